@@ -62,7 +62,24 @@
  *
  ****************************************************************************/
 
-#ifdef CONFIG_TLS_ALIGNED
+#if defined(CONFIG_TLS_THREAD_POINTER)
+static inline FAR struct tls_info_s *up_tls_info(void)
+{
+  FAR struct tls_info_s *info;
+
+  /* The user read-only thread ID register (TPIDRURO) is loaded with the
+   * TLS address of each thread when it is resumed.
+   */
+
+  __asm__ __volatile__
+  (
+    "\tmrc p15, 0, %0, c13, c0, 3\n"
+    : "=r"(info)
+  );
+
+  return info;
+}
+#elif defined(CONFIG_TLS_ALIGNED)
 static inline FAR struct tls_info_s *up_tls_info(void)
 {
   DEBUGASSERT(!up_interrupt_context());
@@ -58,6 +58,11 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Page state bits used by the Clock replacement policy */
+
+#define PG_STATE_RESIDENT 0x01 /* The page holds the data of g_ptemap[] */
+#define PG_STATE_MAPPED   0x02 /* The page is mapped (the reference bit) */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,10 +92,13 @@ typedef uint32_t l2ndx_t;
  * simply allocated in order: 0, 1, 2, ... .  After all CONFIG_PAGING_NPAGED
  * pages have be filled, then they are blindly freed and re-used in the
  * same order 0, 1, 2, ... because we don't know any better.  No smart "least
- * recently used" kind of logic is supported.
+ * recently used" kind of logic is supported, unless CONFIG_PAGING_CLOCK is
+ * selected.
  */
 
+#ifndef CONFIG_PAGING_CLOCK
 static pgndx_t g_pgndx;
+#endif
 
 /* After CONFIG_PAGING_NPAGED have been allocated, the pages will be re-used.
  * In order to re-used the page, we will have un-map the page from its
@@ -102,16 +110,123 @@ static pgndx_t g_pgndx;
 
 static l2ndx_t g_ptemap[CONFIG_PAGING_NPPAGED];
 
+#ifdef CONFIG_PAGING_CLOCK
+/* With CONFIG_PAGING_CLOCK, the pages are replaced using the Clock (second
+ * chance) algorithm.  The MMU has no reference bit, so it is emulated:  When
+ * the clock hand passes a mapped page, the page is un-mapped but kept
+ * resident.  If it is accessed again before the hand comes back, the fault
+ * just maps it again (up_allocpage() returns PG_RESIDENT) without a fill.
+ * Otherwise the page is replaced the next time that the hand reaches it.
+ */
+
+static uint8_t g_pgstate[CONFIG_PAGING_NPPAGED];
+
+/* The clock hand:  The index of the next page to be examined */
+
+static pgndx_t g_pghand;
+#else
 /* The contents of g_ptemap[] are not valid until g_pgndx has wrapped at
  * least one time.
  */
 
 static bool g_pgwrap;
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: arm_unmappage
+ *
+ * Description:
+ *   Un-map the page at index pgndx from its previous virtual address.
+ *
+ ****************************************************************************/
+
+static void arm_unmappage(unsigned int pgndx)
+{
+  /* Get a pointer to the L2 entry corresponding to the previous mapping --
+   * then zero it!
+   */
+
+  uintptr_t oldvaddr = PG_POOL_NDX2VA(g_ptemap[pgndx]);
+  uint32_t *pte = arm_va2pte(oldvaddr);
+  *pte = 0;
+
+  /* Invalidate instruction TLB corresponding to the virtual address */
+
+  tlb_inst_invalidate_single(oldvaddr);
+
+  /* I do not believe that it is necessary to flush the I-Cache in this
+   * case: The I-Cache uses a virtual address index and, hence, since the
+   * NuttX address space is flat, the cached instruction value should be
+   * correct even if the page mapping is no longer in place.
+   */
+}
+
+#ifdef CONFIG_PAGING_CLOCK
+/****************************************************************************
+ * Name: arm_reclaimpage
+ *
+ * Description:
+ *   Return the index of the resident page that still holds the data of the
+ *   virtual page with L2 index l2ndx, or -ENOENT if there is none.
+ *
+ ****************************************************************************/
+
+static int arm_reclaimpage(l2ndx_t l2ndx)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_PAGING_NPPAGED; i++)
+    {
+      if ((g_pgstate[i] & PG_STATE_RESIDENT) != 0 && g_ptemap[i] == l2ndx)
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: arm_clockvictim
+ *
+ * Description:
+ *   Advance the clock hand to the next page that can be replaced and return
+ *   its index.  Mapped pages passed by the hand are un-mapped, i.e., their
+ *   reference bit is cleared.
+ *
+ ****************************************************************************/
+
+static unsigned int arm_clockvictim(void)
+{
+  unsigned int pgndx;
+
+  for (; ; )
+    {
+      pgndx = g_pghand;
+      if (++g_pghand >= CONFIG_PAGING_NPPAGED)
+        {
+          g_pghand = 0;
+        }
+
+      if ((g_pgstate[pgndx] & PG_STATE_MAPPED) == 0)
+        {
+          /* Free or no longer referenced:  Replace this page */
+
+          return pgndx;
+        }
+
+      /* Referenced since the last pass:  Give it a second chance */
+
+      arm_unmappage(pgndx);
+      g_pgstate[pgndx] &= ~PG_STATE_MAPPED;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -154,6 +269,8 @@ static bool g_pgwrap;
  *
  * Returned Value:
  *   This function will return zero (OK) if the allocation was successful.
+ *   With CONFIG_PAGING_CLOCK, PG_RESIDENT is returned if the page was still
+ *   resident and has just been mapped again; no fill is needed then.
  *   A negated errno value may be returned if an error occurs.  All errors,
  *   however, are fatal.
  *
@@ -171,6 +288,9 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
   uintptr_t paddr;
   uint32_t *pte;
   unsigned int pgndx;
+#ifdef CONFIG_PAGING_CLOCK
+  int ret;
+#endif
 
   /* Since interrupts are disabled, we don't need to anything special. */
 
@@ -181,12 +301,33 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
   vaddr = tcb->xcp.far;
   DEBUGASSERT(vaddr >= PG_PAGED_VBASE && vaddr < PG_PAGED_VEND);
 
+#ifdef CONFIG_PAGING_CLOCK
+  /* Is the page still resident?  Then just map it again. */
+
+  ret = arm_reclaimpage(PG_POOL_VA2L2NDX(vaddr));
+  if (ret >= 0)
+    {
+      pte  = arm_va2pte(vaddr);
+      *pte = (PG_POOL_PGPADDR(ret) | MMU_L2_ALLOCFLAGS);
+      g_pgstate[ret] |= PG_STATE_MAPPED;
+
+      *vpage = (void *)(vaddr & ~PAGEMASK);
+      return PG_RESIDENT;
+    }
+
+  /* No.. Let the clock select the page to replace.  A victim page that is
+   * still mapped has already been un-mapped by arm_clockvictim().
+   */
+
+  pgndx = arm_clockvictim();
+  g_pgstate[pgndx] = PG_STATE_RESIDENT | PG_STATE_MAPPED;
+#else
   /* Allocate page memory to back up the mapping.  Start by getting the
    * index of the next page that we are going to allocate.
    */
 
   pgndx = g_pgndx++;
-  if (g_pgndx >= CONFIG_PAGING)
+  if (g_pgndx >= CONFIG_PAGING_NPPAGED)
     {
       g_pgndx  = 0;
       g_pgwrap = true;
@@ -198,24 +339,9 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
 
   if (g_pgwrap)
     {
-      /* Yes.. Get a pointer to the L2 entry corresponding to the previous
-       * mapping -- then zero it!
-       */
-
-       uintptr_t oldvaddr = PG_POOL_NDX2VA(g_ptemap[pgndx]);
-       pte = arm_va2pte(oldvaddr);
-      *pte = 0;
-
-      /* Invalidate instruction TLB corresponding to the virtual address */
-
-      tlb_inst_invalidate_single(oldvaddr);
-
-      /* I do not believe that it is necessary to flush the I-Cache in this
-       * case: The I-Cache uses a virtual address index and, hence, since the
-       * NuttX address space is flat, the cached instruction value should be
-       * correct even if the page mapping is no longer in place.
-       */
+      arm_unmappage(pgndx);
     }
+#endif
 
   /* Then convert the index to a (physical) page address. */
 
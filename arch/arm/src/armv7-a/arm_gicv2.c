@@ -481,6 +481,39 @@ void up_disable_irq(int irq)
     }
 }
 
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Route an IRQ to the CPUs in 'cpuset'.  Only shared peripheral
+ *   interrupts (SPIs) can be routed; SGIs and PPIs are banked per CPU and
+ *   are ignored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void up_affinity_irq(int irq, cpu_set_t cpuset)
+{
+  if (irq >= GIC_IRQ_SPI && irq < NR_IRQS)
+    {
+      uintptr_t regaddr;
+      uint32_t regval;
+
+      /* Write the CPU mask to the corresponding field in the distributor
+       * Interrupt Processor Target Register (GIC_ICDIPTR).
+       */
+
+      regaddr  = GIC_ICDIPTR(irq);
+      regval   = getreg32(regaddr);
+      regval  &= ~GIC_ICDIPTR_ID_MASK(irq);
+      regval  |= GIC_ICDIPTR_ID(irq, (uint8_t)cpuset);
+      putreg32(regval, regaddr);
+
+      arm_gic_dump("Exit up_affinity_irq", false, irq);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: up_prioritize_irq
  *
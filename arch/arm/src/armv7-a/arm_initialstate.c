@@ -77,6 +77,12 @@ void up_initial_state(struct tcb_s *tcb)
     {
       up_use_stack(tcb, (void *)(g_idle_topstack -
         CONFIG_IDLETHREAD_STACKSIZE), CONFIG_IDLETHREAD_STACKSIZE);
+
+#ifdef CONFIG_TLS_THREAD_POINTER
+      /* The IDLE thread is already running, load its thread pointer now */
+
+      up_tls_switch(tcb);
+#endif
     }
 
   /* Initialize the initial exception register context structure */
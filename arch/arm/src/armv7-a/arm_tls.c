@@ -0,0 +1,60 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_tls.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+
+#ifdef CONFIG_TLS_THREAD_POINTER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_tls_switch
+ *
+ * Description:
+ *   Load the user read-only thread ID register (TPIDRURO) with the address
+ *   of the TLS information of 'tcb', which is about to resume.  The TLS
+ *   information lies at the lowest address of the stack allocation.
+ *
+ ****************************************************************************/
+
+void up_tls_switch(FAR struct tcb_s *tcb)
+{
+  uintptr_t info = (uintptr_t)tcb->stack_alloc_ptr;
+
+  __asm__ __volatile__
+  (
+    "\tmcr p15, 0, %0, c13, c0, 3\n"
+    :
+    : "r"(info)
+  );
+}
+
+#endif /* CONFIG_TLS_THREAD_POINTER */
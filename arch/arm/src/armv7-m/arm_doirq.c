@@ -39,7 +39,7 @@
  * Public Functions
  ****************************************************************************/
 
-uint32_t *arm_doirq(int irq, uint32_t *regs)
+uint32_t locate_fast *arm_doirq(int irq, uint32_t *regs)
 {
   board_autoled_on(LED_INIRQ);
 #ifdef CONFIG_SUPPRESS_INTERRUPTS
@@ -124,7 +124,7 @@ static void dispatch_syscall(void)
  *
  ****************************************************************************/
 
-int arm_svcall(int irq, FAR void *context, FAR void *arg)
+int locate_fast arm_svcall(int irq, FAR void *context, FAR void *arg)
 {
   uint32_t *regs = (uint32_t *)context;
   uint32_t cmd;
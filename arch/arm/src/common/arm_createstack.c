@@ -64,6 +64,27 @@
 #define INT32_ALIGN_DOWN(a) ((a) & ~INT32_ALIGN_MASK)
 #define INT32_ALIGN_UP(a)   (((a) + INT32_ALIGN_MASK) & ~INT32_ALIGN_MASK)
 
+/* Stacks may come from a preferred region heap.  Except in the FLAT build,
+ * the region heaps are kernel memory and only kernel threads may use them.
+ */
+
+#ifndef CONFIG_MM_REGION_STACK
+#  define CONFIG_MM_REGION_STACK 0
+#endif
+
+#if CONFIG_MM_REGION_STACK != 0
+#  ifdef CONFIG_BUILD_FLAT
+#    define STACK_IN_REGION(t) true
+#  else
+#    define STACK_IN_REGION(t) ((t) == TCB_FLAG_TTYPE_KERNEL)
+#  endif
+#  ifdef CONFIG_TLS_ALIGNED
+#    define STACK_REGION_ALIGN TLS_STACK_ALIGN
+#  else
+#    define STACK_REGION_ALIGN CONFIG_STACK_ALIGNMENT
+#  endif
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -148,6 +169,16 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
        * If TLS is enabled, then we must allocate aligned stacks.
        */
 
+#if CONFIG_MM_REGION_STACK != 0
+      if (STACK_IN_REGION(ttype))
+        {
+          tcb->stack_alloc_ptr = (uint32_t *)
+            kmm_memalign_region(CONFIG_MM_REGION_STACK, STACK_REGION_ALIGN,
+                                alloc_size);
+        }
+      else
+#endif
+
 #ifdef CONFIG_TLS_ALIGNED
 #ifdef CONFIG_MM_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
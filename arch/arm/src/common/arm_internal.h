@@ -276,6 +276,17 @@ EXTERN uint32_t _eramfuncs;       /* Copy destination end address in RAM */
 #  define __ramfunc__
 
 #endif /* CONFIG_ARCH_RAMFUNCS */
+
+#ifdef CONFIG_ARCH_FASTCODE
+/* Functions marked locate_fast are packaged in the .fastcode section,
+ * stored in FLASH and copied to fast memory (e.g. ITCM) by the start logic
+ * in the same way as the RAM functions above.
+ */
+
+EXTERN const uint32_t _ffastcode; /* Copy source address in FLASH */
+EXTERN uint32_t _sfastcode;       /* Copy destination start address */
+EXTERN uint32_t _efastcode;       /* Copy destination end address */
+#endif
 #endif /* __ASSEMBLY__ */
 
 /****************************************************************************
@@ -88,6 +88,15 @@ void up_release_stack(FAR struct tcb_s *dtcb, uint8_t ttype)
 
   if (dtcb->stack_alloc_ptr)
     {
+#ifdef CONFIG_MM_REGION_HEAPS
+      /* The stack may come from a region heap, see CONFIG_MM_REGION_STACK */
+
+      if (kmm_regionmember(dtcb->stack_alloc_ptr))
+        {
+          kmm_free_region(dtcb->stack_alloc_ptr);
+        }
+      else
+#endif
 #ifdef CONFIG_MM_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
@@ -434,3 +434,28 @@ void arm_addregion(void)
 #endif
 }
 #endif
+
+/****************************************************************************
+ * Name: up_allocate_regionheaps
+ *
+ * Description:
+ *   Register the memory that is not part of the heaps as attribute tagged
+ *   region heaps.  That is the DTCM if it is excluded from the main heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_REGION_HEAPS
+void up_allocate_regionheaps(void)
+{
+#if defined(CONFIG_STM32F7_DTCMEXCLUDE) && defined(DTCM_START)
+  /* Colorize the heap for debug */
+
+  up_heap_color((FAR void *)DTCM_START, DTCM_END - DTCM_START);
+
+  /* The DTCM is zero wait state memory of the core */
+
+  kmm_region_add(MM_REGION_FAST, (FAR void *)DTCM_START,
+                 DTCM_END - DTCM_START);
+#endif
+}
+#endif
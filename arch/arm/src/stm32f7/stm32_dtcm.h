@@ -75,6 +75,14 @@
 #  undef HAVE_DTCM_HEAP
 #endif
 
+/* With region heaps, the excluded DTCM is the fast region heap instead, see
+ * up_allocate_regionheaps().
+ */
+
+#ifdef CONFIG_MM_REGION_HEAPS
+#  undef HAVE_DTCM_HEAP
+#endif
+
 /* Can we support the DTCM heap? */
 
 #ifdef HAVE_DTCM_HEAP
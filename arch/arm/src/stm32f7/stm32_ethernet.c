@@ -57,6 +57,7 @@
 #include <nuttx/net/mii.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/mm/dma.h>
 #include <crc64.h>
 
 #if defined(CONFIG_NET_PKT)
@@ -261,6 +262,11 @@
 #define TXDESC_PADSIZE      DMA_ALIGN_UP(TXDESC_SIZE)
 #define ALIGNED_BUFSIZE     DMA_ALIGN_UP(ETH_BUFSIZE)
 
+/* The maximum number of TX descriptors that one packet may occupy */
+
+#define TX_MAXSEGS          ((OPTIMAL_ETH_BUFSIZE + ALIGNED_BUFSIZE - 1) / \
+                             ALIGNED_BUFSIZE)
+
 #define RXTABLE_SIZE        (STM32F7_NETHERNET * CONFIG_STM32F7_ETH_NRXDESC)
 #define TXTABLE_SIZE        (STM32F7_NETHERNET * CONFIG_STM32F7_ETH_NTXDESC)
 
@@ -1066,6 +1072,13 @@ static int stm32_transmit(struct stm32_ethmac_s *priv)
   struct eth_txdesc_s *txdesc;
   struct eth_txdesc_s *txfirst;
 
+  /* The packet buffer and every descriptor used are cleaned with one
+   * batched cache operation once the whole chain is set up.
+   */
+
+  struct dma_sg_s sg[TX_MAXSEGS + 1];
+  int nsg = 0;
+
   /* The internal (optimal) network buffer size may be configured to be
    * larger than the Ethernet buffer size.
    */
@@ -1090,10 +1103,10 @@ static int stm32_transmit(struct stm32_ethmac_s *priv)
 
   DEBUGASSERT(txdesc && (txdesc->tdes0 & ETH_TDES0_OWN) == 0);
 
-  /* Flush the contents of the TX buffer into physical memory */
+  /* The contents of the TX buffer must be flushed into physical memory */
 
-  up_clean_dcache((uintptr_t)priv->dev.d_buf,
-                  (uintptr_t)priv->dev.d_buf + priv->dev.d_len);
+  sg[nsg].addr  = priv->dev.d_buf;
+  sg[nsg++].len = priv->dev.d_len;
 
   /* Is the size to be sent greater than the size of the Ethernet buffer? */
 
@@ -1108,6 +1121,7 @@ static int stm32_transmit(struct stm32_ethmac_s *priv)
       lastsize = priv->dev.d_len - (bufcount - 1) * ALIGNED_BUFSIZE;
 
       ninfo("bufcount: %d lastsize: %d\n", bufcount, lastsize);
+      DEBUGASSERT(bufcount <= TX_MAXSEGS);
 
       /* Set the first segment bit in the first TX descriptor */
 
@@ -1161,12 +1175,10 @@ static int stm32_transmit(struct stm32_ethmac_s *priv)
 
           txdesc->tdes0 |= ETH_TDES0_OWN;
 
-          /* Flush the contents of the modified TX descriptor into physical
-           * memory.
-           */
+          /* The modified TX descriptor must be flushed too */
 
-          up_clean_dcache((uintptr_t)txdesc,
-                          (uintptr_t)txdesc + sizeof(struct eth_txdesc_s));
+          sg[nsg].addr  = txdesc;
+          sg[nsg++].len = sizeof(union stm32_txdesc_u);
 
           /* Get the next descriptor in the link list */
 
@@ -1197,18 +1209,24 @@ static int stm32_transmit(struct stm32_ethmac_s *priv)
 
       txdesc->tdes0 |= ETH_TDES0_OWN;
 
-      /* Flush the contents of the modified TX descriptor into physical
-       * memory.
-       */
+      /* The modified TX descriptor must be flushed too */
 
-      up_clean_dcache((uintptr_t)txdesc,
-                      (uintptr_t)txdesc + sizeof(struct eth_txdesc_s));
+      sg[nsg].addr  = txdesc;
+      sg[nsg++].len = sizeof(union stm32_txdesc_u);
 
       /* Point to the next available TX descriptor */
 
       txdesc = (struct eth_txdesc_s *)txdesc->tdes3;
     }
 
+  /* Flush the TX buffer and the modified TX descriptors into physical
+   * memory.  The buffer is first in the list, so it reaches memory before
+   * the descriptors that hand it to the DMA.  The descriptors are
+   * consecutive in the TX table, so they are normally cleaned as one range.
+   */
+
+  dma_clean_sg(sg, nsg);
+
   /* Remember where we left off in the TX descriptor chain */
 
   priv->txhead = txdesc;
@@ -324,6 +324,9 @@ static int      qspi_memory(struct qspi_dev_s *dev,
                   struct qspi_meminfo_s *meminfo);
 static FAR void *qspi_alloc(FAR struct qspi_dev_s *dev, size_t buflen);
 static void     qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer);
+static FAR void *qspi_mmap(FAR struct qspi_dev_s *dev,
+                  FAR const struct qspi_meminfo_s *meminfo);
+static void     qspi_munmap(FAR struct qspi_dev_s *dev);
 
 /* Initialization */
 
@@ -345,6 +348,8 @@ static const struct qspi_ops_s g_qspi0ops =
   .memory            = qspi_memory,
   .alloc             = qspi_alloc,
   .free              = qspi_free,
+  .mmap              = qspi_mmap,
+  .munmap            = qspi_munmap,
 };
 
 /* This is the overall state of the QSPI0 controller */
@@ -2397,6 +2402,138 @@ static void qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer)
     }
 }
 
+/****************************************************************************
+ * Name: qspi_memorymapped
+ *
+ * Description:
+ *   Put the QSPI device into memory mapped mode.  The caller holds the
+ *   lock.
+ *
+ * Input Parameters:
+ *   priv    - Device state structure.
+ *   meminfo - parameters like for a memory transfer used for reading
+ *   lpto    - number of cycles to wait to automatically de-assert CS
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void qspi_memorymapped(struct stm32f7_qspidev_s *priv,
+                              const struct qspi_meminfo_s *meminfo,
+                              uint32_t lpto)
+{
+  uint32_t regval;
+  struct qspi_xctnspec_s xctn;
+
+  if (priv->memmap)
+    {
+      return;
+    }
+
+  /* Abort anything in-progress */
+
+  qspi_abort(priv);
+
+  /* Wait till BUSY flag reset */
+
+  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
+
+  /* if we want the 'low-power timeout counter' */
+
+  if (lpto > 0)
+    {
+      /* Set the Low Power Timeout value (automatically de-assert
+       * CS if memory is not accessed for a while)
+       */
+
+      qspi_putreg(priv, lpto, STM32_QUADSPI_LPTR_OFFSET);
+
+      /* Clear Timeout interrupt */
+
+      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32_QUADSPI_FCR_OFFSET);
+
+#ifdef CONFIG_STM32F7_QSPI_INTERRUPTS
+      /* Enable Timeout interrupt */
+
+      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
+      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
+      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
+#endif
+    }
+  else
+    {
+      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
+      regval &= ~QSPI_CR_TCEN;
+      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
+    }
+
+  /* create a transaction object */
+
+  qspi_setupxctnfrommem(&xctn, meminfo);
+
+#ifdef CONFIG_STM32F7_QSPI_INTERRUPTS
+  priv->xctn = NULL;
+#endif
+
+  /* set it into the ccr */
+
+  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
+  priv->memmap = true;
+
+  /* we should be in memory mapped mode now */
+
+  qspi_dumpregs(priv, "After memory mapped:");
+}
+
+/****************************************************************************
+ * Name: qspi_mmap
+ *
+ * Description:
+ *   Put the QSPI device into memory mapped mode (see QSPI_MMAP)
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the memory read command
+ *
+ * Returned Value:
+ *   The address of the memory mapped window
+ *
+ ****************************************************************************/
+
+static FAR void *qspi_mmap(FAR struct qspi_dev_s *dev,
+                           FAR const struct qspi_meminfo_s *meminfo)
+{
+  struct stm32f7_qspidev_s *priv = (struct stm32f7_qspidev_s *)dev;
+
+  qspi_memorymapped(priv, meminfo, 0);
+  return (FAR void *)STM32_FMC_BANK4;
+}
+
+/****************************************************************************
+ * Name: qspi_munmap
+ *
+ * Description:
+ *   Take the QSPI device out of memory mapped mode (see QSPI_MUNMAP)
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void qspi_munmap(FAR struct qspi_dev_s *dev)
+{
+  struct stm32f7_qspidev_s *priv = (struct stm32f7_qspidev_s *)dev;
+
+  /* A simple abort is sufficient */
+
+  qspi_abort(priv);
+  priv->memmap = false;
+}
+
 /****************************************************************************
  * Name: qspi_hw_initialize
  *
@@ -2682,75 +2819,11 @@ void stm32f7_qspi_enter_memorymapped(struct qspi_dev_s *dev,
                                      uint32_t lpto)
 {
   struct stm32f7_qspidev_s *priv = (struct stm32f7_qspidev_s *)dev;
-  uint32_t regval;
-  struct qspi_xctnspec_s xctn;
 
   /* lock during this mode change */
 
   qspi_lock(dev, true);
-
-  if (priv->memmap)
-    {
-      qspi_lock(dev, false);
-      return;
-    }
-
-  /* Abort anything in-progress */
-
-  qspi_abort(priv);
-
-  /* Wait till BUSY flag reset */
-
-  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
-
-  /* if we want the 'low-power timeout counter' */
-
-  if (lpto > 0)
-    {
-      /* Set the Low Power Timeout value (automatically de-assert
-       * CS if memory is not accessed for a while)
-       */
-
-      qspi_putreg(priv, lpto, STM32_QUADSPI_LPTR_OFFSET);
-
-      /* Clear Timeout interrupt */
-
-      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32_QUADSPI_FCR_OFFSET);
-
-#ifdef CONFIG_STM32F7_QSPI_INTERRUPTS
-      /* Enable Timeout interrupt */
-
-      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
-      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
-      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
-#endif
-    }
-  else
-    {
-      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
-      regval &= ~QSPI_CR_TCEN;
-      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
-    }
-
-  /* create a transaction object */
-
-  qspi_setupxctnfrommem(&xctn, meminfo);
-
-#ifdef CONFIG_STM32F7_QSPI_INTERRUPTS
-  priv->xctn = NULL;
-#endif
-
-  /* set it into the ccr */
-
-  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
-  priv->memmap = true;
-
-  /* we should be in memory mapped mode now */
-
-  qspi_dumpregs(priv, "After memory mapped:");
-
-  /* finished this mode change */
-
+  qspi_memorymapped(priv, meminfo, lpto);
   qspi_lock(dev, false);
 }
 
@@ -2770,15 +2843,8 @@ void stm32f7_qspi_enter_memorymapped(struct qspi_dev_s *dev,
 
 void stm32f7_qspi_exit_memorymapped(struct qspi_dev_s *dev)
 {
-  struct stm32f7_qspidev_s *priv = (struct stm32f7_qspidev_s *)dev;
-
   qspi_lock(dev, true);
-
-  /* A simple abort is sufficient */
-
-  qspi_abort(priv);
-  priv->memmap = false;
-
+  qspi_munmap(dev);
   qspi_lock(dev, false);
 }
 
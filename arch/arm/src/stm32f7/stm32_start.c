@@ -223,9 +223,11 @@ static inline void stm32_tcmenable(void)
   ARM_DSB();
   ARM_ISB();
 
-  /* Enabled/disabled ITCM */
+  /* Enabled/disabled ITCM.  It must stay enabled if it holds the .fastcode
+   * section.
+   */
 
-#ifdef CONFIG_ARMV7M_ITCM
+#if defined(CONFIG_ARMV7M_ITCM) || defined(CONFIG_ARCH_FASTCODE)
   regval  = NVIC_TCMCR_EN | NVIC_TCMCR_RMW | NVIC_TCMCR_RETEN;
 #else
   regval  = getreg32(NVIC_ITCMCR);
@@ -250,11 +252,9 @@ static inline void stm32_tcmenable(void)
   ARM_DSB();
   ARM_ISB();
 
-#ifdef CONFIG_ARMV7M_ITCM
-  /* Copy TCM code from flash to ITCM */
-
-#warning Missing logic
-#endif
+  /* TCM code (the .fastcode section) is copied from flash to ITCM by
+   * __start(), before any of it can be called.
+   */
 }
 
 /****************************************************************************
@@ -322,6 +322,19 @@ void __start(void)
                    "r"(CONFIG_IDLETHREAD_STACKSIZE - 64) :);
 #endif
 
+#ifdef CONFIG_ARCH_FASTCODE
+  /* Copy the hot code from FLASH to ITCM RAM (enabled out of reset) before
+   * anything else:  memcpy() may be among it, and the compiler may turn
+   * the copy loops below into memcpy() calls.  The volatile access keeps
+   * it from doing so with this loop.
+   */
+
+  for (src = &_ffastcode, dest = &_sfastcode; dest < &_efastcode; )
+    {
+      *(volatile uint32_t *)dest++ = *src++;
+    }
+#endif
+
   /* Clear .bss.  We'll do this inline (vs. calling memset) just to be
    * certain that there are no issues with the state of global variables.
    */
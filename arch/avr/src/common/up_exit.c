@@ -88,14 +88,14 @@ static void _up_dumponexit(FAR struct tcb_s *tcb, FAR void *arg)
   sinfo("  TCB=%p name=%s pid=%d\n", tcb, tcb->argv[0], tcb->pid);
   sinfo("    priority=%d state=%d\n", tcb->sched_priority, tcb->task_state);
 
-  filelist = tcb->group->tg_filelist;
+  filelist = &tcb->group->tg_filelist;
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      struct inode *inode = filelist->fl_files[i].f_inode;
-      if (inode)
+      FAR struct file *file = files_fget(filelist, i);
+      if (file != NULL && file->f_inode != NULL)
         {
           sinfo("      fd=%d refcount=%d\n",
-                i, inode->i_crefs);
+                i, file->f_inode->i_crefs);
         }
     }
 
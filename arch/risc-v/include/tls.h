@@ -62,7 +62,24 @@
  *
  ****************************************************************************/
 
-#ifdef CONFIG_TLS_ALIGNED
+#if defined(CONFIG_TLS_THREAD_POINTER)
+static inline FAR struct tls_info_s *up_tls_info(void)
+{
+  FAR struct tls_info_s *info;
+
+  /* The tp register is part of the saved register context and holds the
+   * TLS address of each thread.
+   */
+
+  __asm__ __volatile__
+  (
+    "\tmv %0, tp\n"
+    : "=r"(info)
+  );
+
+  return info;
+}
+#elif defined(CONFIG_TLS_ALIGNED)
 static inline FAR struct tls_info_s *up_tls_info(void)
 {
   DEBUGASSERT(!up_interrupt_context());
@@ -139,6 +139,12 @@ void k210_cpu_boot(int cpu)
   sched_note_cpu_started(this_task());
 #endif
 
+#ifdef CONFIG_TLS_THREAD_POINTER
+  /* Load the thread pointer of this CPU's IDLE task */
+
+  __asm__ __volatile__("mv tp, %0" : : "r"(this_task()->stack_alloc_ptr));
+#endif
+
   up_irq_enable();
 
   /* Then transfer control to the IDLE task */
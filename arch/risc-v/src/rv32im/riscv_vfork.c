@@ -255,6 +255,10 @@ pid_t up_vfork(const struct vfork_s *context)
   child->cmn.xcp.regs[REG_S8]  = context->s8;  /* Volatile register s8 */
 #endif
   child->cmn.xcp.regs[REG_SP]  = newsp;        /* Stack pointer */
+#ifdef CONFIG_TLS_THREAD_POINTER
+  child->cmn.xcp.regs[REG_TP]  =               /* Thread pointer */
+    (uint32_t)child->cmn.stack_alloc_ptr;
+#endif
 #ifdef MIPS32_SAVE_GP
   child->cmn.xcp.regs[REG_GP]  = newsp;        /* Global pointer */
 #endif
@@ -78,6 +78,12 @@ void up_initial_state(struct tcb_s *tcb)
     {
       up_use_stack(tcb, (void *)(g_idle_topstack -
         CONFIG_IDLETHREAD_STACKSIZE), CONFIG_IDLETHREAD_STACKSIZE);
+
+#ifdef CONFIG_TLS_THREAD_POINTER
+      /* The IDLE thread is already running, load its thread pointer now */
+
+      __asm__ __volatile__("mv tp, %0" : : "r"(tcb->stack_alloc_ptr));
+#endif
     }
 
   /* Initialize the initial exception register context structure */
@@ -92,6 +98,14 @@ void up_initial_state(struct tcb_s *tcb)
 
   xcp->regs[REG_SP]      = (uintptr_t)tcb->adj_stack_ptr;
 
+#ifdef CONFIG_TLS_THREAD_POINTER
+  /* The thread pointer holds the address of the TLS information at the
+   * beginning of the stack allocation.
+   */
+
+  xcp->regs[REG_TP]      = (uintptr_t)tcb->stack_alloc_ptr;
+#endif
+
   /* Save the task entry point */
 
   xcp->regs[REG_EPC]     = (uintptr_t)tcb->start;
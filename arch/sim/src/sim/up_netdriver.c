@@ -60,6 +60,14 @@
 
 #include "up_internal.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SIM_NETDEV_RXBATCH
+#  define CONFIG_SIM_NETDEV_RXBATCH 1
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -116,106 +124,125 @@ static void netdriver_reply(FAR struct net_driver_s *dev)
     }
 }
 
-static void netdriver_recv_work(FAR void *arg)
+static void netdriver_recv_frame(FAR struct net_driver_s *dev)
 {
-  FAR struct net_driver_s *dev = arg;
   FAR struct eth_hdr_s *eth;
 
-  net_lock();
+  NETDEV_RXPACKETS(dev);
 
-  /* netdev_read will return 0 on a timeout event and > 0
-   * on a data received event
+  /* Data received event.  Check for valid Ethernet header with
+   * destination == our MAC address
    */
 
-  dev->d_len = netdev_read((FAR unsigned char *)dev->d_buf,
-                           dev->d_pktsize);
-  if (dev->d_len > 0)
+  eth = (FAR struct eth_hdr_s *)dev->d_buf;
+  if (dev->d_len > ETH_HDRLEN)
     {
-      NETDEV_RXPACKETS(dev);
-
-      /* Data received event.  Check for valid Ethernet header with
-       * destination == our MAC address
-       */
-
-      eth = (FAR struct eth_hdr_s *)dev->d_buf;
-      if (dev->d_len > ETH_HDRLEN)
-        {
 #ifdef CONFIG_NET_PKT
-          /* When packet sockets are enabled, feed the frame into the packet
-           * tap.
-           */
+      /* When packet sockets are enabled, feed the frame into the packet
+       * tap.
+       */
 
-          pkt_input(dev);
+      pkt_input(dev);
 #endif /* CONFIG_NET_PKT */
 
-          /* We only accept IP packets of the configured type
-           * and ARP packets
-           */
+      /* We only accept IP packets of the configured type
+       * and ARP packets
+       */
 
 #ifdef CONFIG_NET_IPv4
-          if (eth->type == HTONS(ETHTYPE_IP))
-            {
-              ninfo("IPv4 frame\n");
-              NETDEV_RXIPV4(dev);
+      if (eth->type == HTONS(ETHTYPE_IP))
+        {
+          ninfo("IPv4 frame\n");
+          NETDEV_RXIPV4(dev);
 
-              /* Handle ARP on input then give the IPv4 packet to the network
-               * layer
-               */
+          /* Handle ARP on input then give the IPv4 packet to the network
+           * layer
+           */
 
-              arp_ipin(dev);
-              ipv4_input(dev);
+          arp_ipin(dev);
+          ipv4_input(dev);
 
-              /* Check for a reply to the IPv4 packet */
+          /* Check for a reply to the IPv4 packet */
 
-              netdriver_reply(dev);
-            }
-          else
+          netdriver_reply(dev);
+        }
+      else
 #endif /* CONFIG_NET_IPv4 */
 #ifdef CONFIG_NET_IPv6
-          if (eth->type == HTONS(ETHTYPE_IP6))
-            {
-              ninfo("IPv6 frame\n");
-              NETDEV_RXIPV6(dev);
+      if (eth->type == HTONS(ETHTYPE_IP6))
+        {
+          ninfo("IPv6 frame\n");
+          NETDEV_RXIPV6(dev);
 
-              /* Give the IPv6 packet to the network layer */
+          /* Give the IPv6 packet to the network layer */
 
-              ipv6_input(dev);
+          ipv6_input(dev);
 
-              /* Check for a reply to the IPv6 packet */
+          /* Check for a reply to the IPv6 packet */
 
-              netdriver_reply(dev);
-            }
-          else
+          netdriver_reply(dev);
+        }
+      else
 #endif/* CONFIG_NET_IPv6 */
 #ifdef CONFIG_NET_ARP
-          if (eth->type == htons(ETHTYPE_ARP))
-            {
-              ninfo("ARP frame\n");
-              NETDEV_RXARP(dev);
+      if (eth->type == htons(ETHTYPE_ARP))
+        {
+          ninfo("ARP frame\n");
+          NETDEV_RXARP(dev);
 
-              arp_arpin(dev);
+          arp_arpin(dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (dev->d_len > 0)
-                {
-                  netdev_send(dev->d_buf, dev->d_len);
-                }
-            }
-          else
-#endif
+          if (dev->d_len > 0)
             {
-              NETDEV_RXDROPPED(dev);
-              nwarn("WARNING: Unsupported Ethernet type %u\n", eth->type);
+              netdev_send(dev->d_buf, dev->d_len);
             }
         }
       else
+#endif
+        {
+          NETDEV_RXDROPPED(dev);
+          nwarn("WARNING: Unsupported Ethernet type %u\n", eth->type);
+        }
+    }
+  else
+    {
+      NETDEV_RXERRORS(dev);
+    }
+}
+
+static void netdriver_recv_work(FAR void *arg)
+{
+  FAR struct net_driver_s *dev = arg;
+  int nframes;
+
+  /* Handle up to CONFIG_SIM_NETDEV_RXBATCH frames while holding the
+   * network lock instead of going back through the idle loop and the work
+   * queue for every frame.
+   */
+
+  net_lock();
+
+  for (nframes = 0;
+       nframes < CONFIG_SIM_NETDEV_RXBATCH && netdev_avail();
+       nframes++)
+    {
+      /* netdev_read will return 0 on a timeout event and > 0
+       * on a data received event
+       */
+
+      dev->d_len = netdev_read((FAR unsigned char *)dev->d_buf,
+                               dev->d_pktsize);
+      if (dev->d_len == 0)
         {
-          NETDEV_RXERRORS(dev);
+          break;
         }
+
+      netdriver_recv_frame(dev);
     }
 
   net_unlock();
@@ -50,6 +50,8 @@
 #include <sys/socket.h>
 
 #include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -57,6 +59,10 @@
 #include <syslog.h>
 #include <time.h>
 
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+#  include <pthread.h>
+#endif
+
 #ifdef CONFIG_SIM_NET_HOST_ROUTE
 #  include <net/route.h>
 #endif
@@ -75,6 +81,20 @@
 
 #define DEVTAP        "/dev/net/tun"
 
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+#  ifndef NETDEV_BUFSIZE
+#    define NETDEV_BUFSIZE 1518
+#  endif
+#  ifndef CONFIG_SIM_NETDEV_TAP_RXQUEUE
+#    define CONFIG_SIM_NETDEV_TAP_RXQUEUE 32
+#  endif
+#  if (CONFIG_SIM_NETDEV_TAP_RXQUEUE & \
+       (CONFIG_SIM_NETDEV_TAP_RXQUEUE - 1)) != 0
+#    error CONFIG_SIM_NETDEV_TAP_RXQUEUE must be a power of two
+#  endif
+#  define RXQUEUE_MASK (CONFIG_SIM_NETDEV_TAP_RXQUEUE - 1)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -90,6 +110,19 @@ struct sel_arg_struct
   struct timeval *tvp;
 };
 
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+/* One received frame.  The receive queue has a single producer, the host
+ * receive thread, which only advances 'grxhead', and a single consumer,
+ * tapdev_read(), which only advances 'grxtail'.
+ */
+
+struct rxframe_s
+{
+  unsigned int  len;
+  unsigned char buf[NETDEV_BUFSIZE];
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -104,6 +137,14 @@ static char gdevname[IFNAMSIZ];
 static struct rtentry ghostroute;
 #endif
 
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+static struct rxframe_s grxqueue[CONFIG_SIM_NETDEV_TAP_RXQUEUE];
+static unsigned int     grxhead;
+static unsigned int     grxtail;
+static unsigned long    grxdropped;
+static pthread_t        grxthread;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -157,6 +198,77 @@ static void set_macaddr(void)
   netdriver_setmacaddr(mac);
 }
 
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+/* Receive frames from the TAP device in a host thread so that the idle
+ * loop only has to look at the queue indices instead of making a select()
+ * and a read() system call for every frame.
+ */
+
+static void *tapdev_rxthread(void *arg)
+{
+  static unsigned char scratch[NETDEV_BUFSIZE];
+  struct rxframe_s *frame;
+  unsigned int head;
+  unsigned char *buf;
+  sigset_t set;
+  int ret;
+
+  /* The simulated interrupts and timers are host signals that must only
+   * be delivered to the threads running NuttX.
+   */
+
+  sigfillset(&set);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  for (; ; )
+    {
+      /* Receive into the next free slot.  If the queue is full, the frame
+       * is still read, so that the TAP device does not back up, but then
+       * dropped.
+       */
+
+      head  = grxhead;
+      frame = &grxqueue[head & RXQUEUE_MASK];
+      if (head - __atomic_load_n(&grxtail, __ATOMIC_ACQUIRE) >=
+          CONFIG_SIM_NETDEV_TAP_RXQUEUE)
+        {
+          buf = scratch;
+        }
+      else
+        {
+          buf = frame->buf;
+        }
+
+      ret = read(gtapdevfd, buf, NETDEV_BUFSIZE);
+      if (ret < 0)
+        {
+          if (errno != EINTR)
+            {
+              syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -errno);
+              return NULL;
+            }
+
+          continue;
+        }
+
+      if (buf == scratch || ret == 0)
+        {
+          grxdropped++;
+          continue;
+        }
+
+      dump_ethhdr("read", buf, ret);
+
+      /* Publish the frame only after its contents are complete */
+
+      frame->len = ret;
+      __atomic_store_n(&grxhead, head + 1, __ATOMIC_RELEASE);
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -246,12 +358,26 @@ void tapdev_init(void)
   /* Set the MAC address */
 
   set_macaddr();
+
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+  /* Start receiving frames in the background */
+
+  ret = pthread_create(&grxthread, NULL, tapdev_rxthread, NULL);
+  if (ret != 0)
+    {
+      syslog(LOG_ERR, "TAPDEV: pthread_create failed: %d\n", -ret);
+      gtapdevfd = -1;
+      close(tapdevfd);
+    }
+#endif
 }
 
 int tapdev_avail(void)
 {
+#ifndef CONFIG_SIM_NETDEV_TAP_RXTHREAD
   struct timeval tv;
   fd_set fdset;
+#endif
 
   /* We can't do anything if we failed to open the tap device */
 
@@ -260,6 +386,9 @@ int tapdev_avail(void)
       return 0;
     }
 
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+  return __atomic_load_n(&grxhead, __ATOMIC_ACQUIRE) != grxtail;
+#else
   /* Wait for data on the tap device (or a timeout) */
 
   tv.tv_sec  = 0;
@@ -269,17 +398,35 @@ int tapdev_avail(void)
   FD_SET(gtapdevfd, &fdset);
 
   return select(gtapdevfd + 1, &fdset, NULL, NULL, &tv) > 0;
+#endif
 }
 
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
 {
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+  struct rxframe_s *frame;
+  unsigned int tail;
+  unsigned int len;
+#else
   int ret;
+#endif
 
   if (!tapdev_avail())
     {
       return 0;
     }
 
+#ifdef CONFIG_SIM_NETDEV_TAP_RXTHREAD
+  /* Take the oldest frame from the receive queue, then release its slot */
+
+  tail  = grxtail;
+  frame = &grxqueue[tail & RXQUEUE_MASK];
+  len   = frame->len < buflen ? frame->len : buflen;
+
+  memcpy(buf, frame->buf, len);
+  __atomic_store_n(&grxtail, tail + 1, __ATOMIC_RELEASE);
+  return len;
+#else
   ret = read(gtapdevfd, buf, buflen);
   if (ret < 0)
     {
@@ -289,6 +436,7 @@ unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
 
   dump_ethhdr("read", buf, ret);
   return ret;
+#endif
 }
 
 void tapdev_send(unsigned char *buf, unsigned int buflen)
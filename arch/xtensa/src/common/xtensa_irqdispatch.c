@@ -57,7 +57,7 @@
  * Public Functions
  ****************************************************************************/
 
-uint32_t *xtensa_irq_dispatch(int irq, uint32_t *regs)
+uint32_t locate_fast *xtensa_irq_dispatch(int irq, uint32_t *regs)
 {
 #ifdef CONFIG_SUPPRESS_INTERRUPTS
   board_autoled_on(LED_INIRQ);
@@ -56,6 +56,7 @@
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/audio/audio.h>
 #include <nuttx/semaphore.h>
 
@@ -92,6 +93,15 @@ struct audio_upperhalf_s
   sem_t             exclsem;          /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   mqd_t             usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RINGBUFFER
+  FAR struct ap_buffer_s *ring;       /* Periods of the mapped ring */
+  FAR uint8_t      *ringbase;         /* Samples of the mapped ring */
+  uint32_t          nperiods;         /* Number of periods in the ring */
+  apb_samp_t        periodsize;       /* Bytes per period */
+  uint32_t          head;             /* Periods committed to the lower half */
+  uint32_t          tail;             /* Periods acquired by the application */
+  sem_t             ringsem;          /* Counts periods owned by the app */
+#endif
 };
 
 /****************************************************************************
@@ -124,6 +134,9 @@ static void     audio_callback(FAR void *priv,
                                FAR struct ap_buffer_s *apb,
                                uint16_t status);
 #endif /* CONFIG_AUDIO_MULTI_SESSION */
+#ifdef CONFIG_AUDIO_RINGBUFFER
+static int      audio_ringrelease(FAR struct audio_upperhalf_s *upper);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -244,6 +257,11 @@ static int audio_close(FAR struct file *filep)
       audinfo("calling shutdown: %d\n");
 
       lower->ops->shutdown(lower);
+
+#ifdef CONFIG_AUDIO_RINGBUFFER
+      upper->started = false;
+      audio_ringrelease(upper);
+#endif
     }
 
   ret = OK;
@@ -357,6 +375,208 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
   return ret;
 }
 
+/****************************************************************************
+ * Name: audio_ringrelease
+ *
+ * Description:
+ *   Free the memory-mapped ring.  The periods must not be in use by the
+ *   lower half.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_RINGBUFFER
+static int audio_ringrelease(FAR struct audio_upperhalf_s *upper)
+{
+  uint32_t i;
+
+  if (upper->ring == NULL)
+    {
+      return OK;
+    }
+
+  if (upper->started)
+    {
+      return -EBUSY;
+    }
+
+  for (i = 0; i < upper->nperiods; i++)
+    {
+      nxsem_destroy(&upper->ring[i].sem);
+    }
+
+  nxsem_destroy(&upper->ringsem);
+  kumm_free(upper->ring);
+  upper->ring = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ringsetup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGSETUP ioctl command:  Allocate the periods of
+ *   the ring with one allocation from the user heap, so that they are
+ *   contiguous and can be mapped to the application, and describe each by
+ *   an audio pipeline buffer that is passed to the lower half as is.
+ *
+ ****************************************************************************/
+
+static int audio_ringsetup(FAR struct audio_upperhalf_s *upper,
+                           FAR struct audio_ring_s *ring)
+{
+  FAR struct ap_buffer_s *apb;
+  size_t hdrsize;
+  uint32_t i;
+  int ret;
+
+  if (ring == NULL || ring->nperiods < 2 || ring->periodsize == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = audio_ringrelease(upper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Keep the samples aligned for DMA */
+
+  hdrsize = ring->nperiods * sizeof(struct ap_buffer_s);
+  hdrsize = (hdrsize + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+
+  upper->ring = (FAR struct ap_buffer_s *)
+    kumm_zalloc(hdrsize + (size_t)ring->nperiods * ring->periodsize);
+  if (upper->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->ringbase   = (FAR uint8_t *)upper->ring + hdrsize;
+  upper->nperiods   = ring->nperiods;
+  upper->periodsize = ring->periodsize;
+  upper->head       = 0;
+  upper->tail       = 0;
+
+  for (i = 0; i < ring->nperiods; i++)
+    {
+      /* The ring holds a reference so that apb_free() in the lower half
+       * never releases a period.
+       */
+
+      apb             = &upper->ring[i];
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = ring->periodsize;
+      apb->flags      = AUDIO_APB_RING;
+      apb->samp       = upper->ringbase + i * ring->periodsize;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      apb->session    = ring->session;
+#endif
+      nxsem_init(&apb->sem, 0, 1);
+    }
+
+  /* All periods are initially owned by the application */
+
+  nxsem_init(&upper->ringsem, 0, ring->nperiods);
+  nxsem_set_protocol(&upper->ringsem, SEM_PRIO_NONE);
+
+  ring->base = upper->ringbase;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ringacquire
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGACQUIRE ioctl command.  Called with exclsem
+ *   held, which is released while waiting for the lower half to return a
+ *   period.
+ *
+ ****************************************************************************/
+
+static int audio_ringacquire(FAR struct file *filep,
+                             FAR struct audio_upperhalf_s *upper,
+                             FAR uint32_t *index)
+{
+  int ret;
+
+  if (upper->ring == NULL || index == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((filep->f_oflags & O_NONBLOCK) != 0)
+    {
+      ret = nxsem_trywait(&upper->ringsem);
+    }
+  else
+    {
+      nxsem_post(&upper->exclsem);
+      ret = nxsem_wait(&upper->ringsem);
+      nxsem_wait_uninterruptible(&upper->exclsem);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->ring == NULL)
+    {
+      /* The ring was released while we were waiting */
+
+      return -ECANCELED;
+    }
+
+  /* Periods are returned by the lower half in the order they were
+   * committed.
+   */
+
+  *index = upper->tail++ % upper->nperiods;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ringcommit
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGCOMMIT ioctl command:  Enqueue the oldest
+ *   acquired period to the lower half without copying it.
+ *
+ ****************************************************************************/
+
+static int audio_ringcommit(FAR struct audio_upperhalf_s *upper,
+                            unsigned long nbytes)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct ap_buffer_s *apb;
+  int ret;
+
+  if (upper->ring == NULL || nbytes > upper->periodsize ||
+      upper->head == upper->tail)
+    {
+      /* No ring, too much data, or no period acquired */
+
+      return -EINVAL;
+    }
+
+  apb          = &upper->ring[upper->head % upper->nperiods];
+  apb->nbytes  = nbytes != 0 ? nbytes : upper->periodsize;
+  apb->curbyte = 0;
+  apb->flags   = AUDIO_APB_RING;
+
+  DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
+  ret = lower->ops->enqueuebuffer(lower, apb);
+  if (ret >= 0)
+    {
+      upper->head++;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: audio_ioctl
  *
@@ -667,6 +887,81 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RINGBUFFER
+      /* AUDIOIOC_RINGSETUP - Allocate a memory-mapped ring
+       *
+       *   ioctl argument:  pointer to an audio_ring_s structure
+       */
+
+      case AUDIOIOC_RINGSETUP:
+        {
+          audinfo("AUDIOIOC_RINGSETUP\n");
+
+          ret = audio_ringsetup(upper, (FAR struct audio_ring_s *)arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGACQUIRE - Get the next period owned by the app
+       *
+       *   ioctl argument:  pointer to a uint32_t to receive the index
+       */
+
+      case AUDIOIOC_RINGACQUIRE:
+        {
+          audinfo("AUDIOIOC_RINGACQUIRE\n");
+
+          ret = audio_ringacquire(filep, upper, (FAR uint32_t *)arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGCOMMIT - Enqueue the oldest acquired period
+       *
+       *   ioctl argument:  number of valid bytes in the period
+       */
+
+      case AUDIOIOC_RINGCOMMIT:
+        {
+          audinfo("AUDIOIOC_RINGCOMMIT\n");
+
+          ret = audio_ringcommit(upper, arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGRELEASE - Free the memory-mapped ring
+       *
+       *   ioctl argument:  none
+       */
+
+      case AUDIOIOC_RINGRELEASE:
+        {
+          audinfo("AUDIOIOC_RINGRELEASE\n");
+
+          ret = audio_ringrelease(upper);
+        }
+        break;
+
+      /* FIOC_MMAP - Return the address of the ring (used by mmap())
+       *
+       *   ioctl argument:  location to return the address
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+          if (upper->ring == NULL || addr == NULL)
+            {
+              ret = -ENODEV;
+            }
+          else
+            {
+              *addr = upper->ringbase;
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be
        * platform-specific ioctl commands
        */
@@ -729,6 +1024,16 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
 
   audinfo("Entry\n");
 
+#ifdef CONFIG_AUDIO_RINGBUFFER
+  /* A period of the mapped ring is handed back to the application */
+
+  if ((apb->flags & AUDIO_APB_RING) != 0)
+    {
+      nxsem_post(&upper->ringsem);
+      return;
+    }
+#endif
+
   /* Send a dequeue message to the user if a message queue is registered */
 
   if (upper->usermq != NULL)
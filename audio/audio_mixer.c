@@ -0,0 +1,1176 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1) != 0
+#  include <arm_mve.h>
+#  define MIXER_HAVE_MVE 1
+#elif defined(__ARM_FEATURE_SIMD32)
+#  include <arm_acle.h>
+#  define MIXER_HAVE_SIMD32 1
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The output is always 16-bit stereo PCM */
+
+#define MIXER_NCHANNELS   2
+#define MIXER_FRAMESIZE   (MIXER_NCHANNELS * sizeof(int16_t))
+#define MIXER_PERIODBYTES (CONFIG_AUDIO_MIXER_PERIOD * MIXER_FRAMESIZE)
+
+/* Resampling positions are Q16 fractions of an input frame */
+
+#define MIXER_ONE         (1 << 16)
+
+/* Unity gain (Q15) */
+
+#define MIXER_UNITY       INT16_MAX
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define MIXER_WORK      HPWORK
+#else
+#  define MIXER_WORK      LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* One input stream.  Each is registered as its own audio device. */
+
+struct audio_mixer_stream_s
+{
+  /* This is our appearance to the upper half.  This *MUST* be the first
+   * element of the structure.
+   */
+
+  struct audio_lowerhalf_s dev;
+
+  FAR struct audio_mixer_s *mixer;
+  struct dq_queue_s pendq;          /* Buffers enqueued by the client */
+  uint32_t samprate;                /* Sample rate of the stream */
+  uint8_t nchannels;                /* 1 (duplicated) or 2 */
+  bool running;                     /* Started and not yet complete */
+  bool paused;                      /* Skipped while mixing */
+  bool final;                       /* The last buffer has been enqueued */
+  int16_t gain;                     /* Volume (Q15) */
+  uint32_t step;                    /* Input frames per output frame (Q16) */
+  uint32_t phase;                   /* Position between prev and cur (Q16) */
+  int16_t prev[MIXER_NCHANNELS];    /* Input frames interpolated between */
+  int16_t cur[MIXER_NCHANNELS];
+  uint32_t queued;                  /* Input frames not mixed yet */
+  uint32_t maxlatency;              /* Highest latency at enqueue (usec) */
+  uint32_t underruns;               /* Periods mixed without data */
+};
+
+/* The state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower;  /* The output device */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;                    /* Session on the output device */
+#endif
+  FAR struct audio_mixer_stream_s *streams;
+  int nstreams;
+  int nrunning;                         /* Streams running */
+  bool started;                         /* The output device is running */
+  volatile uint8_t nqueued;             /* Buffers in the output device */
+  sem_t exclsem;                        /* Protects the streams */
+  struct work_s work;                   /* Mixes returned output buffers */
+  struct dq_queue_s freeq;              /* Output buffers to be mixed */
+  FAR struct ap_buffer_s *apb[CONFIG_AUDIO_MIXER_NBUFFERS];
+
+  /* The resampled stream being added (int32_t for alignment) */
+
+  int32_t scratch[CONFIG_AUDIO_MIXER_PERIOD];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps);
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session);
+#endif
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session);
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status, FAR void *session);
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  .getcaps       = audio_mixer_getcaps,
+  .configure     = audio_mixer_configure,
+  .shutdown      = audio_mixer_shutdown,
+  .start         = audio_mixer_start,
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  .stop          = audio_mixer_stop,
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  .pause         = audio_mixer_pause,
+  .resume        = audio_mixer_resume,
+#endif
+  .enqueuebuffer = audio_mixer_enqueuebuffer,
+  .ioctl         = audio_mixer_ioctl,
+  .reserve       = audio_mixer_reserve,
+  .release       = audio_mixer_release,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_notify
+ *
+ * Description:
+ *   Report a buffer or the completion of a stream to its upper half.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_notify(FAR struct audio_mixer_stream_s *stream,
+                               uint16_t reason, FAR struct ap_buffer_s *apb)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  stream->dev.upper(stream->dev.priv, reason, apb, OK, stream);
+#else
+  stream->dev.upper(stream->dev.priv, reason, apb, OK);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_usec
+ *
+ * Description:
+ *   Convert a number of frames at 'rate' to microseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t audio_mixer_usec(uint32_t nframes, uint32_t rate)
+{
+  return (uint32_t)(((uint64_t)nframes * 1000000) / rate);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_latency
+ *
+ * Description:
+ *   Return the time until a sample enqueued now to the stream is played:
+ *   The frames still queued in the stream plus the mixed frames queued in
+ *   the output device.
+ *
+ ****************************************************************************/
+
+static uint32_t
+audio_mixer_latency(FAR struct audio_mixer_stream_s *stream,
+                    FAR uint32_t *output)
+{
+  uint32_t outlatency;
+
+  outlatency = audio_mixer_usec(stream->mixer->nqueued *
+                                CONFIG_AUDIO_MIXER_PERIOD,
+                                CONFIG_AUDIO_MIXER_RATE);
+  if (output != NULL)
+    {
+      *output = outlatency;
+    }
+
+  return audio_mixer_usec(stream->queued, stream->samprate) + outlatency;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_nextframe
+ *
+ * Description:
+ *   Advance the stream by one input frame.  Buffers are returned to the
+ *   client as soon as their last frame has been read.
+ *
+ * Returned Value:
+ *   false if the stream has no more data.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_nextframe(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const int16_t *samp;
+
+  apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq);
+  if (apb == NULL)
+    {
+      return false;
+    }
+
+  samp = (FAR const int16_t *)(apb->samp + apb->curbyte);
+
+  stream->prev[0] = stream->cur[0];
+  stream->prev[1] = stream->cur[1];
+  stream->cur[0]  = samp[0];
+  stream->cur[1]  = stream->nchannels > 1 ? samp[1] : samp[0];
+
+  apb->curbyte   += stream->nchannels * sizeof(int16_t);
+  stream->queued--;
+
+  if (apb->curbyte + stream->nchannels * sizeof(int16_t) > apb->nbytes)
+    {
+      dq_remfirst(&stream->pendq);
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          stream->final = true;
+        }
+
+      audio_mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resample
+ *
+ * Description:
+ *   Produce up to 'nframes' stereo output frames of the stream at the
+ *   output rate, by linear interpolation between input frames, and apply
+ *   the gain of the stream.
+ *
+ * Returned Value:
+ *   The number of frames produced.  Less than 'nframes' if the stream ran
+ *   out of data.
+ *
+ ****************************************************************************/
+
+static unsigned int
+audio_mixer_resample(FAR struct audio_mixer_stream_s *stream,
+                     FAR int16_t *dst, unsigned int nframes)
+{
+  int32_t frac;
+  int32_t smp;
+  unsigned int i;
+  int ch;
+
+  for (i = 0; i < nframes; i++)
+    {
+      while (stream->phase >= MIXER_ONE)
+        {
+          if (!audio_mixer_nextframe(stream))
+            {
+              return i;
+            }
+
+          stream->phase -= MIXER_ONE;
+        }
+
+      /* Q15 so that the product fits into 32 bits */
+
+      frac = stream->phase >> 1;
+
+      for (ch = 0; ch < MIXER_NCHANNELS; ch++)
+        {
+          smp  = stream->prev[ch] +
+                 (((stream->cur[ch] - stream->prev[ch]) * frac) >> 15);
+          *dst++ = (int16_t)((smp * stream->gain) >> 15);
+        }
+
+      stream->phase += stream->step;
+    }
+
+  return nframes;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_accumulate
+ *
+ * Description:
+ *   Add 'nsamples' samples to the output with saturation.  Uses the Helium
+ *   (MVE) or the ARMv7E-M DSP saturating adds when the target has them.
+ *   Both buffers must be 32-bit aligned.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_accumulate(FAR int16_t *dst, FAR const int16_t *src,
+                                   size_t nsamples)
+{
+  int32_t sum;
+
+#if defined(MIXER_HAVE_MVE)
+  for (; nsamples >= 8; nsamples -= 8, dst += 8, src += 8)
+    {
+      vst1q_s16(dst, vqaddq_s16(vld1q_s16(dst), vld1q_s16(src)));
+    }
+
+#elif defined(MIXER_HAVE_SIMD32)
+  for (; nsamples >= 2; nsamples -= 2, dst += 2, src += 2)
+    {
+      FAR int16x2_t *d = (FAR int16x2_t *)dst;
+
+      *d = __qadd16(*d, *(FAR const int16x2_t *)src);
+    }
+#endif
+
+  for (; nsamples > 0; nsamples--, dst++, src++)
+    {
+      sum  = *dst + *src;
+      *dst = sum > INT16_MAX ? INT16_MAX :
+             sum < INT16_MIN ? INT16_MIN : sum;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_mixperiod
+ *
+ * Description:
+ *   Mix one period of all running streams into an output buffer.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_mixperiod(FAR struct audio_mixer_s *mixer,
+                                  FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream;
+  FAR int16_t *scratch = (FAR int16_t *)mixer->scratch;
+  unsigned int nframes;
+  int i;
+
+  memset(apb->samp, 0, MIXER_PERIODBYTES);
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->streams[i];
+      if (!stream->running || stream->paused)
+        {
+          continue;
+        }
+
+      nframes = audio_mixer_resample(stream, scratch,
+                                     CONFIG_AUDIO_MIXER_PERIOD);
+      audio_mixer_accumulate((FAR int16_t *)apb->samp, scratch,
+                             nframes * MIXER_NCHANNELS);
+
+      if (nframes < CONFIG_AUDIO_MIXER_PERIOD)
+        {
+          if (stream->final)
+            {
+              /* All of the stream has been mixed */
+
+              stream->running = false;
+              mixer->nrunning--;
+              audio_mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+            }
+          else
+            {
+              stream->underruns++;
+            }
+        }
+    }
+
+  apb->nbytes  = MIXER_PERIODBYTES;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fill
+ *
+ * Description:
+ *   Mix and enqueue the output buffers returned by the output device.  Stop
+ *   the output device once no stream is running and all mixed data has
+ *   been played.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_fill(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret;
+
+  while (mixer->started && mixer->nrunning > 0)
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mixer_mixperiod(mixer, apb);
+
+      flags = enter_critical_section();
+      mixer->nqueued++;
+      leave_critical_section(flags);
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: enqueuebuffer failed: %d\n", ret);
+
+          flags = enter_critical_section();
+          mixer->nqueued--;
+          dq_addfirst(&apb->dq_entry, &mixer->freeq);
+          leave_critical_section(flags);
+          break;
+        }
+    }
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  if (mixer->started && mixer->nrunning == 0 && mixer->nqueued == 0)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      lower->ops->stop(lower, mixer->session);
+#else
+      lower->ops->stop(lower);
+#endif
+      mixer->started = false;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+  audio_mixer_fill(mixer);
+  nxsem_post(&mixer->exclsem);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_startoutput
+ *
+ * Description:
+ *   Configure the output device, prime it with mixed buffers and start it.
+ *   Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_startoutput(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_caps_s caps;
+  int ret;
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = MIXER_NCHANNELS;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_RATE & 0xffff;
+  caps.ac_controls.b[2]  = 16;
+  caps.ac_controls.b[3]  = CONFIG_AUDIO_MIXER_RATE >> 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, mixer->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: configure failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Mix all free buffers before starting, then keep the output busy from
+   * the dequeue callback.
+   */
+
+  mixer->started = true;
+  audio_mixer_fill(mixer);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, mixer->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: start failed: %d\n", ret);
+      mixer->started = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stopstream
+ *
+ * Description:
+ *   Return all buffers of a stream and report its completion.  Called with
+ *   exclsem held.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stopstream(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)
+                dq_remfirst(&stream->pendq)) != NULL)
+    {
+      audio_mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  stream->queued = 0;
+
+  if (stream->running)
+    {
+      stream->running = false;
+      stream->mixer->nrunning--;
+      audio_mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description:
+ *   Get the capabilities of a stream:  16-bit PCM at any sample rate, mono
+ *   or stereo, with a volume control.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_channels      = MIXER_NCHANNELS;
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = MIXER_NCHANNELS;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            /* Every rate is resampled to the output rate */
+
+            caps->ac_controls.hw[0] =
+              AUDIO_SAMP_RATE_8K   | AUDIO_SAMP_RATE_11K  |
+              AUDIO_SAMP_RATE_16K  | AUDIO_SAMP_RATE_22K  |
+              AUDIO_SAMP_RATE_32K  | AUDIO_SAMP_RATE_44K  |
+              AUDIO_SAMP_RATE_48K  | AUDIO_SAMP_RATE_96K;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Set the format or the volume of a stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps)
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t samprate;
+  int ret = OK;
+
+  DEBUGASSERT(caps != NULL);
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0] |
+                   (caps->ac_controls.b[3] << 16);
+
+        if (caps->ac_controls.b[2] != 16 || samprate == 0 ||
+            caps->ac_channels < 1 || caps->ac_channels > MIXER_NCHANNELS)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        stream->samprate  = samprate;
+        stream->nchannels = caps->ac_channels;
+        stream->step      = (uint32_t)(((uint64_t)samprate << 16) /
+                                       CONFIG_AUDIO_MIXER_RATE);
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME &&
+            caps->ac_controls.hw[0] <= 1000)
+          {
+            stream->gain = (int16_t)(caps->ac_controls.hw[0] *
+                                     MIXER_UNITY / 1000);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxsem_wait_uninterruptible(&stream->mixer->exclsem);
+  audio_mixer_stopstream(stream);
+  nxsem_post(&stream->mixer->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing a stream, starting the output device if it is the first.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  if (!stream->running)
+    {
+      /* Load the first two input frames before producing output */
+
+      stream->phase   = 2 * MIXER_ONE;
+      stream->prev[0] = stream->prev[1] = 0;
+      stream->cur[0]  = stream->cur[1]  = 0;
+      stream->final   = false;
+      stream->paused  = false;
+      stream->running = true;
+      mixer->nrunning++;
+
+      if (!mixer->started)
+        {
+          ret = audio_mixer_startoutput(mixer);
+          if (ret < 0)
+            {
+              stream->running = false;
+              mixer->nrunning--;
+            }
+        }
+      else if (work_available(&mixer->work))
+        {
+          /* The output may be draining with buffers left unmixed */
+
+          work_queue(MIXER_WORK, &mixer->work, audio_mixer_worker, mixer, 0);
+        }
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  /* The output device is stopped by the worker once it has drained */
+
+  nxsem_wait_uninterruptible(&stream->mixer->exclsem);
+  audio_mixer_stopstream(stream);
+  nxsem_post(&stream->mixer->exclsem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause and audio_mixer_resume
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  stream->paused = true;
+  return OK;
+}
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session)
+#else
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  stream->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ *
+ * Description:
+ *   Queue a buffer of the client.  It is returned as soon as it has been
+ *   mixed.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t latency;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  apb->curbyte = 0;
+  if (apb->nbytes < stream->nchannels * sizeof(int16_t))
+    {
+      /* Nothing to mix (e.g., an empty final buffer) */
+
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          stream->final = true;
+        }
+
+      audio_mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+  else
+    {
+      dq_addlast(&apb->dq_entry, &stream->pendq);
+      stream->queued += apb->nbytes / (stream->nchannels * sizeof(int16_t));
+
+      latency = audio_mixer_latency(stream, NULL);
+      if (latency > stream->maxlatency)
+        {
+          stream->maxlatency = latency;
+        }
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  int ret = OK;
+
+  switch (cmd)
+    {
+      case AUDIOIOC_GETLATENCY:
+        {
+          FAR struct audio_latency_s *latency =
+            (FAR struct audio_latency_s *)((uintptr_t)arg);
+
+          if (latency == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          nxsem_wait_uninterruptible(&stream->mixer->exclsem);
+          latency->latency    = audio_mixer_latency(stream,
+                                                    &latency->output);
+          latency->maxlatency = stream->maxlatency;
+          latency->underruns  = stream->underruns;
+          nxsem_post(&stream->mixer->exclsem);
+        }
+        break;
+
+      case AUDIOIOC_HWRESET:
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve and audio_mixer_release
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session)
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  *session = dev;
+#endif
+  return OK;
+}
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session)
+#else
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   Called by the output device, possibly from an interrupt handler, when
+ *   it is done with a buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status, FAR void *session)
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        dq_addlast(&apb->dq_entry, &mixer->freeq);
+        mixer->nqueued--;
+        leave_critical_section(flags);
+
+        if (work_available(&mixer->work))
+          {
+            work_queue(MIXER_WORK, &mixer->work, audio_mixer_worker,
+                       mixer, 0);
+          }
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        auderr("ERROR: Output I/O error: %d\n", status);
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a software mixer on top of an output device and register its
+ *   input streams as the audio devices <name>0 ... <name>N-1.
+ *
+ * Input Parameters:
+ *   name     - The base name of the stream devices.
+ *   lower    - The output device.  It is owned by the mixer from now on.
+ *   nstreams - The number of input streams.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           int nstreams)
+{
+  FAR struct audio_mixer_s *mixer;
+  FAR struct audio_mixer_stream_s *stream;
+  struct audio_buf_desc_s bufdesc;
+  char devname[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && lower != NULL && nstreams > 0);
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mixer->streams = kmm_calloc(nstreams, sizeof(struct audio_mixer_stream_s));
+  if (mixer->streams == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_mixer;
+    }
+
+  mixer->lower    = lower;
+  mixer->nstreams = nstreams;
+  nxsem_init(&mixer->exclsem, 0, 1);
+
+  lower->upper = audio_mixer_callback;
+  lower->priv  = mixer;
+
+  /* The mixer is the only client of the output device */
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->reserve(lower, &mixer->session);
+#else
+  ret = lower->ops->reserve(lower);
+#endif
+  if (ret < 0)
+    {
+      goto errout_with_streams;
+    }
+
+  /* Allocate the output buffers, from DMA-capable memory if the output
+   * device provides its own allocator.
+   */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      bufdesc.session   = mixer->session;
+#endif
+      bufdesc.numbytes  = MIXER_PERIODBYTES;
+      bufdesc.u.pbuffer = &mixer->apb[i];
+
+      ret = lower->ops->allocbuffer != NULL ?
+            lower->ops->allocbuffer(lower, &bufdesc) : apb_alloc(&bufdesc);
+      if (ret < 0)
+        {
+          goto errout_with_buffers;
+        }
+
+      dq_addlast(&mixer->apb[i]->dq_entry, &mixer->freeq);
+    }
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream            = &mixer->streams[i];
+      stream->dev.ops   = &g_audio_mixer_ops;
+      stream->mixer     = mixer;
+      stream->samprate  = CONFIG_AUDIO_MIXER_RATE;
+      stream->nchannels = MIXER_NCHANNELS;
+      stream->step      = MIXER_ONE;
+      stream->gain      = MIXER_UNITY;
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->dev);
+      if (ret < 0)
+        {
+          /* The streams registered so far remain usable */
+
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+
+errout_with_buffers:
+  while (--i >= 0)
+    {
+      bufdesc.u.buffer = mixer->apb[i];
+      if (lower->ops->freebuffer != NULL)
+        {
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else
+        {
+          apb_free(mixer->apb[i]);
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  lower->ops->release(lower, mixer->session);
+#else
+  lower->ops->release(lower);
+#endif
+
+errout_with_streams:
+  nxsem_destroy(&mixer->exclsem);
+  kmm_free(mixer->streams);
+
+errout_with_mixer:
+  kmm_free(mixer);
+  return ret;
+}
@@ -52,10 +52,17 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/audio/audio.h>
 #include <nuttx/audio/pcm.h>
 
+#if defined(CONFIG_AUDIO_PCM_CONVERT) && defined(__ARM_FEATURE_SAT)
+#  include <arm_acle.h>
+#endif
+
 #if defined(CONFIG_AUDIO) && defined(CONFIG_AUDIO_FORMAT_PCM)
 
 /****************************************************************************
@@ -76,6 +83,15 @@
 #  define MAX(a,b) (((a) > (b)) ? (a) : (b))
 #endif
 
+/* Format conversion */
+
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+#  define PCM_ONE       (1 << 16)  /* One input frame (Q16) */
+#  define PCM_NTAPS     16         /* Taps per filter phase */
+#  define PCM_PHASEBITS 5          /* log2 of the number of filter phases */
+#  define PCM_NPHASES   (1 << PCM_PHASEBITS)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -128,6 +144,33 @@ struct pcm_decode_s
   uint8_t  skip;                   /* Number of sample bytes to be skipped */
   uint8_t  npartial;               /* Size of the partially copied sample */
 #endif
+
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  /* Format conversion and resampling to the native format of the lower
+   * level driver.
+   */
+
+  bool     convert;                /* Converting the current stream */
+  uint8_t  outbpsamp;              /* Output bits per sample */
+  uint8_t  outchannels;            /* Output channels */
+  uint8_t  outalign;               /* Output bytes per frame */
+  uint32_t outrate;                /* Output sample rate */
+  uint32_t step;                   /* Input frames per output frame (Q16) */
+  uint32_t phase;                  /* Output position after the newest
+                                    * frame in the history (Q16) */
+  uint8_t  histpos;                /* Oldest frame in the history */
+  int32_t  hist[2][2 * PCM_NTAPS]; /* Mirrored history of each channel */
+
+  sem_t    convsem;                /* Serializes the conversion */
+  struct work_s work;              /* Resumes the conversion */
+  struct dq_queue_s pendq;         /* Input buffers to be converted */
+  struct dq_queue_s freeq;         /* Free output buffers */
+  FAR struct ap_buffer_s *curout;  /* Output buffer being filled */
+  FAR struct ap_buffer_s *outapb[CONFIG_AUDIO_PCM_NBUFFERS];
+
+  int32_t  inwork[2 * CONFIG_AUDIO_PCM_CHUNK];  /* Unpacked input */
+  int32_t  outwork[2 * CONFIG_AUDIO_PCM_CHUNK]; /* Resampled output */
+#endif
 };
 
 /****************************************************************************
@@ -160,6 +203,12 @@ static void pcm_subsample(FAR struct pcm_decode_s *priv,
               FAR struct ap_buffer_s *apb);
 #endif
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+static void pcm_convert_run(FAR struct pcm_decode_s *priv);
+static bool pcm_convert_configure(FAR struct pcm_decode_s *priv);
+static void pcm_convert_reset(FAR struct pcm_decode_s *priv);
+#endif
+
 /* struct audio_lowerhalf_s methods *****************************************/
 
 static int  pcm_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
@@ -243,6 +292,146 @@ static void pcm_callback(FAR void *arg, uint16_t reason,
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+/* Polyphase low-pass filter for resampling:  A Kaiser-windowed (beta = 6)
+ * sinc with a cutoff at 0.9 times the input Nyquist frequency.  Row 'p'
+ * interpolates at p/32 of an input frame after tap 7.  Each row is scaled
+ * to a DC gain of exactly 1.0 (Q15).
+ */
+
+static const int16_t g_pcm_coef[PCM_NPHASES][PCM_NTAPS] =
+{
+  {
+        81,   -270,    638,  -1197,   1889,  -2576,   3086,  29477,
+      3086,  -2576,   1889,  -1197,    638,   -270,     81,    -11
+  },
+  {
+        83,   -269,    621,  -1135,   1727,  -2206,   2162,  29438,
+      4050,  -2940,   2041,  -1252,    650,   -269,     78,    -11
+  },
+  {
+        83,   -266,    600,  -1067,   1558,  -1834,   1281,  29320,
+      5048,  -3296,   2182,  -1298,    657,   -265,     75,    -10
+  },
+  {
+        83,   -261,    574,   -992,   1382,  -1462,    444,  29126,
+      6079,  -3641,   2310,  -1335,    659,   -259,     70,     -9
+  },
+  {
+        82,   -253,    545,   -912,   1202,  -1094,   -345,  28849,
+      7138,  -3970,   2424,  -1362,    655,   -249,     65,     -7
+  },
+  {
+        81,   -244,    513,   -828,   1019,   -733,  -1084,  28500,
+      8221,  -4282,   2523,  -1379,    645,   -237,     58,     -5
+  },
+  {
+        78,   -234,    479,   -741,    835,   -379,  -1771,  28076,
+      9324,  -4572,   2604,  -1385,    630,   -223,     50,     -3
+  },
+  {
+        76,   -222,    441,   -651,    651,    -37,  -2405,  27578,
+     10442,  -4837,   2667,  -1379,    608,   -205,     41,      0
+  },
+  {
+        72,   -208,    402,   -559,    468,    292,  -2984,  27012,
+     11571,  -5075,   2710,  -1362,    580,   -185,     31,      3
+  },
+  {
+        68,   -194,    362,   -467,    289,    605,  -3509,  26380,
+     12705,  -5281,   2733,  -1333,    546,   -162,     20,      6
+  },
+  {
+        64,   -179,    320,   -375,    114,    902,  -3977,  25684,
+     13839,  -5454,   2734,  -1291,    506,   -136,      8,      9
+  },
+  {
+        60,   -163,    277,   -283,    -56,   1179,  -4389,  24927,
+     14969,  -5589,   2712,  -1237,    459,   -107,     -4,     13
+  },
+  {
+        55,   -146,    235,   -192,   -218,   1437,  -4745,  24112,
+     16090,  -5685,   2666,  -1170,    407,    -77,    -18,     17
+  },
+  {
+        50,   -130,    192,   -104,   -373,   1673,  -5045,  23248,
+     17197,  -5739,   2597,  -1091,    348,    -43,    -33,     21
+  },
+  {
+        45,   -113,    150,    -19,   -519,   1887,  -5291,  22333,
+     18283,  -5747,   2504,  -1000,    285,     -8,    -48,     26
+  },
+  {
+        40,    -96,    108,     64,   -655,   2077,  -5482,  21374,
+     19345,  -5709,   2386,   -896,    216,     29,    -64,     31
+  },
+  {
+        35,    -80,     68,    142,   -781,   2244,  -5621,  20377,
+     20377,  -5621,   2244,   -781,    142,     68,    -80,     35
+  },
+  {
+        31,    -64,     29,    216,   -896,   2386,  -5709,  19345,
+     21374,  -5482,   2077,   -655,     64,    108,    -96,     40
+  },
+  {
+        26,    -48,     -8,    285,  -1000,   2504,  -5747,  18283,
+     22333,  -5291,   1887,   -519,    -19,    150,   -113,     45
+  },
+  {
+        21,    -33,    -43,    348,  -1091,   2597,  -5739,  17197,
+     23248,  -5045,   1673,   -373,   -104,    192,   -130,     50
+  },
+  {
+        17,    -18,    -77,    407,  -1170,   2666,  -5685,  16090,
+     24112,  -4745,   1437,   -218,   -192,    235,   -146,     55
+  },
+  {
+        13,     -4,   -107,    459,  -1237,   2712,  -5589,  14969,
+     24927,  -4389,   1179,    -56,   -283,    277,   -163,     60
+  },
+  {
+         9,      8,   -136,    506,  -1291,   2734,  -5454,  13839,
+     25684,  -3977,    902,    114,   -375,    320,   -179,     64
+  },
+  {
+         6,     20,   -162,    546,  -1333,   2733,  -5281,  12705,
+     26380,  -3509,    605,    289,   -467,    362,   -194,     68
+  },
+  {
+         3,     31,   -185,    580,  -1362,   2710,  -5075,  11571,
+     27012,  -2984,    292,    468,   -559,    402,   -208,     72
+  },
+  {
+         0,     41,   -205,    608,  -1379,   2667,  -4837,  10442,
+     27578,  -2405,    -37,    651,   -651,    441,   -222,     76
+  },
+  {
+        -3,     50,   -223,    630,  -1385,   2604,  -4572,   9324,
+     28076,  -1771,   -379,    835,   -741,    479,   -234,     78
+  },
+  {
+        -5,     58,   -237,    645,  -1379,   2523,  -4282,   8221,
+     28500,  -1084,   -733,   1019,   -828,    513,   -244,     81
+  },
+  {
+        -7,     65,   -249,    655,  -1362,   2424,  -3970,   7138,
+     28849,   -345,  -1094,   1202,   -912,    545,   -253,     82
+  },
+  {
+        -9,     70,   -259,    659,  -1335,   2310,  -3641,   6079,
+     29126,    444,  -1462,   1382,   -992,    574,   -261,     83
+  },
+  {
+       -10,     75,   -265,    657,  -1298,   2182,  -3296,   5048,
+     29320,   1281,  -1834,   1558,  -1067,    600,   -266,     83
+  },
+  {
+       -11,     78,   -269,    650,  -1252,   2041,  -2940,   4050,
+     29438,   2162,  -2206,   1727,  -1135,    621,   -269,     83
+  }
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -399,7 +588,12 @@ static bool pcm_parsewav(FAR struct pcm_decode_s *priv, uint8_t *data)
        * number of channels and sample sizes that we can handle.
        */
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+      if (priv->bpsamp != 8 && priv->bpsamp != 16 &&
+          priv->bpsamp != 24 && priv->bpsamp != 32)
+#else
       if (priv->bpsamp != 8 && priv->bpsamp != 16)
+#endif
         {
           auderr("ERROR: %d bits per sample are not suported in this mode\n",
                  priv->bpsamp);
@@ -664,6 +858,475 @@ static void pcm_subsample(FAR struct pcm_decode_s *priv,
 }
 #endif
 
+/****************************************************************************
+ * Name: pcm_unpack
+ *
+ * Description:
+ *   Convert 'nsamples' little-endian samples of 'bpsamp' bits to signed
+ *   24-bit values in 32-bit words.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+static void pcm_unpack(FAR const uint8_t *src, FAR int32_t *dest,
+                       unsigned int nsamples, uint8_t bpsamp)
+{
+  unsigned int i;
+
+  switch (bpsamp)
+    {
+      case 8:
+        for (i = 0; i < nsamples; i++, src++)
+          {
+            *dest++ = ((int32_t)src[0] - 128) << 16;
+          }
+        break;
+
+      case 16:
+        for (i = 0; i < nsamples; i++, src += 2)
+          {
+            *dest++ = (int32_t)(int16_t)(src[0] | (src[1] << 8)) << 8;
+          }
+        break;
+
+      case 24:
+        for (i = 0; i < nsamples; i++, src += 3)
+          {
+            *dest++ = (int32_t)((uint32_t)src[0] << 8 |
+                                (uint32_t)src[1] << 16 |
+                                (uint32_t)src[2] << 24) >> 8;
+          }
+        break;
+
+      default:
+        for (i = 0; i < nsamples; i++, src += 4)
+          {
+            *dest++ = (int32_t)((uint32_t)src[0]       |
+                                (uint32_t)src[1] << 8  |
+                                (uint32_t)src[2] << 16 |
+                                (uint32_t)src[3] << 24) >> 8;
+          }
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: pcm_saturate
+ *
+ * Description:
+ *   Limit a value to 'bits' signed bits.
+ *
+ ****************************************************************************/
+
+#if defined(__ARM_FEATURE_SAT)
+#  define pcm_saturate(v, bits) __ssat((v), (bits))
+#else
+static inline int32_t pcm_saturate(int32_t value, int bits)
+{
+  int32_t max = (1 << (bits - 1)) - 1;
+
+  return value > max ? max : value < -max - 1 ? -max - 1 : value;
+}
+#endif
+
+/****************************************************************************
+ * Name: pcm_pack
+ *
+ * Description:
+ *   Convert 'nframes' frames of 'inch' channels of 24-bit values to the
+ *   output format, mapping mono to stereo or stereo to mono.
+ *
+ * Returned Value:
+ *   The number of bytes written.
+ *
+ ****************************************************************************/
+
+static unsigned int pcm_pack(FAR struct pcm_decode_s *priv,
+                             FAR const int32_t *src, FAR uint8_t *dest,
+                             unsigned int nframes)
+{
+  FAR uint8_t *start = dest;
+  uint8_t inch = priv->nchannels;
+  uint8_t outch = priv->outchannels;
+  int32_t frame[2];
+  int32_t value;
+  unsigned int i;
+  int ch;
+
+  for (i = 0; i < nframes; i++, src += inch)
+    {
+      frame[0] = src[0];
+      frame[1] = inch > 1 ? src[1] : src[0];
+
+      if (outch == 1 && inch > 1)
+        {
+          frame[0] = (frame[0] + frame[1]) >> 1;
+        }
+
+      for (ch = 0; ch < outch; ch++)
+        {
+          value = frame[ch];
+
+          switch (priv->outbpsamp)
+            {
+              case 8:
+                value   = pcm_saturate(value >> 16, 8) + 128;
+                *dest++ = (uint8_t)value;
+                break;
+
+              case 16:
+                value   = pcm_saturate(value >> 8, 16);
+                *dest++ = (uint8_t)value;
+                *dest++ = (uint8_t)(value >> 8);
+                break;
+
+              case 24:
+                value   = pcm_saturate(value, 24);
+                *dest++ = (uint8_t)value;
+                *dest++ = (uint8_t)(value >> 8);
+                *dest++ = (uint8_t)(value >> 16);
+                break;
+
+              default:
+                value   = pcm_saturate(value, 24);
+                *dest++ = 0;
+                *dest++ = (uint8_t)value;
+                *dest++ = (uint8_t)(value >> 8);
+                *dest++ = (uint8_t)(value >> 16);
+                break;
+            }
+        }
+    }
+
+  return dest - start;
+}
+
+/****************************************************************************
+ * Name: pcm_resample
+ *
+ * Description:
+ *   Run the polyphase resampler over 'nin' unpacked input frames and
+ *   produce up to 'maxout' output frames.  The output frame at a fractional
+ *   position between two input frames is computed with the filter phase
+ *   nearest to that position.
+ *
+ * Returned Value:
+ *   The number of output frames produced.  The number of input frames
+ *   consumed is returned in *nused.
+ *
+ ****************************************************************************/
+
+static unsigned int pcm_resample(FAR struct pcm_decode_s *priv,
+                                 FAR const int32_t *src, unsigned int nin,
+                                 FAR int32_t *dest, unsigned int maxout,
+                                 FAR unsigned int *nused)
+{
+  FAR const int16_t *coef;
+  FAR const int32_t *hist;
+  uint8_t inch = priv->nchannels;
+  unsigned int nout = 0;
+  unsigned int used = 0;
+  int64_t acc;
+  int ch;
+  int k;
+
+  while (nout < maxout)
+    {
+      /* Shift in input frames until the output position is reached */
+
+      while (priv->phase >= PCM_ONE)
+        {
+          if (used >= nin)
+            {
+              goto done;
+            }
+
+          for (ch = 0; ch < inch; ch++)
+            {
+              priv->hist[ch][priv->histpos] = src[ch];
+              priv->hist[ch][priv->histpos + PCM_NTAPS] = src[ch];
+            }
+
+          priv->histpos = (priv->histpos + 1) % PCM_NTAPS;
+          priv->phase  -= PCM_ONE;
+          src          += inch;
+          used++;
+        }
+
+      coef = g_pcm_coef[priv->phase >> (16 - PCM_PHASEBITS)];
+
+      for (ch = 0; ch < inch; ch++)
+        {
+          hist = &priv->hist[ch][priv->histpos];
+          acc  = 0;
+
+          for (k = 0; k < PCM_NTAPS; k++)
+            {
+              acc += (int64_t)hist[k] * coef[k];
+            }
+
+          *dest++ = (int32_t)(acc >> 15);
+        }
+
+      priv->phase += priv->step;
+      nout++;
+    }
+
+done:
+  *nused = used;
+  return nout;
+}
+
+/****************************************************************************
+ * Name: pcm_convert_buffer
+ *
+ * Description:
+ *   Convert as much of the input buffer as fits into the output buffer,
+ *   one chunk of CONFIG_AUDIO_PCM_CHUNK frames at a time.
+ *
+ * Returned Value:
+ *   true if the input buffer has been consumed.
+ *
+ ****************************************************************************/
+
+static bool pcm_convert_buffer(FAR struct pcm_decode_s *priv,
+                               FAR struct ap_buffer_s *in,
+                               FAR struct ap_buffer_s *out)
+{
+  unsigned int navail;
+  unsigned int nspace;
+  unsigned int nin;
+  unsigned int nout;
+  unsigned int nused;
+
+  for (; ; )
+    {
+      navail = (in->nbytes - in->curbyte) / priv->align;
+      nspace = (out->nmaxbytes - out->nbytes) / priv->outalign;
+      if (navail == 0 || nspace == 0)
+        {
+          return navail == 0;
+        }
+
+      nin = MIN(navail, CONFIG_AUDIO_PCM_CHUNK);
+      pcm_unpack(&in->samp[in->curbyte], priv->inwork,
+                 nin * priv->nchannels, priv->bpsamp);
+
+      if (priv->step == PCM_ONE)
+        {
+          /* No resampling, only format conversion */
+
+          nout  = MIN(nin, nspace);
+          nused = nout;
+          out->nbytes += pcm_pack(priv, priv->inwork,
+                                  &out->samp[out->nbytes], nout);
+        }
+      else
+        {
+          nout = pcm_resample(priv, priv->inwork, nin, priv->outwork,
+                              MIN(nspace, CONFIG_AUDIO_PCM_CHUNK), &nused);
+          out->nbytes += pcm_pack(priv, priv->outwork,
+                                  &out->samp[out->nbytes], nout);
+        }
+
+      in->curbyte += nused * priv->align;
+    }
+}
+
+/****************************************************************************
+ * Name: pcm_convert_run
+ *
+ * Description:
+ *   Convert the pending input buffers into free output buffers.  Input
+ *   buffers are returned to the client as soon as they are converted and
+ *   output buffers are passed to the lower half when they are full or
+ *   hold the end of the stream.
+ *
+ ****************************************************************************/
+
+static void pcm_convert_run(FAR struct pcm_decode_s *priv)
+{
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+  FAR struct ap_buffer_s *in;
+  FAR struct ap_buffer_s *out;
+  irqstate_t flags;
+  bool final;
+  int ret;
+
+  nxsem_wait_uninterruptible(&priv->convsem);
+
+  while ((in = (FAR struct ap_buffer_s *)dq_peek(&priv->pendq)) != NULL)
+    {
+      if (priv->curout == NULL)
+        {
+          flags = enter_critical_section();
+          priv->curout = (FAR struct ap_buffer_s *)dq_remfirst(&priv->freeq);
+          leave_critical_section(flags);
+
+          if (priv->curout == NULL)
+            {
+              /* Continued when the lower half returns a buffer */
+
+              break;
+            }
+
+          priv->curout->nbytes  = 0;
+          priv->curout->curbyte = 0;
+          priv->curout->flags   = 0;
+        }
+
+      out   = priv->curout;
+      final = false;
+
+      if (pcm_convert_buffer(priv, in, out))
+        {
+          dq_remfirst(&priv->pendq);
+          final = (in->flags & AUDIO_APB_FINAL) != 0;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          priv->export.upper(priv->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                             in, OK, priv->session);
+#else
+          priv->export.upper(priv->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                             in, OK);
+#endif
+        }
+
+      if (final || out->nmaxbytes - out->nbytes < priv->outalign)
+        {
+          if (final)
+            {
+              out->flags |= AUDIO_APB_FINAL;
+            }
+
+          priv->curout = NULL;
+          ret = lower->ops->enqueuebuffer(lower, out);
+          if (ret < 0)
+            {
+              auderr("ERROR: enqueuebuffer failed: %d\n", ret);
+
+              flags = enter_critical_section();
+              dq_addlast(&out->dq_entry, &priv->freeq);
+              leave_critical_section(flags);
+            }
+        }
+    }
+
+  nxsem_post(&priv->convsem);
+}
+
+/****************************************************************************
+ * Name: pcm_convert_worker
+ ****************************************************************************/
+
+static void pcm_convert_worker(FAR void *arg)
+{
+  pcm_convert_run((FAR struct pcm_decode_s *)arg);
+}
+
+/****************************************************************************
+ * Name: pcm_convert_configure
+ *
+ * Description:
+ *   Select the output format for the stream that has just been parsed and
+ *   reset the converter.
+ *
+ * Returned Value:
+ *   true if the stream needs to be converted.
+ *
+ ****************************************************************************/
+
+static bool pcm_convert_configure(FAR struct pcm_decode_s *priv)
+{
+  priv->outrate     = CONFIG_AUDIO_PCM_OUTRATE > 0 ?
+                      CONFIG_AUDIO_PCM_OUTRATE : priv->samprate;
+  priv->outbpsamp   = CONFIG_AUDIO_PCM_OUTBPSAMP > 0 ?
+                      CONFIG_AUDIO_PCM_OUTBPSAMP : priv->bpsamp;
+  priv->outchannels = CONFIG_AUDIO_PCM_OUTCHANNELS > 0 ?
+                      CONFIG_AUDIO_PCM_OUTCHANNELS : priv->nchannels;
+  priv->outalign    = priv->outchannels * priv->outbpsamp / 8;
+
+  priv->convert = priv->outrate != priv->samprate ||
+                  priv->outbpsamp != priv->bpsamp ||
+                  priv->outchannels != priv->nchannels;
+
+  priv->step    = (uint32_t)(((uint64_t)priv->samprate << 16) /
+                             priv->outrate);
+  priv->phase   = PCM_ONE;
+  priv->histpos = 0;
+  memset(priv->hist, 0, sizeof(priv->hist));
+
+  audinfo("Convert %d: %lu/%d/%d -> %lu/%d/%d\n", priv->convert,
+          (unsigned long)priv->samprate, priv->bpsamp, priv->nchannels,
+          (unsigned long)priv->outrate, priv->outbpsamp, priv->outchannels);
+  return priv->convert;
+}
+
+/****************************************************************************
+ * Name: pcm_convert_reset
+ *
+ * Description:
+ *   Return the pending input buffers to the client when the stream is
+ *   stopped.
+ *
+ ****************************************************************************/
+
+static void pcm_convert_reset(FAR struct pcm_decode_s *priv)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  nxsem_wait_uninterruptible(&priv->convsem);
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&priv->pendq)) != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      priv->export.upper(priv->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                         apb, OK, priv->session);
+#else
+      priv->export.upper(priv->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                         apb, OK);
+#endif
+    }
+
+  if (priv->curout != NULL)
+    {
+      flags = enter_critical_section();
+      dq_addlast(&priv->curout->dq_entry, &priv->freeq);
+      leave_critical_section(flags);
+      priv->curout = NULL;
+    }
+
+  priv->convert = false;
+  nxsem_post(&priv->convsem);
+}
+
+/****************************************************************************
+ * Name: pcm_convert_isours
+ *
+ * Description:
+ *   Check if a buffer returned by the lower half is an output buffer of
+ *   the converter.
+ *
+ ****************************************************************************/
+
+static bool pcm_convert_isours(FAR struct pcm_decode_s *priv,
+                               FAR struct ap_buffer_s *apb)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_PCM_NBUFFERS; i++)
+    {
+      if (priv->outapb[i] == apb)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif /* CONFIG_AUDIO_PCM_CONVERT */
+
 /****************************************************************************
  * Name: pcm_getcaps
  *
@@ -798,6 +1461,10 @@ static int pcm_shutdown(FAR struct audio_lowerhalf_s *dev)
 
   priv->streaming = false;
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  pcm_convert_reset(priv);
+#endif
+
   /* Defer the operation to the lower device driver */
 
   lower = priv->lower;
@@ -867,6 +1534,10 @@ static int pcm_stop(FAR struct audio_lowerhalf_s *dev)
 
   priv->streaming = false;
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  pcm_convert_reset(priv);
+#endif
+
   /* Defer the operation to the lower device driver */
 
   lower = priv->lower;
@@ -1063,6 +1734,17 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
       pcm_subsample(priv, apb);
 #endif
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+      if (priv->convert)
+        {
+          /* Convert the buffer into our own output buffers */
+
+          dq_addlast(&apb->dq_entry, &priv->pendq);
+          pcm_convert_run(priv);
+          return OK;
+        }
+#endif
+
       /* Then give the audio buffer to the lower driver */
 
       audinfo("Pass to lower enqueuebuffer: apb=%p curbyte=%d nbytes=%d\n",
@@ -1093,6 +1775,21 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
            * and sample bitwidth.
            */
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+          /* Configure the lower level for the format that it will receive
+           * after the conversion.
+           */
+
+          pcm_convert_configure(priv);
+
+          caps.ac_len            = sizeof(struct audio_caps_s);
+          caps.ac_type           = AUDIO_TYPE_OUTPUT;
+          caps.ac_channels       = priv->outchannels;
+
+          caps.ac_controls.hw[0] = (uint16_t)priv->outrate;
+          caps.ac_controls.b[2]  = priv->outbpsamp;
+          caps.ac_controls.b[3]  = (uint8_t)(priv->outrate >> 16);
+#else
           DEBUGASSERT(priv->samprate < 65535);
 
           caps.ac_len            = sizeof(struct audio_caps_s);
@@ -1101,6 +1798,7 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
 
           caps.ac_controls.hw[0] = (uint16_t)priv->samprate;
           caps.ac_controls.b[2]  = priv->bpsamp;
+#endif
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
           ret = lower->ops->configure(lower, priv->session, &caps);
@@ -1126,6 +1824,17 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
           pcm_subsample(priv, apb);
 #endif
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+          if (priv->convert)
+            {
+              priv->streaming = ((apb->flags & AUDIO_APB_FINAL) == 0);
+
+              dq_addlast(&apb->dq_entry, &priv->pendq);
+              pcm_convert_run(priv);
+              return OK;
+            }
+#endif
+
           /* Then give the audio buffer to the lower driver */
 
           audinfo(
@@ -1340,9 +2049,32 @@ static void pcm_callback(FAR void *arg, uint16_t reason,
 #endif
 {
   FAR struct pcm_decode_s *priv = (FAR struct pcm_decode_s *)arg;
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  irqstate_t flags;
+#endif
 
   DEBUGASSERT(priv && priv->export.upper);
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  /* Our output buffers are recycled.  This may be called from an interrupt
+   * handler, so the conversion is resumed on the work queue.
+   */
+
+  if (reason == AUDIO_CALLBACK_DEQUEUE && pcm_convert_isours(priv, apb))
+    {
+      flags = enter_critical_section();
+      dq_addlast(&apb->dq_entry, &priv->freeq);
+      leave_critical_section(flags);
+
+      if (work_available(&priv->work))
+        {
+          work_queue(LPWORK, &priv->work, pcm_convert_worker, priv, 0);
+        }
+
+      return;
+    }
+#endif
+
   /* The buffer belongs to an upper level.  Just forward the event to
    * the next level up.
    */
@@ -1382,6 +2114,11 @@ FAR struct audio_lowerhalf_s *
 {
   FAR struct pcm_decode_s *priv;
   FAR struct audio_ops_s *ops;
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  struct audio_buf_desc_s bufdesc;
+  int ret;
+  int i;
+#endif
 
   /* Allocate an instance of our private data structure */
 
@@ -1443,6 +2180,47 @@ FAR struct audio_lowerhalf_s *
   dev->upper           = pcm_callback;
   dev->priv            = priv;
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  /* Allocate the output buffers of the converter from the lower level
+   * driver (which may need DMA-capable memory).
+   */
+
+  nxsem_init(&priv->convsem, 0, 1);
+
+  for (i = 0; i < CONFIG_AUDIO_PCM_NBUFFERS; i++)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+      bufdesc.numbytes  = CONFIG_AUDIO_PCM_BUFSIZE;
+      bufdesc.u.pbuffer = &priv->outapb[i];
+
+      ret = dev->ops->allocbuffer != NULL ?
+            dev->ops->allocbuffer(dev, &bufdesc) : apb_alloc(&bufdesc);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to allocate output buffers: %d\n", ret);
+
+          while (--i >= 0)
+            {
+              bufdesc.u.buffer = priv->outapb[i];
+              if (dev->ops->freebuffer != NULL)
+                {
+                  dev->ops->freebuffer(dev, &bufdesc);
+                }
+              else
+                {
+                  apb_free(priv->outapb[i]);
+                }
+            }
+
+          nxsem_destroy(&priv->convsem);
+          kmm_free(priv);
+          return NULL;
+        }
+
+      dq_addlast(&priv->outapb[i]->dq_entry, &priv->freeq);
+    }
+#endif
+
   return &priv->export;
 }
 
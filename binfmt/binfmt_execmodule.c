@@ -133,7 +133,8 @@ int exec_module(FAR const struct binary_s *binp)
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)
+        nxsched_alloc_tcb(sizeof(struct task_tcb_s));
   if (!tcb)
     {
       return -ENOMEM;
@@ -267,7 +268,7 @@ errout_with_addrenv:
 
 errout_with_tcb:
 #endif
-  kmm_free(tcb);
+  nxsched_free_tcb(&tcb->cmn);
   return ret;
 }
 
@@ -96,7 +96,11 @@ static struct binfmt_s g_elfbinfmt =
 {
   NULL,             /* next */
   elf_loadbinary,   /* load */
+#ifdef CONFIG_ELF_SHARETEXT
+  elf_share_unload, /* unload */
+#else
   NULL,             /* unload */
+#endif
 };
 
 /****************************************************************************
@@ -238,6 +242,12 @@ static int elf_loadbinary(FAR struct binary_s *binp)
       goto errout;
     }
 
+#ifdef CONFIG_ELF_SHARETEXT
+  /* Reuse the text of an instance of the same file that is still loaded */
+
+  elf_share_find(binp->filename, &loadinfo);
+#endif
+
   /* Load the program binary */
 
   ret = elf_load(&loadinfo);
@@ -276,6 +286,22 @@ static int elf_loadbinary(FAR struct binary_s *binp)
    */
 
   up_addrenv_clone(&loadinfo.addrenv, &binp->addrenv);
+#elif defined(CONFIG_ELF_SHARETEXT)
+  /* Offer the text to later instances.  Shared text is released by
+   * elf_share_unload(); otherwise text and data are separate allocations.
+   */
+
+  elf_share_add(binp->filename, &loadinfo);
+  if (loadinfo.share == NULL)
+    {
+      binp->alloc[BINFMT_NALLOC - 1] = (FAR void *)loadinfo.textalloc;
+    }
+
+  binp->alloc[0]  = (FAR void *)loadinfo.dataalloc;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  binp->alloc[1]  = loadinfo.ctoralloc;
+  binp->alloc[2]  = loadinfo.dtoralloc;
+#endif
 #else
   binp->alloc[0]  = (FAR void *)loadinfo.textalloc;
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
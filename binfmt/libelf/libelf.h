@@ -346,4 +346,62 @@ int elf_addrenv_alloc(FAR struct elf_loadinfo_s *loadinfo, size_t textsize,
 
 void elf_addrenv_free(FAR struct elf_loadinfo_s *loadinfo);
 
+#ifdef CONFIG_ELF_SHARETEXT
+/****************************************************************************
+ * Name: elf_share_find
+ *
+ * Description:
+ *   Look for a loaded instance of the same file (same path, size and
+ *   modification time) whose text can be shared.  On success a reference
+ *   is taken and loadinfo->share is set.
+ *
+ ****************************************************************************/
+
+void elf_share_find(FAR const char *filename,
+                    FAR struct elf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: elf_share_add
+ *
+ * Description:
+ *   After a successful load and bind, offer the text of a new image for
+ *   sharing.  Nothing is done if the text depends on this instance's data.
+ *   On success loadinfo->share owns the text.
+ *
+ ****************************************************************************/
+
+void elf_share_add(FAR const char *filename,
+                   FAR struct elf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: elf_share_text
+ *
+ * Description:
+ *   Return the address of the shared text.
+ *
+ ****************************************************************************/
+
+uintptr_t elf_share_text(FAR struct elf_share_s *share);
+
+/****************************************************************************
+ * Name: elf_share_release
+ *
+ * Description:
+ *   Drop a reference to shared text; the last reference frees it.
+ *
+ ****************************************************************************/
+
+void elf_share_release(FAR struct elf_share_s *share);
+
+/****************************************************************************
+ * Name: elf_share_unload
+ *
+ * Description:
+ *   binfmt unload method:  release the shared text used by 'binp', if any.
+ *
+ ****************************************************************************/
+
+int elf_share_unload(FAR struct binary_s *binp);
+#endif
+
 #endif /* __BINFMT_LIBELF_LIBELF_H */
@@ -128,6 +128,40 @@ int elf_addrenv_alloc(FAR struct elf_loadinfo_s *loadinfo, size_t textsize,
 
   loadinfo->textalloc = (uintptr_t)vtext;
   loadinfo->dataalloc = (uintptr_t)vdata;
+  return OK;
+#elif defined(CONFIG_ELF_SHARETEXT)
+  /* Text and data are allocated separately so that the text can be
+   * shared with later instances.  A shared image brings its own text.
+   */
+
+  if (loadinfo->share != NULL)
+    {
+      loadinfo->textalloc = elf_share_text(loadinfo->share);
+    }
+  else if (textsize > 0)
+    {
+      loadinfo->textalloc = (uintptr_t)kumm_malloc(textsize);
+      if (!loadinfo->textalloc)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  if (datasize > 0)
+    {
+      loadinfo->dataalloc = (uintptr_t)kumm_malloc(datasize);
+      if (!loadinfo->dataalloc)
+        {
+          if (loadinfo->share == NULL && loadinfo->textalloc != 0)
+            {
+              kumm_free((FAR void *)loadinfo->textalloc);
+            }
+
+          loadinfo->textalloc = 0;
+          return -ENOMEM;
+        }
+    }
+
   return OK;
 #else
   /* Allocate memory to hold the ELF image */
@@ -173,6 +207,23 @@ void elf_addrenv_free(FAR struct elf_loadinfo_s *loadinfo)
     {
       berr("ERROR: up_addrenv_destroy failed: %d\n", ret);
     }
+#elif defined(CONFIG_ELF_SHARETEXT)
+  /* Drop the reference to shared text, or free our own */
+
+  if (loadinfo->share != NULL)
+    {
+      elf_share_release(loadinfo->share);
+      loadinfo->share = NULL;
+    }
+  else if (loadinfo->textalloc != 0)
+    {
+      kumm_free((FAR void *)loadinfo->textalloc);
+    }
+
+  if (loadinfo->dataalloc != 0)
+    {
+      kumm_free((FAR void *)loadinfo->dataalloc);
+    }
 #else
   /* If there is an allocation for the ELF image, free it */
 
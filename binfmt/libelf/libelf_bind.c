@@ -171,6 +171,32 @@ static inline int elf_readrelas(FAR struct elf_loadinfo_s *loadinfo,
                   relsec->sh_offset + offset);
 }
 
+/****************************************************************************
+ * Name: elf_checkshared
+ *
+ * Description:
+ *   A relocation in a read-only section that refers to a symbol in a
+ *   writable section makes the text depend on where this instance's data
+ *   lives.  Such text cannot be shared with other instances.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_SHARETEXT
+static inline void elf_checkshared(FAR struct elf_loadinfo_s *loadinfo,
+                                   FAR const Elf_Shdr *dstsec,
+                                   FAR const Elf_Sym *sym)
+{
+  if (sym != NULL && (dstsec->sh_flags & SHF_WRITE) == 0 &&
+      sym->st_shndx != SHN_UNDEF && sym->st_shndx < loadinfo->ehdr.e_shnum &&
+      (loadinfo->shdr[sym->st_shndx].sh_flags & SHF_WRITE) != 0)
+    {
+      loadinfo->textpriv = true;
+    }
+}
+#else
+#  define elf_checkshared(l,d,s)
+#endif
+
 /****************************************************************************
  * Name: elf_relocate and elf_relocateadd
  *
@@ -332,6 +358,8 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
           sym = NULL;
         }
 
+      elf_checkshared(loadinfo, dstsec, sym);
+
       /* Calculate the relocation address. */
 
       if (rel->r_offset < 0 ||
@@ -516,6 +544,8 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
           sym = NULL;
         }
 
+      elf_checkshared(loadinfo, dstsec, sym);
+
       /* Calculate the relocation address. */
 
       if (rela->r_offset < 0 ||
@@ -631,6 +661,16 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
           continue;
         }
 
+#ifdef CONFIG_ELF_SHARETEXT
+      /* Shared text has already been relocated by the first instance */
+
+      if (loadinfo->share != NULL &&
+          (loadinfo->shdr[infosec].sh_flags & SHF_WRITE) == 0)
+        {
+          continue;
+        }
+#endif
+
       /* Process the relocations by type */
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
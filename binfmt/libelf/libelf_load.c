@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -52,6 +53,8 @@
 #include <nuttx/arch.h>
 #include <nuttx/addrenv.h>
 #include <nuttx/elf.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/binfmt/elf.h>
 
@@ -81,6 +84,74 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: elf_xipprobe
+ *
+ * Description:
+ *   Find out if the ELF file is directly addressable in memory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static void elf_xipprobe(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR void *addr = NULL;
+  int ret;
+
+  ret = nx_ioctl(loadinfo->filfd, FIOC_MMAP,
+                 (unsigned long)((uintptr_t)&addr));
+  loadinfo->xipbase = ret >= 0 ? (FAR const uint8_t *)addr : NULL;
+
+  binfo("XIP base: %p\n", loadinfo->xipbase);
+}
+
+/****************************************************************************
+ * Name: elf_xipsection
+ *
+ * Description:
+ *   Return true if section 'idx' can be used in place:  it must be a
+ *   read-only section with data in the file, suitably aligned, and no
+ *   relocation section may apply to it.
+ *
+ ****************************************************************************/
+
+static bool elf_xipsection(FAR struct elf_loadinfo_s *loadinfo, int idx)
+{
+  FAR Elf_Shdr *shdr = &loadinfo->shdr[idx];
+  uintptr_t addr;
+  int i;
+
+  if (loadinfo->xipbase == NULL ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC ||
+      shdr->sh_type == SHT_NOBITS)
+    {
+      return false;
+    }
+
+  addr = (uintptr_t)loadinfo->xipbase + shdr->sh_offset;
+  if (shdr->sh_addralign > 1 && (addr & (shdr->sh_addralign - 1)) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *relsec = &loadinfo->shdr[i];
+
+      if ((relsec->sh_type == SHT_REL || relsec->sh_type == SHT_RELA) &&
+          relsec->sh_info == idx)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define elf_xipprobe(l)
+#  define elf_xipsection(l,i) false
+#endif
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -122,7 +193,10 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
             {
               datasize += ELF_ALIGNUP(shdr->sh_size);
             }
-          else
+
+          /* Sections executed in place need no RAM */
+
+          else if (!elf_xipsection(loadinfo, i))
             {
               textsize += ELF_ALIGNUP(shdr->sh_size);
             }
@@ -175,6 +249,17 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           continue;
         }
 
+#ifdef CONFIG_ELF_XIP
+      /* Read-only sections in memory-mapped storage are used in place */
+
+      if (elf_xipsection(loadinfo, i))
+        {
+          shdr->sh_addr = (uintptr_t)loadinfo->xipbase + shdr->sh_offset;
+          binfo("%d. XIP %08lx\n", i, (unsigned long)shdr->sh_addr);
+          continue;
+        }
+#endif
+
       /* SHF_WRITE indicates that the section address space is write-
        * able
        */
@@ -188,6 +273,17 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           pptr = &text;
         }
 
+#ifdef CONFIG_ELF_SHARETEXT
+      /* The text of a shared image is already loaded and relocated */
+
+      if (loadinfo->share != NULL && pptr == &text)
+        {
+          shdr->sh_addr = (uintptr_t)text;
+          text += ELF_ALIGNUP(shdr->sh_size);
+          continue;
+        }
+#endif
+
       /* SHT_NOBITS indicates that there is no data in the file for the
        * section.
        */
@@ -265,6 +361,10 @@ int elf_load(FAR struct elf_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+  /* Check if the file can be executed in place */
+
+  elf_xipprobe(loadinfo);
+
   /* Determine total size to allocate */
 
   elf_elfsize(loadinfo);
@@ -0,0 +1,222 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_share.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* When the same ELF program is started several times, the read-only part
+ * of its image (text and rodata) is loaded and relocated only once and
+ * then shared by all instances; each instance only gets its own data and
+ * bss.  This is possible when no relocation in a read-only section refers
+ * to a writable section (see elf_checkshared() in libelf_bind.c).  The
+ * shared text lives as long as any instance is loaded.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_SHARETEXT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct elf_share_s
+{
+  FAR struct elf_share_s *flink; /* Supports a singly linked list */
+  off_t filelen;                 /* File identity:  size ... */
+  time_t mtime;                  /* ... and modification time */
+  uintptr_t text;                /* The shared, relocated text */
+  size_t textsize;               /* Size of the text allocation */
+  int crefs;                     /* Number of instances using the text */
+  char filename[1];              /* Path of the ELF file, actual size varies */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct elf_share_s *g_elfshare;
+static sem_t g_elfsharesem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int elf_share_stat(FAR const char *filename, FAR struct stat *buf)
+{
+  int ret = stat(filename, buf);
+  return ret < 0 ? -get_errno() : OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_share_find
+ ****************************************************************************/
+
+void elf_share_find(FAR const char *filename,
+                    FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct elf_share_s *share;
+  struct stat buf;
+
+  loadinfo->share = NULL;
+  if (elf_share_stat(filename, &buf) < 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_elfsharesem);
+  for (share = g_elfshare; share != NULL; share = share->flink)
+    {
+      if (share->filelen == buf.st_size && share->mtime == buf.st_mtime &&
+          strcmp(share->filename, filename) == 0)
+        {
+          share->crefs++;
+          loadinfo->share = share;
+          binfo("Sharing text of %s at %08lx\n",
+                filename, (unsigned long)share->text);
+          break;
+        }
+    }
+
+  nxsem_post(&g_elfsharesem);
+}
+
+/****************************************************************************
+ * Name: elf_share_add
+ ****************************************************************************/
+
+void elf_share_add(FAR const char *filename,
+                   FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct elf_share_s *share;
+  struct stat buf;
+
+  if (loadinfo->share != NULL || loadinfo->textpriv ||
+      loadinfo->textalloc == 0 || elf_share_stat(filename, &buf) < 0)
+    {
+      return;
+    }
+
+  share = kmm_zalloc(sizeof(struct elf_share_s) + strlen(filename));
+  if (share == NULL)
+    {
+      return;
+    }
+
+  strcpy(share->filename, filename);
+  share->filelen  = buf.st_size;
+  share->mtime    = buf.st_mtime;
+  share->text     = loadinfo->textalloc;
+  share->textsize = loadinfo->textsize;
+  share->crefs    = 1;
+
+  nxsem_wait_uninterruptible(&g_elfsharesem);
+  share->flink    = g_elfshare;
+  g_elfshare      = share;
+  nxsem_post(&g_elfsharesem);
+
+  loadinfo->share = share;
+}
+
+/****************************************************************************
+ * Name: elf_share_text
+ ****************************************************************************/
+
+uintptr_t elf_share_text(FAR struct elf_share_s *share)
+{
+  return share->text;
+}
+
+/****************************************************************************
+ * Name: elf_share_release
+ ****************************************************************************/
+
+void elf_share_release(FAR struct elf_share_s *share)
+{
+  FAR struct elf_share_s **link;
+
+  nxsem_wait_uninterruptible(&g_elfsharesem);
+
+  DEBUGASSERT(share->crefs > 0);
+  if (--share->crefs > 0)
+    {
+      nxsem_post(&g_elfsharesem);
+      return;
+    }
+
+  for (link = &g_elfshare; *link != NULL && *link != share;
+       link = &(*link)->flink)
+    {
+    }
+
+  DEBUGASSERT(*link == share);
+  *link = share->flink;
+  nxsem_post(&g_elfsharesem);
+
+  kumm_free((FAR void *)share->text);
+  kmm_free(share);
+}
+
+/****************************************************************************
+ * Name: elf_share_unload
+ ****************************************************************************/
+
+int elf_share_unload(FAR struct binary_s *binp)
+{
+  FAR struct elf_share_s *share;
+  uintptr_t entry = (uintptr_t)binp->entrypt;
+
+  /* Find the shared text that contains the entry point */
+
+  nxsem_wait_uninterruptible(&g_elfsharesem);
+  for (share = g_elfshare; share != NULL; share = share->flink)
+    {
+      if (entry >= share->text && entry < share->text + share->textsize)
+        {
+          break;
+        }
+    }
+
+  nxsem_post(&g_elfsharesem);
+
+  if (share != NULL)
+    {
+      elf_share_release(share);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_ELF_SHARETEXT */
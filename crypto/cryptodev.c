@@ -43,9 +43,14 @@
 #include <stdbool.h>
 #include <string.h>
 #include <poll.h>
+#include <queue.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/drivers/drivers.h>
 
 #include <nuttx/crypto/crypto.h>
@@ -55,18 +60,68 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_CRYPTO_AES
-#  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
+#ifndef CONFIG_CRYPTO_CRYPTODEV_NSESSIONS
+#  define CONFIG_CRYPTO_CRYPTODEV_NSESSIONS 4
 #endif
 
+#define CRYPTODEV_MAXKEYLEN      32
+#define CRYPTODEV_NPOLLWAITERS   2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A session: the cipher and a copy of the key */
+
+struct cryptodev_session_s
+{
+  uint32_t cipher;
+  uint32_t keylen;                   /* 0: session slot is free */
+  uint8_t key[CRYPTODEV_MAXKEYLEN];
+};
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* A queued CIOCNCRYPTM request; the session is copied at submission so
+ * that freeing it does not affect jobs in flight.
+ */
+
+struct cryptodev_job_s
+{
+  sq_entry_t node;
+  struct cryptodev_session_s ses;
+  struct crypt_n_op op;
+};
+#endif
+
+/* State of one open file of /dev/crypto */
+
+struct cryptodev_file_s
+{
+  mutex_t lock;
+  struct cryptodev_session_s sessions[CONFIG_CRYPTO_CRYPTODEV_NSESSIONS];
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  struct work_s work;                /* Runs the pending jobs */
+  sq_queue_t freeq;                  /* Unused jobs */
+  sq_queue_t pendq;                  /* Submitted, not yet run */
+  sq_queue_t doneq;                  /* Completed, not yet collected */
+  uint32_t reqid;                    /* Last request id handed out */
+  bool busy;                         /* Work scheduled or running */
+  bool closing;                      /* close() waits for idle */
+  sem_t idle;                        /* Posted when the worker stops */
+  FAR struct pollfd *fds[CRYPTODEV_NPOLLWAITERS];
+  struct cryptodev_job_s jobs[CONFIG_CRYPTO_CRYPTODEV_NJOBS];
+#endif
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 /* Character driver methods */
 
+static int cryptodev_open(FAR struct file *filep);
+static int cryptodev_close(FAR struct file *filep);
 static ssize_t cryptodev_read(FAR struct file *filep,
                               FAR char *buffer,
                               size_t len);
@@ -76,6 +131,10 @@ static ssize_t cryptodev_write(FAR struct file *filep,
 static int cryptodev_ioctl(FAR struct file *filep,
                            int cmd,
                            unsigned long arg);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -83,13 +142,17 @@ static int cryptodev_ioctl(FAR struct file *filep,
 
 static const struct file_operations g_cryptodevops =
 {
-  NULL,               /* open   */
-  NULL,               /* close  */
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   NULL,               /* seek   */
   cryptodev_ioctl,    /* ioctl  */
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_poll      /* poll   */
+#else
   NULL                /* poll   */
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL              /* unlink */
 #endif
@@ -99,6 +162,339 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_crypt
+ *
+ * Description:
+ *   Run one operation with the given session.
+ *
+ ****************************************************************************/
+
+static int cryptodev_crypt(FAR const struct cryptodev_session_s *ses,
+                           uint16_t op, FAR void *dst, FAR const void *src,
+                           unsigned len, FAR const void *iv)
+{
+#ifdef CONFIG_CRYPTO_AES
+  int encrypt;
+  int mode;
+
+  switch (op)
+    {
+      case COP_ENCRYPT:
+        encrypt = CYPHER_ENCRYPT;
+        break;
+
+      case COP_DECRYPT:
+        encrypt = CYPHER_DECRYPT;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  switch (ses->cipher)
+    {
+      case CRYPTO_AES_ECB:
+        mode = AES_MODE_ECB;
+        break;
+
+      case CRYPTO_AES_CBC:
+        mode = AES_MODE_CBC;
+        break;
+
+      case CRYPTO_AES_CTR:
+        mode = AES_MODE_CTR;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  return aes_cypher(dst, src, len, iv, ses->key, ses->keylen, mode,
+                    encrypt);
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: cryptodev_getsession
+ *
+ * Description:
+ *   Copy out the session with the given id.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static int cryptodev_getsession(FAR struct cryptodev_file_s *priv,
+                                uint32_t id,
+                                FAR struct cryptodev_session_s *ses)
+{
+  if (id < 1 || id > CONFIG_CRYPTO_CRYPTODEV_NSESSIONS ||
+      priv->sessions[id - 1].keylen == 0)
+    {
+      return -EINVAL;
+    }
+
+  *ses = priv->sessions[id - 1];
+  return OK;
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/****************************************************************************
+ * Name: cryptodev_notify
+ *
+ * Description:
+ *   Report POLLIN if results are ready and POLLOUT if a job can be
+ *   queued.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void cryptodev_notify(FAR struct cryptodev_file_s *priv)
+{
+  pollevent_t eventset = 0;
+  int i;
+
+  if (!sq_empty(&priv->doneq))
+    {
+      eventset |= POLLIN;
+    }
+
+  if (!sq_empty(&priv->freeq))
+    {
+      eventset |= POLLOUT;
+    }
+
+  for (i = 0; i < CRYPTODEV_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = priv->fds[i];
+
+      if (fds != NULL)
+        {
+          fds->revents |= fds->events & eventset;
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_worker
+ *
+ * Description:
+ *   Work queue function: take all pending jobs at once and run them back
+ *   to back, so that an engine behind aes_cypher() sees a burst of
+ *   requests, then move them to the completion queue.
+ *
+ ****************************************************************************/
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct cryptodev_file_s *priv = arg;
+  FAR struct cryptodev_job_s *job;
+  FAR sq_entry_t *node;
+  sq_queue_t batch;
+
+  nxmutex_lock(&priv->lock);
+
+  while (!sq_empty(&priv->pendq) && !priv->closing)
+    {
+      sq_init(&batch);
+      sq_move(&priv->pendq, &batch);
+      nxmutex_unlock(&priv->lock);
+
+      for (node = sq_peek(&batch); node != NULL; node = sq_next(node))
+        {
+          job = (FAR struct cryptodev_job_s *)node;
+          job->op.status = cryptodev_crypt(&job->ses, job->op.op,
+                                           job->op.dst, job->op.src,
+                                           job->op.len, job->op.iv);
+        }
+
+      nxmutex_lock(&priv->lock);
+      sq_cat(&batch, &priv->doneq);
+      cryptodev_notify(priv);
+    }
+
+  priv->busy = false;
+  if (priv->closing)
+    {
+      nxsem_post(&priv->idle);
+    }
+
+  nxmutex_unlock(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: cryptodev_submit
+ *
+ * Description:
+ *   CIOCNCRYPTM: queue the requests and schedule the worker.
+ *
+ ****************************************************************************/
+
+static int cryptodev_submit(FAR struct cryptodev_file_s *priv,
+                            FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_job_s *job;
+  FAR struct crypt_n_op *req;
+  size_t i;
+  int ret;
+
+  if (mop == NULL || (mop->count > 0 && mop->reqs == NULL))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < mop->count; i++)
+    {
+      req = &mop->reqs[i];
+      req->reqid = ++priv->reqid;
+
+      job = (FAR struct cryptodev_job_s *)sq_peek(&priv->freeq);
+      if (job == NULL)
+        {
+          req->status = -EAGAIN;
+          continue;
+        }
+
+      req->status = cryptodev_getsession(priv, req->ses, &job->ses);
+      if (req->status < 0)
+        {
+          continue;
+        }
+
+      sq_remfirst(&priv->freeq);
+      job->op = *req;
+      sq_addlast(&job->node, &priv->pendq);
+    }
+
+  if (!priv->busy && !sq_empty(&priv->pendq))
+    {
+      priv->busy = true;
+      work_queue(LPWORK, &priv->work, cryptodev_worker, priv, 0);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_retrieve
+ *
+ * Description:
+ *   CIOCNCRYPTRETM: return the results of completed requests without
+ *   waiting; poll() for POLLIN to wait.
+ *
+ ****************************************************************************/
+
+static int cryptodev_retrieve(FAR struct cryptodev_file_s *priv,
+                              FAR struct cryptret *ret)
+{
+  FAR struct cryptodev_job_s *job;
+  size_t n;
+  int err;
+
+  if (ret == NULL || (ret->count > 0 && ret->results == NULL))
+    {
+      return -EINVAL;
+    }
+
+  err = nxmutex_lock(&priv->lock);
+  if (err < 0)
+    {
+      return err;
+    }
+
+  for (n = 0; n < ret->count; n++)
+    {
+      job = (FAR struct cryptodev_job_s *)sq_remfirst(&priv->doneq);
+      if (job == NULL)
+        {
+          break;
+        }
+
+      ret->results[n].reqid  = job->op.reqid;
+      ret->results[n].status = job->op.status;
+      ret->results[n].opaque = job->op.opaque;
+      sq_addlast(&job->node, &priv->freeq);
+    }
+
+  ret->count = n;
+  nxmutex_unlock(&priv->lock);
+  return OK;
+}
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *priv;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  int i;
+#endif
+
+  priv = kmm_zalloc(sizeof(struct cryptodev_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&priv->lock);
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxsem_init(&priv->idle, 0, 0);
+  nxsem_set_protocol(&priv->idle, SEM_PRIO_NONE);
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NJOBS; i++)
+    {
+      sq_addlast(&priv->jobs[i].node, &priv->freeq);
+    }
+#endif
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *priv = filep->f_priv;
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* Drop the jobs that have not started and wait for a running batch */
+
+  nxmutex_lock(&priv->lock);
+  priv->closing = true;
+  if (priv->busy && work_cancel(LPWORK, &priv->work) == OK)
+    {
+      priv->busy = false;
+    }
+
+  while (priv->busy)
+    {
+      nxmutex_unlock(&priv->lock);
+      nxsem_wait_uninterruptible(&priv->idle);
+      nxmutex_lock(&priv->lock);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  nxsem_destroy(&priv->idle);
+#endif
+
+  /* Do not leave keys behind in the heap */
+
+  memset(priv->sessions, 0, sizeof(priv->sessions));
+  nxmutex_destroy(&priv->lock);
+  kmm_free(priv);
+  return OK;
+}
+
 static ssize_t cryptodev_read(FAR struct file *filep,
                               FAR char *buffer,
                               size_t len)
@@ -117,56 +513,99 @@ static int cryptodev_ioctl(FAR struct file *filep,
                            int cmd,
                            unsigned long arg)
 {
+  FAR struct cryptodev_file_s *priv = filep->f_priv;
+  int ret;
+
   switch (cmd)
   {
   case CIOCGSESSION:
     {
-      FAR struct session_op *ses = (FAR struct session_op *)arg;
-      ses->ses = (uint32_t)ses;
-      return OK;
+      FAR struct session_op *sop = (FAR struct session_op *)arg;
+      FAR struct cryptodev_session_s *ses;
+      int i;
+
+      if (sop->cipher < CRYPTO_AES_ECB || sop->cipher > CRYPTO_AES_CTR ||
+          (sop->keylen != 16 && sop->keylen != 24 && sop->keylen != 32))
+        {
+          return -EINVAL;
+        }
+
+      ret = nxmutex_lock(&priv->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = -ENOMEM;
+      for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NSESSIONS; i++)
+        {
+          ses = &priv->sessions[i];
+          if (ses->keylen == 0)
+            {
+              ses->cipher = sop->cipher;
+              ses->keylen = sop->keylen;
+              memcpy(ses->key, sop->key, sop->keylen);
+              sop->ses    = i + 1;
+              ret         = OK;
+              break;
+            }
+        }
+
+      nxmutex_unlock(&priv->lock);
+      return ret;
     }
 
   case CIOCFSESSION:
     {
+      uint32_t id = *(FAR uint32_t *)arg;
+
+      if (id < 1 || id > CONFIG_CRYPTO_CRYPTODEV_NSESSIONS)
+        {
+          return -EINVAL;
+        }
+
+      ret = nxmutex_lock(&priv->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      memset(&priv->sessions[id - 1], 0,
+             sizeof(struct cryptodev_session_s));
+      nxmutex_unlock(&priv->lock);
       return OK;
     }
 
-#ifdef CONFIG_CRYPTO_AES
   case CIOCCRYPT:
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
+      FAR struct crypt_op *op = (FAR struct crypt_op *)arg;
+      struct cryptodev_session_s ses;
 
-      switch (op->op)
+      ret = nxmutex_lock(&priv->lock);
+      if (ret < 0)
         {
-        case COP_ENCRYPT:
-          encrypt = 1;
-          break;
-
-        case COP_DECRYPT:
-          encrypt = 0;
-          break;
-
-        default:
-          return -EINVAL;
+          return ret;
         }
 
-      switch (ses->cipher)
+      ret = cryptodev_getsession(priv, op->ses, &ses);
+      nxmutex_unlock(&priv->lock);
+
+      if (ret >= 0)
         {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
+          ret = cryptodev_crypt(&ses, op->op, op->dst, op->src, op->len,
+                                op->iv);
+        }
 
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
+      memset(&ses, 0, sizeof(ses));
+      return ret;
+    }
 
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  case CIOCNCRYPTM:
+    return cryptodev_submit(priv, (FAR struct crypt_mop *)arg);
 
-        default:
-           return -EINVAL;
-        }
-    }
+  case CIOCNCRYPTRETM:
+    return cryptodev_retrieve(priv, (FAR struct cryptret *)arg);
 #endif
 
   default:
@@ -174,6 +613,55 @@ static int cryptodev_ioctl(FAR struct file *filep,
   }
 }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct cryptodev_file_s *priv = filep->f_priv;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < CRYPTODEV_NPOLLWAITERS; i++)
+        {
+          if (priv->fds[i] == NULL)
+            {
+              priv->fds[i] = fds;
+              fds->priv    = &priv->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CRYPTODEV_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else
+        {
+          cryptodev_notify(priv);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
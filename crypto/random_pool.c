@@ -49,6 +49,8 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 
@@ -65,6 +67,39 @@
 #define ROTL_32(x,n) ( ((x) << (n)) | ((x) >> (32-(n))) )
 #define ROTR_32(x,n) ( ((x) >> (n)) | ((x) << (32-(n))) )
 
+#ifndef CONFIG_CRYPTO_RANDOM_POOL_CPUBUF
+#  define CONFIG_CRYPTO_RANDOM_POOL_CPUBUF 0
+#endif
+
+#if CONFIG_CRYPTO_RANDOM_POOL_CPUBUF > 0
+#  if (CONFIG_CRYPTO_RANDOM_POOL_CPUBUF % 64) != 0
+#    error CONFIG_CRYPTO_RANDOM_POOL_CPUBUF must be a multiple of 64
+#  endif
+
+#  ifdef CONFIG_SMP
+#    define CPURNG_NCPUS   CONFIG_SMP_NCPUS
+#  else
+#    define CPURNG_NCPUS   1
+#  endif
+
+/* The first 32 bytes of each refill become the next ChaCha20 key, the
+ * rest is output.  Requests up to CPURNG_MAXREQ bytes are served from it.
+ */
+
+#  define CPURNG_KEYSIZE   32
+#  define CPURNG_MAXREQ    (CONFIG_CRYPTO_RANDOM_POOL_CPUBUF / 4)
+
+#  define CHACHA_QR(a,b,c,d) \
+  do \
+    { \
+      a += b; d ^= a; d = ROTL_32(d, 16); \
+      c += d; b ^= c; b = ROTL_32(b, 12); \
+      a += b; d ^= a; d = ROTL_32(d, 8); \
+      c += d; b ^= c; b = ROTL_32(b, 7); \
+    } \
+  while (0)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -90,9 +125,31 @@ struct rng_s
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
   bool output_initialized;
+  volatile uint32_t rd_gen; /* Reseed generation, never 0 once seeded */
   struct blake2xs_rng_s blake2xs;
 };
 
+#if CONFIG_CRYPTO_RANDOM_POOL_CPUBUF > 0
+/* Per-CPU output buffer.  A ChaCha20 key taken from the central pool
+ * produces a buffer of output at a time; the key is replaced by the first
+ * output bytes of every refill (fast key erasure), so earlier output can
+ * not be recovered from the state.  The lock is only contended if a
+ * thread migrates between CPUs in the middle of a refill.
+ */
+
+struct cpurng_s
+{
+#ifdef CONFIG_SMP
+  spinlock_t lock;
+#endif
+  bool refilling;           /* A thread is producing a new buffer */
+  uint16_t avail;           /* Unused bytes at the end of buf */
+  uint32_t gen;             /* rd_gen the key was taken at, 0: no key */
+  uint32_t key[8];
+  uint8_t buf[CONFIG_CRYPTO_RANDOM_POOL_CPUBUF];
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -108,6 +165,10 @@ enum
 
 static struct rng_s g_rng;
 
+#if CONFIG_CRYPTO_RANDOM_POOL_CPUBUF > 0
+static struct cpurng_s g_cpurng[CPURNG_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -321,6 +382,13 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+
+  /* Let the per-CPU generators pick up a new key */
+
+  if (++g_rng.rd_gen == 0)
+    {
+      g_rng.rd_gen = 1;
+    }
 }
 
 static void rng_buf_internal(FAR void *bytes, size_t nbytes)
@@ -374,6 +442,193 @@ static void rng_buf_internal(FAR void *bytes, size_t nbytes)
     }
 }
 
+#if CONFIG_CRYPTO_RANDOM_POOL_CPUBUF > 0
+/****************************************************************************
+ * Name: chacha20_block
+ *
+ * Description:
+ *   Produce one 64-byte ChaCha20 block (RFC 8439) with a zero nonce.
+ *
+ ****************************************************************************/
+
+static void chacha20_block(FAR const uint32_t *key, uint32_t counter,
+                           FAR uint8_t *out)
+{
+  uint32_t in[16];
+  uint32_t x[16];
+  int i;
+
+  in[0]  = 0x61707865;
+  in[1]  = 0x3320646e;
+  in[2]  = 0x79622d32;
+  in[3]  = 0x6b206574;
+  memcpy(&in[4], key, 32);
+  in[12] = counter;
+  in[13] = 0;
+  in[14] = 0;
+  in[15] = 0;
+
+  memcpy(x, in, sizeof(x));
+
+  for (i = 0; i < 10; i++)
+    {
+      CHACHA_QR(x[0], x[4], x[8],  x[12]);
+      CHACHA_QR(x[1], x[5], x[9],  x[13]);
+      CHACHA_QR(x[2], x[6], x[10], x[14]);
+      CHACHA_QR(x[3], x[7], x[11], x[15]);
+      CHACHA_QR(x[0], x[5], x[10], x[15]);
+      CHACHA_QR(x[1], x[6], x[11], x[12]);
+      CHACHA_QR(x[2], x[7], x[8],  x[13]);
+      CHACHA_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+  for (i = 0; i < 16; i++)
+    {
+      x[i] += in[i];
+    }
+
+  memcpy(out, x, sizeof(x));
+  explicit_bzero(x, sizeof(x));
+  explicit_bzero(in, sizeof(in));
+}
+
+/****************************************************************************
+ * Name: cpurng_lock, cpurng_relock and cpurng_unlock
+ *
+ * Description:
+ *   Get exclusive access to the generator of the current CPU.  Only local
+ *   interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static inline FAR struct cpurng_s *cpurng_lock(FAR irqstate_t *flags)
+{
+  FAR struct cpurng_s *r;
+
+  *flags = local_irq_save();
+  r      = &g_cpurng[up_cpu_index()];
+
+#ifdef CONFIG_SMP
+  spin_lock(&r->lock);
+#endif
+
+  return r;
+}
+
+static inline void cpurng_relock(FAR struct cpurng_s *r,
+                                 FAR irqstate_t *flags)
+{
+  *flags = local_irq_save();
+
+#ifdef CONFIG_SMP
+  spin_lock(&r->lock);
+#endif
+}
+
+static inline void cpurng_unlock(FAR struct cpurng_s *r, irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&r->lock);
+#endif
+
+  local_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: cpurng_take
+ *
+ * Description:
+ *   Copy out and erase nbytes of the buffer.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static inline void cpurng_take(FAR struct cpurng_s *r, FAR void *bytes,
+                               size_t nbytes)
+{
+  FAR uint8_t *p = &r->buf[CONFIG_CRYPTO_RANDOM_POOL_CPUBUF - r->avail];
+
+  memcpy(bytes, p, nbytes);
+  explicit_bzero(p, nbytes);
+  r->avail -= nbytes;
+}
+
+/****************************************************************************
+ * Name: cpurng_get
+ *
+ * Description:
+ *   Serve a small request from the buffer of the current CPU, refilling it
+ *   if needed.  Only a refill that needs a new key from the central pool
+ *   takes the pool semaphore.
+ *
+ * Returned Value:
+ *   true if the request was served; false if the caller has to use the
+ *   central pool (another thread on this CPU is refilling).
+ *
+ ****************************************************************************/
+
+static bool cpurng_get(FAR void *bytes, size_t nbytes)
+{
+  FAR struct cpurng_s *r;
+  irqstate_t flags;
+  uint32_t key[8];
+  uint32_t gen;
+  int i;
+
+  r = cpurng_lock(&flags);
+
+  gen = g_rng.rd_gen;
+  if (r->gen != 0 && r->gen == gen && r->avail >= nbytes)
+    {
+      cpurng_take(r, bytes, nbytes);
+      cpurng_unlock(r, flags);
+      return true;
+    }
+
+  if (r->refilling)
+    {
+      cpurng_unlock(r, flags);
+      return false;
+    }
+
+  /* Claim the buffer; it is written with the lock released */
+
+  r->refilling = true;
+  r->avail     = 0;
+  memcpy(key, r->key, sizeof(key));
+  gen = (r->gen != 0 && r->gen == gen) ? r->gen : 0;
+  cpurng_unlock(r, flags);
+
+  if (gen == 0)
+    {
+      /* No key yet or the pool has been reseeded since: take a new key */
+
+      nxsem_wait_uninterruptible(&g_rng.rd_sem);
+      rng_buf_internal(key, sizeof(key));
+      gen = g_rng.rd_gen;
+      nxsem_post(&g_rng.rd_sem);
+    }
+
+  for (i = 0; i < CONFIG_CRYPTO_RANDOM_POOL_CPUBUF / 64; i++)
+    {
+      chacha20_block(key, i, &r->buf[64 * i]);
+    }
+
+  explicit_bzero(key, sizeof(key));
+
+  cpurng_relock(r, &flags);
+
+  memcpy(r->key, r->buf, CPURNG_KEYSIZE);
+  explicit_bzero(r->buf, CPURNG_KEYSIZE);
+  r->gen       = gen;
+  r->avail     = CONFIG_CRYPTO_RANDOM_POOL_CPUBUF - CPURNG_KEYSIZE;
+  r->refilling = false;
+  cpurng_take(r, bytes, nbytes);
+
+  cpurng_unlock(r, flags);
+  return true;
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_CPUBUF > 0 */
+
 static void rng_init(void)
 {
   cryptinfo("Initializing RNG\n");
@@ -552,6 +807,10 @@ void up_randompool_initialize(void)
  *
  *   Note that this function cannot fail, other than by asserting.
  *
+ *   With CONFIG_CRYPTO_RANDOM_POOL_CPUBUF, small requests are served from
+ *   a per-CPU ChaCha20 generator keyed from the pool, without taking the
+ *   pool semaphore.
+ *
  * Input Parameters:
  *   bytes  - Buffer for returned random bytes
  *   nbytes - Number of bytes requested.
@@ -565,6 +824,13 @@ void getrandom(FAR void *bytes, size_t nbytes)
 {
   int ret;
 
+#if CONFIG_CRYPTO_RANDOM_POOL_CPUBUF > 0
+  if (nbytes <= CPURNG_MAXREQ && cpurng_get(bytes, nbytes))
+    {
+      return;
+    }
+#endif
+
   ret = nxsem_wait_uninterruptible(&g_rng.rd_sem);
   if (ret >= 0)
     {
@@ -57,6 +57,8 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/analog/adc.h>
 #include <nuttx/random.h>
 
@@ -73,6 +75,14 @@ static ssize_t adc_read(FAR struct file *fielp, FAR char *buffer,
 static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
+#ifdef CONFIG_ADC_BLOCK
+static ssize_t adc_readblocks(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev,
+                              FAR char *buffer, size_t buflen);
+static int     adc_receiveblock(FAR struct adc_dev_s *dev,
+                                FAR const void *data, size_t nbytes,
+                                uint8_t nchannels, uint8_t samplesize);
+#endif
 static void    adc_notify(FAR struct adc_dev_s *dev);
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds,
                         bool setup);
@@ -97,7 +107,10 @@ static const struct file_operations g_adc_fops =
 
 static const struct adc_callback_s g_adc_callback =
 {
-  adc_receive   /* au_receive */
+  adc_receive       /* au_receive */
+#ifdef CONFIG_ADC_BLOCK
+  , adc_receiveblock /* au_receiveblock */
+#endif
 };
 
 /****************************************************************************
@@ -146,9 +159,27 @@ static int adc_open(FAR struct file *filep)
 
           if (tmp == 1)
             {
+              irqstate_t flags;
+
+#ifdef CONFIG_ADC_BLOCK
+              /* Allocate the ring of blocks of a block mode device */
+
+              if (dev->ad_block)
+                {
+                  dev->ad_blocks.ab_buffer = (FAR struct adc_block_s *)
+                    kmm_malloc(CONFIG_ADC_BLOCK_NBLOCKS *
+                               sizeof(struct adc_block_s));
+                  if (dev->ad_blocks.ab_buffer == NULL)
+                    {
+                      nxsem_post(&dev->ad_closesem);
+                      return -ENOMEM;
+                    }
+                }
+#endif
+
               /* Yes.. perform one time hardware initialization. */
 
-              irqstate_t flags = enter_critical_section();
+              flags = enter_critical_section();
               ret = dev->ad_ops->ao_setup(dev);
               if (ret == OK)
                 {
@@ -156,6 +187,12 @@ static int adc_open(FAR struct file *filep)
 
                   dev->ad_recv.af_head = 0;
                   dev->ad_recv.af_tail = 0;
+#ifdef CONFIG_ADC_BLOCK
+                  dev->ad_blocks.ab_head  = 0;
+                  dev->ad_blocks.ab_tail  = 0;
+                  dev->ad_blocks.ab_lost  = 0;
+                  dev->ad_blocks.ab_seqno = 0;
+#endif
 
                   /* Finally, Enable the ADC RX interrupt */
 
@@ -167,6 +204,14 @@ static int adc_open(FAR struct file *filep)
                 }
 
               leave_critical_section(flags);
+
+#ifdef CONFIG_ADC_BLOCK
+              if (ret != OK && dev->ad_blocks.ab_buffer != NULL)
+                {
+                  kmm_free(dev->ad_blocks.ab_buffer);
+                  dev->ad_blocks.ab_buffer = NULL;
+                }
+#endif
             }
         }
 
@@ -189,6 +234,9 @@ static int adc_close(FAR struct file *filep)
 {
   FAR struct inode     *inode = filep->f_inode;
   FAR struct adc_dev_s *dev   = inode->i_private;
+#ifdef CONFIG_ADC_BLOCK
+  FAR struct adc_block_s *buffer;
+#endif
   irqstate_t            flags;
   int                   ret;
 
@@ -214,8 +262,19 @@ static int adc_close(FAR struct file *filep)
 
           flags = enter_critical_section();    /* Disable interrupts */
           dev->ad_ops->ao_shutdown(dev);       /* Disable the ADC */
+#ifdef CONFIG_ADC_BLOCK
+          buffer = dev->ad_blocks.ab_buffer;
+          dev->ad_blocks.ab_buffer = NULL;
+#endif
           leave_critical_section(flags);
 
+#ifdef CONFIG_ADC_BLOCK
+          if (buffer != NULL)
+            {
+              kmm_free(buffer);
+            }
+#endif
+
           nxsem_post(&dev->ad_closesem);
         }
     }
@@ -239,6 +298,15 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_BLOCK
+  /* Block mode devices return whole blocks */
+
+  if (dev->ad_block)
+    {
+      return adc_readblocks(filep, dev, buffer, buflen);
+    }
+#endif
+
   /* Determine the size of the messages to return.
    *
    * REVISIT:  What if buflen is 8 does that mean 4 messages of size 2?  Or
@@ -405,6 +473,88 @@ return_with_irqdisabled:
   return ret;
 }
 
+/****************************************************************************
+ * Name: adc_readblocks
+ *
+ * Description:
+ *   Read whole struct adc_block_s blocks from a block mode device.  The
+ *   block at the head of the ring is never written by the lower half, so
+ *   it is copied with interrupts enabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static ssize_t adc_readblocks(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev,
+                              FAR char *buffer, size_t buflen)
+{
+  FAR struct adc_blockfifo_s *fifo = &dev->ad_blocks;
+  FAR struct adc_block_s *block;
+  irqstate_t flags;
+  size_t nread = 0;
+  int32_t seed;
+  int ret;
+
+  if (buflen < sizeof(struct adc_block_s))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (fifo->ab_head == fifo->ab_tail)
+    {
+      /* The ring is empty -- was non-blocking mode selected? */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      /* Wait for a block to be received */
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  /* Copy all blocks that will fit in the user buffer */
+
+  do
+    {
+      block = &fifo->ab_buffer[fifo->ab_head];
+      leave_critical_section(flags);
+
+      memcpy(&buffer[nread], block, sizeof(struct adc_block_s));
+      nread += sizeof(struct adc_block_s);
+
+      /* Feed ADC data to entropy pool */
+
+      if (block->ab_nbytes >= sizeof(int32_t))
+        {
+          memcpy(&seed, block->ab_data, sizeof(int32_t));
+          add_sensor_randomness(seed);
+        }
+
+      flags = enter_critical_section();
+      if (++fifo->ab_head >= CONFIG_ADC_BLOCK_NBLOCKS)
+        {
+          fifo->ab_head = 0;
+        }
+    }
+  while (fifo->ab_head != fifo->ab_tail &&
+         nread + sizeof(struct adc_block_s) <= buflen);
+
+  leave_critical_section(flags);
+  return nread;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_ioctl
  ****************************************************************************/
@@ -460,6 +610,94 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
   return errcode;
 }
 
+/****************************************************************************
+ * Name: adc_receiveblock
+ *
+ * Description:
+ *   Add a block of samples from the lower half to the ring, splitting it
+ *   into as many blocks as needed.  Blocks that do not fit are dropped and
+ *   counted in ab_lost of the next block that is stored; their sequence
+ *   numbers are skipped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static int adc_receiveblock(FAR struct adc_dev_s *dev,
+                            FAR const void *data, size_t nbytes,
+                            uint8_t nchannels, uint8_t samplesize)
+{
+  FAR struct adc_blockfifo_s *fifo = &dev->ad_blocks;
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  FAR struct adc_block_s *block;
+  struct timespec ts;
+  size_t maxbytes;
+  size_t ncopy;
+  int nexttail;
+  int errcode = OK;
+
+  DEBUGASSERT(dev->ad_block && nchannels > 0 && samplesize > 0);
+
+  if (fifo->ab_buffer == NULL)
+    {
+      return -ENODEV;
+    }
+
+  /* Blocks hold whole scans of all channels */
+
+  maxbytes = CONFIG_ADC_BLOCK_SIZE -
+             CONFIG_ADC_BLOCK_SIZE % (nchannels * samplesize);
+  DEBUGASSERT(maxbytes > 0);
+
+  clock_systime_timespec(&ts);
+
+  while (nbytes > 0)
+    {
+      ncopy = nbytes < maxbytes ? nbytes : maxbytes;
+
+      nexttail = fifo->ab_tail + 1;
+      if (nexttail >= CONFIG_ADC_BLOCK_NBLOCKS)
+        {
+          nexttail = 0;
+        }
+
+      if (nexttail == fifo->ab_head)
+        {
+          /* The ring is full.  Drop the block. */
+
+          if (fifo->ab_lost < UINT16_MAX)
+            {
+              fifo->ab_lost++;
+            }
+
+          errcode = -ENOMEM;
+        }
+      else
+        {
+          block                = &fifo->ab_buffer[fifo->ab_tail];
+          block->ab_time       = ts;
+          block->ab_seqno      = fifo->ab_seqno;
+          block->ab_lost       = fifo->ab_lost;
+          block->ab_nbytes     = ncopy;
+          block->ab_nchannels  = nchannels;
+          block->ab_samplesize = samplesize;
+          memcpy(block->ab_data, src, ncopy);
+
+          fifo->ab_lost        = 0;
+          fifo->ab_tail        = nexttail;
+        }
+
+      fifo->ab_seqno++;
+      src    += ncopy;
+      nbytes -= ncopy;
+    }
+
+  /* One notification for the whole transfer */
+
+  adc_notify(dev);
+  return errcode;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_pollnotify
  ****************************************************************************/
@@ -471,7 +709,10 @@ static void adc_pollnotify(FAR struct adc_dev_s *dev, uint32_t type)
   for (i = 0; i < CONFIG_ADC_NPOLLWAITERS; i++)
     {
       struct pollfd *fds = dev->fds[i];
-      if (fds)
+
+      /* Wake each waiter once, not once per sample */
+
+      if (fds && (fds->revents & type) == 0)
         {
           fds->revents |= type;
           nxsem_post(fds->sem);
@@ -562,6 +803,13 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
         {
           adc_pollnotify(dev, POLLIN);
         }
+#ifdef CONFIG_ADC_BLOCK
+      else if (dev->ad_block &&
+               dev->ad_blocks.ab_head != dev->ad_blocks.ab_tail)
+        {
+          adc_pollnotify(dev, POLLIN);
+        }
+#endif
     }
   else if (fds->priv)
     {
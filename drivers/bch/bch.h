@@ -56,6 +56,27 @@
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#ifndef CONFIG_BCH_DIRECT_ALIGN
+#  define CONFIG_BCH_DIRECT_ALIGN 1
+#endif
+
+/* Whole sectors may be transferred directly to/from the caller's buffer
+ * only if the buffer meets the alignment requirement and the data need not
+ * pass through the sector buffer for encryption.
+ */
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+#  define bchlib_direct(b)  (false)
+#else
+#  define bchlib_direct(b) \
+     (((uintptr_t)(b) & (CONFIG_BCH_DIRECT_ALIGN - 1)) == 0)
+#endif
+
+/* True if the sector buffer holds a sector in the range [s, s + n) */
+
+#define bchlib_incache(d,s,n) \
+  ((d)->sector >= (s) && (d)->sector < (s) + (n))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -437,6 +437,54 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_FS_BLOCK_REQUEST
+      /* Queue a sector transfer directly on the contained block driver */
+
+      case BIOC_SUBMIT:
+        {
+          FAR struct blk_request_s *req =
+            (FAR struct blk_request_s *)((uintptr_t)arg);
+
+          if (req == NULL || req->br_nsectors == 0 ||
+              !bchlib_direct(req->br_buffer) ||
+              req->br_sector + req->br_nsectors > bch->nsectors)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          if (req->br_op == BLKREQ_WRITE && bch->readonly)
+            {
+              ret = -EACCES;
+              break;
+            }
+
+          ret = bchlib_semtake(bch);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          /* Write back and forget any copy of these sectors in the sector
+           * buffer.
+           */
+
+          if (bchlib_incache(bch, req->br_sector, req->br_nsectors))
+            {
+              ret = bchlib_flushsector(bch);
+              bch->sector = (size_t)-1;
+            }
+
+          if (ret >= 0)
+            {
+              ret = block_submit(bch->inode, req);
+            }
+
+          bchlib_semgive(bch);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_BCH_ENCRYPTION
       /* This is a request to set the encryption key? */
 
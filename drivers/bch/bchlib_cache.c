@@ -51,6 +51,14 @@
 #  include <crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of 16-byte cypher blocks handed to aes_cypher() per call */
+
+#define BCH_CYPHER_NBLK 8
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -78,25 +86,52 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 {
   int blocks = bch->sectsize / 16;
   FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  uint32_t T[BCH_CYPHER_NBLK][4];
+  uint32_t X[BCH_CYPHER_NBLK][4];
+  int nblk;
   int i;
+  int j;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  /* Process the sector in chunks of blocks, so that each chunk needs only
+   * two aes_cypher() calls instead of two per block.
+   */
+
+  for (i = 0; i < blocks; i += nblk)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
+      nblk = blocks - i;
+      if (nblk > BCH_CYPHER_NBLK)
+        {
+          nblk = BCH_CYPHER_NBLK;
+        }
 
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
+      /* The tweaks of all blocks of the chunk */
+
+      for (j = 0; j < nblk; j++)
+        {
+          X[j][0] = bch->sector;
+          X[j][1] = 0;
+          X[j][2] = 0;
+          X[j][3] = i + j;
+        }
+
+      aes_cypher(X, X, 16 * nblk, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB,
+                 CYPHER_ENCRYPT);
 
       /* Xor-Encrypt-Xor */
 
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (j = 0; j < nblk; j++)
+        {
+          bch_xor(T[j], X[j], buffer + 4 * j);
+        }
+
+      aes_cypher(T, T, 16 * nblk, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB, encrypt);
+
+      for (j = 0; j < nblk; j++, buffer += 4)
+        {
+          bch_xor(buffer, X[j], T[j]);
+        }
     }
 
   return OK;
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
@@ -155,12 +156,52 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
+      if (bchlib_direct(buffer))
         {
-          ferr("ERROR: Read failed: %d\n");
-          return ret;
+          /* Make sure that the media holds any modified data in the
+           * sector buffer before reading around it.
+           */
+
+          if (bchlib_incache(bch, sector, nsectors))
+            {
+              ret = bchlib_flushsector(bch);
+              if (ret < 0)
+                {
+                  ferr("ERROR: Flush failed: %d\n", ret);
+                  return ret;
+                }
+            }
+
+          /* Read the contiguous sectors directly into the user buffer */
+
+          ret = bch->inode->u.i_bops->read(bch->inode,
+                                           (FAR uint8_t *)buffer,
+                                           sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return ret;
+            }
+        }
+      else
+        {
+          size_t i;
+
+          /* The user buffer cannot be used for the transfer.  Copy the
+           * sectors one at a time through the sector buffer.
+           */
+
+          for (i = 0; i < nsectors; i++)
+            {
+              ret = bchlib_readsector(bch, sector + i);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              memcpy(buffer + i * bch->sectsize, bch->buffer,
+                     bch->sectsize);
+            }
         }
 
       /* Adjust pointers and counts */
@@ -150,14 +150,51 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           return ret;
         }
 
-      /* Write the contiguous sectors */
-
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
-      if (ret < 0)
+      if (bchlib_direct(buffer))
         {
-          ferr("ERROR: Write failed: %d\n", ret);
-          return ret;
+          /* The sector buffer is stale if it holds one of the sectors
+           * being overwritten.
+           */
+
+          if (bchlib_incache(bch, sector, nsectors))
+            {
+              bch->sector = (size_t)-1;
+            }
+
+          /* Write the contiguous sectors directly from the user buffer */
+
+          ret = bch->inode->u.i_bops->write(bch->inode,
+                                            (FAR uint8_t *)buffer,
+                                            sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Write failed: %d\n", ret);
+              return ret;
+            }
+        }
+      else
+        {
+          size_t i;
+
+          /* The user buffer cannot be used for the transfer.  Copy the
+           * sectors one at a time through the sector buffer.  Each sector
+           * is completely replaced, so there is no need to read it first.
+           */
+
+          for (i = 0; i < nsectors; i++)
+            {
+              ret = bchlib_flushsector(bch);
+              if (ret < 0)
+                {
+                  ferr("ERROR: Flush failed: %d\n", ret);
+                  return ret;
+                }
+
+              memcpy(bch->buffer, buffer + i * bch->sectsize,
+                     bch->sectsize);
+              bch->sector = sector + i;
+              bch->dirty  = true;
+            }
         }
 
       /* Adjust pointers and counts */
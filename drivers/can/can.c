@@ -55,6 +55,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/can/can.h>
@@ -209,6 +210,26 @@ static void can_pollnotify(FAR struct can_dev_s *dev, pollevent_t eventset)
     }
 }
 
+/****************************************************************************
+ * Name: can_rxcount
+ *
+ * Description:
+ *   Return the number of messages queued in a receive FIFO.
+ *
+ ****************************************************************************/
+
+static inline int can_rxcount(FAR struct can_rxfifo_s *fifo)
+{
+  int count = fifo->rx_tail - fifo->rx_head;
+
+  if (count < 0)
+    {
+      count += CONFIG_CAN_FIFOSIZE;
+    }
+
+  return count;
+}
+
 /****************************************************************************
  * Name: can_dlc2bytes
  *
@@ -387,6 +408,7 @@ static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 
   reader->fifo.rx_head  = 0;
   reader->fifo.rx_tail  = 0;
+  reader->rx_nwait      = 1;
 
   nxsem_init(&reader->fifo.rx_sem, 0, 1);
   nxsem_set_protocol(&reader->fifo.rx_sem, SEM_PRIO_NONE);
@@ -589,6 +611,9 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
       if (dev->cd_error != 0)
         {
           FAR struct can_msg_s *msg;
+#ifdef CONFIG_CAN_TIMESTAMP
+          struct timespec ts;
+#endif
 
           /* Detected an internal driver error.  Generate a
            * CAN_ERROR_MESSAGE
@@ -608,6 +633,11 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
           msg->cm_hdr.ch_extid  = 0;
 #endif
           msg->cm_hdr.ch_unused = 0;
+#ifdef CONFIG_CAN_TIMESTAMP
+          clock_systime_timespec(&ts);
+          msg->cm_hdr.ch_ts.tv_sec  = ts.tv_sec;
+          msg->cm_hdr.ch_ts.tv_usec = ts.tv_nsec / 1000;
+#endif
           memset(&(msg->cm_data), 0, CAN_ERROR_DLC);
           msg->cm_data[5]       = dev->cd_error;
 
@@ -959,6 +989,101 @@ static inline ssize_t can_rtrread(FAR struct can_dev_s *dev,
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_rxwait
+ *
+ * Description:
+ *   Wait until the receive FIFO of the open instance holds the requested
+ *   number of messages (CANIOC_RXWAIT).  can_receive() does not wake the
+ *   reader until that level is reached.
+ *
+ ****************************************************************************/
+
+static int can_rxwait(FAR struct file *filep,
+                      FAR const struct canioc_rxwait_s *rxwait)
+{
+  FAR struct can_reader_s *reader;
+  FAR struct can_rxfifo_s *fifo;
+  irqstate_t               flags;
+  clock_t                  start;
+  uint32_t                 ticks = 0;
+  int                      nmsgs;
+  int                      ret   = OK;
+
+  if (rxwait == NULL)
+    {
+      return -EINVAL;
+    }
+
+  DEBUGASSERT(filep->f_priv != NULL);
+  reader = (FAR struct can_reader_s *)filep->f_priv;
+  fifo   = &reader->fifo;
+
+  /* The FIFO holds no more than CONFIG_CAN_FIFOSIZE - 1 messages */
+
+  nmsgs = rxwait->rw_nmsgs;
+  if (nmsgs < 1)
+    {
+      nmsgs = 1;
+    }
+
+  if (nmsgs > CONFIG_CAN_FIFOSIZE - 1)
+    {
+      nmsgs = CONFIG_CAN_FIFOSIZE - 1;
+    }
+
+  if (rxwait->rw_timeout > 0)
+    {
+      ticks = MSEC2TICK(rxwait->rw_timeout);
+      if (ticks == 0)
+        {
+          ticks = 1;
+        }
+    }
+
+  /* Interrupts must be disabled while accessing the cd_recv FIFO */
+
+  flags = enter_critical_section();
+  start = clock_systime_ticks();
+  reader->rx_nwait = nmsgs;
+
+  while (can_rxcount(fifo) < nmsgs)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      if (ticks > 0)
+        {
+          ret = nxsem_tickwait(&fifo->rx_sem, start, ticks);
+        }
+      else
+        {
+          ret = can_takesem(&fifo->rx_sem);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  reader->rx_nwait = 1;
+
+  /* Messages that arrived before the timeout are still worth a wakeup */
+
+  nmsgs = can_rxcount(fifo);
+  if (ret >= 0 || (ret == -ETIMEDOUT && nmsgs > 0))
+    {
+      ret = nmsgs;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
 /****************************************************************************
  * Name: can_ioctl
  ****************************************************************************/
@@ -986,6 +1111,38 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         ret = can_rtrread(dev, (FAR struct canioc_rtr_s *)((uintptr_t)arg));
         break;
 
+      /* CANIOC_RXWAIT: Wait for a number of messages to be received.
+       * Argument is a reference to struct canioc_rxwait_s.
+       */
+
+      case CANIOC_RXWAIT:
+        ret = can_rxwait(filep,
+                         (FAR const struct canioc_rxwait_s *)
+                         ((uintptr_t)arg));
+        break;
+
+#ifdef CONFIG_CAN_RXMMAP
+      /* FIOC_MMAP: Return the address of the receive FIFO of this open
+       * instance.  Argument is the location to return the address.
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(filep->f_priv != NULL);
+          if (addr == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              *addr = &((FAR struct can_reader_s *)filep->f_priv)->fifo;
+            }
+        }
+        break;
+#endif
+
       /* Not a "built-in" ioctl command.. perhaps it is unique to this
        * lower-half, device driver.
        */
@@ -1239,6 +1396,19 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
   caninfo("ID: %d DLC: %d\n", hdr->ch_id, hdr->ch_dlc);
 
+#ifdef CONFIG_CAN_TIMESTAMP
+  /* Stamp the message if the lower half has no hardware time stamp */
+
+  if (!dev->cd_hwtstamp)
+    {
+      struct timespec ts;
+
+      clock_systime_timespec(&ts);
+      hdr->ch_ts.tv_sec  = ts.tv_sec;
+      hdr->ch_ts.tv_usec = ts.tv_nsec / 1000;
+    }
+#endif
+
   /* Check if adding this new message would over-run the drivers ability to
    * enqueue read data.
    */
@@ -1340,10 +1510,11 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
           /* Increment the counting semaphore. The maximum value should
            * be CONFIG_CAN_FIFOSIZE -- one possible count for each allocated
-           * message buffer.
+           * message buffer.  A reader waiting in CANIOC_RXWAIT is not woken
+           * before the FIFO reaches the level that it waits for.
            */
 
-          if (sval <= 0)
+          if (sval <= 0 && can_rxcount(fifo) >= reader->rx_nwait)
             {
               can_givesem(&fifo->rx_sem);
             }
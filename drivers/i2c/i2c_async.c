@@ -0,0 +1,274 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_I2C_ASYNC_HPWORK) || !defined(CONFIG_SCHED_LPWORK)
+#  define I2CWORK HPWORK
+#else
+#  define I2CWORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of transfers of one I2C bus, sorted by priority */
+
+struct i2c_asyncq_s
+{
+  FAR struct i2c_master_s *dev;  /* The bus, NULL if the entry is free */
+  FAR struct i2c_async_s  *head; /* Next transfer to perform */
+  struct work_s            work; /* Performs the queued transfers */
+  bool                     busy; /* True: The work is scheduled */
+#ifdef CONFIG_I2C_ASYNC_BATCH
+  struct i2c_msg_s         msgs[CONFIG_I2C_ASYNC_MAXMSGS]; /* Merged batch */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct i2c_asyncq_s g_i2c_asyncq[CONFIG_I2C_ASYNC_NBUSES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_dequeue
+ *
+ * Description:
+ *   Remove the next transfer from the queue, together with the following
+ *   transfers that can be merged with it.
+ *
+ * Returned Value:
+ *   The list of the removed transfers (linked through flink), NULL if the
+ *   queue is empty.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct i2c_async_s *i2c_async_dequeue(FAR struct i2c_asyncq_s *q)
+{
+  FAR struct i2c_async_s *first = q->head;
+  FAR struct i2c_async_s *last = first;
+
+  if (first == NULL)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_I2C_ASYNC_BATCH
+  if (first->count <= CONFIG_I2C_ASYNC_MAXMSGS)
+    {
+      FAR struct i2c_async_s *next;
+      int nmsgs = first->count;
+
+      while ((next = last->flink) != NULL &&
+             nmsgs + next->count <= CONFIG_I2C_ASYNC_MAXMSGS &&
+             next->msgs[0].frequency == first->msgs[0].frequency)
+        {
+          nmsgs += next->count;
+          last   = next;
+        }
+    }
+#endif
+
+  q->head     = last->flink;
+  last->flink = NULL;
+  return first;
+}
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Perform the queued transfers of one bus until the queue is empty.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_asyncq_s *q = (FAR struct i2c_asyncq_s *)arg;
+  FAR struct i2c_async_s *req;
+  FAR struct i2c_async_s *next;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      req = i2c_async_dequeue(q);
+      if (req == NULL)
+        {
+          q->busy = false;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+
+#ifdef CONFIG_I2C_ASYNC_BATCH
+      if (req->flink != NULL)
+        {
+          int nmsgs = 0;
+
+          /* Pass the whole batch to the lower half in one go.  Each message
+           * carries its own address so the devices may differ.
+           */
+
+          for (next = req; next != NULL; next = next->flink)
+            {
+              memcpy(&q->msgs[nmsgs], next->msgs,
+                     next->count * sizeof(struct i2c_msg_s));
+              nmsgs += next->count;
+            }
+
+          ret = I2C_TRANSFER(q->dev, q->msgs, nmsgs);
+        }
+      else
+#endif
+        {
+          ret = I2C_TRANSFER(q->dev, req->msgs, req->count);
+        }
+
+      if (ret < 0)
+        {
+          i2cerr("ERROR: I2C_TRANSFER failed: %d\n", ret);
+        }
+
+      /* The callback may queue the next transfer and reuse 'req' */
+
+      for (; req != NULL; req = next)
+        {
+          next = req->flink;
+          req->callback(req, ret);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer and return without waiting for it.  See
+ *   include/nuttx/i2c/i2c_master.h.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *req)
+{
+  FAR struct i2c_asyncq_s *q = NULL;
+  FAR struct i2c_async_s **link;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(dev != NULL && req != NULL && req->msgs != NULL &&
+              req->count > 0 && req->callback != NULL);
+
+  flags = enter_critical_section();
+
+  /* Find the queue of this bus or a free one */
+
+  for (i = 0; i < CONFIG_I2C_ASYNC_NBUSES; i++)
+    {
+      if (g_i2c_asyncq[i].dev == dev)
+        {
+          q = &g_i2c_asyncq[i];
+          break;
+        }
+      else if (q == NULL && g_i2c_asyncq[i].dev == NULL)
+        {
+          q = &g_i2c_asyncq[i];
+        }
+    }
+
+  if (q == NULL)
+    {
+      i2cerr("ERROR: No queue for I2C bus %p\n", dev);
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  q->dev = dev;
+
+  /* Insert behind all transfers of the same or a higher priority */
+
+  for (link = &q->head;
+       *link != NULL && (*link)->priority >= req->priority;
+       link = &(*link)->flink)
+    {
+    }
+
+  req->flink = *link;
+  *link      = req;
+
+  if (!q->busy)
+    {
+      ret = work_queue(I2CWORK, &q->work, i2c_async_worker, q, 0);
+      if (ret < 0)
+        {
+          i2cerr("ERROR: work_queue failed: %d\n", ret);
+
+          /* Only this transfer can be in the queue */
+
+          q->head = NULL;
+          goto errout;
+        }
+
+      q->busy = true;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_I2C_ASYNC */
@@ -0,0 +1,571 @@
+/****************************************************************************
+ * drivers/input/touchscreen_upper.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/input/touchscreen.h>
+
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_INPUT_TOUCHSCREEN_NPOINTS
+#  define CONFIG_INPUT_TOUCHSCREEN_NPOINTS 1
+#endif
+
+#ifndef CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS
+#  define CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS 2
+#endif
+
+/* SP_DMB() is only provided when the architecture supports spinlocks */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+#define TOUCH_SLOTSIZE \
+  SIZEOF_TOUCH_SAMPLE_S(CONFIG_INPUT_TOUCHSCREEN_NPOINTS)
+#define TOUCH_SLOT(u,i) \
+  ((FAR struct touch_sample_s *)&(u)->ring[(i) * TOUCH_SLOTSIZE])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The ring has a single producer, touch_event(), which only writes 'head',
+ * and a single consumer, touch_read() under 'exclsem', which only writes
+ * 'tail'.  A slot is filled before 'head' moves past it and is not reused
+ * until 'tail' has moved past it, so neither side needs a lock.
+ */
+
+struct touch_upperhalf_s
+{
+  FAR struct touch_lowerhalf_s *lower;
+  sem_t             exclsem;          /* Serializes open, close and read */
+  sem_t             waitsem;          /* Wakes up a blocked reader */
+  uint8_t           crefs;            /* Number of opens */
+  volatile bool     waiting;          /* A reader is blocked on waitsem */
+  volatile uint16_t head;             /* Next slot to fill [IN] */
+  volatile uint16_t tail;             /* Next slot to read [OUT] */
+  uint16_t          mask;             /* Number of slots - 1 */
+  uint32_t          overruns;         /* Samples lost, ring full */
+
+  FAR struct pollfd *fds[CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS];
+
+  uint8_t           ring[1];          /* Actual size is (mask + 1) slots */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     touch_open(FAR struct file *filep);
+static int     touch_close(FAR struct file *filep);
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+static int     touch_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+static int     touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_touch_fops =
+{
+  touch_open,   /* open */
+  touch_close,  /* close */
+  touch_read,   /* read */
+  NULL,         /* write */
+  NULL,         /* seek */
+  touch_ioctl,  /* ioctl */
+  touch_poll    /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL        /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_pollnotify
+ ****************************************************************************/
+
+static void touch_pollnotify(FAR struct touch_upperhalf_s *upper,
+                             pollevent_t eventset)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = upper->fds[i];
+
+      if (fds != NULL && (fds->revents & eventset) == 0)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: touch_supersedes
+ *
+ * Description:
+ *   Return true if 'next' makes 'prev' redundant:  Both only report motion
+ *   of the same contacts, so only the latest position matters.
+ *
+ ****************************************************************************/
+
+static bool touch_supersedes(FAR const struct touch_sample_s *prev,
+                             FAR const struct touch_sample_s *next)
+{
+  int i;
+
+  if (prev->npoints != next->npoints)
+    {
+      return false;
+    }
+
+  for (i = 0; i < prev->npoints; i++)
+    {
+      if (prev->point[i].id != next->point[i].id ||
+          (prev->point[i].flags & (TOUCH_DOWN | TOUCH_UP)) != 0 ||
+          (next->point[i].flags & (TOUCH_DOWN | TOUCH_UP)) != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: touch_open
+ ****************************************************************************/
+
+static int touch_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->crefs == UINT8_MAX)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      upper->crefs++;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_close
+ ****************************************************************************/
+
+static int touch_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(upper->crefs > 0);
+  upper->crefs--;
+
+  nxsem_post(&upper->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: touch_read
+ *
+ * Description:
+ *   Return one sample.  Samples waiting in the ring that are superseded by
+ *   a later one are skipped.
+ *
+ ****************************************************************************/
+
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct touch_sample_s *sample;
+  FAR struct touch_sample_s *next;
+  uint16_t head;
+  uint16_t tail;
+  size_t npoints;
+  int ret;
+
+  if (buflen < SIZEOF_TOUCH_SAMPLE_S(1))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  tail = upper->tail;
+  while ((head = upper->head) == tail)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      /* Announce the wait, then look again in case touch_event() filled a
+       * slot before it could see the announcement.
+       */
+
+      upper->waiting = true;
+      SP_DMB();
+
+      if (upper->head != tail)
+        {
+          upper->waiting = false;
+          continue;
+        }
+
+      ret = nxsem_wait(&upper->waitsem);
+      upper->waiting = false;
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  /* Make sure that the slot contents are read after the head index */
+
+  SP_DMB();
+
+  /* Skip samples that are superseded by the next one */
+
+  sample = TOUCH_SLOT(upper, tail);
+  while (((tail + 1) & upper->mask) != head)
+    {
+      next = TOUCH_SLOT(upper, (tail + 1) & upper->mask);
+      if (!touch_supersedes(sample, next))
+        {
+          break;
+        }
+
+      tail   = (tail + 1) & upper->mask;
+      sample = next;
+    }
+
+  /* Return as many points as fit into the user buffer */
+
+  npoints = (buflen - offsetof(struct touch_sample_s, point)) /
+            sizeof(struct touch_point_s);
+  if (npoints > sample->npoints)
+    {
+      npoints = sample->npoints;
+    }
+
+  memcpy(buffer, sample, SIZEOF_TOUCH_SAMPLE_S(npoints));
+  ((FAR struct touch_sample_s *)buffer)->npoints = npoints;
+  ret = SIZEOF_TOUCH_SAMPLE_S(npoints);
+
+  /* Release the slot only after it has been copied */
+
+  SP_DMB();
+  upper->tail = (tail + 1) & upper->mask;
+
+errout:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_ioctl
+ ****************************************************************************/
+
+static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct touch_lowerhalf_s *lower = upper->lower;
+
+  if (lower->control == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  return lower->control(lower, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: touch_poll
+ ****************************************************************************/
+
+static int touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (upper->head != upper->tail)
+        {
+          leave_critical_section(flags);
+          touch_pollnotify(upper, POLLIN);
+          return OK;
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll */
+
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_event
+ *
+ * Description:
+ *   Report a sample to the upper half.  This may be called from interrupt
+ *   handlers and work queues, but only from one context at a time.  At
+ *   most CONFIG_INPUT_TOUCHSCREEN_NPOINTS points of each sample are kept.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOSPC if the ring was full and the sample was lost.
+ *
+ ****************************************************************************/
+
+int touch_event(FAR struct touch_lowerhalf_s *lower,
+                FAR const struct touch_sample_s *sample)
+{
+  FAR struct touch_upperhalf_s *upper = lower->priv;
+  FAR struct touch_sample_s *slot;
+  uint16_t head;
+  uint16_t next;
+  int npoints;
+
+  DEBUGASSERT(upper != NULL && sample != NULL);
+
+  head = upper->head;
+  next = (head + 1) & upper->mask;
+  if (next == upper->tail)
+    {
+      /* The ring is full.  The reader is far enough behind that it will
+       * get the next sample soon enough.
+       */
+
+      upper->overruns++;
+      return -ENOSPC;
+    }
+
+  npoints = sample->npoints;
+  if (npoints > CONFIG_INPUT_TOUCHSCREEN_NPOINTS)
+    {
+      npoints = CONFIG_INPUT_TOUCHSCREEN_NPOINTS;
+    }
+
+  slot = TOUCH_SLOT(upper, head);
+  memcpy(slot, sample, SIZEOF_TOUCH_SAMPLE_S(npoints));
+  slot->npoints = npoints;
+
+  /* Publish the slot, then wake up a blocked reader */
+
+  SP_DMB();
+  upper->head = next;
+  SP_DMB();
+
+  if (upper->waiting)
+    {
+      upper->waiting = false;
+      nxsem_post(&upper->waitsem);
+    }
+
+  touch_pollnotify(upper, POLLIN);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Register a touchscreen lower half with the common upper half as the
+ *   character device 'path'.
+ *
+ * Input Parameters:
+ *   lower    - The lower half driver instance
+ *   path     - The device path, e.g. "/dev/input0"
+ *   nsamples - The number of samples the ring can hold; rounded up to a
+ *              power of two
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower, FAR const char *path,
+                   uint8_t nsamples)
+{
+  FAR struct touch_upperhalf_s *upper;
+  uint16_t nslots;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && path != NULL);
+
+  /* One slot is always left empty to tell a full ring from an empty one */
+
+  for (nslots = 2; nslots < (uint16_t)nsamples + 1; nslots <<= 1)
+    {
+    }
+
+  upper = (FAR struct touch_upperhalf_s *)
+    kmm_zalloc(sizeof(struct touch_upperhalf_s) + nslots * TOUCH_SLOTSIZE);
+  if (upper == NULL)
+    {
+      ierr("ERROR: Failed to allocate the upper half\n");
+      return -ENOMEM;
+    }
+
+  upper->lower = lower;
+  upper->mask  = nslots - 1;
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->waitsem, 0, 0);
+  nxsem_set_protocol(&upper->waitsem, SEM_PRIO_NONE);
+
+  lower->priv = upper;
+
+  ret = register_driver(path, &g_touch_fops, 0444, upper);
+  if (ret < 0)
+    {
+      ierr("ERROR: register_driver failed: %d\n", ret);
+      lower->priv = NULL;
+      nxsem_destroy(&upper->exclsem);
+      nxsem_destroy(&upper->waitsem);
+      kmm_free(upper);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_unregister
+ *
+ * Description:
+ *   Unregister a touchscreen device registered by touch_register().
+ *
+ ****************************************************************************/
+
+void touch_unregister(FAR struct touch_lowerhalf_s *lower,
+                      FAR const char *path)
+{
+  FAR struct touch_upperhalf_s *upper = lower->priv;
+
+  DEBUGASSERT(upper != NULL);
+
+  unregister_driver(path);
+  lower->priv = NULL;
+
+  nxsem_destroy(&upper->exclsem);
+  nxsem_destroy(&upper->waitsem);
+  kmm_free(upper);
+}
+
+#endif /* CONFIG_INPUT_TOUCHSCREEN */
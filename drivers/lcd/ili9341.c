@@ -389,6 +389,12 @@ struct ili9341_dev_s
 
   int (*putrun)(fb_coord_t row, fb_coord_t col,
                 FAR const uint8_t * buffer, size_t npixels);
+
+  /* Driver specific putarea function */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, size_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
   /* Driver specific getrun function */
 
@@ -430,6 +436,10 @@ static inline uint16_t ili9341_getyres(FAR struct ili9341_dev_s *dev);
 
 static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col,
                          FAR const uint8_t * buffer, size_t npixels);
+static int ili9341_putarea(int devno, fb_coord_t row_start,
+                           fb_coord_t row_end, fb_coord_t col_start,
+                           fb_coord_t col_end, FAR const uint8_t *buffer,
+                           size_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
 static int ili9341_getrun(int devno, fb_coord_t row, fb_coord_t col,
                          FAR uint8_t * buffer, size_t npixels);
@@ -442,10 +452,16 @@ static int ili9341_getrun(int devno, fb_coord_t row, fb_coord_t col,
 #ifdef CONFIG_LCD_ILI9341_IFACE0
 static int ili9341_putrun0(fb_coord_t row, fb_coord_t col,
                            FAR const uint8_t *buffer, size_t npixsels);
+static int ili9341_putarea0(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride);
 #endif
 #ifdef CONFIG_LCD_ILI9341_IFACE1
 static int ili9341_putrun1(fb_coord_t row, fb_coord_t col,
                             FAR const uint8_t * buffer, size_t npixsels);
+static int ili9341_putarea1(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride);
 #endif
 
 #ifndef CONFIG_LCD_NOGETRUN
@@ -492,6 +508,7 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] =
   {
     .lcd              = 0,
     .putrun           = ili9341_putrun0,
+    .putarea          = ili9341_putarea0,
 # ifndef CONFIG_LCD_NOGETRUN
     .getrun           = ili9341_getrun0,
 # endif
@@ -506,6 +523,7 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] =
   {
     .lcd              = 0,
     .putrun           = ili9341_putrun1,
+    .putarea          = ili9341_putarea1,
 # ifndef CONFIG_LCD_NOGETRUN
     .getrun           = ili9341_getrun1,
 # endif
@@ -673,6 +691,84 @@ static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col,
   return OK;
 }
 
+/****************************************************************************
+ * Name:  ili9341_putarea
+ *
+ * Description:
+ *   Write a rectangular area to the LCD.  The address window is selected
+ *   once for the whole area.  If the rows are contiguous in the buffer, the
+ *   area is sent to the gram in a single transfer; otherwise one transfer
+ *   is made per row without reprogramming the window.
+ *
+ * Input Parameters:
+ *   devno     - Number of lcd device
+ *   row_start - Starting row to write to (range: 0 <= row < yres)
+ *   row_end   - Ending row to write to (range: row_start <= row < yres)
+ *   col_start - Starting column to write to (range: 0 <= col < xres)
+ *   col_end   - Ending column to write to
+ *               (range: col_start <= col_end < xres)
+ *   buffer    - The buffer containing the area to be written to the LCD
+ *   stride    - The distance in bytes between two rows in the buffer
+ *
+ * Returned Value:
+ *
+ *   On success - OK
+ *   On error   - -EINVAL
+ *
+ ****************************************************************************/
+
+static int ili9341_putarea(int devno, fb_coord_t row_start,
+                           fb_coord_t row_end, fb_coord_t col_start,
+                           fb_coord_t col_end, FAR const uint8_t *buffer,
+                           size_t stride)
+{
+  FAR struct ili9341_dev_s *dev = &g_lcddev[devno];
+  FAR struct ili9341_lcd_s *lcd = dev->lcd;
+  size_t width = col_end - col_start + 1;
+  fb_coord_t row;
+
+  DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0 && (stride & 1) == 0);
+
+  /* Check if position outside of area */
+
+  if (col_end >= ili9341_getxres(dev) || row_end >= ili9341_getyres(dev) ||
+      col_start > col_end || row_start > row_end)
+    {
+      return -EINVAL;
+    }
+
+  /* Select lcd driver */
+
+  lcd->select(lcd);
+
+  /* Select the area and start the memory write */
+
+  ili9341_selectarea(lcd, col_start, row_start, col_end, row_end);
+  lcd->sendcmd(lcd, ILI9341_MEMORY_WRITE);
+
+  if (stride == width * sizeof(uint16_t))
+    {
+      /* The rows are contiguous, send the whole area at once */
+
+      lcd->sendgram(lcd, (FAR const uint16_t *)buffer,
+                    width * (row_end - row_start + 1));
+    }
+  else
+    {
+      for (row = row_start; row <= row_end; row++)
+        {
+          lcd->sendgram(lcd, (FAR const uint16_t *)buffer, width);
+          buffer += stride;
+        }
+    }
+
+  /* Deselect the lcd driver */
+
+  lcd->deselect(lcd);
+
+  return OK;
+}
+
 
 /****************************************************************************
  * Name:  ili9341_getrun
@@ -859,6 +955,14 @@ static int ili9341_putrun0(fb_coord_t row, fb_coord_t col,
 {
   return ili9341_putrun(0, row, col, buffer, npixels);
 }
+
+static int ili9341_putarea0(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride)
+{
+  return ili9341_putarea(0, row_start, row_end, col_start, col_end,
+                         buffer, stride);
+}
 #endif
 
 #ifdef CONFIG_LCD_ILI9341_IFACE1
@@ -867,6 +971,14 @@ static int ili9341_putrun1(fb_coord_t row, fb_coord_t col,
 {
   return ili9341_putrun(1, row, col, buffer, npixels);
 }
+
+static int ili9341_putarea1(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride)
+{
+  return ili9341_putarea(1, row_start, row_end, col_start, col_end,
+                         buffer, stride);
+}
 #endif
 
 
@@ -973,6 +1085,7 @@ static int ili9341_getplaneinfo(FAR struct lcd_dev_s *dev, unsigned int planeno,
       FAR struct ili9341_dev_s *priv = (FAR struct ili9341_dev_s *)dev;
 
       pinfo->putrun = priv->putrun;
+      pinfo->putarea = priv->putarea;
 #ifndef CONFIG_LCD_NOGETRUN
       pinfo->getrun = priv->getrun;
 #endif
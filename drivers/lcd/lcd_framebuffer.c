@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -47,6 +48,8 @@
 
 #include <nuttx/board.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/lcd/lcd.h>
 #include <nuttx/video/fb.h>
 
@@ -60,6 +63,25 @@
 
 #define VIDEO_PLANE 0
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+#  ifdef CONFIG_SCHED_LPWORK
+#    define LCDFBWORK LPWORK
+#  else
+#    define LCDFBWORK HPWORK
+#  endif
+
+#  define LCDFB_NDIRTY   CONFIG_LCD_FRAMEBUFFER_NDIRTY
+#  define LCDFB_INTERVAL MSEC2TICK(CONFIG_LCD_FRAMEBUFFER_INTERVAL)
+#endif
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#  define MAX(a,b) ((a) > (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -78,6 +100,16 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+  /* Dirty rectangles not yet pushed to the LCD.  Updates are coalesced
+   * here and written once per frame interval from the work queue.
+   */
+
+  struct work_s work;               /* Deferred update work */
+  uint8_t ndirty;                   /* Number of valid dirty rectangles */
+  struct fb_area_s dirty[LCDFB_NDIRTY];
+#endif
 };
 
 /****************************************************************************
@@ -165,53 +197,37 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
 }
 
 /****************************************************************************
- * Name: lcdfb_updateearea
+ * Name: lcdfb_clip
  *
  * Description:
- * Update the LCD when there is a change to the framebuffer.
+ *   Clip an area to the framebuffer.  Returns false if nothing is left.
  *
  ****************************************************************************/
 
-static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
-                             FAR const struct fb_area_s *area)
+static bool lcdfb_clip(FAR struct lcdfb_dev_s *priv,
+                       FAR const struct fb_area_s *area,
+                       FAR struct fb_area_s *clipped)
 {
-  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
-  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
-  FAR uint8_t *run;
-  fb_coord_t row;
   fb_coord_t startx;
   fb_coord_t endx;
-  fb_coord_t width;
   fb_coord_t starty;
   fb_coord_t endy;
-  int ret;
-
-  DEBUGASSERT(area != NULL);
-  DEBUGASSERT(area->w >= 1);
-  DEBUGASSERT(area->h >= 1);
 
-  /* Clip to fit in the framebuffer */
-
-  startx = area->x;
-  if (startx < 0)
+  if (area->x >= priv->xres || area->y >= priv->yres)
     {
-      startx = 0;
+      return false;
     }
 
-  endx = startx + area->w - 1;
-  if (endx >= priv->xres)
+  startx = area->x;
+  endx   = startx + area->w - 1;
+  if (endx >= priv->xres || endx < startx)
     {
       endx = priv->xres - 1;
     }
 
   starty = area->y;
-  if (starty < 0)
-    {
-      starty = 0;
-    }
-
-  endy = starty + area->h - 1;
-  if (endy >= priv->yres)
+  endy   = starty + area->h - 1;
+  if (endy >= priv->yres || endy < starty)
     {
       endy = priv->yres - 1;
     }
@@ -220,26 +236,57 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
    * rectangle on the left so that it is byte aligned.  Works for BPP={1,2,4}
    */
 
-  if (pinfo->bpp < 8)
+  if (priv->pinfo.bpp < 8)
     {
-      unsigned int pixperbyte = 8 / pinfo->bpp;
+      unsigned int pixperbyte = 8 / priv->pinfo.bpp;
       startx &= ~(pixperbyte - 1);
     }
 
-  width = endx - startx + 1;
+  clipped->x = startx;
+  clipped->y = starty;
+  clipped->w = endx - startx + 1;
+  clipped->h = endy - starty + 1;
+  return true;
+}
+
+/****************************************************************************
+ * Name: lcdfb_flush
+ *
+ * Description:
+ *   Write a clipped area of the framebuffer to the LCD.  The LCD putarea()
+ *   method is used if the driver provides one, so that the whole area goes
+ *   out in one transfer; otherwise the area is written row by row.
+ *
+ ****************************************************************************/
+
+static int lcdfb_flush(FAR struct lcdfb_dev_s *priv,
+                       FAR const struct fb_area_s *area)
+{
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  FAR uint8_t *run;
+  fb_coord_t row;
+  fb_coord_t endy;
+  int ret;
 
   /* Get the starting position in the framebuffer */
 
-  run  = priv->fbmem + starty * priv->stride;
-  run += (startx * pinfo->bpp + 7) >> 3;
+  run  = priv->fbmem + area->y * priv->stride;
+  run += (area->x * pinfo->bpp + 7) >> 3;
+  endy = area->y + area->h - 1;
+
+  if (pinfo->putarea != NULL)
+    {
+      return pinfo->putarea(area->y, endy, area->x, area->x + area->w - 1,
+                            run, priv->stride);
+    }
 
-  for (row = starty; row <= endy; row++)
+  for (row = area->y; row <= endy; row++)
     {
       /* REVISIT: Some LCD hardware certain alignment requirements on DMA
        * memory.
        */
 
-      ret = pinfo->putrun(row, startx, run, width);
+      ret = pinfo->putrun(row, area->x, run, area->w);
       if (ret < 0)
         {
           return ret;
@@ -251,6 +298,170 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
   return OK;
 }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+/****************************************************************************
+ * Name: lcdfb_union
+ *
+ * Description:
+ *   Grow the dirty rectangle 'dest' so that it also covers 'area'.
+ *
+ ****************************************************************************/
+
+static void lcdfb_union(FAR struct fb_area_s *dest,
+                        FAR const struct fb_area_s *area)
+{
+  fb_coord_t endx = MAX(dest->x + dest->w, area->x + area->w);
+  fb_coord_t endy = MAX(dest->y + dest->h, area->y + area->h);
+
+  dest->x = MIN(dest->x, area->x);
+  dest->y = MIN(dest->y, area->y);
+  dest->w = endx - dest->x;
+  dest->h = endy - dest->y;
+}
+
+/****************************************************************************
+ * Name: lcdfb_growth
+ *
+ * Description:
+ *   Return the number of pixels that 'dest' would grow by if merged with
+ *   'area'.
+ *
+ ****************************************************************************/
+
+static uint32_t lcdfb_growth(FAR const struct fb_area_s *dest,
+                             FAR const struct fb_area_s *area)
+{
+  struct fb_area_s merged = *dest;
+
+  lcdfb_union(&merged, area);
+  return (uint32_t)merged.w * merged.h - (uint32_t)dest->w * dest->h;
+}
+
+/****************************************************************************
+ * Name: lcdfb_worker
+ *
+ * Description:
+ *   Push the coalesced dirty rectangles to the LCD.
+ *
+ ****************************************************************************/
+
+static void lcdfb_worker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)arg;
+  struct fb_area_s dirty[LCDFB_NDIRTY];
+  irqstate_t flags;
+  int ndirty;
+  int ret;
+  int i;
+
+  /* Take the dirty list so that new updates can be recorded while the
+   * LCD transfer is in progress.
+   */
+
+  flags  = enter_critical_section();
+  ndirty = priv->ndirty;
+  memcpy(dirty, priv->dirty, ndirty * sizeof(struct fb_area_s));
+  priv->ndirty = 0;
+  leave_critical_section(flags);
+
+  for (i = 0; i < ndirty; i++)
+    {
+      ret = lcdfb_flush(priv, &dirty[i]);
+      if (ret < 0)
+        {
+          lcderr("ERROR: LCD update failed: %d\n", ret);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: lcdfb_adddirty
+ *
+ * Description:
+ *   Record a clipped area as dirty and schedule the deferred update.
+ *
+ ****************************************************************************/
+
+static void lcdfb_adddirty(FAR struct lcdfb_dev_s *priv,
+                           FAR const struct fb_area_s *area)
+{
+  irqstate_t flags;
+  uint32_t best = UINT32_MAX;
+  uint32_t growth;
+  int merge = 0;
+  int i;
+
+  flags = enter_critical_section();
+
+  for (i = 0; i < priv->ndirty; i++)
+    {
+      growth = lcdfb_growth(&priv->dirty[i], area);
+      if (growth < best)
+        {
+          best  = growth;
+          merge = i;
+        }
+    }
+
+  /* Merge with the cheapest rectangle if that adds no pixels beyond the
+   * new area itself (overlapping or adjacent areas) or if the list is
+   * full.  Disjoint areas otherwise get their own entry, so that two small
+   * widgets at opposite corners do not turn into a full screen update.
+   */
+
+  if (priv->ndirty > 0 && (priv->ndirty >= LCDFB_NDIRTY ||
+      best <= (uint32_t)area->w * area->h))
+    {
+      lcdfb_union(&priv->dirty[merge], area);
+    }
+  else
+    {
+      priv->dirty[priv->ndirty++] = *area;
+    }
+
+  if (work_available(&priv->work))
+    {
+      work_queue(LCDFBWORK, &priv->work, lcdfb_worker, priv,
+                 LCDFB_INTERVAL);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: lcdfb_updateearea
+ *
+ * Description:
+ * Update the LCD when there is a change to the framebuffer.
+ *
+ ****************************************************************************/
+
+static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
+                             FAR const struct fb_area_s *area)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  struct fb_area_s clipped;
+
+  DEBUGASSERT(area != NULL);
+  DEBUGASSERT(area->w >= 1);
+  DEBUGASSERT(area->h >= 1);
+
+  /* Clip to fit in the framebuffer */
+
+  if (!lcdfb_clip(priv, area, &clipped))
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+  lcdfb_adddirty(priv, &clipped);
+  return OK;
+#else
+  return lcdfb_flush(priv, &clipped);
+#endif
+}
+
 /****************************************************************************
  * Name: lcdfb_getvideoinfo
  ****************************************************************************/
@@ -586,7 +797,7 @@ int up_fbinitialize(int display)
   area.w = priv->xres;
   area.h = priv->yres;
 
-  ret = lcdfb_updateearea(&priv->vtable, &area);
+  ret = lcdfb_flush(priv, &area);
   if (ret < 0)
     {
       lcderr("FB update failed: %d\n", ret);
@@ -686,6 +897,12 @@ void up_fbuninitialize(int display)
               g_lcdfb = priv->flink;
             }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DEFERRED
+          /* Stop any pending deferred update */
+
+          work_cancel(LCDFBWORK, &priv->work);
+#endif
+
 #ifndef CONFIG_LCD_EXTERNINIT
           /* Uninitialize the LCD */
 
@@ -193,6 +193,9 @@ static void st7735_fill(FAR struct st7735_dev_s *dev, uint16_t color);
 
 static int st7735_putrun(fb_coord_t row, fb_coord_t col,
                          FAR const uint8_t *buffer, size_t npixels);
+static int st7735_putarea(fb_coord_t row_start, fb_coord_t row_end,
+                          fb_coord_t col_start, fb_coord_t col_end,
+                          FAR const uint8_t *buffer, size_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
 static int st7735_getrun(fb_coord_t row, fb_coord_t col,
                          FAR uint8_t *buffer, size_t npixels);
@@ -476,6 +479,58 @@ static int st7735_putrun(fb_coord_t row, fb_coord_t col,
   return OK;
 }
 
+/****************************************************************************
+ * Name:  st7735_putarea
+ *
+ * Description:
+ *   This method can be used to write a rectangular area to the LCD:
+ *
+ *   row_start - Starting row to write to (range: 0 <= row < yres)
+ *   row_end   - Ending row to write to (range: row_start <= row < yres)
+ *   col_start - Starting column to write to (range: 0 <= col < xres)
+ *   col_end   - Ending column to write to
+ *               (range: col_start <= col_end < xres)
+ *   buffer    - The buffer containing the area to be written to the LCD
+ *   stride    - The distance in bytes between two rows in the buffer
+ *
+ *   The address window is set once.  Contiguous rows are sent with a
+ *   single SPI block transfer, otherwise one block is sent per row.
+ *
+ ****************************************************************************/
+
+static int st7735_putarea(fb_coord_t row_start, fb_coord_t row_end,
+                          fb_coord_t col_start, fb_coord_t col_end,
+                          FAR const uint8_t *buffer, size_t stride)
+{
+  FAR struct st7735_dev_s *priv = &g_lcddev;
+  size_t width = col_end - col_start + 1;
+  fb_coord_t row;
+
+  ginfo("row: %d-%d col: %d-%d\n", row_start, row_end, col_start, col_end);
+  DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0 && (stride & 1) == 0);
+
+  st7735_setarea(priv, col_start, row_start, col_end, row_end);
+
+  if (stride == width * ST7735_BYTESPP)
+    {
+      st7735_wrram(priv, (FAR const uint16_t *)buffer,
+                   width * (row_end - row_start + 1));
+      return OK;
+    }
+
+  st7735_sendcmd(priv, ST7735_RAMWR);
+  st7735_select(priv->spi, ST7735_BYTESPP * 8);
+
+  for (row = row_start; row <= row_end; row++)
+    {
+      SPI_SNDBLOCK(priv->spi, buffer, width);
+      buffer += stride;
+    }
+
+  st7735_deselect(priv->spi);
+  return OK;
+}
+
 /****************************************************************************
  * Name:  st7735_getrun
  *
@@ -547,6 +602,7 @@ static int st7735_getplaneinfo(FAR struct lcd_dev_s *dev,
   lcdinfo("planeno: %d bpp: %d\n", planeno, ST7735_BPP);
 
   pinfo->putrun = st7735_putrun;                  /* Put a run into LCD memory */
+  pinfo->putarea = st7735_putarea;                /* Put an area into LCD memory */
 #ifndef CONFIG_LCD_NOGETRUN
   pinfo->getrun = st7735_getrun;                  /* Get a run from LCD memory */
 #endif
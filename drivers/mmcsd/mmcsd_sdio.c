@@ -49,6 +49,8 @@
 #include <nuttx/sdio.h>
 #include <nuttx/mmcsd.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/dma.h>
 
 #include "mmcsd.h"
 #include "mmcsd_sdio.h"
@@ -85,6 +87,22 @@
 
 #define IS_EMPTY(priv) (priv->type == MMCSD_CARDTYPE_UNKNOWN)
 
+/* Queued block requests are serviced on the low priority work queue */
+
+#if defined(CONFIG_FS_BLOCK_REQUEST) && defined(CONFIG_SCHED_LPWORK)
+#  define MMCSD_HAVE_REQUESTS 1
+#endif
+
+/* Buffers that the SDIO DMA cannot use directly (rejected by the preflight
+ * check or not cache-line aligned) are bounced through a DMA-safe buffer
+ * one block at a time instead of failing the transfer.
+ */
+
+#if defined(CONFIG_SDIO_DMA) && \
+    (defined(CONFIG_ARCH_HAVE_SDIO_PREFLIGHT) || defined(CONFIG_ARCH_DCACHE))
+#  define MMCSD_HAVE_DMABOUNCE 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -106,6 +124,8 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+  uint8_t cmd23:1;                 /* true: card supports CMD23 (from SCR or CSD) */
+  uint8_t highspeed:1;             /* true: SD high speed mode selected */
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -113,6 +133,7 @@ struct mmcsd_state_s
   uint8_t mode:2;                  /* (See MMCSDMODE_* definitions) */
   uint8_t type:4;                  /* Card type (See MMCSD_CARDTYPE_* definitions) */
   uint8_t buswidth:4;              /* Bus widths supported (SD only) */
+  uint8_t sdversion:4;             /* SD_SPEC from the SCR (SD only) */
   sdio_capset_t caps;              /* SDIO driver capabilities/limitations */
   uint16_t selblocklen;            /* The currently selected block length */
   uint16_t rca;                    /* Relative Card Address (RCS) register */
@@ -134,6 +155,19 @@ struct mmcsd_state_s
 #if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
   struct rwbuffer_s rwbuffer;
 #endif
+
+  /* Queued block requests */
+
+#ifdef MMCSD_HAVE_REQUESTS
+  FAR struct blk_request_s *reqhead; /* First queued request */
+  FAR struct blk_request_s *reqtail; /* Last queued request */
+  struct work_s reqwork;             /* Services the request queue */
+  bool reqbusy;                      /* true: reqwork is queued or running */
+#endif
+
+#ifdef MMCSD_HAVE_DMABOUNCE
+  FAR uint8_t *dmabuf;               /* One block DMA-safe bounce buffer */
+#endif
 };
 
 /****************************************************************************
@@ -180,9 +214,20 @@ static int     mmcsd_eventwait(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                 size_t nblocks);
 #endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                  uint32_t blocklen);
+#ifdef MMCSD_HAVE_DMABOUNCE
+static bool    mmcsd_needbounce(FAR struct mmcsd_state_s *priv,
+                 FAR const uint8_t *buffer, size_t nbytes);
+static ssize_t mmcsd_bounceread(FAR struct mmcsd_state_s *priv,
+                 FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+static ssize_t mmcsd_bouncewrite(FAR struct mmcsd_state_s *priv,
+                 FAR const uint8_t *buffer, off_t startblock,
+                 size_t nblocks);
+#endif
 static ssize_t mmcsd_readsingle(FAR struct mmcsd_state_s *priv,
                  FAR uint8_t *buffer, off_t startblock);
 #ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
@@ -205,6 +250,18 @@ static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 #endif
 
+/* Transfer helpers *********************************************************/
+
+static ssize_t mmcsd_readsectors(FAR struct mmcsd_state_s *priv,
+                 FAR unsigned char *buffer, size_t startsector,
+                 unsigned int nsectors);
+static ssize_t mmcsd_writesectors(FAR struct mmcsd_state_s *priv,
+                 FAR const unsigned char *buffer, size_t startsector,
+                 unsigned int nsectors);
+#ifdef MMCSD_HAVE_REQUESTS
+static void    mmcsd_reqworker(FAR void *arg);
+#endif
+
 /* Block driver methods *****************************************************/
 
 static int     mmcsd_open(FAR struct inode *inode);
@@ -218,11 +275,18 @@ static int     mmcsd_geometry(FAR struct inode *inode,
                  FAR struct geometry *geometry);
 static int     mmcsd_ioctl(FAR struct inode *inode, int cmd,
                  unsigned long arg);
+#ifdef MMCSD_HAVE_REQUESTS
+static int     mmcsd_submit(FAR struct inode *inode,
+                 FAR struct blk_request_s *req);
+#endif
 
 /* Initialization/uninitialization/reset ************************************/
 
 static void    mmcsd_mediachange(FAR void *arg);
 static int     mmcsd_widebus(FAR struct mmcsd_state_s *priv);
+#ifdef CONFIG_MMCSD_HIGHSPEED
+static int     mmcsd_highspeed(FAR struct mmcsd_state_s *priv);
+#endif
 #ifdef CONFIG_MMCSD_MMCSUPPORT
 static int     mmcsd_mmcinitialize(FAR struct mmcsd_state_s *priv);
 static int     mmcsd_read_csd (FAR struct mmcsd_state_s *priv);
@@ -245,7 +309,13 @@ static const struct block_operations g_bops =
   mmcsd_read,     /* read     */
   mmcsd_write,    /* write    */
   mmcsd_geometry, /* geometry */
-  mmcsd_ioctl     /* ioctl    */
+  mmcsd_ioctl,    /* ioctl    */
+#ifdef MMCSD_HAVE_REQUESTS
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,           /* unlink   */
+#endif
+  mmcsd_submit    /* submit   */
+#endif
 };
 
 /****************************************************************************
@@ -587,6 +657,14 @@ static void mmcsd_decode_csd(FAR struct mmcsd_state_s *priv, uint32_t csd[4])
    */
 
   priv->dsrimp             = (csd[1] >> 12) & 1;
+
+  /* MMC cards support CMD23 (SET_BLOCK_COUNT) since version 3.1 */
+
+  if (IS_MMC(priv->type))
+    {
+      priv->cmd23          = ((csd[0] >> 26) & 0x0f) >= 3;
+    }
+
   readbllen                = (csd[1] >> 16) & 0x0f;
 
 #ifdef CONFIG_DEBUG_FS_INFO
@@ -963,8 +1041,8 @@ static void mmcsd_decode_cid(FAR struct mmcsd_state_s *priv, uint32_t cid[4])
  * Name: mmsd_decode_scr
  *
  * Description:
- *   Show the contents of the SD Configuration Register (SCR).  The only
- *   value retained is:  priv->buswidth;
+ *   Show the contents of the SD Configuration Register (SCR).  The values
+ *   retained are:  priv->buswidth, priv->sdversion and priv->cmd23.
  *
  ****************************************************************************/
 
@@ -980,13 +1058,18 @@ static void mmsd_decode_scr(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
    *   DATA_STATE_AFTER_ERASE 55:55 1-bit erase status
    *   SD_SECURITY            54:52 3-bit SD security support level
    *   SD_BUS_WIDTHS          51:48 4-bit bus width indicator
-   *   Reserved               47:32 16-bit SD reserved space
+   *   Reserved               47:34 SD reserved space
+   *   CMD_SUPPORT            33:32 2-bit command support (CMD23, CMD20)
    */
 
 #ifdef CONFIG_ENDIAN_BIG  /* Card transfers SCR in big-endian order */
   priv->buswidth     = (scr[0] >> 16) & 15;
+  priv->sdversion    = (scr[0] >> 24) & 15;
+  priv->cmd23        = (scr[0] & MMCSD_SCR_CMD23_SUPPORT) != 0;
 #else
   priv->buswidth     = (scr[0] >> 8) & 15;
+  priv->sdversion    =  scr[0]       & 15;
+  priv->cmd23        = ((scr[0] >> 24) & MMCSD_SCR_CMD23_SUPPORT) != 0;
 #endif
 
 #ifdef CONFIG_DEBUG_FS_INFO
@@ -997,7 +1080,7 @@ static void mmsd_decode_scr(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
    */
 
   decoded.scrversion =  scr[0] >> 28;
-  decoded.sdversion  = (scr[0] >> 24) & 15;
+  decoded.sdversion  = priv->sdversion;
   decoded.erasestate = (scr[0] >> 23) & 1;
   decoded.security   = (scr[0] >> 20) & 7;
 #else
@@ -1007,7 +1090,7 @@ static void mmsd_decode_scr(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
    */
 
   decoded.scrversion = (scr[0] >> 4)  & 15;
-  decoded.sdversion  =  scr[0]        & 15;
+  decoded.sdversion  = priv->sdversion;
   decoded.erasestate = (scr[0] >> 15) & 1;
   decoded.security   = (scr[0] >> 12) & 7;
 #endif
@@ -1315,6 +1398,49 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Announce the number of blocks of the following multiple block transfer
+ *   with CMD23 (SET_BLOCK_COUNT).  The transfer then ends after that many
+ *   blocks without a STOP_TRANSMISSION.
+ *
+ * Returned Value:
+ *   OK if CMD23 was accepted; -ENOSYS if CMD23 is not used, then the
+ *   transfer must be ended with mmcsd_stoptransmission(); another negated
+ *   errno value if the command failed.
+ *
+ ****************************************************************************/
+
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               size_t nblocks)
+{
+#ifdef CONFIG_MMCSD_CMD23
+  int ret;
+
+  if (!priv->cmd23 || nblocks > MMCSD_CMD23_MAXBLOCKS)
+    {
+      return -ENOSYS;
+    }
+
+  /* Send CMD23, SET_BLOCK_COUNT (the same command index for SD and MMC),
+   * and verify good R1 return status
+   */
+
+  mmcsd_sendcmdpoll(priv, MMC_CMD23, nblocks);
+  ret = mmsd_recv_r1(priv, MMC_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmsd_recv_r1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
 #endif
 
 /****************************************************************************
@@ -1354,6 +1480,136 @@ static int mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
   return ret;
 }
 
+/****************************************************************************
+ * Name: mmcsd_needbounce
+ *
+ * Description:
+ *   Return true if the buffer cannot be handed to the SDIO DMA directly.
+ *
+ ****************************************************************************/
+
+#ifdef MMCSD_HAVE_DMABOUNCE
+static bool mmcsd_needbounce(FAR struct mmcsd_state_s *priv,
+                             FAR const uint8_t *buffer, size_t nbytes)
+{
+  if ((priv->caps & SDIO_CAPS_DMASUPPORTED) == 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_ARCH_HAVE_SDIO_PREFLIGHT
+  if (SDIO_DMAPREFLIGHT(priv->dev, buffer, nbytes) != OK)
+    {
+      return true;
+    }
+#endif
+
+#ifdef CONFIG_ARCH_DCACHE
+  /* Cache maintenance on a buffer that shares its first or last cache
+   * line with other data would corrupt that data.
+   */
+
+  return !DMA_ALIGNED(buffer, nbytes);
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: mmcsd_bouncebuffer
+ *
+ * Description:
+ *   Return the bounce buffer, allocating it on first use.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *mmcsd_bouncebuffer(FAR struct mmcsd_state_s *priv)
+{
+  if (priv->dmabuf == NULL)
+    {
+      priv->dmabuf = kmm_dma_alloc(priv->blocksize);
+      if (priv->dmabuf == NULL)
+        {
+          ferr("ERROR: Failed to allocate the DMA bounce buffer\n");
+        }
+    }
+
+  return priv->dmabuf;
+}
+
+/****************************************************************************
+ * Name: mmcsd_bounceread
+ *
+ * Description:
+ *   Read blocks one at a time through the bounce buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_bounceread(FAR struct mmcsd_state_s *priv,
+                                FAR uint8_t *buffer, off_t startblock,
+                                size_t nblocks)
+{
+  FAR uint8_t *dmabuf = mmcsd_bouncebuffer(priv);
+  ssize_t ret;
+  size_t i;
+
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nblocks; i++)
+    {
+      ret = mmcsd_readsingle(priv, dmabuf, startblock + i);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      memcpy(buffer, dmabuf, priv->blocksize);
+      buffer += priv->blocksize;
+    }
+
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: mmcsd_bouncewrite
+ *
+ * Description:
+ *   Write blocks one at a time through the bounce buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_bouncewrite(FAR struct mmcsd_state_s *priv,
+                                 FAR const uint8_t *buffer,
+                                 off_t startblock, size_t nblocks)
+{
+  FAR uint8_t *dmabuf = mmcsd_bouncebuffer(priv);
+  ssize_t ret;
+  size_t i;
+
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nblocks; i++)
+    {
+      memcpy(dmabuf, buffer, priv->blocksize);
+      ret = mmcsd_writesingle(priv, dmabuf, startblock + i);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      buffer += priv->blocksize;
+    }
+
+  return nblocks;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_readsingle
  *
@@ -1379,6 +1635,13 @@ static ssize_t mmcsd_readsingle(FAR struct mmcsd_state_s *priv,
       return -EPERM;
     }
 
+#ifdef MMCSD_HAVE_DMABOUNCE
+  if (mmcsd_needbounce(priv, buffer, priv->blocksize))
+    {
+      return mmcsd_bounceread(priv, buffer, startblock, 1);
+    }
+#endif
+
 #if defined(CONFIG_SDIO_DMA) && defined(CONFIG_ARCH_HAVE_SDIO_PREFLIGHT)
   /* If we think we are going to perform a DMA transfer, make sure that we
    * will be able to before we commit the card to the operation.
@@ -1503,6 +1766,7 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
 {
   size_t nbytes;
   off_t  offset;
+  int predefined;
   int ret;
 
   finfo("startblock=%d nblocks=%d\n", startblock, nblocks);
@@ -1516,6 +1780,13 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return -EPERM;
     }
 
+#ifdef MMCSD_HAVE_DMABOUNCE
+  if (mmcsd_needbounce(priv, buffer, nblocks << priv->blockshift))
+    {
+      return mmcsd_bounceread(priv, buffer, startblock, nblocks);
+    }
+#endif
+
 #if defined(CONFIG_SDIO_DMA) && defined(CONFIG_ARCH_HAVE_SDIO_PREFLIGHT)
   /* If we think we are going to perform a DMA transfer, make sure that we
    * will be able to before we commit the card to the operation.
@@ -1572,6 +1843,14 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
+  /* Announce the number of blocks with CMD23, if supported */
+
+  predefined = mmcsd_setblockcount(priv, nblocks);
+  if (predefined != OK && predefined != -ENOSYS)
+    {
+      return predefined;
+    }
+
   /* Configure SDIO controller hardware for the read transfer */
 
   SDIO_BLOCKSETUP(priv->dev, priv->blocksize, nblocks);
@@ -1614,12 +1893,21 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
   if (ret != OK)
     {
       ferr("ERROR: CMD18 transfer failed: %d\n", ret);
+      if (predefined == OK)
+        {
+          mmcsd_stoptransmission(priv);
+        }
+
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION unless the block count was set with CMD23 */
+
+  if (predefined != OK)
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
 #ifdef CONFIG_SDIO_DMA
   SDIO_DMADELYDINVLDT(priv->dev, buffer, priv->blocksize * nblocks);
 #endif
@@ -1726,6 +2014,13 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_state_s *priv,
       return -EPERM;
     }
 
+#ifdef MMCSD_HAVE_DMABOUNCE
+  if (mmcsd_needbounce(priv, buffer, priv->blocksize))
+    {
+      return mmcsd_bouncewrite(priv, buffer, startblock, 1);
+    }
+#endif
+
 #if defined(CONFIG_SDIO_DMA) && defined(CONFIG_ARCH_HAVE_SDIO_PREFLIGHT)
   /* If we think we are going to perform a DMA transfer, make sure that we
    * will be able to before we commit the card to the operation.
@@ -1880,6 +2175,7 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 {
   off_t  offset;
   size_t nbytes;
+  int predefined;
   int ret;
   int evret = OK;
 
@@ -1896,6 +2192,13 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
       return -EPERM;
     }
 
+#ifdef MMCSD_HAVE_DMABOUNCE
+  if (mmcsd_needbounce(priv, buffer, nblocks << priv->blockshift))
+    {
+      return mmcsd_bouncewrite(priv, buffer, startblock, nblocks);
+    }
+#endif
+
 #if defined(CONFIG_SDIO_DMA) && defined(CONFIG_ARCH_HAVE_SDIO_PREFLIGHT)
   /* If we think we are going to perform a DMA transfer, make sure that we
    * will be able to before we commit the card to the operation.
@@ -1983,6 +2286,16 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
         }
     }
 
+  /* Announce the number of blocks with CMD23, if supported.  It must
+   * immediately precede CMD25.
+   */
+
+  predefined = mmcsd_setblockcount(priv, nblocks);
+  if (predefined != OK && predefined != -ENOSYS)
+    {
+      return predefined;
+    }
+
   /* If Controller does not need DMA setup before the write then send CMD25
    * now.
    */
@@ -2057,9 +2370,15 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
        */
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION unless the block count was set with CMD23 and
+   * the transfer completed.
+   */
+
+  if (predefined != OK || evret != OK)
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
   if (evret != OK)
     {
       return evret;
@@ -2212,7 +2531,7 @@ static int mmcsd_close(FAR struct inode *inode)
 }
 
 /****************************************************************************
- * Name: mmcsd_read
+ * Name: mmcsd_readsectors
  *
  * Description:
  *   Read the specified number of sectors from the read-ahead buffer or from
@@ -2220,18 +2539,16 @@ static int mmcsd_close(FAR struct inode *inode)
  *
  ****************************************************************************/
 
-static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
-                          size_t startsector, unsigned int nsectors)
+static ssize_t mmcsd_readsectors(FAR struct mmcsd_state_s *priv,
+                                 FAR unsigned char *buffer,
+                                 size_t startsector, unsigned int nsectors)
 {
-  FAR struct mmcsd_state_s *priv;
 #if !defined(CONFIG_DRVR_READAHEAD) && defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
   size_t sector;
   size_t endsector;
 #endif
   ssize_t ret = nsectors;
 
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct mmcsd_state_s *)inode->i_private;
   finfo("startsector: %d nsectors: %d sectorsize: %d\n",
         startsector, nsectors, priv->blocksize);
 
@@ -2291,7 +2608,7 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
 }
 
 /****************************************************************************
- * Name: mmcsd_write
+ * Name: mmcsd_writesectors
  *
  * Description:
  *   Write the specified number of sectors to the write buffer or to the
@@ -2299,20 +2616,16 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
  *
  ****************************************************************************/
 
-static ssize_t mmcsd_write(FAR struct inode *inode,
-                           FAR const unsigned char *buffer,
-                           size_t startsector, unsigned int nsectors)
+static ssize_t mmcsd_writesectors(FAR struct mmcsd_state_s *priv,
+                                  FAR const unsigned char *buffer,
+                                  size_t startsector, unsigned int nsectors)
 {
-  FAR struct mmcsd_state_s *priv;
 #if defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
   size_t sector;
   size_t endsector;
 #endif
   ssize_t ret = nsectors;
 
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct mmcsd_state_s *)inode->i_private;
-
   finfo("sector: %lu nsectors: %u sectorsize: %u\n",
         (unsigned long)startsector, nsectors, priv->blocksize);
 
@@ -2371,6 +2684,126 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
   return ret;
 }
 
+/****************************************************************************
+ * Name: mmcsd_reqworker
+ *
+ * Description:
+ *   Service the queue of block requests on the low priority work queue.
+ *   Requests for sequential sectors in the same direction whose buffers
+ *   are also contiguous are merged into one multiple block transfer.
+ *
+ ****************************************************************************/
+
+#ifdef MMCSD_HAVE_REQUESTS
+static void mmcsd_reqworker(FAR void *arg)
+{
+  FAR struct mmcsd_state_s *priv = (FAR struct mmcsd_state_s *)arg;
+  FAR struct blk_request_s *first;
+  FAR struct blk_request_s *last;
+  FAR struct blk_request_s *next;
+  unsigned int nsectors;
+  irqstate_t flags;
+  ssize_t ret;
+
+  for (; ; )
+    {
+      /* Remove the next request and any requests that can be merged with
+       * it from the head of the queue.
+       */
+
+      flags = enter_critical_section();
+      first = priv->reqhead;
+      if (first == NULL)
+        {
+          priv->reqbusy = false;
+          leave_critical_section(flags);
+          return;
+        }
+
+      last     = first;
+      nsectors = first->br_nsectors;
+
+      while ((next = last->br_flink) != NULL &&
+             next->br_op == first->br_op &&
+             next->br_sector == first->br_sector + nsectors &&
+             next->br_buffer == first->br_buffer +
+                                nsectors * priv->blocksize)
+        {
+          nsectors += next->br_nsectors;
+          last      = next;
+        }
+
+      priv->reqhead = last->br_flink;
+      if (priv->reqhead == NULL)
+        {
+          priv->reqtail = NULL;
+        }
+
+      last->br_flink = NULL;
+      leave_critical_section(flags);
+
+      /* Perform the (merged) transfer */
+
+      if (first->br_op == BLKREQ_READ)
+        {
+          ret = mmcsd_readsectors(priv, first->br_buffer,
+                                  first->br_sector, nsectors);
+        }
+      else
+        {
+          ret = mmcsd_writesectors(priv, first->br_buffer,
+                                   first->br_sector, nsectors);
+        }
+
+      /* Complete each of the requests that were merged */
+
+      while (first != NULL)
+        {
+          next             = first->br_flink;
+          first->br_flink  = NULL;
+          first->br_result = ret < 0 ? ret : (ssize_t)first->br_nsectors;
+          first->br_complete(first);
+          first            = next;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: mmcsd_read
+ *
+ * Description:
+ *   Read the specified number of sectors from the read-ahead buffer or from
+ *   the physical device.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
+                          size_t startsector, unsigned int nsectors)
+{
+  DEBUGASSERT(inode && inode->i_private);
+  return mmcsd_readsectors((FAR struct mmcsd_state_s *)inode->i_private,
+                           buffer, startsector, nsectors);
+}
+
+/****************************************************************************
+ * Name: mmcsd_write
+ *
+ * Description:
+ *   Write the specified number of sectors to the write buffer or to the
+ *   physical device.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_write(FAR struct inode *inode,
+                           FAR const unsigned char *buffer,
+                           size_t startsector, unsigned int nsectors)
+{
+  DEBUGASSERT(inode && inode->i_private);
+  return mmcsd_writesectors((FAR struct mmcsd_state_s *)inode->i_private,
+                            buffer, startsector, nsectors);
+}
+
 /****************************************************************************
  * Name: mmcsd_geometry
  *
@@ -2502,6 +2935,69 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
  * Initialization/uninitialization/reset
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mmcsd_submit
+ *
+ * Description:
+ *   Queue a block request.  The transfer is performed later on the low
+ *   priority work queue and req->br_complete() is called from there.
+ *
+ ****************************************************************************/
+
+#ifdef MMCSD_HAVE_REQUESTS
+static int mmcsd_submit(FAR struct inode *inode,
+                        FAR struct blk_request_s *req)
+{
+  FAR struct mmcsd_state_s *priv;
+  irqstate_t flags;
+  bool start;
+
+  DEBUGASSERT(inode && inode->i_private && req);
+  priv = (FAR struct mmcsd_state_s *)inode->i_private;
+
+  if (req->br_nsectors == 0 || IS_EMPTY(priv))
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_MMCSD_READONLY
+  if (req->br_op == BLKREQ_WRITE)
+    {
+      return -EACCES;
+    }
+#endif
+
+  /* Add the request to the end of the queue and start the worker if it is
+   * not already draining the queue.  Only one worker may run at a time so
+   * that requests are performed in the order that they were submitted.
+   */
+
+  req->br_flink = NULL;
+
+  flags = enter_critical_section();
+  if (priv->reqhead == NULL)
+    {
+      priv->reqhead = req;
+    }
+  else
+    {
+      priv->reqtail->br_flink = req;
+    }
+
+  priv->reqtail = req;
+  start         = !priv->reqbusy;
+  priv->reqbusy = true;
+  leave_critical_section(flags);
+
+  if (start)
+    {
+      work_queue(LPWORK, &priv->reqwork, mmcsd_reqworker, priv, 0);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_mediachange
  *
@@ -2653,6 +3149,95 @@ static int mmcsd_widebus(FAR struct mmcsd_state_s *priv)
   return -ENOSYS;
 }
 
+/****************************************************************************
+ * Name: mmcsd_highspeed
+ *
+ * Description:
+ *   Switch an SD card to the high speed bus mode with CMD6 (SWITCH_FUNC)
+ *   and select the high speed clock.  The card must be in 4-bit mode.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_HIGHSPEED
+static int mmcsd_highspeed(FAR struct mmcsd_state_s *priv)
+{
+  uint32_t buffer[MMCSD_CMD6_STATUS_SIZE / sizeof(uint32_t)];
+  FAR uint8_t *status = (FAR uint8_t *)buffer;
+  int ret;
+
+  /* CMD6 exists since SD version 1.10; the SDIO driver must also be able
+   * to clock the bus at 50MHz.
+   */
+
+  if (priv->highspeed)
+    {
+      return OK;
+    }
+
+  if (priv->sdversion < MMCSD_SCR_SPEC_1_10 ||
+      (priv->caps & SDIO_CAPS_HIGHSPEED) == 0)
+    {
+      return -ENOSYS;
+    }
+
+  ret = mmcsd_setblocklen(priv, MMCSD_CMD6_STATUS_SIZE);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_setblocklen failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Setup up to receive the 512-bit switch status */
+
+  SDIO_BLOCKSETUP(priv->dev, MMCSD_CMD6_STATUS_SIZE, 1);
+  SDIO_RECVSETUP(priv->dev, status, MMCSD_CMD6_STATUS_SIZE);
+
+  SDIO_WAITENABLE(priv->dev,
+                  SDIOWAIT_TRANSFERDONE | SDIOWAIT_TIMEOUT |
+                  SDIOWAIT_ERROR);
+
+  /* Send CMD6 in switch mode, selecting the high speed function of the
+   * access mode group and leaving the other groups unchanged.
+   */
+
+  mmcsd_sendcmdpoll(priv, MMCSD_CMD6,
+                    MMCSD_CMD6_MODE_SWITCH | MMCSD_CMD6_GROUP1_HIGHSPEED);
+  ret = mmsd_recv_r1(priv, MMCSD_CMD6);
+  if (ret != OK)
+    {
+      ferr("ERROR: RECVR1 for CMD6 failed: %d\n", ret);
+      SDIO_CANCEL(priv->dev);
+      return ret;
+    }
+
+  ret = mmcsd_eventwait(priv, SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR,
+                        MMCSD_SCR_DATADELAY);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_eventwait for CMD6 status failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The status tells the function that is now selected in group 1 */
+
+  if (MMCSD_CMD6_STATUS_GROUP1(status) != 1)
+    {
+      fwarn("WARNING: Card did not switch to high speed: %x\n",
+            MMCSD_CMD6_STATUS_GROUP1(status));
+      return -ENOSYS;
+    }
+
+  /* The card switches within 8 clocks after the status */
+
+  finfo("High speed mode selected\n");
+  SDIO_CLOCK(priv->dev, CLOCK_SD_TRANSFER_HS);
+  up_udelay(MMCSD_CLK_DELAY);
+
+  priv->highspeed = true;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_mmcinitialize
  *
@@ -3043,11 +3628,21 @@ static int mmcsd_sdinitialize(FAR struct mmcsd_state_s *priv)
       ferr("ERROR: Failed to set wide bus operation: %d\n", ret);
     }
 
-  /* TODO: If wide-bus selected, then send CMD6 to see if the card supports
-   * high speed mode.  A new SDIO method will be needed to set high speed
-   * mode.
+#ifdef CONFIG_MMCSD_HIGHSPEED
+  /* If wide-bus selected, then send CMD6 to switch to high speed mode if
+   * both the card and the SDIO driver support it.
    */
 
+  if (priv->widebus)
+    {
+      ret = mmcsd_highspeed(priv);
+      if (ret != OK)
+        {
+          fwarn("WARNING: High speed mode not selected: %d\n", ret);
+        }
+    }
+#endif
+
   return OK;
 }
 
@@ -3553,10 +4148,19 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->rca          = 0;
   priv->selblocklen  = 0;
 
+#ifdef MMCSD_HAVE_DMABOUNCE
+  /* The bounce buffer is sized for this card's block size */
+
+  kmm_dma_free(priv->dmabuf);
+  priv->dmabuf       = NULL;
+#endif
+
   /* Go back to the default 1-bit data bus. */
 
   SDIO_WIDEBUS(priv->dev, false);
   priv->widebus      = false;
+  priv->highspeed    = false;
+  priv->cmd23        = false;
 
   /* Disable clocking to the card */
 
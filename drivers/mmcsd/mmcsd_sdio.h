@@ -181,6 +181,21 @@
 #define MMCSD_SCR_BUSWIDTH_4BIT     (4)
 #define MMCSD_SCR_BUSWIDTH_8BIT     (8)
 
+#define MMCSD_SCR_SPEC_1_10         (1)                    /* SD_SPEC: Version 1.10 or later */
+#define MMCSD_SCR_CMD23_SUPPORT     (2)                    /* CMD_SUPPORT: CMD23 (SET_BLOCK_COUNT) */
+
+/* CMD6 (SWITCH_FUNC) argument and 512-bit switch status */
+
+#define MMCSD_CMD6_MODE_CHECK       ((uint32_t)0 << 31)    /* Query the functions */
+#define MMCSD_CMD6_MODE_SWITCH      ((uint32_t)1 << 31)    /* Switch the functions */
+#define MMCSD_CMD6_GROUP1_HIGHSPEED ((uint32_t)0x00fffff1) /* Group 1, function 1: High speed */
+#define MMCSD_CMD6_STATUS_SIZE      (64)                   /* Size of the switch status (bytes) */
+#define MMCSD_CMD6_STATUS_GROUP1(s) ((s)[16] & 0x0f)       /* Bits 379:376: Group 1 function */
+
+/* CMD23 (SET_BLOCK_COUNT) argument */
+
+#define MMCSD_CMD23_MAXBLOCKS       (0xffff)               /* Bits 15:0: Block count */
+
 /* Last 4 bytes of the 48-bit R7 response */
 
 #define MMCSD_R7VERSION_SHIFT       (28)                   /* Bits 28-31: Command version number */
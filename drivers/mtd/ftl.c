@@ -28,12 +28,16 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <string.h>
 #include <debug.h>
 #include <errno.h>
+#ifdef CONFIG_FTL_LOGSTRUCT
+#  include <crc32.h>
+#endif
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
@@ -57,10 +61,35 @@
 
 #define DEV_NAME_MAX    (NAME_MAX + 5)
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+/* Log-structured mode.  The first R/W block of every physical erase block
+ * holds a header naming the logical erase block stored in the remaining
+ * R/W blocks.
+ */
+
+#  define FTL_MAGIC     0x4c544673           /* "sFTL" */
+#  define FTL_UNMAPPED  UINT32_MAX           /* map[]: never written */
+#  define FTL_FREE      UINT32_MAX           /* rmap[]: free erase block */
+#  define FTL_BAD       (UINT32_MAX - 1)     /* rmap[]: retired erase block */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+/* The erase block header (log-structured mode) */
+
+struct ftl_ehdr_s
+{
+  uint32_t magic;                 /* FTL_MAGIC */
+  uint32_t lblock;                /* Logical erase block stored here */
+  uint32_t seq;                   /* Write sequence number */
+  uint32_t erasecnt;              /* Erase count of this erase block */
+  uint32_t crc;                   /* CRC32 of the fields above */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;      /* Contained MTD interface */
@@ -72,6 +101,15 @@ struct ftl_struct_s
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
   FAR uint8_t          *eblock;   /* One, in-memory erase block */
+#ifdef CONFIG_FTL_LOGSTRUCT
+  uint16_t              lblkper;  /* Data R/W blocks per erase block */
+  uint32_t              nlogical; /* Number of logical erase blocks */
+  uint32_t              nphys;    /* Number of physical erase blocks */
+  uint32_t              seq;      /* Last write sequence number */
+  FAR uint32_t         *map;      /* Logical to physical erase block */
+  FAR uint32_t         *rmap;     /* Physical to logical erase block */
+  FAR uint32_t         *erasecnt; /* Erase count per physical block */
+#endif
 };
 
 /****************************************************************************
@@ -96,6 +134,13 @@ static int     ftl_ioctl(FAR struct inode *inode, int cmd,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     ftl_unlink(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FTL_LOGSTRUCT
+static ssize_t ftl_log_reload(FAR struct ftl_struct_s *dev,
+                 FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+static ssize_t ftl_log_flush(FAR struct ftl_struct_s *dev,
+                 FAR const uint8_t *buffer, off_t startblock,
+                 size_t nblocks);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -164,6 +209,10 @@ static int ftl_close(FAR struct inode *inode)
           kmm_free(dev->eblock);
         }
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+      kmm_free(dev->map);
+#endif
+
       kmm_free(dev);
     }
 
@@ -183,6 +232,10 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   ssize_t nread;
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+  return ftl_log_reload(dev, buffer, startblock, nblocks);
+#endif
+
   /* Read the full erase block into the buffer */
 
   nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
@@ -238,6 +291,480 @@ static int ftl_alloc_eblock(FAR struct ftl_struct_s *dev)
   return dev->eblock != NULL ? OK : -ENOMEM;
 }
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+/****************************************************************************
+ * Name: ftl_log_hdrcrc
+ *
+ * Description: Return the CRC that protects an erase block header
+ *
+ ****************************************************************************/
+
+static uint32_t ftl_log_hdrcrc(FAR const struct ftl_ehdr_s *hdr)
+{
+  return crc32((FAR const uint8_t *)hdr, offsetof(struct ftl_ehdr_s, crc));
+}
+
+/****************************************************************************
+ * Name: ftl_log_allocphys
+ *
+ * Description:
+ *   Select a free physical erase block.  Normally the least worn free block
+ *   is returned so that hot data is spread over the whole device; static
+ *   wear leveling asks for the most worn one to park cold data on it.
+ *
+ ****************************************************************************/
+
+static int ftl_log_allocphys(FAR struct ftl_struct_s *dev, bool mostworn,
+                             FAR uint32_t *phys)
+{
+  uint32_t best = FTL_UNMAPPED;
+  uint32_t i;
+
+  for (i = 0; i < dev->nphys; i++)
+    {
+      if (dev->rmap[i] != FTL_FREE)
+        {
+          continue;
+        }
+
+      if (best == FTL_UNMAPPED ||
+          (mostworn ? dev->erasecnt[i] > dev->erasecnt[best] :
+                      dev->erasecnt[i] < dev->erasecnt[best]))
+        {
+          best = i;
+        }
+    }
+
+  if (best == FTL_UNMAPPED)
+    {
+      return -ENOSPC;
+    }
+
+  *phys = best;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_readblock
+ *
+ * Description:
+ *   Read 'nblocks' data blocks starting at data block 'first' of logical
+ *   erase block 'lblock'.  Logical blocks that were never written read
+ *   back as erased FLASH.
+ *
+ ****************************************************************************/
+
+static int ftl_log_readblock(FAR struct ftl_struct_s *dev, uint32_t lblock,
+                             FAR uint8_t *buffer, off_t first,
+                             size_t nblocks)
+{
+  uint32_t phys = dev->map[lblock];
+  off_t rwblock;
+  ssize_t nxfrd;
+
+  if (phys == FTL_UNMAPPED)
+    {
+      memset(buffer, CONFIG_FTL_ERASED_STATE, nblocks * dev->geo.blocksize);
+      return OK;
+    }
+
+  rwblock = (off_t)phys * dev->blkper + 1 + first;
+  nxfrd   = MTD_BREAD(dev->mtd, rwblock, nblocks, buffer);
+  if (nxfrd != nblocks)
+    {
+      ferr("ERROR: Read %zu blocks at block %jd failed: %zd\n",
+           nblocks, (intmax_t)rwblock, nxfrd);
+      return nxfrd < 0 ? (int)nxfrd : -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_commit
+ *
+ * Description:
+ *   Write the logical erase block held in dev->eblock (after the header
+ *   block) to a fresh physical erase block and remap it.  The data blocks
+ *   are written first and the header last, so an interrupted write leaves
+ *   the previous copy of the logical block in place.  Blocks that fail to
+ *   erase or program are retired.
+ *
+ ****************************************************************************/
+
+static int ftl_log_commit(FAR struct ftl_struct_s *dev, uint32_t lblock,
+                          bool mostworn)
+{
+  struct ftl_ehdr_s hdr;
+  uint32_t phys;
+  uint32_t old;
+  off_t rwblock;
+  ssize_t nxfrd;
+  int ret;
+
+  for (; ; )
+    {
+      ret = ftl_log_allocphys(dev, mostworn, &phys);
+      if (ret < 0)
+        {
+          ferr("ERROR: No free erase block for logical block %lu\n",
+               (unsigned long)lblock);
+          return ret;
+        }
+
+      /* Erase lazily, just before the block is reused, so that a released
+       * block keeps its old header (and therefore its erase count) on
+       * FLASH until then.
+       */
+
+      dev->erasecnt[phys]++;
+      ret = MTD_ERASE(dev->mtd, phys, 1);
+      if (ret < 0)
+        {
+          ferr("ERROR: Erase block=%lu failed: %d\n",
+               (unsigned long)phys, ret);
+          dev->rmap[phys] = FTL_BAD;
+          continue;
+        }
+
+      rwblock = (off_t)phys * dev->blkper;
+      nxfrd   = MTD_BWRITE(dev->mtd, rwblock + 1, dev->lblkper,
+                           dev->eblock + dev->geo.blocksize);
+      if (nxfrd == dev->lblkper)
+        {
+          hdr.magic    = FTL_MAGIC;
+          hdr.lblock   = lblock;
+          hdr.seq      = ++dev->seq;
+          hdr.erasecnt = dev->erasecnt[phys];
+          hdr.crc      = ftl_log_hdrcrc(&hdr);
+
+          memset(dev->eblock, CONFIG_FTL_ERASED_STATE, dev->geo.blocksize);
+          memcpy(dev->eblock, &hdr, sizeof(hdr));
+
+          nxfrd = MTD_BWRITE(dev->mtd, rwblock, 1, dev->eblock);
+          if (nxfrd == 1)
+            {
+              break;
+            }
+        }
+
+      ferr("ERROR: Write erase block %lu failed: %zd\n",
+           (unsigned long)phys, nxfrd);
+      dev->rmap[phys] = FTL_BAD;
+    }
+
+  /* The new copy is committed; the old one becomes free */
+
+  old = dev->map[lblock];
+  if (old != FTL_UNMAPPED)
+    {
+      dev->rmap[old] = FTL_FREE;
+    }
+
+  dev->map[lblock] = phys;
+  dev->rmap[phys]  = lblock;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_wearlevel
+ *
+ * Description:
+ *   Static wear leveling.  Dynamic wear leveling (always writing to the
+ *   least worn free block) never touches blocks holding data that is not
+ *   rewritten.  When the most worn free block is more than
+ *   CONFIG_FTL_WEAR_THRESHOLD erases ahead of the least worn block in use,
+ *   move that cold data onto the worn block so the fresh one rejoins the
+ *   free pool.
+ *
+ ****************************************************************************/
+
+static int ftl_log_wearlevel(FAR struct ftl_struct_s *dev)
+{
+  uint32_t cold = FTL_UNMAPPED;
+  uint32_t worn = FTL_UNMAPPED;
+  uint32_t lblock;
+  uint32_t i;
+  int ret;
+
+  for (i = 0; i < dev->nphys; i++)
+    {
+      if (dev->rmap[i] == FTL_FREE)
+        {
+          if (worn == FTL_UNMAPPED || dev->erasecnt[i] > dev->erasecnt[worn])
+            {
+              worn = i;
+            }
+        }
+      else if (dev->rmap[i] != FTL_BAD)
+        {
+          if (cold == FTL_UNMAPPED || dev->erasecnt[i] < dev->erasecnt[cold])
+            {
+              cold = i;
+            }
+        }
+    }
+
+  if (cold == FTL_UNMAPPED || worn == FTL_UNMAPPED ||
+      dev->erasecnt[worn] <= dev->erasecnt[cold] + CONFIG_FTL_WEAR_THRESHOLD)
+    {
+      return OK;
+    }
+
+  lblock = dev->rmap[cold];
+  finfo("Moving logical block %lu from %lu to %lu\n",
+        (unsigned long)lblock, (unsigned long)cold, (unsigned long)worn);
+
+  ret = ftl_log_readblock(dev, lblock, dev->eblock + dev->geo.blocksize,
+                          0, dev->lblkper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return ftl_log_commit(dev, lblock, true);
+}
+
+/****************************************************************************
+ * Name: ftl_log_reload
+ *
+ * Description: Read the specified number of sectors through the map
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_reload(FAR struct ftl_struct_s *dev,
+                              FAR uint8_t *buffer, off_t startblock,
+                              size_t nblocks)
+{
+  size_t remaining = nblocks;
+  uint32_t lblock;
+  off_t offset;
+  size_t ncopy;
+  int ret;
+
+  while (remaining > 0)
+    {
+      lblock = startblock / dev->lblkper;
+      offset = startblock - (off_t)lblock * dev->lblkper;
+      ncopy  = dev->lblkper - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      ret = ftl_log_readblock(dev, lblock, buffer, offset, ncopy);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      startblock += ncopy;
+      remaining  -= ncopy;
+      buffer     += ncopy * dev->geo.blocksize;
+    }
+
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_flush
+ *
+ * Description:
+ *   Write the specified number of sectors.  Each logical erase block that
+ *   is touched is merged with its current contents and written out of
+ *   place; nothing is ever erased and rewritten in place.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_flush(FAR struct ftl_struct_s *dev,
+                             FAR const uint8_t *buffer, off_t startblock,
+                             size_t nblocks)
+{
+  FAR uint8_t *data;
+  size_t remaining = nblocks;
+  uint32_t lblock;
+  off_t offset;
+  size_t ncopy;
+  int ret;
+
+  ret = ftl_alloc_eblock(dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to allocate an erase block buffer\n");
+      return ret;
+    }
+
+  data = dev->eblock + dev->geo.blocksize;
+  while (remaining > 0)
+    {
+      lblock = startblock / dev->lblkper;
+      offset = startblock - (off_t)lblock * dev->lblkper;
+      ncopy  = dev->lblkper - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      /* Only a partial update needs the current contents */
+
+      if (ncopy < dev->lblkper)
+        {
+          ret = ftl_log_readblock(dev, lblock, data, 0, dev->lblkper);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      memcpy(data + offset * dev->geo.blocksize, buffer,
+             ncopy * dev->geo.blocksize);
+
+      ret = ftl_log_commit(dev, lblock, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      startblock += ncopy;
+      remaining  -= ncopy;
+      buffer     += ncopy * dev->geo.blocksize;
+    }
+
+  ret = ftl_log_wearlevel(dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: Wear leveling failed: %d\n", ret);
+    }
+
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Allocate the mapping tables and rebuild them from the erase block
+ *   headers on FLASH.  When two physical blocks claim the same logical
+ *   block, the one with the higher sequence number is current and the
+ *   other is free.  Blocks without a valid header are free.
+ *
+ ****************************************************************************/
+
+static int ftl_log_initialize(FAR struct ftl_struct_s *dev)
+{
+  struct ftl_ehdr_s hdr;
+  FAR uint32_t *seqs;
+  ssize_t nxfrd;
+  uint32_t i;
+  int ret;
+
+  if (dev->blkper < 2 ||
+      dev->geo.blocksize < sizeof(struct ftl_ehdr_s) ||
+      dev->geo.neraseblocks <= CONFIG_FTL_SPARE_BLOCKS)
+    {
+      ferr("ERROR: Geometry unsuitable for the log-structured FTL\n");
+      return -EINVAL;
+    }
+
+  dev->lblkper  = dev->blkper - 1;
+  dev->nphys    = dev->geo.neraseblocks;
+  dev->nlogical = dev->nphys - CONFIG_FTL_SPARE_BLOCKS;
+
+  /* One allocation holds the logical-to-physical map, the reverse map and
+   * the erase counts.
+   */
+
+  dev->map = (FAR uint32_t *)
+    kmm_malloc((dev->nlogical + 2 * dev->nphys) * sizeof(uint32_t));
+  seqs     = (FAR uint32_t *)kmm_malloc(dev->nlogical * sizeof(uint32_t));
+  if (dev->map == NULL || seqs == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  dev->rmap     = dev->map + dev->nlogical;
+  dev->erasecnt = dev->rmap + dev->nphys;
+
+  ret = ftl_alloc_eblock(dev);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  for (i = 0; i < dev->nlogical; i++)
+    {
+      dev->map[i] = FTL_UNMAPPED;
+    }
+
+  for (i = 0; i < dev->nphys; i++)
+    {
+      uint32_t l;
+
+      dev->rmap[i]     = FTL_FREE;
+      dev->erasecnt[i] = 0;
+
+      nxfrd = MTD_BREAD(dev->mtd, (off_t)i * dev->blkper, 1, dev->eblock);
+      if (nxfrd != 1)
+        {
+          ferr("ERROR: Read header of erase block %lu failed: %zd\n",
+               (unsigned long)i, nxfrd);
+          dev->rmap[i] = FTL_BAD;
+          continue;
+        }
+
+      memcpy(&hdr, dev->eblock, sizeof(hdr));
+      if (hdr.magic != FTL_MAGIC || hdr.crc != ftl_log_hdrcrc(&hdr))
+        {
+          continue;
+        }
+
+      dev->erasecnt[i] = hdr.erasecnt;
+      if ((int32_t)(hdr.seq - dev->seq) > 0)
+        {
+          dev->seq = hdr.seq;
+        }
+
+      l = hdr.lblock;
+      if (l >= dev->nlogical)
+        {
+          continue;
+        }
+
+      if (dev->map[l] != FTL_UNMAPPED)
+        {
+          if ((int32_t)(hdr.seq - seqs[l]) < 0)
+            {
+              continue;
+            }
+
+          dev->rmap[dev->map[l]] = FTL_FREE;
+        }
+
+      dev->map[l]  = i;
+      dev->rmap[i] = l;
+      seqs[l]      = hdr.seq;
+    }
+
+  kmm_free(seqs);
+  return OK;
+
+errout:
+  if (seqs != NULL)
+    {
+      kmm_free(seqs);
+    }
+
+  if (dev->map != NULL)
+    {
+      kmm_free(dev->map);
+      dev->map = NULL;
+    }
+
+  return ret;
+}
+#endif /* CONFIG_FTL_LOGSTRUCT */
+
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                          off_t startblock, size_t nblocks)
 {
@@ -252,6 +779,10 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   int    nbytes;
   int    ret;
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+  return ftl_log_flush(dev, buffer, startblock, nblocks);
+#endif
+
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -468,7 +999,11 @@ static int ftl_geometry(FAR struct inode *inode,
       geometry->geo_available     = true;
       geometry->geo_mediachanged  = false;
       geometry->geo_writeenabled  = true;
+#ifdef CONFIG_FTL_LOGSTRUCT
+      geometry->geo_nsectors      = dev->nlogical * dev->lblkper;
+#else
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       finfo("available: true mediachanged: false writeenabled: %s\n",
@@ -570,6 +1105,10 @@ static int ftl_unlink(FAR struct inode *inode)
           kmm_free(dev->eblock);
         }
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+      kmm_free(dev->map);
+#endif
+
       kmm_free(dev);
     }
 
@@ -635,28 +1174,62 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_LOGSTRUCT
+      /* Rebuild the logical to physical map from FLASH */
+
+      ret = ftl_log_initialize(dev);
+      if (ret < 0)
+        {
+          ferr("ERROR: ftl_log_initialize failed: %d\n", ret);
+          kmm_free(dev->eblock);
+          kmm_free(dev);
+          return ret;
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize     = dev->geo.blocksize;
+#ifdef CONFIG_FTL_LOGSTRUCT
+      dev->rwb.nblocks       = dev->nlogical * dev->lblkper;
+#else
       dev->rwb.nblocks       = dev->geo.neraseblocks * dev->blkper;
+#endif
       dev->rwb.dev           = (FAR void *)dev;
       dev->rwb.wrflush       = ftl_flush;
       dev->rwb.rhreload      = ftl_reload;
 
 #if defined(CONFIG_FTL_WRITEBUFFER)
+#ifdef CONFIG_FTL_LOGSTRUCT
+      /* Buffer whole logical erase blocks so that a burst of small writes
+       * costs a single out-of-place erase block write.
+       */
+
+      dev->rwb.wrmaxblocks   = dev->lblkper * CONFIG_FTL_WRITEBUFFER_NERASE;
+      dev->rwb.wralignblocks = dev->lblkper;
+#else
       dev->rwb.wrmaxblocks   = dev->blkper;
       dev->rwb.wralignblocks = dev->blkper;
 #endif
+#endif
 
 #ifdef CONFIG_FTL_READAHEAD
+#ifdef CONFIG_FTL_LOGSTRUCT
+      dev->rwb.rhmaxblocks   = dev->lblkper;
+#else
       dev->rwb.rhmaxblocks   = dev->blkper;
+#endif
 #endif
 
       ret = rwb_initialize(&dev->rwb);
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_LOGSTRUCT
+          kmm_free(dev->eblock);
+          kmm_free(dev->map);
+#endif
           kmm_free(dev);
           return ret;
         }
@@ -670,6 +1243,10 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_LOGSTRUCT
+          kmm_free(dev->eblock);
+          kmm_free(dev->map);
 #endif
           kmm_free(dev);
         }
@@ -35,6 +35,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -76,6 +77,8 @@
 #define GD25_RDMFID                 0x90    /* Read Manufacturer / Device */
 #define GD25_JEDEC_ID               0x9f    /* JEDEC ID read              */
 #define GD25_4BEN                   0xb7    /* Enable 4-byte Mode         */
+#define GD25_PES                    0x75    /* Program/erase suspend      */
+#define GD25_PER                    0x7a    /* Program/erase resume       */
 
 /***************************************************************************
  * GD25 Registers
@@ -140,6 +143,10 @@ struct gd25_dev_s
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to GD25 device */
   bool                  addr_4byte;  /* True: Use Four-byte address */
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  off_t                 erasesect;   /* Sector of the last sector erase */
+  clock_t               resumed;     /* Time of the last erase resume */
+#endif
 };
 
 /***************************************************************************
@@ -165,6 +172,11 @@ static void gd25_sectorerase(FAR struct gd25_dev_s *priv, off_t offset);
 static inline int gd25_chiperase(FAR struct gd25_dev_s *priv);
 static void gd25_byteread(FAR struct gd25_dev_s *priv, FAR uint8_t *buffer,
     off_t address, size_t nbytes);
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+static bool gd25_erasesuspend(FAR struct gd25_dev_s *priv, off_t address,
+    size_t nbytes);
+static void gd25_eraseresume(FAR struct gd25_dev_s *priv);
+#endif
 #ifndef CONFIG_GD25_READONLY
 static void gd25_pagewrite(FAR struct gd25_dev_s *priv,
     FAR const uint8_t *buffer, off_t address, size_t nbytes);
@@ -531,6 +543,9 @@ static void gd25_sectorerase(FAR struct gd25_dev_s *priv, off_t sector)
 
   SPI_SEND(priv->spi, GD25_SE);
   priv->prev_instr = GD25_SE;
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  priv->erasesect  = sector;
+#endif
 
   /* Send the sector address high byte first.  Only the most significant
    * bits (those corresponding to the sector) have any meaning.
@@ -580,15 +595,29 @@ static inline int gd25_chiperase(FAR struct gd25_dev_s *priv)
 static void gd25_byteread(FAR struct gd25_dev_s *priv, FAR uint8_t *buffer,
                           off_t address, size_t nbytes)
 {
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  bool suspended;
+#endif
+
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  /* Suspend a sector erase in progress rather than wait for it, unless
+   * the read touches that sector.
+   */
 
-  gd25_waitwritecomplete(priv);
+  suspended = gd25_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  /* Make sure that writing is disabled */
+      gd25_waitwritecomplete(priv);
+
+      /* Make sure that writing is disabled */
 
-  gd25_wrdi(priv);
+      gd25_wrdi(priv);
+    }
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
 
@@ -624,8 +653,76 @@ static void gd25_byteread(FAR struct gd25_dev_s *priv, FAR uint8_t *buffer,
   SPI_RECVBLOCK(priv->spi, buffer, nbytes);
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+  if (suspended)
+    {
+      gd25_eraseresume(priv);
+    }
+#endif
+}
+
+/***************************************************************************
+ * Name: gd25_erasesuspend
+ *
+ * Description:
+ *   Suspend a sector erase in progress so that a different sector can be
+ *   read.  The SPI bus stays locked until gd25_eraseresume(), so the
+ *   erasing thread never observes the suspended state.  Returns true if
+ *   the erase was suspended.
+ *
+ ***************************************************************************/
+
+#ifdef CONFIG_GD25_ERASE_SUSPEND
+static bool gd25_erasesuspend(FAR struct gd25_dev_s *priv, off_t address,
+                              size_t nbytes)
+{
+  if (priv->prev_instr != GD25_SE || nbytes == 0 ||
+      (priv->erasesect >= (address >> GD25_SECTOR_SHIFT) &&
+       priv->erasesect <= ((address + nbytes - 1) >> GD25_SECTOR_SHIFT)))
+    {
+      return false;
+    }
+
+  /* Give the erase at least one full tick after a resume so that a steady
+   * stream of reads cannot keep it from completing.
+   */
+
+  if (clock_systime_ticks() - priv->resumed < 2 ||
+      (gd25_rdsr(priv, 0) & GD25_SR_WIP) == 0)
+    {
+      return false;
+    }
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
+  SPI_SEND(priv->spi, GD25_PES);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+  /* The suspend completes within tSUS (tens of microseconds) */
+
+  while ((gd25_rdsr(priv, 0) & GD25_SR_WIP) != 0)
+    {
+    }
+
+  finfo("Suspended erase of sector %ld\n", (long)priv->erasesect);
+  return true;
 }
 
+/***************************************************************************
+ * Name: gd25_eraseresume
+ ***************************************************************************/
+
+static void gd25_eraseresume(FAR struct gd25_dev_s *priv)
+{
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
+  SPI_SEND(priv->spi, GD25_PER);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+  priv->prev_instr = GD25_SE;
+  priv->resumed    = clock_systime_ticks();
+}
+#endif
+
 /***************************************************************************
  * Name:  gd25_pagewrite
  ***************************************************************************/
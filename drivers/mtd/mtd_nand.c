@@ -106,6 +106,12 @@ static int      nand_readpage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR uint8_t *data);
 static int      nand_writepage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR const void *data);
+static int      nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, unsigned int npages,
+                  FAR uint8_t *data);
+static int      nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, unsigned int npages,
+                  FAR const uint8_t *data);
 
 /* MTD driver methods */
 
@@ -533,6 +539,109 @@ static int nand_writepage(FAR struct nand_dev_s *nand, off_t block,
     }
 }
 
+/****************************************************************************
+ * Name: nand_readpages
+ *
+ * Description:
+ *   Reads the data areas of up to 'npages' consecutive pages of one block.
+ *   If the lower half provides a multi-page read (using the read cache or
+ *   multi-plane commands) and handles the ECC itself, all pages are read
+ *   with one call and the block is checked only once.  Otherwise a single
+ *   page is read.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - The maximum number of pages to read (within the block)
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   The number of pages read is returned in success; a negated errno
+ *   value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                          unsigned int page, unsigned int npages,
+                          FAR uint8_t *data)
+{
+  int ret;
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  FAR struct nand_raw_s *raw = nand->raw;
+
+  if (npages > 1 && raw->readpages != NULL &&
+      raw->ecctype != NANDECC_SWECC)
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      ret = NAND_READPAGES(raw, block, page, npages, data);
+      return ret < 0 ? ret : (int)npages;
+    }
+#endif
+
+  ret = nand_readpage(nand, block, page, data);
+  return ret < 0 ? ret : 1;
+}
+
+/****************************************************************************
+ * Name: nand_writepages
+ *
+ * Description:
+ *   Writes the data areas of up to 'npages' consecutive pages of one block
+ *   with one multi-page write (page cache program or multi-plane program)
+ *   if the lower half supports it and handles the ECC itself.  Otherwise a
+ *   single page is written.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - The maximum number of pages to write (within the block)
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   The number of pages written is returned in success; a negated errno
+ *   value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                           unsigned int page, unsigned int npages,
+                           FAR const uint8_t *data)
+{
+  int ret;
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  FAR struct nand_raw_s *raw = nand->raw;
+
+  if (npages > 1 && raw->writepages != NULL &&
+      raw->ecctype != NANDECC_SWECC)
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      ret = NAND_WRITEPAGES(raw, block, page, npages, data);
+      return ret < 0 ? ret : (int)npages;
+    }
+#endif
+
+  ret = nand_writepage(nand, block, page, data);
+  return ret < 0 ? ret : 1;
+}
+
 /****************************************************************************
  * Name: nand_erase
  *
@@ -589,6 +698,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -622,7 +732,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then read every page from NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= ret)
     {
       /* Check for attempt to read beyond the end of NAND */
 
@@ -635,12 +745,18 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Read the next page from NAND */
+      /* Read the next pages of this block from NAND */
+
+      count = pagesperblock - page;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
 
-      ret = nand_readpage(nand, block, page, buffer);
+      ret = nand_readpages(nand, block, page, count, buffer);
       if (ret < 0)
         {
-          ferr("ERROR: nand_readpage failed block=%ld page=%d: %d\n",
+          ferr("ERROR: nand_readpages failed block=%ld page=%d: %d\n",
                (long)block, page, ret);
           goto errout_with_lock;
         }
@@ -650,15 +766,16 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += ret;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages transferred */
 
-      buffer += pagesize;
+      buffer += (size_t)ret * pagesize;
     }
 
   nand_unlock(nand);
@@ -685,6 +802,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -718,7 +836,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then write every page into NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= ret)
     {
       /* Check for attempt to write beyond the end of NAND */
 
@@ -731,12 +849,18 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Write the next page into NAND */
+      /* Write the next pages of this block into NAND */
 
-      ret = nand_writepage(nand, block, page, buffer);
+      count = pagesperblock - page;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      ret = nand_writepages(nand, block, page, count, buffer);
       if (ret < 0)
         {
-          ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
+          ferr("ERROR: nand_writepages failed block=%ld page=%d: %d\n",
                (long)block, page, ret);
           goto errout_with_lock;
         }
@@ -746,15 +870,16 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += ret;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages transferred */
 
-      buffer += pagesize;
+      buffer += (size_t)ret * pagesize;
     }
 
   nand_unlock(nand);
@@ -899,6 +1024,29 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
       model->pagesize  = onfi.pagesize;
       model->sparesize = onfi.sparesize;
 
+      /* Optional cache and multi-plane commands */
+
+      if ((onfi.optcmds & ONFI_OPTCMD_CACHEREAD) != 0)
+        {
+          model->options |= NANDMODEL_CACHEREAD;
+        }
+
+      if ((onfi.optcmds & ONFI_OPTCMD_CACHEPROGRAM) != 0)
+        {
+          model->options |= NANDMODEL_CACHEPROGRAM;
+        }
+
+      if ((onfi.optcmds & ONFI_OPTCMD_COPYBACK) != 0)
+        {
+          model->options |= NANDMODEL_COPYBACK;
+        }
+
+      if (onfi.planebits > 0)
+        {
+          model->options  |= NANDMODEL_MULTIPLANE;
+          model->planebits = onfi.planebits;
+        }
+
       size             = (uint64_t)onfi.pagesperblock *
                          (uint64_t)onfi.blocksperlun *
                          (uint64_t)onfi.pagesize;
@@ -933,8 +1081,29 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
 
       /* Disable any internal, embedded ECC function */
 
-      onfi_embeddedecc(&onfi, cmdaddr, addraddr, dataaddr, false);
+      onfi_embeddedecc(&onfi, raw->cmdaddr, raw->addraddr, raw->dataaddr,
+                       false);
+    }
+
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+  /* The ECC of every step of a page must fit in the spare area scheme */
+
+  if (raw->eccengine != NULL)
+    {
+      FAR const struct nand_eccengine_s *engine = raw->eccengine;
+      FAR const struct nand_scheme_s *scheme =
+        nandmodel_getscheme(&raw->model);
+      unsigned int pagesize = nandmodel_getpagesize(&raw->model);
+
+      if (engine->stepsize == 0 || (pagesize % engine->stepsize) != 0 ||
+          (pagesize / engine->stepsize) * engine->eccbytes >
+          scheme->eccsize)
+        {
+          ferr("ERROR: ECC engine does not fit the spare scheme\n");
+          return NULL;
+        }
     }
+#endif
 
   /* Allocate an NAND MTD device structure */
 
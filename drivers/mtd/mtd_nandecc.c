@@ -62,6 +62,90 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandecc_engine_verify
+ *
+ * Description:
+ *   Check and correct every ECC step of a page with the controller ECC
+ *   engine.  An erased page (all ECC bytes 0xff) is accepted as is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+static int nandecc_engine_verify(FAR struct nand_raw_s *raw,
+                                 FAR uint8_t *data, unsigned int pagesize)
+{
+  FAR const struct nand_eccengine_s *engine = raw->eccengine;
+  unsigned int nsteps = pagesize / engine->stepsize;
+  unsigned int neccbytes = nsteps * engine->eccbytes;
+  unsigned int i;
+  int ret;
+
+  for (i = 0; i < neccbytes; i++)
+    {
+      if (raw->ecc[i] != 0xff)
+        {
+          break;
+        }
+    }
+
+  if (i == neccbytes)
+    {
+      return OK;
+    }
+
+  for (i = 0; i < nsteps; i++)
+    {
+      ret = engine->correct(raw, data + i * engine->stepsize,
+                            raw->ecc + i * engine->eccbytes);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret > 0)
+        {
+          finfo("Step %u: corrected %d bit errors\n", i, ret);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nandecc_engine_compute
+ *
+ * Description:
+ *   Compute the ECC of every step of a page with the controller ECC engine.
+ *
+ ****************************************************************************/
+
+static int nandecc_engine_compute(FAR struct nand_raw_s *raw,
+                                  FAR const uint8_t *data,
+                                  unsigned int pagesize)
+{
+  FAR const struct nand_eccengine_s *engine = raw->eccengine;
+  unsigned int nsteps = pagesize / engine->stepsize;
+  unsigned int i;
+  int ret;
+
+  for (i = 0; i < nsteps; i++)
+    {
+      ret = engine->calculate(raw, data + i * engine->stepsize,
+                              raw->ecc + i * engine->eccbytes);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -120,18 +204,9 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
       memset(spare, 0xff, sparesize);
     }
 
-  /* Start by reading the spare data */
+  /* Read the data and the spare area with a single page read */
 
-  ret = NAND_RAWREAD(raw, block, page, 0, spare);
-  if (ret < 0)
-    {
-      ferr("ERROR: Failed to read page:d\n", ret);
-      return ret;
-    }
-
-  /* Then reading the data */
-
-  ret = NAND_RAWREAD(nand->raw, block, page, data, 0);
+  ret = NAND_RAWREAD(raw, block, page, data, spare);
   if (ret < 0)
     {
       ferr("ERROR: Failed to read page:d\n", ret);
@@ -143,6 +218,23 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
   scheme = nandmodel_getscheme(model);
   nandscheme_readecc(scheme, spare, raw->ecc);
 
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+  /* Let the controller ECC engine verify and correct the page */
+
+  if (raw->eccengine != NULL)
+    {
+      ret = nandecc_engine_verify(raw, data, pagesize);
+      if (ret < 0)
+        {
+          ferr("ERROR: Block=%d page=%d Unrecoverable error: %d\n",
+               block, page, ret);
+          return -EIO;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Use the ECC data to verify the page */
 
   ret = hamming_verify256x(data, pagesize, raw->ecc);
@@ -210,9 +302,25 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 
   if (data)
     {
-      /* Compute hamming code on data */
-
-      hamming_compute256x(data, pagesize, raw->ecc);
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+      if (raw->eccengine != NULL)
+        {
+          /* Compute the ECC with the controller ECC engine */
+
+          ret = nandecc_engine_compute(raw, data, pagesize);
+          if (ret < 0)
+            {
+              ferr("ERROR: ECC engine failed: %d\n", ret);
+              return ret;
+            }
+        }
+      else
+#endif
+        {
+          /* Compute hamming code on data */
+
+          hamming_compute256x(data, pagesize, raw->ecc);
+        }
     }
 
   /* Store code in spare buffer, either the buffer provided by the caller or
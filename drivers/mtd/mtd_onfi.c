@@ -328,6 +328,11 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->buswidth = (*(FAR uint8_t *)(parmtab + 6)) & 0x01;
 
+  /* Features and optional commands supported (bytes 6-7 and 8-9) */
+
+  onfi->features = (uint16_t)parmtab[6] | ((uint16_t)parmtab[7] << 8);
+  onfi->optcmds  = (uint16_t)parmtab[8] | ((uint16_t)parmtab[9] << 8);
+
   /* Get number of data bytes per page (bytes 80-83 in the param table) */
 
   onfi->pagesize =  *(FAR uint32_t *)(FAR void *)(parmtab + 80);
@@ -356,6 +361,14 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->model = *(FAR uint8_t *)(parmtab + 49);
 
+  /* Number of plane address bits (byte 114, bits 0-3) */
+
+  onfi->planebits = parmtab[114] & 0x0f;
+  if ((onfi->features & ONFI_FEATURE_MULTIPLANE) == 0)
+    {
+      onfi->planebits = 0;
+    }
+
   finfo("Returning:\n");
   finfo("  manufacturer:  0x%02x\n", onfi->manufacturer);
   finfo("  buswidth:      %d\n",     onfi->buswidth);
@@ -366,6 +379,9 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
   finfo("  pagesperblock: %d\n",     onfi->pagesperblock);
   finfo("  blocksperlun:  %d\n",     onfi->blocksperlun);
   finfo("  pagesize:      %d\n",     onfi->pagesize);
+  finfo("  features:      0x%04x\n", onfi->features);
+  finfo("  optcmds:       0x%04x\n", onfi->optcmds);
+  finfo("  planebits:     %d\n",     onfi->planebits);
   return OK;
 }
 
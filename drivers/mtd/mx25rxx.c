@@ -45,12 +45,13 @@
 #include <debug.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #ifdef CONFIG_MX25RXX_SECTOR512
 #  include <stdlib.h>
-#  include <string.h>
 #endif
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/signal.h>
@@ -191,6 +192,11 @@ struct mx25rxx_dev_s
   uint16_t               esectno;     /* Erase sector number in the cache */
   FAR uint8_t           *sector;      /* Allocated sector data */
 #endif
+
+#ifdef CONFIG_MX25RXX_MMAP
+  FAR uint8_t           *mmapbase;    /* Memory-mapped window or NULL */
+  bool                   mapped;      /* True: in memory-mapped mode */
+#endif
 };
 
 /******************************************************************************
@@ -238,6 +244,17 @@ static int mx25rxx_erase_block(struct mx25rxx_dev_s *priv, off_t block);
 #endif
 static int mx25rxx_erase_chip(struct mx25rxx_dev_s *priv);
 
+#ifdef CONFIG_MX25RXX_MMAP
+static void mx25rxx_mmap_enter(FAR struct mx25rxx_dev_s *priv);
+static void mx25rxx_mmap_exit(FAR struct mx25rxx_dev_s *priv);
+static void mx25rxx_mmap_modified(FAR struct mx25rxx_dev_s *priv,
+                                  off_t address, size_t nbytes);
+#else
+#  define mx25rxx_mmap_enter(p)
+#  define mx25rxx_mmap_exit(p)
+#  define mx25rxx_mmap_modified(p,a,n)
+#endif
+
 #ifdef CONFIG_MX25RXX_SECTOR512
 static int  mx25rxx_flush_cache(struct mx25rxx_dev_s *priv);
 static FAR uint8_t *mx25rxx_read_cache(struct mx25rxx_dev_s *priv, off_t sector);
@@ -356,6 +373,14 @@ int mx25rxx_read_byte(FAR struct mx25rxx_dev_s *dev, FAR uint8_t *buffer,
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)buflen);
 
+#ifdef CONFIG_MX25RXX_MMAP
+  if (dev->mapped)
+    {
+      memcpy(buffer, dev->mmapbase + address, buflen);
+      return OK;
+    }
+#endif
+
   meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
   meminfo.addrlen = 3;
 
@@ -370,6 +395,66 @@ int mx25rxx_read_byte(FAR struct mx25rxx_dev_s *dev, FAR uint8_t *buffer,
   return QSPI_MEMORY(dev->qspi, &meminfo);
 }
 
+#ifdef CONFIG_MX25RXX_MMAP
+/* Put the controller into memory-mapped mode with the 4READ command used by
+ * mx25rxx_read_byte().  The bus must be locked.
+ */
+
+static void mx25rxx_mmap_enter(FAR struct mx25rxx_dev_s *priv)
+{
+  struct qspi_meminfo_s meminfo;
+  FAR void *base;
+
+  if (priv->mapped)
+    {
+      return;
+    }
+
+  memset(&meminfo, 0, sizeof(meminfo));
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = 3;
+  meminfo.dummies = 6;
+  meminfo.cmd     = MX25R_4READ;
+
+  /* The mapped window is read at the read command frequency */
+
+  QSPI_SETFREQUENCY(priv->qspi, CONFIG_MX25RXX_QSPI_READ_FREQUENCY);
+
+  base = QSPI_MMAP(priv->qspi, &meminfo);
+  if (base != NULL)
+    {
+      priv->mmapbase = (FAR uint8_t *)base;
+      priv->mapped   = true;
+    }
+}
+
+/* Leave memory-mapped mode before issuing commands */
+
+static void mx25rxx_mmap_exit(FAR struct mx25rxx_dev_s *priv)
+{
+  if (priv->mapped)
+    {
+      QSPI_MUNMAP(priv->qspi);
+      priv->mapped = false;
+    }
+}
+
+/* The FLASH content in [address, address + nbytes) was programmed or erased:
+ * discard stale cache lines and map the FLASH again.
+ */
+
+static void mx25rxx_mmap_modified(FAR struct mx25rxx_dev_s *priv,
+                                  off_t address, size_t nbytes)
+{
+  if (priv->mmapbase != NULL)
+    {
+      up_invalidate_dcache((uintptr_t)priv->mmapbase + address,
+                           (uintptr_t)priv->mmapbase + address + nbytes);
+      mx25rxx_mmap_enter(priv);
+    }
+}
+#endif
+
 int mx25rxx_write_page(struct mx25rxx_dev_s *priv, FAR const uint8_t *buffer,
                        off_t address, size_t buflen)
 {
@@ -556,6 +641,9 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
 {
   FAR struct mx25rxx_dev_s *priv = (FAR struct mx25rxx_dev_s *)dev;
   size_t blocksleft = nblocks;
+#ifdef CONFIG_MX25RXX_MMAP
+  off_t firstblock = startblock;
+#endif
 #ifdef CONFIG_MX25RXX_SECTOR512
   int ret;
 #endif
@@ -565,6 +653,7 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
   /* Lock access to the SPI bus until we complete the erase */
 
   mx25rxx_lock(priv->qspi, false);
+  mx25rxx_mmap_exit(priv);
 
   while (blocksleft-- > 0)
     {
@@ -618,6 +707,13 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
     }
 #endif
 
+#if defined(CONFIG_MX25RXX_MMAP) && defined(CONFIG_MX25RXX_SECTOR512)
+  mx25rxx_mmap_modified(priv, firstblock << MX25RXX_SECTOR512_SHIFT,
+                        (startblock - firstblock) << MX25RXX_SECTOR512_SHIFT);
+#elif defined(CONFIG_MX25RXX_MMAP)
+  mx25rxx_mmap_modified(priv, firstblock << priv->sectorshift,
+                        (startblock - firstblock) << priv->sectorshift);
+#endif
   mx25rxx_unlock(priv->qspi);
 
   return (int)nblocks;
@@ -665,6 +761,7 @@ ssize_t mx25rxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
   mx25rxx_lock(priv->qspi, false);
+  mx25rxx_mmap_exit(priv);
 
 #if defined(CONFIG_MX25RXX_SECTOR512)
   ret = mx25rxx_write_cache(priv, buf, startblock, nblocks);
@@ -682,6 +779,13 @@ ssize_t mx25rxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
+#if defined(CONFIG_MX25RXX_SECTOR512)
+  mx25rxx_mmap_modified(priv, startblock << MX25RXX_SECTOR512_SHIFT,
+                        nblocks << MX25RXX_SECTOR512_SHIFT);
+#else
+  mx25rxx_mmap_modified(priv, startblock << priv->pageshift,
+                        nblocks << priv->pageshift);
+#endif
   mx25rxx_unlock(priv->qspi);
 
   return ret < 0 ? ret : nblocks;
@@ -698,6 +802,7 @@ ssize_t mx25rxx_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
   /* Lock the QuadSPI bus and select this FLASH part */
 
   mx25rxx_lock(priv->qspi, true);
+  mx25rxx_mmap_enter(priv);
   ret = mx25rxx_read_byte(priv, buffer, offset, nbytes);
   mx25rxx_unlock(priv->qspi);
 
@@ -759,10 +864,37 @@ int mx25rxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
           /* Erase the entire device */
 
           mx25rxx_lock(priv->qspi, false);
+          mx25rxx_mmap_exit(priv);
           ret = mx25rxx_erase_chip(priv);
+          mx25rxx_mmap_modified(priv, 0,
+                                (size_t)priv->nsectors << priv->sectorshift);
+          mx25rxx_unlock(priv->qspi);
+        }
+        break;
+
+#ifdef CONFIG_MX25RXX_MMAP
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+
+          mx25rxx_lock(priv->qspi, true);
+          mx25rxx_mmap_enter(priv);
+          if (priv->mapped)
+            {
+              *ppv = priv->mmapbase;
+              ret  = OK;
+            }
+          else
+            {
+              ret  = -ENOTTY;
+            }
+
           mx25rxx_unlock(priv->qspi);
         }
         break;
+#endif
 
       default:
         ret = -ENOTTY; /* Bad/unsupported command */
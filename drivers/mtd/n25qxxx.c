@@ -51,6 +51,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -282,6 +283,11 @@ struct n25qxxx_dev_s
   uint16_t               esectno;     /* Erase sector number in the cache */
   FAR uint8_t           *sector;      /* Allocated sector data */
 #endif
+
+#ifdef CONFIG_N25QXXX_MMAP
+  FAR uint8_t           *mmapbase;    /* Memory-mapped window or NULL */
+  bool                   mapped;      /* True: in memory-mapped mode */
+#endif
 };
 
 /************************************************************************************
@@ -322,6 +328,16 @@ static int  n25qxxx_read_byte(FAR struct n25qxxx_dev_s *priv, FAR uint8_t *buffe
               off_t address, size_t nbytes);
 static int  n25qxxx_write_page(FAR struct n25qxxx_dev_s *priv,
               FAR const uint8_t *buffer, off_t address, size_t nbytes);
+#ifdef CONFIG_N25QXXX_MMAP
+static void n25qxxx_mmap_enter(FAR struct n25qxxx_dev_s *priv);
+static void n25qxxx_mmap_exit(FAR struct n25qxxx_dev_s *priv);
+static void n25qxxx_mmap_modified(FAR struct n25qxxx_dev_s *priv,
+                                    off_t address, size_t nbytes);
+#else
+#  define n25qxxx_mmap_enter(p)
+#  define n25qxxx_mmap_exit(p)
+#  define n25qxxx_mmap_modified(p,a,n)
+#endif
 #ifdef CONFIG_N25QXXX_SECTOR512
 static int  n25qxxx_flush_cache(struct n25qxxx_dev_s *priv);
 static FAR uint8_t *n25qxxx_read_cache(struct n25qxxx_dev_s *priv, off_t sector);
@@ -874,6 +890,14 @@ static int n25qxxx_read_byte(FAR struct n25qxxx_dev_s *priv, FAR uint8_t *buffer
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)buflen);
 
+#ifdef CONFIG_N25QXXX_MMAP
+  if (priv->mapped)
+    {
+      memcpy(buffer, priv->mmapbase + address, buflen);
+      return OK;
+    }
+#endif
+
   meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
   meminfo.addrlen = 3;
   meminfo.dummies = CONFIG_N25QXXX_DUMMIES;
@@ -885,6 +909,82 @@ static int n25qxxx_read_byte(FAR struct n25qxxx_dev_s *priv, FAR uint8_t *buffer
   return QSPI_MEMORY(priv->qspi, &meminfo);
 }
 
+/************************************************************************************
+ * Name: n25qxxx_mmap_enter
+ *
+ * Description:
+ *   Put the QuadSPI controller into memory-mapped mode using the same quad
+ *   I/O fast read command as n25qxxx_read_byte().  The bus must be
+ *   locked.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_N25QXXX_MMAP
+static void n25qxxx_mmap_enter(FAR struct n25qxxx_dev_s *priv)
+{
+  struct qspi_meminfo_s meminfo;
+  FAR void *base;
+
+  if (priv->mapped)
+    {
+      return;
+    }
+
+  memset(&meminfo, 0, sizeof(meminfo));
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = 3;
+  meminfo.dummies = CONFIG_N25QXXX_DUMMIES;
+  meminfo.cmd     = N25QXXX_FAST_READ_QUADIO;
+
+  base = QSPI_MMAP(priv->qspi, &meminfo);
+  if (base != NULL)
+    {
+      priv->mmapbase = (FAR uint8_t *)base;
+      priv->mapped   = true;
+    }
+}
+
+/************************************************************************************
+ * Name: n25qxxx_mmap_exit
+ *
+ * Description:
+ *   Leave memory-mapped mode before issuing commands.  The bus must be
+ *   locked.
+ *
+ ************************************************************************************/
+
+static void n25qxxx_mmap_exit(FAR struct n25qxxx_dev_s *priv)
+{
+  if (priv->mapped)
+    {
+      QSPI_MUNMAP(priv->qspi);
+      priv->mapped = false;
+    }
+}
+
+/************************************************************************************
+ * Name: n25qxxx_mmap_modified
+ *
+ * Description:
+ *   Called after the FLASH content in [address, address + nbytes) was
+ *   programmed or erased.  Discard any stale copy of that range in the data
+ *   cache and map the FLASH again so that an XIP address handed out earlier
+ *   stays valid.
+ *
+ ************************************************************************************/
+
+static void n25qxxx_mmap_modified(FAR struct n25qxxx_dev_s *priv,
+                                    off_t address, size_t nbytes)
+{
+  if (priv->mmapbase != NULL)
+    {
+      up_invalidate_dcache((uintptr_t)priv->mmapbase + address,
+                           (uintptr_t)priv->mmapbase + address + nbytes);
+      n25qxxx_mmap_enter(priv);
+    }
+}
+#endif
+
 /************************************************************************************
  * Name:  n25qxxx_write_page
  ************************************************************************************/
@@ -1157,6 +1257,9 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
 {
   FAR struct n25qxxx_dev_s *priv = (FAR struct n25qxxx_dev_s *)dev;
   size_t blocksleft = nblocks;
+#ifdef CONFIG_N25QXXX_MMAP
+  off_t firstblock = startblock;
+#endif
 #ifdef CONFIG_N25QXXX_SECTOR512
   int ret;
 #endif
@@ -1166,6 +1269,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
   /* Lock access to the SPI bus until we complete the erase */
 
   n25qxxx_lock(priv->qspi);
+  n25qxxx_mmap_exit(priv);
 
   while (blocksleft-- > 0)
     {
@@ -1189,6 +1293,14 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
     }
 #endif
 
+#if defined(CONFIG_N25QXXX_MMAP) && defined(CONFIG_N25QXXX_SECTOR512)
+  n25qxxx_mmap_modified(priv, firstblock << N25QXXX_SECTOR512_SHIFT,
+                          (startblock - firstblock) <<
+                          N25QXXX_SECTOR512_SHIFT);
+#elif defined(CONFIG_N25QXXX_MMAP)
+  n25qxxx_mmap_modified(priv, firstblock << priv->sectorshift,
+                          (startblock - firstblock) << priv->sectorshift);
+#endif
   n25qxxx_unlock(priv->qspi);
 
   return (int)nblocks;
@@ -1244,6 +1356,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
   n25qxxx_lock(priv->qspi);
+  n25qxxx_mmap_exit(priv);
 
 #if defined(CONFIG_N25QXXX_SECTOR512)
   ret = n25qxxx_write_cache(priv, buffer, startblock, nblocks);
@@ -1261,6 +1374,13 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
+#if defined(CONFIG_N25QXXX_SECTOR512)
+  n25qxxx_mmap_modified(priv, startblock << N25QXXX_SECTOR512_SHIFT,
+                          nblocks << N25QXXX_SECTOR512_SHIFT);
+#else
+  n25qxxx_mmap_modified(priv, startblock << priv->pageshift,
+                          nblocks << priv->pageshift);
+#endif
   n25qxxx_unlock(priv->qspi);
 
   return ret < 0 ? ret : nblocks;
@@ -1281,6 +1401,7 @@ static ssize_t n25qxxx_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbyt
   /* Lock the QuadSPI bus and select this FLASH part */
 
   n25qxxx_lock(priv->qspi);
+  n25qxxx_mmap_enter(priv);
   ret = n25qxxx_read_byte(priv, buffer, offset, nbytes);
   n25qxxx_unlock(priv->qspi);
 
@@ -1345,7 +1466,10 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
           /* Erase the entire device */
 
           n25qxxx_lock(priv->qspi);
+          n25qxxx_mmap_exit(priv);
           ret = n25qxxx_erase_chip(priv);
+          n25qxxx_mmap_modified(priv, 0, (size_t)priv->nsectors <<
+                                         priv->sectorshift);
           n25qxxx_unlock(priv->qspi);
         }
         break;
@@ -1356,7 +1480,15 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+#ifdef CONFIG_N25QXXX_MMAP
+          n25qxxx_lock(priv->qspi);
+          n25qxxx_mmap_exit(priv);
+#endif
           ret = n25qxxx_protect(priv, prot->startblock, prot->nblocks);
+#ifdef CONFIG_N25QXXX_MMAP
+          n25qxxx_mmap_enter(priv);
+          n25qxxx_unlock(priv->qspi);
+#endif
         }
         break;
 
@@ -1366,9 +1498,41 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+#ifdef CONFIG_N25QXXX_MMAP
+          n25qxxx_lock(priv->qspi);
+          n25qxxx_mmap_exit(priv);
+#endif
           ret = n25qxxx_unprotect(priv, prot->startblock, prot->nblocks);
+#ifdef CONFIG_N25QXXX_MMAP
+          n25qxxx_mmap_enter(priv);
+          n25qxxx_unlock(priv->qspi);
+#endif
+        }
+        break;
+
+#ifdef CONFIG_N25QXXX_MMAP
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+
+          n25qxxx_lock(priv->qspi);
+          n25qxxx_mmap_enter(priv);
+          if (priv->mapped)
+            {
+              *ppv = priv->mmapbase;
+              ret  = OK;
+            }
+          else
+            {
+              ret  = -ENOTTY;
+            }
+
+          n25qxxx_unlock(priv->qspi);
         }
         break;
+#endif
 
       default:
         ret = -ENOTTY; /* Bad/unsupported command */
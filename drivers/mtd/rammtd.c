@@ -46,6 +46,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -67,6 +68,14 @@
 #  define CONFIG_RAMMTD_ERASESTATE 0xff
 #endif
 
+#ifndef CONFIG_RAMMTD_ERASE_DELAY
+#  define CONFIG_RAMMTD_ERASE_DELAY 0
+#endif
+
+#ifndef CONFIG_RAMMTD_PROGRAM_DELAY
+#  define CONFIG_RAMMTD_PROGRAM_DELAY 0
+#endif
+
 #if CONFIG_RAMMTD_ERASESTATE != 0xff && CONFIG_RAMMTD_ERASESTATE != 0x00
 #  error "Unsupported value for CONFIG_RAMMTD_ERASESTATE"
 #endif
@@ -183,6 +192,27 @@ static void *ram_write(FAR void *dest, FAR const void *src, size_t len)
 }
 #endif
 
+/****************************************************************************
+ * Name: ram_delay
+ *
+ * Description:
+ *   Busy wait to simulate the erase or program time of a real FLASH part,
+ *   so that file systems can be benchmarked over the RAM MTD device with
+ *   realistic costs.
+ *
+ ****************************************************************************/
+
+static void ram_delay(size_t nblocks, unsigned int usec)
+{
+  if (usec > 0)
+    {
+      while (nblocks-- > 0)
+        {
+          up_udelay(usec);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: ram_erase
  ****************************************************************************/
@@ -225,6 +255,7 @@ static int ram_erase(FAR struct mtd_dev_s *dev, off_t startblock,
   /* Then erase the data in RAM */
 
   memset(&priv->start[offset], CONFIG_RAMMTD_ERASESTATE, nbytes);
+  ram_delay(nblocks / RAMMTD_BLKPER, CONFIG_RAMMTD_ERASE_DELAY);
   return OK;
 }
 
@@ -305,6 +336,7 @@ static ssize_t ram_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
   /* Then write the data to RAM */
 
   ram_write(&priv->start[offset], buf, nbytes);
+  ram_delay(nblocks, CONFIG_RAMMTD_PROGRAM_DELAY);
   return nblocks;
 }
 
@@ -354,6 +386,8 @@ static ssize_t ram_bytewrite(FAR struct mtd_dev_s *dev, off_t offset,
   /* Then write the data to RAM */
 
   ram_write(&priv->start[offset], buf, nbytes);
+  ram_delay((nbytes + CONFIG_RAMMTD_BLOCKSIZE - 1) / CONFIG_RAMMTD_BLOCKSIZE,
+            CONFIG_RAMMTD_PROGRAM_DELAY);
   return nbytes;
 }
 #endif
@@ -406,6 +440,7 @@ static int ram_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
             /* Erase the entire device */
 
             memset(priv->start, CONFIG_RAMMTD_ERASESTATE, size);
+            ram_delay(priv->nblocks, CONFIG_RAMMTD_ERASE_DELAY);
             ret = OK;
         }
         break;
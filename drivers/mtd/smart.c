@@ -59,6 +59,9 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -126,6 +129,25 @@
                                              * such as format, sector,
                                              * etc.) */
 
+/* With background garbage collection, the worker and the block driver
+ * methods are serialized by a per-device lock.  Otherwise the smartfs
+ * layer's mutex is all the locking that is needed.
+ */
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  define smart_lock(d)       nxmutex_lock(&(d)->lock)
+#  define smart_unlock(d)     nxmutex_unlock(&(d)->lock)
+#  define SMART_BGGC_IDLE     MSEC2TICK(CONFIG_MTD_SMART_BGGC_IDLE)
+#else
+#  define smart_lock(d)
+#  define smart_unlock(d)
+#  define smart_bggc_kick(d)
+#endif
+
+/* Hash bucket of a logical sector in the sector map cache */
+
+#define SMART_CACHE_HASH(l)         ((l) % CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
+
 #if defined(CONFIG_MTD_SMART_READAHEAD) || (defined(CONFIG_DRVR_WRITABLE) && \
     defined(CONFIG_MTD_SMART_WRITEBUFFER))
 #  define SMART_HAVE_RWBUFFER 1
@@ -213,6 +235,7 @@ struct smart_cache_s
   uint16_t              logical;          /* Logical sector number */
   uint16_t              physical;         /* Associated physical sector */
   uint16_t              birth;            /* The "birthday" of this entry */
+  uint16_t              next;             /* Next entry in the hash chain */
 };
 #endif
 
@@ -283,6 +306,9 @@ struct smart_struct_s
   uint16_t              cache_lastlog;    /* Keep track of the last sector accessed */
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
   uint16_t              cache_nextbirth;  /* Sector cache aging value */
+  FAR uint16_t         *chash;            /* Sector cache hash chain heads */
+  uint32_t              cache_hits;       /* Lookups satisfied by the cache */
+  uint32_t              cache_misses;     /* Lookups that scanned the volume */
 #endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
@@ -291,6 +317,11 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  mutex_t               lock;             /* Serializes I/O and the GC worker */
+  struct work_s         gcwork;           /* Background garbage collection */
+  clock_t               gcstamp;          /* Time of the last write or release */
+#endif
 };
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -428,6 +459,10 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev,
 static int     smart_readsector(FAR struct smart_struct_s *dev,
                  unsigned long arg);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+static void    smart_bggc_kick(FAR struct smart_struct_s *dev);
+#endif
+
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 static int     smart_validate_crc(FAR struct smart_struct_s *dev);
 #endif
@@ -893,6 +928,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -902,7 +938,11 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_lock(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -939,7 +979,7 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  smart_lock(dev);
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -978,9 +1018,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
+              smart_unlock(dev);
               return ret;
             }
         }
@@ -1007,9 +1045,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -1021,6 +1057,8 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdblkspererase;
     }
 
+  smart_bggc_kick(dev);
+  smart_unlock(dev);
   return nsectors;
 }
 
@@ -1238,13 +1276,13 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
   allocsize = dev->neraseblocks << 1;
 #endif
 
-  /* Allocate the sector cache */
+  /* Allocate the sector cache and its hash chain heads */
 
   if (dev->scache == NULL)
     {
       dev->scache = (FAR struct smart_cache_s *) smart_malloc(dev,
-        CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s) +
-        allocsize, "Sector Cache");
+        CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * (sizeof(struct smart_cache_s) +
+        sizeof(uint16_t)) + allocsize, "Sector Cache");
     }
 
   if (!dev->scache)
@@ -1253,8 +1291,15 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       goto errexit;
     }
 
-  dev->releasecount = (FAR uint8_t *)dev->scache +
-    (CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s));
+  dev->chash = (FAR uint16_t *)
+    &dev->scache[CONFIG_MTD_SMART_SECTOR_CACHE_SIZE];
+  memset(dev->chash, 0xff,
+         CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(uint16_t));
+  dev->cache_hits   = 0;
+  dev->cache_misses = 0;
+
+  dev->releasecount = (FAR uint8_t *)
+    &dev->chash[CONFIG_MTD_SMART_SECTOR_CACHE_SIZE];
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
   if (dev->sectorsperblk > 16)
@@ -1442,6 +1487,99 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_cache_find
+ *
+ * Description: Return the index of the cache entry for a logical sector, or
+ *              -1 if it is not in the cache.  Entries are chained by
+ *              logical sector number modulo the cache size, so a lookup
+ *              visits only the entries that share its hash bucket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static int smart_cache_find(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+  uint16_t x;
+
+  for (x = dev->chash[SMART_CACHE_HASH(logical)];
+       x != 0xffff;
+       x = dev->scache[x].next)
+    {
+      if (dev->scache[x].logical == logical)
+        {
+          return x;
+        }
+    }
+
+  return -1;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cache_link / smart_cache_unlink
+ *
+ * Description: Add a cache entry to / remove it from its hash chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_link(FAR struct smart_struct_s *dev, uint16_t index)
+{
+  FAR uint16_t *head;
+
+  head = &dev->chash[SMART_CACHE_HASH(dev->scache[index].logical)];
+  dev->scache[index].next = *head;
+  *head = index;
+}
+
+static void smart_cache_unlink(FAR struct smart_struct_s *dev,
+                               uint16_t index)
+{
+  FAR uint16_t *link;
+
+  link = &dev->chash[SMART_CACHE_HASH(dev->scache[index].logical)];
+  while (*link != 0xffff)
+    {
+      if (*link == index)
+        {
+          *link = dev->scache[index].next;
+          break;
+        }
+
+      link = &dev->scache[*link].next;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cache_touch
+ *
+ * Description: Mark a cache entry as the most recently used.  When the
+ *              birthday counter is about to wrap, all birthdays are halved,
+ *              which keeps their order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_touch(FAR struct smart_struct_s *dev, uint16_t index)
+{
+  uint16_t x;
+
+  if (dev->cache_nextbirth == 0xffff)
+    {
+      for (x = 0; x < dev->cache_entries; x++)
+        {
+          dev->scache[x].birth >>= 1;
+        }
+
+      dev->cache_nextbirth = 0x8000;
+    }
+
+  dev->scache[index].birth = dev->cache_nextbirth++;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1449,9 +1587,9 @@ errout:
  *              map cache.  The cache is used to minimize RAM by eliminating
  *              a one-to-one mapping of all logical sectors and only keeping
  *              a fixed number of mappings per the
- *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  Sectors are
- *              automatically managed and removed based on the time since
- *              they were accessed last.
+ *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  When the cache
+ *              is full, the least recently used entry is replaced.  If the
+ *              logical sector is already cached, its mapping is updated.
  *
  ****************************************************************************/
 
@@ -1462,19 +1600,29 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
   uint16_t index;
   uint16_t x;
   uint16_t oldest;
+  int      found;
+
+  found = smart_cache_find(dev, logical);
+  if (found >= 0)
+    {
+      index = (uint16_t)found;
+    }
 
   /* If we aren't full yet, just add the sector to the end of the list */
 
-  index = 1;
-  if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
+  else if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
     {
-      oldest = 0;
-      index  = dev->cache_entries++;
+      index = dev->cache_entries++;
+      dev->scache[index].logical = logical;
+      smart_cache_link(dev, index);
     }
   else
     {
-      /* Cache is full.  We must find the least accessed entry and replace it */
+      /* Cache is full.  We must find the least recently used entry and
+       * replace it.
+       */
 
+      index  = 1;
       oldest = 0xffff;
       for (x = 0; x < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE; x++)
         {
@@ -1483,21 +1631,22 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
           if (dev->scache[x].logical < SMART_FIRST_ALLOC_SECTOR)
             continue;
 
-          /* If the hit count is zero, then choose this entry */
-
           if (dev->scache[x].birth < oldest)
             {
               oldest = dev->scache[x].birth;
               index  = x;
             }
         }
+
+      smart_cache_unlink(dev, index);
+      dev->scache[index].logical = logical;
+      smart_cache_link(dev, index);
     }
 
-  /* Now add the sector at index */
+  /* Now set the mapping at index */
 
-  dev->scache[index].logical = logical;
   dev->scache[index].physical = physical;
-  dev->scache[index].birth = dev->cache_nextbirth++;
+  smart_cache_touch(dev, index);
   dev->cache_lastlog = logical;
   dev->cache_lastphys = physical;
 
@@ -1507,18 +1656,6 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
           logical, physical, index, line);
     }
 
-  /* Test if the birthdays need to be adjusted */
-
-  if (oldest >= CONFIG_MTD_SMART_SECTOR_CACHE_SIZE + 1024)
-    {
-      for (x = 0; x < dev->cache_entries; x++)
-        {
-          dev->scache[x].birth -= 1024;
-        }
-
-      dev->cache_nextbirth -= 1024;
-    }
-
   return index;
 }
 #endif
@@ -1527,11 +1664,11 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
  * Name: smart_cache_lookup
  *
  * Description: Perform a cache lookup for the requested logical sector.
- *              If the sector is in the cache, then update the hitcount and
- *              return the physical mapping.  If a cache miss occurs, then
- *              the routine will scan the volume to find the logical sector
- *              and add / replace a cache entry with the newly located
- *              sector.
+ *              If the sector is in the cache, then mark it as recently used
+ *              and return the physical mapping.  If a cache miss occurs,
+ *              then the routine will scan the volume to find the logical
+ *              sector and add / replace a cache entry with the newly
+ *              located sector.
  *
  ****************************************************************************/
 
@@ -1542,7 +1679,6 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev,
   int       ret;
   uint16_t  block;
   uint16_t  sector;
-  uint16_t  x;
   uint16_t  physical;
   uint16_t  logicalsector;
   struct    smart_sect_header_s header;
@@ -1554,28 +1690,30 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev,
 
   if (logical == dev->cache_lastlog)
     {
+      dev->cache_hits++;
       return dev->cache_lastphys;
     }
 
   /* First search for the entry in the cache */
 
-  for (x = 0; x < dev->cache_entries; x++)
+  ret = smart_cache_find(dev, logical);
+  if (ret >= 0)
     {
-      if (dev->scache[x].logical == logical)
-        {
-          /* Entry found in the cache.  Grab the physical mapping. */
+      /* Entry found in the cache.  Grab the physical mapping. */
 
-          physical = dev->scache[x].physical;
-          break;
-        }
+      physical = dev->scache[ret].physical;
+      smart_cache_touch(dev, ret);
+      dev->cache_hits++;
     }
 
   /* If the entry wasn't found in the cache, then we must search the volume
    * for it and add it to the cache.
    */
 
-  if (physical == 0xffff)
+  else
     {
+      dev->cache_misses++;
+
       /* Now scan the MTD device.  Instead of scanning start to end, we
        * span the erase blocks and read one sector from each at a time.
        * this helps speed up the search on volumes that aren't full
@@ -1676,38 +1814,41 @@ err_out:
 static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t
     logical, uint16_t physical)
 {
-  uint16_t    x;
+  uint16_t    last;
+  int         x;
 
-  /* Scan through all cache entries and find the logical sector entry */
+  /* Find the logical sector entry */
 
-  for (x = 0; x < dev->cache_entries; x++)
+  x = smart_cache_find(dev, logical);
+  if (x >= 0)
     {
-      if (dev->scache[x].logical == logical)
-        {
-          /* Entry found.  Update it's physical mapping */
+      /* Entry found.  Update it's physical mapping */
 
-          dev->scache[x].physical = physical;
+      dev->scache[x].physical = physical;
 
-          /* If we are freeing a sector, then remove the logical entry from
-           * the cache.
-           */
+      /* If we are freeing a sector, then remove the logical entry from
+       * the cache, moving the last entry into its place.
+       */
 
-          if (physical == 0xffff)
-            {
-                dev->scache[x].logical =
-                  dev->scache[dev->cache_entries - 1].logical;
-                dev->scache[x].physical =
-                  dev->scache[dev->cache_entries - 1].physical;
-                dev->cache_entries--;
-            }
+      if (physical == 0xffff)
+        {
+          smart_cache_unlink(dev, x);
 
-          if (dev->debuglevel > 1)
+          last = dev->cache_entries - 1;
+          if (x != last)
             {
-              _err("Update Cache:  Log=%d, Phys=%d at index %d\n",
-                   logical, physical, x);
+              smart_cache_unlink(dev, last);
+              dev->scache[x] = dev->scache[last];
+              smart_cache_link(dev, x);
             }
 
-          break;
+          dev->cache_entries--;
+        }
+
+      if (dev->debuglevel > 1)
+        {
+          _err("Update Cache:  Log=%d, Phys=%d at index %d\n",
+               logical, physical, x);
         }
     }
 
@@ -2464,7 +2605,12 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
       dev->sbitmap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
 
-      if (logicalsector < SMART_FIRST_ALLOC_SECTOR)
+      /* The system sectors are always cached.  Use the scan, which has
+       * already read this header, to warm the rest of the cache too.
+       */
+
+      if (logicalsector < SMART_FIRST_ALLOC_SECTOR ||
+          dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
         {
           smart_add_sector_to_cache(dev, logicalsector, winner, __LINE__);
         }
@@ -4102,6 +4248,197 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_bggc_select
+ *
+ * Description:  Find the erase block with the most released sectors among
+ *               those that are at least 'threshold' percent released and
+ *               can be relocated without dipping into the free sectors
+ *               reserved for foreground collection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static uint16_t smart_bggc_select(FAR struct smart_struct_s *dev,
+                                  uint16_t threshold)
+{
+  uint16_t  collectblock = 0xffff;
+  uint16_t  releasemax = 0;
+  uint16_t  released;
+  uint16_t  freecount;
+  uint16_t  live;
+  int       x;
+
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      released  = smart_get_count(dev, dev->releasecount, x);
+      freecount = smart_get_count(dev, dev->freecount, x);
+#else
+      released  = dev->releasecount[x];
+      freecount = dev->freecount[x];
+#endif
+
+      if (released <= releasemax ||
+          released * 100 < threshold * dev->availsectperblk)
+        {
+          continue;
+        }
+
+      /* The live sectors of the block must fit in the free sectors of the
+       * other blocks, leaving the reserve untouched.
+       */
+
+      live = dev->availsectperblk - released - freecount;
+      if (dev->freesectors < freecount + live + dev->sectorsperblk + 4)
+        {
+          continue;
+        }
+
+      releasemax   = released;
+      collectblock = x;
+    }
+
+  return collectblock;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_bggc
+ *
+ * Description:  Reclaim erase blocks ahead of need, most released first,
+ *               until a limit is reached or no block is dirty enough.
+ *               Returns the number of blocks reclaimed or a negated errno.
+ *
+ * Assumptions:  The device is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static int smart_bggc(FAR struct smart_struct_s *dev,
+                      FAR const struct mtd_smart_gc_s *limits)
+{
+  uint16_t  threshold = CONFIG_MTD_SMART_BGGC_THRESHOLD;
+  uint16_t  maxblocks = 0;
+  clock_t   maxticks = 0;
+  clock_t   start;
+  uint16_t  block;
+  int       count;
+  int       ret;
+
+  if (limits != NULL)
+    {
+      maxblocks = limits->maxblocks;
+      maxticks  = MSEC2TICK(limits->maxtime);
+      if (limits->threshold > 0)
+        {
+          threshold = limits->threshold;
+        }
+    }
+
+  start = clock_systime_ticks();
+  for (count = 0; maxblocks == 0 || count < maxblocks; count++)
+    {
+      if (maxticks > 0 && clock_systime_ticks() - start >= maxticks)
+        {
+          break;
+        }
+
+      block = smart_bggc_select(dev, threshold);
+      if (block == 0xffff)
+        {
+          break;
+        }
+
+      finfo("Background collect block %d, free=%d released=%d\n",
+            block, dev->freesectors, dev->releasesectors);
+
+      ret = smart_relocate_block(dev, block);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return count;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Low priority work queue worker.  Once the device has been
+ *               idle for CONFIG_MTD_SMART_BGGC_IDLE, reclaim up to
+ *               CONFIG_MTD_SMART_BGGC_BLOCKS erase blocks, then come back
+ *               after another idle period if any were reclaimed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  struct mtd_smart_gc_s limits;
+  clock_t elapsed;
+  int ret;
+
+  /* Wait until there has been no activity for a whole idle period */
+
+  elapsed = clock_systime_ticks() - dev->gcstamp;
+  if (elapsed < SMART_BGGC_IDLE)
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 SMART_BGGC_IDLE - elapsed);
+      return;
+    }
+
+  limits.maxblocks = CONFIG_MTD_SMART_BGGC_BLOCKS;
+  limits.threshold = 0;
+  limits.maxtime   = 0;
+
+  smart_lock(dev);
+  ret = smart_bggc(dev, &limits);
+  smart_unlock(dev);
+
+  if (ret > 0)
+    {
+      dev->gcstamp = clock_systime_ticks();
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 SMART_BGGC_IDLE);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_bggc_kick
+ *
+ * Description:  Note that a sector was written or released and make sure
+ *               the background collector will look at the device once it
+ *               is idle again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_bggc_kick(FAR struct smart_struct_s *dev)
+{
+  dev->gcstamp = clock_systime_ticks();
+  if (work_available(&dev->gcwork))
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                 SMART_BGGC_IDLE);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -5458,6 +5795,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  smart_lock(dev);
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5474,7 +5813,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5529,6 +5869,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       /* Free the specified logical sector */
 
       ret = smart_freesector(dev, arg);
+      smart_bggc_kick(dev);
       goto ok_out;
 
     case BIOC_WRITESECT:
@@ -5546,8 +5887,18 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
 #endif
 
+      smart_bggc_kick(dev);
       goto ok_out;
 
+#ifdef CONFIG_MTD_SMART_BGGC
+    case BIOC_GC:
+
+      /* Reclaim erase blocks now, within the caller's limits */
+
+      ret = smart_bggc(dev, (FAR const struct mtd_smart_gc_s *)arg);
+      goto ok_out;
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
     case BIOC_GETPROCFSD:
 
@@ -5568,6 +5919,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       procfs_data->formatsector   = dev->smap[0];
       procfs_data->dirsector      = dev->smap[3];
 #else
+      procfs_data->cachehits      = dev->cache_hits;
+      procfs_data->cachemisses    = dev->cache_misses;
       procfs_data->formatsector   = smart_cache_lookup(dev, 0);
       procfs_data->dirsector      = smart_cache_lookup(dev, 3);
 #endif
@@ -5616,6 +5969,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_unlock(dev);
   return ret;
 }
 
@@ -6151,6 +6505,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxmutex_init(&dev->lock);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6295,6 +6652,9 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  nxmutex_destroy(&dev->lock);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   if (rootdirdev)
     {
@@ -37,6 +37,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -83,6 +84,8 @@
 #define W25_PURDID                 0xab    /* Release PD, Device ID                 */
 #define W25_RDMFID                 0x90    /* Read Manufacturer / Device            */
 #define W25_JEDEC_ID               0x9f    /* JEDEC ID read                         */
+#define W25_ES                     0x75    /* Erase/program suspend                 */
+#define W25_ER                     0x7a    /* Erase/program resume                  */
 
 /* W25 Registers ********************************************************************/
 
@@ -218,6 +221,11 @@ struct w25_dev_s
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to W25 device */
 
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  off_t                 erasesect;   /* Sector of the last sector erase */
+  clock_t               resumed;     /* Time of the last erase resume */
+#endif
+
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
   uint8_t               flags;       /* Buffered sector flags */
   uint16_t              esectno;     /* Erase sector number in the cache*/
@@ -245,6 +253,11 @@ static void w25_sectorerase(FAR struct w25_dev_s *priv, off_t offset);
 static inline int w25_chiperase(FAR struct w25_dev_s *priv);
 static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes);
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes);
+static void w25_eraseresume(FAR struct w25_dev_s *priv);
+#endif
 #ifndef CONFIG_W25_READONLY
 static void w25_pagewrite(FAR struct w25_dev_s *priv, FAR const uint8_t *buffer,
                             off_t address, size_t nbytes);
@@ -648,6 +661,9 @@ static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
 
   SPI_SEND(priv->spi, W25_SE);
   priv->prev_instr = W25_SE;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  priv->erasesect  = sector;
+#endif
 
   /* Send the sector address high byte first. Only the most significant bits (those
    * corresponding to the sector) have any meaning.
@@ -702,17 +718,31 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes)
 {
   uint8_t status;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  bool suspended;
+#endif
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  /* Rather than waiting up to hundreds of milliseconds for a sector erase
+   * to finish, suspend it if the read does not touch that sector.
+   */
 
-  status = w25_waitwritecomplete(priv);
-  DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+  suspended = w25_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  /* Make sure that writing is disabled */
+      status = w25_waitwritecomplete(priv);
+      DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+      UNUSED(status);
 
-  w25_wrdi(priv);
+      /* Make sure that writing is disabled */
+
+      w25_wrdi(priv);
+    }
 
   /* Select this FLASH part */
 
@@ -747,8 +777,111 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  if (suspended)
+    {
+      w25_eraseresume(priv);
+    }
+#endif
 }
 
+/************************************************************************************
+ * Name: w25_erasesuspend
+ *
+ * Description:
+ *   Suspend a sector erase that is in progress so that the caller can read a
+ *   different sector.  The SPI bus must be locked and remains locked until
+ *   w25_eraseresume() is called, so the erasing thread never sees the
+ *   suspended state.
+ *
+ * Returned Value:
+ *   True if the erase was suspended; false if the caller must wait for the
+ *   device to become ready as usual.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes)
+{
+  uint8_t status;
+
+  /* Only a sector erase can be suspended, and not if the read touches the
+   * sector being erased.
+   */
+
+  if (priv->prev_instr != W25_SE || nbytes == 0 ||
+      (priv->erasesect >= (address >> W25_SECTOR_SHIFT) &&
+       priv->erasesect <= ((address + nbytes - 1) >> W25_SECTOR_SHIFT)))
+    {
+      return false;
+    }
+
+  /* Leave the erase alone for at least one full clock tick after it was last
+   * resumed.  Otherwise a steady stream of reads could keep it from ever
+   * completing.
+   */
+
+  if (clock_systime_ticks() - priv->resumed < 2)
+    {
+      return false;
+    }
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_RDSR);
+  status = SPI_SEND(priv->spi, W25_DUMMY);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  if ((status & W25_SR_BUSY) == 0)
+    {
+      /* The erase has already completed */
+
+      return false;
+    }
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_ES);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* The suspend takes effect within tSUS (20 us max); poll without
+   * sleeping.
+   */
+
+  do
+    {
+      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+      SPI_SEND(priv->spi, W25_RDSR);
+      status = SPI_SEND(priv->spi, W25_DUMMY);
+      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+    }
+  while ((status & W25_SR_BUSY) != 0);
+
+  finfo("Suspended erase of sector %ld\n", (long)priv->erasesect);
+  return true;
+}
+
+/************************************************************************************
+ * Name: w25_eraseresume
+ *
+ * Description:
+ *   Resume the sector erase suspended by w25_erasesuspend().
+ *
+ ************************************************************************************/
+
+static void w25_eraseresume(FAR struct w25_dev_s *priv)
+{
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_ER);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* The erase is in progress again */
+
+  priv->prev_instr = W25_SE;
+  priv->resumed    = clock_systime_ticks();
+}
+#endif
+
 /************************************************************************************
  * Name:  w25_pagewrite
  ************************************************************************************/
@@ -51,6 +51,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -314,6 +315,11 @@ struct w25qxxxjv_dev_s
   uint16_t               esectno;     /* Erase sector number in the cache */
   FAR uint8_t           *sector;      /* Allocated sector data */
 #endif
+
+#ifdef CONFIG_W25QXXXJV_MMAP
+  FAR uint8_t           *mmapbase;    /* Memory-mapped window or NULL */
+  bool                   mapped;      /* True: in memory-mapped mode */
+#endif
 };
 
 /************************************************************************************
@@ -356,6 +362,16 @@ static int  w25qxxxjv_read_byte(FAR struct w25qxxxjv_dev_s *priv, FAR uint8_t *b
               off_t address, size_t nbytes);
 static int  w25qxxxjv_write_page(FAR struct w25qxxxjv_dev_s *priv,
               FAR const uint8_t *buffer, off_t address, size_t nbytes);
+#ifdef CONFIG_W25QXXXJV_MMAP
+static void w25qxxxjv_mmap_enter(FAR struct w25qxxxjv_dev_s *priv);
+static void w25qxxxjv_mmap_exit(FAR struct w25qxxxjv_dev_s *priv);
+static void w25qxxxjv_mmap_modified(FAR struct w25qxxxjv_dev_s *priv,
+                                    off_t address, size_t nbytes);
+#else
+#  define w25qxxxjv_mmap_enter(p)
+#  define w25qxxxjv_mmap_exit(p)
+#  define w25qxxxjv_mmap_modified(p,a,n)
+#endif
 #ifdef CONFIG_W25QXXXJV_SECTOR512
 static int  w25qxxxjv_flush_cache(struct w25qxxxjv_dev_s *priv);
 static FAR uint8_t *w25qxxxjv_read_cache(struct w25qxxxjv_dev_s *priv, off_t sector);
@@ -856,6 +872,14 @@ static int w25qxxxjv_read_byte(FAR struct w25qxxxjv_dev_s *priv, FAR uint8_t *bu
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)buflen);
 
+#ifdef CONFIG_W25QXXXJV_MMAP
+  if (priv->mapped)
+    {
+      memcpy(buffer, priv->mmapbase + address, buflen);
+      return OK;
+    }
+#endif
+
   meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
   meminfo.addrlen = 3;
   meminfo.dummies = CONFIG_W25QXXXJV_DUMMIES;
@@ -867,6 +891,82 @@ static int w25qxxxjv_read_byte(FAR struct w25qxxxjv_dev_s *priv, FAR uint8_t *bu
   return QSPI_MEMORY(priv->qspi, &meminfo);
 }
 
+/************************************************************************************
+ * Name: w25qxxxjv_mmap_enter
+ *
+ * Description:
+ *   Put the QuadSPI controller into memory-mapped mode using the same quad
+ *   I/O fast read command as w25qxxxjv_read_byte().  The bus must be
+ *   locked.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_W25QXXXJV_MMAP
+static void w25qxxxjv_mmap_enter(FAR struct w25qxxxjv_dev_s *priv)
+{
+  struct qspi_meminfo_s meminfo;
+  FAR void *base;
+
+  if (priv->mapped)
+    {
+      return;
+    }
+
+  memset(&meminfo, 0, sizeof(meminfo));
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = 3;
+  meminfo.dummies = CONFIG_W25QXXXJV_DUMMIES;
+  meminfo.cmd     = W25QXXXJV_FAST_READ_QUADIO;
+
+  base = QSPI_MMAP(priv->qspi, &meminfo);
+  if (base != NULL)
+    {
+      priv->mmapbase = (FAR uint8_t *)base;
+      priv->mapped   = true;
+    }
+}
+
+/************************************************************************************
+ * Name: w25qxxxjv_mmap_exit
+ *
+ * Description:
+ *   Leave memory-mapped mode before issuing commands.  The bus must be
+ *   locked.
+ *
+ ************************************************************************************/
+
+static void w25qxxxjv_mmap_exit(FAR struct w25qxxxjv_dev_s *priv)
+{
+  if (priv->mapped)
+    {
+      QSPI_MUNMAP(priv->qspi);
+      priv->mapped = false;
+    }
+}
+
+/************************************************************************************
+ * Name: w25qxxxjv_mmap_modified
+ *
+ * Description:
+ *   Called after the FLASH content in [address, address + nbytes) was
+ *   programmed or erased.  Discard any stale copy of that range in the data
+ *   cache and map the FLASH again so that an XIP address handed out earlier
+ *   stays valid.
+ *
+ ************************************************************************************/
+
+static void w25qxxxjv_mmap_modified(FAR struct w25qxxxjv_dev_s *priv,
+                                    off_t address, size_t nbytes)
+{
+  if (priv->mmapbase != NULL)
+    {
+      up_invalidate_dcache((uintptr_t)priv->mmapbase + address,
+                           (uintptr_t)priv->mmapbase + address + nbytes);
+      w25qxxxjv_mmap_enter(priv);
+    }
+}
+#endif
+
 /************************************************************************************
  * Name:  w25qxxxjv_write_page
  ************************************************************************************/
@@ -1141,6 +1241,9 @@ static int w25qxxxjv_erase(FAR struct mtd_dev_s *dev, off_t startblock,
 {
   FAR struct w25qxxxjv_dev_s *priv = (FAR struct w25qxxxjv_dev_s *)dev;
   size_t blocksleft = nblocks;
+#ifdef CONFIG_W25QXXXJV_MMAP
+  off_t firstblock = startblock;
+#endif
 #ifdef CONFIG_W25QXXXJV_SECTOR512
   int ret;
 #endif
@@ -1150,6 +1253,7 @@ static int w25qxxxjv_erase(FAR struct mtd_dev_s *dev, off_t startblock,
   /* Lock access to the SPI bus until we complete the erase */
 
   w25qxxxjv_lock(priv->qspi);
+  w25qxxxjv_mmap_exit(priv);
 
   while (blocksleft-- > 0)
     {
@@ -1173,6 +1277,14 @@ static int w25qxxxjv_erase(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
+#if defined(CONFIG_W25QXXXJV_MMAP) && defined(CONFIG_W25QXXXJV_SECTOR512)
+  w25qxxxjv_mmap_modified(priv, firstblock << W25QXXXJV_SECTOR512_SHIFT,
+                          (startblock - firstblock) <<
+                          W25QXXXJV_SECTOR512_SHIFT);
+#elif defined(CONFIG_W25QXXXJV_MMAP)
+  w25qxxxjv_mmap_modified(priv, firstblock << priv->sectorshift,
+                          (startblock - firstblock) << priv->sectorshift);
+#endif
   w25qxxxjv_unlock(priv->qspi);
 
   return (int)nblocks;
@@ -1228,6 +1340,7 @@ static ssize_t w25qxxxjv_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
   w25qxxxjv_lock(priv->qspi);
+  w25qxxxjv_mmap_exit(priv);
 
 #if defined(CONFIG_W25QXXXJV_SECTOR512)
   ret = w25qxxxjv_write_cache(priv, buffer, startblock, nblocks);
@@ -1245,6 +1358,13 @@ static ssize_t w25qxxxjv_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
+#if defined(CONFIG_W25QXXXJV_SECTOR512)
+  w25qxxxjv_mmap_modified(priv, startblock << W25QXXXJV_SECTOR512_SHIFT,
+                          nblocks << W25QXXXJV_SECTOR512_SHIFT);
+#else
+  w25qxxxjv_mmap_modified(priv, startblock << priv->pageshift,
+                          nblocks << priv->pageshift);
+#endif
   w25qxxxjv_unlock(priv->qspi);
 
   return ret < 0 ? ret : nblocks;
@@ -1265,6 +1385,7 @@ static ssize_t w25qxxxjv_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nb
   /* Lock the QuadSPI bus and select this FLASH part */
 
   w25qxxxjv_lock(priv->qspi);
+  w25qxxxjv_mmap_enter(priv);
   ret = w25qxxxjv_read_byte(priv, buffer, offset, nbytes);
   w25qxxxjv_unlock(priv->qspi);
 
@@ -1330,7 +1451,10 @@ static int w25qxxxjv_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg
           /* Erase the entire device */
 
           w25qxxxjv_lock(priv->qspi);
+          w25qxxxjv_mmap_exit(priv);
           ret = w25qxxxjv_erase_chip(priv);
+          w25qxxxjv_mmap_modified(priv, 0, (size_t)priv->nsectors <<
+                                           priv->sectorshift);
           w25qxxxjv_unlock(priv->qspi);
         }
         break;
@@ -1341,7 +1465,15 @@ static int w25qxxxjv_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+#ifdef CONFIG_W25QXXXJV_MMAP
+          w25qxxxjv_lock(priv->qspi);
+          w25qxxxjv_mmap_exit(priv);
+#endif
           ret = w25qxxxjv_protect(priv, prot->startblock, prot->nblocks);
+#ifdef CONFIG_W25QXXXJV_MMAP
+          w25qxxxjv_mmap_enter(priv);
+          w25qxxxjv_unlock(priv->qspi);
+#endif
         }
         break;
 
@@ -1351,9 +1483,41 @@ static int w25qxxxjv_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+#ifdef CONFIG_W25QXXXJV_MMAP
+          w25qxxxjv_lock(priv->qspi);
+          w25qxxxjv_mmap_exit(priv);
+#endif
           ret = w25qxxxjv_unprotect(priv, prot->startblock, prot->nblocks);
+#ifdef CONFIG_W25QXXXJV_MMAP
+          w25qxxxjv_mmap_enter(priv);
+          w25qxxxjv_unlock(priv->qspi);
+#endif
+        }
+        break;
+
+#ifdef CONFIG_W25QXXXJV_MMAP
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+
+          w25qxxxjv_lock(priv->qspi);
+          w25qxxxjv_mmap_enter(priv);
+          if (priv->mapped)
+            {
+              *ppv = priv->mmapbase;
+              ret  = OK;
+            }
+          else
+            {
+              ret  = -ENOTTY;
+            }
+
+          w25qxxxjv_unlock(priv->qspi);
         }
         break;
+#endif
 
       default:
         ret = -ENOTTY; /* Bad/unsupported command */
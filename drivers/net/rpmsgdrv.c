@@ -37,9 +37,11 @@
 
 #include <nuttx/net/arp.h>
 #include <nuttx/net/dns.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/pkt.h>
 #include <nuttx/net/rpmsg.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/rptun/openamp.h>
 
 /****************************************************************************
@@ -132,6 +134,25 @@
 
 #define NET_RPMSG_DRV_WDDELAY      (1*CLK_TCK)
 
+/* Space reserved in front of each TX frame in the rpmsg buffer */
+
+#ifdef CONFIG_NET_RPMSG_DRV_BATCH
+#  define NET_RPMSG_DRV_HDRLEN     (sizeof(struct net_rpmsg_transferv_s) + \
+                                    sizeof(struct net_rpmsg_frame_s))
+#else
+#  define NET_RPMSG_DRV_HDRLEN     sizeof(struct net_rpmsg_transfer_s)
+#  define net_rpmsg_drv_flush(dev)
+#endif
+
+#if defined(CONFIG_NET_RPMSG_DRV_OFFLOAD) && defined(CONFIG_NETDEV_TSO)
+#  define NET_RPMSG_DRV_TSO        1
+#  ifdef CONFIG_NET_IPv6
+#    define NET_RPMSG_DRV_IPHDRLEN IPv6_HDRLEN
+#  else
+#    define NET_RPMSG_DRV_IPHDRLEN IPv4_HDRLEN
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -154,6 +175,13 @@ struct net_rpmsg_drv_s
   struct wdog_s         txpoll;   /* TX poll timer */
   struct work_s         pollwork; /* For deferring poll work to the work queue */
 
+#ifdef CONFIG_NET_RPMSG_DRV_BATCH
+  /* Frames waiting to be sent in one NET_RPMSG_TRANSFERV message */
+
+  FAR struct net_rpmsg_transferv_s *txbatch;
+  uint32_t              txbatchsize; /* Size of the txbatch rpmsg buffer */
+#endif
+
   /* This holds the information visible to the NuttX network */
 
   struct net_driver_s  dev;      /* Interface understood by the network */
@@ -168,7 +196,7 @@ struct net_rpmsg_drv_s
 static int  net_rpmsg_drv_transmit(FAR struct net_driver_s *dev,
                                    bool nocopy);
 static int  net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev);
-static void net_rpmsg_drv_reply(FAR struct net_driver_s *dev);
+static void net_rpmsg_drv_reply(FAR struct net_driver_s *dev, bool nocopy);
 
 /* RPMSG related functions */
 
@@ -181,6 +209,9 @@ static int net_rpmsg_drv_sockioctl_handler(FAR struct rpmsg_endpoint *ept,
 static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
                                           FAR void *data, size_t len,
                                           uint32_t src, FAR void *priv);
+static int net_rpmsg_drv_transferv_handler(FAR struct rpmsg_endpoint *ept,
+                                           FAR void *data, size_t len,
+                                           uint32_t src, FAR void *priv);
 
 static void net_rpmsg_drv_device_created(FAR struct rpmsg_device *rdev,
                                          FAR void *priv_);
@@ -234,6 +265,7 @@ static const rpmsg_ept_cb g_net_rpmsg_drv_handler[] =
   [NET_RPMSG_DEVIOCTL]  = net_rpmsg_drv_default_handler,
   [NET_RPMSG_SOCKIOCTL] = net_rpmsg_drv_sockioctl_handler,
   [NET_RPMSG_TRANSFER]  = net_rpmsg_drv_transfer_handler,
+  [NET_RPMSG_TRANSFERV] = net_rpmsg_drv_transferv_handler,
 };
 
 /****************************************************************************
@@ -245,6 +277,80 @@ static void net_rpmsg_drv_wait(FAR sem_t *sem)
   net_lockedwait_uninterruptible(sem);
 }
 
+/****************************************************************************
+ * Name: net_rpmsg_drv_getbuf
+ *
+ * Description:
+ *   Get a new rpmsg TX buffer and make it the device's d_buf.  d_buf is
+ *   left NULL if no buffer is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void net_rpmsg_drv_getbuf(FAR struct net_driver_s *dev, bool wait)
+{
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  FAR uint8_t *buf;
+  uint32_t size;
+
+  buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, wait);
+  if (buf == NULL)
+    {
+      dev->d_buf = NULL;
+      return;
+    }
+
+  dev->d_buf     = buf + NET_RPMSG_DRV_HDRLEN;
+  dev->d_pktsize = size - NET_RPMSG_DRV_HDRLEN;
+
+#ifdef NET_RPMSG_DRV_TSO
+  /* The link side segments TCP frames as large as the buffer */
+
+  size = dev->d_pktsize - dev->d_llhdrlen - NET_RPMSG_DRV_IPHDRLEN -
+         TCP_HDRLEN;
+  dev->d_tsomax = MIN(size, UINT16_MAX);
+#endif
+}
+
+#ifdef CONFIG_NET_RPMSG_DRV_BATCH
+/****************************************************************************
+ * Name: net_rpmsg_drv_flush
+ *
+ * Description:
+ *   Send the frames packed by net_rpmsg_drv_transmit() in one message.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void net_rpmsg_drv_flush(FAR struct net_driver_s *dev)
+{
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  FAR struct net_rpmsg_transferv_s *msg = priv->txbatch;
+  int ret;
+
+  if (msg == NULL)
+    {
+      return;
+    }
+
+  priv->txbatch = NULL;
+
+  msg->header.command = NET_RPMSG_TRANSFERV;
+  msg->header.result  = 0;
+  msg->header.cookie  = 0;
+
+  ret = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg) + msg->length);
+  if (ret < 0)
+    {
+      NETDEV_TXERRORS(dev);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: net_rpmsg_drv_transmit
  *
@@ -262,6 +368,88 @@ static void net_rpmsg_drv_wait(FAR sem_t *sem)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_RPMSG_DRV_BATCH
+static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
+{
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  FAR struct net_rpmsg_transferv_s *msg = priv->txbatch;
+  FAR struct net_rpmsg_frame_s *frame;
+  uint32_t need = NET_RPMSG_FRAME_SIZE(dev->d_len);
+  uint32_t size;
+
+  net_rpmsg_drv_dumppacket("transmit", dev->d_buf, dev->d_len);
+  NETDEV_TXPACKETS(dev);
+
+  /* Send the pending frames first if this one doesn't fit behind them */
+
+  if (msg != NULL &&
+      priv->txbatchsize - sizeof(*msg) - msg->length < need)
+    {
+      net_rpmsg_drv_flush(dev);
+      msg = NULL;
+    }
+
+  if (msg == NULL && nocopy)
+    {
+      /* d_buf is our own TX buffer with the headers reserved in front, so
+       * it becomes the new message in place.
+       */
+
+      msg = (FAR struct net_rpmsg_transferv_s *)
+            (dev->d_buf - NET_RPMSG_DRV_HDRLEN);
+      frame = (FAR struct net_rpmsg_frame_s *)msg->data;
+
+      msg->count        = 0;
+      msg->length       = 0;
+      priv->txbatch     = msg;
+      priv->txbatchsize = dev->d_pktsize + NET_RPMSG_DRV_HDRLEN;
+
+      /* The buffer is now owned by the batch */
+
+      dev->d_buf = NULL;
+    }
+  else
+    {
+      /* Copy the frame behind the pending ones.  d_buf is then free for
+       * the next frame, which is cheaper than a message per frame.
+       */
+
+      if (msg == NULL)
+        {
+          msg = rpmsg_get_tx_payload_buffer(&priv->ept, &size, true);
+          if (msg == NULL)
+            {
+              NETDEV_TXERRORS(dev);
+              return -ENOMEM;
+            }
+
+          msg->count        = 0;
+          msg->length       = 0;
+          priv->txbatch     = msg;
+          priv->txbatchsize = size;
+        }
+
+      frame = (FAR struct net_rpmsg_frame_s *)(msg->data + msg->length);
+      memcpy(frame->data, dev->d_buf, dev->d_len);
+    }
+
+  frame->length   = dev->d_len;
+  frame->flags    = NETDEV_TXCHKSUM_OFFLOAD(dev) ?
+                    NET_RPMSG_FRAME_NOCSUM : 0;
+#ifdef CONFIG_NETDEV_TSO
+  frame->gso_size = dev->d_tsomss;
+  NETDEV_SET_TSOMSS(dev, 0);
+#else
+  frame->gso_size = 0;
+#endif
+
+  msg->count++;
+  msg->length += need;
+
+  NETDEV_TXDONE(dev);
+  return OK;
+}
+#else
 static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
 {
   FAR struct net_rpmsg_drv_s *priv = dev->d_private;
@@ -290,6 +478,10 @@ static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
   if (nocopy)
     {
       ret = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg) + msg->length);
+
+      /* The buffer is gone with the message */
+
+      dev->d_buf = NULL;
     }
   else
     {
@@ -307,6 +499,7 @@ static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
       return OK;
     }
 }
+#endif
 
 /****************************************************************************
  * Name: net_rpmsg_drv_txpoll
@@ -333,9 +526,6 @@ static int net_rpmsg_drv_transmit(FAR struct net_driver_s *dev, bool nocopy)
 
 static int net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev)
 {
-  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
-  uint32_t size;
-
   /* If the polling resulted in data that should be sent out on the network,
    * the field d_len is set to a value > 0.
    */
@@ -367,14 +557,13 @@ static int net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev)
           net_rpmsg_drv_transmit(dev, true);
 
           /* Check if there is room in the device to hold another packet. If
-           * not, return a non-zero value to terminate the poll.
+           * not, return a non-zero value to terminate the poll.  d_buf is
+           * still there if the frame was copied into a pending batch.
            */
 
-          dev->d_buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
-          if (dev->d_buf)
+          if (dev->d_buf == NULL)
             {
-              dev->d_buf += sizeof(struct net_rpmsg_transfer_s);
-              dev->d_pktsize = size - sizeof(struct net_rpmsg_transfer_s);
+              net_rpmsg_drv_getbuf(dev, false);
             }
 
           return dev->d_buf == NULL;
@@ -397,7 +586,8 @@ static int net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev)
  *   that case and performs the transmission if necessary.
  *
  * Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   dev    - Reference to the NuttX driver state structure
+ *   nocopy - d_buf is a TX buffer of the driver, not the RX message
  *
  * Returned Value:
  *   None
@@ -407,7 +597,7 @@ static int net_rpmsg_drv_txpoll(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
-static void net_rpmsg_drv_reply(FAR struct net_driver_s *dev)
+static void net_rpmsg_drv_reply(FAR struct net_driver_s *dev, bool nocopy)
 {
   /* If the packet dispatch resulted in data that should be sent out on the
    * network, the field d_len will set to a value > 0.
@@ -433,7 +623,7 @@ static void net_rpmsg_drv_reply(FAR struct net_driver_s *dev)
 
       /* And send the packet */
 
-      net_rpmsg_drv_transmit(dev, false);
+      net_rpmsg_drv_transmit(dev, nocopy);
     }
 }
 
@@ -574,53 +764,31 @@ static bool net_rpmsg_drv_is_arp(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Name: net_rpmsg_drv_transfer_handler
+ * Name: net_rpmsg_drv_input
  *
  * Description:
- *   An message was received indicating the availability of a new RX packet
+ *   Dispatch the frame in d_buf/d_len to the network and send the reply.
  *
  * Parameters:
- *   ept - Reference to the endpoint which receive the message
+ *   dev    - Reference to the NuttX driver state structure
+ *   nocopy - d_buf is a TX buffer of the driver, not the RX message
  *
  * Returned Value:
- *   OK on success
+ *   None
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
-                                          FAR void *data, size_t len,
-                                          uint32_t src, FAR void *priv)
+static void net_rpmsg_drv_input(FAR struct net_driver_s *dev, bool nocopy)
 {
-  FAR struct net_driver_s *dev = ept->priv;
-  FAR struct net_rpmsg_transfer_s *msg = data;
-  FAR void *oldbuf;
-
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
-   */
-
-  net_lock();
-
   /* Check for errors and update statistics */
 
-  net_rpmsg_drv_dumppacket("receive", msg->data, msg->length);
+  net_rpmsg_drv_dumppacket("receive", dev->d_buf, dev->d_len);
 
   NETDEV_RXPACKETS(dev);
 
-  /* Copy the data from the hardware to dev->d_buf. Set
-   * amount of data in dev->d_len
-   */
-
-  oldbuf = dev->d_buf;
-
-  dev->d_buf = msg->data;
-  dev->d_len = msg->length;
-
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the frame into the tap */
 
@@ -644,7 +812,7 @@ static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
 
       /* Check for a reply to the IPv4 packet */
 
-      net_rpmsg_drv_reply(dev);
+      net_rpmsg_drv_reply(dev, nocopy);
     }
   else
 #endif
@@ -660,7 +828,7 @@ static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
 
       /* Check for a reply to the IPv6 packet */
 
-      net_rpmsg_drv_reply(dev);
+      net_rpmsg_drv_reply(dev, nocopy);
     }
   else
 #endif
@@ -676,13 +844,59 @@ static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
 
       /* Check for a reply to the ARP packet */
 
-      net_rpmsg_drv_reply(dev);
+      net_rpmsg_drv_reply(dev, nocopy);
     }
   else
 #endif
     {
       NETDEV_RXDROPPED(dev);
     }
+}
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_transfer_handler
+ *
+ * Description:
+ *   An message was received indicating the availability of a new RX packet
+ *
+ * Parameters:
+ *   ept - Reference to the endpoint which receive the message
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
+                                          FAR void *data, size_t len,
+                                          uint32_t src, FAR void *priv)
+{
+  FAR struct net_driver_s *dev = ept->priv;
+  FAR struct net_rpmsg_transfer_s *msg = data;
+  FAR void *oldbuf;
+
+  /* Lock the network and serialize driver operations if necessary.
+   * NOTE: Serialization is only required in the case where the driver work
+   * is performed on an LP worker thread and where more than one LP worker
+   * thread has been configured.
+   */
+
+  net_lock();
+
+  /* Copy the data from the hardware to dev->d_buf. Set
+   * amount of data in dev->d_len
+   */
+
+  oldbuf = dev->d_buf;
+
+  dev->d_buf = msg->data;
+  dev->d_len = msg->length;
+
+  net_rpmsg_drv_input(dev, false);
+  net_rpmsg_drv_flush(dev);
 
   dev->d_buf = oldbuf;
   net_unlock();
@@ -690,6 +904,88 @@ static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+/****************************************************************************
+ * Name: net_rpmsg_drv_transferv_handler
+ *
+ * Description:
+ *   A message was received carrying several RX packets
+ *
+ * Parameters:
+ *   ept - Reference to the endpoint which receive the message
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ ****************************************************************************/
+
+static int net_rpmsg_drv_transferv_handler(FAR struct rpmsg_endpoint *ept,
+                                           FAR void *data, size_t len,
+                                           uint32_t src, FAR void *priv)
+{
+  FAR struct net_driver_s *dev = ept->priv;
+  FAR struct net_rpmsg_transferv_s *msg = data;
+  FAR struct net_rpmsg_frame_s *frame;
+  FAR uint8_t *end = (FAR uint8_t *)data + len;
+  FAR uint8_t *ptr = msg->data;
+  FAR void *oldbuf;
+  uint32_t i;
+
+  net_lock();
+
+  for (i = 0; i < msg->count; i++)
+    {
+      frame = (FAR struct net_rpmsg_frame_s *)ptr;
+      if (frame->data > end || frame->length > end - frame->data)
+        {
+          NETDEV_RXERRORS(dev);
+          break;
+        }
+
+      ptr += NET_RPMSG_FRAME_SIZE(frame->length);
+
+      if (msg->count == 1)
+        {
+          /* A lone frame may be handled in place like NET_RPMSG_TRANSFER,
+           * the reply can use the rest of the buffer.
+           */
+
+          oldbuf     = dev->d_buf;
+          dev->d_buf = frame->data;
+          dev->d_len = frame->length;
+
+          net_rpmsg_drv_input(dev, false);
+
+          dev->d_buf = oldbuf;
+          break;
+        }
+
+      /* A reply built in place could overwrite the next frames, so copy
+       * the frame into a TX buffer and send the reply from there.
+       */
+
+      if (dev->d_buf == NULL)
+        {
+          net_rpmsg_drv_getbuf(dev, true);
+        }
+
+      if (dev->d_buf == NULL || frame->length > dev->d_pktsize)
+        {
+          NETDEV_RXDROPPED(dev);
+          continue;
+        }
+
+      memcpy(dev->d_buf, frame->data, frame->length);
+      dev->d_len = frame->length;
+
+      net_rpmsg_drv_input(dev, true);
+    }
+
+  net_rpmsg_drv_flush(dev);
+  net_unlock();
+
+  return 0;
+}
+
 static void net_rpmsg_drv_device_created(FAR struct rpmsg_device *rdev,
                                          FAR void *priv_)
 {
@@ -718,6 +1014,9 @@ static void net_rpmsg_drv_device_destroy(FAR struct rpmsg_device *rdev,
     {
       rpmsg_destroy_ept(&priv->ept);
       dev->d_buf = NULL;
+#ifdef CONFIG_NET_RPMSG_DRV_BATCH
+      priv->txbatch = NULL;
+#endif
     }
 }
 
@@ -788,7 +1087,6 @@ static void net_rpmsg_drv_poll_work(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
   FAR struct net_rpmsg_drv_s *priv = dev->d_private;
-  uint32_t size;
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -808,12 +1106,7 @@ static void net_rpmsg_drv_poll_work(FAR void *arg)
     {
       /* Try to get the payload buffer if not yet */
 
-      dev->d_buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
-      if (dev->d_buf)
-        {
-          dev->d_buf += sizeof(struct net_rpmsg_transfer_s);
-          dev->d_pktsize = size - sizeof(struct net_rpmsg_transfer_s);
-        }
+      net_rpmsg_drv_getbuf(dev, false);
     }
 
   if (dev->d_buf)
@@ -824,6 +1117,7 @@ static void net_rpmsg_drv_poll_work(FAR void *arg)
        */
 
       devif_timer(dev, NET_RPMSG_DRV_WDDELAY, net_rpmsg_drv_txpoll);
+      net_rpmsg_drv_flush(dev);
     }
 
   /* Setup the watchdog poll timer again */
@@ -1056,8 +1350,6 @@ static int net_rpmsg_drv_ifdown(FAR struct net_driver_s *dev)
 static void net_rpmsg_drv_txavail_work(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
-  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
-  uint32_t size;
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -1075,12 +1367,7 @@ static void net_rpmsg_drv_txavail_work(FAR void *arg)
 
       if (dev->d_buf == NULL)
         {
-          dev->d_buf = rpmsg_get_tx_payload_buffer(&priv->ept, &size, false);
-          if (dev->d_buf)
-            {
-              dev->d_buf += sizeof(struct net_rpmsg_transfer_s);
-              dev->d_pktsize = size - sizeof(struct net_rpmsg_transfer_s);
-            }
+          net_rpmsg_drv_getbuf(dev, false);
         }
 
       /* Check if there is room in the hardware to hold another outgoing
@@ -1092,6 +1379,7 @@ static void net_rpmsg_drv_txavail_work(FAR void *arg)
           /* If so, then poll the network for new XMIT data */
 
           devif_poll(dev, net_rpmsg_drv_txpoll);
+          net_rpmsg_drv_flush(dev);
         }
     }
 
@@ -1378,6 +1666,10 @@ int net_rpmsg_drv_init(FAR const char *cpuname,
   dev->d_ioctl   = net_rpmsg_drv_ioctl;   /* Handle network IOCTL commands */
 #endif
   dev->d_private = priv;                  /* Used to recover private state from dev */
+#ifdef CONFIG_NET_RPMSG_DRV_OFFLOAD
+  dev->d_chkoffload = NETDEV_CHKSUM_TX |  /* The link side does the checksums */
+                      NETDEV_CHKSUM_RX;
+#endif
 
   /* Register the device with the openamp */
 
@@ -26,6 +26,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 #include <poll.h>
 #include <errno.h>
@@ -158,7 +159,7 @@ static void    telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                  FAR const char *src, size_t srclen, FAR char *dest,
                  size_t destlen);
-static bool    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+static void    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
                  int *nwritten);
 static void    telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option,
                  uint8_t value);
@@ -356,14 +357,53 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                               FAR const char *src, size_t srclen,
                               FAR char *dest, size_t destlen)
 {
+  FAR const char *end;
+  size_t ncopy;
   int nread;
   uint8_t ch;
 
   ninfo("srclen: %d destlen: %d\n", srclen, destlen);
 
-  for (nread = 0; srclen > 0 && nread < destlen; srclen--)
+  for (nread = 0; srclen > 0 && nread < destlen; )
     {
+      if (priv->td_state == STATE_NORMAL)
+        {
+          /* Fast path:  Copy the run of plain data up to the next byte that
+           * needs to be parsed (IAC, or CR which is dropped in line mode).
+           */
+
+          ncopy = destlen - nread;
+          if (ncopy > srclen)
+            {
+              ncopy = srclen;
+            }
+
+          end = memchr(src, TELNET_IAC, ncopy);
+          if (end != NULL)
+            {
+              ncopy = end - src;
+            }
+
+#ifndef CONFIG_TELNET_CHARACTER_MODE
+          end = memchr(src, TELNET_CR, ncopy);
+          if (end != NULL)
+            {
+              ncopy = end - src;
+            }
+#endif
+
+          if (ncopy > 0)
+            {
+              memcpy(&dest[nread], src, ncopy);
+              nread  += ncopy;
+              src    += ncopy;
+              srclen -= ncopy;
+              continue;
+            }
+        }
+
       ch = *src++;
+      srclen--;
       ninfo("ch=%02x state=%d\n", ch, priv->td_state);
 
       switch (priv->td_state)
@@ -566,11 +606,10 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
  *
  ****************************************************************************/
 
-static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+static void telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
                            int *nread)
 {
   register int index;
-  bool ret = false;
 
   /* Ignore carriage returns (we will put these in automatically as
    * necessary).
@@ -590,16 +629,10 @@ static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
           /* Now add the carriage return */
 
           priv->td_txbuffer[index++] = TELNET_CR;
-
-          /* End of line */
-
-          ret = true;
         }
 
       *nread = index;
     }
-
-  return ret;
 }
 
 /****************************************************************************
@@ -886,31 +919,62 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode = filep->f_inode;
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
+  FAR const char *end;
+  size_t ncopy;
   ssize_t nsent;
   ssize_t ret;
   int ncopied;
-  char ch;
-  bool eol;
 
   ninfo("len: %d\n", len);
 
   /* Process each character from the user buffer */
 
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+  for (nsent = 0, ncopied = 0; nsent < len; )
     {
-      /* Get the next character from the user buffer */
+      /* Fast path:  Copy the run of characters up to the next CR or NL
+       * directly into the TX buffer.
+       */
 
-      ch = *src++;
+      ncopy = CONFIG_TELNET_TXBUFFER_SIZE - 1 - ncopied;
+      if (ncopy > len - nsent)
+        {
+          ncopy = len - nsent;
+        }
+
+      end = memchr(src, TELNET_NL, ncopy);
+      if (end != NULL)
+        {
+          ncopy = end - src;
+        }
+
+      end = memchr(src, TELNET_CR, ncopy);
+      if (end != NULL)
+        {
+          ncopy = end - src;
+        }
+
+      if (ncopy > 0)
+        {
+          memcpy(&priv->td_txbuffer[ncopied], src, ncopy);
+          ncopied += ncopy;
+        }
+      else
+        {
+          /* Add the CR or NL character to the TX buffer */
 
-      /* Add the character to the TX buffer */
+          telnet_putchar(priv, *src, &ncopied);
+          ncopy = 1;
+        }
 
-      eol = telnet_putchar(priv, ch, &ncopied);
+      src   += ncopy;
+      nsent += ncopy;
 
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n")?
+      /* Is the buffer too full to hold the next largest character sequence
+       * ("\r\n")?  Lines are not sent one at a time:  All output of the
+       * write is coalesced into as few TCP sends as possible.
        */
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 2)
+      if (ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 2)
         {
           /* Yes... send the data now */
 
@@ -1308,15 +1372,29 @@ static int telnet_io_main(int argc, FAR char** argv)
                       /* Take exclusive access to data buffer */
 
                       nxsem_wait(&priv->td_exclsem);
-                      buffer = priv->td_rxbuffer + priv->td_pending +
-                               priv->td_offset;
 
+                      /* Move the pending bytes to the beginning of the
+                       * buffer so that all of the free space can be
+                       * received in one batch.
+                       */
+
+                      if (priv->td_offset > 0)
+                        {
+                          memmove(priv->td_rxbuffer,
+                                  priv->td_rxbuffer + priv->td_offset,
+                                  priv->td_pending);
+                          priv->td_offset = 0;
+                        }
+
+                      buffer = priv->td_rxbuffer + priv->td_pending;
                       ret = psock_recv(&priv->td_psock, buffer,
                                        CONFIG_TELNET_RXBUFFER_SIZE -
-                                       priv->td_pending - priv->td_offset,
-                                       0);
+                                       priv->td_pending, 0);
+                      if (ret > 0)
+                        {
+                          priv->td_pending += ret;
+                        }
 
-                      priv->td_pending += ret;
                       nxsem_post(&priv->td_exclsem);
 
                       /* Notify the client thread that data is available */
@@ -1328,7 +1406,10 @@ static int telnet_io_main(int argc, FAR char** argv)
                        * control that should generate a signal.
                        */
 
-                      telnet_check_ctrlchar(priv, buffer, ret);
+                      if (ret > 0)
+                        {
+                          telnet_check_ctrlchar(priv, buffer, ret);
+                        }
 #endif
                     }
                 }
@@ -25,6 +25,7 @@
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notectl_driver.h>
+#include <nuttx/note/notectf_driver.h>
 
 /****************************************************************************
  * Public Functions
@@ -65,5 +66,13 @@ int note_register(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVER_NOTECTF
+  ret = notectf_register();
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   return ret;
 }
@@ -0,0 +1,319 @@
+/****************************************************************************
+ * drivers/note/notectf_driver.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The notes read from /dev/note are already a compact binary stream:  Each
+ * note starts with a common header holding its length, its type, the
+ * priority, CPU and PID of the thread, and a time stamp; all multi-byte
+ * fields are little endian.  This driver describes that stream in the
+ * Common Trace Format (CTF) 1.8 metadata language (TSDL) so that standard
+ * tools such as babeltrace or Trace Compass can decode it without any
+ * NuttX-specific parser.
+ *
+ * To capture a trace, copy /dev/notectf to a file named 'metadata' and
+ * stream /dev/note into a second file (or over a serial port, socket or
+ * RTT channel) in the same directory.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/note/notectf_driver.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NOTECTF_PTRBITS (8 * sizeof(uintptr_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct notectf_file_s
+{
+  size_t nf_length;   /* Length of the metadata text */
+  char   nf_text[1];  /* The metadata text */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     notectf_open(FAR struct file *filep);
+static int     notectf_close(FAR struct file *filep);
+static ssize_t notectf_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_notectf_fops =
+{
+  notectf_open,  /* open */
+  notectf_close, /* close */
+  notectf_read,  /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL,          /* ioctl */
+  NULL           /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0            /* unlink */
+#endif
+};
+
+/* The metadata text.  The two '%lu' and '%u' conversions receive the clock
+ * frequency and the size of a pointer in bits.
+ */
+
+static const char g_notectf_format[] =
+  "/* CTF 1.8 */\n"
+  "\n"
+  "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n"
+  "typealias integer { size = 16; align = 8; signed = false; } "
+  ":= uint16_t;\n"
+  "typealias integer { size = 32; align = 8; signed = false; } "
+  ":= uint32_t;\n"
+  "\n"
+  "trace {\n"
+  "  major = 1;\n"
+  "  minor = 8;\n"
+  "  byte_order = le;\n"
+  "};\n"
+  "\n"
+  "clock {\n"
+  "  name = systime;\n"
+  "  freq = %lu;\n"
+  "  absolute = false;\n"
+  "};\n"
+  "\n"
+  "typealias integer { size = 32; align = 8; signed = false; "
+  "map = clock.systime.value; } := systime_t;\n"
+  "typealias integer { size = %u; align = 8; signed = false; base = hex; }"
+  " := uintptr_t;\n"
+  "\n"
+  "stream {\n"
+  "  event.header := struct {\n"
+  "    uint8_t length;\n"
+  "    uint8_t id;\n"
+  "    uint8_t priority;\n"
+#ifdef CONFIG_SMP
+  "    uint8_t cpu;\n"
+#endif
+  "    uint16_t pid;\n"
+  "    systime_t timestamp;\n"
+  "  };\n"
+  "};\n"
+  "\n"
+#if CONFIG_TASK_NAME_SIZE > 0
+  "event { name = \"sched_start\"; id = 0; "
+  "fields := struct { string name; }; };\n"
+#else
+  "event { name = \"sched_start\"; id = 0; };\n"
+#endif
+  "event { name = \"sched_stop\"; id = 1; };\n"
+  "event { name = \"sched_suspend\"; id = 2; "
+  "fields := struct { uint8_t state; }; };\n"
+  "event { name = \"sched_resume\"; id = 3; };\n"
+#ifdef CONFIG_SMP
+  "event { name = \"cpu_start\"; id = 4; "
+  "fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_started\"; id = 5; };\n"
+  "event { name = \"cpu_pause\"; id = 6; "
+  "fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_paused\"; id = 7; };\n"
+  "event { name = \"cpu_resume\"; id = 8; "
+  "fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_resumed\"; id = 9; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
+  "event { name = \"preempt_lock\"; id = 10; "
+  "fields := struct { uint16_t count; }; };\n"
+  "event { name = \"preempt_unlock\"; id = 11; "
+  "fields := struct { uint16_t count; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
+#ifdef CONFIG_SMP
+  "event { name = \"csection_enter\"; id = 12; "
+  "fields := struct { uint16_t count; }; };\n"
+  "event { name = \"csection_leave\"; id = 13; "
+  "fields := struct { uint16_t count; }; };\n"
+#else
+  "event { name = \"csection_enter\"; id = 12; };\n"
+  "event { name = \"csection_leave\"; id = 13; };\n"
+#endif
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  "event { name = \"spinlock_lock\"; id = 14; "
+  "fields := struct { uintptr_t spinlock; uint8_t value; }; };\n"
+  "event { name = \"spinlock_locked\"; id = 15; "
+  "fields := struct { uintptr_t spinlock; uint8_t value; }; };\n"
+  "event { name = \"spinlock_unlock\"; id = 16; "
+  "fields := struct { uintptr_t spinlock; uint8_t value; }; };\n"
+  "event { name = \"spinlock_abort\"; id = 17; "
+  "fields := struct { uintptr_t spinlock; uint8_t value; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+  "event { name = \"syscall_enter\"; id = 18; "
+  "fields := struct { uint8_t nr; }; };\n"
+  "event { name = \"syscall_leave\"; id = 19; "
+  "fields := struct { uint8_t nr; uintptr_t result; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+  "event { name = \"irq_enter\"; id = 20; "
+  "fields := struct { uint8_t irq; }; };\n"
+  "event { name = \"irq_leave\"; id = 21; "
+  "fields := struct { uint8_t irq; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SEMSPIN
+  "event { name = \"sem_spin\"; id = 22; "
+  "fields := struct { uintptr_t sem; uint16_t nspins; "
+  "uint8_t acquired; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  "event { name = \"dump_string\"; id = 23; "
+  "fields := struct { string message; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_SPANS
+  "event { name = \"span_begin\"; id = 24; "
+  "fields := struct { uintptr_t span; uint32_t time; }; };\n"
+  "event { name = \"span_end\"; id = 25; "
+  "fields := struct { uintptr_t span; uint32_t time; }; };\n"
+#endif
+  ;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_open
+ *
+ * Description:
+ *   Generate the metadata text for this configuration.
+ *
+ ****************************************************************************/
+
+static int notectf_open(FAR struct file *filep)
+{
+  FAR struct notectf_file_s *priv;
+  int len;
+
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      return -EACCES;
+    }
+
+  len = snprintf(NULL, 0, g_notectf_format, (unsigned long)TICK_PER_SEC,
+                 (unsigned int)NOTECTF_PTRBITS);
+  DEBUGASSERT(len > 0);
+
+  priv = (FAR struct notectf_file_s *)
+    kmm_malloc(sizeof(struct notectf_file_s) + len);
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->nf_length = snprintf(priv->nf_text, len + 1, g_notectf_format,
+                             (unsigned long)TICK_PER_SEC,
+                             (unsigned int)NOTECTF_PTRBITS);
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: notectf_close
+ ****************************************************************************/
+
+static int notectf_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: notectf_read
+ ****************************************************************************/
+
+static ssize_t notectf_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct notectf_file_s *priv = filep->f_priv;
+  size_t nread;
+
+  DEBUGASSERT(priv != NULL && buffer != NULL);
+
+  if (filep->f_pos >= priv->nf_length)
+    {
+      return 0;
+    }
+
+  nread = priv->nf_length - filep->f_pos;
+  if (nread > buflen)
+    {
+      nread = buflen;
+    }
+
+  memcpy(buffer, &priv->nf_text[filep->f_pos], nread);
+  filep->f_pos += nread;
+  return nread;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_register
+ *
+ * Description:
+ *   Register a driver at /dev/notectf that returns the CTF metadata
+ *   describing the note stream read from /dev/note.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero on succress. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notectf_register(void)
+{
+  return register_driver("/dev/notectf", &g_notectf_fops, 0444, NULL);
+}
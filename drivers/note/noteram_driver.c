@@ -45,21 +45,67 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/fs/fs.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* There is one circular buffer per CPU.  Each buffer is written only by
+ * the CPU that owns it, so no lock is needed to add a note.
+ */
+
+#ifdef CONFIG_SMP
+#  define NOTERAM_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define NOTERAM_NCPUS 1
+#endif
+
+/* The buffer indices are free-running counts of bytes.  The buffer size
+ * must be a power of two so that the indices map onto the buffer
+ * correctly when they wrap around.
+ */
+
+#if (CONFIG_DRIVER_NOTERAM_BUFSIZE & \
+     (CONFIG_DRIVER_NOTERAM_BUFSIZE - 1)) != 0
+#  error CONFIG_DRIVER_NOTERAM_BUFSIZE must be a power of two
+#endif
+
+/* Memory barriers are only provided with spinlock support (and are only
+ * needed in the SMP case).
+ */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+#define NOTERAM_MASK       (CONFIG_DRIVER_NOTERAM_BUFSIZE - 1)
+#define NOTERAM_BYTE(n,i)  ((n)->ni_buffer[(i) & NOTERAM_MASK])
+
+/* True if free-running index a is before index b */
+
+#define NOTERAM_BEFORE(a,b) ((int)((a) - (b)) < 0)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* ni_head and ni_tail are only modified by the CPU that owns the buffer.
+ * ni_read and ni_start are only modified by the reader.  ni_start is the
+ * oldest note that has not been cleared by NOTERAM_CLEAR.
+ */
+
 struct noteram_info_s
 {
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
-  unsigned int ni_overwrite;
+  volatile unsigned int ni_start;
   uint8_t ni_buffer[CONFIG_DRIVER_NOTERAM_BUFSIZE];
 };
 
@@ -90,17 +136,13 @@ static const struct file_operations g_noteram_fops =
 #endif
 };
 
-static struct noteram_info_s g_noteram_info =
-{
+static struct noteram_info_s g_noteram_info[NOTERAM_NCPUS];
+
+static volatile unsigned int g_noteram_overwrite =
 #ifdef CONFIG_DRIVER_NOTERAM_DEFAULT_NOOVERWRITE
-  .ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE
+  NOTERAM_MODE_OVERWRITE_DISABLE;
 #else
-  .ni_overwrite = NOTERAM_MODE_OVERWRITE_ENABLE
-#endif
-};
-
-#ifdef CONFIG_SMP
-static volatile spinlock_t g_noteram_lock;
+  NOTERAM_MODE_OVERWRITE_ENABLE;
 #endif
 
 /****************************************************************************
@@ -111,7 +153,7 @@ static volatile spinlock_t g_noteram_lock;
  * Name: noteram_buffer_clear
  *
  * Description:
- *   Clear all contents of the circular buffer.
+ *   Clear all contents of the circular buffers.
  *
  * Input Parameters:
  *   None.
@@ -124,156 +166,200 @@ static volatile spinlock_t g_noteram_lock;
 static void noteram_buffer_clear(void)
 {
   irqstate_t flags;
+  int cpu;
 
   flags = enter_critical_section();
 
-  g_noteram_info.ni_tail = g_noteram_info.ni_head;
-  g_noteram_info.ni_read = g_noteram_info.ni_head;
+  /* The cleared notes remain in the buffers until the producer reclaims
+   * them, but they will never be read again.
+   */
+
+  for (cpu = 0; cpu < NOTERAM_NCPUS; cpu++)
+    {
+      FAR struct noteram_info_s *ni = &g_noteram_info[cpu];
+
+      ni->ni_start = ni->ni_head;
+      ni->ni_read  = ni->ni_start;
+    }
 
-  if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+  if (g_noteram_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      g_noteram_info.ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
+      g_noteram_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
     }
 
   leave_critical_section(flags);
 }
 
 /****************************************************************************
- * Name: noteram_next
+ * Name: noteram_systime
  *
  * Description:
- *   Return the circular buffer index at offset from the specified index
- *   value, handling wraparound
- *
- * Input Parameters:
- *   ndx - Old circular buffer index
- *
- * Returned Value:
- *   New circular buffer index
+ *   Return the time stamp of a note.
  *
  ****************************************************************************/
 
-static inline unsigned int noteram_next(unsigned int ndx,
-                                        unsigned int offset)
+static inline uint32_t noteram_systime(FAR const struct note_common_s *note)
 {
-  ndx += offset;
-  if (ndx >= CONFIG_DRIVER_NOTERAM_BUFSIZE)
-    {
-      ndx -= CONFIG_DRIVER_NOTERAM_BUFSIZE;
-    }
-
-  return ndx;
+  return (uint32_t)note->nc_systime[0] |
+         (uint32_t)note->nc_systime[1] << 8 |
+         (uint32_t)note->nc_systime[2] << 16 |
+         (uint32_t)note->nc_systime[3] << 24;
 }
 
 /****************************************************************************
- * Name: noteram_length
+ * Name: noteram_copy
  *
  * Description:
- *   Length of data currently in circular buffer.
+ *   Copy bytes out of a circular buffer and verify that the producer did
+ *   not overwrite them while they were being copied.
  *
  * Input Parameters:
- *   None
+ *   ni     - The per-CPU buffer
+ *   read   - Free-running index of the first byte to copy
+ *   buffer - Location to return the bytes
+ *   len    - The number of bytes to copy
  *
  * Returned Value:
- *   Length of data currently in circular buffer.
+ *   true if the copy is valid.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_DEBUG_ASSERTIONS
-static unsigned int noteram_length(void)
+static bool noteram_copy(FAR struct noteram_info_s *ni, unsigned int read,
+                         FAR uint8_t *buffer, size_t len)
 {
-  unsigned int head = g_noteram_info.ni_head;
-  unsigned int tail = g_noteram_info.ni_tail;
+  size_t i;
 
-  if (tail > head)
+  for (i = 0; i < len; i++)
     {
-      head += CONFIG_DRIVER_NOTERAM_BUFSIZE;
+      buffer[i] = NOTERAM_BYTE(ni, read + i);
     }
 
-  return head - tail;
+  /* The producer advances the tail before it overwrites any bytes.  If
+   * the tail is still not beyond 'read' then the copy is intact.
+   */
+
+  SP_DMB();
+  return !NOTERAM_BEFORE(read, ni->ni_tail);
 }
-#endif
 
 /****************************************************************************
- * Name: noteram_unread_length
+ * Name: noteram_peek
  *
  * Description:
- *   Length of unread data currently in circular buffer.
+ *   Get the common header of the next unread note in one per-CPU buffer.
  *
  * Input Parameters:
- *   None
+ *   ni   - The per-CPU buffer
+ *   read - Location to return the free-running read index of the note
+ *   note - Location to return the common note header
  *
  * Returned Value:
- *   Length of unread data currently in circular buffer.
+ *   The length of the note, or zero if the buffer holds no unread notes.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the read side of the buffers.
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(void)
+static size_t noteram_peek(FAR struct noteram_info_s *ni,
+                           FAR unsigned int *read,
+                           FAR struct note_common_s *note)
 {
-  unsigned int head = g_noteram_info.ni_head;
-  unsigned int read = g_noteram_info.ni_read;
+  unsigned int head;
+  unsigned int pos;
 
-  if (read > head)
+  for (; ; )
     {
-      head += CONFIG_DRIVER_NOTERAM_BUFSIZE;
-    }
+      /* Skip any notes that were overwritten or cleared */
+
+      pos = ni->ni_read;
+      if (NOTERAM_BEFORE(pos, ni->ni_tail))
+        {
+          pos = ni->ni_tail;
+        }
+
+      if (NOTERAM_BEFORE(pos, ni->ni_start))
+        {
+          pos = ni->ni_start;
+        }
+
+      ni->ni_read = pos;
+
+      head = ni->ni_head;
+      SP_DMB();
 
-  return head - read;
+      if (pos == head)
+        {
+          return 0;
+        }
+
+      if (noteram_copy(ni, pos, (FAR uint8_t *)note,
+                       sizeof(struct note_common_s)))
+        {
+          DEBUGASSERT(note->nc_length >= sizeof(struct note_common_s) &&
+                      note->nc_length <= head - pos);
+
+          *read = pos;
+          return note->nc_length;
+        }
+    }
 }
 
 /****************************************************************************
- * Name: noteram_remove
+ * Name: noteram_next
  *
  * Description:
- *   Remove the variable length note from the tail of the circular buffer
+ *   Select the per-CPU buffer holding the oldest unread note.
  *
  * Input Parameters:
- *   None
+ *   read    - Location to return the free-running read index of the note
+ *   notelen - Location to return the length of the note
  *
  * Returned Value:
- *   None
+ *   The selected buffer, or NULL if all of the buffers are empty.
  *
  * Assumptions:
- *   We are within a critical section.
+ *   The caller has exclusive access to the read side of the buffers.
  *
  ****************************************************************************/
 
-static void noteram_remove(void)
+static FAR struct noteram_info_s *noteram_next(FAR unsigned int *read,
+                                               FAR size_t *notelen)
 {
-  FAR struct note_common_s *note;
-  unsigned int tail;
-  unsigned int length;
-
-  /* Get the tail index of the circular buffer */
-
-  tail = g_noteram_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_DRIVER_NOTERAM_BUFSIZE);
-
-  /* Get the length of the note at the tail index */
-
-  note   = (FAR struct note_common_s *)&g_noteram_info.ni_buffer[tail];
-  length = note->nc_length;
-  DEBUGASSERT(length <= noteram_length());
-
-  /* Increment the tail index to remove the entire note from the circular
-   * buffer.
-   */
-
-  if (g_noteram_info.ni_read == g_noteram_info.ni_tail)
+  FAR struct noteram_info_s *oldest = NULL;
+  struct note_common_s note;
+  unsigned int pos;
+  uint32_t systime = 0;
+  uint32_t time;
+  size_t len;
+  int cpu;
+
+  for (cpu = 0; cpu < NOTERAM_NCPUS; cpu++)
     {
-      /* The read index also needs increment. */
+      FAR struct noteram_info_s *ni = &g_noteram_info[cpu];
 
-      g_noteram_info.ni_read = noteram_next(tail, length);
+      len = noteram_peek(ni, &pos, &note);
+      if (len > 0)
+        {
+          time = noteram_systime(&note);
+          if (oldest == NULL || (int32_t)(time - systime) < 0)
+            {
+              oldest   = ni;
+              systime  = time;
+              *read    = pos;
+              *notelen = len;
+            }
+        }
     }
 
-  g_noteram_info.ni_tail = noteram_next(tail, length);
+  return oldest;
 }
 
 /****************************************************************************
  * Name: noteram_get
  *
  * Description:
- *   Get the next note from the read index of the circular buffer.
+ *   Get the oldest unread note from the circular buffers.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -281,75 +367,64 @@ static void noteram_remove(void)
  *
  * Returned Value:
  *   On success, the positive, non-zero length of the return note is
- *   provided.  Zero is returned only if the circular buffer is empty.  A
+ *   provided.  Zero is returned only if the circular buffers are empty.  A
  *   negated errno value is returned in the event of any failure.
  *
  ****************************************************************************/
 
 static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
+  FAR struct noteram_info_s *ni;
   irqstate_t flags;
-  unsigned int remaining;
   unsigned int read;
+  size_t len;
   ssize_t notelen;
-  size_t circlen;
 
   DEBUGASSERT(buffer != NULL);
-  flags = enter_critical_section();
-
-  /* Verify that the circular buffer is not empty */
-
-  circlen = noteram_unread_length();
-  if (circlen <= 0)
-    {
-      notelen = 0;
-      goto errout_with_csection;
-    }
-
-  /* Get the read index of the circular buffer */
-
-  read    = g_noteram_info.ni_read;
-  DEBUGASSERT(read < CONFIG_DRIVER_NOTERAM_BUFSIZE);
-
-  /* Get the length of the note at the read index */
 
-  note    = (FAR struct note_common_s *)&g_noteram_info.ni_buffer[read];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  /* The critical section only serializes readers.  The producers never
+   * wait for it.
+   */
 
-  /* Is the user buffer large enough to hold the note? */
+  flags = enter_critical_section();
 
-  if (buflen < notelen)
+  for (; ; )
     {
-      /* Skip the large note so that we do not get constipated. */
+      /* Find the oldest note in any of the buffers */
 
-      g_noteram_info.ni_read = noteram_next(read, notelen);
+      ni = noteram_next(&read, &len);
+      if (ni == NULL)
+        {
+          notelen = 0;
+          break;
+        }
 
-      /* and return an error */
+      /* Is the user buffer large enough to hold the note? */
 
-      notelen = -EFBIG;
-      goto errout_with_csection;
-    }
+      if (buflen < len)
+        {
+          /* Skip the large note so that we do not get constipated. */
 
-  /* Loop until the note has been transferred to the user buffer */
+          ni->ni_read = read + len;
 
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
-    {
-      /* Copy the next byte at the read index */
+          /* and return an error */
 
-      *buffer++ = g_noteram_info.ni_buffer[read];
+          notelen = -EFBIG;
+          break;
+        }
 
-      /* Adjust indices and counts */
+      /* Copy the note to the user buffer.  If it was overwritten during
+       * the copy, then try again with whatever is now the oldest note.
+       */
 
-      read = noteram_next(read, 1);
-      remaining--;
+      if (noteram_copy(ni, read, buffer, len))
+        {
+          ni->ni_read = read + len;
+          notelen     = len;
+          break;
+        }
     }
 
-  g_noteram_info.ni_read = read;
-
-errout_with_csection:
   leave_critical_section(flags);
   return notelen;
 }
@@ -358,49 +433,30 @@ errout_with_csection:
  * Name: noteram_size
  *
  * Description:
- *   Return the size of the next note at the read index of the circular
- *   buffer.
+ *   Return the size of the oldest unread note in the circular buffers.
  *
  * Input Parameters:
  *   None.
  *
  * Returned Value:
- *   Zero is returned if the circular buffer is empty.  Otherwise, the size
- *   of the next note is returned.
+ *   Zero is returned if the circular buffers are empty.  Otherwise, the
+ *   size of the next note is returned.
  *
  ****************************************************************************/
 
 static ssize_t noteram_size(void)
 {
-  FAR struct note_common_s *note;
   irqstate_t flags;
   unsigned int read;
-  ssize_t notelen;
-  size_t circlen;
+  size_t notelen;
 
   flags = enter_critical_section();
 
-  /* Verify that the circular buffer is not empty */
-
-  circlen = noteram_unread_length();
-  if (circlen <= 0)
+  if (noteram_next(&read, &notelen) == NULL)
     {
       notelen = 0;
-      goto errout_with_csection;
     }
 
-  /* Get the read index of the circular buffer */
-
-  read = g_noteram_info.ni_read;
-  DEBUGASSERT(read < CONFIG_DRIVER_NOTERAM_BUFSIZE);
-
-  /* Get the length of the note at the read index */
-
-  note    = (FAR struct note_common_s *)&g_noteram_info.ni_buffer[read];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
-
-errout_with_csection:
   leave_critical_section(flags);
   return notelen;
 }
@@ -411,10 +467,21 @@ errout_with_csection:
 
 static int noteram_open(FAR struct file *filep)
 {
-  /* Reset the read index of the circular buffer */
+  irqstate_t flags;
+  int cpu;
 
-  g_noteram_info.ni_read = g_noteram_info.ni_tail;
+  /* Reset the read index of the circular buffers.  noteram_peek() will
+   * skip anything that has already been overwritten or cleared.
+   */
+
+  flags = enter_critical_section();
 
+  for (cpu = 0; cpu < NOTERAM_NCPUS; cpu++)
+    {
+      g_noteram_info[cpu].ni_read = g_noteram_info[cpu].ni_start;
+    }
+
+  leave_critical_section(flags);
   return OK;
 }
 
@@ -512,7 +579,7 @@ static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
-            *(unsigned int *)arg = g_noteram_info.ni_overwrite;
+            *(unsigned int *)arg = g_noteram_overwrite;
             ret = OK;
           }
         break;
@@ -529,7 +596,7 @@ static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
-            g_noteram_info.ni_overwrite = *(unsigned int *)arg;
+            g_noteram_overwrite = *(unsigned int *)arg;
             ret = OK;
           }
         break;
@@ -559,78 +626,80 @@ static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg)
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   The note is added to the buffer of the current CPU.  Only local
+ *   interrupts are disabled; no lock is taken.
  *
  ****************************************************************************/
 
 void sched_note_add(FAR const void *note, size_t notelen)
 {
-  FAR const char *buf = note;
+  FAR struct noteram_info_s *ni;
+  FAR const uint8_t *buf = note;
   unsigned int head;
-  unsigned int next;
+  unsigned int tail;
   irqstate_t flags;
+  size_t i;
+
+  DEBUGASSERT(note != NULL && notelen < CONFIG_DRIVER_NOTERAM_BUFSIZE);
+
+  /* Disabling local interrupts keeps this CPU the only writer of its
+   * buffer.
+   */
 
   flags = up_irq_save();
-#ifdef CONFIG_SMP
-  spin_lock_wo_note(&g_noteram_lock);
-#endif
 
-  if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+  if (g_noteram_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-#ifdef CONFIG_SMP
-      spin_unlock_wo_note(&g_noteram_lock);
-#endif
       up_irq_restore(flags);
       return;
     }
 
-  /* Get the index to the head of the circular buffer */
+  ni   = &g_noteram_info[up_cpu_index()];
+  head = ni->ni_head;
+  tail = ni->ni_tail;
 
-  DEBUGASSERT(note != NULL && notelen < CONFIG_DRIVER_NOTERAM_BUFSIZE);
-  head = g_noteram_info.ni_head;
+  /* Remove notes from the tail until there is room for the new note */
 
-  /* Loop until all bytes have been transferred to the circular buffer */
-
-  while (notelen > 0)
+  while (head - tail + notelen > CONFIG_DRIVER_NOTERAM_BUFSIZE)
     {
-      /* Get the next head index.  Would it collide with the current tail
-       * index?
+      /* Notes that were cleared may always be discarded.  Otherwise, stop
+       * recording if not in overwrite mode.
        */
 
-      next = noteram_next(head, 1);
-      if (next == g_noteram_info.ni_tail)
+      if (g_noteram_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE &&
+          !NOTERAM_BEFORE(tail, ni->ni_start))
         {
-          if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
-            {
-              /* Stop recording if not in overwrite mode */
-
-              g_noteram_info.ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-
-#ifdef CONFIG_SMP
-              spin_unlock_wo_note(&g_noteram_lock);
-#endif
-              up_irq_restore(flags);
-              return;
-            }
+          g_noteram_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+          up_irq_restore(flags);
+          return;
+        }
 
-          /* Yes, then remove the note at the tail index */
+      /* The first byte of every note is its length */
 
-          noteram_remove();
-        }
+      DEBUGASSERT(NOTERAM_BYTE(ni, tail) != 0);
+      tail += NOTERAM_BYTE(ni, tail);
+    }
 
-      /* Save the next byte at the head index */
+  /* Publish the new tail before overwriting any bytes so that a reader on
+   * another CPU can detect that the note it is copying was lost.
+   */
 
-      g_noteram_info.ni_buffer[head] = *buf++;
+  if (tail != ni->ni_tail)
+    {
+      ni->ni_tail = tail;
+      SP_DMB();
+    }
 
-      head = next;
-      notelen--;
+  for (i = 0; i < notelen; i++)
+    {
+      NOTERAM_BYTE(ni, head + i) = buf[i];
     }
 
-  g_noteram_info.ni_head = head;
+  /* Then publish the note */
+
+  SP_DMB();
+  ni->ni_head = head + notelen;
 
-#ifdef CONFIG_SMP
-  spin_unlock_wo_note(&g_noteram_lock);
-#endif
   up_irq_restore(flags);
 }
 
@@ -40,6 +40,7 @@
 #ifdef CONFIG_DEBUG_FEATURES
 #  include <nuttx/arch.h>
 #endif
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
@@ -63,6 +64,21 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+/* In SPSC mode each index is written by only one side and read by the
+ * other without any lock.  On a uniprocessor a context switch orders all
+ * memory accesses, so only the compiler must be kept from moving ring data
+ * accesses across the index update that publishes (or releases) them.
+ */
+
+#  define PIPE_NDX(n)           (*(FAR volatile pipe_ndx_t *)&(n))
+#  ifdef __GNUC__
+#    define pipe_barrier()      __asm__ __volatile__("" ::: "memory")
+#  else
+#    define pipe_barrier()
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -114,6 +130,388 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem'.  The check is done in a critical
+ *   section so that it cannot race with pipecommon_spsc_wait().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+  irqstate_t flags;
+  int sval;
+
+  flags = enter_critical_section();
+  while (nxsem_get_value(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: pipecommon_spsc_notify
+ *
+ * Description:
+ *   Report a ring state transition to the other side: wake the thread
+ *   blocked on 'sem' and notify poll waiters.  The device semaphore is
+ *   only needed to protect the poll slot array.
+ *
+ ****************************************************************************/
+
+static void pipecommon_spsc_notify(FAR struct pipe_dev_s *dev,
+                                   FAR sem_t *sem, pollevent_t eventset)
+{
+  pipecommon_wakeup(sem);
+
+  if (pipecommon_semtake(&dev->d_bfsem) >= 0)
+    {
+      pipecommon_pollnotify(dev, eventset);
+      nxsem_post(&dev->d_bfsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_spsc_read
+ *
+ * Description:
+ *   Lock-free read used when only one thread reads and one thread writes
+ *   the pipe.  Only the reader updates d_rdndx and only the writer updates
+ *   d_wrndx.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spsc_read(FAR struct file *filep,
+                                    FAR struct pipe_dev_s *dev,
+                                    FAR char *buffer, size_t len)
+{
+  pipe_ndx_t rdndx = dev->d_rdndx;
+  pipe_ndx_t oldndx = rdndx;
+  pipe_ndx_t wrndx;
+  irqstate_t flags;
+  size_t nread = 0;
+  size_t chunk;
+  int ret;
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  while ((wrndx = PIPE_NDX(dev->d_wrndx)) == rdndx)
+    {
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0)
+        {
+          return 0;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* Re-check and wait in a critical section so that the writer cannot
+       * make the empty->non-empty transition unnoticed.
+       */
+
+      ret = OK;
+      flags = enter_critical_section();
+      if (PIPE_NDX(dev->d_wrndx) == rdndx && dev->d_nwriters > 0)
+        {
+          ret = nxsem_wait(&dev->d_rdsem);
+        }
+
+      leave_critical_section(flags);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Don't access the data before the index that published it */
+
+  pipe_barrier();
+
+  while (nread < len && rdndx != wrndx)
+    {
+      chunk = (wrndx > rdndx ? wrndx : dev->d_bufsize) - rdndx;
+      if (chunk > len - nread)
+        {
+          chunk = len - nread;
+        }
+
+      memcpy(buffer + nread, &dev->d_buffer[rdndx], chunk);
+      nread += chunk;
+      rdndx += chunk;
+      if (rdndx >= dev->d_bufsize)
+        {
+          rdndx = 0;
+        }
+    }
+
+  /* Release the space to the writer, then check if it may have seen the
+   * buffer full.  That is the only case where a wake-up is needed.
+   */
+
+  pipe_barrier();
+  PIPE_NDX(dev->d_rdndx) = rdndx;
+  pipe_barrier();
+
+  wrndx = PIPE_NDX(dev->d_wrndx) + 1;
+  if (wrndx >= dev->d_bufsize)
+    {
+      wrndx = 0;
+    }
+
+  if (wrndx == oldndx)
+    {
+      pipecommon_spsc_notify(dev, &dev->d_wrsem, POLLOUT);
+    }
+
+  pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)buffer, nread);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spsc_write
+ *
+ * Description:
+ *   Lock-free write counterpart of pipecommon_spsc_read().
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spsc_write(FAR struct file *filep,
+                                     FAR struct pipe_dev_s *dev,
+                                     FAR const char *buffer, size_t len)
+{
+  pipe_ndx_t wrndx = dev->d_wrndx;
+  pipe_ndx_t oldndx;
+  pipe_ndx_t nxtndx;
+  pipe_ndx_t rdndx;
+  irqstate_t flags;
+  size_t nwritten = 0;
+  size_t chunk;
+  int ret;
+
+  while (nwritten < len)
+    {
+      /* The buffer is full when the next write index reaches the read
+       * index.
+       */
+
+      nxtndx = wrndx + 1;
+      if (nxtndx >= dev->d_bufsize)
+        {
+          nxtndx = 0;
+        }
+
+      rdndx = PIPE_NDX(dev->d_rdndx);
+      if (nxtndx == rdndx)
+        {
+          /* If O_NONBLOCK was set, then return partial bytes written or
+           * EGAIN.
+           */
+
+          if (filep->f_oflags & O_NONBLOCK)
+            {
+              return nwritten > 0 ? (ssize_t)nwritten : -EAGAIN;
+            }
+
+          ret = OK;
+          flags = enter_critical_section();
+          if (PIPE_NDX(dev->d_rdndx) == nxtndx && dev->d_nreaders > 0)
+            {
+              ret = nxsem_wait(&dev->d_wrsem);
+            }
+
+          leave_critical_section(flags);
+          if (ret < 0)
+            {
+              return nwritten > 0 ? (ssize_t)nwritten : (ssize_t)ret;
+            }
+
+          if (dev->d_nreaders <= 0)
+            {
+              return nwritten > 0 ? (ssize_t)nwritten : -EPIPE;
+            }
+
+          continue;
+        }
+
+      /* Don't overwrite data before the reader released it */
+
+      pipe_barrier();
+
+      /* Fill the free space, leaving one byte to tell full from empty */
+
+      oldndx = wrndx;
+      while (nwritten < len && nxtndx != rdndx)
+        {
+          if (wrndx >= rdndx)
+            {
+              chunk = dev->d_bufsize - wrndx - (rdndx == 0 ? 1 : 0);
+            }
+          else
+            {
+              chunk = rdndx - wrndx - 1;
+            }
+
+          if (chunk > len - nwritten)
+            {
+              chunk = len - nwritten;
+            }
+
+          memcpy(&dev->d_buffer[wrndx], buffer + nwritten, chunk);
+          nwritten += chunk;
+          wrndx += chunk;
+          if (wrndx >= dev->d_bufsize)
+            {
+              wrndx = 0;
+            }
+
+          nxtndx = wrndx + 1;
+          if (nxtndx >= dev->d_bufsize)
+            {
+              nxtndx = 0;
+            }
+        }
+
+      /* Publish the data, then check if the reader may have seen the
+       * buffer empty.
+       */
+
+      pipe_barrier();
+      PIPE_NDX(dev->d_wrndx) = wrndx;
+      pipe_barrier();
+
+      if (PIPE_NDX(dev->d_rdndx) == oldndx)
+        {
+          pipecommon_spsc_notify(dev, &dev->d_rdsem, POLLIN);
+        }
+    }
+
+  return nwritten;
+}
+#endif /* CONFIG_DEV_PIPE_SPSC */
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+/****************************************************************************
+ * Name: pipecommon_wakeall
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem' and report 'eventset' to the
+ *   poll waiters.  Must be called with the device semaphore held.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeall(FAR struct pipe_dev_s *dev, FAR sem_t *sem,
+                               pollevent_t eventset)
+{
+  int sval;
+
+  while (nxsem_get_value(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+
+  pipecommon_pollnotify(dev, eventset);
+}
+
+/****************************************************************************
+ * Name: pipecommon_nbytes and pipecommon_nfree
+ *
+ * Description:
+ *   Return the number of bytes in the ring and the room left in it.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  return dev->d_wrndx >= dev->d_rdndx ?
+         dev->d_wrndx - dev->d_rdndx :
+         dev->d_bufsize - dev->d_rdndx + dev->d_wrndx;
+}
+
+static size_t pipecommon_nfree(FAR struct pipe_dev_s *dev)
+{
+  return dev->d_bufsize - 1 - pipecommon_nbytes(dev);
+}
+
+/****************************************************************************
+ * Name: pipecommon_splicewait
+ *
+ * Description:
+ *   Drop the device semaphore, wait on 'sem' for the other side to make
+ *   progress and take the device semaphore again.  Returns a negated errno
+ *   value with the device semaphore released on failure.
+ *
+ ****************************************************************************/
+
+static int pipecommon_splicewait(FAR struct pipe_dev_s *dev, FAR sem_t *sem)
+{
+  int ret;
+
+  sched_lock();
+  nxsem_post(&dev->d_bfsem);
+  ret = nxsem_wait(sem);
+  sched_unlock();
+
+  if (ret >= 0)
+    {
+      ret = nxsem_wait(&dev->d_bfsem);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_lock2 and pipecommon_unlock2
+ *
+ * Description:
+ *   Take the device semaphores of two pipes, always in the same order so
+ *   that concurrent transfers in opposite directions cannot deadlock.
+ *
+ ****************************************************************************/
+
+static int pipecommon_lock2(FAR struct pipe_dev_s *dev1,
+                            FAR struct pipe_dev_s *dev2)
+{
+  int ret;
+
+  if (dev1 > dev2)
+    {
+      FAR struct pipe_dev_s *tmp = dev1;
+      dev1 = dev2;
+      dev2 = tmp;
+    }
+
+  ret = nxsem_wait(&dev1->d_bfsem);
+  if (ret >= 0)
+    {
+      ret = nxsem_wait(&dev2->d_bfsem);
+      if (ret < 0)
+        {
+          nxsem_post(&dev1->d_bfsem);
+        }
+    }
+
+  return ret;
+}
+
+static void pipecommon_unlock2(FAR struct pipe_dev_s *dev1,
+                               FAR struct pipe_dev_s *dev2)
+{
+  nxsem_post(&dev1->d_bfsem);
+  nxsem_post(&dev2->d_bfsem);
+}
+#endif /* CONFIG_DEV_PIPE_SPLICE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -409,6 +807,13 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return 0;
     }
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+  if (PIPE_IS_SPSC(dev->d_flags))
+    {
+      return pipecommon_spsc_read(filep, dev, buffer, len);
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   ret = nxsem_wait(&dev->d_bfsem);
@@ -543,6 +948,13 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   DEBUGASSERT(up_interrupt_context() == false);
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+  if (PIPE_IS_SPSC(dev->d_flags))
+    {
+      return pipecommon_spsc_write(filep, dev, buffer, len);
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   ret = nxsem_wait(&dev->d_bfsem);
@@ -834,6 +1246,23 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+      case PIPEIOC_SPSC:
+        {
+          if (arg != 0)
+            {
+              dev->d_flags |= PIPE_FLAG_SPSC;
+            }
+          else
+            {
+              dev->d_flags &= ~PIPE_FLAG_SPSC;
+            }
+
+          ret = OK;
+        }
+        break;
+#endif
+
       case FIONWRITE:  /* Number of bytes waiting in send queue */
       case FIONREAD:   /* Number of bytes available for reading */
         {
@@ -932,4 +1361,384 @@ int pipecommon_unlink(FAR struct inode *inode)
 }
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_splice_read
+ *
+ * Description:
+ *   Remove up to 'len' bytes from the pipe and hand them to 'sink' directly
+ *   from the pipe buffer, one contiguous segment at a time.  Waits for data
+ *   as read() does.  The pipe stays locked while 'sink' runs, so 'sink'
+ *   must not block.
+ *
+ * Returned Value:
+ *   The number of bytes consumed by 'sink', zero at end of file or a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+ssize_t pipecommon_splice_read(FAR struct file *filep,
+                               pipe_splicecb_t sink, FAR void *arg,
+                               size_t len, bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  ssize_t nread = 0;
+  ssize_t ret;
+  size_t n;
+
+  DEBUGASSERT(dev);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (PIPE_IS_SPSC(dev->d_flags))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  while (dev->d_wrndx == dev->d_rdndx)
+    {
+      if (dev->d_nwriters <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      if (nonblock || (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      ret = pipecommon_splicewait(dev, &dev->d_rdsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Pass the data on in at most two segments: up to the end of the buffer
+   * and then from its beginning.
+   */
+
+  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
+    {
+      n = (dev->d_wrndx > dev->d_rdndx ? dev->d_wrndx : dev->d_bufsize) -
+          dev->d_rdndx;
+      if (n > len - nread)
+        {
+          n = len - nread;
+        }
+
+      ret = sink(arg, &dev->d_buffer[dev->d_rdndx], n);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("From PIPE:", &dev->d_buffer[dev->d_rdndx], ret);
+      dev->d_rdndx += ret;
+      if (dev->d_rdndx >= dev->d_bufsize)
+        {
+          dev->d_rdndx = 0;
+        }
+
+      nread += ret;
+      if ((size_t)ret < n)
+        {
+          break;
+        }
+    }
+
+  /* Notify all waiting writers that bytes have been removed */
+
+  if (nread > 0)
+    {
+      pipecommon_wakeall(dev, &dev->d_wrsem, POLLOUT);
+    }
+
+  nxsem_post(&dev->d_bfsem);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_write
+ *
+ * Description:
+ *   Let 'source' fill up to 'len' bytes of free space directly in the pipe
+ *   buffer, one contiguous segment at a time.  Waits for free space as
+ *   write() does.  The pipe stays locked while 'source' runs, so 'source'
+ *   must not block.
+ *
+ * Returned Value:
+ *   The number of bytes added to the pipe, zero if 'source' is at end of
+ *   file or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice_write(FAR struct file *filep,
+                                pipe_splicecb_t source, FAR void *arg,
+                                size_t len, bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  ssize_t nwritten = 0;
+  ssize_t ret;
+  size_t n;
+
+  DEBUGASSERT(dev);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (dev->d_nreaders <= 0)
+    {
+      return -EPIPE;
+    }
+
+  if (PIPE_IS_SPSC(dev->d_flags))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* If the pipe is full, wait for data to be removed from it */
+
+  while (pipecommon_nfree(dev) == 0)
+    {
+      if (nonblock || (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      ret = pipecommon_splicewait(dev, &dev->d_wrsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Fill the free space in at most two segments.  One byte always stays
+   * free so that a full buffer can be told from an empty one.
+   */
+
+  while ((size_t)nwritten < len && pipecommon_nfree(dev) > 0)
+    {
+      if (dev->d_rdndx > dev->d_wrndx)
+        {
+          n = dev->d_rdndx - 1 - dev->d_wrndx;
+        }
+      else if (dev->d_rdndx == 0)
+        {
+          n = dev->d_bufsize - 1 - dev->d_wrndx;
+        }
+      else
+        {
+          n = dev->d_bufsize - dev->d_wrndx;
+        }
+
+      if (n > len - nwritten)
+        {
+          n = len - nwritten;
+        }
+
+      ret = source(arg, &dev->d_buffer[dev->d_wrndx], n);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("To PIPE:", &dev->d_buffer[dev->d_wrndx], ret);
+      dev->d_wrndx += ret;
+      if (dev->d_wrndx >= dev->d_bufsize)
+        {
+          dev->d_wrndx = 0;
+        }
+
+      nwritten += ret;
+      if ((size_t)ret < n)
+        {
+          break;
+        }
+    }
+
+  /* Notify all waiting readers that more data is available */
+
+  if (nwritten > 0)
+    {
+      pipecommon_wakeall(dev, &dev->d_rdsem, POLLIN);
+    }
+
+  nxsem_post(&dev->d_bfsem);
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_pipe
+ *
+ * Description:
+ *   Copy up to 'len' bytes from the buffer of one pipe directly to the
+ *   buffer of another.  If 'consume' is true the bytes are removed from
+ *   the input pipe (splice()); otherwise they are left there (tee()).
+ *   Waits until the input pipe has data and the output pipe has room,
+ *   unless 'nonblock' is set.
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero at end of file on the input pipe or a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice_pipe(FAR struct file *infile,
+                               FAR struct file *outfile,
+                               size_t len, bool nonblock, bool consume)
+{
+  FAR struct pipe_dev_s *indev  = infile->f_inode->i_private;
+  FAR struct pipe_dev_s *outdev = outfile->f_inode->i_private;
+  pipe_ndx_t rdndx;
+  size_t n;
+  size_t i;
+  int ret;
+
+  DEBUGASSERT(indev && outdev);
+
+  if (indev == outdev || PIPE_IS_SPSC(indev->d_flags) ||
+      PIPE_IS_SPSC(outdev->d_flags))
+    {
+      return -EINVAL;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  nonblock |= (infile->f_oflags & O_NONBLOCK) != 0 ||
+              (outfile->f_oflags & O_NONBLOCK) != 0;
+
+  ret = pipecommon_lock2(indev, outdev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait until there is something to copy and somewhere to put it.  Both
+   * pipes are unlocked while waiting.
+   */
+
+  for (; ; )
+    {
+      FAR struct pipe_dev_s *dev;
+      FAR sem_t *sem;
+
+      if (outdev->d_nreaders <= 0)
+        {
+          ret = -EPIPE;
+          goto errout;
+        }
+
+      if (indev->d_wrndx == indev->d_rdndx)
+        {
+          if (indev->d_nwriters <= 0)
+            {
+              ret = 0;
+              goto errout;
+            }
+
+          dev = indev;
+          sem = &indev->d_rdsem;
+        }
+      else if (pipecommon_nfree(outdev) == 0)
+        {
+          dev = outdev;
+          sem = &outdev->d_wrsem;
+        }
+      else
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      /* Keep the lock ordering: only the pipe being waited on is held at
+       * the time of the wait.
+       */
+
+      nxsem_post(dev == indev ? &outdev->d_bfsem : &indev->d_bfsem);
+      ret = pipecommon_splicewait(dev, sem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxsem_post(&dev->d_bfsem);
+      ret = pipecommon_lock2(indev, outdev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  n = pipecommon_nbytes(indev);
+  if (n > pipecommon_nfree(outdev))
+    {
+      n = pipecommon_nfree(outdev);
+    }
+
+  if (n > len)
+    {
+      n = len;
+    }
+
+  rdndx = indev->d_rdndx;
+  for (i = 0; i < n; i++)
+    {
+      outdev->d_buffer[outdev->d_wrndx] = indev->d_buffer[rdndx];
+      if (++outdev->d_wrndx >= outdev->d_bufsize)
+        {
+          outdev->d_wrndx = 0;
+        }
+
+      if (++rdndx >= indev->d_bufsize)
+        {
+          rdndx = 0;
+        }
+    }
+
+  if (consume)
+    {
+      indev->d_rdndx = rdndx;
+      pipecommon_wakeall(indev, &indev->d_wrsem, POLLOUT);
+    }
+
+  pipecommon_wakeall(outdev, &outdev->d_rdsem, POLLIN);
+  ret = n;
+
+errout:
+  pipecommon_unlock2(indev, outdev);
+  return ret;
+}
+#endif /* CONFIG_DEV_PIPE_SPLICE */
+
 #endif /* CONFIG_PIPES */
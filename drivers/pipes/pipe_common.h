@@ -98,6 +98,7 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPSC      (1 << 2) /* Bit 2: Lock-free SPSC transfers */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -107,6 +108,12 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+#  define PIPE_IS_SPSC(f)   (((f) & PIPE_FLAG_SPSC) != 0)
+#else
+#  define PIPE_IS_SPSC(f)   (false)
+#endif
+
 
 /****************************************************************************
  * Public Types
@@ -122,6 +129,19 @@ typedef uint16_t pipe_ndx_t;  /* 16-bit index */
 typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 #endif
 
+/* splice() moves data between a pipe buffer and another file through one
+ * of these.  It is given a contiguous segment of the pipe buffer to either
+ * consume (pipe to file) or fill (file to pipe) and returns the number of
+ * bytes it consumed or filled, zero at end of file or a negated errno
+ * value.  It is called with the pipe locked and so must not block: it
+ * returns -EAGAIN instead and the caller waits with the pipe unlocked.
+ */
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+typedef CODE ssize_t (*pipe_splicecb_t)(FAR void *arg, FAR uint8_t *buf,
+                                        size_t len);
+#endif
+
 /* This structure represents the state of one pipe.  A reference to this
  * structure is retained in the i_private field of the inode whenthe pipe/fifo
  * device is registered.
@@ -176,6 +196,17 @@ int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 int     pipecommon_unlink(FAR struct inode *priv);
 #endif
+#ifdef CONFIG_DEV_PIPE_SPLICE
+ssize_t pipecommon_splice_read(FAR struct file *filep,
+                               pipe_splicecb_t sink, FAR void *arg,
+                               size_t len, bool nonblock);
+ssize_t pipecommon_splice_write(FAR struct file *filep,
+                                pipe_splicecb_t source, FAR void *arg,
+                                size_t len, bool nonblock);
+ssize_t pipecommon_splice_pipe(FAR struct file *infile,
+                               FAR struct file *outfile,
+                               size_t len, bool nonblock, bool consume);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -0,0 +1,425 @@
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "pipe_common.h"
+
+#if defined(CONFIG_PIPES) && defined(CONFIG_DEV_PIPE_SPLICE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The end of a splice() transfer that is not a pipe */
+
+struct splice_end_s
+{
+  FAR struct file   *filep;   /* File, if not a socket */
+#ifdef CONFIG_NET
+  FAR struct socket *psock;   /* Socket, if not a file */
+#endif
+  FAR off_t         *offset;  /* Explicit file offset or NULL */
+  int                fd;      /* The descriptor, for poll() */
+  bool               busy;    /* The last access would have blocked */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_ispipe
+ *
+ * Description:
+ *   Return true if the file is one end of a pipe or FIFO.  Pipes and FIFOs
+ *   are told apart from other drivers by their read method.
+ *
+ ****************************************************************************/
+
+static bool splice_ispipe(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  return inode != NULL && INODE_IS_DRIVER(inode) &&
+         inode->u.i_ops != NULL && inode->u.i_ops->read == pipecommon_read;
+}
+
+/****************************************************************************
+ * Name: splice_getend
+ *
+ * Description:
+ *   Resolve a file or socket descriptor.
+ *
+ ****************************************************************************/
+
+static int splice_getend(int fd, FAR off_t *offset,
+                         FAR struct splice_end_s *end)
+{
+  memset(end, 0, sizeof(*end));
+  end->offset = offset;
+  end->fd     = fd;
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      return fs_getfilep(fd, &end->filep);
+    }
+
+#ifdef CONFIG_NET
+  end->psock = sockfd_socket(fd);
+  if (end->psock != NULL)
+    {
+      /* Sockets cannot seek */
+
+      return offset != NULL ? -ESPIPE : OK;
+    }
+#endif
+
+  return -EBADF;
+}
+
+/****************************************************************************
+ * Name: splice_ready
+ *
+ * Description:
+ *   Return true if a file can be accessed without blocking.  Sockets are
+ *   always accessed with MSG_DONTWAIT instead.
+ *
+ ****************************************************************************/
+
+static bool splice_ready(FAR struct splice_end_s *end, pollevent_t events)
+{
+  struct pollfd fds;
+
+  if (end->filep == NULL)
+    {
+      return true;
+    }
+
+  fds.fd      = end->fd;
+  fds.events  = events;
+  fds.revents = 0;
+
+  return nx_poll(&fds, 1, 0) != 0;
+}
+
+/****************************************************************************
+ * Name: splice_wait
+ *
+ * Description:
+ *   Wait, with no pipe locked, until the file or socket can be accessed.
+ *
+ ****************************************************************************/
+
+static int splice_wait(FAR struct splice_end_s *end, pollevent_t events)
+{
+  struct pollfd fds;
+  int ret;
+
+  fds.fd      = end->fd;
+  fds.events  = events;
+  fds.revents = 0;
+
+  ret = nx_poll(&fds, 1, -1);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: splice_sink
+ *
+ * Description:
+ *   Pass a segment of the pipe buffer on to the output file or socket.
+ *   Returns -EAGAIN rather than block, since the pipe is locked.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_sink(FAR void *arg, FAR uint8_t *buf, size_t len)
+{
+  FAR struct splice_end_s *end = arg;
+  ssize_t ret;
+
+  if (!splice_ready(end, POLLOUT))
+    {
+      ret = -EAGAIN;
+    }
+#ifdef CONFIG_NET
+  else if (end->psock != NULL)
+    {
+      ret = psock_send(end->psock, buf, len, MSG_DONTWAIT);
+    }
+#endif
+  else if (end->offset != NULL)
+    {
+      ret = file_pwrite(end->filep, buf, len, *end->offset);
+      if (ret > 0)
+        {
+          *end->offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_write(end->filep, buf, len);
+    }
+
+  end->busy = ret == -EAGAIN;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: splice_source
+ *
+ * Description:
+ *   Fill a segment of the pipe buffer from the input file or socket.
+ *   Returns -EAGAIN rather than block, since the pipe is locked.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_source(FAR void *arg, FAR uint8_t *buf, size_t len)
+{
+  FAR struct splice_end_s *end = arg;
+  ssize_t ret;
+
+  if (!splice_ready(end, POLLIN))
+    {
+      ret = -EAGAIN;
+    }
+#ifdef CONFIG_NET
+  else if (end->psock != NULL)
+    {
+      ret = psock_recv(end->psock, buf, len, MSG_DONTWAIT);
+    }
+#endif
+  else if (end->offset != NULL)
+    {
+      ret = file_pread(end->filep, buf, len, *end->offset);
+      if (ret > 0)
+        {
+          *end->offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_read(end->filep, buf, len);
+    }
+
+  end->busy = ret == -EAGAIN;
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves up to 'len' bytes between two descriptors, at least one
+ *   of which must be a pipe, without copying them through user space.  The
+ *   data is written to the output straight from the pipe buffer, or read
+ *   from the input straight into it.  Between two pipes it is copied from
+ *   one buffer to the other.  The other end may be a file or a socket.
+ *
+ *   NOTE: This interface is *not* specified in POSIX.  It follows the Linux
+ *   splice() interface.
+ *
+ * Input Parameters:
+ *   fd_in   - The input descriptor
+ *   off_in  - The input file offset, or NULL to use and update the file
+ *             position.  Must be NULL for pipes and sockets.
+ *   fd_out  - The output descriptor
+ *   off_out - The output file offset, as for 'off_in'
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK: don't block on the pipe(s).  SPLICE_F_MORE
+ *             and SPLICE_F_MOVE are accepted and ignored.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of input or -1 with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  struct splice_end_s in;
+  struct splice_end_s out;
+  bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+  ssize_t ret;
+
+  ret = splice_getend(fd_in, off_in, &in);
+  if (ret >= 0)
+    {
+      ret = splice_getend(fd_out, off_out, &out);
+    }
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (in.filep != NULL && splice_ispipe(in.filep))
+    {
+      if (in.offset != NULL)
+        {
+          ret = -ESPIPE;
+        }
+      else if (out.filep != NULL && splice_ispipe(out.filep))
+        {
+          ret = out.offset != NULL ? -ESPIPE :
+                pipecommon_splice_pipe(in.filep, out.filep, len,
+                                       nonblock, true);
+        }
+      else
+        {
+          /* The pipe is locked while the output is accessed, so the
+           * output is never allowed to block.  If it is not ready, wait
+           * for it here with the pipe unlocked and try again.
+           */
+
+          for (; ; )
+            {
+              ret = pipecommon_splice_read(in.filep, splice_sink, &out,
+                                           len, nonblock);
+              if (ret != -EAGAIN || !out.busy || nonblock)
+                {
+                  break;
+                }
+
+              ret = splice_wait(&out, POLLOUT);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+        }
+    }
+  else if (out.filep != NULL && splice_ispipe(out.filep))
+    {
+      if (out.offset != NULL)
+        {
+          ret = -ESPIPE;
+        }
+      else
+        {
+          /* Likewise for the input */
+
+          for (; ; )
+            {
+              ret = pipecommon_splice_write(out.filep, splice_source, &in,
+                                            len, nonblock);
+              if (ret != -EAGAIN || !in.busy || nonblock)
+                {
+                  break;
+                }
+
+              ret = splice_wait(&in, POLLIN);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+        }
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  if (ret >= 0)
+    {
+      return ret;
+    }
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() copies up to 'len' bytes from the pipe 'fd_in' to the pipe
+ *   'fd_out' without consuming them, so that they can still be read or
+ *   spliced from 'fd_in'.
+ *
+ * Input Parameters:
+ *   fd_in   - The input pipe
+ *   fd_out  - The output pipe
+ *   len     - The maximum number of bytes to copy
+ *   flags   - As for splice()
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero at end of input or -1 with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret >= 0)
+    {
+      ret = fs_getfilep(fd_out, &outfile);
+    }
+
+  if (ret >= 0)
+    {
+      if (!splice_ispipe(infile) || !splice_ispipe(outfile))
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          ret = pipecommon_splice_pipe(infile, outfile, len,
+                                       (flags & SPLICE_F_NONBLOCK) != 0,
+                                       false);
+        }
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_PIPES && CONFIG_DEV_PIPE_SPLICE */
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * drivers/power/idle_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/power/pm.h>
+
+#include "idle_governor.h"
+#include "pm.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void            idle_governor_initialize(void);
+static enum pm_state_e idle_governor_checkstate(int domain);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pm_governor_s g_idle_governor_ops =
+{
+  .initialize   = idle_governor_initialize,   /* initialize */
+  .statechanged = NULL,                       /* statechanged */
+  .checkstate   = idle_governor_checkstate,   /* checkstate */
+  .activity     = NULL,                       /* activity */
+};
+
+/* The shortest predicted idle time, in microseconds, for which each state
+ * is worth entering.
+ */
+
+static const uint32_t g_idle_latency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_IDLE_IDLE_LATENCY,
+  CONFIG_PM_GOVERNOR_IDLE_STANDBY_LATENCY,
+  CONFIG_PM_GOVERNOR_IDLE_SLEEP_LATENCY
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: idle_governor_initialize
+ ****************************************************************************/
+
+static void idle_governor_initialize(void)
+{
+}
+
+/****************************************************************************
+ * Name: idle_governor_checkstate
+ *
+ * Description:
+ *   Suggest the deepest state whose latency fits before the next timer
+ *   event, without going below the first state held by pm_stay().
+ *
+ ****************************************************************************/
+
+static enum pm_state_e idle_governor_checkstate(int domain)
+{
+  FAR struct pm_domain_s *pdom;
+  struct timespec ts;
+  irqstate_t flags;
+  uint32_t idle;
+  int state;
+
+  pdom  = &g_pmglobals.domain[domain];
+  state = PM_NORMAL;
+
+  /* Without a pending timer event, only an interrupt ends the idle time */
+
+  idle = UINT32_MAX;
+  if (nxsched_timer_remaining(&ts) >= 0 &&
+      ts.tv_sec < UINT32_MAX / USEC_PER_SEC)
+    {
+      idle = ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+    }
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = enter_critical_section();
+
+  while (!pdom->stay[state] && state < (PM_COUNT - 1) &&
+         g_idle_latency[state + 1] <= idle)
+    {
+      state++;
+    }
+
+  leave_critical_section(flags);
+  return state;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_idle_governor_initialize
+ *
+ * Description:
+ *   Return the idle duration governor instance.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_idle_governor_initialize(void)
+{
+  return &g_idle_governor_ops;
+}
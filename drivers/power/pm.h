@@ -94,6 +94,13 @@ struct pm_domain_s
   /* The power state lock count */
 
   uint16_t stay[PM_COUNT];
+
+#ifdef CONFIG_PM_RESIDENCY
+  /* The time of the last state change and the time spent in each state */
+
+  struct timespec since;
+  struct pm_residency_s residency[PM_COUNT];
+#endif
 };
 
 /* This structure encapsulates all of the global data used by the PM system */
@@ -42,9 +42,11 @@
 
 #include <queue.h>
 #include <assert.h>
+#include <errno.h>
 #include <stdlib.h>
 
 #include <nuttx/power/pm.h>
+#include <nuttx/clock.h>
 #include <nuttx/irq.h>
 
 #include "pm.h"
@@ -184,6 +186,35 @@ static inline void pm_changeall(int domain, enum pm_state_e newstate)
     }
 }
 
+/****************************************************************************
+ * Name: pm_account
+ *
+ * Description:
+ *   Charge the time since the last state change to the current state of
+ *   the domain and start timing 'newstate'.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_RESIDENCY
+static void pm_account(FAR struct pm_domain_s *pdom,
+                       enum pm_state_e newstate)
+{
+  FAR struct pm_residency_s *res = &pdom->residency[pdom->state];
+  struct timespec now;
+  struct timespec delta;
+
+  clock_systime_timespec(&now);
+  clock_timespec_subtract(&now, &pdom->since, &delta);
+  clock_timespec_add(&res->time, &delta, &res->time);
+  pdom->since = now;
+
+  pdom->residency[newstate].entries++;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -253,6 +284,13 @@ int pm_changestate(int domain, enum pm_state_e newstate)
   pm_changeall(domain, newstate);
   if (newstate != PM_RESTORE)
     {
+#ifdef CONFIG_PM_RESIDENCY
+      if (newstate != g_pmglobals.domain[domain].state)
+        {
+          pm_account(&g_pmglobals.domain[domain], newstate);
+        }
+#endif
+
       g_pmglobals.domain[domain].state = newstate;
     }
 
@@ -288,4 +326,42 @@ enum pm_state_e pm_querystate(int domain)
   return g_pmglobals.domain[domain].state;
 }
 
+/****************************************************************************
+ * Name: pm_residency
+ *
+ * Description:
+ *   Return how often and for how long a domain has been in a power state.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_RESIDENCY
+int pm_residency(int domain, enum pm_state_e state,
+                 FAR struct pm_residency_s *res)
+{
+  FAR struct pm_domain_s *pdom;
+  struct timespec now;
+  irqstate_t flags;
+
+  if (domain < 0 || domain >= CONFIG_PM_NDOMAINS ||
+      state < PM_NORMAL || state >= PM_COUNT)
+    {
+      return -EINVAL;
+    }
+
+  pdom  = &g_pmglobals.domain[domain];
+  flags = enter_critical_section();
+
+  *res = pdom->residency[state];
+  if (pdom->state == state)
+    {
+      clock_systime_timespec(&now);
+      clock_timespec_subtract(&now, &pdom->since, &now);
+      clock_timespec_add(&res->time, &now, &res->time);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_PM */
@@ -24,11 +24,16 @@
 
 #include <nuttx/config.h>
 
+#include <sys/stat.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include <fcntl.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/procfs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/rptun/openamp.h>
@@ -48,10 +53,33 @@
 #  define ALIGN_UP(s, a)        (((s) + (a) - 1) & ~((a) - 1))
 #endif
 
+#ifndef CONFIG_RPTUN_NOTIFY_BATCH
+#  define CONFIG_RPTUN_NOTIFY_BATCH 1
+#endif
+
+#if defined(CONFIG_RPTUN_PROCFS) && \
+    (!defined(CONFIG_FS_PROCFS) || !defined(CONFIG_FS_PROCFS_REGISTER))
+#  undef CONFIG_RPTUN_PROCFS
+#endif
+
+#define RPTUN_PROCFS_BUFSIZE    512
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* Doorbell and latency statistics of one remote, see /proc/rptun */
+
+struct rptun_stats_s
+{
+  uint32_t rx_irqs;          /* Doorbells received from the remote */
+  uint32_t rx_rounds;        /* Passes over the vrings by rptun_thread */
+  uint32_t tx_kicks;         /* Notifications requested by the vrings */
+  uint32_t tx_irqs;          /* Doorbells raised to the remote */
+  uint32_t lat_max;          /* Max doorbell to processing latency, us */
+  uint64_t lat_total;        /* Sum of the latencies, us */
+};
+
 struct rptun_priv_s
 {
   FAR struct rptun_dev_s       *dev;
@@ -61,6 +89,10 @@ struct rptun_priv_s
   struct metal_list            bind;
   struct metal_list            node;
   int                          pid;
+  unsigned int                 kick_pending; /* Deferred doorbells */
+  bool                         rx_pending;   /* Doorbell not yet served */
+  struct timespec              rx_time;      /* When it arrived */
+  struct rptun_stats_s         stats;
 };
 
 struct rptun_bind_s
@@ -85,6 +117,15 @@ struct rptun_store_s
   FAR char   *buf;
 };
 
+#ifdef CONFIG_RPTUN_PROCFS
+struct rptun_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  size_t               linesize;     /* Number of valid characters */
+  char                 line[RPTUN_PROCFS_BUFSIZE];
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -124,6 +165,18 @@ static metal_phys_addr_t rptun_pa_to_da(FAR struct rptun_dev_s *dev,
 static metal_phys_addr_t rptun_da_to_pa(FAR struct rptun_dev_s *dev,
                                         metal_phys_addr_t da);
 
+#ifdef CONFIG_RPTUN_PROCFS
+static int rptun_procfs_open(FAR struct file *filep,
+                             FAR const char *relpath, int oflags,
+                             mode_t mode);
+static int rptun_procfs_close(FAR struct file *filep);
+static ssize_t rptun_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen);
+static int rptun_procfs_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int rptun_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -154,6 +207,29 @@ static struct image_store_ops g_rptun_storeops =
 
 static sem_t g_rptun_sem = SEM_INITIALIZER(1);
 
+#ifdef CONFIG_RPTUN_PROCFS
+static const struct procfs_operations g_rptun_procfsops =
+{
+  rptun_procfs_open,  /* open */
+  rptun_procfs_close, /* close */
+  rptun_procfs_read,  /* read */
+  NULL,               /* write */
+  rptun_procfs_dup,   /* dup */
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+  rptun_procfs_stat   /* stat */
+};
+
+static const struct procfs_entry_s g_rptun_procfs =
+{
+  "rptun", &g_rptun_procfsops, PROCFS_FILE_TYPE
+};
+
+static bool g_rptun_procfs_registered;
+#endif
+
 static METAL_DECLARE_LIST(g_rptun_cb);
 static METAL_DECLARE_LIST(g_rptun_priv);
 
@@ -161,6 +237,55 @@ static METAL_DECLARE_LIST(g_rptun_priv);
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rptun_update_latency
+ *
+ * Description:
+ *   Account the time from the doorbell to rptun_thread serving it.
+ *
+ ****************************************************************************/
+
+static void rptun_update_latency(FAR struct rptun_priv_s *priv)
+{
+  struct timespec now;
+  uint32_t us;
+
+  if (!priv->rx_pending)
+    {
+      return;
+    }
+
+  priv->rx_pending = false;
+  clock_systime_timespec(&now);
+
+  us = (now.tv_sec - priv->rx_time.tv_sec) * USEC_PER_SEC +
+       (now.tv_nsec - priv->rx_time.tv_nsec) / NSEC_PER_USEC;
+
+  priv->stats.lat_total += us;
+  if (us > priv->stats.lat_max)
+    {
+      priv->stats.lat_max = us;
+    }
+}
+
+/****************************************************************************
+ * Name: rptun_flush_kick
+ *
+ * Description:
+ *   Raise the doorbell deferred by rptun_notify(), if any.
+ *
+ ****************************************************************************/
+
+static void rptun_flush_kick(FAR struct rptun_priv_s *priv)
+{
+  if (priv->kick_pending > 0)
+    {
+      priv->kick_pending = 0;
+      priv->stats.tx_irqs++;
+      RPTUN_NOTIFY(priv->dev, RPTUN_NOTIFY_ALL);
+    }
+}
+
 static int rptun_thread(int argc, FAR char *argv[])
 {
   FAR struct rptun_priv_s *priv;
@@ -178,7 +303,16 @@ static int rptun_thread(int argc, FAR char *argv[])
       ret = nxsig_timedwait(&set, NULL, NULL);
       if (ret == SIGUSR1)
         {
+          rptun_update_latency(priv);
+          priv->stats.rx_rounds++;
+
+          /* Notifications raised while the vrings are served, mostly
+           * returned RX buffers and responses sent from the endpoint
+           * callbacks, are coalesced into one doorbell at the end.
+           */
+
           remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+          rptun_flush_kick(priv);
         }
     }
 
@@ -189,6 +323,18 @@ static int rptun_callback(FAR void *arg, uint32_t vqid)
 {
   FAR struct rptun_priv_s *priv = arg;
 
+  priv->stats.rx_irqs++;
+
+  /* Several doorbells before the thread runs are served by one pass, so
+   * only the first one is timed.
+   */
+
+  if (!priv->rx_pending)
+    {
+      clock_systime_timespec(&priv->rx_time);
+      priv->rx_pending = true;
+    }
+
   return nxsig_kill(priv->pid, SIGUSR1);
 }
 
@@ -296,6 +442,21 @@ static int rptun_notify(FAR struct remoteproc *rproc, uint32_t id)
 {
   FAR struct rptun_priv_s *priv = rproc->priv;
 
+  priv->stats.tx_kicks++;
+
+  /* In rptun_thread, defer the doorbell to the end of the pass, but not
+   * for more than CONFIG_RPTUN_NOTIFY_BATCH notifications: a sender that
+   * waits for TX buffers must not hold back the kick that returns them.
+   */
+
+  if (getpid() == priv->pid &&
+      ++priv->kick_pending < CONFIG_RPTUN_NOTIFY_BATCH)
+    {
+      return 0;
+    }
+
+  priv->kick_pending = 0;
+  priv->stats.tx_irqs++;
   RPTUN_NOTIFY(priv->dev, RPTUN_NOTIFY_ALL);
 
   return 0;
@@ -690,6 +851,135 @@ static metal_phys_addr_t rptun_da_to_pa(FAR struct rptun_dev_s *dev,
   return da;
 }
 
+#ifdef CONFIG_RPTUN_PROCFS
+static int rptun_procfs_open(FAR struct file *filep,
+                             FAR const char *relpath, int oflags,
+                             mode_t mode)
+{
+  FAR struct rptun_file_s *attr;
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  if (strcmp(relpath, "rptun") != 0)
+    {
+      return -ENOENT;
+    }
+
+  attr = kmm_zalloc(sizeof(struct rptun_file_s));
+  if (!attr)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = attr;
+  return OK;
+}
+
+static int rptun_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+static ssize_t rptun_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen)
+{
+  FAR struct rptun_file_s *attr = filep->f_priv;
+  FAR struct metal_list *node;
+  FAR struct rptun_priv_s *priv;
+  off_t offset;
+  ssize_t ret;
+
+  /* Take a snapshot on the first read, so that the output stays
+   * consistent when it is read in pieces.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      attr->linesize = snprintf(attr->line, RPTUN_PROCFS_BUFSIZE,
+                                "%-8s %10s %10s %10s %10s %8s %8s\n",
+                                "CPU", "RXIRQ", "RXROUND", "TXKICK",
+                                "TXIRQ", "LATAVG", "LATMAX");
+
+      nxsem_wait_uninterruptible(&g_rptun_sem);
+
+      metal_list_for_each(&g_rptun_priv, node)
+        {
+          FAR struct rptun_stats_s *st;
+          uint32_t avg;
+
+          if (attr->linesize >= RPTUN_PROCFS_BUFSIZE)
+            {
+              break;
+            }
+
+          priv = metal_container_of(node, struct rptun_priv_s, node);
+          st   = &priv->stats;
+          avg  = st->rx_rounds ? st->lat_total / st->rx_rounds : 0;
+
+          attr->linesize +=
+            snprintf(attr->line + attr->linesize,
+                     RPTUN_PROCFS_BUFSIZE - attr->linesize,
+                     "%-8s %10lu %10lu %10lu %10lu %8lu %8lu\n",
+                     RPTUN_GET_CPUNAME(priv->dev),
+                     (unsigned long)st->rx_irqs,
+                     (unsigned long)st->rx_rounds,
+                     (unsigned long)st->tx_kicks,
+                     (unsigned long)st->tx_irqs, (unsigned long)avg,
+                     (unsigned long)st->lat_max);
+        }
+
+      nxsem_post(&g_rptun_sem);
+
+      if (attr->linesize > RPTUN_PROCFS_BUFSIZE - 1)
+        {
+          attr->linesize = RPTUN_PROCFS_BUFSIZE - 1;
+        }
+    }
+
+  offset = filep->f_pos;
+  ret = procfs_memcpy(attr->line, attr->linesize, buffer, buflen, &offset);
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+static int rptun_procfs_dup(FAR const struct file *oldp,
+                            FAR struct file *newp)
+{
+  FAR struct rptun_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct rptun_file_s));
+  if (!newattr)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct rptun_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+static int rptun_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  if (strcmp(relpath, "rptun") != 0)
+    {
+      return -ENOENT;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif /* CONFIG_RPTUN_PROCFS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -833,6 +1123,16 @@ int rptun_initialize(FAR struct rptun_dev_s *dev)
   priv->pid = ret;
   priv->dev = dev;
 
+#ifdef CONFIG_RPTUN_PROCFS
+  nxsem_wait_uninterruptible(&g_rptun_sem);
+  if (!g_rptun_procfs_registered)
+    {
+      g_rptun_procfs_registered = procfs_register(&g_rptun_procfs) >= 0;
+    }
+
+  nxsem_post(&g_rptun_sem);
+#endif
+
   metal_list_init(&priv->bind);
   remoteproc_init(&priv->rproc, &g_rptun_ops, priv);
 
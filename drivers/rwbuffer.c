@@ -35,6 +35,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/dma.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/drivers/rwbuffer.h>
@@ -143,6 +144,98 @@ static inline void rwb_resetwrbuffer(FAR struct rwbuffer_s *rwb)
 
   rwb->wrnblocks    = 0;
   rwb->wrblockstart = -1;
+#ifdef CONFIG_DRVR_WRCOALESCE
+  rwb->wrnunits     = 0;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrfind
+ *
+ * Description:
+ *   Find the buffer slot holding 'unit'.  The position of the unit in the
+ *   sorted order (or where it would be inserted) is returned in 'pos'.
+ *
+ * Returned Value:
+ *   The slot index or -1 if the unit is not in the write buffer.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRCOALESCE
+static int rwb_wrfind(FAR struct rwbuffer_s *rwb, off_t unit, FAR int *pos)
+{
+  int low  = 0;
+  int high = rwb->wrnunits;
+  int mid;
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (rwb->wrunit[rwb->wrorder[mid]] < unit)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  *pos = low;
+  if (low < rwb->wrnunits && rwb->wrunit[rwb->wrorder[low]] == unit)
+    {
+      return rwb->wrorder[low];
+    }
+
+  return -1;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrremove
+ *
+ * Description:
+ *   Discard the unit at position 'pos' of the sorted order.  The last slot
+ *   is moved into the freed slot so that the used slots stay contiguous.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_WRCOALESCE) && defined(CONFIG_DRVR_INVALIDATE)
+static void rwb_wrremove(FAR struct rwbuffer_s *rwb, int pos)
+{
+  size_t unitsize = rwb->wralignblocks * rwb->blocksize;
+  uint16_t slot   = rwb->wrorder[pos];
+  uint16_t last   = rwb->wrnunits - 1;
+  int i;
+
+  memmove(&rwb->wrorder[pos], &rwb->wrorder[pos + 1],
+          (last - pos) * sizeof(uint16_t));
+
+  if (slot != last)
+    {
+      memcpy(rwb->wrbuffer + slot * unitsize,
+             rwb->wrbuffer + last * unitsize, unitsize);
+      rwb->wrunit[slot] = rwb->wrunit[last];
+
+      for (i = 0; i < last; i++)
+        {
+          if (rwb->wrorder[i] == last)
+            {
+              rwb->wrorder[i] = slot;
+              break;
+            }
+        }
+    }
+
+  rwb->wrnunits--;
+  rwb->wrnblocks -= rwb->wralignblocks;
 }
 #endif
 
@@ -154,7 +247,85 @@ static inline void rwb_resetwrbuffer(FAR struct rwbuffer_s *rwb)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_DRVR_WRITEBUFFER
+#ifdef CONFIG_DRVR_WRCOALESCE
+static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
+{
+  FAR uint8_t *buffer = rwb->wrbuffer;
+  size_t unitsize = rwb->wralignblocks * rwb->blocksize;
+  size_t nblocks;
+  uint16_t first;
+  uint16_t i;
+  uint16_t j;
+  uint16_t k;
+  off_t unit;
+  int ret;
+
+  if (rwb->wrnunits == 0)
+    {
+      return;
+    }
+
+  /* Put the slots in ascending unit order so that each run of consecutive
+   * units is contiguous in the buffer.  The permutation is applied in place
+   * one cycle at a time, using wrtemp to hold the first slot of the cycle.
+   */
+
+  for (i = 0; i < rwb->wrnunits; i++)
+    {
+      if (rwb->wrorder[i] == i)
+        {
+          continue;
+        }
+
+      memcpy(rwb->wrtemp, buffer + i * unitsize, unitsize);
+      unit = rwb->wrunit[i];
+
+      for (j = i; (k = rwb->wrorder[j]) != i; j = k)
+        {
+          memcpy(buffer + j * unitsize, buffer + k * unitsize, unitsize);
+          rwb->wrunit[j]  = rwb->wrunit[k];
+          rwb->wrorder[j] = j;
+        }
+
+      memcpy(buffer + j * unitsize, rwb->wrtemp, unitsize);
+      rwb->wrunit[j]  = unit;
+      rwb->wrorder[j] = j;
+    }
+
+  /* Then write each run of consecutive units with a single transfer */
+
+  for (first = 0; first < rwb->wrnunits; first = i)
+    {
+      i = first + 1;
+      while (i < rwb->wrnunits && rwb->wrunit[i] == rwb->wrunit[i - 1] + 1)
+        {
+          i++;
+        }
+
+      nblocks = (i - first) * rwb->wralignblocks;
+
+      finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
+            (long)(rwb->wrunit[first] * rwb->wralignblocks), (int)nblocks,
+            buffer + first * unitsize);
+
+      ret = rwb->wrflush(rwb->dev, buffer + first * unitsize,
+                         rwb->wrunit[first] * rwb->wralignblocks, nblocks);
+      if (ret != nblocks)
+        {
+          ferr("ERROR: Error flushing write buffer: %d\n", ret);
+        }
+
+      rwb->wrnflushes++;
+      rwb->wrnflushed += nblocks;
+    }
+
+  finfo("Written: %lu merged: %lu flushed: %lu in %lu transfers\n",
+        (unsigned long)rwb->wrnwritten, (unsigned long)rwb->wrnmerged,
+        (unsigned long)rwb->wrnflushed, (unsigned long)rwb->wrnflushes);
+
+  rwb_resetwrbuffer(rwb);
+}
+#elif defined(CONFIG_DRVR_WRITEBUFFER)
 static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
 {
   int ret;
@@ -250,9 +421,106 @@ static inline void rwb_wrcanceltimeout(FAR struct rwbuffer_s *rwb)
 
 /****************************************************************************
  * Name: rwb_writebuffer
+ *
+ * Description:
+ *   Add blocks to the coalescing write buffer.  A unit that is not yet
+ *   buffered is inserted in sorted order; a unit that is already buffered
+ *   is simply updated in place.  If there is no free slot, the buffer is
+ *   flushed first.
+ *
  ****************************************************************************/
 
-#ifdef CONFIG_DRVR_WRITEBUFFER
+#ifdef CONFIG_DRVR_WRCOALESCE
+static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
+                               off_t startblock, uint32_t nblocks,
+                               FAR const uint8_t *wrbuffer)
+{
+  size_t unitsize = rwb->wralignblocks * rwb->blocksize;
+  uint32_t nwritten = nblocks;
+  FAR uint8_t *dest;
+  size_t offset;
+  size_t ncopy;
+  off_t unit;
+  ssize_t ret;
+  int slot;
+  int pos;
+
+  rwb_wrcanceltimeout(rwb);
+
+  /* Transfers larger than the write buffer go directly to the media.  The
+   * buffer is flushed first so that older buffered data cannot later
+   * overwrite the new data.
+   */
+
+  if (nblocks > rwb->wrmaxblocks)
+    {
+      rwb_wrflush(rwb);
+
+      ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+      return ret < 0 ? ret : nwritten;
+    }
+
+  while (nblocks > 0)
+    {
+      unit   = startblock / rwb->wralignblocks;
+      offset = startblock - unit * rwb->wralignblocks;
+      ncopy  = rwb->wralignblocks - offset;
+      if (ncopy > nblocks)
+        {
+          ncopy = nblocks;
+        }
+
+      slot = rwb_wrfind(rwb, unit, &pos);
+      if (slot >= 0)
+        {
+          rwb->wrnmerged += ncopy;
+        }
+      else
+        {
+          if (rwb->wrnunits >= rwb->wrmaxunits)
+            {
+              rwb_wrflush(rwb);
+              pos = 0;
+            }
+
+          slot = rwb->wrnunits;
+
+          /* A partially written unit must first be filled from the media */
+
+          if (ncopy < rwb->wralignblocks)
+            {
+              ret = rwb_read_(rwb, unit * rwb->wralignblocks,
+                              rwb->wralignblocks,
+                              rwb->wrbuffer + slot * unitsize);
+              if (ret < 0)
+                {
+                  ferr("ERROR: Failed to fill write buffer: %d\n", (int)ret);
+                  return ret;
+                }
+            }
+
+          memmove(&rwb->wrorder[pos + 1], &rwb->wrorder[pos],
+                  (rwb->wrnunits - pos) * sizeof(uint16_t));
+
+          rwb->wrorder[pos]  = slot;
+          rwb->wrunit[slot]  = unit;
+          rwb->wrnunits++;
+          rwb->wrnblocks    += rwb->wralignblocks;
+        }
+
+      dest = rwb->wrbuffer + slot * unitsize + offset * rwb->blocksize;
+      memcpy(dest, wrbuffer, ncopy * rwb->blocksize);
+
+      rwb->wrnwritten += ncopy;
+      startblock      += ncopy;
+      wrbuffer        += ncopy * rwb->blocksize;
+      nblocks         -= ncopy;
+    }
+
+  rwb_wrstarttimeout(rwb);
+  return nwritten;
+}
+#elif defined(CONFIG_DRVR_WRITEBUFFER)
 static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
@@ -522,7 +790,82 @@ static int rwb_rhreload(FAR struct rwbuffer_s *rwb, off_t startblock)
  *
  ****************************************************************************/
 
-#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
+#if defined(CONFIG_DRVR_WRCOALESCE) && defined(CONFIG_DRVR_INVALIDATE)
+int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
+                               off_t startblock, size_t blockcount)
+{
+  size_t unitsize = rwb->wralignblocks * rwb->blocksize;
+  off_t invend = startblock + blockcount;
+  off_t unitstart;
+  off_t first;
+  off_t last;
+  int ret = OK;
+  int slot;
+  int pos;
+
+  /* Is there a write buffer?  Is data saved in the write buffer? */
+
+  if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
+    {
+      finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
+
+      ret = rwb_semtake(&rwb->wrsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Visit each buffered unit that overlaps the invalidated region */
+
+      rwb_wrfind(rwb, startblock / rwb->wralignblocks, &pos);
+      while (pos < rwb->wrnunits)
+        {
+          slot      = rwb->wrorder[pos];
+          unitstart = rwb->wrunit[slot] * rwb->wralignblocks;
+          if (unitstart >= invend)
+            {
+              break;
+            }
+
+          /* Discard units that are wholly invalidated */
+
+          if (unitstart >= startblock &&
+              unitstart + rwb->wralignblocks <= invend)
+            {
+              rwb_wrremove(rwb, pos);
+              continue;
+            }
+
+          /* The rest of a partially invalidated unit is kept, so the
+           * invalidated blocks are reloaded from the media.
+           */
+
+          first = startblock > unitstart ? startblock : unitstart;
+          last  = unitstart + rwb->wralignblocks;
+          if (last > invend)
+            {
+              last = invend;
+            }
+
+          ret = rwb->rhreload(rwb->dev, rwb->wrbuffer + slot * unitsize +
+                              (first - unitstart) * rwb->blocksize,
+                              first, last - first);
+          if (ret < 0)
+            {
+              ferr("ERROR: rhreload failed: %d\n", ret);
+              break;
+            }
+
+          ret = OK;
+          pos++;
+        }
+
+      rwb_semgive(&rwb->wrsem);
+    }
+
+  return ret;
+}
+#elif defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
 int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
@@ -799,6 +1142,11 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
   DEBUGASSERT(rwb->wrflush != NULL);
   rwb->wrbuffer = NULL;
+#ifdef CONFIG_DRVR_WRCOALESCE
+  rwb->wrunit   = NULL;
+  rwb->wrorder  = NULL;
+  rwb->wrtemp   = NULL;
+#endif
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   DEBUGASSERT(rwb->rhreload != NULL);
@@ -826,17 +1174,44 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       rwb_resetwrbuffer(rwb);
 
-      /* Allocate the write buffer */
+      /* Allocate the write buffer.  It is handed directly to the driver's
+       * flush method, so it must be safe to use for DMA.
+       */
 
       allocsize     = rwb->wrmaxblocks * rwb->blocksize;
-      rwb->wrbuffer = kmm_malloc(allocsize);
+      rwb->wrbuffer = kmm_dma_alloc(allocsize);
       if (!rwb->wrbuffer)
         {
-          ferr("Write buffer kmm_malloc(%d) failed\n", allocsize);
+          ferr("Write buffer kmm_dma_alloc(%d) failed\n", allocsize);
           return -ENOMEM;
         }
 
       finfo("Write buffer size: %d bytes\n", allocsize);
+
+#ifdef CONFIG_DRVR_WRCOALESCE
+      /* Allocate the unit map, the sorted order and the sorting scratch
+       * buffer.
+       */
+
+      rwb->wrmaxunits = rwb->wrmaxblocks / rwb->wralignblocks;
+      rwb->wrnwritten = 0;
+      rwb->wrnmerged  = 0;
+      rwb->wrnflushes = 0;
+      rwb->wrnflushed = 0;
+
+      rwb->wrunit  = (FAR off_t *)
+        kmm_malloc(rwb->wrmaxunits * sizeof(off_t));
+      rwb->wrorder = (FAR uint16_t *)
+        kmm_malloc(rwb->wrmaxunits * sizeof(uint16_t));
+      rwb->wrtemp  = (FAR uint8_t *)
+        kmm_malloc(rwb->wralignblocks * rwb->blocksize);
+
+      if (!rwb->wrunit || !rwb->wrorder || !rwb->wrtemp)
+        {
+          ferr("Write buffer map kmm_malloc failed\n");
+          return -ENOMEM;
+        }
+#endif
     }
 #endif /* CONFIG_DRVR_WRITEBUFFER */
 
@@ -853,13 +1228,15 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       rwb_resetrhbuffer(rwb);
 
-      /* Allocate the read-ahead buffer */
+      /* Allocate the read-ahead buffer (filled by the driver's reload
+       * method, so it must be DMA-safe too).
+       */
 
       allocsize     = rwb->rhmaxblocks * rwb->blocksize;
-      rwb->rhbuffer = kmm_malloc(allocsize);
+      rwb->rhbuffer = kmm_dma_alloc(allocsize);
       if (!rwb->rhbuffer)
         {
-          ferr("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
+          ferr("Read-ahead buffer kmm_dma_alloc(%d) failed\n", allocsize);
           return -ENOMEM;
         }
 
@@ -884,8 +1261,25 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
       nxsem_destroy(&rwb->wrsem);
       if (rwb->wrbuffer)
         {
-          kmm_free(rwb->wrbuffer);
+          kmm_dma_free(rwb->wrbuffer);
+        }
+
+#ifdef CONFIG_DRVR_WRCOALESCE
+      if (rwb->wrunit)
+        {
+          kmm_free(rwb->wrunit);
+        }
+
+      if (rwb->wrorder)
+        {
+          kmm_free(rwb->wrorder);
+        }
+
+      if (rwb->wrtemp)
+        {
+          kmm_free(rwb->wrtemp);
         }
+#endif
     }
 #endif
 
@@ -895,7 +1289,7 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
       nxsem_destroy(&rwb->rhsem);
       if (rwb->rhbuffer)
         {
-          kmm_free(rwb->rhbuffer);
+          kmm_dma_free(rwb->rhbuffer);
         }
     }
 #endif
@@ -989,6 +1383,98 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: rwb_wrread
+ *
+ * Description:
+ *   Read blocks taking the most recent data from the coalescing write
+ *   buffer.  Runs of blocks that are not buffered are read with a single
+ *   call to rwb_read_().
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRCOALESCE
+static ssize_t rwb_wrread(FAR struct rwbuffer_s *rwb, off_t startblock,
+                          size_t nblocks, FAR uint8_t *rdbuffer)
+{
+  size_t unitsize = rwb->wralignblocks * rwb->blocksize;
+  FAR uint8_t *rdpending = rdbuffer;
+  off_t rdstart = startblock;
+  size_t remaining;
+  size_t offset;
+  size_t ncopy;
+  off_t unit;
+  off_t next;
+  ssize_t ret;
+  int slot;
+  int pos;
+
+  for (remaining = nblocks; remaining > 0; remaining -= ncopy)
+    {
+      unit   = startblock / rwb->wralignblocks;
+      offset = startblock - unit * rwb->wralignblocks;
+      ncopy  = rwb->wralignblocks - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      slot = rwb_wrfind(rwb, unit, &pos);
+      if (slot >= 0)
+        {
+          /* Read any unbuffered blocks that precede this unit */
+
+          if (startblock > rdstart)
+            {
+              ret = rwb_read_(rwb, rdstart, startblock - rdstart,
+                              rdpending);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          memcpy(rdbuffer, rwb->wrbuffer + slot * unitsize +
+                 offset * rwb->blocksize, ncopy * rwb->blocksize);
+
+          rdstart   = startblock + ncopy;
+          rdpending = rdbuffer + ncopy * rwb->blocksize;
+        }
+      else
+        {
+          /* Skip ahead to the next buffered unit */
+
+          ncopy = remaining;
+          if (pos < rwb->wrnunits)
+            {
+              next = rwb->wrunit[rwb->wrorder[pos]] * rwb->wralignblocks;
+              if (next - startblock < remaining)
+                {
+                  ncopy = next - startblock;
+                }
+            }
+        }
+
+      startblock += ncopy;
+      rdbuffer   += ncopy * rwb->blocksize;
+    }
+
+  if (startblock > rdstart)
+    {
+      ret = rwb_read_(rwb, rdstart, startblock - rdstart, rdpending);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return nblocks;
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_read
  ****************************************************************************/
@@ -1002,7 +1488,22 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
   finfo("startblock=%ld nblocks=%ld rdbuffer=%p\n",
         (long)startblock, (long)nblocks, rdbuffer);
 
-#ifdef CONFIG_DRVR_WRITEBUFFER
+#ifdef CONFIG_DRVR_WRCOALESCE
+  /* Any buffered blocks are more recent than the media */
+
+  if (rwb->wrmaxblocks > 0)
+    {
+      ret = nxsem_wait(&rwb->wrsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = rwb_wrread(rwb, startblock, nblocks, rdbuffer);
+      rwb_semgive(&rwb->wrsem);
+      return ret;
+    }
+#elif defined(CONFIG_DRVR_WRITEBUFFER)
   /* If the new read data overlaps any part of the write buffer, we
    * directly copy write buffer to read buffer. This boost performance.
    */
@@ -46,7 +46,9 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
 #include <nuttx/i2c/i2c_master.h>
 #include <nuttx/sensors/bmi160.h>
 
@@ -479,6 +481,26 @@ static uint16_t bmi160_getreg16(FAR struct bmi160_dev_s *priv,
   return regval;
 }
 
+/****************************************************************************
+ * Name: bmi160_async_done
+ *
+ * Description:
+ *   Completion callback of the queued register read.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_SENSORS_BMI160_I2C) && defined(CONFIG_SPI_ASYNC)
+static void bmi160_async_done(FAR struct spi_async_s *req, int result)
+{
+  if (result < 0)
+    {
+      snerr("SPI transfer failed: %d\n", result);
+    }
+
+  nxsem_post((FAR sem_t *)req->arg);
+}
+#endif
+
 /****************************************************************************
  * Name: bmi160_getregs
  *
@@ -512,6 +534,69 @@ static void bmi160_getregs(FAR struct bmi160_dev_s *priv, uint8_t regaddr,
       snerr("I2C_TRANSFER failed: %d\n", ret);
     }
 
+#elif defined(CONFIG_SPI_ASYNC)
+  struct spi_async_s req;
+  struct spi_sequence_s seq;
+  struct spi_trans_s trans[2];
+  uint8_t cmd = regaddr | 0x80;
+  sem_t done;
+  int ret;
+
+  /* Queue the command and the burst read as one sequence.  The bus is only
+   * held while the sequence runs, and drivers with chained DMA perform both
+   * segments without CPU involvement.
+   */
+
+  trans[0].deselect = false;
+#ifdef CONFIG_SPI_CMDDATA
+  trans[0].cmd      = false;
+#endif
+#ifdef CONFIG_SPI_HWFEATURES
+  trans[0].hwfeat   = 0;
+#endif
+  trans[0].delay    = 0;
+  trans[0].nwords   = 1;
+  trans[0].txbuffer = &cmd;
+  trans[0].rxbuffer = NULL;
+
+  trans[1]          = trans[0];
+  trans[1].nwords   = len;
+  trans[1].txbuffer = NULL;
+  trans[1].rxbuffer = regval;
+
+  seq.dev       = SPIDEV_ACCELEROMETER(0);
+  seq.mode      = SPIDEV_MODE3;
+  seq.nbits     = 8;
+  seq.ntrans    = 2;
+  seq.frequency = BMI160_SPI_MAXFREQUENCY;
+#ifdef CONFIG_SPI_CS_DELAY_CONTROL
+  seq.a         = 0;
+  seq.b         = 0;
+  seq.c         = 0;
+#endif
+  seq.trans     = trans;
+
+  nxsem_init(&done, 0, 0);
+  nxsem_set_protocol(&done, SEM_PRIO_NONE);
+
+  req.seq      = &seq;
+  req.callback = bmi160_async_done;
+  req.arg      = &done;
+
+  ret = spi_transfer_async(priv->spi, &req);
+  if (ret < 0)
+    {
+      snerr("spi_transfer_async failed: %d\n", ret);
+    }
+  else
+    {
+      /* The request lives on our stack:  Do not return before it is done */
+
+      nxsem_wait_uninterruptible(&done);
+    }
+
+  nxsem_destroy(&done);
+
 #else /* CONFIG_SENSORS_BMI160_SPI */
   /* If SPI bus is shared then lock and configure it */
 
@@ -0,0 +1,532 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sensors/ioctl.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One subscriber:  Created by each open() of the device */
+
+struct sensor_user_s
+{
+  dq_entry_t node;               /* Link in the upper half's list */
+  uint32_t tail;                 /* Sequence number of the next event */
+  uint32_t lost;                 /* Events overwritten before being read */
+  bool waiting;                  /* Blocked in read() */
+  sem_t waitsem;                 /* Wakes up read() */
+  FAR struct pollfd *fds;        /* The poll() waiter, if any */
+};
+
+/* The upper half state of one sensor */
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower;
+  size_t esize;                  /* Size of one event */
+  uint32_t nbuffer;              /* Capacity of the ring (events) */
+  uint32_t head;                 /* Sequence number of the next event */
+  FAR uint8_t *buffer;           /* The ring shared by all subscribers */
+  dq_queue_t users;              /* The subscribers */
+  sem_t exclsem;                 /* Protects everything above */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_sensor_fops =
+{
+  sensor_open,    /* open */
+  sensor_close,   /* close */
+  sensor_read,    /* read */
+  NULL,           /* write */
+  NULL,           /* seek */
+  sensor_ioctl,   /* ioctl */
+  sensor_poll     /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL          /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_notify
+ *
+ * Description:
+ *   Wake up a subscriber blocked in read() or poll().
+ *
+ ****************************************************************************/
+
+static void sensor_notify(FAR struct sensor_user_s *user)
+{
+  if (user->waiting)
+    {
+      user->waiting = false;
+      nxsem_post(&user->waitsem);
+    }
+
+  if (user->fds != NULL && (user->fds->events & POLLIN) != 0)
+    {
+      user->fds->revents |= POLLIN;
+      nxsem_post(user->fds->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: sensor_push_event
+ *
+ * Description:
+ *   Called by the lower half to publish events to all subscribers.
+ *
+ ****************************************************************************/
+
+static void sensor_push_event(FAR void *priv, FAR const void *data,
+                              size_t bytes)
+{
+  FAR struct sensor_upperhalf_s *upper = priv;
+  FAR const uint8_t *src = data;
+  FAR dq_entry_t *node;
+  uint32_t nevents = bytes / upper->esize;
+
+  if (nevents == 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&upper->exclsem);
+
+  /* Only the newest events are kept if more than fit were pushed */
+
+  if (nevents > upper->nbuffer)
+    {
+      src          += (nevents - upper->nbuffer) * upper->esize;
+      upper->head  += nevents - upper->nbuffer;
+      nevents       = upper->nbuffer;
+    }
+
+  while (nevents > 0)
+    {
+      uint32_t index = upper->head % upper->nbuffer;
+      uint32_t n = upper->nbuffer - index;
+
+      if (n > nevents)
+        {
+          n = nevents;
+        }
+
+      memcpy(&upper->buffer[index * upper->esize], src, n * upper->esize);
+      src         += n * upper->esize;
+      upper->head += n;
+      nevents     -= n;
+    }
+
+  for (node = dq_peek(&upper->users); node != NULL; node = dq_next(node))
+    {
+      sensor_notify((FAR struct sensor_user_s *)node);
+    }
+
+  nxsem_post(&upper->exclsem);
+}
+
+/****************************************************************************
+ * Name: sensor_open
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_user_s *user;
+  int ret;
+
+  user = (FAR struct sensor_user_s *)kmm_zalloc(sizeof(*user));
+  if (user == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&user->waitsem, 0, 0);
+  nxsem_set_protocol(&user->waitsem, SEM_PRIO_NONE);
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      goto errout_with_user;
+    }
+
+  /* The first subscriber starts the sensor */
+
+  if (dq_empty(&upper->users) && lower->ops->activate != NULL)
+    {
+      ret = lower->ops->activate(lower, true);
+      if (ret < 0)
+        {
+          nxsem_post(&upper->exclsem);
+          goto errout_with_user;
+        }
+    }
+
+  /* A new subscriber only sees the events published from now on */
+
+  user->tail = upper->head;
+  dq_addlast(&user->node, &upper->users);
+  filep->f_priv = user;
+
+  nxsem_post(&upper->exclsem);
+  return OK;
+
+errout_with_user:
+  nxsem_destroy(&user->waitsem);
+  kmm_free(user);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_user_s *user = filep->f_priv;
+
+  nxsem_wait_uninterruptible(&upper->exclsem);
+
+  dq_rem(&user->node, &upper->users);
+  if (dq_empty(&upper->users) && lower->ops->activate != NULL)
+    {
+      lower->ops->activate(lower, false);
+    }
+
+  nxsem_post(&upper->exclsem);
+
+  nxsem_destroy(&user->waitsem);
+  kmm_free(user);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Return as many of the subscriber's pending events as fit into the
+ *   buffer, waiting for one unless O_NONBLOCK is set.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  uint32_t nevents = buflen / upper->esize;
+  uint32_t navail;
+  ssize_t nread = 0;
+  int ret;
+
+  if (nevents == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (user->tail == upper->head)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxsem_post(&upper->exclsem);
+          return -EAGAIN;
+        }
+
+      user->waiting = true;
+      nxsem_post(&upper->exclsem);
+
+      ret = nxsem_wait(&user->waitsem);
+      nxsem_wait_uninterruptible(&upper->exclsem);
+      if (ret < 0)
+        {
+          user->waiting = false;
+          nxsem_post(&upper->exclsem);
+          return ret;
+        }
+    }
+
+  /* Skip what was overwritten since the last read */
+
+  navail = upper->head - user->tail;
+  if (navail > upper->nbuffer)
+    {
+      user->lost += navail - upper->nbuffer;
+      user->tail  = upper->head - upper->nbuffer;
+      navail      = upper->nbuffer;
+    }
+
+  if (nevents > navail)
+    {
+      nevents = navail;
+    }
+
+  while (nevents > 0)
+    {
+      uint32_t index = user->tail % upper->nbuffer;
+      uint32_t n = upper->nbuffer - index;
+
+      if (n > nevents)
+        {
+          n = nevents;
+        }
+
+      memcpy(&buffer[nread], &upper->buffer[index * upper->esize],
+             n * upper->esize);
+      nread      += n * upper->esize;
+      user->tail += n;
+      nevents    -= n;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      /* Arg: unsigned long* pointer, in microseconds */
+
+      case SNIOC_SET_INTERVAL:
+        ret = lower->ops->set_interval != NULL ?
+              lower->ops->set_interval(lower,
+                                       (FAR unsigned long *)(uintptr_t)arg) :
+              -ENOTSUP;
+        break;
+
+      /* Arg: uint32_t* pointer.  Events this subscriber lost so far */
+
+      case SNIOC_GET_OVERRUNS:
+        *(FAR uint32_t *)(uintptr_t)arg = user->lost;
+        break;
+
+      /* Arg: None.  Discard the pending events of this subscriber */
+
+      case SNIOC_FIFO_FLUSH:
+        user->tail = upper->head;
+        break;
+
+      default:
+        ret = lower->ops->control != NULL ?
+              lower->ops->control(lower, cmd, arg) : -ENOTTY;
+        break;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      if (user->fds != NULL)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          user->fds = fds;
+          fds->priv = user;
+
+          if (user->tail != upper->head)
+            {
+              sensor_notify(user);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      user->fds = NULL;
+      fds->priv = NULL;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_register
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower,
+                    FAR const char *path, size_t esize,
+                    unsigned int nbuffer)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL && path != NULL &&
+              esize > 0 && nbuffer > 0);
+
+  upper = (FAR struct sensor_upperhalf_s *)kmm_zalloc(sizeof(*upper));
+  if (upper == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->buffer = (FAR uint8_t *)kmm_malloc(esize * nbuffer);
+  if (upper->buffer == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_upper;
+    }
+
+  upper->lower   = lower;
+  upper->esize   = esize;
+  upper->nbuffer = nbuffer;
+  dq_init(&upper->users);
+  nxsem_init(&upper->exclsem, 0, 1);
+
+  lower->push_event = sensor_push_event;
+  lower->priv       = upper;
+
+  ret = register_driver(path, &g_sensor_fops, 0444, upper);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to register %s: %d\n", path, ret);
+      nxsem_destroy(&upper->exclsem);
+      kmm_free(upper->buffer);
+      goto errout_with_upper;
+    }
+
+  return OK;
+
+errout_with_upper:
+  lower->push_event = NULL;
+  lower->priv       = NULL;
+  kmm_free(upper);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_unregister
+ ****************************************************************************/
+
+void sensor_unregister(FAR struct sensor_lowerhalf_s *lower,
+                       FAR const char *path)
+{
+  FAR struct sensor_upperhalf_s *upper = lower->priv;
+
+  DEBUGASSERT(upper != NULL && dq_empty(&upper->users));
+
+  unregister_driver(path);
+
+  lower->push_event = NULL;
+  lower->priv       = NULL;
+
+  nxsem_destroy(&upper->exclsem);
+  kmm_free(upper->buffer);
+  kmm_free(upper);
+}
+
+#endif /* CONFIG_SENSORS_UPPER */
@@ -0,0 +1,466 @@
+/****************************************************************************
+ * drivers/sensors/sensor_fifo.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <poll.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/sensors/ioctl.h>
+#include <nuttx/sensors/sensor_fifo.h>
+
+#ifdef CONFIG_SENSORS_FIFO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_fifo_now
+ *
+ * Description:
+ *   Return the time since boot in microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t sensor_fifo_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_notify
+ *
+ * Description:
+ *   Wake up the blocked reader and all poll() waiters.
+ *
+ * Assumptions:
+ *   exclsem is held.
+ *
+ ****************************************************************************/
+
+static void sensor_fifo_notify(FAR struct sensor_fifo_s *fifo)
+{
+  int i;
+
+  if (fifo->waiting)
+    {
+      fifo->waiting = false;
+      nxsem_post(&fifo->waitsem);
+    }
+
+  for (i = 0; i < CONFIG_SENSORS_FIFO_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = fifo->fds[i];
+
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & POLLIN);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_worker
+ *
+ * Description:
+ *   Read the burst of samples signalled by the watermark interrupt, time
+ *   stamp them and append them to the ring.
+ *
+ *   The interrupt time is taken as the time of the last sample of the
+ *   burst.  The samples in between are spread evenly over the time since
+ *   the previous burst, which is exact for a constant output data rate.
+ *
+ ****************************************************************************/
+
+static void sensor_fifo_worker(FAR void *arg)
+{
+  FAR struct sensor_fifo_s *fifo = (FAR struct sensor_fifo_s *)arg;
+  uint64_t irqtime;
+  uint64_t period = 0;
+  uint64_t timestamp;
+  int nsamples;
+  int i;
+
+  nxsem_wait_uninterruptible(&fifo->exclsem);
+
+  irqtime  = fifo->irqtime;
+  nsamples = fifo->ops->drain(fifo, fifo->burst, fifo->maxburst);
+  if (nsamples <= 0)
+    {
+      if (nsamples < 0)
+        {
+          snerr("ERROR: Failed to read the FIFO: %d\n", nsamples);
+        }
+
+      nxsem_post(&fifo->exclsem);
+      return;
+    }
+
+  if (fifo->lasttime != 0 && irqtime > fifo->lasttime)
+    {
+      period = (irqtime - fifo->lasttime) / nsamples;
+    }
+
+  for (i = 0; i < nsamples; i++)
+    {
+      FAR uint8_t *rec = &fifo->buffer[fifo->head * fifo->recsize];
+      unsigned int next = fifo->head + 1;
+
+      if (next >= fifo->nrecords)
+        {
+          next = 0;
+        }
+
+      /* Keep the newest data if the reader does not keep up */
+
+      if (next == fifo->tail)
+        {
+          if (++fifo->tail >= fifo->nrecords)
+            {
+              fifo->tail = 0;
+            }
+
+          fifo->overruns++;
+        }
+
+      timestamp = period != 0 ? fifo->lasttime + (i + 1) * period : irqtime;
+
+      memcpy(rec, &timestamp, sizeof(uint64_t));
+      memcpy(rec + sizeof(uint64_t), &fifo->burst[i * fifo->samplesize],
+             fifo->samplesize);
+
+      fifo->head = next;
+    }
+
+  fifo->lasttime = irqtime;
+
+  sensor_fifo_notify(fifo);
+  nxsem_post(&fifo->exclsem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_fifo_initialize
+ ****************************************************************************/
+
+int sensor_fifo_initialize(FAR struct sensor_fifo_s *fifo,
+                           FAR const struct sensor_fifo_ops_s *ops,
+                           FAR void *priv, size_t samplesize,
+                           unsigned int nrecords, unsigned int maxburst)
+{
+  DEBUGASSERT(fifo != NULL && ops != NULL && ops->drain != NULL &&
+              ops->setwatermark != NULL && samplesize > 0 &&
+              nrecords > 0 && maxburst > 0);
+
+  memset(fifo, 0, sizeof(*fifo));
+
+  fifo->ops        = ops;
+  fifo->priv       = priv;
+  fifo->samplesize = samplesize;
+  fifo->recsize    = SENSOR_FIFO_RECSIZE(samplesize);
+  fifo->maxburst   = maxburst;
+
+  /* One record stays empty to tell a full ring from an empty one */
+
+  fifo->nrecords   = nrecords + 1;
+
+  fifo->buffer = (FAR uint8_t *)kmm_malloc(fifo->nrecords * fifo->recsize);
+  fifo->burst  = (FAR uint8_t *)kmm_malloc(maxburst * samplesize);
+  if (fifo->buffer == NULL || fifo->burst == NULL)
+    {
+      kmm_free(fifo->buffer);
+      kmm_free(fifo->burst);
+      return -ENOMEM;
+    }
+
+  nxsem_init(&fifo->exclsem, 0, 1);
+  nxsem_init(&fifo->waitsem, 0, 0);
+  nxsem_set_protocol(&fifo->waitsem, SEM_PRIO_NONE);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_uninitialize
+ ****************************************************************************/
+
+void sensor_fifo_uninitialize(FAR struct sensor_fifo_s *fifo)
+{
+  fifo->ops->setwatermark(fifo, 0);
+  work_cancel(HPWORK, &fifo->work);
+
+  kmm_free(fifo->buffer);
+  kmm_free(fifo->burst);
+  fifo->buffer = NULL;
+  fifo->burst  = NULL;
+
+  nxsem_destroy(&fifo->exclsem);
+  nxsem_destroy(&fifo->waitsem);
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_setwatermark
+ ****************************************************************************/
+
+int sensor_fifo_setwatermark(FAR struct sensor_fifo_s *fifo,
+                             unsigned int nsamples)
+{
+  int ret;
+
+  if (nsamples > fifo->maxburst)
+    {
+      nsamples = fifo->maxburst;
+    }
+
+  ret = nxsem_wait(&fifo->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fifo->ops->setwatermark(fifo, nsamples);
+  if (ret >= 0)
+    {
+      /* The sample period is measured again from the next burst */
+
+      fifo->watermark = nsamples;
+      fifo->lasttime  = 0;
+    }
+
+  nxsem_post(&fifo->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_interrupt
+ ****************************************************************************/
+
+void sensor_fifo_interrupt(FAR struct sensor_fifo_s *fifo)
+{
+  fifo->irqtime = sensor_fifo_now();
+  work_queue(HPWORK, &fifo->work, sensor_fifo_worker, fifo, 0);
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_read
+ ****************************************************************************/
+
+ssize_t sensor_fifo_read(FAR struct sensor_fifo_s *fifo, FAR char *buffer,
+                         size_t buflen, bool nonblock)
+{
+  size_t nread = 0;
+  int ret;
+
+  if (buflen < fifo->recsize)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&fifo->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (fifo->head == fifo->tail)
+    {
+      if (nonblock)
+        {
+          nxsem_post(&fifo->exclsem);
+          return -EAGAIN;
+        }
+
+      fifo->waiting = true;
+      nxsem_post(&fifo->exclsem);
+
+      ret = nxsem_wait(&fifo->waitsem);
+      nxsem_wait_uninterruptible(&fifo->exclsem);
+      if (ret < 0)
+        {
+          fifo->waiting = false;
+          nxsem_post(&fifo->exclsem);
+          return ret;
+        }
+    }
+
+  /* Copy whole records, at most up to the end of the ring at a time */
+
+  while (fifo->head != fifo->tail && buflen - nread >= fifo->recsize)
+    {
+      unsigned int end = fifo->head > fifo->tail ? fifo->head :
+                         fifo->nrecords;
+      unsigned int nrecs = end - fifo->tail;
+
+      if (nrecs > (buflen - nread) / fifo->recsize)
+        {
+          nrecs = (buflen - nread) / fifo->recsize;
+        }
+
+      memcpy(&buffer[nread], &fifo->buffer[fifo->tail * fifo->recsize],
+             nrecs * fifo->recsize);
+      nread += nrecs * fifo->recsize;
+
+      fifo->tail += nrecs;
+      if (fifo->tail >= fifo->nrecords)
+        {
+          fifo->tail = 0;
+        }
+    }
+
+  nxsem_post(&fifo->exclsem);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_poll
+ ****************************************************************************/
+
+int sensor_fifo_poll(FAR struct sensor_fifo_s *fifo, FAR struct pollfd *fds,
+                     bool setup)
+{
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&fifo->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_SENSORS_FIFO_NPOLLWAITERS; i++)
+        {
+          if (fifo->fds[i] == NULL)
+            {
+              fifo->fds[i] = fds;
+              fds->priv    = &fifo->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_SENSORS_FIFO_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (fifo->head != fifo->tail)
+        {
+          /* Data is already available */
+
+          sensor_fifo_notify(fifo);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxsem_post(&fifo->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_ioctl
+ ****************************************************************************/
+
+int sensor_fifo_ioctl(FAR struct sensor_fifo_s *fifo, int cmd,
+                      unsigned long arg)
+{
+  int ret = OK;
+
+  switch (cmd)
+    {
+      /* Arg: unsigned int value */
+
+      case SNIOC_SET_WATERMARK:
+        ret = sensor_fifo_setwatermark(fifo, (unsigned int)arg);
+        break;
+
+      /* Arg: unsigned int* pointer */
+
+      case SNIOC_GET_WATERMARK:
+        {
+          FAR unsigned int *ptr = (FAR unsigned int *)((uintptr_t)arg);
+
+          DEBUGASSERT(ptr != NULL);
+          *ptr = fifo->watermark;
+        }
+        break;
+
+      /* Arg: None */
+
+      case SNIOC_FIFO_FLUSH:
+        ret = nxsem_wait(&fifo->exclsem);
+        if (ret >= 0)
+          {
+            fifo->tail = fifo->head;
+            nxsem_post(&fifo->exclsem);
+          }
+        break;
+
+      /* Arg: uint32_t* pointer */
+
+      case SNIOC_GET_OVERRUNS:
+        {
+          FAR uint32_t *ptr = (FAR uint32_t *)((uintptr_t)arg);
+
+          DEBUGASSERT(ptr != NULL);
+          *ptr = fifo->overruns;
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_SENSORS_FIFO */
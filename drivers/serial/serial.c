@@ -140,6 +140,22 @@ static int uart_takesem(FAR sem_t *sem, bool errout)
 
 #define uart_givesem(sem) (void)nxsem_post(sem)
 
+/************************************************************************************
+ * Name: uart_rxcount
+ *
+ * Description:
+ *   Return the number of bytes buffered in the RX circular buffer.
+ *
+ ************************************************************************************/
+
+static inline int16_t uart_rxcount(FAR uart_dev_t *dev)
+{
+  int16_t head = dev->recv.head;
+  int16_t tail = dev->recv.tail;
+
+  return head >= tail ? head - tail : dev->recv.size - tail + head;
+}
+
 /************************************************************************************
  * Name: uart_pollnotify
  ************************************************************************************/
@@ -338,6 +354,119 @@ err_out:
   return ret;
 }
 
+/************************************************************************************
+ * Name: uart_rawoutput
+ *
+ * Description:
+ *   Return true if the characters written need no output processing and
+ *   may be copied to the TX buffer as they are.
+ *
+ ************************************************************************************/
+
+static inline bool uart_rawoutput(FAR uart_dev_t *dev)
+{
+#ifdef CONFIG_SERIAL_TERMIOS
+  return (dev->tc_oflag & OPOST) == 0 ||
+         (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) == 0;
+#else
+  return !dev->isconsole;
+#endif
+}
+
+/************************************************************************************
+ * Name: uart_rawinput
+ *
+ * Description:
+ *   Return true if the characters received need no input processing and
+ *   may be returned to the reader as they are.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_DIRECTIO
+static inline bool uart_rawinput(FAR uart_dev_t *dev)
+{
+#ifdef CONFIG_SERIAL_TERMIOS
+  return (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0;
+#else
+  return true;
+#endif
+}
+#endif
+
+/************************************************************************************
+ * Name: uart_copyxmit
+ *
+ * Description:
+ *   Copy as much of 'buffer' into the TX circular buffer as there is space
+ *   for, without waiting.
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero if the TX buffer is full.
+ *
+ ************************************************************************************/
+
+static size_t uart_copyxmit(FAR uart_dev_t *dev, FAR const char *buffer,
+                            size_t buflen)
+{
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  size_t ncopied = 0;
+  size_t nfree;
+  int16_t head;
+  int16_t tail;
+
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  /* Only this thread modifies the head index (we hold xmit.sem) */
+
+  head = txbuf->head;
+  tail = txbuf->tail;
+
+  /* The free space is at most two contiguous regions.  One slot always stays
+   * empty to tell a full buffer from an empty one.
+   */
+
+  while (ncopied < buflen)
+    {
+      if (head < tail)
+        {
+          nfree = tail - head - 1;
+        }
+      else
+        {
+          nfree = txbuf->size - head - (tail == 0 ? 1 : 0);
+        }
+
+      if (nfree == 0)
+        {
+          break;
+        }
+
+      if (nfree > buflen - ncopied)
+        {
+          nfree = buflen - ncopied;
+        }
+
+      memcpy(&txbuf->buffer[head], &buffer[ncopied], nfree);
+      ncopied += nfree;
+
+      head += nfree;
+      if (head >= txbuf->size)
+        {
+          head = 0;
+        }
+    }
+
+  txbuf->head = head;
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return ncopied;
+}
+
 /************************************************************************************
  * Name: uart_putc
  ************************************************************************************/
@@ -711,10 +840,43 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+  ssize_t minrecv = 1;
+#ifdef CONFIG_SERIAL_TERMIOS
+  clock_t timeout = 0;
+#endif
+  bool timedout = false;
   int16_t tail;
   char ch;
   int ret;
 
+#ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
+  minrecv = buflen;
+#endif
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  /* VMIN and VTIME select how long read() blocks (see termios(3)).  With both
+   * zero, the traditional behavior is kept:  Wait for at least one byte.
+   *
+   * VMIN > 0:  Return when VMIN bytes (at most buflen) were received.
+   * VTIME > 0: Return what was received when no more data arrives within
+   *            VTIME deciseconds.  If VMIN is also non-zero, the timer only
+   *            runs once the first byte was received.
+   */
+
+#ifndef CONFIG_DEV_SERIAL_FULLBLOCKS
+  if (dev->tc_vmin > 0)
+    {
+      minrecv = (size_t)dev->tc_vmin < buflen ?
+                (ssize_t)dev->tc_vmin : (ssize_t)buflen;
+    }
+#endif
+
+  if (dev->tc_vtime > 0)
+    {
+      timeout = DSEC2TICK(dev->tc_vtime);
+    }
+#endif
+
   /* Only one user can access rxbuf->tail at a time */
 
   ret = uart_takesem(&rxbuf->sem, true);
@@ -728,6 +890,27 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
       return ret;
     }
 
+#ifdef CONFIG_SERIAL_DIRECTIO
+  /* If nothing is buffered and we would simply wait for the first byte, let
+   * the lower half deliver the data straight into the caller's buffer.
+   */
+
+  if (dev->ops->directread != NULL && minrecv == 1 &&
+#ifdef CONFIG_SERIAL_TERMIOS
+      timeout == 0 &&
+#endif
+      (filep->f_oflags & O_NONBLOCK) == 0 &&
+      rxbuf->head == rxbuf->tail && uart_rawinput(dev))
+    {
+      recvd = dev->ops->directread(dev, buffer, buflen);
+      if (recvd != 0)
+        {
+          uart_givesem(&rxbuf->sem);
+          return recvd;
+        }
+    }
+#endif
+
   /* Loop while we still have data to copy to the receive buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
@@ -845,7 +1028,7 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        * to the caller?
        */
 
-      else if (recvd > 0)
+      else if (recvd >= minrecv || timedout)
         {
           /* Yes.. break out of the loop and return the number of bytes
            * received up to the wait condition.
@@ -861,9 +1044,15 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
       else if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
-          /* Break out of the loop returning -EAGAIN */
+          /* Break out of the loop returning -EAGAIN if nothing was
+           * transferred.
+           */
+
+          if (recvd < 1)
+            {
+              recvd = -EAGAIN;
+            }
 
-          recvd = -EAGAIN;
           break;
         }
 #endif
@@ -930,12 +1119,48 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                    * thread goes to sleep.
                    */
 
+                  ssize_t needed = minrecv - recvd;
+
+                  /* Do not wake up for every byte that is received.  The
+                   * threshold may never exceed what the buffer can hold.
+                   */
+
+                  if (needed >= rxbuf->size)
+                    {
+                      needed = rxbuf->size - 1;
+                    }
+
+                  dev->recvmin     = needed;
                   dev->recvwaiting = true;
-                  ret = uart_takesem(&dev->recvsem, true);
+
+#ifdef CONFIG_SERIAL_TERMIOS
+                  if (timeout > 0 && (recvd > 0 || dev->tc_vmin == 0))
+                    {
+                      ret = nxsem_tickwait(&dev->recvsem,
+                                           clock_systime_ticks(), timeout);
+                      if (ret == -ETIMEDOUT)
+                        {
+                          dev->recvwaiting = false;
+                          timedout = true;
+                          ret = OK;
+                        }
+                    }
+                  else
+#endif
+                    {
+                      ret = uart_takesem(&dev->recvsem, true);
+                    }
                 }
 
               leave_critical_section(flags);
 
+              /* VTIME expired:  Return what we have, possibly nothing */
+
+              if (timedout)
+                {
+                  break;
+                }
+
               /* Was a signal received while waiting for data to be
                * received?  Was a removable device disconnected while
                * we were waiting?
@@ -1114,12 +1339,58 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 
   oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
 
+#ifdef CONFIG_SERIAL_DIRECTIO
+  /* If nothing is waiting in the TX buffer, the lower half may send the
+   * caller's buffer as it is.
+   */
+
+  if (dev->ops->directwrite != NULL && oktoblock && uart_rawoutput(dev) &&
+      dev->xmit.head == dev->xmit.tail)
+    {
+      ret = dev->ops->directwrite(dev, buffer, buflen);
+      if (ret != 0)
+        {
+          uart_givesem(&dev->xmit.sem);
+          return ret;
+        }
+    }
+#endif
+
   /* Loop while we still have data to copy to the transmit buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
    */
 
   uart_disabletxint(dev);
+
+  /* Without output processing the data is copied in blocks.  We only go
+   * through uart_putxmitchar() for one byte when the TX buffer is full:  It
+   * knows how to wait for space.
+   */
+
+  while (buflen > 0 && uart_rawoutput(dev))
+    {
+      size_t ncopied = uart_copyxmit(dev, buffer, buflen);
+
+      if (ncopied == 0)
+        {
+          ret = uart_putxmitchar(dev, *buffer, oktoblock);
+          if (ret < 0)
+            {
+              /* See the comments in the loop below */
+
+              nwritten = buflen < (size_t)nwritten ?
+                         nwritten - (ssize_t)buflen : ret;
+              goto start_xmit;
+            }
+
+          ncopied = 1;
+        }
+
+      buffer += ncopied;
+      buflen -= ncopied;
+    }
+
   for (; buflen; buflen--)
     {
       ch  = *buffer++;
@@ -1207,6 +1478,7 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 
+start_xmit:
   if (dev->xmit.head != dev->xmit.tail)
     {
 #ifdef CONFIG_SERIAL_TXDMA
@@ -1319,6 +1591,29 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
             break;
 
+#ifdef CONFIG_SERIAL_ICOUNT
+          /* Get the RX/TX and error statistics */
+
+          case TIOCGICOUNT:
+            {
+              FAR struct serial_icounter_struct *icount =
+                (FAR struct serial_icounter_struct *)((uintptr_t)arg);
+              irqstate_t flags;
+
+              if (icount == NULL)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              flags = enter_critical_section();
+              *icount = dev->icount;
+              leave_critical_section(flags);
+              ret = 0;
+            }
+            break;
+#endif
+
 #ifdef CONFIG_SERIAL_TERMIOS
           case TCFLSH:
             {
@@ -1395,6 +1690,9 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               termiosp->c_iflag = dev->tc_iflag;
               termiosp->c_oflag = dev->tc_oflag;
               termiosp->c_lflag = dev->tc_lflag;
+
+              termiosp->c_cc[VMIN]  = dev->tc_vmin;
+              termiosp->c_cc[VTIME] = dev->tc_vtime;
             }
             break;
 
@@ -1413,6 +1711,9 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               dev->tc_iflag = termiosp->c_iflag;
               dev->tc_oflag = termiosp->c_oflag;
               dev->tc_lflag = termiosp->c_lflag;
+
+              dev->tc_vmin  = termiosp->c_cc[VMIN];
+              dev->tc_vtime = termiosp->c_cc[VTIME];
             }
             break;
         }
@@ -1630,9 +1931,9 @@ int uart_register(FAR const char *path, FAR uart_dev_t *dev)
 
 void uart_datareceived(FAR uart_dev_t *dev)
 {
-  /* Is there a thread waiting for read data?  */
+  /* Is there a thread waiting for read data and is there enough of it? */
 
-  if (dev->recvwaiting)
+  if (dev->recvwaiting && uart_rxcount(dev) >= dev->recvmin)
     {
       /* Yes... wake it up */
 
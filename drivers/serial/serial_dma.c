@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/serial/serial.h>
@@ -99,8 +100,9 @@ static int uart_check_signo(const char *buf, size_t size)
  * Name: uart_recvchars_signo
  *
  * Description:
- *   Check if the SIGINT character is anywhere in the newly received DMA
- *   buffer.
+ *   Check if the SIGINT character is anywhere in the bytes [from, to) of the
+ *   current RX DMA transfer.  Bytes already reported by an earlier
+ *   uart_recvchars_update() are not scanned again.
  *
  *   REVISIT:  We must also remove the SIGINT/SIGSTP character from the Rx
  *   buffer.  It should not be read as normal data by the caller.
@@ -109,29 +111,94 @@ static int uart_check_signo(const char *buf, size_t size)
 
 #if defined(CONFIG_SERIAL_RXDMA) && \
    (defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP))
-static int uart_recvchars_signo(FAR uart_dev_t *dev)
+static int uart_recvchars_signo(FAR uart_dev_t *dev, size_t from, size_t to)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
-  int signo;
+  int signo = 0;
 
-  /* Check if the valid DMAed data is in one or two contiguous regions */
+  /* The valid DMAed data may be in one or two contiguous regions */
 
-  if (xfer->nbytes <= xfer->length)
+  if (from < xfer->length)
     {
-      return uart_check_signo(xfer->buffer, xfer->nbytes);
+      signo = uart_check_signo(&xfer->buffer[from],
+                               (to < xfer->length ? to : xfer->length) -
+                               from);
     }
-  else
+
+  /* REVISIT:  Additional signals could be in the second region. */
+
+  if (signo == 0 && to > xfer->length)
     {
-      /* REVISIT:  Additional signals could be in the second region. */
+      from = from > xfer->length ? from - xfer->length : 0;
+      signo = uart_check_signo(&xfer->nbuffer[from],
+                               to - xfer->length - from);
+    }
 
-      signo = uart_check_signo(xfer->buffer, xfer->length);
-      if (signo != 0)
-        {
-          return signo;
-        }
+  return signo;
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_advance
+ *
+ * Description:
+ *   Move the RX circular buffer head over the bytes of the current DMA
+ *   transfer that were not reported to the upper half yet.
+ *
+ * Returned Value:
+ *   The number of bytes added to the RX circular buffer.
+ *
+ ****************************************************************************/
 
-      return uart_check_signo(xfer->nbuffer, xfer->nbytes - xfer->length);
+#ifdef CONFIG_SERIAL_RXDMA
+static size_t uart_recvchars_advance(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t nbytes;
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  int signo = 0;
+#endif
+
+  DEBUGASSERT(xfer->nbytes >= xfer->nreported);
+
+  nbytes = xfer->nbytes - xfer->nreported;
+  if (nbytes == 0)
+    {
+      return 0;
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  /* Check if the SIGINT character is anywhere in the newly received DMA
+   * data.
+   */
+
+  if (dev->pid >= 0 && (dev->tc_lflag & ISIG))
+    {
+      signo = uart_recvchars_signo(dev, xfer->nreported, xfer->nbytes);
     }
+#endif
+
+  /* Move head for nbytes. */
+
+  rxbuf->head     = (rxbuf->head + nbytes) % rxbuf->size;
+  xfer->nreported = xfer->nbytes;
+
+#ifdef CONFIG_SERIAL_ICOUNT
+  dev->icount.rx += nbytes;
+#endif
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      kill(dev->pid, signo);
+      uart_reset_sem(dev);
+    }
+#endif
+
+  return nbytes;
 }
 #endif
 
@@ -207,6 +274,10 @@ void uart_xmitchars_done(FAR uart_dev_t *dev)
       txbuf->tail  = (txbuf->tail + nbytes) % txbuf->size;
     }
 
+#ifdef CONFIG_SERIAL_ICOUNT
+  dev->icount.tx += nbytes;
+#endif
+
   /* Reset xmit buffer. */
 
   xfer->nbytes = 0;
@@ -349,6 +420,9 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
       xfer->nlength = 0;
     }
 
+  xfer->nbytes    = 0;
+  xfer->nreported = 0;
+
   uart_dmareceive(dev);
 }
 #endif
@@ -368,26 +442,13 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
 void uart_recvchars_done(FAR uart_dev_t *dev)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
-  FAR struct uart_buffer_s *rxbuf = &dev->recv;
-  size_t nbytes = xfer->nbytes;
-#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
-  int signo = 0;
+  size_t nbytes;
 
-  /* Check if the SIGINT character is anywhere in the newly received DMA
-   * buffer.
-   */
+  nbytes = uart_recvchars_advance(dev);
 
-  if (dev->pid >= 0 && (dev->tc_lflag & ISIG))
-    {
-      signo = uart_recvchars_signo(dev);
-    }
-#endif
-
-  /* Move head for nbytes. */
-
-  rxbuf->head  = (rxbuf->head + nbytes) % rxbuf->size;
-  xfer->nbytes = 0;
-  xfer->length = xfer->nlength = 0;
+  xfer->nbytes    = 0;
+  xfer->nreported = 0;
+  xfer->length    = xfer->nlength = 0;
 
   /* If any bytes were added to the buffer, inform any waiters there is new
    * incoming data available.
@@ -397,16 +458,36 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
     {
       uart_datareceived(dev);
     }
+}
+#endif
 
-#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
-  /* Send the signal if necessary */
+/****************************************************************************
+ * Name: uart_recvchars_update
+ *
+ * Description:
+ *   Make the bytes received so far by a still running DMA transfer
+ *   available to readers.  See include/nuttx/serial/serial.h.
+ *
+ ****************************************************************************/
 
-  if (signo != 0)
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_update(FAR uart_dev_t *dev, bool idle)
+{
+  size_t nbytes;
+
+  nbytes = uart_recvchars_advance(dev);
+
+  if (idle && dev->recv.head != dev->recv.tail)
     {
-      kill(dev->pid, signo);
-      uart_reset_sem(dev);
+      /* The burst is over:  Wake up the reader with whatever it has */
+
+      dev->recvmin = 0;
+      uart_datareceived(dev);
+    }
+  else if (nbytes)
+    {
+      uart_datareceived(dev);
     }
-#endif
 }
 #endif
 
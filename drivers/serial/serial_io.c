@@ -110,6 +110,10 @@ void uart_xmitchars(FAR uart_dev_t *dev)
    * there is space available.
    */
 
+#ifdef CONFIG_SERIAL_ICOUNT
+  dev->icount.tx += nbytes;
+#endif
+
   if (nbytes)
     {
       uart_datasent(dev);
@@ -281,8 +285,18 @@ void uart_recvchars(FAR uart_dev_t *dev)
                nexthead = 0;
             }
         }
+#ifdef CONFIG_SERIAL_ICOUNT
+      else
+        {
+          dev->icount.buf_overrun++;
+        }
+#endif
     }
 
+#ifdef CONFIG_SERIAL_ICOUNT
+  dev->icount.rx += nbytes;
+#endif
+
   /* If any bytes were added to the buffer, inform any waiters there is new
    * incoming data available.
    */
@@ -29,10 +29,12 @@
 #include <string.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/rptun/openamp.h>
 #include <nuttx/serial/serial.h>
 #include <nuttx/serial/uart_rpmsg.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor definitions
@@ -45,6 +47,15 @@
 #define UART_RPMSG_TTY_WRITE            0
 #define UART_RPMSG_TTY_WAKEUP           1
 
+/* With a work queue, a write that does not fit into the RX buffer is held
+ * in its rpmsg buffer and consumed as the reader makes room, instead of
+ * being answered short and sent again by the remote after a wakeup.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+#  define UART_RPMSG_HOLD_RX
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -75,8 +86,12 @@ struct uart_rpmsg_priv_s
   struct rpmsg_endpoint ept;
   FAR const char        *devname;
   FAR const char        *cpuname;
-  FAR void              *recv_data;
+  FAR struct uart_rpmsg_write_s *recv_data;
+  uint32_t              recv_pos;   /* Bytes of recv_data consumed */
   bool                  last_upper;
+#ifdef UART_RPMSG_HOLD_RX
+  struct work_s         recv_work;  /* Drains a held recv_data */
+#endif
 #ifdef CONFIG_SERIAL_TERMIOS
   struct termios        termios;
 #endif
@@ -211,16 +226,17 @@ static bool uart_rpmsg_rxflowcontrol(FAR struct uart_dev_s *dev,
                                      unsigned int nbuffered, bool upper)
 {
   FAR struct uart_rpmsg_priv_s *priv = dev->priv;
-  FAR struct uart_rpmsg_wakeup_s msg;
+  FAR struct uart_rpmsg_wakeup_s *msg;
+  uint32_t space;
 
-  if (!upper && upper != priv->last_upper)
+  if (!upper && upper != priv->last_upper &&
+      is_rpmsg_ept_ready(&priv->ept))
     {
-      memset(&msg, 0, sizeof(msg));
-
-      msg.header.command = UART_RPMSG_TTY_WAKEUP;
-      if (is_rpmsg_ept_ready(&priv->ept))
+      msg = rpmsg_alloc_msg(&priv->ept, sizeof(*msg), &space, true);
+      if (msg != NULL)
         {
-          rpmsg_send(&priv->ept, &msg, sizeof(msg));
+          msg->header.command = UART_RPMSG_TTY_WAKEUP;
+          rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg));
         }
     }
 
@@ -236,16 +252,14 @@ static void uart_rpmsg_dmasend(FAR struct uart_dev_s *dev)
   size_t len = xfer->length + xfer->nlength;
   uint32_t space;
 
-  msg = rpmsg_get_tx_payload_buffer(&priv->ept, &space, true);
+  msg = rpmsg_alloc_msg(&priv->ept, sizeof(*msg), &space, true);
   if (!msg)
     {
       dev->dmatx.length = 0;
       return;
     }
 
-  memset(msg, 0, sizeof(*msg));
-
-  space = C2B(space - sizeof(*msg));
+  space = C2B(space);
 
   if (len > space)
     {
@@ -276,7 +290,8 @@ static void uart_rpmsg_dmareceive(FAR struct uart_dev_s *dev)
   FAR struct uart_rpmsg_priv_s *priv = dev->priv;
   FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
   FAR struct uart_rpmsg_write_s *msg = priv->recv_data;
-  uint32_t len = msg->count;
+  uint32_t pos = priv->recv_pos;
+  uint32_t len = msg->count - pos;
   size_t space = xfer->length + xfer->nlength;
 
   if (len > space)
@@ -286,28 +301,110 @@ static void uart_rpmsg_dmareceive(FAR struct uart_dev_s *dev)
 
   if (len > xfer->length)
     {
-      bmem2cmem(xfer->buffer, msg->data, 0, xfer->length);
-      bmem2cmem(xfer->nbuffer, msg->data + B2C_OFF(xfer->length),
-              B2C_REM(xfer->length), len - xfer->length);
+      bmem2cmem(xfer->buffer, msg->data + B2C_OFF(pos), B2C_REM(pos),
+                xfer->length);
+      pos += xfer->length;
+      bmem2cmem(xfer->nbuffer, msg->data + B2C_OFF(pos), B2C_REM(pos),
+                len - xfer->length);
     }
   else
     {
-      bmem2cmem(xfer->buffer, msg->data, 0, len);
+      bmem2cmem(xfer->buffer, msg->data + B2C_OFF(pos), B2C_REM(pos), len);
     }
 
-  xfer->nbytes = len;
+  priv->recv_pos += len;
+  xfer->nbytes    = len;
   uart_recvchars_done(dev);
+}
+
+/****************************************************************************
+ * Name: uart_rpmsg_recv
+ *
+ * Description:
+ *   Move as much of the pending write as fits into the RX buffer.  The
+ *   caller that consumes the last byte takes the write over, so that it is
+ *   answered exactly once.
+ *
+ * Returned Value:
+ *   The write if it has been consumed completely by this call, else NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct uart_rpmsg_write_s *
+uart_rpmsg_recv(FAR struct uart_dev_s *dev)
+{
+  FAR struct uart_rpmsg_priv_s *priv = dev->priv;
+  FAR struct uart_rpmsg_write_s *msg;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  msg = priv->recv_data;
+  if (msg != NULL)
+    {
+      uart_recvchars_dma(dev);
+      if (priv->recv_pos >= msg->count)
+        {
+          priv->recv_data = NULL;
+        }
+      else
+        {
+          msg = NULL;
+        }
+    }
+
+  leave_critical_section(flags);
+  return msg;
+}
+
+/****************************************************************************
+ * Name: uart_rpmsg_recv_done
+ *
+ * Description:
+ *   Answer a received write with the number of bytes consumed.
+ *
+ ****************************************************************************/
 
-  msg->header.result = len;
+static void uart_rpmsg_recv_done(FAR struct rpmsg_endpoint *ept,
+                                 FAR struct uart_rpmsg_write_s *msg,
+                                 uint32_t result)
+{
+  msg->header.response = 1;
+  msg->header.result   = result;
+
+  rpmsg_send(ept, msg, sizeof(*msg));
+}
 
-  if (len != msg->count)
+#ifdef UART_RPMSG_HOLD_RX
+static void uart_rpmsg_recv_work(FAR void *arg)
+{
+  FAR struct uart_dev_s *dev = arg;
+  FAR struct uart_rpmsg_priv_s *priv = dev->priv;
+  FAR struct uart_rpmsg_write_s *msg;
+
+  msg = uart_rpmsg_recv(dev);
+  if (msg != NULL)
     {
-      uart_rpmsg_rxflowcontrol(dev, 0, true);
+      uart_rpmsg_recv_done(&priv->ept, msg, msg->count);
+      rpmsg_release_rx_buffer(&priv->ept, msg);
     }
 }
+#endif
 
 static void uart_rpmsg_dmarxfree(FAR struct uart_dev_s *dev)
 {
+#ifdef UART_RPMSG_HOLD_RX
+  FAR struct uart_rpmsg_priv_s *priv = dev->priv;
+
+  /* The reader made room: continue with a held write outside of the
+   * critical section that this is called in.
+   */
+
+  if (priv->recv_data != NULL && work_available(&priv->recv_work))
+    {
+      work_queue(LPWORK, &priv->recv_work, uart_rpmsg_recv_work, dev, 0);
+    }
+#endif
 }
 
 static void uart_rpmsg_dmatxavail(FAR struct uart_dev_s *dev)
@@ -388,6 +485,10 @@ static void uart_rpmsg_device_destroy(FAR struct rpmsg_device *rdev,
 
   if (strcmp(priv->cpuname, rpmsg_get_cpuname(rdev)) == 0)
     {
+#ifdef UART_RPMSG_HOLD_RX
+      work_cancel(LPWORK, &priv->recv_work);
+#endif
+      priv->recv_data = NULL;
       rpmsg_destroy_ept(&priv->ept);
     }
 }
@@ -424,12 +525,31 @@ static int uart_rpmsg_ept_cb(FAR struct rpmsg_endpoint *ept, FAR void *data,
 
       /* Get write-cmd, there are some data, we need receive them */
 
-      priv->recv_data = data;
-      uart_recvchars_dma(dev);
-      priv->recv_data = NULL;
+      priv->recv_data = msg;
+      priv->recv_pos  = 0;
+
+#ifdef UART_RPMSG_HOLD_RX
+      /* Hold the buffer first, so that a reader making room right away
+       * can finish the write from the work queue.
+       */
 
-      header->response = 1;
-      rpmsg_send(ept, msg, sizeof(*msg));
+      rpmsg_hold_rx_buffer(ept, data);
+      if (uart_rpmsg_recv(dev) != NULL)
+        {
+          uart_rpmsg_recv_done(ept, msg, msg->count);
+          rpmsg_release_rx_buffer(ept, data);
+        }
+#else
+      if (uart_rpmsg_recv(dev) == NULL)
+        {
+          /* Answer short; the remote sends the rest after the wakeup */
+
+          priv->recv_data = NULL;
+          uart_rpmsg_rxflowcontrol(dev, 0, true);
+        }
+
+      uart_rpmsg_recv_done(ept, msg, priv->recv_pos);
+#endif
     }
   else if (header->command == UART_RPMSG_TTY_WAKEUP)
     {
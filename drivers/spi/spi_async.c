@@ -0,0 +1,214 @@
+/****************************************************************************
+ * drivers/spi/spi_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_SPI_ASYNC_HPWORK) || !defined(CONFIG_SCHED_LPWORK)
+#  define SPIWORK HPWORK
+#else
+#  define SPIWORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of requests of one SPI bus whose driver does not implement the
+ * transfer_async() method.
+ */
+
+struct spi_asyncq_s
+{
+  FAR struct spi_dev_s   *spi;   /* The bus, NULL if the entry is free */
+  FAR struct spi_async_s *head;  /* First queued request */
+  FAR struct spi_async_s *tail;  /* Last queued request */
+  struct work_s           work;  /* Performs the queued requests */
+  bool                    busy;  /* True: The work is scheduled */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct spi_asyncq_s g_spi_asyncq[CONFIG_SPI_ASYNC_NBUSES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_async_worker
+ *
+ * Description:
+ *   Perform the requests queued for one bus, one after the other, until
+ *   the queue is empty.
+ *
+ ****************************************************************************/
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct spi_asyncq_s *queue = (FAR struct spi_asyncq_s *)arg;
+  FAR struct spi_async_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      req = queue->head;
+      if (req == NULL)
+        {
+          /* Keep the entry:  The bus will most likely be used again */
+
+          queue->busy = false;
+          leave_critical_section(flags);
+          break;
+        }
+
+      queue->head = req->flink;
+      if (queue->head == NULL)
+        {
+          queue->tail = NULL;
+        }
+
+      leave_critical_section(flags);
+
+      /* spi_transfer() locks the bus for the duration of the sequence, so
+       * that synchronous users of the bus are serialized as usual.
+       */
+
+      ret = spi_transfer(queue->spi, req->seq);
+      req->callback(req, ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return immediately.  See
+ *   include/nuttx/spi/spi_transfer.h.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_async_s *req)
+{
+  FAR struct spi_asyncq_s *queue = NULL;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(spi != NULL && req != NULL && req->seq != NULL &&
+              req->callback != NULL);
+
+  /* Let the driver chain the transfers if it knows how to */
+
+  if (spi->ops->transfer_async != NULL)
+    {
+      return SPI_TRANSFER_ASYNC(spi, req);
+    }
+
+  req->flink = NULL;
+
+  flags = enter_critical_section();
+
+  /* Find the queue of this bus or a free one */
+
+  for (i = 0; i < CONFIG_SPI_ASYNC_NBUSES; i++)
+    {
+      if (g_spi_asyncq[i].spi == spi)
+        {
+          queue = &g_spi_asyncq[i];
+          break;
+        }
+      else if (queue == NULL && g_spi_asyncq[i].spi == NULL)
+        {
+          queue = &g_spi_asyncq[i];
+        }
+    }
+
+  if (queue == NULL)
+    {
+      spierr("ERROR: No queue for SPI bus %p\n", spi);
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  queue->spi = spi;
+
+  if (queue->tail == NULL)
+    {
+      queue->head = req;
+    }
+  else
+    {
+      queue->tail->flink = req;
+    }
+
+  queue->tail = req;
+
+  if (!queue->busy)
+    {
+      ret = work_queue(SPIWORK, &queue->work, spi_async_worker, queue, 0);
+      if (ret < 0)
+        {
+          spierr("ERROR: work_queue failed: %d\n", ret);
+
+          /* Only this request can be in the queue */
+
+          queue->head = NULL;
+          queue->tail = NULL;
+          goto errout;
+        }
+
+      queue->busy = true;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_SPI_ASYNC */
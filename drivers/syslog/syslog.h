@@ -42,7 +42,9 @@
 
 #include <nuttx/config.h>
 
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Public Data
@@ -248,6 +250,32 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
                            bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Save a message to be formatted later on the low-priority work queue.
+ *   This never blocks:  If the ring of the current CPU is full, the message
+ *   is dropped and the number of dropped messages is reported later.
+ *
+ * Input Parameters:
+ *   ts  - The time stamp of the message (ignored if
+ *         CONFIG_SYSLOG_TIMESTAMP is not enabled)
+ *   fmt - The format string.  This must persist until the message has been
+ *         formatted.
+ *   ap  - The arguments.  These are not consumed.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was saved or dropped; a negated errno value if
+ *   the message cannot be deferred and must be formatted immediately.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_add_deferred(FAR const struct timespec *ts,
+                        FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
 /****************************************************************************
  * Name: syslog_putc
  *
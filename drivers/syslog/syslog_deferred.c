@@ -0,0 +1,755 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Deferred SYSLOG formatting.
+ *
+ * Instead of formatting the message in the context of the caller,
+ * syslog_add_deferred() saves the format string pointer, the time stamp
+ * and a binary copy of the arguments in a per-CPU ring buffer.  Each ring
+ * has a single producer (the local CPU, with local interrupts disabled) and
+ * a single consumer (the worker), so neither side needs a lock.  The
+ * worker runs on the low-priority work queue and formats the messages into
+ * the SYSLOG channel.
+ *
+ * Because only the pointer is saved, the format string must persist until
+ * the message is formatted.  The arguments of %s conversions are copied.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SYSLOG_DEFERRED_BUFSIZE & \
+     (CONFIG_SYSLOG_DEFERRED_BUFSIZE - 1)) != 0
+#  error CONFIG_SYSLOG_DEFERRED_BUFSIZE must be a power of two
+#endif
+
+#if CONFIG_SYSLOG_DEFERRED_MSGSIZE > CONFIG_SYSLOG_DEFERRED_BUFSIZE
+#  error CONFIG_SYSLOG_DEFERRED_MSGSIZE exceeds CONFIG_SYSLOG_DEFERRED_BUFSIZE
+#endif
+
+#define SYSLOG_DEFERRED_MASK (CONFIG_SYSLOG_DEFERRED_BUFSIZE - 1)
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_DEFERRED_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define SYSLOG_DEFERRED_NCPUS 1
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define SYSLOGWORK LPWORK
+#else
+#  define SYSLOGWORK HPWORK
+#endif
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+/* Longest single conversion specification that can be re-played */
+
+#define SYSLOG_SPECLEN 16
+
+/* Format one saved argument of the given type with zero, one or two
+ * preceding '*' width/precision arguments.
+ */
+
+#define SYSLOG_PRINT(stream, spec, desc, star, args, type) \
+  do \
+    { \
+      type value; \
+      memcpy(&value, args, sizeof(type)); \
+      args += sizeof(type); \
+      if ((desc)->sd_nstar == 0) \
+        { \
+          lib_sprintf(stream, spec, value); \
+        } \
+      else if ((desc)->sd_nstar == 1) \
+        { \
+          lib_sprintf(stream, spec, star[0], value); \
+        } \
+      else \
+        { \
+          lib_sprintf(stream, spec, star[0], star[1], value); \
+        } \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The type of the argument consumed by one conversion */
+
+enum syslog_argtype_e
+{
+  SYSLOG_ARG_NONE = 0,    /* "%%":  No argument */
+  SYSLOG_ARG_INT,         /* int (including char and short) */
+  SYSLOG_ARG_LONG,        /* long */
+  SYSLOG_ARG_LLONG,       /* long long */
+  SYSLOG_ARG_DOUBLE,      /* double */
+  SYSLOG_ARG_PTR,         /* void * */
+  SYSLOG_ARG_STRING       /* NUL-terminated string, saved by value */
+};
+
+/* Description of one conversion specification */
+
+struct syslog_spec_s
+{
+  uint8_t sd_len;         /* Length of the specification, including '%' */
+  uint8_t sd_nstar;       /* Number of '*' int arguments (0-2) */
+  uint8_t sd_type;        /* See enum syslog_argtype_e */
+};
+
+/* The header of each saved message.  The saved arguments follow. */
+
+struct syslog_msghdr_s
+{
+  uint16_t sm_length;                /* Length of the message with header */
+  FAR const IPTR char *sm_fmt;       /* The format string */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec sm_ts;             /* Time that the message was logged */
+#endif
+};
+
+/* One per-CPU ring of saved messages.  The indices are free running. */
+
+struct syslog_ring_s
+{
+  volatile size_t sr_head;           /* Written only by the producer */
+  volatile size_t sr_tail;           /* Written only by the consumer */
+  volatile unsigned int sr_dropped;  /* Messages lost to overflow */
+  unsigned int sr_reported;          /* Drops already reported */
+  uint8_t sr_buffer[CONFIG_SYSLOG_DEFERRED_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_ring[SYSLOG_DEFERRED_NCPUS];
+static struct work_s g_syslog_work;
+
+/* The message being formatted.  Only the worker uses this buffer. */
+
+static uint8_t g_syslog_msg[CONFIG_SYSLOG_DEFERRED_MSGSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parse
+ *
+ * Description:
+ *   Parse the conversion specification at 'fmt' (which must point to a
+ *   '%') and determine the arguments that it consumes.  The parse mirrors
+ *   the argument handling of lib_vsprintf().
+ *
+ * Returned Value:
+ *   A pointer to the character following the specification, or NULL if the
+ *   specification cannot be re-played later.
+ *
+ ****************************************************************************/
+
+static FAR const IPTR char *syslog_parse(FAR const IPTR char *fmt,
+                                         FAR struct syslog_spec_s *desc)
+{
+  FAR const IPTR char *ptr = fmt + 1;
+  int nlong = 0;
+
+  desc->sd_nstar = 0;
+
+  if (*ptr == '%')
+    {
+      desc->sd_len  = 2;
+      desc->sd_type = SYSLOG_ARG_NONE;
+      return ptr + 1;
+    }
+
+  /* Flags */
+
+  while (*ptr == '0' || *ptr == '+' || *ptr == ' ' || *ptr == '-' ||
+         *ptr == '#')
+    {
+      ptr++;
+    }
+
+  /* Width */
+
+  if (*ptr == '*')
+    {
+      desc->sd_nstar++;
+      ptr++;
+    }
+  else
+    {
+      while (*ptr >= '0' && *ptr <= '9')
+        {
+          ptr++;
+        }
+    }
+
+  /* Precision */
+
+  if (*ptr == '.')
+    {
+      ptr++;
+      if (*ptr == '*')
+        {
+          desc->sd_nstar++;
+          ptr++;
+        }
+      else
+        {
+          while (*ptr >= '0' && *ptr <= '9')
+            {
+              ptr++;
+            }
+        }
+    }
+
+  /* Length modifiers */
+
+  for (; ; ptr++)
+    {
+      if (*ptr == 'l')
+        {
+          nlong++;
+        }
+      else if (*ptr == 'z')
+        {
+          nlong = sizeof(size_t) == sizeof(long) ? 1 : 0;
+        }
+      else if (*ptr == 'j')
+        {
+          nlong = 2;
+        }
+      else if (*ptr != 'h')
+        {
+          break;
+        }
+    }
+
+  /* Conversion */
+
+  switch (*ptr)
+    {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+#ifdef CONFIG_LIBC_LONG_LONG
+        desc->sd_type = nlong == 0 ? SYSLOG_ARG_INT :
+                        nlong == 1 ? SYSLOG_ARG_LONG : SYSLOG_ARG_LLONG;
+#else
+        desc->sd_type = nlong == 0 ? SYSLOG_ARG_INT : SYSLOG_ARG_LONG;
+#endif
+        break;
+
+      case 'c':
+        desc->sd_type = SYSLOG_ARG_INT;
+        break;
+
+      case 'p':
+        desc->sd_type = SYSLOG_ARG_PTR;
+        break;
+
+      case 's':
+      case 'S':
+        desc->sd_type = SYSLOG_ARG_STRING;
+        break;
+
+      case 'e':
+      case 'f':
+      case 'g':
+      case 'E':
+      case 'F':
+      case 'G':
+        desc->sd_type = SYSLOG_ARG_DOUBLE;
+        break;
+
+      default:
+        return NULL;
+    }
+
+  ptr++;
+  if (ptr - fmt >= SYSLOG_SPECLEN)
+    {
+      return NULL;
+    }
+
+  desc->sd_len = ptr - fmt;
+  return ptr;
+}
+
+/****************************************************************************
+ * Name: syslog_save
+ *
+ * Description:
+ *   Append 'len' bytes to the message being built.
+ *
+ ****************************************************************************/
+
+static int syslog_save(FAR uint8_t *msg, FAR size_t *offset,
+                       FAR const void *src, size_t len)
+{
+  if (*offset + len > CONFIG_SYSLOG_DEFERRED_MSGSIZE)
+    {
+      return -E2BIG;
+    }
+
+  memcpy(&msg[*offset], src, len);
+  *offset += len;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_ring_copyin / syslog_ring_copyout
+ *
+ * Description:
+ *   Copy data into or out of a ring buffer at a free running index.
+ *
+ ****************************************************************************/
+
+static void syslog_ring_copyin(FAR struct syslog_ring_s *ring, size_t index,
+                               FAR const uint8_t *src, size_t len)
+{
+  size_t offset = index & SYSLOG_DEFERRED_MASK;
+  size_t first  = CONFIG_SYSLOG_DEFERRED_BUFSIZE - offset;
+
+  if (first > len)
+    {
+      first = len;
+    }
+
+  memcpy(&ring->sr_buffer[offset], src, first);
+  memcpy(ring->sr_buffer, src + first, len - first);
+}
+
+static void syslog_ring_copyout(FAR struct syslog_ring_s *ring,
+                                size_t index, FAR uint8_t *dest, size_t len)
+{
+  size_t offset = index & SYSLOG_DEFERRED_MASK;
+  size_t first  = CONFIG_SYSLOG_DEFERRED_BUFSIZE - offset;
+
+  if (first > len)
+    {
+      first = len;
+    }
+
+  memcpy(dest, &ring->sr_buffer[offset], first);
+  memcpy(dest + first, ring->sr_buffer, len - first);
+}
+
+/****************************************************************************
+ * Name: syslog_format
+ *
+ * Description:
+ *   Format one saved message into the SYSLOG channel.
+ *
+ ****************************************************************************/
+
+static void syslog_format(FAR const struct syslog_msghdr_s *hdr,
+                          FAR const uint8_t *args)
+{
+  struct lib_syslogstream_s stream;
+  struct syslog_spec_s desc;
+  FAR const IPTR char *ptr;
+  FAR const IPTR char *next;
+  char spec[SYSLOG_SPECLEN];
+  int star[2];
+  int i;
+
+  syslogstream_create(&stream);
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  /* Pre-pend the message with the time that it was logged */
+
+  lib_sprintf(&stream.public, "[%5d.%06d] ",
+              hdr->sm_ts.tv_sec, hdr->sm_ts.tv_nsec / 1000);
+#endif
+
+#ifdef CONFIG_SYSLOG_PREFIX
+  lib_sprintf(&stream.public, "%s", CONFIG_SYSLOG_PREFIX_STRING);
+#endif
+
+  for (ptr = hdr->sm_fmt; *ptr != '\0'; ptr = next)
+    {
+      if (*ptr != '%')
+        {
+          stream.public.put(&stream.public, *ptr);
+          next = ptr + 1;
+          continue;
+        }
+
+      /* The specification was validated when the message was saved */
+
+      next = syslog_parse(ptr, &desc);
+      DEBUGASSERT(next != NULL);
+
+      memcpy(spec, ptr, desc.sd_len);
+      spec[desc.sd_len] = '\0';
+
+      for (i = 0; i < desc.sd_nstar; i++)
+        {
+          memcpy(&star[i], args, sizeof(int));
+          args += sizeof(int);
+        }
+
+      switch (desc.sd_type)
+        {
+          case SYSLOG_ARG_NONE:
+            stream.public.put(&stream.public, '%');
+            break;
+
+          case SYSLOG_ARG_INT:
+            SYSLOG_PRINT(&stream.public, spec, &desc, star, args, int);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            SYSLOG_PRINT(&stream.public, spec, &desc, star, args, long);
+            break;
+
+          case SYSLOG_ARG_LLONG:
+            SYSLOG_PRINT(&stream.public, spec, &desc, star, args,
+                         long long);
+            break;
+
+          case SYSLOG_ARG_DOUBLE:
+            SYSLOG_PRINT(&stream.public, spec, &desc, star, args, double);
+            break;
+
+          case SYSLOG_ARG_PTR:
+            SYSLOG_PRINT(&stream.public, spec, &desc, star, args,
+                         FAR void *);
+            break;
+
+          case SYSLOG_ARG_STRING:
+            {
+              FAR const char *str = (FAR const char *)args;
+
+              if (desc.sd_nstar == 0)
+                {
+                  lib_sprintf(&stream.public, spec, str);
+                }
+              else if (desc.sd_nstar == 1)
+                {
+                  lib_sprintf(&stream.public, spec, star[0], str);
+                }
+              else
+                {
+                  lib_sprintf(&stream.public, spec, star[0], star[1], str);
+                }
+
+              args += strlen(str) + 1;
+            }
+            break;
+        }
+    }
+
+  syslogstream_destroy(&stream);
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_worker
+ *
+ * Description:
+ *   Format all saved messages.  This runs on the low-priority work queue
+ *   and is the only consumer of the rings.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_worker(FAR void *arg)
+{
+  FAR struct syslog_msghdr_s *hdr;
+  FAR struct syslog_ring_s *ring;
+  unsigned int dropped;
+  size_t tail;
+  int cpu;
+
+  hdr = (FAR struct syslog_msghdr_s *)g_syslog_msg;
+
+  for (cpu = 0; cpu < SYSLOG_DEFERRED_NCPUS; cpu++)
+    {
+      ring = &g_syslog_ring[cpu];
+
+      while ((tail = ring->sr_tail) != ring->sr_head)
+        {
+          /* Read the head index before the message that it publishes */
+
+          SP_DMB();
+
+          /* Copy the message out so that the space can be re-used
+           * while it is formatted.
+           */
+
+          syslog_ring_copyout(ring, tail, g_syslog_msg,
+                              sizeof(struct syslog_msghdr_s));
+          syslog_ring_copyout(ring, tail, g_syslog_msg, hdr->sm_length);
+
+          SP_DMB();
+          ring->sr_tail = tail + hdr->sm_length;
+
+          syslog_format(hdr, &g_syslog_msg[sizeof(struct syslog_msghdr_s)]);
+        }
+
+      dropped = ring->sr_dropped;
+      if (dropped != ring->sr_reported)
+        {
+          struct lib_syslogstream_s stream;
+
+          syslogstream_create(&stream);
+          lib_sprintf(&stream.public, "[%u syslog messages dropped]\n",
+                      dropped - ring->sr_reported);
+          syslogstream_destroy(&stream);
+
+          ring->sr_reported = dropped;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Save a message to be formatted later on the low-priority work queue.
+ *   This never blocks:  If the ring of the current CPU is full, the message
+ *   is dropped and the number of dropped messages is reported later.
+ *
+ * Input Parameters:
+ *   ts  - The time stamp of the message (ignored if
+ *         CONFIG_SYSLOG_TIMESTAMP is not enabled)
+ *   fmt - The format string.  This must persist until the message has been
+ *         formatted.
+ *   ap  - The arguments.  These are not consumed.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was saved or dropped; a negated errno value if
+ *   the message cannot be deferred and must be formatted immediately.
+ *
+ ****************************************************************************/
+
+int syslog_add_deferred(FAR const struct timespec *ts,
+                        FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  uint8_t msg[CONFIG_SYSLOG_DEFERRED_MSGSIZE];
+  struct syslog_msghdr_s hdr;
+  struct syslog_spec_s desc;
+  FAR struct syslog_ring_s *ring;
+  FAR const IPTR char *ptr;
+  irqstate_t flags;
+  size_t offset;
+  size_t head;
+  va_list copy;
+  int ret = OK;
+  int i;
+
+  /* Messages cannot be deferred until the work queues are running */
+
+  if (!OSINIT_OS_READY())
+    {
+      return -EAGAIN;
+    }
+
+  /* Save the arguments after the message header */
+
+  offset = sizeof(struct syslog_msghdr_s);
+  va_copy(copy, *ap);
+
+  for (ptr = fmt; *ptr != '\0' && ret >= 0; )
+    {
+      if (*ptr != '%')
+        {
+          ptr++;
+          continue;
+        }
+
+      ptr = syslog_parse(ptr, &desc);
+      if (ptr == NULL)
+        {
+          ret = -ENOSYS;
+          break;
+        }
+
+      for (i = 0; i < desc.sd_nstar && ret >= 0; i++)
+        {
+          int value = va_arg(copy, int);
+          ret = syslog_save(msg, &offset, &value, sizeof(int));
+        }
+
+      switch (desc.sd_type)
+        {
+          case SYSLOG_ARG_INT:
+            {
+              int value = va_arg(copy, int);
+              ret = syslog_save(msg, &offset, &value, sizeof(int));
+            }
+            break;
+
+          case SYSLOG_ARG_LONG:
+            {
+              long value = va_arg(copy, long);
+              ret = syslog_save(msg, &offset, &value, sizeof(long));
+            }
+            break;
+
+          case SYSLOG_ARG_LLONG:
+            {
+              long long value = va_arg(copy, long long);
+              ret = syslog_save(msg, &offset, &value, sizeof(long long));
+            }
+            break;
+
+          case SYSLOG_ARG_DOUBLE:
+            {
+              double value = va_arg(copy, double);
+              ret = syslog_save(msg, &offset, &value, sizeof(double));
+            }
+            break;
+
+          case SYSLOG_ARG_PTR:
+            {
+              FAR void *value = va_arg(copy, FAR void *);
+              ret = syslog_save(msg, &offset, &value, sizeof(FAR void *));
+            }
+            break;
+
+          case SYSLOG_ARG_STRING:
+            {
+              FAR const char *str = va_arg(copy, FAR const char *);
+              size_t len;
+
+              if (str == NULL)
+                {
+                  str = "(null)";
+                }
+
+              /* Truncate the string rather than give up on the message */
+
+              len = strlen(str);
+              if (offset + len + 1 > CONFIG_SYSLOG_DEFERRED_MSGSIZE)
+                {
+                  if (offset >= CONFIG_SYSLOG_DEFERRED_MSGSIZE)
+                    {
+                      ret = -E2BIG;
+                      break;
+                    }
+
+                  len = CONFIG_SYSLOG_DEFERRED_MSGSIZE - offset - 1;
+                }
+
+              memcpy(&msg[offset], str, len);
+              msg[offset + len] = '\0';
+              offset += len + 1;
+            }
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  va_end(copy);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hdr.sm_length = offset;
+  hdr.sm_fmt    = fmt;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  hdr.sm_ts     = *ts;
+#endif
+  memcpy(msg, &hdr, sizeof(struct syslog_msghdr_s));
+
+  /* Disabling local interrupts is sufficient:  Only this CPU adds to its
+   * ring, and the worker never modifies the head.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_ring[up_cpu_index()];
+  head  = ring->sr_head;
+
+  if (CONFIG_SYSLOG_DEFERRED_BUFSIZE - (head - ring->sr_tail) < offset)
+    {
+      ring->sr_dropped++;
+      up_irq_restore(flags);
+      return OK;
+    }
+
+  /* Do not overwrite the space until the worker is done reading it */
+
+  SP_DMB();
+  syslog_ring_copyin(ring, head, msg, offset);
+
+  /* Publish the message only after it is complete */
+
+  SP_DMB();
+  ring->sr_head = head + offset;
+  up_irq_restore(flags);
+
+  /* Schedule the worker if it is not already pending.  The worker clears
+   * the work structure before it runs, so no message is left behind.
+   */
+
+  if (work_available(&g_syslog_work))
+    {
+      work_queue(SYSLOGWORK, &g_syslog_work, syslog_deferred_worker,
+                 NULL, 0);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
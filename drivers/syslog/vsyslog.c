@@ -50,6 +50,8 @@
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
+#include "syslog.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -111,6 +113,25 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     }
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Save the message to be formatted later on the work queue.  Emergency
+   * messages are always output immediately.
+   */
+
+  if (priority != LOG_EMERG)
+    {
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      ret = syslog_add_deferred(&ts, fmt, ap);
+#else
+      ret = syslog_add_deferred(NULL, fmt, ap);
+#endif
+      if (ret >= 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.  NOTE that emergency priority output is handled
    * differently.. it will use the SYSLOG emergency stream.
@@ -371,7 +371,8 @@ int up_alarm_start(FAR const struct timespec *ts)
  *   units.
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_SPANS) || \
+    defined(CONFIG_SCHED_CPUTIME) || defined(CONFIG_SCHED_BENCHMARK)
 uint32_t up_critmon_gettime(void)
 {
   uint32_t ret = 0;
@@ -69,6 +69,8 @@ static struct arch_timer_s g_timer;
  ****************************************************************************/
 
 #if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_SCHED_CRITMONITOR) \
+    || defined(CONFIG_SCHED_SPANS) || defined(CONFIG_SCHED_CPUTIME) \
+    || defined(CONFIG_SCHED_BENCHMARK) \
     || defined(CONFIG_SCHED_IRQMONITOR_GETTIME)
 static inline void timespec_from_usec(FAR struct timespec *ts,
                                       uint64_t microseconds)
@@ -427,7 +429,8 @@ int up_timer_start(FAR const struct timespec *ts)
  *   units.
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_SPANS) || \
+    defined(CONFIG_SCHED_CPUTIME) || defined(CONFIG_SCHED_BENCHMARK)
 uint32_t up_critmon_gettime(void)
 {
   uint32_t ret = 0;
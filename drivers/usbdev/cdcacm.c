@@ -52,6 +52,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
 #include <nuttx/serial/serial.h>
@@ -129,6 +130,21 @@ struct cdcacm_dev_s
   struct sq_queue_s txfree;            /* Available write request containers */
   struct sq_queue_s rxpending;         /* Pending read request containers */
 
+#ifdef CONFIG_CDCACM_DIRECTIO
+  /* Direct I/O:  A write request sending the caller's buffer, and the
+   * buffer of a reader waiting for the next packet.
+   */
+
+  FAR struct cdcacm_wrreq_s *wrdirect; /* Request using the caller's buffer */
+  FAR uint8_t *wrbuf;                  /* The request's own buffer meanwhile */
+  ssize_t nwrbytes;                    /* Bytes sent from it or -errno */
+  sem_t wrsem;                         /* Wakes up the direct writer */
+  FAR char *rdbuf;                     /* Buffer of the waiting reader */
+  size_t rdlen;                        /* Size of rdbuf */
+  ssize_t nrdbytes;                    /* Bytes received into rdbuf or -errno */
+  sem_t rdsem;                         /* Wakes up the direct reader */
+#endif
+
   struct usbdev_devinfo_s devinfo;
 
   /* Pre-allocated write request containers.  The write requests will
@@ -243,6 +259,12 @@ static bool    cdcuart_rxflowcontrol(FAR struct uart_dev_s *dev,
 #endif
 static void    cdcuart_txint(FAR struct uart_dev_s *dev, bool enable);
 static bool    cdcuart_txempty(FAR struct uart_dev_s *dev);
+#ifdef CONFIG_CDCACM_DIRECTIO
+static ssize_t cdcuart_directwrite(FAR struct uart_dev_s *dev,
+                 FAR const char *buffer, size_t buflen);
+static ssize_t cdcuart_directread(FAR struct uart_dev_s *dev,
+                 FAR char *buffer, size_t buflen);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -294,6 +316,10 @@ static const struct uart_ops_s g_uartops =
   cdcuart_txint,         /* txinit */
   NULL,                  /* txready */
   cdcuart_txempty        /* txempty */
+#ifdef CONFIG_CDCACM_DIRECTIO
+  , cdcuart_directwrite  /* directwrite */
+  , cdcuart_directread   /* directread */
+#endif
 };
 
 /****************************************************************************
@@ -324,23 +350,40 @@ static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
   FAR struct uart_buffer_s *xmit = &serdev->xmit;
   irqstate_t flags;
   uint16_t nbytes = 0;
+  uint16_t ncopy;
 
   /* Disable interrupts */
 
   flags = enter_critical_section();
 
   /* Transfer bytes while we have bytes available and there is room in the
-   * request.
+   * request.  The data is copied in (at most two) contiguous blocks.
    */
 
   while (xmit->head != xmit->tail && nbytes < reqlen)
     {
-      *reqbuf++ = xmit->buffer[xmit->tail];
-      nbytes++;
+      if (xmit->head > xmit->tail)
+        {
+          ncopy = xmit->head - xmit->tail;
+        }
+      else
+        {
+          ncopy = xmit->size - xmit->tail;
+        }
+
+      if (ncopy > reqlen - nbytes)
+        {
+          ncopy = reqlen - nbytes;
+        }
+
+      memcpy(reqbuf, &xmit->buffer[xmit->tail], ncopy);
+      reqbuf += ncopy;
+      nbytes += ncopy;
 
       /* Increment the tail pointer */
 
-      if (++(xmit->tail) >= xmit->size)
+      xmit->tail += ncopy;
+      if (xmit->tail >= xmit->size)
         {
           xmit->tail = 0;
         }
@@ -960,6 +1003,17 @@ static void cdcacm_resetconfig(FAR struct cdcacm_dev_s *priv)
       EP_DISABLE(priv->epintin);
       EP_DISABLE(priv->epbulkin);
       EP_DISABLE(priv->epbulkout);
+
+#ifdef CONFIG_CDCACM_DIRECTIO
+      /* Wake up a reader waiting for data that will not arrive */
+
+      if (priv->rdbuf != NULL)
+        {
+          priv->rdbuf    = NULL;
+          priv->nrdbytes = -ENOTCONN;
+          nxsem_post(&priv->rdsem);
+        }
+#endif
     }
 }
 
@@ -1198,9 +1252,33 @@ static void cdcacm_rdcomplete(FAR struct usbdev_ep_s *ep,
       {
         usbtrace(TRACE_CLASSRDCOMPLETE, priv->nrdq);
 
+        rdcontainer->offset = 0;
+
+#ifdef CONFIG_CDCACM_DIRECTIO
+        /* If a reader waits for data, give it the packet directly.  Any
+         * data that does not fit goes through the RX buffer as usual.
+         */
+
+        if (priv->rdbuf != NULL && req->xfrd > 0 &&
+            sq_empty(&priv->rxpending))
+          {
+            rdcontainer->offset = MIN(req->xfrd, priv->rdlen);
+            memcpy(priv->rdbuf, req->buf, rdcontainer->offset);
+
+            priv->nrdbytes = rdcontainer->offset;
+            priv->rdbuf    = NULL;
+            nxsem_post(&priv->rdsem);
+
+            if (rdcontainer->offset >= req->xfrd)
+              {
+                cdcacm_requeue_rdrequest(priv, rdcontainer);
+                break;
+              }
+          }
+#endif
+
         /* Place the incoming packet at the end of pending RX packet list. */
 
-        rdcontainer->offset = 0;
         sq_addlast((FAR sq_entry_t *)rdcontainer, &priv->rxpending);
 
         /* Then process all pending RX packet starting at the head of the
@@ -1264,6 +1342,21 @@ static void cdcacm_wrcomplete(FAR struct usbdev_ep_s *ep,
   /* Return the write request to the free list */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_CDCACM_DIRECTIO
+  /* Give the request of a direct write its own buffer back and wake up the
+   * writer.
+   */
+
+  if (wrcontainer == priv->wrdirect)
+    {
+      req->buf       = priv->wrbuf;
+      priv->nwrbytes = req->result < 0 ? req->result : req->xfrd;
+      priv->wrdirect = NULL;
+      nxsem_post(&priv->wrsem);
+    }
+#endif
+
   sq_addlast((FAR sq_entry_t *)wrcontainer, &priv->txfree);
   priv->nwrq++;
   leave_critical_section(flags);
@@ -2870,6 +2963,165 @@ static bool cdcuart_txempty(FAR struct uart_dev_s *dev)
   return priv->nwrq >= CONFIG_CDCACM_NWRREQS;
 }
 
+/****************************************************************************
+ * Name: cdcuart_directwrite
+ *
+ * Description:
+ *   Send the caller's buffer without copying it:  The buffer is submitted
+ *   to the bulk IN endpoint in place of the request's own buffer.  Returns
+ *   when the transfer is complete.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCACM_DIRECTIO
+static ssize_t cdcuart_directwrite(FAR struct uart_dev_s *dev,
+                                   FAR const char *buffer, size_t buflen)
+{
+  FAR struct cdcacm_dev_s *priv = (FAR struct cdcacm_dev_s *)dev->priv;
+  FAR struct usbdev_ep_s *ep = priv->epbulkin;
+  FAR struct cdcacm_wrreq_s *wrcontainer;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+  size_t nsent = 0;
+  size_t maxlen;
+  int ret;
+
+  /* Short writes and unaligned buffers go through the TX buffer */
+
+  if (priv->config == CDCACM_CONFIGIDNONE || buflen < ep->maxpacket ||
+      ((uintptr_t)buffer & (CONFIG_CDCACM_DIRECTIO_ALIGN - 1)) != 0)
+    {
+      return 0;
+    }
+
+  /* Requests other than the last one must be a multiple of the max packet
+   * size, otherwise the host would see the end of the transfer.
+   */
+
+  maxlen = UINT16_MAX - UINT16_MAX % ep->maxpacket;
+
+  while (nsent < buflen)
+    {
+      flags = enter_critical_section();
+
+      /* Buffered data may still be in flight.  Only our own request is in
+       * flight after the first one completed, so it is free again then.
+       */
+
+      wrcontainer = (FAR struct cdcacm_wrreq_s *)sq_remfirst(&priv->txfree);
+      if (wrcontainer == NULL)
+        {
+          leave_critical_section(flags);
+          return 0;
+        }
+
+      priv->nwrq--;
+
+      req            = wrcontainer->req;
+      priv->wrdirect = wrcontainer;
+      priv->wrbuf    = req->buf;
+
+      req->buf       = (FAR uint8_t *)buffer + nsent;
+      req->len       = MIN(buflen - nsent, maxlen);
+      req->priv      = wrcontainer;
+      req->flags     = nsent + req->len >= buflen ?
+                       USBDEV_REQFLAGS_NULLPKT : 0;
+
+      ret = EP_SUBMIT(ep, req);
+      if (ret != OK)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_SUBMITFAIL),
+                   (uint16_t)-ret);
+
+          req->buf       = priv->wrbuf;
+          priv->wrdirect = NULL;
+          sq_addlast((FAR sq_entry_t *)wrcontainer, &priv->txfree);
+          priv->nwrq++;
+          leave_critical_section(flags);
+          return nsent > 0 ? (ssize_t)nsent : ret;
+        }
+
+      leave_critical_section(flags);
+
+      /* The controller accesses the caller's buffer until the request
+       * completes, so we must not return before.  A disconnection also
+       * completes (cancels) the request.
+       */
+
+      nxsem_wait_uninterruptible(&priv->wrsem);
+      if (priv->nwrbytes < 0)
+        {
+          return nsent > 0 ? (ssize_t)nsent : priv->nwrbytes;
+        }
+
+      nsent += priv->nwrbytes;
+    }
+
+  return nsent;
+}
+#endif
+
+/****************************************************************************
+ * Name: cdcuart_directread
+ *
+ * Description:
+ *   Wait for the next packet and receive it directly into the caller's
+ *   buffer.  Only used while the RX buffer is empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCACM_DIRECTIO
+static ssize_t cdcuart_directread(FAR struct uart_dev_s *dev,
+                                  FAR char *buffer, size_t buflen)
+{
+  FAR struct cdcacm_dev_s *priv = (FAR struct cdcacm_dev_s *)dev->priv;
+  irqstate_t flags;
+  ssize_t ret;
+
+  flags = enter_critical_section();
+
+  /* Data that reached the RX buffer or that waits for space in it must be
+   * returned first.
+   */
+
+  if (priv->config == CDCACM_CONFIGIDNONE ||
+      dev->recv.head != dev->recv.tail || !sq_empty(&priv->rxpending))
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  /* cdcacm_rdcomplete() copies the next packet into the buffer */
+
+  priv->rdbuf    = buffer;
+  priv->rdlen    = buflen;
+  priv->nrdbytes = 0;
+
+  ret = nxsem_wait(&priv->rdsem);
+  if (ret < 0)
+    {
+      if (priv->rdbuf != NULL)
+        {
+          priv->rdbuf = NULL;
+        }
+      else
+        {
+          /* The data arrived together with the signal */
+
+          nxsem_trywait(&priv->rdsem);
+          ret = priv->nrdbytes;
+        }
+    }
+  else
+    {
+      ret = priv->nrdbytes;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -2926,6 +3178,13 @@ int cdcacm_classobject(int minor, FAR struct usbdev_devinfo_s *devinfo,
   sq_init(&priv->txfree);
   sq_init(&priv->rxpending);
 
+#ifdef CONFIG_CDCACM_DIRECTIO
+  nxsem_init(&priv->wrsem, 0, 0);
+  nxsem_set_protocol(&priv->wrsem, SEM_PRIO_NONE);
+  nxsem_init(&priv->rdsem, 0, 0);
+  nxsem_set_protocol(&priv->rdsem, SEM_PRIO_NONE);
+#endif
+
   priv->minor               = minor;
 
   /* Save the caller provided device description (composite only) */
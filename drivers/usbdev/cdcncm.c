@@ -0,0 +1,2626 @@
+/****************************************************************************
+ * drivers/usbdev/cdcncm.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* References:
+ *   [NCM1.0] Universal Serial Bus - Communications Class - Subclass
+ *            Specification for Ethernet Control Model Devices and Network
+ *            Control Model Devices - Rev 1.0
+ *
+ * The structure of this driver follows the CDC/ECM driver (cdcecm.c).  The
+ * difference is on the data interface:  Instead of one Ethernet frame per
+ * USB transfer, NCM exchanges Network Transfer Blocks (NTBs) that carry any
+ * number of frames.  Outgoing frames are collected in an NTB while the
+ * previous one is on the bus, so the number of USB transfers (and
+ * interrupts on both sides) under load is a fraction of the number of
+ * frames.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/usb/usbdev.h>
+#include <nuttx/usb/cdc.h>
+#include <nuttx/usb/usbdev_trace.h>
+
+#ifdef CONFIG_NET_PKT
+#  include <nuttx/net/pkt.h>
+#endif
+
+#include "cdcncm.h"
+
+#ifdef CONFIG_NET_CDCNCM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Work queue support is required. */
+
+#if !defined(CONFIG_SCHED_WORKQUEUE)
+#  error Work queue support is required in this configuration (CONFIG_SCHED_WORKQUEUE)
+#endif
+
+/* The low priority work queue is preferred.  If it is not enabled, LPWORK
+ * will be the same as HPWORK. NOTE: Use of the high priority work queue will
+ * have a negative impact on interrupt handling latency and overall system
+ * performance.  This should be avoided.
+ */
+
+#define ETHWORK LPWORK
+
+/* TX poll delay = 1 seconds.
+ * CLK_TCK is the number of clock ticks per second
+ */
+
+#define CDCNCM_WDDELAY   (1*CLK_TCK)
+
+/* Notifications sent on the interrupt IN endpoint when the host selects
+ * the data interface alternate setting 1.
+ */
+
+#define CDCNCM_NOTIFY_NONE    0
+#define CDCNCM_NOTIFY_SPEED   1
+#define CDCNCM_NOTIFY_CONNECT 2
+
+#define CDCNCM_NOTIFY_MAXLEN  SIZEOF_NOTIFICATION_S(8)
+
+/* This is a helper pointer for accessing the contents of Ethernet header */
+
+#define BUF ((struct eth_hdr_s *)self->dev.d_buf)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cdcncm_driver_s encapsulates all state information for a single
+ * hardware interface
+ */
+
+struct cdcncm_driver_s
+{
+  /* USB CDC-NCM device */
+
+  struct usbdevclass_driver_s  usbdev;      /* USB device class vtable */
+  struct usbdev_devinfo_s      devinfo;
+  FAR struct usbdev_req_s     *ctrlreq;     /* Allocated control request */
+  FAR struct usbdev_ep_s      *epint;       /* Interrupt IN endpoint */
+  FAR struct usbdev_ep_s      *epbulkin;    /* Bulk IN endpoint */
+  FAR struct usbdev_ep_s      *epbulkout;   /* Bulk OUT endpoint */
+  uint8_t                      config;      /* Selected configuration number */
+
+  uint8_t                      pktbuf[CONFIG_NET_ETH_PKTSIZE +
+                                      CONFIG_NET_GUARDSIZE];
+
+  struct usbdev_req_s         *notifyreq;   /* Interrupt IN request */
+  uint8_t                      notify;      /* Next notification to send */
+
+  struct usbdev_req_s         *rdreq;       /* Single read request (NTB) */
+  bool                         rxpending;   /* NTB available in rdreq */
+
+  /* IN NTBs.  Frames are added to wrreq[wrcur] while the other request
+   * may be in flight.
+   */
+
+  struct usbdev_req_s         *wrreq[2];    /* Write requests */
+  sem_t                        wrreq_idle;  /* No write request in flight */
+  bool                         txdone;      /* Did a write request complete? */
+  uint8_t                      wrcur;       /* The NTB being filled */
+  uint16_t                     ntbinsize;   /* IN NTB size set by the host */
+  uint16_t                     txseq;       /* wSequence of the next NTB */
+  uint16_t                     txlen;       /* Bytes used in the NTB */
+  uint16_t                     ndgrams;     /* Datagrams in the NTB */
+
+  /* Index and length of each datagram in the NTB */
+
+  uint16_t                     dgram[CONFIG_CDCNCM_MAXDATAGRAMS][2];
+
+  /* Network device */
+
+  bool                         bifup;       /* true:ifup false:ifdown */
+  struct wdog_s                txpoll;      /* TX poll timer */
+  struct work_s                irqwork;     /* For deferring interrupt work
+                                             * to the work queue */
+  struct work_s                pollwork;    /* For deferring poll work to
+                                             * the work queue */
+
+  /* This holds the information visible to the NuttX network */
+
+  struct net_driver_s          dev;         /* Interface understood by the
+                                             * network */
+  bool                         registered;  /* netdev is currently registered */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Network Device ***********************************************************/
+
+/* Common TX logic */
+
+static int  cdcncm_txflush(FAR struct cdcncm_driver_s *self, bool wait);
+static int  cdcncm_transmit(FAR struct cdcncm_driver_s *self);
+static int  cdcncm_txpoll(FAR struct net_driver_s *dev);
+
+/* Interrupt handling */
+
+static void cdcncm_reply(struct cdcncm_driver_s *self);
+static void cdcncm_input(FAR struct cdcncm_driver_s *self);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self);
+static void cdcncm_txdone(FAR struct cdcncm_driver_s *self);
+
+static void cdcncm_interrupt_work(FAR void *arg);
+
+/* Watchdog timer expirations */
+
+static void cdcncm_poll_work(FAR void *arg);
+static void cdcncm_poll_expiry(wdparm_t arg);
+
+/* NuttX callback functions */
+
+static int  cdcncm_ifup(FAR struct net_driver_s *dev);
+static int  cdcncm_ifdown(FAR struct net_driver_s *dev);
+
+static void cdcncm_txavail_work(FAR void *arg);
+static int  cdcncm_txavail(FAR struct net_driver_s *dev);
+
+#ifdef CONFIG_NET_MCASTGROUP
+static int  cdcncm_addmac(FAR struct net_driver_s *dev,
+              FAR const uint8_t *mac);
+static int  cdcncm_rmmac(FAR struct net_driver_s *dev,
+              FAR const uint8_t *mac);
+#endif
+
+/* USB Device Class Driver **************************************************/
+
+/* USB Device Class methods */
+
+static int  cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev);
+
+static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev);
+
+static int  cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev, FAR const struct usb_ctrlreq_s *ctrl,
+              FAR uint8_t *dataout, size_t outlen);
+
+static void cdcncm_disconnect(FAR struct usbdevclass_driver_s *driver,
+                              FAR struct usbdev_s *dev);
+
+/* USB Device Class helpers */
+
+static struct usbdev_req_s *cdcncm_allocreq(FAR struct usbdev_ep_s *ep,
+              uint16_t len);
+static void cdcncm_freereq(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+
+static void cdcncm_ep0incomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_intcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+
+static void cdcncm_mkepdesc(int epidx,
+              FAR struct usb_epdesc_s *epdesc,
+              FAR struct usbdev_devinfo_s *devinfo, bool hispeed);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* USB Device Class Methods */
+
+static const struct usbdevclass_driverops_s g_usbdevops =
+{
+  cdcncm_bind,
+  cdcncm_unbind,
+  cdcncm_setup,
+  cdcncm_disconnect,
+  NULL,
+  NULL
+};
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+static const struct usb_devdesc_s g_devdesc =
+{
+  USB_SIZEOF_DEVDESC,
+  USB_DESC_TYPE_DEVICE,
+  {
+    LSBYTE(0x0200),
+    MSBYTE(0x0200)
+  },
+  USB_CLASS_CDC,
+  CDC_SUBCLASS_NONE,
+  CDC_PROTO_NONE,
+  CONFIG_CDCNCM_EP0MAXPACKET,
+  {
+    LSBYTE(CONFIG_CDCNCM_VENDORID),
+    MSBYTE(CONFIG_CDCNCM_VENDORID)
+  },
+  {
+    LSBYTE(CONFIG_CDCNCM_PRODUCTID),
+    MSBYTE(CONFIG_CDCNCM_PRODUCTID)
+  },
+  {
+    LSBYTE(CDCNCM_VERSIONNO),
+    MSBYTE(CDCNCM_VERSIONNO)
+  },
+  CDCNCM_MANUFACTURERSTRID,
+  CDCNCM_PRODUCTSTRID,
+  CDCNCM_SERIALSTRID,
+  CDCNCM_NCONFIGS
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_putuint16 and cdcncm_putuint32
+ *
+ * Description:
+ *   Store a little endian value in an NTB or in a class specific structure.
+ *
+ ****************************************************************************/
+
+static inline void cdcncm_putuint16(FAR uint8_t *dest, uint16_t value)
+{
+  dest[0] = LSBYTE(value);
+  dest[1] = MSBYTE(value);
+}
+
+static inline void cdcncm_putuint32(FAR uint8_t *dest, uint32_t value)
+{
+  cdcncm_putuint16(dest, (uint16_t)value);
+  cdcncm_putuint16(dest + 2, (uint16_t)(value >> 16));
+}
+
+/****************************************************************************
+ * Name: cdcncm_txreset
+ *
+ * Description:
+ *   Start a new, empty IN NTB.
+ *
+ ****************************************************************************/
+
+static void cdcncm_txreset(FAR struct cdcncm_driver_s *self)
+{
+  self->txlen   = SIZEOF_NCM_NTH16;
+  self->ndgrams = 0;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txroom
+ *
+ * Description:
+ *   Check if a datagram of 'len' bytes still fits into the current IN NTB,
+ *   together with the NDP that will be appended when the NTB is sent.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_txroom(FAR struct cdcncm_driver_s *self, uint16_t len)
+{
+  uint32_t end;
+
+  if (self->ndgrams >= CONFIG_CDCNCM_MAXDATAGRAMS)
+    {
+      return false;
+    }
+
+  /* The datagram, the NDP with one more entry and the null entry */
+
+  end = CDCNCM_NTB_ALIGNUP(self->txlen) + len;
+  end = CDCNCM_NTB_ALIGNUP(end) + SIZEOF_NCM_NDP16(self->ndgrams + 2);
+
+  return end <= self->ntbinsize;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txflush
+ *
+ * Description:
+ *   Complete the current IN NTB with its header and NDP and submit it.
+ *   Nothing is done if the NTB is empty.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *   wait - Wait for the previous NTB to complete.  Otherwise -EBUSY is
+ *          returned if it is still in flight; the NTB will then be sent
+ *          when the write completes.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_txflush(FAR struct cdcncm_driver_s *self, bool wait)
+{
+  FAR struct usbdev_req_s *req;
+  FAR struct cdc_ncm_nth16_s *nth;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  uint16_t ndpindex;
+  uint16_t ndplen;
+  int ret;
+  int i;
+
+  if (self->ndgrams == 0)
+    {
+      return OK;
+    }
+
+  if (wait)
+    {
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
+    }
+  else if (nxsem_trywait(&self->wrreq_idle) != OK)
+    {
+      return -EBUSY;
+    }
+
+  req = self->wrreq[self->wrcur];
+
+  /* The NDP follows the last datagram */
+
+  ndpindex = CDCNCM_NTB_ALIGNUP(self->txlen);
+  ndplen   = SIZEOF_NCM_NDP16(self->ndgrams + 1);
+  ndp      = (FAR struct cdc_ncm_ndp16_s *)&req->buf[ndpindex];
+
+  cdcncm_putuint32(ndp->signature, NCM_NDP16_NOCRC_SIGNATURE);
+  cdcncm_putuint16(ndp->len, ndplen);
+  cdcncm_putuint16(ndp->nextindex, 0);
+
+  for (i = 0; i < self->ndgrams; i++)
+    {
+      cdcncm_putuint16(ndp->dgram[i][0], self->dgram[i][0]);
+      cdcncm_putuint16(ndp->dgram[i][1], self->dgram[i][1]);
+    }
+
+  cdcncm_putuint16(ndp->dgram[i][0], 0);
+  cdcncm_putuint16(ndp->dgram[i][1], 0);
+
+  /* And the NTH16 comes first */
+
+  nth = (FAR struct cdc_ncm_nth16_s *)req->buf;
+  cdcncm_putuint32(nth->signature, NCM_NTH16_SIGNATURE);
+  cdcncm_putuint16(nth->hdrlen, SIZEOF_NCM_NTH16);
+  cdcncm_putuint16(nth->sequence, self->txseq++);
+  cdcncm_putuint16(nth->blklen, ndpindex + ndplen);
+  cdcncm_putuint16(nth->ndpindex, ndpindex);
+
+  req->len = ndpindex + ndplen;
+
+  /* Continue with the other request */
+
+  self->wrcur ^= 1;
+  cdcncm_txreset(self);
+
+  ret = EP_SUBMIT(self->epbulkin, req);
+  if (ret < 0)
+    {
+      uerr("EP_SUBMIT failed. ret %d\n", ret);
+      NETDEV_TXERRORS(&self->dev);
+      nxsem_post(&self->wrreq_idle);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit
+ *
+ * Description:
+ *   Add the frame in d_buf to the current IN NTB.  The NTB is sent when it
+ *   is full or when the caller calls cdcncm_txflush().
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_transmit(FAR struct cdcncm_driver_s *self)
+{
+  FAR uint8_t *buf;
+  uint16_t index;
+
+  /* If the frame does not fit, send the current NTB first.  This waits
+   * until the previous one has been sent.
+   */
+
+  if (!cdcncm_txroom(self, self->dev.d_len))
+    {
+      cdcncm_txflush(self, true);
+    }
+
+  /* Increment statistics */
+
+  NETDEV_TXPACKETS(&self->dev);
+
+  /* Add the packet: address=self->dev.d_buf, length=self->dev.d_len */
+
+  buf   = self->wrreq[self->wrcur]->buf;
+  index = CDCNCM_NTB_ALIGNUP(self->txlen);
+
+  memcpy(&buf[index], self->dev.d_buf, self->dev.d_len);
+
+  self->dgram[self->ndgrams][0] = index;
+  self->dgram[self->ndgrams][1] = self->dev.d_len;
+  self->ndgrams++;
+  self->txlen = index + self->dev.d_len;
+
+  /* Send the NTB right away if it cannot take another full frame, unless
+   * the previous one is still in flight.
+   */
+
+  if (!cdcncm_txroom(self, CONFIG_NET_ETH_PKTSIZE))
+    {
+      cdcncm_txflush(self, false);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txpoll
+ *
+ * Description:
+ *   The transmitter is available, check if the network has any outgoing
+ *   packets ready to send.  This is a callback from devif_poll().
+ *   devif_poll() may be called:
+ *
+ *   1. When the preceding TX packet send is complete,
+ *   2. When the preceding TX packet send times out and the interface is
+ *      reset
+ *   3. During normal TX polling
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *self =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+  /* If the polling resulted in data that should be sent out on the network,
+   * the field d_len is set to a value > 0.
+   */
+
+  if (self->dev.d_len > 0)
+    {
+      /* Look up the destination MAC address and add it to the Ethernet
+       * header.
+       */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (IFF_IS_IPv4(self->dev.d_flags))
+#endif
+        {
+          arp_out(&self->dev);
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          neighbor_out(&self->dev);
+        }
+#endif /* CONFIG_NET_IPv6 */
+
+      if (!devif_loopback(&self->dev))
+        {
+          /* Add the packet to the NTB.  There is always room for another
+           * one, so continue the poll:  All packets produced by this poll
+           * go out in as few NTBs as possible.
+           */
+
+          cdcncm_transmit(self);
+        }
+    }
+
+  /* If zero is returned, the polling will continue until all connections
+   * have been examined.
+   */
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: cdcncm_reply
+ *
+ * Description:
+ *   After a packet has been received and dispatched to the network, it
+ *   may return return with an outgoing packet.  This function checks for
+ *   that case and performs the transmission if necessary.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_reply(struct cdcncm_driver_s *self)
+{
+  /* If the packet dispatch resulted in data that should be sent out on the
+   * network, the field d_len will set to a value > 0.
+   */
+
+  if (self->dev.d_len > 0)
+    {
+      /* Update the Ethernet header with the correct MAC address */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      /* Check for an outgoing IPv4 packet */
+
+      if (IFF_IS_IPv4(self->dev.d_flags))
+#endif
+        {
+          arp_out(&self->dev);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      /* Otherwise, it must be an outgoing IPv6 packet */
+
+      else
+#endif
+        {
+          neighbor_out(&self->dev);
+        }
+#endif
+
+      /* And add the packet to the NTB */
+
+      cdcncm_transmit(self);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_input
+ *
+ * Description:
+ *   Dispatch the frame in d_buf to the network.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_input(FAR struct cdcncm_driver_s *self)
+{
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(&self->dev);
+#endif
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (BUF->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(&self->dev);
+
+      /* Handle ARP on input, then dispatch IPv4 packet to the network
+       * layer.
+       */
+
+      arp_ipin(&self->dev);
+      ipv4_input(&self->dev);
+
+      /* Check for a reply to the IPv4 packet */
+
+      cdcncm_reply(self);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (BUF->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(&self->dev);
+
+      /* Dispatch IPv6 packet to the network layer */
+
+      ipv6_input(&self->dev);
+
+      /* Check for a reply to the IPv6 packet */
+
+      cdcncm_reply(self);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (BUF->type == htons(ETHTYPE_ARP))
+    {
+      /* Dispatch ARP packet to the network layer */
+
+      arp_arpin(&self->dev);
+      NETDEV_RXARP(&self->dev);
+
+      /* If the above function invocation resulted in data that should be
+       * sent out on the network, d_len field will set to a value > 0.
+       */
+
+      if (self->dev.d_len > 0)
+        {
+          cdcncm_transmit(self);
+        }
+    }
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(&self->dev);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_receive
+ *
+ * Description:
+ *   An OUT NTB was received.  Walk its NDPs and pass every datagram to the
+ *   network.  Replies are collected in one IN NTB.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+{
+  FAR const uint8_t *buf = self->rdreq->buf;
+  uint16_t blklen;
+  uint16_t ndpindex;
+  uint16_t ndplen;
+  uint16_t index;
+  uint16_t len;
+  int nndps = 0;
+  int i;
+
+  /* Check the NTH16 */
+
+  if (self->rdreq->xfrd < SIZEOF_NCM_NTH16 ||
+      GETUINT32(buf) != NCM_NTH16_SIGNATURE ||
+      GETUINT16((buf + 4)) != SIZEOF_NCM_NTH16)
+    {
+      nwarn("WARNING: Bad NTH16\n");
+      NETDEV_RXERRORS(&self->dev);
+      return;
+    }
+
+  blklen   = GETUINT16((buf + 8));
+  ndpindex = GETUINT16((buf + 10));
+
+  if (blklen > self->rdreq->xfrd)
+    {
+      nwarn("WARNING: Truncated NTB: %u > %u\n", blklen, self->rdreq->xfrd);
+      NETDEV_RXERRORS(&self->dev);
+      return;
+    }
+
+  /* Then each NDP16 of the chain.  The number of NDPs is limited so that
+   * a malformed chain cannot loop.
+   */
+
+  while (ndpindex != 0 && nndps++ < 8)
+    {
+      if ((ndpindex & 3) != 0 ||
+          ndpindex + SIZEOF_NCM_NDP16(1) > blklen ||
+          GETUINT32((buf + ndpindex)) != NCM_NDP16_NOCRC_SIGNATURE)
+        {
+          nwarn("WARNING: Bad NDP16 at %u\n", ndpindex);
+          NETDEV_RXERRORS(&self->dev);
+          break;
+        }
+
+      ndplen = GETUINT16((buf + ndpindex + 4));
+      if (ndplen < SIZEOF_NCM_NDP16(2) || ndpindex + ndplen > blklen)
+        {
+          nwarn("WARNING: Bad NDP16 length: %u\n", ndplen);
+          NETDEV_RXERRORS(&self->dev);
+          break;
+        }
+
+      for (i = 8; i + 4 <= ndplen; i += 4)
+        {
+          index = GETUINT16((buf + ndpindex + i));
+          len   = GETUINT16((buf + ndpindex + i + 2));
+
+          if (index == 0 || len == 0)
+            {
+              break;
+            }
+
+          if (len > CONFIG_NET_ETH_PKTSIZE || index + len > blklen)
+            {
+              NETDEV_RXDROPPED(&self->dev);
+              continue;
+            }
+
+          NETDEV_RXPACKETS(&self->dev);
+
+          /* Copy the datagram to self->dev.d_buf and dispatch it */
+
+          memcpy(self->dev.d_buf, &buf[index], len);
+          self->dev.d_len = len;
+
+          cdcncm_input(self);
+        }
+
+      ndpindex = GETUINT16((buf + ndpindex + 6));
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_txdone
+ *
+ * Description:
+ *   An interrupt was received indicating that the last IN NTB is done
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_txdone(FAR struct cdcncm_driver_s *self)
+{
+  /* Check for errors and update statistics */
+
+  NETDEV_TXDONE(&self->dev);
+
+  /* Send the frames collected while the NTB was in flight, then poll the
+   * network for new TX data.
+   */
+
+  cdcncm_txflush(self, false);
+  devif_poll(&self->dev, cdcncm_txpoll);
+}
+
+/****************************************************************************
+ * Name: cdcncm_interrupt_work
+ *
+ * Description:
+ *   Perform interrupt related work from the worker thread
+ *
+ * Input Parameters:
+ *   arg - The argument passed when work_queue() was called.
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   Runs on a worker thread.
+ *
+ ****************************************************************************/
+
+static void cdcncm_interrupt_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  irqstate_t flags;
+
+  net_lock();
+
+  /* Check if we received an incoming NTB, if so, call cdcncm_receive() */
+
+  if (self->rxpending)
+    {
+      cdcncm_receive(self);
+
+      flags = enter_critical_section();
+      self->rxpending = false;
+      EP_SUBMIT(self->epbulkout, self->rdreq);
+      leave_critical_section(flags);
+    }
+
+  /* Check if an NTB transmission just completed. */
+
+  if (self->txdone)
+    {
+      flags = enter_critical_section();
+      self->txdone = false;
+      leave_critical_section(flags);
+
+      cdcncm_txdone(self);
+    }
+
+  /* Send any replies now, or when the NTB in flight completes */
+
+  cdcncm_txflush(self, false);
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_poll_work
+ *
+ * Description:
+ *   Perform periodic polling from the worker thread
+ *
+ * Input Parameters:
+ *   arg - The argument passed when work_queue() as called.
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ * Assumptions:
+ *   Run on a work queue thread.
+ *
+ ****************************************************************************/
+
+static void cdcncm_poll_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+
+  net_lock();
+
+  /* Perform the poll.  We are always able to accept another packet, since
+   * cdcncm_transmit will just wait until an NTB becomes available.
+   */
+
+  devif_timer(&self->dev, CDCNCM_WDDELAY, cdcncm_txpoll);
+  cdcncm_txflush(self, false);
+
+  /* Setup the watchdog poll timer again */
+
+  wd_start(&self->txpoll, CDCNCM_WDDELAY,
+           cdcncm_poll_expiry, (wdparm_t)self);
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_poll_expiry
+ *
+ * Description:
+ *   Periodic timer handler.  Called from the timer interrupt handler.
+ *
+ * Input Parameters:
+ *   arg  - The argument
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs in the context of a the timer interrupt handler.  Local
+ *   interrupts are disabled by the interrupt logic.
+ *
+ ****************************************************************************/
+
+static void cdcncm_poll_expiry(wdparm_t arg)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+
+  /* Schedule to perform the interrupt processing on the worker thread. */
+
+  work_queue(ETHWORK, &self->pollwork, cdcncm_poll_work, self, 0);
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifup
+ *
+ * Description:
+ *   NuttX Callback: Bring up the Ethernet interface when an IP address is
+ *   provided
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifup(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *self =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+#ifdef CONFIG_NET_IPv4
+  ninfo("Bringing up: %d.%d.%d.%d\n",
+        dev->d_ipaddr & 0xff, (dev->d_ipaddr >> 8) & 0xff,
+        (dev->d_ipaddr >> 16) & 0xff, dev->d_ipaddr >> 24);
+#endif
+
+  /* Set and activate a timer process */
+
+  wd_start(&self->txpoll, CDCNCM_WDDELAY,
+           cdcncm_poll_expiry, (wdparm_t)self);
+
+  self->bifup = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifdown
+ *
+ * Description:
+ *   NuttX Callback: Stop the interface.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifdown(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *self =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* Cancel the TX poll timer */
+
+  wd_cancel(&self->txpoll);
+
+  /* Mark the device "down" */
+
+  self->bifup = false;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txavail_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the NuttX driver state structure (cast to void*)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs on a work queue thread.
+ *
+ ****************************************************************************/
+
+static void cdcncm_txavail_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+
+  net_lock();
+
+  /* Ignore the notification if the interface is not yet up */
+
+  if (self->bifup)
+    {
+      devif_poll(&self->dev, cdcncm_txpoll);
+      cdcncm_txflush(self, false);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_txavail
+ *
+ * Description:
+ *   Driver callback invoked when new TX data is available.  This is a
+ *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
+ *   latency.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_txavail(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_driver_s *self =
+    (FAR struct cdcncm_driver_s *)dev->d_private;
+
+  /* Is our single work structure available?  It may not be if there are
+   * pending interrupt actions and we will have to ignore the Tx
+   * availability action.
+   */
+
+  if (work_available(&self->pollwork))
+    {
+      /* Schedule to serialize the poll on the worker thread. */
+
+      work_queue(ETHWORK, &self->pollwork, cdcncm_txavail_work, self, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_addmac and cdcncm_rmmac
+ *
+ * Description:
+ *   NuttX Callback: Add or remove a multicast MAC address.  The host does
+ *   all filtering, so there is nothing to do.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MCASTGROUP
+static int cdcncm_addmac(FAR struct net_driver_s *dev,
+                         FAR const uint8_t *mac)
+{
+  return OK;
+}
+
+static int cdcncm_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
+{
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * USB Device Class Helpers
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_ep0incomplete
+ *
+ * Description:
+ *   Handle completion of EP0 control operations
+ *
+ ****************************************************************************/
+
+static void cdcncm_ep0incomplete(FAR struct usbdev_ep_s *ep,
+                                 FAR struct usbdev_req_s *req)
+{
+  if (req->result || req->xfrd != req->len)
+    {
+      uerr("result: %hd, xfrd: %hu\n", req->result, req->xfrd);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_notify
+ *
+ * Description:
+ *   Send the next pending notification on the interrupt IN endpoint:  The
+ *   connection speed, then the connection state.  The host does not use
+ *   the data interface before it has seen both.
+ *
+ ****************************************************************************/
+
+static void cdcncm_notify(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct usbdev_req_s *req = self->notifyreq;
+  FAR struct cdc_notification_s *notify;
+  uint32_t speed;
+
+  notify = (FAR struct cdc_notification_s *)req->buf;
+  notify->type     = USB_REQ_DIR_IN | USB_REQ_TYPE_CLASS |
+                     USB_REQ_RECIPIENT_INTERFACE;
+  notify->index[0] = LSBYTE(self->devinfo.ifnobase);
+  notify->index[1] = MSBYTE(self->devinfo.ifnobase);
+
+  switch (self->notify)
+    {
+      case CDCNCM_NOTIFY_SPEED:
+        speed = self->usbdev.speed == USB_SPEED_HIGH ? 480000000 : 12000000;
+
+        notify->notification = ECM_SPEED_CHANGE;
+        cdcncm_putuint16(notify->value, 0);
+        cdcncm_putuint16(notify->len, 8);
+        cdcncm_putuint32(&notify->data[0], speed);
+        cdcncm_putuint32(&notify->data[4], speed);
+        req->len = SIZEOF_NOTIFICATION_S(8);
+
+        self->notify = CDCNCM_NOTIFY_CONNECT;
+        break;
+
+      case CDCNCM_NOTIFY_CONNECT:
+        notify->notification = ECM_NETWORK_CONNECTION;
+        cdcncm_putuint16(notify->value, 1);
+        cdcncm_putuint16(notify->len, 0);
+        req->len = SIZEOF_NOTIFICATION_S(0);
+
+        self->notify = CDCNCM_NOTIFY_NONE;
+        break;
+
+      default:
+        return;
+    }
+
+  if (EP_SUBMIT(self->epint, req) < 0)
+    {
+      uerr("EP_SUBMIT failed\n");
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_intcomplete
+ *
+ * Description:
+ *   Handle completion of a notification on the interrupt IN endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_intcomplete(FAR struct usbdev_ep_s *ep,
+                               FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+
+  if (req->result == OK)
+    {
+      cdcncm_notify(self);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_rdcomplete
+ *
+ * Description:
+ *   Handle completion of read request on the bulk OUT endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+
+  uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
+        req->buf, req->flags, req->len, req->xfrd, req->result);
+
+  switch (req->result)
+    {
+      case 0:  /* Normal completion */
+        {
+          DEBUGASSERT(!self->rxpending);
+          self->rxpending = true;
+          work_queue(ETHWORK, &self->irqwork,
+                     cdcncm_interrupt_work, self, 0);
+        }
+        break;
+
+      case -ESHUTDOWN:  /* Disconnection */
+        break;
+
+      default: /* Some other error occurred */
+        {
+          uerr("req->result: %hd\n", req->result);
+          EP_SUBMIT(self->epbulkout, self->rdreq);
+        }
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_wrcomplete
+ *
+ * Description:
+ *   Handle completion of write request.  This function probably executes
+ *   in the context of an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+  int rc;
+
+  uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
+        req->buf, req->flags, req->len, req->xfrd, req->result);
+
+  /* The next NTB may be sent now */
+
+  rc = nxsem_post(&self->wrreq_idle);
+
+  if (rc != OK)
+    {
+      nerr("nxsem_post failed! rc: %d\n", rc);
+    }
+
+  /* Send the frames collected in the meantime and poll the network */
+
+  self->txdone = true;
+  work_queue(ETHWORK, &self->irqwork, cdcncm_interrupt_work, self, 0);
+}
+
+/****************************************************************************
+ * Name: cdcncm_allocreq
+ *
+ * Description:
+ *   Allocate a request instance along with its buffer
+ *
+ ****************************************************************************/
+
+static struct usbdev_req_s *cdcncm_allocreq(FAR struct usbdev_ep_s *ep,
+                                            uint16_t len)
+{
+  FAR struct usbdev_req_s *req;
+
+  req = EP_ALLOCREQ(ep);
+
+  if (req != NULL)
+    {
+      req->len   = len;
+      req->buf   = EP_ALLOCBUFFER(ep, len);
+      req->flags = USBDEV_REQFLAGS_NULLPKT;
+
+      if (req->buf == NULL)
+        {
+          EP_FREEREQ(ep, req);
+          req = NULL;
+        }
+    }
+
+  return req;
+}
+
+/****************************************************************************
+ * Name: cdcncm_freereq
+ *
+ * Description:
+ *   Free a request instance along with its buffer
+ *
+ ****************************************************************************/
+
+static void cdcncm_freereq(FAR struct usbdev_ep_s *ep,
+                           FAR struct usbdev_req_s *req)
+{
+  if (ep != NULL && req != NULL)
+    {
+      if (req->buf != NULL)
+        {
+          EP_FREEBUFFER(ep, req->buf);
+        }
+
+      EP_FREEREQ(ep, req);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_resetconfig
+ *
+ * Description:
+ *   Mark the device as not configured and disable all endpoints.
+ *
+ ****************************************************************************/
+
+static void cdcncm_resetconfig(FAR struct cdcncm_driver_s *self)
+{
+  /* Are we configured? */
+
+  if (self->config != CDCNCM_CONFIGID_NONE)
+    {
+      /* Yes.. but not anymore */
+
+      self->config = CDCNCM_CONFIGID_NONE;
+      self->notify = CDCNCM_NOTIFY_NONE;
+
+      /* Inform the networking layer that the link is down */
+
+      self->dev.d_ifdown(&self->dev);
+
+      /* Disable endpoints.  This should force completion of all pending
+       * transfers.
+       */
+
+      EP_DISABLE(self->epint);
+      EP_DISABLE(self->epbulkin);
+      EP_DISABLE(self->epbulkout);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_setconfig
+ *
+ *   Set the device configuration by allocating and configuring endpoints and
+ *   by allocating and queue read and write requests.
+ *
+ ****************************************************************************/
+
+static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
+{
+  struct usb_epdesc_s epdesc;
+  bool hispeed = (self->usbdev.speed == USB_SPEED_HIGH);
+  int ret = OK;
+
+  if (config == self->config)
+    {
+      return OK;
+    }
+
+  cdcncm_resetconfig(self);
+
+  if (config == CDCNCM_CONFIGID_NONE)
+    {
+      return OK;
+    }
+
+  if (config != CDCNCM_CONFIGID)
+    {
+      return -EINVAL;
+    }
+
+  cdcncm_mkepdesc(CDCNCM_EP_INTIN_IDX, &epdesc, &self->devinfo, hispeed);
+  ret = EP_CONFIGURE(self->epint, &epdesc, false);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epint->priv = self;
+
+  cdcncm_mkepdesc(CDCNCM_EP_BULKIN_IDX, &epdesc, &self->devinfo, hispeed);
+  ret = EP_CONFIGURE(self->epbulkin, &epdesc, false);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epbulkin->priv = self;
+
+  cdcncm_mkepdesc(CDCNCM_EP_BULKOUT_IDX, &epdesc, &self->devinfo, hispeed);
+  ret = EP_CONFIGURE(self->epbulkout, &epdesc, true);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epbulkout->priv = self;
+
+  /* Start with empty NTBs of the default size */
+
+  self->ntbinsize = CONFIG_CDCNCM_NTB_INSIZE;
+  self->txseq     = 0;
+  cdcncm_txreset(self);
+
+  /* Queue read requests in the bulk OUT endpoint */
+
+  DEBUGASSERT(!self->rxpending);
+
+  self->rdreq->callback = cdcncm_rdcomplete;
+  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
+  if (ret != OK)
+    {
+      uerr("EP_SUBMIT failed. ret %d\n", ret);
+      goto error;
+    }
+
+  /* We are successfully configured */
+
+  self->config = config;
+
+  /* Report link up to networking layer */
+
+  if (self->dev.d_ifup(&self->dev) == OK)
+    {
+      self->dev.d_flags |= IFF_UP;
+    }
+
+  return OK;
+
+error:
+  cdcncm_resetconfig(self);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_setinterface
+ *
+ *   The host selects the alternate setting 1 of the data interface when it
+ *   starts to use the network.  Tell it that the link is up.
+ *
+ ****************************************************************************/
+
+static int cdcncm_setinterface(FAR struct cdcncm_driver_s *self,
+                               uint16_t interface, uint16_t altsetting)
+{
+  uinfo("interface: %hu, altsetting: %hu\n", interface, altsetting);
+
+  if (interface == self->devinfo.ifnobase + 1 && altsetting == 1 &&
+      self->config != CDCNCM_CONFIGID_NONE)
+    {
+      self->notify = CDCNCM_NOTIFY_SPEED;
+      cdcncm_notify(self);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkstrdesc
+ *
+ * Description:
+ *   Construct a string descriptor
+ *
+ ****************************************************************************/
+
+static int cdcncm_mkstrdesc(uint8_t id, FAR struct usb_strdesc_s *strdesc)
+{
+  const char *str;
+  int len;
+  int ndata;
+  int i;
+
+  switch (id)
+    {
+#ifndef CONFIG_CDCNCM_COMPOSITE
+    case 0:
+      {
+        /* Descriptor 0 is the language id */
+
+        strdesc->len     = 4;
+        strdesc->type    = USB_DESC_TYPE_STRING;
+        strdesc->data[0] = LSBYTE(CDCNCM_STR_LANGUAGE);
+        strdesc->data[1] = MSBYTE(CDCNCM_STR_LANGUAGE);
+        return 4;
+      }
+
+    case CDCNCM_MANUFACTURERSTRID:
+      str = CONFIG_CDCNCM_VENDORSTR;
+      break;
+
+    case CDCNCM_PRODUCTSTRID:
+      str = CONFIG_CDCNCM_PRODUCTSTR;
+      break;
+
+    case CDCNCM_SERIALSTRID:
+      str = "0";
+      break;
+
+    case CDCNCM_CONFIGSTRID:
+      str = "Default";
+      break;
+#endif
+
+    case CDCNCM_MACSTRID:
+      str = "020000112233";
+      break;
+
+    default:
+      uwarn("Unknown string descriptor index: %d\n", id);
+      return -EINVAL;
+    }
+
+  /* The string is utf16-le.  The poor man's utf-8 to utf16-le
+   * conversion below will only handle 7-bit en-us ascii
+   */
+
+  len = strlen(str);
+  if (len > (CDCNCM_MAXSTRLEN / 2))
+    {
+      len = (CDCNCM_MAXSTRLEN / 2);
+    }
+
+  for (i = 0, ndata = 0; i < len; i++, ndata += 2)
+    {
+      strdesc->data[ndata]     = str[i];
+      strdesc->data[ndata + 1] = 0;
+    }
+
+  strdesc->len  = ndata + 2;
+  strdesc->type = USB_DESC_TYPE_STRING;
+  return strdesc->len;
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkepdesc
+ *
+ * Description:
+ *   Construct the endpoint descriptor
+ *
+ ****************************************************************************/
+
+static void cdcncm_mkepdesc(int epidx,
+                            FAR struct usb_epdesc_s *epdesc,
+                            FAR struct usbdev_devinfo_s *devinfo,
+                            bool hispeed)
+{
+  uint16_t intin_mxpktsz   = CONFIG_CDCNCM_EPINTIN_FSSIZE;
+  uint16_t bulkout_mxpktsz = CONFIG_CDCNCM_EPBULKOUT_FSSIZE;
+  uint16_t bulkin_mxpktsz  = CONFIG_CDCNCM_EPBULKIN_FSSIZE;
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  if (hispeed)
+    {
+      intin_mxpktsz   = CONFIG_CDCNCM_EPINTIN_HSSIZE;
+      bulkout_mxpktsz = CONFIG_CDCNCM_EPBULKOUT_HSSIZE;
+      bulkin_mxpktsz  = CONFIG_CDCNCM_EPBULKIN_HSSIZE;
+    }
+#else
+  UNUSED(hispeed);
+#endif
+
+  epdesc->len  = USB_SIZEOF_EPDESC;            /* Descriptor length */
+  epdesc->type = USB_DESC_TYPE_ENDPOINT;       /* Descriptor type */
+
+  switch (epidx)
+    {
+      case CDCNCM_EP_INTIN_IDX:  /* Interrupt IN endpoint */
+        {
+          epdesc->addr            = USB_DIR_IN |
+                                    devinfo->epno[CDCNCM_EP_INTIN_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_INT;
+          epdesc->mxpacketsize[0] = LSBYTE(intin_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(intin_mxpktsz);
+          epdesc->interval        = hispeed ? 9 : 32;
+        }
+        break;
+
+      case CDCNCM_EP_BULKIN_IDX:
+        {
+          epdesc->addr            = USB_DIR_IN |
+                                    devinfo->epno[CDCNCM_EP_BULKIN_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_BULK;
+          epdesc->mxpacketsize[0] = LSBYTE(bulkin_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(bulkin_mxpktsz);
+          epdesc->interval        = 0;
+        }
+        break;
+
+      case CDCNCM_EP_BULKOUT_IDX:
+        {
+          epdesc->addr            = USB_DIR_OUT |
+                                    devinfo->epno[CDCNCM_EP_BULKOUT_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_BULK;
+          epdesc->mxpacketsize[0] = LSBYTE(bulkout_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(bulkout_mxpktsz);
+          epdesc->interval        = 0;
+        }
+        break;
+
+      default:
+        DEBUGASSERT(false);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkcfgdesc
+ *
+ * Description:
+ *   Construct the config descriptor
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+static int16_t cdcncm_mkcfgdesc(FAR uint8_t *desc,
+                                FAR struct usbdev_devinfo_s *devinfo,
+                                uint8_t speed, uint8_t type)
+#else
+static int16_t cdcncm_mkcfgdesc(FAR uint8_t *desc,
+                                FAR struct usbdev_devinfo_s *devinfo)
+#endif
+{
+  FAR struct usb_cfgdesc_s *cfgdesc = NULL;
+  int16_t len = 0;
+  bool hispeed = false;
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  hispeed = (speed == USB_SPEED_HIGH);
+
+  /* Check for switches between high and full speed */
+
+  if (type == USB_DESC_TYPE_OTHERSPEEDCONFIG)
+    {
+      hispeed = !hispeed;
+    }
+#endif
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  if (desc)
+    {
+      cfgdesc = (FAR struct usb_cfgdesc_s *)desc;
+      cfgdesc->len         = USB_SIZEOF_CFGDESC;
+      cfgdesc->type        = USB_DESC_TYPE_CONFIG;
+      cfgdesc->ninterfaces = CDCNCM_NINTERFACES;
+      cfgdesc->cfgvalue    = CDCNCM_CONFIGID;
+      cfgdesc->icfg        = devinfo->strbase + CDCNCM_CONFIGSTRID;
+      cfgdesc->attr        = USB_CONFIG_ATTR_ONE | CDCNCM_SELFPOWERED |
+                             CDCNCM_REMOTEWAKEUP;
+      cfgdesc->mxpower     = (CONFIG_USBDEV_MAXPOWER + 1) / 2;
+
+      desc += USB_SIZEOF_CFGDESC;
+    }
+
+  len += USB_SIZEOF_CFGDESC;
+
+#elif defined(CONFIG_COMPOSITE_IAD)
+
+  /* Interface association descriptor */
+
+  if (desc)
+    {
+      FAR struct usb_iaddesc_s *iaddesc = (FAR struct usb_iaddesc_s *)desc;
+
+      iaddesc->len       = USB_SIZEOF_IADDESC;                  /* Descriptor length */
+      iaddesc->type      = USB_DESC_TYPE_INTERFACEASSOCIATION;  /* Descriptor type */
+      iaddesc->firstif   = devinfo->ifnobase;                   /* Number of first interface of the function */
+      iaddesc->nifs      = devinfo->ninterfaces;                /* Number of interfaces associated with the function */
+      iaddesc->classid   = USB_CLASS_CDC;                       /* Class code */
+      iaddesc->subclass  = CDC_SUBCLASS_NCM;                    /* Sub-class code */
+      iaddesc->protocol  = CDC_PROTO_NONE;                      /* Protocol code */
+      iaddesc->ifunction = 0;                                   /* Index to string identifying the function */
+
+      desc += USB_SIZEOF_IADDESC;
+    }
+
+  len += USB_SIZEOF_IADDESC;
+#endif
+
+  /* Communications Class Interface */
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase;
+      ifdesc->alt      = 0;
+      ifdesc->neps     = 1;
+      ifdesc->classid  = USB_CLASS_CDC;
+      ifdesc->subclass = CDC_SUBCLASS_NCM;
+      ifdesc->protocol = CDC_PROTO_NONE;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_hdr_funcdesc_s *hdrdesc;
+
+      hdrdesc = (FAR struct cdc_hdr_funcdesc_s *)desc;
+      hdrdesc->size    = SIZEOF_HDR_FUNCDESC;
+      hdrdesc->type    = USB_DESC_TYPE_CSINTERFACE;
+      hdrdesc->subtype = CDC_DSUBTYPE_HDR;
+      hdrdesc->cdc[0]  = LSBYTE(0x0110);
+      hdrdesc->cdc[1]  = MSBYTE(0x0110);
+
+      desc += SIZEOF_HDR_FUNCDESC;
+    }
+
+  len += SIZEOF_HDR_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_union_funcdesc_s *uniondesc;
+
+      uniondesc = (FAR struct cdc_union_funcdesc_s *)desc;
+      uniondesc->size = SIZEOF_UNION_FUNCDESC(1);
+      uniondesc->type = USB_DESC_TYPE_CSINTERFACE;
+      uniondesc->subtype = CDC_DSUBTYPE_UNION;
+      uniondesc->master = devinfo->ifnobase;
+      uniondesc->slave[0] = devinfo->ifnobase + 1;
+
+      desc += SIZEOF_UNION_FUNCDESC(1);
+    }
+
+  len += SIZEOF_UNION_FUNCDESC(1);
+
+  /* NCM also requires the ECM functional descriptor */
+
+  if (desc)
+    {
+      FAR struct cdc_ecm_funcdesc_s *ecmdesc;
+
+      ecmdesc = (FAR struct cdc_ecm_funcdesc_s *)desc;
+      ecmdesc->size       = SIZEOF_ECM_FUNCDESC;
+      ecmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ecmdesc->subtype    = CDC_DSUBTYPE_ECM;
+      ecmdesc->mac        = devinfo->strbase + CDCNCM_MACSTRID;
+      ecmdesc->stats[0]   = 0;
+      ecmdesc->stats[1]   = 0;
+      ecmdesc->stats[2]   = 0;
+      ecmdesc->stats[3]   = 0;
+      ecmdesc->maxseg[0]  = LSBYTE(CONFIG_NET_ETH_PKTSIZE);
+      ecmdesc->maxseg[1]  = MSBYTE(CONFIG_NET_ETH_PKTSIZE);
+      ecmdesc->nmcflts[0] = LSBYTE(0);
+      ecmdesc->nmcflts[1] = MSBYTE(0);
+      ecmdesc->npwrflts   = 0;
+
+      desc += SIZEOF_ECM_FUNCDESC;
+    }
+
+  len += SIZEOF_ECM_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_ncm_funcdesc_s *ncmdesc;
+
+      ncmdesc = (FAR struct cdc_ncm_funcdesc_s *)desc;
+      ncmdesc->size       = SIZEOF_NCM_FUNCDESC;
+      ncmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ncmdesc->subtype    = CDC_DSUBTYPE_NCM;
+      ncmdesc->version[0] = LSBYTE(CDCNCM_NCMVERSIONNO);
+      ncmdesc->version[1] = MSBYTE(CDCNCM_NCMVERSIONNO);
+      ncmdesc->caps       = NCMCAP_PACKET_FILTER;
+
+      desc += SIZEOF_NCM_FUNCDESC;
+    }
+
+  len += SIZEOF_NCM_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_INTIN_IDX, epdesc, devinfo, hispeed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  /* Data Class Interface:  No endpoints in the default alternate setting,
+   * the bulk endpoints in alternate setting 1.
+   */
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase + 1;
+      ifdesc->alt      = 0;
+      ifdesc->neps     = 0;
+      ifdesc->classid  = USB_CLASS_CDC_DATA;
+      ifdesc->subclass = CDC_DATA_SUBCLASS_NONE;
+      ifdesc->protocol = CDC_DATA_PROTO_NCM;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase + 1;
+      ifdesc->alt      = 1;
+      ifdesc->neps     = 2;
+      ifdesc->classid  = USB_CLASS_CDC_DATA;
+      ifdesc->subclass = CDC_DATA_SUBCLASS_NONE;
+      ifdesc->protocol = CDC_DATA_PROTO_NCM;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_BULKIN_IDX, epdesc, devinfo, hispeed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_BULKOUT_IDX, epdesc, devinfo, hispeed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  if (cfgdesc)
+    {
+      cfgdesc->totallen[0] = LSBYTE(len);
+      cfgdesc->totallen[1] = MSBYTE(len);
+    }
+
+  DEBUGASSERT(len <= CDCNCM_MXDESCLEN);
+  return len;
+}
+
+/****************************************************************************
+ * Name: cdcncm_getdescriptor
+ *
+ * Description:
+ *   Copy the USB CDC-NCM Device USB Descriptor of a given Type and a given
+ *   Index into the provided Descriptor Buffer.
+ *
+ * Input Parameter:
+ *   self  - The CDC-NCM driver instance.
+ *   type  - The Type of USB Descriptor requested.
+ *   index - The Index of the USB Descriptor requested.
+ *   desc  - The USB Descriptor is copied into this buffer, which must be at
+ *           least CDCNCM_MXDESCLEN bytes wide.
+ *
+ * Returned Value:
+ *   The size in bytes of the requested USB Descriptor or a negated errno in
+ *   case of failure.
+ *
+ ****************************************************************************/
+
+static int cdcncm_getdescriptor(FAR struct cdcncm_driver_s *self,
+                                uint8_t type, uint8_t index, FAR void *desc)
+{
+  uinfo("type: 0x%02hhx, index: 0x%02hhx\n", type, index);
+
+  switch (type)
+    {
+#ifndef CONFIG_CDCNCM_COMPOSITE
+    case USB_DESC_TYPE_DEVICE:
+      {
+        memcpy(desc, &g_devdesc, sizeof(g_devdesc));
+        return (int)sizeof(g_devdesc);
+      }
+      break;
+#endif
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+    case USB_DESC_TYPE_OTHERSPEEDCONFIG:
+#endif
+    case USB_DESC_TYPE_CONFIG:
+      {
+#ifdef CONFIG_USBDEV_DUALSPEED
+        return cdcncm_mkcfgdesc((FAR uint8_t *)desc, &self->devinfo,
+                                self->usbdev.speed, type);
+#else
+        return cdcncm_mkcfgdesc((FAR uint8_t *)desc, &self->devinfo);
+#endif
+      }
+      break;
+
+    case USB_DESC_TYPE_STRING:
+      {
+        return cdcncm_mkstrdesc(index, (FAR struct usb_strdesc_s *)desc);
+      }
+      break;
+
+    default:
+      uwarn("Unsupported descriptor type: 0x%02hhx\n", type);
+      break;
+    }
+
+  return -ENOTSUP;
+}
+
+/****************************************************************************
+ * Name: cdcncm_classrequest
+ *
+ * Description:
+ *   Handle the NCM class specific requests.  Returns the length of the
+ *   response in ctrlreq->buf or a negated errno.
+ *
+ ****************************************************************************/
+
+static int cdcncm_classrequest(FAR struct cdcncm_driver_s *self,
+                               FAR const struct usb_ctrlreq_s *ctrl,
+                               FAR uint8_t *dataout, size_t outlen)
+{
+  FAR uint8_t *buf = self->ctrlreq->buf;
+  uint32_t size;
+
+  switch (ctrl->req)
+    {
+      case ECM_SET_PACKET_FILTER:
+
+        /* Always operate in promiscuous mode and rely on the host to do
+         * the filtering, as the CDC/ECM driver does.
+         */
+
+        uinfo("ECM_SET_PACKET_FILTER wValue: 0x%04hx\n",
+              GETUINT16(ctrl->value));
+        return 0;
+
+      case NCM_GET_NTB_PARAMETERS:
+        {
+          FAR struct cdc_ncm_ntbparms_s *parms =
+            (FAR struct cdc_ncm_ntbparms_s *)buf;
+
+          memset(parms, 0, SIZEOF_NCM_NTBPARMS);
+          cdcncm_putuint16(parms->len, SIZEOF_NCM_NTBPARMS);
+          cdcncm_putuint16(parms->formats, 1 << NCM_NTB_FORMAT_16);
+          cdcncm_putuint32(parms->inmaxsize, CONFIG_CDCNCM_NTB_INSIZE);
+          cdcncm_putuint16(parms->indivisor, CDCNCM_NTB_ALIGN);
+          cdcncm_putuint16(parms->inalignment, CDCNCM_NTB_ALIGN);
+          cdcncm_putuint32(parms->outmaxsize, CONFIG_CDCNCM_NTB_OUTSIZE);
+          cdcncm_putuint16(parms->outdivisor, CDCNCM_NTB_ALIGN);
+          cdcncm_putuint16(parms->outalignment, CDCNCM_NTB_ALIGN);
+          return SIZEOF_NCM_NTBPARMS;
+        }
+
+      case NCM_GET_NTB_FORMAT:
+        cdcncm_putuint16(buf, NCM_NTB_FORMAT_16);
+        return 2;
+
+      case NCM_SET_NTB_FORMAT:
+        return GETUINT16(ctrl->value) == NCM_NTB_FORMAT_16 ? 0 : -EINVAL;
+
+      case NCM_GET_NTB_INPUT_SIZE:
+        cdcncm_putuint32(buf, self->ntbinsize);
+        return 4;
+
+      case NCM_SET_NTB_INPUT_SIZE:
+
+        /* Not all device controller drivers provide the EP0 OUT data with
+         * the setup command.  Keep the default size then.
+         */
+
+        if (dataout != NULL && outlen >= 4)
+          {
+            size = GETUINT32(dataout);
+            if (size < CDCNCM_NTB_MININSIZE)
+              {
+                return -EINVAL;
+              }
+
+            self->ntbinsize = MIN(size, CONFIG_CDCNCM_NTB_INSIZE);
+          }
+
+        return 0;
+
+      default:
+        uwarn("Unsupported class req: 0x%02hhx\n", ctrl->req);
+        return -EOPNOTSUPP;
+    }
+}
+
+/****************************************************************************
+ * USB Device Class Methods
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_bind
+ *
+ * Description:
+ *   Invoked when the driver is bound to an USB device
+ *
+ ****************************************************************************/
+
+static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
+                       FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int ret = OK;
+  int i;
+
+  uinfo("\n");
+
+  dev->ep0->priv = self;
+
+  /* Preallocate control request */
+
+  self->ctrlreq = cdcncm_allocreq(dev->ep0, CDCNCM_MXDESCLEN);
+
+  if (self->ctrlreq == NULL)
+    {
+      ret = -ENOMEM;
+      goto error;
+    }
+
+  self->ctrlreq->callback = cdcncm_ep0incomplete;
+
+  self->epint     = DEV_ALLOCEP(dev,
+                                USB_DIR_IN |
+                                self->devinfo.epno[CDCNCM_EP_INTIN_IDX],
+                                true, USB_EP_ATTR_XFER_INT);
+  self->epbulkin  = DEV_ALLOCEP(dev,
+                                USB_DIR_IN |
+                                self->devinfo.epno[CDCNCM_EP_BULKIN_IDX],
+                                true, USB_EP_ATTR_XFER_BULK);
+  self->epbulkout = DEV_ALLOCEP(dev,
+                                USB_DIR_OUT |
+                                self->devinfo.epno[CDCNCM_EP_BULKOUT_IDX],
+                                false, USB_EP_ATTR_XFER_BULK);
+
+  if (!self->epint || !self->epbulkin || !self->epbulkout)
+    {
+      uerr("Failed to allocate endpoints!\n");
+      ret = -ENODEV;
+      goto error;
+    }
+
+  self->epint->priv     = self;
+  self->epbulkin->priv  = self;
+  self->epbulkout->priv = self;
+
+  /* Pre-allocate the notification request */
+
+  self->notifyreq = cdcncm_allocreq(self->epint, CDCNCM_NOTIFY_MAXLEN);
+  if (self->notifyreq == NULL)
+    {
+      uerr("Out of memory\n");
+      ret = -ENOMEM;
+      goto error;
+    }
+
+  self->notifyreq->callback = cdcncm_intcomplete;
+  self->notifyreq->flags    = 0;
+
+  /* Pre-allocate the read request.  The buffer holds one OUT NTB. */
+
+  self->rdreq = cdcncm_allocreq(self->epbulkout, CONFIG_CDCNCM_NTB_OUTSIZE);
+  if (self->rdreq == NULL)
+    {
+      uerr("Out of memory\n");
+      ret = -ENOMEM;
+      goto error;
+    }
+
+  self->rdreq->callback = cdcncm_rdcomplete;
+
+  /* Pre-allocate two write requests of one IN NTB each */
+
+  for (i = 0; i < 2; i++)
+    {
+      self->wrreq[i] = cdcncm_allocreq(self->epbulkin,
+                                       CONFIG_CDCNCM_NTB_INSIZE);
+      if (self->wrreq[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      self->wrreq[i]->callback = cdcncm_wrcomplete;
+    }
+
+  /* No write request is in flight now */
+
+  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+
+  if (ret != OK)
+    {
+      uerr("nxsem_init failed. ret: %d\n", ret);
+      goto error;
+    }
+
+  self->txdone    = false;
+  self->wrcur     = 0;
+  self->ntbinsize = CONFIG_CDCNCM_NTB_INSIZE;
+  cdcncm_txreset(self);
+  self->dev.d_len = 0;
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+#ifdef CONFIG_USBDEV_SELFPOWERED
+  DEV_SETSELFPOWERED(dev);
+#endif
+
+  /* And pull-up the data line for the soft connect function (unless we are
+   * part of a composite device)
+   */
+
+  DEV_CONNECT(dev);
+#endif
+  return OK;
+
+error:
+  uerr("cdcncm_bind failed! ret: %d\n", ret);
+  cdcncm_unbind(driver, dev);
+  return ret;
+}
+
+static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
+                          FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!driver || !dev)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return;
+    }
+#endif
+
+  /* Make sure that the endpoints have been unconfigured.  If
+   * we were terminated gracefully, then the configuration should
+   * already have been reset.  If not, then calling cdcncm_resetconfig
+   * should cause the endpoints to immediately terminate all
+   * transfers and return the requests to us (with result == -ESHUTDOWN)
+   */
+
+  cdcncm_resetconfig(self);
+  up_mdelay(50);
+
+  /* Free the interrupt IN endpoint and its request */
+
+  if (self->notifyreq != NULL)
+    {
+      cdcncm_freereq(self->epint, self->notifyreq);
+      self->notifyreq = NULL;
+    }
+
+  if (self->epint)
+    {
+      DEV_FREEEP(dev, self->epint);
+      self->epint = NULL;
+    }
+
+  /* Free the pre-allocated control request */
+
+  if (self->ctrlreq != NULL)
+    {
+      cdcncm_freereq(dev->ep0, self->ctrlreq);
+      self->ctrlreq = NULL;
+    }
+
+  /* Free the pre-allocated read request */
+
+  if (self->rdreq != NULL)
+    {
+      cdcncm_freereq(self->epbulkout, self->rdreq);
+      self->rdreq = NULL;
+    }
+
+  /* Free the bulk OUT endpoint */
+
+  if (self->epbulkout)
+    {
+      DEV_FREEEP(dev, self->epbulkout);
+      self->epbulkout = NULL;
+    }
+
+  /* Free the write requests */
+
+  for (i = 0; i < 2; i++)
+    {
+      if (self->wrreq[i] != NULL)
+        {
+          cdcncm_freereq(self->epbulkin, self->wrreq[i]);
+          self->wrreq[i] = NULL;
+        }
+    }
+
+  /* Free the bulk IN endpoint */
+
+  if (self->epbulkin)
+    {
+      DEV_FREEEP(dev, self->epbulkin);
+      self->epbulkin = NULL;
+    }
+
+  /* Clear out all data in the buffer */
+
+  self->dev.d_len = 0;
+}
+
+static int cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
+                        FAR struct usbdev_s *dev,
+                        FAR const struct usb_ctrlreq_s *ctrl,
+                        FAR uint8_t *dataout,
+                        size_t outlen)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  uint16_t value = GETUINT16(ctrl->value);
+  uint16_t index = GETUINT16(ctrl->index);
+  uint16_t len = GETUINT16(ctrl->len);
+  int ret = -EOPNOTSUPP;
+
+  uinfo("\n");
+
+  if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_STANDARD)
+    {
+      switch (ctrl->req)
+        {
+          case USB_REQ_GETDESCRIPTOR:
+            {
+              uint8_t descindex = ctrl->value[0];
+              uint8_t desctype  = ctrl->value[1];
+
+              ret = cdcncm_getdescriptor(self, desctype, descindex,
+                                         self->ctrlreq->buf);
+            }
+            break;
+
+          case USB_REQ_SETCONFIGURATION:
+            ret = cdcncm_setconfig(self, value);
+            break;
+
+          case USB_REQ_SETINTERFACE:
+            ret = cdcncm_setinterface(self, index, value);
+            break;
+
+          default:
+            uwarn("Unsupported standard req: 0x%02hhx\n", ctrl->req);
+            break;
+        }
+    }
+  else if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_CLASS)
+    {
+      ret = cdcncm_classrequest(self, ctrl, dataout, outlen);
+    }
+  else
+    {
+      uwarn("Unsupported type: 0x%02hhx\n", ctrl->type);
+    }
+
+  if (ret >= 0)
+    {
+      FAR struct usbdev_req_s *ctrlreq = self->ctrlreq;
+
+      ctrlreq->len   = MIN(len, ret);
+      ctrlreq->flags = USBDEV_REQFLAGS_NULLPKT;
+
+      ret = EP_SUBMIT(dev->ep0, ctrlreq);
+      uinfo("EP_SUBMIT ret: %d\n", ret);
+
+      if (ret < 0)
+        {
+          ctrlreq->result = OK;
+          cdcncm_ep0incomplete(dev->ep0, ctrlreq);
+        }
+    }
+
+  return ret;
+}
+
+static void cdcncm_disconnect(FAR struct usbdevclass_driver_s *driver,
+                              FAR struct usbdev_s *dev)
+{
+  uinfo("\n");
+}
+
+/****************************************************************************
+ * Name: cdcncm_classobject
+ *
+ * Description:
+ *   Register USB CDC/NCM and return the class object.
+ *
+ * Returned Value:
+ *   A pointer to the allocated class object (NULL on failure).
+ *
+ ****************************************************************************/
+
+static int cdcncm_classobject(int minor,
+                              FAR struct usbdev_devinfo_s *devinfo,
+                              FAR struct usbdevclass_driver_s **classdev)
+{
+  FAR struct cdcncm_driver_s *self;
+  int ret;
+
+  /* Initialize the driver structure */
+
+  self = kmm_zalloc(sizeof(struct cdcncm_driver_s));
+  if (!self)
+    {
+      nerr("Out of memory!\n");
+      return -ENOMEM;
+    }
+
+  /* Network device initialization */
+
+  self->dev.d_buf     = self->pktbuf;
+  self->dev.d_ifup    = cdcncm_ifup;     /* I/F up (new IP address) callback */
+  self->dev.d_ifdown  = cdcncm_ifdown;   /* I/F down callback */
+  self->dev.d_txavail = cdcncm_txavail;  /* New TX data callback */
+#ifdef CONFIG_NET_MCASTGROUP
+  self->dev.d_addmac  = cdcncm_addmac;   /* Add multicast MAC address */
+  self->dev.d_rmmac   = cdcncm_rmmac;    /* Remove multicast MAC address */
+#endif
+  self->dev.d_private = self;            /* Used to recover private state from dev */
+
+  /* USB device initialization */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  self->usbdev.speed  = USB_SPEED_HIGH;
+#else
+  self->usbdev.speed  = USB_SPEED_FULL;
+#endif
+  self->usbdev.ops    = &g_usbdevops;
+
+  memcpy(&self->devinfo, devinfo, sizeof(struct usbdev_devinfo_s));
+
+  /* Put the interface in the down state */
+
+  cdcncm_ifdown(&self->dev);
+
+  memcpy(self->dev.d_mac.ether.ether_addr_octet,
+         "\x00\xe0\xde\xad\xbe\xef", IFHWADDRLEN);
+
+  /* Register the device with the OS so that socket IOCTLs can be performed */
+
+  ret = netdev_register(&self->dev, NET_LL_ETHERNET);
+  if (ret < 0)
+    {
+      nerr("netdev_register failed. ret: %d\n", ret);
+      kmm_free(self);
+      return ret;
+    }
+
+  self->registered = true;
+
+  *classdev = (FAR struct usbdevclass_driver_s *)self;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_uninitialize
+ *
+ * Description:
+ *   Un-initialize the USB CDC/NCM class driver.  This function is used
+ *   internally by the USB composite driver to uninitialize the CDC/NCM
+ *   driver.  This same interface is available (with an untyped input
+ *   parameter) when the CDC/NCM driver is used standalone.
+ *
+ * Input Parameters:
+ *   There is one parameter, it differs in typing depending upon whether the
+ *   CDC/NCM driver is an internal part of a composite device, or a
+ *   standalone USB driver:
+ *
+ *     classdev - The class object returned by cdcncm_classobject()
+ *     handle   - The opaque handle representing the class object returned by
+ *                a previous call to cdcncm_initialize().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+void cdcncm_uninitialize(FAR struct usbdevclass_driver_s *classdev)
+#else
+void cdcncm_uninitialize(FAR void *handle)
+#endif
+{
+#ifdef CONFIG_CDCNCM_COMPOSITE
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)classdev;
+#else
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)handle;
+#endif
+  int ret;
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+  /* Check for pass 2 uninitialization.  We did most of the work on the
+   * first pass uninitialization.
+   */
+
+  if (!self->registered)
+    {
+      /* In this second and final pass, all that remains to be done is to
+       * free the memory resources.
+       */
+
+      kmm_free(self);
+      return;
+    }
+#endif
+
+  /* Un-register the CDC/NCM netdev device */
+
+  ret = netdev_unregister(&self->dev);
+  if (ret < 0)
+    {
+      nerr("ERROR: netdev_unregister failed. ret: %d\n", ret);
+    }
+
+  /* For the case of the composite driver, there is a two pass
+   * uninitialization sequence.  We cannot yet free the driver structure.
+   * We will do that on the second pass.
+   */
+
+  self->registered = false; /* Successfully unregistered netdev */
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  usbdev_unregister(&self->usbdev);
+
+  /* And free the driver structure */
+
+  kmm_free(self);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_initialize
+ *
+ * Description:
+ *   Register CDC/NCM USB device interface. Register the corresponding
+ *   network driver to NuttX and bring up the network.
+ *
+ * Input Parameters:
+ *   minor - Device minor number.
+ *   handle - An optional opaque reference to the CDC/NCM class object that
+ *     may subsequently be used with cdcncm_uninitialize().
+ *
+ * Returned Value:
+ *   Zero (OK) means that the driver was successfully registered.  On any
+ *   failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+int cdcncm_initialize(int minor, FAR void **handle)
+{
+  FAR struct usbdevclass_driver_s *drvr = NULL;
+  struct usbdev_devinfo_s devinfo;
+  int ret;
+
+  memset(&devinfo, 0, sizeof(struct usbdev_devinfo_s));
+  devinfo.ninterfaces                 = CDCNCM_NINTERFACES;
+  devinfo.nstrings                    = CDCNCM_NSTRIDS;
+  devinfo.nendpoints                  = CDCNCM_NUM_EPS;
+  devinfo.epno[CDCNCM_EP_INTIN_IDX]   = CONFIG_CDCNCM_EPINTIN;
+  devinfo.epno[CDCNCM_EP_BULKIN_IDX]  = CONFIG_CDCNCM_EPBULKIN;
+  devinfo.epno[CDCNCM_EP_BULKOUT_IDX] = CONFIG_CDCNCM_EPBULKOUT;
+
+  ret = cdcncm_classobject(minor, &devinfo, &drvr);
+  if (ret == OK)
+    {
+      ret = usbdev_register(drvr);
+      if (ret < 0)
+        {
+          uinfo("usbdev_register failed. ret %d\n", ret);
+        }
+    }
+
+  if (handle)
+    {
+      *handle = (FAR void *)drvr;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: cdcncm_get_composite_devdesc
+ *
+ * Description:
+ *   Helper function to fill in some constants into the composite
+ *   configuration struct.
+ *
+ * Input Parameters:
+ *     dev - Pointer to the configuration struct we should fill
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+void cdcncm_get_composite_devdesc(struct composite_devdesc_s *dev)
+{
+  memset(dev, 0, sizeof(struct composite_devdesc_s));
+
+  /* The callback functions for the CDC/NCM class.
+   *
+   * classobject() and uninitialize() must be provided by board-specific
+   * logic
+   */
+
+  dev->mkconfdesc   = cdcncm_mkcfgdesc;
+  dev->mkstrdesc    = cdcncm_mkstrdesc;
+  dev->classobject  = cdcncm_classobject;
+  dev->uninitialize = cdcncm_uninitialize;
+
+  dev->nconfigs     = CDCNCM_NCONFIGS; /* Number of configurations supported  */
+  dev->configid     = CDCNCM_CONFIGID; /* The only supported configuration ID */
+
+  /* Let the construction function calculate the size of config descriptor */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  dev->cfgdescsize  = cdcncm_mkcfgdesc(NULL, NULL, USB_SPEED_UNKNOWN, 0);
+#else
+  dev->cfgdescsize  = cdcncm_mkcfgdesc(NULL, NULL);
+#endif
+
+  /* Board-specific logic must provide the device minor, ifnobase, strbase
+   * and the endpoint numbers.
+   */
+
+  dev->devinfo.ninterfaces = CDCNCM_NINTERFACES; /* Number of interfaces in the configuration */
+  dev->devinfo.nstrings    = CDCNCM_NSTRIDS + 1; /* Number of Strings */
+  dev->devinfo.nendpoints  = CDCNCM_NUM_EPS;
+}
+#endif /* CONFIG_CDCNCM_COMPOSITE */
+
+#endif /* CONFIG_NET_CDCNCM */
@@ -0,0 +1,75 @@
+/****************************************************************************
+ * drivers/usbdev/cdcncm.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_USBDEV_CDCNCM_H
+#define __DRIVERS_USBDEV_CDCNCM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/usb/cdcncm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CDCNCM_VERSIONNO         (0x0100)
+#define CDCNCM_NCMVERSIONNO      (0x0100) /* bcdNcmVersion */
+#define CDCNCM_MXDESCLEN         (96)
+#define CDCNCM_MAXSTRLEN         (CDCNCM_MXDESCLEN - 2)
+#define CDCNCM_NCONFIGS          (1)
+#define CDCNCM_NINTERFACES       (2)
+#define CDCNCM_NUM_EPS           (3)
+
+#define CDCNCM_MANUFACTURERSTRID (1)
+#define CDCNCM_PRODUCTSTRID      (2)
+#define CDCNCM_SERIALSTRID       (3)
+#define CDCNCM_CONFIGSTRID       (4)
+#define CDCNCM_MACSTRID          (5)
+#define CDCNCM_NSTRIDS           (5)
+
+#define CDCNCM_STR_LANGUAGE      (0x0409) /* en-us */
+
+#define CDCNCM_CONFIGID_NONE     (0)
+#define CDCNCM_CONFIGID          (1)
+
+#define CDCNCM_SELFPOWERED       (0)
+#define CDCNCM_REMOTEWAKEUP      (0)
+
+/* Datagrams and NDPs in the NTBs sent to the host start on 4-byte
+ * boundaries (wNdpInDivisor, wNdpInAlignment).
+ */
+
+#define CDCNCM_NTB_ALIGN         (4)
+#define CDCNCM_NTB_ALIGNUP(n)    (((n) + CDCNCM_NTB_ALIGN - 1) & \
+                                  ~(CDCNCM_NTB_ALIGN - 1))
+
+/* The smallest IN NTB size the host may select (NCM 1.0, 6.2.7) */
+
+#define CDCNCM_NTB_MININSIZE     (2048)
+
+#ifndef MIN
+#  define MIN(a,b) ((a)<(b)?(a):(b))
+#endif
+
+#endif /* __DRIVERS_USBDEV_CDCNCM_H */
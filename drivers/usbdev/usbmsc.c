@@ -1429,6 +1429,7 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
   FAR struct usbmsc_lun_s *lun;
   FAR struct inode *inode;
   struct geometry geo;
+  uint32_t iosize;
   int ret;
 
 #ifdef CONFIG_DEBUG_FEATURES
@@ -1504,15 +1505,17 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
 
   memset(lun, 0, sizeof(struct usbmsc_lun_s));
 
-  /* Allocate an I/O buffer big enough to hold one hardware sector.  SCSI
-   * commands are processed one at a time so all LUNs may share a single I/O
-   * buffer.  The I/O buffer will be allocated so that is it as large as the
-   * largest block device sector size
+  /* Allocate an I/O buffer big enough to hold CONFIG_USBMSC_NSECTORS
+   * hardware sectors.  SCSI commands are processed one at a time so all
+   * LUNs may share a single I/O buffer.  The I/O buffer will be allocated
+   * so that is it as large as needed for the largest block device sector
+   * size
    */
 
+  iosize = (uint32_t)geo.geo_sectorsize * CONFIG_USBMSC_NSECTORS;
   if (!priv->iobuffer)
     {
-      priv->iobuffer = (FAR uint8_t *)kmm_malloc(geo.geo_sectorsize);
+      priv->iobuffer = (FAR uint8_t *)kmm_malloc(iosize);
       if (!priv->iobuffer)
         {
           usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_ALLOCIOBUFFER),
@@ -1520,13 +1523,13 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
           return -ENOMEM;
         }
 
-      priv->iosize = geo.geo_sectorsize;
+      priv->iosize = iosize;
     }
-  else if (priv->iosize < geo.geo_sectorsize)
+  else if (priv->iosize < iosize)
     {
       FAR void *tmp;
 
-      tmp = (FAR void *)kmm_realloc(priv->iobuffer, geo.geo_sectorsize);
+      tmp = (FAR void *)kmm_realloc(priv->iobuffer, iosize);
       if (!tmp)
         {
           usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_REALLOCIOBUFFER),
@@ -1535,7 +1538,7 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
         }
 
       priv->iobuffer = (FAR uint8_t *)tmp;
-      priv->iosize   = geo.geo_sectorsize;
+      priv->iosize   = iosize;
     }
 
   lun->inode       = inode;
@@ -1886,6 +1886,7 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
   /* No data is buffered */
 
   priv->nsectbytes   = 0;
+  priv->iolen        = 0;
   priv->nreqbytes    = 0;
 
   /* Get exclusive access to the block driver */
@@ -2187,7 +2188,9 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   iolen      - holds the number of bytes read into the I/O buffer
+ *   nsectbytes - holds the number of bytes of the I/O buffer not yet copied
+ *                into requests
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
@@ -2202,12 +2205,21 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   ssize_t nread;
   uint8_t *src;
   uint8_t *dest;
+  uint16_t reqlen;
   int nbytes;
   int ret;
 
+  /* Fill each request buffer up to a multiple of the max packet size.  Only
+   * the final request of the transfer may end with a short packet.
+   */
+
+  reqlen = CONFIG_USBMSC_BULKINREQLEN -
+           CONFIG_USBMSC_BULKINREQLEN % priv->epbulkin->maxpacket;
+
   /* Loop transferring data until either (1) all of the data has been
    * transferred, or (2) we have used up all of the write requests that we
-   * have available.
+   * have available.  The requests already submitted are sent by the USB
+   * device controller while the next sectors are read.
    */
 
   while (priv->u.xfrlen > 0 || priv->nsectbytes > 0)
@@ -2218,10 +2230,12 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read the next sectors, as many as the I/O buffer holds */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-          if (nread < 0)
+          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                   MIN(priv->u.xfrlen,
+                                       CONFIG_USBMSC_NSECTORS));
+          if (nread <= 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
                        -nread);
@@ -2230,9 +2244,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->iolen      = nread * lun->sectorsize;
+          priv->nsectbytes = priv->iolen;
+          priv->u.xfrlen  -= nread;
+          priv->sector    += nread;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2260,11 +2275,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * OR (2) all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->iolen - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
-      nbytes = MIN(priv->epbulkin->maxpacket - priv->nreqbytes,
-                   priv->nsectbytes);
+      nbytes = MIN(reqlen - priv->nreqbytes, priv->nsectbytes);
 
       /* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2277,7 +2291,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * then submit the request
        */
 
-      if (priv->nreqbytes >= priv->epbulkin->maxpacket ||
+      if (priv->nreqbytes >= reqlen ||
           (priv->u.xfrlen <= 0 && priv->nsectbytes <= 0))
         {
           /* Remove the request that we just filled from wrreqlist (we've
@@ -2341,7 +2355,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be written.
  *   sector     - holds the sector number of the next sector to write
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes buffered in the I/O buffer
  *   nreqbytes  - holds the number of untransferred bytes currently in the
  *                request at the head of the rdreqlist.
  *
@@ -2353,9 +2367,12 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbmsc_req_s *privreq;
   FAR struct usbdev_req_s *req;
   ssize_t nwritten;
+  uint32_t iolen;
   uint16_t xfrd;
   uint8_t *src;
   uint8_t *dest;
+  bool resubmitted;
+  int nsectors;
   int nbytes;
   int ret;
 
@@ -2392,6 +2409,7 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
       req             = privreq->req;
       xfrd            = req->xfrd;
       priv->nreqbytes = xfrd;
+      resubmitted     = false;
 
       /* Now loop until all of the data in the read request has been
        * transferred to the block driver OR all of the request data has been
@@ -2400,12 +2418,19 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       while (priv->nreqbytes > 0 && priv->u.xfrlen > 0)
         {
+          /* The I/O buffer collects as many of the remaining sectors as it
+           * holds before they are written with one block driver access.
+           */
+
+          nsectors = MIN(priv->u.xfrlen, CONFIG_USBMSC_NSECTORS);
+          iolen    = nsectors * lun->sectorsize;
+
           /* Copy the data received in the read request into the sector I/O buffer */
 
           src  = &req->buf[xfrd - priv->nreqbytes];
           dest = &priv->iobuffer[priv->nsectbytes];
 
-          nbytes = MIN(lun->sectorsize - priv->nsectbytes, priv->nreqbytes);
+          nbytes = MIN(iolen - priv->nsectbytes, priv->nreqbytes);
 
           /* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2413,14 +2438,35 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
           priv->nsectbytes += nbytes;
           priv->nreqbytes  -= nbytes;
 
+          /* If all of the request data has been copied, return the request
+           * to the endpoint now so that the host can send more data while
+           * the block driver is busy writing.
+           */
+
+          if (priv->nreqbytes <= 0)
+            {
+              req->len      = priv->epbulkout->maxpacket;
+              req->priv     = privreq;
+              req->callback = usbmsc_rdcomplete;
+
+              ret = EP_SUBMIT(priv->epbulkout, req);
+              if (ret != OK)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITERDSUBMIT),
+                           (uint16_t)-ret);
+                }
+
+              resubmitted = true;
+            }
+
           /* Is the I/O buffer full? */
 
-          if (priv->nsectbytes >= lun->sectorsize)
+          if (priv->nsectbytes >= iolen)
             {
-              /* Yes.. Write the next sector */
+              /* Yes.. Write the buffered sectors */
 
               nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer,
-                                           priv->sector, 1);
+                                           priv->sector, nsectors);
               if (nwritten < 0)
                 {
                   usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL),
@@ -2431,26 +2477,30 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
                 }
 
               priv->nsectbytes = 0;
-              priv->residue   -= lun->sectorsize;
-              priv->u.xfrlen--;
-              priv->sector++;
+              priv->residue   -= iolen;
+              priv->u.xfrlen  -= nsectors;
+              priv->sector    += nsectors;
             }
         }
 
       /* In either case, we are finished with this read request and can
-       * return it to the endpoint.  Then we will go back to the top of the
-       * top and attempt to get the next read request.
+       * return it to the endpoint (unless that was already done above).
+       * Then we will go back to the top of the top and attempt to get the
+       * next read request.
        */
 
-      req->len      = priv->epbulkout->maxpacket;
-      req->priv     = privreq;
-      req->callback = usbmsc_rdcomplete;
-
-      ret = EP_SUBMIT(priv->epbulkout, req);
-      if (ret != OK)
+      if (!resubmitted)
         {
-          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITERDSUBMIT),
-                   (uint16_t)-ret);
+          req->len      = priv->epbulkout->maxpacket;
+          req->priv     = privreq;
+          req->callback = usbmsc_rdcomplete;
+
+          ret = EP_SUBMIT(priv->epbulkout, req);
+          if (ret != OK)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITERDSUBMIT),
+                       (uint16_t)-ret);
+            }
         }
 
       /* Did the host decide to stop early? */
@@ -39,7 +39,9 @@
 #include <nuttx/wqueue.h>
 #include <nuttx/scsi.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/drivers/rwbuffer.h>
 
 #include <nuttx/usb/usb.h>
 #include <nuttx/usb/usbhost.h>
@@ -75,6 +77,19 @@
 #  error "Currently limited to 26 devices /dev/sda-z"
 #endif
 
+/* The number of sectors transferred with one READ(10)/WRITE(10) command */
+
+#ifndef CONFIG_USBHOST_MSC_MAXSECTORS
+#  define CONFIG_USBHOST_MSC_MAXSECTORS 64
+#endif
+
+/* Check if read/write buffer support is needed */
+
+#if defined(CONFIG_USBHOST_MSC_READAHEAD) || \
+    defined(CONFIG_USBHOST_MSC_WRITEBUFFER)
+#  define USBHOST_HAVE_RWBUFFER 1
+#endif
+
 /* Driver support ***********************************************************/
 
 /* This format is used to construct the /dev/sd[n] device driver path.  It
@@ -95,6 +110,10 @@
 #define USBHOST_MAX_RETRIES 100        /* Give up after 5 seconds */
 #define USBHOST_MAX_CREFS   INT16_MAX  /* Max cref count before signed overflow */
 
+#ifndef MIN
+#  define MIN(a,b)          ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -123,6 +142,9 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#ifdef USBHOST_HAVE_RWBUFFER
+  struct rwbuffer_s       rwbuffer;     /* Read-ahead/write buffer support */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -228,6 +250,10 @@ static int usbhost_disconnected(FAR struct usbhost_class_s *usbclass);
 
 /* struct block_operations methods */
 
+static ssize_t usbhost_reload(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startblock, size_t nblocks);
+static ssize_t usbhost_flush(FAR void *dev, FAR const uint8_t *buffer,
+                             off_t startblock, size_t nblocks);
 static int usbhost_open(FAR struct inode *inode);
 static int usbhost_close(FAR struct inode *inode);
 static ssize_t usbhost_read(FAR struct inode *inode,
@@ -941,6 +967,15 @@ static void usbhost_destroy(FAR void *arg)
   usbhost_mkdevname(priv, devname);
   unregister_blockdriver(devname);
 
+#ifdef USBHOST_HAVE_RWBUFFER
+  /* Release the read-ahead/write buffers (if they were initialized) */
+
+  if (priv->rwbuffer.dev != NULL)
+    {
+      rwb_uninitialize(&priv->rwbuffer);
+    }
+#endif
+
   /* Release the device name used by this connection */
 
   usbhost_freedevno(priv);
@@ -1361,6 +1396,35 @@ static inline int usbhost_initvolume(FAR struct usbhost_state_s *priv)
         }
     }
 
+#ifdef USBHOST_HAVE_RWBUFFER
+  /* Initialize the read-ahead/write buffers */
+
+  if (ret >= 0)
+    {
+      priv->rwbuffer.blocksize     = priv->blocksize;
+      priv->rwbuffer.nblocks       = priv->nblocks;
+      priv->rwbuffer.dev           = (FAR void *)priv;
+      priv->rwbuffer.wrflush       = usbhost_flush;
+      priv->rwbuffer.rhreload      = usbhost_reload;
+
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+      priv->rwbuffer.wrmaxblocks   = CONFIG_USBHOST_MSC_WRMAXBLOCKS;
+      priv->rwbuffer.wralignblocks = 0;
+#endif
+
+#ifdef CONFIG_USBHOST_MSC_READAHEAD
+      priv->rwbuffer.rhmaxblocks   = CONFIG_USBHOST_MSC_RHMAXBLOCKS;
+#endif
+
+      ret = rwb_initialize(&priv->rwbuffer);
+      if (ret < 0)
+        {
+          uerr("ERROR: rwb_initialize failed: %d\n", ret);
+          priv->rwbuffer.dev = NULL;
+        }
+    }
+#endif
+
   /* Register the block driver */
 
   if (ret >= 0)
@@ -1980,6 +2044,15 @@ static int usbhost_close(FAR struct inode *inode)
 
   DEBUGASSERT(priv->crefs > 1);
 
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+  /* Write any buffered sectors back to the device while it is connected */
+
+  if (!priv->disconnected)
+    {
+      rwb_flush(&priv->rwbuffer);
+    }
+#endif
+
   usbhost_forcetake(&priv->exclsem);
   priv->crefs--;
 
@@ -2015,142 +2088,102 @@ static int usbhost_close(FAR struct inode *inode)
 }
 
 /****************************************************************************
- * Name: usbhost_read
+ * Name: usbhost_xfrsectors
  *
  * Description:
- *   Read the specified number of sectors from the read-ahead buffer or from
- *   the physical device.
+ *   Read or write up to CONFIG_USBHOST_MSC_MAXSECTORS sectors with a single
+ *   READ(10) or WRITE(10) command:  Send the CBW, transfer the data
+ *   directly from/to the caller's buffer, and receive the CSW.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
  *
  ****************************************************************************/
 
-static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
-                            size_t startsector, unsigned int nsectors)
+static ssize_t usbhost_xfrsectors(FAR struct usbhost_state_s *priv,
+                                  FAR uint8_t *buffer, size_t startsector,
+                                  unsigned int nsectors, bool write)
 {
-  FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
-  ssize_t nbytes = 0;
-  int ret;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct usbhost_state_s *)inode->i_private;
-
-  DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
-
-  uinfo("startsector: %d nsectors: %d sectorsize: %d\n",
-        startsector, nsectors, priv->blocksize);
-
-  /* Check if the mass storage device is still connected */
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_cbw_s *cbw;
+  FAR struct usbmsc_csw_s *csw;
+  ssize_t nbytes;
 
-  if (priv->disconnected)
-    {
-      /* No... the block driver is no longer bound to the class.  That means
-       * that the USB storage device is no longer connected.  Refuse any
-       * attempt to read from the device.
-       */
+  /* Loop in the event that EAGAIN is returned on a read (meaning that the
+   * transaction was NAKed and we should try again).
+   */
 
-      nbytes = -ENODEV;
-    }
-  else if (nsectors > 0)
+  do
     {
-      FAR struct usbmsc_cbw_s *cbw;
+      /* Initialize a CBW (re-using the allocated transfer buffer) */
 
-      ret = usbhost_takesem(&priv->exclsem);
-      if (ret < 0)
+      cbw = usbhost_cbwalloc(priv);
+      if (write)
         {
-          return ret;
+          usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
+        }
+      else
+        {
+          usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
         }
 
-      /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
+      /* Send the CBW */
 
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                             (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+      if (nbytes >= 0)
         {
-          /* Loop in the event that EAGAIN is returned (mean that the
-           * transaction was NAKed and we should try again.
-           */
+          /* Send or receive the user data */
 
-          do
+          nbytes = DRVR_TRANSFER(hport->drvr,
+                                 write ? priv->bulkout : priv->bulkin,
+                                 buffer, priv->blocksize * nsectors);
+          if (nbytes >= 0)
             {
-              /* Assume some device failure */
-
-              nbytes = -ENODEV;
+              /* Receive the CSW */
 
-              /* Construct and send the CBW */
-
-              usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                     priv->tbuffer, USBMSC_CSW_SIZEOF);
               if (nbytes >= 0)
                 {
-                  /* Receive the user data */
+                  /* Check the CSW status */
 
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         buffer, priv->blocksize * nsectors);
-                  if (nbytes >= 0)
+                  csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+                  if (csw->status != 0)
                     {
-                      /* Receive the CSW */
-
-                      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                             priv->tbuffer,
-                                             USBMSC_CSW_SIZEOF);
-                      if (nbytes >= 0)
-                        {
-                          FAR struct usbmsc_csw_s *csw;
-
-                          /* Check the CSW status */
-
-                          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                          if (csw->status != 0)
-                            {
-                              uerr("ERROR: CSW status error: %d\n",
-                                   csw->status);
-                              nbytes = -ENODEV;
-                            }
-                        }
+                      uerr("ERROR: CSW status error: %d\n", csw->status);
+                      nbytes = -ENODEV;
                     }
                 }
             }
-          while (nbytes == -EAGAIN);
         }
-
-      usbhost_givesem(&priv->exclsem);
     }
+  while (nbytes == -EAGAIN && !write);
 
-  /* On success, return the number of blocks read */
-
-  return nbytes < 0 ? (int)nbytes : nsectors;
+  return nbytes < 0 ? nbytes : (ssize_t)nsectors;
 }
 
 /****************************************************************************
- * Name: usbhost_write
+ * Name: usbhost_rwsectors
  *
  * Description:
- *   Write the specified number of sectors to the write buffer or to the
- *   physical device.
+ *   Read or write any number of sectors from/to the physical device.  Large
+ *   requests are split into commands of CONFIG_USBHOST_MSC_MAXSECTORS
+ *   sectors, the transfer limit of the host controller.
  *
  ****************************************************************************/
 
-static ssize_t usbhost_write(FAR struct inode *inode,
-                             FAR const unsigned char *buffer,
-                             size_t startsector, unsigned int nsectors)
+static ssize_t usbhost_rwsectors(FAR struct usbhost_state_s *priv,
+                                 FAR uint8_t *buffer, size_t startsector,
+                                 size_t nsectors, bool write)
 {
-  FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
-  ssize_t nbytes;
-  int ret;
+  ssize_t ret;
+  size_t remaining;
+  unsigned int count;
 
-  uinfo("sector: %d nsectors: %d sectorsize: %d\n");
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv = (FAR struct usbhost_state_s *)inode->i_private;
-
-  DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
+  uinfo("%s startsector: %lu nsectors: %lu sectorsize: %u\n",
+        write ? "write" : "read", (unsigned long)startsector,
+        (unsigned long)nsectors, priv->blocksize);
 
   /* Check if the mass storage device is still connected */
 
@@ -2158,75 +2191,127 @@ static ssize_t usbhost_write(FAR struct inode *inode,
     {
       /* No... the block driver is no longer bound to the class.  That means
        * that the USB storage device is no longer connected.  Refuse any
-       * attempt to write to the device.
+       * attempt to access the device.
        */
 
-      nbytes = -ENODEV;
+      return -ENODEV;
     }
-  else
+
+  ret = usbhost_takesem(&priv->exclsem);
+  if (ret < 0)
     {
-      FAR struct usbmsc_cbw_s *cbw;
+      return ret;
+    }
 
-      ret = usbhost_takesem(&priv->exclsem);
+  for (remaining = nsectors; remaining > 0; remaining -= count)
+    {
+      count = MIN(remaining, CONFIG_USBHOST_MSC_MAXSECTORS);
+
+      ret = usbhost_xfrsectors(priv, buffer, startsector, count, write);
       if (ret < 0)
         {
-          return ret;
+          break;
         }
 
-      /* Assume allocation failure */
+      buffer      += count * priv->blocksize;
+      startsector += count;
+    }
 
-      nbytes = -ENOMEM;
+  usbhost_givesem(&priv->exclsem);
 
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
+  /* On success, return the number of sectors transferred */
 
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
-        {
-          /* Assume some device failure */
+  return ret < 0 ? ret : (ssize_t)nsectors;
+}
 
-          nbytes = -ENODEV;
+/****************************************************************************
+ * Name: usbhost_reload
+ *
+ * Description:
+ *   Read sectors from the physical device.  This is the read-ahead buffer
+ *   reload callout if read-ahead buffering is enabled.
+ *
+ ****************************************************************************/
 
-          /* Construct and send the CBW */
+static ssize_t usbhost_reload(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startblock, size_t nblocks)
+{
+  return usbhost_rwsectors((FAR struct usbhost_state_s *)dev, buffer,
+                           startblock, nblocks, false);
+}
 
-          usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
-          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                 (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-          if (nbytes >= 0)
-            {
-              /* Send the user data */
+/****************************************************************************
+ * Name: usbhost_flush
+ *
+ * Description:
+ *   Write sectors to the physical device.  This is the write buffer flush
+ *   callout if write buffering is enabled.
+ *
+ ****************************************************************************/
 
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)buffer,
-                                     priv->blocksize * nsectors);
-              if (nbytes >= 0)
-                {
-                  /* Receive the CSW */
+static ssize_t usbhost_flush(FAR void *dev, FAR const uint8_t *buffer,
+                             off_t startblock, size_t nblocks)
+{
+  return usbhost_rwsectors((FAR struct usbhost_state_s *)dev,
+                           (FAR uint8_t *)buffer, startblock, nblocks, true);
+}
 
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         priv->tbuffer, USBMSC_CSW_SIZEOF);
-                  if (nbytes >= 0)
-                    {
-                      FAR struct usbmsc_csw_s *csw;
+/****************************************************************************
+ * Name: usbhost_read
+ *
+ * Description:
+ *   Read the specified number of sectors from the read-ahead buffer or from
+ *   the physical device.
+ *
+ ****************************************************************************/
 
-                      /* Check the CSW status */
+static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
+                            size_t startsector, unsigned int nsectors)
+{
+  FAR struct usbhost_state_s *priv;
 
-                      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                      if (csw->status != 0)
-                        {
-                          uerr("ERROR: CSW status error: %d\n", csw->status);
-                          nbytes = -ENODEV;
-                        }
-                    }
-                }
-            }
-        }
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct usbhost_state_s *)inode->i_private;
+
+  DEBUGASSERT(priv->usbclass.hport);
 
-      usbhost_givesem(&priv->exclsem);
+  if (nsectors == 0)
+    {
+      return 0;
     }
 
-  /* On success, return the number of blocks written */
+#ifdef USBHOST_HAVE_RWBUFFER
+  return rwb_read(&priv->rwbuffer, startsector, nsectors, buffer);
+#else
+  return usbhost_reload(priv, buffer, startsector, nsectors);
+#endif
+}
 
-  return nbytes < 0 ? (int)nbytes : nsectors;
+/****************************************************************************
+ * Name: usbhost_write
+ *
+ * Description:
+ *   Write the specified number of sectors to the write buffer or to the
+ *   physical device.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_write(FAR struct inode *inode,
+                             FAR const unsigned char *buffer,
+                             size_t startsector, unsigned int nsectors)
+{
+  FAR struct usbhost_state_s *priv;
+
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct usbhost_state_s *)inode->i_private;
+
+  DEBUGASSERT(priv->usbclass.hport);
+
+#ifdef USBHOST_HAVE_RWBUFFER
+  return rwb_write(&priv->rwbuffer, startsector, nsectors, buffer);
+#else
+  return usbhost_flush(priv, buffer, startsector, nsectors);
+#endif
 }
 
 /****************************************************************************
@@ -2306,6 +2391,14 @@ static int usbhost_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       ret = -ENODEV;
     }
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+  else if (cmd == BIOC_FLUSH)
+    {
+      /* Write the buffered sectors.  The flush callout takes exclsem. */
+
+      ret = rwb_flush(&priv->rwbuffer);
+    }
+#endif
   else
     {
       /* Process the IOCTL by command */
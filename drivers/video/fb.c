@@ -419,6 +419,25 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_FB_PANDISPLAY
+      case FBIOPAN_DISPLAY:  /* Pan the display within the virtual plane */
+        {
+          FAR struct fb_planeinfo_s *pinfo =
+            (FAR struct fb_planeinfo_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(pinfo != NULL && fb->vtable != NULL);
+          if (fb->vtable->pandisplay == NULL)
+            {
+              ret = -ENOTTY;
+            }
+          else
+            {
+              ret = fb->vtable->pandisplay(fb->vtable, pinfo);
+            }
+        }
+        break;
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
       case FBIO_SELECT_OVERLAY:  /* Select video overlay */
         {
@@ -49,7 +49,9 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/board.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/ioctl.h>
 
 #include <arch/board/board.h>
 
@@ -70,6 +72,14 @@
 
 #define VIDEO_REMAINING_CAPNUM_INFINITY (-1)
 
+/* Alignment of each V4L2_MEMORY_MMAP buffer, suitable for DMA */
+
+#define VIDEO_MMAP_ALIGN        CONFIG_VIDEO_STREAM_MMAP_ALIGN
+
+/* Weight of the newest frame interval in the average: 1 / 2^n */
+
+#define VIDEO_INTERVAL_SHIFT    (3)
+
 /* Debug option */
 
 #ifdef CONFIG_DEBUG_VIDEO_ERROR
@@ -135,6 +145,14 @@ struct video_type_inf_s
   int32_t              remaining_capnum;
   video_wait_dma_t     wait_dma;
   video_framebuff_t    bufinf;
+  uint32_t             imagesize;  /* Image size of the last S_FMT */
+  uint16_t             memory;     /* enum #v4l2_memory of REQBUFS */
+  uint16_t             bufcount;   /* Number of V4L2_MEMORY_MMAP buffers */
+  uint32_t             bufsize;    /* Size of one V4L2_MEMORY_MMAP buffer */
+  FAR uint8_t          *bufheap;   /* V4L2_MEMORY_MMAP buffers */
+  uint16_t             sequence;   /* Sequence number of the next frame */
+  struct timespec      lastframe;  /* Time the last frame was captured */
+  struct v4l2_stream_stats stats;  /* Frame statistics */
 };
 
 typedef struct video_type_inf_s video_type_inf_t;
@@ -184,6 +202,8 @@ static bool is_sem_waited(FAR sem_t *sem);
 
 static int video_reqbufs(FAR struct video_mng_s *vmng,
                          FAR struct v4l2_requestbuffers *reqbufs);
+static int video_querybuf(FAR struct video_mng_s *vmng,
+                          FAR struct v4l2_buffer *buf);
 static int video_qbuf(FAR struct video_mng_s *vmng,
                       FAR struct v4l2_buffer *buf);
 static int video_dqbuf(FAR struct video_mng_s *vmng,
@@ -195,6 +215,9 @@ static int video_enum_framesizes(FAR struct v4l2_frmsizeenum *frmsize);
 static int video_s_fmt(FAR struct video_mng_s *priv,
                        FAR struct v4l2_format *fmt);
 static int video_enum_frameintervals(FAR struct v4l2_frmivalenum *frmival);
+static int video_g_stats(FAR struct video_mng_s *priv,
+                         FAR struct v4l2_stream_stats *stats);
+static int video_mmap(FAR struct video_mng_s *priv, FAR void **addr);
 static int video_s_parm(FAR struct video_mng_s *priv,
                         FAR struct v4l2_streamparm *parm);
 static int video_streamon(FAR struct video_mng_s *vmng,
@@ -424,6 +447,11 @@ static void initialize_resources(FAR video_mng_t *vmng)
 
 static void cleanup_streamresources(FAR video_type_inf_t *type_inf)
 {
+  if (type_inf->bufheap != NULL)
+    {
+      kumm_free(type_inf->bufheap);
+    }
+
   video_framebuff_uninit(&type_inf->bufinf);
   nxsem_destroy(&type_inf->wait_dma.dqbuf_wait_flg);
   nxsem_destroy(&type_inf->lock_state);
@@ -522,6 +550,54 @@ static int video_close(FAR struct file *filep)
   return ret;
 }
 
+static int video_mmap_alloc(FAR video_type_inf_t *type_inf,
+                            uint32_t type, uint32_t count)
+{
+  uint32_t bufsize;
+
+  /* Release the buffers of the previous request */
+
+  if (type_inf->bufheap != NULL)
+    {
+      kumm_free(type_inf->bufheap);
+      type_inf->bufheap  = NULL;
+      type_inf->bufcount = 0;
+      type_inf->bufsize  = 0;
+    }
+
+  if (count == 0)
+    {
+      return OK;
+    }
+
+  /* Only the video stream can be memory mapped and the buffer size is
+   * taken from the format, so S_FMT must come first.
+   */
+
+  if (type != V4L2_BUF_TYPE_VIDEO_CAPTURE ||
+      type_inf->imagesize == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Keep every buffer aligned so that the DMA can write to it directly */
+
+  bufsize = (type_inf->imagesize + VIDEO_MMAP_ALIGN - 1) &
+            ~(VIDEO_MMAP_ALIGN - 1);
+
+  type_inf->bufheap = kumm_memalign(VIDEO_MMAP_ALIGN,
+                                    bufsize * count);
+  if (type_inf->bufheap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  type_inf->bufcount = count;
+  type_inf->bufsize  = bufsize;
+
+  return OK;
+}
+
 static int video_reqbufs(FAR struct video_mng_s         *vmng,
                          FAR struct v4l2_requestbuffers *reqbufs)
 {
@@ -554,13 +630,57 @@ static int video_reqbufs(FAR struct video_mng_s         *vmng,
 
       ret = video_framebuff_realloc_container(&type_inf->bufinf,
                                               reqbufs->count);
+      if (ret == OK)
+        {
+          type_inf->memory = reqbufs->memory;
+          memset(&type_inf->stats, 0, sizeof(struct v4l2_stream_stats));
+          type_inf->sequence = 0;
+          type_inf->lastframe.tv_sec  = 0;
+          type_inf->lastframe.tv_nsec = 0;
+        }
     }
 
   leave_critical_section(flags);
 
+  if (ret == OK)
+    {
+      ret = video_mmap_alloc(type_inf, reqbufs->type,
+                             reqbufs->memory == V4L2_MEMORY_MMAP ?
+                             reqbufs->count : 0);
+    }
+
   return ret;
 }
 
+static int video_querybuf(FAR struct video_mng_s *vmng,
+                          FAR struct v4l2_buffer *buf)
+{
+  FAR video_type_inf_t *type_inf;
+
+  if ((vmng == NULL) || (buf == NULL))
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_video_type_inf(vmng, buf->type);
+  if (type_inf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (type_inf->memory != V4L2_MEMORY_MMAP ||
+      buf->index >= type_inf->bufcount)
+    {
+      return -EINVAL;
+    }
+
+  buf->memory   = V4L2_MEMORY_MMAP;
+  buf->m.offset = buf->index * type_inf->bufsize;
+  buf->length   = type_inf->bufsize;
+
+  return OK;
+}
+
 static int video_qbuf(FAR struct video_mng_s *vmng,
                       FAR struct v4l2_buffer *buf)
 {
@@ -580,7 +700,15 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
-  if (!is_bufsize_sufficient(vmng, buf->length))
+  if (buf->memory == V4L2_MEMORY_MMAP)
+    {
+      if (type_inf->memory != V4L2_MEMORY_MMAP ||
+          buf->index >= type_inf->bufcount)
+        {
+          return -EINVAL;
+        }
+    }
+  else if (!is_bufsize_sufficient(vmng, buf->length))
     {
       return -EINVAL;
     }
@@ -592,6 +720,16 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
     }
 
   memcpy(&container->buf, buf, sizeof(struct v4l2_buffer));
+
+  if (buf->memory == V4L2_MEMORY_MMAP)
+    {
+      /* The DMA writes directly to the driver owned buffer */
+
+      container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
+                                 buf->index * type_inf->bufsize);
+      container->buf.length    = type_inf->bufsize;
+    }
+
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
   video_lock(&type_inf->lock_state);
@@ -697,6 +835,11 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
 
+  if (buf->memory == V4L2_MEMORY_MMAP)
+    {
+      buf->m.offset = buf->index * type_inf->bufsize;
+    }
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
@@ -776,6 +919,7 @@ static int video_try_fmt(FAR struct v4l2_format *fmt)
 static int video_s_fmt(FAR struct video_mng_s *priv,
                        FAR struct v4l2_format *fmt)
 {
+  FAR video_type_inf_t *type_inf;
   int ret;
 
   if ((g_video_devops == NULL) || (g_video_devops->set_format == NULL))
@@ -784,10 +928,68 @@ static int video_s_fmt(FAR struct video_mng_s *priv,
     }
 
   ret = g_video_devops->set_format(fmt);
+  if (ret == OK)
+    {
+      type_inf = get_video_type_inf(priv, fmt->type);
+      if (type_inf != NULL)
+        {
+          /* Remember the image size for V4L2_MEMORY_MMAP buffers.  If the
+           * driver does not report it, assume two bytes per pixel, which
+           * also bounds a JPEG image.
+           */
+
+          type_inf->imagesize = fmt->fmt.pix.sizeimage;
+          if (type_inf->imagesize == 0)
+            {
+              type_inf->imagesize = (uint32_t)fmt->fmt.pix.width *
+                                    fmt->fmt.pix.height * 2;
+            }
+        }
+    }
 
   return ret;
 }
 
+static int video_g_stats(FAR struct video_mng_s *priv,
+                         FAR struct v4l2_stream_stats *stats)
+{
+  FAR video_type_inf_t *type_inf;
+  irqstate_t           flags;
+  uint32_t             type;
+
+  if ((priv == NULL) || (stats == NULL))
+    {
+      return -EINVAL;
+    }
+
+  type     = stats->type;
+  type_inf = get_video_type_inf(priv, type);
+  if (type_inf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  memcpy(stats, &type_inf->stats, sizeof(struct v4l2_stream_stats));
+  leave_critical_section(flags);
+
+  stats->type = type;
+  return OK;
+}
+
+static int video_mmap(FAR struct video_mng_s *priv, FAR void **addr)
+{
+  if ((priv == NULL) || (addr == NULL) || (priv->video_inf.bufheap == NULL))
+    {
+      return -EINVAL;
+    }
+
+  /* V4L2_MEMORY_MMAP buffers are at m.offset of the video stream heap */
+
+  *addr = priv->video_inf.bufheap;
+  return OK;
+}
+
 static int video_enum_frameintervals(FAR struct v4l2_frmivalenum *frmival)
 {
   int ret;
@@ -1257,6 +1459,21 @@ static int video_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
         break;
 
+      case VIDIOC_QUERYBUF:
+        ret = video_querybuf(priv, (FAR struct v4l2_buffer *)arg);
+
+        break;
+
+      case VIDIOC_G_STATS:
+        ret = video_g_stats(priv, (FAR struct v4l2_stream_stats *)arg);
+
+        break;
+
+      case FIOC_MMAP:
+        ret = video_mmap(priv, (FAR void **)((uintptr_t)arg));
+
+        break;
+
       case VIDIOC_CANCEL_DQBUF:
         ret = video_cancel_dqbuf(priv, (FAR enum v4l2_buf_type)arg);
 
@@ -1530,6 +1747,8 @@ int video_common_notify_dma_done(uint8_t  err_code,
   FAR video_mng_t      *vmng = (FAR video_mng_t *)priv;
   FAR video_type_inf_t *type_inf;
   FAR vbuf_container_t *container = NULL;
+  FAR struct v4l2_buffer *buf;
+  struct timespec      now;
 
   type_inf = get_video_type_inf(vmng, buf_type);
   if (type_inf == NULL)
@@ -1537,21 +1756,61 @@ int video_common_notify_dma_done(uint8_t  err_code,
       return -EINVAL;
     }
 
+  buf = &type_inf->bufinf.vbuf_dma->buf;
+
   if (err_code == 0)
     {
-      type_inf->bufinf.vbuf_dma->buf.flags = 0;
+      buf->flags = 0;
       if (type_inf->remaining_capnum > 0)
         {
           type_inf->remaining_capnum--;
         }
+
+      type_inf->stats.frames++;
     }
   else
     {
-      type_inf->bufinf.vbuf_dma->buf.flags = V4L2_BUF_FLAG_ERROR;
+      buf->flags = V4L2_BUF_FLAG_ERROR;
+      type_inf->stats.errors++;
     }
 
-  type_inf->bufinf.vbuf_dma->buf.bytesused = datasize;
-  video_framebuff_dma_done(&type_inf->bufinf);
+  /* Stamp the frame and update the average frame interval */
+
+  clock_systime_timespec(&now);
+  buf->timestamp.tv_sec  = now.tv_sec;
+  buf->timestamp.tv_usec = now.tv_nsec / NSEC_PER_USEC;
+  buf->sequence          = type_inf->sequence++;
+
+  if (type_inf->lastframe.tv_sec != 0 || type_inf->lastframe.tv_nsec != 0)
+    {
+      int32_t interval;
+
+      interval = (now.tv_sec - type_inf->lastframe.tv_sec) * USEC_PER_SEC +
+                 (now.tv_nsec - type_inf->lastframe.tv_nsec) /
+                 NSEC_PER_USEC;
+
+      if (type_inf->stats.interval == 0)
+        {
+          type_inf->stats.interval = interval;
+        }
+      else
+        {
+          type_inf->stats.interval +=
+            (interval - (int32_t)type_inf->stats.interval) >>
+            VIDEO_INTERVAL_SHIFT;
+        }
+    }
+
+  type_inf->lastframe = now;
+
+  buf->bytesused = datasize;
+  if (video_framebuff_dma_done(&type_inf->bufinf) &&
+      !is_sem_waited(&type_inf->wait_dma.dqbuf_wait_flg))
+    {
+      /* The ring is full and nobody dequeued the oldest frame */
+
+      type_inf->stats.dropped++;
+    }
 
   if (is_sem_waited(&type_inf->wait_dma.dqbuf_wait_flg))
     {
@@ -242,18 +242,27 @@ vbuf_container_t *video_framebuff_get_dma_container(video_framebuff_t *fbuf)
   return ret;
 }
 
-void video_framebuff_dma_done(video_framebuff_t *fbuf)
+bool video_framebuff_dma_done(video_framebuff_t *fbuf)
 {
+  bool dropped = false;
+
   fbuf->vbuf_dma = NULL;
   if (fbuf->vbuf_next_dma)
     {
       fbuf->vbuf_next_dma = fbuf->vbuf_next_dma->next;
       if (fbuf->vbuf_next_dma == fbuf->vbuf_top)  /* RING mode case. */
         {
+          /* The oldest captured frame will be overwritten by the next DMA
+           * before it was dequeued.
+           */
+
           fbuf->vbuf_top  = fbuf->vbuf_top->next;
           fbuf->vbuf_tail = fbuf->vbuf_tail->next;
+          dropped = true;
         }
     }
+
+  return dropped;
 }
 
 void video_framebuff_change_mode(video_framebuff_t  *fbuf,
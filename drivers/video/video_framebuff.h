@@ -39,6 +39,8 @@
 #include <nuttx/video/video.h>
 #include <nuttx/semaphore.h>
 
+#include <stdbool.h>
+
 struct vbuf_container_s
 {
   struct v4l2_buffer       buf;    /* Buffer information */
@@ -82,7 +84,7 @@ vbuf_container_t *video_framebuff_get_dma_container
                        (video_framebuff_t *fbuf);
 vbuf_container_t *video_framebuff_pop_curr_container
                        (video_framebuff_t *fbuf);
-void              video_framebuff_dma_done
+bool              video_framebuff_dma_done
                        (video_framebuff_t *fbuf);
 void              video_framebuff_change_mode
                        (video_framebuff_t *fbuf, enum v4l2_buf_mode mode);
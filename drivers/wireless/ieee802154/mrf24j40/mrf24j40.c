@@ -470,6 +470,9 @@ FAR struct ieee802154_radio_s *
   dev->radio.beaconupdate = mrf24j40_beaconupdate;
   dev->radio.beaconstop   = mrf24j40_beaconstop;
   dev->radio.sfupdate     = mrf24j40_sfupdate;
+  dev->radio.caps         = IEEE802154_RADIOCAP_CSMA |
+                            IEEE802154_RADIOCAP_AUTOACK |
+                            IEEE802154_RADIOCAP_RETRY;
 
   dev->lower    = lower;
   dev->spi      = spi;
@@ -77,6 +77,7 @@ static void mrf24j40_irqwork_txnorm(FAR struct mrf24j40_radio_s *dev)
   uint8_t reg;
   enum ieee802154_status_e status;
   bool framepending;
+  uint8_t retries;
 
   /* Disable tx int */
 
@@ -117,6 +118,10 @@ static void mrf24j40_irqwork_txnorm(FAR struct mrf24j40_radio_s *dev)
       status = IEEE802154_STATUS_SUCCESS;
     }
 
+  /* TXNRETRY holds the number of retransmissions of the frame */
+
+  retries = (reg & MRF24J40_TXSTAT_X_MASK) >> MRF24J40_TXSTAT_X_SHIFT;
+
   framepending = (mrf24j40_getreg(dev->spi, MRF24J40_TXNCON) &
                   MRF24J40_TXNCON_FPSTAT);
 
@@ -126,6 +131,7 @@ static void mrf24j40_irqwork_txnorm(FAR struct mrf24j40_radio_s *dev)
 
       dev->txdelayed_desc->conf->status = status;
       dev->txdelayed_desc->framepending = framepending;
+      dev->txdelayed_desc->retries      = retries;
       dev->radiocb->txdone(dev->radiocb, dev->txdelayed_desc);
 
       dev->txdelayed_busy = false;
@@ -143,6 +149,7 @@ static void mrf24j40_irqwork_txnorm(FAR struct mrf24j40_radio_s *dev)
 
       dev->csma_desc->conf->status = status;
       dev->csma_desc->framepending = framepending;
+      dev->csma_desc->retries      = retries;
       dev->radiocb->txdone(dev->radiocb, dev->csma_desc);
 
       /* We are now done with the transaction */
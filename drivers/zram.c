@@ -0,0 +1,782 @@
+/****************************************************************************
+ * drivers/zram.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <lzf.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/zram.h>
+
+#ifdef CONFIG_DRVR_ZRAM_GRAN
+#  include <nuttx/mm/gran.h>
+#endif
+
+#ifdef CONFIG_DRVR_ZRAM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_DRVR_ZRAM_GRAN_LOG2
+#  define CONFIG_DRVR_ZRAM_GRAN_LOG2 5
+#endif
+
+/* A sector is only kept compressed if that saves at least 1/8 of it.
+ * Otherwise reading it back would cost a decompression for little gain.
+ */
+
+#define ZRAM_MAXCOMPRESSED(s)  ((s) - ((s) >> 3))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The storage of one sector.  The length tells how it is stored:
+ *
+ *   0              - Same-filled: the sector is zs_fill repeated.  This is
+ *                    also the state of a sector that was never written.
+ *   zr_sectsize    - Raw: zs_data holds the sector as is.
+ *   anything else  - Compressed: zs_data holds zs_len bytes of LZF data.
+ */
+
+struct zram_slot_s
+{
+  union
+  {
+    FAR uint8_t *zs_data;       /* Raw or compressed data */
+    uint32_t     zs_fill;       /* Fill pattern of a same-filled sector */
+  } u;
+  uint16_t zs_len;              /* See above */
+};
+
+struct zram_dev_s
+{
+  sem_t zr_exclsem;                 /* Serializes access to the device */
+  uint32_t zr_nsectors;             /* Number of sectors on device */
+  uint16_t zr_sectsize;             /* The size of one sector */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  uint8_t zr_crefs;                 /* Open reference count */
+  bool zr_unlinked;                 /* The driver has been unlinked */
+#endif
+  FAR struct zram_slot_s *zr_slots; /* One entry per sector */
+  FAR uint8_t *zr_stage;            /* Input buffer, see zram_store() */
+  FAR uint8_t *zr_cbuf;             /* Compression output buffer */
+  FAR lzf_hslot_t *zr_htab;         /* LZF compressor hash table */
+#ifdef CONFIG_DRVR_ZRAM_GRAN
+  GRAN_HANDLE zr_gran;              /* Sector data pool */
+  FAR uint8_t *zr_granbase;         /* Start of the pool */
+#endif
+
+  /* Statistics */
+
+  uint32_t zr_ncompressed;          /* Sectors stored compressed */
+  uint32_t zr_nraw;                 /* Sectors stored raw */
+  size_t zr_stored;                 /* Bytes allocated for sector data */
+  uint32_t zr_nnomem;               /* Writes failed for lack of memory */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     zram_open(FAR struct inode *inode);
+static int     zram_close(FAR struct inode *inode);
+#endif
+
+static ssize_t zram_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+static ssize_t zram_write(FAR struct inode *inode,
+                 FAR const unsigned char *buffer, size_t start_sector,
+                 unsigned int nsectors);
+static int     zram_geometry(FAR struct inode *inode,
+                 FAR struct geometry *geometry);
+static int     zram_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     zram_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_zram_bops =
+{
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  zram_open,     /* open     */
+  zram_close,    /* close    */
+#else
+  0,             /* open     */
+  0,             /* close    */
+#endif
+  zram_read,     /* read     */
+  zram_write,    /* write    */
+  zram_geometry, /* geometry */
+  zram_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  zram_unlink    /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: zram_alloc and zram_free
+ *
+ * Description:
+ *   Allocate and free sector data, from the granule pool if there is one
+ *   and it has room, otherwise from the heap.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *zram_alloc(FAR struct zram_dev_s *dev, size_t len)
+{
+#ifdef CONFIG_DRVR_ZRAM_GRAN
+  if (dev->zr_gran != NULL)
+    {
+      FAR uint8_t *data = (FAR uint8_t *)gran_alloc(dev->zr_gran, len);
+      if (data != NULL)
+        {
+          return data;
+        }
+    }
+#endif
+
+  return (FAR uint8_t *)kmm_malloc(len);
+}
+
+static void zram_free(FAR struct zram_dev_s *dev, FAR uint8_t *data,
+                      size_t len)
+{
+#ifdef CONFIG_DRVR_ZRAM_GRAN
+  if (data >= dev->zr_granbase &&
+      data < dev->zr_granbase + CONFIG_DRVR_ZRAM_GRAN_SIZE)
+    {
+      gran_free(dev->zr_gran, data, len);
+      return;
+    }
+#endif
+
+  kmm_free(data);
+}
+
+/****************************************************************************
+ * Name: zram_release
+ *
+ * Description:
+ *   Free the storage of one sector and make it a zero-filled sector.
+ *
+ ****************************************************************************/
+
+static void zram_release(FAR struct zram_dev_s *dev,
+                         FAR struct zram_slot_s *slot)
+{
+  if (slot->zs_len == dev->zr_sectsize)
+    {
+      dev->zr_nraw--;
+    }
+  else if (slot->zs_len > 0)
+    {
+      dev->zr_ncompressed--;
+    }
+
+  if (slot->zs_len > 0)
+    {
+      zram_free(dev, slot->u.zs_data, slot->zs_len);
+      dev->zr_stored -= slot->zs_len;
+    }
+
+  slot->u.zs_fill = 0;
+  slot->zs_len    = 0;
+}
+
+/****************************************************************************
+ * Name: zram_load
+ *
+ * Description:
+ *   Read back one sector.
+ *
+ ****************************************************************************/
+
+static int zram_load(FAR struct zram_dev_s *dev,
+                     FAR const struct zram_slot_s *slot,
+                     FAR uint8_t *buffer)
+{
+  unsigned int i;
+
+  if (slot->zs_len == 0)
+    {
+      for (i = 0; i < dev->zr_sectsize; i += sizeof(uint32_t))
+        {
+          memcpy(&buffer[i], &slot->u.zs_fill, sizeof(uint32_t));
+        }
+    }
+  else if (slot->zs_len == dev->zr_sectsize)
+    {
+      memcpy(buffer, slot->u.zs_data, dev->zr_sectsize);
+    }
+  else if (lzf_decompress(slot->u.zs_data, slot->zs_len, buffer,
+                          dev->zr_sectsize) != dev->zr_sectsize)
+    {
+      ferr("ERROR: Corrupted sector data\n");
+      return -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zram_store
+ *
+ * Description:
+ *   Store one sector.  The old contents are only released once the new
+ *   ones are safely stored, so a failed write leaves the sector unchanged.
+ *
+ ****************************************************************************/
+
+static int zram_store(FAR struct zram_dev_s *dev,
+                      FAR struct zram_slot_s *slot,
+                      FAR const uint8_t *buffer)
+{
+  FAR struct lzf_header_s *header;
+  FAR const uint8_t *src;
+  FAR uint8_t *data;
+  uint16_t sectsize = dev->zr_sectsize;
+  size_t len;
+
+  /* Same-filled?  The sector repeats its first four bytes if it equals
+   * itself shifted by four bytes.  This needs no alignment.
+   */
+
+  if (memcmp(buffer, buffer + sizeof(uint32_t),
+             sectsize - sizeof(uint32_t)) == 0)
+    {
+      zram_release(dev, slot);
+      memcpy(&slot->u.zs_fill, buffer, sizeof(uint32_t));
+      return OK;
+    }
+
+  /* lzf_compress() writes its header in front of the output buffer and,
+   * when it gives up, in front of the input buffer.  So the input is
+   * staged in a buffer with room for that header.
+   */
+
+  memcpy(dev->zr_stage + LZF_TYPE0_HDR_SIZE, buffer, sectsize);
+  len = lzf_compress(dev->zr_stage + LZF_TYPE0_HDR_SIZE, sectsize,
+                     dev->zr_cbuf + LZF_TYPE1_HDR_SIZE,
+                     ZRAM_MAXCOMPRESSED(sectsize), dev->zr_htab, &header);
+
+  if (len > 0 && header->lzf_type == LZF_TYPE1_HDR)
+    {
+      src = dev->zr_cbuf + LZF_TYPE1_HDR_SIZE;
+      len -= LZF_TYPE1_HDR_SIZE;
+    }
+  else
+    {
+      src = buffer;
+      len = sectsize;
+    }
+
+  data = zram_alloc(dev, len);
+  if (data == NULL)
+    {
+      dev->zr_nnomem++;
+      return -ENOSPC;
+    }
+
+  memcpy(data, src, len);
+
+  zram_release(dev, slot);
+  slot->u.zs_data = data;
+  slot->zs_len    = len;
+  dev->zr_stored += len;
+
+  if (len == sectsize)
+    {
+      dev->zr_nraw++;
+    }
+  else
+    {
+      dev->zr_ncompressed++;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zram_destroy
+ *
+ * Description:
+ *   Free all resources used by the compressed RAM disk
+ *
+ ****************************************************************************/
+
+static void zram_destroy(FAR struct zram_dev_s *dev)
+{
+  uint32_t i;
+
+  finfo("Destroying compressed RAM disk\n");
+
+  if (dev->zr_slots != NULL)
+    {
+      for (i = 0; i < dev->zr_nsectors; i++)
+        {
+          zram_release(dev, &dev->zr_slots[i]);
+        }
+
+      kmm_free(dev->zr_slots);
+    }
+
+#ifdef CONFIG_DRVR_ZRAM_GRAN
+  if (dev->zr_gran != NULL)
+    {
+      gran_release(dev->zr_gran);
+    }
+
+  if (dev->zr_granbase != NULL)
+    {
+      kmm_free(dev->zr_granbase);
+    }
+#endif
+
+  if (dev->zr_htab != NULL)
+    {
+      kmm_free(dev->zr_htab);
+    }
+
+  if (dev->zr_cbuf != NULL)
+    {
+      kmm_free(dev->zr_cbuf);
+    }
+
+  if (dev->zr_stage != NULL)
+    {
+      kmm_free(dev->zr_stage);
+    }
+
+  nxsem_destroy(&dev->zr_exclsem);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: zram_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int zram_open(FAR struct inode *inode)
+{
+  FAR struct zram_dev_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct zram_dev_s *)inode->i_private;
+
+  ret = nxsem_wait(&dev->zr_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Increment the open reference count */
+
+  dev->zr_crefs++;
+  DEBUGASSERT(dev->zr_crefs > 0);
+
+  finfo("zr_crefs: %d\n", dev->zr_crefs);
+  nxsem_post(&dev->zr_exclsem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: zram_close
+ *
+ * Description: close the block device
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int zram_close(FAR struct inode *inode)
+{
+  FAR struct zram_dev_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct zram_dev_s *)inode->i_private;
+
+  ret = nxsem_wait(&dev->zr_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Decrement the open reference count */
+
+  DEBUGASSERT(dev->zr_crefs > 0);
+  dev->zr_crefs--;
+  finfo("zr_crefs: %d\n", dev->zr_crefs);
+
+  /* Was that the last open reference to an unlinked disk? */
+
+  if (dev->zr_crefs == 0 && dev->zr_unlinked)
+    {
+      /* Yes.. Release all of the resources */
+
+      zram_destroy(dev);
+      return OK;
+    }
+
+  nxsem_post(&dev->zr_exclsem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: zram_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t zram_read(FAR struct inode *inode, unsigned char *buffer,
+                         size_t start_sector, unsigned int nsectors)
+{
+  FAR struct zram_dev_s *dev;
+  unsigned int i;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct zram_dev_s *)inode->i_private;
+
+  finfo("sector: %d nsectors: %d sectorsize: %d\n",
+        start_sector, nsectors, dev->zr_sectsize);
+
+  if (start_sector >= dev->zr_nsectors ||
+      start_sector + nsectors > dev->zr_nsectors)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&dev->zr_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      ret = zram_load(dev, &dev->zr_slots[start_sector + i],
+                      &buffer[i * dev->zr_sectsize]);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxsem_post(&dev->zr_exclsem);
+  return i > 0 ? (ssize_t)i : ret;
+}
+
+/****************************************************************************
+ * Name: zram_write
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t zram_write(FAR struct inode *inode,
+                          FAR const unsigned char *buffer,
+                          size_t start_sector, unsigned int nsectors)
+{
+  FAR struct zram_dev_s *dev;
+  unsigned int i;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct zram_dev_s *)inode->i_private;
+
+  finfo("sector: %d nsectors: %d sectorsize: %d\n",
+        start_sector, nsectors, dev->zr_sectsize);
+
+  if (start_sector >= dev->zr_nsectors ||
+      start_sector + nsectors > dev->zr_nsectors)
+    {
+      return -EFBIG;
+    }
+
+  ret = nxsem_wait(&dev->zr_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      ret = zram_store(dev, &dev->zr_slots[start_sector + i],
+                       &buffer[i * dev->zr_sectsize]);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxsem_post(&dev->zr_exclsem);
+  return i > 0 ? (ssize_t)i : ret;
+}
+
+/****************************************************************************
+ * Name: zram_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int zram_geometry(FAR struct inode *inode,
+                         FAR struct geometry *geometry)
+{
+  FAR struct zram_dev_s *dev;
+
+  DEBUGASSERT(inode);
+  if (geometry)
+    {
+      dev = (FAR struct zram_dev_s *)inode->i_private;
+      geometry->geo_available     = true;
+      geometry->geo_mediachanged  = false;
+      geometry->geo_writeenabled  = true;
+      geometry->geo_nsectors      = dev->zr_nsectors;
+      geometry->geo_sectorsize    = dev->zr_sectsize;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: zram_ioctl
+ *
+ * Description:
+ *   Return the compression statistics
+ *
+ ****************************************************************************/
+
+static int zram_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct zram_dev_s *dev;
+  FAR struct zram_stats_s *stats =
+    (FAR struct zram_stats_s *)((uintptr_t)arg);
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct zram_dev_s *)inode->i_private;
+
+  if (cmd != BIOC_ZRAMSTATS || stats == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = nxsem_wait(&dev->zr_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stats->zs_nsectors    = dev->zr_nsectors;
+  stats->zs_ncompressed = dev->zr_ncompressed;
+  stats->zs_nraw        = dev->zr_nraw;
+  stats->zs_nsame       = dev->zr_nsectors - dev->zr_ncompressed -
+                          dev->zr_nraw;
+  stats->zs_stored      = dev->zr_stored;
+  stats->zs_original    = (size_t)(dev->zr_ncompressed + dev->zr_nraw) *
+                          dev->zr_sectsize;
+  stats->zs_nnomem      = dev->zr_nnomem;
+
+  nxsem_post(&dev->zr_exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zram_unlink
+ *
+ * Description:
+ *   The block driver has been unlinked.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int zram_unlink(FAR struct inode *inode)
+{
+  FAR struct zram_dev_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct zram_dev_s *)inode->i_private;
+
+  ret = nxsem_wait(&dev->zr_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dev->zr_unlinked = true;
+
+  /* Are the any open references to the driver? */
+
+  if (dev->zr_crefs == 0)
+    {
+      /* No... release all resources held by the block driver */
+
+      zram_destroy(dev);
+      return OK;
+    }
+
+  nxsem_post(&dev->zr_exclsem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: zram_register
+ *
+ * Description:
+ *   Register a compressed RAM disk at /dev/zramN.
+ *
+ * Input Parameters:
+ *   minor:         Selects suffix of device named /dev/zramN, N={0,1,...}
+ *   nsectors:      Number of sectors on device
+ *   sectsize:      The size of one sector, a multiple of 4 bytes
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int zram_register(int minor, uint32_t nsectors, uint16_t sectsize)
+{
+  FAR struct zram_dev_s *dev;
+  char devname[16];
+  int ret;
+
+  finfo("nsectors: %d sectsize: %d\n", nsectors, sectsize);
+
+  if (minor < 0 || minor > 255 || nsectors == 0 ||
+      sectsize < 2 * sizeof(uint32_t) || (sectsize & 3) != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Allocate the device structure and its buffers.  The slot table starts
+   * out zeroed: every sector reads as zeros and uses no memory.
+   */
+
+  dev = (FAR struct zram_dev_s *)kmm_zalloc(sizeof(struct zram_dev_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&dev->zr_exclsem, 0, 1);
+  dev->zr_nsectors = nsectors;
+  dev->zr_sectsize = sectsize;
+
+  dev->zr_slots = (FAR struct zram_slot_s *)
+    kmm_zalloc(nsectors * sizeof(struct zram_slot_s));
+  dev->zr_stage = (FAR uint8_t *)kmm_malloc(sectsize + LZF_TYPE0_HDR_SIZE);
+  dev->zr_cbuf  = (FAR uint8_t *)kmm_malloc(sectsize + LZF_TYPE1_HDR_SIZE);
+  dev->zr_htab  = (FAR lzf_hslot_t *)kmm_malloc(sizeof(lzf_state_t));
+
+  if (dev->zr_slots == NULL || dev->zr_stage == NULL ||
+      dev->zr_cbuf == NULL || dev->zr_htab == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_dev;
+    }
+
+#ifdef CONFIG_DRVR_ZRAM_GRAN
+  /* Sector data comes from a granule pool so that the many small, odd
+   * sized allocations do not fragment the heap.  Without the pool the
+   * heap is used.
+   */
+
+  dev->zr_granbase = (FAR uint8_t *)
+    kmm_memalign(1 << CONFIG_DRVR_ZRAM_GRAN_LOG2,
+                 CONFIG_DRVR_ZRAM_GRAN_SIZE);
+  if (dev->zr_granbase != NULL)
+    {
+      dev->zr_gran = gran_initialize(dev->zr_granbase,
+                                     CONFIG_DRVR_ZRAM_GRAN_SIZE,
+                                     CONFIG_DRVR_ZRAM_GRAN_LOG2,
+                                     CONFIG_DRVR_ZRAM_GRAN_LOG2);
+    }
+
+  if (dev->zr_gran == NULL)
+    {
+      fwarn("WARNING: No granule pool, using the heap\n");
+    }
+#endif
+
+  /* Create a device name */
+
+  snprintf(devname, sizeof(devname), "/dev/zram%d", minor);
+
+  /* Inode private data is a reference to the device structure */
+
+  ret = register_blockdriver(devname, &g_zram_bops, 0, dev);
+  if (ret < 0)
+    {
+      ferr("register_blockdriver failed: %d\n", -ret);
+      goto errout_with_dev;
+    }
+
+  return OK;
+
+errout_with_dev:
+  zram_destroy(dev);
+  return ret;
+}
+
+#endif /* CONFIG_DRVR_ZRAM */
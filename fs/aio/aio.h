@@ -33,6 +33,7 @@
 #include <queue.h>
 
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #ifdef CONFIG_FS_AIO
@@ -49,12 +50,46 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* Number of threads in the AIO worker pool.  Zero selects the low priority
+ * work queue.
+ */
+
+#ifndef CONFIG_FS_AIO_WORKERS
+#  define CONFIG_FS_AIO_WORKERS 0
+#endif
+
+#undef AIO_HAVE_POOL
+#undef AIO_HAVE_LPBOOST
+
+#if CONFIG_FS_AIO_WORKERS > 0
+#  define AIO_HAVE_POOL
+#elif defined(CONFIG_PRIORITY_INHERITANCE)
+#  define AIO_HAVE_LPBOOST  /* Workers restore the LP work queue priority */
+#endif
+
+/* Internal aio_lio_opcode value marking the requests of the AIO ring
+ * driver.  Their completions go to the ring instead of signaling the
+ * client.
+ */
+
+#define AIO_LIO_RING 0x80
+
 #undef AIO_HAVE_PSOCK
 
 #ifdef CONFIG_NET_TCP
 #  define AIO_HAVE_PSOCK
 #endif
 
+/* Sector aligned transfers on block devices may be queued directly on the
+ * block driver.
+ */
+
+#undef AIO_HAVE_BLKREQ
+
+#ifdef CONFIG_FS_BLOCK_REQUEST
+#  define AIO_HAVE_BLKREQ
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -77,7 +112,15 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
+#ifdef AIO_HAVE_POOL
+  dq_entry_t aioc_qlink;           /* Links the container in a device queue */
+  worker_t aioc_worker;            /* Performs the I/O on a pool thread */
+#else
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#endif
+#ifdef AIO_HAVE_BLKREQ
+  struct blk_request_s aioc_req;   /* Used to queue I/O on a block driver */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
@@ -220,7 +263,8 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO worker pool or, if there is
+ *   no pool, on the low priority work queue
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -234,6 +278,46 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not been started yet from the queue
+ *   it was scheduled on by aio_queue().
+ *
+ * Input Parameters:
+ *   aioc - The AIO container to remove
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed before it started.  -ENOENT if it has
+ *   already started (or finished) and cannot be canceled.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Try to queue the transfer directly on the block driver underlying a
+ *   block device file descriptor.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container describing the transfer
+ *   op   - BLKREQ_READ or BLKREQ_WRITE
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; the client will be signaled on
+ *   completion.  A negated errno value if the transfer must be deferred to
+ *   the worker thread with aio_queue() instead.
+ *
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_BLKREQ
+int aio_submit(FAR struct aio_container_s *aioc, uint8_t op);
+#endif
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -253,6 +337,25 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
 int aio_signal(pid_t pid, FAR struct aiocb *aiocbp);
 
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Called from aio_signal() in place of signaling the client when an
+ *   asynchronous I/O started by the AIO ring driver completes.
+ *
+ * Input Parameters:
+ *   aiocbp - The AIO control block of a ring operation (AIO_LIO_RING)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_RING
+void aio_ring_complete(FAR struct aiocb *aiocbp);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
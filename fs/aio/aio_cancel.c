@@ -120,11 +120,11 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * possibilities:* (1) the work has already been started and
                * is no longer queued, or (2) the work has not been started
                * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
+               * be canceled.  aio_dequeue() will return -ENOENT in the
                * first case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending transfers */
@@ -175,11 +175,11 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * possibilities:* (1) the work has already been started and
                * is no longer queued, or (2) the work has not been started
                * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
+               * be canceled.  aio_dequeue() will return -ENOENT in the
                * first case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending transfers */
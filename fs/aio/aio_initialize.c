@@ -30,6 +30,7 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/fs/ioring.h>
 
 #include "aio/aio.h"
 
@@ -113,6 +114,12 @@ void aio_initialize(void)
 
       dq_addlast(&g_aioc_alloc[i].aioc_link, &g_aioc_free);
     }
+
+#ifdef CONFIG_FS_AIO_RING
+  /* Register the AIO ring driver */
+
+  ioring_register();
+#endif
 }
 
 /****************************************************************************
@@ -39,26 +39,234 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <sched.h>
 #include <aio.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
 #include <nuttx/wqueue.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_POOL
+/* The queue of pending I/O for one device.  A device queue exists only
+ * while it has pending or running I/O; there can never be more than one
+ * per container.
+ */
+
+struct aio_devq_s
+{
+  dq_entry_t link;                 /* Links the queue in g_aio_active */
+  FAR void *key;                   /* Identifies the device */
+  dq_queue_t pending;              /* Containers not yet started */
+  bool busy;                       /* A worker is running I/O from it */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_POOL
+static struct aio_devq_s g_aio_devq[CONFIG_FS_NAIOC];
+
+/* Protects the device queues and the worker state below */
+
+static sem_t g_aio_poolsem = SEM_INITIALIZER(1);
+
+static dq_queue_t g_aio_devqfree;  /* Unused device queues */
+static dq_queue_t g_aio_active;    /* Device queues with work */
+static sem_t g_aio_wakesem;        /* Idle workers wait here */
+static uint8_t g_aio_nidle;        /* Number of waiting workers */
+static bool g_aio_started;         /* The workers have been created */
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef AIO_HAVE_POOL
+/****************************************************************************
+ * Name: aio_devkey
+ *
+ * Description:
+ *   Return the key of the device queue for a container: the inode of the
+ *   driver or mount point for files, the socket itself for sockets.
+ *
+ ****************************************************************************/
+
+static FAR void *aio_devkey(FAR struct aio_container_s *aioc)
+{
+#ifdef AIO_HAVE_PSOCK
+  if (aioc->aioc_aiocbp->aio_fildes >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return aioc->u.aioc_psock;
+    }
+#endif
+
+  return aioc->u.aioc_filep->f_inode;
+}
+
+/****************************************************************************
+ * Name: aio_worker
+ *
+ * Description:
+ *   The body of one pool thread.  Take the first request from a device that
+ *   has no I/O in progress, run it, and repeat.
+ *
+ ****************************************************************************/
+
+static int aio_worker(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aio_devq_s *devq;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  struct sched_param param;
+#endif
+  worker_t worker;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_aio_poolsem);
+
+      for (devq = (FAR struct aio_devq_s *)g_aio_active.head;
+           devq != NULL && (devq->busy || dq_empty(&devq->pending));
+           devq = (FAR struct aio_devq_s *)devq->link.flink);
+
+      if (devq == NULL)
+        {
+          /* Nothing can be started.  Wait for new work or for a device to
+           * become idle.
+           */
+
+          g_aio_nidle++;
+          nxsem_post(&g_aio_poolsem);
+          nxsem_wait_uninterruptible(&g_aio_wakesem);
+          continue;
+        }
+
+      aioc = (FAR struct aio_container_s *)
+        ((uintptr_t)dq_remfirst(&devq->pending) -
+         offsetof(struct aio_container_s, aioc_qlink));
+      devq->busy = true;
+      worker     = aioc->aioc_worker;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      /* Run the I/O at the priority of the requester if that is higher */
+
+      if (aioc->aioc_prio > CONFIG_FS_AIO_WORKER_PRIORITY)
+        {
+          param.sched_priority = aioc->aioc_prio;
+          nxsched_set_param(0, &param);
+        }
+#endif
+
+      nxsem_post(&g_aio_poolsem);
+
+      /* Perform the I/O.  This frees the container. */
+
+      worker(aioc);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      param.sched_priority = CONFIG_FS_AIO_WORKER_PRIORITY;
+      nxsched_set_param(0, &param);
+#endif
+
+      nxsem_wait_uninterruptible(&g_aio_poolsem);
+      devq->busy = false;
+
+      if (dq_empty(&devq->pending))
+        {
+          dq_rem(&devq->link, &g_aio_active);
+          dq_addlast(&devq->link, &g_aio_devqfree);
+        }
+      else if (g_aio_nidle > 0)
+        {
+          /* More I/O for this device that another worker may take */
+
+          g_aio_nidle--;
+          nxsem_post(&g_aio_wakesem);
+        }
+
+      nxsem_post(&g_aio_poolsem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_startpool
+ *
+ * Description:
+ *   Initialize the pool and start the worker threads.  Called on the first
+ *   request with g_aio_poolsem held, since the file system is initialized
+ *   before threads can be created.
+ *
+ ****************************************************************************/
+
+static int aio_startpool(void)
+{
+  int ret;
+  int i;
+
+  dq_init(&g_aio_devqfree);
+  dq_init(&g_aio_active);
+
+  for (i = 0; i < CONFIG_FS_NAIOC; i++)
+    {
+      dq_addlast(&g_aio_devq[i].link, &g_aio_devqfree);
+    }
+
+  nxsem_init(&g_aio_wakesem, 0, 0);
+  nxsem_set_protocol(&g_aio_wakesem, SEM_PRIO_NONE);
+
+  for (i = 0; i < CONFIG_FS_AIO_WORKERS; i++)
+    {
+      ret = kthread_create("aio", CONFIG_FS_AIO_WORKER_PRIORITY,
+                           CONFIG_FS_AIO_WORKER_STACKSIZE, aio_worker,
+                           NULL);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to start AIO worker: %d\n", ret);
+
+          /* Carry on with the workers that did start */
+
+          if (i == 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+    }
+
+  g_aio_started = true;
+  return OK;
+}
+#endif /* AIO_HAVE_POOL */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO worker pool or, if there is
+ *   no pool, on the low priority work queue
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -70,6 +278,67 @@
  *
  ****************************************************************************/
 
+#ifdef AIO_HAVE_POOL
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+  FAR struct aio_devq_s *devq;
+  FAR void *key;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&g_aio_poolsem);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!g_aio_started)
+    {
+      ret = aio_startpool();
+      if (ret < 0)
+        {
+          nxsem_post(&g_aio_poolsem);
+          goto errout;
+        }
+    }
+
+  /* Find the queue of the device, or start one */
+
+  key = aio_devkey(aioc);
+  for (devq = (FAR struct aio_devq_s *)g_aio_active.head;
+       devq != NULL && devq->key != key;
+       devq = (FAR struct aio_devq_s *)devq->link.flink);
+
+  if (devq == NULL)
+    {
+      devq = (FAR struct aio_devq_s *)dq_remfirst(&g_aio_devqfree);
+      DEBUGASSERT(devq != NULL);
+
+      devq->key  = key;
+      devq->busy = false;
+      dq_init(&devq->pending);
+      dq_addlast(&devq->link, &g_aio_active);
+    }
+
+  aioc->aioc_worker = worker;
+  dq_addlast(&aioc->aioc_qlink, &devq->pending);
+
+  /* Wake an idle worker if the device can start now */
+
+  if (!devq->busy && g_aio_nidle > 0)
+    {
+      g_aio_nidle--;
+      nxsem_post(&g_aio_wakesem);
+    }
+
+  nxsem_post(&g_aio_poolsem);
+  return OK;
+
+errout:
+  aioc->aioc_aiocbp->aio_result = ret;
+  set_errno(-ret);
+  return ERROR;
+}
+#else
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
   int ret;
@@ -110,4 +379,59 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
+#endif /* AIO_HAVE_POOL */
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not been started yet from the queue
+ *   it was scheduled on by aio_queue().
+ *
+ * Input Parameters:
+ *   aioc - The AIO container to remove
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed before it started.  -ENOENT if it has
+ *   already started (or finished) and cannot be canceled.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+#ifdef AIO_HAVE_POOL
+  FAR struct aio_devq_s *devq;
+  FAR dq_entry_t *entry;
+  int ret = -ENOENT;
+
+  nxsem_wait_uninterruptible(&g_aio_poolsem);
+
+  for (devq = (FAR struct aio_devq_s *)g_aio_active.head;
+       devq != NULL && ret < 0;
+       devq = (FAR struct aio_devq_s *)devq->link.flink)
+    {
+      for (entry = devq->pending.head; entry != NULL; entry = entry->flink)
+        {
+          if (entry == &aioc->aioc_qlink)
+            {
+              dq_rem(entry, &devq->pending);
+              if (!devq->busy && dq_empty(&devq->pending))
+                {
+                  dq_rem(&devq->link, &g_aio_active);
+                  dq_addlast(&devq->link, &g_aio_devqfree);
+                }
+
+              ret = OK;
+              break;
+            }
+        }
+    }
+
+  nxsem_post(&g_aio_poolsem);
+  return ret;
+#else
+  return work_cancel(LPWORK, &aioc->aioc_work);
+#endif
+}
+
 #endif /* CONFIG_FS_AIO */
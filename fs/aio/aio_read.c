@@ -77,7 +77,7 @@ static void aio_read_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_LPBOOST
   uint8_t prio;
 #endif
   ssize_t nread = 0;
@@ -89,7 +89,7 @@ static void aio_read_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_LPBOOST
   prio   = aioc->aioc_prio;
 #endif
   aiocbp = aioc_decant(aioc);
@@ -139,7 +139,7 @@ static void aio_read_worker(FAR void *arg)
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_LPBOOST
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
@@ -272,6 +272,15 @@ int aio_read(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
+#ifdef AIO_HAVE_BLKREQ
+  /* Queue the transfer directly on the block driver if possible */
+
+  if (aio_submit(aioc, BLKREQ_READ) >= 0)
+    {
+      return OK;
+    }
+
+#endif
   /* Defer the work to the worker thread */
 
   ret = aio_queue(aioc, aio_read_worker);
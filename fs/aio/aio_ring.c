@@ -0,0 +1,618 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <aio.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioring.h>
+#include <nuttx/net/net.h>
+
+#include "aio/aio.h"
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one in-flight operation */
+
+enum aio_ropstate_e
+{
+  AIO_ROP_FREE = 0,                /* Not in use */
+  AIO_ROP_AIO,                     /* Queued as asynchronous I/O */
+  AIO_ROP_POLL                     /* Waiting for a poll event */
+};
+
+struct aio_ring_s;
+struct aio_rop_s
+{
+  struct aiocb rop_aiocb;          /* Must be first: the AIO request */
+  FAR struct aio_ring_s *rop_ring; /* The owning ring context */
+  FAR void *rop_udata;             /* Returned in the completion */
+  struct pollfd rop_fds;           /* Used by IORING_OP_POLL */
+  uint8_t rop_state;               /* See enum aio_ropstate_e */
+};
+
+/* The state of one open of the driver */
+
+struct aio_ring_s
+{
+  FAR struct ioring_s *ring;       /* The application's rings */
+  FAR struct aio_rop_s *rops;      /* One per completion queue entry */
+  uint32_t nrops;                  /* Number of entries in rops[] */
+  uint32_t ninflight;              /* Operations not yet completed */
+  uint8_t crefs;                   /* Number of open references */
+  sem_t exclsem;                   /* Serializes SETUP/ENTER/close */
+  sem_t waitsem;                   /* Posted on each completion */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int aio_ring_open(FAR struct file *filep);
+static int aio_ring_close(FAR struct file *filep);
+static int aio_ring_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_aio_ringops =
+{
+  aio_ring_open,   /* open */
+  aio_ring_close,  /* close */
+  NULL,            /* read */
+  NULL,            /* write */
+  NULL,            /* seek */
+  aio_ring_ioctl,  /* ioctl */
+  NULL             /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL           /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_poll
+ *
+ * Description:
+ *   Setup or teardown the poll of a file or socket descriptor
+ *
+ ****************************************************************************/
+
+static int aio_ring_poll(FAR struct pollfd *fds, bool setup)
+{
+  if (fds->fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+#ifdef CONFIG_NET
+      return net_poll(fds->fd, fds, setup);
+#else
+      return -EBADF;
+#endif
+    }
+
+  return fs_poll(fds->fd, fds, setup);
+}
+
+/****************************************************************************
+ * Name: aio_ring_post
+ *
+ * Description:
+ *   Add one entry to the completion queue and release the operation.  This
+ *   may run on an AIO worker or in the completion interrupt of a block
+ *   driver.  Room in the completion queue was reserved at submission.
+ *
+ ****************************************************************************/
+
+static void aio_ring_post(FAR struct aio_rop_s *rop, ssize_t res)
+{
+  FAR struct aio_ring_s *priv = rop->rop_ring;
+  FAR struct ioring_s *ring;
+  FAR struct ioring_cqe_s *cqe;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* The ring is gone if the file is being closed */
+
+  ring = priv->ring;
+  if (ring != NULL)
+    {
+      cqe = &ring->cqes[ring->cq_tail & ring->cq_mask];
+      cqe->user_data = rop->rop_udata;
+      cqe->res       = res;
+      ring->cq_tail++;
+    }
+
+  rop->rop_state = AIO_ROP_FREE;
+  priv->ninflight--;
+  leave_critical_section(flags);
+
+  nxsem_post(&priv->waitsem);
+}
+
+/****************************************************************************
+ * Name: aio_ring_room
+ *
+ * Description:
+ *   Return a free operation if the completion queue can take one more
+ *   completion, counting those of the operations still in flight.
+ *
+ ****************************************************************************/
+
+static FAR struct aio_rop_s *aio_ring_room(FAR struct aio_ring_s *priv)
+{
+  FAR struct ioring_s *ring = priv->ring;
+  FAR struct aio_rop_s *rop = NULL;
+  irqstate_t flags;
+  uint32_t i;
+
+  flags = enter_critical_section();
+  if (priv->ninflight + (uint32_t)(ring->cq_tail - ring->cq_head) <
+      priv->nrops)
+    {
+      for (i = 0; i < priv->nrops; i++)
+        {
+          if (priv->rops[i].rop_state == AIO_ROP_FREE)
+            {
+              rop = &priv->rops[i];
+              rop->rop_state = AIO_ROP_AIO;
+              priv->ninflight++;
+              break;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+  return rop;
+}
+
+/****************************************************************************
+ * Name: aio_ring_submit
+ *
+ * Description:
+ *   Start the operation described by one submission queue entry.  Errors
+ *   are reported in the completion, never to the caller.
+ *
+ ****************************************************************************/
+
+static void aio_ring_submit(FAR struct aio_rop_s *rop,
+                            FAR const struct ioring_sqe_s *sqe)
+{
+  FAR struct aiocb *aiocbp = &rop->rop_aiocb;
+  int ret;
+
+  rop->rop_udata = sqe->user_data;
+
+  if (sqe->fd < 0 ||
+      sqe->fd >= CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS)
+    {
+      ret = sqe->opcode == IORING_OP_NOP ? OK : -EBADF;
+      goto errout;
+    }
+
+  if (sqe->opcode == IORING_OP_POLL)
+    {
+      FAR struct pollfd *fds = &rop->rop_fds;
+
+      /* The poll event posts the same semaphore as the other completions;
+       * aio_ring_reap() then finds the event and completes the operation.
+       */
+
+      fds->fd      = sqe->fd;
+      fds->events  = sqe->events | POLLERR | POLLHUP;
+      fds->revents = 0;
+      fds->sem     = &rop->rop_ring->waitsem;
+      fds->priv    = NULL;
+
+      rop->rop_state = AIO_ROP_POLL;
+      ret = aio_ring_poll(fds, true);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      return;
+    }
+
+  memset(aiocbp, 0, sizeof(struct aiocb));
+  aiocbp->aio_sigevent.sigev_notify = SIGEV_NONE;
+  aiocbp->aio_buf        = sqe->buf;
+  aiocbp->aio_offset     = sqe->offset;
+  aiocbp->aio_nbytes     = sqe->nbytes;
+  aiocbp->aio_fildes     = sqe->fd;
+  aiocbp->aio_lio_opcode = AIO_LIO_RING;
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        ret = OK;
+        goto errout;
+
+      case IORING_OP_SEND:
+      case IORING_OP_RECV:
+#ifdef AIO_HAVE_PSOCK
+        if (sqe->fd < CONFIG_NFILE_DESCRIPTORS)
+          {
+            ret = -ENOTSOCK;
+            goto errout;
+          }
+
+        ret = sqe->opcode == IORING_OP_SEND ? aio_write(aiocbp) :
+                                              aio_read(aiocbp);
+        break;
+#else
+        ret = -ENOSYS;
+        goto errout;
+#endif
+
+      case IORING_OP_READ:
+        ret = aio_read(aiocbp);
+        break;
+
+      case IORING_OP_WRITE:
+        ret = aio_write(aiocbp);
+        break;
+
+      case IORING_OP_FSYNC:
+        ret = aio_fsync(O_SYNC, aiocbp);
+        break;
+
+      default:
+        ret = -EINVAL;
+        goto errout;
+    }
+
+  /* On success, the completion will be posted by aio_ring_complete() */
+
+  if (ret >= 0)
+    {
+      return;
+    }
+
+  ret = aiocbp->aio_result;
+
+errout:
+  aio_ring_post(rop, ret);
+}
+
+/****************************************************************************
+ * Name: aio_ring_reap
+ *
+ * Description:
+ *   Complete the poll operations whose events have occurred
+ *
+ ****************************************************************************/
+
+static void aio_ring_reap(FAR struct aio_ring_s *priv)
+{
+  FAR struct aio_rop_s *rop;
+  uint32_t i;
+
+  for (i = 0; i < priv->nrops; i++)
+    {
+      rop = &priv->rops[i];
+      if (rop->rop_state == AIO_ROP_POLL && rop->rop_fds.revents != 0)
+        {
+          aio_ring_poll(&rop->rop_fds, false);
+          aio_ring_post(rop, rop->rop_fds.revents);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: aio_ring_setup
+ ****************************************************************************/
+
+static int aio_ring_setup(FAR struct aio_ring_s *priv,
+                          FAR struct ioring_s *ring)
+{
+  if (priv->ring != NULL)
+    {
+      return -EBUSY;
+    }
+
+  if (ring == NULL || ring->sqes == NULL || ring->cqes == NULL ||
+      (ring->sq_mask & (ring->sq_mask + 1)) != 0 ||
+      (ring->cq_mask & (ring->cq_mask + 1)) != 0 ||
+      ring->cq_mask >= UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* One operation for each completion queue entry: an operation is only
+   * started when its completion is sure to have room.
+   */
+
+  priv->nrops = ring->cq_mask + 1;
+  priv->rops  = (FAR struct aio_rop_s *)
+    kmm_zalloc(priv->nrops * sizeof(struct aio_rop_s));
+  if (priv->rops == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->ring = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_enter
+ ****************************************************************************/
+
+static int aio_ring_enter(FAR struct aio_ring_s *priv,
+                          FAR const struct ioring_enter_s *enter)
+{
+  FAR struct ioring_s *ring = priv->ring;
+  FAR struct aio_rop_s *rop;
+  unsigned int nsubmitted = 0;
+  int ret;
+
+  if (ring == NULL || enter == NULL ||
+      enter->min_complete > priv->nrops)
+    {
+      return -EINVAL;
+    }
+
+  /* Start the new submissions, as many as the completion queue has room
+   * for.
+   */
+
+  while (nsubmitted < enter->to_submit && ring->sq_head != ring->sq_tail)
+    {
+      rop = aio_ring_room(priv);
+      if (rop == NULL)
+        {
+          break;
+        }
+
+      rop->rop_ring = priv;
+      aio_ring_submit(rop, &ring->sqes[ring->sq_head & ring->sq_mask]);
+      ring->sq_head++;
+      nsubmitted++;
+    }
+
+  /* Wait for the requested number of completions.  Don't wait for
+   * completions that can never come.
+   */
+
+  for (; ; )
+    {
+      aio_ring_reap(priv);
+
+      if ((uint32_t)(ring->cq_tail - ring->cq_head) >= enter->min_complete ||
+          priv->ninflight == 0)
+        {
+          break;
+        }
+
+      ret = nxsem_wait(&priv->waitsem);
+      if (ret < 0)
+        {
+          /* Report the interruption only if nothing else happened */
+
+          return nsubmitted > 0 ? nsubmitted : ret;
+        }
+    }
+
+  if (nsubmitted == 0 && enter->to_submit > 0 &&
+      ring->sq_head != ring->sq_tail)
+    {
+      return -EBUSY;
+    }
+
+  return nsubmitted;
+}
+
+/****************************************************************************
+ * Name: aio_ring_open
+ ****************************************************************************/
+
+static int aio_ring_open(FAR struct file *filep)
+{
+  FAR struct aio_ring_s *priv = filep->f_priv;
+
+  /* A duplicated descriptor shares the context of the original */
+
+  if (priv != NULL)
+    {
+      nxsem_wait_uninterruptible(&priv->exclsem);
+      priv->crefs++;
+      nxsem_post(&priv->exclsem);
+      return OK;
+    }
+
+  priv = (FAR struct aio_ring_s *)kmm_zalloc(sizeof(struct aio_ring_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->crefs = 1;
+  nxsem_init(&priv->exclsem, 0, 1);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&priv->waitsem, 0, 0);
+  nxsem_set_protocol(&priv->waitsem, SEM_PRIO_NONE);
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_close
+ ****************************************************************************/
+
+static int aio_ring_close(FAR struct file *filep)
+{
+  FAR struct aio_ring_s *priv = filep->f_priv;
+  FAR struct aio_rop_s *rop;
+  irqstate_t flags;
+  uint32_t i;
+
+  nxsem_wait_uninterruptible(&priv->exclsem);
+  if (--priv->crefs > 0)
+    {
+      nxsem_post(&priv->exclsem);
+      return OK;
+    }
+
+  /* Stop posting completions to the application's rings, which may be
+   * freed as soon as we return.
+   */
+
+  flags = enter_critical_section();
+  priv->ring = NULL;
+  leave_critical_section(flags);
+
+  /* Cancel or wait for everything still in flight */
+
+  for (i = 0; i < priv->nrops; i++)
+    {
+      rop = &priv->rops[i];
+      if (rop->rop_state == AIO_ROP_POLL)
+        {
+          aio_ring_poll(&rop->rop_fds, false);
+          aio_ring_post(rop, -ECANCELED);
+        }
+      else if (rop->rop_state == AIO_ROP_AIO)
+        {
+          aio_cancel(rop->rop_aiocb.aio_fildes, &rop->rop_aiocb);
+        }
+    }
+
+  while (priv->ninflight > 0)
+    {
+      nxsem_wait_uninterruptible(&priv->waitsem);
+    }
+
+  nxsem_destroy(&priv->waitsem);
+  nxsem_destroy(&priv->exclsem);
+  kmm_free(priv->rops);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_ioctl
+ ****************************************************************************/
+
+static int aio_ring_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg)
+{
+  FAR struct aio_ring_s *priv = filep->f_priv;
+  int ret;
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case IORINGIOC_SETUP:
+        ret = aio_ring_setup(priv, (FAR struct ioring_s *)((uintptr_t)arg));
+        break;
+
+      case IORINGIOC_ENTER:
+        ret = aio_ring_enter(priv,
+                     (FAR const struct ioring_enter_s *)((uintptr_t)arg));
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxsem_post(&priv->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Called from aio_signal() in place of signaling the client when an
+ *   asynchronous I/O started by the AIO ring driver completes.
+ *
+ * Input Parameters:
+ *   aiocbp - The AIO control block of a ring operation (AIO_LIO_RING)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_ring_complete(FAR struct aiocb *aiocbp)
+{
+  FAR struct aio_rop_s *rop = (FAR struct aio_rop_s *)aiocbp;
+
+  DEBUGASSERT(rop->rop_state == AIO_ROP_AIO);
+  aio_ring_post(rop, aiocbp->aio_result);
+}
+
+/****************************************************************************
+ * Name: ioring_register
+ *
+ * Description:
+ *   Register the AIO ring driver at IORING_DEVPATH
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ioring_register(void)
+{
+  return register_driver(IORING_DEVPATH, &g_aio_ringops, 0666, NULL);
+}
+
+#endif /* CONFIG_FS_AIO_RING */
@@ -72,6 +72,16 @@ int aio_signal(pid_t pid, FAR struct aiocb *aiocbp)
 
   ret = OK; /* Assume success */
 
+#ifdef CONFIG_FS_AIO_RING
+  /* Requests of the AIO ring driver complete into the ring */
+
+  if (aiocbp->aio_lio_opcode == AIO_LIO_RING)
+    {
+      aio_ring_complete(aiocbp);
+      return OK;
+    }
+
+#endif
   /* Signal the client */
 
   ret = nxsig_notification(pid, &aiocbp->aio_sigevent,
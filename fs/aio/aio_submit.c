@@ -0,0 +1,157 @@
+/****************************************************************************
+ * fs/aio/aio_submit.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <aio.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "aio/aio.h"
+
+#ifdef AIO_HAVE_BLKREQ
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_complete
+ *
+ * Description:
+ *   Called by the block driver when a submitted request completes.  This
+ *   releases the container and signals the client just as the worker
+ *   functions do at the end of a deferred transfer.
+ *
+ ****************************************************************************/
+
+static void aio_complete(FAR struct blk_request_s *req)
+{
+  FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)
+                                     req->br_priv;
+  FAR struct aiocb *aiocbp;
+  ssize_t result;
+  pid_t pid;
+
+  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
+
+  /* Convert the sector count to a byte count before the container (which
+   * holds the request) is released.
+   */
+
+  result = req->br_result;
+  if (result > 0)
+    {
+      result *= aioc->aioc_aiocbp->aio_nbytes / req->br_nsectors;
+    }
+  else if (result < 0)
+    {
+      ferr("ERROR: block request failed: %d\n", (int)result);
+    }
+
+  pid    = aioc->aioc_pid;
+  aiocbp = aioc_decant(aioc);
+
+  aiocbp->aio_result = result;
+  aio_signal(pid, aiocbp);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Try to queue the transfer directly on the block driver underlying a
+ *   block device file descriptor (see block_submit()).  This is only
+ *   possible if the file is the character driver proxy of a block driver
+ *   and the transfer is a whole number of sectors at a sector aligned
+ *   offset.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container describing the transfer
+ *   op   - BLKREQ_READ or BLKREQ_WRITE
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; the client will be signaled on
+ *   completion.  A negated errno value if the transfer must be deferred to
+ *   the worker thread with aio_queue() instead.
+ *
+ ****************************************************************************/
+
+int aio_submit(FAR struct aio_container_s *aioc, uint8_t op)
+{
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  FAR struct blk_request_s *req = &aioc->aioc_req;
+  FAR struct file *filep;
+  struct geometry geo;
+  int ret;
+
+#ifdef AIO_HAVE_PSOCK
+  if (aiocbp->aio_fildes >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -ENOTBLK;
+    }
+#endif
+
+  filep = aioc->u.aioc_filep;
+  if (op == BLKREQ_WRITE && (filep->f_oflags & O_APPEND) != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Only a block device proxy will report the block geometry */
+
+  ret = file_ioctl(filep, BIOC_GEOMETRY, (unsigned long)((uintptr_t)&geo));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (geo.geo_sectorsize == 0 || aiocbp->aio_nbytes == 0 ||
+      aiocbp->aio_offset < 0 ||
+      (aiocbp->aio_offset % geo.geo_sectorsize) != 0 ||
+      (aiocbp->aio_nbytes % geo.geo_sectorsize) != 0)
+    {
+      return -EINVAL;
+    }
+
+  req->br_op       = op;
+  req->br_buffer   = (FAR uint8_t *)aiocbp->aio_buf;
+  req->br_sector   = aiocbp->aio_offset / geo.geo_sectorsize;
+  req->br_nsectors = aiocbp->aio_nbytes / geo.geo_sectorsize;
+  req->br_result   = 0;
+  req->br_complete = aio_complete;
+  req->br_priv     = aioc;
+
+  return file_ioctl(filep, BIOC_SUBMIT, (unsigned long)((uintptr_t)req));
+}
+
+#endif /* AIO_HAVE_BLKREQ */
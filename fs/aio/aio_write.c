@@ -77,7 +77,7 @@ static void aio_write_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_LPBOOST
   uint8_t prio;
 #endif
   ssize_t nwritten = 0;
@@ -90,7 +90,7 @@ static void aio_write_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_LPBOOST
   prio   = aioc->aioc_prio;
 #endif
   aiocbp = aioc_decant(aioc);
@@ -166,7 +166,7 @@ errout:
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_HAVE_LPBOOST
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
@@ -301,6 +301,15 @@ int aio_write(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
+#ifdef AIO_HAVE_BLKREQ
+  /* Queue the transfer directly on the block driver if possible */
+
+  if (aio_submit(aioc, BLKREQ_WRITE) >= 0)
+    {
+      return OK;
+    }
+
+#endif
   /* Defer the work to the worker thread */
 
   ret = aio_queue(aioc, aio_write_worker);
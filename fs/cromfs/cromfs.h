@@ -43,6 +43,14 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of the cn_flags field of struct cromfs_node_s */
+
+#define CROMFS_FLAG_INDEX  (1 << 0)  /* cn_blocks refers to a block index */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -115,12 +123,20 @@ struct cromfs_volume_s
  *                Return 0
  *   st_ctime   - Time of last status change
  *                Return 0
+ *
+ * The data of a regular file is a sequence of LZF blocks.  Every block
+ * except the last holds exactly cv_bsize bytes of uncompressed data.  If
+ * CROMFS_FLAG_INDEX is set in cn_flags, cn_blocks refers to an index of
+ * uint32_t volume offsets, one per block, that immediately precedes the
+ * first block.  The block holding file offset 'pos' is then found directly
+ * as entry pos / cv_bsize of the index.  Index entries are not necessarily
+ * aligned.  Images without the flag are located by walking the blocks.
  */
 
 struct cromfs_node_s
 {
   uint16_t cn_mode;      /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;       /* Not used */
+  uint16_t cn_flags;     /* See CROMFS_FLAG_* definitions */
   uint32_t cn_name;      /* Offset from the beginning of the volume header to the
                           * node name string.  NUL-terminated. */
   uint32_t cn_size;      /* Size of the uncompressed data (in bytes) */
@@ -38,6 +38,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -52,6 +53,10 @@
 
 #define CROMFS_MAX_LINKS 64
 
+#ifndef CONFIG_FS_CROMFS_NCACHE
+#  define CONFIG_FS_CROMFS_NCACHE 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -61,11 +66,27 @@
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+#if CONFIG_FS_CROMFS_NCACHE == 0
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
 };
 
+/* This structure describes one entry of the decompressed block cache that
+ * is shared by all open files.
+ */
+
+#if CONFIG_FS_CROMFS_NCACHE > 0
+struct cromfs_cache_s
+{
+  FAR const struct lzf_header_s *cc_hdr;    /* Compressed block (NULL means none) */
+  FAR uint8_t *cc_buffer;                   /* Decompressed data */
+  uint16_t cc_ulen;                         /* Length of decompressed data */
+  uint16_t cc_size;                         /* Allocated size of cc_buffer */
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -120,6 +141,17 @@ static int      cromfs_child_node(FAR const struct cromfs_volume_s *fs,
 static int      cromfs_compare_node(FAR const struct cromfs_volume_s *fs,
                   FAR const struct cromfs_node_s *node, uint32_t offset,
                   FAR void *arg);
+static FAR const struct lzf_header_s *
+                cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct cromfs_node_s *node, uint32_t fpos,
+                  FAR uint32_t *blkoffs);
+static unsigned int cromfs_decompress(FAR const struct lzf_header_s *hdr,
+                  FAR uint8_t *dest, uint32_t destlen);
+#if CONFIG_FS_CROMFS_NCACHE > 0
+static int      cromfs_cache_read(FAR const struct lzf_header_s *hdr,
+                  uint32_t bsize, unsigned int copyoffs,
+                  unsigned int copysize, FAR uint8_t *dest);
+#endif
 static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                   FAR const char *relpath,
                   FAR struct cromfs_nodeinfo_s *info,
@@ -207,6 +239,13 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/* The decompressed block cache, ordered from most to least recently used */
+
+#if CONFIG_FS_CROMFS_NCACHE > 0
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_FS_CROMFS_NCACHE];
+static sem_t g_cromfs_cachesem = SEM_INITIALIZER(1);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -330,7 +369,7 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
            */
 
           newnode->cn_mode    = S_IFDIR | (node->cn_mode & ~S_IFMT);
-          newnode->cn_pad     = 0;
+          newnode->cn_flags   = 0;
           newnode->cn_name    = node->cn_name;
           newnode->cn_size    = 0;
           newnode->cn_peer    = node->cn_peer;
@@ -347,13 +386,13 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
       /* Copy the origin node file name into the writable node copy */
 
       newnode->cn_name   = node->cn_name;
-      newnode->cn_pad    = 0;
 
       /* Copy all attributes of the target node, but retain the hard link
        * file name and, possibly, the peer node reference.
        */
 
       newnode->cn_mode   = linknode->cn_mode;
+      newnode->cn_flags  = linknode->cn_flags;
       newnode->cn_size   = linknode->cn_size;
       newnode->u.cn_link = linknode->u.cn_link;
 
@@ -704,6 +743,199 @@ static int cromfs_find_node(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_find_block
+ *
+ * Description:
+ *   Return the header of the compressed block that holds file offset 'fpos'
+ *   of a regular file node and the file offset of the start of that block
+ *   in 'blkoffs'.  If the node has a block index, the block is found
+ *   directly.  Otherwise, the blocks must be walked from the first.
+ *
+ ****************************************************************************/
+
+static FAR const struct lzf_header_s *
+cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct cromfs_node_s *node, uint32_t fpos,
+                  FAR uint32_t *blkoffs)
+{
+  FAR const struct lzf_header_s *hdr;
+  FAR const uint8_t *index;
+  uint32_t blkno;
+  uint32_t blksize;
+  uint32_t offset;
+  uint16_t ulen;
+
+  DEBUGASSERT(fpos < node->cn_size);
+
+  if ((node->cn_flags & CROMFS_FLAG_INDEX) != 0)
+    {
+      /* The index entries may not be aligned */
+
+      blkno    = fpos / fs->cv_bsize;
+      index    = (FAR const uint8_t *)
+                 cromfs_offset2addr(fs, node->u.cn_blocks);
+      memcpy(&offset, &index[blkno * sizeof(uint32_t)], sizeof(uint32_t));
+
+      *blkoffs = blkno * fs->cv_bsize;
+      return (FAR const struct lzf_header_s *)cromfs_offset2addr(fs, offset);
+    }
+
+  hdr      = (FAR const struct lzf_header_s *)
+             cromfs_offset2addr(fs, node->u.cn_blocks);
+  *blkoffs = 0;
+
+  for (; ; )
+    {
+      if (hdr->lzf_type == LZF_TYPE0_HDR)
+        {
+          FAR const struct lzf_type0_header_s *hdr0 =
+            (FAR const struct lzf_type0_header_s *)hdr;
+
+          ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
+                    (uint16_t)hdr0->lzf_len[1];
+          blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
+        }
+      else
+        {
+          FAR const struct lzf_type1_header_s *hdr1 =
+            (FAR const struct lzf_type1_header_s *)hdr;
+
+          ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+                    (uint16_t)hdr1->lzf_ulen[1];
+          blksize = ((uint32_t)hdr1->lzf_clen[0] << 8 |
+                     (uint32_t)hdr1->lzf_clen[1]) + LZF_TYPE1_HDR_SIZE;
+        }
+
+      if (fpos < *blkoffs + ulen)
+        {
+          return hdr;
+        }
+
+      *blkoffs += ulen;
+      hdr       = (FAR const struct lzf_header_s *)
+                  ((FAR const uint8_t *)hdr + blksize);
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_decompress
+ *
+ * Description:
+ *   Decompress an LZF (LZF_TYPE1_HDR) or LZ4 (LZF_TYPE2_HDR) block into
+ *   'dest'.  Returns the decompressed size or zero on any failure.
+ *
+ ****************************************************************************/
+
+static unsigned int cromfs_decompress(FAR const struct lzf_header_s *hdr,
+                                      FAR uint8_t *dest, uint32_t destlen)
+{
+  FAR const struct lzf_type1_header_s *hdr1 =
+    (FAR const struct lzf_type1_header_s *)hdr;
+  FAR const uint8_t *src;
+  uint16_t clen;
+
+  src  = (FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE;
+  clen = (uint16_t)hdr1->lzf_clen[0] << 8 | (uint16_t)hdr1->lzf_clen[1];
+
+  switch (hdr->lzf_type)
+    {
+      case LZF_TYPE1_HDR:
+        return lzf_decompress(src, clen, dest, destlen);
+
+#ifdef CONFIG_LIBC_LZF_LZ4
+      case LZF_TYPE2_HDR:
+        return lz4_decompress(src, clen, dest, destlen);
+#endif
+
+      default:
+        ferr("ERROR: Unsupported block type %u\n", hdr->lzf_type);
+        return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_read
+ *
+ * Description:
+ *   Copy part of a compressed block to 'dest' from the decompressed block
+ *   cache, decompressing it into the least recently used entry first if it
+ *   is not already cached.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_NCACHE > 0
+static int cromfs_cache_read(FAR const struct lzf_header_s *hdr,
+                             uint32_t bsize, unsigned int copyoffs,
+                             unsigned int copysize, FAR uint8_t *dest)
+{
+  struct cromfs_cache_s entry;
+  int ret;
+  int i;
+
+  ret = nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Search for the block.  If it is not found, 'i' is left at the least
+   * recently used entry which is then replaced.
+   */
+
+  for (i = 0; i < CONFIG_FS_CROMFS_NCACHE - 1; i++)
+    {
+      if (g_cromfs_cache[i].cc_hdr == hdr)
+        {
+          break;
+        }
+    }
+
+  entry = g_cromfs_cache[i];
+  if (entry.cc_hdr != hdr)
+    {
+      if (entry.cc_size < bsize)
+        {
+          if (entry.cc_buffer != NULL)
+            {
+              kmm_free(entry.cc_buffer);
+            }
+
+          entry.cc_hdr    = NULL;
+          entry.cc_buffer = (FAR uint8_t *)kmm_malloc(bsize);
+          entry.cc_size   = entry.cc_buffer != NULL ? bsize : 0;
+
+          if (entry.cc_buffer == NULL)
+            {
+              g_cromfs_cache[i] = entry;
+              nxsem_post(&g_cromfs_cachesem);
+              return -ENOMEM;
+            }
+        }
+
+      entry.cc_ulen = cromfs_decompress(hdr, entry.cc_buffer, bsize);
+      entry.cc_hdr  = entry.cc_ulen > 0 ? hdr : NULL;
+    }
+
+  /* Make this the most recently used entry */
+
+  memmove(&g_cromfs_cache[1], &g_cromfs_cache[0],
+          i * sizeof(struct cromfs_cache_s));
+  g_cromfs_cache[0] = entry;
+
+  if (entry.cc_ulen < (copyoffs + copysize))
+    {
+      nxsem_post(&g_cromfs_cachesem);
+      return -EIO;
+    }
+
+  memcpy(dest, &entry.cc_buffer[copyoffs], copysize);
+
+  nxsem_post(&g_cromfs_cachesem);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -772,6 +1004,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_NCACHE == 0
   /* Create a file buffer to support partial sector accesses */
 
   ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -780,6 +1013,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       kmm_free(ff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -806,11 +1040,13 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
+#if CONFIG_FS_CROMFS_NCACHE == 0
   kmm_free(ff->ff_buffer);
+#endif
   kmm_free(ff);
 
   return OK;
@@ -852,7 +1088,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -880,19 +1116,19 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   fpos      = filep->f_pos;
   blkoffs   = 0;
   ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+  nexthdr   = NULL;
 
-  /* Look until we find the compressed block containing the start of the
-   * requested data.
-   */
+  if (remaining > 0)
+    {
+      nexthdr = (FAR struct lzf_header_s *)
+                cromfs_find_block(fs, ff->ff_node, fpos, &blkoffs);
+    }
 
   while (remaining > 0)
     {
-      /* Search for the next block containing the fpos file offset.  This is
-       * real search on the first time through but the remaining blocks
-       * should be contiguous so that the logic should not loop.
-       *
+      /* Get the next block containing the fpos file offset.  The first
+       * block was located above and the remaining blocks are contiguous so
+       * that the logic should not loop.
        */
 
       do
@@ -960,41 +1196,34 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
           /* If the source of the data is at the beginning of the compressed
            * data buffer and if the uncompressed data would not overrun the
            * buffer, then we can decompress directly into the user buffer.
+           * The data is not cached in that case:  The whole block has been
+           * consumed.
            */
 
           if (filep->f_pos <= blkoffs && ulen <= remaining)
             {
-              uint32_t voloffs;
+              unsigned int decomplen;
 
-              copyoffs = 0;
-              copysize = ulen;
-
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
+              copyoffs  = 0;
+              copysize  = ulen;
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+              decomplen = cromfs_decompress(currhdr, dest, fs->cv_bsize);
 
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+              finfo("blkoffs=%lu ulen=%u copysize=%u\n",
+                    (unsigned long)blkoffs, ulen, copysize);
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+              if (decomplen < copysize)
+                {
+                  return -EIO;
                 }
-
-              finfo(
-                "voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
             }
           else
             {
+#if CONFIG_FS_CROMFS_NCACHE == 0
               uint32_t voloffs;
+#else
+              int ret;
+#endif
 
               /* No, we will need to decompress into the our intermediate
                * decompression buffer.
@@ -1012,14 +1241,27 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
               DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
 
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+#if CONFIG_FS_CROMFS_NCACHE > 0
+              /* Get the data from the shared decompressed block cache */
+
+              ret = cromfs_cache_read(currhdr, fs->cv_bsize, copyoffs,
+                                      copysize, dest);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              finfo("blkoffs=%lu ulen=%u clen=%u copyoffs=%u copysize=%u\n",
+                    (unsigned long)blkoffs, ulen, clen, copyoffs, copysize);
+#else
+              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
               voloffs = cromfs_addr2offset(fs, src);
               if (voloffs != ff->ff_offset)
                 {
                   unsigned int decomplen;
 
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
+                  decomplen = cromfs_decompress(currhdr, ff->ff_buffer,
+                                                fs->cv_bsize);
 
                   ff->ff_offset = voloffs;
                   ff->ff_ulen   = decomplen;
@@ -1034,6 +1276,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
               /* Then copy to user buffer */
 
               memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+#endif
             }
         }
 
@@ -1089,7 +1332,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1101,6 +1344,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_NCACHE == 0
   /* Create a file buffer to support partial sector accesses */
 
   newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -1109,6 +1353,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       kmm_free(newff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -1146,7 +1391,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -28,6 +28,7 @@
 #include <dirent.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 
@@ -44,6 +45,7 @@
 static inline int readpseudodir(struct fs_dirent_s *idir)
 {
   FAR struct inode *prev;
+  irqstate_t flags;
   int ret;
 
   /* Check if we are at the end of the list */
@@ -120,7 +122,7 @@ static inline int readpseudodir(struct fs_dirent_s *idir)
 
   /* Now get the inode to visit next time that readdir() is called */
 
-  ret = inode_semtake();
+  ret = inode_rdlock();
   if (ret < 0)
     {
       return ret;
@@ -133,10 +135,12 @@ static inline int readpseudodir(struct fs_dirent_s *idir)
     {
       /* Increment the reference count on this next node */
 
+      flags = enter_critical_section();
       idir->u.pseudo.fd_next->i_crefs++;
+      leave_critical_section(flags);
     }
 
-  inode_semgive();
+  inode_rdunlock();
 
   if (prev)
     {
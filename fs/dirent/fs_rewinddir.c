@@ -27,6 +27,7 @@
 #include <dirent.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 
@@ -43,9 +44,10 @@
 static inline void rewindpseudodir(struct fs_dirent_s *idir)
 {
   struct inode *prev;
+  irqstate_t flags;
   int ret;
 
-  ret = inode_semtake();
+  ret = inode_rdlock();
   if (ret < 0)
     {
       return;
@@ -61,8 +63,10 @@ static inline void rewindpseudodir(struct fs_dirent_s *idir)
    * should now have two references on the inode.
    */
 
+  flags = enter_critical_section();
   idir->fd_root->i_crefs++;
-  inode_semgive();
+  leave_critical_section(flags);
+  inode_rdunlock();
 
   /* Then release the reference to the old next inode */
 
@@ -29,6 +29,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 
@@ -46,6 +47,7 @@ static inline void seekpseudodir(struct fs_dirent_s *idir, off_t offset)
 {
   struct inode *curr;
   struct inode *prev;
+  irqstate_t flags;
   off_t pos;
   int ret;
 
@@ -72,10 +74,10 @@ static inline void seekpseudodir(struct fs_dirent_s *idir, off_t offset)
    * be a very unpredictable operation.
    */
 
-  ret = inode_semtake();
+  ret = inode_rdlock();
   if (ret < 0)
     {
-      ferr("ERROR:  inode_semtake failed: %d\n", ret);
+      ferr("ERROR:  inode_rdlock failed: %d\n", ret);
       return;
     }
 
@@ -91,10 +93,12 @@ static inline void seekpseudodir(struct fs_dirent_s *idir, off_t offset)
     {
       /* Increment the reference count on this next node */
 
+      flags = enter_critical_section();
       curr->i_crefs++;
+      leave_critical_section(flags);
     }
 
-  inode_semgive();
+  inode_rdunlock();
 
   if (prev)
     {
@@ -0,0 +1,109 @@
+/****************************************************************************
+ * fs/driver/fs_blocksubmit.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_BLOCK_REQUEST
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: block_submit
+ *
+ * Description:
+ *   Queue a block transfer on the block driver.  If the driver provides a
+ *   submit() method, this returns as soon as the request is queued and
+ *   req->br_complete() is called later from the driver's context.
+ *   Otherwise, the transfer is performed synchronously with the read() or
+ *   write() method and req->br_complete() is called before returning.
+ *
+ * Input Parameters:
+ *   inode - The inode of the block driver
+ *   req   - The request to perform
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was accepted; req->br_complete() will be (or
+ *   has been) called.  A negated errno value is returned if the request
+ *   was rejected; req->br_complete() will not be called in that case.
+ *
+ ****************************************************************************/
+
+int block_submit(FAR struct inode *inode, FAR struct blk_request_s *req)
+{
+  FAR const struct block_operations *bops;
+
+  DEBUGASSERT(req != NULL && req->br_complete != NULL);
+
+  if (inode == NULL || !INODE_IS_BLOCK(inode) || inode->u.i_bops == NULL)
+    {
+      return -ENOTBLK;
+    }
+
+  if (req->br_op != BLKREQ_READ && req->br_op != BLKREQ_WRITE)
+    {
+      return -EINVAL;
+    }
+
+  bops = inode->u.i_bops;
+  if (bops->submit != NULL)
+    {
+      return bops->submit(inode, req);
+    }
+
+  /* No native request queue.  Perform the transfer now. */
+
+  if (req->br_op == BLKREQ_READ)
+    {
+      if (bops->read == NULL)
+        {
+          return -EACCES;
+        }
+
+      req->br_result = bops->read(inode, req->br_buffer, req->br_sector,
+                                  req->br_nsectors);
+    }
+  else
+    {
+      if (bops->write == NULL)
+        {
+          return -EACCES;
+        }
+
+      req->br_result = bops->write(inode, req->br_buffer, req->br_sector,
+                                   req->br_nsectors);
+    }
+
+  req->br_complete(req);
+  return OK;
+}
+
+#endif /* CONFIG_FS_BLOCK_REQUEST */
@@ -249,6 +249,9 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
         {
           /* Truncate the file to zero length */
 
+#if CONFIG_FAT_EXTENTS > 0
+          fat_extentreset(fs, fs->fs_currentsector, dirinfo.dir.fd_index);
+#endif
           ret = fat_dirtruncate(fs, direntry);
           if (ret < 0)
             {
@@ -1027,6 +1030,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   int32_t cluster;
   off_t position;
   unsigned int clustersize;
+#if CONFIG_FAT_EXTENTS > 0
+  uint32_t index;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1157,6 +1163,17 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#if CONFIG_FAT_EXTENTS > 0
+      /* Skip directly to the closest cluster already known from an
+       * earlier walk of the chain.
+       */
+
+      index         = fat_extentfind(ff, position / clustersize, &cluster);
+      filep->f_pos += (off_t)index * clustersize;
+      position     -= (off_t)index * clustersize;
+
+#endif
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1164,6 +1181,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
            */
 
           ff->ff_currentcluster = cluster;
+#if CONFIG_FAT_EXTENTS > 0
+          fat_extentadd(ff, index, cluster);
+#endif
           if (position < clustersize)
             {
               break;
@@ -1227,6 +1247,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
 
           filep->f_pos += clustersize;
           position     -= clustersize;
+#if CONFIG_FAT_EXTENTS > 0
+          index++;
+#endif
         }
 
       /* We get here after we have found the sector containing
@@ -1547,6 +1570,9 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#if CONFIG_FAT_EXTENTS > 0
+  newff->ff_nextents         = 0;                          /* Cluster extent map */
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1835,6 +1861,12 @@ static int fat_truncate(FAR struct file *filep, off_t length)
       ndx      = (ff->ff_dirindex & DIRSEC_NDXMASK(fs)) * DIR_SIZE;
       direntry = &fs->fs_buffer[ndx];
 
+#if CONFIG_FAT_EXTENTS > 0
+      /* Part of the cluster chain is going away */
+
+      fat_extentreset(fs, ff->ff_dirsector, ff->ff_dirindex);
+
+#endif
       /* Handle the simple case where we are shrinking the file to zero
        * length.
        */
@@ -2163,7 +2195,13 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
    */
 
   fs->fs_blkdriver = blkdriver;   /* Save the block driver reference */
-  nxsem_init(&fs->fs_sem, 0, 0);  /* Initialize the semaphore that controls access */
+
+  /* Initialize the mutex that controls access and hold it until the
+   * volume is mounted.
+   */
+
+  nxmutex_init(&fs->fs_lock);
+  fat_semtake(fs);
 
   /* Then get information about the FAT32 filesystem on the devices managed
    * by this block driver.
@@ -2172,7 +2210,8 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
   ret = fat_mount(fs, true);
   if (ret != 0)
     {
-      nxsem_destroy(&fs->fs_sem);
+      fat_semgive(fs);
+      nxmutex_destroy(&fs->fs_lock);
       kmm_free(fs);
       return ret;
     }
@@ -2243,6 +2282,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+  /* Write back anything still held in the sector cache */
+
+  fat_fscachesync(fs);
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2275,7 +2318,15 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
-  nxsem_destroy(&fs->fs_sem);
+#if CONFIG_FAT_SECTORCACHE > 0
+  if (fs->fs_cachebuf)
+    {
+      fat_io_free(fs->fs_cachebuf,
+                  CONFIG_FAT_SECTORCACHE * fs->fs_hwsectorsize);
+    }
+#endif
+
+  nxmutex_destroy(&fs->fs_lock);
   kmm_free(fs);
   return OK;
 }
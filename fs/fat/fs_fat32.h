@@ -34,12 +34,22 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/dirent.h>
-#include <nuttx/semaphore.h>
+#include <nuttx/mutex.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FAT_SECTORCACHE
+#  define CONFIG_FAT_SECTORCACHE 0
+#endif
+
+#ifndef CONFIG_FAT_EXTENTS
+#  define CONFIG_FAT_EXTENTS 0
+#endif
+
 /****************************************************************************
  * These offsets describes the master boot record (MBR).
  *
@@ -857,13 +867,28 @@
  * is mounted with a fat32 filesystem.
  */
 
+#if CONFIG_FAT_SECTORCACHE > 0
+/* This structure describes one entry in the mountpoint sector cache.  The
+ * entries are retained in the fs_cache[] array in least-recently-used
+ * order:  fs_cache[0] is the most recently used sector.
+ */
+
+struct fat_sectcache_s
+{
+  off_t    sc_sector;              /* The sector number buffered in sc_buffer */
+  bool     sc_valid;               /* true: sc_buffer holds sc_sector */
+  bool     sc_dirty;               /* true: sc_buffer must be written back */
+  uint8_t *sc_buffer;              /* One sector in fs_cachebuf */
+};
+#endif
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
   struct inode      *fs_blkdriver; /* The block driver inode that hosts the FAT32 fs */
   struct fat_file_s *fs_head;      /* A list to all files opened on this mountpoint */
 
-  sem_t    fs_sem;                 /* Used to assume thread-safe access */
+  mutex_t  fs_lock;                /* Used to assume thread-safe access */
   off_t    fs_hwsectorsize;        /* HW: Sector size reported by block driver */
   off_t    fs_hwnsectors;          /* HW: The number of sectors reported by the hardware */
   off_t    fs_fatbase;             /* Logical block of start of filesystem (past resd sectors) */
@@ -886,8 +911,26 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#if CONFIG_FAT_SECTORCACHE > 0
+  uint8_t *fs_cachebuf;            /* Allocated sector storage for fs_cache[] */
+  struct fat_sectcache_s fs_cache[CONFIG_FAT_SECTORCACHE];
+#endif
 };
 
+#if CONFIG_FAT_EXTENTS > 0
+/* This structure describes one run of contiguous clusters in the cluster
+ * chain of an open file.  fe_index is the position of fe_cluster in the
+ * chain, counting in clusters from the start of the file.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* First cluster of the run */
+  uint32_t fe_count;               /* Number of contiguous clusters */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -907,6 +950,10 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_EXTENTS > 0
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents[] */
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1069,6 +1116,17 @@ EXTERN int    fat_freedirentry(struct fat_mountpt_s *fs,
 EXTERN int    fat_dirname2path(struct fat_mountpt_s *fs,
                                struct fs_dirent_s *dir);
 
+/* Cluster extent map */
+
+#if CONFIG_FAT_EXTENTS > 0
+EXTERN uint32_t fat_extentfind(FAR struct fat_file_s *ff, uint32_t index,
+                               FAR int32_t *cluster);
+EXTERN void   fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                            uint32_t cluster);
+EXTERN void   fat_extentreset(FAR struct fat_mountpt_s *fs, off_t dirsector,
+                              uint16_t dirindex);
+#endif
+
 /* File creation and removal helpers */
 
 EXTERN int    fat_dirtruncate(struct fat_mountpt_s *fs,
@@ -1086,6 +1144,7 @@ EXTERN int    fat_remove(struct fat_mountpt_s *fs, const char *relpath,
 
 EXTERN int    fat_fscacheflush(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(struct fat_mountpt_s *fs, off_t sector);
+EXTERN int    fat_fscachesync(struct fat_mountpt_s *fs);
 EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs,
                                struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs,
@@ -35,16 +35,343 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched_span.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+SCHED_SPAN_DEFINE(fat_hwread);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_devread
+ *
+ * Description:
+ *   Read sectors directly from the block driver, bypassing the sector
+ *   cache.
+ *
+ ****************************************************************************/
+
+static int fat_devread(struct fat_mountpt_s *fs, uint8_t *buffer,
+                       off_t sector, unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->read)
+        {
+          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
+                                                       sector, nsectors);
+          if (nsectorsread == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nsectorsread < 0)
+            {
+              ret = nsectorsread;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_devwrite
+ *
+ * Description:
+ *   Write sectors directly to the block driver, bypassing the sector
+ *   cache.
+ *
+ ****************************************************************************/
+
+static int fat_devwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
+                        off_t sector, unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->write)
+        {
+          ssize_t nsectorswritten =
+              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+
+          if (nsectorswritten == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nsectorswritten < 0)
+            {
+              ret = nsectorswritten;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_writesector
+ *
+ * Description:
+ *   Write one buffered FAT, directory, or FSINFO sector to the media.  If
+ *   the sector lies in the FAT region, the change is also made in each
+ *   FAT copy.
+ *
+ ****************************************************************************/
+
+static int fat_writesector(struct fat_mountpt_s *fs, uint8_t *buffer,
+                           off_t sector)
+{
+  int ret;
+
+  /* Write the dirty sector */
+
+  ret = fat_devwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      int i;
+
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_devwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+#if CONFIG_FAT_SECTORCACHE > 0
+/****************************************************************************
+ * Name: fat_cachefind
+ *
+ * Description:
+ *   Return the index of the sector cache entry holding 'sector' or -1 if
+ *   the sector is not cached.
+ *
+ ****************************************************************************/
+
+static int fat_cachefind(struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      if (fs->fs_cache[i].sc_valid && fs->fs_cache[i].sc_sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: fat_cachetouch
+ *
+ * Description:
+ *   Make the sector cache entry at 'ndx' the most recently used entry.
+ *
+ ****************************************************************************/
+
+static void fat_cachetouch(struct fat_mountpt_s *fs, int ndx)
+{
+  struct fat_sectcache_s tmp;
+
+  if (ndx > 0)
+    {
+      tmp = fs->fs_cache[ndx];
+      memmove(&fs->fs_cache[1], &fs->fs_cache[0],
+              ndx * sizeof(struct fat_sectcache_s));
+      fs->fs_cache[0] = tmp;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cacheinvalidate
+ *
+ * Description:
+ *   Discard any cached copy of the sectors in the range.  This is called
+ *   when the sectors are being overwritten on the media by some other
+ *   path, so any cached contents (dirty or not) are stale.
+ *
+ ****************************************************************************/
+
+static void fat_cacheinvalidate(struct fat_mountpt_s *fs, off_t sector,
+                                unsigned int nsectors)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      FAR struct fat_sectcache_s *sc = &fs->fs_cache[i];
+
+      if (sc->sc_valid && sc->sc_sector >= sector &&
+          sc->sc_sector < sector + nsectors)
+        {
+          sc->sc_valid = false;
+          sc->sc_dirty = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cachewriteback
+ *
+ * Description:
+ *   Write back any dirty cached sectors in the range so that the media is
+ *   up to date before it is read by some other path.
+ *
+ ****************************************************************************/
+
+static int fat_cachewriteback(struct fat_mountpt_s *fs, off_t sector,
+                              unsigned int nsectors)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      FAR struct fat_sectcache_s *sc = &fs->fs_cache[i];
+
+      if (sc->sc_valid && sc->sc_dirty && sc->sc_sector >= sector &&
+          sc->sc_sector < sector + nsectors)
+        {
+          ret = fat_writesector(fs, sc->sc_buffer, sc->sc_sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          sc->sc_dirty = false;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachespill
+ *
+ * Description:
+ *   Move the sector currently held in fs_buffer into the sector cache,
+ *   evicting the least recently used entry if necessary.  On return,
+ *   fs_buffer may be reused for a different sector.
+ *
+ ****************************************************************************/
+
+static int fat_cachespill(struct fat_mountpt_s *fs)
+{
+  FAR struct fat_sectcache_s *sc;
+  int ndx;
+  int ret;
+
+  /* fs_buffer is always at least as recent as any copy in the cache */
+
+  fat_cacheinvalidate(fs, fs->fs_currentsector, 1);
+
+  /* Use a free entry if there is one, otherwise the least recently used */
+
+  for (ndx = CONFIG_FAT_SECTORCACHE - 1; ndx > 0; ndx--)
+    {
+      if (!fs->fs_cache[ndx].sc_valid)
+        {
+          break;
+        }
+    }
+
+  if (ndx == 0 && fs->fs_cache[0].sc_valid)
+    {
+      ndx = CONFIG_FAT_SECTORCACHE - 1;
+    }
+
+  sc = &fs->fs_cache[ndx];
+  if (sc->sc_valid && sc->sc_dirty)
+    {
+      ret = fat_writesector(fs, sc->sc_buffer, sc->sc_sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memcpy(sc->sc_buffer, fs->fs_buffer, fs->fs_hwsectorsize);
+  sc->sc_sector = fs->fs_currentsector;
+  sc->sc_valid  = true;
+  sc->sc_dirty  = fs->fs_dirty;
+  fs->fs_dirty  = false;
+
+  fat_cachetouch(fs, ndx);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cacheswap
+ *
+ * Description:
+ *   Exchange the sector held in fs_buffer with the cached sector at 'ndx'.
+ *   The old fs_buffer sector becomes the most recently used cache entry.
+ *
+ ****************************************************************************/
+
+static void fat_cacheswap(struct fat_mountpt_s *fs, int ndx)
+{
+  FAR struct fat_sectcache_s *sc = &fs->fs_cache[ndx];
+  FAR uint8_t *src = sc->sc_buffer;
+  FAR uint8_t *dest = fs->fs_buffer;
+  off_t sector;
+  off_t i;
+  bool dirty;
+
+  /* Drop any stale duplicate of the fs_buffer sector */
+
+  fat_cacheinvalidate(fs, fs->fs_currentsector, 1);
+
+  for (i = 0; i < fs->fs_hwsectorsize; i++)
+    {
+      uint8_t tmp = dest[i];
+
+      dest[i]     = src[i];
+      src[i]      = tmp;
+    }
+
+  sector               = sc->sc_sector;
+  dirty                = sc->sc_dirty;
+  sc->sc_sector        = fs->fs_currentsector;
+  sc->sc_dirty         = fs->fs_dirty;
+  fs->fs_currentsector = sector;
+  fs->fs_dirty         = dirty;
+
+  fat_cachetouch(fs, ndx);
+}
+#endif /* CONFIG_FAT_SECTORCACHE > 0 */
+
 /****************************************************************************
  * Name: fat_checkfsinfo
  *
@@ -347,7 +674,7 @@ void fat_putuint32(FAR uint8_t *ptr, uint32_t value32)
 
 int fat_semtake(struct fat_mountpt_s *fs)
 {
-  return nxsem_wait_uninterruptible(&fs->fs_sem);
+  return nxmutex_lock(&fs->fs_lock);
 }
 
 /****************************************************************************
@@ -356,7 +683,7 @@ int fat_semtake(struct fat_mountpt_s *fs)
 
 void fat_semgive(struct fat_mountpt_s *fs)
 {
-  nxsem_post(&fs->fs_sem);
+  nxmutex_unlock(&fs->fs_lock);
 }
 
 /****************************************************************************
@@ -486,6 +813,7 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   FAR struct inode *inode;
   struct geometry geo;
   int ret;
+  int i;
 
   /* Assume that the mount is successful */
 
@@ -525,6 +853,26 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#if CONFIG_FAT_SECTORCACHE > 0
+  /* Allocate the sector cache */
+
+  fs->fs_cachebuf = (FAR uint8_t *)
+    fat_io_alloc(CONFIG_FAT_SECTORCACHE * fs->fs_hwsectorsize);
+  if (!fs->fs_cachebuf)
+    {
+      ret = -ENOMEM;
+      goto errout_with_buffer;
+    }
+
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      fs->fs_cache[i].sc_valid  = false;
+      fs->fs_cache[i].sc_dirty  = false;
+      fs->fs_cache[i].sc_buffer = fs->fs_cachebuf +
+                                  i * fs->fs_hwsectorsize;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -553,7 +901,6 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
        * partition number.
        */
 
-      int i;
       for (i = 0; i < 4; i++)
         {
           /* Check if the partition exists and, if so, get the bootsector for
@@ -618,6 +965,10 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
         }
     }
 
+  /* fs_buffer now holds the boot record sector */
+
+  fs->fs_currentsector = fs->fs_fatbase - fs->fs_fatresvdseccount;
+
   /* We have what appears to be a valid FAT filesystem! Now read the
    * FSINFO sector (FAT32 only)
    */
@@ -653,6 +1004,15 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#if CONFIG_FAT_SECTORCACHE > 0
+  if (fs->fs_cachebuf)
+    {
+      fat_io_free(fs->fs_cachebuf,
+                  CONFIG_FAT_SECTORCACHE * fs->fs_hwsectorsize);
+      fs->fs_cachebuf = NULL;
+    }
+
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
 
@@ -717,25 +1077,22 @@ int fat_checkmount(struct fat_mountpt_s *fs)
 int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
 {
-  int ret = -ENODEV;
-  if (fs && fs->fs_blkdriver)
+  uint32_t span;
+  int ret;
+
+  span = SCHED_SPAN_BEGIN(fat_hwread);
+
+#if CONFIG_FAT_SECTORCACHE > 0
+  /* Make sure that the media holds the latest content of the sectors */
+
+  ret = fat_cachewriteback(fs, sector, nsectors);
+  if (ret >= 0)
+#endif
     {
-      struct inode *inode = fs->fs_blkdriver;
-      if (inode && inode->u.i_bops && inode->u.i_bops->read)
-        {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
-          if (nsectorsread == nsectors)
-            {
-              ret = OK;
-            }
-          else if (nsectorsread < 0)
-            {
-              ret = nsectorsread;
-            }
-        }
+      ret = fat_devread(fs, buffer, sector, nsectors);
     }
 
+  SCHED_SPAN_END(fat_hwread, span);
   return ret;
 }
 
@@ -750,27 +1107,13 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
 int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
                 unsigned int nsectors)
 {
-  int ret = -ENODEV;
-  if (fs && fs->fs_blkdriver)
-    {
-      struct inode *inode = fs->fs_blkdriver;
-      if (inode && inode->u.i_bops && inode->u.i_bops->write)
-        {
-          ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+#if CONFIG_FAT_SECTORCACHE > 0
+  /* Any cached copies of these sectors are about to become stale */
 
-          if (nsectorswritten == nsectors)
-            {
-              ret = OK;
-            }
-          else if (nsectorswritten < 0)
-            {
-              ret = nsectorswritten;
-            }
-        }
-    }
+  fat_cacheinvalidate(fs, sector, nsectors);
+#endif
 
-  return ret;
+  return fat_devwrite(fs, buffer, sector, nsectors);
 }
 
 /****************************************************************************
@@ -1411,6 +1754,117 @@ int fat_nextdirentry(struct fat_mountpt_s *fs, struct fs_fatdir_s *dir)
   return OK;
 }
 
+#if CONFIG_FAT_EXTENTS > 0
+/****************************************************************************
+ * Name: fat_extentfind
+ *
+ * Description:
+ *   Find the closest known cluster at or before cluster 'index' of the
+ *   file.  On return, *cluster holds that cluster and the return value is
+ *   its index.  If nothing is known, *cluster is not modified and zero is
+ *   returned (i.e., start from the first cluster).
+ *
+ ****************************************************************************/
+
+uint32_t fat_extentfind(FAR struct fat_file_s *ff, uint32_t index,
+                        FAR int32_t *cluster)
+{
+  FAR struct fat_extent_s *fe;
+  int i;
+
+  if (ff->ff_nextents == 0)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < ff->ff_nextents; i++)
+    {
+      fe = &ff->ff_extents[i];
+      if (index < fe->fe_index + fe->fe_count)
+        {
+          *cluster = fe->fe_cluster + (index - fe->fe_index);
+          return index;
+        }
+    }
+
+  /* Beyond the end of the map.  Return the last known cluster */
+
+  fe       = &ff->ff_extents[ff->ff_nextents - 1];
+  *cluster = fe->fe_cluster + fe->fe_count - 1;
+  return fe->fe_index + fe->fe_count - 1;
+}
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that 'cluster' is the cluster at 'index' in the file's cluster
+ *   chain.  Only clusters that directly follow the mapped part of the chain
+ *   are recorded; the map always describes a prefix of the chain.
+ *
+ ****************************************************************************/
+
+void fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                   uint32_t cluster)
+{
+  FAR struct fat_extent_s *fe;
+  uint32_t next;
+
+  if (ff->ff_nextents == 0)
+    {
+      next = 0;
+    }
+  else
+    {
+      fe   = &ff->ff_extents[ff->ff_nextents - 1];
+      next = fe->fe_index + fe->fe_count;
+
+      /* Extend the last run if this cluster is contiguous with it */
+
+      if (index == next && cluster == fe->fe_cluster + fe->fe_count)
+        {
+          fe->fe_count++;
+          return;
+        }
+    }
+
+  /* Otherwise start a new run, if there is space for it */
+
+  if (index == next && ff->ff_nextents < CONFIG_FAT_EXTENTS)
+    {
+      fe             = &ff->ff_extents[ff->ff_nextents];
+      fe->fe_index   = index;
+      fe->fe_cluster = cluster;
+      fe->fe_count   = 1;
+      ff->ff_nextents++;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_extentreset
+ *
+ * Description:
+ *   Discard the extent maps of every open file that refers to the
+ *   directory entry at 'dirsector'/'dirindex'.  This must be called when
+ *   the cluster chain of the file is released or shortened.
+ *
+ ****************************************************************************/
+
+void fat_extentreset(FAR struct fat_mountpt_s *fs, off_t dirsector,
+                     uint16_t dirindex)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff; ff = ff->ff_next)
+    {
+      if (ff->ff_dirsector == dirsector && ff->ff_dirindex == dirindex)
+        {
+          ff->ff_nextents = 0;
+        }
+    }
+}
+#endif /* CONFIG_FAT_EXTENTS > 0 */
+
 /****************************************************************************
  * Name: fat_dirtruncate
  *
@@ -1767,32 +2221,18 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
   if (fs->fs_dirty)
     {
-      /* Write the dirty sector */
+#if CONFIG_FAT_SECTORCACHE > 0
+      /* Any cached copy of this sector is superseded by fs_buffer */
 
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-      if (ret < 0)
-        {
-          return ret;
-        }
+      fat_cacheinvalidate(fs, fs->fs_currentsector, 1);
+#endif
 
-      /* Does the sector lie in the FAT region? */
+      /* Write the dirty sector (and its FAT copies) */
 
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
+      ret = fat_writesector(fs, fs->fs_buffer, fs->fs_currentsector);
+      if (ret < 0)
         {
-          int i;
-
-          /* Yes, then make the change in the FAT copy as well */
-
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
-            {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-            }
+          return ret;
         }
 
       /* No longer dirty */
@@ -1823,11 +2263,29 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
   if (fs->fs_currentsector != sector)
     {
+#if CONFIG_FAT_SECTORCACHE > 0
+      /* Check if the new sector is already in the sector cache */
+
+      int ndx = fat_cachefind(fs, sector);
+      if (ndx >= 0)
+        {
+          fat_cacheswap(fs, ndx);
+          return OK;
+        }
+
+      /* We will need to read the new sector.  First, move the current
+       * sector into the cache.  It will be written back later if it is
+       * dirty.
+       */
+
+      ret = fat_cachespill(fs);
+#else
       /* We will need to read the new sector.  First, flush the cached
        * sector if it is dirty.
        */
 
       ret = fat_fscacheflush(fs);
+#endif
       if (ret < 0)
         {
           return ret;
@@ -1849,6 +2307,49 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscachesync
+ *
+ * Description:
+ *   Write back fs_buffer and every dirty sector in the sector cache so that
+ *   the media is fully up to date.
+ *
+ ****************************************************************************/
+
+int fat_fscachesync(struct fat_mountpt_s *fs)
+{
+  int ret;
+#if CONFIG_FAT_SECTORCACHE > 0
+  int i;
+#endif
+
+  ret = fat_fscacheflush(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#if CONFIG_FAT_SECTORCACHE > 0
+  for (i = 0; i < CONFIG_FAT_SECTORCACHE; i++)
+    {
+      FAR struct fat_sectcache_s *sc = &fs->fs_cache[i];
+
+      if (sc->sc_valid && sc->sc_dirty)
+        {
+          ret = fat_writesector(fs, sc->sc_buffer, sc->sc_sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          sc->sc_dirty = false;
+        }
+    }
+#endif
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: fat_ffcacheflush
  *
@@ -1979,9 +2480,9 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 {
   int ret;
 
-  /* Flush the fs_buffer if it is dirty */
+  /* Flush the fs_buffer and the sector cache if they are dirty */
 
-  ret = fat_fscacheflush(fs);
+  ret = fat_fscachesync(fs);
   if (ret == OK)
     {
       /* The FSINFO sector only has to be update for the case of a FAT32 file
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <nuttx/kmalloc.h>
@@ -39,10 +40,31 @@
  * Private Types
  ****************************************************************************/
 
+/* Directory handle returned by host_opendir(): the server's handle plus
+ * the records of the last READDIR reply not yet returned.
+ */
+
+struct hostfs_rpmsg_dir_s
+{
+  int32_t               fd;
+  uint32_t              pos;
+  uint32_t              len;
+  FAR char              *path;
+  char                  buf[CONFIG_FS_HOSTFS_RPMSG_DIRBUF];
+};
+
 struct hostfs_rpmsg_s
 {
   struct rpmsg_endpoint ept;
   FAR const char        *cpuname;
+#ifdef CONFIG_FS_HOSTFS_RPMSG_DIRSTAT
+  sem_t                 statsem;
+
+  /* The last entry returned by host_readdir(), whose stat came with it */
+
+  FAR struct hostfs_rpmsg_dir_s    *statdir;
+  FAR struct hostfs_rpmsg_dirent_s *statent;
+#endif
 };
 
 struct hostfs_rpmsg_cookie_s
@@ -116,6 +138,106 @@ static const rpmsg_ept_cb g_hostfs_rpmsg_handler[] =
  * Private Functions
  ****************************************************************************/
 
+static void hostfs_rpmsg_copy_stat(FAR struct stat *buf,
+                                   FAR const struct stat *rsp)
+{
+  buf->st_dev     = rsp->st_dev;
+  buf->st_ino     = rsp->st_ino;
+  buf->st_mode    = rsp->st_mode;
+  buf->st_nlink   = rsp->st_nlink;
+  buf->st_uid     = rsp->st_uid;
+  buf->st_gid     = rsp->st_gid;
+  buf->st_rdev    = rsp->st_rdev;
+  buf->st_size    = B2C(rsp->st_size);
+  buf->st_atime   = rsp->st_atime;
+  buf->st_mtime   = rsp->st_mtime;
+  buf->st_ctime   = rsp->st_ctime;
+  buf->st_blksize = B2C(rsp->st_blksize);
+  buf->st_blocks  = rsp->st_blocks;
+}
+
+#ifdef CONFIG_FS_HOSTFS_RPMSG_DIRSTAT
+static void hostfs_rpmsg_stat_drop(FAR struct hostfs_rpmsg_dir_s *dir)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+
+  nxsem_wait_uninterruptible(&priv->statsem);
+  if (dir == NULL || priv->statdir == dir)
+    {
+      priv->statdir = NULL;
+    }
+
+  nxsem_post(&priv->statsem);
+}
+
+static void hostfs_rpmsg_stat_save(FAR struct hostfs_rpmsg_dir_s *dir,
+                                   FAR struct hostfs_rpmsg_dirent_s *ent)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+
+  nxsem_wait_uninterruptible(&priv->statsem);
+  priv->statdir = ent->statret == 0 ? dir : NULL;
+  priv->statent = ent;
+  nxsem_post(&priv->statsem);
+}
+
+/* Answer stat() of the entry host_readdir() just returned from the stat
+ * that came along with it.  The entry is used at most once.
+ */
+
+static int hostfs_rpmsg_stat_lookup(FAR const char *path,
+                                    FAR struct stat *buf)
+{
+  FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  FAR struct hostfs_rpmsg_dirent_s *ent;
+  FAR struct hostfs_rpmsg_dir_s *dir;
+  char name[NAME_MAX + 1];
+  struct stat tmp;
+  size_t len;
+  int ret = -ENOENT;
+
+  nxsem_wait_uninterruptible(&priv->statsem);
+
+  dir = priv->statdir;
+  ent = priv->statent;
+  if (dir == NULL)
+    {
+      goto out;
+    }
+
+  len = strlen(dir->path);
+  if (strncmp(path, dir->path, len) != 0)
+    {
+      goto out;
+    }
+
+  path += len;
+  if (len == 0 || dir->path[len - 1] != '/')
+    {
+      if (*path++ != '/')
+        {
+          goto out;
+        }
+    }
+
+  nbstr2cstr(name, (FAR char *)ent + B2C(ent->namepos), NAME_MAX);
+  name[NAME_MAX] = '\0';
+  if (strcmp(path, name) == 0)
+    {
+      tmp = ent->buf;
+      hostfs_rpmsg_copy_stat(buf, &tmp);
+      priv->statdir = NULL;
+      ret = 0;
+    }
+
+out:
+  nxsem_post(&priv->statsem);
+  return ret;
+}
+#else
+#  define hostfs_rpmsg_stat_drop(d)
+#endif
+
 static int hostfs_rpmsg_default_handler(FAR struct rpmsg_endpoint *ept,
                                         FAR void *data, size_t len,
                                         uint32_t src, FAR void *priv)
@@ -144,13 +266,26 @@ static int hostfs_rpmsg_read_handler(FAR struct rpmsg_endpoint *ept,
       (struct hostfs_rpmsg_cookie_s *)(uintptr_t)header->cookie;
   FAR struct hostfs_rpmsg_read_s *rsp = data;
 
-  cookie->result = header->result;
-  if (cookie->result > 0)
+  /* One of possibly many replies: append it to what we already have */
+
+  if (header->result < 0)
+    {
+      if (cookie->result == 0)
+        {
+          cookie->result = header->result;
+        }
+    }
+  else if (header->result > 0)
     {
-      memcpy(cookie->data, rsp->buf, B2C(cookie->result));
+      memcpy(cookie->data, rsp->buf, B2C(header->result));
+      cookie->data    = (FAR char *)cookie->data + B2C(header->result);
+      cookie->result += B2C(header->result);
     }
 
-  nxsem_post(&cookie->sem);
+  if (header->result < 0 || rsp->count == 0)
+    {
+      nxsem_post(&cookie->sem);
+    }
 
   return 0;
 }
@@ -163,14 +298,14 @@ static int hostfs_rpmsg_readdir_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct hostfs_rpmsg_cookie_s *cookie =
       (struct hostfs_rpmsg_cookie_s *)(uintptr_t)header->cookie;
   FAR struct hostfs_rpmsg_readdir_s *rsp = data;
-  FAR struct dirent *entry = cookie->data;
+  FAR struct hostfs_rpmsg_dir_s *dir = cookie->data;
 
   cookie->result = header->result;
-  if (cookie->result >= 0)
+  if (cookie->result > 0)
     {
-      nbstr2cstr(entry->d_name, rsp->name, NAME_MAX);
-      entry->d_name[NAME_MAX] = '\0';
-      entry->d_type = rsp->type;
+      memcpy(dir->buf, rsp->buf, B2C(rsp->count));
+      dir->pos = 0;
+      dir->len = B2C(rsp->count);
     }
 
   nxsem_post(&cookie->sem);
@@ -215,23 +350,13 @@ static int hostfs_rpmsg_stat_handler(FAR struct rpmsg_endpoint *ept,
       (struct hostfs_rpmsg_cookie_s *)(uintptr_t)header->cookie;
   FAR struct hostfs_rpmsg_stat_s *rsp = data;
   FAR struct stat *buf = cookie->data;
+  struct stat tmp;
 
   cookie->result = header->result;
   if (cookie->result >= 0)
     {
-      buf->st_dev     = rsp->buf.st_dev;
-      buf->st_ino     = rsp->buf.st_ino;
-      buf->st_mode    = rsp->buf.st_mode;
-      buf->st_nlink   = rsp->buf.st_nlink;
-      buf->st_uid     = rsp->buf.st_uid;
-      buf->st_gid     = rsp->buf.st_gid;
-      buf->st_rdev    = rsp->buf.st_rdev;
-      buf->st_size    = B2C(rsp->buf.st_size);
-      buf->st_atime   = rsp->buf.st_atime;
-      buf->st_mtime   = rsp->buf.st_mtime;
-      buf->st_ctime   = rsp->buf.st_ctime;
-      buf->st_blksize = B2C(rsp->buf.st_blksize);
-      buf->st_blocks  = rsp->buf.st_blocks;
+      tmp = rsp->buf;
+      hostfs_rpmsg_copy_stat(buf, &tmp);
     }
 
   nxsem_post(&cookie->sem);
@@ -355,6 +480,8 @@ int host_open(FAR const char *pathname, int flags, int mode)
   msg->mode  = mode;
   cstr2bstr(msg->pathname, pathname);
 
+  hostfs_rpmsg_stat_drop(NULL);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_OPEN, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
 }
@@ -372,68 +499,127 @@ int host_close(int fd)
 
 ssize_t host_read(int fd, FAR void *buf, size_t count)
 {
-  size_t read = 0;
-  int ret = 0;
-
-  while (read < count)
-    {
-      struct hostfs_rpmsg_read_s msg =
-      {
-        .fd    = fd,
-        .count = C2B(count - read),
-      };
-
-      ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_READ, true,
-              (FAR struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), buf);
-      if (ret <= 0)
-        {
-          break;
-        }
+  struct hostfs_rpmsg_read_s msg =
+  {
+    .fd    = fd,
+    .count = C2B(count),
+  };
 
-      read += B2C(ret);
-      buf  += B2C(ret);
-    }
+  /* The server streams the whole request back, so this costs one round
+   * trip however many rpmsg buffers it takes.
+   */
 
-  return read ? read : ret;
+  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_READ, true,
+          (FAR struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), buf);
 }
 
 ssize_t host_write(int fd, FAR const void *buf, size_t count)
 {
   FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
+  struct hostfs_rpmsg_cookie_s cookies[CONFIG_FS_HOSTFS_RPMSG_NWRITES];
+  uint32_t chunks[CONFIG_FS_HOSTFS_RPMSG_NWRITES];
+  FAR struct hostfs_rpmsg_cookie_s *cookie;
+  unsigned int head = 0;
+  unsigned int tail = 0;
   size_t written = 0;
+  size_t queued = 0;
+  bool stop = false;
   int ret = 0;
+  int i;
 
-  while (written < count)
+  hostfs_rpmsg_stat_drop(NULL);
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_RPMSG_NWRITES; i++)
     {
-      FAR struct hostfs_rpmsg_write_s *msg;
-      uint32_t space;
+      nxsem_init(&cookies[i].sem, 0, 0);
+      nxsem_set_protocol(&cookies[i].sem, SEM_PRIO_NONE);
+    }
 
-      msg = rpmsg_get_tx_payload_buffer(&priv->ept, &space, true);
-      if (!msg)
-        {
-          ret = -ENOMEM;
-          break;
-        }
+  /* Keep up to CONFIG_FS_HOSTFS_RPMSG_NWRITES chunks in flight.  The server
+   * handles them in order, so only the replies need to be matched up.
+   */
 
-      space -= sizeof(*msg);
-      if (space > count - written)
+  while (head != tail || (!stop && queued < count))
+    {
+      if (!stop && queued < count &&
+          head - tail < CONFIG_FS_HOSTFS_RPMSG_NWRITES)
         {
-          space = count - written;
+          FAR struct hostfs_rpmsg_write_s *msg;
+          uint32_t space;
+
+          msg = rpmsg_get_tx_payload_buffer(&priv->ept, &space, true);
+          if (!msg)
+            {
+              ret  = -ENOMEM;
+              stop = true;
+              continue;
+            }
+
+          space -= sizeof(*msg);
+          if (space > count - queued)
+            {
+              space = count - queued;
+            }
+
+          cookie         = &cookies[head % CONFIG_FS_HOSTFS_RPMSG_NWRITES];
+          cookie->result = 0;
+          cookie->data   = NULL;
+
+          msg->header.command = HOSTFS_RPMSG_WRITE;
+          msg->header.result  = -ENXIO;
+          msg->header.cookie  = (uintptr_t)cookie;
+          msg->fd             = fd;
+          msg->count          = C2B(space);
+          memcpy(msg->buf, (FAR const char *)buf + queued, space);
+
+          i = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg) + space);
+          if (i < 0)
+            {
+              ret  = i;
+              stop = true;
+              continue;
+            }
+
+          chunks[head % CONFIG_FS_HOSTFS_RPMSG_NWRITES] = space;
+          queued += space;
+          head++;
+          continue;
         }
 
-      msg->fd    = fd;
-      msg->count = C2B(space);
-      memcpy(msg->buf, buf + written, space);
+      /* Window full or nothing left to send: reap the oldest reply */
 
-      ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_WRITE, false,
-                                   (FAR struct hostfs_rpmsg_header_s *)msg,
-                                   sizeof(*msg) + space, NULL);
-      if (ret <= 0)
+      cookie = &cookies[tail % CONFIG_FS_HOSTFS_RPMSG_NWRITES];
+      nxsem_wait_uninterruptible(&cookie->sem);
+
+      if (!stop)
         {
-          break;
+          if (cookie->result < 0)
+            {
+              ret  = cookie->result;
+              stop = true;
+            }
+          else
+            {
+              written += B2C(cookie->result);
+
+              /* Data after a short write would land in the wrong place,
+               * so stop there and report what is contiguous.
+               */
+
+              if (B2C(cookie->result) <
+                  chunks[tail % CONFIG_FS_HOSTFS_RPMSG_NWRITES])
+                {
+                  stop = true;
+                }
+            }
         }
 
-      written += B2C(ret);
+      tail++;
+    }
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_RPMSG_NWRITES; i++)
+    {
+      nxsem_destroy(&cookies[i].sem);
     }
 
   return written ? written : ret;
@@ -510,6 +696,8 @@ int host_ftruncate(int fd, off_t length)
     .length = length,
   };
 
+  hostfs_rpmsg_stat_drop(NULL);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_FTRUNCATE, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
 }
@@ -518,16 +706,29 @@ FAR void *host_opendir(FAR const char *name)
 {
   FAR struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
   FAR struct hostfs_rpmsg_opendir_s *msg;
+  FAR struct hostfs_rpmsg_dir_s *dir;
   uint32_t space;
   size_t len;
   int ret;
 
+  dir = kmm_malloc(sizeof(*dir) + strlen(name) + 1);
+  if (!dir)
+    {
+      return NULL;
+    }
+
+  dir->pos  = 0;
+  dir->len  = 0;
+  dir->path = (FAR char *)(dir + 1);
+  strcpy(dir->path, name);
+
   len  = sizeof(*msg);
   len += B2C(strlen(name) + 1);
 
   msg = rpmsg_get_tx_payload_buffer(&priv->ept, &space, true);
   if (!msg)
     {
+      kmm_free(dir);
       return NULL;
     }
 
@@ -537,39 +738,90 @@ FAR void *host_opendir(FAR const char *name)
 
   ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_OPENDIR, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
+  if (ret < 0)
+    {
+      kmm_free(dir);
+      return NULL;
+    }
 
-  return ret < 0 ? NULL : (FAR void *)((uintptr_t)ret);
+  dir->fd = ret;
+  return dir;
 }
 
 int host_readdir(FAR void *dirp, FAR struct dirent *entry)
 {
-  struct hostfs_rpmsg_readdir_s msg =
-  {
-    .fd = (uintptr_t)dirp,
-  };
+  FAR struct hostfs_rpmsg_dir_s *dir = dirp;
+  FAR struct hostfs_rpmsg_dirent_s *ent;
+  int ret;
+
+  /* Fetch the next batch of entries once the last one is used up */
+
+  if (dir->pos >= dir->len)
+    {
+      struct hostfs_rpmsg_readdir_s msg =
+      {
+        .fd    = dir->fd,
+        .count = C2B(sizeof(dir->buf)),
+#ifdef CONFIG_FS_HOSTFS_RPMSG_DIRSTAT
+        .flags = HOSTFS_RPMSG_READDIR_STAT,
+#endif
+      };
+
+      hostfs_rpmsg_stat_drop(dir);
+
+      ret = hostfs_rpmsg_send_recv(HOSTFS_RPMSG_READDIR, true,
+              (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), dir);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret == 0)
+        {
+          return -ENOENT;
+        }
+    }
+
+  ent       = (FAR struct hostfs_rpmsg_dirent_s *)&dir->buf[dir->pos];
+  dir->pos += B2C(ent->reclen);
+
+  nbstr2cstr(entry->d_name, (FAR char *)ent + B2C(ent->namepos), NAME_MAX);
+  entry->d_name[NAME_MAX] = '\0';
+  entry->d_type = ent->type;
+
+#ifdef CONFIG_FS_HOSTFS_RPMSG_DIRSTAT
+  hostfs_rpmsg_stat_save(dir, ent);
+#endif
 
-  return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_READDIR, true,
-          (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), entry);
+  return 0;
 }
 
 void host_rewinddir(FAR void *dirp)
 {
+  FAR struct hostfs_rpmsg_dir_s *dir = dirp;
   struct hostfs_rpmsg_rewinddir_s msg =
   {
-    .fd = (uintptr_t)dirp,
+    .fd = dir->fd,
   };
 
+  hostfs_rpmsg_stat_drop(dir);
+  dir->pos = 0;
+  dir->len = 0;
+
   hostfs_rpmsg_send_recv(HOSTFS_RPMSG_REWINDDIR, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
 }
 
 int host_closedir(FAR void *dirp)
 {
+  FAR struct hostfs_rpmsg_dir_s *dir = dirp;
   struct hostfs_rpmsg_closedir_s msg =
   {
-    .fd = (uintptr_t)dirp,
+    .fd = dir->fd,
   };
 
+  hostfs_rpmsg_stat_drop(dir);
+  kmm_free(dir);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_CLOSEDIR, true,
           (struct hostfs_rpmsg_header_s *)&msg, sizeof(msg), NULL);
 }
@@ -618,6 +870,8 @@ int host_unlink(FAR const char *pathname)
 
   cstr2bstr(msg->pathname, pathname);
 
+  hostfs_rpmsg_stat_drop(NULL);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_UNLINK, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
 }
@@ -641,6 +895,8 @@ int host_mkdir(FAR const char *pathname, mode_t mode)
   msg->mode = mode;
   cstr2bstr(msg->pathname, pathname);
 
+  hostfs_rpmsg_stat_drop(NULL);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_MKDIR, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
 }
@@ -665,6 +921,8 @@ int host_rmdir(FAR const char *pathname)
 
   cstr2bstr(msg->pathname, pathname);
 
+  hostfs_rpmsg_stat_drop(NULL);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_RMDIR, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
 }
@@ -692,6 +950,8 @@ int host_rename(FAR const char *oldpath, FAR const char *newpath)
   cstr2bstr(msg->pathname, oldpath);
   cstr2bstr(msg->pathname + oldlen, newpath);
 
+  hostfs_rpmsg_stat_drop(NULL);
+
   return hostfs_rpmsg_send_recv(HOSTFS_RPMSG_RENAME, false,
           (struct hostfs_rpmsg_header_s *)msg, len, NULL);
 }
@@ -703,6 +963,13 @@ int host_stat(FAR const char *path, FAR struct stat *buf)
   uint32_t space;
   size_t len;
 
+#ifdef CONFIG_FS_HOSTFS_RPMSG_DIRSTAT
+  if (hostfs_rpmsg_stat_lookup(path, buf) == 0)
+    {
+      return 0;
+    }
+#endif
+
   len  = sizeof(*msg);
   len += B2C(strlen(path) + 1);
 
@@ -725,6 +992,9 @@ int hostfs_rpmsg_init(FAR const char *cpuname)
   struct hostfs_rpmsg_s *priv = &g_hostfs_rpmsg;
 
   priv->cpuname = cpuname;
+#ifdef CONFIG_FS_HOSTFS_RPMSG_DIRSTAT
+  nxsem_init(&priv->statsem, 0, 1);
+#endif
 
   return rpmsg_register_callback(priv,
                                  hostfs_rpmsg_device_created,
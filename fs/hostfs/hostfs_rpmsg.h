@@ -59,6 +59,17 @@
 #define HOSTFS_RPMSG_RENAME         19
 #define HOSTFS_RPMSG_STAT           20
 
+/* READDIR request flags */
+
+#define HOSTFS_RPMSG_READDIR_STAT   0x01 /* Return stat() for each entry */
+
+/* Size of a READDIR record holding a name of namelen bytes (including the
+ * terminating NUL) at offset namepos.  Records are 8-byte aligned.
+ */
+
+#define HOSTFS_RPMSG_DIRENT_SIZE(namepos, namelen) \
+  (((namepos) + (namelen) + 0x7) & ~0x7)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -84,6 +95,12 @@ begin_packed_struct struct hostfs_rpmsg_close_s
   int32_t                      fd;
 } end_packed_struct;
 
+/* A READ request asks for count bytes.  The server answers with as many
+ * replies as it takes to move them, each carrying the number of bytes in
+ * it in header.result and the number still to come in count; the reply
+ * with count == 0 (or with an error) is the last one.
+ */
+
 begin_packed_struct struct hostfs_rpmsg_read_s
 {
   struct hostfs_rpmsg_header_s header;
@@ -134,12 +151,36 @@ begin_packed_struct struct hostfs_rpmsg_opendir_s
   char                         pathname[0];
 } end_packed_struct;
 
+/* A READDIR request asks for up to count bytes of records.  The reply
+ * returns the number of records in header.result (0 at the end of the
+ * directory) and their total size in count, followed by the records.
+ */
+
 begin_packed_struct struct hostfs_rpmsg_readdir_s
 {
   struct hostfs_rpmsg_header_s header;
   int32_t                      fd;
+  uint32_t                     count;
+  uint32_t                     flags;
+  uint32_t                     reserved;
+  char                         buf[0];
+} end_packed_struct;
+
+/* One READDIR record.  buf is only valid if HOSTFS_RPMSG_READDIR_STAT was
+ * requested and statret is 0; otherwise the name may start inside it.
+ */
+
+begin_packed_struct struct hostfs_rpmsg_dirent_s
+{
   uint32_t                     type;
-  char                         name[0];
+  uint32_t                     reclen;
+  int32_t                      statret;
+  uint32_t                     namepos;
+  union
+  {
+    struct stat                buf;
+    uint32_t                   reserved[16];
+  };
 } end_packed_struct;
 
 #define hostfs_rpmsg_rewinddir_s hostfs_rpmsg_close_s
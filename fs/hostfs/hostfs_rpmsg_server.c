@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <dirent.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
@@ -41,12 +42,19 @@
  * Private Types
  ****************************************************************************/
 
+struct hostfs_rpmsg_dir_s
+{
+  FAR DIR               *dir;
+  FAR char              *path;    /* For stat() of the entries */
+  FAR struct dirent     *pending; /* Read but did not fit in the last reply */
+};
+
 struct hostfs_rpmsg_server_s
 {
-  struct rpmsg_endpoint ept;
-  struct file           files[CONFIG_NFILE_DESCRIPTORS];
-  void                  *dirs[CONFIG_NFILE_DESCRIPTORS];
-  sem_t                 sem;
+  struct rpmsg_endpoint    ept;
+  struct file              files[CONFIG_NFILE_DESCRIPTORS];
+  struct hostfs_rpmsg_dir_s dirs[CONFIG_NFILE_DESCRIPTORS];
+  sem_t                    sem;
 };
 
 /****************************************************************************
@@ -154,6 +162,27 @@ static const rpmsg_ept_cb g_hostfs_rpmsg_handler[] =
  * Private Functions
  ****************************************************************************/
 
+static int hostfs_rpmsg_dirent_stat(FAR struct hostfs_rpmsg_dir_s *dir,
+                                    FAR const char *name,
+                                    FAR struct hostfs_rpmsg_dirent_s *ent)
+{
+  char path[PATH_MAX];
+  struct stat buf;
+  size_t len;
+
+  len = strlen(dir->path);
+  snprintf(path, sizeof(path), "%s%s%s", dir->path,
+           len > 0 && dir->path[len - 1] == '/' ? "" : "/", name);
+
+  if (stat(path, &buf) < 0)
+    {
+      return -get_errno();
+    }
+
+  ent->buf = buf;
+  return 0;
+}
+
 static int hostfs_rpmsg_open_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv_)
@@ -211,30 +240,61 @@ static int hostfs_rpmsg_read_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct hostfs_rpmsg_server_s *priv = priv_;
   FAR struct hostfs_rpmsg_read_s *msg = data;
   FAR struct hostfs_rpmsg_read_s *rsp;
-  int ret = -ENOENT;
+  uint32_t remain = msg->count;
   uint32_t space;
+  int ret;
 
-  rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
-  if (!rsp)
+  /* Stream the data back in as many replies as needed; the file is read
+   * into the next tx buffer while the client is still copying out the
+   * previous one.
+   */
+
+  do
     {
-      return -ENOMEM;
-    }
+      rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+      if (!rsp)
+        {
+          return -ENOMEM;
+        }
 
-  *rsp = *msg;
+      *rsp = *msg;
 
-  space -= sizeof(*msg);
-  if (space > msg->count)
-    {
-      space = msg->count;
-    }
+      space -= sizeof(*msg);
+      if (space > remain)
+        {
+          space = remain;
+        }
 
-  if (msg->fd >= 0 && msg->fd < CONFIG_NFILE_DESCRIPTORS)
-    {
-      ret = file_read(&priv->files[msg->fd], rsp->buf, space);
+      ret = -ENOENT;
+      if (msg->fd >= 0 && msg->fd < CONFIG_NFILE_DESCRIPTORS)
+        {
+          ret = file_read(&priv->files[msg->fd], rsp->buf, space);
+        }
+
+      /* A short read or an error ends the stream */
+
+      if (ret < 0 || (uint32_t)ret < space)
+        {
+          remain = 0;
+        }
+      else
+        {
+          remain -= ret;
+        }
+
+      rsp->count         = remain;
+      rsp->header.result = ret;
+
+      ret = rpmsg_send_nocopy(ept, rsp,
+                              (ret < 0 ? 0 : ret) + sizeof(*rsp));
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
+  while (remain > 0);
 
-  rsp->header.result = ret;
-  return rpmsg_send_nocopy(ept, rsp, (ret < 0 ? 0 : ret) + sizeof(*rsp));
+  return 0;
 }
 
 static int hostfs_rpmsg_write_handler(FAR struct rpmsg_endpoint *ept,
@@ -383,19 +443,31 @@ static int hostfs_rpmsg_opendir_handler(FAR struct rpmsg_endpoint *ept,
 {
   FAR struct hostfs_rpmsg_server_s *priv = priv_;
   FAR struct hostfs_rpmsg_opendir_s *msg = data;
-  FAR void *dir;
+  FAR char *path;
+  FAR DIR *dir;
   int i;
   int ret = -ENOENT;
 
-  dir = opendir(msg->pathname);
+  path = kmm_malloc(strlen(msg->pathname) + 1);
+  if (!path)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  strcpy(path, msg->pathname);
+
+  dir = opendir(path);
   if (dir)
     {
       nxsem_wait(&priv->sem);
       for (i = 1; i < CONFIG_NFILE_DESCRIPTORS; i++)
         {
-          if (!priv->dirs[i])
+          if (!priv->dirs[i].dir)
             {
-              priv->dirs[i] = dir;
+              priv->dirs[i].dir     = dir;
+              priv->dirs[i].path    = path;
+              priv->dirs[i].pending = NULL;
               ret = i;
               break;
             }
@@ -409,6 +481,13 @@ static int hostfs_rpmsg_opendir_handler(FAR struct rpmsg_endpoint *ept,
         }
     }
 
+  if (ret < 0)
+    {
+      kmm_free(path);
+    }
+
+out:
+
   msg->header.result = ret;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -419,23 +498,93 @@ static int hostfs_rpmsg_readdir_handler(FAR struct rpmsg_endpoint *ept,
 {
   FAR struct hostfs_rpmsg_server_s *priv = priv_;
   FAR struct hostfs_rpmsg_readdir_s *msg = data;
+  FAR struct hostfs_rpmsg_readdir_s *rsp;
+  FAR struct hostfs_rpmsg_dirent_s *ent;
+  FAR struct hostfs_rpmsg_dir_s *dir;
   FAR struct dirent *entry;
+  uint32_t namepos;
+  uint32_t reclen;
+  uint32_t space;
+  uint32_t pos = 0;
   int ret = -ENOENT;
 
-  if (msg->fd >= 1 && msg->fd < CONFIG_NFILE_DESCRIPTORS)
+  rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+  if (!rsp)
+    {
+      return -ENOMEM;
+    }
+
+  *rsp = *msg;
+
+  space -= sizeof(*msg);
+  if (space > msg->count)
+    {
+      space = msg->count;
+    }
+
+  if (msg->flags & HOSTFS_RPMSG_READDIR_STAT)
+    {
+      namepos = sizeof(*ent);
+    }
+  else
+    {
+      namepos = offsetof(struct hostfs_rpmsg_dirent_s, buf);
+    }
+
+  /* Pack as many entries as fit into one reply */
+
+  if (msg->fd >= 1 && msg->fd < CONFIG_NFILE_DESCRIPTORS &&
+      priv->dirs[msg->fd].dir)
     {
-      entry = readdir(priv->dirs[msg->fd]);
-      if (entry)
+      dir = &priv->dirs[msg->fd];
+      ret = 0;
+
+      for (; ; )
         {
-          msg->type = entry->d_type;
-          strcpy(msg->name, entry->d_name);
-          len += strlen(entry->d_name) + 1;
-          ret = 0;
+          entry = dir->pending ? dir->pending : readdir(dir->dir);
+          dir->pending = NULL;
+          if (!entry)
+            {
+              break;
+            }
+
+          reclen = HOSTFS_RPMSG_DIRENT_SIZE(namepos,
+                                            strlen(entry->d_name) + 1);
+          if (pos + reclen > space)
+            {
+              /* Keep it for the next request */
+
+              dir->pending = entry;
+              if (ret == 0)
+                {
+                  ret = -ENOBUFS;
+                }
+
+              break;
+            }
+
+          ent          = (FAR struct hostfs_rpmsg_dirent_s *)&rsp->buf[pos];
+          ent->type    = entry->d_type;
+          ent->reclen  = reclen;
+          ent->namepos = namepos;
+          ent->statret = 0;
+
+          if (msg->flags & HOSTFS_RPMSG_READDIR_STAT)
+            {
+              ent->statret = hostfs_rpmsg_dirent_stat(dir, entry->d_name,
+                                                      ent);
+            }
+
+          strcpy((FAR char *)ent + namepos, entry->d_name);
+
+          pos += reclen;
+          ret++;
         }
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, len);
+  rsp->count         = pos;
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp) + pos);
 }
 
 static int hostfs_rpmsg_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
@@ -446,9 +595,11 @@ static int hostfs_rpmsg_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct hostfs_rpmsg_rewinddir_s *msg = data;
   int ret = -ENOENT;
 
-  if (msg->fd >= 1 && msg->fd < CONFIG_NFILE_DESCRIPTORS)
+  if (msg->fd >= 1 && msg->fd < CONFIG_NFILE_DESCRIPTORS &&
+      priv->dirs[msg->fd].dir)
     {
-      rewinddir(priv->dirs[msg->fd]);
+      rewinddir(priv->dirs[msg->fd].dir);
+      priv->dirs[msg->fd].pending = NULL;
       ret = 0;
     }
 
@@ -464,11 +615,13 @@ static int hostfs_rpmsg_closedir_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct hostfs_rpmsg_closedir_s *msg = data;
   int ret = -ENOENT;
 
-  if (msg->fd >= 1 && msg->fd < CONFIG_NFILE_DESCRIPTORS)
+  if (msg->fd >= 1 && msg->fd < CONFIG_NFILE_DESCRIPTORS &&
+      priv->dirs[msg->fd].dir)
     {
-      ret = closedir(priv->dirs[msg->fd]);
+      ret = closedir(priv->dirs[msg->fd].dir);
+      kmm_free(priv->dirs[msg->fd].path);
       nxsem_wait(&priv->sem);
-      priv->dirs[msg->fd] = NULL;
+      priv->dirs[msg->fd].dir = NULL;
       nxsem_post(&priv->sem);
       ret = ret ? -get_errno() : 0;
     }
@@ -620,9 +773,10 @@ static void hostfs_rpmsg_ns_unbind(FAR struct rpmsg_endpoint *ept)
 
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      if (priv->dirs[i])
+      if (priv->dirs[i].dir)
         {
-          closedir(priv->dirs[i]);
+          closedir(priv->dirs[i].dir);
+          kmm_free(priv->dirs[i].path);
         }
     }
 
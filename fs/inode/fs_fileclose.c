@@ -80,6 +80,10 @@ int file_close(FAR struct file *filep)
 
   if (inode)
     {
+      /* Disconnect any persistent poll of the file (epoll, poll cache) */
+
+      pollreg_release(filep);
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
@@ -88,22 +88,23 @@ int file_detach(int fd, FAR struct file *filep)
 
   DEBUGASSERT(filep != NULL);
 
+  /* Get the thread-specific file list.  It should never be NULL in this
+   * context.
+   */
+
+  list = nxsched_get_files();
+  DEBUGASSERT(list != NULL);
+
   /* Verify the file descriptor range */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS)
+  parent = files_fget(list, fd);
+  if (parent == NULL)
     {
       /* Not a file descriptor (might be a socket descriptor) */
 
       return -EBADF;
     }
 
-  /* Get the thread-specific file list.  It should never be NULL in this
-   * context.
-   */
-
-  list = nxsched_get_files();
-  DEBUGASSERT(list != NULL);
-
   /* If the file was properly opened, there should be an inode assigned */
 
   ret = _files_semtake(list);
@@ -114,7 +115,6 @@ int file_detach(int fd, FAR struct file *filep)
       return ret;
     }
 
-  parent = &list->fl_files[fd];
   if (parent->f_inode == NULL)
     {
       /* File is not open */
@@ -123,6 +123,12 @@ int file_detach(int fd, FAR struct file *filep)
       return -EBADF;
     }
 
+  /* Persistent polls refer to the descriptor's struct file, which is
+   * emptied below.  Disconnect them while the driver can still be reached.
+   */
+
+  pollreg_release(parent);
+
   /* Duplicate the 'struct file' content into the user-provided file
    * structure.
    */
@@ -141,6 +147,7 @@ int file_detach(int fd, FAR struct file *filep)
   parent->f_pos    = 0;
   parent->f_inode  = NULL;
   parent->f_priv   = NULL;
+  files_freefd(list, fd);
 
   _files_semgive(list);
   return OK;
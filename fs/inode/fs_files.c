@@ -25,9 +25,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <sched.h>
+#include <fcntl.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
@@ -55,6 +57,131 @@ static int _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) nxsem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_findfree
+ *
+ * Description:
+ *   Return the lowest free file descriptor >= minfd, or -EMFILE if all of
+ *   them are in use.  A whole word of the bitmap is tested at once.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static int _files_findfree(FAR struct filelist *list, int minfd)
+{
+  uint32_t avail;
+  int ndx;
+  int fd;
+
+  if (minfd < 0 || minfd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EMFILE;
+    }
+
+  /* Ignore the descriptors below minfd in the first word */
+
+  ndx   = minfd >> 5;
+  avail = ~list->fl_used[ndx] & ~((1ul << (minfd & 31)) - 1);
+
+  for (; ; )
+    {
+      if (avail != 0)
+        {
+          fd = (ndx << 5) + __builtin_ctz(avail);
+          return fd < CONFIG_NFILE_DESCRIPTORS ? fd : -EMFILE;
+        }
+
+      if (++ndx >= FILES_NWORDS)
+        {
+          return -EMFILE;
+        }
+
+      avail = ~list->fl_used[ndx];
+    }
+}
+
+/****************************************************************************
+ * Name: _files_extend
+ *
+ * Description:
+ *   Make sure that the block holding file descriptor 'fd' is allocated.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static int _files_extend(FAR struct filelist *list, int fd)
+{
+  FAR struct file **block = &list->fl_files[fd / FILES_PER_BLOCK];
+
+  if (*block == NULL)
+    {
+      *block = (FAR struct file *)
+        kmm_zalloc(FILES_PER_BLOCK * sizeof(struct file));
+      if (*block == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: _files_index
+ *
+ * Description:
+ *   Return the file descriptor of 'filep' in 'list', or -1 if the file is
+ *   not part of the list.
+ *
+ ****************************************************************************/
+
+static int _files_index(FAR struct filelist *list, FAR struct file *filep)
+{
+  int i;
+
+  for (i = 0; i < FILES_NBLOCKS; i++)
+    {
+      FAR struct file *block = list->fl_files[i];
+
+      if (block != NULL && filep >= block && filep < block + FILES_PER_BLOCK)
+        {
+          return i * FILES_PER_BLOCK + (int)(filep - block);
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: _files_setused
+ *
+ * Description:
+ *   Mark file descriptor 'fd' allocated or free.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static void _files_setused(FAR struct filelist *list, int fd, bool used)
+{
+  if (fd >= 0)
+    {
+      if (used)
+        {
+          list->fl_used[fd >> 5] |= 1ul << (fd & 31);
+        }
+      else
+        {
+          list->fl_used[fd >> 5] &= ~(1ul << (fd & 31));
+        }
+    }
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -76,6 +203,10 @@ static int _files_close(FAR struct file *filep)
 
   if (inode)
     {
+      /* Disconnect any persistent poll of the file (epoll, poll cache) */
+
+      pollreg_release(filep);
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
@@ -126,6 +257,11 @@ void files_initlist(FAR struct filelist *list)
 {
   DEBUGASSERT(list);
 
+  /* No descriptors are allocated until they are first used */
+
+  memset(list->fl_used, 0, sizeof(list->fl_used));
+  memset(list->fl_files, 0, sizeof(list->fl_files));
+
   /* Initialize the list access mutex */
 
   nxsem_init(&list->fl_sem, 0, 1);
@@ -142,6 +278,7 @@ void files_initlist(FAR struct filelist *list)
 void files_releaselist(FAR struct filelist *list)
 {
   int i;
+  int j;
 
   DEBUGASSERT(list);
 
@@ -150,16 +287,96 @@ void files_releaselist(FAR struct filelist *list)
    * because there should not be any references in this context.
    */
 
-  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (i = 0; i < FILES_NBLOCKS; i++)
     {
-      _files_close(&list->fl_files[i]);
+      FAR struct file *block = list->fl_files[i];
+
+      if (block != NULL)
+        {
+          for (j = 0; j < FILES_PER_BLOCK; j++)
+            {
+              _files_close(&block[j]);
+            }
+
+          kmm_free(block);
+          list->fl_files[i] = NULL;
+        }
     }
 
+  memset(list->fl_used, 0, sizeof(list->fl_used));
+
   /* Destroy the semaphore */
 
   nxsem_destroy(&list->fl_sem);
 }
 
+/****************************************************************************
+ * Name: files_duplist
+ *
+ * Description:
+ *   Duplicate the first 'nfds' file descriptors of 'plist' that are open
+ *   and not close-on-exec into the new list 'clist'.
+ *
+ ****************************************************************************/
+
+void files_duplist(FAR struct filelist *plist, FAR struct filelist *clist,
+                   int nfds)
+{
+  FAR struct file *parent;
+  int fd;
+
+  if (_files_semtake(clist) < 0)
+    {
+      return;
+    }
+
+  for (fd = 0; fd < nfds; fd++)
+    {
+      /* Check if this file is opened by the parent.  We can tell if
+       * if the file is open because it contain a reference to a non-NULL
+       * i-node structure.
+       */
+
+      parent = files_fget(plist, fd);
+      if (parent != NULL && parent->f_inode &&
+          (parent->f_oflags & O_CLOEXEC) == 0 &&
+          _files_extend(clist, fd) >= 0)
+        {
+          /* Yes... duplicate it for the child */
+
+          if (file_dup2(parent, files_fget(clist, fd)) >= 0)
+            {
+              _files_setused(clist, fd, true);
+            }
+        }
+    }
+
+  _files_semgive(clist);
+}
+
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the struct file of descriptor 'fd' in 'list', or NULL if no
+ *   block has been allocated for the descriptor yet (so that it cannot be
+ *   open).
+ *
+ ****************************************************************************/
+
+FAR struct file *files_fget(FAR struct filelist *list, int fd)
+{
+  FAR struct file *block;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  block = list->fl_files[fd / FILES_PER_BLOCK];
+  return block != NULL ? &block[fd % FILES_PER_BLOCK] : NULL;
+}
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -181,6 +398,7 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 {
   FAR struct filelist *list;
   FAR struct inode *inode;
+  int fd2 = -1;
   int ret;
 
   if (filep1 == NULL || filep1->f_inode == NULL || filep2 == NULL)
@@ -206,6 +424,10 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 
           return ret;
         }
+
+      /* Is the new file structure one of our file descriptors? */
+
+      fd2 = _files_index(list, filep2);
     }
 
   /* If there is already an inode contained in the new file structure,
@@ -266,6 +488,7 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 
   if (list != NULL)
     {
+      _files_setused(list, fd2, true);
       _files_semgive(list);
     }
 
@@ -283,6 +506,9 @@ errout_with_inode:
 errout_with_sem:
   if (list != NULL)
     {
+      /* The new file structure is closed now in any case */
+
+      _files_setused(list, fd2, false);
       _files_semgive(list);
     }
 
@@ -301,8 +527,9 @@ errout_with_sem:
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
   int ret;
-  int i;
+  int fd;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
 
@@ -317,21 +544,26 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
       return ret;
     }
 
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  /* Find the lowest free descriptor and allocate its block if this is the
+   * first descriptor used in it.
+   */
+
+  fd = _files_findfree(list, minfd);
+  if (fd < 0 || _files_extend(list, fd) < 0)
     {
-      if (!list->fl_files[i].f_inode)
-        {
-          list->fl_files[i].f_oflags = oflags;
-          list->fl_files[i].f_pos    = pos;
-          list->fl_files[i].f_inode  = inode;
-          list->fl_files[i].f_priv   = NULL;
-          _files_semgive(list);
-          return i;
-        }
+      _files_semgive(list);
+      return ERROR;
     }
 
+  filep           = files_fget(list, fd);
+  filep->f_oflags = oflags;
+  filep->f_pos    = pos;
+  filep->f_inode  = inode;
+  filep->f_priv   = NULL;
+  _files_setused(list, fd, true);
+
   _files_semgive(list);
-  return ERROR;
+  return fd;
 }
 
 /****************************************************************************
@@ -349,6 +581,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -360,8 +593,8 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS ||
-      !list->fl_files[fd].f_inode)
+  filep = files_fget(list, fd);
+  if (filep == NULL || !filep->f_inode)
     {
       return -EBADF;
     }
@@ -371,7 +604,8 @@ int files_close(int fd)
   ret = _files_semtake(list);
   if (ret >= 0)
     {
-      ret = _files_close(&list->fl_files[fd]);
+      ret = _files_close(filep);
+      _files_setused(list, fd, false);
       _files_semgive(list);
     }
 
@@ -390,20 +624,75 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
   int ret;
 
   list = nxsched_get_files();
   DEBUGASSERT(list != NULL);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
+  filep = files_fget(list, fd);
+  if (filep != NULL)
     {
       ret = _files_semtake(list);
       if (ret >= 0)
         {
-          list->fl_files[fd].f_oflags  = 0;
-          list->fl_files[fd].f_pos     = 0;
-          list->fl_files[fd].f_inode = NULL;
+          filep->f_oflags  = 0;
+          filep->f_pos     = 0;
+          filep->f_inode = NULL;
+          _files_setused(list, fd, false);
           _files_semgive(list);
         }
     }
 }
+
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that file descriptor 'fd' of the calling task has storage,
+ *   so that fs_getfilep() succeeds for it even if it was never used.
+ *
+ ****************************************************************************/
+
+int files_extend(int fd)
+{
+  FAR struct filelist *list;
+  int ret;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EBADF;
+    }
+
+  list = nxsched_get_files();
+  if (list == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  ret = _files_semtake(list);
+  if (ret >= 0)
+    {
+      ret = _files_extend(list, fd);
+      _files_semgive(list);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: files_freefd
+ *
+ * Description:
+ *   Mark file descriptor 'fd' free after its struct file has been cleared
+ *   by other means, see file_detach().
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+void files_freefd(FAR struct filelist *list, int fd)
+{
+  _files_setused(list, fd, false);
+}
@@ -28,7 +28,9 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 
 #include "inode/inode.h"
@@ -43,19 +45,40 @@
  * Private Types
  ****************************************************************************/
 
-/* Implements a re-entrant mutex for inode access.  This must be re-entrant
- * because there can be cycles.  For example, it may be necessary to destroy
- * a block driver inode on umount() after a removable block device has been
- * removed.  In that case umount() holds the inode semaphore, but the block
- * driver may callback to unregister_blockdriver() after the un-mount,
- * requiring the semaphore again.
+/* Implements a re-entrant reader/writer lock for inode access.
+ *
+ * Exclusive access must be re-entrant because there can be cycles.  For
+ * example, it may be necessary to destroy a block driver inode on umount()
+ * after a removable block device has been removed.  In that case umount()
+ * holds the inode semaphore, but the block driver may callback to
+ * unregister_blockdriver() after the un-mount, requiring the semaphore
+ * again.  The exclusive holder may also take shared access; that is
+ * accounted as one more nested exclusive count.
+ *
+ * Writers first take 'excl', a semaphore with priority inheritance, and
+ * keep it while they wait for the readers to drain and until they release
+ * exclusive access.  So a writer that waits for another writer boosts it,
+ * as with the plain inode mutex.  A writer becomes the holder as soon as
+ * it owns 'excl', and from then on new readers wait.  Hence a steady
+ * stream of readers cannot starve a writer.  Readers that already hold
+ * shared access (counted in their TCB) are still admitted, so that they
+ * can nest shared accesses without deadlocking against a draining writer.
+ * A reader must never request exclusive access while it holds shared
+ * access.
+ *
+ * The state is protected by a critical section.  'wait' is only used to
+ * block tasks until the state changes; all waiters are awakened and then
+ * re-check the state, similar to pthread_cond_broadcast().
  */
 
 struct inode_sem_s
 {
-  sem_t   sem;     /* The semaphore */
-  pid_t   holder;  /* The current holder of the semaphore */
-  int16_t count;   /* Number of counts held */
+  sem_t   excl;     /* Serializes writers, with priority inheritance */
+  sem_t   wait;     /* Waiters for a change of state */
+  pid_t   holder;   /* The current exclusive holder of the lock */
+  int16_t count;    /* Number of exclusive counts held */
+  int16_t nreaders; /* Number of shared counts held */
+  int16_t nwaiters; /* Number of tasks blocked on 'wait' */
 };
 
 /****************************************************************************
@@ -64,6 +87,43 @@ struct inode_sem_s
 
 static struct inode_sem_s g_inode_sem;
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_semwait
+ *
+ * Description:
+ *   Wait for the lock state to change.  Must be called from within a
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static int inode_semwait(void)
+{
+  g_inode_sem.nwaiters++;
+  return nxsem_wait_uninterruptible(&g_inode_sem.wait);
+}
+
+/****************************************************************************
+ * Name: inode_semwake
+ *
+ * Description:
+ *   Wake up all tasks waiting for the lock state to change.  Must be called
+ *   from within a critical section.
+ *
+ ****************************************************************************/
+
+static void inode_semwake(void)
+{
+  while (g_inode_sem.nwaiters > 0)
+    {
+      g_inode_sem.nwaiters--;
+      nxsem_post(&g_inode_sem.wait);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -79,13 +139,19 @@ static struct inode_sem_s g_inode_sem;
 
 void inode_initialize(void)
 {
-  /* Initialize the semaphore to one (to support one-at-a-time access to the
-   * inode tree).
+  /* Initialize the inode tree lock.  The wait semaphore is used for
+   * signaling and, hence, should not have priority inheritance enabled.
+   * The writer semaphore keeps it.
    */
 
-  nxsem_init(&g_inode_sem.sem, 0, 1);
-  g_inode_sem.holder = NO_HOLDER;
-  g_inode_sem.count  = 0;
+  nxsem_init(&g_inode_sem.excl, 0, 1);
+  nxsem_init(&g_inode_sem.wait, 0, 0);
+  nxsem_set_protocol(&g_inode_sem.wait, SEM_PRIO_NONE);
+
+  g_inode_sem.holder   = NO_HOLDER;
+  g_inode_sem.count    = 0;
+  g_inode_sem.nreaders = 0;
+  g_inode_sem.nwaiters = 0;
 
   /* Reserve the root node */
 
@@ -111,12 +177,15 @@ void inode_initialize(void)
 
 int inode_semtake(void)
 {
+  irqstate_t flags;
   pid_t me;
   int ret = OK;
 
-  /* Do we already hold the semaphore? */
+  me    = getpid();
+  flags = enter_critical_section();
+
+  /* Do we already hold the lock? */
 
-  me = getpid();
   if (me == g_inode_sem.holder)
     {
       /* Yes... just increment the count */
@@ -125,20 +194,44 @@ int inode_semtake(void)
       DEBUGASSERT(g_inode_sem.count > 0);
     }
 
-  /* Take the semaphore (perhaps waiting) */
+  /* Wait for the other writers, with priority inheritance, then for the
+   * readers to drain.  New readers wait as soon as we are the holder.
+   */
 
   else
     {
-      ret = nxsem_wait_uninterruptible(&g_inode_sem.sem);
-      if (ret >= 0)
+      leave_critical_section(flags);
+
+      ret = nxsem_wait_uninterruptible(&g_inode_sem.excl);
+      if (ret < 0)
         {
-          /* No we hold the semaphore */
+          return ret;
+        }
+
+      flags = enter_critical_section();
+      DEBUGASSERT(g_inode_sem.holder == NO_HOLDER);
 
-          g_inode_sem.holder = me;
-          g_inode_sem.count  = 1;
+      g_inode_sem.holder = me;
+      g_inode_sem.count  = 1;
+
+      while (g_inode_sem.nreaders > 0)
+        {
+          ret = inode_semwait();
+          if (ret < 0)
+            {
+              /* Let the readers and the other writers in again */
+
+              g_inode_sem.holder = NO_HOLDER;
+              g_inode_sem.count  = 0;
+              inode_semwake();
+              leave_critical_section(flags);
+              nxsem_post(&g_inode_sem.excl);
+              return ret;
+            }
         }
     }
 
+  leave_critical_section(flags);
   return ret;
 }
 
@@ -152,9 +245,13 @@ int inode_semtake(void)
 
 void inode_semgive(void)
 {
+  irqstate_t flags;
+
   DEBUGASSERT(g_inode_sem.holder == getpid());
 
-  /* Is this our last count on the semaphore? */
+  flags = enter_critical_section();
+
+  /* Is this our last count on the lock? */
 
   if (g_inode_sem.count > 1)
     {
@@ -163,12 +260,113 @@ void inode_semgive(void)
       g_inode_sem.count--;
     }
 
-  /* Yes.. then we can really release the semaphore */
+  /* Yes.. then we can really release the lock */
 
   else
     {
       g_inode_sem.holder = NO_HOLDER;
       g_inode_sem.count  = 0;
-      nxsem_post(&g_inode_sem.sem);
+      inode_semwake();
+      leave_critical_section(flags);
+
+      /* Hand over to the next writer, restoring our priority */
+
+      nxsem_post(&g_inode_sem.excl);
+      return;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_rdlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (g_inode_sem).  Any
+ *   number of tasks may hold shared access at the same time, but not while
+ *   another task holds or waits for exclusive access.  The inode tree may
+ *   be searched but must not be modified.
+ *
+ ****************************************************************************/
+
+int inode_rdlock(void)
+{
+  FAR struct tcb_s *rtcb = nxsched_self();
+  irqstate_t flags;
+  pid_t me;
+  int ret = OK;
+
+  me    = rtcb->pid;
+  flags = enter_critical_section();
+
+  /* If we already hold exclusive access, then just nest one more count */
+
+  if (me == g_inode_sem.holder)
+    {
+      g_inode_sem.count++;
+      DEBUGASSERT(g_inode_sem.count > 0);
+    }
+
+  /* Otherwise, wait until no other task holds exclusive access or waits
+   * for the readers to drain.  A nested shared access must not wait for a
+   * writer that is waiting for us.
+   */
+
+  else
+    {
+      while (g_inode_sem.holder != NO_HOLDER && rtcb->inodelocks == 0)
+        {
+          ret = inode_semwait();
+          if (ret < 0)
+            {
+              goto errout;
+            }
+        }
+
+      g_inode_sem.nreaders++;
+      rtcb->inodelocks++;
+      DEBUGASSERT(g_inode_sem.nreaders > 0 && rtcb->inodelocks > 0);
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: inode_rdunlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (g_inode_sem).
+ *
+ ****************************************************************************/
+
+void inode_rdunlock(void)
+{
+  FAR struct tcb_s *rtcb = nxsched_self();
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (g_inode_sem.holder == rtcb->pid)
+    {
+      /* This was a nested count on our exclusive access */
+
+      DEBUGASSERT(g_inode_sem.count > 1);
+      g_inode_sem.count--;
     }
+  else
+    {
+      DEBUGASSERT(g_inode_sem.nreaders > 0 && rtcb->inodelocks > 0);
+      rtcb->inodelocks--;
+
+      /* Wake up any waiting writer when the last reader leaves */
+
+      if (--g_inode_sem.nreaders == 0)
+        {
+          inode_semwake();
+        }
+    }
+
+  leave_critical_section(flags);
 }
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 #include "inode/inode.h"
 
@@ -47,11 +48,13 @@ int inode_addref(FAR struct inode *inode)
 
   if (inode)
     {
-      ret = inode_semtake();
+      ret = inode_rdlock();
       if (ret >= 0)
         {
+          irqstate_t flags = enter_critical_section();
           inode->i_crefs++;
-          inode_semgive();
+          leave_critical_section(flags);
+          inode_rdunlock();
         }
     }
 
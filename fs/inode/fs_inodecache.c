@@ -0,0 +1,234 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_FS_INODE_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_INODE_CACHE_PATHLEN
+#  define CONFIG_FS_INODE_CACHE_PATHLEN 32
+#endif
+
+/* 32-bit FNV-1a hash parameters */
+
+#define INODE_HASH_BASIS 2166136261u
+#define INODE_HASH_PRIME 16777619u
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry in the direct-mapped path lookup cache.  An entry is unused
+ * when ic_node is NULL.
+ */
+
+struct inode_cache_s
+{
+  uint32_t ic_hash;                            /* Hash of ic_path */
+  FAR struct inode *ic_node;                   /* The inode found */
+  FAR struct inode *ic_peer;                   /* Node to the "left" */
+  FAR struct inode *ic_parent;                 /* Node "above" */
+  char ic_path[CONFIG_FS_INODE_CACHE_PATHLEN]; /* Absolute path */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The path lookup cache.  Lookups run with only shared access to the inode
+ * tree, so entries are also protected by a critical section.
+ */
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Hash a path and return its length in 'len'.  Returns false if the path
+ *   is too long to be cached.
+ *
+ ****************************************************************************/
+
+static bool inode_cache_hash(FAR const char *path, FAR uint32_t *hash,
+                             FAR size_t *len)
+{
+  uint32_t h = INODE_HASH_BASIS;
+  size_t i;
+
+  for (i = 0; path[i] != '\0'; i++)
+    {
+      if (i >= CONFIG_FS_INODE_CACHE_PATHLEN - 1)
+        {
+          return false;
+        }
+
+      h = (h ^ (uint8_t)path[i]) * INODE_HASH_PRIME;
+    }
+
+  *hash = h;
+  *len  = i;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up an absolute path in the path lookup cache.  On a hit, the node,
+ *   peer and parent are returned in 'desc' exactly as inode_search() would
+ *   have returned them (before following any terminal soft link).
+ *
+ * Returned Value:
+ *   Zero (OK) on a cache hit; -ENOENT on a miss.
+ *
+ * Assumptions:
+ *   The caller holds shared or exclusive access to g_inode_sem
+ *
+ ****************************************************************************/
+
+int inode_cache_lookup(FAR struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  DEBUGASSERT(desc != NULL && desc->path != NULL);
+
+  if (!inode_cache_hash(desc->path, &hash, &len))
+    {
+      return -ENOENT;
+    }
+
+  entry = &g_inode_cache[hash % CONFIG_FS_INODE_CACHE];
+
+  flags = enter_critical_section();
+  if (entry->ic_node == NULL || entry->ic_hash != hash ||
+      strcmp(entry->ic_path, desc->path) != 0)
+    {
+      leave_critical_section(flags);
+      return -ENOENT;
+    }
+
+  /* Return the same state as a successful _inode_search() of the full
+   * path:  Both the remaining path and the relative path are empty.
+   */
+
+  desc->node    = entry->ic_node;
+  desc->peer    = entry->ic_peer;
+  desc->parent  = entry->ic_parent;
+  leave_critical_section(flags);
+
+  desc->path   += len;
+  desc->relpath = desc->path;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of a successful search for the absolute 'path'.
+ *   Only searches that resolved the complete path may be added.
+ *
+ * Assumptions:
+ *   The caller holds shared or exclusive access to g_inode_sem
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  DEBUGASSERT(path != NULL && desc != NULL && desc->node != NULL);
+
+  if (!inode_cache_hash(path, &hash, &len))
+    {
+      return;
+    }
+
+  /* Replace whatever occupied the slot */
+
+  entry            = &g_inode_cache[hash % CONFIG_FS_INODE_CACHE];
+
+  flags            = enter_critical_section();
+  entry->ic_hash   = hash;
+  entry->ic_node   = desc->node;
+  entry->ic_peer   = desc->peer;
+  entry->ic_parent = desc->parent;
+  memcpy(entry->ic_path, path, len + 1);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Discard the path lookup cache.  This must be called whenever an inode
+ *   is inserted into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds exclusive access to g_inode_sem
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_INODE_CACHE; i++)
+    {
+      g_inode_cache[i].ic_node = NULL;
+    }
+}
+
+#endif /* CONFIG_FS_INODE_CACHE > 0 */
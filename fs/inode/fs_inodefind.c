@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
@@ -55,7 +56,7 @@ int inode_find(FAR struct inode_search_s *desc)
    * references on the node.
    */
 
-  ret = inode_semtake();
+  ret = inode_rdlock();
   if (ret < 0)
     {
       return ret;
@@ -67,13 +68,19 @@ int inode_find(FAR struct inode_search_s *desc)
       /* Found it */
 
       FAR struct inode *node = desc->node;
+      irqstate_t flags;
+
       DEBUGASSERT(node != NULL);
 
-      /* Increment the reference count on the inode */
+      /* Increment the reference count on the inode.  Other readers may be
+       * doing the same thing concurrently.
+       */
 
+      flags = enter_critical_section();
       node->i_crefs++;
+      leave_critical_section(flags);
     }
 
-  inode_semgive();
+  inode_rdunlock();
   return ret;
 }
@@ -109,6 +109,7 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+      inode_cache_invalidate();
     }
 
   RELEASE_SEARCH(&desc);
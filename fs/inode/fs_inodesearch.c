@@ -478,7 +478,7 @@ static FAR const char *_inode_getcwd(void)
  *   that link WILL be deferenced unconditionally.
  *
  * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   The caller holds shared or exclusive access to g_inode_sem
  *
  ****************************************************************************/
 
@@ -506,7 +506,30 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
-  ret = _inode_search(desc);
+#if CONFIG_FS_INODE_CACHE > 0
+  /* Absolute paths given by the caller may be satisfied from the path
+   * lookup cache.  Only searches that resolve the complete path are cached.
+   */
+
+  if (desc->buffer == NULL)
+    {
+      FAR const char *path = desc->path;
+
+      ret = inode_cache_lookup(desc);
+      if (ret < 0)
+        {
+          ret = _inode_search(desc);
+          if (ret >= 0 && *desc->relpath == '\0')
+            {
+              inode_cache_add(path, desc);
+            }
+        }
+    }
+  else
+#endif
+    {
+      ret = _inode_search(desc);
+    }
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
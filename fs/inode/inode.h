@@ -40,6 +40,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_FS_INODE_CACHE
+#  define CONFIG_FS_INODE_CACHE 0
+#endif
+
+#if CONFIG_FS_INODE_CACHE == 0
+#  define inode_cache_invalidate()
+#endif
+
 #define SETUP_SEARCH(d,p,n) \
   do \
     { \
@@ -166,6 +174,28 @@ int inode_semtake(void);
 
 void inode_semgive(void);
 
+/****************************************************************************
+ * Name: inode_rdlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (tree_sem).  The tree may
+ *   be searched, but not modified, while shared access is held.  A task
+ *   holding shared access must not call inode_semtake().
+ *
+ ****************************************************************************/
+
+int inode_rdlock(void);
+
+/****************************************************************************
+ * Name: inode_rdunlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (tree_sem).
+ *
+ ****************************************************************************/
+
+void inode_rdunlock(void);
+
 /****************************************************************************
  * Name: inode_checkflags
  *
@@ -196,12 +226,65 @@ int inode_checkflags(FAR struct inode *inode, int oflags);
  *   that link WILL be deferenced unconditionally.
  *
  * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   The caller holds shared or exclusive access to g_inode_sem
  *
  ****************************************************************************/
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up an absolute path in the path lookup cache.  On a hit, the node,
+ *   peer and parent are returned in 'desc' exactly as inode_search() would
+ *   have returned them (before following any terminal soft link).
+ *
+ * Returned Value:
+ *   Zero (OK) on a cache hit; -ENOENT on a miss.
+ *
+ * Assumptions:
+ *   The caller holds shared or exclusive access to g_inode_sem
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+int inode_cache_lookup(FAR struct inode_search_s *desc);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of a successful search for the absolute 'path'.
+ *   Only searches that resolved the complete path may be added.
+ *
+ * Assumptions:
+ *   The caller holds shared or exclusive access to g_inode_sem
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Discard the path lookup cache.  This must be called whenever an inode
+ *   is inserted into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds exclusive access to g_inode_sem
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE > 0
+void inode_cache_invalidate(void);
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -414,6 +497,31 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that file descriptor 'fd' of the calling task has storage,
+ *   so that fs_getfilep() succeeds for it even if it was never used.
+ *
+ ****************************************************************************/
+
+int files_extend(int fd);
+
+/****************************************************************************
+ * Name: files_freefd
+ *
+ * Description:
+ *   Mark file descriptor 'fd' free after its struct file has been cleared
+ *   by other means, see file_detach().
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+void files_freefd(FAR struct filelist *list, int fd);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -26,7 +26,9 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
+#include <debug.h>
 
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/fs.h>
@@ -40,10 +42,41 @@
 #include "littlefs/lfs.h"
 #include "littlefs/lfs_util.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Mount option flags */
+
+#define LITTLEFS_OPT_AUTOFORMAT   (1 << 0)
+#define LITTLEFS_OPT_FORCEFORMAT  (1 << 1)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* Mount options: "-o autoformat,cache=4096,lookahead=64,blockcache=16" */
+
+struct littlefs_options_s
+{
+  uint8_t               flags;       /* See LITTLEFS_OPT_* definitions */
+  lfs_size_t            cache_size;  /* littlefs cache size (0 = default) */
+  lfs_size_t            lookahead;   /* littlefs lookahead size (0 = default) */
+  int                   bcount;      /* Block cache entries */
+};
+
+/* One entry of the block cache.  The cache holds copies of device blocks
+ * (of the MTD read/write block size) that littlefs recently read so that
+ * repeatedly fetching the same metadata pairs does not go to the device.
+ * The cache is write-through; it never holds data newer than the device.
+ */
+
+struct littlefs_bcentry_s
+{
+  off_t                 block;       /* Device block number (-1 = unused) */
+  uint32_t              age;         /* Last access, for LRU replacement */
+};
+
 /* This structure represents the overall mountpoint state. An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a littlefs filesystem.
@@ -56,6 +89,13 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   lfs_t                 lfs;
+
+  /* Block cache */
+
+  FAR struct littlefs_bcentry_s *bcache;
+  FAR uint8_t          *bbuffer;     /* bcount device blocks */
+  uint32_t              bclock;      /* Access counter */
+  int                   bcount;      /* Number of entries (0 = disabled) */
 };
 
 /****************************************************************************
@@ -780,38 +820,155 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
 }
 
 /****************************************************************************
- * Name: littlefs_bind
+ * Name: littlefs_bcache_lookup
+ *
+ * Description: Return the block cache entry holding device block 'block'
+ *  or -1 if it is not cached.
+ *
+ ****************************************************************************/
+
+static int littlefs_bcache_lookup(FAR struct littlefs_mountpt_s *fs,
+                                  off_t block)
+{
+  int i;
+
+  for (i = 0; i < fs->bcount; i++)
+    {
+      if (fs->bcache[i].block == block)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: littlefs_bcache_insert
+ *
+ * Description: Copy device block 'block' into the least recently used
+ *  block cache entry.
+ *
+ ****************************************************************************/
+
+static void littlefs_bcache_insert(FAR struct littlefs_mountpt_s *fs,
+                                   off_t block, FAR const uint8_t *data)
+{
+  int victim = 0;
+  int i;
+
+  for (i = 0; i < fs->bcount; i++)
+    {
+      if (fs->bcache[i].block < 0)
+        {
+          victim = i;
+          break;
+        }
+
+      if (fs->bcache[i].age - fs->bcache[victim].age > UINT32_MAX / 2)
+        {
+          /* Entry i was used longer ago than the current victim */
+
+          victim = i;
+        }
+    }
+
+  fs->bcache[victim].block = block;
+  fs->bcache[victim].age   = ++fs->bclock;
+  memcpy(&fs->bbuffer[victim * fs->geo.blocksize], data, fs->geo.blocksize);
+}
+
+/****************************************************************************
+ * Name: littlefs_devread
  *
- * Description: This implements a portion of the mount operation. This
- *  function allocates and initializes the mountpoint private data and
- *  binds the driver inode to the filesystem private data. The final
- *  binding of the private data (containing the driver) to the
- *  mountpoint is performed by mount().
+ * Description: Read 'nblocks' device blocks in a single request.
  *
  ****************************************************************************/
 
+static int littlefs_devread(FAR struct littlefs_mountpt_s *fs, off_t block,
+                            size_t nblocks, FAR uint8_t *buffer)
+{
+  FAR struct inode *drv = fs->drv;
+  ssize_t ret;
+
+  if (INODE_IS_MTD(drv))
+    {
+      ret = MTD_BREAD(drv->u.i_mtd, block, nblocks, buffer);
+    }
+  else
+    {
+      ret = drv->u.i_bops->read(drv, buffer, block, nblocks);
+    }
+
+  return ret >= 0 ? OK : (int)ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_read_block
+ ****************************************************************************/
+
 static int littlefs_read_block(FAR const struct lfs_config *c,
                                lfs_block_t block, lfs_off_t off,
                                FAR void *buffer, lfs_size_t size)
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
-  FAR struct inode *drv = fs->drv;
+  FAR uint8_t *dest = buffer;
+  off_t start;
+  size_t nblocks;
+  size_t run;
+  size_t i;
+  int ndx;
   int ret;
 
-  block = (block * c->block_size + off) / geo->blocksize;
-  size  = size / geo->blocksize;
+  start   = ((off_t)block * c->block_size + off) / geo->blocksize;
+  nblocks = size / geo->blocksize;
 
-  if (INODE_IS_MTD(drv))
+  /* Without a block cache the whole request goes to the device at once */
+
+  if (fs->bcount == 0)
     {
-      ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
+      return littlefs_devread(fs, start, nblocks, dest);
     }
-  else
+
+  while (nblocks > 0)
     {
-      ret = drv->u.i_bops->read(drv, buffer, block, size);
+      ndx = littlefs_bcache_lookup(fs, start);
+      if (ndx >= 0)
+        {
+          fs->bcache[ndx].age = ++fs->bclock;
+          memcpy(dest, &fs->bbuffer[ndx * geo->blocksize], geo->blocksize);
+          run = 1;
+        }
+      else
+        {
+          /* Fetch the whole run of uncached blocks with one request */
+
+          for (run = 1;
+               run < nblocks && littlefs_bcache_lookup(fs, start + run) < 0;
+               run++)
+            {
+            }
+
+          ret = littlefs_devread(fs, start, run, dest);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          for (i = 0; i < run; i++)
+            {
+              littlefs_bcache_insert(fs, start + i,
+                                     &dest[i * geo->blocksize]);
+            }
+        }
+
+      start   += run;
+      nblocks -= run;
+      dest    += run * geo->blocksize;
     }
 
-  return ret >= 0 ? OK : ret;
+  return OK;
 }
 
 /****************************************************************************
@@ -839,7 +996,31 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
       ret = drv->u.i_bops->write(drv, buffer, block, size);
     }
 
-  return ret >= 0 ? OK : ret;
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Keep the block cache coherent with what is now on the device */
+
+  if (fs->bcount > 0)
+    {
+      FAR const uint8_t *src = buffer;
+      lfs_size_t i;
+      int ndx;
+
+      for (i = 0; i < size; i++)
+        {
+          ndx = littlefs_bcache_lookup(fs, block + i);
+          if (ndx >= 0)
+            {
+              memcpy(&fs->bbuffer[ndx * geo->blocksize],
+                     &src[i * geo->blocksize], geo->blocksize);
+            }
+        }
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -860,6 +1041,24 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
 
       block = block * c->block_size / geo->erasesize;
       ret = MTD_ERASE(drv->u.i_mtd, block, size);
+
+      /* Forget cached copies of the erased blocks */
+
+      if (fs->bcount > 0)
+        {
+          off_t first = (off_t)block * geo->erasesize / geo->blocksize;
+          off_t last  = first + size * geo->erasesize / geo->blocksize;
+          int i;
+
+          for (i = 0; i < fs->bcount; i++)
+            {
+              if (fs->bcache[i].block >= first &&
+                  fs->bcache[i].block < last)
+                {
+                  fs->bcache[i].block = -1;
+                }
+            }
+        }
     }
 
   return ret >= 0 ? OK : ret;
@@ -887,6 +1086,57 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parse_options
+ *
+ * Description: Parse the comma separated mount options.  Unknown options
+ *  are ignored, as they always were.
+ *
+ ****************************************************************************/
+
+static void littlefs_parse_options(FAR const char *data,
+                                   FAR struct littlefs_options_s *opts)
+{
+  FAR const char *end;
+  size_t len;
+
+  memset(opts, 0, sizeof(*opts));
+  opts->bcount = CONFIG_FS_LITTLEFS_BLOCKCACHE;
+
+  while (data != NULL && *data != '\0')
+    {
+      end = strchr(data, ',');
+      len = end ? end - data : strlen(data);
+
+      if (len == 10 && strncmp(data, "autoformat", 10) == 0)
+        {
+          opts->flags |= LITTLEFS_OPT_AUTOFORMAT;
+        }
+      else if (len == 11 && strncmp(data, "forceformat", 11) == 0)
+        {
+          opts->flags |= LITTLEFS_OPT_FORCEFORMAT;
+        }
+      else if (strncmp(data, "cache=", 6) == 0)
+        {
+          opts->cache_size = strtoul(data + 6, NULL, 0);
+        }
+      else if (strncmp(data, "lookahead=", 10) == 0)
+        {
+          opts->lookahead = strtoul(data + 10, NULL, 0);
+        }
+      else if (strncmp(data, "blockcache=", 11) == 0)
+        {
+          opts->bcount = strtoul(data + 11, NULL, 0);
+        }
+      else
+        {
+          fwarn("WARNING: Unknown mount option '%.*s'\n", (int)len, data);
+        }
+
+      data = end ? end + 1 : data + len;
+    }
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -895,8 +1145,12 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  struct littlefs_options_s opts;
+  lfs_size_t maxlook;
   int ret;
 
+  littlefs_parse_options(data, &opts);
+
   /* Open the block driver */
 
   if (INODE_IS_BLOCK(driver) && driver->u.i_bops->open)
@@ -973,10 +1227,73 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.block_size     = fs->geo.erasesize;
   fs->cfg.block_count    = fs->geo.neraseblocks;
   fs->cfg.block_cycles   = 500;
-  fs->cfg.cache_size     = fs->geo.blocksize;
-  fs->cfg.lookahead_size =
-    lfs_min(lfs_alignup((fs->cfg.block_count + 7) / 8, 8),
-            fs->cfg.read_size);
+
+  /* The cache size must be a multiple of the read/program size and a
+   * factor of the block size.  A larger cache lets littlefs read and
+   * program several device blocks per request.
+   */
+
+  if (opts.cache_size == 0)
+    {
+      opts.cache_size = CONFIG_FS_LITTLEFS_CACHE_SIZE;
+    }
+
+  fs->cfg.cache_size = lfs_alignup(lfs_max(opts.cache_size,
+                                           fs->geo.blocksize),
+                                   fs->geo.blocksize);
+  fs->cfg.cache_size = lfs_min(fs->cfg.cache_size, fs->cfg.block_size);
+  while (fs->cfg.block_size % fs->cfg.cache_size != 0)
+    {
+      fs->cfg.cache_size -= fs->geo.blocksize;
+    }
+
+  /* The lookahead size must be a multiple of 8 bytes.  There is no point
+   * in tracking more blocks than the device has.
+   */
+
+  maxlook = lfs_alignup((fs->cfg.block_count + 7) / 8, 8);
+  if (opts.lookahead == 0)
+    {
+      opts.lookahead = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
+    }
+
+  if (opts.lookahead == 0)
+    {
+      fs->cfg.lookahead_size = lfs_min(maxlook, fs->cfg.read_size);
+    }
+  else
+    {
+      fs->cfg.lookahead_size = lfs_min(maxlook,
+                                       lfs_alignup(opts.lookahead, 8));
+    }
+
+  /* Allocate the block cache.  It is an optimization only, so continue
+   * without it if there is not enough memory.
+   */
+
+  if (opts.bcount > 0)
+    {
+      fs->bcache = kmm_malloc(opts.bcount *
+                              (sizeof(struct littlefs_bcentry_s) +
+                               fs->geo.blocksize));
+      if (fs->bcache != NULL)
+        {
+          int i;
+
+          fs->bbuffer = (FAR uint8_t *)&fs->bcache[opts.bcount];
+          fs->bcount  = opts.bcount;
+
+          for (i = 0; i < fs->bcount; i++)
+            {
+              fs->bcache[i].block = -1;
+              fs->bcache[i].age   = 0;
+            }
+        }
+      else
+        {
+          fwarn("WARNING: No memory for the block cache\n");
+        }
+    }
 
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
@@ -984,7 +1301,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if ((opts.flags & LITTLEFS_OPT_FORCEFORMAT) != 0)
     {
       ret = lfs_format(&fs->lfs, &fs->cfg);
       if (ret < 0)
@@ -999,7 +1316,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
       /* Auto format the device if -o autoformat */
 
       if (ret != LFS_ERR_CORRUPT ||
-          !data || strcmp(data, "autoformat"))
+          (opts.flags & LITTLEFS_OPT_AUTOFORMAT) == 0)
         {
           goto errout_with_fs;
         }
@@ -1024,6 +1341,11 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+  if (fs->bcache != NULL)
+    {
+      kmm_free(fs->bcache);
+    }
+
   nxsem_destroy(&fs->sem);
   kmm_free(fs);
 errout_with_block:
@@ -1083,6 +1405,11 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+      if (fs->bcache != NULL)
+        {
+          kmm_free(fs->bcache);
+        }
+
       nxsem_destroy(&fs->sem);
       kmm_free(fs);
     }
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+
+#include "inode/inode.h"
+#include "fs_rammap.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   Write the changes made to a MAP_SHARED mapping back to the mapped file.
+ *
+ *   Mappings returned directly by the file system (FIOC_MMAP) are the file
+ *   itself and need no synchronization.  Regions copied into RAM by
+ *   CONFIG_FS_RAMMAP are written back to the file.  The write back is
+ *   always synchronous; with MS_SYNC the file is also flushed to the media.
+ *   MS_INVALIDATE has nothing to do: there is only one copy of each mapped
+ *   region.
+ *
+ * Input Parameters:
+ *   addr  - The start of the range to synchronize
+ *   len   - The length of the range
+ *   flags - MS_ASYNC or MS_SYNC, optionally with MS_INVALIDATE
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set:
+ *
+ *     EINVAL
+ *       'flags' is invalid.
+ *     EIO
+ *       The write back failed.
+ *
+ ****************************************************************************/
+
+int msync(FAR void *addr, size_t len, int flags)
+{
+#ifdef CONFIG_FS_RAMMAP
+  FAR struct fs_rammap_s *curr;
+  size_t offset;
+  int ret = OK;
+#endif
+  int errcode;
+
+  if ((flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) != 0 ||
+      (flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC))
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+#ifdef CONFIG_FS_RAMMAP
+  /* msync() is a cancellation point */
+
+  enter_cancellation_point();
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      leave_cancellation_point();
+      errcode = -ret;
+      goto errout;
+    }
+
+  /* Find the region holding the start of the range */
+
+  for (curr = g_rammaps.head; curr; curr = curr->flink)
+    {
+      if ((uintptr_t)addr >= (uintptr_t)curr->addr &&
+          (uintptr_t)addr < (uintptr_t)curr->addr + curr->length)
+        {
+          break;
+        }
+    }
+
+  if (curr != NULL)
+    {
+      offset = (uintptr_t)addr - (uintptr_t)curr->addr;
+      if (len > curr->length - offset)
+        {
+          len = curr->length - offset;
+        }
+
+      ret = rammap_writeback(curr, offset, len);
+      if (ret >= 0 && curr->shared && (flags & MS_SYNC) != 0)
+        {
+          ret = file_fsync(&curr->file);
+          if (ret == -ENOSYS)
+            {
+              ret = OK;
+            }
+        }
+    }
+
+  nxsem_post(&g_rammaps.exclsem);
+  leave_cancellation_point();
+
+  if (ret < 0)
+    {
+      errcode = EIO;
+      goto errout;
+    }
+#endif
+
+  return OK;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
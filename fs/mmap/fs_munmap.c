@@ -91,7 +91,8 @@
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
  *      into RAM.  munmap() is required in this case to free the allocated
- *      memory holding the shared copy of the file.
+ *      memory holding the shared copy of the file.  The unmapped part of a
+ *      writable MAP_SHARED region is first written back to the file.
  *
  * Input Parameters:
  *   start   The start address of the mapping to delete.  For this
@@ -112,7 +113,7 @@ int munmap(FAR void *start, size_t length)
   FAR struct fs_rammap_s *prev;
   FAR struct fs_rammap_s *curr;
   FAR void *newaddr;
-  unsigned int offset;
+  size_t offset;
   int ret;
   int errcode;
 
@@ -122,7 +123,7 @@ int munmap(FAR void *start, size_t length)
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
-      errcode = ret;
+      errcode = -ret;
       goto errout;
     }
 
@@ -131,10 +132,10 @@ int munmap(FAR void *start, size_t length)
   for (prev = NULL, curr = g_rammaps.head; curr;
        prev = curr, curr = curr->flink)
     {
-      /* Does this region include any part of the specified range? */
+      /* Does this region include the start of the specified range? */
 
-      if ((uintptr_t)start < (uintptr_t)curr->addr + curr->length &&
-          (uintptr_t)start + length >= (uintptr_t)curr->addr)
+      if ((uintptr_t)start >= (uintptr_t)curr->addr &&
+          (uintptr_t)start < (uintptr_t)curr->addr + curr->length)
         {
           break;
         }
@@ -156,7 +157,7 @@ int munmap(FAR void *start, size_t length)
    * simulate the unmapping.
    */
 
-  offset = start - curr->addr;
+  offset = (uintptr_t)start - (uintptr_t)curr->addr;
   if (offset + length < curr->length)
     {
       ferr("ERROR: Cannot umap without unmapping to the end\n");
@@ -170,9 +171,27 @@ int munmap(FAR void *start, size_t length)
 
   length = curr->length - offset;
 
+  /* A MAP_SHARED region hands its changes back to the file before the
+   * memory goes away.
+   */
+
+  rammap_writeback(curr, offset, length);
+
+  /* If the region was mapped more than once, the other users still need
+   * it.  Only drop the reference when the whole region is unmapped.
+   */
+
+  if (curr->refs > 1)
+    {
+      if (offset == 0)
+        {
+          curr->refs--;
+        }
+    }
+
   /* Are we unmapping the entire region (offset == 0)? */
 
-  if (length >= curr->length)
+  else if (offset == 0)
     {
       /* Yes.. remove the mapping from the list */
 
@@ -185,22 +204,32 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
+      /* Release the reference to the file held by a shared mapping */
+
+      if (curr->shared)
+        {
+          file_close(&curr->file);
+        }
+
       /* Then free the region */
 
       kumm_free(curr);
     }
 
   /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+   * (offset > 0).  Keep the first 'offset' bytes.
    */
 
   else
     {
-      newaddr = kumm_realloc(curr->addr,
-                             sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
+      newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+      DEBUGASSERT(newaddr == (FAR void *)curr);
       UNUSED(newaddr); /* May not be used */
-      curr->length = length;
+      curr->length = offset;
+      if (curr->filelen > offset)
+        {
+          curr->filelen = offset;
+        }
     }
 
   nxsem_post(&g_rammaps.exclsem);
@@ -42,8 +42,10 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -101,6 +103,9 @@ void rammap_initialize(void)
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    PROT_WRITE is required for a MAP_SHARED mapping to be written
+ *           back
+ *   flags   MAP_SHARED or MAP_PRIVATE
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -112,32 +117,68 @@ void rammap_initialize(void)
  *       'length' or 'offset' are invalid
  *     ENOMEM
  *       Insufficient memory is available to map the file.
+ *     EACCES
+ *       A writable MAP_SHARED mapping of a file not open for writing.
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, int prot, int flags)
 {
   FAR struct fs_rammap_s *map;
+  FAR struct file *filep;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
+  size_t remaining;
   ssize_t nread;
-  off_t fpos;
+  bool shared;
   int errcode;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  /* Only a writable MAP_SHARED mapping has to reach the file again */
+
+  shared = (flags & MAP_SHARED) != 0 && (prot & PROT_WRITE) != 0;
+  if (shared && (filep->f_oflags & O_WROK) == 0)
+    {
+      errcode = EACCES;
+      goto errout;
+    }
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  /* A MAP_SHARED mapping of a range that is already mapped from the same
+   * open file gets the same region, so that all users see each other's
+   * changes.  Files are identified by the open file they were mapped from;
+   * different opens of the same path are not recognized.
    */
 
+  if ((flags & MAP_SHARED) != 0)
+    {
+      for (map = g_rammaps.head; map != NULL; map = map->flink)
+        {
+          if (map->shared == shared && map->inode == filep->f_inode &&
+              map->priv == filep->f_priv && map->offset == offset &&
+              map->length >= length && map->refs < UINT16_MAX)
+            {
+              map->refs++;
+              nxsem_post(&g_rammaps.exclsem);
+              return map->addr;
+            }
+        }
+    }
+
   /* Allocate a region of memory of the specified size */
 
   alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
@@ -145,7 +186,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
     {
       ferr("ERROR: Region allocation failed, length: %d\n", (int)length);
       errcode = ENOMEM;
-      goto errout;
+      goto errout_with_semaphore;
     }
 
   /* Initialize the region */
@@ -155,27 +196,21 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   map->addr   = alloc + sizeof(struct fs_rammap_s);
   map->length = length;
   map->offset = offset;
+  map->refs   = 1;
+  map->shared = shared;
+  map->inode  = filep->f_inode;
+  map->priv   = filep->f_priv;
 
-  /* Seek to the specified file offset */
-
-  fpos = lseek(fd, offset,  SEEK_SET);
-  if (fpos == (off_t)-1)
-    {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
-
-      ferr("ERROR: Seek to position %d failed\n", (int)offset);
-      errcode = EINVAL;
-      goto errout_with_region;
-    }
-
-  /* Read the file data into the memory region */
+  /* Read the file data into the memory region.  The file position of 'fd'
+   * is not disturbed.
+   */
 
-  rdbuffer = map->addr;
-  while (length > 0)
+  rdbuffer  = map->addr;
+  remaining = length;
+  while (remaining > 0)
     {
-      nread = nx_read(fd, rdbuffer, length);
+      nread = file_pread(filep, rdbuffer, remaining,
+                         offset + (rdbuffer - (FAR uint8_t *)map->addr));
       if (nread < 0)
         {
           /* Handle the special case where the read was interrupted by a
@@ -192,6 +227,8 @@ FAR void *rammap(int fd, size_t length, off_t offset)
               errcode = (int)-nread;
               goto errout_with_region;
             }
+
+          continue;
         }
 
       /* Check for end of file. */
@@ -203,24 +240,33 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
       /* Increment number of bytes read */
 
-      rdbuffer += nread;
-      length   -= nread;
+      rdbuffer  += nread;
+      remaining -= nread;
     }
 
-  /* Zero any memory beyond the amount read from the file */
+  /* Zero any memory beyond the amount read from the file.  That part is
+   * never written back.
+   */
 
-  memset(rdbuffer, 0, length);
+  memset(rdbuffer, 0, remaining);
+  map->filelen = length - remaining;
 
-  /* Add the buffer to the list of regions */
+  /* A shared mapping keeps its own reference to the file so that it can be
+   * written back after 'fd' has been closed.
+   */
 
-  rammap_initialize();
-  ret = nxsem_wait(&g_rammaps.exclsem);
-  if (ret < 0)
+  if (shared)
     {
-      errcode = -ret;
-      goto errout_with_region;
+      ret = file_dup2(filep, &map->file);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_region;
+        }
     }
 
+  /* Add the buffer to the list of regions */
+
   map->flink  = g_rammaps.head;
   g_rammaps.head = map;
 
@@ -230,9 +276,74 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 errout_with_region:
   kumm_free(alloc);
 
+errout_with_semaphore:
+  nxsem_post(&g_rammaps.exclsem);
+
 errout:
   set_errno(errcode);
   return MAP_FAILED;
 }
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of a MAP_SHARED region back to the file.  Called with
+ *   g_rammaps.exclsem held.
+ *
+ * Input Parameters:
+ *   map     The mapped region
+ *   start   Offset of the first byte to write back, relative to map->addr
+ *   length  The number of bytes to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t start,
+                     size_t length)
+{
+  FAR const uint8_t *wrbuffer;
+  ssize_t nwritten;
+
+  /* Only the part of the region that came from the file is written back;
+   * the zero fill after the end of the file does not extend it.
+   */
+
+  if (!map->shared || start >= map->filelen)
+    {
+      return OK;
+    }
+
+  if (length > map->filelen - start)
+    {
+      length = map->filelen - start;
+    }
+
+  wrbuffer = (FAR const uint8_t *)map->addr + start;
+  while (length > 0)
+    {
+      nwritten = file_pwrite(&map->file, wrbuffer, length,
+                             map->offset + start);
+      if (nwritten < 0)
+        {
+          if (nwritten == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Write back failed: offset=%d errno=%d\n",
+               (int)(map->offset + start), (int)nwritten);
+          return (int)nwritten;
+        }
+
+      wrbuffer += nwritten;
+      start    += nwritten;
+      length   -= nwritten;
+    }
+
+  return OK;
+}
+
 #endif /* CONFIG_FS_RAMMAP */
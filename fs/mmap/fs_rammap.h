@@ -45,6 +45,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+
+#include <nuttx/fs/fs.h>
 #include <nuttx/semaphore.h>
 
 #ifdef CONFIG_FS_RAMMAP
@@ -65,8 +68,10 @@
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - A MAP_PRIVATE mapping is a private copy.  A MAP_SHARED mapping keeps
+ *   its own reference to the file and writes the in-memory image back to
+ *   it on msync() and on the final munmap().  Mapping the same range of
+ *   the same open file again (in any task) returns the same region.
  * - There are not access privileges.
  */
 
@@ -76,6 +81,12 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+  size_t              filelen;     /* Bytes of the region backed by the file */
+  uint16_t            refs;        /* Number of mmap() references */
+  bool                shared;      /* MAP_SHARED: write back to the file */
+  FAR struct inode   *inode;       /* Identifies the mapped open file */
+  FAR void           *priv;        /* (with inode) */
+  struct file         file;        /* MAP_SHARED: reference to the file */
 };
 
 /* This structure defines all "mapped" files */
@@ -126,6 +137,9 @@ void rammap_initialize(void);
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    PROT_WRITE is required for a MAP_SHARED mapping to be written
+ *           back
+ *   flags   MAP_SHARED or MAP_PRIVATE
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -137,10 +151,32 @@ void rammap_initialize(void);
  *       'length' or 'offset' are invalid
  *     ENOMEM
  *       Insufficient memory is available to map the file.
+ *     EACCES
+ *       A writable MAP_SHARED mapping of a file not open for writing.
+ *
+ ****************************************************************************/
+
+FAR void *rammap(int fd, size_t length, off_t offset, int prot, int flags);
+
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of a MAP_SHARED region back to the file.  Called with
+ *   g_rammaps.exclsem held.
+ *
+ * Input Parameters:
+ *   map     The mapped region
+ *   start   Offset of the first byte to write back, relative to map->addr
+ *   length  The number of bytes to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t start,
+                     size_t length);
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
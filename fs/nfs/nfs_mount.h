@@ -57,10 +57,26 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_NFS_LOOKUP_NCACHE
+#  define CONFIG_NFS_LOOKUP_NCACHE 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#if CONFIG_NFS_LOOKUP_NCACHE > 0
+/* One cached result of nfs_findnode() */
+
+struct nfs_lookup_s
+{
+  FAR char                 *nl_relpath;       /* Path relative to the mount, NULL if unused */
+  clock_t                   nl_stamp;         /* Time of the lookup */
+  struct file_handle        nl_fhandle;       /* File handle of the path */
+  struct nfs_fattr          nl_fattr;         /* Attributes of the path */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -79,6 +95,10 @@ struct nfsmount
   uint16_t                  nm_wsize;         /* Max size of write RPC */
   uint16_t                  nm_readdirsize;   /* Size of a readdir RPC */
   uint16_t                  nm_buflen;        /* Size of I/O buffer */
+#if CONFIG_NFS_LOOKUP_NCACHE > 0
+  uint8_t                   nm_nextlookup;    /* Next lookup cache entry to replace */
+  struct nfs_lookup_s       nm_lookup[CONFIG_NFS_LOOKUP_NCACHE];
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.  NOTE
    * that for the case of the write call message, it is the reply message that
@@ -70,6 +70,11 @@ struct nfsnode
   time_t              n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_READAHEAD
+  FAR uint8_t        *n_rabuf;      /* Read-ahead buffer of nm_rsize bytes */
+  uint64_t            n_raoffset;   /* File offset of the read-ahead data */
+  uint32_t            n_ralen;      /* Bytes of read-ahead data, 0 if none */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
@@ -35,6 +35,9 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -98,6 +101,109 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+#if CONFIG_NFS_LOOKUP_NCACHE > 0
+/****************************************************************************
+ * Name: nfs_lookup_find
+ *
+ * Description:
+ *   Return the file handle and attributes of relpath if a recent lookup of
+ *   the same path is cached.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if the path is not cached.
+ *
+ ****************************************************************************/
+
+static int nfs_lookup_find(FAR struct nfsmount *nmp,
+                           FAR const char *relpath,
+                           FAR struct file_handle *fhandle,
+                           FAR struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_lookup_s *nl;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_NCACHE; i++)
+    {
+      nl = &nmp->nm_lookup[i];
+      if (nl->nl_relpath != NULL && strcmp(nl->nl_relpath, relpath) == 0)
+        {
+          if (now - nl->nl_stamp >= SEC2TICK(CONFIG_NFS_LOOKUP_TIMEO))
+            {
+              /* Too old to be trusted */
+
+              return -ENOENT;
+            }
+
+          memcpy(fhandle, &nl->nl_fhandle, sizeof(struct file_handle));
+          if (obj_attributes)
+            {
+              memcpy(obj_attributes, &nl->nl_fattr,
+                     sizeof(struct nfs_fattr));
+            }
+
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nfs_lookup_add
+ *
+ * Description:
+ *   Remember the file handle and attributes found for relpath, replacing
+ *   any previous entry for the same path or else the oldest entry.
+ *
+ ****************************************************************************/
+
+static void nfs_lookup_add(FAR struct nfsmount *nmp,
+                           FAR const char *relpath,
+                           FAR const struct file_handle *fhandle,
+                           FAR const struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_lookup_s *nl = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_NCACHE; i++)
+    {
+      if (nmp->nm_lookup[i].nl_relpath != NULL &&
+          strcmp(nmp->nm_lookup[i].nl_relpath, relpath) == 0)
+        {
+          nl = &nmp->nm_lookup[i];
+          break;
+        }
+    }
+
+  if (nl == NULL)
+    {
+      nl = &nmp->nm_lookup[nmp->nm_nextlookup];
+      if (++nmp->nm_nextlookup >= CONFIG_NFS_LOOKUP_NCACHE)
+        {
+          nmp->nm_nextlookup = 0;
+        }
+
+      if (nl->nl_relpath != NULL)
+        {
+          kmm_free(nl->nl_relpath);
+        }
+
+      /* If the path cannot be duplicated, the lookup is just not cached */
+
+      nl->nl_relpath = strdup(relpath);
+      if (nl->nl_relpath == NULL)
+        {
+          return;
+        }
+    }
+
+  nl->nl_stamp = clock_systime_ticks();
+  memcpy(&nl->nl_fhandle, fhandle, sizeof(struct file_handle));
+  memcpy(&nl->nl_fattr, obj_attributes, sizeof(struct nfs_fattr));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,6 +228,28 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
   struct nfs_reply_header replyh;
   int error;
 
+  /* Any request that may modify the server invalidates cached lookups */
+
+  switch (procnum)
+    {
+      case NFSPROC_SETATTR:
+      case NFSPROC_WRITE:
+      case NFSPROC_CREATE:
+      case NFSPROC_MKDIR:
+      case NFSPROC_SYMLINK:
+      case NFSPROC_MKNOD:
+      case NFSPROC_REMOVE:
+      case NFSPROC_RMDIR:
+      case NFSPROC_RENAME:
+      case NFSPROC_LINK:
+      case NFSPROC_COMMIT:
+        nfs_lookup_flush(nmp);
+        break;
+
+      default:
+        break;
+    }
+
   error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
                           request, reqlen, response, resplen);
   if (error != 0)
@@ -323,6 +451,16 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
       return OK;
     }
 
+#if CONFIG_NFS_LOOKUP_NCACHE > 0
+  /* Only the object attributes are cached */
+
+  if (dir_attributes == NULL &&
+      nfs_lookup_find(nmp, relpath, fhandle, obj_attributes) == OK)
+    {
+      return OK;
+    }
+#endif
+
   /* This is not the root directory. Loop until the directory entry
    * corresponding to the path is found.
    */
@@ -364,6 +502,13 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
            * dir_attributes.
            */
 
+#if CONFIG_NFS_LOOKUP_NCACHE > 0
+          if (obj_attributes != NULL)
+            {
+              nfs_lookup_add(nmp, relpath, fhandle, obj_attributes);
+            }
+#endif
+
           return OK;
         }
 
@@ -507,3 +652,31 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_ctime, &ts);
   np->n_ctime  = ts.tv_sec;
 }
+
+/****************************************************************************
+ * Name: nfs_lookup_flush
+ *
+ * Description:
+ *   Forget all cached lookups.  This is called before every request that
+ *   may modify the server and when the file system is unmounted.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_LOOKUP_NCACHE > 0
+void nfs_lookup_flush(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_NCACHE; i++)
+    {
+      if (nmp->nm_lookup[i].nl_relpath != NULL)
+        {
+          kmm_free(nmp->nm_lookup[i].nl_relpath);
+          nmp->nm_lookup[i].nl_relpath = NULL;
+        }
+    }
+}
+#endif
@@ -119,6 +119,9 @@ static int     nfs_filetruncate(FAR struct nfsmount *nmp,
 static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
+static ssize_t nfs_fileread(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset, FAR void *buffer,
+                   size_t readsize, FAR bool *eof);
 
 static int     nfs_open(FAR struct file *filep, FAR const char *relpath,
                    int oflags, mode_t mode);
@@ -394,6 +397,12 @@ static int nfs_filetruncate(FAR struct nfsmount *nmp,
 
   finfo("Truncating file\n");
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* Discard any read-ahead data */
+
+  np->n_ralen = 0;
+#endif
+
   /* Create the SETATTR RPC call arguments */
 
   ptr    = (FAR uint32_t *)&nmp->nm_msgbuffer.setattr.setattr;
@@ -762,6 +771,13 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
+#ifdef CONFIG_NFS_READAHEAD
+              if (np->n_rabuf != NULL)
+                {
+                  kmm_free(np->n_rabuf);
+                }
+#endif
+
               kmm_free(np);
               ret = OK;
               break;
@@ -774,6 +790,135 @@ static int nfs_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nfs_fileread
+ *
+ * Description:
+ *   Perform one READ RPC of at most readsize bytes at offset into buffer.
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes read on success; a negated errno
+ *   value on failure.  *eof is set if the server reported the end of the
+ *   file.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_fileread(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, off_t offset,
+                            FAR void *buffer, size_t readsize,
+                            FAR bool *eof)
+{
+  FAR uint32_t *ptr;
+  ssize_t       tmp;
+  size_t        reqlen;
+  int           ret;
+
+  /* Make sure that the attempted read size does not exceed the RPC
+   * maximum
+   */
+
+  if (readsize > nmp->nm_rsize)
+    {
+      readsize = nmp->nm_rsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO buffer
+   * size
+   */
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(readsize);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the read */
+
+  finfo("Reading %d bytes\n", readsize);
+  nfs_statistics(NFSPROC_READ);
+  ret = nfs_request(nmp, NFSPROC_READ,
+                    (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
+                    (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The read was successful.  Get a pointer to the beginning of the NFS
+   * response data.
+   */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
+
+  ptr++;
+
+  /* Next comes an EOF indication. */
+
+  *eof = (*ptr++ != 0);
+
+  /* Then the length of the read data followed by the read data itself */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp > readsize)
+    {
+      return -EIO;
+    }
+
+  /* Copy the read data into the caller's buffer */
+
+  memcpy(buffer, ptr, tmp);
+  return tmp;
+}
+
 /****************************************************************************
  * Name: nfs_read
  *
@@ -788,11 +933,12 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
+#ifdef CONFIG_NFS_READAHEAD
   ssize_t                    readsize;
+#endif
   ssize_t                    tmp;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  bool                       eof;
   int                        ret = 0;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
@@ -829,118 +975,80 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
+#ifdef CONFIG_NFS_READAHEAD
+      /* Copy from the read-ahead buffer if it holds the file position */
 
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
+      if (np->n_ralen > 0 && filep->f_pos >= np->n_raoffset &&
+          filep->f_pos < np->n_raoffset + np->n_ralen)
         {
-          readsize = nmp->nm_rsize;
-        }
+          readsize = np->n_raoffset + np->n_ralen - filep->f_pos;
+          if (readsize > buflen - bytesread)
+            {
+              readsize = buflen - bytesread;
+            }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
+          memcpy(buffer, np->n_rabuf + (filep->f_pos - np->n_raoffset),
+                 readsize);
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
+          filep->f_pos += readsize;
+          bytesread    += readsize;
+          buffer       += readsize;
+          continue;
         }
 
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
+      /* A read smaller than one RPC fills the read-ahead buffer instead,
+       * so that the reads that follow need no RPC.
+       */
 
-      finfo("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                        (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
+      if (buflen - bytesread < nmp->nm_rsize)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_semaphore;
-        }
+          if (np->n_rabuf == NULL)
+            {
+              np->n_rabuf = (FAR uint8_t *)kmm_malloc(nmp->nm_rsize);
+            }
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
+          if (np->n_rabuf != NULL)
+            {
+              np->n_ralen = 0;
+              tmp = nfs_fileread(nmp, np, filep->f_pos, np->n_rabuf,
+                                 nmp->nm_rsize, &eof);
+              if (tmp <= 0)
+                {
+                  ret = tmp;
+                  break;
+                }
 
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+              np->n_raoffset = filep->f_pos;
+              np->n_ralen    = tmp;
+              continue;
+            }
+        }
+#endif
 
-      /* Check if attributes are included in the responses */
+      /* Read directly into the user buffer */
 
-      tmp = *ptr++;
-      if (tmp != 0)
+      tmp = nfs_fileread(nmp, np, filep->f_pos, buffer, buflen - bytesread,
+                         &eof);
+      if (tmp < 0)
         {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          ret = tmp;
+          break;
         }
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
       /* Update the read state data */
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
+      filep->f_pos += tmp;
+      bytesread    += tmp;
+      buffer       += tmp;
 
       /* Check if we hit the end of file */
 
-      if (tmp != 0)
+      if (eof || tmp == 0)
         {
           break;
         }
     }
 
-errout_with_semaphore:
   nfs_semgive(nmp);
   return bytesread > 0 ? bytesread : ret;
 }
@@ -996,6 +1104,12 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* Discard any read-ahead data */
+
+  np->n_ralen = 0;
+#endif
+
   /* Now loop until we send the entire user buffer */
 
   for (byteswritten = 0; byteswritten < buflen; )
@@ -2001,6 +2115,7 @@ static int nfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* And free any allocated resources */
 
+  nfs_lookup_flush(nmp);
   nxsem_destroy(&nmp->nm_sem);
   kmm_free(nmp->nm_rpcclnt);
   kmm_free(nmp);
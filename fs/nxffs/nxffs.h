@@ -236,6 +236,22 @@ struct nxffs_data_s
 };
 #define SIZEOF_NXFFS_DATA_HDR 10
 
+/* This structure defines the packed header of an inode index checkpoint on
+ * the FLASH media.  The header is followed by 'count' entries of the
+ * form {hash[4], hoffs[4]} and by a trailer of the form {ckptlen[2],
+ * magic[4]}, so that a checkpoint can be found from its end.
+ */
+
+struct nxffs_ckpt_s
+{
+  uint8_t                   magic[4];  /* 0-3: Magic number for checkpoint */
+  uint8_t                   count[2];  /* 4-5: Number of inode entries */
+  uint8_t                   crc[4];    /* 6-9: CRC32 */
+};
+#define SIZEOF_NXFFS_CKPT_HDR 10
+#define SIZEOF_NXFFS_CKPT_ENTRY 8
+#define SIZEOF_NXFFS_CKPT_TRAILER 6
+
 /* This is an in-memory representation of the NXFFS inode as extracted from
  * FLASH and with additional state information.
  */
@@ -305,7 +321,25 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  bool                      ivalid;    /* True: index describes all inodes */
+  FAR struct nxffs_ientry_s *index[CONFIG_NXFFS_INDEX_NBUCKETS];
+#endif
+};
+
+#ifdef CONFIG_NXFFS_INDEX
+/* One entry in the RAM inode index.  The index maps a hash of the file name
+ * to the FLASH offset of the inode header so that a lookup only has to read
+ * the inode headers of files whose name hashes to the same value.
+ */
+
+struct nxffs_ientry_s
+{
+  FAR struct nxffs_ientry_s *flink;    /* Next entry in the hash chain */
+  uint32_t                  hash;      /* Hash of the inode name */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
 };
+#endif
 
 /* This structure describes the state of the blocks on the NXFFS volume */
 
@@ -1086,6 +1120,148 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_index_reset
+ *
+ * Description:
+ *   Discard the RAM inode index.  The index will be rebuilt by the next
+ *   inode lookup.  This must be called whenever inode headers are moved on
+ *   FLASH (packing or reformatting).
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_reset(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_index_reset(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_add
+ *
+ * Description:
+ *   Add the inode header at 'hoffset' with name 'name' to the RAM inode
+ *   index.  If memory cannot be allocated, the index is discarded and
+ *   lookups fall back to scanning FLASH until it can be rebuilt.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   name    - The name of the inode.
+ *   hoffset - FLASH offset to the inode header.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_add(FAR struct nxffs_volume_s *volume,
+                     FAR const char *name, off_t hoffset);
+#else
+#  define nxffs_index_add(v,n,o)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_remove
+ *
+ * Description:
+ *   Remove the inode header at 'hoffset' from the RAM inode index.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume.
+ *   name    - The name of the inode.
+ *   hoffset - FLASH offset to the inode header.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume,
+                        FAR const char *name, off_t hoffset);
+#else
+#  define nxffs_index_remove(v,n,o)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_find
+ *
+ * Description:
+ *   Use the RAM inode index to find the inode with the provided name.  The
+ *   index is (re-)built first if it is not valid.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  -ENOENT is returned if the index shows
+ *   that there is no such inode.  Any other negated errno value means that
+ *   the index could not be used and the caller must scan FLASH.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_index_find(FAR struct nxffs_volume_s *volume,
+                     FAR const char *name, FAR struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_load
+ *
+ * Description:
+ *   Load the inode index checkpoint that was written at the end of the
+ *   used FLASH region and use it in place of the inode walk done by
+ *   nxffs_limits().  The checkpoint is accepted only if no inode was
+ *   written after it.  On success, the RAM inode index, inoffset and
+ *   froffset are all valid.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  Otherwise, a negated errno value is
+ *   returned and the caller must recover the limits with nxffs_limits().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_index_load(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_index_load(v) (-ENOSYS)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_save
+ *
+ * Description:
+ *   Write the RAM inode index to FLASH at froffset so that the next
+ *   nxffs_index_load() can use it.  This is only an optimization:  the
+ *   checkpoint is silently skipped if the index is not valid, if it does
+ *   not fit in one block or if there is no free FLASH.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_save(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_index_save(v)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
@@ -0,0 +1,710 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+#include <crc32.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of a checkpoint with 'n' entries */
+
+#define NXFFS_CKPT_SIZE(n) \
+  (SIZEOF_NXFFS_CKPT_HDR + (n) * SIZEOF_NXFFS_CKPT_ENTRY + \
+   SIZEOF_NXFFS_CKPT_TRAILER)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The magic number that appears at the beginning and at the end of each
+ * inode index checkpoint.  The last byte must not be the erased state.
+ */
+
+static const uint8_t g_ckptmagic[NXFFS_MAGICSIZE] =
+{
+  'I', 'n', 'd', 'x'
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_index_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of an inode name.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_index_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_insert
+ *
+ * Description:
+ *   Insert one entry with the name hash 'hash' in the hash chain.  Returns
+ *   false if no memory is available.
+ *
+ ****************************************************************************/
+
+static bool nxffs_index_insert(FAR struct nxffs_volume_s *volume,
+                               uint32_t hash, off_t hoffset)
+{
+  FAR struct nxffs_ientry_s *ientry;
+  int bucket = hash % CONFIG_NXFFS_INDEX_NBUCKETS;
+
+  ientry = (FAR struct nxffs_ientry_s *)
+    kmm_malloc(sizeof(struct nxffs_ientry_s));
+  if (ientry == NULL)
+    {
+      return false;
+    }
+
+  ientry->hash          = hash;
+  ientry->hoffset       = hoffset;
+  ientry->flink         = volume->index[bucket];
+  volume->index[bucket] = ientry;
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_build
+ *
+ * Description:
+ *   Walk all inodes on FLASH and record them in the index.
+ *
+ ****************************************************************************/
+
+static int nxffs_index_build(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  nxffs_index_reset(volume);
+
+  offset = volume->inoffset;
+  while ((ret = nxffs_nextentry(volume, offset, &entry)) == OK)
+    {
+      bool ok = nxffs_index_insert(volume, nxffs_index_hash(entry.name),
+                                   entry.hoffset);
+
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+
+      if (!ok)
+        {
+          nxffs_index_reset(volume);
+          return -ENOMEM;
+        }
+    }
+
+  /* -ENOENT simply means that the end of the inodes was reached */
+
+  if (ret != -ENOENT)
+    {
+      nxffs_index_reset(volume);
+      return ret;
+    }
+
+  volume->ivalid = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_crc
+ *
+ * Description:
+ *   Return the CRC of the checkpoint at 'ckpt' of length 'ckptlen'.  The
+ *   CRC field itself is not included.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_index_crc(FAR const uint8_t *ckpt, size_t ckptlen)
+{
+  uint32_t crc;
+
+  crc = crc32(ckpt, SIZEOF_NXFFS_CKPT_HDR - 4);
+  return crc32part(&ckpt[SIZEOF_NXFFS_CKPT_HDR],
+                   ckptlen - SIZEOF_NXFFS_CKPT_HDR, crc);
+}
+
+/****************************************************************************
+ * Name: nxffs_index_lastblock
+ *
+ * Description:
+ *   Find the last valid block that holds any data after its block header.
+ *   Data is only ever appended, so a binary search over the blocks finds it
+ *   with a few block reads instead of a walk over all of the inodes.
+ *
+ ****************************************************************************/
+
+static int nxffs_index_lastblock(FAR struct nxffs_volume_s *volume,
+                                 FAR off_t *lastblock)
+{
+  size_t datlen = volume->geo.blocksize - SIZEOF_NXFFS_BLOCK_HDR;
+  off_t found = -1;
+  off_t lower = 0;
+  off_t upper = volume->nblocks - 1;
+  off_t middle;
+  off_t block;
+
+  while (lower <= upper)
+    {
+      /* Find the first valid block at or after the middle of the range */
+
+      middle = lower + (upper - lower) / 2;
+      for (block = middle; block <= upper; block++)
+        {
+          if (nxffs_verifyblock(volume, block) == OK)
+            {
+              break;
+            }
+        }
+
+      if (block <= upper &&
+          nxffs_erased(&volume->cache[SIZEOF_NXFFS_BLOCK_HDR],
+                       datlen) < datlen)
+        {
+          found = block;
+          lower = block + 1;
+        }
+      else
+        {
+          upper = middle - 1;
+        }
+    }
+
+  if (found < 0)
+    {
+      return -ENOENT;
+    }
+
+  *lastblock = found;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_parse
+ *
+ * Description:
+ *   Check for a checkpoint at the very end of the data in the last used
+ *   block and load its entries into the RAM inode index.  On success, the
+ *   FLASH offsets to the beginning and to the end of the checkpoint are
+ *   returned.
+ *
+ ****************************************************************************/
+
+static int nxffs_index_parse(FAR struct nxffs_volume_s *volume,
+                             FAR off_t *start, FAR off_t *end)
+{
+  FAR const uint8_t *ckpt;
+  FAR const uint8_t *trailer;
+  FAR const uint8_t *ientry;
+  off_t blkoffset;
+  off_t hoffset;
+  off_t block;
+  size_t ckptlen;
+  size_t dend;
+  size_t count;
+  size_t i;
+  int ret;
+
+  ret = nxffs_index_lastblock(volume, &block);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxffs_rdcache(volume, block);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Find the end of the data in the block */
+
+  for (dend = volume->geo.blocksize;
+       dend > SIZEOF_NXFFS_BLOCK_HDR &&
+       volume->cache[dend - 1] == CONFIG_NXFFS_ERASEDSTATE;
+       dend--);
+
+  if (dend < SIZEOF_NXFFS_BLOCK_HDR + NXFFS_CKPT_SIZE(0))
+    {
+      return -ENOENT;
+    }
+
+  /* The last thing written must be the trailer of a checkpoint */
+
+  trailer = &volume->cache[dend - SIZEOF_NXFFS_CKPT_TRAILER];
+  if (memcmp(&trailer[2], g_ckptmagic, NXFFS_MAGICSIZE) != 0)
+    {
+      return -ENOENT;
+    }
+
+  ckptlen = nxffs_rdle16(trailer);
+  if (ckptlen < NXFFS_CKPT_SIZE(0) ||
+      ckptlen > dend - SIZEOF_NXFFS_BLOCK_HDR)
+    {
+      return -EINVAL;
+    }
+
+  ckpt  = &volume->cache[dend - ckptlen];
+  count = nxffs_rdle16(&ckpt[4]);
+  if (memcmp(ckpt, g_ckptmagic, NXFFS_MAGICSIZE) != 0 ||
+      NXFFS_CKPT_SIZE(count) != ckptlen ||
+      nxffs_rdle32(&ckpt[6]) != nxffs_index_crc(ckpt, ckptlen))
+    {
+      ferr("ERROR: Bad checkpoint in block %jd\n", (intmax_t)block);
+      return -EINVAL;
+    }
+
+  /* Every inode recorded must lie before the checkpoint */
+
+  blkoffset = block * volume->geo.blocksize;
+  *start    = blkoffset + dend - ckptlen;
+  *end      = blkoffset + dend;
+
+  nxffs_index_reset(volume);
+  ientry = &ckpt[SIZEOF_NXFFS_CKPT_HDR];
+  for (i = 0; i < count; i++, ientry += SIZEOF_NXFFS_CKPT_ENTRY)
+    {
+      hoffset = nxffs_rdle32(&ientry[4]);
+      if (hoffset >= *start)
+        {
+          nxffs_index_reset(volume);
+          return -EINVAL;
+        }
+
+      if (!nxffs_index_insert(volume, nxffs_rdle32(ientry), hoffset))
+        {
+          nxffs_index_reset(volume);
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_contains
+ *
+ * Description:
+ *   Return true if the index holds the inode described by 'entry'.
+ *
+ ****************************************************************************/
+
+static bool nxffs_index_contains(FAR struct nxffs_volume_s *volume,
+                                 FAR struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_ientry_s *ientry;
+  uint32_t hash = nxffs_index_hash(entry->name);
+
+  for (ientry = volume->index[hash % CONFIG_NXFFS_INDEX_NBUCKETS];
+       ientry;
+       ientry = ientry->flink)
+    {
+      if (ientry->hash == hash && ientry->hoffset == entry->hoffset)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_index_reset
+ ****************************************************************************/
+
+void nxffs_index_reset(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_ientry_s *ientry;
+  int i;
+
+  for (i = 0; i < CONFIG_NXFFS_INDEX_NBUCKETS; i++)
+    {
+      while ((ientry = volume->index[i]) != NULL)
+        {
+          volume->index[i] = ientry->flink;
+          kmm_free(ientry);
+        }
+    }
+
+  volume->ivalid = false;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_add
+ ****************************************************************************/
+
+void nxffs_index_add(FAR struct nxffs_volume_s *volume,
+                     FAR const char *name, off_t hoffset)
+{
+  /* Nothing to do if the index will be rebuilt anyway */
+
+  if (volume->ivalid &&
+      !nxffs_index_insert(volume, nxffs_index_hash(name), hoffset))
+    {
+      nxffs_index_reset(volume);
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_index_remove
+ ****************************************************************************/
+
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume,
+                        FAR const char *name, off_t hoffset)
+{
+  FAR struct nxffs_ientry_s *ientry;
+  FAR struct nxffs_ientry_s *prev = NULL;
+  int bucket;
+
+  if (!volume->ivalid)
+    {
+      return;
+    }
+
+  bucket = nxffs_index_hash(name) % CONFIG_NXFFS_INDEX_NBUCKETS;
+  for (ientry = volume->index[bucket]; ientry; ientry = ientry->flink)
+    {
+      if (ientry->hoffset == hoffset)
+        {
+          if (prev)
+            {
+              prev->flink = ientry->flink;
+            }
+          else
+            {
+              volume->index[bucket] = ientry->flink;
+            }
+
+          kmm_free(ientry);
+          return;
+        }
+
+      prev = ientry;
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_index_find
+ ****************************************************************************/
+
+int nxffs_index_find(FAR struct nxffs_volume_s *volume,
+                     FAR const char *name, FAR struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_ientry_s *ientry;
+  uint32_t hash;
+  int ret;
+
+  if (!volume->ivalid)
+    {
+      ret = nxffs_index_build(volume);
+      if (ret < 0)
+        {
+          /* Don't report -ENOENT here; that would mean "no such file" */
+
+          return ret == -ENOENT ? -EIO : ret;
+        }
+    }
+
+  hash = nxffs_index_hash(name);
+  for (ientry = volume->index[hash % CONFIG_NXFFS_INDEX_NBUCKETS];
+       ientry;
+       ientry = ientry->flink)
+    {
+      if (ientry->hash != hash)
+        {
+          continue;
+        }
+
+      /* Verify the candidate on FLASH.  nxffs_nextentry() returns the
+       * inode at hoffset if it is still valid, otherwise some later inode.
+       */
+
+      ret = nxffs_nextentry(volume, ientry->hoffset, entry);
+      if (ret == OK && entry->hoffset == ientry->hoffset &&
+          nxffs_index_hash(entry->name) == hash)
+        {
+          if (strcmp(name, entry->name) == 0)
+            {
+              return OK;
+            }
+
+          /* A hash collision with a different file */
+
+          nxffs_freeentry(entry);
+          continue;
+        }
+
+      if (ret == OK)
+        {
+          nxffs_freeentry(entry);
+        }
+
+      /* The index is out of step with FLASH; drop it and let the caller
+       * scan.  The next lookup will rebuild it.
+       */
+
+      ferr("ERROR: Stale index entry at %jd\n", (intmax_t)ientry->hoffset);
+      nxffs_index_reset(volume);
+      return -ESTALE;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_load
+ ****************************************************************************/
+
+int nxffs_index_load(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t start;
+  off_t end;
+  off_t block;
+  int ret;
+
+  ret = nxffs_index_parse(volume, &start, &end);
+  if (ret < 0)
+    {
+      finfo("No usable checkpoint: %d\n", ret);
+      return ret;
+    }
+
+  /* The checkpoint is current only if no inode was written after it.  This
+   * is the same search that ends the inode walk in nxffs_limits().
+   */
+
+  ret = nxffs_nextentry(volume, end, &entry);
+  if (ret == OK)
+    {
+      finfo("Checkpoint at %jd is out of date\n", (intmax_t)start);
+      nxffs_freeentry(&entry);
+      ret = -ESTALE;
+      goto errout;
+    }
+
+  /* Find the first valid inode the same way that nxffs_limits() does.  It
+   * must be one of the inodes in the checkpoint.  Inodes deleted since the
+   * checkpoint was written are skipped here and are dropped from the index
+   * by the first lookup that finds them.
+   */
+
+  block = 0;
+  ret = nxffs_validblock(volume, &block);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = nxffs_nextentry(volume, block * volume->geo.blocksize, &entry);
+  if (ret == OK)
+    {
+      bool found = entry.hoffset < start &&
+                   nxffs_index_contains(volume, &entry);
+
+      volume->inoffset = entry.hoffset;
+      nxffs_freeentry(&entry);
+
+      if (!found)
+        {
+          ferr("ERROR: Checkpoint does not match the inodes\n");
+          ret = -ESTALE;
+          goto errout;
+        }
+    }
+  else if (ret == -ENOENT)
+    {
+      volume->inoffset = end;
+    }
+  else
+    {
+      goto errout;
+    }
+
+  volume->froffset = end;
+  volume->ivalid   = true;
+
+  finfo("Checkpoint at %jd: inoffset %jd froffset %jd\n",
+        (intmax_t)start, (intmax_t)volume->inoffset,
+        (intmax_t)volume->froffset);
+  return OK;
+
+errout:
+  nxffs_index_reset(volume);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_save
+ ****************************************************************************/
+
+void nxffs_index_save(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_ientry_s *ientry;
+  FAR uint8_t *ckpt;
+  FAR uint8_t *dest;
+  off_t froffset;
+  off_t offset;
+  size_t ckptlen;
+  size_t count;
+  int ret;
+  int i;
+
+  if (!volume->ivalid)
+    {
+      return;
+    }
+
+  count = 0;
+  for (i = 0; i < CONFIG_NXFFS_INDEX_NBUCKETS; i++)
+    {
+      for (ientry = volume->index[i]; ientry; ientry = ientry->flink)
+        {
+          count++;
+        }
+    }
+
+  ckptlen = NXFFS_CKPT_SIZE(count);
+  if (ckptlen > volume->geo.blocksize - SIZEOF_NXFFS_BLOCK_HDR ||
+      ckptlen > UINT16_MAX)
+    {
+      finfo("Too many inodes for a checkpoint: %lu\n",
+            (unsigned long)count);
+      return;
+    }
+
+  /* An inode walk stops at NXFFS_NERASED erased bytes.  The checkpoint
+   * must not leave such a gap in front of itself, or later inodes would
+   * no longer be found by nxffs_limits().  So use the current block if it
+   * has room and only move to the next one if little would be skipped.
+   */
+
+  froffset = volume->froffset;
+  nxffs_ioseek(volume, froffset);
+  if (volume->iooffset < SIZEOF_NXFFS_BLOCK_HDR)
+    {
+      volume->iooffset = SIZEOF_NXFFS_BLOCK_HDR;
+    }
+
+  if (volume->iooffset + ckptlen > volume->geo.blocksize &&
+      volume->geo.blocksize - volume->iooffset >= NXFFS_NERASED)
+    {
+      finfo("No room for a checkpoint in block %jd\n",
+            (intmax_t)volume->ioblock);
+      return;
+    }
+
+  ret = nxffs_wrreserve(volume, ckptlen);
+  if (ret < 0)
+    {
+      finfo("No space for a checkpoint: %d\n", ret);
+      volume->froffset = froffset;
+      return;
+    }
+
+  offset = nxffs_iotell(volume);
+  ret = nxffs_wrverify(volume, ckptlen);
+  if (ret < 0 || nxffs_iotell(volume) != offset)
+    {
+      /* The reserved memory was not erased.  Give up rather than leave a
+       * gap; the next allocation will skip the bad memory.
+       */
+
+      finfo("No erased memory for a checkpoint at %jd\n",
+            (intmax_t)offset);
+      volume->froffset = froffset;
+      return;
+    }
+
+  /* nxffs_wrverify() left the block in the cache.  Build the checkpoint
+   * there and write the block.
+   */
+
+  ckpt = &volume->cache[volume->iooffset];
+  memcpy(ckpt, g_ckptmagic, NXFFS_MAGICSIZE);
+  nxffs_wrle16(&ckpt[4], count);
+
+  dest = &ckpt[SIZEOF_NXFFS_CKPT_HDR];
+  for (i = 0; i < CONFIG_NXFFS_INDEX_NBUCKETS; i++)
+    {
+      for (ientry = volume->index[i]; ientry; ientry = ientry->flink)
+        {
+          nxffs_wrle32(dest, ientry->hash);
+          nxffs_wrle32(&dest[4], ientry->hoffset);
+          dest += SIZEOF_NXFFS_CKPT_ENTRY;
+        }
+    }
+
+  nxffs_wrle16(dest, ckptlen);
+  memcpy(&dest[2], g_ckptmagic, NXFFS_MAGICSIZE);
+  nxffs_wrle32(&ckpt[6], nxffs_index_crc(ckpt, ckptlen));
+
+  ret = nxffs_wrcache(volume);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to write checkpoint at %jd: %d\n",
+           (intmax_t)offset, -ret);
+    }
+
+  /* froffset stays past the checkpoint even if the write failed */
+
+  finfo("Checkpoint of %lu inodes at %jd\n",
+        (unsigned long)count, (intmax_t)offset);
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
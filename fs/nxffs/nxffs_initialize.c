@@ -273,11 +273,21 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
     }
 #endif /* CONFIG_NXFFS_SCAN_VOLUME */
 
-  /* Get the file system limits */
+  /* Use the inode index checkpoint, if there is a current one.  Otherwise,
+   * get the file system limits by walking the inodes and write a new
+   * checkpoint for the next time.
+   */
+
+  ret = nxffs_index_load(volume);
+  if (ret == OK)
+    {
+      return OK;
+    }
 
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+      nxffs_index_save(volume);
       return OK;
     }
 
@@ -307,6 +317,7 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+      nxffs_index_save(volume);
       return OK;
     }
 
@@ -315,6 +326,7 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ferr("ERROR: Failed to calculate file system limits: %d\n", -ret);
 
 errout_with_buffer:
+  nxffs_index_reset(volume);
   kmm_free(volume->pack);
 errout_with_cache:
   kmm_free(volume->cache);
@@ -369,6 +381,15 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+  /* The walk below visits every inode, so use it to populate the RAM
+   * inode index as well.
+   */
+
+  nxffs_index_reset(volume);
+#ifdef CONFIG_NXFFS_INDEX
+  volume->ivalid = true;
+#endif
+
   /* Then find the first valid inode in or beyond the first valid block */
 
   offset = block * volume->geo.blocksize;
@@ -404,6 +425,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
 
       /* Discard this entry and set the next offset. */
 
+      nxffs_index_add(volume, entry.name, entry.hoffset);
       offset = nxffs_inodeend(volume, &entry);
       nxffs_freeentry(&entry);
     }
@@ -416,6 +438,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
         {
           /* Discard the entry and guess the next offset. */
 
+          nxffs_index_add(volume, entry.name, entry.hoffset);
           offset = nxffs_inodeend(volume, &entry);
           nxffs_freeentry(&entry);
         }
@@ -378,6 +378,18 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Try the RAM inode index first.  Its answer is authoritative unless it
+   * could not be used, in which case fall back to scanning FLASH.
+   */
+
+  ret = nxffs_index_find(volume, name, entry);
+  if (ret == OK || ret == -ENOENT)
+    {
+      return ret;
+    }
+#endif
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
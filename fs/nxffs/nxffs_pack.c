@@ -1283,6 +1283,10 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   wrfile = NULL;
   packed = false;
 
+  /* Packing moves inode headers; the RAM index is rebuilt on next lookup */
+
+  nxffs_index_reset(volume);
+
   iooffset = nxffs_mediacheck(volume, &pack);
   if (iooffset == 0)
     {
@@ -283,6 +283,7 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
 
   /* Erase and reformat the entire volume */
 
+  nxffs_index_reset(volume);
   ret = nxffs_format(volume);
   if (ret < 0)
     {
@@ -66,8 +66,19 @@ extern const struct procfs_operations irq_operations;
 extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations critmon_operations;
 extern const struct procfs_operations meminfo_operations;
+extern const struct procfs_operations heaptrace_operations;
+extern const struct procfs_operations slabinfo_operations;
+extern const struct procfs_operations paging_operations;
+extern const struct procfs_operations stackmon_operations;
+extern const struct procfs_operations pm_operations;
+extern const struct procfs_operations initsteps_operations;
 extern const struct procfs_operations iobinfo_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations spans_operations;
+extern const struct procfs_operations bench_operations;
+extern const struct procfs_operations fsbench_operations;
+extern const struct procfs_operations membench_operations;
+extern const struct procfs_operations mmbench_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
 
@@ -79,9 +90,11 @@ extern const struct procfs_operations version_operations;
 
 extern const struct procfs_operations net_procfsoperations;
 extern const struct procfs_operations net_procfs_routeoperations;
+extern const struct procfs_operations net_procfs_benchoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations mount_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
+extern const struct procfs_operations spiffs_procfsoperations;
 
 /****************************************************************************
  * Private Types
@@ -116,6 +129,32 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "meminfo",       &meminfo_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_TRACE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAPTRACE)
+  { "heaptrace",     &heaptrace_operations,       PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_SLAB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SLABINFO)
+  { "slabinfo",      &slabinfo_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_PAGING) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGING)
+  { "paging",        &paging_operations,          PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_SCHED_INITSTEPS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_INITSTEPS)
+  { "initsteps",     &initsteps_operations,       PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_STACK_MONITOR) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_STACKMON)
+  { "stackmon",      &stackmon_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_PM_RESIDENCY) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PM)
+  { "pm",            &pm_operations,              PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",       &iobinfo_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -124,6 +163,26 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "modules",       &module_operations,          PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_SPANS
+  { "spans",         &spans_operations,           PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SCHED_BENCHMARK
+  { "bench",         &bench_operations,           PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_FS_BENCHMARK
+  { "fsbench",       &fsbench_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_MEMCPY_BENCHMARK
+  { "membench",      &membench_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_MM_BENCHMARK
+  { "mmbench",       &mmbench_operations,         PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",     &mount_procfsoperations,     PROCFS_FILE_TYPE   },
 #endif
@@ -140,6 +199,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/smartfs**",  &smartfs_procfsoperations,   PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifdef CONFIG_SPIFFS_PROCFS
+  { "fs/spiffs",     &spiffs_procfsoperations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_NET) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
   { "net",           &net_procfsoperations,       PROCFS_DIR_TYPE    },
 #if defined(CONFIG_NET_ROUTE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_ROUTE)
@@ -149,6 +212,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "net/**",        &net_procfsoperations,       PROCFS_UNKOWN_TYPE },
 #endif
 
+#if defined(CONFIG_NET_LOOPBACK_BENCHMARK) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+  { "netbench",      &net_procfs_benchoperations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MTD_PARTITION) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PARTITIONS)
   { "partitions",    &part_procfsoperations,      PROCFS_FILE_TYPE   },
 #endif
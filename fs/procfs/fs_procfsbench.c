@@ -0,0 +1,347 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched_bench.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_BENCHMARK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BENCH_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct bench_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  int result;                   /* Result of sched_bench_run() */
+  struct sched_bench_s tests[SCHED_BENCH_NTESTS];
+  char line[BENCH_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     bench_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     bench_close(FAR struct file *filep);
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     bench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     bench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations bench_operations =
+{
+  bench_open,         /* open */
+  bench_close,        /* close */
+  bench_read,         /* read */
+  NULL,               /* write */
+
+  bench_dup,          /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  bench_stat          /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_open
+ *
+ * Description:
+ *   Run the benchmarks.  The results are kept with the open file, so that
+ *   one run can be read in as many pieces as needed.
+ *
+ ****************************************************************************/
+
+static int bench_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct bench_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "bench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "bench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct bench_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  attr->result = sched_bench_run(attr->tests);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_close
+ ****************************************************************************/
+
+static int bench_close(FAR struct file *filep)
+{
+  FAR struct bench_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_nsec
+ *
+ * Description:
+ *   Convert an elapsed time in up_critmon_gettime() units to nanoseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long bench_nsec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  if (elapsed == 0)
+    {
+      return 0;
+    }
+
+  up_critmon_convert(elapsed, &ts);
+  return (unsigned long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: bench_read
+ *
+ * Description:
+ *   Generate one line for each measurement with the number of samples and
+ *   the minimum, maximum and average in nanoseconds, or the error that
+ *   prevented the measurement in place of the count.
+ *
+ ****************************************************************************/
+
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct bench_file_s *attr;
+  FAR struct sched_bench_s *test;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  uint32_t avg;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (attr->result < 0)
+    {
+      return attr->result;
+    }
+
+  offset = filep->f_pos;
+
+  /* Generate the header line */
+
+  linesize  = snprintf(attr->line, BENCH_LINELEN,
+                       "%-10s %10s %10s %10s %10s\n",
+                       "TEST", "COUNT", "MIN", "MAX", "AVG");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (i = 0; i < SCHED_BENCH_NTESTS && totalsize < buflen; i++)
+    {
+      test = &attr->tests[i];
+      if (test->sb_result < 0)
+        {
+          linesize = snprintf(attr->line, BENCH_LINELEN,
+                              "%-10s %10d\n", test->sb_name,
+                              test->sb_result);
+        }
+      else
+        {
+          avg = test->sb_count > 0 ?
+                (uint32_t)(test->sb_total / test->sb_count) : 0;
+
+          linesize = snprintf(attr->line, BENCH_LINELEN,
+                              "%-10s %10lu %10lu %10lu %10lu\n",
+                              test->sb_name,
+                              (unsigned long)test->sb_count,
+                              bench_nsec(test->sb_min),
+                              bench_nsec(test->sb_max),
+                              bench_nsec(avg));
+        }
+
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: bench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct bench_file_s *oldattr;
+  FAR struct bench_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct bench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct bench_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct bench_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "bench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "bench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "bench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_BENCHMARK */
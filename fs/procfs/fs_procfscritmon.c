@@ -54,6 +54,7 @@
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -95,6 +96,8 @@ static int     critmon_open(FAR struct file *filep, FAR const char *relpath,
 static int     critmon_close(FAR struct file *filep);
 static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+static ssize_t critmon_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
 static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -113,7 +116,7 @@ const struct procfs_operations critmon_operations =
   critmon_open,       /* open */
   critmon_close,      /* close */
   critmon_read,       /* read */
-  NULL,               /* write */
+  critmon_write,      /* write */
 
   critmon_dup,        /* dup */
 
@@ -140,18 +143,6 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Open '%s'\n", relpath);
 
-  /* PROCFS is read-only.  Any attempt to open with any kind of write
-   * access is not permitted.
-   *
-   * REVISIT:  Write-able proc files could be quite useful.
-   */
-
-  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
-    {
-      ferr("ERROR: Only O_RDONLY supported\n");
-      return -EACCES;
-    }
-
   /* "critmon" is the only acceptable value for the relpath */
 
   if (strcmp(relpath, "critmon") != 0)
@@ -195,6 +186,62 @@ static int critmon_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: critmon_read_hist
+ *
+ * Description:
+ *   Generate one line for each non-empty bucket of a histogram:  The CPU,
+ *   the name of the histogram, the upper bound of the bucket in seconds,
+ *   and the number of times that fell in the bucket.
+ *
+ ****************************************************************************/
+
+static ssize_t critmon_read_hist(FAR struct critmon_file_s *attr,
+                                 FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset, int cpu,
+                                 FAR const char *name,
+                                 FAR const uint32_t *hist)
+{
+  struct timespec bound;
+  size_t linesize;
+  size_t totalsize;
+  uint32_t elapsed;
+  int i;
+
+  totalsize = 0;
+
+  for (i = 0; i < CRITMON_NBUCKETS && totalsize < buflen; i++)
+    {
+      if (hist[i] == 0)
+        {
+          continue;
+        }
+
+      /* Bucket i holds the times below 2^i */
+
+      elapsed = i < 32 ? (UINT32_C(1) << i) - 1 : UINT32_MAX;
+      if (elapsed > 0)
+        {
+          up_critmon_convert(elapsed, &bound);
+        }
+      else
+        {
+          bound.tv_sec  = 0;
+          bound.tv_nsec = 0;
+        }
+
+      linesize   = snprintf(attr->line, CRITMON_LINELEN,
+                            "%d,%s,%lu.%09lu,%lu\n",
+                            cpu, name, (unsigned long)bound.tv_sec,
+                            (unsigned long)bound.tv_nsec,
+                            (unsigned long)hist[i]);
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, offset);
+    }
+
+  return totalsize;
+}
+
 /****************************************************************************
  * Name: critmon_read_cpu
  ****************************************************************************/
@@ -265,8 +312,30 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   linesize = snprintf(attr->line, CRITMON_LINELEN, "%lu.%09lu\n",
                      (unsigned long)maxtime.tv_sec,
                      (unsigned long)maxtime.tv_nsec);
-  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+  copysize = procfs_memcpy(attr->line, linesize, buffer, remaining, offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  /* Generate output for the histograms.  These accumulate until they are
+   * reset by writing to the file.
+   */
+
+  copysize   = critmon_read_hist(attr, buffer, remaining, offset,
+                                 cpu, "premp", g_premp_hist[cpu]);
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
 
+  copysize   = critmon_read_hist(attr, buffer, remaining, offset,
+                                 cpu, "crit", g_crit_hist[cpu]);
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  copysize   = critmon_read_hist(attr, buffer, remaining, offset,
+                                 cpu, "wakeup", g_wakeup_hist[cpu]);
   totalsize += copysize;
   return totalsize;
 }
@@ -303,13 +372,13 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
       ssize_t nbytes = critmon_read_cpu(attr, buffer + ret, buflen - ret,
                                         &offset, cpu);
 
+      /* critmon_read_cpu() has already consumed the offset */
+
       ret += nbytes;
-      if (ret > buflen)
+      if (ret >= buflen)
         {
           break;
         }
-
-      offset += nbytes;
     }
 
 #else
@@ -326,6 +395,32 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: critmon_write
+ *
+ * Description:
+ *   Any write to /proc/critmon resets the global maxima and histograms.
+ *
+ ****************************************************************************/
+
+static ssize_t critmon_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  irqstate_t flags;
+
+  /* The statistics are only updated within a critical section */
+
+  flags = enter_critical_section();
+  memset(g_premp_max, 0, sizeof(g_premp_max));
+  memset(g_crit_max, 0, sizeof(g_crit_max));
+  memset(g_premp_hist, 0, sizeof(g_premp_hist));
+  memset(g_crit_hist, 0, sizeof(g_crit_hist));
+  memset(g_wakeup_hist, 0, sizeof(g_wakeup_hist));
+  leave_critical_section(flags);
+
+  return buflen;
+}
+
 /****************************************************************************
  * Name: critmon_dup
  *
@@ -382,10 +477,10 @@ static int critmon_stat(const char *relpath, struct stat *buf)
       return -ENOENT;
     }
 
-  /* "critmon" is the name for a read-only file */
+  /* "critmon" is the name for a file that may be written to reset it */
 
   memset(buf, 0, sizeof(struct stat));
-  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
   return OK;
 }
 
@@ -0,0 +1,1058 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsfsbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/drivers/ramdisk.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/nxffs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mtd/mtd.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_FS_BENCHMARK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#if !defined(CONFIG_FS_SMARTFS) || !defined(CONFIG_MTD_SMART)
+#  undef CONFIG_FS_BENCHMARK_SMARTFS
+#endif
+
+#if defined(CONFIG_FS_LITTLEFS) || defined(CONFIG_FS_SPIFFS)
+#  define FSBENCH_HAVE_MTDDRIVER 1
+#endif
+
+#if defined(CONFIG_RAMMTD) && (defined(FSBENCH_HAVE_MTDDRIVER) || \
+    defined(CONFIG_FS_BENCHMARK_SMARTFS))
+#  define FSBENCH_HAVE_MTD 1
+#else
+#  undef FSBENCH_HAVE_MTDDRIVER
+#  undef CONFIG_FS_BENCHMARK_SMARTFS
+#endif
+
+#ifndef CONFIG_RAMMTD
+#  undef CONFIG_FS_BENCHMARK_NXFFS
+#endif
+
+#if !defined(CONFIG_BCH) && !defined(FSBENCH_HAVE_MTD) && \
+    !defined(CONFIG_FS_BENCHMARK_NXFFS)
+#  error "No file system or block device to benchmark"
+#endif
+
+/* Paths used for the devices and the files under test */
+
+#define FSBENCH_MTDPATH      "/dev/fsbench"
+#define FSBENCH_MOUNTPT      CONFIG_FS_BENCHMARK_MOUNTPT
+#define FSBENCH_DATAPATH     CONFIG_FS_BENCHMARK_MOUNTPT "/data"
+#define FSBENCH_PATHLEN      64
+
+#define FSBENCH_STR(x)       #x
+#define FSBENCH_XSTR(x)      FSBENCH_STR(x)
+#define FSBENCH_SMARTPATH    "/dev/smart" \
+                             FSBENCH_XSTR(CONFIG_FS_BENCHMARK_SMART_MINOR)
+
+/* Number of I/O requests needed to transfer the whole test file, and the
+ * sector size of the RAM disk.
+ */
+
+#define FSBENCH_NIO          (CONFIG_FS_BENCHMARK_FILESIZE / \
+                              CONFIG_FS_BENCHMARK_IOSIZE)
+#define FSBENCH_SECTSIZE     512
+
+/* The measurements made for each file system */
+
+#define FSBENCH_MOUNT        0  /* Mount an empty volume (usec) */
+#define FSBENCH_SEQWRITE     1  /* Sequential write (KiB/s) */
+#define FSBENCH_SEQREAD      2  /* Sequential read (KiB/s) */
+#define FSBENCH_RANDWRITE    3  /* Random write (KiB/s) */
+#define FSBENCH_RANDREAD     4  /* Random read (KiB/s) */
+#define FSBENCH_CREATE       5  /* Create one empty file (usec) */
+#define FSBENCH_READDIR      6  /* Read one directory entry (usec) */
+#define FSBENCH_REMOUNT      7  /* Mount a populated volume (usec) */
+#define FSBENCH_UNLINK       8  /* Unlink one file (usec) */
+#define FSBENCH_NTESTS       9
+
+#define FSBENCH_NFS          (sizeof(g_fsbench_fs) / sizeof(g_fsbench_fs[0]))
+
+/* Size of the open file structure, with one result per file system */
+
+#define SIZEOF_FSBENCH_FILE_S(n) \
+  (sizeof(struct fsbench_file_s) + \
+   ((n) - 1) * sizeof(struct fsbench_result_s))
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define FSBENCH_LINELEN      128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one file system under test */
+
+struct fsbench_fs_s
+{
+  FAR const char *name;         /* Name shown in the output */
+  FAR const char *fstype;       /* File system type, NULL for raw block */
+  FAR const char *source;       /* Device to mount */
+  CODE int (*format)(void);     /* Return the device to an empty state */
+};
+
+/* This structure holds the results for one file system.  Each value is
+ * either the measurement or, if the measurement failed, a negated errno.
+ */
+
+struct fsbench_result_s
+{
+  int32_t value[FSBENCH_NTESTS];
+};
+
+/* This structure describes one open "file" */
+
+struct fsbench_file_s
+{
+  struct procfs_file_s base;     /* Base open file structure */
+  int result;                    /* Result of fsbench_run() */
+  char line[FSBENCH_LINELEN];    /* Buffer for formatted lines */
+  struct fsbench_result_s fs[1]; /* One per file system, must be last */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_LITTLEFS
+static int     fsbench_format_littlefs(void);
+#endif
+#ifdef CONFIG_FS_SPIFFS
+static int     fsbench_format_spiffs(void);
+#endif
+#ifdef CONFIG_FS_BENCHMARK_SMARTFS
+static int     fsbench_format_smartfs(void);
+#endif
+#ifdef CONFIG_FS_BENCHMARK_NXFFS
+static int     fsbench_format_nxffs(void);
+#endif
+
+/* File system methods */
+
+static int     fsbench_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     fsbench_close(FAR struct file *filep);
+static ssize_t fsbench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     fsbench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     fsbench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The file systems under test.  The RAM disk entry measures the block
+ * layer (the BCH character driver over the RAM disk) without any file
+ * system on top.
+ */
+
+static const struct fsbench_fs_s g_fsbench_fs[] =
+{
+#ifdef CONFIG_BCH
+  { "ramdisk",  NULL,       NULL,            NULL                    },
+#endif
+#ifdef CONFIG_FS_LITTLEFS
+  { "littlefs", "littlefs", FSBENCH_MTDPATH, fsbench_format_littlefs },
+#endif
+#ifdef CONFIG_FS_SPIFFS
+  { "spiffs",   "spiffs",   FSBENCH_MTDPATH, fsbench_format_spiffs   },
+#endif
+#ifdef CONFIG_FS_BENCHMARK_SMARTFS
+  { "smartfs",  "smartfs",  FSBENCH_SMARTPATH, fsbench_format_smartfs },
+#endif
+#ifdef CONFIG_FS_BENCHMARK_NXFFS
+  { "nxffs",    "nxffs",    NULL,            fsbench_format_nxffs    },
+#endif
+};
+
+static FAR const char * const g_fsbench_names[FSBENCH_NTESTS] =
+{
+  "MOUNT", "SEQWR", "SEQRD", "RNDWR", "RNDRD",
+  "CREATE", "READDIR", "REMOUNT", "UNLINK"
+};
+
+/* Only one benchmark may run at a time */
+
+static sem_t g_fsbench_sem = SEM_INITIALIZER(1);
+
+/* The RAM MTD devices cannot be torn down again, so they are created by
+ * the first run and then reused by all of the following ones.
+ */
+
+#ifdef FSBENCH_HAVE_MTD
+static FAR struct mtd_dev_s *g_fsbench_mtd;
+#endif
+
+#ifdef CONFIG_FS_BENCHMARK_NXFFS
+static FAR struct mtd_dev_s *g_fsbench_nxffsmtd;
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations fsbench_operations =
+{
+  fsbench_open,       /* open */
+  fsbench_close,      /* close */
+  fsbench_read,       /* read */
+  NULL,               /* write */
+
+  fsbench_dup,        /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  fsbench_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fsbench_now
+ *
+ * Description:
+ *   Return the system time in microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t fsbench_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: fsbench_elapsed
+ *
+ * Description:
+ *   Return the microseconds elapsed since 'start', never zero so that the
+ *   result may be used as a divisor.
+ *
+ ****************************************************************************/
+
+static uint32_t fsbench_elapsed(uint64_t start)
+{
+  uint64_t elapsed = fsbench_now() - start;
+
+  return elapsed > 0 ? (uint32_t)elapsed : 1;
+}
+
+/****************************************************************************
+ * Name: fsbench_rate
+ *
+ * Description:
+ *   Convert the time taken to transfer the test file to KiB per second.
+ *
+ ****************************************************************************/
+
+static int32_t fsbench_rate(uint32_t usec)
+{
+  return (int32_t)(((uint64_t)CONFIG_FS_BENCHMARK_FILESIZE * USEC_PER_SEC) /
+                   ((uint64_t)usec * 1024));
+}
+
+/****************************************************************************
+ * Name: fsbench_random
+ *
+ * Description:
+ *   Return a pseudo-random I/O request index.  A fixed seed is used by
+ *   each test so that every file system sees the same offsets.
+ *
+ ****************************************************************************/
+
+static unsigned int fsbench_random(FAR uint32_t *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return (*seed >> 16) % FSBENCH_NIO;
+}
+
+/****************************************************************************
+ * Name: fsbench_transfer
+ *
+ * Description:
+ *   Write or read the whole test file in CONFIG_FS_BENCHMARK_IOSIZE
+ *   requests, in order or at random offsets, and return its rate in KiB
+ *   per second.  Writes are synchronized with the media before the clock
+ *   is stopped.
+ *
+ ****************************************************************************/
+
+static int32_t fsbench_transfer(FAR const char *path, int oflags,
+                                bool random, FAR uint8_t *buffer)
+{
+  struct file file;
+  uint64_t start;
+  uint32_t seed = 1;
+  uint32_t usec;
+  ssize_t nbytes;
+  off_t offset;
+  int ret;
+  int i;
+
+  ret = file_open(&file, path, oflags, 0666);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  start = fsbench_now();
+  for (i = 0; i < FSBENCH_NIO; i++)
+    {
+      offset = (off_t)(random ? fsbench_random(&seed) : i) *
+               CONFIG_FS_BENCHMARK_IOSIZE;
+
+      if ((oflags & O_WRONLY) != 0)
+        {
+          nbytes = file_pwrite(&file, buffer, CONFIG_FS_BENCHMARK_IOSIZE,
+                               offset);
+        }
+      else
+        {
+          nbytes = file_pread(&file, buffer, CONFIG_FS_BENCHMARK_IOSIZE,
+                              offset);
+        }
+
+      if (nbytes != CONFIG_FS_BENCHMARK_IOSIZE)
+        {
+          ret = nbytes < 0 ? (int)nbytes : -ENOSPC;
+          break;
+        }
+    }
+
+  if (ret >= 0 && (oflags & O_WRONLY) != 0)
+    {
+      ret = file_fsync(&file);
+      if (ret == -ENOSYS || ret == -EINVAL)
+        {
+          ret = OK;
+        }
+    }
+
+  usec = fsbench_elapsed(start);
+  file_close(&file);
+  return ret < 0 ? ret : fsbench_rate(usec);
+}
+
+/****************************************************************************
+ * Name: fsbench_io
+ *
+ * Description:
+ *   Run the four data transfer tests on one file.
+ *
+ ****************************************************************************/
+
+static void fsbench_io(FAR const char *path, int oflags,
+                       FAR uint8_t *buffer,
+                       FAR struct fsbench_result_s *result)
+{
+  result->value[FSBENCH_SEQWRITE] =
+    fsbench_transfer(path, O_WRONLY | oflags, false, buffer);
+  result->value[FSBENCH_SEQREAD] =
+    fsbench_transfer(path, O_RDONLY, false, buffer);
+  result->value[FSBENCH_RANDWRITE] =
+    fsbench_transfer(path, O_WRONLY, true, buffer);
+  result->value[FSBENCH_RANDREAD] =
+    fsbench_transfer(path, O_RDONLY, true, buffer);
+}
+
+/****************************************************************************
+ * Name: fsbench_ramdisk
+ *
+ * Description:
+ *   Measure the block layer alone: transfer the test file to and from a
+ *   RAM disk through its BCH character driver proxy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH
+static int fsbench_ramdisk(FAR uint8_t *buffer,
+                           FAR struct fsbench_result_s *result)
+{
+  char path[FSBENCH_PATHLEN];
+  FAR uint8_t *disk;
+  int ret;
+
+  disk = kmm_zalloc(CONFIG_FS_BENCHMARK_FILESIZE);
+  if (disk == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The RAM disk frees its memory when it is unlinked */
+
+  ret = ramdisk_register(CONFIG_FS_BENCHMARK_RAMDISK_MINOR, disk,
+                         CONFIG_FS_BENCHMARK_FILESIZE / FSBENCH_SECTSIZE,
+                         FSBENCH_SECTSIZE,
+                         RDFLAG_WRENABLED | RDFLAG_FUNLINK);
+  if (ret < 0)
+    {
+      kmm_free(disk);
+      return ret;
+    }
+
+  snprintf(path, sizeof(path), "/dev/ram%d",
+           CONFIG_FS_BENCHMARK_RAMDISK_MINOR);
+  fsbench_io(path, 0, buffer, result);
+  unlink(path);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fsbench_format_*
+ *
+ * Description:
+ *   Erase and, where the file system needs it, format the media so that
+ *   each run starts from an empty volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_LITTLEFS
+static int fsbench_format_littlefs(void)
+{
+  int ret;
+
+  ret = nx_mount(FSBENCH_MTDPATH, FSBENCH_MOUNTPT, "littlefs", 0,
+                 "forceformat");
+  if (ret >= 0)
+    {
+      ret = nx_umount2(FSBENCH_MOUNTPT, 0);
+    }
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_FS_SPIFFS
+static int fsbench_format_spiffs(void)
+{
+  /* SPIFFS treats erased media as an empty volume */
+
+  return MTD_IOCTL(g_fsbench_mtd, MTDIOC_BULKERASE, 0);
+}
+#endif
+
+#ifdef CONFIG_FS_BENCHMARK_SMARTFS
+static int fsbench_format_smartfs(void)
+{
+  struct file file;
+  int ret;
+
+  ret = MTD_IOCTL(g_fsbench_mtd, MTDIOC_BULKERASE, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_open(&file, FSBENCH_SMARTPATH, O_RDWR);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_ioctl(&file, BIOC_LLFORMAT, 0);
+  file_close(&file);
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_FS_BENCHMARK_NXFFS
+static int fsbench_format_nxffs(void)
+{
+  FAR uint8_t *start;
+  int ret;
+
+  /* NXFFS supports a single volume that cannot be released again, so it
+   * is bound to its own MTD device once.  Later runs reuse the volume, and
+   * the files of the previous run have been unlinked.
+   */
+
+  if (g_fsbench_nxffsmtd != NULL)
+    {
+      return OK;
+    }
+
+  start = kmm_malloc(CONFIG_FS_BENCHMARK_MTDSIZE);
+  if (start == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  g_fsbench_nxffsmtd = rammtd_initialize(start,
+                                         CONFIG_FS_BENCHMARK_MTDSIZE);
+  if (g_fsbench_nxffsmtd == NULL)
+    {
+      kmm_free(start);
+      return -ENOMEM;
+    }
+
+  ret = MTD_IOCTL(g_fsbench_nxffsmtd, MTDIOC_BULKERASE, 0);
+  if (ret >= 0)
+    {
+      ret = nxffs_initialize(g_fsbench_nxffsmtd);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: fsbench_initialize
+ *
+ * Description:
+ *   Create the RAM MTD device shared by the MTD file systems.
+ *
+ ****************************************************************************/
+
+#ifdef FSBENCH_HAVE_MTD
+static int fsbench_initialize(void)
+{
+  FAR uint8_t *start;
+  int ret;
+
+  if (g_fsbench_mtd != NULL)
+    {
+      return OK;
+    }
+
+  start = kmm_malloc(CONFIG_FS_BENCHMARK_MTDSIZE);
+  if (start == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  g_fsbench_mtd = rammtd_initialize(start, CONFIG_FS_BENCHMARK_MTDSIZE);
+  if (g_fsbench_mtd == NULL)
+    {
+      kmm_free(start);
+      return -ENOMEM;
+    }
+
+  ret = MTD_IOCTL(g_fsbench_mtd, MTDIOC_BULKERASE, 0);
+
+#ifdef FSBENCH_HAVE_MTDDRIVER
+  if (ret >= 0)
+    {
+      ret = register_mtddriver(FSBENCH_MTDPATH, g_fsbench_mtd, 0666, NULL);
+    }
+#endif
+
+#ifdef CONFIG_FS_BENCHMARK_SMARTFS
+  if (ret >= 0)
+    {
+      ret = smart_initialize(CONFIG_FS_BENCHMARK_SMART_MINOR,
+                             g_fsbench_mtd, NULL);
+    }
+#endif
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: fsbench_unlink
+ *
+ * Description:
+ *   Unlink the metadata test files, returning the microseconds per file.
+ *
+ ****************************************************************************/
+
+static int32_t fsbench_unlink(void)
+{
+  char path[FSBENCH_PATHLEN];
+  uint64_t start;
+  int ret = OK;
+  int i;
+
+  start = fsbench_now();
+  for (i = 0; i < CONFIG_FS_BENCHMARK_NFILES; i++)
+    {
+      snprintf(path, sizeof(path), FSBENCH_MOUNTPT "/f%03d", i);
+      if (unlink(path) < 0 && ret >= 0)
+        {
+          ret = -get_errno();
+        }
+    }
+
+  return ret < 0 ? ret : (int32_t)(fsbench_elapsed(start) /
+                                   CONFIG_FS_BENCHMARK_NFILES);
+}
+
+/****************************************************************************
+ * Name: fsbench_metadata
+ *
+ * Description:
+ *   Create the metadata test files and then list the directory holding
+ *   them.
+ *
+ ****************************************************************************/
+
+static void fsbench_metadata(FAR struct fsbench_result_s *result)
+{
+  char path[FSBENCH_PATHLEN];
+  struct file file;
+  FAR DIR *dirp;
+  uint64_t start;
+  int nentries = 0;
+  int ret = OK;
+  int i;
+
+  start = fsbench_now();
+  for (i = 0; i < CONFIG_FS_BENCHMARK_NFILES; i++)
+    {
+      snprintf(path, sizeof(path), FSBENCH_MOUNTPT "/f%03d", i);
+      ret = file_open(&file, path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      file_close(&file);
+    }
+
+  result->value[FSBENCH_CREATE] = ret < 0 ? ret :
+    (int32_t)(fsbench_elapsed(start) / CONFIG_FS_BENCHMARK_NFILES);
+
+  start = fsbench_now();
+  dirp  = opendir(FSBENCH_MOUNTPT);
+  if (dirp == NULL)
+    {
+      result->value[FSBENCH_READDIR] = -get_errno();
+      return;
+    }
+
+  while (readdir(dirp) != NULL)
+    {
+      nentries++;
+    }
+
+  closedir(dirp);
+  result->value[FSBENCH_READDIR] = nentries == 0 ? -ENOENT :
+    (int32_t)(fsbench_elapsed(start) / nentries);
+}
+
+/****************************************************************************
+ * Name: fsbench_mount
+ *
+ * Description:
+ *   Mount the file system under test, returning the microseconds taken.
+ *
+ ****************************************************************************/
+
+static int32_t fsbench_mount(FAR const struct fsbench_fs_s *fs)
+{
+  uint64_t start;
+  int ret;
+
+  start = fsbench_now();
+  ret   = nx_mount(fs->source, FSBENCH_MOUNTPT, fs->fstype, 0, NULL);
+  return ret < 0 ? ret : (int32_t)fsbench_elapsed(start);
+}
+
+/****************************************************************************
+ * Name: fsbench_filesystem
+ *
+ * Description:
+ *   Run all of the tests on one file system, starting from an empty
+ *   volume.  The remount is measured with the test file and the metadata
+ *   test files in place, before they are removed again.
+ *
+ ****************************************************************************/
+
+static int fsbench_filesystem(FAR const struct fsbench_fs_s *fs,
+                              FAR uint8_t *buffer,
+                              FAR struct fsbench_result_s *result)
+{
+  int32_t value;
+  int ret;
+
+  ret = fs->format();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  value = fsbench_mount(fs);
+  result->value[FSBENCH_MOUNT] = value;
+  if (value < 0)
+    {
+      return value;
+    }
+
+  fsbench_io(FSBENCH_DATAPATH, O_CREAT | O_TRUNC, buffer, result);
+  fsbench_metadata(result);
+
+  ret = nx_umount2(FSBENCH_MOUNTPT, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  value = fsbench_mount(fs);
+  result->value[FSBENCH_REMOUNT] = value;
+  if (value < 0)
+    {
+      return value;
+    }
+
+  result->value[FSBENCH_UNLINK] = fsbench_unlink();
+  unlink(FSBENCH_DATAPATH);
+  return nx_umount2(FSBENCH_MOUNTPT, 0);
+}
+
+/****************************************************************************
+ * Name: fsbench_run
+ *
+ * Description:
+ *   Run the benchmark on every configured file system.  A test that could
+ *   not be run is reported as -ENOSYS.
+ *
+ ****************************************************************************/
+
+static int fsbench_run(FAR struct fsbench_result_s *results)
+{
+  FAR uint8_t *buffer;
+  int ret;
+  int i;
+  int j;
+
+  for (i = 0; i < FSBENCH_NFS; i++)
+    {
+      for (j = 0; j < FSBENCH_NTESTS; j++)
+        {
+          results[i].value[j] = -ENOSYS;
+        }
+    }
+
+  buffer = kmm_malloc(CONFIG_FS_BENCHMARK_IOSIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_FS_BENCHMARK_IOSIZE; i++)
+    {
+      buffer[i] = (uint8_t)i;
+    }
+
+  ret = nxsem_wait_uninterruptible(&g_fsbench_sem);
+  if (ret < 0)
+    {
+      kmm_free(buffer);
+      return ret;
+    }
+
+#ifdef FSBENCH_HAVE_MTD
+  ret = fsbench_initialize();
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
+  for (i = 0; i < FSBENCH_NFS; i++)
+    {
+      FAR const struct fsbench_fs_s *fs = &g_fsbench_fs[i];
+
+#ifdef CONFIG_BCH
+      if (fs->fstype == NULL)
+        {
+          ret = fsbench_ramdisk(buffer, &results[i]);
+        }
+      else
+#endif
+        {
+          ret = fsbench_filesystem(fs, buffer, &results[i]);
+        }
+
+      /* Report an error that prevented the tests from being run in
+       * place of the mount time.
+       */
+
+      if (ret < 0)
+        {
+          ferr("ERROR: %s failed: %d\n", fs->name, ret);
+          results[i].value[FSBENCH_MOUNT] = ret;
+        }
+    }
+
+  ret = OK;
+
+#ifdef FSBENCH_HAVE_MTD
+errout:
+#endif
+  nxsem_post(&g_fsbench_sem);
+  kmm_free(buffer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_open
+ *
+ * Description:
+ *   Run the benchmark.  The results are kept with the open file, so that
+ *   one run can be read in as many pieces as needed.
+ *
+ ****************************************************************************/
+
+static int fsbench_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct fsbench_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "fsbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fsbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(SIZEOF_FSBENCH_FILE_S(FSBENCH_NFS));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  attr->result = fsbench_run(attr->fs);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_close
+ ****************************************************************************/
+
+static int fsbench_close(FAR struct file *filep)
+{
+  FAR struct fsbench_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct fsbench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_read
+ *
+ * Description:
+ *   Generate one line for each file system.  Mount times are in
+ *   microseconds, transfer rates in KiB per second and the metadata
+ *   operations in microseconds per file.  A test that failed shows its
+ *   negated errno instead.
+ *
+ ****************************************************************************/
+
+static ssize_t fsbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct fsbench_file_s *attr;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct fsbench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (attr->result < 0)
+    {
+      return attr->result;
+    }
+
+  offset = filep->f_pos;
+
+  /* Generate the header line */
+
+  linesize = snprintf(attr->line, FSBENCH_LINELEN, "%-8s", "FS");
+  for (j = 0; j < FSBENCH_NTESTS; j++)
+    {
+      linesize += snprintf(attr->line + linesize,
+                           FSBENCH_LINELEN - linesize, " %8s",
+                           g_fsbench_names[j]);
+    }
+
+  attr->line[linesize++] = '\n';
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (i = 0; i < FSBENCH_NFS && totalsize < buflen; i++)
+    {
+      linesize = snprintf(attr->line, FSBENCH_LINELEN, "%-8s",
+                          g_fsbench_fs[i].name);
+      for (j = 0; j < FSBENCH_NTESTS; j++)
+        {
+          linesize += snprintf(attr->line + linesize,
+                               FSBENCH_LINELEN - linesize, " %8ld",
+                               (long)attr->fs[i].value[j]);
+        }
+
+      attr->line[linesize++] = '\n';
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: fsbench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int fsbench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct fsbench_file_s *oldattr;
+  FAR struct fsbench_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct fsbench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(SIZEOF_FSBENCH_FILE_S(FSBENCH_NFS));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, SIZEOF_FSBENCH_FILE_S(FSBENCH_NFS));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int fsbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fsbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fsbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "fsbench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_FS_BENCHMARK */
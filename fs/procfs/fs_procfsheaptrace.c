@@ -0,0 +1,434 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheaptrace.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_MM_TRACE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAPTRACE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAPTRACE_LINELEN 64
+
+/* The heaps that can be reached from here */
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+#  define HEAPTRACE_KHEAP 1
+#else
+#  define HEAPTRACE_KHEAP 0
+#endif
+
+#ifdef CONFIG_BUILD_FLAT
+#  define HEAPTRACE_UHEAP 1
+#else
+#  define HEAPTRACE_UHEAP 0
+#endif
+
+#define HEAPTRACE_NHEAPS  (HEAPTRACE_KHEAP + HEAPTRACE_UHEAP)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Snapshot of one heap */
+
+struct heaptrace_heap_s
+{
+  FAR const char *name;
+  struct mm_traceinfo_s info;
+  struct mm_tracecaller_s callers[CONFIG_MM_TRACE_NCALLERS];
+};
+
+/* This structure describes one open "file" */
+
+struct heaptrace_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  struct heaptrace_heap_s heap[HEAPTRACE_NHEAPS];
+  char line[HEAPTRACE_LINELEN]; /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     heaptrace_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     heaptrace_close(FAR struct file *filep);
+static ssize_t heaptrace_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     heaptrace_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heaptrace_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations heaptrace_operations =
+{
+  heaptrace_open,     /* open */
+  heaptrace_close,    /* close */
+  heaptrace_read,     /* read */
+  NULL,               /* write */
+
+  heaptrace_dup,      /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  heaptrace_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heaptrace_compare
+ *
+ * Description:
+ *   qsort() comparison putting the call sites holding most memory first.
+ *
+ ****************************************************************************/
+
+static int heaptrace_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct mm_tracecaller_s *ca = a;
+  FAR const struct mm_tracecaller_s *cb = b;
+
+  if (ca->size != cb->size)
+    {
+      return ca->size < cb->size ? 1 : -1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heaptrace_snapshot
+ ****************************************************************************/
+
+static void heaptrace_snapshot(FAR struct heaptrace_heap_s *snap,
+                               FAR const char *name,
+                               FAR struct mm_heap_s *heap)
+{
+  snap->name           = name;
+  snap->info.callers   = snap->callers;
+  snap->info.ncallers  = CONFIG_MM_TRACE_NCALLERS;
+
+  mm_traceinfo(heap, &snap->info);
+
+  /* Move the used entries of the hash table to the front, biggest first */
+
+  qsort(snap->callers, CONFIG_MM_TRACE_NCALLERS,
+        sizeof(struct mm_tracecaller_s), heaptrace_compare);
+}
+
+/****************************************************************************
+ * Name: heaptrace_open
+ ****************************************************************************/
+
+static int heaptrace_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct heaptrace_file_s *attr;
+  int i = 0;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "heaptrace" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heaptrace") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct heaptrace_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take the snapshots now, so that the output stays consistent when it is
+   * read in pieces.
+   */
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  heaptrace_snapshot(&attr->heap[i++], "Kernel", &g_kmmheap);
+#endif
+#ifdef CONFIG_BUILD_FLAT
+  heaptrace_snapshot(&attr->heap[i++], "User", &g_mmheap);
+#endif
+
+  UNUSED(i);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heaptrace_close
+ ****************************************************************************/
+
+static int heaptrace_close(FAR struct file *filep)
+{
+  FAR struct heaptrace_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heaptrace_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heaptrace_read_heap
+ *
+ * Description:
+ *   Generate the output for one heap:  One line per call site and thread
+ *   with the number and total size of its live chunks, then one line per
+ *   non-empty free list bin with the smallest chunk size of the bin, the
+ *   number and the total size of the free chunks in it.
+ *
+ ****************************************************************************/
+
+static size_t heaptrace_read_heap(FAR struct heaptrace_file_s *attr,
+                                  FAR struct heaptrace_heap_s *snap,
+                                  FAR char *buffer, size_t buflen,
+                                  FAR off_t *offset)
+{
+  FAR struct mm_traceinfo_s *info = &snap->info;
+  size_t linesize;
+  size_t totalsize = 0;
+  int i;
+
+#define HEAPTRACE_EMIT(...) \
+  do \
+    { \
+      linesize   = snprintf(attr->line, HEAPTRACE_LINELEN, __VA_ARGS__); \
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize, \
+                                 buflen - totalsize, offset); \
+    } \
+  while (0)
+
+  HEAPTRACE_EMIT("%s heap:\n%6s %18s %10s %10s\n", snap->name,
+                 "PID", "CALLER", "COUNT", "SIZE");
+
+  for (i = 0; i < info->nused && totalsize < buflen; i++)
+    {
+      FAR struct mm_tracecaller_s *entry = &snap->callers[i];
+
+      HEAPTRACE_EMIT("%6d %18p %10lu %10lu\n", entry->pid, entry->caller,
+                     (unsigned long)entry->count,
+                     (unsigned long)entry->size);
+    }
+
+  if (info->nother > 0)
+    {
+      HEAPTRACE_EMIT("%6s %18s %10lu %10lu\n", "-", "other",
+                     (unsigned long)info->nother,
+                     (unsigned long)info->sother);
+    }
+
+  if (info->ncached > 0)
+    {
+      HEAPTRACE_EMIT("%6s %18s %10lu %10lu\n", "-", "cached",
+                     (unsigned long)info->ncached,
+                     (unsigned long)info->scached);
+    }
+
+  HEAPTRACE_EMIT("%6s %18s %10s %10s\n", "BIN", "MINSIZE", "NFREE",
+                 "FREE");
+
+  for (i = 0; i < MM_NNODES && totalsize < buflen; i++)
+    {
+      if (info->nfree[i] > 0)
+        {
+          HEAPTRACE_EMIT("%6d %18lu %10lu %10lu\n", i,
+                         (unsigned long)MM_NDX2SIZE(i),
+                         (unsigned long)info->nfree[i],
+                         (unsigned long)info->sfree[i]);
+        }
+    }
+
+#undef HEAPTRACE_EMIT
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heaptrace_read
+ ****************************************************************************/
+
+static ssize_t heaptrace_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct heaptrace_file_s *attr;
+  size_t totalsize = 0;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heaptrace_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  for (i = 0; i < HEAPTRACE_NHEAPS && totalsize < buflen; i++)
+    {
+      totalsize += heaptrace_read_heap(attr, &attr->heap[i],
+                                       buffer + totalsize,
+                                       buflen - totalsize, &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heaptrace_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heaptrace_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heaptrace_file_s *oldattr;
+  FAR struct heaptrace_file_s *newattr;
+  int i;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heaptrace_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct heaptrace_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct heaptrace_file_s));
+  for (i = 0; i < HEAPTRACE_NHEAPS; i++)
+    {
+      newattr->heap[i].info.callers = newattr->heap[i].callers;
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heaptrace_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heaptrace_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "heaptrace" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heaptrace") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "heaptrace" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_MM_TRACE */
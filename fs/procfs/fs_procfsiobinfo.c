@@ -151,6 +151,9 @@ static FAR const char *g_iob_user_names[] =
 #ifdef CONFIG_NET_IPFORWARD
   "ipforward",
 #endif
+#ifdef CONFIG_NETDEV_TXQUEUE
+  "txqueue",
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   "rad802154",
 #endif
@@ -352,6 +355,45 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
       totalsize += copysize;
     }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Then the hit rate of the per-CPU I/O buffer caches */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                            "\n        CACHE"
+                            "              HITS          MISSES\n");
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (i = 0; i < IOB_NCACHES; i++)
+    {
+      if (totalsize < buflen)
+        {
+          FAR struct iob_cachestats_s *cachestats;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          cachestats = iob_getcachestats(i);
+          linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                                "cpu%-13d%16lu%16lu\n", i,
+                                (unsigned long)cachestats->hits,
+                                (unsigned long)cachestats->misses);
+
+          copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                     &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -0,0 +1,518 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmembench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_MEMCPY_BENCHMARK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest copy measured.  The buffer holds two such regions plus room
+ * for the misaligned and overlapping cases.
+ */
+
+#define MEMBENCH_MAXSIZE     4096
+#define MEMBENCH_OVERLAP     (2 * sizeof(uintptr_t))
+#define MEMBENCH_BUFSIZE     (2 * MEMBENCH_MAXSIZE + MEMBENCH_OVERLAP)
+
+/* The measurements made for each copy size */
+
+#define MEMBENCH_MEMCPY      0  /* memcpy(), both pointers aligned */
+#define MEMBENCH_MEMCPYU     1  /* memcpy(), source misaligned by one */
+#define MEMBENCH_MOVEUP      2  /* memmove(), overlapping, moving up */
+#define MEMBENCH_MOVEDOWN    3  /* memmove(), overlapping, moving down */
+#define MEMBENCH_BYTES       4  /* Byte loop, for reference */
+#define MEMBENCH_NTESTS      5
+
+#define MEMBENCH_NSIZES      (sizeof(g_membench_sizes) / \
+                              sizeof(g_membench_sizes[0]))
+
+/* Size of the open file structure, with one result per copy size */
+
+#define SIZEOF_MEMBENCH_FILE_S(n) \
+  (sizeof(struct membench_file_s) + \
+   ((n) - 1) * sizeof(struct membench_result_s))
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MEMBENCH_LINELEN     80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE FAR void *(*membench_copy_t)(FAR void *dest,
+                                          FAR const void *src, size_t n);
+
+/* This structure holds the results for one copy size.  Each value is the
+ * throughput in KiB per second.
+ */
+
+struct membench_result_s
+{
+  int32_t value[MEMBENCH_NTESTS];
+};
+
+/* This structure describes one open "file" */
+
+struct membench_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  int result;                        /* Result of membench_run() */
+  char line[MEMBENCH_LINELEN];       /* Buffer for formatted lines */
+  struct membench_result_s size[1];  /* One per copy size, must be last */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     membench_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     membench_close(FAR struct file *filep);
+static ssize_t membench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     membench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     membench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint16_t g_membench_sizes[] =
+{
+  16, 64, 256, 1024, MEMBENCH_MAXSIZE
+};
+
+static FAR const char * const g_membench_names[MEMBENCH_NTESTS] =
+{
+  "MEMCPY", "MEMCPYU", "MOVEUP", "MOVEDOWN", "BYTES"
+};
+
+/* Only one benchmark may run at a time */
+
+static sem_t g_membench_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations membench_operations =
+{
+  membench_open,       /* open */
+  membench_close,      /* close */
+  membench_read,       /* read */
+  NULL,                /* write */
+
+  membench_dup,        /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  membench_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: membench_now
+ *
+ * Description:
+ *   Return the system time in microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t membench_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: membench_bytecopy
+ *
+ * Description:
+ *   Copy one byte at a time, as memcpy() does when it is optimized for
+ *   size.  The volatile destination keeps the compiler from turning the
+ *   loop back into a call to memcpy().
+ *
+ ****************************************************************************/
+
+static FAR void *membench_bytecopy(FAR void *dest, FAR const void *src,
+                                   size_t n)
+{
+  FAR volatile uint8_t *pout = dest;
+  FAR const uint8_t *pin = src;
+
+  while (n-- > 0)
+    {
+      *pout++ = *pin++;
+    }
+
+  return dest;
+}
+
+/****************************************************************************
+ * Name: membench_measure
+ *
+ * Description:
+ *   Repeat one copy of 'n' bytes until CONFIG_MEMCPY_BENCHMARK_NBYTES have
+ *   been copied and return the throughput in KiB per second.  The copy
+ *   function is called through a pointer so that the compiler cannot
+ *   replace it with inline code.
+ *
+ ****************************************************************************/
+
+static int32_t membench_measure(membench_copy_t copy, FAR uint8_t *dest,
+                                FAR const uint8_t *src, size_t n)
+{
+  uint64_t elapsed;
+  uint64_t start;
+  uint32_t count;
+  uint32_t i;
+
+  count = CONFIG_MEMCPY_BENCHMARK_NBYTES / n;
+  if (count == 0)
+    {
+      count = 1;
+    }
+
+  start = membench_now();
+  for (i = 0; i < count; i++)
+    {
+      copy(dest, src, n);
+    }
+
+  elapsed = membench_now() - start;
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  return (int32_t)(((uint64_t)count * n * USEC_PER_SEC) / (elapsed * 1024));
+}
+
+/****************************************************************************
+ * Name: membench_run
+ *
+ * Description:
+ *   Measure every copy function for every copy size.
+ *
+ ****************************************************************************/
+
+static int membench_run(FAR struct membench_result_s *results)
+{
+  membench_copy_t copy;
+  FAR uint8_t *buffer;
+  FAR uint8_t *dest;
+  int ret;
+  int i;
+
+  buffer = kmm_malloc(MEMBENCH_BUFSIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < MEMBENCH_BUFSIZE; i++)
+    {
+      buffer[i] = (uint8_t)i;
+    }
+
+  ret = nxsem_wait_uninterruptible(&g_membench_sem);
+  if (ret < 0)
+    {
+      kmm_free(buffer);
+      return ret;
+    }
+
+  dest = buffer + MEMBENCH_MAXSIZE + MEMBENCH_OVERLAP;
+  for (i = 0; i < MEMBENCH_NSIZES; i++)
+    {
+      FAR int32_t *value = results[i].value;
+      size_t n = g_membench_sizes[i];
+
+      copy                     = memcpy;
+      value[MEMBENCH_MEMCPY]   = membench_measure(copy, dest, buffer, n);
+      value[MEMBENCH_MEMCPYU]  = membench_measure(copy, dest, buffer + 1,
+                                                  n);
+
+      copy                     = memmove;
+      value[MEMBENCH_MOVEUP]   = membench_measure(copy,
+                                                  buffer + MEMBENCH_OVERLAP,
+                                                  buffer, n);
+      value[MEMBENCH_MOVEDOWN] = membench_measure(copy, buffer,
+                                                  buffer + MEMBENCH_OVERLAP,
+                                                  n);
+
+      copy                     = membench_bytecopy;
+      value[MEMBENCH_BYTES]    = membench_measure(copy, dest, buffer, n);
+    }
+
+  nxsem_post(&g_membench_sem);
+  kmm_free(buffer);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: membench_open
+ *
+ * Description:
+ *   Run the benchmark.  The results are kept with the open file, so that
+ *   one run can be read in as many pieces as needed.
+ *
+ ****************************************************************************/
+
+static int membench_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct membench_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "membench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "membench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(SIZEOF_MEMBENCH_FILE_S(MEMBENCH_NSIZES));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  attr->result = membench_run(attr->size);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: membench_close
+ ****************************************************************************/
+
+static int membench_close(FAR struct file *filep)
+{
+  FAR struct membench_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct membench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: membench_read
+ *
+ * Description:
+ *   Generate one line for each copy size with the throughput of each copy
+ *   function in KiB per second.
+ *
+ ****************************************************************************/
+
+static ssize_t membench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct membench_file_s *attr;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct membench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (attr->result < 0)
+    {
+      return attr->result;
+    }
+
+  offset = filep->f_pos;
+
+  /* Generate the header line */
+
+  linesize = snprintf(attr->line, MEMBENCH_LINELEN, "%-6s", "SIZE");
+  for (j = 0; j < MEMBENCH_NTESTS; j++)
+    {
+      linesize += snprintf(attr->line + linesize,
+                           MEMBENCH_LINELEN - linesize, " %9s",
+                           g_membench_names[j]);
+    }
+
+  attr->line[linesize++] = '\n';
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (i = 0; i < MEMBENCH_NSIZES && totalsize < buflen; i++)
+    {
+      linesize = snprintf(attr->line, MEMBENCH_LINELEN, "%-6u",
+                          (unsigned int)g_membench_sizes[i]);
+      for (j = 0; j < MEMBENCH_NTESTS; j++)
+        {
+          linesize += snprintf(attr->line + linesize,
+                               MEMBENCH_LINELEN - linesize, " %9ld",
+                               (long)attr->size[i].value[j]);
+        }
+
+      attr->line[linesize++] = '\n';
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: membench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int membench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct membench_file_s *oldattr;
+  FAR struct membench_file_s *newattr;
+  size_t size;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct membench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  size    = SIZEOF_MEMBENCH_FILE_S(MEMBENCH_NSIZES);
+  newattr = kmm_malloc(size);
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, size);
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: membench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int membench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "membench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "membench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "membench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_MEMCPY_BENCHMARK */
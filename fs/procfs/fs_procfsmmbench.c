@@ -0,0 +1,617 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmmbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_MM_BENCHMARK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of request sizes measured, see g_mmbench_sizes */
+
+#define MMBENCH_NSIZES       4
+
+/* The free holes left in the heap are two thirds of the size of the
+ * requests, so that they are in the same free lists but too small.
+ */
+
+#define MMBENCH_HOLESIZE(s)  ((s) * 2 / 3)
+
+/* The measurements made for each request size */
+
+#define MMBENCH_MALLOC       0  /* mm_malloc() */
+#define MMBENCH_FREE         1  /* mm_free() */
+#define MMBENCH_NTESTS       2
+
+/* Size of the open file structure, with one result per request size */
+
+#define SIZEOF_MMBENCH_FILE_S(n) \
+  (sizeof(struct mmbench_file_s) + \
+   ((n) - 1) * sizeof(struct mmbench_result_s))
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MMBENCH_LINELEN      96
+
+/* The allocator being measured */
+
+#ifdef CONFIG_MM_TLSF
+#  define MMBENCH_ALLOCATOR  "TLSF"
+#else
+#  define MMBENCH_ALLOCATOR  "best fit"
+#endif
+
+#ifdef MM_USE_FASTBINS
+#  define MMBENCH_FASTBINS   " with fast bins"
+#else
+#  define MMBENCH_FASTBINS   ""
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The durations of one kind of call, in up_critmon_gettime() units */
+
+struct mmbench_stat_s
+{
+  int      result;           /* OK or a negated errno */
+  uint32_t count;            /* Number of samples */
+  uint32_t min;              /* Shortest sample */
+  uint32_t max;              /* Longest sample */
+  uint64_t total;            /* Sum of all samples */
+};
+
+/* This structure holds the results for one request size */
+
+struct mmbench_result_s
+{
+  struct mmbench_stat_s stat[MMBENCH_NTESTS];
+};
+
+/* This structure describes one open "file" */
+
+struct mmbench_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  int result;                        /* Result of mmbench_run() */
+  char line[MMBENCH_LINELEN];        /* Buffer for formatted lines */
+  struct mmbench_result_s size[1];   /* One per request size, must be last */
+};
+
+/* The private heap and the pointers to the blocks allocated from it */
+
+struct mmbench_heap_s
+{
+  struct mm_heap_s heap;
+  FAR void *holes[CONFIG_MM_BENCHMARK_NHOLES * MMBENCH_NSIZES];
+  FAR void *fences[CONFIG_MM_BENCHMARK_NHOLES * MMBENCH_NSIZES];
+  FAR void *blocks[CONFIG_MM_BENCHMARK_NALLOCS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     mmbench_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     mmbench_close(FAR struct file *filep);
+static ssize_t mmbench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     mmbench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     mmbench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The request sizes, each one in a different free list */
+
+static const uint16_t g_mmbench_sizes[MMBENCH_NSIZES] =
+{
+  24, 96, 384, 1536
+};
+
+static FAR const char * const g_mmbench_names[MMBENCH_NTESTS] =
+{
+  "MALLOC", "FREE"
+};
+
+/* Only one benchmark may run at a time */
+
+static sem_t g_mmbench_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations mmbench_operations =
+{
+  mmbench_open,        /* open */
+  mmbench_close,       /* close */
+  mmbench_read,        /* read */
+  NULL,                /* write */
+
+  mmbench_dup,         /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  mmbench_stat         /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmbench_sample
+ *
+ * Description:
+ *   Add one sample to a measurement.
+ *
+ ****************************************************************************/
+
+static void mmbench_sample(FAR struct mmbench_stat_s *stat,
+                           uint32_t elapsed)
+{
+  if (stat->count == 0 || elapsed < stat->min)
+    {
+      stat->min = elapsed;
+    }
+
+  if (elapsed > stat->max)
+    {
+      stat->max = elapsed;
+    }
+
+  stat->total += elapsed;
+  stat->count++;
+}
+
+/****************************************************************************
+ * Name: mmbench_fragment
+ *
+ * Description:
+ *   Leave free holes of each request size class in the heap.  The blocks
+ *   in between are kept allocated so that the holes cannot be merged.
+ *   Returns the number of holes made.
+ *
+ ****************************************************************************/
+
+static int mmbench_fragment(FAR struct mmbench_heap_s *bench)
+{
+  int nholes = CONFIG_MM_BENCHMARK_NHOLES * MMBENCH_NSIZES;
+  int i;
+
+  for (i = 0; i < nholes; i++)
+    {
+      size_t size = MMBENCH_HOLESIZE(g_mmbench_sizes[i % MMBENCH_NSIZES]);
+
+      bench->holes[i]  = mm_malloc(&bench->heap, size);
+      bench->fences[i] = mm_malloc(&bench->heap, 1);
+      if (bench->holes[i] == NULL || bench->fences[i] == NULL)
+        {
+          nholes = i + 1;
+          break;
+        }
+    }
+
+  for (i = 0; i < nholes; i++)
+    {
+      if (bench->holes[i] != NULL)
+        {
+          mm_free(&bench->heap, bench->holes[i]);
+        }
+    }
+
+  return nholes;
+}
+
+/****************************************************************************
+ * Name: mmbench_measure
+ *
+ * Description:
+ *   Time CONFIG_MM_BENCHMARK_NALLOCS allocations of 'size' bytes followed
+ *   by their release.  Every other block is freed first, so that the
+ *   second half of the frees must merge with both neighbors.
+ *
+ ****************************************************************************/
+
+static void mmbench_measure(FAR struct mmbench_heap_s *bench, size_t size,
+                            FAR struct mmbench_result_s *result)
+{
+  FAR struct mmbench_stat_s *stat;
+  uint32_t start;
+  int nblocks;
+  int i;
+
+  stat = &result->stat[MMBENCH_MALLOC];
+  for (i = 0; i < CONFIG_MM_BENCHMARK_NALLOCS; i++)
+    {
+      start = up_critmon_gettime();
+      bench->blocks[i] = mm_malloc(&bench->heap, size);
+      mmbench_sample(stat, up_critmon_gettime() - start);
+
+      if (bench->blocks[i] == NULL)
+        {
+          stat->result = -ENOMEM;
+          break;
+        }
+    }
+
+  nblocks = i;
+  stat    = &result->stat[MMBENCH_FREE];
+
+  for (i = 0; i < nblocks; i += 2)
+    {
+      start = up_critmon_gettime();
+      mm_free(&bench->heap, bench->blocks[i]);
+      mmbench_sample(stat, up_critmon_gettime() - start);
+    }
+
+  for (i = 1; i < nblocks; i += 2)
+    {
+      start = up_critmon_gettime();
+      mm_free(&bench->heap, bench->blocks[i]);
+      mmbench_sample(stat, up_critmon_gettime() - start);
+    }
+}
+
+/****************************************************************************
+ * Name: mmbench_run
+ *
+ * Description:
+ *   Build a private, fragmented heap and measure every request size.  A
+ *   private heap keeps the results independent of the state of the system
+ *   heaps.
+ *
+ ****************************************************************************/
+
+static int mmbench_run(FAR struct mmbench_result_s *results)
+{
+  FAR struct mmbench_heap_s *bench;
+  FAR void *heapstart;
+  int nholes;
+  int ret;
+  int i;
+
+  bench = kmm_zalloc(sizeof(struct mmbench_heap_s));
+  if (bench == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  heapstart = kmm_malloc(CONFIG_MM_BENCHMARK_HEAPSIZE);
+  if (heapstart == NULL)
+    {
+      kmm_free(bench);
+      return -ENOMEM;
+    }
+
+  ret = nxsem_wait_uninterruptible(&g_mmbench_sem);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  mm_initialize(&bench->heap, heapstart, CONFIG_MM_BENCHMARK_HEAPSIZE);
+  nholes = mmbench_fragment(bench);
+
+  for (i = 0; i < MMBENCH_NSIZES; i++)
+    {
+      mmbench_measure(bench, g_mmbench_sizes[i], &results[i]);
+    }
+
+  for (i = 0; i < nholes; i++)
+    {
+      if (bench->fences[i] != NULL)
+        {
+          mm_free(&bench->heap, bench->fences[i]);
+        }
+    }
+
+  nxsem_post(&g_mmbench_sem);
+
+errout:
+  kmm_free(heapstart);
+  kmm_free(bench);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mmbench_nsec
+ *
+ * Description:
+ *   Convert an elapsed time in up_critmon_gettime() units to nanoseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long mmbench_nsec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  if (elapsed == 0)
+    {
+      return 0;
+    }
+
+  up_critmon_convert(elapsed, &ts);
+  return (unsigned long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: mmbench_open
+ *
+ * Description:
+ *   Run the benchmark.  The results are kept with the open file, so that
+ *   one run can be read in as many pieces as needed.
+ *
+ ****************************************************************************/
+
+static int mmbench_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct mmbench_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "mmbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "mmbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(SIZEOF_MMBENCH_FILE_S(MMBENCH_NSIZES));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  attr->result = mmbench_run(attr->size);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_close
+ ****************************************************************************/
+
+static int mmbench_close(FAR struct file *filep)
+{
+  FAR struct mmbench_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct mmbench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_read
+ *
+ * Description:
+ *   Generate a line naming the allocator, then one line for each request
+ *   size and call with the number of samples and the minimum, maximum and
+ *   average in nanoseconds, or the error that stopped the measurement in
+ *   place of the count.
+ *
+ ****************************************************************************/
+
+static ssize_t mmbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct mmbench_file_s *attr;
+  FAR struct mmbench_stat_s *stat;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  uint32_t avg;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct mmbench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (attr->result < 0)
+    {
+      return attr->result;
+    }
+
+  offset = filep->f_pos;
+
+  /* Generate the header lines */
+
+  linesize  = snprintf(attr->line, MMBENCH_LINELEN,
+                       "Allocator: %s%s\n%-6s %-6s %10s %10s %10s %10s\n",
+                       MMBENCH_ALLOCATOR, MMBENCH_FASTBINS,
+                       "SIZE", "CALL", "COUNT", "MIN", "MAX", "AVG");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (i = 0; i < MMBENCH_NSIZES && totalsize < buflen; i++)
+    {
+      for (j = 0; j < MMBENCH_NTESTS && totalsize < buflen; j++)
+        {
+          stat = &attr->size[i].stat[j];
+          if (stat->result < 0)
+            {
+              linesize = snprintf(attr->line, MMBENCH_LINELEN,
+                                  "%-6u %-6s %10d\n",
+                                  (unsigned int)g_mmbench_sizes[i],
+                                  g_mmbench_names[j], stat->result);
+            }
+          else
+            {
+              avg = stat->count > 0 ?
+                    (uint32_t)(stat->total / stat->count) : 0;
+
+              linesize = snprintf(attr->line, MMBENCH_LINELEN,
+                                  "%-6u %-6s %10lu %10lu %10lu %10lu\n",
+                                  (unsigned int)g_mmbench_sizes[i],
+                                  g_mmbench_names[j],
+                                  (unsigned long)stat->count,
+                                  mmbench_nsec(stat->min),
+                                  mmbench_nsec(stat->max),
+                                  mmbench_nsec(avg));
+            }
+
+          totalsize += procfs_memcpy(attr->line, linesize,
+                                     buffer + totalsize,
+                                     buflen - totalsize, &offset);
+        }
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: mmbench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mmbench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct mmbench_file_s *oldattr;
+  FAR struct mmbench_file_s *newattr;
+  size_t size;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct mmbench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  size    = SIZEOF_MMBENCH_FILE_S(MMBENCH_NSIZES);
+  newattr = kmm_malloc(size);
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, size);
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mmbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "mmbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "mmbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "mmbench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_MM_BENCHMARK */
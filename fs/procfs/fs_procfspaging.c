@@ -0,0 +1,295 @@
+/****************************************************************************
+ * fs/procfs/fs_procfspaging.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/page.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_PAGING) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGING)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define PAGING_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct paging_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  char line[PAGING_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     paging_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     paging_close(FAR struct file *filep);
+static ssize_t paging_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     paging_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     paging_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations paging_operations =
+{
+  paging_open,        /* open */
+  paging_close,       /* close */
+  paging_read,        /* read */
+  NULL,               /* write */
+
+  paging_dup,         /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  paging_stat         /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: paging_open
+ ****************************************************************************/
+
+static int paging_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct paging_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "paging" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "paging") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct paging_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: paging_close
+ ****************************************************************************/
+
+static int paging_close(FAR struct file *filep)
+{
+  FAR struct paging_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct paging_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: paging_read
+ ****************************************************************************/
+
+static ssize_t paging_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct paging_file_s *attr;
+  struct pg_stats_s stats;
+  clock_t ticks;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct paging_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  pg_statistics(&stats);
+  ticks = clock_systime_ticks();
+  if (ticks == 0)
+    {
+      ticks = 1;
+    }
+
+  offset    = filep->f_pos;
+  linesize  = snprintf(attr->line, PAGING_LINELEN,
+                       "%10s %10s %10s %10s %10s %8s\n",
+                       "FAULTS", "FILLS", "PREFETCH", "RECLAIM",
+                       "REDUNDANT", "RATE/S");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  /* The fault rate is the average number of faults per second since boot */
+
+  linesize   = snprintf(attr->line, PAGING_LINELEN,
+                        "%10lu %10lu %10lu %10lu %10lu %8lu\n",
+                        (unsigned long)stats.faults,
+                        (unsigned long)stats.fills,
+                        (unsigned long)stats.prefetches,
+                        (unsigned long)stats.reclaims,
+                        (unsigned long)stats.redundant,
+                        (unsigned long)((uint64_t)stats.faults *
+                                        TICK_PER_SEC / ticks));
+  totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                             buflen - totalsize, &offset);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: paging_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int paging_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct paging_file_s *oldattr;
+  FAR struct paging_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct paging_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct paging_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct paging_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: paging_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int paging_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "paging" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "paging") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "paging" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_PAGING */
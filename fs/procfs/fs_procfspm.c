@@ -0,0 +1,299 @@
+/****************************************************************************
+ * fs/procfs/fs_procfspm.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/power/pm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_PM_RESIDENCY) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define PM_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct pm_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[PM_LINELEN];        /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     pm_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     pm_close(FAR struct file *filep);
+static ssize_t pm_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     pm_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     pm_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations pm_operations =
+{
+  pm_open,  /* open */
+  pm_close, /* close */
+  pm_read,  /* read */
+  NULL,     /* write */
+
+  pm_dup,   /* dup */
+
+  NULL,     /* opendir */
+  NULL,     /* closedir */
+  NULL,     /* readdir */
+  NULL,     /* rewinddir */
+
+  pm_stat   /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_open
+ ****************************************************************************/
+
+static int pm_open(FAR struct file *filep, FAR const char *relpath,
+                   int oflags, mode_t mode)
+{
+  FAR struct pm_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "pm" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "pm") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct pm_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_close
+ ****************************************************************************/
+
+static int pm_close(FAR struct file *filep)
+{
+  FAR struct pm_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct pm_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_read
+ ****************************************************************************/
+
+static ssize_t pm_read(FAR struct file *filep, FAR char *buffer,
+                       size_t buflen)
+{
+  static FAR const char * const names[PM_COUNT] =
+  {
+    "NORMAL", "IDLE", "STANDBY", "SLEEP"
+  };
+
+  FAR struct pm_file_s *attr;
+  struct pm_residency_s res;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  int domain;
+  int state;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct pm_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset    = filep->f_pos;
+  linesize  = snprintf(attr->line, PM_LINELEN, "%6s %-8s %10s %14s\n",
+                       "DOMAIN", "STATE", "ENTRIES", "TIME(ms)");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (domain = 0; domain < CONFIG_PM_NDOMAINS; domain++)
+    {
+      for (state = PM_NORMAL; state < PM_COUNT && totalsize < buflen;
+           state++)
+        {
+          pm_residency(domain, state, &res);
+
+          linesize   = snprintf(attr->line, PM_LINELEN,
+                                "%6d %-8s %10lu %10lu.%03lu\n",
+                                domain, names[state],
+                                (unsigned long)res.entries,
+                                (unsigned long)res.time.tv_sec * 1000 +
+                                res.time.tv_nsec / NSEC_PER_MSEC,
+                                (unsigned long)(res.time.tv_nsec /
+                                                NSEC_PER_USEC % 1000));
+          totalsize += procfs_memcpy(attr->line, linesize,
+                                     buffer + totalsize,
+                                     buflen - totalsize, &offset);
+        }
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: pm_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pm_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct pm_file_s *oldattr;
+  FAR struct pm_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct pm_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct pm_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct pm_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pm_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "pm" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "pm") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "pm" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && ... */
@@ -50,7 +50,8 @@
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
 
-#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR)
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_CPUTIME)
 #  include <nuttx/clock.h>
 #endif
 
@@ -95,6 +96,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CPULOAD
   PROC_LOADAVG,                       /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  PROC_CPUTIME,                       /* Accumulated execution time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
@@ -154,9 +158,9 @@ struct proc_envinfo_s
  * Private Data
  ****************************************************************************/
 
-static FAR const char *g_policy[4] =
+static FAR const char *g_policy[5] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -178,6 +182,11 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
 static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
@@ -272,6 +281,13 @@ static const struct proc_node_s g_loadavg =
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+static const struct proc_node_s g_cputime =
+{
+  "cputime",       "cputime", (uint8_t)PROC_CPUTIME,     DTYPE_FILE        /* Accumulated execution time */
+};
+#endif
+
 #ifdef CONFIG_SCHED_CRITMONITOR
 static const struct proc_node_s g_critmon =
 {
@@ -316,6 +332,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_cputime,      /* Accumulated execution time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
@@ -339,6 +358,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_cputime,      /* Accumulated execution time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
@@ -443,8 +465,10 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *   Flags:      xxx                N,P,X
  *   Priority:   nnn                Decimal, 0-255
  *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC,
- *                                   SCHED_OTHER}
+ *                                   SCHED_OTHER, SCHED_DEADLINE}
  *   Sigmask:    nnnnnnnn           Hexadecimal, 32-bit
+ *   SigDropped: nnn                Signals lost for lack of memory
+ *   SigOverrun: nnn                Signals merged into a pending one
  *
  ****************************************************************************/
 
@@ -548,6 +572,22 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
   buffer    += copysize;
   remaining -= copysize;
 
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of migrations between CPUs */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "Migrations:", (unsigned long)tcb->nmigrations);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
   if (totalsize >= buflen)
     {
       return totalsize;
@@ -637,6 +677,36 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
   copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
                            &offset);
 
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the lost signal counters */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                      "SigDropped:", (unsigned long)tcb->sigdropped);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                      "SigOverrun:", (unsigned long)tcb->sigoverrun);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
   totalsize += copysize;
   return totalsize;
 }
@@ -778,6 +848,43 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_cputime
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  struct timespec thread;
+  struct timespec process;
+  size_t linesize;
+  size_t copysize;
+
+  /* Sample the execution times.  These should only fail if the thread
+   * exited sometime after the procfs entry was opened.
+   */
+
+  if (clock_cputime(procfile->pid, &thread) < 0 ||
+      clock_processtime(procfile->pid, &process) < 0)
+    {
+      return -ENOENT;
+    }
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN,
+                      "%lu.%09lu %lu.%09lu\n",
+                      (unsigned long)thread.tv_sec,
+                      (unsigned long)thread.tv_nsec,
+                      (unsigned long)process.tv_sec,
+                      (unsigned long)process.tv_nsec);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                           &offset);
+
+  return copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_critmon
  ****************************************************************************/
@@ -1103,13 +1210,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open file descriptor */
 
-  for (i = 0, file = group->tg_filelist.fl_files;
-       i < CONFIG_NFILE_DESCRIPTORS;
-       i++, file++)
+  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       /* Is there an inode associated with the file descriptor? */
 
-      if (file->f_inode)
+      file = files_fget(&group->tg_filelist, i);
+      if (file != NULL && file->f_inode)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN,
                                 "%3d %8ld %04x\n", i, (long)file->f_pos,
@@ -1146,12 +1252,17 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open socket descriptor */
 
-  for (i = 0, socket = group->tg_socketlist.sl_sockets;
-       i < CONFIG_NSOCKET_DESCRIPTORS;
-       i++, socket++)
+  for (i = 0; i < CONFIG_NSOCKET_DESCRIPTORS; i++)
     {
       /* Is there an connection associated with the socket descriptor? */
 
+      socket = group->tg_socketlist.sl_sockets[i / SOCKETS_PER_BLOCK];
+      if (socket == NULL)
+        {
+          continue;
+        }
+
+      socket += i % SOCKETS_PER_BLOCK;
       if (socket->s_conn)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN,
@@ -1454,6 +1565,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+    case PROC_CPUTIME: /* Accumulated execution time */
+      ret = proc_cputime(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
     case PROC_CRITMON: /* Critical section monitor */
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -0,0 +1,295 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsslabinfo.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/slab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_MM_SLAB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SLABINFO)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SLABINFO_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct slabinfo_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[SLABINFO_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     slabinfo_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     slabinfo_close(FAR struct file *filep);
+static ssize_t slabinfo_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     slabinfo_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     slabinfo_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations slabinfo_operations =
+{
+  slabinfo_open,      /* open */
+  slabinfo_close,     /* close */
+  slabinfo_read,      /* read */
+  NULL,               /* write */
+
+  slabinfo_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  slabinfo_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slabinfo_open
+ ****************************************************************************/
+
+static int slabinfo_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct slabinfo_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "slabinfo" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "slabinfo") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct slabinfo_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: slabinfo_close
+ ****************************************************************************/
+
+static int slabinfo_close(FAR struct file *filep)
+{
+  FAR struct slabinfo_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct slabinfo_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: slabinfo_read
+ ****************************************************************************/
+
+static ssize_t slabinfo_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct slabinfo_file_s *attr;
+  FAR struct kmem_cache_s *cache;
+  struct kmem_cacheinfo_s info;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct slabinfo_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset    = filep->f_pos;
+  linesize  = snprintf(attr->line, SLABINFO_LINELEN,
+                       "%-12s %7s %7s %7s %7s %6s %10s %10s %6s\n",
+                       "NAME", "OBJSIZE", "TOTAL", "INUSE", "CACHED",
+                       "SLABS", "ALLOCS", "HITS", "FAILS");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (cache = kmem_cache_next(NULL);
+       cache != NULL && totalsize < buflen;
+       cache = kmem_cache_next(cache))
+    {
+      kmem_cache_info(cache, &info);
+
+      linesize   = snprintf(attr->line, SLABINFO_LINELEN,
+                            "%-12s %7lu %7lu %7lu %7lu %6lu %10lu %10lu "
+                            "%6lu\n",
+                            info.name, (unsigned long)info.objsize,
+                            (unsigned long)info.ntotal,
+                            (unsigned long)(info.ntotal - info.nfree -
+                                            info.ncached),
+                            (unsigned long)info.ncached,
+                            (unsigned long)info.nslabs,
+                            (unsigned long)info.nallocs,
+                            (unsigned long)info.nhits,
+                            (unsigned long)info.nfails);
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: slabinfo_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int slabinfo_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct slabinfo_file_s *oldattr;
+  FAR struct slabinfo_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct slabinfo_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct slabinfo_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct slabinfo_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: slabinfo_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int slabinfo_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "slabinfo" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "slabinfo") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "slabinfo" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_MM_SLAB */
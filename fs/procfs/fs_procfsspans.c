@@ -0,0 +1,373 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsspans.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched_span.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_SPANS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SPANS_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct spans_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[SPANS_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     spans_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     spans_close(FAR struct file *filep);
+static ssize_t spans_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     spans_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     spans_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations spans_operations =
+{
+  spans_open,         /* open */
+  spans_close,        /* close */
+  spans_read,         /* read */
+  NULL,               /* write */
+
+  spans_dup,          /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  spans_stat          /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spans_open
+ ****************************************************************************/
+
+static int spans_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct spans_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "spans" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "spans") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct spans_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spans_close
+ ****************************************************************************/
+
+static int spans_close(FAR struct file *filep)
+{
+  FAR struct spans_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct spans_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spans_usec
+ *
+ * Description:
+ *   Convert an elapsed time in up_critmon_gettime() units to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long spans_usec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  if (elapsed == 0)
+    {
+      return 0;
+    }
+
+  up_critmon_convert(elapsed, &ts);
+  return (unsigned long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: spans_read_span
+ *
+ * Description:
+ *   Generate the output for one span:  A line with the count and minimum,
+ *   maximum and average durations in microseconds, followed by one line
+ *   for each non-empty histogram bucket giving the upper bound of the
+ *   bucket in microseconds and the number of spans that fell in it.
+ *
+ ****************************************************************************/
+
+static size_t spans_read_span(FAR struct spans_file_s *attr,
+                              FAR struct sched_span_s *span,
+                              FAR char *buffer, size_t buflen,
+                              FAR off_t *offset)
+{
+  struct sched_span_s snap;
+  irqstate_t flags;
+  uint32_t avg;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  /* Take a consistent snapshot of the statistics */
+
+  flags = enter_critical_section();
+  memcpy(&snap, span, sizeof(struct sched_span_s));
+  leave_critical_section(flags);
+
+  avg = snap.ss_count > 0 ? (uint32_t)(snap.ss_total / snap.ss_count) : 0;
+
+  linesize  = snprintf(attr->line, SPANS_LINELEN,
+                       "%-16s %10lu %10lu %10lu %10lu\n",
+                       snap.ss_name, (unsigned long)snap.ss_count,
+                       spans_usec(snap.ss_min), spans_usec(snap.ss_max),
+                       spans_usec(avg));
+  copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+  totalsize = copysize;
+
+  for (i = 0; i < SCHED_SPAN_NBUCKETS && totalsize < buflen; i++)
+    {
+      uint32_t bound;
+
+      if (snap.ss_hist[i] == 0)
+        {
+          continue;
+        }
+
+      /* Bucket i holds durations below 2^i */
+
+      bound     = i < 32 ? (UINT32_C(1) << i) - 1 : UINT32_MAX;
+      linesize  = snprintf(attr->line, SPANS_LINELEN,
+                           "  <= %10lu %10lu\n",
+                           spans_usec(bound),
+                           (unsigned long)snap.ss_hist[i]);
+      copysize  = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                buflen - totalsize, offset);
+      totalsize += copysize;
+    }
+
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spans_read
+ ****************************************************************************/
+
+static ssize_t spans_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct spans_file_s *attr;
+  FAR struct sched_span_s *span;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct spans_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  /* Generate the header line.  All times are in microseconds */
+
+  linesize  = snprintf(attr->line, SPANS_LINELEN,
+                       "%-16s %10s %10s %10s %10s\n",
+                       "SPAN", "COUNT", "MIN", "MAX", "AVG");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  /* Spans are only ever added at the head of the list, so the list may be
+   * traversed without holding any lock.
+   */
+
+  for (span = g_sched_spans; span != NULL && totalsize < buflen;
+       span = span->ss_flink)
+    {
+      totalsize += spans_read_span(attr, span, buffer + totalsize,
+                                   buflen - totalsize, &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spans_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int spans_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct spans_file_s *oldattr;
+  FAR struct spans_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct spans_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct spans_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct spans_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spans_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int spans_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "spans" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "spans") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "spans" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_SPANS */
@@ -0,0 +1,354 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsstackmon.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_STACK_MONITOR) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_STACKMON)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define STACKMON_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct stackmon_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[STACKMON_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/* State of one read, passed to the nxsched_foreach() callback */
+
+struct stackmon_read_s
+{
+  FAR struct stackmon_file_s *attr;
+  FAR char *buffer;             /* User buffer */
+  size_t buflen;                /* Size of the user buffer */
+  size_t totalsize;             /* Bytes copied so far */
+  off_t offset;                 /* Offset of the next line in the file */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     stackmon_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     stackmon_close(FAR struct file *filep);
+static ssize_t stackmon_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     stackmon_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     stackmon_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations stackmon_operations =
+{
+  stackmon_open,      /* open */
+  stackmon_close,     /* close */
+  stackmon_read,      /* read */
+  NULL,               /* write */
+
+  stackmon_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  stackmon_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stackmon_open
+ ****************************************************************************/
+
+static int stackmon_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct stackmon_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "stackmon" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "stackmon") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct stackmon_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackmon_close
+ ****************************************************************************/
+
+static int stackmon_close(FAR struct file *filep)
+{
+  FAR struct stackmon_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct stackmon_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackmon_line
+ *
+ * Description:
+ *   Format one line and copy the part of it after the file offset.
+ *
+ ****************************************************************************/
+
+static void stackmon_line(FAR struct stackmon_read_s *rd,
+                          FAR const char *pid, size_t size, size_t used,
+                          FAR const char *count, FAR const char *name)
+{
+  size_t linesize;
+
+  if (rd->totalsize < rd->buflen)
+    {
+      linesize = snprintf(rd->attr->line, STACKMON_LINELEN,
+                          "%5s %7lu %7lu %7lu %3lu%% %5s %s\n",
+                          pid, (unsigned long)size, (unsigned long)used,
+                          (unsigned long)(size - used),
+                          (unsigned long)(size > 0 ? used * 100 / size : 0),
+                          count, name);
+      rd->totalsize += procfs_memcpy(rd->attr->line, linesize,
+                                     rd->buffer + rd->totalsize,
+                                     rd->buflen - rd->totalsize,
+                                     &rd->offset);
+    }
+}
+
+/****************************************************************************
+ * Name: stackmon_thread
+ *
+ * Description:
+ *   nxsched_foreach() callback:  Report one live thread.
+ *
+ ****************************************************************************/
+
+static void stackmon_thread(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR const char *name = "";
+  char pid[8];
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  name = tcb->name;
+#endif
+
+  if (tcb->adj_stack_size > 0)
+    {
+      snprintf(pid, sizeof(pid), "%d", (int)tcb->pid);
+      stackmon_line((FAR struct stackmon_read_s *)arg, pid,
+                    tcb->adj_stack_size, tcb->stack_hwm, "-", name);
+    }
+}
+
+/****************************************************************************
+ * Name: stackmon_read
+ ****************************************************************************/
+
+static ssize_t stackmon_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct stackmon_read_s rd;
+  struct stackhist_s hist;
+  size_t linesize;
+  char count[12];
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  rd.attr = (FAR struct stackmon_file_s *)filep->f_priv;
+  DEBUGASSERT(rd.attr);
+
+  rd.buffer    = buffer;
+  rd.buflen    = buflen;
+  rd.offset    = filep->f_pos;
+
+  linesize     = snprintf(rd.attr->line, STACKMON_LINELEN,
+                          "%5s %7s %7s %7s %4s %5s %s\n",
+                          "PID", "SIZE", "USED", "FREE", "USE", "EXITS",
+                          "NAME");
+  rd.totalsize = procfs_memcpy(rd.attr->line, linesize, buffer, buflen,
+                               &rd.offset);
+
+  /* Live threads, as of the last sample */
+
+  nxsched_foreach(stackmon_thread, &rd);
+
+  /* Threads that have exited, by name */
+
+  for (i = 0; nxsched_stackmon_history(i, &hist) >= 0; i++)
+    {
+      snprintf(count, sizeof(count), "%lu", (unsigned long)hist.count);
+      stackmon_line(&rd, "-", hist.size, hist.used, count, hist.name);
+    }
+
+  filep->f_pos += rd.totalsize;
+  return rd.totalsize;
+}
+
+/****************************************************************************
+ * Name: stackmon_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int stackmon_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct stackmon_file_s *oldattr;
+  FAR struct stackmon_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct stackmon_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct stackmon_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct stackmon_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackmon_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int stackmon_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "stackmon" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "stackmon") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "stackmon" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && ... */
@@ -1061,6 +1061,18 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       goto errout_with_buffer;
     }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Index the directory tree.  Without the index, the directories will
+   * just be searched linearly.
+   */
+
+  ret = romfs_buildindex(rm);
+  if (ret < 0)
+    {
+      fwarn("WARNING: romfs_buildindex failed: %d\n", ret);
+    }
+#endif
+
   /* Mounted! */
 
   *handle = (FAR void *)rm;
@@ -1156,6 +1168,10 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           kmm_free(rm->rm_buffer);
         }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+      romfs_freeindex(rm);
+#endif
+
       nxsem_destroy(&rm->rm_sem);
       kmm_free(rm);
       return OK;
@@ -140,6 +140,17 @@
  * is mounted with a fat32 filesystem.
  */
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+/* This structure describes one entry in the directory index */
+
+struct romfs_dirindex_s
+{
+  uint32_t ri_dir;                  /* Offset to the first directory entry */
+  uint32_t ri_hash;                 /* Hash of the entry name */
+  uint32_t ri_offset;               /* Offset of the entry file header */
+};
+#endif
+
 struct romfs_file_s;
 struct romfs_mountpt_s
 {
@@ -155,6 +166,12 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Directory index, may be NULL */
+
+  FAR struct romfs_dirindex_s *rm_index;
+  uint32_t rm_nindex;               /* Number of entries in rm_index */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -229,6 +246,10 @@ int  romfs_parsefilename(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR char *pname);
 int  romfs_datastart(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR uint32_t *start);
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+int  romfs_buildindex(FAR struct romfs_mountpt_s *rm);
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
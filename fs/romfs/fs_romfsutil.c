@@ -261,6 +261,110 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+/****************************************************************************
+ * Name: romfs_namehash
+ *
+ * Description:
+ *   Return the FNV-1a hash of a path segment of namelen characters
+ *
+ ****************************************************************************/
+
+static uint32_t romfs_namehash(FAR const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u;
+
+  while (namelen-- > 0)
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: romfs_indexcompare
+ *
+ * Description:
+ *   qsort() comparison function that orders the directory index by
+ *   directory, then by name hash.
+ *
+ ****************************************************************************/
+
+static int romfs_indexcompare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct romfs_dirindex_s *ria = a;
+  FAR const struct romfs_dirindex_s *rib = b;
+
+  if (ria->ri_dir != rib->ri_dir)
+    {
+      return ria->ri_dir < rib->ri_dir ? -1 : 1;
+    }
+
+  if (ria->ri_hash != rib->ri_hash)
+    {
+      return ria->ri_hash < rib->ri_hash ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Description:
+ *   Search the directory index for entryname in the directory beginning at
+ *   dirinfo->fr_firstoffset.  Only the entries whose name hash matches
+ *   are read from the media.
+ *
+ ****************************************************************************/
+
+static int romfs_searchindex(FAR struct romfs_mountpt_s *rm,
+                             FAR const char *entryname, int entrylen,
+                             FAR struct romfs_dirinfo_s *dirinfo)
+{
+  FAR const struct romfs_dirindex_s *ri;
+  uint32_t dir = dirinfo->rd_dir.fr_firstoffset;
+  uint32_t hash = romfs_namehash(entryname, entrylen);
+  uint32_t lo = 0;
+  uint32_t hi = rm->rm_nindex;
+  uint32_t mid;
+  int ret;
+
+  /* Find the first entry with this directory and name hash */
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) >> 1;
+      ri  = &rm->rm_index[mid];
+      if (ri->ri_dir < dir || (ri->ri_dir == dir && ri->ri_hash < hash))
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  /* Then check every entry with the same hash */
+
+  for (ri = &rm->rm_index[lo];
+       lo < rm->rm_nindex && ri->ri_dir == dir && ri->ri_hash == hash;
+       lo++, ri++)
+    {
+      ret = romfs_checkentry(rm, ri->ri_offset, entryname, entrylen,
+                             dirinfo);
+      if (ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -279,6 +383,15 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Use the directory index if one was built at mount time */
+
+  if (rm->rm_index != NULL)
+    {
+      return romfs_searchindex(rm, entryname, entrylen, dirinfo);
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -998,3 +1111,141 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
 
   return -EINVAL; /* Won't get here */
 }
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Description:
+ *   This function is called as part of the ROMFS mount operation.  It walks
+ *   the whole directory tree once and builds the sorted directory index
+ *   used by romfs_finddirentry().  If this fails, the mount still works but
+ *   directories are searched linearly.
+ *
+ ****************************************************************************/
+
+int romfs_buildindex(FAR struct romfs_mountpt_s *rm)
+{
+  FAR struct romfs_dirindex_s *index = NULL;
+  FAR struct romfs_dirindex_s *newindex;
+  char name[NAME_MAX + 1];
+  uint32_t nalloc = 0;
+  uint32_t nindex = 0;
+  uint32_t dir = rm->rm_rootoffset;
+  uint32_t ndirs = 0;
+  uint32_t linkoffset;
+  uint32_t offset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t size;
+  int ret;
+
+  /* The index doubles as the queue of directories still to be walked:
+   * every directory entry appended to it is visited in turn.
+   */
+
+  for (; ; )
+    {
+      for (offset = dir; offset != 0; offset = next & RFNEXT_OFFSETMASK)
+        {
+          ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info,
+                                    &size);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          if (!IS_DIRECTORY(next) && !IS_FILE(next))
+            {
+              continue;
+            }
+
+          ret = romfs_parsefilename(rm, offset, name);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          if (nindex >= nalloc)
+            {
+              nalloc   = nalloc ? 2 * nalloc : 32;
+              newindex = (FAR struct romfs_dirindex_s *)
+                kmm_realloc(index, nalloc * sizeof(*index));
+              if (newindex == NULL)
+                {
+                  ret = -ENOMEM;
+                  goto errout;
+                }
+
+              index = newindex;
+            }
+
+          index[nindex].ri_dir    = dir;
+          index[nindex].ri_hash   = romfs_namehash(name, strlen(name));
+          index[nindex].ri_offset = offset;
+          nindex++;
+        }
+
+      /* Find the next directory to walk.  The "." and ".." entries and any
+       * other hard link to a directory lead back into the tree and are not
+       * walked again.
+       */
+
+      for (; ndirs < nindex; ndirs++)
+        {
+          offset = index[ndirs].ri_offset;
+          ret    = romfs_parsedirentry(rm, offset, &linkoffset, &next,
+                                       &info, &size);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          if (IS_DIRECTORY(next) && linkoffset == offset && info != 0)
+            {
+              break;
+            }
+        }
+
+      if (ndirs >= nindex)
+        {
+          break;
+        }
+
+      dir = info;
+      ndirs++;
+    }
+
+  qsort(index, nindex, sizeof(*index), romfs_indexcompare);
+
+  rm->rm_index  = index;
+  rm->rm_nindex = nindex;
+  return OK;
+
+errout:
+  if (index != NULL)
+    {
+      kmm_free(index);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Description:
+ *   Free the directory index when the file system is unmounted
+ *
+ ****************************************************************************/
+
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm)
+{
+  if (rm->rm_index != NULL)
+    {
+      kmm_free(rm->rm_index);
+      rm->rm_index  = NULL;
+      rm->rm_nindex = 0;
+    }
+}
+#endif
@@ -807,6 +807,9 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
   int       ret;
   size_t    len;
   int       utilization;
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  int       hitrate;
+#endif
 
   priv = (FAR struct smartfs_file_s *) filep->f_priv;
 
@@ -840,6 +843,20 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                             procfs_data.sectorsperblk);
             }
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+          /* Calculate the sector map cache hit rate */
+
+          if (procfs_data.cachehits + procfs_data.cachemisses == 0)
+            {
+              hitrate = 100;
+            }
+          else
+            {
+              hitrate = (int)((uint64_t)procfs_data.cachehits * 100 /
+                        (procfs_data.cachehits + procfs_data.cachemisses));
+            }
+#endif
+
           /* Format and return data in the buffer */
 
           len = snprintf(buffer, buflen,
@@ -851,6 +868,10 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                          "Sectors Per Block: %d\nSector Utilization:%d%%\n"
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                          "Uneven Wear Count: %d\n"
+#endif
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+                         "Map Cache Hits:    %lu\nMap Cache Misses:  %lu\n"
+                         "Map Cache Hit Rate:%d%%\n"
 #endif
                   ,
                   procfs_data.formatversion, procfs_data.namelen,
@@ -861,6 +882,11 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                   procfs_data.sectorsperblk, utilization
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                   , procfs_data.uneven_wearcount
+#endif
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+                  , (unsigned long)procfs_data.cachehits
+                  , (unsigned long)procfs_data.cachemisses
+                  , hitrate
 #endif
            );
         }
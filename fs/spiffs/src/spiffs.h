@@ -119,12 +119,27 @@ struct spiffs_sem_s
 
 /* spiffs SPI configuration struct */
 
+/* One entry of the object index lookup cache.  Maps an object index span
+ * to the page that holds it so that the object lookup pages do not have to
+ * be scanned each time a file is accessed beyond the first index page.
+ */
+
+struct spiffs_ndxcache_s
+{
+  int16_t objid;                    /* Object ID (with SPIFFS_OBJID_NDXFLAG) */
+  int16_t spndx;                    /* Object index span index */
+  int16_t pgndx;                    /* Page holding that object index span */
+};
+
 /* This structure represents the current state of an SPIFFS volume */
 
 struct spiffs_file_s;               /* Forward reference */
 
 struct spiffs_s
 {
+#ifdef CONFIG_SPIFFS_PROCFS
+  FAR struct spiffs_s *flink;       /* Supports a list of mounted volumes */
+#endif
   struct mtd_geometry_s geo;        /* FLASH geometry */
   struct spiffs_sem_s exclsem;      /* Supports mutually exclusive access */
   dq_queue_t objq;                  /* A doubly linked list of open file objects */
@@ -133,6 +148,9 @@ struct spiffs_s
   FAR uint8_t *work;                /* Secondary work buffer, size of a logical page */
   FAR uint8_t *mtd_work;            /* MTD I/O buffer for read-modify-write */
   FAR void *cache;                  /* Cache memory */
+#if CONFIG_SPIFFS_READAHEAD > 0
+  FAR uint8_t *ra_buffer;           /* Read-ahead buffer of physical pages */
+#endif
 #ifdef CONFIG_HAVE_LONG_LONG
   off64_t media_size;               /* Physical size of the SPI flash */
 #else
@@ -148,9 +166,20 @@ struct spiffs_s
   uint32_t stats_gc_runs;
 #endif
   uint32_t cache_size;              /* Cache size */
-#ifdef CONFIG_SPIFFS_CACHEDBG
   uint32_t cache_hits;              /* Number of cache hits */
   uint32_t cache_misses;            /* Number of cache misses */
+#if CONFIG_SPIFFS_READAHEAD > 0
+  uint32_t ra_hits;                 /* Reads satisfied by the read-ahead buffer */
+  uint32_t ra_fills;                /* Number of read-ahead buffer fills */
+#endif
+#if CONFIG_SPIFFS_NDXCACHE > 0
+  uint32_t ndx_hits;                /* Object index lookup cache hits */
+  uint32_t ndx_misses;              /* Object index lookup cache misses */
+  struct spiffs_ndxcache_s ndxcache[CONFIG_SPIFFS_NDXCACHE];
+#endif
+#if CONFIG_SPIFFS_READAHEAD > 0
+  int16_t ra_pgndx;                 /* First page in the read-ahead buffer */
+  uint8_t ra_npages;                /* Number of valid pages (0 = empty) */
 #endif
   int16_t free_blkndx;              /* Cursor for free blocks, block index */
   int16_t lu_blkndx;                /* Cursor when searching, block index */
@@ -175,6 +204,9 @@ struct spiffs_file_s
   uint16_t oflags;                  /* File object open flags */
   off_t size;                       /* Size of the file */
   off_t offset;                     /* Current absolute offset */
+#if CONFIG_SPIFFS_READAHEAD > 0
+  off_t rdpos;                      /* End of the last read (sequential detection) */
+#endif
 };
 
 /****************************************************************************
@@ -331,6 +363,29 @@ ssize_t spiffs_fobj_read(FAR struct spiffs_s *fs,
 void spiffs_fobj_free(FAR struct spiffs_s *fs,
                       FAR struct spiffs_file_s *fobj, bool unlink);
 
+/****************************************************************************
+ * Name: spiffs_procfs_register and spiffs_procfs_unregister
+ *
+ * Description:
+ *   Add a volume to (or remove it from) the list of mounted volumes whose
+ *   cache statistics are reported by /proc/fs/spiffs.
+ *
+ * Input Parameters:
+ *   fs     - A reference to the volume structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_PROCFS
+void spiffs_procfs_register(FAR struct spiffs_s *fs);
+void spiffs_procfs_unregister(FAR struct spiffs_s *fs);
+#else
+#  define spiffs_procfs_register(fs)
+#  define spiffs_procfs_unregister(fs)
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
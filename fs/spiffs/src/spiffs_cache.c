@@ -46,6 +46,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/mtd/mtd.h>
@@ -55,10 +56,52 @@
 #include "spiffs_core.h"
 #include "spiffs_cache.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Object index lookup cache slot for an object index span */
+
+#define SPIFFS_NDXCACHE_SLOT(objid, spndx) \
+  ((((uint16_t)(objid) * 31u) + (uint16_t)(spndx)) % CONFIG_SPIFFS_NDXCACHE)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: spiffs_cache_raget
+ *
+ * Description:
+ *  Return the address of [addr, addr + len) in the read-ahead buffer or
+ *  NULL if that region is not held there.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPIFFS_READAHEAD > 0
+static FAR uint8_t *spiffs_cache_raget(FAR struct spiffs_s *fs, off_t addr,
+                                       size_t len)
+{
+  off_t start;
+  off_t end;
+
+  if (fs->ra_npages == 0)
+    {
+      return NULL;
+    }
+
+  start = SPIFFS_PAGE_TO_PADDR(fs, fs->ra_pgndx);
+  end   = start + fs->ra_npages * SPIFFS_GEO_PAGE_SIZE(fs);
+
+  if (addr < start || addr + len > end)
+    {
+      return NULL;
+    }
+
+  return &fs->ra_buffer[addr - start];
+}
+#endif
+
 /****************************************************************************
  * Name: spiffs_cache_page_get
  *
@@ -414,14 +457,24 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
 
       /* We've already got a cache page */
 
-#ifdef CONFIG_SPIFFS_CACHEDBG
       fs->cache_hits++;
-#endif
 
       cp->last_access = cache->last_access;
       mem             = spiffs_get_cache_page(fs, cache, cp->cpndx);
       memcpy(dest, &mem[SPIFFS_PADDR_TO_PAGE_OFFSET(fs, addr)], len);
     }
+#if CONFIG_SPIFFS_READAHEAD > 0
+  else if ((op & SPIFFS_OP_TYPE_MASK) == SPIFFS_OP_T_OBJ_DA &&
+           spiffs_cache_raget(fs, addr, len) != NULL)
+    {
+      /* Data pages of a sequential read are taken from the read-ahead
+       * buffer and are not copied into the page cache.
+       */
+
+      fs->ra_hits++;
+      memcpy(dest, spiffs_cache_raget(fs, addr, len), len);
+    }
+#endif
   else
     {
       /* Check for second layer lookup */
@@ -436,9 +489,7 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
         }
       else
         {
-#ifdef CONFIG_SPIFFS_CACHEDBG
           fs->cache_misses++;
-#endif
 
           /* This operation will always free one cache page (unless all
            * already free), the result code stems from the write operation
@@ -721,3 +772,160 @@ void spiffs_cache_page_release(FAR struct spiffs_s *fs,
       cp->objid = 0;
     }
 }
+
+/****************************************************************************
+ * Name: spiffs_cache_readahead
+ *
+ * Description:
+ *   Read 'npages' physically consecutive pages starting at 'pgndx' into the
+ *   read-ahead buffer with a single FLASH read.
+ *
+ * Input Parameters:
+ *   fs     - A reference to the SPIFFS volume object instance
+ *   pgndx  - First page to read
+ *   npages - Number of pages to read (at most CONFIG_SPIFFS_READAHEAD)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPIFFS_READAHEAD > 0
+void spiffs_cache_readahead(FAR struct spiffs_s *fs, int16_t pgndx,
+                            int npages)
+{
+  ssize_t ret;
+
+  DEBUGASSERT(npages > 0 && npages <= CONFIG_SPIFFS_READAHEAD);
+
+  if (fs->ra_buffer == NULL)
+    {
+      return;
+    }
+
+  fs->ra_npages = 0;
+  ret = spiffs_mtd_read(fs, SPIFFS_PAGE_TO_PADDR(fs, pgndx),
+                        npages * SPIFFS_GEO_PAGE_SIZE(fs), fs->ra_buffer);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_mtd_read() failed: %d\n", (int)ret);
+      return;
+    }
+
+  spiffs_cacheinfo("Read-ahead pgndx %04x npages %d\n", pgndx, npages);
+
+  fs->ra_pgndx  = pgndx;
+  fs->ra_npages = npages;
+  fs->ra_fills++;
+}
+
+/****************************************************************************
+ * Name: spiffs_cache_rainvalidate
+ *
+ * Description:
+ *   Discard the read-ahead buffer if it overlaps [addr, addr + len).
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   addr  - Start of the modified FLASH region
+ *   len   - The size of the modified FLASH region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spiffs_cache_rainvalidate(FAR struct spiffs_s *fs, off_t addr,
+                               size_t len)
+{
+  off_t start;
+  off_t end;
+
+  if (fs->ra_npages > 0)
+    {
+      start = SPIFFS_PAGE_TO_PADDR(fs, fs->ra_pgndx);
+      end   = start + fs->ra_npages * SPIFFS_GEO_PAGE_SIZE(fs);
+
+      if (addr < end && addr + len > start)
+        {
+          fs->ra_npages = 0;
+        }
+    }
+}
+#endif /* CONFIG_SPIFFS_READAHEAD > 0 */
+
+#if CONFIG_SPIFFS_NDXCACHE > 0
+/****************************************************************************
+ * Name: spiffs_ndxcache_lookup
+ *
+ * Description:
+ *   Look up the page holding object index span 'spndx' of object 'objid'
+ *   in the object index lookup cache.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID (including SPIFFS_OBJID_NDXFLAG)
+ *   spndx - The object index span index
+ *   pgndx - The location to return the page index
+ *
+ * Returned Value:
+ *   True if the entry was found.
+ *
+ ****************************************************************************/
+
+bool spiffs_ndxcache_lookup(FAR struct spiffs_s *fs, int16_t objid,
+                            int16_t spndx, FAR int16_t *pgndx)
+{
+  FAR struct spiffs_ndxcache_s *nc;
+
+  nc = &fs->ndxcache[SPIFFS_NDXCACHE_SLOT(objid, spndx)];
+  if (nc->objid == objid && nc->spndx == spndx)
+    {
+      fs->ndx_hits++;
+      *pgndx = nc->pgndx;
+      return true;
+    }
+
+  fs->ndx_misses++;
+  return false;
+}
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_insert
+ *
+ * Description:
+ *   Record the page holding object index span 'spndx' of object 'objid'.
+ *
+ ****************************************************************************/
+
+void spiffs_ndxcache_insert(FAR struct spiffs_s *fs, int16_t objid,
+                            int16_t spndx, int16_t pgndx)
+{
+  FAR struct spiffs_ndxcache_s *nc;
+
+  nc        = &fs->ndxcache[SPIFFS_NDXCACHE_SLOT(objid, spndx)];
+  nc->objid = objid;
+  nc->spndx = spndx;
+  nc->pgndx = pgndx;
+}
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_drop
+ *
+ * Description:
+ *   Forget the page holding object index span 'spndx' of object 'objid'.
+ *
+ ****************************************************************************/
+
+void spiffs_ndxcache_drop(FAR struct spiffs_s *fs, int16_t objid,
+                          int16_t spndx)
+{
+  FAR struct spiffs_ndxcache_s *nc;
+
+  nc = &fs->ndxcache[SPIFFS_NDXCACHE_SLOT(objid, spndx)];
+  if (nc->objid == objid && nc->spndx == spndx)
+    {
+      nc->objid = 0;
+    }
+}
+#endif /* CONFIG_SPIFFS_NDXCACHE > 0 */
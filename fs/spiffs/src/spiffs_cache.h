@@ -47,7 +47,9 @@ extern "C"
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -267,6 +269,94 @@ FAR struct spiffs_cache_page_s *
 void spiffs_cache_page_release(FAR struct spiffs_s *fs,
                                FAR struct spiffs_cache_page_s *cp);
 
+/****************************************************************************
+ * Name: spiffs_cache_readahead
+ *
+ * Description:
+ *   Read 'npages' physically consecutive pages starting at 'pgndx' into the
+ *   read-ahead buffer with a single FLASH read.  The read-ahead buffer is
+ *   separate from the page cache so that streaming through a large file
+ *   does not evict the lookup and index pages held there.
+ *
+ * Input Parameters:
+ *   fs     - A reference to the SPIFFS volume object instance
+ *   pgndx  - First page to read
+ *   npages - Number of pages to read (at most CONFIG_SPIFFS_READAHEAD)
+ *
+ * Returned Value:
+ *   None.  On a read failure the buffer is left empty and reads simply
+ *   fall through to the page cache.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPIFFS_READAHEAD > 0
+void spiffs_cache_readahead(FAR struct spiffs_s *fs, int16_t pgndx,
+                            int npages);
+#endif
+
+/****************************************************************************
+ * Name: spiffs_cache_rainvalidate
+ *
+ * Description:
+ *   Discard the read-ahead buffer if it overlaps the FLASH region
+ *   [addr, addr + len).  Called for every FLASH write and erase.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   addr  - Start of the modified FLASH region
+ *   len   - The size of the modified FLASH region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPIFFS_READAHEAD > 0
+void spiffs_cache_rainvalidate(FAR struct spiffs_s *fs, off_t addr,
+                               size_t len);
+#else
+#  define spiffs_cache_rainvalidate(fs,a,l)
+#endif
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_lookup
+ *
+ * Description:
+ *   Look up the page holding object index span 'spndx' of object 'objid'
+ *   in the object index lookup cache.  A hit is only a hint: the caller
+ *   must verify the page header and call spiffs_ndxcache_drop() if it does
+ *   not match.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID (including SPIFFS_OBJID_NDXFLAG)
+ *   spndx - The object index span index
+ *   pgndx - The location to return the page index
+ *
+ * Returned Value:
+ *   True if the entry was found.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPIFFS_NDXCACHE > 0
+bool spiffs_ndxcache_lookup(FAR struct spiffs_s *fs, int16_t objid,
+                            int16_t spndx, FAR int16_t *pgndx);
+
+/****************************************************************************
+ * Name: spiffs_ndxcache_insert and spiffs_ndxcache_drop
+ *
+ * Description:
+ *   Record (or forget) the page holding object index span 'spndx' of
+ *   object 'objid'.
+ *
+ ****************************************************************************/
+
+void spiffs_ndxcache_insert(FAR struct spiffs_s *fs, int16_t objid,
+                            int16_t spndx, int16_t pgndx);
+void spiffs_ndxcache_drop(FAR struct spiffs_s *fs, int16_t objid,
+                          int16_t spndx);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -142,6 +142,57 @@ static int spiffs_page_data_check(FAR struct spiffs_s *fs,
   return ret;
 }
 
+/****************************************************************************
+ * Name: spiffs_objndx_locate
+ *
+ * Description:
+ *   Find the page holding object index span 'spndx' of object 'objid'.  The
+ *   object index lookup cache is consulted first; a cached page is only
+ *   used if its header still describes that object index span, otherwise
+ *   the object lookup pages are scanned.
+ *
+ ****************************************************************************/
+
+static int spiffs_objndx_locate(FAR struct spiffs_s *fs, int16_t objid,
+                                int16_t spndx, FAR int16_t *pgndx)
+{
+  int ret;
+
+  objid |= SPIFFS_OBJID_NDXFLAG;
+
+#if CONFIG_SPIFFS_NDXCACHE > 0
+  if (spiffs_ndxcache_lookup(fs, objid, spndx, pgndx))
+    {
+      struct spiffs_page_header_s ph;
+
+      ret = spiffs_cache_read(fs, SPIFFS_OP_T_OBJNDX | SPIFFS_OP_C_READ,
+                              objid, SPIFFS_PAGE_TO_PADDR(fs, *pgndx),
+                              sizeof(struct spiffs_page_header_s),
+                              (FAR uint8_t *)&ph);
+      if (ret >= 0 && ph.objid == objid &&
+          spiffs_validate_objndx(&ph, objid, spndx) == OK)
+        {
+          return OK;
+        }
+
+      /* The index page has moved */
+
+      spiffs_ndxcache_drop(fs, objid, spndx);
+    }
+#endif
+
+  ret = spiffs_objlu_find_id_and_span(fs, objid, spndx, 0, pgndx);
+
+#if CONFIG_SPIFFS_NDXCACHE > 0
+  if (ret >= 0)
+    {
+      spiffs_ndxcache_insert(fs, objid, spndx, *pgndx);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: spiffs_page_index_check
  *
@@ -1954,14 +2005,11 @@ ssize_t spiffs_fobj_append(FAR struct spiffs_s *fs,
                     }
                   else
                     {
-                      ret =
-                        spiffs_objlu_find_id_and_span(fs,
-                                                      fobj->objid | SPIFFS_OBJID_NDXFLAG,
-                                                      cur_objndx_spndx, 0,
-                                                      &pgndx);
+                      ret = spiffs_objndx_locate(fs, fobj->objid,
+                                                 cur_objndx_spndx, &pgndx);
                       if (ret < 0)
                         {
-                          ferr("ERROR: spiffs_objlu_find_id_and_span() failed: %d\n",
+                          ferr("ERROR: spiffs_objndx_locate() failed: %d\n",
                                ret);
                           return ret;
                         }
@@ -2395,14 +2443,11 @@ ssize_t spiffs_fobj_modify(FAR struct spiffs_s *fs,
                 }
               else
                 {
-                  ret =
-                    spiffs_objlu_find_id_and_span(fs,
-                                                  fobj->objid | SPIFFS_OBJID_NDXFLAG,
-                                                  cur_objndx_spndx, 0,
-                                                  &pgndx);
+                  ret = spiffs_objndx_locate(fs, fobj->objid,
+                                             cur_objndx_spndx, &pgndx);
                   if (ret < 0)
                     {
-                      ferr("ERROR: spiffs_objlu_find_id_and_span() failed: %d\n",
+                      ferr("ERROR: spiffs_objndx_locate() failed: %d\n",
                            ret);
                       return ret;
                     }
@@ -2874,13 +2919,11 @@ int spiffs_fobj_truncate(FAR struct spiffs_s *fs,
             }
           else
             {
-              ret = spiffs_objlu_find_id_and_span(fs,
-                                                  fobj->objid | SPIFFS_OBJID_NDXFLAG,
-                                                  cur_objndx_spndx, 0,
-                                                  &objndx_pgndx);
+              ret = spiffs_objndx_locate(fs, fobj->objid,
+                                         cur_objndx_spndx, &objndx_pgndx);
               if (ret < 0)
                 {
-                  ferr("ERROR: spiffs_objlu_find_id_and_span() failed: %d\n",
+                  ferr("ERROR: spiffs_objndx_locate() failed: %d\n",
                        ret);
                   return ret;
                 }
@@ -3239,11 +3282,20 @@ ssize_t spiffs_object_read(FAR struct spiffs_s *fs,
   int16_t data_spndx;
   int16_t cur_objndx_spndx;
   int16_t prev_objndx_spndx;
+#if CONFIG_SPIFFS_READAHEAD > 0
+  bool sequential;
+#endif
   int ret = OK;
 
   objhdr            = (FAR struct spiffs_pgobj_ndxheader_s *)fs->work;
   objndx            = (FAR struct spiffs_page_objndx_s *)fs->work;
 
+#if CONFIG_SPIFFS_READAHEAD > 0
+  /* Read-ahead is only worthwhile if this read continues the last one */
+
+  sequential        = (offset == fobj->rdpos);
+#endif
+
   data_spndx        = offset / SPIFFS_DATA_PAGE_SIZE(fs);
   cur_offset        = offset;
   prev_objndx_spndx = (int16_t)-1;
@@ -3272,14 +3324,12 @@ ssize_t spiffs_object_read(FAR struct spiffs_s *fs,
                 }
               else
                 {
-                  ret =
-                    spiffs_objlu_find_id_and_span(fs,
-                                                  fobj->objid | SPIFFS_OBJID_NDXFLAG,
-                                                  cur_objndx_spndx, 0,
-                                                  &objndx_pgndx);
+                  ret = spiffs_objndx_locate(fs, fobj->objid,
+                                             cur_objndx_spndx,
+                                             &objndx_pgndx);
                   if (ret < 0)
                     {
-                      ferr("ERROR: spiffs_objlu_find_id_and_span() failed: %d\n",
+                      ferr("ERROR: spiffs_objndx_locate() failed: %d\n",
                            ret);
                       return ret;
                     }
@@ -3357,6 +3407,57 @@ ssize_t spiffs_object_read(FAR struct spiffs_s *fs,
           break;
         }
 
+#if CONFIG_SPIFFS_READAHEAD > 0
+      /* On a sequential read, fetch the following data pages with a single
+       * FLASH read if they are physically consecutive.
+       */
+
+      if (sequential &&
+          (fs->ra_npages == 0 || data_pgndx < fs->ra_pgndx ||
+           data_pgndx >= fs->ra_pgndx + fs->ra_npages))
+        {
+          FAR int16_t *ndxtab;
+          int maxpages;
+          int npages;
+          int first;
+          int last;
+
+          if (cur_objndx_spndx == 0)
+            {
+              ndxtab = (FAR int16_t *)((FAR uint8_t *)objhdr +
+                         sizeof(struct spiffs_pgobj_ndxheader_s));
+              first  = data_spndx;
+              last   = SPIFFS_OBJHDR_NDXLEN(fs);
+            }
+          else
+            {
+              ndxtab = (FAR int16_t *)((FAR uint8_t *)objndx +
+                         sizeof(struct spiffs_page_objndx_s));
+              first  = SPIFFS_OBJNDX_ENTRY(fs, data_spndx);
+              last   = SPIFFS_OBJNDX_LEN(fs);
+            }
+
+          /* Don't read beyond the end of the file */
+
+          maxpages = (fobj->size - 1) / SPIFFS_DATA_PAGE_SIZE(fs) -
+                     data_spndx + 1;
+          maxpages = MIN(maxpages, CONFIG_SPIFFS_READAHEAD);
+          last     = MIN(last, first + maxpages);
+
+          for (npages = 1;
+               first + npages < last &&
+               ndxtab[first + npages] == data_pgndx + npages;
+               npages++)
+            {
+            }
+
+          if (npages > 1)
+            {
+              spiffs_cache_readahead(fs, data_pgndx, npages);
+            }
+        }
+#endif
+
       ret = spiffs_page_data_check(fs, fobj, data_pgndx, data_spndx);
       if (ret < 0)
         {
@@ -3382,6 +3483,10 @@ ssize_t spiffs_object_read(FAR struct spiffs_s *fs,
       data_spndx++;
     }
 
+#if CONFIG_SPIFFS_READAHEAD > 0
+  fobj->rdpos = offset + len;
+#endif
+
   return len;
 }
 
@@ -50,6 +50,7 @@
 
 #include "spiffs.h"
 #include "spiffs_mtd.h"
+#include "spiffs_cache.h"
 
 /****************************************************************************
  * Private Functions
@@ -106,6 +107,7 @@ ssize_t spiffs_mtd_write(FAR struct spiffs_s *fs, off_t offset, size_t len,
 
   DEBUGASSERT(fs != NULL && fs->mtd != NULL && src != NULL && len > 0);
 
+  spiffs_cache_rainvalidate(fs, offset, len);
   remaining = len;
 
 #ifdef CONFIG_MTD_BYTE_WRITE
@@ -468,6 +470,8 @@ ssize_t spiffs_mtd_erase(FAR struct spiffs_s *fs, off_t offset, size_t len)
   DEBUGASSERT(offset == erasesize * eblkstart);
   DEBUGASSERT(len    == erasesize * eblkend - offset);
 
+  spiffs_cache_rainvalidate(fs, offset, len);
+
   nerased = MTD_ERASE(fs->mtd, eblkstart, eblkend - eblkstart);
   if (nerased < 0)
     {
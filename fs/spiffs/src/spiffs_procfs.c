@@ -0,0 +1,343 @@
+/****************************************************************************
+ * fs/spiffs/src/spiffs_procfs.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "spiffs.h"
+
+#ifdef CONFIG_SPIFFS_PROCFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the buffer that holds the formatted statistics of all volumes */
+
+#define SPIFFS_PROCFS_TEXTLEN 512
+
+#if CONFIG_SPIFFS_READAHEAD > 0
+#  define SPIFFS_RAHITS(fs)     ((fs)->ra_hits)
+#  define SPIFFS_RAFILLS(fs)    ((fs)->ra_fills)
+#else
+#  define SPIFFS_RAHITS(fs)     0
+#  define SPIFFS_RAFILLS(fs)    0
+#endif
+
+#if CONFIG_SPIFFS_NDXCACHE > 0
+#  define SPIFFS_NDXHITS(fs)    ((fs)->ndx_hits)
+#  define SPIFFS_NDXMISSES(fs)  ((fs)->ndx_misses)
+#else
+#  define SPIFFS_NDXHITS(fs)    0
+#  define SPIFFS_NDXMISSES(fs)  0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct spiffs_procfs_file_s
+{
+  struct procfs_file_s base;          /* Base open file structure */
+  size_t textlen;                     /* Number of valid characters in text[] */
+  char text[SPIFFS_PROCFS_TEXTLEN];   /* Formatted statistics */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     spiffs_procfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     spiffs_procfs_close(FAR struct file *filep);
+static ssize_t spiffs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     spiffs_procfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     spiffs_procfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of mounted SPIFFS volumes */
+
+static mutex_t g_spiffs_vollock = MUTEX_INITIALIZER;
+static FAR struct spiffs_s *g_spiffs_volumes;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs/procfs/fs_procfs.c -- this structure is explicitly externed there */
+
+const struct procfs_operations spiffs_procfsoperations =
+{
+  spiffs_procfs_open,   /* open */
+  spiffs_procfs_close,  /* close */
+  spiffs_procfs_read,   /* read */
+  NULL,                 /* write */
+
+  spiffs_procfs_dup,    /* dup */
+
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+
+  spiffs_procfs_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_procfs_open
+ ****************************************************************************/
+
+static int spiffs_procfs_open(FAR struct file *filep,
+                              FAR const char *relpath, int oflags,
+                              mode_t mode)
+{
+  FAR struct spiffs_procfs_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  if (strcmp(relpath, "fs/spiffs") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  attr = kmm_zalloc(sizeof(struct spiffs_procfs_file_s));
+  if (attr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_close
+ ****************************************************************************/
+
+static int spiffs_procfs_close(FAR struct file *filep)
+{
+  FAR struct spiffs_procfs_file_s *attr;
+
+  attr = (FAR struct spiffs_procfs_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_read
+ ****************************************************************************/
+
+static ssize_t spiffs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                  size_t buflen)
+{
+  FAR struct spiffs_procfs_file_s *attr;
+  FAR struct spiffs_s *fs;
+  off_t offset;
+  ssize_t ret;
+  size_t len;
+  int i;
+
+  attr = (FAR struct spiffs_procfs_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Take a snapshot of the statistics on the first read so that they stay
+   * consistent if the file is read in pieces.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      len = snprintf(attr->text, SPIFFS_PROCFS_TEXTLEN,
+                     "Vol     Hits   Misses   RAHits  RAFills  "
+                     "NdxHits NdxMisses\n");
+
+      ret = nxmutex_lock(&g_spiffs_vollock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (fs = g_spiffs_volumes, i = 0;
+           fs != NULL && len < SPIFFS_PROCFS_TEXTLEN;
+           fs = fs->flink, i++)
+        {
+          len += snprintf(&attr->text[len], SPIFFS_PROCFS_TEXTLEN - len,
+                          "%3d %8lu %8lu %8lu %8lu %8lu %9lu\n", i,
+                          (unsigned long)fs->cache_hits,
+                          (unsigned long)fs->cache_misses,
+                          (unsigned long)SPIFFS_RAHITS(fs),
+                          (unsigned long)SPIFFS_RAFILLS(fs),
+                          (unsigned long)SPIFFS_NDXHITS(fs),
+                          (unsigned long)SPIFFS_NDXMISSES(fs));
+        }
+
+      nxmutex_unlock(&g_spiffs_vollock);
+
+      /* The output is truncated if there are very many volumes */
+
+      if (len >= SPIFFS_PROCFS_TEXTLEN)
+        {
+          len = SPIFFS_PROCFS_TEXTLEN - 1;
+        }
+
+      attr->textlen = len;
+    }
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(attr->text, attr->textlen, buffer, buflen, &offset);
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_dup
+ ****************************************************************************/
+
+static int spiffs_procfs_dup(FAR const struct file *oldp,
+                             FAR struct file *newp)
+{
+  FAR struct spiffs_procfs_file_s *oldattr;
+  FAR struct spiffs_procfs_file_s *newattr;
+
+  oldattr = (FAR struct spiffs_procfs_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  newattr = kmm_malloc(sizeof(struct spiffs_procfs_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct spiffs_procfs_file_s));
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_stat
+ ****************************************************************************/
+
+static int spiffs_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  if (strcmp(relpath, "fs/spiffs") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_procfs_register
+ *
+ * Description:
+ *   Add a volume to the list of mounted volumes reported by
+ *   /proc/fs/spiffs.
+ *
+ ****************************************************************************/
+
+void spiffs_procfs_register(FAR struct spiffs_s *fs)
+{
+  nxmutex_lock(&g_spiffs_vollock);
+  fs->flink        = g_spiffs_volumes;
+  g_spiffs_volumes = fs;
+  nxmutex_unlock(&g_spiffs_vollock);
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_unregister
+ *
+ * Description:
+ *   Remove a volume from the list of mounted volumes.
+ *
+ ****************************************************************************/
+
+void spiffs_procfs_unregister(FAR struct spiffs_s *fs)
+{
+  FAR struct spiffs_s **pprev;
+
+  nxmutex_lock(&g_spiffs_vollock);
+  for (pprev = &g_spiffs_volumes; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (*pprev == fs)
+        {
+          *pprev = fs->flink;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_spiffs_vollock);
+}
+
+#endif /* CONFIG_SPIFFS_PROCFS */
@@ -1445,9 +1445,14 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
   addrmask   = (sizeof(FAR void *) - 1);
   cache_size = (CONFIG_SPIFFS_CACHE_SIZE + addrmask) & ~addrmask;
 
-  /* Don't let the cache size exceed the maximum that is needed */
+  /* Don't let the cache size exceed the maximum that can be used:  The
+   * cache page allocation map has 32 bits; each cache page also carries a
+   * header.
+   */
 
-  cache_max  = SPIFFS_GEO_PAGE_SIZE(fs) << 5;
+  cache_max  = sizeof(struct spiffs_cache_s) +
+               32 * SPIFFS_CACHE_PAGE_SIZE(fs);
+  cache_max  = (cache_max + addrmask) & ~addrmask;
   if (cache_size > cache_max)
     {
       cache_size = cache_max;
@@ -1467,6 +1472,19 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
 
   spiffs_cache_initialize(fs);
 
+#if CONFIG_SPIFFS_READAHEAD > 0
+  /* Allocate the read-ahead buffer.  Sequential reads still work without
+   * it, so failing to allocate it is not fatal.
+   */
+
+  fs->ra_buffer = (FAR uint8_t *)
+    kmm_malloc(CONFIG_SPIFFS_READAHEAD * SPIFFS_GEO_PAGE_SIZE(fs));
+  if (fs->ra_buffer == NULL)
+    {
+      fwarn("WARNING: Failed to allocate read-ahead buffer\n");
+    }
+#endif
+
   /* Allocate the memory work buffer comprising 3*config->page_size bytes
    * used throughout all file system operations.
    *
@@ -1528,6 +1546,7 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
 
   /* Return the new file system handle */
 
+  spiffs_procfs_register(fs);
   *handle = (FAR void *)fs;
   return OK;
 
@@ -1535,6 +1554,13 @@ errout_with_work:
   kmm_free(fs->work);
 
 errout_with_cache:
+#if CONFIG_SPIFFS_READAHEAD > 0
+  if (fs->ra_buffer != NULL)
+    {
+      kmm_free(fs->ra_buffer);
+    }
+
+#endif
   kmm_free(fs->cache);
 
 errout_with_volume:
@@ -1579,6 +1605,8 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
       spiffs_fobj_free(fs, fobj, false);
     }
 
+  spiffs_procfs_unregister(fs);
+
   /* Free allocated working buffers */
 
   if (fs->work != NULL)
@@ -1591,6 +1619,13 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
       kmm_free(fs->cache);
     }
 
+#if CONFIG_SPIFFS_READAHEAD > 0
+  if (fs->ra_buffer != NULL)
+    {
+      kmm_free(fs->ra_buffer);
+    }
+#endif
+
   /* Free the volume memory (note that the semaphore is now stale!) */
 
   nxsem_destroy(&fs->exclsem.sem);
@@ -38,6 +38,9 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
+#ifdef CONFIG_FS_TMPFS_GRAN
+#  include <nuttx/mm/gran.h>
+#endif
 
 #include "fs_tmpfs.h"
 
@@ -51,8 +54,11 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
+#define TMPFS_PAGESIZE CONFIG_FS_TMPFS_PAGESIZE
+
+#if defined(CONFIG_FS_TMPFS_GRAN) && \
+    (TMPFS_PAGESIZE & (TMPFS_PAGESIZE - 1)) != 0
+#  error CONFIG_FS_TMPFS_PAGESIZE must be a power of two
 #endif
 
 #define tmpfs_lock_file(tfo) \
@@ -78,8 +84,19 @@ static int  tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static FAR uint8_t *tmpfs_alloc_pages(size_t npages);
+static void tmpfs_free_pages(FAR uint8_t *pages, size_t npages);
+static void tmpfs_free_page(FAR struct tmpfs_file_s *tfo, size_t index);
+static void tmpfs_update_alloc(FAR struct tmpfs_file_s *tfo);
+static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, size_t pos,
+              FAR uint8_t *buffer, size_t len);
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t pos,
+              FAR const uint8_t *buffer, size_t len);
+static int  tmpfs_linearize_file(FAR struct tmpfs_file_s *tfo,
+              FAR void **ppv);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -151,6 +168,20 @@ static void tmpfs_stat_common(FAR struct tmpfs_object_s *to,
 static int  tmpfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               FAR struct stat *buf);
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_GRAN
+/* The page pool shared by all TMPFS mounts.  It is carved out of the heap
+ * by the first mount and kept, since unlinked files that are still open
+ * may outlive their mount.
+ */
+
+static GRAN_HANDLE g_tmpfs_gran;
+static FAR uint8_t *g_tmpfs_granbase;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -344,75 +375,345 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_alloc_pages
+ *
+ * Description:
+ *   Allocate 'npages' contiguous pages, from the granule allocator if it
+ *   is enabled and has room, otherwise from the heap.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_alloc_pages(size_t npages)
+{
+  size_t size = npages * TMPFS_PAGESIZE;
+
+#ifdef CONFIG_FS_TMPFS_GRAN
+  if (g_tmpfs_gran != NULL)
+    {
+      FAR uint8_t *pages = (FAR uint8_t *)gran_alloc(g_tmpfs_gran, size);
+      if (pages != NULL)
+        {
+          return pages;
+        }
+    }
+#endif
+
+  return (FAR uint8_t *)kmm_malloc(size);
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ ****************************************************************************/
+
+static void tmpfs_free_pages(FAR uint8_t *pages, size_t npages)
+{
+#ifdef CONFIG_FS_TMPFS_GRAN
+  if (pages >= g_tmpfs_granbase &&
+      pages < g_tmpfs_granbase + CONFIG_FS_TMPFS_GRAN_SIZE)
+    {
+      gran_free(g_tmpfs_gran, pages, npages * TMPFS_PAGESIZE);
+      return;
+    }
+#endif
+
+  kmm_free(pages);
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_page
+ *
+ * Description:
+ *   Release one page of a file.  Pages that are part of the contiguous
+ *   FIOC_MMAP copy are released with it and kept for re-use until then.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_page(FAR struct tmpfs_file_s *tfo, size_t index)
+{
+  if (index >= tfo->tfo_nlinear)
+    {
+      tmpfs_free_pages(tfo->tfo_pages[index], 1);
+    }
+
+  tfo->tfo_pages[index] = NULL;
+}
+
+/****************************************************************************
+ * Name: tmpfs_update_alloc
+ ****************************************************************************/
+
+static void tmpfs_update_alloc(FAR struct tmpfs_file_s *tfo)
+{
+  size_t npages = tfo->tfo_nlinear;
+
+  if (tfo->tfo_npages > npages)
+    {
+      npages = tfo->tfo_npages;
+    }
+
+  tfo->tfo_alloc = sizeof(struct tmpfs_file_s) +
+                   tfo->tfo_nslots * sizeof(FAR uint8_t *) +
+                   npages * TMPFS_PAGESIZE;
+}
+
 /****************************************************************************
  * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the size of a file by adding or releasing pages.  The data
+ *   already in the file is not moved.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  size_t npages;
+  size_t i;
 
-  /* Check if the current allocation is sufficient */
+  npages = (newsize + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE;
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+  if (npages > tfo->tfo_npages)
+    {
+      /* Growing.  Make room in the page list first; it grows geometrically
+       * so that appending stays cheap.
+       */
 
-  /* Are we growing or shrinking the object? */
+      if (npages > tfo->tfo_nslots)
+        {
+          FAR uint8_t **newpages;
+          size_t nslots;
+
+          nslots = tfo->tfo_nslots < 4 ? 4 : 2 * tfo->tfo_nslots;
+          if (nslots < npages)
+            {
+              nslots = npages;
+            }
 
-  if (objsize <= oldtfo->tfo_alloc)
+          newpages = (FAR uint8_t **)
+            kmm_realloc(tfo->tfo_pages, nslots * sizeof(FAR uint8_t *));
+          if (newpages == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          tfo->tfo_pages  = newpages;
+          tfo->tfo_nslots = nslots;
+        }
+
+      for (i = tfo->tfo_npages; i < npages; i++)
+        {
+          if (i < tfo->tfo_nlinear)
+            {
+              tfo->tfo_pages[i] = tfo->tfo_linear + i * TMPFS_PAGESIZE;
+            }
+          else
+            {
+              tfo->tfo_pages[i] = tmpfs_alloc_pages(1);
+              if (tfo->tfo_pages[i] == NULL)
+                {
+                  /* Give back what was added and leave the size alone */
+
+                  while (i-- > tfo->tfo_npages)
+                    {
+                      tmpfs_free_page(tfo, i);
+                    }
+
+                  return -ENOMEM;
+                }
+            }
+        }
+    }
+  else
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      /* Shrinking (or not changing the number of pages) */
 
-      if (newsize > 0)
+      for (i = npages; i < tfo->tfo_npages; i++)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          tmpfs_free_page(tfo, i);
+        }
 
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+      if (npages == 0)
+        {
+          if (tfo->tfo_linear != NULL)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+              tmpfs_free_pages(tfo->tfo_linear, tfo->tfo_nlinear);
+              tfo->tfo_linear  = NULL;
+              tfo->tfo_nlinear = 0;
+            }
 
-              oldtfo->tfo_size = newsize;
-              return OK;
+          if (tfo->tfo_pages != NULL)
+            {
+              kmm_free(tfo->tfo_pages);
+              tfo->tfo_pages  = NULL;
+              tfo->tfo_nslots = 0;
             }
         }
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  tfo->tfo_npages = npages;
+  tfo->tfo_size   = newsize;
+  tmpfs_update_alloc(tfo);
+  return OK;
+}
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+/****************************************************************************
+ * Name: tmpfs_copyout
+ *
+ * Description:
+ *   Copy 'len' bytes of file data starting at 'pos' to 'buffer'.
+ *
+ ****************************************************************************/
 
-  /* Realloc the file object */
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, size_t pos,
+                          FAR uint8_t *buffer, size_t len)
+{
+  size_t offset;
+  size_t ncopy;
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
+  while (len > 0)
+    {
+      offset = pos % TMPFS_PAGESIZE;
+      ncopy  = TMPFS_PAGESIZE - offset;
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      memcpy(buffer, tfo->tfo_pages[pos / TMPFS_PAGESIZE] + offset, ncopy);
+
+      pos    += ncopy;
+      buffer += ncopy;
+      len    -= ncopy;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_copyin
+ *
+ * Description:
+ *   Copy 'len' bytes from 'buffer' into the file at 'pos', or zero them if
+ *   'buffer' is NULL.  The pages must already exist.
+ *
+ ****************************************************************************/
+
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t pos,
+                         FAR const uint8_t *buffer, size_t len)
+{
+  FAR uint8_t *dest;
+  size_t offset;
+  size_t ncopy;
+
+  while (len > 0)
+    {
+      offset = pos % TMPFS_PAGESIZE;
+      ncopy  = TMPFS_PAGESIZE - offset;
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      dest = tfo->tfo_pages[pos / TMPFS_PAGESIZE] + offset;
+      if (buffer != NULL)
+        {
+          memcpy(dest, buffer, ncopy);
+          buffer += ncopy;
+        }
+      else
+        {
+          memset(dest, 0, ncopy);
+        }
+
+      pos += ncopy;
+      len -= ncopy;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_linearize_file
+ *
+ * Description:
+ *   Return the address of the file data as one contiguous region for
+ *   FIOC_MMAP.  Nothing is copied if the pages already happen to be
+ *   contiguous (always true for a file of one page, and for a file that
+ *   was mapped before and has not grown since).  Otherwise all pages are
+ *   copied once into a single allocation that then backs the file, so
+ *   reads, writes and the mapping all see the same memory.
+ *
+ *   As with any memory mapping without an MMU, a mapping does not survive
+ *   the file being truncated to zero, or being grown and then mapped
+ *   again.
+ *
+ ****************************************************************************/
+
+static int tmpfs_linearize_file(FAR struct tmpfs_file_s *tfo,
+                                FAR void **ppv)
+{
+  FAR uint8_t *linear;
+  size_t i;
+
+  if (tfo->tfo_npages == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 1; i < tfo->tfo_npages; i++)
+    {
+      if (tfo->tfo_pages[i] != tfo->tfo_pages[0] + i * TMPFS_PAGESIZE)
+        {
+          break;
+        }
+    }
+
+  if (i >= tfo->tfo_npages)
+    {
+      *ppv = tfo->tfo_pages[0];
+      return OK;
+    }
+
+  linear = tmpfs_alloc_pages(tfo->tfo_npages);
+  if (linear == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Adjust the reference in the parent directory entry */
+  for (i = 0; i < tfo->tfo_npages; i++)
+    {
+      memcpy(linear + i * TMPFS_PAGESIZE, tfo->tfo_pages[i],
+             TMPFS_PAGESIZE);
+      tmpfs_free_page(tfo, i);
+      tfo->tfo_pages[i] = linear + i * TMPFS_PAGESIZE;
+    }
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+  if (tfo->tfo_linear != NULL)
+    {
+      tmpfs_free_pages(tfo->tfo_linear, tfo->tfo_nlinear);
+    }
 
-  /* Return the new address of the reallocated file object */
+  tfo->tfo_linear  = linear;
+  tfo->tfo_nlinear = tfo->tfo_npages;
+  tmpfs_update_alloc(tfo);
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
+  *ppv = linear;
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_free_file
+ *
+ * Description:
+ *   Release a file object and all of its pages.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  tmpfs_realloc_file(tfo, 0);
+  nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
+  kmm_free(tfo);
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -448,8 +749,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -595,12 +895,12 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  No pages are allocated until
+   * data is written.
+   */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)kmm_zalloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -610,7 +910,7 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
+  tfo->tfo_alloc = sizeof(struct tmpfs_file_s);
   tfo->tfo_type  = TMPFS_REGULAR;
   tfo->tfo_refs  = 1;
   tfo->tfo_flags = 0;
@@ -738,8 +1038,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
   /* Error exits */
 
 errout_with_file:
-  nxsem_destroy(&newtfo->tfo_exclsem.ts_sem);
-  kmm_free(newtfo);
+  tmpfs_free_file(newtfo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -1279,8 +1578,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   /* Free the object now */
 
-  nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      nxsem_destroy(&to->to_exclsem.ts_sem);
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1441,7 +1748,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
+              ret = tmpfs_realloc_file(tfo, 0);
               if (ret < 0)
                 {
                   goto errout_with_filelock;
@@ -1561,7 +1868,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1612,9 +1919,17 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the file pages to the user buffer */
+
+  if (nread > 0)
+    {
+      tmpfs_copyout(tfo, startpos, (FAR uint8_t *)buffer, nread);
+    }
+  else
+    {
+      nread = 0;
+    }
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1632,6 +1947,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+  size_t oldsize;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1658,22 +1974,31 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   nwritten = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  oldsize  = tfo->tfo_size;
+
+  if (endpos > oldsize)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Add pages to handle the write past the end of the file.  Existing
+       * data is not moved.
+       */
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
+      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
 
-      filep->f_priv = tfo;
+      /* Zero any hole between the old end of file and the write */
+
+      if (startpos > oldsize)
+        {
+          tmpfs_copyin(tfo, oldsize, NULL, startpos - oldsize);
+        }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the file pages */
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+  tmpfs_copyin(tfo, startpos, (FAR const uint8_t *)buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1754,6 +2079,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct tmpfs_file_s *tfo;
   FAR void **ppv = (FAR void**)arg;
+  int ret;
 
   finfo("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1769,11 +2095,18 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
       /* Return the address on the media corresponding to the start of
-       * the file.
+       * the file.  That requires the file pages to be contiguous.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
-      return OK;
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = tmpfs_linearize_file(tfo, ppv);
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1890,23 +2223,21 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
+      /* The size is changing.. up or down.  Add or release pages. */
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
+      ret = tmpfs_realloc_file(tfo, (size_t)length);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
 
-      filep->f_priv = tfo;
-
       /* If the size has increased, then we need to zero the newly added
        * memory.
        */
 
       if (length > oldsize)
         {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+          tmpfs_copyin(tfo, oldsize, NULL, length - oldsize);
         }
 
       ret = OK;
@@ -2106,6 +2437,41 @@ static int tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_FS_TMPFS_GRAN
+  /* Set up the page pool on the first mount.  Without it pages simply come
+   * from the heap.
+   */
+
+  if (g_tmpfs_gran == NULL)
+    {
+      uint8_t log2page = 0;
+
+      while ((1 << log2page) < TMPFS_PAGESIZE)
+        {
+          log2page++;
+        }
+
+      g_tmpfs_granbase = (FAR uint8_t *)
+        kmm_memalign(TMPFS_PAGESIZE, CONFIG_FS_TMPFS_GRAN_SIZE);
+      if (g_tmpfs_granbase != NULL)
+        {
+          g_tmpfs_gran = gran_initialize(g_tmpfs_granbase,
+                                         CONFIG_FS_TMPFS_GRAN_SIZE,
+                                         log2page, log2page);
+          if (g_tmpfs_gran == NULL)
+            {
+              kmm_free(g_tmpfs_granbase);
+              g_tmpfs_granbase = NULL;
+            }
+        }
+
+      if (g_tmpfs_gran == NULL)
+        {
+          fwarn("WARNING: No TMPFS page pool, using the heap\n");
+        }
+    }
+#endif
+
   /* Create a root file system.  This is like a single directory entry in
    * the file system structure.
    */
@@ -2333,8 +2699,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
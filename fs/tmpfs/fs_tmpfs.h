@@ -133,6 +133,13 @@ struct tmpfs_directory_s
   (sizeof(struct tmpfs_directory_s) + ((n) - 1) * sizeof(struct tmpfs_dirent_s))
 
 /* The form of a regular file memory object
+ *
+ * File data is held in fixed size pages of CONFIG_FS_TMPFS_PAGESIZE bytes
+ * listed in tfo_pages[].  Growing a file only adds pages, so an append
+ * never copies the existing data and the file object itself never moves.
+ * FIOC_MMAP needs the data in one piece: if the pages are not already
+ * contiguous they are copied once into the single allocation tfo_linear
+ * and tfo_pages[] is pointed into it.
  *
  * NOTE that in this very simplified implementation, there is no per-open
  * state.  The file memory object also serves as the open file object,
@@ -153,13 +160,15 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
-  size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
+  uint8_t  tfo_flags;      /* See TFO_FLAG_* definitions */
+  size_t   tfo_size;       /* Valid file size */
+  size_t   tfo_npages;     /* Number of pages holding file data */
+  size_t   tfo_nslots;     /* Allocated length of tfo_pages[] */
+  size_t   tfo_nlinear;    /* Number of pages in tfo_linear */
+  FAR uint8_t **tfo_pages; /* File data pages */
+  FAR uint8_t *tfo_linear; /* Contiguous pages (FIOC_MMAP) or NULL */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
-
 /* This structure represents one instance of a TMPFS file system */
 
 struct tmpfs_s
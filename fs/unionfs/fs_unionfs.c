@@ -59,6 +59,15 @@
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+#ifndef CONFIG_FS_UNIONFS_NCACHE
+#  define CONFIG_FS_UNIONFS_NCACHE 0
+#endif
+
+/* Lookup cache results in addition to the file system index 0 or 1 */
+
+#define UNIONFS_NOENT   2            /* Path exists on neither file system */
+#define UNIONFS_UNKNOWN 3            /* Path is not in the cache */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -71,11 +80,25 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+#if CONFIG_FS_UNIONFS_NCACHE > 0
+/* This structure describes one lookup cache entry */
+
+struct unionfs_cache_s
+{
+  uint32_t uc_hash;                  /* Hash of the path */
+  uint8_t uc_ndx;                    /* File system index or UNIONFS_NOENT */
+  FAR char *uc_relpath;              /* Path relative to the union, or NULL */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
 {
   struct unionfs_mountpt_s ui_fs[2]; /* Contained file systems */
+#if CONFIG_FS_UNIONFS_NCACHE > 0
+  struct unionfs_cache_s ui_cache[CONFIG_FS_UNIONFS_NCACHE];
+#endif
   sem_t ui_exclsem;                  /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
@@ -127,6 +150,19 @@ static int     unionfs_trystatfile(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
 static FAR char *unionfs_relpath(FAR const char *path,
                  FAR const char *name);
+#if CONFIG_FS_UNIONFS_NCACHE > 0
+static int     unionfs_cache_find(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
+static void    unionfs_cache_add(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int ndx);
+static void    unionfs_cache_flush(FAR struct unionfs_inode_s *ui);
+#else
+#  define      unionfs_cache_find(ui, relpath) UNIONFS_UNKNOWN
+#  define      unionfs_cache_add(ui, relpath, ndx)
+#  define      unionfs_cache_flush(ui)
+#endif
+static bool    unionfs_isoccluded(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
 
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
@@ -716,6 +752,182 @@ static FAR char *unionfs_relpath(FAR const char *path, FAR const char *name)
     }
 }
 
+#if CONFIG_FS_UNIONFS_NCACHE > 0
+/****************************************************************************
+ * Name: unionfs_cache_entry
+ *
+ * Description:
+ *   Return the lookup cache entry that may hold relpath and the hash of
+ *   relpath.  The cache is direct mapped: a path can only ever be held in
+ *   one entry.
+ *
+ ****************************************************************************/
+
+static FAR struct unionfs_cache_s *
+unionfs_cache_entry(FAR struct unionfs_inode_s *ui, FAR const char *relpath,
+                    FAR uint32_t *hash)
+{
+  uint32_t h = 2166136261u;
+
+  /* FNV-1a, ignoring any leading '/' */
+
+  for (; *relpath == '/'; relpath++);
+  for (; *relpath != '\0'; relpath++)
+    {
+      h = (h ^ (uint8_t)*relpath) * 16777619u;
+    }
+
+  *hash = h;
+  return &ui->ui_cache[h % CONFIG_FS_UNIONFS_NCACHE];
+}
+
+/****************************************************************************
+ * Name: unionfs_cache_find
+ *
+ * Description:
+ *   Return the index of the file system that holds relpath, UNIONFS_NOENT
+ *   if relpath is known to exist on neither, or UNIONFS_UNKNOWN if relpath
+ *   is not in the cache.  The caller must hold ui_exclsem.
+ *
+ ****************************************************************************/
+
+static int unionfs_cache_find(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath)
+{
+  FAR struct unionfs_cache_s *uc;
+  uint32_t hash;
+
+  uc = unionfs_cache_entry(ui, relpath, &hash);
+  for (; *relpath == '/'; relpath++);
+
+  if (uc->uc_relpath != NULL && uc->uc_hash == hash &&
+      strcmp(uc->uc_relpath, relpath) == 0)
+    {
+      return uc->uc_ndx;
+    }
+
+  return UNIONFS_UNKNOWN;
+}
+
+/****************************************************************************
+ * Name: unionfs_cache_add
+ *
+ * Description:
+ *   Remember the result of a lookup of relpath, replacing whatever path
+ *   was held in the same entry.  The caller must hold ui_exclsem.
+ *
+ ****************************************************************************/
+
+static void unionfs_cache_add(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath, int ndx)
+{
+  FAR struct unionfs_cache_s *uc;
+  uint32_t hash;
+
+  uc = unionfs_cache_entry(ui, relpath, &hash);
+  for (; *relpath == '/'; relpath++);
+
+  if (uc->uc_relpath == NULL || uc->uc_hash != hash ||
+      strcmp(uc->uc_relpath, relpath) != 0)
+    {
+      if (uc->uc_relpath != NULL)
+        {
+          kmm_free(uc->uc_relpath);
+        }
+
+      /* On failure to allocate the path, the lookup is just not cached */
+
+      uc->uc_relpath = strdup(relpath);
+      uc->uc_hash    = hash;
+    }
+
+  uc->uc_ndx = ndx;
+}
+
+/****************************************************************************
+ * Name: unionfs_cache_flush
+ *
+ * Description:
+ *   Forget every cached lookup.  This must be called whenever a path may
+ *   have been created, removed or renamed on either file system.  The
+ *   caller must hold ui_exclsem.
+ *
+ ****************************************************************************/
+
+static void unionfs_cache_flush(FAR struct unionfs_inode_s *ui)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_NCACHE; i++)
+    {
+      if (ui->ui_cache[i].uc_relpath != NULL)
+        {
+          kmm_free(ui->ui_cache[i].uc_relpath);
+          ui->ui_cache[i].uc_relpath = NULL;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_isoccluded
+ *
+ * Description:
+ *   Return true if relpath, which was found while enumerating file system
+ *   2, also exists on file system 1 and so must not be reported twice.
+ *
+ ****************************************************************************/
+
+static bool unionfs_isoccluded(FAR struct unionfs_inode_s *ui,
+                               FAR const char *relpath)
+{
+  FAR struct unionfs_mountpt_s *um0 = &ui->ui_fs[0];
+  struct stat buf;
+  bool locked;
+  int ndx;
+  int ret;
+
+  /* readdir() does not otherwise hold ui_exclsem.  Without it, just do
+   * without the cache.
+   */
+
+  locked = unionfs_semtake(ui, true) >= 0;
+  ndx    = locked ? unionfs_cache_find(ui, relpath) : UNIONFS_UNKNOWN;
+
+  if (ndx == UNIONFS_UNKNOWN)
+    {
+      /* Check if anything exists at this path on file system 1 */
+
+      ret = unionfs_trystat(um0->um_node, relpath, um0->um_prefix, &buf);
+      if (ret >= 0)
+        {
+          ndx = 0;
+        }
+      else if (ret == -ENOENT)
+        {
+          /* The path was just found on file system 2 */
+
+          ndx = 1;
+        }
+
+      if (locked && ndx != UNIONFS_UNKNOWN)
+        {
+          unionfs_cache_add(ui, relpath, ndx);
+        }
+    }
+
+  if (locked)
+    {
+      unionfs_semgive(ui);
+    }
+
+  /* REVISIT: We could allow files and directories to have duplicate
+   * names.
+   */
+
+  return ndx == 0;
+}
+
 /****************************************************************************
  * Name: unionfs_unbind_child
  ****************************************************************************/
@@ -795,7 +1007,9 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
   unionfs_unbind_child(&ui->ui_fs[0]);
   unionfs_unbind_child(&ui->ui_fs[1]);
 
-  /* Free any allocated prefix strings */
+  /* Free any cached lookups and allocated prefix strings */
+
+  unionfs_cache_flush(ui);
 
   if (ui->ui_fs[0].um_prefix)
     {
@@ -823,6 +1037,8 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  int ndx;
+  int ret1;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -840,6 +1056,26 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       return ret;
     }
 
+  /* Creating a file invalidates what we know about the path.  Otherwise,
+   * the lookup cache may tell us where the file is, or that it does not
+   * exist at all.
+   */
+
+  if ((oflags & O_CREAT) != 0)
+    {
+      ndx = UNIONFS_UNKNOWN;
+      unionfs_cache_flush(ui);
+    }
+  else
+    {
+      ndx = unionfs_cache_find(ui, relpath);
+      if (ndx == UNIONFS_NOENT)
+        {
+          ret = -ENOENT;
+          goto errout_with_semaphore;
+        }
+    }
+
   /* Allocate a container to hold the open file system information */
 
   uf = (FAR struct unionfs_file_s *)
@@ -861,8 +1097,14 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   uf->uf_file.f_inode  = um->um_node;
   uf->uf_file.f_priv   = NULL;
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
-  if (ret >= 0)
+  ret1 = -ENOENT;
+  if (ndx != 1)
+    {
+      ret1 = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                             mode);
+    }
+
+  if (ret1 >= 0)
     {
       /* Successfully opened on file system 1 */
 
@@ -883,7 +1125,13 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
                             mode);
       if (ret < 0)
         {
-          goto errout_with_semaphore;
+          if (ndx == UNIONFS_UNKNOWN && (oflags & O_CREAT) == 0 &&
+              ret1 == -ENOENT && ret == -ENOENT)
+            {
+              unionfs_cache_add(ui, relpath, UNIONFS_NOENT);
+            }
+
+          goto errout_with_container;
         }
 
       /* Successfully opened on file system 1 */
@@ -891,6 +1139,16 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_ndx = 1;
     }
 
+  /* Remember where the file was found.  It is only known to be absent
+   * from file system 1 if that file system said so.
+   */
+
+  if (ndx == UNIONFS_UNKNOWN && (oflags & O_CREAT) == 0 &&
+      (uf->uf_ndx == 0 || ret1 == -ENOENT))
+    {
+      unionfs_cache_add(ui, relpath, uf->uf_ndx);
+    }
+
   /* Increment the open reference count */
 
   ui->ui_nopen++;
@@ -899,7 +1157,11 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   /* Save our private data in the file structure */
 
   filep->f_priv = (FAR void *)uf;
-  ret = OK;
+  unionfs_semgive(ui);
+  return OK;
+
+errout_with_container:
+  kmm_free(uf);
 
 errout_with_semaphore:
   unionfs_semgive(ui);
@@ -1893,22 +2155,9 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
                                         fu->fu_lower[1]->fd_dir.d_name);
               if (relpath)
                 {
-                  int tmp;
-
                   /* Check if anything exists at this path on file system 1 */
 
-                  um0 = &ui->ui_fs[0];
-                  tmp = unionfs_trystat(um0->um_node, relpath,
-                                        um0->um_prefix, &buf);
-                  if (tmp >= 0)
-                    {
-                      /* There is something there!
-                       * REVISIT: We could allow files and directories to
-                       * have duplicate names.
-                       */
-
-                      duplicate = true;
-                    }
+                  duplicate = unionfs_isoccluded(ui, relpath);
 
                   /* Free the allocated relpath */
 
@@ -2266,6 +2515,10 @@ static int unionfs_unlink(FAR struct inode *mountpt,
       return ret;
     }
 
+  /* The path may be about to disappear */
+
+  unionfs_cache_flush(ui);
+
   /* Check if some exists at this path on file system 1.  This might be
    * a file or a directory
    */
@@ -2359,6 +2612,8 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Try to create the directory on both file systems. */
 
+  unionfs_cache_flush(ui);
+
   um  = &ui->ui_fs[0];
   ret1 = unionfs_trymkdir(um->um_node, relpath, um->um_prefix, mode);
 
@@ -2414,6 +2669,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
     }
 
   ret = -ENOENT;
+  unionfs_cache_flush(ui);
 
   /* We really don't know any better so we will try to remove the directory
    * from both file systems.
@@ -2489,6 +2745,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
     }
 
   DEBUGASSERT(oldrelpath != NULL && oldrelpath != NULL);
+  unionfs_cache_flush(ui);
 
   /* Is there a file with this name on file system 1 */
 
@@ -2545,6 +2802,8 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+  int ndx;
+  int ret1;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2563,32 +2822,63 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
-  /* stat this path on file system 1 */
+  /* If the lookup cache knows where the path is, then stat it there */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  ndx = unionfs_cache_find(ui, relpath);
+  if (ndx == 0 || ndx == 1)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      um  = &ui->ui_fs[ndx];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          unionfs_semgive(ui);
+          return OK;
+        }
 
-      unionfs_semgive(ui);
-      return OK;
+      ndx = UNIONFS_UNKNOWN;
     }
 
-  /* stat failed on the file system 1.  Try again on file system 2. */
-
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  ret = -ENOENT;
+  if (ndx == UNIONFS_UNKNOWN)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      /* stat this path on file system 1 */
 
-      unionfs_semgive(ui);
-      return OK;
+      um   = &ui->ui_fs[0];
+      ret1 = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret1 >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
+
+          unionfs_cache_add(ui, relpath, 0);
+          unionfs_semgive(ui);
+          return OK;
+        }
+
+      /* stat failed on the file system 1.  Try again on file system 2. */
+
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
+
+          if (ret1 == -ENOENT)
+            {
+              unionfs_cache_add(ui, relpath, 1);
+            }
+
+          unionfs_semgive(ui);
+          return OK;
+        }
+
+      if (ret1 == -ENOENT && ret == -ENOENT)
+        {
+          unionfs_cache_add(ui, relpath, UNIONFS_NOENT);
+        }
     }
 
   /* Special case the unionfs root directory when both file systems are
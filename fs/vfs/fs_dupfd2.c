@@ -81,6 +81,13 @@ int fs_dupfd2(int fd1, int fd2)
   /* Get the file structures corresponding to the file descriptors. */
 
   ret = fs_getfilep(fd1, &filep1);
+  if (ret >= 0)
+    {
+      /* fd2 may be in a block of descriptors not used so far */
+
+      ret = files_extend(fd2);
+    }
+
   if (ret >= 0)
     {
       ret = fs_getfilep(fd2, &filep2);
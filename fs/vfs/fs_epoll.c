@@ -42,25 +42,242 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
+#include <signal.h>
+#include <assert.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These events are always reported, whether requested or not */
+
+#define EPOLL_DEFAULT_EVENTS  (EPOLLERR | EPOLLHUP)
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One registered file descriptor.  The embedded poll registration stays
+ * connected to the driver (or socket) from EPOLL_CTL_ADD until
+ * EPOLL_CTL_DEL, until the epoll instance is closed, or until the
+ * descriptor is closed.  The driver posts the shared epoll semaphore in the
+ * head structure whenever it sets revents, so no per-wait setup or teardown
+ * of the poll is required.
+ */
+
+struct epoll_node_s
+{
+  uint32_t          events;   /* Requested events, including EPOLLET etc. */
+  bool              inuse;    /* True: This node is allocated */
+  epoll_data_t      data;     /* User data returned with each event */
+  struct pollreg_s  reg;      /* Persistent poll registration */
+};
+
 struct epoll_head
 {
-  int size;
-  int occupied;
-  FAR epoll_data_t *data;
-  FAR struct pollfd *poll;
+  int               size;     /* Number of nodes */
+  int               occupied; /* Number of nodes in use */
+  sem_t             sem;      /* Posted by drivers when an event occurs */
+  FAR struct epoll_node_s *node;
 };
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_head_from_fd
+ ****************************************************************************/
+
+static inline FAR struct epoll_head *epoll_head_from_fd(int epfd)
+{
+  /* REVISIT: This will not work on machines where:
+   * sizeof(struct epoll_head *) > sizeof(int)
+   */
+
+  return (FAR struct epoll_head *)((intptr_t)epfd);
+}
+
+/****************************************************************************
+ * Name: epoll_closed
+ *
+ * Description:
+ *   Free the node if its descriptor was closed.  Like Linux, a closed
+ *   descriptor is removed from the interest list silently.
+ *
+ ****************************************************************************/
+
+static bool epoll_closed(FAR struct epoll_head *eph,
+                         FAR struct epoll_node_s *epn)
+{
+  if (!epn->reg.armed && (epn->reg.pfd.revents & POLLNVAL) != 0)
+    {
+      epn->inuse = false;
+      eph->occupied--;
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Return the node registered for 'fd' or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *epoll_find(FAR struct epoll_head *eph,
+                                           int fd)
+{
+  int i;
+
+  for (i = 0; i < eph->size; i++)
+    {
+      if (eph->node[i].inuse && eph->node[i].reg.pfd.fd == fd &&
+          !epoll_closed(eph, &eph->node[i]))
+        {
+          return &eph->node[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_alloc
+ *
+ * Description:
+ *   Return a free node or NULL if all nodes are in use.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *epoll_alloc(FAR struct epoll_head *eph)
+{
+  int i;
+
+  for (i = 0; i < eph->size; i++)
+    {
+      if (!eph->node[i].inuse)
+        {
+          return &eph->node[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Connect (setup == true) or disconnect (setup == false) the persistent
+ *   poll structure of one node to/from its file or socket descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(FAR struct epoll_head *eph,
+                         FAR struct epoll_node_s *epn, bool setup)
+{
+  FAR struct pollfd *pfd = &epn->reg.pfd;
+
+  if (setup == epn->reg.armed)
+    {
+      return OK;
+    }
+
+  if (!setup)
+    {
+      pollreg_disarm(&epn->reg);
+      return OK;
+    }
+
+  pfd->events = (pollevent_t)((epn->events | EPOLL_DEFAULT_EVENTS) &
+                              ~POLLMASK);
+  pfd->sem    = &eph->sem;
+
+  return pollreg_arm(&epn->reg);
+}
+
+/****************************************************************************
+ * Name: epoll_drain
+ *
+ * Description:
+ *   Collect the pending events of up to 'maxevents' nodes.  Level-triggered
+ *   nodes that reported events are re-armed so that the driver re-evaluates
+ *   the current state; edge-triggered nodes remain connected as-is and will
+ *   report again only when the driver signals a new event.
+ *
+ ****************************************************************************/
+
+static int epoll_drain(FAR struct epoll_head *eph,
+                       FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_node_s *epn;
+  irqstate_t flags;
+  uint32_t revents;
+  int nevents = 0;
+  int i;
+
+  for (i = 0; i < eph->size && nevents < maxevents; i++)
+    {
+      epn = &eph->node[i];
+      if (!epn->inuse || epoll_closed(eph, epn) || !epn->reg.armed)
+        {
+          continue;
+        }
+
+      /* revents may be modified from interrupt level by the driver */
+
+      flags = enter_critical_section();
+      revents = epn->reg.pfd.revents;
+      epn->reg.pfd.revents = 0;
+      leave_critical_section(flags);
+
+      revents &= epn->events | EPOLL_DEFAULT_EVENTS;
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = epn->data;
+      nevents++;
+
+      if ((epn->events & EPOLLONESHOT) != 0)
+        {
+          /* Disabled until re-enabled with EPOLL_CTL_MOD */
+
+          epoll_fdsetup(eph, epn, false);
+        }
+      else if ((epn->events & EPOLLET) == 0)
+        {
+          /* Level-triggered:  Reconnect so that a still-ready descriptor
+           * is reported again on the next wait.
+           */
+
+          epoll_fdsetup(eph, epn, false);
+          epoll_fdsetup(eph, epn, true);
+        }
+    }
+
+  return nevents;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -69,24 +286,45 @@ struct epoll_head
  * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance able to monitor up to 'size' descriptors.
  *
  * Input Parameters:
+ *   size - The maximum number of descriptors that may be registered.
  *
  * Returned Value:
+ *   The epoll descriptor on success; -1 (ERROR) on failure with the errno
+ *   value set appropriately.
  *
  ****************************************************************************/
 
 int epoll_create(int size)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head) +
-                                        sizeof(epoll_data_t) * size +
-                                        sizeof(struct pollfd) * size);
+  FAR struct epoll_head *eph;
+
+  if (size <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  eph = (FAR struct epoll_head *)
+    kmm_zalloc(sizeof(struct epoll_head) +
+               sizeof(struct epoll_node_s) * size);
+  if (eph == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
 
   eph->size = size;
-  eph->occupied = 0;
-  eph->data = (FAR epoll_data_t *)(eph + 1);
-  eph->poll = (FAR struct pollfd *)(eph->data + size);
+  eph->node = (FAR struct epoll_node_s *)(eph + 1);
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&eph->sem, 0, 0);
+  nxsem_set_protocol(&eph->sem, SEM_PRIO_NONE);
 
   /* REVISIT: This will not work on machines where:
    * sizeof(struct epoll_head *) > sizeof(int)
@@ -99,10 +337,13 @@ int epoll_create(int size)
  * Name: epoll_create1
  *
  * Description:
+ *   Create an epoll instance with the default number of descriptors.
  *
  * Input Parameters:
+ *   flags - Must be EPOLL_CLOEXEC
  *
  * Returned Value:
+ *   See epoll_create().
  *
  ****************************************************************************/
 
@@ -114,7 +355,8 @@ int epoll_create1(int flags)
 
   if (flags != EPOLL_CLOEXEC)
     {
-      return EINVAL;
+      set_errno(EINVAL);
+      return ERROR;
     }
 
   return epoll_create(CONFIG_FS_NEPOLL_DESCRIPTORS);
@@ -124,21 +366,30 @@ int epoll_create1(int flags)
  * Name: epoll_close
  *
  * Description:
+ *   Disconnect all registered descriptors and free the epoll instance.
  *
  * Input Parameters:
+ *   epfd - The epoll descriptor returned by epoll_create().
  *
  * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
 void epoll_close(int epfd)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head *eph = epoll_head_from_fd(epfd);
+  int i;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  for (i = 0; i < eph->size; i++)
+    {
+      if (eph->node[i].inuse)
+        {
+          epoll_fdsetup(eph, &eph->node[i], false);
+        }
+    }
 
+  nxsem_destroy(&eph->sem);
   kmm_free(eph);
 }
 
@@ -146,20 +397,29 @@ void epoll_close(int epfd)
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a descriptor in the interest list of the epoll
+ *   instance.  The poll of the descriptor is connected once when it is
+ *   added and stays connected until it is removed.
  *
  * Input Parameters:
+ *   epfd - The epoll descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The target file or socket descriptor
+ *   ev   - The events to monitor and the associated user data
  *
  * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with the errno value set
+ *   appropriately.
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head *eph = epoll_head_from_fd(epfd);
+  FAR struct epoll_node_s *epn;
+  int ret = OK;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  epn = epoll_find(eph, fd);
 
   switch (op)
     {
@@ -167,136 +427,205 @@ int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
         finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
               epfd, eph->occupied, fd, ev->events);
 
-        eph->data[eph->occupied]        = ev->data;
-        eph->poll[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->poll[eph->occupied++].fd   = fd;
-        return 0;
+        if (epn != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        epn = epoll_alloc(eph);
+        if (epn == NULL)
+          {
+            ret = -ENOMEM;
+            break;
+          }
+
+        epn->events = ev->events;
+        epn->data   = ev->data;
+        epn->reg.pfd.fd = fd;
+
+        ret = epoll_fdsetup(eph, epn, true);
+        if (ret >= 0)
+          {
+            epn->inuse = true;
+            eph->occupied++;
+          }
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
-
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->poll[i].fd == fd)
-                {
-                  if (i != eph->occupied - 1)
-                    {
-                      memmove(&eph->data[i], &eph->data[i + 1],
-                              sizeof(epoll_data_t) * (eph->occupied - i));
-                      memmove(&eph->poll[i], &eph->poll[i + 1],
-                              sizeof(struct pollfd) * (eph->occupied - i));
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        if (epn == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          return -ENOENT;
-        }
+        epoll_fdsetup(eph, epn, false);
+        epn->inuse = false;
+        eph->occupied--;
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
-
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
+              epfd, eph->occupied, fd, ev->events);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->poll[i].fd == fd)
-                {
-                  eph->data[i]        = ev->data;
-                  eph->poll[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+        if (epn == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        /* Reconnect with the new event set.  This also re-enables an
+         * EPOLLONESHOT descriptor that has already fired.
+         */
+
+        epoll_fdsetup(eph, epn, false);
+        epn->events = ev->events;
+        epn->data   = ev->data;
+        ret = epoll_fdsetup(eph, epn, true);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-          return -ENOENT;
-        }
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_pwait
+ *
+ * Description:
+ *   Wait for events on the epoll instance.  Only the pending events of the
+ *   persistently connected descriptors are collected; nothing is set up or
+ *   torn down unless the descriptor is level-triggered and reported an
+ *   event.
+ *
+ * Input Parameters:
+ *   epfd      - The epoll descriptor
+ *   evs       - The returned events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - Timeout in milliseconds, a negative value waits forever
+ *   sigmask   - Signal mask to install while waiting, or NULL
+ *
+ * Returned Value:
+ *   The number of returned events, zero on timeout, or -1 (ERROR) on
+ *   failure with the errno value set appropriately.
+ *
  ****************************************************************************/
 
 int epoll_pwait(int epfd, FAR struct epoll_event *evs,
                 int maxevents, int timeout, FAR const sigset_t *sigmask)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
-
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  FAR struct epoll_head *eph = epoll_head_from_fd(epfd);
+  sigset_t saved;
+  clock_t start;
+  clock_t ticks = 0;
+  int ret;
 
-  if (timeout < 0)
+  if (evs == NULL || maxevents <= 0)
     {
-      rc = ppoll(eph->poll, eph->occupied, NULL, sigmask);
+      set_errno(EINVAL);
+      return ERROR;
     }
-  else
-    {
-      struct timespec timeout_ts;
 
-      timeout_ts.tv_sec  = timeout / 1000;
-      timeout_ts.tv_nsec = timeout % 1000 * 1000;
+  /* epoll_pwait() is a cancellation point */
+
+  enter_cancellation_point();
 
-      rc = ppoll(eph->poll, eph->occupied, &timeout_ts, sigmask);
+  if (sigmask != NULL)
+    {
+      nxsig_procmask(SIG_SETMASK, sigmask, &saved);
+    }
+
+  if (timeout > 0)
+    {
+      /* Round timeout up to next full tick */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
     }
 
-  if (rc <= 0)
+  start = clock_systime_ticks();
+
+  for (; ; )
     {
-      if (rc < 0)
+      ret = epoll_drain(eph, evs, maxevents);
+      if (ret > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      /* Nothing pending.  Wait for a driver to post an event.  A stale
+       * count on the semaphore only causes one extra pass.
+       */
+
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->sem, start, ticks);
+        }
+      else
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          ret = nxsem_wait(&eph->sem);
+        }
 
-          for (i = 0; i < eph->occupied; i++)
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
             {
-              ferr("  %02d: fd=%d\n", i, eph->poll[i].fd);
+              ret = epoll_drain(eph, evs, maxevents);
             }
-        }
 
-      return rc;
+          break;
+        }
     }
 
-  /* Iterate over non NULL event fds */
-
-  if (rc > maxevents)
+  if (sigmask != NULL)
     {
-      rc = maxevents;
+      nxsig_procmask(SIG_SETMASK, &saved, NULL);
     }
 
-  for (i = 0, counter = 0; i < rc && counter < eph->occupied; counter++)
+  leave_cancellation_point();
+
+  if (ret < 0)
     {
-      if (eph->poll[counter].revents != 0)
-        {
-          evs[i].data     = eph->data[counter];
-          evs[i++].events = eph->poll[counter].revents;
-          if (eph->poll[counter].events & EPOLLONESHOT)
-            {
-              eph->poll[counter].events = 0; /* Disable oneshot internally */
-            }
-        }
+      ferr("ERROR: %08x wait failed: %d for %d, %d msecs\n",
+           epfd, ret, eph->occupied, timeout);
+
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return i;
+  return ret;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Equivalent to epoll_pwait() with a NULL signal mask.
  *
  * Input Parameters:
+ *   epfd      - The epoll descriptor
+ *   evs       - The returned events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - Timeout in milliseconds, a negative value waits forever
  *
  * Returned Value:
+ *   See epoll_pwait().
  *
  ****************************************************************************/
 
@@ -40,12 +40,15 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <string.h>
 #include <poll.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
@@ -61,6 +64,51 @@
 
 #define poll_semgive(sem) nxsem_post(sem)
 
+#ifndef CONFIG_FS_POLL_NCACHE
+#  define CONFIG_FS_POLL_NCACHE 4
+#endif
+
+/* These events are always reported, whether requested or not */
+
+#define POLL_DEFAULT_EVENTS (POLLERR | POLLHUP | POLLNVAL)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+/* The poll registrations of the last poll() call of one thread.  They stay
+ * connected after poll() returns, so the next call with the same set of
+ * descriptors only needs to reconnect those that reported events.
+ */
+
+struct poll_cache_s
+{
+  pid_t pid;                        /* The owning thread */
+  bool busy;                        /* The owner is in nx_poll() */
+  uint32_t lastuse;                 /* For least-recently-used eviction */
+  nfds_t nfds;                      /* Number of registrations in use */
+  nfds_t nalloc;                    /* Number of registrations allocated */
+  FAR struct pollreg_s *regs;       /* One per pollfd */
+  sem_t sem;                        /* Posted by the drivers */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All connected registrations, so that they can be released on close */
+
+static FAR struct pollreg_s *g_pollreg;
+static sem_t g_pollreg_sem = SEM_INITIALIZER(1);
+
+#ifdef CONFIG_FS_POLL_CACHE
+static struct poll_cache_s g_poll_cache[CONFIG_FS_POLL_NCACHE];
+static sem_t g_poll_cachesem = SEM_INITIALIZER(1);
+static uint32_t g_poll_usecount;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -289,6 +337,413 @@ static inline int poll_teardown(FAR struct pollfd *fds, nfds_t nfds,
   return ret;
 }
 
+/****************************************************************************
+ * Name: pollreg_resolve
+ *
+ * Description:
+ *   Return the struct file or struct socket a descriptor refers to.
+ *
+ ****************************************************************************/
+
+static int pollreg_resolve(int fd, FAR void **ptr, FAR bool *sock)
+{
+  FAR struct file *filep;
+  int ret;
+
+  if (fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+#ifdef CONFIG_NET
+      *ptr  = sockfd_socket(fd);
+      *sock = true;
+      return *ptr != NULL ? OK : -EBADF;
+#else
+      return -EBADF;
+#endif
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *ptr  = filep;
+  *sock = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pollreg_poll
+ *
+ * Description:
+ *   Setup or teardown the poll of a registration on its file or socket
+ *
+ ****************************************************************************/
+
+static int pollreg_poll(FAR struct pollreg_s *reg, bool setup)
+{
+#ifdef CONFIG_NET
+  if (reg->sock)
+    {
+      return psock_poll(reg->ptr, &reg->pfd, setup);
+    }
+#endif
+
+  /* Every close and file_detach() disconnects the registrations of the
+   * file first, so this only catches a descriptor that was never opened.
+   */
+
+  if (((FAR struct file *)reg->ptr)->f_inode == NULL)
+    {
+      return -EBADF;
+    }
+
+  return file_poll(reg->ptr, &reg->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: pollreg_unlink
+ *
+ * Description:
+ *   Disconnect a registration with g_pollreg_sem held
+ *
+ ****************************************************************************/
+
+static void pollreg_unlink(FAR struct pollreg_s *reg)
+{
+  FAR struct pollreg_s **link;
+
+  if (!reg->armed)
+    {
+      return;
+    }
+
+  pollreg_poll(reg, false);
+  reg->armed = false;
+
+  for (link = &g_pollreg; *link != NULL; link = &(*link)->flink)
+    {
+      if (*link == reg)
+        {
+          *link = reg->flink;
+          break;
+        }
+    }
+}
+
+#ifdef CONFIG_FS_POLL_CACHE
+/****************************************************************************
+ * Name: poll_cache_drop
+ *
+ * Description:
+ *   Disconnect all registrations of a cache
+ *
+ ****************************************************************************/
+
+static void poll_cache_drop(FAR struct poll_cache_s *cache)
+{
+  nfds_t i;
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      pollreg_disarm(&cache->regs[i]);
+    }
+
+  cache->nfds = 0;
+}
+
+/****************************************************************************
+ * Name: poll_cache_get
+ *
+ * Description:
+ *   Return the cache of the calling thread, taking over the least recently
+ *   used idle one if the thread has none.  Returns NULL if every cache is
+ *   in use or the descriptor list cannot be cached.
+ *
+ ****************************************************************************/
+
+static FAR struct poll_cache_s *poll_cache_get(FAR struct pollfd *fds,
+                                               nfds_t nfds)
+{
+  FAR struct poll_cache_s *cache = NULL;
+  FAR struct poll_cache_s *victim = NULL;
+  pid_t pid = getpid();
+  nfds_t i;
+
+  /* Only plain descriptors can be cached */
+
+  for (i = 0; i < nfds; i++)
+    {
+      if ((fds[i].events & POLLMASK) != POLLFD)
+        {
+          return NULL;
+        }
+    }
+
+  nxsem_wait_uninterruptible(&g_poll_cachesem);
+
+  for (i = 0; i < CONFIG_FS_POLL_NCACHE; i++)
+    {
+      if (g_poll_cache[i].pid == pid && g_poll_cache[i].regs != NULL)
+        {
+          cache = &g_poll_cache[i];
+          break;
+        }
+
+      if (!g_poll_cache[i].busy && g_poll_cache[i].nfds > 0 &&
+          nxsched_get_tcb(g_poll_cache[i].pid) == NULL)
+        {
+          /* The owner has exited.  Give the poll waiter slots it holds in
+           * the drivers back.
+           */
+
+          poll_cache_drop(&g_poll_cache[i]);
+        }
+
+      if (!g_poll_cache[i].busy &&
+          (victim == NULL ||
+           g_poll_cache[i].lastuse < victim->lastuse))
+        {
+          victim = &g_poll_cache[i];
+        }
+    }
+
+  if (cache == NULL && victim != NULL)
+    {
+      /* Take over the cache.  Its registrations no longer match anything
+       * and are reconnected as needed by poll_cache_setup().
+       */
+
+      cache = victim;
+      cache->pid = pid;
+
+      if (cache->regs == NULL)
+        {
+          nxsem_init(&cache->sem, 0, 0);
+          nxsem_set_protocol(&cache->sem, SEM_PRIO_NONE);
+        }
+    }
+
+  if (cache != NULL)
+    {
+      if (cache->busy)
+        {
+          /* Nested or concurrent use by the same thread (from a signal
+           * handler, for example).
+           */
+
+          cache = NULL;
+        }
+      else
+        {
+          cache->busy    = true;
+          cache->lastuse = ++g_poll_usecount;
+        }
+    }
+
+  nxsem_post(&g_poll_cachesem);
+  return cache;
+}
+
+/****************************************************************************
+ * Name: poll_cache_setup
+ *
+ * Description:
+ *   Make the registrations of the cache match the descriptor list.
+ *   Registrations are kept connected if they still refer to the same file
+ *   or socket with the same events and reported nothing since the last
+ *   call.  All others are (re)connected, which lets the driver report the
+ *   current state as a normal poll setup would.
+ *
+ ****************************************************************************/
+
+static int poll_cache_setup(FAR struct poll_cache_s *cache,
+                            FAR struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct pollreg_s *reg;
+  FAR void *ptr;
+  bool sock;
+  nfds_t i;
+  int ret;
+
+  /* Grow the registrations.  They cannot move while connected. */
+
+  if (nfds > cache->nalloc)
+    {
+      poll_cache_drop(cache);
+      kmm_free(cache->regs);
+      cache->regs = (FAR struct pollreg_s *)
+        kmm_zalloc(nfds * sizeof(struct pollreg_s));
+      if (cache->regs == NULL)
+        {
+          cache->nalloc = 0;
+          cache->nfds   = 0;
+          return -ENOMEM;
+        }
+
+      cache->nalloc = nfds;
+    }
+
+  for (i = nfds; i < cache->nfds; i++)
+    {
+      pollreg_disarm(&cache->regs[i]);
+    }
+
+  cache->nfds = nfds;
+
+  /* Drop stale posts; every event still pending is in some revents */
+
+  while (nxsem_trywait(&cache->sem) >= 0);
+
+  for (i = 0; i < nfds; i++)
+    {
+      reg = &cache->regs[i];
+      fds[i].revents = 0;
+
+      if (fds[i].fd < 0)
+        {
+          pollreg_disarm(reg);
+          reg->pfd.fd      = fds[i].fd;
+          reg->pfd.revents = 0;
+          continue;
+        }
+
+      ret = pollreg_resolve(fds[i].fd, &ptr, &sock);
+      if (ret < 0)
+        {
+          pollreg_disarm(reg);
+          fds[i].revents = POLLERR;
+          return ret;
+        }
+
+      if (reg->armed && reg->ptr == ptr && reg->pfd.fd == fds[i].fd &&
+          reg->pfd.events == (fds[i].events | POLL_DEFAULT_EVENTS) &&
+          reg->pfd.revents == 0)
+        {
+          /* Still connected and quiet */
+
+          continue;
+        }
+
+      pollreg_disarm(reg);
+
+      reg->pfd.fd     = fds[i].fd;
+      reg->pfd.events = fds[i].events | POLL_DEFAULT_EVENTS;
+      reg->pfd.sem    = &cache->sem;
+
+      ret = pollreg_arm(reg);
+      if (ret < 0)
+        {
+          fds[i].revents = POLLERR;
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: poll_cache_collect
+ *
+ * Description:
+ *   Copy the events reported so far to the descriptor list and return the
+ *   number of descriptors with events.  The events are left in the
+ *   registrations, so that the next call reconnects them and the driver
+ *   re-evaluates the state of the descriptor.
+ *
+ ****************************************************************************/
+
+static int poll_cache_collect(FAR struct poll_cache_s *cache,
+                              FAR struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct pollreg_s *reg;
+  irqstate_t flags;
+  int count = 0;
+  nfds_t i;
+
+  for (i = 0; i < nfds; i++)
+    {
+      reg = &cache->regs[i];
+      if (fds[i].fd < 0)
+        {
+          continue;
+        }
+
+      /* revents may be modified from interrupt level by the driver */
+
+      flags = enter_critical_section();
+      fds[i].revents = reg->pfd.revents &
+                       (fds[i].events | POLL_DEFAULT_EVENTS);
+      leave_critical_section(flags);
+
+      if (fds[i].revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: poll_cache_wait
+ *
+ * Description:
+ *   The cached version of nx_poll()
+ *
+ ****************************************************************************/
+
+static int poll_cache_wait(FAR struct poll_cache_s *cache,
+                           FAR struct pollfd *fds, nfds_t nfds,
+                           clock_t ticks, bool forever)
+{
+  clock_t start = clock_systime_ticks();
+  int count;
+  int ret;
+
+  ret = poll_cache_setup(cache, fds, nfds);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      count = poll_cache_collect(cache, fds, nfds);
+      if (count > 0 || (ticks == 0 && !forever))
+        {
+          break;
+        }
+
+      ret = forever ? poll_semtake(&cache->sem) :
+                      nxsem_tickwait(&cache->sem, start, ticks);
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
+            {
+              count = poll_cache_collect(cache, fds, nfds);
+              break;
+            }
+
+          return ret;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: poll_cache_put
+ ****************************************************************************/
+
+static void poll_cache_put(FAR struct poll_cache_s *cache)
+{
+  nxsem_wait_uninterruptible(&g_poll_cachesem);
+  cache->busy = false;
+  nxsem_post(&g_poll_cachesem);
+}
+#endif /* CONFIG_FS_POLL_CACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -397,6 +852,122 @@ int fs_poll(int fd, FAR struct pollfd *fds, bool setup)
   return file_poll(filep, fds, setup);
 }
 
+/****************************************************************************
+ * Name: pollreg_arm
+ *
+ * Description:
+ *   Connect a persistent poll registration to the file or socket that
+ *   reg->pfd.fd refers to.  The caller provides pfd.fd, pfd.events and
+ *   pfd.sem.  The driver then reports events in pfd.revents and posts
+ *   pfd.sem until pollreg_disarm() is called or the descriptor is closed,
+ *   without a setup and teardown on each wait.
+ *
+ *   When the file or socket is closed, the registration is disarmed,
+ *   POLLNVAL is set in pfd.revents and pfd.sem is posted.
+ *
+ * Input Parameters:
+ *   reg - The registration.  Must remain valid until it is disarmed.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int pollreg_arm(FAR struct pollreg_s *reg)
+{
+  int ret;
+
+  DEBUGASSERT(reg != NULL && !reg->armed && reg->pfd.sem != NULL);
+
+  ret = pollreg_resolve(reg->pfd.fd, &reg->ptr, &reg->sock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  reg->pfd.revents = 0;
+  reg->pfd.priv    = NULL;
+
+  nxsem_wait_uninterruptible(&g_pollreg_sem);
+
+  ret = pollreg_poll(reg, true);
+  if (ret >= 0)
+    {
+      reg->armed = true;
+      reg->flink = g_pollreg;
+      g_pollreg  = reg;
+    }
+
+  nxsem_post(&g_pollreg_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pollreg_disarm
+ *
+ * Description:
+ *   Disconnect a registration connected by pollreg_arm().  Does nothing if
+ *   it is not connected.
+ *
+ ****************************************************************************/
+
+void pollreg_disarm(FAR struct pollreg_s *reg)
+{
+  if (reg->armed)
+    {
+      nxsem_wait_uninterruptible(&g_pollreg_sem);
+      pollreg_unlink(reg);
+      nxsem_post(&g_pollreg_sem);
+    }
+
+  reg->pfd.revents = 0;
+}
+
+/****************************************************************************
+ * Name: pollreg_release
+ *
+ * Description:
+ *   Disarm all registrations connected to a file or socket that is being
+ *   closed.  Called by every close path of files (file_close(),
+ *   close(), dup2(), task exit and file_detach()) and by psock_close().
+ *
+ * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
+ *
+ ****************************************************************************/
+
+void pollreg_release(FAR void *ptr)
+{
+  FAR struct pollreg_s *reg;
+  FAR struct pollreg_s *next;
+
+  /* Nothing is connected most of the time */
+
+  if (g_pollreg == NULL)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&g_pollreg_sem);
+
+  for (reg = g_pollreg; reg != NULL; reg = next)
+    {
+      next = reg->flink;
+      if (reg->ptr == ptr)
+        {
+          pollreg_unlink(reg);
+
+          /* Tell whoever waits on the registration */
+
+          reg->pfd.revents |= POLLNVAL;
+          nxsem_post(reg->pfd.sem);
+        }
+    }
+
+  nxsem_post(&g_pollreg_sem);
+}
+
 /****************************************************************************
  * Name: nx_poll
  *
@@ -414,6 +985,9 @@ int fs_poll(int fd, FAR struct pollfd *fds, bool setup)
 
 int nx_poll(FAR struct pollfd *fds, unsigned int nfds, int timeout)
 {
+#ifdef CONFIG_FS_POLL_CACHE
+  FAR struct poll_cache_s *cache;
+#endif
   sem_t sem;
   int count = 0;
   int ret2;
@@ -421,6 +995,35 @@ int nx_poll(FAR struct pollfd *fds, unsigned int nfds, int timeout)
 
   DEBUGASSERT(nfds == 0 || fds != NULL);
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Reuse the registrations of the previous call of this thread if
+   * possible.
+   */
+
+  cache = nfds > 0 ? poll_cache_get(fds, nfds) : NULL;
+  if (cache != NULL)
+    {
+      clock_t ticks = 0;
+
+      if (timeout > 0)
+        {
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+          ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+                   (USEC_PER_TICK - 1)) /
+                  USEC_PER_TICK;
+#else
+          ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+                  MSEC_PER_TICK;
+#endif
+        }
+
+      ret = poll_cache_wait(cache, fds, nfds, ticks, timeout < 0);
+      poll_cache_put(cache);
+      return ret;
+    }
+#endif
+
   /* This semaphore is used for signaling and, hence, should not have
    * priority inheritance enabled.
    */
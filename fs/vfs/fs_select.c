@@ -54,6 +54,14 @@
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_SELECT_NSTACKFDS
+#  define CONFIG_FS_SELECT_NSTACKFDS 0
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -93,7 +101,10 @@
 int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
            FAR fd_set *exceptfds, FAR struct timeval *timeout)
 {
-  struct pollfd *pollset = NULL;
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  struct pollfd stackset[CONFIG_FS_SELECT_NSTACKFDS];
+#endif
+  FAR struct pollfd *pollset = NULL;
   int errcode = OK;
   int fd;
   int npfds;
@@ -123,8 +134,18 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  /* Allocate the descriptor list for poll() */
+  /* Allocate the descriptor list for poll().  Small lists are kept on the
+   * stack.
+   */
 
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  if (npfds > 0 && npfds <= CONFIG_FS_SELECT_NSTACKFDS)
+    {
+      pollset = stackset;
+      memset(pollset, 0, npfds * sizeof(struct pollfd));
+    }
+  else
+#endif
   if (npfds > 0)
     {
       pollset = (FAR struct pollfd *)
@@ -269,7 +290,12 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  kmm_free(pollset);
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  if (pollset != stackset)
+#endif
+    {
+      kmm_free(pollset);
+    }
 
   /* Did poll() fail above? */
 
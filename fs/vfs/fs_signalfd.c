@@ -0,0 +1,567 @@
+/****************************************************************************
+ * vfs/fs_signalfd.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <debug.h>
+
+#include <sys/ioctl.h>
+#include <sys/signalfd.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/signal.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SIGNAL_FD_VFS_PATH
+#  define CONFIG_SIGNAL_FD_VFS_PATH "/dev"
+#endif
+
+#ifndef CONFIG_SIGNAL_FD_NPOLLWAITERS
+/* Maximum number of threads than can be waiting for POLL events */
+#  define CONFIG_SIGNAL_FD_NPOLLWAITERS 2
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the internal state of the driver.  The signal
+ * logic walks the list of signalfds when a signal becomes pending, possibly
+ * from interrupt level, so the list links, the mask and the poll slots are
+ * protected by a critical section rather than by exclsem.
+ */
+
+struct signalfd_priv_s
+{
+  FAR struct signalfd_priv_s *flink; /* Supports a singly linked list */
+  FAR struct task_group_s *group;    /* Task group that owns the signals */
+  sem_t     exclsem;                 /* Enforces device exclusive access */
+  sigset_t  mask;                    /* Signals reported by this fd */
+  uint8_t   minor;                   /* signalfd minor number */
+  uint8_t   crefs;                   /* References counts on signalfd */
+
+  /* The following is a list if poll structures of threads waiting for
+   * driver events.
+   */
+
+  FAR struct pollfd *fds[CONFIG_SIGNAL_FD_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int signalfd_do_open(FAR struct file *filep);
+static int signalfd_do_close(FAR struct file *filep);
+static ssize_t signalfd_do_read(FAR struct file *filep, FAR char *buffer,
+                                size_t len);
+static int signalfd_do_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg);
+static int signalfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_signalfd_fops =
+{
+  signalfd_do_open,  /* open */
+  signalfd_do_close, /* close */
+  signalfd_do_read,  /* read */
+  0,                 /* write */
+  0,                 /* seek */
+  signalfd_do_ioctl, /* ioctl */
+  signalfd_do_poll   /* poll */
+};
+
+/* All open signalfds */
+
+static FAR struct signalfd_priv_s *g_signalfd_list;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct signalfd_priv_s *signalfd_allocdev(void)
+{
+  FAR struct signalfd_priv_s *dev;
+
+  dev = (FAR struct signalfd_priv_s *)
+    kmm_zalloc(sizeof(struct signalfd_priv_s));
+  if (dev)
+    {
+      /* Initialize the private structure */
+
+      nxsem_init(&dev->exclsem, 0, 0);
+    }
+
+  return dev;
+}
+
+static void signalfd_destroy(FAR struct signalfd_priv_s *dev)
+{
+  nxsem_destroy(&dev->exclsem);
+  kmm_free(dev);
+}
+
+static int signalfd_get_unique_minor(void)
+{
+  static int minor = 0;
+
+  /* REVISIT: Minor numbers are reused after 256 signalfds, as eventfd */
+
+  return (minor++) & 0xff;
+}
+
+/* Must be called within a critical section */
+
+static void signalfd_pollnotify(FAR struct signalfd_priv_s *dev,
+                                pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_SIGNAL_FD_NPOLLWAITERS; i++)
+    {
+      fds = dev->fds[i];
+      if (fds)
+        {
+          fds->revents |= eventset & fds->events;
+
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/* Return true if one of the signals in the mask is pending */
+
+static bool signalfd_ispending(FAR struct signalfd_priv_s *dev)
+{
+  sigset_t pending;
+
+  return sigpending(&pending) == OK && (pending & dev->mask) != 0;
+}
+
+static void signalfd_unlink(FAR struct signalfd_priv_s *dev)
+{
+  FAR struct signalfd_priv_s **prev;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (prev = &g_signalfd_list; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == dev)
+        {
+          *prev = dev->flink;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+static int signalfd_do_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *priv = inode->i_private;
+  int ret;
+
+  /* Get exclusive access to the device structures */
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("crefs: %d <%s>\n", priv->crefs, inode->i_name);
+
+  if (priv->crefs >= 255)
+    {
+      /* More than 255 opens; uint8_t would overflow to zero */
+
+      ret = -EMFILE;
+    }
+  else
+    {
+      /* Save the new open count on success */
+
+      priv->crefs += 1;
+      ret = OK;
+    }
+
+  nxsem_post(&priv->exclsem);
+  return ret;
+}
+
+static int signalfd_do_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *priv = inode->i_private;
+  int ret;
+
+  /* devpath: SIGNAL_FD_VFS_PATH + /sfd (4) + %d (3) + null char (1) */
+
+  char devpath[sizeof(CONFIG_SIGNAL_FD_VFS_PATH) + 4 + 3 + 1];
+
+  /* Get exclusive access to the device structures */
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("crefs: %d <%s>\n", priv->crefs, inode->i_name);
+
+  /* Decrement the references to the driver.  If the reference count will
+   * decrement to 0, then uninitialize the driver.
+   */
+
+  if (priv->crefs > 1)
+    {
+      /* Just decrement the reference count and release the semaphore */
+
+      priv->crefs -= 1;
+      nxsem_post(&priv->exclsem);
+      return OK;
+    }
+
+  /* Re-create the path to the driver. */
+
+  finfo("destroy\n");
+  sprintf(devpath, CONFIG_SIGNAL_FD_VFS_PATH "/sfd%d", priv->minor);
+
+  /* Will be unregistered later after close is done */
+
+  unregister_driver(devpath);
+  signalfd_unlink(priv);
+  signalfd_destroy(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: signalfd_do_read
+ *
+ * Description:
+ *   Dequeue as many pending signals of the mask as fit in the buffer.  Only
+ *   the first one may block, and only if O_NONBLOCK is not set.  The
+ *   signals are taken with sigwaitinfo(), so they must be blocked by the
+ *   caller, just as on Linux.
+ *
+ ****************************************************************************/
+
+static ssize_t signalfd_do_read(FAR struct file *filep, FAR char *buffer,
+                                size_t len)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *dev = inode->i_private;
+  FAR struct signalfd_siginfo *ssi;
+  siginfo_t info;
+  sigset_t mask;
+  ssize_t nread = 0;
+  int ret;
+
+  if (len < sizeof(struct signalfd_siginfo) || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  mask = dev->mask;
+
+  while (len - nread >= sizeof(struct signalfd_siginfo))
+    {
+      if (nread > 0 || (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          /* Don't let another thread take the signal between the test
+           * and the wait, or the wait would block.
+           */
+
+          sched_lock();
+          if (!signalfd_ispending(dev))
+            {
+              sched_unlock();
+              break;
+            }
+
+          ret = nxsig_waitinfo(&mask, &info);
+          sched_unlock();
+        }
+      else
+        {
+          ret = nxsig_waitinfo(&mask, &info);
+        }
+
+      if (ret < 0)
+        {
+          return nread > 0 ? nread : ret;
+        }
+
+      ssi = (FAR struct signalfd_siginfo *)(buffer + nread);
+      memset(ssi, 0, sizeof(*ssi));
+      ssi->ssi_signo  = info.si_signo;
+      ssi->ssi_errno  = info.si_errno;
+      ssi->ssi_code   = info.si_code;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+      ssi->ssi_pid    = info.si_pid;
+      ssi->ssi_status = info.si_status;
+#endif
+      ssi->ssi_int    = info.si_value.sival_int;
+      ssi->ssi_ptr    = (uintptr_t)info.si_value.sival_ptr;
+
+      nread += sizeof(struct signalfd_siginfo);
+    }
+
+  return nread > 0 ? nread : -EAGAIN;
+}
+
+static int signalfd_do_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *priv = inode->i_private;
+
+  if (cmd == FIOC_MINOR)
+    {
+      *(FAR int *)((uintptr_t)arg) = priv->minor;
+      return OK;
+    }
+
+  return -ENOSYS;
+}
+
+static int signalfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *dev = inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      /* Remove all memory of the poll setup */
+
+      *slot     = NULL;
+      fds->priv = NULL;
+      goto errout;
+    }
+
+  /* This is a request to set up the poll. Find an available
+   * slot for the poll structure reference
+   */
+
+  for (i = 0; i < CONFIG_SIGNAL_FD_NPOLLWAITERS; i++)
+    {
+      /* Find an available slot */
+
+      if (!dev->fds[i])
+        {
+          /* Bind the poll structure and this slot */
+
+          dev->fds[i] = fds;
+          fds->priv   = &dev->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_SIGNAL_FD_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto errout;
+    }
+
+  /* Notify the POLLIN event if a signal is already pending */
+
+  if (signalfd_ispending(dev))
+    {
+      signalfd_pollnotify(dev, POLLIN);
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: signalfd_notify
+ *
+ * Description:
+ *   Called by the signal logic when a signal becomes pending for a task
+ *   group.  Wakes up the pollers of every signalfd of that group whose
+ *   mask contains the signal.  May be called from interrupt level.
+ *
+ ****************************************************************************/
+
+void signalfd_notify(FAR struct task_group_s *group, int signo)
+{
+  FAR struct signalfd_priv_s *dev;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (dev = g_signalfd_list; dev != NULL; dev = dev->flink)
+    {
+      if (dev->group == group && nxsig_ismember(&dev->mask, signo) == 1)
+        {
+          signalfd_pollnotify(dev, POLLIN);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+int signalfd(int fd, FAR const sigset_t *mask, int flags)
+{
+  FAR struct signalfd_priv_s *new_dev;
+  irqstate_t intflags;
+  int new_minor;
+  int new_fd;
+  int ret;
+
+  /* devpath: SIGNAL_FD_VFS_PATH + /sfd (4) + %d (3) + null char (1) */
+
+  char devpath[sizeof(CONFIG_SIGNAL_FD_VFS_PATH) + 4 + 3 + 1];
+
+  if (mask == NULL || (flags & ~(SFD_NONBLOCK | SFD_CLOEXEC)) != 0)
+    {
+      ret = EINVAL;
+      goto exit_set_errno;
+    }
+
+  /* Replace the mask of an existing signalfd */
+
+  if (fd != -1)
+    {
+      FAR struct file *filep;
+
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0 || filep->f_inode == NULL ||
+          filep->f_inode->u.i_ops != &g_signalfd_fops)
+        {
+          ret = EINVAL;
+          goto exit_set_errno;
+        }
+
+      new_dev  = filep->f_inode->i_private;
+      intflags = enter_critical_section();
+      new_dev->mask = *mask;
+      leave_critical_section(intflags);
+      return fd;
+    }
+
+  /* Allocate instance data for this driver */
+
+  new_dev = signalfd_allocdev();
+  if (new_dev == NULL)
+    {
+      /* Failed to allocate new device */
+
+      ret = ENOMEM;
+      goto exit_set_errno;
+    }
+
+  new_dev->group = nxsched_self()->group;
+  new_dev->mask  = *mask;
+
+  /* Request a unique minor device number */
+
+  new_minor      = signalfd_get_unique_minor();
+  new_dev->minor = new_minor;
+
+  /* Get device path */
+
+  sprintf(devpath, CONFIG_SIGNAL_FD_VFS_PATH "/sfd%d", new_minor);
+
+  /* Register the driver */
+
+  ret = register_driver(devpath, &g_signalfd_fops, 0444, new_dev);
+  if (ret < 0)
+    {
+      ferr("Failed to register new device %s: %d\n", devpath, ret);
+      ret = -ret;
+      goto exit_free_new_dev;
+    }
+
+  /* Make the signalfd visible to the signal logic */
+
+  intflags = enter_critical_section();
+  new_dev->flink  = g_signalfd_list;
+  g_signalfd_list = new_dev;
+  leave_critical_section(intflags);
+
+  /* Device is ready for use */
+
+  nxsem_post(&new_dev->exclsem);
+
+  /* Try open new device */
+
+  new_fd = open(devpath, O_RDONLY | flags);
+  if (new_fd < 0)
+    {
+      ret = -new_fd;
+      goto exit_unregister_driver;
+    }
+
+  return new_fd;
+
+exit_unregister_driver:
+  unregister_driver(devpath);
+  signalfd_unlink(new_dev);
+exit_free_new_dev:
+  signalfd_destroy(new_dev);
+exit_set_errno:
+  set_errno(ret);
+  return ERROR;
+}
@@ -0,0 +1,658 @@
+/****************************************************************************
+ * vfs/fs_timerfd.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <debug.h>
+
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_TIMER_FD_VFS_PATH
+#  define CONFIG_TIMER_FD_VFS_PATH "/dev"
+#endif
+
+#ifndef CONFIG_TIMER_FD_NPOLLWAITERS
+/* Maximum number of threads than can be waiting for POLL events */
+#  define CONFIG_TIMER_FD_NPOLLWAITERS 2
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the internal state of the driver.  The
+ * expiration count, the interval and the poll slots are touched by the
+ * watchdog handler, so they are protected by a critical section rather
+ * than by exclsem.
+ */
+
+struct timerfd_priv_s
+{
+  sem_t     exclsem;            /* Enforces device exclusive access */
+  sem_t     rdsem;              /* Blocking readers wait here */
+  struct wdog_s wdog;           /* The timer itself */
+  clockid_t clock;              /* Clock used for TFD_TIMER_ABSTIME */
+  sclock_t  interval;           /* Reload value in ticks, 0 = one-shot */
+  uint64_t  count;              /* Expirations since the last read */
+  uint8_t   minor;              /* timerfd minor number */
+  uint8_t   crefs;              /* References counts on timerfd (max: 255) */
+
+  /* The following is a list if poll structures of threads waiting for
+   * driver events.
+   */
+
+  FAR struct pollfd *fds[CONFIG_TIMER_FD_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int timerfd_do_open(FAR struct file *filep);
+static int timerfd_do_close(FAR struct file *filep);
+static ssize_t timerfd_do_read(FAR struct file *filep, FAR char *buffer,
+                               size_t len);
+static int timerfd_do_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+static int timerfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_timerfd_fops =
+{
+  timerfd_do_open,  /* open */
+  timerfd_do_close, /* close */
+  timerfd_do_read,  /* read */
+  0,                /* write */
+  0,                /* seek */
+  timerfd_do_ioctl, /* ioctl */
+  timerfd_do_poll   /* poll */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct timerfd_priv_s *timerfd_allocdev(void)
+{
+  FAR struct timerfd_priv_s *dev;
+
+  dev = (FAR struct timerfd_priv_s *)
+    kmm_zalloc(sizeof(struct timerfd_priv_s));
+  if (dev)
+    {
+      /* Initialize the private structure */
+
+      nxsem_init(&dev->exclsem, 0, 0);
+      nxsem_init(&dev->rdsem, 0, 0);
+      nxsem_set_protocol(&dev->rdsem, SEM_PRIO_NONE);
+    }
+
+  return dev;
+}
+
+static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
+{
+  wd_cancel(&dev->wdog);
+  nxsem_destroy(&dev->rdsem);
+  nxsem_destroy(&dev->exclsem);
+  kmm_free(dev);
+}
+
+static int timerfd_get_unique_minor(void)
+{
+  static int minor = 0;
+
+  /* REVISIT: Minor numbers are reused after 256 timerfds, as eventfd */
+
+  return (minor++) & 0xff;
+}
+
+/* Must be called within a critical section */
+
+static void timerfd_pollnotify(FAR struct timerfd_priv_s *dev,
+                               pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_TIMER_FD_NPOLLWAITERS; i++)
+    {
+      fds = dev->fds[i];
+      if (fds)
+        {
+          fds->revents |= eventset & fds->events;
+
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: timerfd_timeout
+ *
+ * Description:
+ *   Watchdog handler: count one expiration, re-arm a periodic timer and
+ *   wake up everybody waiting on the timerfd.  Runs in interrupt context.
+ *
+ ****************************************************************************/
+
+static void timerfd_timeout(wdparm_t arg)
+{
+  FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
+  int sval;
+
+  if (dev->interval > 0)
+    {
+      wd_start(&dev->wdog, dev->interval, timerfd_timeout, arg);
+    }
+
+  dev->count++;
+
+  /* Release all blocked readers; each re-checks the count */
+
+  while (nxsem_get_value(&dev->rdsem, &sval) >= 0 && sval < 0)
+    {
+      nxsem_post(&dev->rdsem);
+    }
+
+  timerfd_pollnotify(dev, POLLIN);
+}
+
+/****************************************************************************
+ * Name: timerfd_ts2ticks
+ *
+ * Description:
+ *   Convert a relative time to a watchdog delay, rounding up so that the
+ *   timer never fires early.  Non-zero times yield at least one tick.
+ *
+ ****************************************************************************/
+
+static sclock_t timerfd_ts2ticks(FAR const struct timespec *ts)
+{
+  uint64_t ticks;
+
+  ticks = ((uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec +
+           NSEC_PER_TICK - 1) / NSEC_PER_TICK;
+  if (ticks > INT32_MAX)
+    {
+      ticks = INT32_MAX;
+    }
+
+  return ticks;
+}
+
+static void timerfd_ticks2ts(sclock_t ticks, FAR struct timespec *ts)
+{
+  uint64_t nsec = TICK2NSEC((uint64_t)ticks);
+
+  ts->tv_sec  = nsec / NSEC_PER_SEC;
+  ts->tv_nsec = nsec % NSEC_PER_SEC;
+}
+
+/****************************************************************************
+ * Name: timerfd_getpriv
+ *
+ * Description:
+ *   Map a file descriptor to the timerfd it refers to.
+ *
+ ****************************************************************************/
+
+static FAR struct timerfd_priv_s *timerfd_getpriv(int fd)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return NULL;
+    }
+
+  if (filep->f_inode == NULL ||
+      filep->f_inode->u.i_ops != &g_timerfd_fops)
+    {
+      return NULL;
+    }
+
+  return filep->f_inode->i_private;
+}
+
+static int timerfd_do_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct timerfd_priv_s *priv = inode->i_private;
+  int ret;
+
+  /* Get exclusive access to the device structures */
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("crefs: %d <%s>\n", priv->crefs, inode->i_name);
+
+  if (priv->crefs >= 255)
+    {
+      /* More than 255 opens; uint8_t would overflow to zero */
+
+      ret = -EMFILE;
+    }
+  else
+    {
+      /* Save the new open count on success */
+
+      priv->crefs += 1;
+      ret = OK;
+    }
+
+  nxsem_post(&priv->exclsem);
+  return ret;
+}
+
+static int timerfd_do_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct timerfd_priv_s *priv = inode->i_private;
+  int ret;
+
+  /* devpath: TIMER_FD_VFS_PATH + /tfd (4) + %d (3) + null char (1) */
+
+  char devpath[sizeof(CONFIG_TIMER_FD_VFS_PATH) + 4 + 3 + 1];
+
+  /* Get exclusive access to the device structures */
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("crefs: %d <%s>\n", priv->crefs, inode->i_name);
+
+  /* Decrement the references to the driver.  If the reference count will
+   * decrement to 0, then uninitialize the driver.
+   */
+
+  if (priv->crefs > 1)
+    {
+      /* Just decrement the reference count and release the semaphore */
+
+      priv->crefs -= 1;
+      nxsem_post(&priv->exclsem);
+      return OK;
+    }
+
+  /* Re-create the path to the driver. */
+
+  finfo("destroy\n");
+  sprintf(devpath, CONFIG_TIMER_FD_VFS_PATH "/tfd%d", priv->minor);
+
+  /* Will be unregistered later after close is done */
+
+  unregister_driver(devpath);
+  timerfd_destroy(priv);
+  return OK;
+}
+
+static ssize_t timerfd_do_read(FAR struct file *filep, FAR char *buffer,
+                               size_t len)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct timerfd_priv_s *dev = inode->i_private;
+  irqstate_t flags;
+  int ret;
+
+  if (len < sizeof(uint64_t) || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Wait for the timer to expire at least once.  The critical section is
+   * released while the task sleeps on rdsem.
+   */
+
+  flags = enter_critical_section();
+  while (dev->count == 0)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->rdsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  *(FAR uint64_t *)buffer = dev->count;
+  dev->count = 0;
+  leave_critical_section(flags);
+
+  return sizeof(uint64_t);
+}
+
+static int timerfd_do_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct timerfd_priv_s *priv = inode->i_private;
+
+  if (cmd == FIOC_MINOR)
+    {
+      *(FAR int *)((uintptr_t)arg) = priv->minor;
+      return OK;
+    }
+
+  return -ENOSYS;
+}
+
+static int timerfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct timerfd_priv_s *dev = inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      /* Remove all memory of the poll setup */
+
+      *slot     = NULL;
+      fds->priv = NULL;
+      goto errout;
+    }
+
+  /* This is a request to set up the poll. Find an available
+   * slot for the poll structure reference
+   */
+
+  for (i = 0; i < CONFIG_TIMER_FD_NPOLLWAITERS; i++)
+    {
+      /* Find an available slot */
+
+      if (!dev->fds[i])
+        {
+          /* Bind the poll structure and this slot */
+
+          dev->fds[i] = fds;
+          fds->priv   = &dev->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_TIMER_FD_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto errout;
+    }
+
+  /* Notify the POLLIN event if the timer has already expired */
+
+  if (dev->count > 0)
+    {
+      timerfd_pollnotify(dev, POLLIN);
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int timerfd_create(int clockid, int flags)
+{
+  FAR struct timerfd_priv_s *new_dev;
+  int new_minor;
+  int new_fd;
+  int ret;
+
+  /* devpath: TIMER_FD_VFS_PATH + /tfd (4) + %d (3) + null char (1) */
+
+  char devpath[sizeof(CONFIG_TIMER_FD_VFS_PATH) + 4 + 3 + 1];
+
+  if ((clockid != CLOCK_REALTIME
+#ifdef CONFIG_CLOCK_MONOTONIC
+       && clockid != CLOCK_MONOTONIC
+#endif
+      ) || (flags & ~(TFD_NONBLOCK | TFD_CLOEXEC)) != 0)
+    {
+      ret = EINVAL;
+      goto exit_set_errno;
+    }
+
+  /* Allocate instance data for this driver */
+
+  new_dev = timerfd_allocdev();
+  if (new_dev == NULL)
+    {
+      /* Failed to allocate new device */
+
+      ret = ENOMEM;
+      goto exit_set_errno;
+    }
+
+  new_dev->clock = clockid;
+
+  /* Request a unique minor device number */
+
+  new_minor      = timerfd_get_unique_minor();
+  new_dev->minor = new_minor;
+
+  /* Get device path */
+
+  sprintf(devpath, CONFIG_TIMER_FD_VFS_PATH "/tfd%d", new_minor);
+
+  /* Register the driver */
+
+  ret = register_driver(devpath, &g_timerfd_fops, 0444, new_dev);
+  if (ret < 0)
+    {
+      ferr("Failed to register new device %s: %d\n", devpath, ret);
+      ret = -ret;
+      goto exit_free_new_dev;
+    }
+
+  /* Device is ready for use */
+
+  nxsem_post(&new_dev->exclsem);
+
+  /* Try open new device */
+
+  new_fd = open(devpath, O_RDONLY | flags);
+  if (new_fd < 0)
+    {
+      ret = -new_fd;
+      goto exit_unregister_driver;
+    }
+
+  return new_fd;
+
+exit_unregister_driver:
+  unregister_driver(devpath);
+exit_free_new_dev:
+  timerfd_destroy(new_dev);
+exit_set_errno:
+  set_errno(ret);
+  return ERROR;
+}
+
+int timerfd_settime(int fd, int flags,
+                    FAR const struct itimerspec *new_value,
+                    FAR struct itimerspec *old_value)
+{
+  FAR struct timerfd_priv_s *dev;
+  struct timespec delay;
+  irqstate_t intflags;
+  int ret;
+
+  if (new_value == NULL || (flags & ~TFD_TIMER_ABSTIME) != 0 ||
+      new_value->it_value.tv_nsec < 0 ||
+      new_value->it_value.tv_nsec >= NSEC_PER_SEC ||
+      new_value->it_interval.tv_nsec < 0 ||
+      new_value->it_interval.tv_nsec >= NSEC_PER_SEC)
+    {
+      ret = EINVAL;
+      goto errout;
+    }
+
+  dev = timerfd_getpriv(fd);
+  if (dev == NULL)
+    {
+      ret = EINVAL;
+      goto errout;
+    }
+
+  if (old_value != NULL)
+    {
+      timerfd_gettime(fd, old_value);
+    }
+
+  /* Work out the delay to the first expiration */
+
+  delay = new_value->it_value;
+  if ((flags & TFD_TIMER_ABSTIME) != 0 &&
+      (delay.tv_sec != 0 || delay.tv_nsec != 0))
+    {
+      struct timespec now;
+
+      clock_gettime(dev->clock, &now);
+      if (delay.tv_sec < now.tv_sec ||
+          (delay.tv_sec == now.tv_sec && delay.tv_nsec <= now.tv_nsec))
+        {
+          /* Already in the past: expire on the next tick */
+
+          delay.tv_sec  = 0;
+          delay.tv_nsec = 1;
+        }
+      else
+        {
+          delay.tv_sec -= now.tv_sec;
+          delay.tv_nsec -= now.tv_nsec;
+          if (delay.tv_nsec < 0)
+            {
+              delay.tv_sec--;
+              delay.tv_nsec += NSEC_PER_SEC;
+            }
+        }
+    }
+
+  /* Stop the old timer and start the new one.  Expirations that were not
+   * read yet are discarded, as on Linux.
+   */
+
+  intflags = enter_critical_section();
+
+  wd_cancel(&dev->wdog);
+  dev->count    = 0;
+  dev->interval = timerfd_ts2ticks(&new_value->it_interval);
+
+  if (delay.tv_sec != 0 || delay.tv_nsec != 0)
+    {
+      ret = wd_start(&dev->wdog, timerfd_ts2ticks(&delay),
+                     timerfd_timeout, (wdparm_t)dev);
+    }
+  else
+    {
+      ret = OK;
+    }
+
+  leave_critical_section(intflags);
+
+  if (ret < 0)
+    {
+      ret = -ret;
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  set_errno(ret);
+  return ERROR;
+}
+
+int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
+{
+  FAR struct timerfd_priv_s *dev;
+  irqstate_t flags;
+  sclock_t remaining;
+
+  dev = timerfd_getpriv(fd);
+  if (dev == NULL || curr_value == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  flags     = enter_critical_section();
+  remaining = wd_gettime(&dev->wdog);
+  timerfd_ticks2ts(dev->interval, &curr_value->it_interval);
+  leave_critical_section(flags);
+
+  timerfd_ticks2ts(remaining, &curr_value->it_value);
+  return OK;
+}
@@ -191,6 +191,18 @@ struct nxbe_plane_s
 
   NX_DRIVERTYPE *driver;
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_DOUBLEBUFFER
+  /* Double buffering.  pinfo.fbmem/fblen/yoffset describe the back buffer
+   * that is rendered into and 'damage' bounds what was drawn in it since
+   * the last flip.
+   */
+
+  bool dbuf;                      /* True: double buffering is active */
+  bool dirty;                     /* True: 'damage' is valid */
+  FAR uint8_t *fbfront;           /* The visible (front) buffer */
+  struct nxgl_rect_s damage;      /* Region drawn since the last flip */
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -822,6 +834,77 @@ void nxbe_clipper(FAR struct nxbe_window_s *wnd,
                   FAR struct nxbe_clipops_s *cops,
                   FAR struct nxbe_plane_s *plane);
 
+/****************************************************************************
+ * Name: nxbe_flip_configure
+ *
+ * Description:
+ *   Enable double buffering on plane 'planeno' if the framebuffer driver
+ *   supports it.  Called from nxbe_configure().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_DOUBLEBUFFER
+void nxbe_flip_configure(FAR struct nxbe_state_s *be, int planeno);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Record that a rectangle (device coordinates) of the back buffer has
+ *   been modified.  Without double buffering, this simply notifies the
+ *   display update hook (if CONFIG_NX_UPDATE).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_DOUBLEBUFFER
+void nxbe_damage(FAR struct nxbe_plane_s *plane,
+                 FAR const struct nxgl_rect_s *rect);
+#else
+#  define nxbe_damage(plane, rect)
+#endif
+
+/****************************************************************************
+ * Name: nxbe_flip
+ *
+ * Description:
+ *   Show the back buffers of all damaged planes and copy the damaged region
+ *   forward into the new back buffers.  Called by the server when no more
+ *   requests are pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_DOUBLEBUFFER
+void nxbe_flip(FAR struct nxbe_state_s *be);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_fillrect_dev and nxbe_copyrect_dev
+ *
+ * Description:
+ *   Fill or copy a rectangle (device coordinates) of one plane in device
+ *   memory.  The 2D acceleration of the framebuffer driver is used when
+ *   available and the software rasterizer of nxglib otherwise.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FB_ACCEL) && !defined(CONFIG_NX_LCDDRIVER)
+void nxbe_fillrect_dev(FAR struct nxbe_plane_s *plane,
+                       FAR const struct nxgl_rect_s *rect,
+                       nxgl_mxpixel_t color);
+void nxbe_copyrect_dev(FAR struct nxbe_plane_s *plane,
+                       FAR const struct nxgl_rect_s *dest,
+                       FAR const void *src,
+                       FAR const struct nxgl_point_s *origin,
+                       unsigned int srcstride);
+#else
+#  define nxbe_fillrect_dev(plane, rect, color) \
+     (plane)->dev.fillrectangle(&(plane)->pinfo, rect, color)
+#  define nxbe_copyrect_dev(plane, dest, src, origin, srcstride) \
+     (plane)->dev.copyrectangle(&(plane)->pinfo, dest, src, origin, \
+                                srcstride)
+#endif
+
 /****************************************************************************
  * Name: nxbe_clipnull
  *
@@ -0,0 +1,125 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_accel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/video/fb.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_rect2area
+ *
+ * Description:
+ *   Convert an NX rectangle to a framebuffer area.
+ *
+ ****************************************************************************/
+
+static inline void nxbe_rect2area(FAR const struct nxgl_rect_s *rect,
+                                  FAR struct fb_area_s *area)
+{
+  area->x = rect->pt1.x;
+  area->y = rect->pt1.y;
+  area->w = rect->pt2.x - rect->pt1.x + 1;
+  area->h = rect->pt2.y - rect->pt1.y + 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_fillrect_dev
+ *
+ * Description:
+ *   Fill a rectangle of one plane in device memory, using the 2D
+ *   acceleration of the framebuffer driver when available.
+ *
+ ****************************************************************************/
+
+void nxbe_fillrect_dev(FAR struct nxbe_plane_s *plane,
+                       FAR const struct nxgl_rect_s *rect,
+                       nxgl_mxpixel_t color)
+{
+  FAR const struct fb_accel_ops_s *accel = plane->driver->accel;
+  struct fb_area_s area;
+
+  if (accel != NULL && accel->fillrect != NULL)
+    {
+      nxbe_rect2area(rect, &area);
+      if (accel->fillrect(plane->driver, &plane->pinfo, &area,
+                          (uint32_t)color) >= 0)
+        {
+          return;
+        }
+    }
+
+  plane->dev.fillrectangle(&plane->pinfo, rect, color);
+}
+
+/****************************************************************************
+ * Name: nxbe_copyrect_dev
+ *
+ * Description:
+ *   Copy a rectangular region of an image in memory to one plane in device
+ *   memory, using the 2D acceleration of the framebuffer driver when
+ *   available.  Images with less than 8 bits per pixel are always copied
+ *   in software since the source may not start on a byte boundary.
+ *
+ ****************************************************************************/
+
+void nxbe_copyrect_dev(FAR struct nxbe_plane_s *plane,
+                       FAR const struct nxgl_rect_s *dest,
+                       FAR const void *src,
+                       FAR const struct nxgl_point_s *origin,
+                       unsigned int srcstride)
+{
+  FAR const struct fb_accel_ops_s *accel = plane->driver->accel;
+  FAR const uint8_t *sline;
+  struct fb_area_s area;
+
+  if (accel != NULL && accel->copyrect != NULL && plane->pinfo.bpp >= 8)
+    {
+      sline = (FAR const uint8_t *)src +
+              (dest->pt1.y - origin->y) * srcstride +
+              (dest->pt1.x - origin->x) * (plane->pinfo.bpp >> 3);
+
+      nxbe_rect2area(dest, &area);
+      if (accel->copyrect(plane->driver, &plane->pinfo, &area, sline,
+                          srcstride) >= 0)
+        {
+          return;
+        }
+    }
+
+  plane->dev.copyrectangle(&plane->pinfo, dest, src, origin, srcstride);
+}
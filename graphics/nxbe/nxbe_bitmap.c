@@ -80,10 +80,12 @@ static void bitmap_clipcopy(FAR struct nxbe_clipops_s *cops,
 
   /* Copy the rectangular region to the graphics device. */
 
-  plane->dev.copyrectangle(&plane->pinfo, rect, bminfo->src,
-                           &bminfo->origin, bminfo->stride);
+  nxbe_copyrect_dev(plane, rect, bminfo->src, &bminfo->origin,
+                    bminfo->stride);
 
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_DOUBLEBUFFER)
+  nxbe_damage(plane, rect);
+#elif defined(CONFIG_NX_UPDATE)
   /* Notify external logic that the display has been updated */
 
   nxbe_notify_rectangle(plane->driver, rect);
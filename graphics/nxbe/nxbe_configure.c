@@ -122,6 +122,12 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
 
       be->plane[i].driver = dev;
 
+#ifdef CONFIG_NX_DOUBLEBUFFER
+      /* Render into a back buffer if the driver supports page flipping */
+
+      nxbe_flip_configure(be, i);
+#endif
+
       /* Select rasterizers to match the BPP reported for this plane.
        * NOTE that there are configuration options to eliminate support
        * for unused BPP values.  If the unused BPP values are not suppressed
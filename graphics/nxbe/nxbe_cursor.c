@@ -102,6 +102,7 @@ void nxbe_cursor_enable(FAR struct nxbe_state_s *be, bool enable)
               /* Write the new cursor image to device memory */
 
               be->plane[0].cursor.draw(be, &bounds, 0);
+              nxbe_damage(&be->plane[0], &bounds);
             }
 
           /* Mark the cursor visible */
@@ -144,6 +145,7 @@ void nxbe_cursor_enable(FAR struct nxbe_state_s *be, bool enable)
            */
 
           be->plane[0].cursor.erase(be, &bounds, 0);
+          nxbe_damage(&be->plane[0], &bounds);
         }
 #else
       /* For a hardware cursor, this would require some interaction with the
@@ -207,6 +209,7 @@ void nxbe_cursor_setimage(FAR struct nxbe_state_s *be,
 
           DEBUGASSERT(be->cursor.bkgd != NULL);
           be->plane[0].cursor.erase(be, &bounds, 0);
+          nxbe_damage(&be->plane[0], &bounds);
         }
     }
 
@@ -280,6 +283,7 @@ errout_with_erase:
       /* Write the new cursor image to the device graphics memory. */
 
       be->plane[0].cursor.draw(be, &be->cursor.bounds, 0);
+      nxbe_damage(&be->plane[0], &be->cursor.bounds);
     }
 
 #else
@@ -325,6 +329,7 @@ void nxbe_cursor_setposition(FAR struct nxbe_state_s *be,
       /* Erase the old cursor image by writing the saved background image. */
 
       be->plane[0].cursor.erase(be, &be->cursor.bounds, 0);
+      nxbe_damage(&be->plane[0], &be->cursor.bounds);
     }
 
   /* Calculate the cursor movement */
@@ -356,6 +361,7 @@ void nxbe_cursor_setposition(FAR struct nxbe_state_s *be,
           /* Write the new cursor image to the device graphics memory. */
 
           be->plane[0].cursor.draw(be, &bounds, 0);
+          nxbe_damage(&be->plane[0], &bounds);
         }
     }
 
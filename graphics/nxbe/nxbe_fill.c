@@ -78,9 +78,11 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 
   /* Draw the rectangle to the graphics device. */
 
-  plane->dev.fillrectangle(&plane->pinfo, rect, fillinfo->color);
+  nxbe_fillrect_dev(plane, rect, fillinfo->color);
 
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_DOUBLEBUFFER)
+  nxbe_damage(plane, rect);
+#elif defined(CONFIG_NX_UPDATE)
   /* Notify external logic that the display has been updated */
 
   nxbe_notify_rectangle(plane->driver, rect);
@@ -88,7 +88,7 @@ static void nxbe_clipfilltrapezoid(FAR struct nxbe_clipops_s *cops,
                                    FAR const struct nxgl_rect_s *rect)
 {
   struct nxbe_filltrap_s *fillinfo = (struct nxbe_filltrap_s *)cops;
-#ifdef CONFIG_NX_UPDATE
+#if !defined(CONFIG_NX_DOUBLEBUFFER) && defined(CONFIG_NX_UPDATE)
   struct nxgl_rect_s update;
 #endif
 
@@ -97,7 +97,9 @@ static void nxbe_clipfilltrapezoid(FAR struct nxbe_clipops_s *cops,
   plane->dev.filltrapezoid(&plane->pinfo, &fillinfo->trap, rect,
                            fillinfo->color);
 
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_DOUBLEBUFFER)
+  nxbe_damage(plane, rect);
+#elif defined(CONFIG_NX_UPDATE)
   /* Notify external logic that the display has been updated */
 
   update.pt1.x = MIN(MAX(fillinfo->trap.top.x1, rect->pt1.x),
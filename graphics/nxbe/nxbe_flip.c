@@ -0,0 +1,255 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_flip.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/video/fb.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_copyforward
+ *
+ * Description:
+ *   Copy a rectangle (device coordinates) from one buffer of the plane to
+ *   the other.  Partial bytes at the edges of sub-byte pixels are copied
+ *   whole; the source buffer is up to date in those bytes too.
+ *
+ ****************************************************************************/
+
+static void nxbe_copyforward(FAR struct nxbe_plane_s *plane,
+                             FAR uint8_t *dest, FAR const uint8_t *src,
+                             FAR const struct nxgl_rect_s *rect)
+{
+  unsigned int stride = plane->pinfo.stride;
+  unsigned int bpp    = plane->pinfo.bpp;
+  size_t offset;
+  size_t start;
+  size_t end;
+  nxgl_coord_t y;
+
+  start  = ((size_t)rect->pt1.x * bpp) >> 3;
+  end    = (((size_t)rect->pt2.x + 1) * bpp + 7) >> 3;
+  offset = (size_t)rect->pt1.y * stride + start;
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y++, offset += stride)
+    {
+      memcpy(dest + offset, src + offset, end - start);
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_flip_plane
+ *
+ * Description:
+ *   Show the back buffer of one plane and copy the damaged region forward
+ *   into the new back buffer.
+ *
+ ****************************************************************************/
+
+static void nxbe_flip_plane(FAR struct nxbe_state_s *be,
+                            FAR struct nxbe_plane_s *plane)
+{
+  FAR struct fb_vtable_s *dev = plane->driver;
+  FAR uint8_t *front = plane->fbfront;
+  struct fb_planeinfo_s pinfo;
+  int ret;
+
+  /* Show the back buffer.  The driver latches it at vertical blanking and
+   * we wait for that before drawing into the old front buffer.
+   */
+
+  memcpy(&pinfo, &plane->pinfo, sizeof(struct fb_planeinfo_s));
+  pinfo.fbmem   = front < (FAR uint8_t *)plane->pinfo.fbmem ?
+                  front : plane->pinfo.fbmem;
+  pinfo.fblen   = 2 * plane->pinfo.fblen;
+  pinfo.xoffset = 0;
+
+  ret = dev->pandisplay(dev, &pinfo);
+  if (ret < 0)
+    {
+      /* Fall back to drawing into the visible buffer */
+
+      gerr("ERROR: pandisplay failed: %d\n", ret);
+      nxbe_copyforward(plane, front, plane->pinfo.fbmem, &plane->damage);
+      plane->pinfo.fbmem = front;
+      plane->dbuf        = false;
+    }
+  else
+    {
+#ifdef CONFIG_FB_SYNC
+      if (dev->waitforvsync != NULL)
+        {
+          dev->waitforvsync(dev);
+        }
+#endif
+
+      /* The old front buffer becomes the back buffer.  Bring it up to date
+       * with what was drawn since the last flip.
+       */
+
+      plane->fbfront       = plane->pinfo.fbmem;
+      plane->pinfo.fbmem   = front;
+      plane->pinfo.yoffset = plane->pinfo.yoffset == 0 ? be->vinfo.yres : 0;
+
+      nxbe_copyforward(plane, front, plane->fbfront, &plane->damage);
+    }
+
+#ifdef CONFIG_NX_UPDATE
+  /* Notify external logic that the display has been updated */
+
+  nxbe_notify_rectangle(dev, &plane->damage);
+#endif
+
+  plane->dirty = false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_flip_configure
+ *
+ * Description:
+ *   Enable double buffering on plane 'planeno' if the framebuffer driver
+ *   supports it:  The virtual plane must hold two screens and the driver
+ *   must be able to pan the display.  The display is panned to the first
+ *   screen and rendering goes to the second one.
+ *
+ ****************************************************************************/
+
+void nxbe_flip_configure(FAR struct nxbe_state_s *be, int planeno)
+{
+  FAR struct nxbe_plane_s *plane = &be->plane[planeno];
+  FAR struct fb_vtable_s *dev = plane->driver;
+  struct fb_planeinfo_s pinfo;
+  size_t size;
+  int ret;
+
+  plane->dbuf  = false;
+  plane->dirty = false;
+
+  size = (size_t)plane->pinfo.stride * be->vinfo.yres;
+  if (dev->pandisplay == NULL ||
+      plane->pinfo.yres_virtual < 2 * be->vinfo.yres ||
+      plane->pinfo.fblen < 2 * size)
+    {
+      ginfo("Plane %d: no double buffering\n", planeno);
+      return;
+    }
+
+  memcpy(&pinfo, &plane->pinfo, sizeof(struct fb_planeinfo_s));
+  pinfo.xoffset = 0;
+  pinfo.yoffset = 0;
+
+  ret = dev->pandisplay(dev, &pinfo);
+  if (ret < 0)
+    {
+      gerr("ERROR: pandisplay failed: %d\n", ret);
+      return;
+    }
+
+  /* From now on, pinfo describes the back buffer */
+
+  plane->fbfront       = (FAR uint8_t *)plane->pinfo.fbmem;
+  plane->pinfo.fbmem   = plane->fbfront + size;
+  plane->pinfo.fblen   = size;
+  plane->pinfo.yoffset = be->vinfo.yres;
+  plane->dbuf          = true;
+
+  ginfo("Plane %d: double buffered, back buffer at %p\n",
+        planeno, plane->pinfo.fbmem);
+}
+
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Record that a rectangle (device coordinates) of the back buffer has
+ *   been modified.  Without double buffering, this simply notifies the
+ *   display update hook (if CONFIG_NX_UPDATE).
+ *
+ ****************************************************************************/
+
+void nxbe_damage(FAR struct nxbe_plane_s *plane,
+                 FAR const struct nxgl_rect_s *rect)
+{
+  if (!plane->dbuf)
+    {
+#ifdef CONFIG_NX_UPDATE
+      nxbe_notify_rectangle(plane->driver, rect);
+#endif
+      return;
+    }
+
+  if (plane->dirty)
+    {
+      nxgl_rectunion(&plane->damage, &plane->damage, rect);
+    }
+  else
+    {
+      nxgl_rectcopy(&plane->damage, rect);
+      plane->dirty = true;
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_flip
+ *
+ * Description:
+ *   Show the back buffers of all damaged planes and copy the damaged region
+ *   forward into the new back buffers.  Called by the server when no more
+ *   requests are pending.
+ *
+ ****************************************************************************/
+
+void nxbe_flip(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  int i;
+
+#if CONFIG_NX_NPLANES > 1
+  for (i = 0; i < be->vinfo.nplanes; i++)
+#else
+  i = 0;
+#endif
+    {
+      plane = &be->plane[i];
+      if (plane->dbuf && plane->dirty)
+        {
+          nxbe_flip_plane(be, plane);
+        }
+    }
+}
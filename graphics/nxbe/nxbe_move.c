@@ -80,7 +80,9 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
 {
   struct nxbe_move_s *info = (struct nxbe_move_s *)cops;
   struct nxgl_point_s offset;
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_DOUBLEBUFFER)
+  struct nxgl_rect_s update;
+#elif defined(CONFIG_NX_UPDATE)
   FAR struct nxbe_window_s *wnd;
   struct nxgl_rect_s update;
 #endif
@@ -98,7 +100,12 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
 
       plane->dev.moverectangle(&plane->pinfo, rect, &offset);
 
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_DOUBLEBUFFER)
+      /* The destination of the move (device coordinates) was modified */
+
+      nxgl_rectoffset(&update, rect, info->offset.x, info->offset.y);
+      nxbe_damage(plane, &update);
+#elif defined(CONFIG_NX_UPDATE)
       /* Move the source rectangle back to window relative coordinates and
        * apply the offset.
        */
@@ -79,7 +79,9 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 
   plane->dev.setpixel(&plane->pinfo, &rect->pt1, fillinfo->color);
 
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_DOUBLEBUFFER)
+  nxbe_damage(plane, rect);
+#elif defined(CONFIG_NX_UPDATE)
   /* Notify external logic that the display has been updated */
 
   nxbe_notify_rectangle(plane->driver, rect);
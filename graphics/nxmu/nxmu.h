@@ -271,6 +271,35 @@ int nxmu_mousein(FAR struct nxmu_state_s *nxmu,
                  FAR const struct nxgl_point_s *pos, int button);
 #endif
 
+/****************************************************************************
+ * Name: nxmu_mousequeue
+ *
+ * Description:
+ *   Same as nxmu_mousein(), but a report that only moves the mouse is held
+ *   back if 'more' indicates that more server messages are waiting.  It
+ *   will then be replaced by the next motion report or routed by
+ *   nxmu_mouseflush().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_XYINPUT_COALESCE
+int nxmu_mousequeue(FAR struct nxmu_state_s *nxmu,
+                    FAR const struct nxgl_point_s *pos, int buttons,
+                    bool more);
+#endif
+
+/****************************************************************************
+ * Name: nxmu_mouseflush
+ *
+ * Description:
+ *   Route the mouse report held back by nxmu_mousequeue(), if any.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_XYINPUT_COALESCE
+void nxmu_mouseflush(FAR struct nxmu_state_s *nxmu);
+#endif
+
 /****************************************************************************
  * Name: nxmu_kbdin
  *
@@ -41,6 +41,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -63,6 +64,11 @@ static struct nxgl_point_s       g_mrange;
 static uint8_t                   g_mbutton;
 static FAR struct nxbe_window_s *g_mwnd;
 
+#ifdef CONFIG_NX_XYINPUT_COALESCE
+static struct nxgl_point_s       g_mpend;     /* Held back position */
+static bool                      g_mpending;  /* g_mpend is valid */
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -266,4 +272,62 @@ int nxmu_mousein(FAR struct nxmu_state_s *nxmu,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmu_mousequeue
+ *
+ * Description:
+ *   Same as nxmu_mousein(), but a report that only moves the mouse is held
+ *   back if 'more' indicates that more server messages are waiting.  It
+ *   will then be replaced by the next motion report or routed by
+ *   nxmu_mouseflush().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_XYINPUT_COALESCE
+int nxmu_mousequeue(FAR struct nxmu_state_s *nxmu,
+                    FAR const struct nxgl_point_s *pos, int buttons,
+                    bool more)
+{
+  /* Only pure motion is held back:  The buttons are as last routed */
+
+  if (more && buttons == g_mbutton)
+    {
+      g_mpend.x  = pos->x;
+      g_mpend.y  = pos->y;
+      g_mpending = true;
+      return OK;
+    }
+
+  /* This report supersedes held back motion, except that the motion is
+   * routed first if the buttons change, so that it goes to the right
+   * window.
+   */
+
+  if (g_mpending && buttons != g_mbutton)
+    {
+      nxmu_mouseflush(nxmu);
+    }
+
+  g_mpending = false;
+  return nxmu_mousein(nxmu, pos, buttons);
+}
+
+/****************************************************************************
+ * Name: nxmu_mouseflush
+ *
+ * Description:
+ *   Route the mouse report held back by nxmu_mousequeue(), if any.
+ *
+ ****************************************************************************/
+
+void nxmu_mouseflush(FAR struct nxmu_state_s *nxmu)
+{
+  if (g_mpending)
+    {
+      g_mpending = false;
+      nxmu_mousein(nxmu, &g_mpend, g_mbutton);
+    }
+}
+#endif
+
 #endif /* CONFIG_NX_XYINPUT */
@@ -283,6 +283,9 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxmu_state_s    nxmu;
   FAR struct nxsvrmsg_s *msg;
   char                   buffer[NX_MXSVRMSGLEN];
+#if defined(CONFIG_NX_DOUBLEBUFFER) || defined(CONFIG_NX_XYINPUT_COALESCE)
+  struct mq_attr         attr;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -308,6 +311,24 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   for (; ; )
     {
+#ifdef CONFIG_NX_DOUBLEBUFFER
+       /* Show what has been drawn when no more requests are pending */
+
+       if (mq_getattr(nxmu.conn.crdmq, &attr) == 0 && attr.mq_curmsgs == 0)
+         {
+           nxbe_flip(&nxmu.be);
+         }
+#endif
+
+#ifdef CONFIG_NX_XYINPUT_COALESCE
+       /* Route held back mouse motion before waiting for more messages */
+
+       if (mq_getattr(nxmu.conn.crdmq, &attr) == 0 && attr.mq_curmsgs == 0)
+         {
+           nxmu_mouseflush(&nxmu);
+         }
+#endif
+
        /* Receive the next server message */
 
        nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
@@ -329,6 +350,16 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
        msg = (FAR struct nxsvrmsg_s *)buffer;
 
        ginfo("Received opcode=%d nbytes=%d\n", msg->msgid, nbytes);
+
+#ifdef CONFIG_NX_XYINPUT_COALESCE
+       /* Keep held back mouse motion in order with other messages */
+
+       if (msg->msgid != NX_SVRMSG_MOUSEIN)
+         {
+           nxmu_mouseflush(&nxmu);
+         }
+#endif
+
        switch (msg->msgid)
          {
          /* Messages sent from clients to the NX server *********************/
@@ -534,7 +565,13 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
          case NX_SVRMSG_MOUSEIN: /* New mouse report from mouse client */
            {
              FAR struct nxsvrmsg_mousein_s *mousemsg = (FAR struct nxsvrmsg_mousein_s *)buffer;
+#ifdef CONFIG_NX_XYINPUT_COALESCE
+             nxmu_mousequeue(&nxmu, &mousemsg->pt, mousemsg->buttons,
+                             mq_getattr(nxmu.conn.crdmq, &attr) == 0 &&
+                             attr.mq_curmsgs > 0);
+#else
              nxmu_mousein(&nxmu, &mousemsg->pt, mousemsg->buttons);
+#endif
            }
            break;
 #endif
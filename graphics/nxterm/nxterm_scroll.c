@@ -186,9 +186,13 @@ void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
   int i;
   int j;
 
-  /* Adjust the vertical position of each character */
+  /* Adjust the vertical position of each character.  Characters that have
+   * scrolled off the screen are deleted by compacting the array in a
+   * single pass:  'i' walks all characters, 'j' is where the next kept
+   * character goes.
+   */
 
-  for (i = 0; i < priv->nchars; )
+  for (i = 0, j = 0; i < priv->nchars; i++)
     {
       FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
 
@@ -196,35 +200,26 @@ void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 
       if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
-
-          for (j = i; j < priv->nchars - 1; j++)
-            {
-              memcpy(&priv->bm[j], &priv->bm[j + 1],
-                     sizeof(struct nxterm_bitmap_s));
-            }
-
-          /* Decrement the number of cached characters ('i' is not incremented
-           * in this case because it already points to the next character)
-           */
+          /* Yes... Drop it */
 
-          priv->nchars--;
+          continue;
         }
 
       /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
+       * display by one line) and keep it.
        */
 
-      else
+      bm->pos.y -= scrollheight;
+      if (j != i)
         {
-          bm->pos.y -= scrollheight;
-
-          /* We are keeping this one so increment to the next character */
-
-          i++;
+          memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
         }
+
+      j++;
     }
 
+  priv->nchars = j;
+
   /* And move the next display position up by one line as well */
 
   priv->fpos.y -= scrollheight;
@@ -0,0 +1,597 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one Hextile rectangle being streamed to the client */
+
+struct hextile_s
+{
+  FAR struct vnc_session_s *session;
+  size_t len;                  /* Bytes buffered in session->outbuf */
+  size_t total;                /* Total bytes sent */
+  uint8_t colorfmt;            /* Remote color format */
+  uint8_t bytesperpixel;       /* Remote bytes per pixel */
+  bool bigendian;              /* Remote byte order */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hextile_flush
+ *
+ * Description:
+ *  Send the buffered part of the update message.
+ *
+ ****************************************************************************/
+
+static int hextile_flush(FAR struct hextile_s *hx)
+{
+  FAR const uint8_t *src = hx->session->outbuf;
+  ssize_t nsent;
+
+  while (hx->len > 0)
+    {
+      nsent = psock_send(&hx->session->connect, src, hx->len, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= hx->len);
+      src       += nsent;
+      hx->len   -= nsent;
+      hx->total += nsent;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hextile_reserve
+ *
+ * Description:
+ *  Make room for 'size' more bytes in the output buffer, sending what has
+ *  been buffered so far if necessary.
+ *
+ ****************************************************************************/
+
+static inline int hextile_reserve(FAR struct hextile_s *hx, size_t size)
+{
+  if (hx->len + size > VNCSERVER_UPDATE_BUFSIZE)
+    {
+      return hextile_flush(hx);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hextile_putbyte and hextile_putpixel
+ *
+ * Description:
+ *  Append one byte or one remote pixel value to the update message.
+ *
+ ****************************************************************************/
+
+static int hextile_putbyte(FAR struct hextile_s *hx, uint8_t value)
+{
+  int ret;
+
+  ret = hextile_reserve(hx, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hx->session->outbuf[hx->len++] = value;
+  return OK;
+}
+
+static int hextile_putpixel(FAR struct hextile_s *hx, uint32_t pixel)
+{
+  FAR uint8_t *dest;
+  int ret;
+
+  ret = hextile_reserve(hx, hx->bytesperpixel);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dest = &hx->session->outbuf[hx->len];
+  if (hx->bytesperpixel == 1)
+    {
+      *dest = (uint8_t)pixel;
+    }
+  else if (hx->bytesperpixel == 2)
+    {
+      if (hx->bigendian)
+        {
+          rfb_putbe16(dest, (uint16_t)pixel);
+        }
+      else
+        {
+          rfb_putle16(dest, (uint16_t)pixel);
+        }
+    }
+  else
+    {
+      if (hx->bigendian)
+        {
+          rfb_putbe32(dest, pixel);
+        }
+      else
+        {
+          rfb_putle32(dest, pixel);
+        }
+    }
+
+  hx->len += hx->bytesperpixel;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hextile_convert
+ *
+ * Description:
+ *  Convert a local framebuffer color to the remote pixel format.
+ *
+ ****************************************************************************/
+
+static uint32_t hextile_convert(uint8_t colorfmt, lfb_color_t color)
+{
+  switch (colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        return vnc_convert_rgb8_222(color);
+
+      case FB_FMT_RGB8_332:
+        return vnc_convert_rgb8_332(color);
+
+      case FB_FMT_RGB16_555:
+        return vnc_convert_rgb16_555(color);
+
+      case FB_FMT_RGB16_565:
+        return vnc_convert_rgb16_565(color);
+
+      default:
+        return vnc_convert_rgb32_888(color);
+    }
+}
+
+/****************************************************************************
+ * Name: hextile_background
+ *
+ * Description:
+ *  Select the most frequent of the first few colors of the tile as its
+ *  background.
+ *
+ ****************************************************************************/
+
+static uint32_t hextile_background(FAR const uint32_t *tile,
+                                   unsigned int npixels)
+{
+  uint32_t colors[4];
+  unsigned int counts[4];
+  unsigned int ncolors = 0;
+  unsigned int best = 0;
+  unsigned int i;
+  unsigned int j;
+
+  for (i = 0; i < npixels; i++)
+    {
+      for (j = 0; j < ncolors && colors[j] != tile[i]; j++)
+        {
+        }
+
+      if (j < ncolors)
+        {
+          counts[j]++;
+        }
+      else if (ncolors < 4)
+        {
+          colors[ncolors]   = tile[i];
+          counts[ncolors++] = 1;
+        }
+    }
+
+  for (j = 1; j < ncolors; j++)
+    {
+      if (counts[j] > counts[best])
+        {
+          best = j;
+        }
+    }
+
+  return colors[best];
+}
+
+/****************************************************************************
+ * Name: hextile_subrects
+ *
+ * Description:
+ *  Cover the non-background pixels of the tile with sub-rectangles:  Runs
+ *  of one color on each row that continue a run of the row above extend
+ *  that sub-rectangle downwards.
+ *
+ * Returned Value:
+ *  The number of sub-rectangles or -E2BIG if there are too many.
+ *
+ ****************************************************************************/
+
+static int hextile_subrects(FAR struct vnc_session_s *session,
+                            unsigned int width, unsigned int height,
+                            uint32_t bg)
+{
+  FAR const uint32_t *tile = session->tile;
+  FAR struct vnc_hexsubrect_s *sub = session->subrects;
+  uint8_t open[2][VNC_HEXTILE_SIZE];
+  unsigned int nopen[2];
+  unsigned int prev = 0;
+  unsigned int nsub = 0;
+  unsigned int x;
+  unsigned int y;
+  unsigned int x0;
+  unsigned int i;
+  uint32_t pixel;
+
+  nopen[prev] = 0;
+
+  for (y = 0; y < height; y++, tile += width)
+    {
+      unsigned int cur = prev ^ 1;
+
+      nopen[cur] = 0;
+
+      for (x = 0; x < width; )
+        {
+          pixel = tile[x];
+          if (pixel == bg)
+            {
+              x++;
+              continue;
+            }
+
+          for (x0 = x++; x < width && tile[x] == pixel; x++)
+            {
+            }
+
+          /* Does this run continue a sub-rectangle of the previous row? */
+
+          for (i = 0; i < nopen[prev]; i++)
+            {
+              FAR struct vnc_hexsubrect_s *s = &sub[open[prev][i]];
+
+              if (s->x == x0 && s->w == x - x0 && s->pixel == pixel)
+                {
+                  s->h++;
+                  break;
+                }
+            }
+
+          if (i < nopen[prev])
+            {
+              open[cur][nopen[cur]++] = open[prev][i];
+            }
+          else
+            {
+              if (nsub >= VNC_HEXTILE_MAXSUB)
+                {
+                  return -E2BIG;
+                }
+
+              sub[nsub].pixel = pixel;
+              sub[nsub].x     = x0;
+              sub[nsub].y     = y;
+              sub[nsub].w     = x - x0;
+              sub[nsub].h     = 1;
+
+              open[cur][nopen[cur]++] = nsub++;
+            }
+        }
+
+      prev = cur;
+    }
+
+  return nsub;
+}
+
+/****************************************************************************
+ * Name: hextile_tile
+ *
+ * Description:
+ *  Encode one tile with the smaller of the sub-rectangle and raw encodings.
+ *
+ ****************************************************************************/
+
+static int hextile_tile(FAR struct hextile_s *hx, nxgl_coord_t x,
+                        nxgl_coord_t y, unsigned int width,
+                        unsigned int height, FAR uint32_t *prevbg,
+                        FAR bool *bgvalid)
+{
+  FAR struct vnc_session_s *session = hx->session;
+  FAR const lfb_color_t *src;
+  FAR struct vnc_hexsubrect_s *sub = session->subrects;
+  unsigned int npixels = width * height;
+  unsigned int bpp = hx->bytesperpixel;
+  unsigned int rawsize;
+  unsigned int size;
+  unsigned int i;
+  unsigned int j;
+  uint32_t bg;
+  uint8_t subenc;
+  bool mono;
+  int nsub;
+  int ret;
+
+  /* Get the tile in the remote pixel format */
+
+  for (j = 0; j < height; j++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * (y + j) + RFB_BYTESPERPIXEL * x);
+
+      for (i = 0; i < width; i++)
+        {
+          session->tile[j * width + i] = hextile_convert(hx->colorfmt,
+                                                         src[i]);
+        }
+    }
+
+  bg   = hextile_background(session->tile, npixels);
+  nsub = hextile_subrects(session, width, height, bg);
+
+  /* Compare the size of the sub-rectangle encoding with the raw tile */
+
+  rawsize = 1 + npixels * bpp;
+  subenc  = 0;
+  size    = 1;
+  mono    = true;
+
+  if (!*bgvalid || bg != *prevbg)
+    {
+      subenc |= RFB_SUBENCODING_BACK;
+      size   += bpp;
+    }
+
+  if (nsub > 0)
+    {
+      for (i = 1; i < nsub && mono; i++)
+        {
+          mono = (sub[i].pixel == sub[0].pixel);
+        }
+
+      subenc |= RFB_SUBENCODING_ANY;
+      if (mono)
+        {
+          subenc |= RFB_SUBENCODING_FORE;
+          size   += bpp + 1 + 2 * nsub;
+        }
+      else
+        {
+          subenc |= RFB_SUBENCODING_COLORED;
+          size   += 1 + (2 + bpp) * nsub;
+        }
+    }
+
+  if (nsub < 0 || size >= rawsize)
+    {
+      /* Raw tile.  The background can not be carried over a raw tile. */
+
+      ret = hextile_putbyte(hx, RFB_SUBENCODING_RAW);
+      for (i = 0; i < npixels && ret >= 0; i++)
+        {
+          ret = hextile_putpixel(hx, session->tile[i]);
+        }
+
+      *bgvalid = false;
+      return ret;
+    }
+
+  ret = hextile_putbyte(hx, subenc);
+  if (ret >= 0 && (subenc & RFB_SUBENCODING_BACK) != 0)
+    {
+      ret = hextile_putpixel(hx, bg);
+    }
+
+  *prevbg  = bg;
+  *bgvalid = true;
+
+  if (nsub > 0)
+    {
+      if (ret >= 0 && mono)
+        {
+          ret = hextile_putpixel(hx, sub[0].pixel);
+        }
+
+      if (ret >= 0)
+        {
+          ret = hextile_putbyte(hx, nsub);
+        }
+
+      for (i = 0; i < nsub && ret >= 0; i++)
+        {
+          if (!mono)
+            {
+              ret = hextile_putpixel(hx, sub[i].pixel);
+            }
+
+          if (ret >= 0)
+            {
+              ret = hextile_putbyte(hx, (sub[i].x << 4) | sub[i].y);
+            }
+
+          if (ret >= 0)
+            {
+              ret = hextile_putbyte(hx, ((sub[i].w - 1) << 4) |
+                                        (sub[i].h - 1));
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.  The update is
+ *  sent as one rectangle; the message is streamed through the session
+ *  output buffer so it may be larger than CONFIG_VNCSERVER_UPDATE_BUFSIZE.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (the client does
+ *   not support it) but no error was encountered.  Otherwise, the size of
+ *   the framebuffer update message is returned on success or a negated
+ *   errno value is returned on failure that indicates the nature of the
+ *   failure.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  struct hextile_s hx;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  uint32_t prevbg = 0;
+  bool bgvalid = false;
+  int ret;
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  /* Capture the client pixel format.  It is used for the whole message
+   * even if a SetPixelFormat is received asynchronously.
+   */
+
+  hx.session       = session;
+  hx.len           = 0;
+  hx.total         = 0;
+  hx.colorfmt      = session->colorfmt;
+  hx.bytesperpixel = (session->bpp + 7) >> 3;
+  hx.bigendian     = session->bigendian;
+
+  if (hx.bytesperpixel != 1 && hx.bytesperpixel != 2 &&
+      hx.bytesperpixel != 4)
+    {
+      gerr("ERROR: Unsupported pixel size: %d\n", session->bpp);
+      return -EINVAL;
+    }
+
+  DEBUGASSERT(rect->pt1.x <= rect->pt2.x && rect->pt1.y <= rect->pt2.y);
+  width  = rect->pt2.x - rect->pt1.x + 1;
+  height = rect->pt2.y - rect->pt1.y + 1;
+
+  /* Format the FramebufferUpdate header with a single rectangle */
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->pt1.x);
+  rfb_putbe16(update->rect[0].ypos, rect->pt1.y);
+  rfb_putbe16(update->rect[0].width, width);
+  rfb_putbe16(update->rect[0].height, height);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  hx.len = SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
+
+  /* Then the tiles, left-to-right and top-to-bottom */
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y += VNC_HEXTILE_SIZE)
+    {
+      for (x = rect->pt1.x; x <= rect->pt2.x; x += VNC_HEXTILE_SIZE)
+        {
+          ret = hextile_tile(&hx, x, y,
+                             MIN(VNC_HEXTILE_SIZE, rect->pt2.x - x + 1),
+                             MIN(VNC_HEXTILE_SIZE, rect->pt2.y - y + 1),
+                             &prevbg, &bgvalid);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  ret = hextile_flush(&hx);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}: %lu bytes\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y,
+          (unsigned long)hx.total);
+
+  return (int)hx.total;
+}
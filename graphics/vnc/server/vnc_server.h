@@ -152,6 +152,12 @@
 #define VNCSERVER_UPDATE_BUFSIZE \
   (CONFIG_VNCSERVER_UPDATE_BUFSIZE + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0))
 
+/* Hextile tiles are 16x16 pixels with at most 255 sub-rectangles */
+
+#define VNC_HEXTILE_SIZE    16
+#define VNC_HEXTILE_NPIXELS (VNC_HEXTILE_SIZE * VNC_HEXTILE_SIZE)
+#define VNC_HEXTILE_MAXSUB  255
+
 /* Local framebuffer characteristics in bytes */
 
 #define RFB_BYTESPERPIXEL   ((RFB_BITSPERPIXEL + 7) >> 3)
@@ -214,6 +220,19 @@ struct vnc_fbupdate_s
   struct nxgl_rect_s rect;     /* The enqueued update rectangle */
 };
 
+#ifdef CONFIG_VNCSERVER_HEXTILE
+/* One Hextile sub-rectangle being built (tile relative coordinates) */
+
+struct vnc_hexsubrect_s
+{
+  uint32_t pixel;              /* Remote pixel value */
+  uint8_t x;                   /* Position in the tile */
+  uint8_t y;
+  uint8_t w;                   /* Size in pixels */
+  uint8_t h;
+};
+#endif
+
 struct vnc_session_s
 {
   /* Connection data */
@@ -231,6 +250,9 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -255,6 +277,15 @@ struct vnc_session_s
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
   uint8_t outbuf[VNCSERVER_UPDATE_BUFSIZE];
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  /* Work area of the Hextile encoder: the tile in the remote pixel format
+   * and its sub-rectangles.
+   */
+
+  uint32_t tile[VNC_HEXTILE_NPIXELS];
+  struct vnc_hexsubrect_s subrects[VNC_HEXTILE_MAXSUB];
+#endif
 };
 
 /* This structure is used to communicate start-up status between the server
@@ -478,6 +509,30 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (the client does
+ *   not support it) but no error was encountered.  Otherwise, the size of
+ *   the framebuffer update message is returned on success or a negated
+ *   errno value is returned on failure that indicates the nature of the
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -336,6 +336,87 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Try to merge a new update rectangle with one already in the update
+ *   queue.  The new rectangle is discarded if a queued update already
+ *   covers it (e.g., a blinking cursor) and a queued update is grown to
+ *   the union if the two overlap or touch and the union adds no more
+ *   pixels than it saves.
+ *
+ *   Must be called with the scheduler locked:  vnc_remove_queue() may run
+ *   at any time, but entries are modified only while they are queued.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The new (clipped) update rectangle
+ *
+ * Returned Value:
+ *   True if the rectangle is accounted for by a queued update.
+ *
+ ****************************************************************************/
+
+static bool vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct vnc_fbupdate_s *curr;
+  struct nxgl_rect_s grown;
+  struct nxgl_rect_s merged;
+  uint32_t area1;
+  uint32_t area2;
+  uint32_t marea;
+
+  area1 = (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+          (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+
+  for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       curr != NULL;
+       curr = curr->flink)
+    {
+      /* Is it already covered? */
+
+      if (rect->pt1.x >= curr->rect.pt1.x &&
+          rect->pt1.y >= curr->rect.pt1.y &&
+          rect->pt2.x <= curr->rect.pt2.x &&
+          rect->pt2.y <= curr->rect.pt2.y)
+        {
+          return true;
+        }
+
+      /* Do the rectangles overlap or touch? */
+
+      grown.pt1.x = curr->rect.pt1.x - 1;
+      grown.pt1.y = curr->rect.pt1.y - 1;
+      grown.pt2.x = curr->rect.pt2.x + 1;
+      grown.pt2.y = curr->rect.pt2.y + 1;
+
+      if (!nxgl_intersecting(&grown, rect))
+        {
+          continue;
+        }
+
+      nxgl_rectunion(&merged, &curr->rect, rect);
+
+      area2 = (uint32_t)(curr->rect.pt2.x - curr->rect.pt1.x + 1) *
+              (uint32_t)(curr->rect.pt2.y - curr->rect.pt1.y + 1);
+      marea = (uint32_t)(merged.pt2.x - merged.pt1.x + 1) *
+              (uint32_t)(merged.pt2.y - merged.pt1.y + 1);
+
+      if (marea <= area1 + area2)
+        {
+          updinfo("Merged {(%d, %d),(%d, %d)}\n",
+                  merged.pt1.x, merged.pt1.y, merged.pt2.x, merged.pt2.y);
+
+          nxgl_rectcopy(&curr->rect, &merged);
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -382,6 +463,15 @@ static FAR void *vnc_updater(FAR void *arg)
       /* Attempt to use RRE encoding */
 
       ret = vnc_rre(session, &srcrect->rect);
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      if (ret == 0)
+        {
+          /* Then Hextile */
+
+          ret = vnc_hextile(session, &srcrect->rect);
+        }
+#endif
+
       if (ret == 0)
         {
           /* Perform the framebuffer update using the default RAW encoding */
@@ -593,6 +683,14 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                */
 
               session->change |= change;
+
+              /* Merge with a queued update if possible */
+
+              if (vnc_merge_queue(session, &intersection))
+                {
+                  sched_unlock();
+                  return OK;
+                }
             }
 
           /* Allocate an update structure... waiting if necessary */
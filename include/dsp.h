@@ -53,6 +53,10 @@
 #  define CONFIG_LIBDSP_PRECISION 0
 #endif
 
+#ifndef CONFIG_LIBDSP_FOC_MULTI_MAX
+#  define CONFIG_LIBDSP_FOC_MULTI_MAX 4
+#endif
+
 /* Phase rotation direction */
 
 #define DIR_CW   (1.0f)
@@ -350,6 +354,52 @@ struct foc_data_s
   float vab_mod_scale;       /* Voltage alpha-beta modulation scale */
 };
 
+/* Batched FOC data for several motors driven from the same interrupt.
+ * Each quantity is an array indexed by the motor, so that one stage of the
+ * controller is a loop over all motors.
+ */
+
+#define FOC_MULTI_MAX CONFIG_LIBDSP_FOC_MULTI_MAX
+
+struct foc_multi_s
+{
+  uint8_t n;                         /* Number of motors */
+
+  /* Inputs */
+
+  float i_a[FOC_MULTI_MAX];          /* Phase A current */
+  float i_b[FOC_MULTI_MAX];          /* Phase B current */
+  float sin[FOC_MULTI_MAX];          /* Phase angle sine */
+  float cos[FOC_MULTI_MAX];          /* Phase angle cosine */
+
+  /* Current loop */
+
+  float i_alpha[FOC_MULTI_MAX];      /* Alpha current */
+  float i_beta[FOC_MULTI_MAX];       /* Beta current */
+  float i_d[FOC_MULTI_MAX];          /* D current */
+  float i_q[FOC_MULTI_MAX];          /* Q current */
+  float i_d_ref[FOC_MULTI_MAX];      /* D current reference */
+  float i_q_ref[FOC_MULTI_MAX];      /* Q current reference */
+  float id_kp[FOC_MULTI_MAX];        /* D current KP */
+  float id_ki[FOC_MULTI_MAX];        /* D current KI */
+  float iq_kp[FOC_MULTI_MAX];        /* Q current KP */
+  float iq_ki[FOC_MULTI_MAX];        /* Q current KI */
+  float id_int[FOC_MULTI_MAX];       /* D current integral part */
+  float iq_int[FOC_MULTI_MAX];       /* Q current integral part */
+
+  /* Outputs */
+
+  float v_d[FOC_MULTI_MAX];          /* D voltage */
+  float v_q[FOC_MULTI_MAX];          /* Q voltage */
+  float v_ab_mod_a[FOC_MULTI_MAX];   /* Alpha modulation voltage */
+  float v_ab_mod_b[FOC_MULTI_MAX];   /* Beta modulation voltage */
+
+  /* Per motor limits set by foc_multi_vbase_update() */
+
+  float vdq_mag_max[FOC_MULTI_MAX];   /* Maximum dq voltage magnitude */
+  float vab_mod_scale[FOC_MULTI_MAX]; /* Alpha-beta modulation scale */
+};
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -425,6 +475,20 @@ void foc_process(FAR struct foc_data_s *foc,
                  FAR abc_frame_t *i_abc,
                  FAR phase_angle_t *angle);
 
+/* Batched Field Oriented control */
+
+void foc_multi_init(FAR struct foc_multi_s *foc, uint8_t n);
+void foc_multi_gains_set(FAR struct foc_multi_s *foc, uint8_t idx,
+                         float id_kp, float id_ki,
+                         float iq_kp, float iq_ki);
+void foc_multi_vbase_update(FAR struct foc_multi_s *foc, uint8_t idx,
+                            float vbase);
+void foc_multi_idq_ref_set(FAR struct foc_multi_s *foc, uint8_t idx,
+                           float d, float q);
+void foc_multi_process(FAR struct foc_multi_s *foc,
+                       FAR const abc_frame_t *i_abc,
+                       FAR const phase_angle_t *angle);
+
 /* BLDC/PMSM motor observers */
 
 void motor_observer_init(FAR struct motor_observer_s *observer,
@@ -437,6 +501,8 @@ void motor_observer_smo_init(FAR struct motor_observer_smo_s *smo,
 void motor_observer_smo(FAR struct motor_observer_s *o,
                         FAR ab_frame_t *i_ab, FAR ab_frame_t *v_ab,
                         FAR struct motor_phy_params_s *phy, float dir);
+void motor_observer_smo_phase_get(FAR struct motor_observer_s *o,
+                                  FAR phase_angle_t *angle, float dir);
 
 void motor_sobserver_div_init(FAR struct motor_sobserver_div_s *so,
                               uint8_t samples, float filer, float per);
@@ -0,0 +1,258 @@
+/****************************************************************************
+ * include/dspb16.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+#ifndef __INCLUDE_DSPB16_H
+#define __INCLUDE_DSPB16_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/compiler.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fixedmath.h>
+
+#include <assert.h>
+
+/* This is the b16 fixed-point counterpart of dsp.h for targets without an
+ * FPU.  Angles are b16 radians, voltages and currents are b16 and the
+ * per unit values (sine, cosine, duty cycles) are b16 in <-1.0, 1.0>.
+ */
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Disable DEBUGASSERT macro if LIBDSP debug is not enabled */
+
+#ifdef CONFIG_LIBDSP_DEBUG
+#  ifndef CONFIG_DEBUG_ASSERTIONS
+#    warning "Need CONFIG_DEBUG_ASSERTIONS to work properly"
+#  endif
+#else
+#  undef DEBUGASSERT
+#  define DEBUGASSERT(x)
+#endif
+
+/* Phase rotation direction */
+
+#define DIR_CW_B16   (b16ONE)
+#define DIR_CCW_B16  (-b16ONE)
+
+/* Some math constants ******************************************************/
+
+#define SQRT3_BY_TWO_B16     (0x0000ddb4)    /* 0.866025 */
+#define SQRT3_BY_THREE_B16   (0x000093cd)    /* 0.57735 */
+#define ONE_BY_SQRT3_B16     (0x000093cd)    /* 0.57735 */
+#define TWO_BY_SQRT3_B16     (0x0001279a)    /* 1.15470 */
+
+/* Some useful macros *******************************************************/
+
+/* Its float counterpart is SVM3_BASE_VOLTAGE_GET in dsp.h */
+
+#define SVM3_BASE_VOLTAGE_GET_B16(vbus) b16mulb16(vbus, SQRT3_BY_THREE_B16)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Phase angle with its sine and cosine */
+
+struct phase_angle_b16_s
+{
+  b16_t   angle;               /* Phase angle in radians <0, 2PI> */
+  b16_t   sin;                 /* Phase angle sine */
+  b16_t   cos;                 /* Phase angle cosine */
+};
+
+typedef struct phase_angle_b16_s phase_angle_b16_t;
+
+/* b16 number saturaton */
+
+struct b16_sat_s
+{
+  b16_t min;                    /* Lower limit */
+  b16_t max;                    /* Upper limit */
+};
+
+typedef struct b16_sat_s b16_sat_t;
+
+/* PI controller state structure */
+
+struct pid_controller_b16_s
+{
+  b16_t       out;              /* Controller output */
+  b16_sat_t   sat;              /* Output saturation */
+  b16_t       err;              /* Current error value */
+  b16_t       KP;               /* Proportional coefficient */
+  b16_t       KI;               /* Integral coefficient */
+  b16_t       part[2];          /* 0 - proporitonal part
+                                 * 1 - integral part
+                                 */
+};
+
+typedef struct pid_controller_b16_s pid_controller_b16_t;
+
+/* This structure represents the ABC frame (3 phase vector) */
+
+struct abc_frame_b16_s
+{
+  b16_t a;                     /* A component */
+  b16_t b;                     /* B component */
+  b16_t c;                     /* C component */
+};
+
+typedef struct abc_frame_b16_s abc_frame_b16_t;
+
+/* This structure represents the alpha-beta frame (2 phase vector) */
+
+struct ab_frame_b16_s
+{
+  b16_t a;                     /* Alpha component */
+  b16_t b;                     /* Beta component */
+};
+
+typedef struct ab_frame_b16_s ab_frame_b16_t;
+
+/* This structure represent the direct-quadrature frame */
+
+struct dq_frame_b16_s
+{
+  b16_t d;                     /* Driect component */
+  b16_t q;                     /* Quadrature component */
+};
+
+typedef struct dq_frame_b16_s dq_frame_b16_t;
+
+/* Space Vector Modulation data for 3-phase system */
+
+struct svm3_state_b16_s
+{
+  uint8_t     sector;          /* Current space vector sector */
+  b16_t       d_u;             /* Duty cycle for phase U */
+  b16_t       d_v;             /* Duty cycle for phase V */
+  b16_t       d_w;             /* Duty cycle for phase W */
+  b16_t       d_max;           /* Duty cycle max */
+  b16_t       d_min;           /* Duty cycle min */
+};
+
+/* Field oriented control (FOC) data */
+
+struct foc_data_b16_s
+{
+  abc_frame_b16_t      v_abc;    /* Voltage in ABC frame */
+  ab_frame_b16_t       v_ab;     /* Voltage in alpha-beta frame */
+  dq_frame_b16_t       v_dq;     /* Voltage in dq frame */
+  ab_frame_b16_t       v_ab_mod; /* Modulation voltage normalized to
+                                  * magnitude (0.0, 1.0)
+                                  */
+
+  abc_frame_b16_t      i_abc;    /* Current in ABC frame */
+  ab_frame_b16_t       i_ab;     /* Current in apha-beta frame */
+  dq_frame_b16_t       i_dq;     /* Current in dq frame */
+  dq_frame_b16_t       i_dq_err; /* DQ current error */
+
+  dq_frame_b16_t       i_dq_ref; /* Current dq reference frame */
+  pid_controller_b16_t id_pid;   /* Current d-axis component PI controller */
+  pid_controller_b16_t iq_pid;   /* Current q-axis component PI controller */
+
+  b16_t vdq_mag_max;             /* Maximum dq voltage magnitude */
+  b16_t vab_mod_scale;           /* Voltage alpha-beta modulation scale */
+};
+
+/****************************************************************************
+ * Public Functions Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Math functions */
+
+b16_t fast_sin_b16(b16_t angle);
+b16_t fast_cos_b16(b16_t angle);
+void fast_sincos_b16(b16_t angle, FAR b16_t *s, FAR b16_t *c);
+
+void f_saturate_b16(FAR b16_t *val, b16_t min, b16_t max);
+
+b16_t vector2d_mag_b16(b16_t x, b16_t y);
+void vector2d_saturate_b16(FAR b16_t *x, FAR b16_t *y, b16_t max);
+
+void dq_saturate_b16(FAR dq_frame_b16_t *dq, b16_t max);
+b16_t dq_mag_b16(FAR dq_frame_b16_t *dq);
+
+/* PI controller functions */
+
+void pi_controller_init_b16(FAR pid_controller_b16_t *pid,
+                            b16_t KP, b16_t KI);
+void pi_saturation_set_b16(FAR pid_controller_b16_t *pid,
+                           b16_t min, b16_t max);
+void pi_integral_reset_b16(FAR pid_controller_b16_t *pid);
+b16_t pi_controller_b16(FAR pid_controller_b16_t *pid, b16_t err);
+
+/* Transformation functions */
+
+void clarke_transform_b16(FAR abc_frame_b16_t *abc,
+                          FAR ab_frame_b16_t *ab);
+void inv_clarke_transform_b16(FAR ab_frame_b16_t *ab,
+                              FAR abc_frame_b16_t *abc);
+void park_transform_b16(FAR phase_angle_b16_t *angle,
+                        FAR ab_frame_b16_t *ab,
+                        FAR dq_frame_b16_t *dq);
+void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
+                            FAR dq_frame_b16_t *dq,
+                            FAR ab_frame_b16_t *ab);
+
+/* Phase angle related functions */
+
+void angle_norm_b16(FAR b16_t *angle, b16_t per, b16_t bottom, b16_t top);
+void angle_norm_2pi_b16(FAR b16_t *angle, b16_t bottom, b16_t top);
+void phase_angle_update_b16(FAR struct phase_angle_b16_s *angle, b16_t val);
+
+/* 3-phase system space vector modulation */
+
+void svm3_init_b16(FAR struct svm3_state_b16_s *s, b16_t min, b16_t max);
+void svm3_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *ab);
+
+/* Field Oriented control */
+
+void foc_vbase_update_b16(FAR struct foc_data_b16_s *foc, b16_t vbase);
+void foc_idq_ref_set_b16(FAR struct foc_data_b16_s *data, b16_t d, b16_t q);
+
+void foc_init_b16(FAR struct foc_data_b16_s *data,
+                  b16_t id_kp, b16_t id_ki, b16_t iq_kp, b16_t iq_ki);
+void foc_process_b16(FAR struct foc_data_b16_s *foc,
+                     FAR abc_frame_b16_t *i_abc,
+                     FAR phase_angle_b16_t *angle);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_DSPB16_H */
@@ -130,6 +130,13 @@
 #define DN_RENAME   4  /* A file was renamed */
 #define DN_ATTRIB   5  /* Attributes of a file were changed */
 
+/* splice() and tee() flags (linux) */
+
+#define SPLICE_F_MOVE     (1 << 0) /* Hint only, ignored */
+#define SPLICE_F_NONBLOCK (1 << 1) /* Don't block on the pipe */
+#define SPLICE_F_MORE     (1 << 2) /* More data will follow */
+#define SPLICE_F_GIFT     (1 << 3) /* Unused */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -174,6 +181,12 @@ extern "C"
 int open(FAR const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
 
+/* Zero-copy pipe transfers (linux) */
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
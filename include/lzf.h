@@ -40,9 +40,11 @@
 
 #define LZF_TYPE0_HDR      0
 #define LZF_TYPE1_HDR      1
+#define LZF_TYPE2_HDR      2  /* LZ4 compressed, uses struct lzf_type1_header_s */
 
 #define LZF_TYPE0_HDR_SIZE 5
 #define LZF_TYPE1_HDR_SIZE 7
+#define LZF_TYPE2_HDR_SIZE 7
 
 #define LZF_MAX_HDR_SIZE   7
 #define LZF_MIN_HDR_SIZE   5
@@ -56,7 +58,7 @@
 struct lzf_header_s         /* Common data header */
 {
   uint8_t lzf_magic[2];     /* [0]='Z', [1]='V' */
-  uint8_t lzf_type;         /* LZF_TYPE0_HDR or LZF_TYPE1_HDR */
+  uint8_t lzf_type;         /* LZF_TYPE0_HDR, LZF_TYPE1_HDR or LZF_TYPE2_HDR */
 };
 
 struct lzf_type0_header_s   /* Uncompressed data header */
@@ -150,4 +152,24 @@ unsigned int lzf_decompress(FAR const void *const in_data,
                             unsigned int in_len, FAR void *out_data,
                             unsigned int out_len);
 
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress one LZ4 block (the raw LZ4 block format without the frame
+ *   header) stored at in_data with length in_len.  This is an alternative
+ *   to lzf_decompress() that is typically faster for the same data at the
+ *   cost of slightly lower compression.  Blocks compressed this way are
+ *   identified by an LZF_TYPE2_HDR header.
+ *
+ *   The return value and errno are the same as for lzf_decompress().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_LZF_LZ4
+unsigned int lz4_decompress(FAR const void *const in_data,
+                            unsigned int in_len, FAR void *out_data,
+                            unsigned int out_len);
+#endif
+
 #endif /* __INCLUDE_LZF_H */
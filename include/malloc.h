@@ -45,6 +45,8 @@ struct mallinfo
                  * chunks handed out by malloc. */
   int fordblks; /* This is the total size of memory occupied
                  * by free (not in use) chunks. */
+  int fbcached; /* This is the part of uordblks held in the
+                 * small allocation fast bins (not in use). */
 };
 
 /****************************************************************************
@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -69,5 +70,39 @@
 #define TCP_KEEPCNT   (__SO_PROTOCOL + 3) /* Number of keepalives before death
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
+#define TCP_INFO      (__SO_PROTOCOL + 5) /* Connection statistics (read-only)
+                                           * Argument: struct tcp_info */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Returned by getsockopt(TCP_INFO).  Field names follow Linux where the
+ * meaning is the same, but the state uses the NuttX TCP state numbers and
+ * the windows are in bytes.  Times are in microseconds.
+ */
+
+struct tcp_info
+{
+  uint8_t  tcpi_state;          /* TCP state, see nuttx/net/tcp.h */
+  uint8_t  tcpi_retransmits;    /* Retransmissions of the oldest segment */
+  uint32_t tcpi_rto;            /* Retransmission time-out */
+  uint32_t tcpi_rtt;            /* Smoothed round trip time */
+  uint32_t tcpi_rttvar;         /* Round trip time variation */
+  uint32_t tcpi_snd_mss;        /* Maximum segment size */
+  uint32_t tcpi_snd_cwnd;       /* Congestion window (0: no congestion
+                                 * control) */
+  uint32_t tcpi_snd_ssthresh;   /* Slow start threshold */
+  uint32_t tcpi_snd_wnd;        /* Receive window of the peer */
+  uint32_t tcpi_unacked;        /* Bytes sent but not yet acknowledged */
+  uint32_t tcpi_total_retrans;  /* Data segments retransmitted */
+  uint32_t tcpi_rto_timeouts;   /* Retransmission time-outs */
+  uint32_t tcpi_dupacks;        /* Duplicate ACKs received */
+  uint32_t tcpi_zero_windows;   /* Zero windows advertised by the peer */
+  uint32_t tcpi_segs_out;       /* Segments sent */
+  uint32_t tcpi_segs_in;        /* Segments received */
+  uint64_t tcpi_bytes_acked;    /* Data bytes acknowledged by the peer */
+  uint64_t tcpi_bytes_received; /* In-order data bytes received */
+};
 
 #endif /* __INCLUDE_NETINET_TCP_H */
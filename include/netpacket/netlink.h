@@ -91,6 +91,8 @@
 #define NETLINK_RDMA           20
 #define NETLINK_CRYPTO         21      /* Crypto layer */
 #define NETLINK_SMC            22      /* SMC monitoring */
+#define NETLINK_MONITOR        23      /* NuttX: Task, memory and network
+                                        * device monitoring */
 
 /* Definitions associated with struct sockaddr_nl ***************************/
 
@@ -416,6 +418,54 @@
 #define RTNLGRP_NSID          28
 #define RTNLGRP_MAX           29
 
+/* NETLINK_MONITOR protocol message types ***********************************/
+
+/* A query is a bare struct nlmsghdr with one of the MONM_GET* types.
+ *
+ * MONM_GETTASK
+ *   Dump all tasks and threads.  The response is one MONM_NEWTASK message
+ *   with a montaskmsg structure per task, followed by NLMSG_DONE.
+ * MONM_GETMEM
+ *   Get the heap information.  The response is one MONM_NEWMEM message
+ *   with a monmemmsg structure per heap, followed by NLMSG_DONE.
+ * MONM_GETNETDEV
+ *   Dump the network device counters.  The response is one MONM_NEWNETDEV
+ *   message with a monnetdevmsg structure per device, followed by
+ *   NLMSG_DONE.
+ *
+ * The same messages (without NLMSG_DONE) are broadcast to the subscribed
+ * multicast groups when something changes.  MONM_DELTASK carries only the
+ * mt_pid of a task that has exited.
+ */
+
+#define MONM_NEWTASK          16
+#define MONM_DELTASK          17
+#define MONM_GETTASK          18
+#define MONM_NEWMEM           20
+#define MONM_GETMEM           22
+#define MONM_NEWNETDEV        24
+#define MONM_GETNETDEV        26
+
+/* NETLINK_MONITOR multicast groups.  Subscribe by binding the socket with
+ * the corresponding MONGRP_* bits set in nl_groups.
+ */
+
+#define MONNLGRP_NONE         0
+#define MONNLGRP_TASK         1    /* Task creation and exit */
+#define MONNLGRP_MEM          2    /* Heap usage changes */
+#define MONNLGRP_NETDEV       3    /* Network device counter changes */
+
+#define MONGRP_TASK           (1 << (MONNLGRP_TASK - 1))
+#define MONGRP_MEM            (1 << (MONNLGRP_MEM - 1))
+#define MONGRP_NETDEV         (1 << (MONNLGRP_NETDEV - 1))
+
+/* Values of mm_heap */
+
+#define MONHEAP_USER          0
+#define MONHEAP_KERNEL        1
+
+#define MON_NAMESIZE          32   /* Size of mt_name[] and md_ifname[] */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -530,6 +580,54 @@ struct rtmsg
   uint32_t rtm_flags;
 };
 
+/* NETLINK_MONITOR Message Structures ***************************************/
+
+/* MONM_NEWTASK, MONM_DELTASK:  The state of one task or thread */
+
+struct montaskmsg
+{
+  int16_t  mt_pid;        /* Task ID */
+  uint8_t  mt_priority;   /* Current priority */
+  uint8_t  mt_state;      /* Task state.  See enum tstate_e */
+  uint16_t mt_flags;      /* TCB_FLAG_* flags */
+  uint16_t mt_pad;
+  uint32_t mt_stacksize;  /* Size of the stack in bytes */
+  uint32_t mt_stackused;  /* Stack used in bytes (0 if unknown) */
+  uint32_t mt_active;     /* CPU load:  Ticks while active (0 if unknown) */
+  uint32_t mt_total;      /* CPU load:  Ticks in the measurement period */
+  char     mt_name[MON_NAMESIZE];
+};
+
+/* MONM_NEWMEM:  The state of one heap */
+
+struct monmemmsg
+{
+  uint8_t  mm_heap;       /* See MONHEAP_* definitions */
+  uint8_t  mm_pad[3];
+  uint32_t mm_arena;      /* Total space of the heap */
+  uint32_t mm_ordblks;    /* Number of free chunks */
+  uint32_t mm_mxordblk;   /* Size of the largest free chunk */
+  uint32_t mm_uordblks;   /* Total allocated space */
+  uint32_t mm_fordblks;   /* Total free space */
+};
+
+/* MONM_NEWNETDEV:  The counters of one network device.  The counters are
+ * zero if the driver does not keep network device statistics.
+ */
+
+struct monnetdevmsg
+{
+  char     md_ifname[MON_NAMESIZE];
+  uint32_t md_flags;      /* Device IFF_* flags */
+  uint32_t md_rxpackets;  /* Number of packets received */
+  uint32_t md_rxerrors;   /* Number of receive errors */
+  uint32_t md_rxdropped;  /* Unsupported Rx packets received */
+  uint32_t md_txpackets;  /* Number of Tx packets queued */
+  uint32_t md_txdone;     /* Number of packets completed */
+  uint32_t md_txerrors;   /* Number of transmit errors */
+  uint32_t md_errors;     /* Total number of errors */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
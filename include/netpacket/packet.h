@@ -47,6 +47,43 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet socket options (see setsockopt() with level SOL_PACKET) */
+
+#define SOL_PACKET             263
+
+#define PACKET_RX_RING         5   /* Arg: struct tpacket_req */
+#define PACKET_STATISTICS      6   /* Arg: struct tpacket_stats (get only) */
+#define PACKET_TX_RING         13  /* Arg: struct tpacket_req */
+
+/* Frame status in struct tpacket_hdr.  An RX frame belongs to the kernel
+ * while TP_STATUS_USER is clear; a TX frame belongs to the kernel while
+ * TP_STATUS_SEND_REQUEST is set.
+ */
+
+#define TP_STATUS_KERNEL       0
+#define TP_STATUS_USER         (1 << 0)
+#define TP_STATUS_LOSING       (1 << 2)  /* Frames were dropped before this */
+
+#define TP_STATUS_AVAILABLE    0
+#define TP_STATUS_SEND_REQUEST (1 << 0)
+#define TP_STATUS_SENDING      (1 << 1)
+#define TP_STATUS_WRONG_FORMAT (1 << 2)  /* tp_len did not fit the frame */
+
+/* Frame layout.  Each ring frame starts with a struct tpacket_hdr followed
+ * by a struct sockaddr_ll; received data starts at tp_mac, data to send
+ * starts at TPACKET_ALIGN(sizeof(struct tpacket_hdr)).
+ */
+
+#define TPACKET_ALIGNMENT      16
+#define TPACKET_ALIGN(x) \
+  (((x) + TPACKET_ALIGNMENT - 1) & ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN \
+  (TPACKET_ALIGN(sizeof(struct tpacket_hdr)) + sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,4 +95,39 @@ struct sockaddr_ll
   int16_t  sll_ifindex;
 };
 
+/* Ring geometry passed with PACKET_RX_RING and PACKET_TX_RING.  The ring
+ * is tp_block_nr blocks of tp_block_size bytes, each holding as many
+ * frames of tp_frame_size bytes as fit.  A tp_block_nr of zero releases
+ * the ring.
+ */
+
+struct tpacket_req
+{
+  unsigned int tp_block_size;  /* Minimal size of contiguous block */
+  unsigned int tp_block_nr;    /* Number of blocks */
+  unsigned int tp_frame_size;  /* Size of frame */
+  unsigned int tp_frame_nr;    /* Total number of frames */
+};
+
+/* Header at the start of each ring frame */
+
+struct tpacket_hdr
+{
+  unsigned long  tp_status;    /* TP_STATUS_* ownership and flags */
+  unsigned int   tp_len;       /* Length of the frame on the wire */
+  unsigned int   tp_snaplen;   /* Number of bytes stored in the ring */
+  unsigned short tp_mac;       /* Offset of the frame from the header */
+  unsigned short tp_net;       /* Offset of the network header */
+  unsigned int   tp_sec;       /* Receive time stamp */
+  unsigned int   tp_usec;
+};
+
+/* Returned by getsockopt(PACKET_STATISTICS); reading resets the counts */
+
+struct tpacket_stats
+{
+  unsigned int tp_packets;     /* Frames received, including drops */
+  unsigned int tp_drops;       /* Frames dropped because the ring was full */
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -54,6 +54,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/semaphore.h>
@@ -80,6 +81,15 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#ifdef CONFIG_ADC_BLOCK
+#  ifndef CONFIG_ADC_BLOCK_NBLOCKS
+#    define CONFIG_ADC_BLOCK_NBLOCKS 4
+#  endif
+#  ifndef CONFIG_ADC_BLOCK_SIZE
+#    define CONFIG_ADC_BLOCK_SIZE 512
+#  endif
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -110,6 +120,31 @@ struct adc_callback_s
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch,
                          int32_t data);
+
+#ifdef CONFIG_ADC_BLOCK
+  /* This method is called from the lower half when a block of samples is
+   * complete, typically from the DMA half and full transfer interrupts of
+   * a circular DMA buffer.  The data is copied before returning, so the
+   * DMA may overwrite it afterwards.  Only lower halves that set ad_block
+   * may use it.
+   *
+   * Input Parameters:
+   *   dev        - The ADC device structure that was previously registered
+   *                by adc_register()
+   *   data       - The samples of the scanned channels, interleaved
+   *   nbytes     - The size of the samples in bytes
+   *   nchannels  - The number of channels interleaved in the data
+   *   samplesize - The size of one sample in bytes: 1, 2 or 4
+   *
+   * Returned Value:
+   *   Zero on success; -ENOMEM if blocks were lost because the reader is
+   *   too slow.
+   */
+
+  CODE int (*au_receiveblock)(FAR struct adc_dev_s *dev,
+                              FAR const void *data, size_t nbytes,
+                              uint8_t nchannels, uint8_t samplesize);
+#endif
 };
 
 /* This describes on ADC message */
@@ -131,6 +166,32 @@ struct adc_fifo_s
   struct adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+#ifdef CONFIG_ADC_BLOCK
+/* In block mode, read() returns whole blocks of this form */
+
+struct adc_block_s
+{
+  struct timespec ab_time;       /* Time when the block was completed */
+  uint32_t     ab_seqno;         /* Sequence number of the block */
+  uint16_t     ab_lost;          /* Blocks lost just before this one */
+  uint16_t     ab_nbytes;        /* Bytes of samples in ab_data */
+  uint8_t      ab_nchannels;     /* Channels interleaved in ab_data */
+  uint8_t      ab_samplesize;    /* Bytes per sample: 1, 2 or 4 */
+  uint8_t      ab_data[CONFIG_ADC_BLOCK_SIZE];
+};
+
+/* This describes a ring of ADC blocks */
+
+struct adc_blockfifo_s
+{
+  FAR struct adc_block_s *ab_buffer; /* CONFIG_ADC_BLOCK_NBLOCKS blocks */
+  uint8_t      ab_head;              /* Index of the oldest block [OUT] */
+  uint8_t      ab_tail;              /* Index of the next free block [IN] */
+  uint16_t     ab_lost;              /* Blocks dropped while full */
+  uint32_t     ab_seqno;             /* Sequence number of the next block */
+};
+#endif
+
 /* This structure defines all of the operations provided by the architecture
  * specific logic.  All fields must be provided with non-NULL function
  * pointers by the caller of adc_register().
@@ -180,7 +241,7 @@ struct adc_ops_s
  * adc_register() must allocate and initialize this structure.  The calling
  * logic needs to set all fields to zero except:
  *
- *   The elements of 'ad_ops', and 'ad_priv'
+ *   The elements of 'ad_ops', and 'ad_priv' (and 'ad_block')
  *
  * The common logic will initialize all semaphores.
  */
@@ -195,6 +256,9 @@ struct adc_dev_s
   sem_t                       ad_closesem;   /* Locks out new opens while close is in progress */
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
+#ifdef CONFIG_ADC_BLOCK
+  struct adc_blockfifo_s      ad_blocks;     /* Ring of received blocks */
+#endif
 
   /* The following is a list of poll structures of threads waiting for
    * driver events.  The 'struct pollfd' reference for each open is also
@@ -208,6 +272,9 @@ struct adc_dev_s
 
   FAR const struct adc_ops_s *ad_ops;        /* Arch-specific operations */
   FAR void                   *ad_priv;       /* Used by the arch-specific logic */
+#ifdef CONFIG_ADC_BLOCK
+  bool                        ad_block;      /* Delivers au_receiveblock() */
+#endif
 };
 
 /****************************************************************************
@@ -677,6 +677,23 @@ void up_allocate_kheap(FAR void **heap_start, size_t *heap_size);
 void up_allocate_pgheap(FAR void **heap_start, size_t *heap_size);
 #endif
 
+/****************************************************************************
+ * Name: up_allocate_regionheaps
+ *
+ * Description:
+ *   If attribute tagged region heaps are enabled in the configuration, then
+ *   this function must be provided by the platform-specific code.  The OS
+ *   initialization logic will call this function early in the
+ *   initialization sequence, right after the heaps have been initialized.
+ *   It should register each memory region that is not part of the heaps
+ *   with kmm_region_add().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_REGION_HEAPS
+void up_allocate_regionheaps(void);
+#endif
+
 /****************************************************************************
  * Name: pgalloc
  *
@@ -1406,6 +1423,35 @@ void up_disable_irq(int irq);
 void up_trigger_irq(int irq);
 #endif
 
+/****************************************************************************
+ * Name: up_tls_switch
+ *
+ * Description:
+ *   Load the thread pointer register with the address of the TLS
+ *   information of 'tcb', which is about to resume.  Called from
+ *   nxsched_resume_scheduler() on architectures where the register is not
+ *   part of the saved register context.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_TLS_THREAD_POINTER) && \
+    defined(CONFIG_ARCH_THREAD_POINTER_SWITCH)
+void up_tls_switch(FAR struct tcb_s *tcb);
+#endif
+
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Route an IRQ to the CPUs in 'cpuset'.  Only the common logic in
+ *   sched/irq should call this; drivers use irq_set_affinity() instead.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_ARCH_HAVE_IRQ_AFFINITY)
+void up_affinity_irq(int irq, cpu_set_t cpuset);
+#endif
+
 /****************************************************************************
  * Name: up_prioritize_irq
  *
@@ -2084,6 +2130,26 @@ void nxsched_timer_expiration(void);
 void nxsched_alarm_expiration(FAR const struct timespec *ts);
 #endif
 
+/****************************************************************************
+ * Name:  nxsched_timer_remaining
+ *
+ * Description:
+ *   If CONFIG_SCHED_TICKLESS is defined, return the time until the timer
+ *   expires for the next watchdog or time slice.  This is the time that the
+ *   CPU will stay idle unless an interrupt occurs.
+ *
+ * Input Parameters:
+ *   ts - Location to return the remaining time
+ *
+ * Returned Value:
+ *   OK, or -ENOENT if no timer event is pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+int nxsched_timer_remaining(FAR struct timespec *ts);
+#endif
+
 /****************************************************************************
  * Name: nxsched_process_cpuload
  *
@@ -2425,7 +2491,9 @@ void arch_sporadic_resume(FAR struct tcb_s *tcb);
  *   units.
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_SPANS) || \
+    defined(CONFIG_SCHED_CPUTIME) || defined(CONFIG_SCHED_BENCHMARK) || \
+    defined(CONFIG_MM_BENCHMARK)
 uint32_t up_critmon_gettime(void);
 void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
 #endif
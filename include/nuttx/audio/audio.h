@@ -129,6 +129,42 @@
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
 #define AUDIOIOC_SETBUFFERINFO      _AUDIOIOC(17)
 
+/* Memory-mapped ring buffer streaming (CONFIG_AUDIO_RINGBUFFER):
+ *
+ * AUDIOIOC_RINGSETUP - Allocate a ring of equally sized periods.  The
+ *   ring can then be accessed through the returned address or mmap().
+ *
+ *   ioctl argument:  Pointer to an audio_ring_s structure
+ *
+ * AUDIOIOC_RINGACQUIRE - Wait until the next period of the ring is owned by
+ *   the application and return its index.  Initially all periods are
+ *   owned by the application.  Fails with EAGAIN if O_NONBLOCK is set.
+ *
+ *   ioctl argument:  Pointer to a uint32_t to receive the period index
+ *
+ * AUDIOIOC_RINGCOMMIT - Give the oldest acquired period to the device.
+ *   For playback the period holds the samples to play, for capture it
+ *   receives the samples recorded.
+ *
+ *   ioctl argument:  Number of valid bytes in the period (0:  All)
+ *
+ * AUDIOIOC_RINGRELEASE - Free the ring.  The stream must be stopped.
+ *
+ *   ioctl argument:  None
+ */
+
+#define AUDIOIOC_RINGSETUP          _AUDIOIOC(18)
+#define AUDIOIOC_RINGACQUIRE        _AUDIOIOC(19)
+#define AUDIOIOC_RINGCOMMIT         _AUDIOIOC(20)
+#define AUDIOIOC_RINGRELEASE        _AUDIOIOC(21)
+
+/* AUDIOIOC_GETLATENCY - Get the latency statistics of a stream
+ *
+ *   ioctl argument:  Pointer to an audio_latency_s structure
+ */
+
+#define AUDIOIOC_GETLATENCY         _AUDIOIOC(22)
+
 /* Audio Device Types *******************************************************/
 
 /* The NuttX audio interface support different types of audio devices for
@@ -336,6 +372,7 @@
 #define AUDIO_APB_OUTPUT_PROCESS    (1 << 1)
 #define AUDIO_APB_DEQUEUED          (1 << 2)
 #define AUDIO_APB_FINAL             (1 << 3) /* Last buffer in the stream */
+#define AUDIO_APB_RING              (1 << 4) /* Period of a mapped ring */
 
 /****************************************************************************
  * Public Types
@@ -486,6 +523,34 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Structure returned by the AUDIOIOC_GETLATENCY ioctl.  All times are in
+ * microseconds.
+ */
+
+struct audio_latency_s
+{
+  uint32_t             latency;           /* Time until a sample enqueued now
+                                           * is played */
+  uint32_t             maxlatency;        /* Highest latency seen */
+  uint32_t             output;            /* Part of the latency spent in the
+                                           * output device */
+  uint32_t             underruns;         /* Periods played without data */
+};
+
+/* Structure for setting up a memory-mapped ring with the AUDIOIOC_RINGSETUP
+ * ioctl.  Period 'n' starts at base + n * periodsize.
+ */
+
+struct audio_ring_s
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void            *session;           /* Associated channel */
+#endif
+  uint32_t             nperiods;          /* IN:  Number of periods */
+  apb_samp_t           periodsize;        /* IN:  Bytes per period */
+  FAR uint8_t         *base;              /* OUT: Address of the ring */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -53,7 +53,11 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define BINFMT_NALLOC 3
+#ifdef CONFIG_ELF_SHARETEXT
+#  define BINFMT_NALLOC 4 /* ELF text and data are allocated separately */
+#else
+#  define BINFMT_NALLOC 3
+#endif
 
 /****************************************************************************
  * Public Types
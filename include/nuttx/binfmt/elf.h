@@ -88,6 +88,8 @@
  * Public Types
  ****************************************************************************/
 
+struct elf_share_s; /* Opaque, see binfmt/libelf/libelf_share.c */
+
 /* This struct provides a description of the currently loaded instantiation
  * of an ELF binary.
  */
@@ -144,6 +146,13 @@ struct elf_loadinfo_s
   uint16_t           strtabidx;  /* String table section index */
   uint16_t           buflen;     /* size of iobuffer[] */
   int                filfd;      /* Descriptor for the file being loaded */
+#ifdef CONFIG_ELF_XIP
+  FAR const uint8_t *xipbase;    /* Address of the file in memory, or NULL */
+#endif
+#ifdef CONFIG_ELF_SHARETEXT
+  FAR struct elf_share_s *share; /* Text shared with other instances */
+  bool               textpriv;   /* Text relocations depend on the data */
+#endif
 };
 
 /****************************************************************************
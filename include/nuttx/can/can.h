@@ -45,6 +45,9 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#ifdef CONFIG_CAN_TIMESTAMP
+#  include <sys/time.h>
+#endif
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -215,6 +218,30 @@
  *                   is returned with the errno variable set to indicate the
  *                   nature of the error.
  *   Dependencies:   None
+ *
+ * CANIOC_RXWAIT:
+ *   Description:    Wait until at least the requested number of messages is
+ *                   queued in the receive FIFO of this open instance, so
+ *                   that one wakeup can be followed by one read() (or one
+ *                   pass over the mapped FIFO) that drains all of them.
+ *   Argument:       A pointer to a read-able instance of struct
+ *                   canioc_rxwait_s.
+ *   Returned Value: The number of queued messages on success.  This is less
+ *                   than requested if the timeout expired with some, but
+ *                   not enough, messages queued.  Otherwise -1 (ERROR) is
+ *                   returned with the errno variable set to indicate the
+ *                   nature of the error (ETIMEDOUT if no message arrived,
+ *                   EAGAIN in non-blocking mode).
+ *   Dependencies:   None
+ *
+ * FIOC_MMAP:
+ *   Description:    Map the receive FIFO of this open instance (struct
+ *                   can_rxfifo_s) with mmap().  The reader consumes
+ *                   rx_buffer[rx_head] while rx_head != rx_tail and then
+ *                   advances rx_head (modulo CONFIG_CAN_FIFOSIZE) itself.
+ *                   The mapped FIFO must not be mixed with read().
+ *   Argument:       Location to return the address
+ *   Dependencies:   Requires CONFIG_CAN_RXMMAP=y
  */
 
 #define CANIOC_RTR                _CANIOC(1)
@@ -229,9 +256,10 @@
 #define CANIOC_BUSOFF_RECOVERY    _CANIOC(10)
 #define CANIOC_SET_NART           _CANIOC(11)
 #define CANIOC_SET_ABOM           _CANIOC(12)
+#define CANIOC_RXWAIT             _CANIOC(13)
 
 #define CAN_FIRST                 0x0001         /* First common command */
-#define CAN_NCMDS                 12             /* Ten common commands */
+#define CAN_NCMDS                 13             /* Thirteen common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half CAN driver to the lower-half CAN driver via the co_ioctl()
@@ -456,6 +484,9 @@ begin_packed_struct struct can_hdr_s
 #endif
   uint8_t      ch_extid  : 1; /* Extended ID indication */
   uint8_t      ch_unused : 1; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time of reception */
+#endif
 } end_packed_struct;
 
 #else
@@ -468,6 +499,9 @@ begin_packed_struct struct can_hdr_s
   uint8_t      ch_error  : 1; /* 1=ch_id is an error report */
 #endif
   uint8_t      ch_unused : 2; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time of reception */
+#endif
 } end_packed_struct;
 #endif
 
@@ -482,8 +516,8 @@ begin_packed_struct struct can_msg_s
 struct can_rxfifo_s
 {
   sem_t         rx_sem;                  /* Counting semaphore */
-  uint8_t       rx_head;                 /* Index to the head [IN] in the circular buffer */
-  uint8_t       rx_tail;                 /* Index to the tail [OUT] in the circular buffer */
+  volatile uint8_t rx_head;              /* Index to the head [IN] in the circular buffer */
+  volatile uint8_t rx_tail;              /* Index to the tail [OUT] in the circular buffer */
                                          /* Circular buffer of CAN messages */
   struct can_msg_s rx_buffer[CONFIG_CAN_FIFOSIZE];
 };
@@ -580,6 +614,7 @@ struct can_ops_s
 struct can_reader_s
 {
   struct list_node     list;
+  uint8_t              rx_nwait;         /* Wake the reader at this FIFO level */
   struct can_rxfifo_s  fifo;             /* Describes receive FIFO */
 };
 
@@ -601,6 +636,11 @@ struct can_dev_s
   struct can_rtrwait_s cd_rtr[CONFIG_CAN_NPENDINGRTR];
   FAR const struct can_ops_s *cd_ops;    /* Arch-specific operations */
   FAR void            *cd_priv;          /* Used by the arch-specific logic */
+#ifdef CONFIG_CAN_TIMESTAMP
+  bool                 cd_hwtstamp;      /* The lower half provides ch_ts (from a
+                                          * hardware time stamp).  Otherwise
+                                          * can_receive() provides it */
+#endif
 
   FAR struct pollfd   *cd_fds[CONFIG_CAN_NPOLLWAITERS];
 };
@@ -615,6 +655,15 @@ struct canioc_rtr_s
   FAR struct can_msg_s *ci_msg;          /* The location to return the RTR response */
 };
 
+/* CANIOC_RXWAIT: */
+
+struct canioc_rxwait_s
+{
+  uint8_t               rw_nmsgs;        /* Number of messages to wait for */
+  uint32_t              rw_timeout;      /* Timeout in milliseconds; 0 waits
+                                          * forever */
+};
+
 /* CANIOC_GET_BITTIMING/CANIOC_SET_BITTIMING:
  *
  * Bit time = Tquanta * (Sync_Seg + Prop_Seq + Phase_Seg1 + Phase_Seg2)
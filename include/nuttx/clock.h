@@ -219,6 +219,26 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The user time page.  The OS publishes the system timer and the
+ * CLOCK_REALTIME base time here on every tick so that clock_gettime() in
+ * user space does not need a system call.  The page lives in user memory
+ * (struct userspace_s::us_timepage) and is written only by the OS, with
+ * interrupts disabled.
+ *
+ * 'seq' is odd while an update is in progress.  A reader samples it,
+ * copies the fields and retries if 'seq' was odd or has changed.
+ */
+
+#ifdef CONFIG_CLOCK_USERPAGE
+struct clock_timepage_s
+{
+  volatile uint32_t seq;       /* Update sequence count */
+  volatile clock_t  ticks;     /* The system timer */
+  volatile time_t   base_sec;  /* The CLOCK_REALTIME time at tick zero */
+  volatile long     base_nsec;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -247,10 +267,29 @@ EXTERN volatile clock_t g_system_timer;
 #endif
 #endif
 
+/* The user time page, defined by the C library in user space and given to
+ * the OS through struct userspace_s.
+ */
+
+#if defined(CONFIG_CLOCK_USERPAGE) && !defined(__KERNEL__)
+EXTERN struct clock_timepage_s g_clock_timepage;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nx_clock_gettime
+ *
+ * Description:
+ *   The OS version of clock_gettime().  It behaves identically except that
+ *   it returns a negated errno value on failure rather than setting errno.
+ *
+ ****************************************************************************/
+
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp);
+
 /****************************************************************************
  * Name: clock_timespec_compare
  *
@@ -436,6 +475,29 @@ int clock_systime_timespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cputime and clock_processtime
+ *
+ * Description:
+ *   Return the accumulated execution time of the selected thread, or of
+ *   all of the threads in its task group.
+ *
+ * Input Parameters:
+ *   pid - The task ID of the thread of interest. pid == 0 is IDLE thread.
+ *   cputime - The location to return the execution time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+int clock_cputime(int pid, FAR struct timespec *cputime);
+int clock_processtime(int pid, FAR struct timespec *cputime);
+#endif
+
 /****************************************************************************
  * Name:  nxsched_oneshot_extclk
  *
@@ -118,6 +118,18 @@
 
 #  define locate_data(n) __attribute__ ((section(n)))
 
+/* Hot code location.  With CONFIG_ARCH_FASTCODE, functions marked
+ * locate_fast are collected in the .fastcode section, which the linker
+ * script places in tightly coupled or internal RAM.  They are not inlined
+ * so that the code really runs from there.
+ */
+
+#  ifdef CONFIG_ARCH_FASTCODE
+#    define locate_fast __attribute__ ((section(".fastcode"),noinline))
+#  else
+#    define locate_fast
+#  endif
+
 /* The packed attribute informs GCC that the structure elements are packed,
  * ignoring other alignment rules.
  */
@@ -340,6 +352,7 @@
 
 #  define noreturn_function
 #  define locate_code(n)
+#  define locate_fast
 #  define aligned_data(n)
 #  define locate_data(n)
 #  define begin_packed_struct
@@ -478,6 +491,7 @@
 #  define noreturn_function
 #  define aligned_data(n)
 #  define locate_code(n)
+#  define locate_fast
 #  define locate_data(n)
 #  define begin_packed_struct
 #  define end_packed_struct
@@ -576,6 +590,7 @@
 #  define noreturn_function
 #  define farcall_function
 #  define locate_code(n)
+#  define locate_fast
 #  define aligned_data(n)
 #  define locate_data(n)
 #  define begin_packed_struct  __packed
@@ -632,6 +647,7 @@
 #  define farcall_function
 #  define aligned_data(n)
 #  define locate_code(n)
+#  define locate_fast
 #  define locate_data(n)
 #  define begin_packed_struct
 #  define end_packed_struct
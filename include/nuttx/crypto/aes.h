@@ -42,6 +42,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -49,6 +50,12 @@
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES_MAX_KEY_SIZE   32
+#define AES_BLOCK_SIZE     16
+
+/* Number of rounds of AES-256, the longest key schedule */
+
+#define AES_MAXNR          14
 
 /****************************************************************************
  * Public Types
@@ -56,9 +63,20 @@
 
 struct aes_state_s
 {
-  uint8_t expanded_key[176];
+  uint32_t ek[4 * (AES_MAXNR + 1)];  /* Encryption round keys */
+  uint32_t dk[4 * (AES_MAXNR + 1)];  /* Decryption round keys */
+  int nr;                            /* Number of rounds: 10, 12 or 14 */
 };
 
+#ifdef CONFIG_CRYPTO_SW_AES_GCM
+struct aes_gcm_s
+{
+  struct aes_state_s aes;            /* Expanded key */
+  uint64_t hl[16];                   /* GHASH tables: low halves of i * H */
+  uint64_t hh[16];                   /* GHASH tables: high halves of i * H */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -118,14 +136,12 @@ void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key);
  *
  * Input Parameters:
  *  state  an AES context that can be used for AES operations
- *  key    a pointer to a 16-byte buffer holding the AES-128 key
- *  len    length of the key, must be 16
- *
- * TODO: Support other key lengths of 24 (AES-192) and 32 (AES-256)
+ *  key    a pointer to the key
+ *  len    length of the key: 16 (AES-128), 24 (AES-192) or 32 (AES-256)
  *
  * Returned Value:
  *   0 if OK
- *   -EINVAL if len is not 16
+ *   -EINVAL if len is not valid
  *
  ****************************************************************************/
 
@@ -164,6 +180,45 @@ void aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
 void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk);
 
+#ifdef CONFIG_CRYPTO_SW_AES_GCM
+/****************************************************************************
+ * Name: aes_gcm_setupkey
+ *
+ * Description:
+ *   Configure a GCM context for the given key: expand the key and build
+ *   the GHASH multiplication tables.
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if len is not 16, 24 or 32
+ *
+ ****************************************************************************/
+
+int aes_gcm_setupkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                     int len);
+
+/****************************************************************************
+ * Name: aes_gcm_crypt
+ *
+ * Description:
+ *   GCM authenticated encryption (encrypt != 0) or decryption of one
+ *   message.  On encryption taglen bytes of tag are written; on
+ *   decryption the tag is verified.
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if a length is not valid
+ *   -EBADMSG if the tag does not match; out is cleared
+ *
+ ****************************************************************************/
+
+int aes_gcm_crypt(FAR struct aes_gcm_s *gcm, int encrypt,
+                  FAR const uint8_t *iv, size_t ivlen,
+                  FAR const uint8_t *aad, size_t aadlen,
+                  FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                  FAR uint8_t *tag, size_t taglen);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
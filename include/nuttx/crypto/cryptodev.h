@@ -42,6 +42,9 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -65,6 +68,8 @@
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
 #define CIOCCRYPT               103
+#define CIOCNCRYPTM             104 /* Queue several operations */
+#define CIOCNCRYPTRETM          105 /* Collect completed operations */
 
 typedef char* caddr_t;
 
@@ -92,4 +97,46 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* CIOCNCRYPTM: the requests are queued and run asynchronously.  Each
+ * request gets a reqid and a status: 0 if it was queued, otherwise a
+ * negated errno value and it is not run.
+ */
+
+struct crypt_n_op
+{
+  uint32_t ses;
+  uint16_t op;        /* i.e. COP_ENCRYPT */
+  uint16_t flags;
+  unsigned len;
+  uint32_t reqid;     /* returns: request id */
+  int status;         /* returns: 0 if queued */
+  FAR void *opaque;   /* returned with the result */
+  caddr_t src, dst;
+  caddr_t mac;
+  caddr_t iv;
+};
+
+struct crypt_mop
+{
+  size_t count;       /* Number of requests */
+  FAR struct crypt_n_op *reqs;
+};
+
+/* CIOCNCRYPTRETM: up to count results of completed requests are returned,
+ * in completion order, and count is set to the number returned.
+ */
+
+struct crypt_result
+{
+  uint32_t reqid;
+  int status;         /* 0 or a negated errno value */
+  FAR void *opaque;
+};
+
+struct cryptret
+{
+  size_t count;       /* in: room in results, out: number returned */
+  FAR struct crypt_result *results;
+};
+
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
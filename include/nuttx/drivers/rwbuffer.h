@@ -147,6 +147,22 @@ struct rwbuffer_s
   uint8_t      *wrbuffer;        /* Allocated write buffer */
   uint16_t      wrnblocks;       /* Number of blocks in write buffer */
   off_t         wrblockstart;    /* First block in write buffer */
+#ifdef CONFIG_DRVR_WRCOALESCE
+  FAR off_t    *wrunit;          /* Unit number held in each buffer slot */
+  FAR uint16_t *wrorder;         /* Slot indices sorted by unit number */
+  FAR uint8_t  *wrtemp;          /* One unit of scratch for sorting slots */
+  uint16_t      wrnunits;        /* Number of units in write buffer */
+  uint16_t      wrmaxunits;      /* Capacity of write buffer in units */
+
+  /* Write buffer statistics.  wrnflushed / wrnflushes is the average
+   * number of blocks merged into each transfer.
+   */
+
+  uint32_t      wrnwritten;      /* Blocks written to the buffer */
+  uint32_t      wrnmerged;       /* Blocks that rewrote a buffered block */
+  uint32_t      wrnflushes;      /* Number of wrflush() transfers */
+  uint32_t      wrnflushed;      /* Blocks passed to wrflush() */
+#endif
 #endif
 
   /* This is the state of the read-ahead buffering */
@@ -0,0 +1,94 @@
+/****************************************************************************
+ * include/nuttx/drivers/zram.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_ZRAM_H
+#define __INCLUDE_NUTTX_DRIVERS_ZRAM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_DRVR_ZRAM
+
+/****************************************************************************
+ * Type Definitions
+ ****************************************************************************/
+
+/* Returned by the BIOC_ZRAMSTATS ioctl command.  Sectors that were never
+ * written count as same-filled (with zeros).
+ */
+
+struct zram_stats_s
+{
+  uint32_t zs_nsectors;     /* Number of sectors on the device */
+  uint32_t zs_nsame;        /* Sectors stored as a repeated 32-bit pattern */
+  uint32_t zs_ncompressed;  /* Sectors stored compressed */
+  uint32_t zs_nraw;         /* Sectors that did not compress */
+  size_t   zs_stored;       /* Bytes held for compressed and raw sectors */
+  size_t   zs_original;     /* Size of those sectors before compression */
+  uint32_t zs_nnomem;       /* Writes failed for lack of memory */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: zram_register
+ *
+ * Description:
+ *   Register a compressed RAM disk at /dev/zramN.  Each sector is
+ *   compressed with LZF when written and memory is allocated only for the
+ *   compressed data, so the disk may be larger than the memory it uses.
+ *   Sectors filled with a repeated 32-bit pattern (zeros in particular)
+ *   use no memory at all.
+ *
+ * Input Parameters:
+ *   minor:         Selects suffix of device named /dev/zramN, N={0,1,...}
+ *   nsectors:      Number of sectors on device
+ *   sectsize:      The size of one sector, a multiple of 4 bytes
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int zram_register(int minor, uint32_t nsectors, uint16_t sectsize);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_DRVR_ZRAM */
+#endif /* __INCLUDE_NUTTX_DRIVERS_ZRAM_H */
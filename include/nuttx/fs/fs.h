@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#include <poll.h>
 
 #ifdef CONFIG_FS_NAMED_SEMAPHORES
 #  include <nuttx/semaphore.h>
@@ -95,6 +96,15 @@
 #  define _NX_GETERRVAL(r)     (-errno)
 #endif
 
+/* The file descriptors of a task group are allocated in blocks of
+ * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK descriptors when first needed.
+ */
+
+#define FILES_PER_BLOCK CONFIG_NFILE_DESCRIPTORS_PER_BLOCK
+#define FILES_NBLOCKS \
+  ((CONFIG_NFILE_DESCRIPTORS + FILES_PER_BLOCK - 1) / FILES_PER_BLOCK)
+#define FILES_NWORDS    ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
+
 /* Stream flags for the fs_flags field of in struct file_struct */
 
 #define __FS_FLAG_EOF   (1 << 0) /* EOF detected by a read operation */
@@ -248,6 +258,34 @@ struct geometry
   size_t geo_sectorsize;   /* Size of one sector */
 };
 
+/* This structure describes one queued block transfer.  It is passed to the
+ * block driver submit() method which returns as soon as the request has
+ * been queued.  When the transfer completes, the driver sets br_result and
+ * calls br_complete().  The request structure, the buffer, and br_priv
+ * belong to the submitter; the driver uses br_flink while it holds the
+ * request.
+ */
+
+#ifdef CONFIG_FS_BLOCK_REQUEST
+#  define BLKREQ_READ  0       /* Read br_nsectors into br_buffer */
+#  define BLKREQ_WRITE 1       /* Write br_nsectors from br_buffer */
+
+struct blk_request_s;
+typedef CODE void (*blk_complete_t)(FAR struct blk_request_s *req);
+
+struct blk_request_s
+{
+  FAR struct blk_request_s *br_flink; /* For use by the driver */
+  uint8_t        br_op;               /* BLKREQ_READ or BLKREQ_WRITE */
+  FAR uint8_t   *br_buffer;           /* Transfer buffer */
+  size_t         br_sector;           /* First sector of the transfer */
+  unsigned int   br_nsectors;         /* Number of sectors to transfer */
+  ssize_t        br_result;           /* Sectors done or negated errno */
+  blk_complete_t br_complete;         /* Called when the transfer completes */
+  FAR void      *br_priv;             /* For use by the submitter */
+};
+#endif
+
 /* This structure is provided by block devices when they register with the
  * system.  It is used by file systems to perform filesystem transfers.  It
  * differs from the normal driver vtable in several ways -- most notably in
@@ -269,6 +307,9 @@ struct block_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   int     (*unlink)(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FS_BLOCK_REQUEST
+  int     (*submit)(FAR struct inode *inode, FAR struct blk_request_s *req);
+#endif
 };
 
 /* This structure is provided by a filesystem to describe a mount point.
@@ -412,12 +453,32 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* A poll registration that stays connected to a file or socket across
+ * calls (see pollreg_arm()).  The registration is disconnected when the
+ * file or socket is closed.
+ */
+
+struct pollreg_s
+{
+  FAR struct pollreg_s *flink;  /* Links the connected registrations */
+  FAR void         *ptr;        /* The struct file or struct socket */
+  struct pollfd     pfd;        /* The persistent poll structure */
+  bool              armed;      /* True: Connected to the driver */
+  bool              sock;       /* True: ptr is a struct socket */
+};
+
+/* This defines a list of files indexed by the file descriptor.  Bit n of
+ * fl_used is set while descriptor n is allocated.  The descriptor itself
+ * is fl_files[n / FILES_PER_BLOCK][n % FILES_PER_BLOCK]; blocks are never
+ * moved or freed before files_releaselist(), so a struct file pointer
+ * stays valid while the descriptor is open.
+ */
 
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
-  struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+  uint32_t fl_used[FILES_NWORDS];
+  FAR struct file *fl_files[FILES_NBLOCKS];
 };
 
 /* The following structure defines the list of files used for standard C I/O.
@@ -744,6 +805,30 @@ void files_initlist(FAR struct filelist *list);
 
 void files_releaselist(FAR struct filelist *list);
 
+/****************************************************************************
+ * Name: files_duplist
+ *
+ * Description:
+ *   Duplicate the first 'nfds' file descriptors of 'plist' that are open
+ *   and not close-on-exec into the new list 'clist'.
+ *
+ ****************************************************************************/
+
+void files_duplist(FAR struct filelist *plist, FAR struct filelist *clist,
+                   int nfds);
+
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the struct file of descriptor 'fd' in 'list', or NULL if no
+ *   block has been allocated for the descriptor yet (so that it cannot be
+ *   open).
+ *
+ ****************************************************************************/
+
+FAR struct file *files_fget(FAR struct filelist *list, int fd);
+
 /****************************************************************************
  * Name: file_dup
  *
@@ -1022,6 +1107,31 @@ int open_blockdriver(FAR const char *pathname, int mountflags,
 
 int close_blockdriver(FAR struct inode *inode);
 
+/****************************************************************************
+ * Name: block_submit
+ *
+ * Description:
+ *   Queue a block transfer on the block driver.  If the driver provides a
+ *   submit() method, this returns as soon as the request is queued and
+ *   req->br_complete() is called later from the driver's context.
+ *   Otherwise, the transfer is performed synchronously with the read() or
+ *   write() method and req->br_complete() is called before returning.
+ *
+ * Input Parameters:
+ *   inode - The inode of the block driver
+ *   req   - The request to perform
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was accepted; req->br_complete() will be (or
+ *   has been) called.  A negated errno value is returned if the request
+ *   was rejected; req->br_complete() will not be called in that case.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCK_REQUEST
+int block_submit(FAR struct inode *inode, FAR struct blk_request_s *req);
+#endif
+
 /****************************************************************************
  * Name: fs_fdopen
  *
@@ -1412,6 +1522,56 @@ int fs_poll(int fd, FAR struct pollfd *fds, bool setup);
 
 int nx_poll(FAR struct pollfd *fds, unsigned int nfds, int timeout);
 
+/****************************************************************************
+ * Name: pollreg_arm
+ *
+ * Description:
+ *   Connect a persistent poll registration to the file or socket that
+ *   reg->pfd.fd refers to.  The caller provides pfd.fd, pfd.events and
+ *   pfd.sem.  The driver then reports events in pfd.revents and posts
+ *   pfd.sem until pollreg_disarm() is called or the descriptor is closed,
+ *   without a setup and teardown on each wait.
+ *
+ *   When the file or socket is closed, the registration is disarmed,
+ *   POLLNVAL is set in pfd.revents and pfd.sem is posted.
+ *
+ * Input Parameters:
+ *   reg - The registration.  Must remain valid until it is disarmed.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int pollreg_arm(FAR struct pollreg_s *reg);
+
+/****************************************************************************
+ * Name: pollreg_disarm
+ *
+ * Description:
+ *   Disconnect a registration connected by pollreg_arm().  Does nothing if
+ *   it is not connected.
+ *
+ ****************************************************************************/
+
+void pollreg_disarm(FAR struct pollreg_s *reg);
+
+/****************************************************************************
+ * Name: pollreg_release
+ *
+ * Description:
+ *   Disarm all registrations connected to a file or socket that is being
+ *   closed.  Called by every close path of files (file_close(),
+ *   close(), dup2(), task exit and file_detach()) and by psock_close().
+ *
+ * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
+ *
+ ****************************************************************************/
+
+void pollreg_release(FAR void *ptr);
+
 /****************************************************************************
  * Name: file_fstat
  *
@@ -1454,6 +1614,25 @@ int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 
 int nx_stat(FAR const char *path, FAR struct stat *buf, int resolve);
 
+/****************************************************************************
+ * Name: signalfd_notify
+ *
+ * Description:
+ *   Called by the signal logic whenever a signal is added to the pending
+ *   set of a task group, so that signalfds of that group polling for the
+ *   signal are woken up.  May be called from interrupt level.
+ *
+ * Input Parameters:
+ *   group - The task group the signal is pending for
+ *   signo - The signal number
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIGNAL_FD
+struct task_group_s;
+void signalfd_notify(FAR struct task_group_s *group, int signo);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -99,6 +99,7 @@
 #define _RPTUNBASE      (0x2b00) /* Remote processor tunnel ioctl commands */
 #define _NOTECTLBASE    (0x2c00) /* Note filter control ioctl commands*/
 #define _NOTERAMBASE    (0x2d00) /* Noteram device ioctl commands*/
+#define _IORINGBASE     (0x2e00) /* AIO ring ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -286,6 +287,23 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_SUBMIT     _BIOC(0x000e)     /* Used only by BCH to queue a transfer
+                                           * on the contained block driver.
+                                           * IN:  Pointer to struct blk_request_s
+                                           *      (see include/nuttx/fs/fs.h)
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_GC         _BIOC(0x000f)     /* Run bounded garbage collection now
+                                           * IN:  Pointer to a driver-specific
+                                           *      struct with the limits (see
+                                           *      struct mtd_smart_gc_s)
+                                           * OUT: The number of erase blocks
+                                           *      reclaimed or error */
+#define BIOC_ZRAMSTATS  _BIOC(0x0010)     /* Get compressed RAM disk statistics
+                                           * IN:  Pointer to struct zram_stats_s
+                                           *      (see include/nuttx/drivers/
+                                           *      zram.h)
+                                           * OUT: The statistics */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -405,6 +423,11 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SPSC      _PIPEIOC(0x0002)  /* Single producer/consumer mode
+                                             * IN: unsigned long integer
+                                             *     0=disabled (default)
+                                             *     1=lock-free SPSC ring
+                                             * OUT: None */
 
 /* RTC driver ioctl definitions *********************************************/
 
@@ -539,6 +562,11 @@
 #define _NOTERAMIOCVALID(c) (_IOC_TYPE(c) == _NOTERAMBASE)
 #define _NOTERAMIOC(nr)     _IOC(_NOTERAMBASE, nr)
 
+/* AIO ring driver **********************************************************/
+
+#define _IORINGIOCVALID(c) (_IOC_TYPE(c) == _IORINGBASE)
+#define _IORINGIOC(nr)     _IOC(_IORINGBASE, nr)
+
 /* Wireless driver network ioctl definitions ********************************/
 
 /* (see nuttx/include/wireless/wireless.h */
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * include/nuttx/fs/ioring.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_IORING_H
+#define __INCLUDE_NUTTX_FS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <poll.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The AIO ring driver.  Each open of the driver creates a new, private
+ * ring context that is released when the file is closed.
+ */
+
+#define IORING_DEVPATH      "/dev/ioring"
+
+/* AIO ring IOCTL commands */
+
+/* Command:      IORINGIOC_SETUP
+ * Description:  Attach the submission and completion rings to the context.
+ *               This may be done only once per open.
+ * Argument:     A pointer to an instance of struct ioring_s in memory that
+ *               is accessible to both the caller and the OS and that
+ *               remains valid until the file is closed.
+ */
+
+/* Command:      IORINGIOC_ENTER
+ * Description:  Start the I/O described by new submission queue entries
+ *               and/or wait for completions.
+ * Argument:     A pointer to a read-only instance of struct ioring_enter_s
+ * Returns:      The number of submission queue entries consumed
+ */
+
+#define IORINGIOC_SETUP     _IORINGIOC(0x0001)
+#define IORINGIOC_ENTER     _IORINGIOC(0x0002)
+
+/* Submission queue entry operations */
+
+#define IORING_OP_NOP       0  /* Complete immediately with result 0 */
+#define IORING_OP_READ      1  /* pread() from a file */
+#define IORING_OP_WRITE     2  /* pwrite() to a file */
+#define IORING_OP_SEND      3  /* send() on a socket */
+#define IORING_OP_RECV      4  /* recv() on a socket */
+#define IORING_OP_POLL      5  /* Wait for one of the poll events */
+#define IORING_OP_FSYNC     6  /* fsync() a file */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One submission queue entry, written by the application */
+
+struct ioring_sqe_s
+{
+  uint8_t opcode;                  /* See IORING_OP_* definitions */
+  pollevent_t events;              /* IORING_OP_POLL: Events to wait for */
+  int16_t fd;                      /* File or socket descriptor */
+  off_t offset;                    /* READ/WRITE: File offset */
+  FAR void *buf;                   /* READ/WRITE/SEND/RECV: Buffer */
+  size_t nbytes;                   /* READ/WRITE/SEND/RECV: Buffer size */
+  FAR void *user_data;             /* Returned unchanged in the completion */
+};
+
+/* One completion queue entry, written by the OS */
+
+struct ioring_cqe_s
+{
+  FAR void *user_data;             /* Copied from the submission */
+  ssize_t res;                     /* Result of the operation (the value
+                                    * the equivalent call would return or a
+                                    * negated errno value).  The revents
+                                    * for IORING_OP_POLL. */
+};
+
+/* The pair of rings shared between the application and the OS.  Both are
+ * single producer, single consumer rings indexed by free running counters:
+ * The application fills sqes[sq_tail & sq_mask] and then advances sq_tail;
+ * the OS advances sq_head as it consumes entries.  The OS fills
+ * cqes[cq_tail & cq_mask] and then advances cq_tail; the application
+ * advances cq_head as it consumes entries.  The number of entries in each
+ * ring (mask + 1) must be a power of two.
+ */
+
+struct ioring_s
+{
+  volatile uint32_t sq_head;       /* Next entry the OS will consume */
+  volatile uint32_t sq_tail;       /* Next entry the application will fill */
+  volatile uint32_t cq_head;       /* Next entry the application will read */
+  volatile uint32_t cq_tail;       /* Next entry the OS will fill */
+  uint32_t sq_mask;                /* Number of SQ entries - 1 */
+  uint32_t cq_mask;                /* Number of CQ entries - 1 */
+  FAR struct ioring_sqe_s *sqes;   /* The submission queue */
+  FAR struct ioring_cqe_s *cqes;   /* The completion queue */
+};
+
+/* This is the structure referred to in the argument to the IORINGIOC_ENTER
+ * IOCTL command.
+ */
+
+struct ioring_enter_s
+{
+  unsigned int to_submit;          /* Maximum number of entries to submit */
+  unsigned int min_complete;       /* Wait until this many completions are
+                                    * unread in the completion queue */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ioring_register
+ *
+ * Description:
+ *   Register the AIO ring driver at IORING_DEVPATH
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ioring_register(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FS_AIO_RING */
+#endif /* __INCLUDE_NUTTX_FS_IORING_H */
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+
+#include <nuttx/wdog.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HRTIMER_ISACTIVE(t) ((t)->func != NULL)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A high-resolution timer.  Times are in nanoseconds of the free-running
+ * clock of the oneshot timer given to hrtimer_initialize().  The expiration
+ * function is called from that timer's interrupt handler with the same
+ * wdparm_t argument convention as a watchdog.
+ */
+
+struct hrtimer_s
+{
+  FAR struct hrtimer_s *next;    /* Next timer in expiration order */
+  wdentry_t             func;    /* Function to call, NULL if not active */
+  wdparm_t              arg;     /* Argument passed to func */
+  uint64_t              expire;  /* Absolute expiration time (ns) */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+struct oneshot_lowerhalf_s;
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Give the high-resolution timers a oneshot timer to run on.  This must
+ *   be a timer of its own, not the one that drives the system tick.  Until
+ *   this is called hrtimer_start() fails with -ENODEV and its users fall
+ *   back to watchdogs.
+ *
+ * Input Parameters:
+ *   lower - An oneshot lower half with a free-running current() method
+ *
+ ****************************************************************************/
+
+void hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high-resolution clock in nanoseconds,
+ *   or zero if no oneshot timer has been provided.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   (Re)start a timer to call func(arg) once, 'delay' nanoseconds from now.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if no oneshot timer has been provided.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t delay,
+                  wdentry_t func, wdparm_t arg);
+
+/****************************************************************************
+ * Name: hrtimer_start_abs
+ *
+ * Description:
+ *   Like hrtimer_start() but at the absolute time 'expire' as returned by
+ *   hrtimer_gettime().  Periodic users add their period to the previous
+ *   expiration so that the period does not drift.
+ *
+ ****************************************************************************/
+
+int hrtimer_start_abs(FAR struct hrtimer_s *timer, uint64_t expire,
+                      wdentry_t func, wdparm_t arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a timer.  Cancelling a timer that is not active is not an error.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the nanoseconds until an active timer expires; zero if the timer
+ *   is not active or already due.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
@@ -247,6 +247,28 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* This describes a transfer queued with i2c_transfer_async().  Requests of
+ * higher priority are performed first; requests of the same priority in
+ * the order they were queued.  The callback receives the result of
+ * I2C_TRANSFER() and may not block.
+ */
+
+struct i2c_async_s;
+typedef CODE void (*i2c_async_callback_t)(FAR struct i2c_async_s *req,
+                                          int result);
+
+struct i2c_async_s
+{
+  FAR struct i2c_async_s *flink;  /* Used by the queue: Do not touch */
+  FAR struct i2c_msg_s *msgs;     /* The messages of the transfer */
+  int count;                      /* Number of messages */
+  uint8_t priority;               /* Higher values are served first */
+  i2c_async_callback_t callback;  /* Called when the transfer is done */
+  FAR void *arg;                  /* Argument for the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -356,6 +378,31 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer and return without waiting for it.  The queued
+ *   transfers of a bus are performed back-to-back on a work queue thread in
+ *   priority order.  With CONFIG_I2C_ASYNC_BATCH, transfers queued at the
+ *   same time are merged into a single I2C_TRANSFER() call.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - Describes the transfer.  The structure and the messages must
+ *         remain valid until the callback was called.
+ *
+ * Returned Value:
+ *   0: queued, <0: A negated errno.  The callback is not called if the
+ *   transfer could not be queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * include/nuttx/initstep.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_INITSTEP_H
+#define __INCLUDE_NUTTX_INITSTEP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_INITSTEPS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Maximum number of steps in one table passed to initstep_run() */
+
+#define INITSTEP_MAX      32
+
+/* Dependency on the step at index 'n' of the same table */
+
+#define INITSTEP_DEP(n)   ((uint32_t)1 << (n))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One initialization step.  A step is started only after every step named
+ * in 'deps' has returned successfully.  If one of them fails, the step is
+ * not run and fails with -ECANCELED.
+ */
+
+struct initstep_s
+{
+  FAR const char *name;      /* Name for the profile.  Must stay valid. */
+  CODE int (*func)(void);    /* Returns OK or a negated errno value */
+  uint32_t deps;             /* INITSTEP_DEP() of the steps it waits for */
+};
+
+/* Form in which the profile of one step is returned */
+
+struct initstep_info_s
+{
+  FAR const char *name;      /* Name of the step */
+  uint32_t start;            /* Start time in microseconds since boot */
+  uint32_t elapsed;          /* Duration in microseconds */
+  int16_t result;            /* Value returned by the step */
+  uint8_t thread;            /* Thread that ran it; 0 is the caller */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: initstep_run
+ *
+ * Description:
+ *   Run a table of initialization steps and return when all of them have
+ *   completed.  Steps whose dependencies are satisfied run concurrently on
+ *   the calling thread and on up to CONFIG_SCHED_INITSTEPS_NTHREADS kernel
+ *   threads, which exit before this function returns.  Tables are run one
+ *   at a time; a second caller waits for the first.  This must be called
+ *   from a thread that may block, such as board_late_initialize().
+ *
+ * Input Parameters:
+ *   steps  - The table of steps
+ *   nsteps - Number of steps in the table, at most INITSTEP_MAX
+ *
+ * Returned Value:
+ *   OK if every step succeeded; otherwise the result of the first step (in
+ *   table order) that failed.  A dependency cycle fails the steps in it
+ *   with -EDEADLK.
+ *
+ ****************************************************************************/
+
+int initstep_run(FAR const struct initstep_s *steps, int nsteps);
+
+/****************************************************************************
+ * Name: initstep_record
+ *
+ * Description:
+ *   Add a step that was run directly by the caller to the profile.
+ *
+ * Input Parameters:
+ *   name   - Name of the step.  Must stay valid.
+ *   start  - Value of initstep_now() taken before the step was run
+ *   result - Value returned by the step
+ *
+ ****************************************************************************/
+
+void initstep_record(FAR const char *name, uint32_t start, int result);
+
+/****************************************************************************
+ * Name: initstep_now
+ *
+ * Description:
+ *   Return the time since boot in microseconds, the time base of the
+ *   profile.
+ *
+ ****************************************************************************/
+
+uint32_t initstep_now(void);
+
+/****************************************************************************
+ * Name: initstep_info
+ *
+ * Description:
+ *   Return the profile of the recorded step at 'index', in the order in
+ *   which steps completed.
+ *
+ * Returned Value:
+ *   OK, or -ENOENT if fewer steps have been recorded.
+ *
+ ****************************************************************************/
+
+int initstep_info(int index, FAR struct initstep_info_s *info);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_INITSTEPS */
+#endif /* __INCLUDE_NUTTX_INITSTEP_H */
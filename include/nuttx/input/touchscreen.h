@@ -50,6 +50,9 @@
  ************************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/ioctl.h>
 
 #ifdef CONFIG_INPUT
@@ -147,6 +150,27 @@ struct touch_sample_s
 #define SIZEOF_TOUCH_SAMPLE_S(n) \
   (sizeof(struct touch_sample_s) + ((n) - 1) * sizeof(struct touch_point_s))
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/* A touchscreen lower half that uses the common upper half
+ * (drivers/input/touchscreen_upper.c) provides this structure to
+ * touch_register() and reports samples with touch_event().  The upper half
+ * implements open, close, read and poll; samples are kept in a lock-free
+ * ring, and queued motion of the same contacts is merged when read.
+ */
+
+struct touch_lowerhalf_s
+{
+  /* Used by the upper half; set by touch_register() */
+
+  FAR void *priv;
+
+  /* Handle the TSIOC_* and driver specific IOCTL commands.  May be NULL. */
+
+  CODE int (*control)(FAR struct touch_lowerhalf_s *lower, int cmd,
+                      unsigned long arg);
+};
+#endif
+
 /************************************************************************************
  * Public Function Prototypes
  ************************************************************************************/
@@ -159,6 +183,56 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/************************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Register a touchscreen lower half with the common upper half as the
+ *   character device 'path'.
+ *
+ * Input Parameters:
+ *   lower    - The lower half driver instance
+ *   path     - The device path, e.g. "/dev/input0"
+ *   nsamples - The number of samples the ring can hold; rounded up to a
+ *              power of two
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ************************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower, FAR const char *path,
+                   uint8_t nsamples);
+
+/************************************************************************************
+ * Name: touch_unregister
+ *
+ * Description:
+ *   Unregister a touchscreen device registered by touch_register().
+ *
+ ************************************************************************************/
+
+void touch_unregister(FAR struct touch_lowerhalf_s *lower,
+                      FAR const char *path);
+
+/************************************************************************************
+ * Name: touch_event
+ *
+ * Description:
+ *   Report a sample to the upper half.  This may be called from interrupt
+ *   handlers and work queues, but only from one context at a time.  At
+ *   most CONFIG_INPUT_TOUCHSCREEN_NPOINTS points of each sample are kept.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOSPC if the ring was full and the sample was lost.
+ *
+ ************************************************************************************/
+
+int touch_event(FAR struct touch_lowerhalf_s *lower,
+                FAR const struct touch_sample_s *sample);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
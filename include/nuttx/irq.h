@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+# include <sys/types.h>
 # include <stdint.h>
 # include <assert.h>
 #endif
@@ -64,6 +65,12 @@
 
 #  define irq_detach(irq) irq_attach(irq, NULL, NULL)
 
+/* Returned by the top half of a threaded interrupt handler to wake up the
+ * handler thread (see irq_attach_thread()).
+ */
+
+#  define IRQ_WAKE_THREAD 1
+
 /* Maximum/minimum values of IRQ integer types */
 
 #  if NR_IRQS <= 256
@@ -170,6 +177,157 @@ int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #  define irqchain_detach(irq, isr, arg) irq_detach(irq)
 #endif
 
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded interrupt handler to IRQ number 'irq'.  A kernel
+ *   thread named "irq<n>" is created at 'priority'.  When the interrupt
+ *   occurs, the top half 'isr' runs in interrupt context; if it returns
+ *   IRQ_WAKE_THREAD, 'isrthread' is then run on the thread with a NULL
+ *   context.  A NULL 'isr' wakes the thread on every interrupt.
+ *
+ *   The bottom half is thus scheduled by priority with the rest of the
+ *   system rather than in interrupt context or in FIFO order on the high
+ *   priority work queue.  The top half must quiet the interrupt source
+ *   (for a level triggered source) before it returns IRQ_WAKE_THREAD.
+ *   Wake-ups that arrive while the thread is already pending are merged,
+ *   so the bottom half must handle all of the pending work of the device.
+ *
+ *   As with irq_attach(), the caller must still enable the interrupt.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - The top half, or NULL
+ *   isrthread  - The bottom half, run on the handler thread
+ *   arg        - The argument passed to both handlers
+ *   priority   - The priority of the handler thread
+ *   stack_size - The stack size of the handler thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQTHREAD
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size);
+
+/****************************************************************************
+ * Name: irq_detach_thread
+ *
+ * Description:
+ *   Detach a threaded interrupt handler attached with irq_attach_thread()
+ *   and terminate its handler thread.
+ *
+ * Input Parameters:
+ *   irq - The IRQ number
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if no threaded handler is attached.
+ *
+ ****************************************************************************/
+
+int irq_detach_thread(int irq);
+#endif
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset'.  If the IRQ has a
+ *   threaded handler (see irq_attach_thread()), the handler thread is
+ *   bound to the same CPUs.
+ *
+ * Input Parameters:
+ *   irq    - The IRQ number
+ *   cpuset - The set of CPUs that may take the interrupt
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if 'irq' or 'cpuset' is not valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+int irq_set_affinity(int irq, cpu_set_t cpuset);
+
+/****************************************************************************
+ * Name: irq_get_affinity
+ *
+ * Description:
+ *   Return the set of CPUs that IRQ number 'irq' is routed to.
+ *
+ ****************************************************************************/
+
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset);
+
+/****************************************************************************
+ * Name: irq_get_cpu
+ *
+ * Description:
+ *   Return the lowest numbered CPU that IRQ number 'irq' is routed to.
+ *   Drivers use this to queue their bottom half work on the CPU that
+ *   takes the interrupt (see work_queue_cpu()).
+ *
+ ****************************************************************************/
+
+int irq_get_cpu(int irq);
+#else
+#  define irq_get_cpu(irq) 0
+#endif
+
+/****************************************************************************
+ * Name: local_irq_save
+ *
+ * Description:
+ *   Disable interrupts on the current CPU only and return the previous
+ *   interrupt state.  Unlike enter_critical_section(), this never takes
+ *   the global g_cpu_irqlock and so never serializes the other CPUs.
+ *
+ *   This is sufficient to protect:
+ *
+ *   - Per-CPU data that is only accessed from the CPU that owns it, from
+ *     both thread and interrupt level (for example, per-CPU statistics or
+ *     per-CPU free lists), and
+ *   - Short sequences that must not migrate to another CPU, such as
+ *     reading this_cpu() and then using the result.
+ *
+ *   Data that other CPUs may access needs either enter_critical_section()
+ *   or local_irq_save() combined with a spinlock protecting that data.
+ *   Logic that may block or that touches scheduler state must always use
+ *   enter_critical_section().
+ *
+ *   In a non-SMP configuration this is equivalent to
+ *   enter_critical_section().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to local_irq_save();
+ *
+ ****************************************************************************/
+
+#define local_irq_save()     up_irq_save()
+
+/****************************************************************************
+ * Name: local_irq_restore
+ *
+ * Description:
+ *   Restore the interrupt state of the current CPU saved by
+ *   local_irq_save().
+ *
+ * Input Parameters:
+ *   flags - The value returned by the matching local_irq_save().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#define local_irq_restore(f) up_irq_restore(f)
+
 /****************************************************************************
  * Name: enter_critical_section
  *
@@ -109,6 +109,16 @@ extern "C"
 
 #endif
 
+/* Without region heaps, memory for any region comes from the kernel heap */
+
+#ifndef CONFIG_MM_REGION_HEAPS
+#  define kmm_malloc_region(r,s)     kmm_malloc(s)
+#  define kmm_zalloc_region(r,s)     kmm_zalloc(s)
+#  define kmm_memalign_region(r,a,s) kmm_memalign(a,s)
+#  define kmm_free_region(p)         kmm_free(p)
+#  define kmm_regionmember(p)        false
+#endif
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 /****************************************************************************
  * Group memory management
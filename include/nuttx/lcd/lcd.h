@@ -115,6 +115,25 @@ struct lcd_planeinfo_s
    */
 
   uint8_t  bpp;
+
+  /* This optional method can be used to write a rectangular area to the LCD
+   * with one transfer instead of one putrun() call per row.  Drivers that
+   * can set the display address window once and stream the whole area
+   * (typically with an SPI block transfer that the SPI driver may perform
+   * with DMA) should provide it; otherwise it is NULL.
+   *
+   *  row_start - Starting row to write to (range: 0 <= row < yres)
+   *  row_end   - Ending row to write to (range: row_start <= row < yres)
+   *  col_start - Starting column to write to (range: 0 <= col < xres)
+   *  col_end   - Ending column to write to
+   *              (range: col_start <= col_end < xres)
+   *  buffer    - The first pixel of the area in the caller's memory
+   *  stride    - The distance in bytes between two rows in the buffer
+   */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, size_t stride);
 };
 
 /* This structure defines an LCD interface */
@@ -84,10 +84,12 @@ void lib_stream_release(FAR struct task_group_s *group);
 #ifdef CONFIG_STDIO_DISABLE_BUFFERING
 #  define lib_sem_initialize(s)
 #  define lib_take_semaphore(s)
+#  define lib_trytake_semaphore(s) (OK)
 #  define lib_give_semaphore(s)
 #else
 void lib_sem_initialize(FAR struct file_struct *stream);
 void lib_take_semaphore(FAR struct file_struct *stream);
+int lib_trytake_semaphore(FAR struct file_struct *stream);
 void lib_give_semaphore(FAR struct file_struct *stream);
 #endif
 
@@ -243,6 +243,9 @@ long double expl  (long double x);
 #define expm1l(x) (expl(x) - 1.0)
 #endif
 
+float       __cosf(float x);
+float       __sinf(float x);
+int         __rem_pio2f(float x, FAR float *y);
 #ifdef CONFIG_HAVE_DOUBLE
 double      __cos(double x, double y);
 double      __sin(double x, double y, int iy);
@@ -172,6 +172,9 @@ struct module_s
   mod_initializer_t initializer;       /* Module initializer function */
 #endif
   struct mod_info_s modinfo;           /* Module information */
+#ifdef CONFIG_SYMTAB_HASH
+  struct symtab_hash_s exphash;        /* Hash index over modinfo.exports */
+#endif
 #if defined(CONFIG_ARCH_USE_MODULE_TEXT)
   FAR void *textalloc;                 /* Allocated kernel text memory */
   FAR void *dataalloc;                 /* Allocated kernel memory */
@@ -296,6 +299,43 @@ void modlib_getsymtab(FAR const struct symtab_s **symtab, FAR int *nsymbols);
 
 void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols);
 
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol exported by the base code symbol table.  With
+ *   CONFIG_SYMTAB_HASH the lookup goes through a hash index that is built
+ *   on first use.
+ *
+ * Input Parameters:
+ *   name - The symbol name.
+ *
+ * Returned Value:
+ *   The symbol table entry or NULL if it is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name);
+
+/****************************************************************************
+ * Name: modlib_modsymbol
+ *
+ * Description:
+ *   Find a symbol exported by the loaded module 'modp'.  The caller must
+ *   hold the registry lock.
+ *
+ * Input Parameters:
+ *   modp - The module.
+ *   name - The symbol name.
+ *
+ * Returned Value:
+ *   The symbol table entry or NULL if it is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_modsymbol(FAR struct module_s *modp,
+                                            FAR const char *name);
+
 /****************************************************************************
  * Name: modlib_load
  *
@@ -0,0 +1,151 @@
+/****************************************************************************
+ * include/nuttx/mm/dma.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_DMA_H
+#define __INCLUDE_NUTTX_MM_DMA_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Memory that a DMA transfer reads or writes must not share a D-Cache line
+ * with anything else: invalidating the line after a transfer would discard
+ * a CPU write to its other bytes, and cleaning it during a transfer would
+ * overwrite the received data.  DMA buffers are therefore aligned to, and
+ * sized in multiples of, the D-Cache line size.
+ */
+
+#if defined(CONFIG_ARCH_DCACHE) && CONFIG_ARCH_DCACHE_LINESIZE > 8
+#  define DMA_ALIGNMENT      CONFIG_ARCH_DCACHE_LINESIZE
+#else
+#  define DMA_ALIGNMENT      8
+#endif
+
+#define DMA_ALIGN_MASK       (DMA_ALIGNMENT - 1)
+#define DMA_ROUNDUP(n)       (((n) + DMA_ALIGN_MASK) & ~DMA_ALIGN_MASK)
+#define DMA_ALIGNED(p, n)    ((((uintptr_t)(p) | (n)) & DMA_ALIGN_MASK) == 0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One entry of a scatter list: a memory range taking part in a DMA
+ * transfer.
+ */
+
+struct dma_sg_s
+{
+  FAR void *addr;            /* Start of the range */
+  size_t    len;             /* Length of the range in bytes */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kmm_dma_alloc / kmm_dma_zalloc
+ *
+ * Description:
+ *   Allocate a DMA-safe buffer: aligned to DMA_ALIGNMENT, with the size
+ *   rounded up to a multiple of DMA_ALIGNMENT, and taken from the DMA
+ *   capable region heap (MM_REGION_DMA) when one is registered.  Otherwise
+ *   the buffer comes from the kernel heap.
+ *
+ * Input Parameters:
+ *   size - The number of bytes needed
+ *
+ * Returned Value:
+ *   The buffer, or NULL if no memory is available.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_dma_alloc(size_t size);
+FAR void *kmm_dma_zalloc(size_t size);
+
+/****************************************************************************
+ * Name: kmm_dma_free
+ *
+ * Description:
+ *   Free a buffer allocated with kmm_dma_alloc() or kmm_dma_zalloc().
+ *
+ ****************************************************************************/
+
+void kmm_dma_free(FAR void *mem);
+
+/****************************************************************************
+ * Name: dma_clean_sg / dma_invalidate_sg / dma_flush_sg
+ *
+ * Description:
+ *   Perform D-Cache maintenance on all ranges of a scatter list in one
+ *   call.  Ranges that overlap or touch each other are merged, so a list
+ *   of consecutive buffers or descriptors costs one pass over its cache
+ *   lines.  If the total exceeds CONFIG_ARCH_DCACHE_ALL_THRESHOLD, the
+ *   whole D-Cache is cleaned or flushed instead, which is faster than
+ *   walking a large range line by line.
+ *
+ *   - dma_clean_sg() before the DMA reads from memory.
+ *   - dma_invalidate_sg() before and after the DMA writes to memory.  The
+ *     partial cache lines at the edges of a misaligned range are flushed
+ *     instead of invalidated, so the neighbouring data survives.
+ *   - dma_flush_sg() for memory that is both read and written.
+ *
+ *   The scatter list is not modified.
+ *
+ * Input Parameters:
+ *   sg  - The scatter list
+ *   nsg - The number of entries in the list
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void dma_clean_sg(FAR const struct dma_sg_s *sg, int nsg);
+void dma_invalidate_sg(FAR const struct dma_sg_s *sg, int nsg);
+void dma_flush_sg(FAR const struct dma_sg_s *sg, int nsg);
+#else
+#  define dma_clean_sg(sg, nsg)      ((void)(sg), (void)(nsg))
+#  define dma_invalidate_sg(sg, nsg) ((void)(sg), (void)(nsg))
+#  define dma_flush_sg(sg, nsg)      ((void)(sg), (void)(nsg))
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MM_DMA_H */
@@ -124,10 +124,6 @@ extern "C"
  *   The actual memory allocates will be 64 byte (wasting 17 bytes) and
  *   will be aligned at least to (1 << log2align).
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   heapstart - Start of the granule allocation heap
  *   heapsize  - Size of heap in bytes
@@ -196,10 +192,6 @@ void gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size);
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
  *   size   - The size of the memory region to allocate.
@@ -212,6 +204,27 @@ void gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size);
 
 FAR void *gran_alloc(GRAN_HANDLE handle, size_t size);
 
+/****************************************************************************
+ * Name: gran_memalign
+ *
+ * Description:
+ *   Allocate memory from the granule heap that starts at a multiple of
+ *   'alignment'.  gran_alloc() is gran_memalign() with no alignment.
+ *
+ * Input Parameters:
+ *   handle    - The handle previously returned by gran_initialize
+ *   alignment - Power of two alignment in bytes.  Values up to the granule
+ *               size just give the alignment of gran_initialize().
+ *   size      - The size of the memory region to allocate.
+ *
+ * Returned Value:
+ *   On success, a non-NULL pointer to the allocated memory is returned;
+ *   NULL is returned on failure.
+ *
+ ****************************************************************************/
+
+FAR void *gran_memalign(GRAN_HANDLE handle, size_t alignment, size_t size);
+
 /****************************************************************************
  * Name: gran_free
  *
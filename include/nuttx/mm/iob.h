@@ -49,6 +49,10 @@
 #  include <nuttx/wqueue.h>
 #endif
 
+#ifdef CONFIG_IOB_DMA
+#  include <nuttx/mm/dma.h>
+#endif
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
@@ -85,10 +89,45 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* An optional second pool of large I/O buffers.  Zero disables the
+ * large pool.
+ */
+
+#if !defined(CONFIG_IOB_LARGE_NBUFFERS)
+#  define CONFIG_IOB_LARGE_NBUFFERS 0
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  if !defined(CONFIG_IOB_LARGE_BUFSIZE)
+#    error CONFIG_IOB_LARGE_BUFSIZE not defined
+#  endif
+#  if CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#  endif
+#endif
+
+/* Per-CPU I/O buffer caches.  Zero disables the caches. */
+
+#if !defined(CONFIG_IOB_PERCPU_CACHE)
+#  define CONFIG_IOB_PERCPU_CACHE 0
+#endif
+
+#ifdef CONFIG_SMP
+#  define IOB_NCACHES CONFIG_SMP_NCPUS
+#else
+#  define IOB_NCACHES 1
+#endif
+
 /* IOB helpers */
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -114,7 +153,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && CONFIG_IOB_LARGE_NBUFFERS == 0
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -123,7 +162,16 @@ struct iob_s
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* With more than one buffer size, the payload is stored separately */
+
+  uint16_t io_bufsize;  /* Size of the payload buffer */
+  FAR uint8_t *io_data;
+#elif defined(CONFIG_IOB_DMA)
+  uint8_t  io_data[CONFIG_IOB_BUFSIZE] aligned_data(DMA_ALIGNMENT);
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -203,6 +251,9 @@ enum iob_user_e
 #ifdef CONFIG_NET_IPFORWARD
   IOBUSER_NET_IPFORWARD,
 #endif
+#ifdef CONFIG_NETDEV_TXQUEUE
+  IOBUSER_NET_TXQUEUE,
+#endif
 #ifdef CONFIG_WIRELESS_IEEE802154
   IOBUSER_WIRELESS_RAD802154,
 #endif
@@ -234,6 +285,16 @@ struct iob_userstats_s
   int totalproduced;
 };
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* Per-CPU I/O buffer cache statistics */
+
+struct iob_cachestats_s
+{
+  uint32_t hits;                   /* Allocations served from the cache */
+  uint32_t misses;                 /* Allocations that had to refill */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -270,6 +331,29 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid);
 
 FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid);
 
+/****************************************************************************
+ * Name: iob_alloc_len and iob_tryalloc_len
+ *
+ * Description:
+ *   Allocate an I/O buffer that best fits a payload of 'len' bytes.  If
+ *   'len' does not fit into a normal I/O buffer and a large I/O buffer is
+ *   free, a large buffer is returned.  Otherwise these behave exactly like
+ *   iob_alloc() and iob_tryalloc().  The large pool is never waited for.
+ *
+ *   Use IOB_BUFSIZE() to get the capacity of the returned buffer.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+FAR struct iob_s *iob_alloc_len(unsigned int len, bool throttled,
+                                enum iob_user_e consumerid);
+FAR struct iob_s *iob_tryalloc_len(unsigned int len, bool throttled,
+                                   enum iob_user_e consumerid);
+#else
+#  define iob_alloc_len(l,t,c)    iob_alloc(t,c)
+#  define iob_tryalloc_len(l,t,c) iob_tryalloc(t,c)
+#endif
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -607,5 +691,24 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 FAR struct iob_userstats_s * iob_getuserstats(enum iob_user_e userid);
 #endif
 
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return a reference to the statistics of the per-CPU I/O buffer cache
+ *   of one CPU.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU whose cache is queried
+ *
+ * Returned Value:
+ *   A reference to the cache statistics.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+FAR struct iob_cachestats_s *iob_getcachestats(int cpu);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* _INCLUDE_NUTTX_MM_IOB_H */
@@ -30,7 +30,11 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
-#include <semaphore.h>
+#include <nuttx/mutex.h>
+
+#if defined(CONFIG_MM_FASTBINS) && defined(CONFIG_SMP)
+#  include <nuttx/spinlock.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -94,6 +98,12 @@
 #  undef CONFIG_MM_KERNEL_HEAP
 #endif
 
+/* Neither are the region heaps, except in the FLAT build */
+
+#if !defined(CONFIG_BUILD_FLAT) && !defined(__KERNEL__)
+#  undef CONFIG_MM_REGION_HEAPS
+#endif
+
 /* Chunk Header Definitions *************************************************/
 
 /* These definitions define the characteristics of allocator
@@ -145,7 +155,27 @@
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
-#define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+
+/* The free lists.  Normally there is one list per power of two, kept
+ * sorted by size.  With CONFIG_MM_TLSF (two-level segregated fit) each
+ * power of two range is split further into MM_SLI_COUNT unsorted lists of
+ * equal width, and bitmaps of the non-empty lists are kept so that a
+ * large enough chunk is found in constant time.  MM_NDX2SIZE() is the
+ * smallest chunk size kept in a list.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  define MM_SLI_SHIFT   CONFIG_MM_TLSF_SLI_SHIFT
+#  define MM_SLI_COUNT   (1 << MM_SLI_SHIFT)
+#  define MM_FLI_COUNT   (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#  define MM_NNODES      (MM_FLI_COUNT << MM_SLI_SHIFT)
+#  define MM_NDX2SIZE(n) \
+     (((size_t)MM_SLI_COUNT + ((n) & (MM_SLI_COUNT - 1))) << \
+      (((n) >> MM_SLI_SHIFT) + MM_MIN_SHIFT - MM_SLI_SHIFT))
+#else
+#  define MM_NNODES      (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#  define MM_NDX2SIZE(n) ((size_t)1 << ((n) + MM_MIN_SHIFT))
+#endif
 
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
@@ -163,6 +193,30 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0)
 
+/* Fast bins can only be used where interrupts may be disabled, i.e., not
+ * from the user-space heap of the PROTECTED and KERNEL builds.
+ */
+
+#undef MM_USE_FASTBINS
+#if defined(CONFIG_MM_FASTBINS) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_USE_FASTBINS 1
+#endif
+
+#ifdef CONFIG_SMP
+#  define MM_FASTBIN_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define MM_FASTBIN_NCPUS 1
+#endif
+
+/* Attributes of the region heaps, see kmm_region_add().  An allocation
+ * asking for several attributes is served by a heap having all of them.
+ */
+
+#define MM_REGION_FAST   (1 << 0) /* Tightly-coupled or fast internal RAM */
+#define MM_REGION_DMA    (1 << 1) /* Accessible by the DMA controllers */
+#define MM_REGION_LARGE  (1 << 2) /* Large, typically external RAM */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -186,11 +240,19 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_TRACE
+  pid_t pid;               /* Thread that allocated the chunk */
+  FAR void *caller;        /* Where it was allocated, NULL if cached */
+#endif
 };
 
-/* What is the size of the allocnode? */
+/* What is the size of the allocnode?  With CONFIG_MM_TRACE, a free node
+ * reuses the space of the tag for its links, so only the allocnode grows.
+ */
 
-#ifdef CONFIG_MM_SMALL
+#if defined(CONFIG_MM_TRACE)
+# define SIZEOF_MM_ALLOCNODE   sizeof(struct mm_allocnode_s)
+#elif defined(CONFIG_MM_SMALL)
 # define SIZEOF_MM_ALLOCNODE   B2C(4)
 #else
 # define SIZEOF_MM_ALLOCNODE   B2C(8)
@@ -214,6 +276,22 @@ struct mm_delaynode_s
   struct mm_delaynode_s *flink;
 };
 
+#ifdef CONFIG_MM_FASTBINS
+/* This describes the fast bins of one CPU.  Each bin is a singly linked
+ * list of allocated chunks of one exact size, linked through the first
+ * word of the user data.
+ */
+
+struct mm_fastbin_s
+{
+#ifdef CONFIG_SMP
+  spinlock_t fb_lock;      /* Only contended by mm_fastbin_flush() */
+#endif
+  FAR struct mm_delaynode_s *fb_head[CONFIG_MM_FASTBIN_NCLASSES];
+  uint8_t fb_count[CONFIG_MM_FASTBIN_NCLASSES];
+};
+#endif
+
 /* What is the size of the freenode? */
 
 #define MM_PTR_SIZE sizeof(FAR struct mm_freenode_s *)
@@ -222,15 +300,44 @@ struct mm_delaynode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_TRACE
+/* Live allocations of one call site and thread, see mm_traceinfo() */
+
+struct mm_tracecaller_s
+{
+  FAR void *caller;        /* Address of the allocating call */
+  pid_t pid;               /* Thread that allocated */
+  size_t count;            /* Number of live chunks */
+  size_t size;             /* Total size of the chunks */
+};
+
+/* Snapshot of a heap returned by mm_traceinfo().  callers and ncallers
+ * are provided by the caller.
+ */
+
+struct mm_traceinfo_s
+{
+  FAR struct mm_tracecaller_s *callers;
+  int ncallers;            /* Size of callers[] */
+  int nused;               /* Used entries of callers[], not sorted */
+  size_t nother;           /* Chunks that did not fit in callers[] */
+  size_t sother;
+  size_t ncached;          /* Chunks held by the fast bins */
+  size_t scached;
+  size_t nfree[MM_NNODES]; /* Free chunks per mm_nodelist bin */
+  size_t sfree[MM_NNODES];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
 {
   /* Mutually exclusive access to this data set is enforced with
-   * the following un-named semaphore.
+   * the following mutex.
    */
 
-  sem_t mm_semaphore;
+  mutex_t mm_lock;
   pid_t mm_holder;
   int mm_counts_held;
 
@@ -249,14 +356,30 @@ struct mm_heap_s
 
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
-   * speed searches for free nodes.
+   * speed searches for free nodes.  With CONFIG_MM_TLSF, each entry is
+   * instead the head of a separate list.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
 
+#ifdef CONFIG_MM_TLSF
+  /* Bit n of mm_slbitmap[f] is set if list (f << MM_SLI_SHIFT) + n is not
+   * empty, bit f of mm_flbitmap if mm_slbitmap[f] is not zero.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_FLI_COUNT];
+#endif
+
   /* Free delay list, for some situation can't do free immdiately */
 
   struct mm_delaynode_s *mm_delaylist;
+
+#ifdef CONFIG_MM_FASTBINS
+  /* Per-CPU caches of recently freed small chunks */
+
+  struct mm_fastbin_s mm_fastbin[MM_FASTBIN_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -357,6 +480,22 @@ int  kmm_trysemaphore(void);
 void kmm_givesemaphore(void);
 #endif
 
+/* Functions contained in mm_trace.c ****************************************/
+
+#ifdef CONFIG_MM_TRACE
+FAR void *mm_trace(FAR void *mem, FAR void *caller);
+int mm_traceinfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_traceinfo_s *info);
+
+/* Tag the chunk with the return address of the function using the macro,
+ * i.e. the code calling the allocator.
+ */
+
+#  define MM_TRACE(mem) mm_trace(mem, __builtin_return_address(0))
+#else
+#  define MM_TRACE(mem) (mem)
+#endif
+
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
@@ -370,6 +509,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_free_uncached(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -433,6 +573,17 @@ bool umm_heapmember(FAR void *mem);
 bool kmm_heapmember(FAR void *mem);
 #endif
 
+/* Functions contained in kmm_region.c **************************************/
+
+#ifdef CONFIG_MM_REGION_HEAPS
+int kmm_region_add(uint8_t attr, FAR void *heapstart, size_t heapsize);
+FAR void *kmm_malloc_region(uint8_t attr, size_t size);
+FAR void *kmm_zalloc_region(uint8_t attr, size_t size);
+FAR void *kmm_memalign_region(uint8_t attr, size_t alignment, size_t size);
+void kmm_free_region(FAR void *mem);
+bool kmm_regionmember(FAR void *mem);
+#endif
+
 /* Functions contained in mm_brkaddr.c **************************************/
 
 FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region);
@@ -496,10 +647,24 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
 
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
+#ifdef CONFIG_MM_TLSF
+int mm_findndx(FAR struct mm_heap_s *heap, size_t size);
+#endif
+
+/* Functions contained in mm_fastbin.c **************************************/
+
+#ifdef MM_USE_FASTBINS
+FAR void *mm_fastbin_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_fastbin_free(FAR struct mm_heap_s *heap, FAR void *mem);
+size_t mm_fastbin_flush(FAR struct mm_heap_s *heap);
+size_t mm_fastbin_cached(FAR struct mm_heap_s *heap);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
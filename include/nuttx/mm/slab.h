@@ -0,0 +1,151 @@
+/****************************************************************************
+ * include/nuttx/mm/slab.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_SLAB_H
+#define __INCLUDE_NUTTX_MM_SLAB_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An object cache.  The structure is private to mm/slab. */
+
+struct kmem_cache_s;
+
+/* Form in which the state of an object cache is returned */
+
+struct kmem_cacheinfo_s
+{
+  FAR const char *name;    /* Name given to kmem_cache_create() */
+  size_t objsize;          /* Size of one object (rounded up) */
+  size_t nslabs;           /* Slabs allocated from the kernel heap */
+  size_t ntotal;           /* Objects in all slabs */
+  size_t nfree;            /* Objects in the shared free list */
+  size_t ncached;          /* Objects in the per-CPU magazines */
+  uint32_t nallocs;        /* Successful allocations */
+  uint32_t nhits;          /* Allocations served from a magazine */
+  uint32_t nfails;         /* Failed allocations */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of one size.  Objects are carved from slabs
+ *   of 'nperslab' objects that are allocated from the kernel heap on
+ *   demand and never returned to it; freed objects are kept in a magazine
+ *   of the freeing CPU or in a free list shared by all CPUs.  Allocation
+ *   and release from the magazine only disable local interrupts.
+ *
+ * Input Parameters:
+ *   name     - Name of the cache for /proc/slabinfo.  Must stay valid.
+ *   size     - Size of one object
+ *   nperslab - Number of objects per slab
+ *
+ * Returned Value:
+ *   The new cache or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size,
+                                           unsigned int nperslab);
+
+/****************************************************************************
+ * Name: kmem_cache_alloc and kmem_cache_zalloc
+ *
+ * Description:
+ *   Allocate one object, uninitialized or zeroed.  From interrupt level,
+ *   objects can only be taken from the magazines and the shared free list;
+ *   no new slab is allocated.
+ *
+ * Returned Value:
+ *   The object or NULL if none is available.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache);
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Return an object obtained from kmem_cache_alloc() on the same cache.
+ *   This may be called from interrupt level.
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj);
+
+/****************************************************************************
+ * Name: kmem_cache_info
+ *
+ * Description:
+ *   Return the state of a cache.  The counts are sampled without locking
+ *   and are only approximate while other CPUs use the cache.
+ *
+ ****************************************************************************/
+
+void kmem_cache_info(FAR struct kmem_cache_s *cache,
+                     FAR struct kmem_cacheinfo_s *info);
+
+/****************************************************************************
+ * Name: kmem_cache_next
+ *
+ * Description:
+ *   Enumerate the caches:  Return the cache created before 'cache', or
+ *   the most recently created cache if 'cache' is NULL.  NULL is returned
+ *   after the last cache.  Caches are never destroyed.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_next(FAR struct kmem_cache_s *cache);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_SLAB */
+#endif /* __INCLUDE_NUTTX_MM_SLAB_H */
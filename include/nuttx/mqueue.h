@@ -48,6 +48,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <mqueue.h>
 #include <queue.h>
 
@@ -104,6 +105,11 @@ struct mqueue_inode_s
 {
   FAR struct inode *inode;    /* Containing inode */
   sq_queue_t msglist;         /* Prioritized message list */
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  FAR sq_entry_t *priotail[_POSIX_MQ_PRIO_MAX + 1]; /* Last message of each
+                                                     * priority in msglist */
+  uint32_t priomap[(_POSIX_MQ_PRIO_MAX + 32) / 32]; /* Priorities present */
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
   int16_t nwaitnotfull;       /* Number tasks waiting for not full */
@@ -382,6 +388,91 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                           FAR unsigned int *prio,
                           FAR const struct timespec *abstime);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: nxmq_alloc_buffer
+ *
+ * Description:
+ *   Take a message from the message pool and return its payload buffer so
+ *   that the caller can build the message in place.  The buffer holds up to
+ *   CONFIG_MQ_MAXMSGSIZE bytes.  It must be passed to nxmq_send_buffer() or
+ *   released with nxmq_free_buffer().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The payload buffer or NULL if no message is available.
+ *
+ ****************************************************************************/
+
+FAR char *nxmq_alloc_buffer(void);
+
+/****************************************************************************
+ * Name: nxmq_free_buffer
+ *
+ * Description:
+ *   Return a buffer from nxmq_alloc_buffer() or nxmq_receive_buffer() to
+ *   the message pool.
+ *
+ * Input Parameters:
+ *   buffer - The payload buffer to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_free_buffer(FAR char *buffer);
+
+/****************************************************************************
+ * Name: nxmq_send_buffer
+ *
+ * Description:
+ *   Queue a buffer from nxmq_alloc_buffer() by reference.  This behaves
+ *   like nxmq_send() except that the payload is not copied.  On success
+ *   the buffer belongs to the message queue; on failure it still belongs
+ *   to the caller.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - Payload buffer from nxmq_alloc_buffer()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see nxmq_send()).
+ *
+ ****************************************************************************/
+
+int nxmq_send_buffer(mqd_t mqdes, FAR char *buffer, size_t msglen,
+                     unsigned int prio);
+
+/****************************************************************************
+ * Name: nxmq_receive_buffer
+ *
+ * Description:
+ *   Dequeue the oldest of the highest priority messages by reference.  This
+ *   behaves like nxmq_receive() except that the payload is not copied:
+ *   *buffer is set to the message itself, which the caller must release
+ *   with nxmq_free_buffer() (or send on with nxmq_send_buffer()).
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The location to return the payload buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message on success.  A negated errno value is
+ *   returned on failure (see nxmq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_buffer(mqd_t mqdes, FAR char **buffer,
+                            FAR unsigned int *prio);
+#endif
+
 /****************************************************************************
  * Name: nxmq_free_msgq
  *
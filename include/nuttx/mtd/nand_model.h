@@ -71,6 +71,11 @@
 #define NANDMODEL_DATAWIDTH16 (1 << 0)  /* NAND uses a 16-bit databus */
 #define NANDMODEL_COPYBACK    (1 << 1)  /* NAND supports the copy-back function
                                          * (internal page-to-page copy) */
+#define NANDMODEL_CACHEREAD   (1 << 2)  /* NAND supports read cache (31h/3Fh) */
+#define NANDMODEL_CACHEPROGRAM (1 << 3) /* NAND supports page cache program
+                                         * (15h) */
+#define NANDMODEL_MULTIPLANE  (1 << 4)  /* NAND supports multi-plane program,
+                                         * erase and read */
 
 /****************************************************************************
  * Public Types
@@ -90,6 +95,8 @@ struct nand_model_s
   /* Spare area placement scheme */
 
   FAR const struct nand_scheme_s *scheme;
+
+  uint8_t  planebits;     /* Log2 of the number of planes (ONFI only) */
 };
 
 /****************************************************************************
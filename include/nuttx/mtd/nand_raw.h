@@ -77,6 +77,14 @@
 #define COMMAND_STATUS                  0x70
 #define COMMAND_RESET                   0xff
 
+/* Nand flash cache and multi-plane commands (ONFI optional commands) */
+
+#define COMMAND_READ_CACHE_SEQ          0x31  /* Read cache sequential */
+#define COMMAND_READ_CACHE_END          0x3f  /* Read cache end */
+#define COMMAND_READ_MULTIPLANE         0x32  /* Read multi-plane (queue plane) */
+#define COMMAND_WRITE_CACHE             0x15  /* Page cache program */
+#define COMMAND_WRITE_MULTIPLANE        0x11  /* Program multi-plane (queue plane) */
+
 /* Nand flash commands (small blocks) */
 
 #define COMMAND_READ_A                  0x00
@@ -232,10 +240,95 @@
 #  define NAND_WRITEPAGE(r,b,p,d,s) ((r)->rawwrite(r,b,p,d,s))
 #endif
 
+/****************************************************************************
+ * Name: NAND_READPAGES
+ *
+ * Description:
+ *   Reads the data areas of 'npages' consecutive pages of one block, with
+ *   the same ECC handling as NAND_READPAGE.  The lower half should use read
+ *   cache (31h/3Fh) and/or multi-plane reads when the model reports
+ *   NANDMODEL_CACHEREAD or NANDMODEL_MULTIPLANE.  This method is optional;
+ *   if it is NULL, pages are read one at a time.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read; page + npages does not cross the end
+ *            of the block.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  define NAND_READPAGES(r,b,p,n,d) ((r)->readpages(r,b,p,n,d))
+#endif
+
+/****************************************************************************
+ * Name: NAND_WRITEPAGES
+ *
+ * Description:
+ *   Writes the data areas of 'npages' consecutive pages of one block, with
+ *   the same ECC handling as NAND_WRITEPAGE.  The lower half should use page
+ *   cache program (15h) and/or multi-plane programming when the model
+ *   reports NANDMODEL_CACHEPROGRAM or NANDMODEL_MULTIPLANE.  This method is
+ *   optional; if it is NULL, pages are written one at a time.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write; page + npages does not cross the end
+ *            of the block.
+ *   data   - Buffer containing the data to be written
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  define NAND_WRITEPAGES(r,b,p,n,d) ((r)->writepages(r,b,p,n,d))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* A controller ECC engine (e.g., a BCH accelerator) used by the common,
+ * upper-half ECC logic in place of the software Hamming code when the
+ * ecctype is NANDECC_SWECC.  The page data area is split into steps of
+ * 'stepsize' bytes, each protected by 'eccbytes' bytes of ECC.  The ECC of
+ * all steps is stored consecutively at the ECC positions of the spare area
+ * scheme.
+ */
+
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+struct nand_raw_s;
+struct nand_eccengine_s
+{
+  uint16_t stepsize;  /* Bytes of data per ECC step */
+  uint8_t  eccbytes;  /* Bytes of ECC per step */
+  uint8_t  strength;  /* Number of correctable bit errors per step */
+
+  /* Compute the ECC of one step of data */
+
+  CODE int (*calculate)(FAR struct nand_raw_s *raw,
+                        FAR const uint8_t *data, FAR uint8_t *ecc);
+
+  /* Check one step of data against the ECC read from the spare area and
+   * correct it in place.  Returns the number of corrected bit errors, or a
+   * negated errno value (-EBADMSG) if the data cannot be corrected.
+   */
+
+  CODE int (*correct)(FAR struct nand_raw_s *raw, FAR uint8_t *data,
+                      FAR const uint8_t *ecc);
+};
+#endif
+
 /* This type represents the visible portion of the lower-half, raw NAND MTD
  * device.  The lower-half driver may freely append additional information
  * after this required header information.
@@ -268,6 +361,21 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  CODE int (*readpages)(FAR struct nand_raw_s *raw, off_t block,
+                        unsigned int page, unsigned int npages,
+                        FAR void *data);
+  CODE int (*writepages)(FAR struct nand_raw_s *raw, off_t block,
+                         unsigned int page, unsigned int npages,
+                         FAR const void *data);
+#endif
+
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+  /* Optional controller ECC engine (NULL: software Hamming ECC) */
+
+  FAR const struct nand_eccengine_s *eccengine;
+#endif
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers*/
 
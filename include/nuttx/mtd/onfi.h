@@ -60,6 +60,20 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Features supported (parameter page bytes 6-7) */
+
+#define ONFI_FEATURE_BUSWIDTH16  (1 << 0)  /* 16-bit data bus */
+#define ONFI_FEATURE_MULTILUN    (1 << 1)  /* Multiple LUN operations */
+#define ONFI_FEATURE_MULTIPLANE  (1 << 3)  /* Multi-plane program and erase */
+#define ONFI_FEATURE_MPREAD      (1 << 7)  /* Multi-plane read (ONFI 2.x) */
+
+/* Optional commands supported (parameter page bytes 8-9) */
+
+#define ONFI_OPTCMD_CACHEPROGRAM (1 << 0)  /* Page cache program (15h) */
+#define ONFI_OPTCMD_CACHEREAD    (1 << 1)  /* Read cache (31h/3Fh) */
+#define ONFI_OPTCMD_FEATURES     (1 << 2)  /* Get/Set features */
+#define ONFI_OPTCMD_COPYBACK     (1 << 4)  /* Copyback */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -73,6 +87,9 @@ struct onfi_pgparam_s
   uint8_t luns;           /* Number of logical units */
   uint8_t eccsize;        /* Number of bits of ECC correction */
   uint8_t model;          /* Device model */
+  uint8_t planebits;      /* Number of plane (interleave) address bits */
+  uint16_t features;      /* Features supported, see ONFI_FEATURE_* */
+  uint16_t optcmds;       /* Optional commands supported, see ONFI_OPTCMD_* */
   uint16_t sparesize;     /* Number of spare bytes per page */
   uint16_t pagesperblock; /* Number of pages per block */
   uint16_t blocksperlun;  /* Number of blocks per logical unit (LUN) */
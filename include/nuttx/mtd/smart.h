@@ -97,6 +97,22 @@ struct mtd_smart_procfs_data_s
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   uint32_t            uneven_wearcount; /* Number of uneven block erases */
 #endif
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  uint32_t            cachehits;        /* Sector map cache hits */
+  uint32_t            cachemisses;      /* Sector map cache misses (volume scans) */
+#endif
+};
+
+/* The following defines the limits of a BIOC_GC request.  Collection stops
+ * when either limit is reached or when no erase block is above the dirty
+ * threshold.  Zero means no limit.
+ */
+
+struct mtd_smart_gc_s
+{
+  uint16_t            maxblocks;        /* Most erase blocks to reclaim */
+  uint16_t            threshold;        /* Min % of a block released (0: Kconfig) */
+  uint32_t            maxtime;          /* Most time to spend (milliseconds) */
 };
 
 /* The following defines debug command data passed from the procfs layer to
@@ -34,13 +34,40 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define MUTEX_INITIALIZER    SEM_INITIALIZER(1);
+/* A mutex is a binary semaphore that is marked with
+ * PRIOINHERIT_FLAGS_MUTEX.  It never has more than one holder, so the
+ * priority inheritance logic keeps that holder in the mutex itself rather
+ * than in the global pool of holder containers:  finding the owner,
+ * boosting it and restoring it are O(1) and a mutex can never exhaust
+ * CONFIG_SEM_PREALLOCHOLDERS.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+#    define MUTEX_INITIALIZER \
+       {{1, PRIOINHERIT_FLAGS_MUTEX, NULL}, SEMHOLDER_INITIALIZER}
+#  else
+#    define MUTEX_INITIALIZER \
+       {{1, PRIOINHERIT_FLAGS_MUTEX, \
+         {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}}}
+#  endif
+#else
+#  define MUTEX_INITIALIZER  {SEM_INITIALIZER(1)}
+#endif
 
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
-typedef sem_t mutex_t;
+struct mutex_s
+{
+  sem_t sem;                     /* Must be first, see nxsem_mutexholder() */
+#if defined(CONFIG_PRIORITY_INHERITANCE) && CONFIG_SEM_PREALLOCHOLDERS > 0
+  struct semholder_s holder;     /* The owner of the mutex */
+#endif
+};
+
+typedef struct mutex_s mutex_t;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -77,7 +104,21 @@ extern "C"
 
 static inline int nxmutex_init(FAR mutex_t *mutex)
 {
-  return nxsem_init(mutex, 0, 1);
+  int ret = nxsem_init(&mutex->sem, 0, 1);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (ret >= 0)
+    {
+      mutex->sem.flags |= PRIOINHERIT_FLAGS_MUTEX;
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+      mutex->holder.flink  = NULL;
+      mutex->holder.htcb   = NULL;
+      mutex->holder.counts = 0;
+#  endif
+    }
+#endif
+
+  return ret;
 }
 
 /****************************************************************************
@@ -101,7 +142,7 @@ static inline int nxmutex_init(FAR mutex_t *mutex)
 
 static inline int nxmutex_destroy(FAR mutex_t *mutex)
 {
-  return nxsem_destroy(mutex);
+  return nxsem_destroy(&mutex->sem);
 }
 
 /****************************************************************************
@@ -126,7 +167,7 @@ static inline int nxmutex_destroy(FAR mutex_t *mutex)
 
 static inline int nxmutex_lock(FAR mutex_t *mutex)
 {
-  return nxsem_wait_uninterruptible(mutex);
+  return nxsem_wait_uninterruptible(&mutex->sem);
 }
 
 /****************************************************************************
@@ -152,7 +193,7 @@ static inline int nxmutex_lock(FAR mutex_t *mutex)
 
 static inline int nxmutex_trylock(FAR mutex_t *mutex)
 {
-  return nxsem_trywait(mutex);
+  return nxsem_trywait(&mutex->sem);
 }
 
 /****************************************************************************
@@ -173,7 +214,7 @@ static inline bool nxmutex_is_locked(FAR mutex_t *mutex)
   int cnt;
   int ret;
 
-  ret = nxsem_get_value(mutex, &cnt);
+  ret = nxsem_get_value(&mutex->sem, &cnt);
 
   DEBUGASSERT(ret == OK);
 
@@ -202,7 +243,7 @@ static inline bool nxmutex_is_locked(FAR mutex_t *mutex)
 
 static inline int nxmutex_unlock(FAR mutex_t *mutex)
 {
-  return nxsem_post(mutex);
+  return nxsem_post(&mutex->sem);
 }
 
 #undef EXTERN
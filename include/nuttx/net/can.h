@@ -62,6 +62,23 @@
  * Public Types
  ****************************************************************************/
 
+/* Argument of the SIOCSCANFILTER driver ioctl.  SocketCAN passes the
+ * union of the CAN_RAW_FILTER sets of all sockets that may receive from
+ * the device.  The controller must pass every frame that matches at least
+ * one of the filters and may pass others (they are filtered again in
+ * software).  An empty set means that no socket wants any frame.
+ *
+ * Filters never carry CAN_INV_FILTER; a filter with a zero can_mask
+ * passes everything.  A driver that cannot hold the whole set returns
+ * -ENOSPC, and is then asked to pass everything instead.
+ */
+
+struct can_hwfilter_s
+{
+  FAR const struct can_filter *cf_filters; /* Array of filters */
+  uint16_t cf_nfilters;                    /* Number of filters */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -129,6 +129,14 @@
 
 #define SIOCGCANBITRATE  _SIOC(0x002C)  /* Get bitrate from a CAN controller */
 #define SIOCSCANBITRATE  _SIOC(0x002D)  /* Set bitrate of a CAN controller */
+#define SIOCSCANFILTER   _SIOC(0x002F)  /* Set the RX acceptance filters of a
+                                         * CAN controller (driver internal).
+                                         * See include/nuttx/net/can.h */
+
+/* Zero-copy receive ********************************************************/
+
+#define SIOCRECVIOB      _SIOC(0x002E)  /* Receive an I/O buffer chain.
+                                         * See psock_recviob() */
 
 /****************************************************************************
  * Public Type Definitions
@@ -88,6 +88,13 @@
 
 #define __SOCKFD_OFFSET CONFIG_NFILE_DESCRIPTORS
 
+/* Socket descriptors are allocated in blocks, like file descriptors */
+
+#define SOCKETS_PER_BLOCK CONFIG_NSOCKET_DESCRIPTORS_PER_BLOCK
+#define SOCKETS_NBLOCKS \
+  ((CONFIG_NSOCKET_DESCRIPTORS + SOCKETS_PER_BLOCK - 1) / SOCKETS_PER_BLOCK)
+#define SOCKETS_NWORDS    ((CONFIG_NSOCKET_DESCRIPTORS + 31) >> 5)
+
 /* Capabilities of a socket */
 
 #define SOCKCAP_NONBLOCKING (1 << 0)  /* Bit 0: Socket supports non-blocking
@@ -227,7 +234,22 @@ struct sock_intf_s
   CODE int        (*si_ioctl)(FAR struct socket *psock, int cmd,
                     FAR void *arg, size_t arglen);
 #endif
+#ifdef CONFIG_NET_RECVIOB
+  CODE ssize_t    (*si_recviob)(FAR struct socket *psock,
+                    FAR struct iob_s **iob, int flags,
+                    FAR struct sockaddr *from, FAR socklen_t *fromlen);
+#endif
+};
+
+#ifdef CONFIG_NET_RECVIOB
+/* The argument of the SIOCRECVIOB ioctl command */
+
+struct recviob_s
+{
+  FAR struct iob_s *ri_iob;  /* Returned I/O buffer chain */
+  int ri_flags;              /* Receive flags */
 };
+#endif
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
  * socket type will have a different connection structure type bound to its
@@ -297,13 +319,16 @@ struct socket
 #endif
 };
 
-/* This defines a list of sockets indexed by the socket descriptor */
+/* This defines a list of sockets indexed by the socket descriptor.  Bit n
+ * of sl_used is set while socket n is allocated, see struct filelist.
+ */
 
 #ifdef CONFIG_NET
 struct socketlist
 {
   sem_t         sl_sem;      /* Manage access to the socket list */
-  struct socket sl_sockets[CONFIG_NSOCKET_DESCRIPTORS];
+  uint32_t      sl_used[SOCKETS_NWORDS];
+  FAR struct socket *sl_sockets[SOCKETS_NBLOCKS];
 };
 #endif
 
@@ -361,6 +386,10 @@ void net_initialize(void);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * There is a single lock for the whole network.  The socket interface, the
+ * device drivers' receive and poll paths and the devif callbacks all take
+ * the same lock.  CONFIG_NET_LOCK_STATISTICS measures the contention on it.
+ *
  ****************************************************************************/
 
 /****************************************************************************
@@ -570,6 +599,17 @@ void net_initlist(FAR struct socketlist *list);
 
 void net_releaselist(FAR struct socketlist *list);
 
+/****************************************************************************
+ * Name: net_duplist
+ *
+ * Description:
+ *   Duplicate the valid sockets of 'plist' that are not close-on-exec
+ *   into the new list 'clist'.
+ *
+ ****************************************************************************/
+
+void net_duplist(FAR struct socketlist *plist, FAR struct socketlist *clist);
+
 /****************************************************************************
  * Name: sockfd_socket
  *
@@ -1046,6 +1086,46 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Receive data without copying it:  The I/O buffer chain holding the
+ *   next read-ahead data of the socket is removed from the socket and
+ *   returned to the caller, who then owns it.  For stream sockets this is
+ *   whatever data was buffered in one chain; for datagram sockets it is
+ *   exactly one datagram.  Waiting, MSG_DONTWAIT and the receive timeout
+ *   behave as for psock_recvfrom().
+ *
+ *   The chain must be released with iob_free_chain() using the read-ahead
+ *   consumer ID of the protocol, IOBUSER_NET_TCP_READAHEAD,
+ *   IOBUSER_NET_UDP_READAHEAD or, for Bluetooth frames,
+ *   IOBUSER_NET_SOCK_BLUETOOTH.
+ *
+ *   In the FLAT build, applications can do the same through the
+ *   SIOCRECVIOB ioctl command with a struct recviob_s argument.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   iob     - Location to return the I/O buffer chain
+ *   flags   - Receive flags
+ *   from    - Address of source (may be NULL; datagram sockets only)
+ *   fromlen - The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the chain.  Zero is
+ *   returned if the peer has performed an orderly shutdown.  -EOPNOTSUPP
+ *   is returned for sockets that do not buffer received data in I/O
+ *   buffers.  Otherwise a negated errno value as for psock_recvfrom().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags, FAR struct sockaddr *from,
+                      FAR socklen_t *fromlen);
+#endif
+
 /****************************************************************************
  * Name: nx_recvfrom
  *
@@ -1082,6 +1162,42 @@ ssize_t nx_recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
 
 #define nx_recv(psock,buf,len,flags) nx_recvfrom(psock,buf,len,flags,NULL,0)
 
+#ifdef CONFIG_NET_CMSG
+/****************************************************************************
+ * Name: psock_recvmsg and psock_sendmsg
+ *
+ * Description:
+ *   Internal versions of recvmsg() and sendmsg() that operate on the
+ *   socket structure and return a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+#endif
+
+/****************************************************************************
+ * Name: psock_recvmmsg and psock_sendmmsg
+ *
+ * Description:
+ *   Internal versions of recvmmsg() and sendmmsg().  They are functionally
+ *   equivalent except that they are not cancellation points, do not modify
+ *   the errno variable, and accept the internal socket structure.
+ *
+ * Returned Value:
+ *   The number of messages transferred.  If no message could be
+ *   transferred, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: psock_getsockopt
  *
@@ -51,6 +51,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <net/if.h>
@@ -68,6 +69,10 @@
 #  include <nuttx/net/mld.h>
 #endif
 
+#ifdef CONFIG_NETDEV_RXPOLL
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -134,6 +139,9 @@
 
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
+#  define NETDEV_RXDROP(dev,why)  _NETDEV_STATISTIC(dev,rx_drops[why])
+#  define NETDEV_TXDROP(dev,why)  _NETDEV_STATISTIC(dev,tx_drops[why])
+
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
@@ -150,6 +158,42 @@
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
+
+#  define NETDEV_RXDROP(dev,why)
+#  define NETDEV_TXDROP(dev,why)
+#endif
+
+/* Hardware checksum offload capabilities that a driver may advertise in
+ * d_chkoffload.  NETDEV_TXCHKSUM_OFFLOAD() and NETDEV_RXCHKSUM_OFFLOAD()
+ * are used by the stack to decide whether to compute or verify the IPv4
+ * header, TCP and UDP checksums in software.
+ */
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+#  define NETDEV_CHKSUM_TX (1 << 0) /* Hardware inserts checksums on TX */
+#  define NETDEV_CHKSUM_RX (1 << 1) /* Hardware verifies checksums on RX */
+
+#  define NETDEV_TXCHKSUM_OFFLOAD(dev) \
+     (((dev)->d_chkoffload & NETDEV_CHKSUM_TX) != 0)
+#  define NETDEV_RXCHKSUM_OFFLOAD(dev) \
+     (((dev)->d_chkoffload & NETDEV_CHKSUM_RX) != 0)
+#else
+#  define NETDEV_TXCHKSUM_OFFLOAD(dev) (false)
+#  define NETDEV_RXCHKSUM_OFFLOAD(dev) (false)
+#endif
+
+/* TCP segmentation offload.  NETDEV_TSOMAX() is the largest TCP payload
+ * that may be handed to the driver in one frame, or zero if the driver
+ * cannot segment.
+ */
+
+#ifdef CONFIG_NETDEV_TSO
+#  define NETDEV_TSOMAX(dev) \
+     (NETDEV_TXCHKSUM_OFFLOAD(dev) ? (dev)->d_tsomax : 0)
+#  define NETDEV_SET_TSOMSS(dev,mss) do { (dev)->d_tsomss = (mss); } while (0)
+#else
+#  define NETDEV_TSOMAX(dev)         (0)
+#  define NETDEV_SET_TSOMSS(dev,mss)
 #endif
 
 /****************************************************************************
@@ -157,6 +201,34 @@
  ****************************************************************************/
 
 #ifdef CONFIG_NETDEV_STATISTICS
+/* The reasons for which the network stack drops a received packet, counted
+ * per device by NETDEV_RXDROP().  Packets that the driver itself discards
+ * are counted by NETDEV_RXDROPPED() instead.
+ */
+
+enum netdev_rxdrop_e
+{
+  NETDEV_RXDROP_HEADER = 0,  /* Bad IP version, header or packet length */
+  NETDEV_RXDROP_CHKSUM,      /* Bad IP, TCP or UDP checksum */
+  NETDEV_RXDROP_FRAGMENT,    /* IP fragment that could not be reassembled */
+  NETDEV_RXDROP_ADDRESS,     /* Not addressed to us and not forwarded */
+  NETDEV_RXDROP_PROTOCOL,    /* Unsupported IP protocol or ICMP type */
+  NETDEV_RXDROP_NOCONN,      /* No connection or listener for the port */
+  NETDEV_RXDROP_NOBUFS,      /* No buffer for the received data */
+  NETDEV_RXDROP_NREASONS
+};
+
+/* The reasons for which the network stack drops a packet to be sent,
+ * counted by NETDEV_TXDROP().
+ */
+
+enum netdev_txdrop_e
+{
+  NETDEV_TXDROP_NEIGHBOR = 0, /* Replaced by an ARP or ND solicitation */
+  NETDEV_TXDROP_NOBUFS,       /* No buffer in the Tx queue */
+  NETDEV_TXDROP_NREASONS
+};
+
 /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
  * statistics, then this structure holds the counts of network driver
  * events.
@@ -180,6 +252,10 @@ struct netdev_statistics_s
 #endif
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
 
+  /* Packets dropped by the stack, indexed by enum netdev_rxdrop_e */
+
+  uint32_t rx_drops[NETDEV_RXDROP_NREASONS];
+
   /* Tx Status */
 
   uint32_t tx_packets;     /* Number of Tx packets queued */
@@ -187,6 +263,10 @@ struct netdev_statistics_s
   uint32_t tx_errors;      /* Number of receive errors (incl timeouts) */
   uint32_t tx_timeouts;    /* Number of Tx timeout errors */
 
+  /* Packets dropped by the stack, indexed by enum netdev_txdrop_e */
+
+  uint32_t tx_drops[NETDEV_TXDROP_NREASONS];
+
   /* Other status */
 
   uint32_t errors;         /* Total number of errors */
@@ -220,6 +300,9 @@ struct netdev_varaddr_s
  */
 
 struct devif_callback_s; /* Forward reference */
+#ifdef CONFIG_NETDEV_TXQUEUE
+struct iob_queue_s;      /* Forward reference.  See iob.h */
+#endif
 
 struct net_driver_s
 {
@@ -246,6 +329,13 @@ struct net_driver_s
 
   uint8_t d_lltype;             /* See enum net_lltype_e */
   uint8_t d_llhdrlen;           /* Link layer header size */
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  uint8_t d_chkoffload;         /* See NETDEV_CHKSUM_* definitions */
+#endif
+#ifdef CONFIG_NETDEV_TSO
+  uint16_t d_tsomax;            /* Max TCP payload per TSO frame (0: no TSO) */
+  uint16_t d_tsomss;            /* Segment size for the current TSO frame */
+#endif
 #ifdef CONFIG_NETDEV_IFINDEX
   uint8_t d_ifindex;            /* Device index */
 #endif
@@ -358,6 +448,14 @@ struct net_driver_s
   struct netdev_statistics_s d_statistics;
 #endif
 
+#ifdef CONFIG_NETDEV_TXQUEUE
+  /* State of devif_poll_queue() while it polls this device */
+
+  FAR struct iob_queue_s *d_txq; /* Queue receiving the outgoing frames */
+  uint16_t d_txqcount;           /* Number of frames queued so far */
+  uint16_t d_txqmax;             /* Maximum number of frames to queue */
+#endif
+
   /* Application callbacks:
    *
    * Network device event handlers are retained in a 'list' and are called
@@ -402,6 +500,34 @@ struct net_driver_s
 
 typedef CODE int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NETDEV_RXPOLL
+/* Polled receive.  A driver using polled receive provides two functions:
+ *
+ *   rp_poll  - Receive and dispatch up to 'budget' frames and return the
+ *              number of frames processed.  Called on the work queue with
+ *              the network locked.
+ *   rp_rxirq - Enable or disable the RX interrupt of the device.  This is
+ *              called from the interrupt handler (to disable) and from the
+ *              work queue (to enable).  When enabling, the hardware must
+ *              raise a new interrupt if frames are already pending.
+ */
+
+typedef CODE int (*netdev_rxpoll_t)(FAR struct net_driver_s *dev,
+                                    int budget);
+typedef CODE void (*netdev_rxirq_t)(FAR struct net_driver_s *dev,
+                                    bool enable);
+
+struct netdev_rxpoll_s
+{
+  struct work_s rp_work;             /* Deferred receive work */
+  FAR struct net_driver_s *rp_dev;   /* The device being polled */
+  netdev_rxpoll_t rp_poll;           /* Receive up to rp_budget frames */
+  netdev_rxirq_t rp_rxirq;           /* Enable/disable the RX interrupt */
+  int16_t rp_budget;                 /* Frames per pass */
+  uint8_t rp_qid;                    /* Work queue used for polling */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -544,6 +670,40 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
 int devif_timer(FAR struct net_driver_s *dev, int delay,
                 devif_poll_callback_t callback);
 
+/****************************************************************************
+ * Name: devif_poll_queue
+ *
+ * Description:
+ *   Poll the connections like devif_poll(), but instead of handing each
+ *   frame to a driver callback in d_buf, collect up to 'maxframes' frames
+ *   in 'txq'.  Each frame is a separate I/O buffer chain holding the
+ *   complete L2 frame:  For Ethernet devices, arp_out() or neighbor_out()
+ *   has already been applied, and frames addressed to the device itself
+ *   have been looped back.  The driver can then hand the whole batch to
+ *   scatter-gather DMA and must release each frame with iob_free_chain()
+ *   (IOBUSER_NET_TXQUEUE) when it has been sent.
+ *
+ *   Polling stops early if no I/O buffers are available; the frame being
+ *   produced at that point is dropped and counted as a TX error.
+ *
+ * Input Parameters:
+ *   dev       - The network device to poll
+ *   txq       - The queue that receives the frames
+ *   maxframes - Maximum number of frames to queue
+ *
+ * Returned Value:
+ *   The number of frames added to 'txq'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXQUEUE
+int devif_poll_queue(FAR struct net_driver_s *dev,
+                     FAR struct iob_queue_s *txq, int maxframes);
+#endif
+
 /****************************************************************************
  * Name: neighbor_out
  *
@@ -605,6 +765,31 @@ int devif_loopback(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Polled receive
+ *
+ * Instead of handling every received frame from its own work item, the
+ * RX interrupt handler calls netdev_rxpoll_schedule().  That disables the
+ * RX interrupt and queues one work item that receives up to 'budget'
+ * frames with the network locked once.  If the budget was used up, the
+ * network is unlocked and the work is queued again so that other threads
+ * get a chance to run; otherwise the RX interrupt is enabled again.
+ *
+ * netdev_rxpoll_initialize() must be called before the interface is
+ * brought up; netdev_rxpoll_cancel() should be called when it is brought
+ * down.  A 'budget' of zero selects CONFIG_NETDEV_RXPOLL_BUDGET.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXPOLL
+void netdev_rxpoll_initialize(FAR struct netdev_rxpoll_s *rxpoll,
+                              FAR struct net_driver_s *dev, int qid,
+                              int budget, netdev_rxpoll_t poll,
+                              netdev_rxirq_t rxirq);
+void netdev_rxpoll_schedule(FAR struct netdev_rxpoll_s *rxpoll);
+void netdev_rxpoll_cancel(FAR struct netdev_rxpoll_s *rxpoll);
+#endif
+
 /****************************************************************************
  * Name: net_ioctl_arglen
  *
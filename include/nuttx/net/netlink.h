@@ -123,6 +123,7 @@ void netlink_add_response(NETLINK_HANDLE handle,
  *   access to the pending response list.
  *
  * Input Parameters:
+ *   protocol - The Netlink protocol of the connections (NETLINK_*).
  *   group - The broadcast group index.
  *   data  - The broadcast data.  The memory referenced by 'data'
  *           must have been allocated via kmm_malloc().  It will be freed
@@ -130,7 +131,8 @@ void netlink_add_response(NETLINK_HANDLE handle,
  *
  ****************************************************************************/
 
-void netlink_add_broadcast(int group, FAR struct netlink_response_s *data);
+void netlink_add_broadcast(int protocol, int group,
+                           FAR struct netlink_response_s *data);
 
 #undef EXTERN
 #ifdef __cplusplus
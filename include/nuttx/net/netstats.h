@@ -46,6 +46,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
 
 #include <nuttx/net/netconfig.h>
@@ -80,6 +81,36 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCK_STATISTICS
+/* Network lock statistics.  Only the outermost net_lock()/net_unlock() of a
+ * thread is counted; recursive re-locks are free.  Times are in clock ticks.
+ */
+
+struct netlock_stats_s
+{
+  uint32_t    nlocks;           /* Number of times the lock was acquired */
+  uint32_t    ncontended;       /* Number of times the caller had to wait */
+  clock_t     waitticks;        /* Total time spent waiting for the lock */
+  clock_t     maxwait;          /* Longest single wait for the lock */
+  clock_t     holdticks;        /* Total time the lock was held */
+  clock_t     maxhold;          /* Longest time the lock was held */
+};
+#endif
+
+#ifdef CONFIG_NET_IPFORWARD
+/* IP forwarding statistics.  The flow cache counters are only updated if
+ * CONFIG_NET_IPFORWARD_FLOWCACHE is non-zero.
+ */
+
+struct ipfwd_stats_s
+{
+  net_stats_t forwarded;        /* Number of packets forwarded */
+  uint32_t    bytes;            /* Number of bytes forwarded */
+  net_stats_t flowhit;          /* Forwarding flow cache hits */
+  net_stats_t flowmiss;         /* Forwarding flow cache misses */
+};
+#endif
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -117,6 +148,14 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+#ifdef CONFIG_NET_IPFORWARD
+  struct ipfwd_stats_s ipfwd;   /* IP forwarding statistics */
+#endif
+
+#ifdef CONFIG_NET_LOCK_STATISTICS
+  struct netlock_stats_s lock;  /* Network lock statistics */
+#endif
 };
 
 /****************************************************************************
@@ -40,6 +40,18 @@
 #define NET_RPMSG_DEVIOCTL              4 /* IP-->LINK */
 #define NET_RPMSG_SOCKIOCTL             5 /* IP<--LINK */
 #define NET_RPMSG_TRANSFER              6 /* IP<->LINK */
+#define NET_RPMSG_TRANSFERV             7 /* IP<->LINK, several frames */
+
+/* Flags of struct net_rpmsg_frame_s */
+
+#define NET_RPMSG_FRAME_NOCSUM          (1 << 0) /* Checksums not filled */
+
+/* Space taken by a frame of len bytes in a NET_RPMSG_TRANSFERV message.
+ * Every frame starts on a four bytes boundary.
+ */
+
+#define NET_RPMSG_FRAME_SIZE(len) \
+  ((sizeof(struct net_rpmsg_frame_s) + (len) + 3) & ~3)
 
 /****************************************************************************
  * Public Types
@@ -98,4 +110,26 @@ begin_packed_struct struct net_rpmsg_transfer_s
   uint8_t                   data[0];
 } end_packed_struct;
 
+/* One frame of a NET_RPMSG_TRANSFERV message.  A non zero gso_size asks
+ * the receiver to split the TCP payload of the frame into segments of
+ * gso_size bytes, NET_RPMSG_FRAME_NOCSUM to fill in the IPv4 header, TCP
+ * and UDP checksums.
+ */
+
+begin_packed_struct struct net_rpmsg_frame_s
+{
+  uint32_t                  length;
+  uint16_t                  gso_size;
+  uint16_t                  flags;
+  uint8_t                   data[0];
+} end_packed_struct;
+
+begin_packed_struct struct net_rpmsg_transferv_s
+{
+  struct net_rpmsg_header_s header;
+  uint32_t                  count;  /* Number of frames */
+  uint32_t                  length; /* Bytes of frames in data */
+  uint8_t                   data[0];
+} end_packed_struct;
+
 #endif /* __INCLUDE_NUTTX_NET_RPMSG_H */
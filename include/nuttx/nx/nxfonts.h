@@ -464,7 +464,9 @@ typedef FAR void *FCACHE;
 
 struct nxfonts_glyph_s
 {
-  FAR struct nxfonts_glyph_s *flink;   /* Implements a singly linked list */
+  FAR struct nxfonts_glyph_s *flink;   /* Implements a doubly linked LRU */
+  FAR struct nxfonts_glyph_s *blink;   /* list of glyphs */
+  FAR struct nxfonts_glyph_s *hlink;   /* Next glyph in the hash chain */
   uint8_t code;                        /* Character code */
   uint8_t height;                      /* Height of this glyph (in rows) */
   uint8_t width;                       /* Width of this glyph (in pixels) */
@@ -45,6 +45,7 @@
 
 #ifndef __ASSEMBLY__
 #  include <stdbool.h>
+#  include <stdint.h>
 #  include <nuttx/sched.h>
 #endif
 
@@ -223,12 +224,43 @@
  *   Default: No timeouts monitored.
  */
 
+/* PG_FAULTADDR(tcb) - The virtual address of the page fault of the task.
+ *   The architecture keeps it in the TCB for up_checkmapping(),
+ *   up_allocpage() and up_fillpage().  The common logic sets it in the TCB
+ *   of the page fill worker thread to prefetch pages.
+ */
+
+#ifndef PG_FAULTADDR
+#  define PG_FAULTADDR(tcb)        ((tcb)->xcp.far)
+#endif
+
+/* up_allocpage() returns PG_RESIDENT if the page was still resident and has
+ * just been mapped again, so that no fill is needed.
+ */
+
+#define PG_RESIDENT                1
+
 /****************************************************************************
- * Public Data
+ * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/* Paging statistics, as returned by pg_statistics() */
+
+struct pg_stats_s
+{
+  uint32_t faults;         /* Page faults taken */
+  uint32_t fills;          /* Pages filled on demand */
+  uint32_t prefetches;     /* Pages filled by sequential prefetch */
+  uint32_t reclaims;       /* Faults resolved without a fill */
+  uint32_t redundant;      /* Faults on pages that were already mapped */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -311,6 +343,19 @@ extern "C"
 
 void pg_miss(void);
 
+/****************************************************************************
+ * Name: pg_statistics
+ *
+ * Description:
+ *   Return a snapshot of the paging statistics.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *
+ ****************************************************************************/
+
+void pg_statistics(FAR struct pg_stats_s *stats);
+
 /****************************************************************************
  * Public Functions -- Provided by architecture-specific logic to common
  *                     paging logic.
@@ -386,8 +431,10 @@ bool up_checkmapping(FAR struct tcb_s *tcb);
  *
  * Returned Value:
  *   This function will return zero (OK) if the allocation was successful.
- *   A negated errno value may be returned if an error occurs.  All errors,
- *   however, are fatal.
+ *   It may return PG_RESIDENT if the page was still resident (for example,
+ *   it was unmapped only to detect references to it) and has just been
+ *   mapped again; up_fillpage() is then not called.  A negated errno value
+ *   may be returned if an error occurs.  All errors, however, are fatal.
  *
  * Assumptions:
  *   - This function is called from the normal tasking context (but with
@@ -73,6 +73,8 @@
 #include <nuttx/config.h>
 
 #include <queue.h>
+#include <stdint.h>
+#include <time.h>
 
 #ifdef CONFIG_PM
 
@@ -218,6 +220,16 @@ struct pm_callback_s
                       enum pm_state_e pmstate);
 };
 
+/* Time spent in one power state of one domain (CONFIG_PM_RESIDENCY) */
+
+#ifdef CONFIG_PM_RESIDENCY
+struct pm_residency_s
+{
+  uint32_t entries;          /* Number of times the state was entered */
+  struct timespec time;      /* Total time spent in the state */
+};
+#endif
+
 /* An instance of a given PM governor */
 
 struct pm_governor_s
@@ -539,6 +551,28 @@ int pm_changestate(int domain, enum pm_state_e newstate);
 
 enum pm_state_e pm_querystate(int domain);
 
+/****************************************************************************
+ * Name: pm_residency
+ *
+ * Description:
+ *   Return how often and for how long a domain has been in a power state
+ *   since boot, including the time in the current state up to now.
+ *
+ * Input Parameters:
+ *   domain - The PM domain
+ *   state  - The power state
+ *   res    - Location to return the statistics
+ *
+ * Returned Value:
+ *   OK, or -EINVAL if the domain or state is out of range.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_RESIDENCY
+int pm_residency(int domain, enum pm_state_e state,
+                 FAR struct pm_residency_s *res);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
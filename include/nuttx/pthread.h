@@ -136,6 +136,24 @@ EXTERN const pthread_attr_t g_default_pthread_attr;
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nx_pthread_mutex_unlock
+ *
+ * Description:
+ *   The OS part of pthread_mutex_unlock().  This is a system call used by
+ *   the C library pthread_mutex_unlock() when it cannot release the mutex
+ *   without OS assistance.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int nx_pthread_mutex_unlock(FAR pthread_mutex_t *mutex);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
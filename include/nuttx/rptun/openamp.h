@@ -26,6 +26,11 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
 #include <openamp/open_amp.h>
 #include <openamp/remoteproc_loader.h>
 
@@ -63,6 +68,45 @@ void rpmsg_unregister_callback(FAR void *priv,
                                rpmsg_dev_cb_t device_destroy,
                                rpmsg_bind_cb_t ns_bind);
 
+/****************************************************************************
+ * Name: rpmsg_alloc_msg
+ *
+ * Description:
+ *   Reserve a TX buffer for a zero-copy message.  The caller builds the
+ *   message in place and hands the buffer to rpmsg_send_nocopy(), so the
+ *   payload is written once, directly into shared memory.  On the receive
+ *   side, rpmsg_hold_rx_buffer() keeps an RX buffer beyond the return of
+ *   the endpoint callback and rpmsg_release_rx_buffer() returns it once
+ *   the data has been consumed.
+ *
+ * Input Parameters:
+ *   ept    - The endpoint to send on
+ *   hdrlen - Size of the message header, which is cleared
+ *   space  - Returns the room for payload after the header
+ *   wait   - Wait for a free buffer if there is none
+ *
+ * Returned Value:
+ *   The buffer, or NULL if no buffer is available.
+ *
+ ****************************************************************************/
+
+static inline FAR void *rpmsg_alloc_msg(FAR struct rpmsg_endpoint *ept,
+                                        size_t hdrlen,
+                                        FAR uint32_t *space, bool wait)
+{
+  FAR void *msg;
+
+  msg = rpmsg_get_tx_payload_buffer(ept, space, wait);
+  if (msg != NULL)
+    {
+      DEBUGASSERT(*space >= hdrlen);
+      memset(msg, 0, hdrlen);
+      *space -= hdrlen;
+    }
+
+  return msg;
+}
+
 #ifdef __cplusplus
 }
 #endif
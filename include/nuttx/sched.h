@@ -39,6 +39,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/mm/shm.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
@@ -96,17 +97,19 @@
 #define TCB_FLAG_NONCANCELABLE     (1 << 2)                      /* Bit 2: Pthread is non-cancelable */
 #define TCB_FLAG_CANCEL_DEFERRED   (1 << 3)                      /* Bit 3: Deferred (vs asynch) cancellation type */
 #define TCB_FLAG_CANCEL_PENDING    (1 << 4)                      /* Bit 4: Pthread cancel is pending */
-#define TCB_FLAG_POLICY_SHIFT      (5)                           /* Bit 5-6: Scheduling policy */
-#define TCB_FLAG_POLICY_MASK       (3 << TCB_FLAG_POLICY_SHIFT)
+#define TCB_FLAG_POLICY_SHIFT      (5)                           /* Bit 5-7: Scheduling policy */
+#define TCB_FLAG_POLICY_MASK       (7 << TCB_FLAG_POLICY_SHIFT)
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
 #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT)  /* Other scheding policy */
-#define TCB_FLAG_CPU_LOCKED        (1 << 7)                      /* Bit 7: Locked to this CPU */
-#define TCB_FLAG_SIGNAL_ACTION     (1 << 8)                      /* Bit 8: In a signal handler */
-#define TCB_FLAG_SYSCALL           (1 << 9)                      /* Bit 9: In a system call */
-#define TCB_FLAG_EXIT_PROCESSING   (1 << 10)                     /* Bit 10: Exitting */
-                                                                 /* Bits 11-15: Available */
+#  define TCB_FLAG_SCHED_DEADLINE  (4 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
+#define TCB_FLAG_CPU_LOCKED        (1 << 8)                      /* Bit 8: Locked to this CPU */
+#define TCB_FLAG_SIGNAL_ACTION     (1 << 9)                      /* Bit 9: In a signal handler */
+#define TCB_FLAG_SYSCALL           (1 << 10)                     /* Bit 10: In a system call */
+#define TCB_FLAG_EXIT_PROCESSING   (1 << 11)                     /* Bit 11: Exitting */
+#define TCB_FLAG_COND_REQUEUED     (1 << 12)                     /* Bit 12: Cond waiter moved to mutex */
+                                                                 /* Bits 13-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -316,6 +319,30 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure.  It is
+ * allocated when the deadline scheduling policy is assigned to a thread.
+ * All times are in system clock ticks.  The remaining budget of the current
+ * period is kept in the TCB timeslice field.
+ */
+
+struct deadline_s
+{
+  struct wdog_s timer;              /* Period timer                             */
+  bool      throttled;              /* Budget of this period is exhausted       */
+  uint8_t   priority;               /* Priority while within budget             */
+  uint32_t  runtime;                /* Execution budget per period              */
+  uint32_t  deadline;               /* Relative deadline of each job            */
+  uint32_t  period;                 /* Activation period                        */
+  uint32_t  bandwidth;              /* runtime / period (fixed point)           */
+  clock_t   absdeadline;            /* Absolute deadline of the current job     */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ********************************************************/
 
 /* This structure is used to maintain information about child tasks.  pthreads
@@ -345,6 +372,27 @@ struct pthread_cleanup_s
 };
 #endif
 
+/* struct sigq_s ****************************************************************/
+
+/* This structure describes one queued signal action that needs action by the
+ * task.  It is public only because each TCB embeds CONFIG_SIG_TASK_SLOTS of
+ * them; it is managed by sched/signal.
+ */
+
+struct sigq_s
+{
+  FAR struct sigq_s *flink;      /* Forward link */
+  union
+  {
+    void (*sighandler)(int signo, siginfo_t *info, void *context);
+  } action;                      /* Signal action */
+  sigset_t  mask;                /* Additional signals to mask while the
+                                  * the signal-catching function executes */
+  siginfo_t info;                /* Signal information */
+  uint8_t   type;                /* (Used to manage allocations) */
+};
+typedef struct sigq_s sigq_t;
+
 /* type tls_ndxset_t ************************************************************/
 
 /* Smallest addressable type that can hold the entire configured number of TLS
@@ -396,6 +444,22 @@ struct dspace_s
 };
 #endif
 
+/* struct stackhist_s ***********************************************************/
+
+/* Used to report the stack usage of threads that have exited */
+
+#ifdef CONFIG_STACK_MONITOR
+struct stackhist_s
+{
+  /* Name shared by the threads */
+
+  char     name[CONFIG_TASK_NAME_SIZE + 1];
+  size_t   size;                         /* Stack size of the last thread       */
+  size_t   used;                         /* Largest stack use of any of them    */
+  uint32_t count;                        /* Number of threads that exited       */
+};
+#endif
+
 /* struct stackinfo_s ***********************************************************/
 
 /* Used to report stack information */
@@ -487,6 +551,9 @@ struct task_group_s
   /* Group membership ***********************************************************/
 
   uint8_t    tg_nmembers;           /* Number of members in the group           */
+#ifdef CONFIG_SCHED_CPUTIME
+  uint64_t   tg_cputime;            /* Execution time of exited members (nsec)  */
+#endif
 #ifdef HAVE_GROUP_MEMBERS
   uint8_t    tg_mxmembers;          /* Number of members in allocation          */
   FAR pid_t *tg_members;            /* Members of the group                     */
@@ -552,6 +619,7 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+  sigset_t tg_sigpendset;           /* Signals in tg_sigpendingq                */
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -658,6 +726,7 @@ struct tcb_s
 #ifdef CONFIG_SMP
   uint8_t  cpu;                          /* CPU index if running or assigned    */
   cpu_set_t affinity;                    /* Bit set of permitted CPUs           */
+  uint32_t nmigrations;                  /* Times moved to a different CPU      */
 #endif
   uint16_t flags;                        /* Misc. general status flags          */
   int16_t  lockcount;                    /* 0=preemptible (not-locked)          */
@@ -668,16 +737,27 @@ struct tcb_s
   int16_t  cpcount;                      /* Nested cancellation point count     */
 #endif
   int16_t  errcode;                      /* Used to pass error information      */
+  int16_t  inodelocks;                   /* Shared inode tree locks held        */
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
-  int32_t  timeslice;                    /* RR timeslice OR Sporadic budget     */
-                                         /* interval remaining                  */
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+  int32_t  timeslice;                    /* RR timeslice OR Sporadic/Deadline   */
+                                         /* budget interval remaining           */
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters      */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters      */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer      */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s waithrtimer;          /* Or this one for signal waits/sleeps */
+#endif
+#ifdef CONFIG_SCHED_TICKLESS_SLACK
+  uint32_t timerslack;                   /* Timer slack of timed waits (ticks)  */
+#endif
 
   /* Stack-Related Fields *******************************************************/
 
@@ -688,6 +768,9 @@ struct tcb_s
                                          /* Needed to deallocate stack          */
   FAR void *adj_stack_ptr;               /* Adjusted stack_alloc_ptr for HW     */
                                          /* The initial stack pointer value     */
+#ifdef CONFIG_STACK_MONITOR
+  size_t    stack_hwm;                   /* Stack used, as last sampled         */
+#endif
 
   /* External Module Support ****************************************************/
 
@@ -706,6 +789,15 @@ struct tcb_s
   sq_queue_t sigpendactionq;             /* List of pending signal actions      */
   sq_queue_t sigpostedq;                 /* List of posted signals              */
   siginfo_t  sigunbinfo;                 /* Signal info when task unblocked     */
+#if CONFIG_SIG_TASK_SLOTS > 0
+  uint8_t    sigslotbusy;                /* Bit set of sigslots[] in use        */
+
+  /* Pending signal actions tried before the shared pools */
+
+  sigq_t     sigslots[CONFIG_SIG_TASK_SLOTS];
+#endif
+  uint32_t   sigdropped;                 /* Signals lost for lack of memory     */
+  uint32_t   sigoverrun;                 /* Signals merged into a pending one   */
 
   /* POSIX Named Message Queue Fields *******************************************/
 
@@ -737,6 +829,14 @@ struct tcb_s
   uint32_t premp_max;                    /* Max time preemption disabled        */
   uint32_t crit_start;                   /* Time critical section entered       */
   uint32_t crit_max;                     /* Max time in critical section        */
+  uint32_t wakeup_start;                 /* Entry time of the waking interrupt  */
+#endif
+
+  /* CPU time accounting ********************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+  uint32_t run_start;                    /* Time when the thread last resumed   */
+  uint64_t run_time;                     /* Total execution time in nsec        */
 #endif
 
   /* State save areas ***********************************************************/
@@ -834,6 +934,25 @@ EXTERN uint32_t g_crit_max[CONFIG_SMP_NCPUS];
 EXTERN uint32_t g_premp_max[1];
 EXTERN uint32_t g_crit_max[1];
 #endif
+
+/* Histograms of the time with pre-emption disabled, the time within a
+ * critical section, and the latency from the entry of an interrupt to the
+ * execution of a task that it woke up.  Bucket n counts the times between
+ * 2^(n-1) and 2^n - 1 in up_critmon_gettime() units; bucket 0 counts zero
+ * times.
+ */
+
+#define CRITMON_NBUCKETS 33
+
+#ifdef CONFIG_SMP_NCPUS
+EXTERN uint32_t g_premp_hist[CONFIG_SMP_NCPUS][CRITMON_NBUCKETS];
+EXTERN uint32_t g_crit_hist[CONFIG_SMP_NCPUS][CRITMON_NBUCKETS];
+EXTERN uint32_t g_wakeup_hist[CONFIG_SMP_NCPUS][CRITMON_NBUCKETS];
+#else
+EXTERN uint32_t g_premp_hist[1][CRITMON_NBUCKETS];
+EXTERN uint32_t g_crit_hist[1][CRITMON_NBUCKETS];
+EXTERN uint32_t g_wakeup_hist[1][CRITMON_NBUCKETS];
+#endif
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
 /********************************************************************************
@@ -984,6 +1103,25 @@ int nxtask_init(FAR struct task_tcb_s *tcb, const char *name, int priority,
 
 void nxtask_uninit(FAR struct task_tcb_s *tcb);
 
+/********************************************************************************
+ * Name: nxsched_alloc_tcb and nxsched_free_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB of 'size' bytes (the size of a struct task_tcb_s or
+ *   of a struct pthread_tcb_s) and release it.  With CONFIG_MM_SLAB, TCBs
+ *   come from a kernel object cache, otherwise from the kernel heap.  A TCB
+ *   released by nxsched_release_tcb() must have been allocated this way.
+ *
+ ********************************************************************************/
+
+#ifdef CONFIG_MM_SLAB
+FAR struct tcb_s *nxsched_alloc_tcb(size_t size);
+void nxsched_free_tcb(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_alloc_tcb(s) ((FAR struct tcb_s *)kmm_zalloc(s))
+#  define nxsched_free_tcb(t)  kmm_free(t)
+#endif
+
 /********************************************************************************
  * Name: nxtask_activate
  *
@@ -1372,6 +1510,26 @@ int nxsched_set_affinity(pid_t pid, size_t cpusetsize,
 
 int nxsched_get_stackinfo(pid_t pid, FAR struct stackinfo_s *stackinfo);
 
+/********************************************************************************
+ * Name: nxsched_stackmon_history
+ *
+ * Description:
+ *   Report the stack usage of threads that have exited.  Threads are grouped
+ *   by name so that a task that is started repeatedly has one entry.
+ *
+ * Input Parameters:
+ *   index - Index of the entry, starting with zero
+ *   hist  - Location to return the entry
+ *
+ * Returned Value:
+ *   OK, or -ENOENT if there is no entry at 'index'.
+ *
+ ********************************************************************************/
+
+#ifdef CONFIG_STACK_MONITOR
+int nxsched_stackmon_history(int index, FAR struct stackhist_s *hist);
+#endif
+
 /********************************************************************************
  * Name: nx_wait/nx_waitid/nx_waitpid
  ********************************************************************************/
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * include/nuttx/sched_bench.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SCHED_BENCH_H
+#define __INCLUDE_NUTTX_SCHED_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/compiler.h>
+
+#ifdef CONFIG_SCHED_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The measurements made by sched_bench_run() */
+
+#define SCHED_BENCH_SWITCH    0  /* sched_yield() between two threads */
+#define SCHED_BENCH_SEMWAKE   1  /* nxsem_post() to the waiter running */
+#define SCHED_BENCH_MQ        2  /* nxmq_send()/nxmq_receive() round trip */
+#define SCHED_BENCH_WORK      3  /* work_queue() to the worker running */
+#define SCHED_BENCH_IRQWAKE   4  /* Timer interrupt to the waiter running */
+#define SCHED_BENCH_NTESTS    5
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The result of one measurement.  Times are in the units of
+ * up_critmon_gettime().
+ */
+
+struct sched_bench_s
+{
+  FAR const char *sb_name;                 /* Name of the measurement */
+  int      sb_result;                      /* OK or a negated errno */
+  uint32_t sb_count;                       /* Number of samples */
+  uint32_t sb_min;                         /* Shortest sample */
+  uint32_t sb_max;                         /* Longest sample */
+  uint64_t sb_total;                       /* Sum of all samples */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sched_bench_run
+ *
+ * Description:
+ *   Run each measurement CONFIG_SCHED_BENCHMARK_ITERATIONS times.  The
+ *   helper threads run at CONFIG_SCHED_BENCHMARK_PRIORITY and, in SMP
+ *   configurations, on the CPU of the caller, so that every sample
+ *   includes a context switch.
+ *
+ * Input Parameters:
+ *   results - The location to return SCHED_BENCH_NTESTS results
+ *
+ * Returned Value:
+ *   Zero (OK) if the measurements could be started; a negated errno value
+ *   otherwise.  A measurement that failed has a negative sb_result.
+ *
+ ****************************************************************************/
+
+int sched_bench_run(FAR struct sched_bench_s *results);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_BENCHMARK */
+#endif /* __INCLUDE_NUTTX_SCHED_BENCH_H */
@@ -144,6 +144,19 @@ enum note_type_e
   NOTE_IRQ_ENTER       = 20,
   NOTE_IRQ_LEAVE       = 21
 #endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SEMSPIN
+  ,
+  NOTE_SEM_SPIN        = 22
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  ,
+  NOTE_DUMP_STRING     = 23
+#endif
+#ifdef CONFIG_SCHED_SPANS
+  ,
+  NOTE_SPAN_BEGIN      = 24,
+  NOTE_SPAN_END        = 25
+#endif
 };
 
 /* This structure provides the common header of each note */
@@ -302,6 +315,44 @@ struct note_irqhandler_s
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER */
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SEMSPIN
+/* This is the specific form of the NOTE_SEM_SPIN note */
+
+struct note_semspin_s
+{
+  struct note_common_s nss_cmn;        /* Common note parameters */
+  uint8_t nss_sem[sizeof(uintptr_t)];  /* Address of the semaphore */
+  uint8_t nss_nspins[2];               /* Number of polls spent spinning */
+  uint8_t nss_acquired;                /* 1: Semaphore became available */
+};
+#endif /* CONFIG_SCHED_INSTRUMENTATION_SEMSPIN */
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+/* This is the specific form of the NOTE_DUMP_STRING note */
+
+struct note_string_s
+{
+  struct note_common_s nst_cmn; /* Common note parameters */
+  char    nst_data[1];          /* Start of the NUL terminated string */
+};
+
+/* The longest string that fits in one note (excluding the terminator) */
+
+#define NOTE_STRING_MAXLEN \
+  (UINT8_MAX - sizeof(struct note_string_s))
+#endif /* CONFIG_SCHED_INSTRUMENTATION_DUMP */
+
+#ifdef CONFIG_SCHED_SPANS
+/* This is the specific form of the NOTE_SPAN_BEGIN/END notes */
+
+struct note_span_s
+{
+  struct note_common_s nsp_cmn;          /* Common note parameters */
+  uint8_t nsp_span[sizeof(uintptr_t)];   /* Address of struct sched_span_s */
+  uint8_t nsp_time[4];                   /* up_critmon_gettime() value */
+};
+#endif /* CONFIG_SCHED_SPANS */
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
 
 /* This is the type of the argument passed to the NOTECTL_GETMODE and
@@ -423,6 +474,27 @@ void sched_note_irqhandler(int irq, FAR void *handler, bool enter);
 #  define sched_note_irqhandler(i,h,e)
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SEMSPIN
+void sched_note_semspin(FAR struct tcb_s *tcb, FAR sem_t *sem,
+                        unsigned int nspins, bool acquired);
+#else
+#  define sched_note_semspin(t,s,n,a)
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+void sched_note_string(FAR const char *buf);
+void sched_note_printf(FAR const char *fmt, ...);
+#else
+#  define sched_note_string(b)
+#  define sched_note_printf(f,...)
+#endif
+
+#ifdef CONFIG_SCHED_SPANS
+void sched_note_span(FAR void *span, uint32_t time, bool begin);
+#else
+#  define sched_note_span(s,t,b)
+#endif
+
 #if defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT)
 
 /****************************************************************************
@@ -545,6 +617,10 @@ void sched_note_filter_irq(struct note_filter_irq_s *oldf,
 #  define sched_note_syscall_enter(n,a...)
 #  define sched_note_syscall_leave(n,r)
 #  define sched_note_irqhandler(i,h,e)
+#  define sched_note_semspin(t,s,n,a)
+#  define sched_note_string(b)
+#  define sched_note_printf(f,...)
+#  define sched_note_span(s,t,b)
 
 #endif /* CONFIG_SCHED_INSTRUMENTATION */
 #endif /* __INCLUDE_NUTTX_SCHED_NOTE_H */
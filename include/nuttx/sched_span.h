@@ -0,0 +1,164 @@
+/****************************************************************************
+ * include/nuttx/sched_span.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SCHED_SPAN_H
+#define __INCLUDE_NUTTX_SCHED_SPAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/compiler.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Spans are only available to kernel code */
+
+#if defined(CONFIG_SCHED_SPANS) && \
+    (defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT))
+#  define HAVE_SCHED_SPANS 1
+#endif
+
+/* Number of histogram buckets.  Bucket n counts the spans that took
+ * between 2^(n-1) and 2^n - 1 time units; bucket 0 counts zero durations.
+ */
+
+#define SCHED_SPAN_NBUCKETS 33
+
+/* Usage:
+ *
+ *   SCHED_SPAN_DEFINE(fat_hwread);
+ *
+ *   int fat_hwread(...)
+ *   {
+ *     uint32_t span;
+ *     ...
+ *     span = SCHED_SPAN_BEGIN(fat_hwread);
+ *     ... the code being measured ...
+ *     SCHED_SPAN_END(fat_hwread, span);
+ *   }
+ *
+ * The macros cost nothing when CONFIG_SCHED_SPANS is disabled.
+ */
+
+#ifdef HAVE_SCHED_SPANS
+#  define SCHED_SPAN_DEFINE(n) \
+     static struct sched_span_s g_##n##_span = { #n }
+#  define SCHED_SPAN_BEGIN(n)  sched_span_begin(&g_##n##_span)
+#  define SCHED_SPAN_END(n,s)  sched_span_end(&g_##n##_span, (s))
+#else
+#  define SCHED_SPAN_DEFINE(n)
+#  define SCHED_SPAN_BEGIN(n)  0
+#  define SCHED_SPAN_END(n,s)  UNUSED(s)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Accumulated statistics for one instrumented span of code.  Times are in
+ * the units of up_critmon_gettime().
+ */
+
+struct sched_span_s
+{
+  FAR const char *ss_name;                 /* Name shown in /proc/spans */
+  FAR struct sched_span_s *ss_flink;       /* Next registered span */
+  bool     ss_registered;                  /* True: In g_sched_spans */
+  uint32_t ss_count;                       /* Number of completed spans */
+  uint32_t ss_min;                         /* Shortest duration */
+  uint32_t ss_max;                         /* Longest duration */
+  uint64_t ss_total;                       /* Sum of all durations */
+  uint32_t ss_hist[SCHED_SPAN_NBUCKETS];   /* Histogram of durations */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef HAVE_SCHED_SPANS
+/* The list of spans that have completed at least once */
+
+EXTERN FAR struct sched_span_s *volatile g_sched_spans;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef HAVE_SCHED_SPANS
+
+/****************************************************************************
+ * Name: sched_span_begin
+ *
+ * Description:
+ *   Mark the beginning of one execution of a span of code.
+ *
+ * Input Parameters:
+ *   span - The span being measured
+ *
+ * Returned Value:
+ *   The start time, which must be passed to sched_span_end().
+ *
+ ****************************************************************************/
+
+uint32_t sched_span_begin(FAR struct sched_span_s *span);
+
+/****************************************************************************
+ * Name: sched_span_end
+ *
+ * Description:
+ *   Mark the end of one execution of a span of code and account for its
+ *   duration.
+ *
+ * Input Parameters:
+ *   span  - The span being measured
+ *   start - The value returned by the matching sched_span_begin()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_span_end(FAR struct sched_span_s *span, uint32_t start);
+
+#endif /* HAVE_SCHED_SPANS */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_SCHED_SPAN_H */
@@ -415,6 +415,7 @@
 #define SDIO_CAPS_DMABEFOREWRITE  0x04 /* Bit 2=1: Executes DMA before write command */
 #define SDIO_CAPS_4BIT            0x08 /* Bit 3=1: Supports 4 bit operation */
 #define SDIO_CAPS_8BIT            0x10 /* Bit 4=1: Supports 8 bit operation */
+#define SDIO_CAPS_HIGHSPEED       0x20 /* Bit 5=1: Supports CLOCK_SD_TRANSFER_HS */
 
 /****************************************************************************
  * Name: SDIO_STATUS
@@ -871,7 +872,8 @@ enum sdio_clock_e
   CLOCK_IDMODE,            /* Initial ID mode clocking (<400KHz) */
   CLOCK_MMC_TRANSFER,      /* MMC normal operation clocking */
   CLOCK_SD_TRANSFER_1BIT,  /* SD normal operation clocking (narrow 1-bit mode) */
-  CLOCK_SD_TRANSFER_4BIT   /* SD normal operation clocking (wide 4-bit mode) */
+  CLOCK_SD_TRANSFER_4BIT,  /* SD normal operation clocking (wide 4-bit mode) */
+  CLOCK_SD_TRANSFER_HS     /* SD high speed clocking (wide 4-bit mode, 50MHz) */
 };
 
 /* Event set.  A uint8_t is big enough to hold a set of 8-events.  If more
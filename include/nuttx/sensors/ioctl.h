@@ -227,4 +227,15 @@
 #define SNIOC_SET_RESOLUTION       _SNIOC(0x0065) /* Arg: uint8_t value */
 #define SNIOC_SET_RANGE            _SNIOC(0x0066) /* Arg: uint8_t value */
 
+/* IOCTL commands of sensors using the common FIFO support (sensor_fifo.h) */
+
+#define SNIOC_SET_WATERMARK        _SNIOC(0x0067) /* Arg: unsigned int value */
+#define SNIOC_GET_WATERMARK        _SNIOC(0x0068) /* Arg: unsigned int* pointer */
+#define SNIOC_FIFO_FLUSH           _SNIOC(0x0069) /* Arg: None */
+#define SNIOC_GET_OVERRUNS         _SNIOC(0x006a) /* Arg: uint32_t* pointer */
+
+/* Generic sensor upper half */
+
+#define SNIOC_SET_INTERVAL         _SNIOC(0x006b) /* Arg: unsigned long* pointer */
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/* Generic sensor upper half:
+ *
+ * The lower half (the chip driver) reads the hardware and publishes
+ * fixed-size events with lower->push_event().  The upper half keeps the
+ * last 'nbuffer' events in a ring shared by all readers.  Every open()
+ * of the device creates a subscriber with its own read cursor, so any
+ * number of consumers (an estimator, a logger, telemetry, ...) receive
+ * every event while the hardware is read only once.
+ *
+ * A subscriber that falls behind by more than 'nbuffer' events loses the
+ * oldest ones; the number lost is returned by SNIOC_GET_OVERRUNS.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct sensor_lowerhalf_s;
+
+/* The lower half methods.  All are optional. */
+
+struct sensor_ops_s
+{
+  /* Start (enable = true) or stop sampling.  Called when the first
+   * subscriber opens the device and when the last one closes it.
+   */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Set the sampling interval.  The lower half may round it to what the
+   * hardware supports and returns the actual value in *period_us.
+   */
+
+  CODE int (*set_interval)(FAR struct sensor_lowerhalf_s *lower,
+                           FAR unsigned long *period_us);
+
+  /* Any other ioctl command */
+
+  CODE int (*control)(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                      unsigned long arg);
+};
+
+/* Publish 'bytes' bytes of events (a multiple of the event size).  Must be
+ * called from thread context (e.g., the work queue that reads the chip).
+ */
+
+typedef CODE void (*sensor_push_event_t)(FAR void *priv,
+                                         FAR const void *data,
+                                         size_t bytes);
+
+struct sensor_lowerhalf_s
+{
+  FAR const struct sensor_ops_s *ops; /* Set by the lower half */
+
+  /* Set by sensor_register() */
+
+  sensor_push_event_t push_event;     /* Publishes events */
+  FAR void *priv;                     /* First argument of push_event */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor character device backed by the generic upper half.
+ *
+ * Input Parameters:
+ *   lower   - The lower half instance
+ *   path    - The device path, e.g. "/dev/accel0"
+ *   esize   - The size of one event published by the lower half
+ *   nbuffer - The number of events kept in the shared ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower,
+                    FAR const char *path, size_t esize,
+                    unsigned int nbuffer);
+
+/****************************************************************************
+ * Name: sensor_unregister
+ *
+ * Description:
+ *   Unregister the device and free the upper half.
+ *
+ ****************************************************************************/
+
+void sensor_unregister(FAR struct sensor_lowerhalf_s *lower,
+                       FAR const char *path);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_UPPER */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
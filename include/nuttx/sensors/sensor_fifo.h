@@ -0,0 +1,245 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor_fifo.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_FIFO_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_FIFO_H
+
+/* Common support for sensors with a hardware FIFO:
+ *
+ * The driver programs the FIFO watermark of the chip and calls
+ * sensor_fifo_interrupt() from the watermark interrupt handler.  The
+ * interrupt is time stamped and a work queue thread reads the whole burst
+ * from the chip with the drain() method.  Every sample gets a time stamp
+ * interpolated from the interrupt times, and the samples are appended to a
+ * software ring buffer.
+ *
+ * The driver's read() and poll() methods simply call sensor_fifo_read()
+ * and sensor_fifo_poll():  Readers get all samples buffered so far (as an
+ * array of records, see below) with one call, instead of one sample per
+ * system call.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <poll.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_SENSORS_FIFO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of one record returned by sensor_fifo_read():  A uint64_t time
+ * stamp (microseconds since boot) followed by the sample as read by the
+ * driver, padded to keep the time stamps aligned.
+ */
+
+#define SENSOR_FIFO_RECSIZE(samplesize) \
+  (sizeof(uint64_t) + (((samplesize) + 7) & ~7))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct sensor_fifo_s;
+
+/* Provided by the sensor driver.  Both methods are called from the work
+ * queue thread (or from the caller of sensor_fifo_setwatermark()).
+ */
+
+struct sensor_fifo_ops_s
+{
+  /* Program the hardware FIFO to interrupt when 'nsamples' samples are
+   * buffered.  Zero disables the FIFO (and its interrupt).
+   */
+
+  CODE int (*setwatermark)(FAR struct sensor_fifo_s *fifo,
+                           unsigned int nsamples);
+
+  /* Read up to 'nsamples' samples from the hardware FIFO with one burst
+   * transfer.  Returns the number of samples read or a negated errno.
+   */
+
+  CODE int (*drain)(FAR struct sensor_fifo_s *fifo, FAR void *buffer,
+                    unsigned int nsamples);
+};
+
+/* The state of one sensor FIFO.  Embedded in the driver's device structure
+ * and initialized with sensor_fifo_initialize().
+ */
+
+struct sensor_fifo_s
+{
+  FAR const struct sensor_fifo_ops_s *ops;
+  FAR void *priv;                 /* For use by the driver */
+
+  size_t samplesize;              /* Bytes per sample read by drain() */
+  size_t recsize;                 /* Bytes per record in 'buffer' */
+  unsigned int nrecords;          /* Capacity of 'buffer' (records) */
+  unsigned int maxburst;          /* Depth of the hardware FIFO (samples) */
+  unsigned int watermark;         /* Current watermark (samples) */
+  volatile unsigned int head;     /* Next record to write */
+  volatile unsigned int tail;     /* Next record to read */
+  uint32_t overruns;              /* Samples dropped because nobody read */
+
+  uint64_t irqtime;               /* Time of the last interrupt (usec) */
+  uint64_t lasttime;              /* Time stamp of the last sample (usec) */
+
+  FAR uint8_t *buffer;            /* Ring of records */
+  FAR uint8_t *burst;             /* Burst buffer for drain() */
+
+  sem_t exclsem;                  /* Protects the ring and the fds */
+  sem_t waitsem;                  /* Wakes up a blocked reader */
+  bool waiting;                   /* A reader waits on waitsem */
+  struct work_s work;             /* Drains the hardware FIFO */
+
+  FAR struct pollfd *fds[CONFIG_SENSORS_FIFO_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_fifo_initialize
+ *
+ * Description:
+ *   Initialize a sensor FIFO and allocate its buffers.
+ *
+ * Input Parameters:
+ *   fifo       - The FIFO to initialize
+ *   ops        - The driver methods
+ *   priv       - Driver data, available as fifo->priv
+ *   samplesize - Bytes per sample as read from the chip
+ *   nrecords   - Number of samples buffered in software
+ *   maxburst   - Depth of the hardware FIFO in samples
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_initialize(FAR struct sensor_fifo_s *fifo,
+                           FAR const struct sensor_fifo_ops_s *ops,
+                           FAR void *priv, size_t samplesize,
+                           unsigned int nrecords, unsigned int maxburst);
+
+/****************************************************************************
+ * Name: sensor_fifo_uninitialize
+ *
+ * Description:
+ *   Disable the hardware FIFO and free the buffers.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_uninitialize(FAR struct sensor_fifo_s *fifo);
+
+/****************************************************************************
+ * Name: sensor_fifo_setwatermark
+ *
+ * Description:
+ *   Set the number of samples collected by the chip before it interrupts.
+ *   The value is limited to the depth of the hardware FIFO.  Zero disables
+ *   the FIFO.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_setwatermark(FAR struct sensor_fifo_s *fifo,
+                             unsigned int nsamples);
+
+/****************************************************************************
+ * Name: sensor_fifo_interrupt
+ *
+ * Description:
+ *   Called by the driver from its watermark interrupt handler.  Records the
+ *   time of the interrupt and schedules the burst read.
+ *
+ ****************************************************************************/
+
+void sensor_fifo_interrupt(FAR struct sensor_fifo_s *fifo);
+
+/****************************************************************************
+ * Name: sensor_fifo_read
+ *
+ * Description:
+ *   Copy as many complete records (see SENSOR_FIFO_RECSIZE) as fit into
+ *   'buffer', waiting for at least one unless 'nonblock' is true.
+ *
+ * Returned Value:
+ *   The number of bytes copied; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_fifo_read(FAR struct sensor_fifo_s *fifo, FAR char *buffer,
+                         size_t buflen, bool nonblock);
+
+/****************************************************************************
+ * Name: sensor_fifo_poll
+ *
+ * Description:
+ *   Implements the poll() method of a driver using a sensor FIFO.  POLLIN
+ *   is reported while records are buffered.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_poll(FAR struct sensor_fifo_s *fifo, FAR struct pollfd *fds,
+                     bool setup);
+
+/****************************************************************************
+ * Name: sensor_fifo_ioctl
+ *
+ * Description:
+ *   Handle the FIFO-related sensor ioctl commands:  SNIOC_SET_WATERMARK,
+ *   SNIOC_GET_WATERMARK, SNIOC_FIFO_FLUSH and SNIOC_GET_OVERRUNS.
+ *
+ * Returned Value:
+ *   -ENOTTY if the command is not FIFO-related and must be handled by the
+ *   driver.
+ *
+ ****************************************************************************/
+
+int sensor_fifo_ioctl(FAR struct sensor_fifo_s *fifo, int cmd,
+                      unsigned long arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_FIFO */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_FIFO_H */
@@ -52,6 +52,9 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/semaphore.h>
+#ifdef CONFIG_SERIAL_ICOUNT
+#  include <nuttx/serial/tioctl.h>
+#endif
 
 /************************************************************************************
  * Pre-processor Definitions
@@ -147,11 +150,12 @@ struct uart_buffer_s
 #if defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_TXDMA)
 struct uart_dmaxfer_s
 {
-  FAR char        *buffer;  /* First DMA buffer */
-  FAR char        *nbuffer; /* Next DMA buffer */
-  size_t           length;  /* Length of first DMA buffer */
-  size_t           nlength; /* Length of next DMA buffer */
-  size_t           nbytes;  /* Bytes actually transferred by DMA from both buffers */
+  FAR char        *buffer;    /* First DMA buffer */
+  FAR char        *nbuffer;   /* Next DMA buffer */
+  size_t           length;    /* Length of first DMA buffer */
+  size_t           nlength;   /* Length of next DMA buffer */
+  size_t           nbytes;    /* Bytes transferred by DMA from both buffers */
+  size_t           nreported; /* Bytes of nbytes already reported */
 };
 #endif /* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA */
 
@@ -270,6 +274,22 @@ struct uart_ops_s
    */
 
   CODE bool (*txempty)(FAR struct uart_dev_s *dev);
+
+#ifdef CONFIG_SERIAL_DIRECTIO
+  /* Optional.  Transfer data directly between the caller's buffer and the
+   * lower half, by-passing the serial buffers.  These are only called for
+   * blocking I/O without input/output processing and while the respective
+   * buffer is empty.  Both may block until the transfer is complete.  They
+   * return the number of bytes transferred, zero if the lower half cannot
+   * handle this buffer (the data then goes through the serial buffers as
+   * usual), or a negated errno value.
+   */
+
+  CODE ssize_t (*directwrite)(FAR struct uart_dev_s *dev,
+                              FAR const char *buffer, size_t buflen);
+  CODE ssize_t (*directread)(FAR struct uart_dev_s *dev,
+                             FAR char *buffer, size_t buflen);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -289,6 +309,7 @@ struct uart_dev_s
   uint8_t              open_count;   /* Number of times the device has been opened */
   volatile bool        xmitwaiting;  /* true: User waiting for space in xmit.buffer */
   volatile bool        recvwaiting;  /* true: User waiting for data in recv.buffer */
+  volatile int16_t     recvmin;      /* Bytes buffered before a waiting reader is woken */
 #ifdef CONFIG_SERIAL_REMOVABLE
   volatile bool        disconnected; /* true: Removable device is not connected */
 #endif
@@ -300,6 +321,8 @@ struct uart_dev_s
   tcflag_t             tc_iflag;     /* Input modes */
   tcflag_t             tc_oflag;     /* Output modes */
   tcflag_t             tc_lflag;     /* Local modes */
+  cc_t                 tc_vmin;      /* c_cc[VMIN]: Minimum bytes for a read */
+  cc_t                 tc_vtime;     /* c_cc[VTIME]: Read timeout (deciseconds) */
 #if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
   pid_t                pid;          /* Thread PID to receive signals (-1 if none) */
 #endif
@@ -312,6 +335,14 @@ struct uart_dev_s
   sem_t                recvsem;      /* Wakeup user waiting for data in recv.buffer */
   sem_t                pollsem;      /* Manages exclusive access to fds[] */
 
+#ifdef CONFIG_SERIAL_ICOUNT
+  /* Statistics returned by TIOCGICOUNT.  The lower half increments the
+   * error counters directly.
+   */
+
+  struct serial_icounter_struct icount;
+#endif
+
   /* I/O buffers */
 
   struct uart_buffer_s xmit;         /* Describes transmit buffer */
@@ -495,6 +526,27 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/************************************************************************************
+ * Name: uart_recvchars_update
+ *
+ * Description:
+ *   Report the progress of a receive DMA transfer that is still running.
+ *   The lower half sets dmarx.nbytes to the number of bytes transferred so
+ *   far and calls this function from its half-transfer interrupt or when it
+ *   detects that the RX line went idle.  The new bytes are made available
+ *   to readers without stopping the DMA; uart_recvchars_done() then
+ *   accounts only for the bytes that were not reported yet.
+ *
+ *   A waiting reader is woken when its VMIN threshold is reached or, if
+ *   'idle' is true, as soon as any data is available:  An idle line marks
+ *   the end of a burst and no more data is to be expected for now.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_update(FAR uart_dev_t *dev, bool idle);
+#endif
+
 /************************************************************************************
  * Name: uart_reset_sem
  *
@@ -237,6 +237,27 @@ struct serial_rs485
   uint32_t delay_rts_after_send;   /* Delay after send (milliseconds) */
 };
 
+/* Structure used with TIOCGICOUNT (Linux compatible).  The upper half
+ * serial driver counts rx, tx and buf_overrun; the remaining counters are
+ * maintained by lower half drivers that can detect the event.
+ */
+
+struct serial_icounter_struct
+{
+  int cts;                         /* CTS transitions */
+  int dsr;                         /* DSR transitions */
+  int rng;                         /* RI transitions */
+  int dcd;                         /* DCD transitions */
+  int rx;                          /* Bytes received */
+  int tx;                          /* Bytes transmitted */
+  int frame;                       /* Framing errors */
+  int overrun;                     /* Hardware (FIFO or DMA) overruns */
+  int parity;                      /* Parity errors */
+  int brk;                         /* Break conditions */
+  int buf_overrun;                 /* Bytes lost because the RX buffer was full */
+  int reserved[9];
+};
+
 /********************************************************************************************
  * Public Function Prototypes
  ********************************************************************************************/
@@ -235,6 +235,58 @@
 
 #define QSPI_FREE(d,b) (d)->ops->free(d,b)
 
+/****************************************************************************
+ * Name: QSPI_MMAP
+ *
+ * Description:
+ *   Put the controller into memory-mapped mode.  Reads from the returned
+ *   window are translated by the hardware into the memory read command
+ *   described by meminfo (flags, cmd, addrlen and dummies are used; addr,
+ *   buflen and buffer are ignored).  The window maps memory address zero.
+ *
+ *   The bus must be locked.  No QSPI_COMMAND or QSPI_MEMORY may be issued
+ *   until QSPI_MUNMAP is called.  The caller is responsible for
+ *   invalidating any data cache lines covering the window after the
+ *   memory content changes.  This method is optional.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the memory read command
+ *
+ * Returned Value:
+ *   Address of the memory-mapped window; NULL if memory-mapped mode is
+ *   not supported.
+ *
+ ****************************************************************************/
+
+#define QSPI_MMAP(d,m) \
+  ((d)->ops->mmap ? (d)->ops->mmap(d,m) : NULL)
+
+/****************************************************************************
+ * Name: QSPI_MUNMAP
+ *
+ * Description:
+ *   Leave memory-mapped mode so that commands can be issued again.  The
+ *   bus must be locked.
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#define QSPI_MUNMAP(d) \
+  do \
+    { \
+      if ((d)->ops->munmap) \
+        { \
+          (d)->ops->munmap(d); \
+        } \
+    } \
+  while (0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -292,6 +344,9 @@ struct qspi_ops_s
                     FAR struct qspi_meminfo_s *meminfo);
   CODE FAR void *(*alloc)(FAR struct qspi_dev_s *dev, size_t buflen);
   CODE void      (*free)(FAR struct qspi_dev_s *dev, FAR void *buffer);
+  CODE FAR void *(*mmap)(FAR struct qspi_dev_s *dev,
+                    FAR const struct qspi_meminfo_s *meminfo);
+  CODE void      (*munmap)(FAR struct qspi_dev_s *dev);
 };
 
 /* QSPI private data.  This structure only defines the initial fields of the
@@ -449,6 +449,32 @@
 #  define SPI_TRIGGER(d) \
   (((d)->ops->trigger) ? ((d)->ops->trigger(d)) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_TRANSFER_ASYNC
+ *
+ * Description:
+ *   Queue a sequence of transfers (see include/nuttx/spi/spi_transfer.h)
+ *   and return without waiting for it.  Lower half drivers that can chain
+ *   DMA descriptors implement this method to run the queued sequences back
+ *   to back, including the chip select changes, and call req->callback
+ *   from the completion interrupt.  Optional:  Use spi_transfer_async(),
+ *   which falls back to a work queue if the method is not provided.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to queue.  It belongs to the driver until the
+ *         callback was called.
+ *
+ * Returned Value:
+ *   OK if the request was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+#  define SPI_TRANSFER_ASYNC(d,r) \
+  (((d)->ops->transfer_async) ? ((d)->ops->transfer_async(d,r)) : -ENOSYS)
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -552,6 +578,10 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+#ifdef CONFIG_SPI_ASYNC
+struct spi_async_s;
+#endif
+
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -590,6 +620,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_ASYNC
+  CODE int      (*transfer_async)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_async_s *req);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
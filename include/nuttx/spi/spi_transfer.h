@@ -125,6 +125,37 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence of SPI transactions queued with
+ * spi_transfer_async().  The callback is invoked once the whole sequence
+ * completed or failed; it may run on a work queue thread or in the
+ * interrupt handler of the SPI driver and must not block.
+ *
+ * Example usage:
+ *   static void mycallback(FAR struct spi_async_s *req, int result)
+ *   {
+ *     nxsem_post((FAR sem_t *)req->arg);
+ *   }
+ *   ...
+ *   myreq.seq      = &myseq;
+ *   myreq.callback = mycallback;
+ *   myreq.arg      = &mysem;
+ *   int ret = spi_transfer_async(spi, &myreq);
+ */
+
+struct spi_async_s;
+typedef CODE void (*spi_async_callback_t)(FAR struct spi_async_s *req,
+                                          int result);
+
+struct spi_async_s
+{
+  FAR struct spi_async_s *flink;  /* Used by the queue: Do not touch */
+  FAR struct spi_sequence_s *seq; /* The sequence of transfers */
+  spi_async_callback_t callback;  /* Called with OK or a negated errno */
+  FAR void *arg;                  /* Argument for the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -148,6 +179,33 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return immediately.  The requests
+ *   queued for one SPI bus are performed in order; req->callback is called
+ *   when a request completed.  If the SPI driver provides the
+ *   transfer_async() method, the request is passed to it (typically to be
+ *   executed with chained DMA).  Otherwise the sequence is performed with
+ *   spi_transfer() on a work queue thread.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   req - Describes the request.  The structure must remain valid until
+ *         the callback was called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *   The callback is not called if the request could not be queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_async_s *req);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
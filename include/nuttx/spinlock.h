@@ -96,6 +96,33 @@
 #  define SP_SECTION
 #endif
 
+#ifdef CONFIG_SMP
+#  define SPINLOCK_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define SPINLOCK_NCPUS 1
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+/* Per-CPU spinlock contention counters */
+
+struct spinlock_stats_s
+{
+  uint32_t nlocks;     /* Number of spinlocks acquired */
+  uint32_t ncontended; /* Number of acquisitions that had to wait */
+  uint32_t nspins;     /* Number of polling iterations spent waiting */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern struct spinlock_stats_s g_spinlock_stats[SPINLOCK_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
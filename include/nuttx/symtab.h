@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -70,6 +72,24 @@ struct symtab_s
   FAR const void *sym_value;         /* The value associated with the string */
 };
 
+#ifdef CONFIG_SYMTAB_HASH
+/* struct symtab_hash_s is a hash index built at run time over a symbol
+ * table, in the spirit of the ELF DT_GNU_HASH section.  The symbol table
+ * is not modified.  The index holds the 32-bit hash of every name, so a
+ * lookup compares strings only when the hashes already match.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int nsyms;                         /* Number of entries in symtab */
+  unsigned int nbuckets;             /* Number of buckets (power of two) */
+  FAR int *buckets;                  /* First symbol index of each bucket */
+  FAR uint32_t *hashes;              /* Hash of each symbol name */
+  FAR int *chain;                    /* Next symbol index in the bucket */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -150,6 +170,59 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_HASH
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   Return the hash of a symbol name (the DT_GNU_HASH function).
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hashname(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index over the symbol table.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int symtab_hashinit(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hashuninit
+ *
+ * Description:
+ *   Free the memory held by a hash index.
+ *
+ ****************************************************************************/
+
+void symtab_hashuninit(FAR struct symtab_hash_s *hash);
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name in a hashed symbol table.
+ *   'value' must be symtab_hashname(name).
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name, uint32_t value);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -79,6 +79,9 @@ struct tls_info_s
   uintptr_t tl_elem[CONFIG_TLS_NELEM]; /* TLS elements */
 #endif
   int tl_errno;                        /* Per-thread error number */
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+  pid_t tl_pid;                        /* Thread ID of the owner */
+#endif
 };
 
 /****************************************************************************
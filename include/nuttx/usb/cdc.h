@@ -57,7 +57,8 @@
 #define CDC_SUBCLASS_CAPI       0x05 /* CAPI Control Model */
 #define CDC_SUBCLASS_ECM        0x06 /* Ethernet Networking Control Model */
 #define CDC_SUBCLASS_ATM        0x07 /* ATM Networking Control Model */
-                                     /* 0x08-0x0d Reserved (future use) */
+                                     /* 0x08-0x0c Reserved (future use) */
+#define CDC_SUBCLASS_NCM        0x0d /* Network Control Model */
 #define CDC_SUBCLASS_MBIM       0x0e /* MBIM Control Model */
                                      /* 0x0f-0x7f Reserved (future use) */
                                      /* 0x80-0xfe Reserved (vendor specific) */
@@ -84,7 +85,8 @@
 /* Table 19: Data Interface Class Protocol Codes */
 
 #define CDC_DATA_PROTO_NONE     0x00 /* No class specific protocol required */
-                                     /* 0x01-0x2f Reserved (future use) */
+#define CDC_DATA_PROTO_NCM      0x01 /* Network Transfer Block protocol (NCM) */
+                                     /* 0x03-0x2f Reserved (future use) */
 #define CDC_DATA_PROTO_NTB      0x02 /* Network Transfer Block protocol */
 #define CDC_DATA_PROTO_ISDN     0x30 /* Physical interface protocol for ISDN BRI */
 #define CDC_DATA_PROTO_HDLC     0x31 /* HDLC */
@@ -328,6 +330,29 @@
                                       */
 #define ECM_SPEED_CHANGE        ATM_SPEED_CHANGE
 
+/* [NCM1.0] Table 6-2: Requests, Network Control Model */
+
+#define NCM_GET_NTB_PARAMETERS    0x80 /* Get NTB parameters (Required) */
+#define NCM_GET_NET_ADDRESS       0x81 /* Get EUI-48 address (Optional) */
+#define NCM_SET_NET_ADDRESS       0x82 /* Set EUI-48 address (Optional) */
+#define NCM_GET_NTB_FORMAT        0x83 /* Get NTB format (Optional) */
+#define NCM_SET_NTB_FORMAT        0x84 /* Set NTB format (Optional) */
+#define NCM_GET_NTB_INPUT_SIZE    0x85 /* Get IN NTB size (Required) */
+#define NCM_SET_NTB_INPUT_SIZE    0x86 /* Set IN NTB size (Required) */
+#define NCM_GET_MAX_DATAGRAM_SIZE 0x87 /* Get max datagram size (Optional) */
+#define NCM_SET_MAX_DATAGRAM_SIZE 0x88 /* Set max datagram size (Optional) */
+#define NCM_GET_CRC_MODE          0x89 /* Get CRC mode (Optional) */
+#define NCM_SET_CRC_MODE          0x8a /* Set CRC mode (Optional) */
+
+/* [NCM1.0] Network Transfer Blocks */
+
+#define NCM_NTB_FORMAT_16         0x0000     /* NTB-16 (always supported) */
+#define NCM_NTB_FORMAT_32         0x0001     /* NTB-32 */
+
+#define NCM_NTH16_SIGNATURE       0x484d434e /* "NCMH" */
+#define NCM_NDP16_NOCRC_SIGNATURE 0x304d434e /* "NCM0" */
+#define NCM_NDP16_CRC_SIGNATURE   0x314d434e /* "NCM1" */
+
 /* Descriptors ***************************************************************/
 
 /* Table 25: bDescriptor SubType in Functional Descriptors */
@@ -352,6 +377,7 @@
 #define CDC_DSUBTYPE_CAPI       0x0e /* CAPI Control Management Functional Descriptor */
 #define CDC_DSUBTYPE_ECM        0x0f /* Ethernet Networking Functional Descriptor */
 #define CDC_DSUBTYPE_ATM        0x10 /* ATM Networking Functional Descriptor */
+#define CDC_DSUBTYPE_NCM        0x1a /* NCM Functional Descriptor */
 #define CDC_DSUBTYPE_MBIM       0x1b /* MBIM Functional Descriptor */
                                      /* 0x11-0xff Reserved (future use) */
 
@@ -880,6 +906,26 @@ struct cdc_ecm_funcdesc_s
 
 #define SIZEOF_ECM_FUNCDESC 13
 
+/* [NCM1.0] Table 5-2: NCM Functional Descriptor */
+
+struct cdc_ncm_funcdesc_s
+{
+  uint8_t size;       /* bFunctionLength, Size of this descriptor */
+  uint8_t type;       /* bDescriptorType, USB_DESC_TYPE_CSINTERFACE */
+  uint8_t subtype;    /* bDescriptorSubType, CDC_DSUBTYPE_NCM */
+  uint8_t version[2]; /* bcdNcmVersion, Release of the NCM specification */
+  uint8_t caps;       /* bmNetworkCapabilities, See NCMCAP_* */
+};
+
+#define SIZEOF_NCM_FUNCDESC 6
+
+#define NCMCAP_PACKET_FILTER    (1 << 0) /* SetEthernetPacketFilter */
+#define NCMCAP_NET_ADDRESS      (1 << 1) /* Get/SetNetAddress */
+#define NCMCAP_ENCAPSULATED     (1 << 2) /* Encapsulated commands */
+#define NCMCAP_MAX_DATAGRAM     (1 << 3) /* Get/SetMaxDatagramSize */
+#define NCMCAP_CRC_MODE         (1 << 4) /* Get/SetCrcMode */
+#define NCMCAP_NTB_INPUT_8BYTE  (1 << 5) /* 8-byte GetNtbInputSize */
+
 /* Table 43: ATM Networking Functional Descriptor */
 
 struct cdc_atm_funcdesc_s
@@ -967,6 +1013,56 @@ struct cdc_unitparm_s
 
 /* Table 61: Power Management Pattern Filter Structure */
 
+/* [NCM1.0] Table 6-3: NTB Parameter Structure */
+
+struct cdc_ncm_ntbparms_s
+{
+  uint8_t len[2];           /* wLength, Size of this structure (28) */
+  uint8_t formats[2];       /* bmNtbFormatsSupported, bit 0: 16-bit NTBs,
+                             * bit 1: 32-bit NTBs
+                             */
+  uint8_t inmaxsize[4];     /* dwNtbInMaxSize, Maximum IN NTB size */
+  uint8_t indivisor[2];     /* wNdpInDivisor, IN datagram alignment */
+  uint8_t inremainder[2];   /* wNdpInPayloadRemainder */
+  uint8_t inalignment[2];   /* wNdpInAlignment, IN NDP alignment */
+  uint8_t reserved[2];
+  uint8_t outmaxsize[4];    /* dwNtbOutMaxSize, Maximum OUT NTB size */
+  uint8_t outdivisor[2];    /* wNdpOutDivisor, OUT datagram alignment */
+  uint8_t outremainder[2];  /* wNdpOutPayloadRemainder */
+  uint8_t outalignment[2];  /* wNdpOutAlignment, OUT NDP alignment */
+  uint8_t outmaxdgrams[2];  /* wNtbOutMaxDatagrams, 0: no limit */
+};
+
+#define SIZEOF_NCM_NTBPARMS 28
+
+/* [NCM1.0] Table 3-1: 16-bit NCM Transfer Header (NTH16) */
+
+struct cdc_ncm_nth16_s
+{
+  uint8_t signature[4];     /* dwSignature, NCM_NTH16_SIGNATURE */
+  uint8_t hdrlen[2];        /* wHeaderLength, Size of this header (12) */
+  uint8_t sequence[2];      /* wSequence, NTB sequence number */
+  uint8_t blklen[2];        /* wBlockLength, Size of the NTB */
+  uint8_t ndpindex[2];      /* wNdpIndex, Offset of the first NDP */
+};
+
+#define SIZEOF_NCM_NTH16 12
+
+/* [NCM1.0] Table 3-3: 16-bit NCM Datagram Pointer Table (NDP16).  The
+ * header is followed by wLength / 4 - 2 (index, length) pairs, the last of
+ * which is (0, 0).
+ */
+
+struct cdc_ncm_ndp16_s
+{
+  uint8_t signature[4];     /* dwSignature, NCM_NDP16_*_SIGNATURE */
+  uint8_t len[2];           /* wLength, Size of the NDP (a multiple of 4) */
+  uint8_t nextindex[2];     /* wNextNdpIndex, Offset of the next NDP */
+  uint8_t dgram[1][2][2];   /* wDatagramIndex/wDatagramLength pairs */
+};
+
+#define SIZEOF_NCM_NDP16(n) (8 + 4 * (n))
+
 /* Notification Data Structures **********************************************/
 
 /* Table 72: ConnectionSpeedChange Data Structure */
@@ -48,6 +48,7 @@
 #include <pthread.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 
 #ifdef CONFIG_BUILD_PROTECTED
 
@@ -133,6 +134,12 @@ struct userspace_s
 #ifdef CONFIG_LIB_USRWORK
   CODE int (*work_usrstart)(void);
 #endif
+
+  /* Time page read by clock_gettime() (NULL if not provided) */
+
+#ifdef CONFIG_CLOCK_USERPAGE
+  FAR struct clock_timepage_s *us_timepage;
+#endif
 };
 
 /****************************************************************************
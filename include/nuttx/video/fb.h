@@ -288,6 +288,14 @@
 #endif
 #endif /* CONFIG_FB_OVERLAY */
 
+#ifdef CONFIG_FB_PANDISPLAY
+#  define FBIOPAN_DISPLAY     _FBIOC(0x0012)  /* Pan the display to the
+                                               * xoffset/yoffset of the
+                                               * virtual plane
+                                               * Argument: read-only struct
+                                               *           fb_planeinfo_s */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -322,6 +330,17 @@ struct fb_planeinfo_s
   fb_coord_t stride;      /* Length of a line in bytes */
   uint8_t    display;     /* Display number */
   uint8_t    bpp;         /* Bits per pixel */
+#ifdef CONFIG_FB_PANDISPLAY
+  /* Size of the virtual plane in fbmem (zero if it is the visible size)
+   * and the position of the visible area within it.  A virtual plane twice
+   * as high as the display can be used for double buffering.
+   */
+
+  fb_coord_t xres_virtual;
+  fb_coord_t yres_virtual;
+  fb_coord_t xoffset;
+  fb_coord_t yoffset;
+#endif
 };
 
 /* This structure describes an area. */
@@ -474,6 +493,49 @@ struct fb_setcursor_s
 };
 #endif
 
+#ifdef CONFIG_FB_ACCEL
+/* 2D acceleration provided by the framebuffer driver (e.g., DMA2D or a
+ * pixel processing accelerator).  Every method is optional.  The areas are
+ * in pixels on the plane 'pinfo' and colors and source images are in the
+ * pixel format of that plane; 'srcstride' is the length of one source line
+ * in bytes.
+ *
+ * The operation must be complete when the method returns (the caller may
+ * read the framebuffer immediately) so a driver using DMA will normally
+ * wait for its completion.  A negated errno value (e.g. -ENOTSUP for an
+ * unsupported alignment or size) makes the caller fall back to the software
+ * rasterizer.
+ */
+
+struct fb_vtable_s;
+struct fb_accel_ops_s
+{
+  /* Fill an area with a solid color */
+
+  int (*fillrect)(FAR struct fb_vtable_s *vtable,
+                  FAR const struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, uint32_t color);
+
+  /* Copy an image from memory into an area of the framebuffer.  The
+   * source does not overlap the destination.
+   */
+
+  int (*copyrect)(FAR struct fb_vtable_s *vtable,
+                  FAR const struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, FAR const void *src,
+                  size_t srcstride);
+
+  /* Blend an image from memory over an area of the framebuffer with a
+   * constant alpha (0: transparent, 255: opaque).
+   */
+
+  int (*blend)(FAR struct fb_vtable_s *vtable,
+               FAR const struct fb_planeinfo_s *pinfo,
+               FAR const struct fb_area_s *area, FAR const void *src,
+               size_t srcstride, uint8_t alpha);
+};
+#endif
+
 /* The framebuffer "object" is accessed through within the OS via
  * the following vtable:
  */
@@ -528,6 +590,18 @@ struct fb_vtable_s
   int (*waitforvsync)(FAR struct fb_vtable_s *vtable);
 #endif
 
+#ifdef CONFIG_FB_PANDISPLAY
+  /* Show the area of the virtual plane at pinfo->xoffset/yoffset.  The
+   * hardware should latch the new start address at the next vertical
+   * blanking so that the flip does not tear.  The method returns as soon as
+   * the change is programmed; use waitforvsync() to know that it is
+   * effective.
+   */
+
+  int (*pandisplay)(FAR struct fb_vtable_s *vtable,
+                    FAR struct fb_planeinfo_s *pinfo);
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
   /* Get information about the video controller configuration and the
    * configuration of each overlay.
@@ -585,6 +659,12 @@ struct fb_vtable_s
                FAR const struct fb_overlayblend_s *blend);
 # endif
 #endif
+
+#ifdef CONFIG_FB_ACCEL
+  /* 2D acceleration of the framebuffer memory, NULL if not available */
+
+  FAR const struct fb_accel_ops_s *accel;
+#endif
 };
 
 /****************************************************************************
@@ -42,6 +42,7 @@
 
 #include <nuttx/compiler.h>
 #include <sys/ioctl.h>
+#include <sys/time.h>
 #include <stdint.h>
 
 #include "video_controls.h"
@@ -165,6 +166,18 @@ extern "C"
 
 #define VIDIOC_CANCEL_DQBUF           _VIDIOC(0x0016)
 
+/* Query the offset and size of a V4L2_MEMORY_MMAP buffer
+ *  Address pointing to struct #v4l2_buffer
+ */
+
+#define VIDIOC_QUERYBUF               _VIDIOC(0x0017)
+
+/* Get the frame statistics of a stream
+ *  Address pointing to struct #v4l2_stream_stats
+ */
+
+#define VIDIOC_G_STATS                _VIDIOC(0x0018)
+
 #define VIDEO_HSIZE_QVGA        (320)   /* QVGA    horizontal size */
 #define VIDEO_VSIZE_QVGA        (240)   /* QVGA    vertical   size */
 #define VIDEO_HSIZE_VGA         (640)   /* VGA     horizontal size */
@@ -247,7 +260,9 @@ enum v4l2_buf_type
   V4L2_BUF_TYPE_STILL_CAPTURE        = 0x81  /* single-planar still capture stream */
 };
 
-/* Memory I/O method. Currently, support only V4L2_MEMORY_USERPTR. */
+/* Memory I/O method. Currently, support only V4L2_MEMORY_USERPTR and
+ * V4L2_MEMORY_MMAP (V4L2_MEMORY_MMAP only for V4L2_BUF_TYPE_VIDEO_CAPTURE).
+ */
 
 enum v4l2_memory
 {
@@ -324,9 +339,15 @@ struct v4l2_plane
 typedef struct v4l2_plane v4l2_plane_t;
 
 /* struct v4l2_buffer
- * Parameter of ioctl(VIDIOC_QBUF) and ioctl(VIDIOC_DQBUF).
- * Currently, support only index, type, bytesused, memory,
- * m.userptr, and length.
+ * Parameter of ioctl(VIDIOC_QBUF), ioctl(VIDIOC_DQBUF) and
+ * ioctl(VIDIOC_QUERYBUF).
+ * Currently, support only index, type, bytesused, flags, timestamp,
+ * sequence, memory, m.userptr, m.offset, and length.
+ *
+ * With V4L2_MEMORY_MMAP the driver owns the buffers: the application
+ * only sets index (and type/memory) in VIDIOC_QBUF, and gets m.offset
+ * back from VIDIOC_QUERYBUF and VIDIOC_DQBUF.  The buffer is at that
+ * offset of the area returned by mmap() on the video device.
  */
 
 struct v4l2_buffer
@@ -336,6 +357,7 @@ struct v4l2_buffer
   uint32_t             bytesused; /* Driver sets the image size */
   uint16_t             flags;     /* buffer flags. */
   uint16_t             field;     /* the field order of the image */
+  struct timeval       timestamp; /* Capture end time (CLOCK_MONOTONIC) */
   struct v4l2_timecode timecode;  /* frame timecode */
   uint16_t             sequence;  /* frame sequence number */
   uint16_t             memory;    /* enum #v4l2_memory */
@@ -351,6 +373,26 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_stream_stats
+ * Parameter of ioctl(VIDIOC_G_STATS).  The counters are reset by
+ * VIDIOC_REQBUFS.
+ */
+
+struct v4l2_stream_stats
+{
+  uint32_t type;      /* enum #v4l2_buf_type (set by the application) */
+  uint32_t frames;    /* Number of frames captured without error */
+  uint32_t errors;    /* Number of frames completed with an error */
+  uint32_t dropped;   /* Number of frames overwritten before DQBUF
+                       * (V4L2_BUF_MODE_RING only)
+                       */
+  uint32_t interval;  /* Average time between two frames in usec.
+                       * frames per second is 1000000 / interval.
+                       */
+};
+
+typedef struct v4l2_stream_stats v4l2_stream_stats_t;
+
 struct v4l2_fmtdesc
 {
   uint16_t index;                           /* Format number      */
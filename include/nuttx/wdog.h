@@ -73,11 +73,18 @@ typedef CODE void (*wdentry_t)(wdparm_t arg);
 struct wdog_s
 {
   FAR struct wdog_s *next;       /* Support for singly linked lists. */
+#ifdef CONFIG_WDOG_WHEEL
+  FAR struct wdog_s *prev;       /* Doubly linked timer wheel slot */
+#endif
   wdentry_t          func;       /* Function to execute when delay expires */
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
+#ifdef CONFIG_WDOG_WHEEL
+  clock_t            expire;     /* Absolute expiration time in ticks */
+#else
   int                lag;        /* Timer associated with the delay */
+#endif
   uint8_t            flags;      /* See WDOGF_* definitions above */
   wdparm_t           arg;        /* Callback argument */
 };
@@ -102,7 +102,7 @@ struct bt_buf_s
   } u;
 
   FAR uint8_t *data;     /* Start of data in the buffer */
-  uint8_t len;           /* Length of data in the buffer */
+  uint16_t len;          /* Length of data in the buffer */
   uint8_t pool;          /* Memory pool */
   uint8_t ref;           /* Reference count */
   uint8_t type;          /* Type of data contained in the buffer */
@@ -103,6 +103,7 @@
 /* LE features */
 
 #define BT_HCI_LE_ENCRYPTION     0x01
+#define BT_HCI_LE_DATA_LEN_EXT   0x20  /* LE Data Packet Length Extension */
 
 /* OpCode Group Fields */
 
@@ -163,6 +164,7 @@
 #define BT_HCI_OP_LE_START_ENCRYPTION         BT_OP(BT_OGF_LE, 0x0019)
 #define BT_HCI_OP_LE_LTK_REQ_REPLY            BT_OP(BT_OGF_LE, 0x001a)
 #define BT_HCI_OP_LE_LTK_REQ_NEG_REPLY        BT_OP(BT_OGF_LE, 0x001b)
+#define BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN   BT_OP(BT_OGF_LE, 0x0024)
 
 /* Event definitions */
 
@@ -231,6 +233,12 @@ begin_packed_struct struct bt_hci_cp_host_buffer_size_s
   uint16_t sco_pkts;
 } end_packed_struct;
 
+begin_packed_struct struct bt_hci_cp_le_write_default_data_len_s
+{
+  uint16_t max_tx_octets;
+  uint16_t max_tx_time;
+} end_packed_struct;
+
 begin_packed_struct struct bt_hci_handle_count_s
 {
   uint16_t handle;
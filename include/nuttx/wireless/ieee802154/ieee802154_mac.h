@@ -144,6 +144,7 @@
 #define MAC802154IOC_MLME_DPS_REQUEST          _MAC802154IOC(0x000d)
 #define MAC802154IOC_MLME_SOUNDING_REQUEST     _MAC802154IOC(0x000e)
 #define MAC802154IOC_MLME_CALIBRATE_REQUEST    _MAC802154IOC(0x000f)
+#define MAC802154IOC_GET_TXSTATS               _MAC802154IOC(0x0010)
 
 /* Non-standard MAC ioctl calls */
 
@@ -1702,6 +1703,21 @@ struct ieee802154_primitive_s
   int nclients; /* Number of clients to call ieee802154_primitive_free before freed */
 };
 
+/* Transmit queue statistics, returned by MAC802154IOC_GET_TXSTATS */
+
+struct ieee802154_txstats_s
+{
+  uint32_t queued;    /* Frames put in the CSMA queue */
+  uint32_t sent;      /* Frames sent successfully */
+  uint32_t noack;     /* Frames given up:  No ACK */
+  uint32_t chanfail;  /* Frames given up:  Channel access failure */
+  uint32_t failed;    /* Frames given up for other reasons */
+  uint32_t retries;   /* Retransmissions by the radio or the MAC */
+  uint16_t depth;     /* Frames now waiting in the CSMA queue */
+  uint16_t maxdepth;  /* Most frames ever waiting in the CSMA queue */
+  uint8_t  caps;      /* IEEE802154_RADIOCAP_* bits of the radio */
+};
+
 /* A pointer to this structure is passed as the argument of each IOCTL
  * command.
  */
@@ -1728,6 +1744,9 @@ union ieee802154_macarg_u
   struct sigevent                  event;       /* MAC802154IOC_NOTIFY_REGISTER */
   struct ieee802154_primitive_s    primitive;   /* MAC802154IOC_GET_EVENT */
   bool                             enable;      /* MAC802154IOC_ENABLE_EVENTS */
+#ifdef CONFIG_MAC802154_TXSTATS
+  struct ieee802154_txstats_s      txstats;     /* MAC802154IOC_GET_TXSTATS */
+#endif
 };
 
 #if defined(CONFIG_NET_6LOWPAN) || defined(CONFIG_NET_IEEE802154)
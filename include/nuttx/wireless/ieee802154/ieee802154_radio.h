@@ -53,6 +53,17 @@
  * Pre-Processor Definitions
  ****************************************************************************/
 
+/* Radio capabilities, the bits of the caps field of struct
+ * ieee802154_radio_s.  Frames are retransmitted by the MAC when the radio
+ * does not do so itself.
+ */
+
+#define IEEE802154_RADIOCAP_CSMA       (1 << 0) /* Does CSMA-CA in hardware */
+#define IEEE802154_RADIOCAP_AUTOACK    (1 << 1) /* Sends and awaits ACKs */
+#define IEEE802154_RADIOCAP_RETRY      (1 << 2) /* Retransmits on no ACK */
+#define IEEE802154_RADIOCAP_TXPREFETCH (1 << 3) /* Polls for the next frame
+                                                 * while one is in flight */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -85,6 +96,8 @@ struct ieee802154_txdesc_s
 
   bool ackreq;          /* Are we requesting an ACK? */
   bool framepending;    /* Did the ACK have the frame pending bit set */
+  bool csma;            /* Taken from the CSMA queue */
+  uint8_t  retries;     /* Retransmissions, counted by the radio or MAC */
   uint32_t purgetime;   /* Time to purge transaction */
   uint8_t  retrycount;  /* Number of remaining retries. Set to macMaxFrameRetries
                          * when txdescriptor is allocated
@@ -147,6 +160,13 @@ struct ieee802154_radio_s
   CODE int (*beaconstop)(FAR struct ieee802154_radio_s *radio);
   CODE int (*sfupdate)(FAR struct ieee802154_radio_s *radio,
              FAR const struct ieee802154_superframespec_s *sfspec);
+
+  /* IEEE802154_RADIOCAP_* bits.  A radio with IEEE802154_RADIOCAP_TXPREFETCH
+   * may call poll() again while the previous frame is still in flight, to
+   * load the next frame while the current one is on the air.
+   */
+
+  uint8_t caps;
 };
 
 #ifdef __cplusplus
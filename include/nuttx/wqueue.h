@@ -265,6 +265,19 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   clock_t qtime;         /* Time work queued */
   clock_t delay;         /* Delay until work performed */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  uint8_t cpu;           /* CPU whose HP queue holds the work */
+#endif
+};
+
+/* Describes one entry of a work_queue_batch() request */
+
+struct work_batch_s
+{
+  FAR struct work_s *work; /* The work structure to queue */
+  worker_t  worker;        /* Work callback */
+  FAR void *arg;           /* Callback argument */
+  clock_t delay;           /* Delay until work performed */
 };
 
 /* This is an enumeration of the various events that may be
@@ -368,6 +381,63 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Like work_queue(), but place HPWORK work on the high priority work
+ *   queue of 'cpu' rather than that of the calling CPU.  A driver uses
+ *   this with irq_get_cpu() to keep its bottom half work on the CPU that
+ *   takes its interrupt, even when the work is queued from another CPU.
+ *   Without CONFIG_SCHED_HPWORK_PERCPU, or for other queues, 'cpu' is
+ *   ignored.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   cpu    - The CPU whose high priority work queue is used
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument that will be passed to the worker callback.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay);
+#else
+#  define work_queue_cpu(qid, cpu, work, worker, arg, delay) \
+     work_queue(qid, work, worker, arg, delay)
+#endif
+
+/****************************************************************************
+ * Name: work_queue_batch
+ *
+ * Description:
+ *   Queue several work items on the same work queue at once.  This is
+ *   equivalent to calling work_queue() for each entry in 'batch', but the
+ *   queue is locked once and the worker thread is signaled once for the
+ *   whole batch.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   batch  - The array of work requests
+ *   nbatch - The number of entries in 'batch'
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+int work_queue_batch(int qid, FAR const struct work_batch_s *batch,
+                     int nbatch);
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
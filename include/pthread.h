@@ -285,10 +285,13 @@ typedef struct pthread_condattr_s pthread_condattr_t;
 #define __PTHREAD_CONDATTR_T_DEFINED 1
 #endif
 
+struct pthread_mutex_s;
+
 struct pthread_cond_s
 {
   sem_t sem;
   clockid_t clockid;
+  FAR struct pthread_mutex_s *mutex; /* Mutex used by the waiting threads */
 };
 
 #ifndef __PTHREAD_COND_T_DEFINED
@@ -296,7 +299,7 @@ typedef struct pthread_cond_s pthread_cond_t;
 #define __PTHREAD_COND_T_DEFINED 1
 #endif
 
-#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), CLOCK_REALTIME }
+#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), CLOCK_REALTIME, NULL}
 
 struct pthread_mutexattr_s
 {
@@ -400,11 +403,13 @@ typedef bool pthread_once_t;
 
 struct pthread_rwlock_s
 {
-  pthread_mutex_t lock;
-  pthread_cond_t  cv;
-  unsigned int num_readers;
-  unsigned int num_writers;
-  bool write_in_progress;
+  pthread_mutex_t lock;        /* Protects the fields below */
+  sem_t rdsem;                 /* Readers wait here to be granted the lock */
+  sem_t wrsem;                 /* Writers wait here to be granted the lock */
+  unsigned int num_readers;    /* Number of readers holding the lock */
+  unsigned int num_writers;    /* Number of writers waiting for the lock */
+  unsigned int wait_readers;   /* Number of readers waiting for the lock */
+  bool write_in_progress;      /* A writer holds the lock */
 };
 
 typedef struct pthread_rwlock_s pthread_rwlock_t;
@@ -412,8 +417,9 @@ typedef struct pthread_rwlock_s pthread_rwlock_t;
 typedef int pthread_rwlockattr_t;
 
 #define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
-                                     PTHREAD_COND_INITIALIZER, \
-                                     0, 0, false}
+                                     SEM_INITIALIZER(0), \
+                                     SEM_INITIALIZER(0), \
+                                     0, 0, 0, false}
 
 #ifdef CONFIG_PTHREAD_SPINLOCKS
 #ifndef __PTHREAD_SPINLOCK_T_DEFINED
@@ -58,6 +58,9 @@
 
 #define PRIOINHERIT_FLAGS_DISABLE (1 << 0)  /* Bit 0: Priority inheritance
                                              * is disabled for this semaphore. */
+#define PRIOINHERIT_FLAGS_MUTEX   (1 << 1)  /* Bit 1: The semaphore is the
+                                             * core of a mutex_t and has at
+                                             * most one holder. */
 
 /****************************************************************************
  * Public Type Declarations
@@ -138,6 +138,9 @@ int    feof(FAR FILE *stream);
 int    ferror(FAR FILE *stream);
 int    fileno(FAR FILE *stream);
 int    fgetc(FAR FILE *stream);
+void   flockfile(FAR FILE *stream);
+int    ftrylockfile(FAR FILE *stream);
+void   funlockfile(FAR FILE *stream);
 int    fgetpos(FAR FILE *stream, FAR fpos_t *pos);
 FAR char *fgets(FAR char *s, int n, FAR FILE *stream);
 FAR FILE *fopen(FAR const char *path, FAR const char *type);
@@ -171,6 +174,19 @@ int    setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size);
 
 int    ungetc(int c, FAR FILE *stream);
 
+/* Stream operations without locking, for use within flockfile() and
+ * funlockfile() or on streams that are not shared.
+ */
+
+int    getc_unlocked(FAR FILE *stream);
+int    getchar_unlocked(void);
+int    putc_unlocked(int c, FAR FILE *stream);
+int    putchar_unlocked(int c);
+size_t fread_unlocked(FAR void *ptr, size_t size, size_t n_items,
+         FAR FILE *stream);
+size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
+         FAR FILE *stream);
+
 /* Operations on the stdout stream, buffers, paths,
  * and the whole printf-family
  */
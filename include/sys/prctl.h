@@ -82,12 +82,26 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME_EXT, myname, pid);
+ *
+ *  PR_SET_TIMERSLACK
+ *    Set the timer slack of the calling thread to the number of nanoseconds
+ *    in (unsigned long) arg2.  The timed waits of the thread may expire
+ *    late by up to this amount so that they can be coalesced with other
+ *    timer expirations.  A value of zero restores the default slack.
+ *    Requires CONFIG_SCHED_TICKLESS_SLACK.  As an example:
+ *
+ *      prctl(PR_SET_TIMERSLACK, 2000000ul);
+ *
+ *  PR_GET_TIMERSLACK
+ *    Return the timer slack of the calling thread in nanoseconds.
  */
 
-#define PR_SET_NAME     1
-#define PR_GET_NAME     2
-#define PR_SET_NAME_EXT 3
-#define PR_GET_NAME_EXT 4
+#define PR_SET_NAME       1
+#define PR_GET_NAME       2
+#define PR_SET_NAME_EXT   3
+#define PR_GET_NAME_EXT   4
+#define PR_SET_TIMERSLACK 5
+#define PR_GET_TIMERSLACK 6
 
 /****************************************************************************
  * Public Type Definitions
@@ -117,6 +131,7 @@ extern "C"
  * Returned Value:
  *   The returned value may depend on the specific command.  For PR_SET_NAME
  *   and PR_GET_NAME, the returned value of 0 indicates successful operation.
+ *   PR_GET_TIMERSLACK returns the timer slack in nanoseconds.
  *   On any failure, -1 is retruend and the errno value is set appropriately.
  *
  *     EINVAL The value of 'option' is not recognized.
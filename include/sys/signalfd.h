@@ -0,0 +1,75 @@
+/****************************************************************************
+ * include/sys/signalfd.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_SIGNALFD_H
+#define __INCLUDE_SYS_SIGNALFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <signal.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SFD_NONBLOCK  O_NONBLOCK
+#define SFD_CLOEXEC   O_CLOEXEC
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* One of these is returned by read() for each signal dequeued */
+
+struct signalfd_siginfo
+{
+  uint32_t ssi_signo;   /* Signal number */
+  int32_t  ssi_errno;   /* Error number (unused) */
+  int32_t  ssi_code;    /* Signal code */
+  uint32_t ssi_pid;     /* PID of sender */
+  int32_t  ssi_status;  /* Exit status or signal (SIGCHLD) */
+  int32_t  ssi_int;     /* Integer sent by sigqueue() */
+  uint64_t ssi_ptr;     /* Pointer sent by sigqueue() */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+int signalfd(int fd, FAR const sigset_t *mask, int flags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_SIGNALFD_H */
@@ -122,22 +122,23 @@
  * recognized by Linux, not all are supported by NuttX.
  */
 
-#define MSG_OOB        0x0001 /* Process out-of-band data.  */
-#define MSG_PEEK       0x0002 /* Peek at incoming messages.  */
-#define MSG_DONTROUTE  0x0004 /* Don't use local routing.  */
-#define MSG_CTRUNC     0x0008 /* Control data lost before delivery.  */
-#define MSG_PROXY      0x0010 /* Supply or ask second address.  */
+#define MSG_OOB        0x0001  /* Process out-of-band data.  */
+#define MSG_PEEK       0x0002  /* Peek at incoming messages.  */
+#define MSG_DONTROUTE  0x0004  /* Don't use local routing.  */
+#define MSG_CTRUNC     0x0008  /* Control data lost before delivery.  */
+#define MSG_PROXY      0x0010  /* Supply or ask second address.  */
 #define MSG_TRUNC      0x0020
-#define MSG_DONTWAIT   0x0040 /* Enable nonblocking IO.  */
-#define MSG_EOR        0x0080 /* End of record.  */
-#define MSG_WAITALL    0x0100 /* Wait for a full request.  */
+#define MSG_DONTWAIT   0x0040  /* Enable nonblocking IO.  */
+#define MSG_EOR        0x0080  /* End of record.  */
+#define MSG_WAITALL    0x0100  /* Wait for a full request.  */
 #define MSG_FIN        0x0200
 #define MSG_SYN        0x0400
-#define MSG_CONFIRM    0x0800 /* Confirm path validity.  */
+#define MSG_CONFIRM    0x0800  /* Confirm path validity.  */
 #define MSG_RST        0x1000
-#define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
-#define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
-#define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_ERRQUEUE   0x2000  /* Fetch message from error queue.  */
+#define MSG_NOSIGNAL   0x4000  /* Do not generate SIGPIPE.  */
+#define MSG_MORE       0x8000  /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* recvmmsg(): block until 1+ packets avail */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -332,6 +333,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* Used with recvmmsg() and sendmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -408,6 +417,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -166,7 +166,7 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
 
 SYSCALL_LOOKUP(clock,                      0)
 SYSCALL_LOOKUP(clock_getres,               2)
-SYSCALL_LOOKUP(clock_gettime,              2)
+SYSCALL_LOOKUP(nx_clock_gettime,           2)
 SYSCALL_LOOKUP(clock_settime,              2)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2)
@@ -211,6 +211,18 @@ SYSCALL_LOOKUP(pwrite,                     4)
 #ifdef CONFIG_EVENT_FD
   SYSCALL_LOOKUP(eventfd,                  2)
 #endif
+#ifdef CONFIG_TIMER_FD
+  SYSCALL_LOOKUP(timerfd_create,           2)
+  SYSCALL_LOOKUP(timerfd_settime,          4)
+  SYSCALL_LOOKUP(timerfd_gettime,          2)
+#endif
+#ifdef CONFIG_SIGNAL_FD
+  SYSCALL_LOOKUP(signalfd,                 3)
+#endif
+#ifdef CONFIG_DEV_PIPE_SPLICE
+  SYSCALL_LOOKUP(splice,                   6)
+  SYSCALL_LOOKUP(tee,                      4)
+#endif
 #ifdef CONFIG_NETDEV_IFINDEX
   SYSCALL_LOOKUP(if_indextoname,           2)
   SYSCALL_LOOKUP(if_nametoindex,           1)
@@ -247,6 +259,7 @@ SYSCALL_LOOKUP(telldir,                    1)
 
 #if defined(CONFIG_FS_RAMMAP)
   SYSCALL_LOOKUP(munmap,                   2)
+  SYSCALL_LOOKUP(msync,                    3)
 #endif
 
 #if defined(CONFIG_PSEUDOFS_SOFTLINKS)
@@ -309,7 +322,7 @@ SYSCALL_LOOKUP(telldir,                    1)
   SYSCALL_LOOKUP(pthread_mutex_init,       2)
   SYSCALL_LOOKUP(pthread_mutex_timedlock,  2)
   SYSCALL_LOOKUP(pthread_mutex_trylock,    1)
-  SYSCALL_LOOKUP(pthread_mutex_unlock,     1)
+  SYSCALL_LOOKUP(nx_pthread_mutex_unlock,  1)
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
   SYSCALL_LOOKUP(pthread_mutex_consistent, 1)
 #endif
@@ -365,8 +378,10 @@ SYSCALL_LOOKUP(telldir,                    1)
   SYSCALL_LOOKUP(listen,                   2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(socket,                   3)
 #endif
@@ -90,6 +90,15 @@
 #  define CLOCK_MONOTONIC  1
 #endif
 
+/* Clocks that measure the CPU time consumed by the calling process (all
+ * of the threads in its task group) and by the calling thread.
+ */
+
+#ifdef CONFIG_SCHED_CPUTIME
+#  define CLOCK_PROCESS_CPUTIME_ID 2
+#  define CLOCK_THREAD_CPUTIME_ID  3
+#endif
+
 /* This is a flag that may be passed to the timer_settime() and
  * clock_nanosleep() functions.
  */
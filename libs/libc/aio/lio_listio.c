@@ -544,7 +544,9 @@ int lio_listio(int mode, FAR struct aiocb * const list[], int nent,
   sched_lock();
 
   /* Submit each asynchronous I/O operation in the list, skipping over NULL
-   * entries.
+   * entries.  With the scheduler locked, no worker runs until the whole
+   * list is queued, so requests to the same device start in list order and
+   * requests to different devices can then start together.
    */
 
   for (i = 0; i < nent; i++)
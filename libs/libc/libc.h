@@ -141,10 +141,13 @@ int lib_mode2oflags(FAR const char *mode);
 /* Defined in lib_libfwrite.c */
 
 ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream);
+ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
+                            FAR FILE *stream);
 
 /* Defined in lib_libfread.c */
 
 ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream);
+ssize_t lib_fread_unlocked(FAR void *ptr, size_t count, FAR FILE *stream);
 
 /* Defined in lib_libfgets.c */
 
@@ -179,6 +182,13 @@ bool lib_isbasedigit(int ch, int base, FAR int *value);
 
 int lib_checkbase(int base, FAR const char **pptr);
 
+/* Defined in lib_strtofp.c */
+
+#ifdef CONFIG_LIBC_STRTOD_FAST
+double lib_strtod(FAR const void *str, size_t width, FAR void **endptr);
+float  lib_strtof(FAR const void *str, size_t width, FAR void **endptr);
+#endif
+
 /* Defined in lib_expi.c */
 
 #ifdef CONFIG_LIBM
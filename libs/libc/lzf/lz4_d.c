@@ -0,0 +1,191 @@
+/****************************************************************************
+ * libs/libc/lzf/lz4_d.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* LZ4 block format:
+ *
+ *   A block is a sequence of sequences.  Each sequence is:
+ *
+ *     LLLLMMMM                ; token, L = literal length, M = match length
+ *     [255 ... 255 n]         ; if L == 15: literal length += sum of bytes
+ *     <literals>              ; L octets
+ *     oooooooo oooooooo       ; match offset 1..65535, little-endian
+ *     [255 ... 255 n]         ; if M == 15: match length += sum of bytes
+ *
+ *   The match length is M + 4.  The final sequence holds only literals and
+ *   ends at the end of the block.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+
+#include "lzf/lzf.h"
+
+#ifdef CONFIG_LIBC_LZF_LZ4
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_RUN_MASK  15
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_length
+ *
+ * Description:
+ *   Add the optional length extension bytes that follow a token field
+ *   equal to LZ4_RUN_MASK.  Returns false if the input ends first.
+ *
+ ****************************************************************************/
+
+static inline bool lz4_length(FAR const uint8_t **ip,
+                              FAR const uint8_t *in_end,
+                              FAR unsigned int *len)
+{
+  unsigned int byte;
+
+  if (*len == LZ4_RUN_MASK)
+    {
+      do
+        {
+          if (*ip >= in_end)
+            {
+              return false;
+            }
+
+          byte  = *(*ip)++;
+          *len += byte;
+        }
+      while (byte == 255);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress one raw LZ4 block stored at location in_data and length
+ *   in_len.  The result will be stored at out_data up to a maximum of
+ *   out_len characters.
+ *
+ *   If the output buffer is not large enough to hold the decompressed
+ *   data, a 0 is returned and errno is set to E2BIG.  If an error in the
+ *   compressed data is detected, a zero is returned and errno is set to
+ *   EINVAL.  Otherwise the number of decompressed bytes is returned.
+ *
+ ****************************************************************************/
+
+unsigned int lz4_decompress(FAR const void *const in_data,
+                            unsigned int in_len, FAR void *out_data,
+                            unsigned int out_len)
+{
+  FAR const uint8_t *ip = (FAR const uint8_t *)in_data;
+  FAR uint8_t       *op = (FAR uint8_t *)out_data;
+  FAR const uint8_t *const in_end  = ip + in_len;
+  FAR uint8_t       *const out_end = op + out_len;
+  FAR const uint8_t *ref;
+  unsigned int token;
+  unsigned int len;
+  unsigned int off;
+
+  while (ip < in_end)
+    {
+      token = *ip++;
+
+      /* Literal run */
+
+      len = token >> 4;
+      if (!lz4_length(&ip, in_end, &len) || len > (size_t)(in_end - ip))
+        {
+          set_errno(EINVAL);
+          return 0;
+        }
+
+      if (len > (size_t)(out_end - op))
+        {
+          set_errno(E2BIG);
+          return 0;
+        }
+
+      lzf_copy(op, ip, len);
+      op += len;
+      ip += len;
+
+      /* The last sequence has no match */
+
+      if (ip >= in_end)
+        {
+          break;
+        }
+
+      /* Back reference */
+
+      if (in_end - ip < 2)
+        {
+          set_errno(EINVAL);
+          return 0;
+        }
+
+      off  = (unsigned int)ip[0] | (unsigned int)ip[1] << 8;
+      ip  += 2;
+
+      len  = token & LZ4_RUN_MASK;
+      if (!lz4_length(&ip, in_end, &len))
+        {
+          set_errno(EINVAL);
+          return 0;
+        }
+
+      len += LZ4_MIN_MATCH;
+
+      if (off == 0 || off > (size_t)(op - (FAR uint8_t *)out_data))
+        {
+          set_errno(EINVAL);
+          return 0;
+        }
+
+      if (len > (size_t)(out_end - op))
+        {
+          set_errno(E2BIG);
+          return 0;
+        }
+
+      ref = op - off;
+      lzf_copyref(op, ref, len);
+      op += len;
+    }
+
+  return op - (FAR uint8_t *)out_data;
+}
+
+#endif /* CONFIG_LIBC_LZF_LZ4 */
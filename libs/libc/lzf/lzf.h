@@ -90,4 +90,88 @@ using namespace std;
  * Public Types
  ****************************************************************************/
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzf_copy
+ *
+ * Description:
+ *   Copy n octets from src to dest a word at a time when possible.  The
+ *   areas may overlap only if dest lies at least one word above src; the
+ *   result is then the same as that of a forward, octet-by-octet copy,
+ *   which is what a back reference requires.
+ *
+ *   If CONFIG_LIBC_LZF_ALIGN is selected, words are only used when src
+ *   and dest have the same alignment.
+ *
+ ****************************************************************************/
+
+static inline void lzf_copy(FAR uint8_t *dest, FAR const uint8_t *src,
+                            unsigned int n)
+{
+#ifdef CONFIG_LIBC_LZF_ALIGN
+  if ((((uintptr_t)dest ^ (uintptr_t)src) & (sizeof(uint32_t) - 1)) == 0)
+    {
+      while (n > 0 && ((uintptr_t)dest & (sizeof(uint32_t) - 1)) != 0)
+        {
+          *dest++ = *src++;
+          n--;
+        }
+#endif
+
+      while (n >= sizeof(uint32_t))
+        {
+          *(FAR uint32_t *)dest = *(FAR const uint32_t *)src;
+          dest += sizeof(uint32_t);
+          src  += sizeof(uint32_t);
+          n    -= sizeof(uint32_t);
+        }
+
+#ifdef CONFIG_LIBC_LZF_ALIGN
+    }
+#endif
+
+  while (n > 0)
+    {
+      *dest++ = *src++;
+      n--;
+    }
+}
+
+/****************************************************************************
+ * Name: lzf_copyref
+ *
+ * Description:
+ *   Copy a back reference of n octets starting at ref < dest.  Short
+ *   distances mean that the source overlaps the output:  A distance of one
+ *   is a run of a single octet and other distances shorter than a word
+ *   must be copied an octet at a time.
+ *
+ ****************************************************************************/
+
+static inline void lzf_copyref(FAR uint8_t *dest, FAR const uint8_t *ref,
+                               unsigned int n)
+{
+  size_t distance = dest - ref;
+
+  if (distance >= sizeof(uint32_t))
+    {
+      lzf_copy(dest, ref, n);
+    }
+  else if (distance == 1)
+    {
+      memset(dest, *ref, n);
+    }
+  else
+    {
+      while (n > 0)
+        {
+          *dest++ = *ref++;
+          n--;
+        }
+    }
+}
+
 #endif /* __LIBC_LZF_LZF_H */
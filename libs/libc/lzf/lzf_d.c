@@ -54,7 +54,9 @@
  *   If an error in the compressed data is detected, a zero is returned and
  *   errno is set to EINVAL.
  *
- *   This function is very fast, about as fast as a copying loop.
+ *   This function is very fast, about as fast as a copying loop.  Literal
+ *   runs and back references are copied a word at a time where the
+ *   alignment and overlap allow.
  *
  ****************************************************************************/
 
@@ -92,104 +94,9 @@ unsigned int lzf_decompress (FAR const void *const in_data,
 #ifdef lzf_movsb
           lzf_movsb(op, ip, ctrl);
 #else
-          switch (ctrl)
-            {
-              case 32:
-                *op++ = *ip++;
-
-              case 31:
-                *op++ = *ip++;
-
-              case 30:
-                *op++ = *ip++;
-
-              case 29:
-                *op++ = *ip++;
-
-              case 28:
-                *op++ = *ip++;
-
-              case 27:
-                *op++ = *ip++;
-
-              case 26:
-                *op++ = *ip++;
-
-              case 25:
-                *op++ = *ip++;
-
-              case 24:
-                *op++ = *ip++;
-
-              case 23:
-                *op++ = *ip++;
-
-              case 22:
-                *op++ = *ip++;
-
-              case 21:
-                *op++ = *ip++;
-
-              case 20:
-                *op++ = *ip++;
-
-              case 19:
-                *op++ = *ip++;
-
-              case 18:
-                *op++ = *ip++;
-
-              case 17:
-                *op++ = *ip++;
-
-              case 16:
-                *op++ = *ip++;
-
-              case 15:
-                *op++ = *ip++;
-
-              case 14:
-                *op++ = *ip++;
-
-              case 13:
-                *op++ = *ip++;
-
-              case 12:
-                *op++ = *ip++;
-
-              case 11:
-                *op++ = *ip++;
-
-              case 10:
-                *op++ = *ip++;
-
-              case 9:
-                *op++ = *ip++;
-
-              case 8:
-                *op++ = *ip++;
-
-              case 7:
-                *op++ = *ip++;
-
-              case 6:
-                *op++ = *ip++;
-
-              case 5:
-                *op++ = *ip++;
-
-              case 4:
-                *op++ = *ip++;
-
-              case 3:
-                *op++ = *ip++;
-
-              case 2:
-                *op++ = *ip++;
-
-              case 1:
-                *op++ = *ip++;
-            }
+          lzf_copy(op, ip, ctrl);
+          op += ctrl;
+          ip += ctrl;
 #endif
         }
       else /* back reference */
@@ -231,68 +138,13 @@ unsigned int lzf_decompress (FAR const void *const in_data,
               return 0;
             }
 
-#ifdef lzf_movsb
           len += 2;
+
+#ifdef lzf_movsb
           lzf_movsb(op, ref, len);
 #else
-          switch (len)
-            {
-              default:
-                len += 2;
-
-                if (op >= ref + len)
-                  {
-                    /* Disjunct areas */
-
-                    memcpy (op, ref, len);
-                    op += len;
-                  }
-                else
-                  {
-                    /* Overlapping, use octet by octet copying */
-
-                    do
-                      {
-                        *op++ = *ref++;
-                      }
-                    while (--len);
-                  }
-
-                break;
-
-              case 9:
-                *op++ = *ref++;
-
-              case 8:
-                *op++ = *ref++;
-
-              case 7:
-                *op++ = *ref++;
-
-              case 6:
-                *op++ = *ref++;
-
-              case 5:
-                *op++ = *ref++;
-
-              case 4:
-                *op++ = *ref++;
-
-              case 3:
-                *op++ = *ref++;
-
-              case 2:
-                *op++ = *ref++;
-
-              case 1:
-                *op++ = *ref++;
-
-              case 0:
-                /* Two octets more */
-
-                *op++ = *ref++;
-                *op++ = *ref++;
-            }
+          lzf_copyref(op, ref, len);
+          op += len;
 #endif
         }
     }
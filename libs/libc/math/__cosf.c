@@ -0,0 +1,56 @@
+/****************************************************************************
+ * libs/libc/math/__cosf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Minimax coefficients of (cos(x) - 1 + x^2 / 2) / x^4 on [-pi/4, pi/4] */
+
+static const float g_c1 =  4.166664568298827e-2f;
+static const float g_c2 = -1.388731625493765e-3f;
+static const float g_c3 =  2.443315711809948e-5f;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __cosf
+ *
+ * Description:
+ *   cos(x) for x in [-pi/4, pi/4].
+ *
+ ****************************************************************************/
+
+float __cosf(float x)
+{
+  float z = x * x;
+
+  return 1.0F - 0.5F * z + z * z * (g_c1 + z * (g_c2 + z * g_c3));
+}
@@ -0,0 +1,152 @@
+/****************************************************************************
+ * libs/libc/math/__rem_pio2f.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <math.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Below this the three-part pi/2 is accurate enough */
+
+#define REM_PIO2F_MEDIUM  128.0F
+#define REM_PIO2F_TINY    0x1p-10F
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* pi/2 in three parts: n * g_pio2_1 is exact for the medium range */
+
+static const float g_pio2_1 = 1.5703125F;
+static const float g_pio2_2 = 4.837512969970703125e-4F;
+static const float g_pio2_3 = 7.54978995489188216e-8F;
+
+/* The bits of 4/pi, preceded by 32 zero bits.  Entry i holds bits 8 * i to
+ * 8 * i + 31, so that any 96-bit window starting at a multiple of 8 is
+ * three aligned words.
+ */
+
+static const uint32_t g_inv_pio4[25] =
+{
+  0x00000000, 0x000000a2, 0x0000a2f9, 0x00a2f983,
+  0xa2f9836e, 0xf9836e4e, 0x836e4e44, 0x6e4e4415,
+  0x4e441529, 0x441529fc, 0x1529fc27, 0x29fc2757,
+  0xfc2757d1, 0x2757d1f5, 0x57d1f534, 0xd1f534dd,
+  0xf534ddc0, 0x34ddc0db, 0xddc0db62, 0xc0db6295,
+  0xdb629599, 0x6295993c, 0x95993c43, 0x993c4390,
+  0x3c439041
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Payne-Hanek reduction of x >= 1/128, in integer arithmetic: the 24-bit
+ * significand times the 96 bits of 4/pi that matter for its exponent gives
+ * x * 2/pi modulo 4 as a 64-bit fixed point number.
+ */
+
+static float rem_pio2f_large(uint32_t ix, FAR int *n)
+{
+  FAR const uint32_t *inv = &g_inv_pio4[(ix >> 26) - 15];
+  uint64_t res0;
+  uint64_t res1;
+  uint64_t res2;
+  uint64_t q;
+
+  ix = ((ix & 0x7fffff) | 0x800000) << ((ix >> 23) & 7);
+
+  res0 = (uint32_t)(ix * inv[0]);
+  res1 = (uint64_t)ix * inv[4];
+  res2 = (uint64_t)ix * inv[8];
+  res0 = (res2 >> 32) | (res0 << 32);
+  res0 += res1;
+
+  /* The top two bits are the quadrant, the rest the signed remainder in
+   * units of pi/2 * 2^-62.
+   */
+
+  q     = (res0 + ((uint64_t)1 << 61)) >> 62;
+  res0 -= q << 62;
+  *n    = (int)q;
+
+  return (float)(int64_t)res0 * 3.40612158e-19F;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __rem_pio2f
+ *
+ * Description:
+ *   Reduce x to y = x - n * pi/2 with |y| <= pi/4.  x must be finite.
+ *
+ * Returned Value:
+ *   n; only its two lowest bits are significant for large x.
+ *
+ ****************************************************************************/
+
+int __rem_pio2f(float x, FAR float *y)
+{
+  union
+  {
+    uint32_t i;
+    float x;
+  } u;
+
+  float ax = fabsf(x);
+  float r;
+  int n;
+
+  if (ax < REM_PIO2F_MEDIUM)
+    {
+      n = (int)(ax * (float)M_2_PI + 0.5F);
+      r = ((ax - n * g_pio2_1) - n * g_pio2_2) - n * g_pio2_3;
+    }
+
+  /* Close to a multiple of pi/2 the cancellation exposes the error of the
+   * three-part pi/2; take the exact path instead.
+   */
+
+  if (ax >= REM_PIO2F_MEDIUM || fabsf(r) < REM_PIO2F_TINY)
+    {
+      u.x = ax;
+      r   = rem_pio2f_large(u.i, &n);
+    }
+
+  if (x < 0.0F)
+    {
+      *y = -r;
+      return -n;
+    }
+
+  *y = r;
+  return n;
+}
@@ -0,0 +1,56 @@
+/****************************************************************************
+ * libs/libc/math/__sinf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Minimax coefficients of (sin(x) - x) / x^3 on [-pi/4, pi/4] */
+
+static const float g_s1 = -1.6666654611e-1f;
+static const float g_s2 =  8.3321608736e-3f;
+static const float g_s3 = -1.9515295891e-4f;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __sinf
+ *
+ * Description:
+ *   sin(x) for x in [-pi/4, pi/4].
+ *
+ ****************************************************************************/
+
+float __sinf(float x)
+{
+  float z = x * x;
+
+  return x + x * z * (g_s1 + z * (g_s2 + z * g_s3));
+}
@@ -37,5 +37,29 @@
 
 float cosf(float x)
 {
-  return sinf(x + M_PI_2_F);
+  float y;
+
+  if (fabsf(x) <= (float)M_PI_4)
+    {
+      return __cosf(x);
+    }
+  else if (isnan(x) || isinf_f(x))
+    {
+      return NAN_F;
+    }
+
+  switch (__rem_pio2f(x, &y) & 3)
+    {
+      case 0:
+        return __cosf(y);
+
+      case 1:
+        return -__sinf(y);
+
+      case 2:
+        return -__cosf(y);
+
+      default:
+        return __sinf(y);
+    }
 }
@@ -29,84 +29,110 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* expf(x) overflows above this and underflows to zero below the other */
 
-#include "libc.h"
+#define EXPF_MAX     88.72283935546875F
+#define EXPF_MIN    -103.972084045410F
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static float _flt_inv_fact[] =
+/* ln(2) in two parts: n * g_ln2_hi is exact for the whole range */
+
+static const float g_ln2_hi =  0.693359375F;
+static const float g_ln2_lo = -2.12194440e-4F;
+
+/* Minimax coefficients of (exp(r) - 1 - r) / r^2 on [-ln(2)/2, ln(2)/2] */
+
+static const float g_p[] =
 {
-  1.0 / 1.0,                    /* 1/0! */
-  1.0 / 1.0,                    /* 1/1! */
-  1.0 / 2.0,                    /* 1/2! */
-  1.0 / 6.0,                    /* 1/3! */
-  1.0 / 24.0,                   /* 1/4! */
-  1.0 / 120.0,                  /* 1/5! */
-  1.0 / 720.0,                  /* 1/6! */
-  1.0 / 5040.0,                 /* 1/7! */
-  1.0 / 40320.0,                /* 1/8! */
-  1.0 / 362880.0,               /* 1/9! */
-  1.0 / 3628800.0,              /* 1/10! */
+  1.9875691500e-4F, 1.3981999507e-3F, 8.3334519073e-3F,
+  4.1665795894e-2F, 1.6666665459e-1F, 5.0000001201e-1F
 };
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* 2^n for a normal result, -126 <= n <= 127 */
+
+static inline float expf_pow2(int n)
+{
+  union
+  {
+    uint32_t i;
+    float x;
+  } u;
+
+  u.i = (uint32_t)(n + 127) << 23;
+  return u.x;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float expf(float x)
 {
-  size_t int_part;
-  bool invert;
-  float value;
-  float x0;
-  size_t i;
+  float r;
+  float y;
+  int n;
 
-  if (x == 0)
+  if (isnan(x))
     {
-      return 1;
+      return x;
     }
-  else if (x < 0)
+  else if (x > EXPF_MAX)
     {
-      invert = true;
-      x = -x;
+      set_errno(ERANGE);
+      return INFINITY_F;
     }
-  else
+  else if (x < EXPF_MIN)
     {
-      invert = false;
-    }
-
-  /* Extract integer component */
-
-  int_part = (size_t) x;
+      if (!isinf_f(x))
+        {
+          set_errno(ERANGE);
+        }
 
-  /* set x to fractional component */
+      return 0.0F;
+    }
 
-  x -= (float)int_part;
+  /* x = n * ln(2) + r with |r| <= ln(2)/2, exp(x) = 2^n * exp(r) */
 
-  /* Perform Taylor series approximation with eleven terms */
+  n = (int)(x * (float)M_LOG2E + (x < 0.0F ? -0.5F : 0.5F));
+  r = (x - n * g_ln2_hi) - n * g_ln2_lo;
 
-  value = 0.0F;
-  x0 = 1.0F;
-  for (i = 0; i < 10; i++)
-    {
-      value += x0 * _flt_inv_fact[i];
-      x0 *= x;
-    }
+  y = g_p[0];
+  y = y * r + g_p[1];
+  y = y * r + g_p[2];
+  y = y * r + g_p[3];
+  y = y * r + g_p[4];
+  y = y * r + g_p[5];
+  y = y * r * r + r + 1.0F;
 
-  /* Multiply by exp of the integer component */
+  /* Scale in two steps where 2^n itself is not a normal float */
 
-  value *= lib_expif(int_part);
-
-  if (invert)
+  if (n > 127)
     {
-      return (1.0F / value);
+      y *= 2.0F;
+      n--;
     }
-  else
+  else if (n < -126)
     {
-      return value;
+      y *= expf_pow2(n + 126);
+      n = -126;
     }
+
+  return y * expf_pow2(n);
 }
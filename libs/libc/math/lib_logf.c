@@ -29,86 +29,103 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
-#include <float.h>
+#include <errno.h>
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Data
  ****************************************************************************/
 
-#define FLT_MAX_EXP_X   88.0F
+/* ln(2) in two parts: e * g_ln2_hi is exact for every exponent */
+
+static const float g_ln2_hi =  0.693359375F;
+static const float g_ln2_lo = -2.12194440e-4F;
 
-/* To avoid looping forever in particular corner cases, every LOGF_MAX_ITER
- * the error criteria is relaxed by a factor LOGF_RELAX_MULTIPLIER.
- * todo: might need to adjust the double floating point version too.
+/* Minimax coefficients of (log(1 + f) - f + f^2 / 2) / f^3 on
+ * [sqrt(1/2) - 1, sqrt(2) - 1]
  */
 
-#define LOGF_MAX_ITER         10
-#define LOGF_RELAX_MULTIPLIER 2
+static const float g_p[] =
+{
+  7.0376836292e-2F, -1.1514610310e-1F, 1.1676998740e-1F,
+  -1.2420140846e-1F, 1.4249322787e-1F, -1.6668057665e-1F,
+  2.0000714765e-1F, -2.4999993993e-1F, 3.3333331174e-1F
+};
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: logf
- ****************************************************************************/
-
 float logf(float x)
 {
-  float y;
-  float y_old;
-  float ney;
-  float epsilon;
-  int   relax_factor;
-  int   iter;
+  union
+  {
+    uint32_t i;
+    float x;
+  } u;
 
-  y       = 0.0F;
-  y_old   = 1.0F;
-  epsilon = FLT_EPSILON;
-
-  iter         = 0;
-  relax_factor = 1;
+  float f;
+  float y;
+  float z;
+  int e;
 
-  while (y > y_old + epsilon || y < y_old - epsilon)
+  u.x = x;
+  if (isnan(x))
     {
-      y_old = y;
-      ney   = expf(-y);
-      y    -= 1.0F - x * ney;
-
-      if (y > FLT_MAX_EXP_X)
-        {
-          y = FLT_MAX_EXP_X;
-        }
-
-      if (y < -FLT_MAX_EXP_X)
-        {
-          y = -FLT_MAX_EXP_X;
-        }
-
-      epsilon = (fabsf(y) > 1.0F) ? fabsf(y) * FLT_EPSILON : FLT_EPSILON;
-
-      if (++iter >= LOGF_MAX_ITER)
-        {
-          relax_factor *= LOGF_RELAX_MULTIPLIER;
-          iter = 0;
-        }
-
-      if (relax_factor > 1)
-        {
-          epsilon *= relax_factor;
-        }
+      return x;
+    }
+  else if (x < 0.0F)
+    {
+      set_errno(EDOM);
+      return NAN_F;
+    }
+  else if (x == 0.0F)
+    {
+      set_errno(ERANGE);
+      return -INFINITY_F;
+    }
+  else if (isinf_f(x))
+    {
+      return x;
     }
 
-  if (y == FLT_MAX_EXP_X)
+  /* Subnormals: scale by 2^25 */
+
+  e = 0;
+  if (u.i < 0x00800000)
     {
-      return INFINITY;
+      u.x *= 33554432.0F;
+      e = -25;
     }
 
-  if (y == -FLT_MAX_EXP_X)
+  /* x = 2^e * (1 + f) with 1 + f in [sqrt(1/2), sqrt(2)) */
+
+  e  += (int)(u.i >> 23) - 127;
+  u.i = (u.i & 0x007fffff) | 0x3f800000;
+  if (u.x > (float)M_SQRT2)
     {
-      return INFINITY;
+      u.x *= 0.5F;
+      e++;
     }
 
-  return y;
+  f = u.x - 1.0F;
+  z = f * f;
+
+  y = g_p[0];
+  y = y * f + g_p[1];
+  y = y * f + g_p[2];
+  y = y * f + g_p[3];
+  y = y * f + g_p[4];
+  y = y * f + g_p[5];
+  y = y * f + g_p[6];
+  y = y * f + g_p[7];
+  y = y * f + g_p[8];
+  y = y * f * z;
+
+  y += e * g_ln2_lo;
+  y -= 0.5F * z;
+  return (f + y) + e * g_ln2_hi;
 }
@@ -29,76 +29,37 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
 #include <math.h>
 
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-static float _flt_inv_fact[] =
-{
-  1.0 / 1.0,                    /* 1 / 1! */
-  1.0 / 6.0,                    /* 1 / 3! */
-  1.0 / 120.0,                  /* 1 / 5! */
-  1.0 / 5040.0,                 /* 1 / 7! */
-  1.0 / 362880.0,               /* 1 / 9! */
-  1.0 / 39916800.0,             /* 1 / 11! */
-};
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float sinf(float x)
 {
-  float x_squared;
-  float sin_x;
-  size_t i;
-
-  /* Move x to [-pi, pi) */
+  float y;
 
-  x = fmodf(x, 2 * M_PI_F);
-  if (x >= M_PI_F)
+  if (fabsf(x) <= (float)M_PI_4)
     {
-      x -= 2 * M_PI_F;
+      return __sinf(x);
     }
-
-  if (x < -M_PI_F)
+  else if (isnan(x) || isinf_f(x))
     {
-      x += 2 * M_PI_F;
+      return NAN_F;
     }
 
-  /* Move x to [-pi/2, pi/2) */
-
-  if (x >= M_PI_2_F)
+  switch (__rem_pio2f(x, &y) & 3)
     {
-      x = M_PI_F - x;
-    }
-
-  if (x < -M_PI_2_F)
-    {
-      x = -M_PI_F - x;
-    }
+      case 0:
+        return __sinf(y);
 
-  x_squared = x * x;
-  sin_x = 0.0F;
+      case 1:
+        return __cosf(y);
 
-  /* Perform Taylor series approximation for sin(x) with six terms */
+      case 2:
+        return -__sinf(y);
 
-  for (i = 0; i < 6; i++)
-    {
-      if (i % 2 == 0)
-        {
-          sin_x += x * _flt_inv_fact[i];
-        }
-      else
-        {
-          sin_x -= x * _flt_inv_fact[i];
-        }
-
-      x *= x_squared;
+      default:
+        return -__cosf(y);
     }
-
-  return sin_x;
 }
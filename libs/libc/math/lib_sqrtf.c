@@ -32,11 +32,11 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <float.h>
+#include <stdint.h>
 #include <math.h>
 #include <errno.h>
 
-#include "libc.h"
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -44,7 +44,16 @@
 #ifndef CONFIG_LIBM_ARCH_SQRTF
 float sqrtf(float x)
 {
+  union
+  {
+    uint32_t i;
+    float x;
+  } u;
+
+  float scale = 1.0F;
+  float xh;
   float y;
+  float s;
 
   /* Filter out invalid/trivial inputs */
 
@@ -69,18 +78,32 @@ float sqrtf(float x)
       return 0.0F;
     }
 
-  /* Guess square root (using bit manipulation) */
+  /* The bit guess below needs a normal number */
 
-  y = lib_sqrtapprox(x);
+  if (x < FLT_MIN)
+    {
+      x     *= 16777216.0F;     /* 2^24 */
+      scale  = 2.44140625e-4F;  /* 2^-12 */
+    }
 
-  /* Perform three iterations of approximation. This number (3) is
-   * definitely optimal
+  /* Guess 1/sqrt(x) from the bits and refine it with Newton steps, which
+   * unlike the Heron iteration need no division.
    */
 
-  y = 0.5F * (y + x / y);
-  y = 0.5F * (y + x / y);
-  y = 0.5F * (y + x / y);
+  u.x = x;
+  u.i = 0x5f375a86 - (u.i >> 1);
+  y   = u.x;
+  xh  = 0.5F * x;
+
+  y = y * (1.5F - xh * y * y);
+  y = y * (1.5F - xh * y * y);
+  y = y * (1.5F - xh * y * y);
+
+  /* sqrt(x) = x / sqrt(x), corrected once by the residual */
+
+  s = x * y;
+  s = s + 0.5F * y * (x - s * s);
 
-  return y;
+  return s * scale;
 }
 #endif
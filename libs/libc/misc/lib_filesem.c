@@ -122,6 +122,46 @@ void lib_take_semaphore(FAR struct file_struct *stream)
 #endif
 }
 
+/****************************************************************************
+ * lib_trytake_semaphore
+ ****************************************************************************/
+
+int lib_trytake_semaphore(FAR struct file_struct *stream)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  pid_t my_pid = getpid();
+  int ret = OK;
+
+  /* Do I already have the semaphore? */
+
+  if (stream->fs_holder == my_pid)
+    {
+      /* Yes, just increment the number of references that I have */
+
+      stream->fs_counts++;
+    }
+  else if (_SEM_TRYWAIT(&stream->fs_sem) < 0)
+    {
+      /* Another thread holds the stream */
+
+      ret = -EAGAIN;
+    }
+  else
+    {
+      stream->fs_holder = my_pid;
+      stream->fs_counts = 1;
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * lib_give_semaphore
  ****************************************************************************/
@@ -221,6 +221,9 @@ int modlib_registry_del(FAR struct module_s *modp)
     }
 
   modp->flink = NULL;
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hashuninit(&modp->exphash);
+#endif
   return OK;
 }
 
@@ -172,15 +172,7 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-  exportinfo->symbol = symtab_findorderedbyname(modp->modinfo.exports,
-                                                exportinfo->name,
-                                                modp->modinfo.nexports);
-#else
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
-#endif
+  exportinfo->symbol = modlib_modsymbol(modp, exportinfo->name);
 
   if (exportinfo->symbol != NULL)
     {
@@ -314,7 +306,6 @@ int modlib_symvalue(FAR struct module_s *modp,
   FAR const struct symtab_s *symbol;
   struct mod_exportinfo_s exportinfo;
   uintptr_t secbase;
-  int nsymbols;
   int ret;
 
   switch (sym->st_shndx)
@@ -378,14 +369,7 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            modlib_getsymtab(&symbol, &nsymbols);
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-            symbol = symtab_findorderedbyname(symbol, exportinfo.name,
-                                              nsymbols);
-#else
-            symbol = symtab_findbyname(symbol, exportinfo.name,
-                                       nsymbols);
-#endif
+            symbol = modlib_findsymbol(exportinfo.name);
           }
 
         /* Was the symbol found from any exporter? */
@@ -63,6 +63,52 @@ extern int CONFIG_MODLIB_NSYMBOLS_VAR;
 static FAR const struct symtab_s *g_modlib_symtab;
 static FAR int g_modlib_nsymbols;
 
+#ifdef CONFIG_SYMTAB_HASH
+static struct symtab_hash_s g_modlib_symhash;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: modlib_lookup
+ *
+ * Description:
+ *   Search one symbol table, through its hash index when there is one.
+ *   The index is built on the first search; if that fails for lack of
+ *   memory, the table is searched the old way.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *
+modlib_lookup(FAR const struct symtab_s *symtab, int nsyms,
+              FAR void *hash, FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  FAR struct symtab_hash_s *symhash = (FAR struct symtab_hash_s *)hash;
+
+  if (symhash->symtab != symtab)
+    {
+      symtab_hashuninit(symhash);
+      symtab_hashinit(symhash, symtab, nsyms);
+    }
+
+  if (symhash->buckets != NULL)
+    {
+      return symtab_findbyhash(symhash, name, symtab_hashname(name));
+    }
+#else
+  UNUSED(hash);
+#endif
+
+#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+  return symtab_findorderedbyname(symtab, name, nsyms);
+#else
+  return symtab_findbyname(symtab, name, nsyms);
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -125,5 +171,81 @@ void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   modlib_registry_lock();
   g_modlib_symtab   = symtab;
   g_modlib_nsymbols = nsymbols;
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hashuninit(&g_modlib_symhash);
+#endif
   modlib_registry_unlock();
 }
+
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol exported by the base code (the table selected by
+ *   modlib_setsymtab()).
+ *
+ * Input Parameters:
+ *   name - The symbol name.
+ *
+ * Returned Value:
+ *   The symbol table entry or NULL if it is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name)
+{
+  FAR const struct symtab_s *symtab;
+  FAR const struct symtab_s *symbol = NULL;
+  int nsymbols;
+
+  /* modlib_getsymtab() takes the registry lock too, the lock nests */
+
+  modlib_registry_lock();
+  modlib_getsymtab(&symtab, &nsymbols);
+  if (symtab != NULL && nsymbols > 0)
+    {
+#ifdef CONFIG_SYMTAB_HASH
+      symbol = modlib_lookup(symtab, nsymbols, &g_modlib_symhash, name);
+#else
+      symbol = modlib_lookup(symtab, nsymbols, NULL, name);
+#endif
+    }
+
+  modlib_registry_unlock();
+  return symbol;
+}
+
+/****************************************************************************
+ * Name: modlib_modsymbol
+ *
+ * Description:
+ *   Find a symbol exported by a loaded module.
+ *
+ * Input Parameters:
+ *   modp - The module.
+ *   name - The symbol name.
+ *
+ * Returned Value:
+ *   The symbol table entry or NULL if it is not found.
+ *
+ * Assumptions:
+ *   The caller holds the registry lock.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_modsymbol(FAR struct module_s *modp,
+                                            FAR const char *name)
+{
+  if (modp->modinfo.exports == NULL || modp->modinfo.nexports <= 0)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_SYMTAB_HASH
+  return modlib_lookup(modp->modinfo.exports, modp->modinfo.nexports,
+                       &modp->exphash, name);
+#else
+  return modlib_lookup(modp->modinfo.exports, modp->modinfo.nexports,
+                       NULL, name);
+#endif
+}
@@ -76,6 +76,10 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGLIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGLIFESEC 0
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -212,7 +216,9 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero saves a negative
+ *              entry:  The name is known not to resolve.
+ *   ttl      - The time-to-live of the answer in seconds.
  *
  * Returned Value:
  *   None
@@ -221,7 +227,8 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr);
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl);
 #endif
 
 /****************************************************************************
@@ -242,7 +249,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache.  -EADDRNOTAVAIL means that the cache
+ *   holds a negative entry:  The hostname is known not to resolve.
  *
  ****************************************************************************/
 
@@ -63,6 +63,17 @@
 #  define DNS_CLOCK CLOCK_REALTIME
 #endif
 
+/* The cache is set-associative:  A hostname hashes to a set of DNS_WAYS
+ * consecutive entries (wrapping around the end of the cache) and is only
+ * ever stored in, and looked up in, that set.
+ */
+
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES < 4
+#  define DNS_WAYS CONFIG_NETDB_DNSCLIENT_ENTRIES
+#else
+#  define DNS_WAYS 4
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -75,11 +86,11 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
   time_t            ctime;      /* Creation time */
-#endif
+  uint32_t          ttl;        /* Life of the entry in seconds */
   char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
-  uint8_t           naddr;      /* How many addresses per name */
+  uint8_t           naddr;      /* How many addresses per name (zero for a
+                                 * negative entry) */
   union dns_addr_u  addr[CONFIG_NETDB_MAX_IPADDR];
 };
 
@@ -87,9 +98,6 @@ struct dns_cache_s
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
-
 /* This is the DNS resolver cache */
 
 static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
@@ -98,6 +106,48 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_hash
+ *
+ * Description:
+ *   Return the index of the first entry of the set that a hostname maps
+ *   to.  Only the part of the name that is stored in the cache is hashed.
+ *
+ ****************************************************************************/
+
+static int dns_hash(FAR const char *hostname)
+{
+  uint32_t hash = 5381;
+  int i;
+
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_NAMESIZE && hostname[i] != '\0';
+       i++)
+    {
+      hash = hash * 33 + (uint8_t)hostname[i];
+    }
+
+  return hash % CONFIG_NETDB_DNSCLIENT_ENTRIES;
+}
+
+/****************************************************************************
+ * Name: dns_expired
+ *
+ * Description:
+ *   Check if a cache entry is unused or has outlived its time-to-live.
+ *
+ ****************************************************************************/
+
+static bool dns_expired(FAR const struct dns_cache_s *entry,
+                        FAR const struct timespec *now)
+{
+  /* REVISIT: Does not this calculation assume that the sizeof(time_t)
+   * is equal to the sizeof(uint32_t)?
+   */
+
+  return entry->name[0] == '\0' ||
+         (uint32_t)now->tv_sec - (uint32_t)entry->ctime > entry->ttl;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -111,7 +161,9 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero saves a negative
+ *              entry:  The name is known not to resolve.
+ *   ttl      - The time-to-live of the answer in seconds.
  *
  * Returned Value:
  *   None
@@ -119,64 +171,85 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  ****************************************************************************/
 
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr)
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  FAR struct dns_cache_s *victim;
   struct timespec now;
-#endif
-  int next;
   int ndx;
+  int i;
 
   naddr = MIN(naddr, CONFIG_NETDB_MAX_IPADDR);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
+
+  /* Limit the life of the entry */
+
+  if (naddr == 0)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_NEGLIFESEC;
+    }
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  else if (ttl > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_LIFESEC;
+    }
+#endif
+
+  if (ttl == 0)
+    {
+      /* Not worth caching (or negative caching is disabled) */
+
+      return;
+    }
 
   /* Get exclusive access to the DNS cache */
 
   dns_semtake();
 
-  /* Get the index to the new head of the list */
+  /* Get the current time, using CLOCK_MONOTONIC if possible */
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
-    {
-      next = 0;
-    }
+  clock_gettime(DNS_CLOCK, &now);
 
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
+  /* Replace an entry for the same name, else an expired entry, else the
+   * entry of the set that is closest to expiring.
    */
 
-  if (next == g_dns_tail)
+  ndx    = dns_hash(hostname);
+  victim = NULL;
+
+  for (i = 0; i < DNS_WAYS; i++)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      entry = &g_dns_cache[(ndx + i) % CONFIG_NETDB_DNSCLIENT_ENTRIES];
+
+      if (strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
         {
-          tmp = 0;
+          victim = entry;
+          break;
         }
 
-      g_dns_tail = tmp;
+      if (victim == NULL || dns_expired(entry, &now))
+        {
+          victim = entry;
+        }
+      else if (!dns_expired(victim, &now) &&
+               entry->ctime + entry->ttl < victim->ctime + victim->ttl)
+        {
+          victim = entry;
+        }
     }
 
   /* Save the answer in the cache */
 
-  entry = &g_dns_cache[ndx];
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  clock_gettime(DNS_CLOCK, &now);
+  entry        = victim;
   entry->ctime = (time_t)now.tv_sec;
-#endif
+  entry->ttl   = ttl;
 
   strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
   memcpy(&entry->addr, addr, naddr * sizeof(*addr));
   entry->naddr = naddr;
 
-  /* Save the updated head index */
-
-  g_dns_head = next;
   dns_semgive();
 }
 
@@ -198,7 +271,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache.  -EADDRNOTAVAIL means that the cache
+ *   holds a negative entry:  The hostname is known not to resolve.
  *
  ****************************************************************************/
 
@@ -206,84 +280,65 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
   struct timespec now;
-  uint32_t elapsed;
-  int ret;
-#endif
-  int next;
+  int ret = -ENOENT;
   int ndx;
+  int i;
 
   /* Get exclusive access to the DNS cache */
 
   dns_semtake();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
   /* Get the current time, using CLOCK_MONOTONIC if possible */
 
-  ret = clock_gettime(DNS_CLOCK, &now);
-#endif
+  clock_gettime(DNS_CLOCK, &now);
 
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  ndx = dns_hash(hostname);
+  for (i = 0; i < DNS_WAYS; i++)
     {
-      entry = &g_dns_cache[ndx];
+      entry = &g_dns_cache[(ndx + i) % CONFIG_NETDB_DNSCLIENT_ENTRIES];
 
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
+      /* Check for a name match. Because the names are truncated to
+       * CONFIG_NETDB_DNSCLIENT_NAMESIZE, this has the possibility of
+       * aliasing two names and returning the wrong entry from the cache.
        */
 
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      if (strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) != 0)
         {
-          next = 0;
+          continue;
         }
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
-       */
+      if (dns_expired(entry, &now))
+        {
+          /* This entry has expired.  Free it. */
 
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 && elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+          entry->name[0] = '\0';
+        }
+      else if (entry->naddr == 0)
         {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
+          /* A negative entry */
 
-          g_dns_tail = next;
+          ret = -EADDRNOTAVAIL;
         }
       else
-#endif
         {
-          /* The entry has not expired, check for a name match. Because
-           * the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
-           */
+          /* We have a match.  Return the resolved host address */
 
-          if (strncmp(hostname, entry->name,
-                      CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              /* We have a match.  Return the resolved host address */
-
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              *naddr = MIN(*naddr, entry->naddr);
+          /* Make sure that the address will fit in the caller-provided
+           * buffer.
+           */
 
-              /* Return the address information */
+          *naddr = MIN(*naddr, entry->naddr);
 
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+          /* Return the address information */
 
-              dns_semgive();
-              return OK;
-            }
+          memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+          ret = OK;
         }
-    }
 
-  ret = -ENOENT;
+      break;
+    }
 
   dns_semgive();
   return ret;
@@ -79,6 +79,14 @@
 #define SEND_BUFFER_SIZE (16 + CONFIG_NETDB_DNSCLIENT_NAMESIZE + 2)
 #define RECV_BUFFER_SIZE CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 
+/* Record types queried for a hostname */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define DNS_NRECTYPES 2
+#else
+#  define DNS_NRECTYPES 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -90,6 +98,11 @@ struct dns_query_s
   FAR const char *hostname;       /* Hostname to lookup */
   FAR union dns_addr_u *addr;     /* Location to return host address */
   FAR int *naddr;                 /* Number of returned addresses */
+  uint32_t ttl;                   /* Smallest time-to-live of the answers */
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+  int nservers;                   /* Number of name servers to query */
+  union dns_addr_u servers[CONFIG_NETDB_DNSCLIENT_PARALLEL_SERVERS];
+#endif
 };
 
 /* Query info to check response against. */
@@ -186,17 +199,36 @@ static inline uint16_t dns_alloc_id(void)
 }
 
 /****************************************************************************
- * Name: dns_send_query
+ * Name: dns_addrlen
+ ****************************************************************************/
+
+static socklen_t dns_addrlen(FAR const union dns_addr_u *uaddr)
+{
+  if (uaddr->addr.sa_family == AF_INET)
+    {
+      return sizeof(struct sockaddr_in);
+    }
+  else
+    {
+      return sizeof(struct sockaddr_in6);
+    }
+}
+
+/****************************************************************************
+ * Name: dns_build_query
  *
  * Description:
- *   Runs through the list of names to see if there are any that have
- *   not yet been queried and, if so, sends out a query.
+ *   Format a query for 'name' into 'buffer' and save what is needed to
+ *   check the response against in 'qinfo'.
+ *
+ * Returned Value:
+ *   The length of the query.
  *
  ****************************************************************************/
 
-static int dns_send_query(int sd, FAR const char *name,
-                          FAR union dns_addr_u *uaddr, uint16_t rectype,
-                          FAR struct dns_query_info_s *qinfo)
+static int dns_build_query(FAR uint8_t *buffer, FAR const char *name,
+                           uint16_t rectype,
+                           FAR struct dns_query_info_s *qinfo)
 {
   FAR struct dns_header_s *hdr;
   FAR uint8_t *dest;
@@ -204,10 +236,7 @@ static int dns_send_query(int sd, FAR const char *name,
   FAR char *qname;
   FAR char *qptr;
   FAR const char *src;
-  uint8_t buffer[SEND_BUFFER_SIZE];
   uint16_t id;
-  socklen_t addrlen;
-  int ret;
   int len;
   int n;
 
@@ -282,18 +311,31 @@ static int dns_send_query(int sd, FAR const char *name,
   qinfo->rectype = htons(rectype);
   qinfo->id      = hdr->id;
 
-  /* Send the request */
+  return dest - buffer;
+}
 
-  if (uaddr->addr.sa_family == AF_INET)
-    {
-      addrlen = sizeof(struct sockaddr_in);
-    }
-  else
-    {
-      addrlen = sizeof(struct sockaddr_in6);
-    }
+/****************************************************************************
+ * Name: dns_send_query
+ *
+ * Description:
+ *   Runs through the list of names to see if there are any that have
+ *   not yet been queried and, if so, sends out a query.
+ *
+ ****************************************************************************/
 
-  ret = connect(sd, &uaddr->addr, addrlen);
+static int dns_send_query(int sd, FAR const char *name,
+                          FAR union dns_addr_u *uaddr, uint16_t rectype,
+                          FAR struct dns_query_info_s *qinfo)
+{
+  uint8_t buffer[SEND_BUFFER_SIZE];
+  int ret;
+  int len;
+
+  len = dns_build_query(buffer, name, rectype, qinfo);
+
+  /* Send the request */
+
+  ret = connect(sd, &uaddr->addr, dns_addrlen(uaddr));
   if (ret < 0)
     {
       ret = -errno;
@@ -301,7 +343,7 @@ static int dns_send_query(int sd, FAR const char *name,
       return ret;
     }
 
-  ret = _NX_SEND(sd, buffer, dest - buffer, 0);
+  ret = _NX_SEND(sd, buffer, len, 0);
   if (ret < 0)
     {
       ret = -_NX_GETERRNO(ret);
@@ -313,46 +355,34 @@ static int dns_send_query(int sd, FAR const char *name,
 }
 
 /****************************************************************************
- * Name: dns_recv_response
+ * Name: dns_parse_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Check a response received in 'buffer' against the query and extract
+ *   the addresses from it.
  *
  * Returned Value:
- *   Returns number of valid IP address responses.  Negated errno value is
- *   returned in all other cases.
+ *   Returns number of valid IP address responses, and the smallest
+ *   time-to-live of these in 'ttl'.  -EADDRNOTAVAIL is returned if the
+ *   name does not exist or has no addresses of the queried type.  Negated
+ *   errno value is returned in all other cases.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
-                             FAR struct dns_query_info_s *qinfo)
+static int dns_parse_response(FAR char *buffer, int ret,
+                              FAR union dns_addr_u *addr, int naddr,
+                              FAR struct dns_query_info_s *qinfo,
+                              FAR uint32_t *ttl)
 {
   FAR uint8_t *nameptr;
   FAR uint8_t *namestart;
   FAR uint8_t *endofbuffer;
-  char buffer[RECV_BUFFER_SIZE];
   FAR struct dns_answer_s *ans;
   FAR struct dns_header_s *hdr;
   FAR struct dns_question_s *que;
   uint16_t nquestions;
   uint16_t nanswers;
   int naddr_read;
-  int ret;
-
-  if (naddr <= 0)
-    {
-      return -ERANGE;
-    }
-
-  /* Receive the response */
-
-  ret = _NX_RECV(sd, buffer, RECV_BUFFER_SIZE, 0);
-  if (ret < 0)
-    {
-      ret = -_NX_GETERRNO(ret);
-      nerr("ERROR: recv failed: %d\n", ret);
-      return ret;
-    }
 
   if (ret < sizeof(*hdr))
     {
@@ -374,7 +404,12 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
   /* Check for error */
 
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME)
+    {
+      ninfo("DNS reported non-existent name\n");
+      return -EADDRNOTAVAIL;
+    }
+  else if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
     {
       nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
       return -EPROTO;
@@ -452,6 +487,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
   ret = OK;
   naddr_read = 0;
+  *ttl = UINT32_MAX;
 
   for (; nanswers > 0; nanswers--)
     {
@@ -497,6 +533,9 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin_port        = 0;
           inaddr->sin_addr.s_addr = ans->u.ipv4.s_addr;
 
+          *ttl = MIN(*ttl, ((uint32_t)ntohs(ans->ttl[0]) << 16) |
+                           ntohs(ans->ttl[1]));
+
           if (++naddr_read >= naddr)
             {
               ret = -ERANGE;
@@ -526,6 +565,9 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin6_port       = 0;
           memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
+          *ttl = MIN(*ttl, ((uint32_t)ntohs(ans->ttl[0]) << 16) |
+                           ntohs(ans->ttl[1]));
+
           if (++naddr_read >= naddr)
             {
               ret = -ERANGE;
@@ -547,6 +589,44 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
   return naddr_read > 0 ? naddr_read : ret;
 }
 
+/****************************************************************************
+ * Name: dns_recv_response
+ *
+ * Description:
+ *   Called when new UDP data arrives
+ *
+ * Returned Value:
+ *   Returns number of valid IP address responses, and the smallest
+ *   time-to-live of these in 'ttl'.  Negated errno value is returned in all
+ *   other cases.
+ *
+ ****************************************************************************/
+
+static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
+                             FAR struct dns_query_info_s *qinfo,
+                             FAR uint32_t *ttl)
+{
+  char buffer[RECV_BUFFER_SIZE];
+  int ret;
+
+  if (naddr <= 0)
+    {
+      return -ERANGE;
+    }
+
+  /* Receive the response */
+
+  ret = _NX_RECV(sd, buffer, RECV_BUFFER_SIZE, 0);
+  if (ret < 0)
+    {
+      ret = -_NX_GETERRNO(ret);
+      nerr("ERROR: recv failed: %d\n", ret);
+      return ret;
+    }
+
+  return dns_parse_response(buffer, ret, addr, naddr, qinfo, ttl);
+}
+
 /****************************************************************************
  * Name: dns_query_callback
  *
@@ -566,11 +646,13 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NETDB_DNSCLIENT_PARALLEL
 static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
                               FAR socklen_t addrlen)
 {
   FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
   FAR struct dns_query_info_s qinfo;
+  uint32_t ttl;
   int next = 0;
   int retries;
   int ret;
@@ -597,10 +679,11 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
           /* Obtain the IPv6 response */
 
           ret = dns_recv_response(query->sd, &query->addr[next],
-                                  *query->naddr - next, &qinfo);
+                                  *query->naddr - next, &qinfo, &ttl);
           if (ret >= 0)
             {
               next += ret;
+              query->ttl = MIN(query->ttl, ttl);
             }
           else
             {
@@ -626,10 +709,11 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
           /* Obtain the IPv4 response */
 
           ret = dns_recv_response(query->sd, &query->addr[next],
-                                  *query->naddr - next, &qinfo);
+                                  *query->naddr - next, &qinfo, &ttl);
           if (ret >= 0)
             {
               next += ret;
+              query->ttl = MIN(query->ttl, ttl);
             }
           else
             {
@@ -641,11 +725,6 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
 
       if (next > 0)
         {
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-          /* Save the answer in the DNS cache */
-
-          dns_save_answer(query->hostname, query->addr, next);
-#endif
           /* Return 1 to indicate to (1) stop the traversal, and (2)
            * indicate that the address was found.
            */
@@ -661,6 +740,239 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
 
   return 0;
 }
+#endif /* !CONFIG_NETDB_DNSCLIENT_PARALLEL */
+
+/****************************************************************************
+ * Name: dns_collect_callback
+ *
+ * Description:
+ *   Add a DNS name server to the list of servers to be queried in
+ *   parallel.
+ *
+ * Returned Value:
+ *   One (1) to stop the traversal when the list is full; zero otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+static int dns_collect_callback(FAR void *arg, FAR struct sockaddr *addr,
+                                FAR socklen_t addrlen)
+{
+  FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
+
+  if (addrlen <= sizeof(union dns_addr_u))
+    {
+      memcpy(&query->servers[query->nservers++], addr, addrlen);
+    }
+
+  return query->nservers >= CONFIG_NETDB_DNSCLIENT_PARALLEL_SERVERS;
+}
+#endif
+
+/****************************************************************************
+ * Name: dns_query_parallel
+ *
+ * Description:
+ *   Send the queries for all record types to all name servers at once.
+ *   For each record type, the first valid answer received wins; later
+ *   answers are ignored.  Only if no answer arrives within the receive
+ *   timeout are the unanswered queries sent again.
+ *
+ * Returned Value:
+ *   Returns zero (OK) if at least one address was found.  Otherwise, a
+ *   negated errno value indicating the reason for the last failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+static int dns_query_parallel(FAR struct dns_query_s *query)
+{
+  static const uint16_t rectypes[DNS_NRECTYPES] =
+  {
+#ifdef CONFIG_NET_IPv6
+    DNS_RECTYPE_AAAA,
+#endif
+#ifdef CONFIG_NET_IPv4
+    DNS_RECTYPE_A,
+#endif
+  };
+
+  struct dns_query_info_s
+    qinfo[CONFIG_NETDB_DNSCLIENT_PARALLEL_SERVERS][DNS_NRECTYPES];
+  bool outstanding[CONFIG_NETDB_DNSCLIENT_PARALLEL_SERVERS][DNS_NRECTYPES];
+  bool answered[DNS_NRECTYPES];
+  uint8_t sendbuf[SEND_BUFFER_SIZE];
+  char recvbuf[RECV_BUFFER_SIZE];
+  FAR struct dns_header_s *hdr;
+  uint32_t ttl;
+  bool waiting;
+  int next = 0;
+  int retries;
+  int ret;
+  int len;
+  int i;
+  int t;
+
+  /* Get the list of name servers */
+
+  query->nservers = 0;
+  ret = dns_foreach_nameserver(dns_collect_callback, query);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(answered, 0, sizeof(answered));
+  memset(outstanding, 0, sizeof(outstanding));
+
+  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+    {
+      /* Send the queries that have not been answered yet to all name
+       * servers.
+       */
+
+      waiting = false;
+      for (t = 0; t < DNS_NRECTYPES; t++)
+        {
+          if (answered[t])
+            {
+              continue;
+            }
+
+          for (i = 0; i < query->nservers; i++)
+            {
+              len = dns_build_query(sendbuf, query->hostname, rectypes[t],
+                                    &qinfo[i][t]);
+              ret = sendto(query->sd, sendbuf, len, 0,
+                           &query->servers[i].addr,
+                           dns_addrlen(&query->servers[i]));
+              if (ret < 0)
+                {
+                  query->result = -errno;
+                  nerr("ERROR: sendto failed: %d\n", query->result);
+                  outstanding[i][t] = false;
+                }
+              else
+                {
+                  outstanding[i][t] = true;
+                  waiting = true;
+                }
+            }
+        }
+
+      /* Collect the responses */
+
+      while (waiting)
+        {
+          ret = _NX_RECV(query->sd, recvbuf, RECV_BUFFER_SIZE, 0);
+          if (ret < 0)
+            {
+              /* -EAGAIN is a receive timeout */
+
+              query->result = -_NX_GETERRNO(ret);
+              nerr("ERROR: recv failed: %d\n", query->result);
+              break;
+            }
+
+          if (ret < sizeof(struct dns_header_s))
+            {
+              continue;
+            }
+
+          /* Find the query that this is a response to */
+
+          hdr = (FAR struct dns_header_s *)recvbuf;
+          for (t = 0; t < DNS_NRECTYPES; t++)
+            {
+              for (i = 0; i < query->nservers; i++)
+                {
+                  if (outstanding[i][t] && qinfo[i][t].id == hdr->id)
+                    {
+                      goto found;
+                    }
+                }
+            }
+
+          ninfo("Ignoring response with ID %d\n", ntohs(hdr->id));
+          continue;
+
+found:
+          outstanding[i][t] = false;
+
+          if (next >= *query->naddr)
+            {
+              /* No space for more addresses */
+
+              ret = -ERANGE;
+            }
+          else
+            {
+              ret = dns_parse_response(recvbuf, ret, &query->addr[next],
+                                       *query->naddr - next, &qinfo[i][t],
+                                       &ttl);
+            }
+
+          if (ret >= 0)
+            {
+              next += ret;
+              query->ttl = MIN(query->ttl, ttl);
+              answered[t] = true;
+            }
+          else
+            {
+              /* A non-existent name is a final answer, too */
+
+              query->result = ret;
+              answered[t] = (ret == -EADDRNOTAVAIL || ret == -ERANGE);
+            }
+
+          /* Answers of other servers for the same type are ignored */
+
+          if (answered[t])
+            {
+              for (i = 0; i < query->nservers; i++)
+                {
+                  outstanding[i][t] = false;
+                }
+            }
+
+          /* Is there any response still to wait for? */
+
+          waiting = false;
+          for (t = 0; t < DNS_NRECTYPES; t++)
+            {
+              for (i = 0; i < query->nservers; i++)
+                {
+                  waiting |= outstanding[i][t];
+                }
+            }
+        }
+
+      /* Done if all types were answered or only other errors than
+       * timeouts occurred.
+       */
+
+      waiting = false;
+      for (t = 0; t < DNS_NRECTYPES; t++)
+        {
+          waiting |= !answered[t];
+        }
+
+      if (!waiting || query->result != -EAGAIN)
+        {
+          break;
+        }
+    }
+
+  if (next > 0)
+    {
+      *query->naddr = next;
+      return OK;
+    }
+
+  return query->result;
+}
+#endif /* CONFIG_NETDB_DNSCLIENT_PARALLEL */
 
 /****************************************************************************
  * Public Functions
@@ -700,7 +1012,13 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
   query.hostname = hostname;
   query.addr     = addr;
   query.naddr    = naddr;
+  query.ttl      = UINT32_MAX;
+
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+  /* Query all name servers at once */
 
+  ret = dns_query_parallel(&query);
+#else
   /* Perform the query. dns_foreach_nameserver() will return:
    *
    *  1 - The query was successful.
@@ -719,6 +1037,22 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
     {
       ret = query.result;
     }
+#endif
+
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  if (ret == OK)
+    {
+      /* Save the answer in the DNS cache */
+
+      dns_save_answer(hostname, addr, *naddr, query.ttl);
+    }
+  else if (ret == -EADDRNOTAVAIL)
+    {
+      /* Remember that the name does not resolve */
+
+      dns_save_answer(hostname, addr, 0, 0);
+    }
+#endif
 
   return ret;
 }
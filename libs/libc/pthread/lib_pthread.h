@@ -0,0 +1,79 @@
+/****************************************************************************
+ * libs/libc/pthread/lib_pthread.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_PTHREAD_LIB_PTHREAD_H
+#define __LIBS_LIBC_PTHREAD_LIB_PTHREAD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_rwlock_grant
+ *
+ * Description:
+ *   Hand the read/write lock over to waiting threads, if possible.  A
+ *   waiting writer is preferred; otherwise, all waiting readers are
+ *   admitted at once.  The woken threads own the lock on return from
+ *   their wait and do not contend for it again.
+ *
+ * Input Parameters:
+ *   rw_lock - The read/write lock.  The caller holds rw_lock->lock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void lib_rwlock_grant(FAR pthread_rwlock_t *rw_lock);
+
+/****************************************************************************
+ * Name: lib_rwlock_wait
+ *
+ * Description:
+ *   Wait until the read/write lock is granted to this thread by
+ *   lib_rwlock_grant().  The caller holds rw_lock->lock and has counted
+ *   itself as a waiting reader or writer; rw_lock->lock is released.
+ *
+ * Input Parameters:
+ *   rw_lock - The read/write lock
+ *   writer  - True if waiting for write access
+ *   clockid - The clock of the timeout
+ *   ts      - The absolute timeout, or NULL to wait forever
+ *
+ * Returned Value:
+ *   0 if the lock was granted or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int lib_rwlock_wait(FAR pthread_rwlock_t *rw_lock, bool writer,
+                    clockid_t clockid, FAR const struct timespec *ts);
+
+#endif /* __LIBS_LIBC_PTHREAD_LIB_PTHREAD_H */
@@ -93,6 +93,7 @@ int pthread_cond_init(FAR pthread_cond_t *cond,
       sem_setprotocol(&cond->sem, SEM_PRIO_NONE);
 
       cond->clockid = attr ? attr->clockid : CLOCK_REALTIME;
+      cond->mutex   = NULL;
     }
 
   sinfo("Returning %d\n", ret);
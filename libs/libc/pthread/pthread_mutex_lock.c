@@ -39,8 +39,71 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <pthread.h>
 
+#include <arch/tls.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_PTHREAD_MUTEX_FASTPATH) && \
+    defined(__GCC_ATOMIC_SHORT_LOCK_FREE) && __GCC_ATOMIC_SHORT_LOCK_FREE == 2
+#  define HAVE_MUTEX_FASTPATH 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_fastlock
+ *
+ * Description:
+ *   Try to lock an unlocked mutex without calling into the OS by moving the
+ *   semaphore count from 1 (unlocked) to 0 (locked, no waiters).
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be locked.
+ *
+ * Returned Value:
+ *   True if the mutex was locked; false if the OS must be called.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_MUTEX_FASTPATH
+static inline bool pthread_mutex_fastlock(FAR pthread_mutex_t *mutex)
+{
+  int16_t expected = 1;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* The OS must record the holder of a priority inheritance mutex */
+
+  if ((mutex->sem.flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+    {
+      return false;
+    }
+#endif
+
+  if (!__atomic_compare_exchange_n((FAR int16_t *)&mutex->sem.semcount,
+                                   &expected, 0, false, __ATOMIC_ACQUIRE,
+                                   __ATOMIC_RELAXED))
+    {
+      return false;
+    }
+
+  /* We own the mutex now */
+
+  mutex->pid    = up_tls_info()->tl_pid;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  mutex->nlocks = 1;
+#endif
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -97,6 +160,15 @@
 
 int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 {
+#ifdef HAVE_MUTEX_FASTPATH
+  /* Try to lock an uncontended mutex without a system call */
+
+  if (mutex != NULL && pthread_mutex_fastlock(mutex))
+    {
+      return OK;
+    }
+#endif
+
   /* pthread_mutex_lock() is equivalent to pthread_mutex_timedlock() when
    * the absolute time delay is a NULL value.
    */
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_mutex_unlock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <nuttx/pthread.h>
+#include <arch/tls.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_PTHREAD_MUTEX_FASTPATH) && \
+    defined(__GCC_ATOMIC_SHORT_LOCK_FREE) && __GCC_ATOMIC_SHORT_LOCK_FREE == 2
+#  define HAVE_MUTEX_FASTPATH 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_fastunlock
+ *
+ * Description:
+ *   Try to unlock a mutex held by the caller without calling into the OS
+ *   by moving the semaphore count from 0 (locked, no waiters) to 1
+ *   (unlocked).  If there are waiters, the OS must wake one of them.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked.
+ *
+ * Returned Value:
+ *   True if the mutex was unlocked; false if the OS must be called.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_MUTEX_FASTPATH
+static inline bool pthread_mutex_fastunlock(FAR pthread_mutex_t *mutex)
+{
+  int16_t expected = 0;
+  pid_t mypid;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* The OS must release the holder of a priority inheritance mutex */
+
+  if ((mutex->sem.flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+    {
+      return false;
+    }
+#endif
+
+  /* Let the OS deal with errors and with recursive locks */
+
+  mypid = up_tls_info()->tl_pid;
+  if (mutex->pid != mypid)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  if (mutex->nlocks > 1)
+    {
+      return false;
+    }
+
+  mutex->nlocks = 0;
+#endif
+
+  mutex->pid = -1;
+  if (__atomic_compare_exchange_n((FAR int16_t *)&mutex->sem.semcount,
+                                  &expected, 1, false, __ATOMIC_RELEASE,
+                                  __ATOMIC_RELAXED))
+    {
+      return true;
+    }
+
+  /* There are waiters.  Restore the ownership for the OS */
+
+  mutex->pid    = mypid;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  mutex->nlocks = 1;
+#endif
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_unlock
+ *
+ * Description:
+ *   The pthread_mutex_unlock() function releases the mutex object referenced
+ *   by mutex.  See nx_pthread_mutex_unlock() for the full semantics.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+{
+#ifdef HAVE_MUTEX_FASTPATH
+  /* Try to release an uncontended mutex without a system call */
+
+  if (mutex != NULL && pthread_mutex_fastunlock(mutex))
+    {
+      return OK;
+    }
+#endif
+
+  return nx_pthread_mutex_unlock(mutex);
+}
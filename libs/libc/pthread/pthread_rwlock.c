@@ -40,14 +40,171 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <pthread.h>
+#include <semaphore.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/semaphore.h>
+
+#include "pthread/lib_pthread.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rwlock_abandon
+ *
+ * Description:
+ *   Stop waiting for the read/write lock after the wait failed.  The lock
+ *   may have been granted to this thread just before;  in that case it is
+ *   kept and OK is returned.
+ *
+ ****************************************************************************/
+
+static int rwlock_abandon(FAR pthread_rwlock_t *rw_lock, bool writer,
+                          int err)
+{
+  FAR sem_t *sem = writer ? &rw_lock->wrsem : &rw_lock->rdsem;
+
+  pthread_mutex_lock(&rw_lock->lock);
+
+  if (sem_trywait(sem) == OK)
+    {
+      err = OK;
+    }
+  else if (writer)
+    {
+      /* Readers held back only by this writer may now proceed */
+
+      rw_lock->num_writers--;
+      lib_rwlock_grant(rw_lock);
+    }
+  else
+    {
+      rw_lock->wait_readers--;
+    }
+
+  pthread_mutex_unlock(&rw_lock->lock);
+  return err;
+}
+
+#ifdef CONFIG_PTHREAD_CLEANUP
+static void rdwait_cleanup(FAR void *arg)
+{
+  FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
+
+  if (rwlock_abandon(rw_lock, false, ECANCELED) == OK)
+    {
+      pthread_rwlock_unlock(rw_lock);
+    }
+}
+
+static void wrwait_cleanup(FAR void *arg)
+{
+  FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
+
+  if (rwlock_abandon(rw_lock, true, ECANCELED) == OK)
+    {
+      pthread_rwlock_unlock(rw_lock);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: lib_rwlock_grant
+ *
+ * Description:
+ *   Hand the read/write lock over to waiting threads, if possible.
+ *
+ ****************************************************************************/
+
+void lib_rwlock_grant(FAR pthread_rwlock_t *rw_lock)
+{
+  if (rw_lock->write_in_progress)
+    {
+      return;
+    }
+
+  if (rw_lock->num_writers > 0)
+    {
+      /* Writers are preferred, but must wait for the readers to leave */
+
+      if (rw_lock->num_readers == 0)
+        {
+          rw_lock->num_writers--;
+          rw_lock->write_in_progress = true;
+          sem_post(&rw_lock->wrsem);
+        }
+    }
+  else
+    {
+      /* No writer is waiting;  admit all of the waiting readers */
+
+      while (rw_lock->wait_readers > 0)
+        {
+          rw_lock->wait_readers--;
+          rw_lock->num_readers++;
+          sem_post(&rw_lock->rdsem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: lib_rwlock_wait
+ *
+ * Description:
+ *   Wait until the read/write lock is granted to this thread.
+ *
+ ****************************************************************************/
+
+int lib_rwlock_wait(FAR pthread_rwlock_t *rw_lock, bool writer,
+                    clockid_t clockid, FAR const struct timespec *ts)
+{
+  FAR sem_t *sem = writer ? &rw_lock->wrsem : &rw_lock->rdsem;
+  int err;
+
+  pthread_mutex_unlock(&rw_lock->lock);
+
+#ifdef CONFIG_PTHREAD_CLEANUP
+  pthread_cleanup_push(writer ? wrwait_cleanup : rdwait_cleanup, rw_lock);
+#endif
+
+  /* The read/write lock functions never fail with EINTR */
+
+  do
+    {
+      if (ts != NULL)
+        {
+          err = sem_clockwait(sem, clockid, ts);
+        }
+      else
+        {
+          err = sem_wait(sem);
+        }
+
+      err = err < 0 ? get_errno() : OK;
+    }
+  while (err == EINTR);
+
+#ifdef CONFIG_PTHREAD_CLEANUP
+  pthread_cleanup_pop(0);
+#endif
+
+  if (err != OK)
+    {
+      err = rwlock_abandon(rw_lock, writer, err);
+    }
+
+  return err;
+}
+
 int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
                         FAR const pthread_rwlockattr_t *attr)
 {
@@ -60,35 +217,35 @@ int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
 
   lock->num_readers       = 0;
   lock->num_writers       = 0;
+  lock->wait_readers      = 0;
   lock->write_in_progress = false;
 
-  err = pthread_cond_init(&lock->cv, NULL);
-  if (err != 0)
-    {
-      return err;
-    }
-
   err = pthread_mutex_init(&lock->lock, NULL);
   if (err != 0)
     {
-      pthread_cond_destroy(&lock->cv);
       return err;
     }
 
+  /* The semaphores are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  sem_init(&lock->rdsem, 0, 0);
+  sem_setprotocol(&lock->rdsem, SEM_PRIO_NONE);
+  sem_init(&lock->wrsem, 0, 0);
+  sem_setprotocol(&lock->wrsem, SEM_PRIO_NONE);
+
   return err;
 }
 
 int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
 {
-  int cond_err  = pthread_cond_destroy(&lock->cv);
   int mutex_err = pthread_mutex_destroy(&lock->lock);
 
-  if (mutex_err)
-    {
-      return mutex_err;
-    }
+  sem_destroy(&lock->rdsem);
+  sem_destroy(&lock->wrsem);
 
-  return cond_err;
+  return mutex_err;
 }
 
 int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
@@ -107,14 +264,14 @@ int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
 
       if (rw_lock->num_readers == 0)
         {
-          err = pthread_cond_broadcast(&rw_lock->cv);
+          lib_rwlock_grant(rw_lock);
         }
     }
   else if (rw_lock->write_in_progress)
     {
       rw_lock->write_in_progress = false;
 
-      err = pthread_cond_broadcast(&rw_lock->cv);
+      lib_rwlock_grant(rw_lock);
     }
   else
     {
@@ -44,23 +44,18 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/lib_pthread.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-#ifdef CONFIG_PTHREAD_CLEANUP
-static void rdlock_cleanup(FAR void *arg)
-{
-  FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
-
-  pthread_mutex_unlock(&rw_lock->lock);
-}
-#endif
-
 static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
   int err;
 
+  /* Waiting writers are preferred over new readers */
+
   if (rw_lock->num_writers > 0 || rw_lock->write_in_progress)
     {
       err = EBUSY;
@@ -124,31 +119,22 @@ int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
       return err;
     }
 
-#ifdef CONFIG_PTHREAD_CLEANUP
-  pthread_cleanup_push(&rdlock_cleanup, rw_lock);
-#endif
-  while ((err = tryrdlock(rw_lock)) == EBUSY)
+  err = tryrdlock(rw_lock);
+  if (err == EBUSY)
     {
-      if (ts != NULL)
+      if (rw_lock->num_readers + rw_lock->wait_readers == UINT_MAX)
         {
-          err = pthread_cond_clockwait(&rw_lock->cv, &rw_lock->lock,
-                                       clockid, ts);
+          err = EAGAIN;
         }
       else
         {
-          err = pthread_cond_wait(&rw_lock->cv, &rw_lock->lock);
-        }
+          /* Wait to be granted the lock by the releasing writer */
 
-      if (err != 0)
-        {
-          break;
+          rw_lock->wait_readers++;
+          return lib_rwlock_wait(rw_lock, false, clockid, ts);
         }
     }
 
-#ifdef CONFIG_PTHREAD_CLEANUP
-  pthread_cleanup_pop(0);
-#endif
-
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
@@ -44,19 +44,7 @@
 #include <errno.h>
 #include <debug.h>
 
-/****************************************************************************
- * Private Functions
- ****************************************************************************/
-
-#ifdef CONFIG_PTHREAD_CLEANUP
-static void wrlock_cleanup(FAR void *arg)
-{
-  FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
-
-  rw_lock->num_writers--;
-  pthread_mutex_unlock(&rw_lock->lock);
-}
-#endif
+#include "pthread/lib_pthread.h"
 
 /****************************************************************************
  * Public Functions
@@ -111,53 +99,22 @@ int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
       return err;
     }
 
-  if (rw_lock->num_writers == UINT_MAX)
-    {
-      err = EAGAIN;
-      goto exit_with_mutex;
-    }
-
-  rw_lock->num_writers++;
-
-#ifdef CONFIG_PTHREAD_CLEANUP
-  pthread_cleanup_push(&wrlock_cleanup, rw_lock);
-#endif
-  while (rw_lock->write_in_progress || rw_lock->num_readers > 0)
+  if (!rw_lock->write_in_progress && rw_lock->num_readers == 0)
     {
-      if (ts != NULL)
-        {
-          err = pthread_cond_clockwait(&rw_lock->cv, &rw_lock->lock,
-                                       clockid, ts);
-        }
-      else
-        {
-          err = pthread_cond_wait(&rw_lock->cv, &rw_lock->lock);
-        }
-
-      if (err != 0)
-        {
-          break;
-        }
+      rw_lock->write_in_progress = true;
     }
-
-#ifdef CONFIG_PTHREAD_CLEANUP
-  pthread_cleanup_pop(0);
-#endif
-
-  if (err == 0)
+  else if (rw_lock->num_writers == UINT_MAX)
     {
-      rw_lock->write_in_progress = true;
+      err = EAGAIN;
     }
   else
     {
-      /* In case of error, notify any blocked readers. */
+      /* Wait to be granted the lock by the last thread to release it */
 
-      pthread_cond_broadcast(&rw_lock->cv);
+      rw_lock->num_writers++;
+      return lib_rwlock_wait(rw_lock, true, clockid, ts);
     }
 
-  rw_lock->num_writers--;
-
-exit_with_mutex:
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
@@ -40,6 +40,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <math.h>
 #include <stdint.h>
 #include <float.h>
@@ -48,7 +50,11 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define DTOA_MAX_DIG        DBL_DIG
+#ifdef CONFIG_LIBC_DTOA_FAST
+#  define DTOA_MAX_DIG      17    /* Enough for any double to read back */
+#else
+#  define DTOA_MAX_DIG      DBL_DIG
+#endif
 
 #define DTOA_MINUS          1
 #define DTOA_ZERO           2
@@ -0,0 +1,614 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_dtoa_fast.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "lib_dtoa_engine.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MAX(a, b)          ((a) > (b) ? (a) : (b))
+#define MIN(a, b)          ((a) < (b) ? (a) : (b))
+
+/* g_dtoa_pow10[i] holds 10^(8 * (i - DTOA_POW10_BIAS)), which covers the
+ * scale factors 10^-291 ... 10^340 needed over the whole double range.
+ */
+
+#define DTOA_POW10_BIAS    37
+
+/* The significand is scaled to an integer of DTOA_NDIGITS (+-1) digits */
+
+#define DTOA_NDIGITS       17
+
+/* Bound of the error of the scaled significand h, in units of its last
+ * bit.  The power of ten is within one unit and the product adds one
+ * more; twice that leaves a margin.  When the bits that decide the
+ * rounding are this close to a half, the exact comparison decides.
+ */
+
+#define DTOA_ERROR         4
+
+/* Words of the exact comparison.  Both sides stay below 870 bits over the
+ * whole double range.
+ */
+
+#define DTOA_BIGWORDS      30
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* mant * 2^exp, with bit 63 of mant set */
+
+struct dtoa_pow10_s
+{
+  uint64_t mant;
+  int16_t  exp;
+};
+
+/* Unsigned integer of the exact comparison, least significant word first */
+
+struct dtoa_big_s
+{
+  int      len;
+  uint32_t word[DTOA_BIGWORDS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct dtoa_pow10_s g_dtoa_pow10[] =
+{
+  { UINT64_C(0xd1476e2c07286faa), -1047 }, /* 1e-296 */
+  { UINT64_C(0x9becce62836ac577), -1020 }, /* 1e-288 */
+  { UINT64_C(0xe858ad248f5c22ca),  -994 }, /* 1e-280 */
+  { UINT64_C(0xad1c8eab5ee43b67),  -967 }, /* 1e-272 */
+  { UINT64_C(0x80fa687f881c7f8e),  -940 }, /* 1e-264 */
+  { UINT64_C(0xc0314325637a193a),  -914 }, /* 1e-256 */
+  { UINT64_C(0x8f31cc0937ae58d3),  -887 }, /* 1e-248 */
+  { UINT64_C(0xd5605fcdcf32e1d7),  -861 }, /* 1e-240 */
+  { UINT64_C(0x9efa548d26e5a6e2),  -834 }, /* 1e-232 */
+  { UINT64_C(0xece53cec4a314ebe),  -808 }, /* 1e-224 */
+  { UINT64_C(0xb080392cc4349ded),  -781 }, /* 1e-216 */
+  { UINT64_C(0x8380dea93da4bc60),  -754 }, /* 1e-208 */
+  { UINT64_C(0xc3f490aa77bd60fd),  -728 }, /* 1e-200 */
+  { UINT64_C(0x91ff83775423cc06),  -701 }, /* 1e-192 */
+  { UINT64_C(0xd98ddaee19068c76),  -675 }, /* 1e-184 */
+  { UINT64_C(0xa21727db38cb0030),  -648 }, /* 1e-176 */
+  { UINT64_C(0xf18899b1bc3f8ca2),  -622 }, /* 1e-168 */
+  { UINT64_C(0xb3f4e093db73a093),  -595 }, /* 1e-160 */
+  { UINT64_C(0x8613fd0145877586),  -568 }, /* 1e-152 */
+  { UINT64_C(0xc7caba6e7c5382c9),  -542 }, /* 1e-144 */
+  { UINT64_C(0x94db483840b717f0),  -515 }, /* 1e-136 */
+  { UINT64_C(0xddd0467c64bce4a1),  -489 }, /* 1e-128 */
+  { UINT64_C(0xa54394fe1eedb8ff),  -462 }, /* 1e-120 */
+  { UINT64_C(0xf64335bcf065d37d),  -436 }, /* 1e-112 */
+  { UINT64_C(0xb77ada0617e3bbcb),  -409 }, /* 1e-104 */
+  { UINT64_C(0x88b402f7fd75539b),  -382 }, /* 1e-96 */
+  { UINT64_C(0xcbb41ef979346bca),  -356 }, /* 1e-88 */
+  { UINT64_C(0x97c560ba6b0919a6),  -329 }, /* 1e-80 */
+  { UINT64_C(0xe2280b6c20dd5232),  -303 }, /* 1e-72 */
+  { UINT64_C(0xa87fea27a539e9a5),  -276 }, /* 1e-64 */
+  { UINT64_C(0xfb158592be068d2f),  -250 }, /* 1e-56 */
+  { UINT64_C(0xbb127c53b17ec159),  -223 }, /* 1e-48 */
+  { UINT64_C(0x8b61313bbabce2c6),  -196 }, /* 1e-40 */
+  { UINT64_C(0xcfb11ead453994ba),  -170 }, /* 1e-32 */
+  { UINT64_C(0x9abe14cd44753b53),  -143 }, /* 1e-24 */
+  { UINT64_C(0xe69594bec44de15b),  -117 }, /* 1e-16 */
+  { UINT64_C(0xabcc77118461cefd),   -90 }, /* 1e-8 */
+  { UINT64_C(0x8000000000000000),   -63 }, /* 1e0 */
+  { UINT64_C(0xbebc200000000000),   -37 }, /* 1e8 */
+  { UINT64_C(0x8e1bc9bf04000000),   -10 }, /* 1e16 */
+  { UINT64_C(0xd3c21bcecceda100),    16 }, /* 1e24 */
+  { UINT64_C(0x9dc5ada82b70b59e),    43 }, /* 1e32 */
+  { UINT64_C(0xeb194f8e1ae525fd),    69 }, /* 1e40 */
+  { UINT64_C(0xaf298d050e4395d7),    96 }, /* 1e48 */
+  { UINT64_C(0x82818f1281ed44a0),   123 }, /* 1e56 */
+  { UINT64_C(0xc2781f49ffcfa6d5),   149 }, /* 1e64 */
+  { UINT64_C(0x90e40fbeea1d3a4b),   176 }, /* 1e72 */
+  { UINT64_C(0xd7e77a8f87daf7fc),   202 }, /* 1e80 */
+  { UINT64_C(0xa0dc75f1778e39d6),   229 }, /* 1e88 */
+  { UINT64_C(0xefb3ab16c59b14a3),   255 }, /* 1e96 */
+  { UINT64_C(0xb2977ee300c50fe7),   282 }, /* 1e104 */
+  { UINT64_C(0x850fadc09923329e),   309 }, /* 1e112 */
+  { UINT64_C(0xc646d63501a1511e),   335 }, /* 1e120 */
+  { UINT64_C(0x93ba47c980e98ce0),   362 }, /* 1e128 */
+  { UINT64_C(0xdc21a1171d42645d),   388 }, /* 1e136 */
+  { UINT64_C(0xa402b9c5a8d3a6e7),   415 }, /* 1e144 */
+  { UINT64_C(0xf46518c2ef5b8cd1),   441 }, /* 1e152 */
+  { UINT64_C(0xb616a12b7fe617aa),   468 }, /* 1e160 */
+  { UINT64_C(0x87aa9aff79042287),   495 }, /* 1e168 */
+  { UINT64_C(0xca28a291859bbf93),   521 }, /* 1e176 */
+  { UINT64_C(0x969eb7c47859e744),   548 }, /* 1e184 */
+  { UINT64_C(0xe070f78d3927556b),   574 }, /* 1e192 */
+  { UINT64_C(0xa738c6bebb12d16d),   601 }, /* 1e200 */
+  { UINT64_C(0xf92e0c3537826146),   627 }, /* 1e208 */
+  { UINT64_C(0xb9a74a0637ce2ee1),   654 }, /* 1e216 */
+  { UINT64_C(0x8a5296ffe33cc930),   681 }, /* 1e224 */
+  { UINT64_C(0xce1de40642e3f4b9),   707 }, /* 1e232 */
+  { UINT64_C(0x9991a6f3d6bf1766),   734 }, /* 1e240 */
+  { UINT64_C(0xe4d5e82392a40515),   760 }, /* 1e248 */
+  { UINT64_C(0xaa7eebfb9df9de8e),   787 }, /* 1e256 */
+  { UINT64_C(0xfe0efb53d30dd4d8),   813 }, /* 1e264 */
+  { UINT64_C(0xbd49d14aa79dbc82),   840 }, /* 1e272 */
+  { UINT64_C(0x8d07e33455637eb3),   867 }, /* 1e280 */
+  { UINT64_C(0xd226fc195c6a2f8c),   893 }, /* 1e288 */
+  { UINT64_C(0x9c935e00d4b9d8d2),   920 }, /* 1e296 */
+  { UINT64_C(0xe950df20247c83fd),   946 }, /* 1e304 */
+  { UINT64_C(0xadd57a27d29339f6),   973 }, /* 1e312 */
+  { UINT64_C(0x81842f29f2cce376),  1000 }, /* 1e320 */
+  { UINT64_C(0xc0fe908895cf3b44),  1026 }, /* 1e328 */
+  { UINT64_C(0x8fcac257558ee4e6),  1053 }, /* 1e336 */
+};
+
+static const uint32_t g_dtoa_pow10_small[8] =
+{
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000
+};
+
+static const uint64_t g_dtoa_pow10_int[] =
+{
+  UINT64_C(1),
+  UINT64_C(10),
+  UINT64_C(100),
+  UINT64_C(1000),
+  UINT64_C(10000),
+  UINT64_C(100000),
+  UINT64_C(1000000),
+  UINT64_C(10000000),
+  UINT64_C(100000000),
+  UINT64_C(1000000000),
+  UINT64_C(10000000000),
+  UINT64_C(100000000000),
+  UINT64_C(1000000000000),
+  UINT64_C(10000000000000),
+  UINT64_C(100000000000000),
+  UINT64_C(1000000000000000),
+  UINT64_C(10000000000000000),
+  UINT64_C(100000000000000000),
+  UINT64_C(1000000000000000000),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Upper 64 bits of the 128-bit product a * b, rounded */
+
+static uint64_t dtoa_mulhi(uint64_t a, uint64_t b)
+{
+  uint64_t a0 = (uint32_t)a;
+  uint64_t a1 = a >> 32;
+  uint64_t b0 = (uint32_t)b;
+  uint64_t b1 = b >> 32;
+  uint64_t p01 = a0 * b1;
+  uint64_t p10 = a1 * b0;
+  uint64_t mid;
+
+  mid  = ((a0 * b0) >> 32) + (uint32_t)p01 + (uint32_t)p10;
+  mid += (uint64_t)1 << 31;
+
+  return a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+/* 10^p as a normalized 64-bit significand and a binary exponent: the
+ * nearest entry of the coarse table times an exact small power.
+ */
+
+static uint64_t dtoa_pow10(int p, FAR int *exp)
+{
+  FAR const struct dtoa_pow10_s *pow;
+  uint64_t mant;
+  uint64_t lo;
+  uint64_t hi;
+  uint32_t small;
+  int shift;
+
+  pow   = &g_dtoa_pow10[(p >> 3) + DTOA_POW10_BIAS];
+  small = g_dtoa_pow10_small[p & 7];
+
+  /* hi:lo<31:0> = pow->mant * small, up to 88 bits */
+
+  lo = (uint32_t)pow->mant * (uint64_t)small;
+  hi = (pow->mant >> 32) * small + (lo >> 32);
+
+  for (shift = 0; (hi >> shift) > UINT32_MAX; shift++);
+
+  mant = (hi << (32 - shift)) | ((uint32_t)lo >> shift);
+  if (shift > 0 && ((uint32_t)lo >> (shift - 1)) & 1)
+    {
+      if (++mant == 0)
+        {
+          mant = (uint64_t)1 << 63;
+          shift++;
+        }
+    }
+
+  *exp = pow->exp + shift;
+  return mant;
+}
+
+/* Exact integer helpers for dtoa_cmphalf() */
+
+static void dtoa_bigset(FAR struct dtoa_big_s *big, uint64_t value)
+{
+  big->word[0] = (uint32_t)value;
+  big->word[1] = (uint32_t)(value >> 32);
+  big->len     = big->word[1] != 0 ? 2 : 1;
+}
+
+static void dtoa_bigmul(FAR struct dtoa_big_s *big, uint32_t factor)
+{
+  uint64_t carry = 0;
+  int i;
+
+  for (i = 0; i < big->len; i++)
+    {
+      carry        += (uint64_t)big->word[i] * factor;
+      big->word[i]  = (uint32_t)carry;
+      carry       >>= 32;
+    }
+
+  if (carry != 0)
+    {
+      big->word[big->len++] = (uint32_t)carry;
+    }
+}
+
+static void dtoa_bigpow5(FAR struct dtoa_big_s *big, int e)
+{
+  /* 5^13 is the largest power of five that fits in 32 bits */
+
+  for (; e >= 13; e -= 13)
+    {
+      dtoa_bigmul(big, UINT32_C(1220703125));
+    }
+
+  for (; e > 0; e--)
+    {
+      dtoa_bigmul(big, 5);
+    }
+}
+
+static void dtoa_bigshl(FAR struct dtoa_big_s *big, int bits)
+{
+  int words = bits >> 5;
+  int i;
+
+  bits &= 31;
+  if (bits != 0)
+    {
+      big->word[big->len] = 0;
+      for (i = big->len; i > 0; i--)
+        {
+          big->word[i] = (big->word[i] << bits) |
+                         (big->word[i - 1] >> (32 - bits));
+        }
+
+      big->word[0] <<= bits;
+      if (big->word[big->len] != 0)
+        {
+          big->len++;
+        }
+    }
+
+  if (words != 0)
+    {
+      memmove(&big->word[words], big->word, big->len * sizeof(uint32_t));
+      memset(big->word, 0, words * sizeof(uint32_t));
+      big->len += words;
+    }
+}
+
+static int dtoa_bigcmp(FAR const struct dtoa_big_s *a,
+                       FAR const struct dtoa_big_s *b)
+{
+  int i;
+
+  if (a->len != b->len)
+    {
+      return a->len - b->len;
+    }
+
+  for (i = a->len - 1; i >= 0; i--)
+    {
+      if (a->word[i] != b->word[i])
+        {
+          return a->word[i] > b->word[i] ? 1 : -1;
+        }
+    }
+
+  return 0;
+}
+
+/* Compare mant * 2^e2 exactly with (m + 1/2) * 10^e10, the half-way point
+ * of the rounding.  Returns a value <0, 0 or >0 like memcmp().
+ */
+
+static int dtoa_cmphalf(uint64_t mant, int e2, uint64_t m, int e10)
+{
+  struct dtoa_big_s a;
+  struct dtoa_big_s b;
+  int shift;
+
+  /* Compare mant * 2^e2 with (2m + 1) * 5^e10 * 2^(e10 - 1) as integers:
+   * move the power of five and then the power of two to one side.
+   */
+
+  dtoa_bigset(&a, mant);
+  dtoa_bigset(&b, 2 * m + 1);
+
+  if (e10 >= 0)
+    {
+      dtoa_bigpow5(&b, e10);
+    }
+  else
+    {
+      dtoa_bigpow5(&a, -e10);
+    }
+
+  shift = e2 - (e10 - 1);
+  if (shift >= 0)
+    {
+      dtoa_bigshl(&a, shift);
+    }
+  else
+    {
+      dtoa_bigshl(&b, -shift);
+    }
+
+  return dtoa_bigcmp(&a, &b);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __dtoa_engine
+ *
+ * Description:
+ *   Table driven replacement of the engine in lib_dtoa_engine.c with the
+ *   same interface.  Instead of scaling the value into range with a chain
+ *   of floating point multiplications, the binary significand is multiplied
+ *   once by a 64-bit approximation of the right power of ten (as in Grisu)
+ *   giving a 17 or 18 digit integer, which is then rounded to the number of
+ *   digits wanted with integer arithmetic only.  When that integer is too
+ *   close to a rounding boundary for its error, an exact big integer
+ *   comparison decides, so that the digits are always correctly rounded
+ *   (halves away from zero).  Up to 17 significant digits are produced,
+ *   enough to print any double so that it reads back unchanged.
+ *
+ ****************************************************************************/
+
+int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
+                  int max_decimals)
+{
+  int32_t exp = 0;
+  uint8_t flags = 0;
+  int i;
+
+  if (__builtin_signbit(x))
+    {
+      flags |= DTOA_MINUS;
+      x = -x;
+    }
+
+  if (x == 0)
+    {
+      flags |= DTOA_ZERO;
+      for (i = 0; i < max_digits; i++)
+        dtoa->digits[i] = '0';
+    }
+  else if (isnan(x))
+    {
+      flags |= DTOA_NAN;
+    }
+  else if (isinf(x))
+    {
+      flags |= DTOA_INF;
+    }
+  else
+    {
+      uint64_t bits;
+      uint64_t mant;
+      uint64_t h;
+      uint64_t n;
+      uint64_t dist;
+      uint64_t err;
+      bool up;
+      int bexp;
+      int pexp;
+      int shift;
+      int ndigits;
+      int e10;
+      int k;
+
+      /* x = mant * 2^bexp with the top bit of mant set */
+
+      memcpy(&bits, &x, sizeof(bits));
+      mant = bits & (((uint64_t)1 << 52) - 1);
+      bexp = (bits >> 52) & 0x7ff;
+      if (bexp != 0)
+        {
+          mant |= (uint64_t)1 << 52;
+          bexp -= 1075;
+        }
+      else
+        {
+          bexp = -1074;
+        }
+
+      mant <<= 11;
+      bexp -= 11;
+      while ((mant & ((uint64_t)1 << 63)) == 0)
+        {
+          mant <<= 1;
+          bexp--;
+        }
+
+      /* k = floor(log10(2^(bexp + 63))), so 10^k <= x < 10^(k + 2) and
+       * n = x * 10^(16 - k) has 17 or 18 digits.
+       */
+
+      k = ((bexp + 63) * 78913) >> 18;
+
+      h     = dtoa_mulhi(mant, dtoa_pow10(DTOA_NDIGITS - 1 - k, &pexp));
+      shift = -(bexp + pexp + 64);
+      n     = h >> shift;
+
+      /* Rounding errors may leave n one digit short */
+
+      if (n >= g_dtoa_pow10_int[DTOA_NDIGITS])
+        {
+          ndigits = DTOA_NDIGITS + 1;
+        }
+      else if (n >= g_dtoa_pow10_int[DTOA_NDIGITS - 1])
+        {
+          ndigits = DTOA_NDIGITS;
+        }
+      else
+        {
+          ndigits = DTOA_NDIGITS - 1;
+        }
+
+      exp = k + ndigits - DTOA_NDIGITS;
+
+      /* If limiting decimals, then limit the max digits to no more than the
+       * number of digits left of the decimal plus the number of digits right
+       * of the decimal
+       */
+
+      if (max_decimals != 0)
+        {
+          max_digits = MIN(max_digits, max_decimals + MAX(exp + 1, 1));
+        }
+
+      /* Round nearest to max_digits digits.  h still holds the bits that
+       * were shifted out of n; use them when the divisor allows.  n is then
+       * the truncated value of n * 10^e10 and dist the distance of the
+       * remainder from the half-way point, both within err.
+       */
+
+      if (ndigits > max_digits)
+        {
+          uint64_t div = g_dtoa_pow10_int[ndigits - max_digits];
+          uint64_t rem;
+
+          err = DTOA_ERROR;
+          if (div <= (UINT64_MAX >> shift))
+            {
+              div <<= shift;
+              n     = h;
+            }
+          else
+            {
+              err = 2;
+            }
+
+          rem  = n % div;
+          n   /= div;
+          up   = rem >= div - rem;
+          dist = up ? rem - (div - rem) : (div - rem) - rem;
+          e10  = ndigits - max_digits - (DTOA_NDIGITS - 1 - k);
+        }
+      else
+        {
+          uint64_t half = (uint64_t)1 << (shift - 1);
+          uint64_t rem  = h & ((half << 1) - 1);
+
+          err  = DTOA_ERROR;
+          n    = h >> shift;
+          up   = rem >= half;
+          dist = 2 * (up ? rem - half : half - rem);
+          e10  = -(DTOA_NDIGITS - 1 - k);
+        }
+
+      /* Too close to call: compare the exact value with the half-way
+       * point.  This is rare; the error is a few units in 2^64.
+       */
+
+      if (dist <= 2 * err)
+        {
+          up = dtoa_cmphalf(mant, bexp, n, e10) >= 0;
+        }
+
+      if (up)
+        {
+          n++;
+        }
+
+      if (ndigits < max_digits)
+        {
+          n *= g_dtoa_pow10_int[max_digits - ndigits];
+        }
+
+      if (n >= g_dtoa_pow10_int[max_digits])
+        {
+          n /= 10;
+          exp++;
+        }
+
+      /* Convert to decimal, eight digits per 64-bit division */
+
+      i = max_digits;
+      while (i > 0)
+        {
+          uint32_t lo;
+          int j;
+
+          if (n > UINT32_MAX)
+            {
+              uint64_t hi = n / 100000000;
+
+              lo = (uint32_t)(n - hi * 100000000);
+              n  = hi;
+              j  = 8;
+            }
+          else
+            {
+              lo = (uint32_t)n;
+              n  = 0;
+              j  = i;
+            }
+
+          for (; j > 0; j--)
+            {
+              dtoa->digits[--i] = lo % 10 + '0';
+              lo /= 10;
+            }
+        }
+    }
+
+  dtoa->digits[max_digits] = '\0';
+  dtoa->flags = flags;
+  dtoa->exp = exp;
+  return max_digits;
+}
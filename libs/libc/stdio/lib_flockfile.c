@@ -0,0 +1,63 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_flockfile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+
+#include <nuttx/lib/lib.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: flockfile, ftrylockfile, funlockfile
+ *
+ * Description:
+ *   Lock and unlock a stream for exclusive use by the calling thread.  The
+ *   lock is recursive and is also the lock taken by every stream
+ *   operation, so a sequence of operations, or of the *_unlocked()
+ *   variants, is not interleaved with output from other threads.
+ *
+ * Returned Value:
+ *   ftrylockfile() returns zero if the lock was acquired or non-zero if
+ *   another thread holds it.
+ *
+ ****************************************************************************/
+
+void flockfile(FAR FILE *stream)
+{
+  lib_take_semaphore(stream);
+}
+
+int ftrylockfile(FAR FILE *stream)
+{
+  return lib_trytake_semaphore(stream);
+}
+
+void funlockfile(FAR FILE *stream)
+{
+  lib_give_semaphore(stream);
+}
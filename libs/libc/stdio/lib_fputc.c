@@ -38,6 +38,8 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <errno.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -50,27 +52,19 @@
 
 int fputc(int c, FAR FILE *stream)
 {
-  unsigned char buf = (unsigned char)c;
   int ret;
 
-  ret = lib_fwrite(&buf, 1, stream);
-  if (ret > 0)
-    {
-      /* Flush the buffer if a newline is output */
-
-      if (c == '\n' && (stream->fs_flags & __FS_FLAG_LBF) != 0)
-        {
-          ret = lib_fflush(stream, true);
-          if (ret < 0)
-            {
-              return EOF;
-            }
-        }
-
-      return c;
-    }
-  else
+  if (stream == NULL)
     {
+      set_errno(EBADF);
       return EOF;
     }
+
+  /* Hold the stream across the write and the line buffer flush */
+
+  lib_take_semaphore(stream);
+  ret = putc_unlocked(c, stream);
+  lib_give_semaphore(stream);
+
+  return ret;
 }
@@ -0,0 +1,57 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_fwrite_unlocked.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fwrite_unlocked
+ *
+ * Description:
+ *   Equivalent to fwrite(), but the stream is not locked.
+ *
+ ****************************************************************************/
+
+size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
+                       FAR FILE *stream)
+{
+  ssize_t bytes_written;
+
+  bytes_written = lib_fwrite_unlocked(ptr, n_items * size, stream);
+  if (bytes_written > 0)
+    {
+      /* Return the number of full items written */
+
+      return bytes_written / size;
+    }
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_getc_unlocked.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getc_unlocked, getchar_unlocked
+ *
+ * Description:
+ *   Equivalent to getc() and getchar(), but the stream is not locked.  The
+ *   caller holds the stream lock with flockfile() or knows that the stream
+ *   is not shared.
+ *
+ ****************************************************************************/
+
+int getc_unlocked(FAR FILE *stream)
+{
+  unsigned char ch;
+
+  if (lib_fread_unlocked(&ch, 1, stream) > 0)
+    {
+      return ch;
+    }
+
+  return EOF;
+}
+
+int getchar_unlocked(void)
+{
+  return getc_unlocked(stdin);
+}
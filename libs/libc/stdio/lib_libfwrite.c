@@ -50,15 +50,60 @@
 
 #include "libc.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_fwrite_direct
+ *
+ * Description:
+ *   Write data straight to the file, bypassing the stream buffer, until
+ *   all of it is written or an error occurs.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+static ssize_t lib_fwrite_direct(FAR const unsigned char *src, size_t count,
+                                 FAR FILE *stream)
+{
+  size_t remaining = count;
+  ssize_t nwritten;
+
+  while (remaining > 0)
+    {
+      nwritten = _NX_WRITE(stream->fs_fd, src, remaining);
+      if (nwritten < 0)
+        {
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+          _NX_SETERRNO((int)-nwritten);
+#endif
+          return ERROR;
+        }
+
+      src       += nwritten;
+      remaining -= nwritten;
+    }
+
+  return count;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: lib_fwrite
+ * Name: lib_fwrite_unlocked
+ *
+ * Description:
+ *   Write to the stream without taking the stream semaphore.  The caller
+ *   either holds it or knows that the stream is not shared.
+ *
  ****************************************************************************/
 
-ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
+ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
+                            FAR FILE *stream)
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
 {
   FAR const unsigned char *start = ptr;
@@ -98,18 +143,30 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
      goto errout;
    }
 
-  /* Get exclusive access to the stream */
-
-  lib_take_semaphore(stream);
-
   /* If the buffer is currently being used for read access, then
    * discard all of the read-ahead data.  We do not support concurrent
    * buffered read/write access.
    */
 
-  if (lib_rdflush(stream) < 0)
+  if (stream->fs_bufread != stream->fs_bufstart && lib_rdflush(stream) < 0)
+    {
+      goto errout;
+    }
+
+  /* A write that would fill the whole buffer gains nothing from being
+   * copied through it.  Flush whatever is buffered to keep the data in
+   * order, then write the user data directly.
+   */
+
+  if (count >= (size_t)(stream->fs_bufend - stream->fs_bufstart))
     {
-      goto errout_with_semaphore;
+      if (lib_fflush(stream, true) < 0)
+        {
+          goto errout;
+        }
+
+      ret = lib_fwrite_direct(src, count, stream);
+      goto errout;
     }
 
   /* Loop until all of the bytes have been buffered */
@@ -155,7 +212,7 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
           int bytes_buffered = lib_fflush(stream, false);
           if (bytes_buffered < 0)
             {
-              goto errout_with_semaphore;
+              goto errout;
             }
         }
     }
@@ -164,9 +221,6 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   ret = (uintptr_t)src - (uintptr_t)start;
 
-errout_with_semaphore:
-  lib_give_semaphore(stream);
-
 errout:
   if (ret < 0)
     {
@@ -187,3 +241,26 @@ errout:
   return ret;
 }
 #endif /* CONFIG_STDIO_DISABLE_BUFFERING */
+
+/****************************************************************************
+ * Name: lib_fwrite
+ ****************************************************************************/
+
+ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
+{
+  ssize_t ret;
+
+  if (stream == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  /* Get exclusive access to the stream */
+
+  lib_take_semaphore(stream);
+  ret = lib_fwrite_unlocked(ptr, count, stream);
+  lib_give_semaphore(stream);
+
+  return ret;
+}
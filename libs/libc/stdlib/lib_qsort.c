@@ -47,7 +47,27 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+/* The parallel sort runs on the kernel low priority work queue, which
+ * user space cannot reach in the PROTECTED and KERNEL builds.  There the
+ * user-space library always sorts in the calling thread.
+ */
+
+#if defined(CONFIG_LIBC_QSORT_SMP) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define QSORT_PARALLEL 1
+#endif
+
+#ifdef QSORT_PARALLEL
+#  include <nuttx/semaphore.h>
+#  include <nuttx/wqueue.h>
+#endif
+
+#include "libc.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -55,116 +75,234 @@
 
 #define min(a, b)  (a) < (b) ? a : b
 
-#define swapcode(TYPE, parmi, parmj, n) \
-  { \
-    long i = (n) / sizeof (TYPE); \
-    register TYPE *pi = (TYPE *)(parmi); \
-    register TYPE *pj = (TYPE *)(parmj); \
-    do { \
-      register TYPE  t = *pi; \
-      *pi++ = *pj; \
-      *pj++ = t; \
-    } while (--i > 0); \
-  }
-
-#define SWAPINIT(a, width) \
-  swaptype = ((FAR char *)a - (FAR char *)0) % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long)? 0 : 1;
-
-#define swap(a, b) \
-  if (swaptype == 0) \
-    { \
-      long t = *(long *)(a); \
-      *(long *)(a) = *(long *)(b); \
-      *(long *)(b) = t; \
-    } \
-  else \
-    { \
-      swapfunc(a, b, width, swaptype); \
-    }
+/* Partitions smaller than this are insertion sorted */
+
+#define QSORT_INSERTION  12
+
+/* How elements are swapped: one long, several longs, or longs copied from
+ * unaligned memory and then the remaining bytes.
+ */
+
+#define QSORT_SWAPWORD   0
+#define QSORT_SWAPWORDS  1
+#define QSORT_SWAPBYTES  2
+
+#define QSORT_SWAPTYPE(a, width) \
+  ((uintptr_t)(a) % sizeof(long) != 0 || (width) % sizeof(long) != 0 ? \
+   QSORT_SWAPBYTES : (width) == sizeof(long) ? QSORT_SWAPWORD : \
+   QSORT_SWAPWORDS)
 
-#define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
+#define QSORT_ELEM(ctx, base, i)  ((FAR char *)(base) + (i) * (ctx)->width)
 
 /****************************************************************************
- * Private Function Prototypes
+ * Private Types
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+struct qsort_s
+{
+  CODE int (*compar)(FAR const void *, FAR const void *);
+  CODE int (*compar_r)(FAR const void *, FAR const void *, FAR void *);
+  FAR void *arg;
+  size_t width;
+  int swaptype;
+};
+
+#ifdef QSORT_PARALLEL
+struct qsort_job_s
+{
+  struct work_s work;
+  FAR const struct qsort_s *ctx;
+  FAR char *base;
+  size_t nel;
+  FAR sem_t *done;
+};
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+static inline int qsort_cmp(FAR const struct qsort_s *ctx,
+                            FAR const char *a, FAR const char *b)
+{
+  if (ctx->compar_r != NULL)
+    {
+      return ctx->compar_r(a, b, ctx->arg);
+    }
+
+  return ctx->compar(a, b);
+}
+
+static void qsort_swapfunc(FAR char *a, FAR char *b, size_t n,
+                           int swaptype)
+{
+  long t;
+
+  if (swaptype != QSORT_SWAPBYTES)
+    {
+      FAR long *pa = (FAR long *)a;
+      FAR long *pb = (FAR long *)b;
+
+      for (; n > 0; n -= sizeof(long))
+        {
+          t     = *pa;
+          *pa++ = *pb;
+          *pb++ = t;
+        }
+
+      return;
+    }
+
+  for (; n >= sizeof(long); n -= sizeof(long))
+    {
+      memcpy(&t, a, sizeof(long));
+      memcpy(a, b, sizeof(long));
+      memcpy(b, &t, sizeof(long));
+      a += sizeof(long);
+      b += sizeof(long);
+    }
+
+  for (; n > 0; n--)
+    {
+      char c = *a;
+
+      *a++ = *b;
+      *b++ = c;
+    }
+}
+
+static inline void qsort_swap(FAR const struct qsort_s *ctx,
+                              FAR char *a, FAR char *b)
 {
-  if (swaptype <= 1)
+  if (ctx->swaptype == QSORT_SWAPWORD)
     {
-      swapcode(long, a, b, n)
+      long t = *(FAR long *)a;
+
+      *(FAR long *)a = *(FAR long *)b;
+      *(FAR long *)b = t;
     }
   else
     {
-      swapcode(char, a, b, n)
+      qsort_swapfunc(a, b, ctx->width, ctx->swaptype);
     }
 }
 
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+static inline void qsort_vecswap(FAR const struct qsort_s *ctx,
+                                 FAR char *a, FAR char *b, size_t n)
 {
-  return compar(a, b) < 0 ?
-         (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
-         (compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c));
+  if (n > 0)
+    {
+      qsort_swapfunc(a, b, n, ctx->swaptype);
+    }
 }
 
-/****************************************************************************
- * Public Function
- ****************************************************************************/
+static inline FAR char *qsort_med3(FAR const struct qsort_s *ctx,
+                                   FAR char *a, FAR char *b, FAR char *c)
+{
+  if (qsort_cmp(ctx, a, b) < 0)
+    {
+      return qsort_cmp(ctx, b, c) < 0 ? b :
+             (qsort_cmp(ctx, a, c) < 0 ? c : a);
+    }
+
+  return qsort_cmp(ctx, b, c) > 0 ? b :
+         (qsort_cmp(ctx, a, c) < 0 ? a : c);
+}
+
+/* Insertion sort.  With a non-zero limit, give up once more than 'limit'
+ * elements had to be moved and return false.
+ */
+
+static bool qsort_insertion(FAR const struct qsort_s *ctx, FAR char *base,
+                            size_t nel, size_t limit)
+{
+  FAR char *end = QSORT_ELEM(ctx, base, nel);
+  size_t width = ctx->width;
+  size_t moves = 0;
+  FAR char *pm;
+  FAR char *pl;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && qsort_cmp(ctx, pl - width, pl) > 0;
+           pl -= width)
+        {
+          qsort_swap(ctx, pl, pl - width);
+        }
+
+      if (pl != pm)
+        {
+          moves += (pm - pl) / width;
+          if (limit != 0 && moves > limit)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+/* Heapsort, the worst case fallback */
+
+static void qsort_sift(FAR const struct qsort_s *ctx, FAR char *base,
+                       size_t root, size_t nel)
+{
+  size_t child;
+
+  while ((child = 2 * root + 1) < nel)
+    {
+      if (child + 1 < nel &&
+          qsort_cmp(ctx, QSORT_ELEM(ctx, base, child),
+                    QSORT_ELEM(ctx, base, child + 1)) < 0)
+        {
+          child++;
+        }
+
+      if (qsort_cmp(ctx, QSORT_ELEM(ctx, base, root),
+                    QSORT_ELEM(ctx, base, child)) >= 0)
+        {
+          break;
+        }
+
+      qsort_swap(ctx, QSORT_ELEM(ctx, base, root),
+                 QSORT_ELEM(ctx, base, child));
+      root = child;
+    }
+}
+
+static void qsort_heapsort(FAR const struct qsort_s *ctx, FAR char *base,
+                           size_t nel)
+{
+  size_t i;
+
+  for (i = nel / 2; i-- > 0; )
+    {
+      qsort_sift(ctx, base, i, nel);
+    }
+
+  for (i = nel - 1; i > 0; i--)
+    {
+      qsort_swap(ctx, base, QSORT_ELEM(ctx, base, i));
+      qsort_sift(ctx, base, 0, i);
+    }
+}
 
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_intro
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
- *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   Bentley and McIlroy's quicksort with a three-way partition, bounded as
+ *   an introsort: after 'depth' levels of partitioning the rest is
+ *   heapsorted.  The smaller side is sorted recursively and the larger one
+ *   iteratively, so the stack depth is logarithmic.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void qsort_intro(FAR const struct qsort_s *ctx, FAR char *base,
+                        size_t nel, int depth)
 {
+  size_t width = ctx->width;
   FAR char *pa;
   FAR char *pb;
   FAR char *pc;
@@ -172,126 +310,365 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
-  int swap_cnt;
-  int d;
-  int r;
-
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
-
-  if (nel < 7)
+  size_t nl;
+  size_t nr;
+  size_t d;
+  size_t r;
+  bool swapped;
+  int ret;
+
+  while (nel >= QSORT_INSERTION)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (depth-- == 0)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          qsort_heapsort(ctx, base, nel);
+          return;
         }
 
-      return;
-  }
-
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
+      pm = QSORT_ELEM(ctx, base, nel / 2);
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
+      pn = QSORT_ELEM(ctx, base, nel - 1);
       if (nel > 40)
         {
           d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          pl = qsort_med3(ctx, pl, pl + d, pl + 2 * d);
+          pm = qsort_med3(ctx, pm - d, pm, pm + d);
+          pn = qsort_med3(ctx, pn - 2 * d, pn - d, pn);
         }
 
-      pm = med3(pl, pm, pn, compar);
-    }
+      pm = qsort_med3(ctx, pl, pm, pn);
 
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      qsort_swap(ctx, base, pm);
+      pa = pb = base + width;
+      pc = pd = QSORT_ELEM(ctx, base, nel - 1);
+      swapped = false;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      for (; ; )
         {
-          if (r == 0)
+          while (pb <= pc && (ret = qsort_cmp(ctx, pb, base)) <= 0)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              if (ret == 0)
+                {
+                  swapped = true;
+                  qsort_swap(ctx, pa, pb);
+                  pa += width;
+                }
+
+              pb += width;
             }
 
-          pb += width;
-        }
+          while (pb <= pc && (ret = qsort_cmp(ctx, pc, base)) >= 0)
+            {
+              if (ret == 0)
+                {
+                  swapped = true;
+                  qsort_swap(ctx, pc, pd);
+                  pd -= width;
+                }
+
+              pc -= width;
+            }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
-        {
-          if (r == 0)
+          if (pb > pc)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              break;
             }
 
-          pc -= width;
+          qsort_swap(ctx, pb, pc);
+          swapped = true;
+          pb     += width;
+          pc     -= width;
         }
 
-      if (pb > pc)
+      /* Move the elements equal to the pivot to the middle */
+
+      pn = QSORT_ELEM(ctx, base, nel);
+      r  = min(pa - base, pb - pa);
+      qsort_vecswap(ctx, base, pb - r, r);
+
+      r  = min(pd - pc, pn - pd - width);
+      qsort_vecswap(ctx, pb, pn - r, r);
+
+      nl = (pb - pa) / width;
+      nr = (pd - pc) / width;
+
+      /* Nothing had to be swapped: the data is probably nearly sorted.
+       * Try to finish with insertions, but give up after as many moves as
+       * there are elements so that this stays linear.
+       */
+
+      if (!swapped &&
+          qsort_insertion(ctx, base, nl, nl) &&
+          qsort_insertion(ctx, pn - nr * width, nr, nr))
         {
-          break;
+          return;
         }
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
+      if (nl < nr)
+        {
+          qsort_intro(ctx, base, nl, depth);
+          base = pn - nr * width;
+          nel  = nr;
+        }
+      else
+        {
+          qsort_intro(ctx, pn - nr * width, nr, depth);
+          nel  = nl;
+        }
     }
 
-  if (swap_cnt == 0)
+  qsort_insertion(ctx, base, nel, 0);
+}
+
+static void qsort_sort(FAR const struct qsort_s *ctx, FAR char *base,
+                       size_t nel)
+{
+  int depth = 0;
+  size_t n;
+
+  for (n = nel; n > 1; n >>= 1)
     {
-      /* Switch to insertion sort */
+      depth += 2;
+    }
+
+  qsort_intro(ctx, base, nel, depth);
+}
+
+#ifdef QSORT_PARALLEL
+static void qsort_worker(FAR void *arg)
+{
+  FAR struct qsort_job_s *job = arg;
+
+  qsort_sort(job->ctx, job->base, job->nel);
+  _SEM_POST(job->done);
+}
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+/* Merge the sorted runs src[lo..mid) and src[mid..hi) into dst[lo..hi) */
+
+static void qsort_merge(FAR const struct qsort_s *ctx, FAR char *src,
+                        FAR char *dst, size_t lo, size_t mid, size_t hi)
+{
+  FAR char *a    = QSORT_ELEM(ctx, src, lo);
+  FAR char *aend = QSORT_ELEM(ctx, src, mid);
+  FAR char *b    = aend;
+  FAR char *bend = QSORT_ELEM(ctx, src, hi);
+  FAR char *out  = QSORT_ELEM(ctx, dst, lo);
+  size_t width   = ctx->width;
+
+  while (a < aend && b < bend)
+    {
+      if (qsort_cmp(ctx, b, a) < 0)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          memcpy(out, b, width);
+          b += width;
+        }
+      else
+        {
+          memcpy(out, a, width);
+          a += width;
         }
 
-      return;
+      out += width;
+    }
+
+  memcpy(out, a, aend - a);
+  memcpy(out + (aend - a), b, bend - b);
+}
+
+/****************************************************************************
+ * Name: qsort_parallel
+ *
+ * Description:
+ *   Sort one part of the array per CPU, all but the first on the low
+ *   priority work queue, then merge the sorted parts through a temporary
+ *   buffer.  Parts that no worker has started yet when the caller is done
+ *   with its own are taken back and sorted by the caller, so a busy (or
+ *   the calling) work queue only costs parallelism.
+ *
+ * Returned Value:
+ *   False if the temporary buffer could not be allocated; nothing has
+ *   been done.
+ *
+ ****************************************************************************/
+
+static bool qsort_parallel(FAR const struct qsort_s *ctx, FAR char *base,
+                           size_t nel)
+{
+  struct qsort_job_s jobs[CONFIG_SMP_NCPUS];
+  size_t bounds[CONFIG_SMP_NCPUS + 1];
+  FAR char *src = base;
+  FAR char *dst;
+  FAR char *tmp;
+  sem_t done;
+  int step;
+  int hi;
+  int i;
+
+  tmp = lib_malloc(nel * ctx->width);
+  if (tmp == NULL)
+    {
+      return false;
+    }
+
+  _SEM_INIT(&done, 0, 0);
+  _SEM_SETPROTOCOL(&done, SEM_PRIO_NONE);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      bounds[i] = nel / CONFIG_SMP_NCPUS * i;
+    }
+
+  bounds[CONFIG_SMP_NCPUS] = nel;
+
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      memset(&jobs[i].work, 0, sizeof(jobs[i].work));
+      jobs[i].ctx  = ctx;
+      jobs[i].base = QSORT_ELEM(ctx, base, bounds[i]);
+      jobs[i].nel  = bounds[i + 1] - bounds[i];
+      jobs[i].done = &done;
+
+      if (work_queue(LPWORK, &jobs[i].work, qsort_worker, &jobs[i], 0) < 0)
+        {
+          qsort_worker(&jobs[i]);
+        }
     }
 
-  pn = (FAR char *)base + nel * width;
-  r  = min(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+  qsort_sort(ctx, base, bounds[1]);
 
-  r  = min(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (work_cancel(LPWORK, &jobs[i].work) == OK)
+        {
+          qsort_worker(&jobs[i]);
+        }
+    }
 
-  if ((r = pb - pa) > width)
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
     {
-      qsort(base, r / width, width, compar);
+      while (_SEM_WAIT(&done) < 0);
     }
 
-  if ((r = pd - pc) > width)
+  _SEM_DESTROY(&done);
+
+  /* Merge neighbouring runs, doubling their length on each pass */
+
+  dst = tmp;
+  for (step = 1; step < CONFIG_SMP_NCPUS; step <<= 1)
     {
-      /* Iterate rather than recurse to save stack space */
+      for (i = 0; i < CONFIG_SMP_NCPUS; i += 2 * step)
+        {
+          hi = min(i + 2 * step, CONFIG_SMP_NCPUS);
+          qsort_merge(ctx, src, dst, bounds[i],
+                      bounds[min(i + step, hi)], bounds[hi]);
+        }
+
+      dst = src;
+      src = src == base ? tmp : base;
+    }
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  if (src != base)
+    {
+      memcpy(base, src, nel * ctx->width);
     }
+
+  lib_free(tmp);
+  return true;
+}
+#endif
+
+static void qsort_start(FAR const struct qsort_s *ctx, FAR void *base,
+                        size_t nel)
+{
+#ifdef QSORT_PARALLEL
+  if (nel >= CONFIG_LIBC_QSORT_SMP_THRESHOLD &&
+      qsort_parallel(ctx, base, nel))
+    {
+      return;
+    }
+#endif
+
+  qsort_sort(ctx, base, nel);
+}
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  struct qsort_s ctx;
+
+  ctx.compar   = compar;
+  ctx.compar_r = NULL;
+  ctx.arg      = NULL;
+  ctx.width    = width;
+  ctx.swaptype = QSORT_SWAPTYPE(base, width);
+
+  qsort_start(&ctx, base, nel);
+}
+
+/****************************************************************************
+ * Name: qsort_r
+ *
+ * Description:
+ *   The qsort_r() function is qsort() with a comparison function that
+ *   takes a third argument, 'arg', passed through unchanged.
+ *
+ ****************************************************************************/
+
+void qsort_r(FAR void *base, size_t nel, size_t width,
+             CODE int (*compar)(FAR const void *, FAR const void *,
+                                FAR void *),
+             FAR void *arg)
+{
+  struct qsort_s ctx;
+
+  ctx.compar   = NULL;
+  ctx.compar_r = compar;
+  ctx.arg      = arg;
+  ctx.width    = width;
+  ctx.swaptype = QSORT_SWAPTYPE(base, width);
+
+  qsort_start(&ctx, base, nel);
 }
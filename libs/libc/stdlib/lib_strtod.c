@@ -44,6 +44,8 @@
 #include <ctype.h>
 #include <errno.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_HAVE_DOUBLE
 
 /****************************************************************************
@@ -87,6 +89,12 @@ static inline int is_real(double x)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_LIBC_STRTOD_FAST
+double strtod(FAR const char *str, FAR char **endptr)
+{
+  return lib_strtod(str, sizeof(char), (FAR void **)endptr);
+}
+#else
 double strtod(FAR const char *str, FAR char **endptr)
 {
   double number;
@@ -252,5 +260,6 @@ errout:
 
   return number;
 }
+#endif /* CONFIG_LIBC_STRTOD_FAST */
 
 #endif /* CONFIG_HAVE_DOUBLE */
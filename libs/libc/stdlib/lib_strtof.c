@@ -48,6 +48,8 @@
 #include <ctype.h>
 #include <errno.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Pre-processor definitions
  ****************************************************************************/
@@ -89,6 +91,12 @@ static inline int is_real(float x)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_LIBC_STRTOD_FAST
+float strtof(FAR const char *str, FAR char **endptr)
+{
+  return lib_strtof(str, sizeof(char), (FAR void **)endptr);
+}
+#else
 float strtof(FAR const char *str, FAR char **endptr)
 {
   float number;
@@ -254,3 +262,4 @@ errout:
 
   return number;
 }
+#endif /* CONFIG_LIBC_STRTOD_FAST */
@@ -0,0 +1,848 @@
+/****************************************************************************
+ * libs/libc/stdlib/lib_strtofp.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include <errno.h>
+#include <assert.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_LIBC_STRTOD_FAST
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Significant digits kept in the 64-bit significand */
+
+#define STRTOFP_MANTDIGITS  19
+
+/* Significant digits kept for the exact comparison.  A halfway point
+ * between two doubles has at most 767 significant digits, so any digit
+ * after these can only break a tie.
+ */
+
+#define STRTOFP_MAXDIGITS   768
+
+/* 32-bit limbs of the exact comparison: 5^1091 times a 54-bit halfway
+ * significand, the largest operand it can see.
+ */
+
+#define STRTOFP_LIMBS       84
+
+/* Range of decimal exponents for which the result is neither zero nor
+ * infinite, whatever the 19-digit significand.
+ */
+
+#define STRTOFP_MINEXP      (-342)
+#define STRTOFP_MAXEXP      308
+
+/* Largest exponent given to the number of the exponent part */
+
+#define STRTOFP_EXPLIMIT    100000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A scanned decimal number: the first digits and the decimal exponent to
+ * apply to them, and where to find all the digits again if they all are
+ * needed.
+ */
+
+struct strtofp_s
+{
+  uint64_t mant;              /* First STRTOFP_MANTDIGITS significant digits */
+  int exp;                    /* Decimal exponent of mant */
+  bool truncated;             /* Non-zero digits were left out of mant */
+  FAR const uint8_t *digits;  /* First character of the significand */
+  size_t width;               /* Size of one character */
+  int nchars;                 /* Characters of the significand */
+  int dexp;                   /* Decimal exponent of all the digits */
+};
+
+/* An unsigned big integer, least significant limb first */
+
+struct strtofp_big_s
+{
+  int len;
+  uint32_t d[STRTOFP_LIMBS];
+};
+
+/* A normalized 128-bit significand */
+
+struct strtofp_pow5_s
+{
+  uint64_t hi;
+  uint64_t lo;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* 5^(27 * k) for k = -13..11, truncated to 128 bits */
+
+static const struct strtofp_pow5_s g_strtofp_pow5_27[] =
+{
+  { 0x8049a4ac0c5811aeull, 0x205b896d777d6278ull }, /* 5^-351 */
+  { 0xcf42894a5dce35eaull, 0x52064cac828675b9ull }, /* 5^-324 */
+  { 0xa76c582338ed2621ull, 0xaf2af2b80af6f24eull }, /* 5^-297 */
+  { 0x873e4f75e2224e68ull, 0x5a7744a6e804a291ull }, /* 5^-270 */
+  { 0xda7f5bf590966848ull, 0xaf39a475506a899eull }, /* 5^-243 */
+  { 0xb080392cc4349decull, 0xbd8d794d96aacfb3ull }, /* 5^-216 */
+  { 0x8e938662882af53eull, 0x547eb47b7282ee9cull }, /* 5^-189 */
+  { 0xe65829b3046b0afaull, 0x0cb4a5a3112a5112ull }, /* 5^-162 */
+  { 0xba121a4650e4ddebull, 0x92f34d62616ce413ull }, /* 5^-135 */
+  { 0x964e858c91ba2655ull, 0x3a6a07f8d510f86full }, /* 5^-108 */
+  { 0xf2d56790ab41c2a2ull, 0xfae27299423fb9c3ull }, /* 5^-81 */
+  { 0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull }, /* 5^-54 */
+  { 0x9e74d1b791e07e48ull, 0x775ea264cf55347dull }, /* 5^-27 */
+  { 0x8000000000000000ull, 0x0000000000000000ull }, /* 5^0 */
+  { 0xcecb8f27f4200f3aull, 0x0000000000000000ull }, /* 5^27 */
+  { 0xa70c3c40a64e6c51ull, 0x999090b65f67d924ull }, /* 5^54 */
+  { 0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a3ull }, /* 5^81 */
+  { 0xda01ee641a708de9ull, 0xe80e6f4820cc9495ull }, /* 5^108 */
+  { 0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f8full }, /* 5^135 */
+  { 0x8e41ade9fbebc27dull, 0x14588f13be847307ull }, /* 5^162 */
+  { 0xe5d3ef282a242e81ull, 0x8f1668c8a86da5faull }, /* 5^189 */
+  { 0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173692ull }, /* 5^216 */
+  { 0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98eull }, /* 5^243 */
+  { 0xf24a01a73cf2dccfull, 0xbc633b39673c8cecull }, /* 5^270 */
+  { 0xc3b8358109e84f07ull, 0x0a862f80ec4700c8ull }, /* 5^297 */
+};
+
+/* 5^0..5^26, exact */
+
+static const uint64_t g_strtofp_pow5[] =
+{
+  1u, 5u, 25u, 125u, 625u, 3125u, 15625u, 78125u, 390625u, 1953125u,
+  9765625u, 48828125u, 244140625u, 1220703125u, 6103515625ull,
+  30517578125ull, 152587890625ull, 762939453125ull, 3814697265625ull,
+  19073486328125ull, 95367431640625ull, 476837158203125ull,
+  2384185791015625ull, 11920928955078125ull, 59604644775390625ull,
+  298023223876953125ull, 1490116119384765625ull
+};
+
+/* The powers of ten that are exactly representable */
+
+static const double g_strtofp_pow10[] =
+{
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+  1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+  1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const float g_strtofp_pow10f[] =
+{
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline int strtofp_getc(FAR const uint8_t *p, size_t width)
+{
+  return width == 1 ? *p : *(FAR const wchar_t *)p;
+}
+
+static inline bool strtofp_isdigit(int ch)
+{
+  return ch >= '0' && ch <= '9';
+}
+
+static inline int strtofp_clz(uint64_t v)
+{
+#ifdef CONFIG_HAVE_BUILTIN_CLZ
+  return __builtin_clzll(v);
+#else
+  int n = 0;
+
+  while ((v & ((uint64_t)1 << 63)) == 0)
+    {
+      v <<= 1;
+      n++;
+    }
+
+  return n;
+#endif
+}
+
+/* Full 128-bit product of two 64-bit values */
+
+static void strtofp_mul(uint64_t a, uint64_t b,
+                        FAR uint64_t *hi, FAR uint64_t *lo)
+{
+  uint64_t a0 = (uint32_t)a;
+  uint64_t a1 = a >> 32;
+  uint64_t b0 = (uint32_t)b;
+  uint64_t b1 = b >> 32;
+  uint64_t p00 = a0 * b0;
+  uint64_t p01 = a0 * b1;
+  uint64_t p10 = a1 * b0;
+  uint64_t mid;
+
+  mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+  *lo = (mid << 32) | (uint32_t)p00;
+  *hi = a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+/* 5^q as a normalized 128-bit significand, truncated, and its binary
+ * exponent: an entry of the coarse table times an exact small power.
+ * The truncated value is below 5^q by less than two units of its last
+ * place; it is exact for 0 <= q <= 55.
+ */
+
+static int strtofp_pow5(int q, FAR uint64_t *hi, FAR uint64_t *lo)
+{
+  FAR const struct strtofp_pow5_s *pow;
+  uint64_t mul;
+  uint64_t r0;
+  uint64_t r1;
+  uint64_t r2;
+  uint64_t h0;
+  int shift;
+  int exp;
+  int k;
+
+  k   = (q - STRTOFP_MINEXP + 9) / 27;
+  pow = &g_strtofp_pow5_27[k];
+  k   = 27 * k + STRTOFP_MINEXP - 9;
+  mul = g_strtofp_pow5[q - k];
+
+  /* floor(log2(5^k)) - 127, with log2(10) as 217706 / 2^16 */
+
+  exp = ((k * 217706) >> 16) - k - 127;
+
+  if (mul == 1)
+    {
+      *hi = pow->hi;
+      *lo = pow->lo;
+      return exp;
+    }
+
+  strtofp_mul(pow->lo, mul, &r1, &r0);
+  strtofp_mul(pow->hi, mul, &r2, &h0);
+  r1 += h0;
+  r2 += r1 < h0;
+
+  shift = strtofp_clz(r2);
+  if (shift != 0)
+    {
+      r2 = (r2 << shift) | (r1 >> (64 - shift));
+      r1 = (r1 << shift) | (r0 >> (64 - shift));
+    }
+
+  *hi = r2;
+  *lo = r1;
+  return exp + 64 - shift;
+}
+
+/* Exact big integer arithmetic for the hard cases */
+
+static void strtofp_bigset(FAR struct strtofp_big_s *big, uint64_t v)
+{
+  big->len = 0;
+  while (v != 0)
+    {
+      big->d[big->len++] = (uint32_t)v;
+      v >>= 32;
+    }
+}
+
+static void strtofp_bigmuladd(FAR struct strtofp_big_s *big, uint32_t mul,
+                              uint32_t add)
+{
+  uint64_t carry = add;
+  int i;
+
+  for (i = 0; i < big->len; i++)
+    {
+      carry += (uint64_t)big->d[i] * mul;
+      big->d[i] = (uint32_t)carry;
+      carry >>= 32;
+    }
+
+  if (carry != 0)
+    {
+      DEBUGASSERT(big->len < STRTOFP_LIMBS);
+      big->d[big->len++] = (uint32_t)carry;
+    }
+}
+
+static void strtofp_bigpow5(FAR struct strtofp_big_s *big, int n)
+{
+  /* 5^13 is the largest power of five that fits in a limb */
+
+  for (; n >= 13; n -= 13)
+    {
+      strtofp_bigmuladd(big, 1220703125u, 0);
+    }
+
+  if (n > 0)
+    {
+      strtofp_bigmuladd(big, (uint32_t)g_strtofp_pow5[n], 0);
+    }
+}
+
+static void strtofp_bigshl(FAR struct strtofp_big_s *big, int n)
+{
+  int words = n / 32;
+  int bits  = n % 32;
+  int i;
+
+  if (big->len == 0)
+    {
+      return;
+    }
+
+  DEBUGASSERT(big->len + words < STRTOFP_LIMBS);
+
+  if (bits != 0)
+    {
+      big->d[big->len] = 0;
+      for (i = big->len; i > 0; i--)
+        {
+          big->d[i] = (big->d[i] << bits) | (big->d[i - 1] >> (32 - bits));
+        }
+
+      big->d[0] <<= bits;
+      if (big->d[big->len] != 0)
+        {
+          big->len++;
+        }
+    }
+
+  if (words != 0)
+    {
+      memmove(&big->d[words], big->d, big->len * sizeof(uint32_t));
+      memset(big->d, 0, words * sizeof(uint32_t));
+      big->len += words;
+    }
+}
+
+static int strtofp_bigcmp(FAR const struct strtofp_big_s *a,
+                          FAR const struct strtofp_big_s *b)
+{
+  int i;
+
+  if (a->len != b->len)
+    {
+      return a->len < b->len ? -1 : 1;
+    }
+
+  for (i = a->len - 1; i >= 0; i--)
+    {
+      if (a->d[i] != b->d[i])
+        {
+          return a->d[i] < b->d[i] ? -1 : 1;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: strtofp_roundup
+ *
+ * Description:
+ *   Decide a rounding that the 128-bit product left open: compare all the
+ *   digits of the number with the halfway point (2 * mant + 1) * 2^(exp-1)
+ *   between mant * 2^exp and the next value up.
+ *
+ * Returned Value:
+ *   True if the number rounds up to the next value.
+ *
+ ****************************************************************************/
+
+static noinline_function bool
+strtofp_roundup(FAR const struct strtofp_s *dec, uint64_t mant, int exp)
+{
+  struct strtofp_big_s num;
+  struct strtofp_big_s half;
+  FAR const uint8_t *p = dec->digits;
+  uint32_t chunk = 0;
+  uint32_t scale = 1;
+  bool sticky = false;
+  int ndigits = 0;
+  int dexp = dec->dexp;
+  int nshift;
+  int hshift;
+  int ret;
+  int ch;
+  int i;
+
+  /* Collect the significant digits nine at a time */
+
+  strtofp_bigset(&num, 0);
+  for (i = 0; i < dec->nchars; i++, p += dec->width)
+    {
+      ch = strtofp_getc(p, dec->width);
+      if (!strtofp_isdigit(ch) || (ndigits == 0 && ch == '0'))
+        {
+          continue;
+        }
+
+      if (ndigits < STRTOFP_MAXDIGITS)
+        {
+          chunk  = chunk * 10 + (ch - '0');
+          scale *= 10;
+          if (scale == 1000000000u)
+            {
+              strtofp_bigmuladd(&num, scale, chunk);
+              chunk = 0;
+              scale = 1;
+            }
+
+          ndigits++;
+        }
+      else
+        {
+          sticky |= ch != '0';
+          dexp++;
+        }
+    }
+
+  strtofp_bigmuladd(&num, scale, chunk);
+
+  /* Move the power of five to the integer side, then the powers of two
+   * to the smaller side.
+   */
+
+  strtofp_bigset(&half, 2 * mant + 1);
+  if (dexp >= 0)
+    {
+      strtofp_bigpow5(&num, dexp);
+      nshift = dexp;
+      hshift = exp - 1;
+    }
+  else
+    {
+      strtofp_bigpow5(&half, -dexp);
+      nshift = 0;
+      hshift = exp - 1 - dexp;
+    }
+
+  if (nshift > hshift)
+    {
+      strtofp_bigshl(&num, nshift - hshift);
+    }
+  else
+    {
+      strtofp_bigshl(&half, hshift - nshift);
+    }
+
+  ret = strtofp_bigcmp(&num, &half);
+  return ret > 0 || (ret == 0 && (sticky || (mant & 1) != 0));
+}
+
+/****************************************************************************
+ * Name: strtofp_convert
+ *
+ * Description:
+ *   Round a scanned decimal number to a binary floating point format with
+ *   mbits explicit significand bits and ebits exponent bits, following
+ *   Eisel and Lemire: multiply the normalized digits by a 128-bit 5^exp,
+ *   whose top 54 bits are the result unless the rest of the product is too
+ *   close to the halfway point to be sure.
+ *
+ * Returned Value:
+ *   The bits of the value, without the sign.
+ *
+ ****************************************************************************/
+
+static uint64_t strtofp_convert(FAR const struct strtofp_s *dec,
+                                int mbits, int ebits)
+{
+  uint64_t mant;
+  uint64_t phi;
+  uint64_t plo;
+  uint64_t zhi;
+  uint64_t zlo;
+  uint64_t rest;
+  uint64_t half;
+  uint64_t m0;
+  uint64_t m1;
+  uint64_t err;
+  bool ambiguous;
+  bool up;
+  int emax = (1 << ebits) - 1;
+  int field;
+  int shift;
+  int pexp;
+  int bexp;
+  int lz;
+
+  if (dec->mant == 0 || dec->exp < STRTOFP_MINEXP)
+    {
+      return 0;
+    }
+  else if (dec->exp > STRTOFP_MAXEXP)
+    {
+      return (uint64_t)emax << mbits;
+    }
+
+  /* Multiply the normalized digits by 5^exp.  The top 128 bits of the
+   * product are below the exact value by less than 'err' units of zlo;
+   * missing digits cost up to 2^lz units of zhi more.
+   */
+
+  lz   = strtofp_clz(dec->mant);
+  mant = dec->mant << lz;
+  pexp = strtofp_pow5(dec->exp, &phi, &plo);
+
+  strtofp_mul(mant, plo, &m1, &m0);
+  strtofp_mul(mant, phi, &zhi, &zlo);
+  zlo += m1;
+  zhi += zlo < m1;
+
+  if (dec->exp >= 0 && dec->exp <= 55)
+    {
+      err = m0 != 0;
+    }
+  else
+    {
+      err = 3;
+    }
+
+  /* The value is zhi * 2^bexp; keep mbits + 1 bits of zhi, fewer if the
+   * result is subnormal.
+   */
+
+  bexp  = 128 + pexp + dec->exp - lz;
+  shift = (zhi >> 63) != 0 ? 63 - mbits : 62 - mbits;
+  field = bexp + shift + mbits + (emax >> 1);
+  if (field < 1)
+    {
+      shift += 1 - field;
+      field = 1;
+    }
+  else if (field >= emax)
+    {
+      return (uint64_t)emax << mbits;
+    }
+
+  if (shift > 64)
+    {
+      /* At most a quarter of the smallest subnormal, or just too close to
+       * half of it.
+       */
+
+      if (shift > 65 || zhi < UINT64_MAX - 1)
+        {
+          return 0;
+        }
+
+      return strtofp_roundup(dec, 0, bexp + shift);
+    }
+  else if (shift == 64)
+    {
+      mant = 0;
+      rest = zhi;
+    }
+  else
+    {
+      mant = zhi >> shift;
+      rest = zhi & (((uint64_t)1 << shift) - 1);
+    }
+
+  half = (uint64_t)1 << (shift - 1);
+
+  if (dec->truncated)
+    {
+      ambiguous = rest >= half - ((uint64_t)2 << lz) && rest <= half;
+    }
+  else
+    {
+      ambiguous = (rest == half - 1 && zlo > UINT64_MAX - err) ||
+                  (rest == half && zlo == 0 && err > 1);
+    }
+
+  if (ambiguous)
+    {
+      up = strtofp_roundup(dec, mant, bexp + shift);
+    }
+  else if (rest == half && zlo == 0 && err == 0 && !dec->truncated)
+    {
+      up = (mant & 1) != 0;
+    }
+  else
+    {
+      up = rest >= half;
+    }
+
+  /* A carry out of the significand moves into the exponent field, which
+   * also turns the largest subnormal into the smallest normal.
+   */
+
+  mant = ((uint64_t)(field - 1) << mbits) + mant + up;
+  if ((mant >> mbits) >= emax)
+    {
+      mant = (uint64_t)emax << mbits;
+    }
+
+  return mant;
+}
+
+/****************************************************************************
+ * Name: strtofp_scan
+ *
+ * Description:
+ *   Scan a decimal number as strtod() does.  width is the size of the
+ *   characters, one for char and sizeof(wchar_t) for wide strings.
+ *
+ * Returned Value:
+ *   The number of digits of the significand.
+ *
+ ****************************************************************************/
+
+static int strtofp_scan(FAR const void *str, size_t width,
+                        FAR void **endptr, FAR struct strtofp_s *dec,
+                        FAR bool *negative)
+{
+  FAR const uint8_t *p = str;
+  bool point = false;
+  int ndigits = 0;
+  int nsig = 0;
+  int expn = 0;
+  int ch;
+
+  memset(dec, 0, sizeof(*dec));
+  dec->width = width;
+
+  /* Skip leading whitespace */
+
+  for (; ; p += width)
+    {
+      ch = strtofp_getc(p, width);
+      if (ch != ' ' && (ch < '\t' || ch > '\r'))
+        {
+          break;
+        }
+    }
+
+  /* Handle optional sign */
+
+  *negative = ch == '-';
+  if (ch == '-' || ch == '+')
+    {
+      p += width;
+    }
+
+  /* Process the significand, with at most one decimal point */
+
+  dec->digits = p;
+  for (; ; p += width, dec->nchars++)
+    {
+      ch = strtofp_getc(p, width);
+      if (ch == '.' && !point)
+        {
+          point = true;
+          continue;
+        }
+      else if (!strtofp_isdigit(ch))
+        {
+          break;
+        }
+
+      ndigits++;
+      if (point)
+        {
+          dec->dexp--;
+        }
+
+      if (nsig == 0 && ch == '0')
+        {
+          continue;
+        }
+
+      if (nsig < STRTOFP_MANTDIGITS)
+        {
+          dec->mant = dec->mant * 10 + (ch - '0');
+          nsig++;
+        }
+      else
+        {
+          dec->truncated |= ch != '0';
+          dec->exp++;
+        }
+    }
+
+  if (ndigits > 0)
+    {
+      /* Process an exponent string */
+
+      if (ch == 'e' || ch == 'E')
+        {
+          p += width;
+          ch = strtofp_getc(p, width);
+
+          point = ch == '-';
+          if (ch == '-' || ch == '+')
+            {
+              p += width;
+            }
+
+          for (; ; p += width)
+            {
+              ch = strtofp_getc(p, width);
+              if (!strtofp_isdigit(ch))
+                {
+                  break;
+                }
+
+              if (expn < STRTOFP_EXPLIMIT)
+                {
+                  expn = expn * 10 + (ch - '0');
+                }
+            }
+
+          dec->dexp += point ? -expn : expn;
+        }
+
+      dec->exp += dec->dexp;
+    }
+
+  if (endptr != NULL)
+    {
+      *endptr = (FAR void *)p;
+    }
+
+  return ndigits;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_strtod
+ *
+ * Description:
+ *   Convert a string of char or wchar_t to a correctly rounded double.
+ *   This is strtod() and wcstod() with CONFIG_LIBC_STRTOD_FAST.
+ *
+ ****************************************************************************/
+
+double lib_strtod(FAR const void *str, size_t width, FAR void **endptr)
+{
+  struct strtofp_s dec;
+  uint64_t bits;
+  double number;
+  bool negative;
+
+  if (strtofp_scan(str, width, endptr, &dec, &negative) == 0)
+    {
+      set_errno(ERANGE);
+      return 0.0;
+    }
+
+  /* The digits are exactly representable and so is the power of ten: one
+   * correctly rounded operation gives the correctly rounded result.
+   */
+
+  if (!dec.truncated && dec.mant <= ((uint64_t)1 << 53) &&
+      dec.exp >= -22 && dec.exp <= 22)
+    {
+      number = (double)dec.mant;
+      if (dec.exp < 0)
+        {
+          number /= g_strtofp_pow10[0 - dec.exp];
+        }
+      else
+        {
+          number *= g_strtofp_pow10[dec.exp];
+        }
+
+      return negative ? -number : number;
+    }
+
+  bits = strtofp_convert(&dec, 52, 11);
+  if (bits == (uint64_t)0x7ff << 52 || (bits == 0 && dec.mant != 0))
+    {
+      set_errno(ERANGE);
+    }
+
+  bits |= (uint64_t)negative << 63;
+  memcpy(&number, &bits, sizeof(number));
+  return number;
+}
+
+/****************************************************************************
+ * Name: lib_strtof
+ *
+ * Description:
+ *   Convert a string of char or wchar_t to a correctly rounded float.
+ *   This is strtof() and wcstof() with CONFIG_LIBC_STRTOD_FAST.
+ *
+ ****************************************************************************/
+
+float lib_strtof(FAR const void *str, size_t width, FAR void **endptr)
+{
+  struct strtofp_s dec;
+  uint32_t bits;
+  float number;
+  bool negative;
+
+  if (strtofp_scan(str, width, endptr, &dec, &negative) == 0)
+    {
+      set_errno(ERANGE);
+      return 0.0f;
+    }
+
+  if (!dec.truncated && dec.mant <= ((uint64_t)1 << 24) &&
+      dec.exp >= -10 && dec.exp <= 10)
+    {
+      number = (float)dec.mant;
+      if (dec.exp < 0)
+        {
+          number /= g_strtofp_pow10f[0 - dec.exp];
+        }
+      else
+        {
+          number *= g_strtofp_pow10f[dec.exp];
+        }
+
+      return negative ? -number : number;
+    }
+
+  bits = (uint32_t)strtofp_convert(&dec, 23, 8);
+  if (bits == (uint32_t)0xff << 23 || (bits == 0 && dec.mant != 0))
+    {
+      set_errno(ERANGE);
+    }
+
+  bits |= (uint32_t)negative << 31;
+  memcpy(&number, &bits, sizeof(number));
+  return number;
+}
+
+#endif /* CONFIG_LIBC_STRTOD_FAST */
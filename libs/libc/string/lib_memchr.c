@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_strword.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -59,12 +61,33 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_LIBC_ARCH_MEMCHR
 FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
 
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      FAR const uintptr_t *w;
+      uintptr_t mask = STRWORD_REPEAT(c);
+
+      for (; n > 0 && !STRWORD_ALIGNED(p); n--, p++)
+        {
+          if (*p == (unsigned char)c)
+            {
+              return (FAR void *)p;
+            }
+        }
+
+      /* Skip whole words that do not hold c */
+
+      for (w = (FAR const uintptr_t *)p;
+           n >= STRWORD_SIZE && !STRWORD_HASZERO(*w ^ mask);
+           w++, n -= STRWORD_SIZE);
+      p = (FAR const unsigned char *)w;
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
@@ -78,3 +101,4 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   return NULL;
 }
+#endif
@@ -39,8 +39,38 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_MEMCPY_OPTSPEED
+/* The copy unit is the native machine word */
+
+#  define MEMCPY_WORDSIZE  sizeof(uintptr_t)
+#  define MEMCPY_WORDMASK  (MEMCPY_WORDSIZE - 1)
+#  define MEMCPY_WORDBITS  (8 * MEMCPY_WORDSIZE)
+
+/* Copies shorter than this are not worth the alignment overhead */
+
+#  define MEMCPY_THRESHOLD (4 * MEMCPY_WORDSIZE)
+
+/* Merge two aligned source words that straddle one destination word.
+ * 'shift' is the misalignment of the source in bits (never zero).
+ */
+
+#  ifdef CONFIG_ENDIAN_BIG
+#    define MEMCPY_MERGE(w0, w1, shift) \
+       (((w0) << (shift)) | ((w1) >> (MEMCPY_WORDBITS - (shift))))
+#  else
+#    define MEMCPY_MERGE(w0, w1, shift) \
+       (((w0) >> (shift)) | ((w1) << (MEMCPY_WORDBITS - (shift))))
+#  endif
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -50,11 +80,100 @@
  ****************************************************************************/
 
 #ifndef CONFIG_LIBC_ARCH_MEMCPY
-FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
+FAR void locate_fast *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
+#ifdef CONFIG_MEMCPY_OPTSPEED
+  /* This version is optimized for speed.  It copies native words with
+   * the loop unrolled four times once the destination is aligned.  If the
+   * source is then still misaligned, each destination word is composed
+   * from two aligned source words so that no unaligned access is ever
+   * made.
+   */
+
+  FAR uint8_t *pout = (FAR uint8_t *)dest;
+  FAR const uint8_t *pin = (FAR const uint8_t *)src;
+
+  if (n >= MEMCPY_THRESHOLD)
+    {
+      FAR uintptr_t *wout;
+      uintptr_t shift;
+
+      /* Align the destination to a word boundary */
+
+      while (((uintptr_t)pout & MEMCPY_WORDMASK) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout  = (FAR uintptr_t *)pout;
+      shift = ((uintptr_t)pin & MEMCPY_WORDMASK) * 8;
+
+      if (shift == 0)
+        {
+          FAR const uintptr_t *win = (FAR const uintptr_t *)pin;
+
+          /* Both are aligned.  Copy four words at a time. */
+
+          while (n >= 4 * MEMCPY_WORDSIZE)
+            {
+              wout[0] = win[0];
+              wout[1] = win[1];
+              wout[2] = win[2];
+              wout[3] = win[3];
+              wout   += 4;
+              win    += 4;
+              n      -= 4 * MEMCPY_WORDSIZE;
+            }
+
+          while (n >= MEMCPY_WORDSIZE)
+            {
+              *wout++ = *win++;
+              n      -= MEMCPY_WORDSIZE;
+            }
+
+          pin = (FAR const uint8_t *)win;
+        }
+      else
+        {
+          FAR const uintptr_t *win;
+          uintptr_t w0;
+          uintptr_t w1;
+
+          /* The source is misaligned.  Only aligned words are read; the
+           * first and last of them may contain bytes outside of the
+           * source buffer, but never outside of the same aligned word.
+           */
+
+          win = (FAR const uintptr_t *)((uintptr_t)pin & ~MEMCPY_WORDMASK);
+          w0  = *win++;
+
+          while (n >= MEMCPY_WORDSIZE)
+            {
+              w1      = *win++;
+              *wout++ = MEMCPY_MERGE(w0, w1, shift);
+              w0      = w1;
+              pin    += MEMCPY_WORDSIZE;
+              n      -= MEMCPY_WORDSIZE;
+            }
+        }
+
+      pout = (FAR uint8_t *)wout;
+    }
+
+  /* Copy the remaining bytes */
+
+  while (n-- > 0)
+    {
+      *pout++ = *pin++;
+    }
+#else
+  /* This version is optimized for size */
+
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
   while (n-- > 0) *pout++ = *pin++;
+#endif
   return dest;
 }
 #endif
@@ -39,8 +39,19 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+#  define MEMMOVE_WORDSIZE sizeof(uintptr_t)
+#  define MEMMOVE_WORDMASK (MEMMOVE_WORDSIZE - 1)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,11 +62,42 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
   FAR char *tmp;
   FAR char *s;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+  /* Regions that do not overlap can use the (possibly optimized) memcpy() */
+
+  if ((FAR const char *)dest + count <= (FAR const char *)src ||
+      (FAR const char *)src + count <= (FAR const char *)dest)
+    {
+      return memcpy(dest, src, count);
+    }
+#endif
+
   if (dest <= src)
     {
       tmp = (FAR char *) dest;
       s   = (FAR char *) src;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      /* Copy whole words forward if both pointers can be aligned */
+
+      if ((((uintptr_t)tmp ^ (uintptr_t)s) & MEMMOVE_WORDMASK) == 0)
+        {
+          while (((uintptr_t)tmp & MEMMOVE_WORDMASK) != 0 && count > 0)
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          while (count >= MEMMOVE_WORDSIZE)
+            {
+              *(FAR uintptr_t *)tmp = *(FAR uintptr_t *)s;
+              tmp   += MEMMOVE_WORDSIZE;
+              s     += MEMMOVE_WORDSIZE;
+              count -= MEMMOVE_WORDSIZE;
+            }
+        }
+#endif
+
       while (count--)
         {
           *tmp++ = *s++;
@@ -66,6 +108,27 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      /* Copy whole words backward if both pointers can be aligned */
+
+      if ((((uintptr_t)tmp ^ (uintptr_t)s) & MEMMOVE_WORDMASK) == 0)
+        {
+          while (((uintptr_t)tmp & MEMMOVE_WORDMASK) != 0 && count > 0)
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          while (count >= MEMMOVE_WORDSIZE)
+            {
+              tmp   -= MEMMOVE_WORDSIZE;
+              s     -= MEMMOVE_WORDSIZE;
+              count -= MEMMOVE_WORDSIZE;
+              *(FAR uintptr_t *)tmp = *(FAR uintptr_t *)s;
+            }
+        }
+#endif
+
       while (count--)
         {
           *--tmp = *--s;
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_strword.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,6 +66,32 @@ FAR char *strchr(FAR const char *s, int c)
 {
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      FAR const uintptr_t *w;
+      uintptr_t mask = STRWORD_REPEAT(c);
+
+      for (; !STRWORD_ALIGNED(s); s++)
+        {
+          if (*s == c)
+            {
+              return (FAR char *)s;
+            }
+
+          if (!*s)
+            {
+              return NULL;
+            }
+        }
+
+      /* Skip the words that hold neither c nor the terminator; the byte
+       * loop below finds which of the two comes first.
+       */
+
+      for (w = (FAR const uintptr_t *)s;
+           !STRWORD_HASZERO(*w) && !STRWORD_HASZERO(*w ^ mask); w++);
+      s = (FAR const char *)w;
+#endif
+
       for (; ; s++)
         {
           if (*s == c)
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "lib_strword.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,6 +51,35 @@
 int strcmp(FAR const char *cs, FAR const char *ct)
 {
   register signed char result;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Words can only be compared if both strings are equally aligned */
+
+  if ((((uintptr_t)cs ^ (uintptr_t)ct) & STRWORD_MASK) == 0)
+    {
+      FAR const uintptr_t *ws;
+      FAR const uintptr_t *wt;
+
+      for (; !STRWORD_ALIGNED(cs); cs++, ct++)
+        {
+          if ((result = *cs - *ct) != 0 || !*cs)
+            {
+              return result;
+            }
+        }
+
+      /* Skip the equal words without a terminator; the byte loop below
+       * finds the difference or the end in the first one that is not.
+       */
+
+      for (ws = (FAR const uintptr_t *)cs, wt = (FAR const uintptr_t *)ct;
+           *ws == *wt && !STRWORD_HASZERO(*ws); ws++, wt++);
+
+      cs = (FAR const char *)ws;
+      ct = (FAR const char *)wt;
+    }
+#endif
+
   for (; ; )
     {
       if ((result = *cs - *ct++) != 0 || !*cs++)
@@ -41,6 +41,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "lib_strword.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -48,8 +50,28 @@
 #ifndef CONFIG_LIBC_ARCH_STRLEN
 size_t strlen(const char *s)
 {
-  const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+  const char *sc = s;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  FAR const uintptr_t *w;
+
+  /* Check the bytes up to a word boundary, then whole words until one of
+   * them holds the terminator.
+   */
+
+  for (; !STRWORD_ALIGNED(sc); sc++)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  for (w = (FAR const uintptr_t *)sc; !STRWORD_HASZERO(*w); w++);
+  sc = (FAR const char *)w;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
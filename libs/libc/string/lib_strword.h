@@ -0,0 +1,64 @@
+/****************************************************************************
+ * libs/libc/string/lib_strword.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_STRING_LIB_STRWORD_H
+#define __LIBS_LIBC_STRING_LIB_STRWORD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Helpers for the string functions that examine a native word at a time
+ * (CONFIG_LIBC_STRING_OPTSPEED).  Only aligned words are ever read.  Such
+ * a word may extend past the end of the string, but never past the end of
+ * the page or memory region that holds its first byte.
+ */
+
+#define STRWORD_SIZE       sizeof(uintptr_t)
+#define STRWORD_MASK       (STRWORD_SIZE - 1)
+
+#define STRWORD_ALIGNED(p) (((uintptr_t)(p) & STRWORD_MASK) == 0)
+
+/* 0x0101...01 and 0x8080...80 */
+
+#define STRWORD_ONES       ((uintptr_t)-1 / 0xff)
+#define STRWORD_HIGHS      (STRWORD_ONES << 7)
+
+/* A word with every byte equal to c */
+
+#define STRWORD_REPEAT(c)  (STRWORD_ONES * (uint8_t)(c))
+
+/* Non-zero if any byte of w is zero.  A borrow can only spill into bytes
+ * above a zero byte, so the result being non-zero is exact, although
+ * which bytes are flagged is not.
+ */
+
+#define STRWORD_HASZERO(w) \
+  (((w) - STRWORD_ONES) & ~(w) & STRWORD_HIGHS)
+
+#endif /* __LIBS_LIBC_STRING_LIB_STRWORD_H */
@@ -0,0 +1,201 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_SYMTAB_HASH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   Return the hash of a symbol name.  This is the same function as used
+ *   by the ELF DT_GNU_HASH section (h = h * 33 + c, starting at 5381).
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hashname(FAR const char *name)
+{
+  uint32_t hash = 5381;
+  uint8_t ch;
+
+  while ((ch = (uint8_t)*name++) != '\0')
+    {
+      hash = (hash << 5) + hash + ch;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index over an existing symbol table.  The table itself is
+ *   not modified (it normally lives in read-only memory); the index holds
+ *   the hash of every name, so that a lookup compares the strings only
+ *   when the full 32-bit hashes already match.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int symtab_hashinit(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR int *buckets;
+  FAR int *chain;
+  FAR uint32_t *hashes;
+  unsigned int nbuckets;
+  int i;
+
+  DEBUGASSERT(hash != NULL && (symtab != NULL || nsyms == 0));
+
+  memset(hash, 0, sizeof(*hash));
+  if (nsyms <= 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Power-of-two bucket count, about two symbols per bucket */
+
+  for (nbuckets = 1; nbuckets < (unsigned int)(nsyms + 1) / 2;
+       nbuckets <<= 1)
+    {
+    }
+
+  buckets = lib_malloc(nbuckets * sizeof(int) +
+                       nsyms * (sizeof(int) + sizeof(uint32_t)));
+  if (buckets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hashes = (FAR uint32_t *)&buckets[nbuckets];
+  chain  = (FAR int *)&hashes[nsyms];
+
+  for (i = 0; i < (int)nbuckets; i++)
+    {
+      buckets[i] = -1;
+    }
+
+  /* Insert in reverse so that each chain is in table order: if a name
+   * appears twice, the first entry wins, as with symtab_findbyname().
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      unsigned int b;
+
+      hashes[i] = symtab_hashname(symtab[i].sym_name);
+      b         = hashes[i] & (nbuckets - 1);
+      chain[i]  = buckets[b];
+      buckets[b] = i;
+    }
+
+  hash->symtab   = symtab;
+  hash->nsyms    = nsyms;
+  hash->nbuckets = nbuckets;
+  hash->buckets  = buckets;
+  hash->hashes   = hashes;
+  hash->chain    = chain;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hashuninit
+ *
+ * Description:
+ *   Free the memory held by a hash index.
+ *
+ ****************************************************************************/
+
+void symtab_hashuninit(FAR struct symtab_hash_s *hash)
+{
+  DEBUGASSERT(hash != NULL);
+
+  if (hash->buckets != NULL)
+    {
+      lib_free(hash->buckets);
+    }
+
+  memset(hash, 0, sizeof(*hash));
+}
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name using a hash index built by
+ *   symtab_hashinit().  'value' is symtab_hashname(name); callers that
+ *   look the same name up in several tables compute it only once.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name, uint32_t value)
+{
+  int i;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+  if (hash->buckets == NULL)
+    {
+      return NULL;
+    }
+
+  for (i = hash->buckets[value & (hash->nbuckets - 1)];
+       i >= 0;
+       i = hash->chain[i])
+    {
+      if (hash->hashes[i] == value &&
+          strcmp(name, hash->symtab[i].sym_name) == 0)
+        {
+          return &hash->symtab[i];
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_SYMTAB_HASH */
@@ -0,0 +1,157 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if defined(CONFIG_CLOCK_USERPAGE) && !defined(__KERNEL__)
+struct clock_timepage_s g_clock_timepage;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_gettime
+ *
+ * Description:
+ *   Compute CLOCK_REALTIME or CLOCK_MONOTONIC from the user time page.
+ *   This matches what the OS computes from the same values.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSYS if the clock must be read by the OS.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_CLOCK_USERPAGE) && !defined(__KERNEL__)
+static int clock_timepage_gettime(clockid_t clock_id,
+                                  FAR struct timespec *tp)
+{
+  FAR struct clock_timepage_s *page = &g_clock_timepage;
+  uint64_t usecs;
+  uint32_t seq;
+  clock_t ticks;
+  time_t sec;
+  long nsec;
+
+  if (clock_id != CLOCK_REALTIME
+#ifdef CONFIG_CLOCK_MONOTONIC
+      && clock_id != CLOCK_MONOTONIC
+#endif
+     )
+    {
+      return -ENOSYS;
+    }
+
+  /* Take a consistent snapshot:  the OS updates the page from the timer
+   * interrupt, possibly between any two of these reads.
+   */
+
+  do
+    {
+      seq   = page->seq;
+      ticks = page->ticks;
+      sec   = page->base_sec;
+      nsec  = page->base_nsec;
+    }
+  while ((seq & 1) != 0 || seq != page->seq);
+
+  /* The OS has not run its first tick since user memory was initialized */
+
+  if (seq == 0)
+    {
+      return -ENOSYS;
+    }
+
+  usecs       = (uint64_t)ticks * USEC_PER_TICK;
+  tp->tv_sec  = (time_t)(usecs / USEC_PER_SEC);
+  tp->tv_nsec = (long)(usecs % USEC_PER_SEC) * NSEC_PER_USEC;
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      tp->tv_sec  += sec;
+      tp->tv_nsec += nsec;
+      if (tp->tv_nsec >= NSEC_PER_SEC)
+        {
+          tp->tv_sec++;
+          tp->tv_nsec -= NSEC_PER_SEC;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Return the current value of the clock 'clock_id'.  In the protected
+ *   build with CONFIG_CLOCK_USERPAGE, CLOCK_REALTIME and CLOCK_MONOTONIC
+ *   are read from the user time page without a system call.
+ *
+ * Input Parameters:
+ *   clock_id - The clock to read
+ *   tp       - The location to return the time
+ *
+ * Returned Value:
+ *   Zero (OK) on success;  -1 is returned on failure with the errno variable
+ *   set appropriately.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  int ret;
+
+#if defined(CONFIG_CLOCK_USERPAGE) && !defined(__KERNEL__)
+  ret = clock_timepage_gettime(clock_id, tp);
+  if (ret == -ENOSYS)
+#endif
+    {
+      ret = nx_clock_gettime(clock_id, tp);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
+}
@@ -51,6 +51,7 @@
 #include <nuttx/config.h>
 
 #include <stdio.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
@@ -58,6 +59,7 @@
 #include <fcntl.h>
 #include <errno.h>
 
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 
 #include "libc.h"
@@ -76,6 +78,23 @@
 #  define TZDIR "/etc/zoneinfo"
 #endif
 
+/* A parsed time zone is published to lock-free readers by a single pointer
+ * store.  The cache of the last converted day needs lock-free atomics.
+ */
+
+#if defined(__GCC_ATOMIC_POINTER_LOCK_FREE) && \
+    __GCC_ATOMIC_POINTER_LOCK_FREE == 2
+#  define TZ_LOAD(p)          __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+#  define TZ_STORE(p, v)      __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+#else
+#  define TZ_LOAD(p)          (p)
+#  define TZ_STORE(p, v)      ((p) = (v))
+#endif
+
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && __GCC_ATOMIC_INT_LOCK_FREE == 2
+#  define HAVE_DAYCACHE 1
+#endif
+
 /* Time definitions *********************************************************/
 
 /* Time zone files */
@@ -289,8 +308,25 @@ struct state_s
                     (2 * (MY_TZNAME_MAX + 1)))];
   struct lsinfo_s lsis[TZ_MAX_LEAPS];
   int defaulttype;            /* For early times or if no transitions */
+  FAR struct state_s *flink;  /* Next cached time zone */
+  FAR char *name;             /* TZ value, NULL for the system default */
 };
 
+#ifdef HAVE_DAYCACHE
+struct daycache_s
+{                             /* The last day converted by localtime */
+  unsigned int seq;           /* Odd while the cache is being updated */
+  FAR const struct state_s *sp;
+  FAR const struct ttinfo_s *ttisp;
+  time_t start;               /* First second of the day */
+  int year;
+  int mon;
+  int mday;
+  int wday;
+  int yday;
+};
+#endif
+
 struct rule_s
 {
   int r_type;                 /* type of rule; see below */
@@ -318,9 +354,17 @@ static time_t const g_max_timet =
 
 static const char g_wildabbr[] = WILDABBR;
 
-static char g_lcl_tzname[MY_TZNAME_MAX + 1];
-static int g_lcl_isset;
-static int g_gmt_isset;
+/* Time zones are parsed once and kept for the life of the program, so
+ * that a reader never sees a time zone change under it.  g_tzsem only
+ * serializes the loading of time zones.
+ */
+
+static FAR struct state_s *g_tzcache;
+static sem_t g_tzsem = SEM_INITIALIZER(1);
+
+#ifdef HAVE_DAYCACHE
+static struct daycache_s g_daycache;
+#endif
 
 /* Section 4.12.3 of X3.159-1989 requires that
  *    Except for the strftime function, these functions [asctime,
@@ -384,7 +428,7 @@ static int  normalize_overflow32(FAR int_fast32_t * tensptr,
               FAR int *unitsptr, int base);
 static int  normalize_overflow(FAR int *tensptr, FAR int *unitsptr,
               int base);
-static void settzname(void);
+static void settzname(FAR struct state_s *sp);
 static time_t time1(FAR struct tm *tmp,
               FAR struct tm *(*funcp)(FAR const time_t *, int_fast32_t,
                                       FAR struct tm *),
@@ -442,9 +486,8 @@ static int_fast64_t detzcode64(FAR const char *const codep)
   return result;
 }
 
-static void settzname(void)
+static void settzname(FAR struct state_s *const sp)
 {
-  FAR struct state_s *const sp = lclptr;
   int i;
 
   tzname[0] = tzname[1] = (FAR char *)g_wildabbr;
@@ -1633,37 +1676,159 @@ static void gmtload(FAR struct state_s *const sp)
     }
 }
 
-/* A non-static declaration of tzsetwall in a system header file
- * may cause a warning about this upcoming static declaration...
+static void tzlock(void)
+{
+  while (_SEM_WAIT(&g_tzsem) < 0)
+    {
+      /* Retry if awakened by a signal */
+    }
+}
+
+/* Return true if the time zone state was loaded for the TZ value name */
+
+static bool tzmatch(FAR const struct state_s *sp, FAR const char *name)
+{
+  if (name == NULL || sp->name == NULL)
+    {
+      return name == sp->name;
+    }
+
+  return strcmp(name, sp->name) == 0;
+}
+
+/* Allocate and load the time zone state for the TZ value name, NULL for the
+ * system default.
  */
 
-static void tzsetwall(void)
+static FAR struct state_s *tzalloc(FAR const char *name)
 {
-  if (g_lcl_isset < 0)
+  FAR struct state_s *sp;
+  size_t namelen = (name == NULL) ? 0 : strlen(name) + 1;
+
+  sp = lib_zalloc(sizeof(*sp) + namelen);
+  if (sp == NULL)
     {
-      return;
+      return NULL;
     }
 
-  g_lcl_isset = -1;
+  if (name == NULL)
+    {
+      if (tzload(NULL, sp, TRUE) != 0)
+        {
+          gmtload(sp);
+        }
+    }
+  else if (*name == '\0')
+    {
+      /* User wants it fast rather than right */
 
-  if (lclptr == NULL)
+      sp->leapcnt = 0; /* so, we're off a little */
+      sp->timecnt = 0;
+      sp->typecnt = 0;
+      sp->ttis[0].tt_isdst = 0;
+      sp->ttis[0].tt_gmtoff = 0;
+      sp->ttis[0].tt_abbrind = 0;
+      strcpy(sp->chars, GMT);
+    }
+  else if (tzload(name, sp, TRUE) != 0)
     {
-      lclptr = lib_malloc(sizeof *lclptr);
-      if (lclptr == NULL)
+      if (name[0] == ':' || tzparse(name, sp, FALSE) != 0)
         {
-          settzname();          /* all we can do */
-          return;
+          gmtload(sp);
         }
     }
 
-  if (tzload(NULL, lclptr, TRUE) != 0)
+  if (name != NULL)
+    {
+      sp->name = (FAR char *)(sp + 1);
+      strcpy(sp->name, name);
+    }
+
+  return sp;
+}
+
+#ifdef HAVE_DAYCACHE
+/* Convert t using the last day converted if it falls on the same day, in
+ * the same time zone and with the same local time type.  There must be no
+ * leap second corrections.  Readers do not lock: they retry nothing and
+ * simply fall back to timesub() if the cache changes while it is read.
+ */
+
+static bool daycache_get(FAR const struct state_s *sp,
+                         FAR const struct ttinfo_s *ttisp, time_t t,
+                         FAR struct tm *tmp)
+{
+  struct daycache_s dc;
+  unsigned int seq;
+  int_fast32_t rem;
+
+  seq = __atomic_load_n(&g_daycache.seq, __ATOMIC_ACQUIRE);
+  if ((seq & 1) != 0)
+    {
+      return false;
+    }
+
+  dc = g_daycache;
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (__atomic_load_n(&g_daycache.seq, __ATOMIC_RELAXED) != seq)
+    {
+      return false;
+    }
+
+  if (dc.sp != sp || dc.ttisp != ttisp || t < dc.start ||
+      t - dc.start >= SECSPERDAY)
     {
-      gmtload(lclptr);
+      return false;
     }
 
-  settzname();
+  rem           = t - dc.start;
+  tmp->tm_year  = dc.year;
+  tmp->tm_mon   = dc.mon;
+  tmp->tm_mday  = dc.mday;
+  tmp->tm_wday  = dc.wday;
+  tmp->tm_yday  = dc.yday;
+  tmp->tm_hour  = (int)(rem / SECSPERHOUR);
+  rem          %= SECSPERHOUR;
+  tmp->tm_min   = (int)(rem / SECSPERMIN);
+  tmp->tm_sec   = (int)(rem % SECSPERMIN);
+  tmp->tm_isdst = ttisp->tt_isdst;
+  tmp->tm_gmtoff = ttisp->tt_gmtoff;
+  tmp->tm_zone  = tzname[0];
+  return true;
 }
 
+/* Remember the day of a conversion just made by timesub().  If another
+ * thread is updating the cache, this one is simply not remembered.
+ */
+
+static void daycache_put(FAR const struct state_s *sp,
+                         FAR const struct ttinfo_s *ttisp, time_t t,
+                         FAR const struct tm *tmp)
+{
+  unsigned int seq;
+
+  seq = __atomic_load_n(&g_daycache.seq, __ATOMIC_RELAXED);
+  if ((seq & 1) != 0 ||
+      !__atomic_compare_exchange_n(&g_daycache.seq, &seq, seq + 1, false,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      return;
+    }
+
+  g_daycache.sp    = sp;
+  g_daycache.ttisp = ttisp;
+  g_daycache.start = t - (tmp->tm_hour * SECSPERHOUR +
+                          tmp->tm_min * SECSPERMIN + tmp->tm_sec);
+  g_daycache.year  = tmp->tm_year;
+  g_daycache.mon   = tmp->tm_mon;
+  g_daycache.mday  = tmp->tm_mday;
+  g_daycache.wday  = tmp->tm_wday;
+  g_daycache.yday  = tmp->tm_yday;
+
+  __atomic_store_n(&g_daycache.seq, seq + 2, __ATOMIC_RELEASE);
+}
+#endif
+
 /* The easy way to behave "as if no library function calls" localtime
  * is to not call it, so we drop its guts into "localsub", which can be
  * freely called. (And no, the PANS doesn't require the above behavior,
@@ -1681,7 +1846,7 @@ static struct tm *localsub(FAR const time_t * const timep,
   struct tm *result;
   const time_t t = *timep;
 
-  sp = lclptr;
+  sp = TZ_LOAD(lclptr);
   if (sp == NULL)
     {
       return gmtsub(timep, offset, tmp);
@@ -1779,7 +1944,28 @@ static struct tm *localsub(FAR const time_t * const timep,
    *    timesub(&t, 0L, sp, tmp);
    */
 
-  result = timesub(&t, ttisp->tt_gmtoff, sp, tmp);
+#ifdef HAVE_DAYCACHE
+  if (sp->leapcnt == 0)
+    {
+      if (daycache_get(sp, ttisp, t, tmp))
+        {
+          result = tmp;
+        }
+      else
+        {
+          result = timesub(&t, ttisp->tt_gmtoff, sp, tmp);
+          if (result != NULL)
+            {
+              daycache_put(sp, ttisp, t, tmp);
+            }
+        }
+    }
+  else
+#endif
+    {
+      result = timesub(&t, ttisp->tt_gmtoff, sp, tmp);
+    }
+
   tmp->tm_isdst = ttisp->tt_isdst;
   tzname[tmp->tm_isdst] = &sp->chars[ttisp->tt_abbrind];
 
@@ -1791,17 +1977,26 @@ static struct tm *localsub(FAR const time_t * const timep,
 static struct tm *gmtsub(FAR const time_t * const timep,
                          const int_fast32_t offset, struct tm *const tmp)
 {
-  if (!g_gmt_isset)
+  FAR struct state_s *sp = TZ_LOAD(gmtptr);
+
+  if (sp == NULL)
     {
-      gmtptr = lib_malloc(sizeof *gmtptr);
-      g_gmt_isset = gmtptr != NULL;
-      if (g_gmt_isset)
+      tzlock();
+      sp = gmtptr;
+      if (sp == NULL)
         {
-          gmtload(gmtptr);
+          sp = lib_zalloc(sizeof(*sp));
+          if (sp != NULL)
+            {
+              gmtload(sp);
+              TZ_STORE(gmtptr, sp);
+            }
         }
+
+      _SEM_POST(&g_tzsem);
     }
 
-  return timesub(timep, offset, gmtptr, tmp);
+  return timesub(timep, offset, sp, tmp);
 }
 
 /* Return the number of leap years through the end of the given year
@@ -2492,57 +2687,51 @@ static time_t time1(FAR struct tm *const tmp,
 
 void tzset(void)
 {
+  FAR struct state_s *sp;
   FAR const char *name;
 
+  /* Nothing to do if the time zone in use is still the one selected by TZ.
+   * This is the common case and takes no lock.
+   */
+
   name = getenv("TZ");
-  if (name == NULL)
+  sp   = TZ_LOAD(lclptr);
+  if (sp != NULL && tzmatch(sp, name))
     {
-      tzsetwall();
       return;
     }
 
-  if (g_lcl_isset > 0 && strcmp(g_lcl_tzname, name) == 0)
-    {
-      return;
-    }
+  /* Otherwise reuse the time zone if it was parsed before or load it. */
 
-  g_lcl_isset = strlen(name) < sizeof g_lcl_tzname;
-  if (g_lcl_isset)
-    {
-      strcpy(g_lcl_tzname, name);
-    }
+  tzlock();
 
-  if (lclptr == NULL)
+  for (sp = g_tzcache; sp != NULL; sp = sp->flink)
     {
-      lclptr = lib_malloc(sizeof *lclptr);
-      if (lclptr == NULL)
+      if (tzmatch(sp, name))
         {
-          settzname(); /* all we can do */
-          return;
+          break;
         }
     }
 
-  if (*name == '\0')
-    {
-      /* User wants it fast rather than right */
-
-      lclptr->leapcnt = 0; /* so, we're off a little */
-      lclptr->timecnt = 0;
-      lclptr->typecnt = 0;
-      lclptr->ttis[0].tt_isdst = 0;
-      lclptr->ttis[0].tt_gmtoff = 0;
-      lclptr->ttis[0].tt_abbrind = 0;
-      strcpy(lclptr->chars, GMT);
-    }
-  else if (tzload(name, lclptr, TRUE) != 0)
+  if (sp == NULL)
     {
-      if (name[0] == ':' || tzparse(name, lclptr, FALSE) != 0)
+      sp = tzalloc(name);
+      if (sp == NULL)
         {
-          gmtload(lclptr);
+          /* All we can do is keep the time zone in use */
+
+          settzname(lclptr);
+          _SEM_POST(&g_tzsem);
+          return;
         }
+
+      sp->flink = g_tzcache;
+      g_tzcache = sp;
     }
 
-  settzname();
+  settzname(sp);
+  TZ_STORE(lclptr, sp);
+  _SEM_POST(&g_tzsem);
 }
 
 FAR struct tm *localtime(FAR const time_t * const timep)
@@ -2555,6 +2744,15 @@ FAR struct tm *localtime(FAR const time_t * const timep)
 
 FAR struct tm *localtime_r(FAR const time_t * const timep, struct tm *tmp)
 {
+  /* POSIX does not require localtime_r() to follow changes to TZ, so only
+   * the first call selects the time zone and the others take no lock.
+   */
+
+  if (TZ_LOAD(lclptr) == NULL)
+    {
+      tzset();
+    }
+
   return localsub(timep, 0L, tmp);
 }
 
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 
 #include <sys/resource.h>
@@ -59,5 +60,21 @@ int getrusage(int who, FAR struct rusage *r_usage)
     }
 
   memset(r_usage, 0, sizeof(*r_usage));
+
+#ifdef CONFIG_SCHED_CPUTIME
+  /* All of the execution time of the process is reported as user time */
+
+  if (who == RUSAGE_SELF)
+    {
+      struct timespec ts;
+
+      if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == OK)
+        {
+          r_usage->ru_utime.tv_sec  = ts.tv_sec;
+          r_usage->ru_utime.tv_usec = ts.tv_nsec / 1000;
+        }
+    }
+#endif
+
   return OK;
 }
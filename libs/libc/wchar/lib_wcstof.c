@@ -37,6 +37,8 @@
 #include <stdlib.h>
 #include <wchar.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_LIBC_WCHAR
 
 /****************************************************************************
@@ -54,7 +56,11 @@
 
 float wcstof(FAR const wchar_t *nptr, FAR wchar_t **endptr)
 {
+#ifdef CONFIG_LIBC_STRTOD_FAST
+  return lib_strtof(nptr, sizeof(wchar_t), (FAR void **)endptr);
+#else
   return strtof((FAR const char *)nptr, (FAR char **)endptr);
+#endif
 }
 
 #endif /* CONFIG_LIBC_WCHAR */
@@ -0,0 +1,292 @@
+/****************************************************************************
+ * libs/libdsp/lib_foc_multi.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_multi_pi
+ *
+ * Description:
+ *   One PI controller step with output saturation and windup protection,
+ *   the same as pi_controller() with symmetric limits.
+ *
+ ****************************************************************************/
+
+static inline float foc_multi_pi(float err, float kp, float ki,
+                                 FAR float *integral, float max)
+{
+  float out;
+
+  *integral += ki * err;
+  out = kp * err + *integral;
+
+  if (out > max)
+    {
+      out = max;
+      *integral = err > 0.0f ? 0.0f : *integral;
+    }
+  else if (out < -max)
+    {
+      out = -max;
+      *integral = err < 0.0f ? 0.0f : *integral;
+    }
+
+  return out;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_multi_init
+ *
+ * Description:
+ *   Initialize batched FOC controller
+ *
+ * Input Parameters:
+ *   foc - (in/out) pointer to the batched FOC data
+ *   n   - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_multi_init(FAR struct foc_multi_s *foc, uint8_t n)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(n > 0 && n <= FOC_MULTI_MAX);
+
+  memset(foc, 0, sizeof(struct foc_multi_s));
+
+  foc->n = n;
+}
+
+/****************************************************************************
+ * Name: foc_multi_gains_set
+ *
+ * Description:
+ *   Set current controllers gains for one motor
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the batched FOC data
+ *   idx   - (in) motor index
+ *   id_kp - (in) KP for d current
+ *   id_ki - (in) KI for d current
+ *   iq_kp - (in) KP for q current
+ *   iq_ki - (in) KI for q current
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_multi_gains_set(FAR struct foc_multi_s *foc, uint8_t idx,
+                         float id_kp, float id_ki,
+                         float iq_kp, float iq_ki)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(idx < foc->n);
+
+  foc->id_kp[idx]  = id_kp;
+  foc->id_ki[idx]  = id_ki;
+  foc->iq_kp[idx]  = iq_kp;
+  foc->iq_ki[idx]  = iq_ki;
+  foc->id_int[idx] = 0.0f;
+  foc->iq_int[idx] = 0.0f;
+}
+
+/****************************************************************************
+ * Name: foc_multi_vbase_update
+ *
+ * Description:
+ *  Update base voltage for one motor.  The division is done here, so the
+ *  interrupt time foc_multi_process() only multiplies.
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the batched FOC data
+ *   idx   - (in) motor index
+ *   vbase - (in) base voltage for FOC
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_multi_vbase_update(FAR struct foc_multi_s *foc, uint8_t idx,
+                            float vbase)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(idx < foc->n);
+
+  /* Only if voltage is valid */
+
+  if (vbase > 0.0f)
+    {
+      foc->vab_mod_scale[idx] = 1.0f / vbase;
+      foc->vdq_mag_max[idx]   = vbase;
+    }
+  else
+    {
+      foc->vab_mod_scale[idx] = 0.0f;
+      foc->vdq_mag_max[idx]   = 0.0f;
+    }
+}
+
+/****************************************************************************
+ * Name: foc_multi_idq_ref_set
+ *
+ * Description:
+ *   Set dq reference current vector for one motor
+ *
+ * Input Parameters:
+ *   foc - (in/out) pointer to the batched FOC data
+ *   idx - (in) motor index
+ *   d   - (in) reference d current
+ *   q   - (in) reference q current
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_multi_idq_ref_set(FAR struct foc_multi_s *foc, uint8_t idx,
+                           float d, float q)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(idx < foc->n);
+
+  foc->i_d_ref[idx] = d;
+  foc->i_q_ref[idx] = q;
+}
+
+/****************************************************************************
+ * Name: foc_multi_process
+ *
+ * Description:
+ *   Process FOC for all motors in one pass.  This gives the same results as
+ *   foc_process() called for each motor, but each stage runs over all
+ *   motors before the next one starts.
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the batched FOC data
+ *   i_abc - (in) array of ABC current frames, one per motor
+ *   angle - (in) array of phase angles, one per motor
+ *
+ * Returned Value:
+ *   None
+ *
+ *   The alpha-beta modulation voltages are left in foc->v_ab_mod_a and
+ *   foc->v_ab_mod_b.
+ *
+ ****************************************************************************/
+
+void foc_multi_process(FAR struct foc_multi_s *foc,
+                       FAR const abc_frame_t *i_abc,
+                       FAR const phase_angle_t *angle)
+{
+  float mag;
+  float max;
+  float a;
+  float b;
+  int n;
+  int k;
+
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(i_abc != NULL);
+  DEBUGASSERT(angle != NULL);
+
+  n = foc->n;
+
+  /* Gather the inputs */
+
+  for (k = 0; k < n; k++)
+    {
+      foc->i_a[k] = i_abc[k].a;
+      foc->i_b[k] = i_abc[k].b;
+      foc->sin[k] = angle[k].sin;
+      foc->cos[k] = angle[k].cos;
+    }
+
+  /* Clarke and Park transforms (abc -> alpha-beta -> dq) */
+
+  for (k = 0; k < n; k++)
+    {
+      foc->i_alpha[k] = foc->i_a[k];
+      foc->i_beta[k]  = ONE_BY_SQRT3_F * foc->i_a[k] +
+                        TWO_BY_SQRT3_F * foc->i_b[k];
+
+      foc->i_d[k] = foc->cos[k] * foc->i_alpha[k] +
+                    foc->sin[k] * foc->i_beta[k];
+      foc->i_q[k] = foc->cos[k] * foc->i_beta[k] -
+                    foc->sin[k] * foc->i_alpha[k];
+    }
+
+  /* PI current controllers (current dq -> voltage dq) */
+
+  for (k = 0; k < n; k++)
+    {
+      max = foc->vdq_mag_max[k];
+
+      foc->v_d[k] = foc_multi_pi(foc->i_d_ref[k] - foc->i_d[k],
+                                 foc->id_kp[k], foc->id_ki[k],
+                                 &foc->id_int[k], max);
+      foc->v_q[k] = foc_multi_pi(foc->i_q_ref[k] - foc->i_q[k],
+                                 foc->iq_kp[k], foc->iq_ki[k],
+                                 &foc->iq_int[k], max);
+    }
+
+  /* Saturate voltage DQ vectors */
+
+  for (k = 0; k < n; k++)
+    {
+      max = foc->vdq_mag_max[k];
+      mag = foc->v_d[k] * foc->v_d[k] + foc->v_q[k] * foc->v_q[k];
+
+      if (mag > max * max)
+        {
+          mag = max / sqrtf(mag);
+          foc->v_d[k] *= mag;
+          foc->v_q[k] *= mag;
+        }
+    }
+
+  /* Inverse Park transform and normalization to the modulation voltage */
+
+  for (k = 0; k < n; k++)
+    {
+      a = foc->cos[k] * foc->v_d[k] - foc->sin[k] * foc->v_q[k];
+      b = foc->cos[k] * foc->v_q[k] + foc->sin[k] * foc->v_d[k];
+
+      foc->v_ab_mod_a[k] = a * foc->vab_mod_scale[k];
+      foc->v_ab_mod_b[k] = b * foc->vab_mod_scale[k];
+    }
+}
@@ -0,0 +1,436 @@
+/****************************************************************************
+ * libs/libdsp/lib_misc_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define VECTOR2D_SATURATE_MAG_MIN_B16 (1)
+
+/* The sine table holds one quarter wave in SIN_LUT_SIZE steps.  A full turn
+ * is then 4 * SIN_LUT_SIZE steps, kept as a b16 "phase" so that the
+ * fractional part interpolates between two entries and any angle wraps by
+ * plain integer overflow.
+ */
+
+#define SIN_LUT_SIZE            256
+#define SIN_PHASE_QUARTER       (SIN_LUT_SIZE << 16)
+#define SIN_PHASE_MASK          ((4 * SIN_PHASE_QUARTER) - 1)
+
+/* b16 radians to phase: 2 * SIN_LUT_SIZE / PI */
+
+#define SIN_ANGLE_TO_PHASE      (0x00a2f983)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* sin(i * PI / (2 * SIN_LUT_SIZE)) for i = 0..SIN_LUT_SIZE, plus one guard
+ * entry so that the interpolation never reads past the end.
+ */
+
+static const b16_t g_sin_lut_b16[SIN_LUT_SIZE + 2] =
+{
+  0x00000, 0x00192, 0x00324, 0x004b6, 0x00648, 0x007da,
+  0x0096c, 0x00afe, 0x00c90, 0x00e21, 0x00fb3, 0x01144,
+  0x012d5, 0x01466, 0x015f7, 0x01787, 0x01918, 0x01aa8,
+  0x01c38, 0x01dc7, 0x01f56, 0x020e5, 0x02274, 0x02402,
+  0x02590, 0x0271e, 0x028ab, 0x02a38, 0x02bc4, 0x02d50,
+  0x02edc, 0x03067, 0x031f1, 0x0337c, 0x03505, 0x0368e,
+  0x03817, 0x0399f, 0x03b27, 0x03cae, 0x03e34, 0x03fba,
+  0x0413f, 0x042c3, 0x04447, 0x045cb, 0x0474d, 0x048cf,
+  0x04a50, 0x04bd1, 0x04d50, 0x04ecf, 0x0504d, 0x051cb,
+  0x05348, 0x054c3, 0x0563e, 0x057b9, 0x05932, 0x05aaa,
+  0x05c22, 0x05d99, 0x05f0f, 0x06084, 0x061f8, 0x0636b,
+  0x064dd, 0x0664e, 0x067be, 0x0692d, 0x06a9b, 0x06c08,
+  0x06d74, 0x06edf, 0x07049, 0x071b2, 0x0731a, 0x07480,
+  0x075e6, 0x0774a, 0x078ad, 0x07a10, 0x07b70, 0x07cd0,
+  0x07e2f, 0x07f8c, 0x080e8, 0x08243, 0x0839c, 0x084f5,
+  0x0864c, 0x087a1, 0x088f6, 0x08a49, 0x08b9a, 0x08ceb,
+  0x08e3a, 0x08f88, 0x090d4, 0x0921f, 0x09368, 0x094b0,
+  0x095f7, 0x0973c, 0x09880, 0x099c2, 0x09b03, 0x09c42,
+  0x09d80, 0x09ebc, 0x09ff7, 0x0a130, 0x0a268, 0x0a39e,
+  0x0a4d2, 0x0a605, 0x0a736, 0x0a866, 0x0a994, 0x0aac1,
+  0x0abeb, 0x0ad14, 0x0ae3c, 0x0af62, 0x0b086, 0x0b1a8,
+  0x0b2c9, 0x0b3e8, 0x0b505, 0x0b620, 0x0b73a, 0x0b852,
+  0x0b968, 0x0ba7d, 0x0bb8f, 0x0bca0, 0x0bdaf, 0x0bebc,
+  0x0bfc7, 0x0c0d1, 0x0c1d8, 0x0c2de, 0x0c3e2, 0x0c4e4,
+  0x0c5e4, 0x0c6e2, 0x0c7de, 0x0c8d9, 0x0c9d1, 0x0cac7,
+  0x0cbbc, 0x0ccae, 0x0cd9f, 0x0ce8e, 0x0cf7a, 0x0d065,
+  0x0d14d, 0x0d234, 0x0d318, 0x0d3fb, 0x0d4db, 0x0d5ba,
+  0x0d696, 0x0d770, 0x0d848, 0x0d91e, 0x0d9f2, 0x0dac4,
+  0x0db94, 0x0dc62, 0x0dd2d, 0x0ddf7, 0x0debe, 0x0df83,
+  0x0e046, 0x0e107, 0x0e1c6, 0x0e282, 0x0e33c, 0x0e3f4,
+  0x0e4aa, 0x0e55e, 0x0e610, 0x0e6bf, 0x0e76c, 0x0e817,
+  0x0e8bf, 0x0e966, 0x0ea0a, 0x0eaab, 0x0eb4b, 0x0ebe8,
+  0x0ec83, 0x0ed1c, 0x0edb3, 0x0ee47, 0x0eed9, 0x0ef68,
+  0x0eff5, 0x0f080, 0x0f109, 0x0f18f, 0x0f213, 0x0f295,
+  0x0f314, 0x0f391, 0x0f40c, 0x0f484, 0x0f4fa, 0x0f56e,
+  0x0f5df, 0x0f64e, 0x0f6ba, 0x0f724, 0x0f78c, 0x0f7f1,
+  0x0f854, 0x0f8b4, 0x0f913, 0x0f96e, 0x0f9c8, 0x0fa1f,
+  0x0fa73, 0x0fac5, 0x0fb15, 0x0fb62, 0x0fbad, 0x0fbf5,
+  0x0fc3b, 0x0fc7f, 0x0fcc0, 0x0fcfe, 0x0fd3b, 0x0fd74,
+  0x0fdac, 0x0fde1, 0x0fe13, 0x0fe43, 0x0fe71, 0x0fe9c,
+  0x0fec4, 0x0feeb, 0x0ff0e, 0x0ff30, 0x0ff4e, 0x0ff6b,
+  0x0ff85, 0x0ff9c, 0x0ffb1, 0x0ffc4, 0x0ffd4, 0x0ffe1,
+  0x0ffec, 0x0fff5, 0x0fffb, 0x0ffff, 0x10000, 0x0ffff
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sin_phase_b16
+ *
+ * Description:
+ *   Sine of a phase from the quarter wave table with linear interpolation.
+ *   The error is within about one b16 lsb (1.5e-5).
+ *
+ ****************************************************************************/
+
+static b16_t sin_phase_b16(uint32_t phase)
+{
+  uint32_t pos = phase & (SIN_PHASE_QUARTER - 1);
+  uint32_t quadrant = (phase & SIN_PHASE_MASK) / SIN_PHASE_QUARTER;
+  FAR const b16_t *lut;
+  b16_t frac;
+  b16_t val;
+
+  /* The second and the fourth quadrant run the table backwards */
+
+  if (quadrant & 1)
+    {
+      pos = SIN_PHASE_QUARTER - pos;
+    }
+
+  lut  = &g_sin_lut_b16[pos >> 16];
+  frac = (b16_t)(pos & 0xffff);
+  val  = lut[0] + (((lut[1] - lut[0]) * frac + 0x8000) >> 16);
+
+  /* The second half wave is negative */
+
+  return (quadrant & 2) ? -val : val;
+}
+
+/****************************************************************************
+ * Name: angle_to_phase_b16
+ ****************************************************************************/
+
+static uint32_t angle_to_phase_b16(b16_t angle)
+{
+  return (uint32_t)b16mulb16(angle, SIN_ANGLE_TO_PHASE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: f_saturate_b16
+ *
+ * Description:
+ *   Saturate b16 number
+ *
+ * Input Parameters:
+ *   val - pointer to b16 number
+ *   min - lower limit
+ *   max - upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void f_saturate_b16(FAR b16_t *val, b16_t min, b16_t max)
+{
+  if (*val < min)
+    {
+      *val = min;
+    }
+  else if (*val > max)
+    {
+      *val = max;
+    }
+}
+
+/****************************************************************************
+ * Name: vector2d_mag_b16
+ *
+ * Description:
+ *   Get 2D vector magnitude.
+ *
+ * Input Parameters:
+ *   x   - (in) vector x component
+ *   y   - (in) vector y component
+ *
+ * Returned Value:
+ *   Return 2D vector magnitude
+ *
+ ****************************************************************************/
+
+b16_t vector2d_mag_b16(b16_t x, b16_t y)
+{
+#ifdef CONFIG_HAVE_LONG_LONG
+  /* The squares are kept in b32 so that they cannot overflow */
+
+  return (b16_t)ub32sqrtub16((ub32_t)((b32_t)x * x + (b32_t)y * y));
+#else
+  return (b16_t)ub16sqrtub16((ub16_t)(b16sqr(x) + b16sqr(y)));
+#endif
+}
+
+/****************************************************************************
+ * Name: vector2d_saturate_b16
+ *
+ * Description:
+ *   Saturate 2D vector magnitude.
+ *
+ * Input Parameters:
+ *   x   - (in/out) pointer to the vector x component
+ *   y   - (in/out) pointer to the vector y component
+ *   max - (in) maximum vector magnitude
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vector2d_saturate_b16(FAR b16_t *x, FAR b16_t *y, b16_t max)
+{
+  b16_t mag = 0;
+  b16_t tmp = 0;
+
+  /* Get vector magnitude */
+
+  mag = vector2d_mag_b16(*x, *y);
+
+  if (mag < VECTOR2D_SATURATE_MAG_MIN_B16)
+    {
+      mag = VECTOR2D_SATURATE_MAG_MIN_B16;
+    }
+
+  if (mag > max)
+    {
+      /* Saturate vector */
+
+      tmp = b16divb16(max, mag);
+      *x = b16mulb16(*x, tmp);
+      *y = b16mulb16(*y, tmp);
+    }
+}
+
+/****************************************************************************
+ * Name: dq_mag_b16
+ *
+ * Description:
+ *   Get DQ vector magnitude.
+ *
+ * Input Parameters:
+ *   dq  - (in/out) dq frame vector
+ *
+ * Returned Value:
+ *  Return dq vector magnitude
+ *
+ ****************************************************************************/
+
+b16_t dq_mag_b16(FAR dq_frame_b16_t *dq)
+{
+  return vector2d_mag_b16(dq->d, dq->q);
+}
+
+/****************************************************************************
+ * Name: dq_saturate_b16
+ *
+ * Description:
+ *   Saturate dq frame vector magnitude.
+ *
+ * Input Parameters:
+ *   dq  - (in/out) dq frame vector
+ *   max - (in) maximum vector magnitude
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void dq_saturate_b16(FAR dq_frame_b16_t *dq, b16_t max)
+{
+  vector2d_saturate_b16(&dq->d, &dq->q, max);
+}
+
+/****************************************************************************
+ * Name: fast_sin_b16
+ *
+ * Description:
+ *   Table based sine.  Any angle below about 200 radians in magnitude is
+ *   accepted without normalization.
+ *
+ * Input Parameters:
+ *   angle - (in) angle in b16 radians
+ *
+ * Returned Value:
+ *   Return sine value
+ *
+ ****************************************************************************/
+
+b16_t fast_sin_b16(b16_t angle)
+{
+  return sin_phase_b16(angle_to_phase_b16(angle));
+}
+
+/****************************************************************************
+ * Name: fast_cos_b16
+ *
+ * Description:
+ *   Table based cosine.
+ *
+ * Input Parameters:
+ *   angle - (in) angle in b16 radians
+ *
+ * Returned Value:
+ *   Return cosine value
+ *
+ ****************************************************************************/
+
+b16_t fast_cos_b16(b16_t angle)
+{
+  /* cos(x) = sin(x + PI/2) */
+
+  return sin_phase_b16(angle_to_phase_b16(angle) + SIN_PHASE_QUARTER);
+}
+
+/****************************************************************************
+ * Name: fast_sincos_b16
+ *
+ * Description:
+ *   Table based sine and cosine of the same angle, converting the angle
+ *   only once.
+ *
+ * Input Parameters:
+ *   angle - (in) angle in b16 radians
+ *   s     - (out) sine value
+ *   c     - (out) cosine value
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fast_sincos_b16(b16_t angle, FAR b16_t *s, FAR b16_t *c)
+{
+  uint32_t phase = angle_to_phase_b16(angle);
+
+  *s = sin_phase_b16(phase);
+  *c = sin_phase_b16(phase + SIN_PHASE_QUARTER);
+}
+
+/****************************************************************************
+ * Name: angle_norm_b16
+ *
+ * Description:
+ *   Normalize radians angle to a given boundary and a given period.
+ *
+ * Input Parameters:
+ *   angle  - (in/out) pointer to the angle data
+ *   per    - (in) angle period
+ *   bottom - (in) lower limit
+ *   top    - (in) upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void angle_norm_b16(FAR b16_t *angle, b16_t per, b16_t bottom, b16_t top)
+{
+  while (*angle > top)
+    {
+      /* Move the angle backwards by given period */
+
+      *angle = *angle - per;
+    }
+
+  while (*angle < bottom)
+    {
+      /* Move the angle forwards by given period */
+
+      *angle = *angle + per;
+    }
+}
+
+/****************************************************************************
+ * Name: angle_norm_2pi_b16
+ *
+ * Description:
+ *   Normalize radians angle with period 2*PI to a given boundary.
+ *
+ * Input Parameters:
+ *   angle  - (in/out) pointer to the angle data
+ *   bottom - (in) lower limit
+ *   top    - (in) upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void angle_norm_2pi_b16(FAR b16_t *angle, b16_t bottom, b16_t top)
+{
+  angle_norm_b16(angle, b16TWOPI, bottom, top);
+}
+
+/****************************************************************************
+ * Name: phase_angle_update_b16
+ *
+ * Description:
+ *   Update phase_angle_b16_s structure:
+ *     1. normalize angle value to <0.0, 2PI> range
+ *     2. update angle value
+ *     3. update sin/cos value for given angle
+ *
+ * Input Parameters:
+ *   angle - (in/out) pointer to the angle data
+ *   val   - (in) angle radian value
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void phase_angle_update_b16(FAR struct phase_angle_b16_s *angle, b16_t val)
+{
+  DEBUGASSERT(angle != NULL);
+
+  /* Normalize angle to <0.0, 2PI> */
+
+  angle_norm_2pi_b16(&val, 0, b16TWOPI);
+
+  /* Update structure */
+
+  angle->angle = val;
+  fast_sincos_b16(val, &angle->sin, &angle->cos);
+}
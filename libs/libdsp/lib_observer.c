@@ -28,7 +28,8 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define ANGLE_DIFF_THR (M_PI_F)
+#define ANGLE_DIFF_THR    (M_PI_F)
+#define VECTOR2D_SMALLNUM (1e-10f)
 
 /****************************************************************************
  * Public Functions
@@ -363,6 +364,62 @@ void motor_observer_smo(FAR struct motor_observer_s *o, FAR ab_frame_t *i_ab,
   o->angle = angle;
 }
 
+/****************************************************************************
+ * Name: motor_observer_smo_phase_get
+ *
+ * Description:
+ *   Get the phase angle estimated by the last motor_observer_smo() call,
+ *   together with its sine and cosine, ready for the FOC transforms.
+ *
+ *   The sine and cosine are taken directly from the estimated back-EMF
+ *   vector, which motor_observer_smo() already turned into the angle:
+ *
+ *     th    = atan2(-emf_a, emf_b) + dir * PI/2
+ *     sin(th) = dir * emf_b / |emf|
+ *     cos(th) = dir * emf_a / |emf|
+ *
+ *   This costs one square root and one division instead of the sine and
+ *   cosine evaluations in phase_angle_update().
+ *
+ * Input Parameters:
+ *   o     - (in) pointer to the common observer data
+ *   angle - (out) pointer to the phase angle data
+ *   dir   - (in) rotation direction, as passed to motor_observer_smo()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void motor_observer_smo_phase_get(FAR struct motor_observer_s *o,
+                                  FAR phase_angle_t *angle, float dir)
+{
+  DEBUGASSERT(o != NULL);
+  DEBUGASSERT(angle != NULL);
+  DEBUGASSERT(dir == DIR_CW || dir == DIR_CCW);
+
+  FAR struct motor_observer_smo_s *smo =
+    (FAR struct motor_observer_smo_s *)o->ao;
+  FAR ab_frame_t *emf = &smo->emf;
+  float mag;
+
+  mag = vector2d_mag(emf->a, emf->b);
+
+  if (mag < VECTOR2D_SMALLNUM)
+    {
+      /* No back-EMF to take the direction from */
+
+      phase_angle_update(angle, o->angle);
+      return;
+    }
+
+  mag = dir / mag;
+
+  angle->angle = o->angle;
+  angle->sin   = emf->b * mag;
+  angle->cos   = emf->a * mag;
+}
+
 /****************************************************************************
  * Name: motor_sobserver_div_init
  *
@@ -0,0 +1,168 @@
+/****************************************************************************
+ * libs/libdsp/lib_pid_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pi_controller_init_b16
+ *
+ * Description:
+ *   Initialize PI controller. This function does not initialize saturation
+ *   limits.
+ *
+ * Input Parameters:
+ *   pid - (out) pointer to the PI controller data
+ *   KP  - (in) proportional gain
+ *   KI  - (in) integral gain
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_init_b16(FAR pid_controller_b16_t *pid,
+                            b16_t KP, b16_t KI)
+{
+  DEBUGASSERT(pid != NULL);
+
+  /* Reset controller data */
+
+  memset(pid, 0, sizeof(pid_controller_b16_t));
+
+  /* Copy controller parameters */
+
+  pid->KP = KP;
+  pid->KI = KI;
+}
+
+/****************************************************************************
+ * Name: pi_saturation_set_b16
+ *
+ * Description:
+ *   Set controller saturation limits.
+ *
+ * Input Parameters:
+ *   pid - (out) pointer to the PI controller data
+ *   min - (in) lower limit
+ *   max - (in) upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_saturation_set_b16(FAR pid_controller_b16_t *pid,
+                           b16_t min, b16_t max)
+{
+  DEBUGASSERT(pid != NULL);
+  DEBUGASSERT(min < max);
+
+  pid->sat.max = max;
+  pid->sat.min = min;
+}
+
+/****************************************************************************
+ * Name: pi_integral_reset_b16
+ ****************************************************************************/
+
+void pi_integral_reset_b16(FAR pid_controller_b16_t *pid)
+{
+  pid->part[1] = 0;
+}
+
+/****************************************************************************
+ * Name: pi_controller_b16
+ *
+ * Description:
+ *   PI controller with output saturation and windup protection
+ *
+ * Input Parameters:
+ *   pid - (in/out) pointer to the PI controller data
+ *   err - (in) current controller error
+ *
+ * Returned Value:
+ *   Return controller output.
+ *
+ ****************************************************************************/
+
+b16_t pi_controller_b16(FAR pid_controller_b16_t *pid, b16_t err)
+{
+  DEBUGASSERT(pid != NULL);
+
+  /* Store error in controller structure */
+
+  pid->err = err;
+
+  /* Get proportional part */
+
+  pid->part[0] = b16mulb16(pid->KP, err);
+
+  /* Get intergral part */
+
+  pid->part[1] += b16mulb16(pid->KI, err);
+
+  /* Add proportional, integral */
+
+  pid->out = pid->part[0] + pid->part[1];
+
+  /* Saturate output only if some limits are set */
+
+  if (pid->sat.max != pid->sat.min)
+    {
+      if (pid->out > pid->sat.max)
+        {
+          /* Limit output to the upper limit */
+
+          pid->out = pid->sat.max;
+
+          /* Integral anti-windup - reset integral part */
+
+          if (err > 0)
+            {
+              pi_integral_reset_b16(pid);
+            }
+        }
+      else if (pid->out < pid->sat.min)
+        {
+          /* Limit output to the lower limit */
+
+          pid->out = pid->sat.min;
+
+          /* Integral anti-windup - reset integral part */
+
+          if (err < 0)
+            {
+              pi_integral_reset_b16(pid);
+            }
+        }
+    }
+
+  /* Return regulator output */
+
+  return pid->out;
+}
@@ -35,6 +35,17 @@
 
 #include "nxcontext.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Glyphs are found through a small hash table indexed by character code.
+ * Consecutive codes land in different buckets.
+ */
+
+#define NXFONTS_NHASH    32
+#define NXFONTS_HASH(ch) ((ch) & (NXFONTS_NHASH - 1))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -66,6 +77,10 @@ struct nxfonts_fcache_s
 
   FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
   FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+
+  /* Glyph lookup by character code */
+
+  FAR struct nxfonts_glyph_s *hash[NXFONTS_NHASH];
 };
 
 /****************************************************************************
@@ -171,47 +186,48 @@ static void nxf_cache_lock(FAR struct nxfonts_fcache_s *priv)
  ****************************************************************************/
 
 static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
-                                   FAR struct nxfonts_glyph_s *glyph,
-                                   FAR struct nxfonts_glyph_s *prev)
+                                   FAR struct nxfonts_glyph_s *glyph)
 {
+  FAR struct nxfonts_glyph_s **link;
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Remove the glyph for the list.  First check for removal from the head
-   * (which, I think, never actually happens).
-   */
+  /* Remove the glyph from the doubly linked LRU list */
 
-  if (prev == NULL)
+  if (glyph->blink == NULL)
     {
-      /* Replace the head with the node following glyph */
-
       priv->head = glyph->flink;
-
-      /* If there is no node following glyph, then the list is empty */
-
-      if (priv->head == NULL)
-        {
-          priv->tail = NULL;
-        }
     }
-
-  /* Check for removal from the tail (we know that the list cannot become
-   * empty in either of the next two cases).
-   */
-
-  else if (glyph->flink == NULL)
+  else
     {
-      priv->tail = prev;
-      prev->flink = NULL;
+      glyph->blink->flink = glyph->flink;
     }
 
-  /* No.. Remove from mid-list */
-
+  if (glyph->flink == NULL)
+    {
+      priv->tail = glyph->blink;
+    }
   else
     {
-      prev->flink = glyph->flink;
+      glyph->flink->blink = glyph->blink;
     }
 
   glyph->flink = NULL;
+  glyph->blink = NULL;
+
+  /* Remove the glyph from its hash chain.  The chains are short (about
+   * maxglyphs / NXFONTS_NHASH entries), so a walk is cheap.
+   */
+
+  for (link = &priv->hash[NXFONTS_HASH(glyph->code)];
+       *link != NULL && *link != glyph;
+       link = &(*link)->hlink)
+    {
+    }
+
+  DEBUGASSERT(*link == glyph);
+  *link = glyph->hlink;
+  glyph->hlink = NULL;
 
   /* Decrement the count of glyphs in the font cache */
 
@@ -219,29 +235,57 @@ static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
   priv->nglyphs--;
 }
 
+/****************************************************************************
+ * Name: nxf_linkglyph
+ *
+ * Description:
+ *   Add the entry 'glyph' to the head of the LRU list.
+ *
+ ****************************************************************************/
+
+static inline void nxf_linkglyph(FAR struct nxfonts_fcache_s *priv,
+                                 FAR struct nxfonts_glyph_s *glyph)
+{
+  glyph->blink = NULL;
+  glyph->flink = priv->head;
+
+  if (priv->head == NULL)
+    {
+      priv->tail = glyph;
+    }
+  else
+    {
+      priv->head->blink = glyph;
+    }
+
+  priv->head = glyph;
+}
+
 /****************************************************************************
  * Name: nxf_addglyph
  *
  * Description:
- *   Add the entry 'glyph' to the head font cache list.
+ *   Add the entry 'glyph' to the head font cache list and to its hash
+ *   chain.
  *
  ****************************************************************************/
 
 static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
                                 FAR struct nxfonts_glyph_s *glyph)
 {
+  FAR struct nxfonts_glyph_s **bucket;
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
   /* Add the glyph to the head of the list */
 
-  glyph->flink = priv->head;
+  nxf_linkglyph(priv, glyph);
 
-  if (priv->head == NULL)
-    {
-      priv->tail = glyph;
-    }
+  /* And to the head of its hash chain */
 
-  priv->head = glyph;
+  bucket       = &priv->hash[NXFONTS_HASH(glyph->code)];
+  glyph->hlink = *bucket;
+  *bucket      = glyph;
 
   /* Increment the count of glyphs in the font cache. */
 
@@ -266,6 +310,9 @@ static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
  *   glyphs since it is now the most recently used (leaving the least
  *   recently used glyph at the tail of the list).
  *
+ *   The lookup itself goes through the hash chains so that it does not
+ *   depend on the number of glyphs in the cache.
+ *
  * Assumptions:
  *   The caller has exclusive access to the font cache.
  *
@@ -275,16 +322,15 @@ static FAR struct nxfonts_glyph_s *
   nxf_findglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph;
-  FAR struct nxfonts_glyph_s *prev;
 
   ginfo("fcache=%p ch=%c (%02x)\n",
         priv, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Try to find the glyph in the list of pre-rendered glyphs */
+  /* Try to find the glyph in the hash chain for this character */
 
-  for (prev = NULL, glyph = priv->head;
+  for (glyph = priv->hash[NXFONTS_HASH(ch)];
        glyph != NULL;
-       prev = glyph, glyph = glyph->flink)
+       glyph = glyph->hlink)
     {
       /* Check if we found the glyph for this character */
 
@@ -294,9 +340,9 @@ static FAR struct nxfonts_glyph_s *
            * of the list (if it is not already at the head of the list).
            */
 
-          if (prev != NULL)
+          if (glyph != priv->head)
             {
-              nxf_removeglyph(priv, glyph, prev);
+              nxf_removeglyph(priv, glyph);
               nxf_addglyph(priv, glyph);
             }
 
@@ -304,22 +350,21 @@ static FAR struct nxfonts_glyph_s *
 
           return glyph;
         }
+    }
 
-      /* Is this the last glyph in the list?  Has the cache reached its
-       * limit for the number of cached fonts?
-       */
+  /* Not found.  Has the cache reached its limit for the number of cached
+   * glyphs?
+   */
 
-      if (glyph->flink == NULL && priv->nglyphs >= priv->maxglyphs)
-        {
-          /* Yes.. then remove it from the list and free the glyph memory.
-           * We do this because we have all of the information in hand now
-           * and we will surely need to have this space later.
-           */
+  if (priv->tail != NULL && priv->nglyphs >= priv->maxglyphs)
+    {
+      /* Yes.. then remove the least recently used glyph from the cache and
+       * free the glyph memory.  We will surely need this space in a moment.
+       */
 
-          nxf_removeglyph(priv, glyph, prev);
-          lib_free(glyph);
-          return NULL;
-        }
+      glyph = priv->tail;
+      nxf_removeglyph(priv, glyph);
+      lib_free(glyph);
     }
 
   return NULL;
@@ -570,6 +615,35 @@ static inline FAR struct nxfonts_glyph_s *
   return glyph;
 }
 
+/****************************************************************************
+ * Name: nxf_prerender
+ *
+ * Description:
+ *   Fill a new font cache with the printable ASCII characters, or as many
+ *   of them as fit in the cache.
+ *
+ * Assumptions:
+ *   The font cache is not yet visible to any other client.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFONTS_CACHE_PRERENDER
+static void nxf_prerender(FAR struct nxfonts_fcache_s *priv)
+{
+  FAR const struct nx_fontbitmap_s *fbm;
+  unsigned int ch;
+
+  for (ch = ' '; ch < 0x7f && priv->nglyphs < priv->maxglyphs; ch++)
+    {
+      fbm = nxf_getbitmap(priv->font, ch);
+      if (fbm != NULL && nxf_renderglyph(priv, fbm, ch) == NULL)
+        {
+          break;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxf_findcache
  *
@@ -746,6 +820,14 @@ FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
 
       _SEM_INIT(&priv->fsem, 0, 1);
 
+#ifdef CONFIG_NXFONTS_CACHE_PRERENDER
+      /* Render the printable ASCII set now so that the first lines of text
+       * drawn with this font do not pay the rendering cost.
+       */
+
+      nxf_prerender(priv);
+#endif
+
       /* Add the new font cache to the list of font caches */
 
       priv->flink = g_fcaches;
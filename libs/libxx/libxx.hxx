@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <cstddef>
+
 //***************************************************************************
 // Definitions
 //***************************************************************************
@@ -66,6 +68,18 @@
 #  define lib_free(p)      free(p)
 #endif
 
+// Allocators behind operator new and delete
+
+#ifdef CONFIG_CXX_POOL
+#  define lib_newalloc(s)         libxx_pool_alloc(s)
+#  define lib_delfree(p)          libxx_pool_free(p)
+#  define lib_delfree_sized(p,s)  libxx_pool_free_sized(p,s)
+#else
+#  define lib_newalloc(s)         lib_malloc(s)
+#  define lib_delfree(p)          lib_free(p)
+#  define lib_delfree_sized(p,s)  lib_free(p)
+#endif
+
 //***************************************************************************
 // Public Types
 //***************************************************************************/
@@ -84,4 +98,10 @@ extern "C" FAR void *__dso_handle weak_data;
 
 extern "C" int __cxa_atexit(__cxa_exitfunc_t func, void *arg, void *dso_handle);
 
+#ifdef CONFIG_CXX_POOL
+FAR void *libxx_pool_alloc(std::size_t nbytes);
+void libxx_pool_free(FAR void *ptr);
+void libxx_pool_free_sized(FAR void *ptr, std::size_t nbytes);
+#endif
+
 #endif // __LIBXX_LIBXX_HXX
@@ -51,5 +51,5 @@
 
 void operator delete(FAR void *ptr)
 {
-  lib_free(ptr);
+  lib_delfree(ptr);
 }
@@ -0,0 +1,272 @@
+//***************************************************************************
+// libs/libxx/libxx_pool.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <nuttx/semaphore.h>
+
+#include "libxx.hxx"
+
+#ifdef CONFIG_CXX_POOL
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// Size classes are multiples of the allocation granule, which keeps every
+// block aligned like a heap allocation.
+
+#define POOL_GRANULE      (2 * sizeof(FAR void *))
+#define POOL_NCLASSES     ((CONFIG_CXX_POOL_MAXSIZE + POOL_GRANULE - 1) / \
+                           POOL_GRANULE)
+#define POOL_NPAGES       (CONFIG_CXX_POOL_SIZE / CONFIG_CXX_POOL_PAGESIZE)
+#define POOL_SIZE         (POOL_NPAGES * CONFIG_CXX_POOL_PAGESIZE)
+
+#define POOL_CLASS(n)     (((n) - 1) / POOL_GRANULE)
+#define POOL_BLKSIZE(c)   (((c) + 1) * POOL_GRANULE)
+
+#if (CONFIG_CXX_POOL_PAGESIZE & (CONFIG_CXX_POOL_PAGESIZE - 1)) != 0
+#  error CONFIG_CXX_POOL_PAGESIZE must be a power of two
+#endif
+
+#if CONFIG_CXX_POOL_MAXSIZE > CONFIG_CXX_POOL_PAGESIZE
+#  error CONFIG_CXX_POOL_MAXSIZE must not exceed CONFIG_CXX_POOL_PAGESIZE
+#endif
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+struct pool_free_s
+{
+  FAR struct pool_free_s *next;
+};
+
+struct pool_s
+{
+  FAR uint8_t *base;                          // The arena, POOL_SIZE bytes
+  unsigned int npages;                        // Pages handed to a class
+  FAR struct pool_free_s *free[POOL_NCLASSES];
+  uint8_t pgclass[POOL_NPAGES];               // Size class of each page
+};
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static struct pool_s g_pool;
+static sem_t g_pool_sem = SEM_INITIALIZER(1);
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: pool_lock/pool_unlock
+//***************************************************************************
+
+static inline void pool_lock(void)
+{
+  while (_SEM_WAIT(&g_pool_sem) < 0);
+}
+
+static inline void pool_unlock(void)
+{
+  _SEM_POST(&g_pool_sem);
+}
+
+//***************************************************************************
+// Name: pool_inpool
+//
+// Description:
+//   Return true if ptr was carved out of the arena.
+//
+//***************************************************************************
+
+static inline bool pool_inpool(FAR void *ptr)
+{
+  return g_pool.base != NULL &&
+         (uintptr_t)ptr - (uintptr_t)g_pool.base < POOL_SIZE;
+}
+
+//***************************************************************************
+// Name: pool_addpage
+//
+// Description:
+//   Give the next unused page of the arena to size class c.  Pages are
+//   never taken back from a class: they are reused by the next allocations
+//   of the same size.
+//
+//***************************************************************************
+
+static bool pool_addpage(unsigned int c)
+{
+  FAR struct pool_free_s *head = NULL;
+  FAR uint8_t *page;
+  size_t blksize = POOL_BLKSIZE(c);
+  size_t off;
+
+  if (g_pool.base == NULL)
+    {
+      g_pool.base = (FAR uint8_t *)lib_malloc(POOL_SIZE);
+      if (g_pool.base == NULL)
+        {
+          return false;
+        }
+    }
+
+  if (g_pool.npages >= POOL_NPAGES)
+    {
+      return false;
+    }
+
+  g_pool.pgclass[g_pool.npages] = c;
+  page = g_pool.base + g_pool.npages++ * CONFIG_CXX_POOL_PAGESIZE;
+
+  // Thread the blocks from the end, so that they are handed out in address
+  // order.
+
+  for (off = (CONFIG_CXX_POOL_PAGESIZE / blksize) * blksize; off > 0; )
+    {
+      FAR struct pool_free_s *blk;
+
+      off -= blksize;
+      blk  = (FAR struct pool_free_s *)(page + off);
+      blk->next = head;
+      head = blk;
+    }
+
+  g_pool.free[c] = head;
+  return true;
+}
+
+//***************************************************************************
+// Name: pool_put
+//***************************************************************************
+
+static inline void pool_put(FAR void *ptr, unsigned int c)
+{
+  FAR struct pool_free_s *blk = (FAR struct pool_free_s *)ptr;
+
+  pool_lock();
+  blk->next = g_pool.free[c];
+  g_pool.free[c] = blk;
+  pool_unlock();
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_pool_alloc
+//
+// Description:
+//   Allocate nbytes for operator new.  Small requests come from per size
+//   class free lists in a single arena, so that the many small, short
+//   lived C++ objects don't fragment the heap; larger ones, and small ones
+//   once the arena is exhausted, come from the heap.
+//
+//***************************************************************************
+
+FAR void *libxx_pool_alloc(std::size_t nbytes)
+{
+  FAR struct pool_free_s *blk;
+  unsigned int c;
+
+  if (nbytes == 0 || nbytes > CONFIG_CXX_POOL_MAXSIZE)
+    {
+      return lib_malloc(nbytes ? nbytes : 1);
+    }
+
+  c = POOL_CLASS(nbytes);
+
+  pool_lock();
+
+  blk = g_pool.free[c];
+  if (blk == NULL && pool_addpage(c))
+    {
+      blk = g_pool.free[c];
+    }
+
+  if (blk != NULL)
+    {
+      g_pool.free[c] = blk->next;
+    }
+
+  pool_unlock();
+
+  return blk != NULL ? (FAR void *)blk : lib_malloc(nbytes);
+}
+
+//***************************************************************************
+// Name: libxx_pool_free
+//
+// Description:
+//   Free memory from libxx_pool_alloc().  The size class of a pooled block
+//   is found from the page it lives in.
+//
+//***************************************************************************
+
+void libxx_pool_free(FAR void *ptr)
+{
+  if (pool_inpool(ptr))
+    {
+      uintptr_t pg = ((uintptr_t)ptr - (uintptr_t)g_pool.base) /
+                     CONFIG_CXX_POOL_PAGESIZE;
+
+      pool_put(ptr, g_pool.pgclass[pg]);
+    }
+  else
+    {
+      lib_free(ptr);
+    }
+}
+
+//***************************************************************************
+// Name: libxx_pool_free_sized
+//
+// Description:
+//   Free memory of a known size from libxx_pool_alloc() for the sized
+//   delete operators: large blocks go straight back to the heap, and the
+//   size class of small ones doesn't need to be looked up.
+//
+//***************************************************************************
+
+void libxx_pool_free_sized(FAR void *ptr, std::size_t nbytes)
+{
+  if (nbytes > 0 && nbytes <= CONFIG_CXX_POOL_MAXSIZE && pool_inpool(ptr))
+    {
+      pool_put(ptr, POOL_CLASS(nbytes));
+    }
+  else
+    {
+      lib_free(ptr);
+    }
+}
+
+#endif // CONFIG_CXX_POOL
@@ -0,0 +1,238 @@
+/****************************************************************************
+ * mm/dma/dma_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/mm/dma.h>
+
+#ifdef CONFIG_ARCH_DCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LINE_MASK         (CONFIG_ARCH_DCACHE_LINESIZE - 1)
+#define LINE_DOWN(a)      ((a) & ~(uintptr_t)LINE_MASK)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE void (*dma_cacheop_t)(uintptr_t start, uintptr_t end);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_sg_total
+ *
+ * Description:
+ *   Return the total number of bytes in a scatter list.
+ *
+ ****************************************************************************/
+
+#if CONFIG_ARCH_DCACHE_ALL_THRESHOLD > 0
+static size_t dma_sg_total(FAR const struct dma_sg_s *sg, int nsg)
+{
+  size_t total = 0;
+  int i;
+
+  for (i = 0; i < nsg; i++)
+    {
+      total += sg[i].len;
+    }
+
+  return total;
+}
+#endif
+
+/****************************************************************************
+ * Name: dma_invalidate_range
+ *
+ * Description:
+ *   Invalidate a range, flushing rather than invalidating the partial
+ *   cache lines at its edges.
+ *
+ ****************************************************************************/
+
+static void dma_invalidate_range(uintptr_t start, uintptr_t end)
+{
+  if ((start & LINE_MASK) != 0)
+    {
+      up_flush_dcache(LINE_DOWN(start),
+                      LINE_DOWN(start) + CONFIG_ARCH_DCACHE_LINESIZE);
+      start = LINE_DOWN(start) + CONFIG_ARCH_DCACHE_LINESIZE;
+    }
+
+  if ((end & LINE_MASK) != 0 && end > start)
+    {
+      up_flush_dcache(LINE_DOWN(end),
+                      LINE_DOWN(end) + CONFIG_ARCH_DCACHE_LINESIZE);
+      end = LINE_DOWN(end);
+    }
+
+  if (end > start)
+    {
+      up_invalidate_dcache(start, end);
+    }
+}
+
+/****************************************************************************
+ * Name: dma_sg_foreach
+ *
+ * Description:
+ *   Apply a cache operation to the ranges of a scatter list, merging the
+ *   entries that overlap or touch the previous one.
+ *
+ ****************************************************************************/
+
+static void dma_sg_foreach(FAR const struct dma_sg_s *sg, int nsg,
+                           dma_cacheop_t op)
+{
+  uintptr_t start = 0;
+  uintptr_t end = 0;
+  uintptr_t sgstart;
+  uintptr_t sgend;
+  int i;
+
+  for (i = 0; i < nsg; i++)
+    {
+      if (sg[i].len == 0)
+        {
+          continue;
+        }
+
+      sgstart = (uintptr_t)sg[i].addr;
+      sgend   = sgstart + sg[i].len;
+
+      if (end > start && sgstart <= end && sgend >= start)
+        {
+          /* Merge with the pending range */
+
+          if (sgstart < start)
+            {
+              start = sgstart;
+            }
+
+          if (sgend > end)
+            {
+              end = sgend;
+            }
+
+          continue;
+        }
+
+      if (end > start)
+        {
+          op(start, end);
+        }
+
+      start = sgstart;
+      end   = sgend;
+    }
+
+  if (end > start)
+    {
+      op(start, end);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_clean_sg
+ *
+ * Description:
+ *   Clean the D-Cache for all ranges of a scatter list.
+ *
+ ****************************************************************************/
+
+void dma_clean_sg(FAR const struct dma_sg_s *sg, int nsg)
+{
+#if CONFIG_ARCH_DCACHE_ALL_THRESHOLD > 0
+  if (dma_sg_total(sg, nsg) > CONFIG_ARCH_DCACHE_ALL_THRESHOLD)
+    {
+      up_clean_dcache_all();
+      return;
+    }
+#endif
+
+  dma_sg_foreach(sg, nsg, up_clean_dcache);
+}
+
+/****************************************************************************
+ * Name: dma_invalidate_sg
+ *
+ * Description:
+ *   Invalidate the D-Cache for all ranges of a scatter list.
+ *
+ ****************************************************************************/
+
+void dma_invalidate_sg(FAR const struct dma_sg_s *sg, int nsg)
+{
+#if CONFIG_ARCH_DCACHE_ALL_THRESHOLD > 0
+  /* Invalidating the whole D-Cache would discard unrelated dirty data;
+   * flushing it is safe.
+   */
+
+  if (dma_sg_total(sg, nsg) > CONFIG_ARCH_DCACHE_ALL_THRESHOLD)
+    {
+      up_flush_dcache_all();
+      return;
+    }
+#endif
+
+  dma_sg_foreach(sg, nsg, dma_invalidate_range);
+}
+
+/****************************************************************************
+ * Name: dma_flush_sg
+ *
+ * Description:
+ *   Clean and invalidate the D-Cache for all ranges of a scatter list.
+ *
+ ****************************************************************************/
+
+void dma_flush_sg(FAR const struct dma_sg_s *sg, int nsg)
+{
+#if CONFIG_ARCH_DCACHE_ALL_THRESHOLD > 0
+  if (dma_sg_total(sg, nsg) > CONFIG_ARCH_DCACHE_ALL_THRESHOLD)
+    {
+      up_flush_dcache_all();
+      return;
+    }
+#endif
+
+  dma_sg_foreach(sg, nsg, up_flush_dcache);
+}
+
+#endif /* CONFIG_ARCH_DCACHE */
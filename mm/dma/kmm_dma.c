@@ -0,0 +1,86 @@
+/****************************************************************************
+ * mm/dma/kmm_dma.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/dma.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_dma_alloc
+ *
+ * Description:
+ *   Allocate a DMA-safe buffer.  See include/nuttx/mm/dma.h.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_dma_alloc(size_t size)
+{
+  /* kmm_memalign_region() falls back to the kernel heap if there is no
+   * DMA capable region heap or it is exhausted.
+   */
+
+  return kmm_memalign_region(MM_REGION_DMA, DMA_ALIGNMENT,
+                             DMA_ROUNDUP(size));
+}
+
+/****************************************************************************
+ * Name: kmm_dma_zalloc
+ *
+ * Description:
+ *   Allocate and clear a DMA-safe buffer.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_dma_zalloc(size_t size)
+{
+  FAR void *mem = kmm_dma_alloc(size);
+
+  if (mem != NULL)
+    {
+      memset(mem, 0, DMA_ROUNDUP(size));
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: kmm_dma_free
+ *
+ * Description:
+ *   Free a DMA-safe buffer.
+ *
+ ****************************************************************************/
+
+void kmm_dma_free(FAR void *mem)
+{
+  kmm_free_region(mem);
+}
@@ -75,6 +75,12 @@ extern FAR struct iob_s *g_iob_freelist;
 
 extern FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+extern FAR struct iob_s *g_iob_large_freelist;
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -134,6 +140,45 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the cache of the current CPU,
+ *   refilling the cache from the global free list if it is empty.
+ *
+ * Input Parameters:
+ *   consumerid - id representing who is consuming the IOB
+ *
+ * Returned Value:
+ *   The allocated I/O buffer or NULL if none could be obtained this way.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+FAR struct iob_s *iob_cache_alloc(enum iob_user_e consumerid);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Try to return an I/O buffer to the cache of the current CPU.
+ *
+ * Input Parameters:
+ *   iob        - The I/O buffer to free
+ *   producerid - id representing who is producing the IOB
+ *
+ * Returned Value:
+ *   True if the buffer was cached; false if it must be returned to the
+ *   global free list.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+bool iob_cache_free(FAR struct iob_s *iob, enum iob_user_e producerid);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
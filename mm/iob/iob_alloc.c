@@ -99,6 +99,49 @@ static FAR struct iob_s *iob_alloc_committed(enum iob_user_e consumerid)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_large
+ *
+ * Description:
+ *   Try to allocate a large I/O buffer without waiting.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static FAR struct iob_s *iob_alloc_large(enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  iob = g_iob_large_freelist;
+  if (iob != NULL)
+    {
+      g_iob_large_freelist = iob->io_flink;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onalloc(consumerid);
+#endif
+    }
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -220,6 +263,52 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid)
     }
 }
 
+/****************************************************************************
+ * Name: iob_alloc_len
+ *
+ * Description:
+ *   Allocate an I/O buffer that best fits a payload of 'len' bytes,
+ *   waiting for a normal I/O buffer if necessary.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+FAR struct iob_s *iob_alloc_len(unsigned int len, bool throttled,
+                                enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob = NULL;
+
+  if (len > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_alloc_large(consumerid);
+    }
+
+  return iob != NULL ? iob : iob_alloc(throttled, consumerid);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_len
+ *
+ * Description:
+ *   Try to allocate an I/O buffer that best fits a payload of 'len' bytes
+ *   without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_len(unsigned int len, bool throttled,
+                                   enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob = NULL;
+
+  if (len > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_alloc_large(consumerid);
+    }
+
+  return iob != NULL ? iob : iob_tryalloc(throttled, consumerid);
+}
+#endif
+
 /****************************************************************************
  * Name: iob_tryalloc
  *
@@ -237,6 +326,18 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
   FAR sem_t *sem;
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Try the cache of this CPU first.  That avoids the critical section in
+   * the common case.
+   */
+
+  iob = iob_cache_alloc(consumerid);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore count to check. */
 
@@ -0,0 +1,276 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The cache is refilled from the global free list in batches of half of
+ * its size so that a CPU alternating between allocations and frees does
+ * not bounce between an empty and a full cache.
+ */
+
+#define IOB_CACHE_BATCH ((CONFIG_IOB_PERCPU_CACHE + 1) / 2)
+
+/* Only take buffers from, or keep buffers out of, the global pool while it
+ * has spare buffers above the throttle reserve.
+ */
+
+#if CONFIG_IOB_THROTTLE > 0
+#  define IOB_GLOBAL_SPARE(n) \
+     (g_iob_sem.semcount > (n) && g_throttle_sem.semcount > (n))
+#else
+#  define IOB_GLOBAL_SPARE(n) (g_iob_sem.semcount > (n))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The I/O buffer cache of one CPU.  It is only accessed from the CPU that
+ * owns it with local interrupts disabled.
+ */
+
+struct iob_cache_s
+{
+  FAR struct iob_s *ic_head;       /* List of cached free I/O buffers */
+  uint8_t ic_count;                /* Number of buffers in ic_head */
+  struct iob_cachestats_s ic_stats;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[IOB_NCACHES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_pop
+ *
+ * Description:
+ *   Remove the I/O buffer at the head of a cache, if any.  Local
+ *   interrupts must be disabled.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_cache_pop(FAR struct iob_cache_s *cache,
+                                       enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob = cache->ic_head;
+
+  if (iob != NULL)
+    {
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      /* REVISIT: The per-user statistics are global.  In the SMP case,
+       * updates from the cache hit path may race with other CPUs.
+       */
+
+      iob_stats_onalloc(consumerid);
+#endif
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the cache of the current CPU,
+ *   refilling the cache from the global free list if it is empty.
+ *
+ *   Buffers only enter a cache while the global pool has spare buffers
+ *   above the throttle reserve, so serving throttled allocations from the
+ *   cache never consumes the reserve.
+ *
+ * Input Parameters:
+ *   consumerid - id representing who is consuming the IOB
+ *
+ * Returned Value:
+ *   The allocated I/O buffer or NULL if the cache is empty and could not
+ *   be refilled.  The caller should then fall back to the global free list.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(enum iob_user_e consumerid)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  /* Fast path:  Take a buffer from the cache of this CPU */
+
+  flags = local_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  iob   = iob_cache_pop(cache, consumerid);
+  if (iob != NULL)
+    {
+      cache->ic_stats.hits++;
+    }
+
+  local_irq_restore(flags);
+
+  if (iob == NULL)
+    {
+      /* Slow path:  Move a batch of buffers from the global free list into
+       * the cache under a single critical section.  The CPU may have
+       * changed, so look up the cache again.
+       */
+
+      flags = enter_critical_section();
+      cache = &g_iob_cache[up_cpu_index()];
+      cache->ic_stats.misses++;
+
+      while (cache->ic_count < IOB_CACHE_BATCH &&
+             g_iob_freelist != NULL && IOB_GLOBAL_SPARE(0))
+        {
+          iob             = g_iob_freelist;
+          g_iob_freelist  = iob->io_flink;
+
+          /* These buffers are no longer available in the global pool.  See
+           * iob_tryalloc() for why the counts are adjusted directly.
+           */
+
+          g_iob_sem.semcount--;
+#if CONFIG_IOB_THROTTLE > 0
+          g_throttle_sem.semcount--;
+#endif
+
+          iob->io_flink   = cache->ic_head;
+          cache->ic_head  = iob;
+          cache->ic_count++;
+        }
+
+      iob = iob_cache_pop(cache, consumerid);
+      leave_critical_section(flags);
+
+      if (iob == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  /* Put the I/O buffer in a known state */
+
+  iob->io_flink  = NULL; /* Not in a chain */
+  iob->io_len    = 0;    /* Length of the data in the entry */
+  iob->io_offset = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen = 0;    /* Total length of the packet */
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Try to return an I/O buffer to the cache of the current CPU.
+ *
+ * Input Parameters:
+ *   iob        - The I/O buffer to free
+ *   producerid - id representing who is producing the IOB
+ *
+ * Returned Value:
+ *   True if the buffer was cached.  False if the cache is full or the
+ *   global pool is running low; the caller must then return the buffer to
+ *   the global free list so that blocked allocations can get it.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob, enum iob_user_e producerid)
+{
+  FAR struct iob_cache_s *cache;
+  irqstate_t flags;
+  bool cached = false;
+
+  /* Never keep buffers back while anybody could be waiting for one.  This
+   * check is done without the critical section:  Waiters only exist once
+   * the global pool is exhausted, which is well below this threshold.
+   */
+
+  if (!IOB_GLOBAL_SPARE(CONFIG_IOB_PERCPU_CACHE))
+    {
+      return false;
+    }
+
+  flags = local_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  if (cache->ic_count < CONFIG_IOB_PERCPU_CACHE)
+    {
+      iob->io_flink  = cache->ic_head;
+      cache->ic_head = iob;
+      cache->ic_count++;
+      cached         = true;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onfree(producerid);
+#endif
+    }
+
+  local_irq_restore(flags);
+  return cached;
+}
+
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return a reference to the statistics of the per-CPU I/O buffer cache
+ *   of one CPU.
+ *
+ ****************************************************************************/
+
+FAR struct iob_cachestats_s *iob_getcachestats(int cpu)
+{
+  DEBUGASSERT(cpu >= 0 && cpu < IOB_NCACHES);
+  return &g_iob_cache[cpu].ic_stats;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
@@ -128,6 +128,36 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob,
               next, next->io_pktlen, next->io_len);
     }
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* Large I/O buffers go back to their own free list.  Nobody ever waits
+   * for a large buffer, so there is nothing to signal.
+   */
+
+  if (iob->io_bufsize != CONFIG_IOB_BUFSIZE)
+    {
+      flags                = enter_critical_section();
+      iob->io_flink        = g_iob_large_freelist;
+      g_iob_large_freelist = iob;
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+      iob_stats_onfree(producerid);
+#endif
+
+      leave_critical_section(flags);
+      return next;
+    }
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the I/O buffer in the cache of this CPU if possible */
+
+  if (iob_cache_free(iob, producerid))
+    {
+      return next;
+    }
+#endif
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -40,7 +40,10 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <assert.h>
 
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/dma.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -53,13 +56,58 @@
 #  define NULL ((FAR void *)0)
 #endif
 
+#ifndef CONFIG_IOB_REGION
+#  define CONFIG_IOB_REGION 0
+#endif
+
+/* With CONFIG_IOB_DMA, each payload buffer starts on a cache line and is
+ * padded to a whole number of lines.  The dynamically allocated pools
+ * then come from kmm_dma_alloc(), which honours MM_REGION_DMA.
+ */
+
+#ifdef CONFIG_IOB_DMA
+#  define IOB_BUFSTRIDE          DMA_ROUNDUP(CONFIG_IOB_BUFSIZE)
+#  define IOB_LARGE_BUFSTRIDE    DMA_ROUNDUP(CONFIG_IOB_LARGE_BUFSIZE)
+#  define IOB_POOL_ALLOC(s)      kmm_dma_alloc(s)
+#  define IOB_DMA_ALIGNED        aligned_data(DMA_ALIGNMENT)
+#else
+#  define IOB_BUFSTRIDE          CONFIG_IOB_BUFSIZE
+#  define IOB_LARGE_BUFSTRIDE    CONFIG_IOB_LARGE_BUFSIZE
+#  define IOB_POOL_ALLOC(s)      kmm_malloc_region(CONFIG_IOB_REGION, s)
+#  define IOB_DMA_ALIGNED
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* This is a pool of pre-allocated I/O buffers */
+/* This is a pool of pre-allocated I/O buffers.  With CONFIG_IOB_REGION,
+ * the pools are allocated from the preferred region heap at start-up.
+ */
+
+#if CONFIG_IOB_REGION != 0
+static FAR struct iob_s    *g_iob_pool;
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static FAR struct iob_s    *g_iob_large_pool;
+
+/* The payload buffers of both pools */
 
+static FAR uint8_t (*g_iob_buffers)[IOB_BUFSTRIDE];
+static FAR uint8_t (*g_iob_large_buffers)[IOB_LARGE_BUFSTRIDE];
+#endif
+#else
 static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static struct iob_s        g_iob_large_pool[CONFIG_IOB_LARGE_NBUFFERS];
+
+/* The payload buffers of both pools */
+
+static uint8_t g_iob_buffers[CONFIG_IOB_NBUFFERS][IOB_BUFSTRIDE]
+  IOB_DMA_ALIGNED;
+static uint8_t g_iob_large_buffers[CONFIG_IOB_LARGE_NBUFFERS]
+                                  [IOB_LARGE_BUFSTRIDE] IOB_DMA_ALIGNED;
+#endif
+#endif /* CONFIG_IOB_REGION != 0 */
 #if CONFIG_IOB_NCHAINS > 0
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
@@ -76,6 +124,12 @@ FAR struct iob_s *g_iob_freelist;
 
 FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+FAR struct iob_s *g_iob_large_freelist;
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -117,18 +171,58 @@ void iob_initialize(void)
 
   if (!initialized)
     {
+#if CONFIG_IOB_REGION != 0
+      /* Allocate the pools from the preferred memory.  This happens once,
+       * at start-up, so failure is fatal.
+       */
+
+      g_iob_pool = (FAR struct iob_s *)
+        IOB_POOL_ALLOC(CONFIG_IOB_NBUFFERS * sizeof(struct iob_s));
+      DEBUGASSERT(g_iob_pool != NULL);
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+      g_iob_large_pool = (FAR struct iob_s *)
+        kmm_malloc_region(CONFIG_IOB_REGION,
+                          CONFIG_IOB_LARGE_NBUFFERS * sizeof(struct iob_s));
+      g_iob_buffers = IOB_POOL_ALLOC(CONFIG_IOB_NBUFFERS * IOB_BUFSTRIDE);
+      g_iob_large_buffers =
+        IOB_POOL_ALLOC(CONFIG_IOB_LARGE_NBUFFERS * IOB_LARGE_BUFSTRIDE);
+      DEBUGASSERT(g_iob_large_pool != NULL && g_iob_buffers != NULL &&
+                  g_iob_large_buffers != NULL);
+#endif
+#endif
+
       /* Add each I/O buffer to the free list */
 
       for (i = 0; i < CONFIG_IOB_NBUFFERS; i++)
         {
           FAR struct iob_s *iob = &g_iob_pool[i];
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+          iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+          iob->io_data    = g_iob_buffers[i];
+#endif
+
           /* Add the pre-allocate I/O buffer to the head of the free list */
 
           iob->io_flink  = g_iob_freelist;
           g_iob_freelist = iob;
         }
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+      /* And each large I/O buffer to the large free list */
+
+      for (i = 0; i < CONFIG_IOB_LARGE_NBUFFERS; i++)
+        {
+          FAR struct iob_s *iob = &g_iob_large_pool[i];
+
+          iob->io_bufsize      = CONFIG_IOB_LARGE_BUFSIZE;
+          iob->io_data         = g_iob_large_buffers[i];
+          iob->io_flink        = g_iob_large_freelist;
+          g_iob_large_freelist = iob;
+        }
+#endif
+
       g_iob_committed = NULL;
 
       nxsem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
@@ -0,0 +1,293 @@
+/****************************************************************************
+ * mm/kmm_heap/kmm_region.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_REGION_HEAPS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kmm_region_s
+{
+  struct mm_heap_s heap;   /* The heap of all memory with these attributes */
+  uint8_t attr;            /* MM_REGION_* attributes of the memory */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct kmm_region_s g_kmmregions[CONFIG_MM_REGION_NHEAPS];
+static int g_nkmmregions;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_region_alloc
+ *
+ * Description:
+ *   Allocate from the first region heap, in the order of registration,
+ *   that has all of the requested attributes and enough free memory.
+ *
+ ****************************************************************************/
+
+static FAR void *kmm_region_alloc(uint8_t attr, size_t alignment,
+                                  size_t size)
+{
+  FAR void *mem;
+  int i;
+
+  for (i = 0; i < g_nkmmregions; i++)
+    {
+      if ((g_kmmregions[i].attr & attr) == attr)
+        {
+          mem = mm_memalign(&g_kmmregions[i].heap, alignment, size);
+          if (mem != NULL)
+            {
+              return mem;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: kmm_region_find
+ *
+ * Description:
+ *   Return the region heap containing 'mem' or NULL if it is not part of
+ *   any region heap.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_heap_s *kmm_region_find(FAR void *mem)
+{
+  int i;
+
+  for (i = 0; i < g_nkmmregions; i++)
+    {
+      if (mm_heapmember(&g_kmmregions[i].heap, mem))
+        {
+          return &g_kmmregions[i].heap;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_region_add
+ *
+ * Description:
+ *   Register memory with the given MM_REGION_* attributes.  Memory with
+ *   the same attributes as earlier memory is added to the same heap as a
+ *   further region.  This is intended to be called only from
+ *   up_allocate_regionheaps() while the system is still single threaded.
+ *
+ * Input Parameters:
+ *   attr      - The MM_REGION_* attributes of the memory, not zero
+ *   heapstart - Start of the memory
+ *   heapsize  - Size of the memory in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure:
+ *
+ *   -EINVAL - No attributes were given
+ *   -ENOSPC - All CONFIG_MM_REGION_NHEAPS heaps are in use or the heap
+ *             of these attributes has no room for another region
+ *
+ ****************************************************************************/
+
+int kmm_region_add(uint8_t attr, FAR void *heapstart, size_t heapsize)
+{
+  FAR struct kmm_region_s *region;
+  int i;
+
+  DEBUGASSERT(heapstart != NULL && heapsize > 0);
+
+  if (attr == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < g_nkmmregions; i++)
+    {
+      region = &g_kmmregions[i];
+      if (region->attr == attr)
+        {
+#if CONFIG_MM_REGIONS > 1
+          if (region->heap.mm_nregions < CONFIG_MM_REGIONS)
+            {
+              mm_addregion(&region->heap, heapstart, heapsize);
+              return OK;
+            }
+#endif
+
+          return -ENOSPC;
+        }
+    }
+
+  if (g_nkmmregions >= CONFIG_MM_REGION_NHEAPS)
+    {
+      return -ENOSPC;
+    }
+
+  /* Only make the heap visible to the allocators once it is complete */
+
+  region       = &g_kmmregions[g_nkmmregions];
+  region->attr = attr;
+  mm_initialize(&region->heap, heapstart, heapsize);
+  g_nkmmregions++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kmm_malloc_region
+ *
+ * Description:
+ *   Allocate memory from a region heap having all of the MM_REGION_*
+ *   attributes in 'attr'.  If there is no such heap, or none of them can
+ *   satisfy the request, the memory is allocated from the kernel heap.
+ *   The memory must be released with kmm_free_region().
+ *
+ * Input Parameters:
+ *   attr - The required MM_REGION_* attributes
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *
+ * Returned Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+FAR void *kmm_malloc_region(uint8_t attr, size_t size)
+{
+  FAR void *mem = kmm_region_alloc(attr, 0, size);
+
+  if (mem == NULL)
+    {
+      mem = kmm_malloc(size);
+    }
+
+  return MM_TRACE(mem);
+}
+
+/****************************************************************************
+ * Name: kmm_zalloc_region
+ *
+ * Description:
+ *   kmm_malloc_region() and clear the memory.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_zalloc_region(uint8_t attr, size_t size)
+{
+  FAR void *mem = kmm_region_alloc(attr, 0, size);
+
+  if (mem != NULL)
+    {
+      memset(mem, 0, size);
+    }
+  else
+    {
+      mem = kmm_zalloc(size);
+    }
+
+  return MM_TRACE(mem);
+}
+
+/****************************************************************************
+ * Name: kmm_memalign_region
+ *
+ * Description:
+ *   kmm_malloc_region() with the given alignment, which must be a power of
+ *   two.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_memalign_region(uint8_t attr, size_t alignment, size_t size)
+{
+  FAR void *mem = kmm_region_alloc(attr, alignment, size);
+
+  if (mem == NULL)
+    {
+      mem = kmm_memalign(alignment, size);
+    }
+
+  return MM_TRACE(mem);
+}
+
+/****************************************************************************
+ * Name: kmm_free_region
+ *
+ * Description:
+ *   Release memory allocated by kmm_malloc_region(), kmm_zalloc_region()
+ *   or kmm_memalign_region() to the heap it was allocated from.
+ *
+ ****************************************************************************/
+
+void kmm_free_region(FAR void *mem)
+{
+  FAR struct mm_heap_s *heap = kmm_region_find(mem);
+
+  if (heap != NULL)
+    {
+      mm_free(heap, mem);
+    }
+  else
+    {
+      kmm_free(mem);
+    }
+}
+
+/****************************************************************************
+ * Name: kmm_regionmember
+ *
+ * Description:
+ *   Return true if 'mem' lies in one of the region heaps.
+ *
+ ****************************************************************************/
+
+bool kmm_regionmember(FAR void *mem)
+{
+  return kmm_region_find(mem) != NULL;
+}
+
+#endif /* CONFIG_MM_REGION_HEAPS */
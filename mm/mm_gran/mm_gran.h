@@ -56,8 +56,11 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#define SIZEOF_SUMMARY(n) \
+  ((SIZEOF_GAT(n) + 31) >> 5)
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + SIZEOF_SUMMARY(n) - 1))
 
 /* Debug */
 
@@ -87,6 +90,12 @@ struct gran_s
   sem_t      exclsem;   /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+
+  /* Bit n of the summary is set if GAT entry n is fully allocated.  It
+   * follows the GAT in the same allocation.
+   */
+
+  FAR uint32_t *summary;
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
@@ -131,4 +140,23 @@ void gran_leave_critical(FAR struct gran_s *priv);
 void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
                          unsigned int ngranules);
 
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of granules as free.
+ *
+ * Input Parameters:
+ *   priv  - The granule heap state structure.
+ *   alloc - The address of the allocation.
+ *   ngranules - The number of granules allocated
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void gran_mark_free(FAR struct gran_s *priv, uintptr_t alloc,
+                    unsigned int ngranules);
+
 #endif /* __MM_MM_GRAN_MM_GRAN_H */
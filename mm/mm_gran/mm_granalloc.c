@@ -32,23 +32,121 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_next_free
+ *
+ * Description:
+ *   Return the first free granule at or after 'granno', or the number of
+ *   granules if there is none.  Fully allocated GAT entries are skipped
+ *   32 at a time using the summary.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_next_free(FAR struct gran_s *priv,
+                                   unsigned int granno)
+{
+  unsigned int ngat = SIZEOF_GAT(priv->ngranules);
+  unsigned int nsum = SIZEOF_SUMMARY(priv->ngranules);
+  unsigned int gatidx = granno >> 5;
+  unsigned int sumidx;
+  uint32_t     avail;
+  uint32_t     free;
+
+  if (gatidx >= ngat)
+    {
+      return priv->ngranules;
+    }
+
+  free = ~priv->gat[gatidx] & (0xffffffff << (granno & 31));
+  while (free == 0)
+    {
+      /* Find the next GAT entry that is not fully allocated */
+
+      gatidx++;
+      sumidx = gatidx >> 5;
+      if (gatidx >= ngat)
+        {
+          return priv->ngranules;
+        }
+
+      avail = ~priv->summary[sumidx] & (0xffffffff << (gatidx & 31));
+      while (avail == 0)
+        {
+          if (++sumidx >= nsum)
+            {
+              return priv->ngranules;
+            }
+
+          avail = ~priv->summary[sumidx];
+        }
+
+      gatidx = (sumidx << 5) + __builtin_ctz(avail);
+      if (gatidx >= ngat)
+        {
+          return priv->ngranules;
+        }
+
+      free = ~priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + __builtin_ctz(free);
+  return granno < priv->ngranules ? granno : priv->ngranules;
+}
+
+/****************************************************************************
+ * Name: gran_next_used
+ *
+ * Description:
+ *   Return the first allocated granule in [start, end), or 'end' if all of
+ *   them are free.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_next_used(FAR struct gran_s *priv,
+                                   unsigned int start, unsigned int end)
+{
+  unsigned int gatidx;
+  uint32_t     used;
+
+  while (start < end)
+    {
+      gatidx = start >> 5;
+      used   = priv->gat[gatidx] & (0xffffffff << (start & 31));
+      if (used != 0)
+        {
+          start = (gatidx << 5) + __builtin_ctz(used);
+          return start < end ? start : end;
+        }
+
+      start = (gatidx + 1) << 5;
+    }
+
+  return end;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: gran_alloc
+ * Name: gran_memalign
  *
  * Description:
- *   Allocate memory from the granule heap.
+ *   Allocate aligned memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   The search jumps from the first free granule to the first following
+ *   allocated granule with word-wide bit scans, so its cost depends on the
+ *   number of free runs that are too short rather than on the number of
+ *   granules.
  *
  * Input Parameters:
- *   handle - The handle previously returned by gran_initialize
- *   size   - The size of the memory region to allocate.
+ *   handle    - The handle previously returned by gran_initialize
+ *   alignment - Power of two alignment in bytes
+ *   size      - The size of the memory region to allocate.
  *
  * Returned Value:
  *   On success, a non-NULL pointer to the allocated memory is returned;
@@ -56,193 +154,117 @@
  *
  ****************************************************************************/
 
-FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
+FAR void *gran_memalign(GRAN_HANDLE handle, size_t alignment, size_t size)
 {
   FAR struct gran_s *priv = (FAR struct gran_s *)handle;
   unsigned int ngranules;
+  unsigned int granno;
+  unsigned int start;
+  unsigned int end;
+  unsigned int amask = 0;
+  unsigned int phase = 0;
   size_t       tmpmask;
-  uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
   int          ret;
 
-  DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL);
+  DEBUGASSERT((alignment & (alignment - 1)) == 0);
+
+  if (priv == NULL || size == 0)
+    {
+      return NULL;
+    }
+
+  /* How many contiguous granules we we need to find? */
+
+  tmpmask   = (1 << priv->log2gran) - 1;
+  ngranules = (size + tmpmask) >> priv->log2gran;
+  if (ngranules > priv->ngranules)
+    {
+      return NULL;
+    }
+
+  /* Alignments larger than a granule allow only every (amask + 1)th
+   * granule, starting with granule 'phase', to start the allocation.
+   */
 
-  if (priv != NULL && size > 0)
+  if (alignment > tmpmask + 1)
     {
-      /* Get exclusive access to the GAT */
+      uintptr_t offset = (0 - priv->heapstart) & (alignment - 1);
 
-      ret = gran_enter_critical(priv);
-      if (ret < 0)
+      if ((offset & tmpmask) != 0)
         {
           return NULL;
         }
 
-      /* How many contiguous granules we we need to find? */
+      amask = (alignment >> priv->log2gran) - 1;
+      phase = offset >> priv->log2gran;
+    }
 
-      tmpmask   = (1 << priv->log2gran) - 1;
-      ngranules = (size + tmpmask) >> priv->log2gran;
+  /* Get exclusive access to the GAT */
 
-      /* Then create mask for that number of granules */
+  ret = gran_enter_critical(priv);
+  if (ret < 0)
+    {
+      return NULL;
+    }
 
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
+  /* Now search the granule allocation table for that number of contiguous
+   * free granules.
+   */
 
-      /* Now search the granule allocation table for that number of contiguous */
+  for (granno = 0; ; granno = end + 1)
+    {
+      /* Start at the first suitably aligned free granule */
 
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      start  = gran_next_free(priv, granno);
+      start += (phase - start) & amask;
+      if (start >= priv->ngranules ||
+          ngranules > priv->ngranules - start)
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
-
-          /* Handle the case where there are no free granules in the entry */
+          break;
+        }
 
-          if (curr == 0xffffffff)
-            {
-              continue;
-            }
+      /* Is the run long enough? */
 
-          /* Get the next entry from the GAT to support a 64 bit shift */
+      end = gran_next_used(priv, start, start + ngranules);
+      if (end == start + ngranules)
+        {
+          uintptr_t alloc = priv->heapstart + (start << priv->log2gran);
 
-          if (granidx < priv->ngranules)
-            {
-              next = priv->gat[gatidx + 1];
-            }
+          /* Yes.. mark these granules allocated */
 
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
+          gran_mark_allocated(priv, alloc, ngranules);
 
-          else
-            {
-              next = 0xffffffff;
-            }
+          /* And return the allocation address */
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          alloc = priv->heapstart + (granidx << priv->log2gran);
-
-          for (bitidx = 0;
-               bitidx < 32 &&
-               (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
-            {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
-
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Check if we have the allocation at this
-               * bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position and increment
-               * to the next candidate allocation address.
-               */
-
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
+          gran_leave_critical(priv);
+          return (FAR void *)alloc;
         }
-
-      gran_leave_critical(priv);
     }
 
+  gran_leave_critical(priv);
   return NULL;
 }
 
+/****************************************************************************
+ * Name: gran_alloc
+ *
+ * Description:
+ *   Allocate memory from the granule heap.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by gran_initialize
+ *   size   - The size of the memory region to allocate.
+ *
+ * Returned Value:
+ *   On success, a non-NULL pointer to the allocated memory is returned;
+ *   NULL is returned on failure.
+ *
+ ****************************************************************************/
+
+FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
+{
+  return gran_memalign(handle, 0, size);
+}
+
 #endif /* CONFIG_GRAN */
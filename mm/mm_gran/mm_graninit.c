@@ -84,10 +84,6 @@
  *   The actual memory allocates will be 64 byte (wasting 17 bytes) and
  *   will be aligned at least to (1 << log2align).
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   heapstart - Start of the granule allocation heap
  *   heapsize  - Size of heap in bytes
@@ -149,6 +145,7 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
       priv->log2gran  = log2gran;
       priv->ngranules = ngranules;
       priv->heapstart = alignedstart;
+      priv->summary   = &priv->gat[SIZEOF_GAT(ngranules)];
 
       /* Initialize mutual exclusion support */
 
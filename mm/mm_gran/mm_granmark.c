@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <assert.h>
 
 #include <nuttx/mm/gran.h>
@@ -48,77 +49,115 @@
 #ifdef CONFIG_GRAN
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: gran_mark_allocated
+ * Name: gran_mark
  *
  * Description:
- *   Mark a range of granules as allocated.
- *
- * Input Parameters:
- *   priv  - The granule heap state structure.
- *   alloc - The address of the allocation.
- *   ngranules - The number of granules allocated
- *
- * Returned Value:
- *   None
+ *   Set or clear the GAT bits of a range of granules, one GAT entry at a
+ *   time, and keep the summary of the fully allocated entries coherent.
  *
  ****************************************************************************/
 
-void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
-                         unsigned int ngranules)
+static void gran_mark(FAR struct gran_s *priv, uintptr_t alloc,
+                      unsigned int ngranules, bool allocated)
 {
   unsigned int granno;
   unsigned int gatidx;
   unsigned int gatbit;
-  unsigned int avail;
+  unsigned int nbits;
   uint32_t     gatmask;
+  uint32_t     summask;
 
   /* Determine the granule number of the allocation */
 
   granno = (alloc - priv->heapstart) >> priv->log2gran;
+  DEBUGASSERT(granno + ngranules <= priv->ngranules);
 
-  /* Determine the GAT table index associated with the allocation */
-
-  gatidx = granno >> 5;
-  gatbit = granno & 31;
-
-  /* Mark bits in the GAT entry or entries */
-
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  while (ngranules > 0)
     {
-      /* Mark bits in the first GAT entry */
-
-      gatmask = 0xffffffff << gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
-
-      priv->gat[gatidx] |= gatmask;
-      ngranules -= avail;
-
-      /* Mark bits in the second GAT entry */
-
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx + 1] & gatmask) == 0);
-
-      priv->gat[gatidx + 1] |= gatmask;
+      /* Determine the GAT table index and the bits of this entry */
+
+      gatidx  = granno >> 5;
+      gatbit  = granno & 31;
+      nbits   = 32 - gatbit;
+      if (nbits > ngranules)
+        {
+          nbits = ngranules;
+        }
+
+      gatmask = (0xffffffff >> (32 - nbits)) << gatbit;
+      summask = (uint32_t)1 << (gatidx & 31);
+
+      if (allocated)
+        {
+          DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
+          priv->gat[gatidx] |= gatmask;
+          if (priv->gat[gatidx] == 0xffffffff)
+            {
+              priv->summary[gatidx >> 5] |= summask;
+            }
+        }
+      else
+        {
+          DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
+          priv->gat[gatidx] &= ~gatmask;
+          priv->summary[gatidx >> 5] &= ~summask;
+        }
+
+      granno    += nbits;
+      ngranules -= nbits;
     }
+}
 
-  /* Handle the case where where all of the granules come from one entry */
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-  else
-    {
-      /* Mark bits in a single GAT entry */
+/****************************************************************************
+ * Name: gran_mark_allocated
+ *
+ * Description:
+ *   Mark a range of granules as allocated.
+ *
+ * Input Parameters:
+ *   priv  - The granule heap state structure.
+ *   alloc - The address of the allocation.
+ *   ngranules - The number of granules allocated
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
+void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
+                         unsigned int ngranules)
+{
+  gran_mark(priv, alloc, ngranules, true);
+}
 
-      priv->gat[gatidx] |= gatmask;
-      return;
-    }
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of granules as free.
+ *
+ * Input Parameters:
+ *   priv  - The granule heap state structure.
+ *   alloc - The address of the allocation.
+ *   ngranules - The number of granules allocated
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void gran_mark_free(FAR struct gran_s *priv, uintptr_t alloc,
+                    unsigned int ngranules)
+{
+  gran_mark(priv, alloc, ngranules, false);
 }
 
 #endif /* CONFIG_GRAN */
@@ -69,11 +69,22 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
   ndx = mm_size2ndx(node->size);
 
+#ifdef CONFIG_MM_TLSF
+  /* The lists are not sorted, the new node goes first */
+
+  prev = &heap->mm_nodelist[ndx];
+  next = prev->flink;
+
+  heap->mm_slbitmap[ndx >> MM_SLI_SHIFT] |=
+    (uint32_t)1 << (ndx & (MM_SLI_COUNT - 1));
+  heap->mm_flbitmap |= (uint32_t)1 << (ndx >> MM_SLI_SHIFT);
+#else
   /* Now put the new node into the next */
 
   for (prev = &heap->mm_nodelist[ndx], next = heap->mm_nodelist[ndx].flink;
        next && next->size && next->size < node->size;
        prev = next, next = next->flink);
+#endif
 
   /* Does it go in mid next or at the end? */
 
@@ -88,3 +99,45 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
       next->blink = node;
     }
 }
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the nodelist.  This must happen before the
+ *   size of the chunk is changed.  It is assumed that the caller holds the
+ *   mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  /* Remove the node.  There must be a predecessor, but there may not be
+   * a successor node.
+   */
+
+  DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+#ifdef CONFIG_MM_TLSF
+  else if (node->blink->size == 0)
+    {
+      /* That was the last node of its list */
+
+      int ndx = mm_size2ndx(node->size);
+      int fl  = ndx >> MM_SLI_SHIFT;
+
+      DEBUGASSERT(node->blink == &heap->mm_nodelist[ndx]);
+
+      heap->mm_slbitmap[fl] &= ~((uint32_t)1 << (ndx & (MM_SLI_COUNT - 1)));
+      if (heap->mm_slbitmap[fl] == 0)
+        {
+          heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+        }
+    }
+#endif
+}
@@ -0,0 +1,266 @@
+/****************************************************************************
+ * mm/mm_heap/mm_fastbin.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef MM_USE_FASTBINS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Map a chunk size (including the chunk header) to a size class */
+
+#define MM_FASTBIN_CLASS(s)  ((int)((s) >> MM_MIN_SHIFT) - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_fastbin_lock
+ *
+ * Description:
+ *   Get exclusive access to the fast bins of the current CPU.  Only local
+ *   interrupts are disabled; the spinlock is only contended when another
+ *   CPU is flushing the bins.
+ *
+ ****************************************************************************/
+
+static inline FAR struct mm_fastbin_s *
+mm_fastbin_lock(FAR struct mm_heap_s *heap, FAR irqstate_t *flags)
+{
+  FAR struct mm_fastbin_s *bin;
+
+  *flags = local_irq_save();
+  bin    = &heap->mm_fastbin[up_cpu_index()];
+
+#ifdef CONFIG_SMP
+  spin_lock(&bin->fb_lock);
+#endif
+
+  return bin;
+}
+
+/****************************************************************************
+ * Name: mm_fastbin_unlock
+ ****************************************************************************/
+
+static inline void mm_fastbin_unlock(FAR struct mm_fastbin_s *bin,
+                                     irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&bin->fb_lock);
+#endif
+
+  local_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_fastbin_alloc
+ *
+ * Description:
+ *   Take a cached chunk of exactly 'size' bytes (including the chunk
+ *   header) from the fast bins of the current CPU.
+ *
+ * Returned Value:
+ *   The user memory of the chunk or NULL if there is no cached chunk of
+ *   that size.
+ *
+ ****************************************************************************/
+
+FAR void *mm_fastbin_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_fastbin_s *bin;
+  FAR struct mm_delaynode_s *mem;
+  irqstate_t flags;
+  int ndx;
+
+  ndx = MM_FASTBIN_CLASS(size);
+  if (ndx < 0 || ndx >= CONFIG_MM_FASTBIN_NCLASSES)
+    {
+      return NULL;
+    }
+
+  bin = mm_fastbin_lock(heap, &flags);
+
+  mem = bin->fb_head[ndx];
+  if (mem != NULL)
+    {
+      bin->fb_head[ndx] = mem->flink;
+      bin->fb_count[ndx]--;
+    }
+
+  mm_fastbin_unlock(bin, flags);
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_fastbin_free
+ *
+ * Description:
+ *   Try to cache a chunk that is being freed in the fast bins of the
+ *   current CPU.  The chunk stays marked as allocated so that it is never
+ *   merged while it is in the bin.  This is safe in any context, including
+ *   the interrupt level.
+ *
+ * Returned Value:
+ *   True if the chunk was cached; false if it must be returned to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_fastbin_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_delaynode_s *entry = mem;
+  FAR struct mm_fastbin_s *bin;
+  irqstate_t flags;
+  bool cached = false;
+  int ndx;
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
+
+  ndx = MM_FASTBIN_CLASS(node->size);
+  if (ndx < 0 || ndx >= CONFIG_MM_FASTBIN_NCLASSES)
+    {
+      return false;
+    }
+
+  bin = mm_fastbin_lock(heap, &flags);
+
+  if (bin->fb_count[ndx] < CONFIG_MM_FASTBIN_DEPTH)
+    {
+      entry->flink      = bin->fb_head[ndx];
+      bin->fb_head[ndx] = entry;
+      bin->fb_count[ndx]++;
+      cached            = true;
+#ifdef CONFIG_MM_TRACE
+      node->caller      = NULL;
+#endif
+    }
+
+  mm_fastbin_unlock(bin, flags);
+  return cached;
+}
+
+/****************************************************************************
+ * Name: mm_fastbin_flush
+ *
+ * Description:
+ *   Return all chunks cached in the fast bins of every CPU to the heap so
+ *   that they can be merged with their free neighbors again.  This must be
+ *   called from task context.
+ *
+ * Returned Value:
+ *   The number of bytes that were returned to the heap.
+ *
+ ****************************************************************************/
+
+size_t mm_fastbin_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_delaynode_s *list;
+  FAR struct mm_delaynode_s *next;
+  FAR struct mm_fastbin_s *bin;
+  irqstate_t flags;
+  size_t nbytes = 0;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < MM_FASTBIN_NCPUS; cpu++)
+    {
+      bin = &heap->mm_fastbin[cpu];
+
+      for (ndx = 0; ndx < CONFIG_MM_FASTBIN_NCLASSES; ndx++)
+        {
+          /* Detach the whole bin, then free the chunks with interrupts
+           * enabled.
+           */
+
+          flags = local_irq_save();
+#ifdef CONFIG_SMP
+          spin_lock(&bin->fb_lock);
+#endif
+
+          list               = bin->fb_head[ndx];
+          bin->fb_head[ndx]  = NULL;
+          bin->fb_count[ndx] = 0;
+
+#ifdef CONFIG_SMP
+          spin_unlock(&bin->fb_lock);
+#endif
+          local_irq_restore(flags);
+
+          for (; list != NULL; list = next)
+            {
+              next    = list->flink;
+              nbytes += (size_t)(ndx + 1) << MM_MIN_SHIFT;
+              mm_free_uncached(heap, list);
+            }
+        }
+    }
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: mm_fastbin_cached
+ *
+ * Description:
+ *   Return the number of bytes currently held in the fast bins of all CPUs.
+ *   The value is a snapshot only.
+ *
+ ****************************************************************************/
+
+size_t mm_fastbin_cached(FAR struct mm_heap_s *heap)
+{
+  size_t nbytes = 0;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < MM_FASTBIN_NCPUS; cpu++)
+    {
+      for (ndx = 0; ndx < CONFIG_MM_FASTBIN_NCLASSES; ndx++)
+        {
+          nbytes += (size_t)heap->mm_fastbin[cpu].fb_count[ndx] *
+                    ((size_t)(ndx + 1) << MM_MIN_SHIFT);
+        }
+    }
+
+  return nbytes;
+}
+
+#endif /* MM_USE_FASTBINS */
@@ -71,15 +71,16 @@ static void mm_add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_free
+ * Name: mm_free_uncached
  *
  * Description:
  *   Returns a chunk of memory to the list of free nodes,  merging with
- *   adjacent free chunks if possible.
+ *   adjacent free chunks if possible.  Unlike mm_free(), the chunk is never
+ *   placed in the fast bins.
  *
  ****************************************************************************/
 
-void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+void mm_free_uncached(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   FAR struct mm_freenode_s *node;
   FAR struct mm_freenode_s *prev;
@@ -158,16 +159,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       andbeyond = (FAR struct mm_allocnode_s *)
                     ((FAR char *)next + next->size);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -185,16 +179,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   DEBUGASSERT((node->preceding & ~MM_ALLOC_BIT) == prev->size);
   if ((prev->preceding & MM_ALLOC_BIT) == 0)
     {
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the node */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -208,3 +195,30 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   mm_addfreechunk(heap, node);
   mm_givesemaphore(heap);
 }
+
+/****************************************************************************
+ * Name: mm_free
+ *
+ * Description:
+ *   Returns a chunk of memory to the list of free nodes,  merging with
+ *   adjacent free chunks if possible.  Small chunks may instead be kept in
+ *   the fast bins of the current CPU if CONFIG_MM_FASTBINS is enabled.
+ *
+ ****************************************************************************/
+
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#ifdef MM_USE_FASTBINS
+  /* Park small chunks in the fast bins.  This needs neither the heap
+   * semaphore nor the delay list, even at the interrupt level.
+   */
+
+  if (mem != NULL && mm_fastbin_free(heap, mem))
+    {
+      minfo("Cached %p\n", mem);
+      return;
+    }
+#endif
+
+  mm_free_uncached(heap, mem);
+}
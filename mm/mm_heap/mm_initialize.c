@@ -183,14 +183,28 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   heap->mm_delaylist = NULL;
 
+#ifdef CONFIG_MM_FASTBINS
+  /* Initialize the fast bins */
+
+  memset(heap->mm_fastbin, 0, sizeof(heap->mm_fastbin));
+#endif
+
   /* Initialize the node array */
 
   memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
+#ifdef CONFIG_MM_TLSF
+  /* Separate lists, all empty */
+
+  UNUSED(i);
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+#else
   for (i = 1; i < MM_NNODES; i++)
     {
       heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
     }
+#endif
 
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
@@ -114,12 +114,14 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 #endif
               DEBUGASSERT(node->size >= SIZEOF_MM_FREENODE);
               DEBUGASSERT(fnode->blink->flink == fnode);
-              DEBUGASSERT(fnode->blink->size <= fnode->size);
               DEBUGASSERT(fnode->flink == NULL ||
                           fnode->flink->blink == fnode);
+#ifndef CONFIG_MM_TLSF
+              DEBUGASSERT(fnode->blink->size <= fnode->size);
               DEBUGASSERT(fnode->flink == NULL ||
                           fnode->flink->size == 0 ||
                           fnode->flink->size >= fnode->size);
+#endif
               ordblks++;
               fordblks += node->size;
               if (node->size > mxordblk)
@@ -152,5 +154,10 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
   info->mxordblk = mxordblk;
   info->uordblks = uordblks;
   info->fordblks = fordblks;
+#ifdef MM_USE_FASTBINS
+  info->fbcached = mm_fastbin_cached(heap);
+#else
+  info->fbcached = 0;
+#endif
   return OK;
 }
@@ -136,10 +136,49 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(alignsize >= MM_MIN_CHUNK);
   DEBUGASSERT(alignsize >= SIZEOF_MM_FREENODE);
 
+#ifdef MM_USE_FASTBINS
+  /* Try the fast bins of this CPU first.  No semaphore is needed. */
+
+  ret = mm_fastbin_alloc(heap, alignsize);
+  if (ret != NULL)
+    {
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, alignsize - SIZEOF_MM_ALLOCNODE);
+#endif
+      minfo("Allocated %p, size %d (cached)\n", ret, alignsize);
+      return MM_TRACE(ret);
+    }
+#endif
+
   /* We need to hold the MM semaphore while we muck with the nodelist. */
 
   mm_takesemaphore(heap);
 
+#ifdef CONFIG_MM_TLSF
+  /* Find a list that holds chunks large enough in constant time.  Only
+   * the list of the biggest chunks has to be searched.
+   */
+
+  ndx  = mm_findndx(heap, alignsize);
+  node = NULL;
+
+  if (ndx >= 0)
+    {
+      for (node = heap->mm_nodelist[ndx].flink;
+           node && node->size < alignsize;
+           node = node->flink)
+        {
+          /* Below 2 * MM_MAX_CHUNK, mm_findndx() rounds the size up to the
+           * next list boundary, so every chunk of the list it returns is
+           * big enough.  Only the last list, which holds every chunk of
+           * 2 * MM_MAX_CHUNK and more and is returned for all bigger
+           * requests, can have chunks that are too small.
+           */
+
+          DEBUGASSERT(ndx == MM_NNODES - 1);
+        }
+    }
+#else
   /* Get the location in the node list to start the search. Special case
    * really big allocations
    */
@@ -166,6 +205,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     {
       DEBUGASSERT(node->blink->flink == node);
     }
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
@@ -178,16 +218,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -247,6 +280,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
    * to the SYSLOG.
    */
 
+#ifdef MM_USE_FASTBINS
+  /* Chunks parked in the fast bins cannot be merged.  Return them to the
+   * heap and try again before giving up.
+   */
+
+  if (ret == NULL && mm_fastbin_flush(heap) > 0)
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
 #ifdef CONFIG_DEBUG_MM
   if (!ret)
     {
@@ -258,5 +302,5 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
-  return ret;
+  return MM_TRACE(ret);
 }
@@ -208,5 +208,5 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 
   mm_givesemaphore(heap);
-  return (FAR void *)alignedchunk;
+  return MM_TRACE((FAR void *)alignedchunk);
 }
@@ -45,7 +45,7 @@
 #include <assert.h>
 #include <debug.h>
 
-#include <nuttx/semaphore.h>
+#include <nuttx/mutex.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_SMP
@@ -64,6 +64,11 @@
  *
  * See additional definitions in include/nuttx/semaphore.h
  *
+ * For the same reason the heap mutex is taken through its underlying
+ * semaphore rather than with nxmutex_lock().  The semaphore still carries
+ * PRIOINHERIT_FLAGS_MUTEX, so the OS tracks its single holder in O(1)
+ * whichever interface is used.
+ *
  * REVISIT:  The fact that sem_wait() is a cancellation point is an issue
  * and does cause a violation:  It makes all of the memory management
  * interfaces into cancellation points when used from user space in the
@@ -110,11 +115,11 @@
 
 void mm_seminitialize(FAR struct mm_heap_s *heap)
 {
-  /* Initialize the MM semaphore to one (to support one-at-a-time access to
-   * private data sets).
+  /* Initialize the MM mutex (to support one-at-a-time access to private
+   * data sets).  The mutex is recursive on top of the count kept here.
    */
 
-  nxsem_init(&heap->mm_semaphore, 0, 1);
+  nxmutex_init(&heap->mm_lock);
 
   heap->mm_holder      = NO_HOLDER;
   heap->mm_counts_held = 0;
@@ -191,7 +196,7 @@ int mm_trysemaphore(FAR struct mm_heap_s *heap)
     {
       /* Try to take the semaphore */
 
-      ret = _SEM_TRYWAIT(&heap->mm_semaphore);
+      ret = _SEM_TRYWAIT(&heap->mm_lock.sem);
       if (ret < 0)
         {
           _SEM_GETERROR(ret);
@@ -247,7 +252,7 @@ void mm_takesemaphore(FAR struct mm_heap_s *heap)
       mseminfo("PID=%d taking\n", my_pid);
       do
         {
-          ret = _SEM_WAIT(&heap->mm_semaphore);
+          ret = _SEM_WAIT(&heap->mm_lock.sem);
 
           /* The only case that an error should occur here is if the wait
            * was awakened by a signal.
@@ -318,7 +323,7 @@ void mm_givesemaphore(FAR struct mm_heap_s *heap)
 
       heap->mm_holder      = NO_HOLDER;
       heap->mm_counts_held = 0;
-      DEBUGVERIFY(_SEM_POST(&heap->mm_semaphore));
+      DEBUGVERIFY(_SEM_POST(&heap->mm_lock.sem));
     }
 
 #ifdef CONFIG_SMP
@@ -39,6 +39,9 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <assert.h>
+
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
@@ -53,6 +56,27 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_TLSF
+int mm_size2ndx(size_t size)
+{
+  int fl;
+
+  if (size >= ((size_t)MM_MAX_CHUNK << 1))
+    {
+      return MM_NNODES - 1;
+    }
+
+  /* The first level is the power of two, the second level the next
+   * MM_SLI_SHIFT bits below it.
+   */
+
+  DEBUGASSERT(size >= MM_MIN_CHUNK);
+  fl = 31 - __builtin_clz((uint32_t)size);
+
+  return ((fl - MM_MIN_SHIFT) << MM_SLI_SHIFT) +
+         (int)((size >> (fl - MM_SLI_SHIFT)) & (MM_SLI_COUNT - 1));
+}
+#else
 int mm_size2ndx(size_t size)
 {
   int ndx = 0;
@@ -71,3 +95,57 @@ int mm_size2ndx(size_t size)
 
   return ndx;
 }
+#endif
+
+#ifdef CONFIG_MM_TLSF
+/****************************************************************************
+ * Name: mm_findndx
+ *
+ * Description:
+ *    Return the index of a non-empty nodelist entry all of whose chunks are
+ *    at least 'size' bytes, or -1 if there is none.  The last entry, that
+ *    holds all of the biggest chunks, may be returned for any size and its
+ *    chunks must then be checked.  It is assumed that the caller holds the
+ *    mm semaphore.
+ *
+ ****************************************************************************/
+
+int mm_findndx(FAR struct mm_heap_s *heap, size_t size)
+{
+  uint32_t bits;
+  int ndx;
+  int fl;
+
+  /* Round the size up to the next list boundary, so that any chunk of the
+   * list will do.
+   */
+
+  if (size < ((size_t)MM_MAX_CHUNK << 1))
+    {
+      fl    = 31 - __builtin_clz((uint32_t)size);
+      size += ((size_t)1 << (fl - MM_SLI_SHIFT)) - 1;
+    }
+
+  ndx = mm_size2ndx(size);
+  fl  = ndx >> MM_SLI_SHIFT;
+
+  /* Look for a non-empty list of the same power of two first, then for
+   * the smallest one of the bigger powers of two.
+   */
+
+  bits = heap->mm_slbitmap[fl] & (UINT32_MAX << (ndx & (MM_SLI_COUNT - 1)));
+  if (bits == 0)
+    {
+      bits = heap->mm_flbitmap & (UINT32_MAX << (fl + 1));
+      if (bits == 0)
+        {
+          return -1;
+        }
+
+      fl   = __builtin_ctz(bits);
+      bits = heap->mm_slbitmap[fl];
+    }
+
+  return (fl << MM_SLI_SHIFT) + __builtin_ctz(bits);
+}
+#endif
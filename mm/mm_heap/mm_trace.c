@@ -0,0 +1,189 @@
+/****************************************************************************
+ * mm/mm_heap/mm_trace.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TRACE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_trace_account
+ *
+ * Description:
+ *   Add one allocated chunk to the caller table, an open addressing hash
+ *   on the call site and thread.
+ *
+ ****************************************************************************/
+
+static void mm_trace_account(FAR struct mm_traceinfo_s *info,
+                             FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_tracecaller_s *entry;
+  uintptr_t hash;
+  int i;
+
+  if (info->ncallers > 0)
+    {
+      hash = ((uintptr_t)node->caller >> 2) ^ node->pid;
+
+      for (i = 0; i < info->ncallers; i++)
+        {
+          entry = &info->callers[(hash + i) % info->ncallers];
+          if (entry->count == 0)
+            {
+              entry->caller = node->caller;
+              entry->pid    = node->pid;
+              info->nused++;
+            }
+          else if (entry->caller != node->caller || entry->pid != node->pid)
+            {
+              continue;
+            }
+
+          entry->count++;
+          entry->size += node->size;
+          return;
+        }
+    }
+
+  info->nother++;
+  info->sother += node->size;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_trace
+ *
+ * Description:
+ *   Record the calling thread and the allocation site in the header of the
+ *   chunk returned by an allocator.  Use it through MM_TRACE().
+ *
+ * Returned Value:
+ *   mem, which may be NULL.
+ *
+ ****************************************************************************/
+
+FAR void *mm_trace(FAR void *mem, FAR void *caller)
+{
+  FAR struct mm_allocnode_s *node;
+
+  if (mem != NULL)
+    {
+      node = (FAR struct mm_allocnode_s *)
+             ((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+      node->pid    = getpid();
+      node->caller = caller;
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_traceinfo
+ *
+ * Description:
+ *   Walk the heap, grouping the allocated chunks by call site and thread
+ *   in info->callers and counting the free chunks per mm_nodelist bin.
+ *   callers[] and ncallers must be set by the caller; the rest of info is
+ *   overwritten.
+ *
+ ****************************************************************************/
+
+int mm_traceinfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_traceinfo_s *info)
+{
+  FAR struct mm_allocnode_s *node;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(info != NULL);
+
+  memset(info->callers, 0, info->ncallers * sizeof(*info->callers));
+  info->nused   = 0;
+  info->nother  = 0;
+  info->sother  = 0;
+  info->ncached = 0;
+  info->scached = 0;
+  memset(info->nfree, 0, sizeof(info->nfree));
+  memset(info->sfree, 0, sizeof(info->sfree));
+
+  /* Visit each region, retaking the semaphore for each one to reduce
+   * latencies.  The first node of a region is the guard, skip it.
+   */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      mm_takesemaphore(heap);
+
+      for (node = (FAR struct mm_allocnode_s *)
+                  ((FAR char *)heap->mm_heapstart[region] +
+                   heap->mm_heapstart[region]->size);
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)
+                  ((FAR char *)node + node->size))
+        {
+          if ((node->preceding & MM_ALLOC_BIT) == 0)
+            {
+              int ndx = mm_size2ndx(node->size);
+
+              info->nfree[ndx]++;
+              info->sfree[ndx] += node->size;
+            }
+          else if (node->caller == NULL)
+            {
+              info->ncached++;
+              info->scached += node->size;
+            }
+          else
+            {
+              mm_trace_account(info, node);
+            }
+        }
+
+      mm_givesemaphore(heap);
+    }
+
+#undef region
+  return OK;
+}
+
+#endif /* CONFIG_MM_TRACE */
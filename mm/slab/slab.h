@@ -0,0 +1,113 @@
+/****************************************************************************
+ * mm/slab/slab.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_SLAB_SLAB_H
+#define __MM_SLAB_SLAB_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/mm/slab.h>
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define SLAB_NCPUS     CONFIG_SMP_NCPUS
+#else
+#  define SLAB_NCPUS     1
+#endif
+
+/* Objects are aligned like kmm_malloc() memory and must hold the link of
+ * the free lists.
+ */
+
+#define SLAB_ALIGN       8
+#define SLAB_ALIGN_UP(s) (((s) + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1))
+
+/* Magazines are refilled from and spilled to the shared free list in
+ * batches of half of their size so that a CPU alternating between
+ * allocations and frees does not bounce between an empty and a full
+ * magazine.
+ */
+
+#define SLAB_DEPTH       CONFIG_MM_SLAB_MAGAZINE
+#define SLAB_BATCH       ((SLAB_DEPTH + 1) / 2)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A free object, linked through its first word */
+
+struct kmem_freeobj_s
+{
+  FAR struct kmem_freeobj_s *flink;
+};
+
+/* The magazine of one CPU.  It is only accessed from the CPU that owns it
+ * with local interrupts disabled.
+ */
+
+struct kmem_magazine_s
+{
+  FAR struct kmem_freeobj_s *km_head; /* Cached free objects */
+  uint16_t km_count;                  /* Number of objects in km_head */
+  uint32_t km_allocs;                 /* Successful allocations */
+  uint32_t km_hits;                   /* Allocations served from km_head */
+};
+
+struct kmem_cache_s
+{
+  FAR struct kmem_cache_s *kc_flink;  /* Previously created cache */
+  FAR const char *kc_name;            /* For /proc/slabinfo */
+  size_t kc_objsize;                  /* Aligned object size */
+  unsigned int kc_nperslab;           /* Objects per slab */
+
+  /* The following are protected by the critical section */
+
+  FAR struct kmem_freeobj_s *kc_freelist;
+  size_t kc_nfree;                    /* Objects in kc_freelist */
+  size_t kc_ntotal;                   /* Objects in all slabs */
+  size_t kc_nslabs;                   /* Number of slabs */
+  uint32_t kc_nfails;                 /* Failed allocations */
+
+  struct kmem_magazine_s kc_mag[SLAB_NCPUS];
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* All caches, most recently created first */
+
+extern FAR struct kmem_cache_s *g_kmem_caches;
+
+#endif /* CONFIG_MM_SLAB */
+#endif /* __MM_SLAB_SLAB_H */
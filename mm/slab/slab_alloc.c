@@ -0,0 +1,219 @@
+/****************************************************************************
+ * mm/slab/slab_alloc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_pop
+ *
+ * Description:
+ *   Remove the object at the head of a magazine, if any.  Local interrupts
+ *   must be disabled.
+ *
+ ****************************************************************************/
+
+static FAR void *slab_pop(FAR struct kmem_magazine_s *mag)
+{
+  FAR struct kmem_freeobj_s *obj = mag->km_head;
+
+  if (obj != NULL)
+    {
+      mag->km_head = obj->flink;
+      mag->km_count--;
+      mag->km_allocs++;
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: slab_grow
+ *
+ * Description:
+ *   Allocate a new slab from the kernel heap.  The first object is returned
+ *   to the caller, the others are added to the shared free list.
+ *
+ ****************************************************************************/
+
+static FAR void *slab_grow(FAR struct kmem_cache_s *cache)
+{
+  FAR struct kmem_freeobj_s *first;
+  FAR struct kmem_freeobj_s *last;
+  FAR char *slab;
+  irqstate_t flags;
+  unsigned int i;
+
+  if (up_interrupt_context())
+    {
+      return NULL;
+    }
+
+  slab = kmm_malloc(cache->kc_objsize * cache->kc_nperslab);
+  if (slab == NULL)
+    {
+      return NULL;
+    }
+
+  /* Chain the objects after the first one */
+
+  first = (FAR struct kmem_freeobj_s *)(slab + cache->kc_objsize);
+  last  = first;
+
+  for (i = 2; i < cache->kc_nperslab; i++)
+    {
+      last->flink = (FAR struct kmem_freeobj_s *)
+                    (slab + i * cache->kc_objsize);
+      last        = last->flink;
+    }
+
+  flags = enter_critical_section();
+
+  if (cache->kc_nperslab > 1)
+    {
+      last->flink        = cache->kc_freelist;
+      cache->kc_freelist = first;
+      cache->kc_nfree   += cache->kc_nperslab - 1;
+    }
+
+  cache->kc_ntotal += cache->kc_nperslab;
+  cache->kc_nslabs++;
+  cache->kc_mag[up_cpu_index()].km_allocs++;
+
+  leave_critical_section(flags);
+  return slab;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_alloc
+ *
+ * Description:
+ *   Allocate one object.  See include/nuttx/mm/slab.h.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache)
+{
+  FAR struct kmem_magazine_s *mag;
+  FAR void *obj;
+  irqstate_t flags;
+
+  DEBUGASSERT(cache != NULL);
+
+  /* Fast path:  Take an object from the magazine of this CPU */
+
+  flags = local_irq_save();
+  mag   = &cache->kc_mag[up_cpu_index()];
+  obj   = slab_pop(mag);
+  if (obj != NULL)
+    {
+      mag->km_hits++;
+    }
+
+  local_irq_restore(flags);
+
+  if (obj == NULL)
+    {
+      /* Slow path:  Move a batch of objects from the shared free list into
+       * the magazine under a single critical section.  The CPU may have
+       * changed, so look up the magazine again.
+       */
+
+      flags = enter_critical_section();
+      mag   = &cache->kc_mag[up_cpu_index()];
+
+      while (mag->km_count < SLAB_BATCH && cache->kc_freelist != NULL)
+        {
+          FAR struct kmem_freeobj_s *tmp = cache->kc_freelist;
+
+          cache->kc_freelist = tmp->flink;
+          cache->kc_nfree--;
+
+          tmp->flink    = mag->km_head;
+          mag->km_head  = tmp;
+          mag->km_count++;
+        }
+
+      obj = slab_pop(mag);
+      leave_critical_section(flags);
+
+      /* Still nothing?  Then add a slab */
+
+      if (obj == NULL)
+        {
+          obj = slab_grow(cache);
+          if (obj == NULL)
+            {
+              flags = enter_critical_section();
+              cache->kc_nfails++;
+              leave_critical_section(flags);
+
+              mwarn("WARNING: Cache %s is exhausted\n", cache->kc_name);
+            }
+        }
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_zalloc
+ *
+ * Description:
+ *   Allocate one zeroed object.  See include/nuttx/mm/slab.h.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache)
+{
+  FAR void *obj = kmem_cache_alloc(cache);
+
+  if (obj != NULL)
+    {
+      memset(obj, 0, cache->kc_objsize);
+    }
+
+  return obj;
+}
+
+#endif /* CONFIG_MM_SLAB */
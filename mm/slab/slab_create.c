@@ -0,0 +1,101 @@
+/****************************************************************************
+ * mm/slab/slab_create.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *g_kmem_caches;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of one size.  See include/nuttx/mm/slab.h.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size,
+                                           unsigned int nperslab)
+{
+  FAR struct kmem_cache_s *cache;
+  irqstate_t flags;
+
+  DEBUGASSERT(name != NULL && size > 0 && nperslab > 0);
+
+  cache = kmm_zalloc(sizeof(struct kmem_cache_s));
+  if (cache == NULL)
+    {
+      merr("ERROR: Failed to create cache %s\n", name);
+      return NULL;
+    }
+
+  if (size < sizeof(struct kmem_freeobj_s))
+    {
+      size = sizeof(struct kmem_freeobj_s);
+    }
+
+  cache->kc_name     = name;
+  cache->kc_objsize  = SLAB_ALIGN_UP(size);
+  cache->kc_nperslab = nperslab;
+
+  flags = enter_critical_section();
+  cache->kc_flink = g_kmem_caches;
+  g_kmem_caches   = cache;
+  leave_critical_section(flags);
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_next
+ *
+ * Description:
+ *   Enumerate the caches.  See include/nuttx/mm/slab.h.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_next(FAR struct kmem_cache_s *cache)
+{
+  return cache == NULL ? g_kmem_caches : cache->kc_flink;
+}
+
+#endif /* CONFIG_MM_SLAB */
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * mm/slab/slab_free.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Return an object to its cache.  See include/nuttx/mm/slab.h.
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj)
+{
+  FAR struct kmem_freeobj_s *freeobj = obj;
+  FAR struct kmem_magazine_s *mag;
+  irqstate_t flags;
+  bool cached = false;
+
+  DEBUGASSERT(cache != NULL);
+
+  if (obj == NULL)
+    {
+      return;
+    }
+
+  /* Fast path:  Put the object in the magazine of this CPU */
+
+  flags = local_irq_save();
+  mag   = &cache->kc_mag[up_cpu_index()];
+  if (mag->km_count < SLAB_DEPTH)
+    {
+      freeobj->flink = mag->km_head;
+      mag->km_head   = freeobj;
+      mag->km_count++;
+      cached         = true;
+    }
+
+  local_irq_restore(flags);
+
+  if (!cached)
+    {
+      /* Slow path:  The magazine is full.  Move the object and a batch of
+       * the magazine to the shared free list.
+       */
+
+      flags = enter_critical_section();
+      mag   = &cache->kc_mag[up_cpu_index()];
+
+      freeobj->flink     = cache->kc_freelist;
+      cache->kc_freelist = freeobj;
+      cache->kc_nfree++;
+
+      while (mag->km_count > SLAB_DEPTH - SLAB_BATCH)
+        {
+          freeobj            = mag->km_head;
+          mag->km_head       = freeobj->flink;
+          mag->km_count--;
+
+          freeobj->flink     = cache->kc_freelist;
+          cache->kc_freelist = freeobj;
+          cache->kc_nfree++;
+        }
+
+      leave_critical_section(flags);
+    }
+}
+
+#endif /* CONFIG_MM_SLAB */
@@ -0,0 +1,70 @@
+/****************************************************************************
+ * mm/slab/slab_info.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_info
+ *
+ * Description:
+ *   Return the state of a cache.  See include/nuttx/mm/slab.h.
+ *
+ ****************************************************************************/
+
+void kmem_cache_info(FAR struct kmem_cache_s *cache,
+                     FAR struct kmem_cacheinfo_s *info)
+{
+  int cpu;
+
+  DEBUGASSERT(cache != NULL && info != NULL);
+
+  info->name    = cache->kc_name;
+  info->objsize = cache->kc_objsize;
+  info->nslabs  = cache->kc_nslabs;
+  info->ntotal  = cache->kc_ntotal;
+  info->nfree   = cache->kc_nfree;
+  info->nfails  = cache->kc_nfails;
+  info->ncached = 0;
+  info->nallocs = 0;
+  info->nhits   = 0;
+
+  for (cpu = 0; cpu < SLAB_NCPUS; cpu++)
+    {
+      info->ncached += cache->kc_mag[cpu].km_count;
+      info->nallocs += cache->kc_mag[cpu].km_allocs;
+      info->nhits   += cache->kc_mag[cpu].km_hits;
+    }
+}
+
+#endif /* CONFIG_MM_SLAB */
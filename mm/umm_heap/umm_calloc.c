@@ -80,11 +80,11 @@ FAR void *calloc(size_t n, size_t elem_size)
         }
     }
 
-  return ret;
+  return MM_TRACE(ret);
 
 #else
   /* Use mm_calloc() because it implements the clear */
 
-  return mm_calloc(USR_HEAP, n, elem_size);
+  return MM_TRACE(mm_calloc(USR_HEAP, n, elem_size));
 #endif
 }
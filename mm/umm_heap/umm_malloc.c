@@ -100,8 +100,8 @@ FAR void *malloc(size_t size)
     }
   while (mem == NULL);
 
-  return mem;
+  return MM_TRACE(mem);
 #else
-  return mm_malloc(USR_HEAP, size);
+  return MM_TRACE(mm_malloc(USR_HEAP, size));
 #endif
 }
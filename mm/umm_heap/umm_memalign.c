@@ -94,8 +94,8 @@ FAR void *memalign(size_t alignment, size_t size)
     }
   while (mem == NULL);
 
-  return mem;
+  return MM_TRACE(mem);
 #else
-  return mm_memalign(USR_HEAP, alignment, size);
+  return MM_TRACE(mm_memalign(USR_HEAP, alignment, size));
 #endif
 }
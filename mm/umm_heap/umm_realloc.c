@@ -102,8 +102,8 @@ FAR void *realloc(FAR void *oldmem, size_t size)
     }
   while (mem == NULL);
 
-  return mem;
+  return MM_TRACE(mem);
 #else
-  return mm_realloc(USR_HEAP, oldmem, size);
+  return MM_TRACE(mm_realloc(USR_HEAP, oldmem, size));
 #endif
 }
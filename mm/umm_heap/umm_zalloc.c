@@ -75,11 +75,11 @@ FAR void *zalloc(size_t size)
        memset(alloc, 0, size);
     }
 
-  return alloc;
+  return MM_TRACE(alloc);
 
 #else
   /* Use mm_zalloc() because it implements the clear */
 
-  return mm_zalloc(USR_HEAP, size);
+  return MM_TRACE(mm_zalloc(USR_HEAP, size));
 #endif
 }
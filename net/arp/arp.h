@@ -167,6 +167,22 @@ struct arp_notify_s
  ****************************************************************************/
 
 #ifdef CONFIG_NET_ARP
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table.  Called once from net_initialize().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arp_initialize(void);
+
 /****************************************************************************
  * Name: arp_format
  *
@@ -466,6 +482,7 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 
 /* If ARP is disabled, stub out all ARP interfaces */
 
+#  define arp_initialize()
 #  define arp_format(d,i);
 #  define arp_send(i) (0)
 #  define arp_poll(d,c) (0)
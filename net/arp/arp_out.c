@@ -263,6 +263,7 @@ void arp_out(FAR struct net_driver_s *dev)
 
       arp_format(dev, ipaddr);
       arp_dump(ARPBUF);
+      NETDEV_TXDROP(dev, NETDEV_TXDROP_NEIGHBOR);
       return;
     }
 
@@ -49,12 +49,15 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <string.h>
+#include <queue.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <netinet/in.h>
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -72,10 +75,41 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#ifndef CONFIG_NET_ARPTAB_NBUCKETS
+#  define CONFIG_NET_ARPTAB_NBUCKETS 4
+#endif
+
+/* Expired entries are reclaimed by a work item that runs four times per
+ * maximum entry age.  Without a work queue, expired entries are simply
+ * ignored on lookup until they are reused.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+#  define ARP_AGING 1
+#  define ARP_AGE_TICK (ARP_MAXAGE_TICK / 4 + 1)
+#  ifdef CONFIG_SCHED_LPWORK
+#    define ARPWORK LPWORK
+#  else
+#    define ARPWORK HPWORK
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One ARP table entry.  Every entry is in either the free list or the LRU
+ * list (least recently used first); entries in the LRU list are also in
+ * the hash chain selected by their IP address.
+ */
+
+struct arp_table_entry_s
+{
+  dq_entry_t ae_node;                     /* Free or LRU list link */
+  FAR struct arp_table_entry_s *ae_flink; /* Next entry in the hash chain */
+  struct arp_entry_s ae_entry;            /* The address mapping */
+};
+
 struct arp_table_info_s
 {
   in_addr_t              ai_ipaddr;   /* IP address for lookup */
@@ -88,7 +122,22 @@ struct arp_table_info_s
 
 /* The table of known address mappings */
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_table_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+
+/* The heads of the hash chains */
+
+static FAR struct arp_table_entry_s *g_arphash[CONFIG_NET_ARPTAB_NBUCKETS];
+
+/* The list of unused entries and the LRU list of entries in use */
+
+static dq_queue_t g_arpfree;
+static dq_queue_t g_arplru;
+
+#ifdef ARP_AGING
+/* Work item used to discard expired entries */
+
+static struct work_s g_arpwork;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -141,38 +190,140 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Return the hash chain for an IPv4 address.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_table_entry_s **arp_hash(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_arphash[hash % CONFIG_NET_ARPTAB_NBUCKETS];
+}
+
+/****************************************************************************
+ * Name: arp_search
+ *
+ * Description:
+ *   Find the entry for an IPv4 address, whether or not it has expired.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_table_entry_s *arp_search(in_addr_t ipaddr)
+{
+  FAR struct arp_table_entry_s *entry;
+
+  for (entry = *arp_hash(ipaddr); entry != NULL; entry = entry->ae_flink)
     {
-      return e1;
+      if (net_ipv4addr_cmp(ipaddr, entry->ae_entry.at_ipaddr))
+        {
+          return entry;
+        }
     }
-  else if (e2->at_ipaddr == 0)
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_free
+ *
+ * Description:
+ *   Remove an entry from its hash chain and from the LRU list and return
+ *   it to the free list.
+ *
+ ****************************************************************************/
+
+static void arp_free(FAR struct arp_table_entry_s *entry)
+{
+  FAR struct arp_table_entry_s **prev;
+
+  for (prev = arp_hash(entry->ae_entry.at_ipaddr); *prev != NULL;
+       prev = &(*prev)->ae_flink)
     {
-      return e2;
+      if (*prev == entry)
+        {
+          *prev = entry->ae_flink;
+          break;
+        }
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  entry->ae_flink = NULL;
+  entry->ae_entry.at_ipaddr = 0;
+
+  dq_rem(&entry->ae_node, &g_arplru);
+  dq_addlast(&entry->ae_node, &g_arpfree);
+}
+
+/****************************************************************************
+ * Name: arp_age_work
+ *
+ * Description:
+ *   Discard entries that have expired.  Runs periodically on the work
+ *   queue while the table is not empty so that expired entries are
+ *   reclaimed without any cost on the lookup path.
+ *
+ ****************************************************************************/
+
+#ifdef ARP_AGING
+static void arp_age_work(FAR void *arg)
+{
+  FAR struct arp_table_entry_s *entry;
+  FAR dq_entry_t *next;
+  clock_t now;
+
+  net_lock();
+
+  now = clock_systime_ticks();
+  for (entry = (FAR struct arp_table_entry_s *)dq_peek(&g_arplru);
+       entry != NULL;
+       entry = (FAR struct arp_table_entry_s *)next)
     {
-      return e1;
+      next = dq_next(&entry->ae_node);
+      if (now - entry->ae_entry.at_time > ARP_MAXAGE_TICK)
+        {
+          arp_free(entry);
+        }
     }
-  else
+
+  if (!dq_empty(&g_arplru))
     {
-      return e2;
+      work_queue(ARPWORK, &g_arpwork, arp_age_work, NULL, ARP_AGE_TICK);
     }
+
+  net_unlock();
 }
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table.  Called once from net_initialize().
+ *
+ ****************************************************************************/
+
+void arp_initialize(void)
+{
+  int i;
+
+  dq_init(&g_arpfree);
+  dq_init(&g_arplru);
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
+    {
+      dq_addlast(&g_arptable[i].ae_node, &g_arpfree);
+    }
+}
+
 /****************************************************************************
  * Name: arp_update
  *
@@ -195,43 +346,57 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_table_entry_s **head;
+  FAR struct arp_table_entry_s *entry;
+
+  if (ipaddr == 0)
+    {
+      return -EINVAL;
+    }
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the ARP table, reusing the least
+   * recently used entry if the table is full.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  entry = arp_search(ipaddr);
+  if (entry != NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      dq_rem(&entry->ae_node, &g_arplru);
+    }
+  else
+    {
+      if (dq_empty(&g_arpfree))
         {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-          break;
+          arp_free((FAR struct arp_table_entry_s *)dq_peek(&g_arplru));
         }
-      else
-        {
-          /* Record the oldest entry. */
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+      entry = (FAR struct arp_table_entry_s *)dq_remfirst(&g_arpfree);
+
+      head                      = arp_hash(ipaddr);
+      entry->ae_flink           = *head;
+      *head                     = entry;
+      entry->ae_entry.at_ipaddr = ipaddr;
+
+#ifdef ARP_AGING
+      /* Start aging if it is not already running */
+
+      if (work_available(&g_arpwork))
+        {
+          work_queue(ARPWORK, &g_arpwork, arp_age_work, NULL,
+                     ARP_AGE_TICK);
         }
+#endif
     }
 
-  /* Now, tabptr is the ARP table entry which we will fill with the new
-   * information.
+  /* Fill the entry with the new information and make it the most recently
+   * used.
    */
 
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = clock_systime_ticks();
+  memcpy(entry->ae_entry.at_ethaddr.ether_addr_octet, ethaddr,
+         ETHER_ADDR_LEN);
+  entry->ae_entry.at_time = clock_systime_ticks();
+  dq_addlast(&entry->ae_node, &g_arplru);
   return OK;
 }
 
@@ -281,24 +446,24 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_table_entry_s *entry;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check if the IPv4 address is already in the ARP table.  An entry that
+   * has expired but not yet been reclaimed is treated as not found.
+   */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  entry = arp_search(ipaddr);
+  if (entry == NULL ||
+      clock_systime_ticks() - entry->ae_entry.at_time > ARP_MAXAGE_TICK)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return NULL;
     }
 
-  /* Not found */
+  /* Make this the most recently used entry */
 
-  return NULL;
+  dq_rem(&entry->ae_node, &g_arplru);
+  dq_addlast(&entry->ae_node, &g_arplru);
+  return &entry->ae_entry;
 }
 
 /****************************************************************************
@@ -380,16 +545,16 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
 
 void arp_delete(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_table_entry_s *entry;
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr);
-  if (tabptr != NULL)
+  entry = arp_search(ipaddr);
+  if (entry != NULL)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Return the entry to the free list */
 
-      tabptr->at_ipaddr = 0;
+      arp_free(entry);
     }
 }
 
@@ -417,22 +582,21 @@ void arp_delete(in_addr_t ipaddr)
 unsigned int arp_snapshot(FAR struct arp_entry_s *snapshot,
                           unsigned int nentries)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_table_entry_s *entry;
   clock_t now;
   unsigned int ncopied;
-  int i;
 
-  /* Copy all non-empty, non-expired entries in the ARP table. */
+  /* Copy all non-expired entries in the ARP table. */
 
-  for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
-       i++)
+  for (entry = (FAR struct arp_table_entry_s *)dq_peek(&g_arplru),
+       now = clock_systime_ticks(), ncopied = 0;
+       nentries > ncopied && entry != NULL;
+       entry = (FAR struct arp_table_entry_s *)dq_next(&entry->ae_node))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr != 0 &&
-          now - tabptr->at_time <= ARP_MAXAGE_TICK)
+      if (now - entry->ae_entry.at_time <= ARP_MAXAGE_TICK)
         {
-          memcpy(&snapshot[ncopied], tabptr, sizeof(struct arp_entry_s));
+          memcpy(&snapshot[ncopied], &entry->ae_entry,
+                 sizeof(struct arp_entry_s));
           ncopied++;
         }
     }
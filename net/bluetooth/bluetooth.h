@@ -321,6 +321,32 @@ ssize_t bluetooth_recvfrom(FAR struct socket *psock, FAR void *buf,
                            size_t len, int flags, FAR struct sockaddr *from,
                            FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: bluetooth_recviob
+ *
+ * Description:
+ *   Implements psock_recviob() for Bluetooth sockets:  Lend the I/O buffer
+ *   holding the next received frame to the caller.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      Location to return the I/O buffer
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the frame.  Otherwise, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t bluetooth_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags, FAR struct sockaddr *from,
+                          FAR socklen_t *fromlen);
+#endif
+
 /****************************************************************************
  * Name: bluetooth_find_device
  *
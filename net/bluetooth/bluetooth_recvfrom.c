@@ -59,6 +59,9 @@ struct bluetooth_recvfrom_s
   FAR struct devif_callback_s *ir_cb;  /* Reference to callback instance */
   FAR struct sockaddr *ir_from;        /* Location to return the from address */
   FAR uint8_t *ir_buffer;              /* Pointer to receive buffer */
+#ifdef CONFIG_NET_RECVIOB
+  FAR struct iob_s **ir_iob;           /* Location to lend the frame */
+#endif
   size_t ir_buflen;                    /* Length of receive buffer */
   sem_t ir_sem;                        /* Semaphore signals recv completion */
   ssize_t ir_result;                   /* Success:size, failure:negated errno */
@@ -161,10 +164,34 @@ static ssize_t
       container->bn_iob = NULL;
       DEBUGASSERT(iob != NULL);
 
-      /* Copy the new packet data into the user buffer */
+      /* The frame holds io_len - io_offset bytes of L2CAP payload */
 
       copylen = iob->io_len - iob->io_offset;
-      memcpy(pstate->ir_buffer, &iob->io_data[iob->io_offset], copylen);
+
+#ifdef CONFIG_NET_RECVIOB
+      if (pstate->ir_iob != NULL)
+        {
+          /* Lend the IOB to the caller, with the lengths following the
+           * usual IOB convention that io_len excludes the offset.
+           */
+
+          iob->io_len       = copylen;
+          iob->io_pktlen    = copylen;
+          *pstate->ir_iob   = iob;
+          iob               = NULL;
+        }
+      else
+#endif
+        {
+          /* Copy the new packet data into the user buffer */
+
+          if (copylen > pstate->ir_buflen)
+            {
+              copylen = pstate->ir_buflen;
+            }
+
+          memcpy(pstate->ir_buffer, &iob->io_data[iob->io_offset], copylen);
+        }
 
       ninfo("Received %d bytes\n", (int)copylen);
       ret = copylen;
@@ -183,7 +210,11 @@ static ssize_t
 
       /* Free both the IOB and the container */
 
-      iob_free(iob, IOBUSER_NET_SOCK_BLUETOOTH);
+      if (iob != NULL)
+        {
+          iob_free(iob, IOBUSER_NET_SOCK_BLUETOOTH);
+        }
+
       bluetooth_container_free(container);
     }
 
@@ -268,62 +299,33 @@ static uint16_t bluetooth_recvfrom_eventhandler(FAR struct net_driver_s *dev,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: bluetooth_recvfrom
+ * Name: bluetooth_recvframe
  *
  * Description:
- *   Implements the socket recvfrom interface for the case of the AF_INET
- *   and AF_INET6 address families.  bluetooth_recvfrom() receives messages
- *   from a socket, and may be used to receive data on a socket whether or
- *   not it is connection-oriented.
- *
- *   If 'from' is not NULL, and the underlying protocol provides the source
- *   address, this source address is filled in.  The argument 'fromlen' is
- *   initialized to the size of the buffer associated with from, and
- *   modified on return to indicate the actual size of the address stored
- *   there.
+ *   Take the next frame from the RX queue of the socket, waiting for one
+ *   if necessary.  What is done with the frame is described by 'pstate':
+ *   It is either copied to the user buffer or lent to the caller.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Buffer to receive data
- *   len      Length of buffer
+ *   pstate   The initialized receive state
  *   flags    Receive flags
- *   from     Address of source (may be NULL)
- *   fromlen  The length of the address structure
  *
  * Returned Value:
- *   On success, returns the number of characters received.  If no data is
- *   available to be received and the peer has performed an orderly shutdown,
- *   recv() will return 0.  Otherwise, on errors, a negated errno value is
- *   returned (see recvfrom() for the list of appropriate error values).
- *
- * Assumptions:
- *   The network is locked.
+ *   On success, returns the number of bytes received.  Otherwise, a
+ *   negated errno value is returned.
  *
  ****************************************************************************/
 
-ssize_t bluetooth_recvfrom(FAR struct socket *psock, FAR void *buf,
-                            size_t len, int flags, FAR struct sockaddr *from,
-                            FAR socklen_t *fromlen)
+static ssize_t bluetooth_recvframe(FAR struct socket *psock,
+                                   FAR struct bluetooth_recvfrom_s *pstate,
+                                   int flags)
 {
   FAR struct bluetooth_conn_s *conn =
     (FAR struct bluetooth_conn_s *)psock->s_conn;
   FAR struct radio_driver_s *radio;
-  struct bluetooth_recvfrom_s state;
   ssize_t ret;
 
-  /* If a 'from' address has been provided, verify that it is large
-   * enough to hold this address family.
-   */
-
-  if (from != NULL && *fromlen < sizeof(struct sockaddr_l2))
-    {
-      return -EINVAL;
-    }
-
   if (psock->s_type != SOCK_RAW)
     {
       nerr("ERROR: Unsupported socket type: %d\n", psock->s_type);
@@ -332,17 +334,8 @@ ssize_t bluetooth_recvfrom(FAR struct socket *psock, FAR void *buf,
 
   /* Perform the packet recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network
-   * locked because we don't want anything to happen until we are ready.
-   */
-
   net_lock();
-  memset(&state, 0, sizeof(struct bluetooth_recvfrom_s));
-
-  state.ir_buflen = len;
-  state.ir_buffer = buf;
-  state.ir_sock   = psock;
-  state.ir_from   = from;
+  pstate->ir_sock = psock;
 
   /* Get the device driver that will service this transfer */
 
@@ -357,7 +350,7 @@ ssize_t bluetooth_recvfrom(FAR struct socket *psock, FAR void *buf,
    * waiting in the RX queue.
    */
 
-  ret = bluetooth_recvfrom_rxqueue(radio, &state);
+  ret = bluetooth_recvfrom_rxqueue(radio, pstate);
   if (ret > 0)
     {
       /* Good newe!  We have a frame and we are done. */
@@ -366,21 +359,27 @@ ssize_t bluetooth_recvfrom(FAR struct socket *psock, FAR void *buf,
       return ret;
     }
 
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+    {
+      ret = -EAGAIN;
+      goto errout_with_lock;
+    }
+
   /* We will have to wait.  This semaphore is used for signaling and,
    * hence, should not have priority inheritance enabled.
    */
 
-  nxsem_init(&state.ir_sem, 0, 0); /* Doesn't really fail */
-  nxsem_set_protocol(&state.ir_sem, SEM_PRIO_NONE);
+  nxsem_init(&pstate->ir_sem, 0, 0); /* Doesn't really fail */
+  nxsem_set_protocol(&pstate->ir_sem, SEM_PRIO_NONE);
 
   /* Set up the callback in the connection */
 
-  state.ir_cb = bluetooth_callback_alloc(&radio->r_dev, conn);
-  if (state.ir_cb)
+  pstate->ir_cb = bluetooth_callback_alloc(&radio->r_dev, conn);
+  if (pstate->ir_cb)
     {
-      state.ir_cb->flags  = (BLUETOOTH_NEWDATA | BLUETOOTH_POLL);
-      state.ir_cb->priv   = (FAR void *)&state;
-      state.ir_cb->event  = bluetooth_recvfrom_eventhandler;
+      pstate->ir_cb->flags  = (BLUETOOTH_NEWDATA | BLUETOOTH_POLL);
+      pstate->ir_cb->priv   = (FAR void *)pstate;
+      pstate->ir_cb->event  = bluetooth_recvfrom_eventhandler;
 
       /* Wait for either the receive to complete or for an error/timeout to
        * occur. NOTES:  (1) net_lockedwait will also terminate if a signal
@@ -388,23 +387,131 @@ ssize_t bluetooth_recvfrom(FAR struct socket *psock, FAR void *buf,
        * the task sleeps and automatically re-locked when the task restarts.
        */
 
-      net_lockedwait(&state.ir_sem);
+      net_lockedwait(&pstate->ir_sem);
 
       /* Make sure that no further events are processed */
 
-      bluetooth_callback_free(&radio->r_dev, conn, state.ir_cb);
-      ret = state.ir_result;
+      bluetooth_callback_free(&radio->r_dev, conn, pstate->ir_cb);
+      ret = pstate->ir_result;
     }
   else
     {
       ret = -EBUSY;
     }
 
-  nxsem_destroy(&state.ir_sem);
+  nxsem_destroy(&pstate->ir_sem);
 
 errout_with_lock:
   net_unlock();
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bluetooth_recvfrom
+ *
+ * Description:
+ *   Implements the socket recvfrom interface for the case of the AF_INET
+ *   and AF_INET6 address families.  bluetooth_recvfrom() receives messages
+ *   from a socket, and may be used to receive data on a socket whether or
+ *   not it is connection-oriented.
+ *
+ *   If 'from' is not NULL, and the underlying protocol provides the source
+ *   address, this source address is filled in.  The argument 'fromlen' is
+ *   initialized to the size of the buffer associated with from, and
+ *   modified on return to indicate the actual size of the address stored
+ *   there.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly shutdown,
+ *   recv() will return 0.  Otherwise, on errors, a negated errno value is
+ *   returned (see recvfrom() for the list of appropriate error values).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t bluetooth_recvfrom(FAR struct socket *psock, FAR void *buf,
+                            size_t len, int flags, FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
+{
+  struct bluetooth_recvfrom_s state;
+
+  /* If a 'from' address has been provided, verify that it is large
+   * enough to hold this address family.
+   */
+
+  if (from != NULL && *fromlen < sizeof(struct sockaddr_l2))
+    {
+      return -EINVAL;
+    }
+
+  memset(&state, 0, sizeof(struct bluetooth_recvfrom_s));
+
+  state.ir_buflen = len;
+  state.ir_buffer = buf;
+  state.ir_from   = from;
+
+  return bluetooth_recvframe(psock, &state, flags);
+}
+
+/****************************************************************************
+ * Name: bluetooth_recviob
+ *
+ * Description:
+ *   Implements psock_recviob() for Bluetooth sockets:  Remove the next
+ *   frame from the RX queue and lend its I/O buffer to the caller without
+ *   copying it.  The L2CAP payload starts at io_offset and is io_len
+ *   bytes long.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      Location to return the I/O buffer
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the frame.  Otherwise, a
+ *   negated errno value is returned.  The caller must release the buffer
+ *   with iob_free(iob, IOBUSER_NET_SOCK_BLUETOOTH).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t bluetooth_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags, FAR struct sockaddr *from,
+                          FAR socklen_t *fromlen)
+{
+  struct bluetooth_recvfrom_s state;
+
+  DEBUGASSERT(iob != NULL);
+
+  if (from != NULL && *fromlen < sizeof(struct sockaddr_l2))
+    {
+      return -EINVAL;
+    }
+
+  memset(&state, 0, sizeof(struct bluetooth_recvfrom_s));
+
+  state.ir_iob  = iob;
+  state.ir_from = from;
+
+  return bluetooth_recvframe(psock, &state, flags);
+}
+#endif
+
 #endif /* CONFIG_NET_BLUETOOTH */
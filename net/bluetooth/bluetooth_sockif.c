@@ -99,6 +99,12 @@ const struct sock_intf_s g_bluetooth_sockif =
   NULL,                  /* si_sendmsg */
 #endif
   bluetooth_close        /* si_close */
+#ifdef CONFIG_NET_RECVIOB
+#ifdef CONFIG_NET_USRSOCK
+  , NULL                 /* si_ioctl */
+#endif
+  , bluetooth_recviob    /* si_recviob */
+#endif
 };
 
 /****************************************************************************
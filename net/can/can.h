@@ -439,6 +439,46 @@ int can_getsockopt(FAR struct socket *psock, int option,
                    FAR void *value, FAR socklen_t *value_len);
 #endif
 
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check a received CAN ID against the CAN_RAW_FILTER set of a connection.
+ *
+ * Returned Value:
+ *   Non-zero if the frame is to be delivered to the connection; zero if it
+ *   is to be dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id);
+#endif
+
+/****************************************************************************
+ * Name: can_hwfilter_update
+ *
+ * Description:
+ *   Program the RX acceptance filters of a CAN controller with the union
+ *   of the CAN_RAW_FILTER sets of all connections that may receive from it.
+ *   This must be called whenever a filter set, a binding or the set of
+ *   connections changes.
+ *
+ * Input Parameters:
+ *   dev - The CAN device to update, or NULL to update all CAN devices
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  A driver
+ *   without hardware filters is not a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+int can_hwfilter_update(FAR struct net_driver_s *dev);
+#else
+#  define can_hwfilter_update(dev) OK
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
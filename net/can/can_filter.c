@@ -0,0 +1,294 @@
+/****************************************************************************
+ * net/can/can_filter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ioctl.h>
+#include <nuttx/net/can.h>
+
+#include "netdev/netdev.h"
+#include "can/can.h"
+
+#if defined(CONFIG_NET_CAN) && defined(CONFIG_NET_CANPROTO_OPTIONS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+/* A filter that passes every frame */
+
+static const struct can_filter g_can_catchall =
+{
+  0, 0
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_hwfilter_program
+ *
+ * Description:
+ *   Collect the union of the filter sets of all connections that receive
+ *   from 'dev' and pass it to the driver.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+static int can_hwfilter_program(FAR struct net_driver_s *dev)
+{
+  FAR struct can_conn_s *conn = NULL;
+  FAR struct can_filter *filters;
+  struct can_hwfilter_s req;
+  bool catchall = false;
+  int nfilters = 0;
+  int ret;
+  int i;
+  int j;
+
+  if (dev->d_lltype != NET_LL_CAN || dev->d_ioctl == NULL)
+    {
+      return OK;
+    }
+
+  /* If the set cannot be collected, let the software filters do the job */
+
+  filters = (FAR struct can_filter *)
+    kmm_malloc(CONFIG_CAN_CONNS * CONFIG_NET_CAN_RAW_FILTER_MAX *
+               sizeof(struct can_filter));
+  if (filters == NULL)
+    {
+      catchall = true;
+    }
+
+  while (!catchall && (conn = can_nextconn(conn)) != NULL)
+    {
+      /* An unbound connection receives from all devices */
+
+      if (conn->dev != NULL && conn->dev != dev)
+        {
+          continue;
+        }
+
+      for (i = 0; i < conn->filter_count; i++)
+        {
+          FAR const struct can_filter *filter = &conn->filters[i];
+
+          /* An inverted filter cannot be expressed as an acceptance filter
+           * and a zero mask passes everything anyway.
+           */
+
+          if ((filter->can_id & CAN_INV_FILTER) != 0 ||
+              filter->can_mask == 0)
+            {
+              catchall = true;
+              break;
+            }
+
+          /* Sockets listening to the same IDs need only one entry */
+
+          for (j = 0; j < nfilters; j++)
+            {
+              if (filters[j].can_id == filter->can_id &&
+                  filters[j].can_mask == filter->can_mask)
+                {
+                  break;
+                }
+            }
+
+          if (j == nfilters)
+            {
+              filters[nfilters++] = *filter;
+            }
+        }
+    }
+
+  if (catchall)
+    {
+      req.cf_filters  = &g_can_catchall;
+      req.cf_nfilters = 1;
+    }
+  else
+    {
+      req.cf_filters  = filters;
+      req.cf_nfilters = nfilters;
+    }
+
+  ret = dev->d_ioctl(dev, SIOCSCANFILTER, (unsigned long)(uintptr_t)&req);
+  if (ret == -ENOSPC && !catchall)
+    {
+      /* Too many filters for the controller */
+
+      ninfo("%s: %d filters do not fit, passing all frames\n",
+            dev->d_ifname, nfilters);
+
+      req.cf_filters  = &g_can_catchall;
+      req.cf_nfilters = 1;
+
+      ret = dev->d_ioctl(dev, SIOCSCANFILTER,
+                         (unsigned long)(uintptr_t)&req);
+    }
+
+  if (filters != NULL)
+    {
+      kmm_free(filters);
+    }
+
+  /* The driver has no hardware filters.  Nothing is lost:  all frames are
+   * still filtered in software.
+   */
+
+  if (ret == -ENOTTY)
+    {
+      ret = OK;
+    }
+
+  if (ret < 0)
+    {
+      nerr("ERROR: %s: Failed to set RX filters: %d\n",
+           dev->d_ifname, ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_callback
+ *
+ * Description:
+ *   netdev_foreach() callback:  Update one device, remembering the last
+ *   failure without stopping the traversal.
+ *
+ ****************************************************************************/
+
+static int can_hwfilter_callback(FAR struct net_driver_s *dev,
+                                 FAR void *arg)
+{
+  FAR int *result = (FAR int *)arg;
+  int ret;
+
+  ret = can_hwfilter_program(dev);
+  if (ret < 0)
+    {
+      *result = ret;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check a received CAN ID against the CAN_RAW_FILTER set of a connection.
+ *
+ * Returned Value:
+ *   Non-zero if the frame is to be delivered to the connection; zero if it
+ *   is to be dropped.
+ *
+ ****************************************************************************/
+
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
+{
+  uint32_t i;
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (conn->filters[i].can_id & CAN_INV_FILTER)
+        {
+          if ((id & conn->filters[i].can_mask) !=
+                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
+                conn->filters[i].can_mask))
+            {
+              return 1;
+            }
+        }
+      else
+        {
+          if ((id & conn->filters[i].can_mask) ==
+                (conn->filters[i].can_id & conn->filters[i].can_mask))
+            {
+              return 1;
+            }
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_update
+ *
+ * Description:
+ *   Program the RX acceptance filters of a CAN controller with the union
+ *   of the CAN_RAW_FILTER sets of all connections that may receive from it.
+ *
+ * Input Parameters:
+ *   dev - The CAN device to update, or NULL to update all CAN devices
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+int can_hwfilter_update(FAR struct net_driver_s *dev)
+{
+  int ret = OK;
+
+  net_lock();
+  if (dev != NULL)
+    {
+      ret = can_hwfilter_program(dev);
+    }
+  else
+    {
+      netdev_foreach(can_hwfilter_callback, &ret);
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_NET_CAN && CONFIG_NET_CANPROTO_OPTIONS */
@@ -26,6 +26,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_CAN)
 
+#include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -135,7 +136,9 @@ const uint8_t len_to_can_dlc[65] =
  * Name: can_input
  *
  * Description:
- *   Handle incoming packet input
+ *   Handle incoming packet input.  The frame is delivered to every
+ *   connection that receives from the device and whose CAN_RAW_FILTER set
+ *   accepts it.
  *
  * Input Parameters:
  *   dev - The device driver structure containing the received packet
@@ -154,24 +157,43 @@ const uint8_t len_to_can_dlc[65] =
 int can_input(struct net_driver_s *dev)
 {
   FAR struct can_conn_s *conn = NULL;
+  uint16_t buflen = dev->d_len;
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+  canid_t id = ((FAR struct can_frame *)dev->d_buf)->can_id;
+#endif
+  bool delivered = false;
   int ret = OK;
 
-  do
+  while ((conn = can_nextconn(conn)) != NULL)
     {
-      /* FIXME Support for multiple sockets??? */
+      uint16_t flags;
 
-      conn = can_nextconn(conn);
-    }
-  while (conn && conn->dev != 0 && dev != conn->dev);
+      /* An unbound connection receives from all devices */
 
-  if (conn)
-    {
-      uint16_t flags;
+      if (conn->dev != NULL && conn->dev != dev)
+        {
+          continue;
+        }
 
-      /* Setup for the application callback */
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+      /* Apply the receive filters before the frame is copied anywhere, so
+       * that rejected frames never occupy read-ahead buffers.
+       */
+
+      if (can_recv_filter(conn, id) == 0)
+        {
+          continue;
+        }
+#endif
+
+      /* Setup for the application callback.  The previous callback may
+       * have consumed the frame (or appended a timestamp to it).
+       */
 
       dev->d_appdata = dev->d_buf;
+      dev->d_len     = buflen;
       dev->d_sndlen  = 0;
+      delivered      = true;
 
       /* Perform the application callback */
 
@@ -193,11 +215,13 @@ int can_input(struct net_driver_s *dev)
            ret = -EAGAIN;
         }
     }
-  else
+
+  if (!delivered)
     {
       ninfo("No CAN listener\n");
     }
 
+  dev->d_len = 0;
   return ret;
 }
 
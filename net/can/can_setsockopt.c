@@ -115,6 +115,13 @@ int can_setsockopt(FAR struct socket *psock, int option,
 
             ret = OK;
           }
+
+        /* Let the controller drop what no socket wants any longer */
+
+        if (ret == OK)
+          {
+            ret = can_hwfilter_update(conn->dev);
+          }
         break;
 
       case CAN_RAW_ERR_FILTER:
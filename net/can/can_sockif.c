@@ -365,7 +365,9 @@ static int can_bind(FAR struct socket *psock,
   conn->dev = netdev_findbyname((const char *)&netdev_name);
 #endif
 
-  return OK;
+  /* The filters of the socket now apply to a different set of devices */
+
+  return can_hwfilter_update(NULL);
 }
 
 /****************************************************************************
@@ -816,6 +818,9 @@ static ssize_t can_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 static int can_close(FAR struct socket *psock)
 {
   FAR struct can_conn_s *conn = psock->s_conn;
+#ifdef CONFIG_NET_CAN_HWFILTER
+  FAR struct net_driver_s *dev = conn->dev;
+#endif
   int ret = OK;
 
   /* Perform some pre-close operations for the CAN socket type. */
@@ -835,6 +840,12 @@ static int can_close(FAR struct socket *psock)
       conn->crefs = 0;
       can_free(psock->s_conn);
 
+      /* The filters of the connection no longer count */
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+      can_hwfilter_update(dev);
+#endif
+
       if (ret < 0)
         {
           /* Return with error code, but free resources. */
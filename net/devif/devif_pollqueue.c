@@ -0,0 +1,177 @@
+/****************************************************************************
+ * net/devif/devif_pollqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+
+#ifdef CONFIG_NETDEV_TXQUEUE
+
+#if CONFIG_IOB_NCHAINS < 1
+#  error CONFIG_NETDEV_TXQUEUE requires CONFIG_IOB_NCHAINS > 0
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_queue_callback
+ *
+ * Description:
+ *   devif_poll() callback that moves the frame in d_buf to the TX queue of
+ *   the device.
+ *
+ * Returned Value:
+ *   Non-zero to stop polling when the queue is full or no I/O buffers are
+ *   available.
+ *
+ ****************************************************************************/
+
+static int devif_queue_callback(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob;
+  int ret;
+
+  if (dev->d_len == 0)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_ETHERNET
+  /* Look up the destination MAC address and add it to the Ethernet
+   * header.
+   */
+
+  if (dev->d_lltype == NET_LL_ETHERNET)
+    {
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (IFF_IS_IPv4(dev->d_flags))
+#endif
+        {
+          arp_out(dev);
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          neighbor_out(dev);
+        }
+#endif /* CONFIG_NET_IPv6 */
+    }
+#endif /* CONFIG_NET_ETHERNET */
+
+  /* Frames sent to the device itself never reach the driver */
+
+  if (devif_loopback(dev))
+    {
+      return 0;
+    }
+
+  iob = iob_tryalloc(false, IOBUSER_NET_TXQUEUE);
+  if (iob == NULL)
+    {
+      goto errout;
+    }
+
+  ret = iob_trycopyin(iob, dev->d_buf, dev->d_len, 0, false,
+                      IOBUSER_NET_TXQUEUE);
+  if (ret < 0)
+    {
+      goto errout_with_iob;
+    }
+
+  ret = iob_tryadd_queue(iob, dev->d_txq);
+  if (ret < 0)
+    {
+      goto errout_with_iob;
+    }
+
+  dev->d_len = 0;
+  dev->d_txqcount++;
+  return dev->d_txqcount >= dev->d_txqmax;
+
+errout_with_iob:
+  iob_free_chain(iob, IOBUSER_NET_TXQUEUE);
+
+errout:
+  nwarn("WARNING: No I/O buffers for the TX queue\n");
+  NETDEV_TXERRORS(dev);
+  NETDEV_TXDROP(dev, NETDEV_TXDROP_NOBUFS);
+  dev->d_len = 0;
+  return 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_poll_queue
+ *
+ * Description:
+ *   Poll the connections and collect up to 'maxframes' outgoing frames in
+ *   'txq'.  See include/nuttx/net/netdev.h.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int devif_poll_queue(FAR struct net_driver_s *dev,
+                     FAR struct iob_queue_s *txq, int maxframes)
+{
+  DEBUGASSERT(dev != NULL && txq != NULL);
+
+  if (maxframes <= 0)
+    {
+      return 0;
+    }
+
+  dev->d_txq      = txq;
+  dev->d_txqcount = 0;
+  dev->d_txqmax   = maxframes > UINT16_MAX ? UINT16_MAX : maxframes;
+
+  devif_poll(dev, devif_queue_callback);
+
+  dev->d_txq = NULL;
+  return dev->d_txqcount;
+}
+
+#endif /* CONFIG_NETDEV_TXQUEUE */
@@ -360,6 +360,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
 #endif
       nwarn("WARNING: Invalid IP version or header length: %02x\n",
             ipv4->vhl);
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_HEADER);
       goto drop;
     }
 
@@ -369,6 +370,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
   if ((llhdrlen + IPv4_HDRLEN) > dev->d_len)
     {
       nwarn("WARNING: Packet shorter than IPv4 header\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_HEADER);
       goto drop;
     }
 
@@ -389,6 +391,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
   else
     {
       nwarn("WARNING: IP packet shorter than length in IP header\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_HEADER);
       goto drop;
     }
 
@@ -406,6 +409,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
           g_netstats.ipv4.fragerr++;
 #endif
           nwarn("WARNING: IP fragment dropped\n");
+          NETDEV_RXDROP(dev, NETDEV_RXDROP_FRAGMENT);
           goto drop;
         }
     }
@@ -439,6 +443,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
   if (net_ipv4addr_cmp(dev->d_ipaddr, INADDR_ANY))
     {
       nwarn("WARNING: No IP address assigned\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_ADDRESS);
       goto drop;
     }
   else
@@ -514,12 +519,13 @@ int ipv4_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_STATISTICS
               g_netstats.ipv4.drop++;
 #endif
+              NETDEV_RXDROP(dev, NETDEV_RXDROP_ADDRESS);
               goto drop;
             }
         }
     }
 
-  if (ipv4_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCHKSUM_OFFLOAD(dev) && ipv4_chksum(dev) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
@@ -528,6 +534,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
       g_netstats.ipv4.chkerr++;
 #endif
       nwarn("WARNING: Bad IP checksum\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_CHKSUM);
       goto drop;
     }
 
@@ -576,6 +583,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
 #endif
 
         nwarn("WARNING: Unrecognized IP protocol\n");
+        NETDEV_RXDROP(dev, NETDEV_RXDROP_PROTOCOL);
         goto drop;
     }
 
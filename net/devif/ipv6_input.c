@@ -303,6 +303,7 @@ int ipv6_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv6.vhlerr++;
 #endif
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_HEADER);
       goto drop;
     }
 
@@ -312,6 +313,7 @@ int ipv6_input(FAR struct net_driver_s *dev)
   if ((llhdrlen + IPv6_HDRLEN) > dev->d_len)
     {
       nwarn("WARNING: Packet shorter than IPv6 header\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_HEADER);
       goto drop;
     }
 
@@ -351,6 +353,7 @@ int ipv6_input(FAR struct net_driver_s *dev)
   else
     {
       nwarn("WARNING: IP packet shorter than length in IP header\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_HEADER);
       goto drop;
     }
 
@@ -420,6 +423,7 @@ int ipv6_input(FAR struct net_driver_s *dev)
   if (net_ipv6addr_cmp(dev->d_ipv6addr, g_ipv6_unspecaddr))
     {
       nwarn("WARNING: No IP address assigned\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_ADDRESS);
       goto drop;
     }
 
@@ -453,6 +457,7 @@ int ipv6_input(FAR struct net_driver_s *dev)
               /* Not destined for us and not forwardable... drop the packet. */
 
               nwarn("WARNING: Not destined for us; not forwardable... Dropping!\n");
+              NETDEV_RXDROP(dev, NETDEV_RXDROP_ADDRESS);
               goto drop;
             }
         }
@@ -553,6 +558,7 @@ int ipv6_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_STATISTICS
         g_netstats.ipv6.protoerr++;
 #endif
+        NETDEV_RXDROP(dev, NETDEV_RXDROP_PROTOCOL);
         goto drop;
     }
 
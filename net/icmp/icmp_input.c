@@ -365,6 +365,7 @@ typeerr:
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.icmp.typeerr++;
 #endif
+  NETDEV_RXDROP(dev, NETDEV_RXDROP_PROTOCOL);
 
 #ifdef CONFIG_NET_ICMP_SOCKET
 drop:
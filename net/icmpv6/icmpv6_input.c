@@ -581,6 +581,7 @@ icmpv6_type_error:
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.icmpv6.typeerr++;
 #endif
+  NETDEV_RXDROP(dev, NETDEV_RXDROP_PROTOCOL);
 
 icmpv6_drop_packet:
 #ifdef CONFIG_NET_STATISTICS
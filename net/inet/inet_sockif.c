@@ -94,6 +94,11 @@ static ssize_t    inet_sendfile(FAR struct socket *psock,
 static ssize_t    inet_recvfrom(FAR struct socket *psock, FAR void *buf,
                     size_t len, int flags, FAR struct sockaddr *from,
                     FAR socklen_t *fromlen);
+#ifdef CONFIG_NET_RECVIOB
+static ssize_t    inet_recviob(FAR struct socket *psock,
+                    FAR struct iob_s **iob, int flags,
+                    FAR struct sockaddr *from, FAR socklen_t *fromlen);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -122,6 +127,12 @@ static const struct sock_intf_s g_inet_sockif =
   NULL,             /* si_sendmsg */
 #endif
   inet_close        /* si_close */
+#ifdef CONFIG_NET_RECVIOB
+#ifdef CONFIG_NET_USRSOCK
+  , NULL            /* si_ioctl */
+#endif
+  , inet_recviob    /* si_recviob */
+#endif
 };
 
 /****************************************************************************
@@ -1394,6 +1405,50 @@ static ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_recviob
+ *
+ * Description:
+ *   Implements psock_recviob() for TCP and UDP sockets:  Lend the next
+ *   read-ahead I/O buffer chain to the caller.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   iob     - Location to return the I/O buffer chain
+ *   flags   - Receive flags
+ *   from    - Address of source (may be NULL)
+ *   fromlen - The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the chain.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+static ssize_t inet_recviob(FAR struct socket *psock,
+                            FAR struct iob_s **iob, int flags,
+                            FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
+{
+  switch (psock->s_type)
+    {
+#ifdef NET_TCP_HAVE_STACK
+    case SOCK_STREAM:
+      return psock_tcp_recviob(psock, iob, flags);
+#endif
+
+#ifdef NET_UDP_HAVE_STACK
+    case SOCK_DGRAM:
+      return psock_udp_recviob(psock, iob, flags, from, fromlen);
+#endif
+
+    default:
+      return -EOPNOTSUPP;
+    }
+}
+#endif
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
@@ -45,6 +45,14 @@
 #include <stdint.h>
 
 #undef HAVE_FWDALLOC
+#undef HAVE_FWDFLOWCACHE
+
+#if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv4) && \
+    defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && \
+    CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+#  define HAVE_FWDFLOWCACHE 1
+#endif
+
 #ifdef CONFIG_NET_IPFORWARD
 
 /****************************************************************************
@@ -57,6 +65,10 @@
 #  define CONFIG_NET_IPFORWARD_NSTRUCT 4
 #endif
 
+#ifndef CONFIG_NET_IPFORWARD_FLOWTIMEOUT
+#  define CONFIG_NET_IPFORWARD_FLOWTIMEOUT 10
+#endif
+
 /* Allocate a new IP forwarding data callback */
 
 #define ipfwd_callback_alloc(dev)   devif_callback_alloc(dev, &(dev)->d_conncb)
@@ -375,5 +387,46 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flow_resolve
+ *
+ * Description:
+ *   Return the device that an IPv4 packet should be forwarded through.  The
+ *   flow cache is checked first, keyed by the addresses, the protocol and
+ *   (for TCP and UDP) the ports of the packet.  On a miss, the device is
+ *   found with netdev_findby_ripv4addr() and remembered for the following
+ *   packets of the flow.
+ *
+ * Input Parameters:
+ *   ipv4 - The IPv4 header of the packet to be forwarded
+ *
+ * Returned Value:
+ *   The forwarding device, or NULL if the packet is not routable.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_FWDFLOWCACHE
+FAR struct net_driver_s *ipv4_flow_resolve(FAR struct ipv4_hdr_s *ipv4);
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flowflush
+ *
+ * Description:
+ *   Discard all of the flow cache.  This must be called whenever the routes
+ *   change or a network device is unregistered.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_FWDFLOWCACHE
+void ipfwd_flowflush(void);
+#else
+#  define ipfwd_flowflush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -0,0 +1,192 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
+
+#include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
+
+#ifdef HAVE_FWDFLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLOW_TIMEOUT_TICK SEC2TICK(CONFIG_NET_IPFORWARD_FLOWTIMEOUT)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry in the flow cache.  An entry is unused when fl_dev is NULL. */
+
+struct ipfwd_flow_s
+{
+  FAR struct net_driver_s *fl_dev; /* Forwarding device */
+  in_addr_t fl_srcipaddr;          /* Source IPv4 address */
+  in_addr_t fl_destipaddr;         /* Destination IPv4 address */
+  uint32_t  fl_ports;              /* Source and destination ports */
+  uint8_t   fl_proto;              /* IP protocol */
+  clock_t   fl_time;               /* Time when the flow was resolved */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ipfwd_flow_s g_ipfwd_flows[CONFIG_NET_IPFORWARD_FLOWCACHE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_ports
+ *
+ * Description:
+ *   Return the TCP or UDP ports of a packet, or zero for other protocols and
+ *   for fragments that do not hold the transport header.
+ *
+ ****************************************************************************/
+
+static uint32_t ipv4_flow_ports(FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR const uint8_t *l4hdr;
+
+  if (ipv4->proto != IP_PROTO_TCP && ipv4->proto != IP_PROTO_UDP)
+    {
+      return 0;
+    }
+
+  if ((ipv4->ipoffset[0] & 0x1f) != 0 || ipv4->ipoffset[1] != 0)
+    {
+      return 0;
+    }
+
+  /* Both TCP and UDP headers begin with the source and destination ports */
+
+  l4hdr = (FAR const uint8_t *)ipv4 + ((ipv4->vhl & IPv4_HLMASK) << 2);
+  return ((uint32_t)l4hdr[0] << 24) | ((uint32_t)l4hdr[1] << 16) |
+         ((uint32_t)l4hdr[2] << 8) | l4hdr[3];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_resolve
+ *
+ * Description:
+ *   Return the device that an IPv4 packet should be forwarded through,
+ *   using the flow cache when possible.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *ipv4_flow_resolve(FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipfwd_flow_s *flow;
+  FAR struct net_driver_s *fwddev;
+  in_addr_t srcipaddr;
+  in_addr_t destipaddr;
+  uint32_t ports;
+  uint32_t hash;
+  clock_t now;
+
+  srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  ports      = ipv4_flow_ports(ipv4);
+
+  hash  = srcipaddr ^ (destipaddr * 0x9e3779b1u) ^ ports ^ ipv4->proto;
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3bu;
+  hash ^= hash >> 16;
+
+  flow = &g_ipfwd_flows[hash % CONFIG_NET_IPFORWARD_FLOWCACHE];
+  now  = clock_systime_ticks();
+
+  if (flow->fl_dev != NULL &&
+      net_ipv4addr_cmp(flow->fl_srcipaddr, srcipaddr) &&
+      net_ipv4addr_cmp(flow->fl_destipaddr, destipaddr) &&
+      flow->fl_ports == ports && flow->fl_proto == ipv4->proto &&
+      now - flow->fl_time < FLOW_TIMEOUT_TICK &&
+      (flow->fl_dev->d_flags & IFF_UP) != 0)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfwd.flowhit++;
+#endif
+      return flow->fl_dev;
+    }
+
+  /* Miss.  Resolve the flow the slow way and replace the entry */
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipfwd.flowmiss++;
+#endif
+
+  fwddev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+  if (fwddev != NULL)
+    {
+      flow->fl_dev        = fwddev;
+      flow->fl_srcipaddr  = srcipaddr;
+      flow->fl_destipaddr = destipaddr;
+      flow->fl_ports      = ports;
+      flow->fl_proto      = ipv4->proto;
+      flow->fl_time       = now;
+    }
+
+  return fwddev;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flowflush
+ *
+ * Description:
+ *   Discard all of the flow cache.
+ *
+ ****************************************************************************/
+
+void ipfwd_flowflush(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPFORWARD_FLOWCACHE; i++)
+    {
+      g_ipfwd_flows[i].fl_dev = NULL;
+    }
+}
+
+#endif /* HAVE_FWDFLOWCACHE */
@@ -253,6 +253,11 @@ int ipfwd_forward(FAR struct forward_s *fwd)
       fwd->f_cb->priv    = (FAR void *)fwd;
       fwd->f_cb->event   = ipfwd_eventhandler;
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfwd.forwarded++;
+      g_netstats.ipfwd.bytes += fwd->f_iob->io_pktlen;
+#endif
+
       /* Notify the device driver of the availability of TX data */
 
       netdev_txnotify_dev(fwd->f_dev);
@@ -441,17 +441,24 @@ int ipv4_forward_callback(FAR struct net_driver_s *fwddev, FAR void *arg)
 
 int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
 {
+#ifndef HAVE_FWDFLOWCACHE
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
+#endif
   FAR struct net_driver_s *fwddev;
   int ret;
 
   /* Search for a device that can forward this packet. */
 
+#ifdef HAVE_FWDFLOWCACHE
+  fwddev     = ipv4_flow_resolve(ipv4);
+#else
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
   fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+#endif
+
   if (fwddev == NULL)
     {
       nwarn("WARNING: Not routable\n");
@@ -74,6 +74,17 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync sequence */
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+/* Size of the receive ring buffer of a connected stream peer */
+
+#  define LOCAL_SHM_BUFSIZE CONFIG_NET_LOCAL_STREAM_SHM_BUFSIZE
+#  define LOCAL_SHM_BUFMASK (LOCAL_SHM_BUFSIZE - 1)
+
+#  if (LOCAL_SHM_BUFSIZE & LOCAL_SHM_BUFMASK) != 0
+#    error CONFIG_NET_LOCAL_STREAM_SHM_BUFSIZE must be a power of two
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -175,6 +186,29 @@ struct local_conn_s
   struct pollfd lc_inout_fds[2*LOCAL_NPOLLWAITERS];
 #endif
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+  /* Direct transport between connected peers.  Each peer owns the ring
+   * buffer that it receives from; the other peer writes into it.  The
+   * head and tail indices run freely and are masked on access.
+   */
+
+  FAR struct local_conn_s *lc_peer; /* The connected peer (NULL if closed) */
+  FAR uint8_t *lc_rxbuf;            /* Receive ring buffer */
+  size_t lc_rxhead;                 /* Ring index of the next byte written */
+  size_t lc_rxtail;                 /* Ring index of the next byte read */
+  sem_t lc_rxsem;                   /* Wait for incoming data */
+  sem_t lc_txsem;                   /* Wait for space in the peer ring */
+  uint8_t lc_rxwaiters;             /* Threads waiting on lc_rxsem */
+  uint8_t lc_txwaiters;             /* Threads waiting on lc_txsem */
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM_LEND
+  FAR const uint8_t *lc_lendbuf;    /* Send buffer lent to the peer */
+  size_t lc_lendlen;                /* Bytes of lc_lendbuf not yet consumed */
+#endif
+#ifdef HAVE_LOCAL_POLL
+  struct pollfd *lc_shm_fds[LOCAL_NPOLLWAITERS];
+#endif
+#endif /* CONFIG_NET_LOCAL_STREAM_SHM */
+
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
    */
@@ -663,6 +697,105 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
                       bool nonblock);
 #endif
 
+/****************************************************************************
+ * Name: local_shm_alloc
+ *
+ * Description:
+ *   Allocate the receive ring buffer of a stream connection that is about
+ *   to be connected.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the buffer could not be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+int local_shm_alloc(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_shm_connect
+ *
+ * Description:
+ *   Bind two stream connections to each other.  Both must have their
+ *   receive ring buffers allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+void local_shm_connect(FAR struct local_conn_s *conn,
+                       FAR struct local_conn_s *peer);
+#endif
+
+/****************************************************************************
+ * Name: local_shm_disconnect
+ *
+ * Description:
+ *   Unbind a stream connection from its peer and wake up any threads of
+ *   the peer that wait for data or buffer space.  The peer receives the
+ *   remaining data in its ring buffer and then end-of-file.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+void local_shm_disconnect(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_shm_send
+ *
+ * Description:
+ *   Copy data into the receive ring buffer of the peer, waiting for space
+ *   as necessary.
+ *
+ * Returned Value:
+ *   The number of bytes sent on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+ssize_t local_shm_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len, int flags);
+#endif
+
+/****************************************************************************
+ * Name: local_shm_recv
+ *
+ * Description:
+ *   Copy data out of the receive ring buffer (or out of a buffer lent by
+ *   the peer), waiting for data as necessary.
+ *
+ * Returned Value:
+ *   The number of bytes received on success; zero if the peer has closed
+ *   the connection; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+ssize_t local_shm_recv(FAR struct socket *psock, FAR void *buf,
+                       size_t len, int flags);
+#endif
+
+/****************************************************************************
+ * Name: local_shm_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the monitoring of events on a connected stream
+ *   socket that uses the direct transport.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_STREAM_SHM) && defined(HAVE_LOCAL_POLL)
+int local_shm_pollsetup(FAR struct local_conn_s *conn,
+                        FAR struct pollfd *fds, bool setup);
+#endif
+
 /****************************************************************************
  * Name: local_accept_pollnotify
  ****************************************************************************/
@@ -182,6 +182,17 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_path[UNIX_PATH_MAX - 1] = '\0';
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+              /* Allocate the ring buffer that the client will write into
+               * and bind the two sides of the connection.
+               */
+
+              ret = local_shm_alloc(conn);
+              if (ret == OK)
+                {
+                  local_shm_connect(conn, client);
+                }
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -193,8 +204,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                    nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                         conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_STREAM_SHM
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -220,7 +233,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
           if (ret == OK)
             {
               DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+            }
+#endif
 
+          if (ret == OK)
+            {
               /* Return the address family */
 
               if (addr != NULL)
@@ -99,6 +99,13 @@ FAR struct local_conn_s *local_alloc(void)
 
       nxsem_init(&conn->lc_waitsem, 0, 0);
       nxsem_set_protocol(&conn->lc_waitsem, SEM_PRIO_NONE);
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+      nxsem_init(&conn->lc_rxsem, 0, 0);
+      nxsem_set_protocol(&conn->lc_rxsem, SEM_PRIO_NONE);
+      nxsem_init(&conn->lc_txsem, 0, 0);
+      nxsem_set_protocol(&conn->lc_txsem, SEM_PRIO_NONE);
+#endif
 #endif
     }
 
@@ -139,6 +146,18 @@ void local_free(FAR struct local_conn_s *conn)
 
   local_release_fifos(conn);
   nxsem_destroy(&conn->lc_waitsem);
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+  /* Free the ring buffer of the direct transport */
+
+  if (conn->lc_rxbuf != NULL)
+    {
+      kmm_free(conn->lc_rxbuf);
+    }
+
+  nxsem_destroy(&conn->lc_rxsem);
+  nxsem_destroy(&conn->lc_txsem);
+#endif
 #endif
 
   /* And free the connection structure */
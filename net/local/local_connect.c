@@ -31,6 +31,7 @@
 #include <queue.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 
 #include <arch/irq.h>
@@ -126,6 +127,18 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+  /* No FIFOs are needed.  Allocate the ring buffer that the server will
+   * write into.
+   */
+
+  ret = local_shm_alloc(client);
+  if (ret < 0)
+    {
+      net_unlock();
+      return ret;
+    }
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -153,6 +166,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
   /* Set the busy "result" before giving the semaphore. */
 
@@ -185,9 +199,18 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   if (ret < 0)
     {
       nerr("ERROR: Failed to connect: %d\n", ret);
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+      goto errout_with_shm;
+#else
       goto errout_with_outfd;
+#endif
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+  /* Yes.. local_accept() has bound the server side to us */
+
+  DEBUGASSERT(client->lc_peer != NULL);
+#else
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -199,9 +222,22 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#endif
+
   client->lc_state = LOCAL_STATE_CONNECTED;
   return OK;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+errout_with_shm:
+  net_lock();
+  local_shm_disconnect(client);
+  net_unlock();
+
+  kmm_free(client->lc_rxbuf);
+  client->lc_rxbuf = NULL;
+  client->lc_state = LOCAL_STATE_BOUND;
+  return ret;
+#else
 errout_with_outfd:
   file_close(&client->lc_outfile);
   client->lc_outfile.f_inode = NULL;
@@ -210,6 +246,7 @@ errout_with_fifos:
   local_release_fifos(client);
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
+#endif
 }
 
 /****************************************************************************
@@ -200,6 +200,13 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       goto pollerr;
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+  if (conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_shm_pollsetup(conn, fds, true);
+    }
+#endif
+
   switch (fds->events & (POLLIN | POLLOUT))
     {
       case (POLLIN | POLLOUT):
@@ -349,6 +356,13 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return OK;
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+  if (conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_shm_pollsetup(conn, fds, false);
+    }
+#endif
+
   switch (fds->events & (POLLIN | POLLOUT))
     {
       case (POLLIN | POLLOUT):
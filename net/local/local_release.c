@@ -87,6 +87,12 @@ int local_release(FAR struct local_conn_s *conn)
     {
       DEBUGASSERT(conn->lc_proto == SOCK_STREAM);
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+      /* Detach from the peer so that it sees end-of-file */
+
+      local_shm_disconnect(conn);
+#endif
+
       /* Just free the connection structure */
     }
 
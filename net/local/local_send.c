@@ -77,11 +77,24 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags)
 {
   FAR struct local_conn_s *peer;
+#ifndef CONFIG_NET_LOCAL_STREAM_SHM
   int ret;
+#endif
 
   DEBUGASSERT(psock && psock->s_conn && buf);
   peer = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+  /* Connected peers exchange data through the direct transport */
+
+  if (peer->lc_state != LOCAL_STATE_CONNECTED)
+    {
+      nerr("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  return local_shm_send(psock, buf, len, flags);
+#else
   /* Verify that this is a connected peer socket and that it has opened the
    * outgoing FIFO for write-only access.
    */
@@ -100,6 +113,7 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
   /* If the send was successful, then the full packet will have been sent */
 
   return ret < 0 ? ret : len;
+#endif
 }
 
 #endif /* CONFIG_NET_LOCAL_STREAM */
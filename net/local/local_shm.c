@@ -0,0 +1,640 @@
+/****************************************************************************
+ * net/local/local_shm.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/* Number of bytes queued in / free in the receive ring of 'c' */
+
+#define LOCAL_SHM_USED(c) ((c)->lc_rxhead - (c)->lc_rxtail)
+#define LOCAL_SHM_FREE(c) (LOCAL_SHM_BUFSIZE - LOCAL_SHM_USED(c))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_shm_wait
+ *
+ * Description:
+ *   Wait on one of the semaphores of a connection.  The network lock is
+ *   released while waiting.
+ *
+ ****************************************************************************/
+
+static int local_shm_wait(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+  int ret;
+
+  (*nwaiters)++;
+  ret = net_lockedwait(sem);
+  if (ret < 0 && *nwaiters > 0)
+    {
+      /* Not woken up by local_shm_wake() */
+
+      (*nwaiters)--;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_shm_wake
+ *
+ * Description:
+ *   Wake up all threads waiting on one of the semaphores of a connection.
+ *   The woken threads re-evaluate the state of the connection.
+ *
+ ****************************************************************************/
+
+static void local_shm_wake(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+  while (*nwaiters > 0)
+    {
+      (*nwaiters)--;
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_shm_pollevents
+ *
+ * Description:
+ *   Return the poll events that are currently true for a connection.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static pollevent_t local_shm_pollevents(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+  pollevent_t eventset = 0;
+
+  if (LOCAL_SHM_USED(conn) > 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (peer == NULL)
+    {
+      /* The peer closed the connection.  recv() returns end-of-file. */
+
+      eventset |= (POLLIN | POLLHUP);
+    }
+  else
+    {
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM_LEND
+      if (peer->lc_lendlen > 0)
+        {
+          eventset |= POLLIN;
+        }
+
+      if (conn->lc_lendlen == 0 && LOCAL_SHM_FREE(peer) > 0)
+#else
+      if (LOCAL_SHM_FREE(peer) > 0)
+#endif
+        {
+          eventset |= POLLOUT;
+        }
+    }
+
+  return eventset;
+}
+#endif
+
+/****************************************************************************
+ * Name: local_shm_pollnotify
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static void local_shm_pollnotify(FAR struct local_conn_s *conn,
+                                 pollevent_t eventset)
+{
+  int i;
+
+  for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
+    {
+      struct pollfd *fds = conn->lc_shm_fds[i];
+      if (fds)
+        {
+          /* POLLHUP is reported whether requested or not */
+
+          fds->revents |= (fds->events & eventset) | (eventset & POLLHUP);
+          if (fds->revents != 0)
+            {
+              ninfo("Report events: %02x\n", fds->revents);
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+#else
+#  define local_shm_pollnotify(conn, eventset) ((void)(conn))
+#endif
+
+/****************************************************************************
+ * Name: local_shm_copyin
+ *
+ * Description:
+ *   Append data to the receive ring buffer of a connection.  The caller
+ *   has verified that there is space for it.
+ *
+ ****************************************************************************/
+
+static void local_shm_copyin(FAR struct local_conn_s *conn,
+                             FAR const uint8_t *src, size_t len)
+{
+  size_t offset = conn->lc_rxhead & LOCAL_SHM_BUFMASK;
+  size_t ncopy  = MIN(len, LOCAL_SHM_BUFSIZE - offset);
+
+  memcpy(&conn->lc_rxbuf[offset], src, ncopy);
+  memcpy(conn->lc_rxbuf, &src[ncopy], len - ncopy);
+  conn->lc_rxhead += len;
+}
+
+/****************************************************************************
+ * Name: local_shm_copyout
+ *
+ * Description:
+ *   Remove data from the receive ring buffer of a connection.  The caller
+ *   has verified that the data is there.
+ *
+ ****************************************************************************/
+
+static void local_shm_copyout(FAR struct local_conn_s *conn,
+                              FAR uint8_t *dest, size_t len)
+{
+  size_t offset = conn->lc_rxtail & LOCAL_SHM_BUFMASK;
+  size_t ncopy  = MIN(len, LOCAL_SHM_BUFSIZE - offset);
+
+  memcpy(dest, &conn->lc_rxbuf[offset], ncopy);
+  memcpy(&dest[ncopy], conn->lc_rxbuf, len - ncopy);
+  conn->lc_rxtail += len;
+}
+
+/****************************************************************************
+ * Name: local_shm_lend
+ *
+ * Description:
+ *   Lend a send buffer to the peer and wait until the peer has copied the
+ *   data out of it, the peer closes the connection, or a signal is
+ *   received.
+ *
+ * Returned Value:
+ *   The number of bytes consumed by the peer.  If no bytes were consumed,
+ *   a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM_LEND
+static ssize_t local_shm_lend(FAR struct local_conn_s *conn,
+                              FAR const uint8_t *buf, size_t len)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+  int ret = OK;
+
+  conn->lc_lendbuf = buf;
+  conn->lc_lendlen = len;
+
+  local_shm_wake(&peer->lc_rxsem, &peer->lc_rxwaiters);
+  local_shm_pollnotify(peer, POLLIN);
+
+  while (conn->lc_lendlen > 0 && conn->lc_peer != NULL)
+    {
+      ret = local_shm_wait(&conn->lc_txsem, &conn->lc_txwaiters);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  /* Take the buffer back.  Whatever was not consumed is not sent. */
+
+  len -= conn->lc_lendlen;
+  conn->lc_lendbuf = NULL;
+  conn->lc_lendlen = 0;
+
+  if (len == 0)
+    {
+      return ret < 0 ? ret : -EPIPE;
+    }
+
+  return len;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_shm_alloc
+ *
+ * Description:
+ *   Allocate the receive ring buffer of a stream connection that is about
+ *   to be connected.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the buffer could not be allocated.
+ *
+ ****************************************************************************/
+
+int local_shm_alloc(FAR struct local_conn_s *conn)
+{
+  DEBUGASSERT(conn->lc_rxbuf == NULL);
+
+  conn->lc_rxbuf = (FAR uint8_t *)kmm_malloc(LOCAL_SHM_BUFSIZE);
+  if (conn->lc_rxbuf == NULL)
+    {
+      nerr("ERROR: Failed to allocate the ring buffer\n");
+      return -ENOMEM;
+    }
+
+  conn->lc_peer   = NULL;
+  conn->lc_rxhead = 0;
+  conn->lc_rxtail = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_shm_connect
+ *
+ * Description:
+ *   Bind two stream connections to each other.  Both must have their
+ *   receive ring buffers allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_shm_connect(FAR struct local_conn_s *conn,
+                       FAR struct local_conn_s *peer)
+{
+  DEBUGASSERT(conn->lc_rxbuf != NULL && peer->lc_rxbuf != NULL);
+
+  conn->lc_peer = peer;
+  peer->lc_peer = conn;
+}
+
+/****************************************************************************
+ * Name: local_shm_disconnect
+ *
+ * Description:
+ *   Unbind a stream connection from its peer and wake up any threads of
+ *   the peer that wait for data or buffer space.  The peer receives the
+ *   remaining data in its ring buffer and then end-of-file.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_shm_disconnect(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  if (peer != NULL)
+    {
+      DEBUGASSERT(peer->lc_peer == conn);
+
+      conn->lc_peer = NULL;
+      peer->lc_peer = NULL;
+
+      local_shm_wake(&peer->lc_rxsem, &peer->lc_rxwaiters);
+      local_shm_wake(&peer->lc_txsem, &peer->lc_txwaiters);
+      local_shm_pollnotify(peer, POLLIN | POLLHUP);
+    }
+}
+
+/****************************************************************************
+ * Name: local_shm_send
+ *
+ * Description:
+ *   Copy data into the receive ring buffer of the peer, waiting for space
+ *   as necessary.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags (only MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   The number of bytes sent on success; a negated errno value on failure.
+ *   A non-blocking send may return fewer bytes than requested.
+ *
+ ****************************************************************************/
+
+ssize_t local_shm_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len, int flags)
+{
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR const uint8_t *src = (FAR const uint8_t *)buf;
+  FAR struct local_conn_s *peer;
+  bool nonblock;
+  ssize_t ret = OK;
+  size_t nsent = 0;
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  net_lock();
+  while (nsent < len)
+    {
+      size_t ncopy;
+
+      peer = conn->lc_peer;
+      if (peer == NULL)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM_LEND
+      /* A large send to an idle peer:  Let the peer copy the data directly
+       * out of the caller's buffer.  Another thread of the same socket may
+       * already have a lend in progress; wait for that to complete.
+       */
+
+      if (conn->lc_lendlen == 0 && !nonblock &&
+          len - nsent >= LOCAL_SHM_BUFSIZE && LOCAL_SHM_USED(peer) == 0)
+        {
+          ncopy = len - nsent;
+          ret   = local_shm_lend(conn, &src[nsent], ncopy);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nsent += ret;
+          if ((size_t)ret < ncopy)
+            {
+              /* Interrupted or the peer closed the connection */
+
+              break;
+            }
+
+          continue;
+        }
+
+      ncopy = conn->lc_lendlen > 0 ? 0 : LOCAL_SHM_FREE(peer);
+#else
+      ncopy = LOCAL_SHM_FREE(peer);
+#endif
+
+      if (ncopy > 0)
+        {
+          ncopy = MIN(ncopy, len - nsent);
+          local_shm_copyin(peer, &src[nsent], ncopy);
+          nsent += ncopy;
+
+          local_shm_wake(&peer->lc_rxsem, &peer->lc_rxwaiters);
+          local_shm_pollnotify(peer, POLLIN);
+          continue;
+        }
+
+      /* The peer's ring buffer is full */
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = local_shm_wait(&conn->lc_txsem, &conn->lc_txwaiters);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+
+  /* Report a partial transfer rather than the error that ended it */
+
+  return nsent > 0 ? (ssize_t)nsent : ret;
+}
+
+/****************************************************************************
+ * Name: local_shm_recv
+ *
+ * Description:
+ *   Copy data out of the receive ring buffer (or out of a buffer lent by
+ *   the peer), waiting for data as necessary.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   flags    Receive flags (only MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   The number of bytes received on success; zero if the peer has closed
+ *   the connection; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_shm_recv(FAR struct socket *psock, FAR void *buf,
+                       size_t len, int flags)
+{
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR struct local_conn_s *peer;
+  ssize_t ret;
+
+  net_lock();
+  for (; ; )
+    {
+      size_t ncopy;
+
+      /* Data in the ring buffer always precedes data lent by the peer */
+
+      ncopy = LOCAL_SHM_USED(conn);
+      if (ncopy > 0)
+        {
+          ncopy = MIN(ncopy, len);
+          local_shm_copyout(conn, buf, ncopy);
+          ret   = ncopy;
+
+          peer  = conn->lc_peer;
+          if (peer != NULL)
+            {
+              local_shm_wake(&peer->lc_txsem, &peer->lc_txwaiters);
+              local_shm_pollnotify(peer, POLLOUT);
+            }
+
+          break;
+        }
+
+      peer = conn->lc_peer;
+      if (peer == NULL)
+        {
+          /* Orderly shutdown by the peer */
+
+          ret = 0;
+          break;
+        }
+
+#ifdef CONFIG_NET_LOCAL_STREAM_SHM_LEND
+      if (peer->lc_lendlen > 0)
+        {
+          ncopy = MIN(peer->lc_lendlen, len);
+          memcpy(buf, peer->lc_lendbuf, ncopy);
+          peer->lc_lendbuf += ncopy;
+          peer->lc_lendlen -= ncopy;
+          ret = ncopy;
+
+          if (peer->lc_lendlen == 0)
+            {
+              local_shm_wake(&peer->lc_txsem, &peer->lc_txwaiters);
+              local_shm_pollnotify(peer, POLLOUT);
+            }
+
+          break;
+        }
+#endif
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = local_shm_wait(&conn->lc_rxsem, &conn->lc_rxwaiters);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_shm_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the monitoring of events on a connected stream
+ *   socket that uses the direct transport.
+ *
+ * Input Parameters:
+ *   conn  - The connection of interest
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: setup up the poll; false: tear down the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_shm_pollsetup(FAR struct local_conn_s *conn,
+                        FAR struct pollfd *fds, bool setup)
+{
+  pollevent_t eventset;
+  int ret = OK;
+  int i;
+
+  net_lock();
+  if (setup)
+    {
+      /* This is a request to set up the poll.  Find an available
+       * slot for the poll structure reference
+       */
+
+      for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
+        {
+          if (!conn->lc_shm_fds[i])
+            {
+              /* Bind the poll structure and this slot */
+
+              conn->lc_shm_fds[i] = fds;
+              fds->priv = &conn->lc_shm_fds[i];
+              break;
+            }
+        }
+
+      if (i >= LOCAL_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      /* Report the events that are already true */
+
+      eventset = local_shm_pollevents(conn);
+      if (eventset)
+        {
+          local_shm_pollnotify(conn, eventset);
+        }
+    }
+  else
+    {
+      /* This is a request to tear down the poll. */
+
+      struct pollfd **slot = (struct pollfd **)fds->priv;
+
+      if (!slot)
+        {
+          ret = -EIO;
+          goto errout;
+        }
+
+      /* Remove all memory of the poll setup */
+
+      *slot = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET_LOCAL_STREAM_SHM */
@@ -46,9 +46,11 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <queue.h>
 
 #include <net/ethernet.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -56,6 +58,36 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPv6_NCONF_NBUCKETS
+#  define CONFIG_NET_IPv6_NCONF_NBUCKETS 4
+#endif
+
+#ifndef CONFIG_NET_IPv6_NCONF_MAXAGE
+#  define CONFIG_NET_IPv6_NCONF_MAXAGE 1200
+#endif
+
+#define NEIGHBOR_MAXAGE_TICK SEC2TICK(CONFIG_NET_IPv6_NCONF_MAXAGE)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One Neighbor table entry.  Every entry is in either the free list or the
+ * LRU list (least recently used first); entries in the LRU list are also
+ * in the hash chain selected by their IPv6 address.
+ */
+
+struct neighbor_node_s
+{
+  dq_entry_t nn_node;                     /* Free or LRU list link */
+  FAR struct neighbor_node_s *nn_flink;   /* Next entry in the hash chain */
+  struct neighbor_entry_s nn_entry;       /* The address mapping */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -64,7 +96,17 @@
  * this table.
  */
 
-extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The heads of the hash chains */
+
+extern FAR struct neighbor_node_s *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_NBUCKETS];
+
+/* The list of unused entries and the LRU list of entries in use */
+
+extern dq_queue_t g_neighbor_free;
+extern dq_queue_t g_neighbor_lru;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -72,6 +114,58 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_initialize
+ *
+ * Description:
+ *   Initialize the Neighbor table.  Called once from net_initialize().
+ *
+ ****************************************************************************/
+
+void neighbor_initialize(void);
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the head of the hash chain for an IPv6 address.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the table.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_node_s **neighbor_hash(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Allocate an entry for an IPv6 address and add it to the hash chain and
+ *   to the tail of the LRU list.  If the table is full, the least recently
+ *   used entry is replaced.  Also starts aging of the table if necessary.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the table.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_node_s *neighbor_alloc(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_free
+ *
+ * Description:
+ *   Remove an entry from its hash chain and from the LRU list and return
+ *   it to the free list.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the table.
+ *
+ ****************************************************************************/
+
+void neighbor_free(FAR struct neighbor_node_s *node);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
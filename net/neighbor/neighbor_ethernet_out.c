@@ -186,6 +186,7 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev)
            */
 
           icmpv6_solicit(dev, ipaddr);
+          NETDEV_TXDROP(dev, NETDEV_TXDROP_NEIGHBOR);
         }
     }
 
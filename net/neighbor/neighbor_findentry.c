@@ -70,16 +70,29 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_node_s *node;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (node = *neighbor_hash(ipaddr); node != NULL; node = node->nn_flink)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
-
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+      if (net_ipv6addr_cmp(node->nn_entry.ne_ipaddr, ipaddr))
         {
-          neighbor_dumpentry("Entry found", neighbor);
-          return neighbor;
+          /* An entry that has expired but not yet been reclaimed is
+           * treated as not found.
+           */
+
+          if (clock_systime_ticks() - node->nn_entry.ne_time >
+              NEIGHBOR_MAXAGE_TICK)
+            {
+              break;
+            }
+
+          /* Make this the most recently used entry */
+
+          dq_rem(&node->nn_node, &g_neighbor_lru);
+          dq_addlast(&node->nn_node, &g_neighbor_lru);
+
+          neighbor_dumpentry("Entry found", &node->nn_entry);
+          return &node->nn_entry;
         }
     }
 
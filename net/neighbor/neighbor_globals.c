@@ -54,7 +54,16 @@
  * this table.
  */
 
-struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The heads of the hash chains */
+
+FAR struct neighbor_node_s *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_NBUCKETS];
+
+/* The list of unused entries and the LRU list of entries in use */
+
+dq_queue_t g_neighbor_free;
+dq_queue_t g_neighbor_lru;
 
 /****************************************************************************
  * Public Functions
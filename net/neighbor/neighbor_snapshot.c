@@ -42,7 +42,6 @@
 
 #include <nuttx/net/ip.h>
 
-#include "inet/inet.h"
 #include "neighbor/neighbor.h"
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -74,25 +73,21 @@
 unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
                                unsigned int nentries)
 {
+  FAR struct neighbor_node_s *node;
+  clock_t now;
   unsigned int ncopied;
-  int i;
 
-  /* Copy all non-empty entries in the Neighbor table. */
+  /* Copy all non-expired entries in the Neighbor table. */
 
-  for (i = 0, ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_IPv6_NCONF_ENTRIES;
-       i++)
+  for (node = (FAR struct neighbor_node_s *)dq_peek(&g_neighbor_lru),
+       now = clock_systime_ticks(), ncopied = 0;
+       nentries > ncopied && node != NULL;
+       node = (FAR struct neighbor_node_s *)dq_next(&node->nn_node))
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
-
-      /* An unused entry table entry will be nullified.  In particularly,
-       * the Neighbor IP address will be all zero (i.e., the unspecified
-       * IPv6 address).
-       */
-
-      if (!net_ipv6addr_cmp(neighbor->ne_ipaddr, g_ipv6_unspecaddr))
+      if (now - node->nn_entry.ne_time <= NEIGHBOR_MAXAGE_TICK)
         {
-          memcpy(&snapshot[ncopied], neighbor, sizeof(struct neighbor_entry_s));
+          memcpy(&snapshot[ncopied], &node->nn_entry,
+                 sizeof(struct neighbor_entry_s));
           ncopied++;
         }
     }
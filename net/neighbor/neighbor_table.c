@@ -0,0 +1,233 @@
+/****************************************************************************
+ * net/neighbor/neighbor_table.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+
+#include "neighbor/neighbor.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Expired entries are reclaimed by a work item that runs four times per
+ * maximum entry age.  Without a work queue, expired entries are simply
+ * ignored on lookup until they are reused.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+#  define NEIGHBOR_AGING 1
+#  define NEIGHBOR_AGE_TICK (NEIGHBOR_MAXAGE_TICK / 4 + 1)
+#  ifdef CONFIG_SCHED_LPWORK
+#    define NEIGHBORWORK LPWORK
+#  else
+#    define NEIGHBORWORK HPWORK
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef NEIGHBOR_AGING
+/* Work item used to discard expired entries */
+
+static struct work_s g_neighbor_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_age_work
+ *
+ * Description:
+ *   Discard entries that have expired.  Runs periodically on the work
+ *   queue while the table is not empty so that expired entries are
+ *   reclaimed without any cost on the lookup path.
+ *
+ ****************************************************************************/
+
+#ifdef NEIGHBOR_AGING
+static void neighbor_age_work(FAR void *arg)
+{
+  FAR struct neighbor_node_s *node;
+  FAR dq_entry_t *next;
+  clock_t now;
+
+  net_lock();
+
+  now = clock_systime_ticks();
+  for (node = (FAR struct neighbor_node_s *)dq_peek(&g_neighbor_lru);
+       node != NULL;
+       node = (FAR struct neighbor_node_s *)next)
+    {
+      next = dq_next(&node->nn_node);
+      if (now - node->nn_entry.ne_time > NEIGHBOR_MAXAGE_TICK)
+        {
+          neighbor_free(node);
+        }
+    }
+
+  if (!dq_empty(&g_neighbor_lru))
+    {
+      work_queue(NEIGHBORWORK, &g_neighbor_work, neighbor_age_work, NULL,
+                 NEIGHBOR_AGE_TICK);
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_initialize
+ *
+ * Description:
+ *   Initialize the Neighbor table.  Called once from net_initialize().
+ *
+ ****************************************************************************/
+
+void neighbor_initialize(void)
+{
+  int i;
+
+  dq_init(&g_neighbor_free);
+  dq_init(&g_neighbor_lru);
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; i++)
+    {
+      dq_addlast(&g_neighbors[i].nn_node, &g_neighbor_free);
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the head of the hash chain for an IPv6 address.  The interface
+ *   identifier in the low-order half of the address varies the most, but
+ *   all of the address is folded in.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_node_s **neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = (hash << 5) + hash + ipaddr[i];
+    }
+
+  hash ^= hash >> 16;
+  return &g_neighbor_hash[hash % CONFIG_NET_IPv6_NCONF_NBUCKETS];
+}
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Allocate an entry for an IPv6 address and add it to the hash chain and
+ *   to the tail of the LRU list.  If the table is full, the least recently
+ *   used entry is replaced.  Also starts aging of the table if necessary.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_node_s *neighbor_alloc(const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_node_s **head;
+  FAR struct neighbor_node_s *node;
+
+  if (dq_empty(&g_neighbor_free))
+    {
+      neighbor_free((FAR struct neighbor_node_s *)dq_peek(&g_neighbor_lru));
+    }
+
+  node = (FAR struct neighbor_node_s *)dq_remfirst(&g_neighbor_free);
+  DEBUGASSERT(node != NULL);
+
+  net_ipv6addr_copy(node->nn_entry.ne_ipaddr, ipaddr);
+
+  head           = neighbor_hash(ipaddr);
+  node->nn_flink = *head;
+  *head          = node;
+
+  dq_addlast(&node->nn_node, &g_neighbor_lru);
+
+#ifdef NEIGHBOR_AGING
+  /* Start aging if it is not already running */
+
+  if (work_available(&g_neighbor_work))
+    {
+      work_queue(NEIGHBORWORK, &g_neighbor_work, neighbor_age_work, NULL,
+                 NEIGHBOR_AGE_TICK);
+    }
+#endif
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: neighbor_free
+ *
+ * Description:
+ *   Remove an entry from its hash chain and from the LRU list and return
+ *   it to the free list.
+ *
+ ****************************************************************************/
+
+void neighbor_free(FAR struct neighbor_node_s *node)
+{
+  FAR struct neighbor_node_s **prev;
+
+  for (prev = neighbor_hash(node->nn_entry.ne_ipaddr); *prev != NULL;
+       prev = &(*prev)->nn_flink)
+    {
+      if (*prev == node)
+        {
+          *prev = node->nn_flink;
+          break;
+        }
+    }
+
+  node->nn_flink = NULL;
+  memset(&node->nn_entry, 0, sizeof(struct neighbor_entry_s));
+
+  dq_rem(&node->nn_node, &g_neighbor_lru);
+  dq_addlast(&node->nn_node, &g_neighbor_free);
+}
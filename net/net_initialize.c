@@ -48,6 +48,8 @@
 #include "socket/socket.h"
 #include "devif/devif.h"
 #include "netdev/netdev.h"
+#include "arp/arp.h"
+#include "neighbor/neighbor.h"
 #include "ipforward/ipforward.h"
 #include "sixlowpan/sixlowpan.h"
 #include "icmp/icmp.h"
@@ -117,6 +119,18 @@ void net_initialize(void)
 
   devif_initialize();
 
+#ifdef CONFIG_NET_ARP
+  /* Initialize the ARP table */
+
+  arp_initialize();
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  /* Initialize the IPv6 neighbor table */
+
+  neighbor_initialize();
+#endif
+
 #ifdef HAVE_FWDALLOC
   /* Initialize IP forwarding support */
 
@@ -90,6 +90,7 @@
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
+#include "pkt/pkt.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -1669,6 +1670,33 @@ int psock_vioctl(FAR struct socket *psock, int cmd, va_list ap)
 
   arg = va_arg(ap, unsigned long);
 
+#if defined(CONFIG_NET_RECVIOB) && defined(CONFIG_BUILD_FLAT)
+  /* Zero-copy receive.  The I/O buffer chain is only accessible to the
+   * caller in the FLAT build.
+   */
+
+  if (cmd == SIOCRECVIOB)
+    {
+      FAR struct recviob_s *ri = (FAR struct recviob_s *)(uintptr_t)arg;
+
+      if (ri == NULL)
+        {
+          return -EINVAL;
+        }
+
+      return psock_recviob(psock, &ri->ri_iob, ri->ri_flags, NULL, NULL);
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+  /* mmap() of a packet socket returns its shared RX/TX rings */
+
+  if (cmd == FIOC_MMAP && psock->s_domain == PF_PACKET)
+    {
+      return pkt_ring_mmap(psock, (FAR void **)(uintptr_t)arg);
+    }
+#endif
+
 #ifdef CONFIG_NET_USRSOCK
   /* Check for a USRSOCK ioctl command */
 
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * net/netdev/netdev_rxpoll.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_RXPOLL
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxpoll_work
+ *
+ * Description:
+ *   Receive up to one budget of frames with the network locked.  If the
+ *   budget was used up, more frames are probably waiting:  Leave the RX
+ *   interrupt disabled and queue the work again, so that the network lock
+ *   is released between passes.
+ *
+ ****************************************************************************/
+
+static void netdev_rxpoll_work(FAR void *arg)
+{
+  FAR struct netdev_rxpoll_s *rxpoll = (FAR struct netdev_rxpoll_s *)arg;
+  FAR struct net_driver_s *dev = rxpoll->rp_dev;
+  int npkts;
+
+  net_lock();
+  npkts = rxpoll->rp_poll(dev, rxpoll->rp_budget);
+  net_unlock();
+
+  if (npkts >= rxpoll->rp_budget)
+    {
+      work_queue(rxpoll->rp_qid, &rxpoll->rp_work, netdev_rxpoll_work,
+                 rxpoll, 0);
+    }
+  else
+    {
+      rxpoll->rp_rxirq(dev, true);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxpoll_initialize
+ *
+ * Description:
+ *   Initialize the polled receive state of a network device.
+ *
+ * Input Parameters:
+ *   rxpoll - The polled receive state to initialize
+ *   dev    - The network device
+ *   qid    - The work queue to receive on (normally LPWORK)
+ *   budget - Maximum frames per pass; zero selects the default
+ *   poll   - Driver function that receives up to 'budget' frames
+ *   rxirq  - Driver function that enables or disables the RX interrupt
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_initialize(FAR struct netdev_rxpoll_s *rxpoll,
+                              FAR struct net_driver_s *dev, int qid,
+                              int budget, netdev_rxpoll_t poll,
+                              netdev_rxirq_t rxirq)
+{
+  DEBUGASSERT(rxpoll != NULL && dev != NULL);
+  DEBUGASSERT(poll != NULL && rxirq != NULL && budget >= 0);
+
+  memset(rxpoll, 0, sizeof(struct netdev_rxpoll_s));
+  rxpoll->rp_dev    = dev;
+  rxpoll->rp_poll   = poll;
+  rxpoll->rp_rxirq  = rxirq;
+  rxpoll->rp_budget = budget > 0 ? budget : CONFIG_NETDEV_RXPOLL_BUDGET;
+  rxpoll->rp_qid    = qid;
+}
+
+/****************************************************************************
+ * Name: netdev_rxpoll_schedule
+ *
+ * Description:
+ *   Disable the RX interrupt and schedule polled receive.  This is normally
+ *   called from the RX interrupt handler of the driver.
+ *
+ * Input Parameters:
+ *   rxpoll - The polled receive state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_schedule(FAR struct netdev_rxpoll_s *rxpoll)
+{
+  DEBUGASSERT(rxpoll != NULL && rxpoll->rp_poll != NULL);
+
+  rxpoll->rp_rxirq(rxpoll->rp_dev, false);
+
+  if (work_available(&rxpoll->rp_work))
+    {
+      work_queue(rxpoll->rp_qid, &rxpoll->rp_work, netdev_rxpoll_work,
+                 rxpoll, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_rxpoll_cancel
+ *
+ * Description:
+ *   Cancel any pending polled receive.  The RX interrupt is left disabled.
+ *   This is normally called when the interface is brought down.
+ *
+ * Input Parameters:
+ *   rxpoll - The polled receive state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_cancel(FAR struct netdev_rxpoll_s *rxpoll)
+{
+  DEBUGASSERT(rxpoll != NULL);
+
+  rxpoll->rp_rxirq(rxpoll->rp_dev, false);
+  work_cancel(rxpoll->rp_qid, &rxpoll->rp_work);
+}
+
+#endif /* CONFIG_NETDEV_RXPOLL */
@@ -52,6 +52,7 @@
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -158,6 +159,10 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             }
 
           curr->flink = NULL;
+
+          /* Forget any forwarding flows through the device */
+
+          ipfwd_flowflush();
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
@@ -297,6 +297,33 @@ ssize_t netlink_route_sendto(NETLINK_HANDLE handle,
 void netlink_device_notify(FAR struct net_driver_s *dev);
 #endif
 
+#ifdef CONFIG_NETLINK_MONITOR
+/****************************************************************************
+ * Name: netlink_monitor_sendto()
+ *
+ * Description:
+ *   Perform the sendto() operation for the NETLINK_MONITOR protocol.
+ *
+ ****************************************************************************/
+
+ssize_t netlink_monitor_sendto(NETLINK_HANDLE handle,
+                               FAR const struct nlmsghdr *nlmsg,
+                               size_t len, int flags,
+                               FAR const struct sockaddr_nl *to,
+                               socklen_t tolen);
+
+/****************************************************************************
+ * Name: netlink_monitor_subscribe()
+ *
+ * Description:
+ *   A NETLINK_MONITOR connection was bound to multicast groups.  Start the
+ *   periodic broadcast of the changes.
+ *
+ ****************************************************************************/
+
+void netlink_monitor_subscribe(FAR struct netlink_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -299,6 +299,7 @@ void netlink_add_response(NETLINK_HANDLE handle,
  *   access to the pending response list.
  *
  * Input Parameters:
+ *   protocol - The Netlink protocol of the connections (NETLINK_*).
  *   group - The broadcast group index.
  *   data  - The broadcast data.  The memory referenced by 'data'
  *           must have been allocated via kmm_malloc().  It will be freed
@@ -306,7 +307,8 @@ void netlink_add_response(NETLINK_HANDLE handle,
  *
  ****************************************************************************/
 
-void netlink_add_broadcast(int group, FAR struct netlink_response_s *data)
+void netlink_add_broadcast(int protocol, int group,
+                           FAR struct netlink_response_s *data)
 {
   FAR struct netlink_conn_s *conn = NULL;
   int first = 1;
@@ -317,7 +319,8 @@ void netlink_add_broadcast(int group, FAR struct netlink_response_s *data)
 
   while ((conn = netlink_nextconn(conn)) != NULL)
     {
-      if ((conn->groups & (1 << (group - 1))) == 0)
+      if (conn->protocol != protocol ||
+          (conn->groups & (1 << (group - 1))) == 0)
         {
           continue;
         }
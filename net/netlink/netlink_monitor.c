@@ -0,0 +1,740 @@
+/****************************************************************************
+ * net/netlink/netlink_monitor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <malloc.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/netlink.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netlink.h>
+
+#include "netdev/netdev.h"
+#include "netlink/netlink.h"
+
+#ifdef CONFIG_NETLINK_MONITOR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MONITOR_PERIOD  MSEC2TICK(CONFIG_NETLINK_MONITOR_PERIOD)
+
+/* The number of network devices whose counters are remembered to detect
+ * changes.  Devices beyond this are reported in every period.
+ */
+
+#define MONITOR_NETDEVS 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A snapshot of the existing tasks */
+
+struct monitor_pids_s
+{
+  int   npids;
+  pid_t pids[CONFIG_MAX_TASKS];
+};
+
+/* netdev_foreach() callback argument */
+
+struct monitor_netdev_s
+{
+  NETLINK_HANDLE handle;             /* Handle for queries; NULL: broadcast */
+  FAR const struct nlmsghdr *req;    /* The query or NULL */
+  int ndx;                           /* Index of the device */
+  bool notify;                       /* Broadcast the changed counters */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Samples the state periodically while there are subscribers */
+
+static struct work_s g_monitor_work;
+
+/* The state at the last sample.  Protected by the network lock. */
+
+static struct monitor_pids_s g_monitor_pids;
+#ifndef CONFIG_BUILD_KERNEL
+static struct mallinfo g_monitor_umem;
+#endif
+#ifdef CONFIG_MM_KERNEL_HEAP
+static struct mallinfo g_monitor_kmem;
+#endif
+static uint32_t g_monitor_netdev[MONITOR_NETDEVS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: monitor_alloc
+ *
+ * Description:
+ *   Allocate a response message with a payload of the given size.  The
+ *   message is zeroed and the header is initialized.
+ *
+ ****************************************************************************/
+
+static FAR struct netlink_response_s *
+monitor_alloc(uint16_t type, size_t size, FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_response_s *resp;
+
+  resp = kmm_zalloc(SIZEOF_NETLINK_RESPONSE_S(size));
+  if (resp == NULL)
+    {
+      nerr("ERROR: Failed to allocate response buffer.\n");
+      return NULL;
+    }
+
+  resp->msg.nlmsg_len   = NLMSG_LENGTH(size);
+  resp->msg.nlmsg_type  = type;
+  resp->msg.nlmsg_flags = req ? req->nlmsg_flags : 0;
+  resp->msg.nlmsg_seq   = req ? req->nlmsg_seq : 0;
+  resp->msg.nlmsg_pid   = req ? req->nlmsg_pid : 0;
+
+  return resp;
+}
+
+/****************************************************************************
+ * Name: monitor_subscribed
+ *
+ * Description:
+ *   Return true if any NETLINK_MONITOR connection subscribed to the group.
+ *   A group of MONNLGRP_NONE matches any subscription.
+ *
+ ****************************************************************************/
+
+static bool monitor_subscribed(int group)
+{
+  FAR struct netlink_conn_s *conn = NULL;
+  uint32_t mask = group ? 1 << (group - 1) : UINT32_MAX;
+
+  while ((conn = netlink_nextconn(conn)) != NULL)
+    {
+      if (conn->protocol == NETLINK_MONITOR && (conn->groups & mask) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: monitor_getpids
+ *
+ * Description:
+ *   Take a snapshot of the IDs of all tasks and threads.
+ *
+ ****************************************************************************/
+
+static void monitor_pid_callback(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct monitor_pids_s *pids = arg;
+
+  if (pids->npids < CONFIG_MAX_TASKS)
+    {
+      pids->pids[pids->npids++] = tcb->pid;
+    }
+}
+
+static void monitor_getpids(FAR struct monitor_pids_s *pids)
+{
+  pids->npids = 0;
+  nxsched_foreach(monitor_pid_callback, pids);
+}
+
+/****************************************************************************
+ * Name: monitor_findpid
+ ****************************************************************************/
+
+static bool monitor_findpid(FAR const struct monitor_pids_s *pids,
+                            pid_t pid)
+{
+  int i;
+
+  for (i = 0; i < pids->npids; i++)
+    {
+      if (pids->pids[i] == pid)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: monitor_gettask
+ *
+ * Description:
+ *   Generate the MONM_NEWTASK message of one task.  NULL is returned if
+ *   the task no longer exists.
+ *
+ ****************************************************************************/
+
+static FAR struct netlink_response_s *
+monitor_gettask(pid_t pid, FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_response_s *resp;
+  FAR struct montaskmsg *task;
+  FAR struct tcb_s *tcb;
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#endif
+
+  resp = monitor_alloc(MONM_NEWTASK, sizeof(struct montaskmsg), req);
+  if (resp == NULL)
+    {
+      return NULL;
+    }
+
+  task = NLMSG_DATA(&resp->msg);
+
+  /* The TCB must not go away while it is examined */
+
+  sched_lock();
+  tcb = nxsched_get_tcb(pid);
+  if (tcb == NULL)
+    {
+      sched_unlock();
+      kmm_free(resp);
+      return NULL;
+    }
+
+  task->mt_pid       = tcb->pid;
+  task->mt_priority  = tcb->sched_priority;
+  task->mt_state     = tcb->task_state;
+  task->mt_flags     = tcb->flags;
+  task->mt_stacksize = tcb->adj_stack_size;
+#ifdef CONFIG_STACK_COLORATION
+  task->mt_stackused = up_check_tcbstack(tcb);
+#endif
+#if CONFIG_TASK_NAME_SIZE > 0
+  strncpy(task->mt_name, tcb->name, MON_NAMESIZE - 1);
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD
+  if (clock_cpuload(pid, &cpuload) >= 0)
+    {
+      task->mt_active = cpuload.active;
+      task->mt_total  = cpuload.total;
+    }
+#endif
+
+  sched_unlock();
+  return resp;
+}
+
+/****************************************************************************
+ * Name: monitor_getmem
+ *
+ * Description:
+ *   Generate the MONM_NEWMEM message of one heap.
+ *
+ ****************************************************************************/
+
+static FAR struct netlink_response_s *
+monitor_getmem(uint8_t heap, FAR const struct mallinfo *info,
+               FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_response_s *resp;
+  FAR struct monmemmsg *mem;
+
+  resp = monitor_alloc(MONM_NEWMEM, sizeof(struct monmemmsg), req);
+  if (resp == NULL)
+    {
+      return NULL;
+    }
+
+  mem              = NLMSG_DATA(&resp->msg);
+  mem->mm_heap     = heap;
+  mem->mm_arena    = info->arena;
+  mem->mm_ordblks  = info->ordblks;
+  mem->mm_mxordblk = info->mxordblk;
+  mem->mm_uordblks = info->uordblks;
+  mem->mm_fordblks = info->fordblks;
+
+  return resp;
+}
+
+/****************************************************************************
+ * Name: monitor_getnetdev
+ *
+ * Description:
+ *   Generate the MONM_NEWNETDEV message of one network device.
+ *
+ ****************************************************************************/
+
+static FAR struct netlink_response_s *
+monitor_getnetdev(FAR struct net_driver_s *dev,
+                  FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_response_s *resp;
+  FAR struct monnetdevmsg *netdev;
+
+  resp = monitor_alloc(MONM_NEWNETDEV, sizeof(struct monnetdevmsg), req);
+  if (resp == NULL)
+    {
+      return NULL;
+    }
+
+  netdev = NLMSG_DATA(&resp->msg);
+  strncpy(netdev->md_ifname, dev->d_ifname, MON_NAMESIZE - 1);
+  netdev->md_flags     = dev->d_flags;
+#ifdef CONFIG_NETDEV_STATISTICS
+  netdev->md_rxpackets = dev->d_statistics.rx_packets;
+  netdev->md_rxerrors  = dev->d_statistics.rx_errors;
+  netdev->md_rxdropped = dev->d_statistics.rx_dropped;
+  netdev->md_txpackets = dev->d_statistics.tx_packets;
+  netdev->md_txdone    = dev->d_statistics.tx_done;
+  netdev->md_txerrors  = dev->d_statistics.tx_errors;
+  netdev->md_errors    = dev->d_statistics.errors;
+#endif
+
+  return resp;
+}
+
+/****************************************************************************
+ * Name: monitor_netdev_callback
+ *
+ * Description:
+ *   netdev_foreach() callback.  For a query, add the message of the device
+ *   to the responses.  Otherwise, remember a summary of the counters and
+ *   broadcast the message if they changed.
+ *
+ ****************************************************************************/
+
+static int monitor_netdev_callback(FAR struct net_driver_s *dev,
+                                   FAR void *arg)
+{
+  FAR struct monitor_netdev_s *info = arg;
+  FAR struct netlink_response_s *resp;
+  uint32_t summary;
+
+  if (info->handle == NULL)
+    {
+      /* Any counted event changes this summary */
+
+      summary = dev->d_flags;
+#ifdef CONFIG_NETDEV_STATISTICS
+      summary += dev->d_statistics.rx_packets +
+                 dev->d_statistics.tx_packets +
+                 dev->d_statistics.tx_done +
+                 dev->d_statistics.errors;
+#endif
+
+      if (info->ndx < MONITOR_NETDEVS)
+        {
+          if (g_monitor_netdev[info->ndx] == summary)
+            {
+              info->ndx++;
+              return OK;
+            }
+
+          g_monitor_netdev[info->ndx] = summary;
+        }
+
+      info->ndx++;
+      if (!info->notify)
+        {
+          return OK;
+        }
+    }
+
+  resp = monitor_getnetdev(dev, info->req);
+  if (resp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (info->handle != NULL)
+    {
+      netlink_add_response(info->handle, resp);
+    }
+  else
+    {
+      netlink_add_broadcast(NETLINK_MONITOR, MONNLGRP_NETDEV, resp);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: monitor_add_terminator
+ *
+ * Description:
+ *   Add one NLMSG_DONE response to handle.
+ *
+ ****************************************************************************/
+
+static int monitor_add_terminator(NETLINK_HANDLE handle,
+                                  FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_response_s *resp;
+
+  resp = monitor_alloc(NLMSG_DONE, 0, req);
+  if (resp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  netlink_add_response(handle, resp);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: monitor_get_tasklist
+ *
+ * Description:
+ *   Dump the state of all tasks and threads.
+ *
+ ****************************************************************************/
+
+static int monitor_get_tasklist(NETLINK_HANDLE handle,
+                                FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_response_s *resp;
+  struct monitor_pids_s pids;
+  int i;
+
+  monitor_getpids(&pids);
+  for (i = 0; i < pids.npids; i++)
+    {
+      resp = monitor_gettask(pids.pids[i], req);
+      if (resp != NULL)
+        {
+          netlink_add_response(handle, resp);
+        }
+    }
+
+  return monitor_add_terminator(handle, req);
+}
+
+/****************************************************************************
+ * Name: monitor_get_meminfo
+ *
+ * Description:
+ *   Return the state of the heaps.
+ *
+ ****************************************************************************/
+
+static int monitor_get_meminfo(NETLINK_HANDLE handle,
+                               FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_response_s *resp;
+  struct mallinfo info;
+
+#ifndef CONFIG_BUILD_KERNEL
+  info = kumm_mallinfo();
+  resp = monitor_getmem(MONHEAP_USER, &info, req);
+  if (resp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  netlink_add_response(handle, resp);
+#endif
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  info = kmm_mallinfo();
+  resp = monitor_getmem(MONHEAP_KERNEL, &info, req);
+  if (resp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  netlink_add_response(handle, resp);
+#endif
+
+  UNUSED(resp);
+  UNUSED(info);
+  return monitor_add_terminator(handle, req);
+}
+
+/****************************************************************************
+ * Name: monitor_get_netdevlist
+ *
+ * Description:
+ *   Dump the counters of all network devices.
+ *
+ ****************************************************************************/
+
+static int monitor_get_netdevlist(NETLINK_HANDLE handle,
+                                  FAR const struct nlmsghdr *req)
+{
+  struct monitor_netdev_s info;
+  int ret;
+
+  info.handle = handle;
+  info.req    = req;
+  info.ndx    = 0;
+  info.notify = false;
+
+  net_lock();
+  ret = netdev_foreach(monitor_netdev_callback, &info);
+  net_unlock();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return monitor_add_terminator(handle, req);
+}
+
+/****************************************************************************
+ * Name: monitor_sample_mem
+ *
+ * Description:
+ *   Compare a heap with its last sample and broadcast it if it changed.
+ *
+ ****************************************************************************/
+
+static void monitor_sample_mem(uint8_t heap, FAR struct mallinfo *last,
+                               FAR const struct mallinfo *info, bool notify)
+{
+  FAR struct netlink_response_s *resp;
+
+  if (memcmp(last, info, sizeof(struct mallinfo)) != 0)
+    {
+      *last = *info;
+      if (notify)
+        {
+          resp = monitor_getmem(heap, info, NULL);
+          if (resp != NULL)
+            {
+              netlink_add_broadcast(NETLINK_MONITOR, MONNLGRP_MEM, resp);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: monitor_sample
+ *
+ * Description:
+ *   Compare the current state with the last sample.  If notify is true,
+ *   broadcast the changes to the subscribed groups.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void monitor_sample(bool notify)
+{
+  FAR struct netlink_response_s *resp;
+  FAR struct montaskmsg *task;
+  struct monitor_pids_s pids;
+  struct monitor_netdev_s info;
+  bool subscribed;
+  struct mallinfo mem;
+  int i;
+
+  /* Task creation and exit */
+
+  monitor_getpids(&pids);
+  subscribed = notify && monitor_subscribed(MONNLGRP_TASK);
+
+  for (i = 0; subscribed && i < pids.npids; i++)
+    {
+      if (!monitor_findpid(&g_monitor_pids, pids.pids[i]))
+        {
+          resp = monitor_gettask(pids.pids[i], NULL);
+          if (resp != NULL)
+            {
+              netlink_add_broadcast(NETLINK_MONITOR, MONNLGRP_TASK, resp);
+            }
+        }
+    }
+
+  for (i = 0; subscribed && i < g_monitor_pids.npids; i++)
+    {
+      if (!monitor_findpid(&pids, g_monitor_pids.pids[i]))
+        {
+          resp = monitor_alloc(MONM_DELTASK, sizeof(struct montaskmsg),
+                               NULL);
+          if (resp != NULL)
+            {
+              task         = NLMSG_DATA(&resp->msg);
+              task->mt_pid = g_monitor_pids.pids[i];
+              netlink_add_broadcast(NETLINK_MONITOR, MONNLGRP_TASK, resp);
+            }
+        }
+    }
+
+  g_monitor_pids = pids;
+
+  /* Heap usage */
+
+  subscribed = notify && monitor_subscribed(MONNLGRP_MEM);
+
+#ifndef CONFIG_BUILD_KERNEL
+  mem = kumm_mallinfo();
+  monitor_sample_mem(MONHEAP_USER, &g_monitor_umem, &mem, subscribed);
+#endif
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  mem = kmm_mallinfo();
+  monitor_sample_mem(MONHEAP_KERNEL, &g_monitor_kmem, &mem, subscribed);
+#endif
+
+  UNUSED(mem);
+
+  /* Network device counters */
+
+  info.handle = NULL;
+  info.req    = NULL;
+  info.ndx    = 0;
+  info.notify = notify && monitor_subscribed(MONNLGRP_NETDEV);
+
+  netdev_foreach(monitor_netdev_callback, &info);
+}
+
+/****************************************************************************
+ * Name: monitor_worker
+ *
+ * Description:
+ *   Periodic work:  Broadcast the changes since the last period.  Stop when
+ *   there are no subscribers left.
+ *
+ ****************************************************************************/
+
+static void monitor_worker(FAR void *arg)
+{
+  net_lock();
+  if (monitor_subscribed(MONNLGRP_NONE))
+    {
+      monitor_sample(true);
+      work_queue(LPWORK, &g_monitor_work, monitor_worker, NULL,
+                 MONITOR_PERIOD);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netlink_monitor_sendto()
+ *
+ * Description:
+ *   Perform the sendto() operation for the NETLINK_MONITOR protocol.
+ *
+ ****************************************************************************/
+
+ssize_t netlink_monitor_sendto(NETLINK_HANDLE handle,
+                               FAR const struct nlmsghdr *nlmsg,
+                               size_t len, int flags,
+                               FAR const struct sockaddr_nl *to,
+                               socklen_t tolen)
+{
+  int ret;
+
+  DEBUGASSERT(handle != NULL && nlmsg != NULL &&
+              nlmsg->nlmsg_len >= sizeof(struct nlmsghdr) &&
+              len >= sizeof(struct nlmsghdr) &&
+              len >= nlmsg->nlmsg_len && to != NULL &&
+              tolen >= sizeof(struct sockaddr_nl));
+
+  /* Handle according to the message type */
+
+  switch (nlmsg->nlmsg_type)
+    {
+      case MONM_GETTASK:
+        ret = monitor_get_tasklist(handle, nlmsg);
+        break;
+
+      case MONM_GETMEM:
+        ret = monitor_get_meminfo(handle, nlmsg);
+        break;
+
+      case MONM_GETNETDEV:
+        ret = monitor_get_netdevlist(handle, nlmsg);
+        break;
+
+      default:
+        ret = -ENOSYS;
+        break;
+    }
+
+  /* On success, return the size of the request that was processed */
+
+  if (ret >= 0)
+    {
+      ret = len;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netlink_monitor_subscribe()
+ *
+ * Description:
+ *   A NETLINK_MONITOR connection was bound to multicast groups.  Start the
+ *   periodic sampling if it is not already running.
+ *
+ ****************************************************************************/
+
+void netlink_monitor_subscribe(FAR struct netlink_conn_s *conn)
+{
+  DEBUGASSERT(conn != NULL && conn->protocol == NETLINK_MONITOR);
+
+  net_lock();
+  if (conn->groups != 0 && work_available(&g_monitor_work))
+    {
+      /* Take the initial sample.  Only the changes are broadcast. */
+
+      monitor_sample(false);
+      work_queue(LPWORK, &g_monitor_work, monitor_worker, NULL,
+                 MONITOR_PERIOD);
+    }
+
+  net_unlock();
+}
+
+#endif /* CONFIG_NETLINK_MONITOR */
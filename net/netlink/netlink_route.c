@@ -828,12 +828,12 @@ void netlink_device_notify(FAR struct net_driver_s *dev)
   resp = netlink_get_device(dev, NULL);
   if (resp != NULL)
     {
-      netlink_add_broadcast(RTNLGRP_LINK, resp);
+      netlink_add_broadcast(NETLINK_ROUTE, RTNLGRP_LINK, resp);
 
       resp = netlink_get_terminator(NULL);
       if (resp != NULL)
         {
-          netlink_add_broadcast(RTNLGRP_LINK, resp);
+          netlink_add_broadcast(NETLINK_ROUTE, RTNLGRP_LINK, resp);
         }
     }
 }
@@ -157,6 +157,11 @@ static int netlink_setup(FAR struct socket *psock, int protocol)
         break;
 #endif
 
+#ifdef CONFIG_NETLINK_MONITOR
+      case NETLINK_MONITOR:
+        break;
+#endif
+
       default:
         return -EPROTONOSUPPORT;
     }
@@ -292,6 +297,13 @@ static int netlink_bind(FAR struct socket *psock,
   conn->pid    = nladdr->nl_pid ? nladdr->nl_pid : getpid();
   conn->groups = nladdr->nl_groups;
 
+#ifdef CONFIG_NETLINK_MONITOR
+  if (conn->protocol == NETLINK_MONITOR)
+    {
+      netlink_monitor_subscribe(conn);
+    }
+#endif
+
   return OK;
 }
 
@@ -771,6 +783,14 @@ static ssize_t netlink_sendto(FAR struct socket *psock, FAR const void *buf,
         break;
 #endif
 
+#ifdef CONFIG_NETLINK_MONITOR
+      case NETLINK_MONITOR:
+        ret = netlink_monitor_sendto(conn, nlmsg, len, flags,
+                                     (FAR struct sockaddr_nl *)to,
+                                     tolen);
+        break;
+#endif
+
       default:
        ret = -EOPNOTSUPP;
        break;
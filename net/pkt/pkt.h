@@ -43,6 +43,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #ifdef CONFIG_NET_PKT
@@ -62,9 +65,24 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_PKT_RING
+/* One shared frame ring (PACKET_RX_RING or PACKET_TX_RING) */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *base;       /* First frame of the ring, NULL if not set up */
+  uint32_t    blocksize;   /* Bytes per block */
+  uint32_t    framesize;   /* Bytes per frame */
+  uint16_t    perblock;    /* Frames per block */
+  uint16_t    nframes;     /* Total number of frames */
+  uint16_t    head;        /* Next frame the kernel will use */
+};
+#endif
+
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct pollfd;           /* Forward reference */
 
 struct pkt_conn_s
 {
@@ -84,6 +102,24 @@ struct pkt_conn_s
   uint8_t    ifindex;
   uint16_t   proto;
   uint8_t    crefs;    /* Reference counts on this instance */
+
+#ifdef CONFIG_NET_PKT_RING
+  /* Shared rings.  Both live in one allocation, RX ring first, which is
+   * what mmap() on the socket returns.
+   */
+
+  struct pkt_ring_s rxring;
+  struct pkt_ring_s txring;
+  FAR uint8_t *ringbuf;   /* Allocation holding both rings */
+  bool        mapped;     /* mmap() was called; ring setup is frozen */
+  bool        losing;     /* Frames were dropped since last delivered one */
+  uint32_t    packets;    /* PACKET_STATISTICS counters */
+  uint32_t    drops;
+
+  /* Threads waiting in poll() for ring events */
+
+  FAR struct pollfd *fds[CONFIG_NET_PKT_RING_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -308,6 +344,109 @@ struct socket;
 ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+#ifdef CONFIG_NET_PKT_RING
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set a SOL_PACKET option: PACKET_RX_RING or PACKET_TX_RING.  The ring
+ *   geometry cannot change once the rings have been mapped.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Get a SOL_PACKET option.  Only PACKET_STATISTICS is supported;
+ *   reading it resets the counters.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Return the address of the shared rings for FIOC_MMAP.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENXIO if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR void **addr);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the frame in dev->d_buf into the next RX ring frame, or count it
+ *   as dropped if the application has not yet released that frame.
+ *
+ * Returned Value:
+ *   true if the connection has an RX ring and the frame was consumed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send every TX ring frame marked TP_STATUS_SEND_REQUEST, in ring order,
+ *   from a single device callback.
+ *
+ * Returned Value:
+ *   The number of bytes sent; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock);
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Setup or teardown a poll on the shared rings.  POLLIN is reported when
+ *   the next RX frame belongs to the user, POLLOUT when the next TX frame
+ *   is available.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_poll(FAR struct socket *psock, FAR struct pollfd *fds,
+                  bool setup);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the shared rings of a connection that is being freed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -182,6 +182,10 @@ void pkt_free(FAR struct pkt_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+#ifdef CONFIG_NET_PKT_RING
+  pkt_ring_free(conn);
+#endif
+
   _pkt_semtake(&g_free_sem);
 
   /* Remove the connection from the active list */
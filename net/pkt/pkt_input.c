@@ -95,6 +95,17 @@ int pkt_input(struct net_driver_s *dev)
     {
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_RING
+      /* With an RX ring the frame is stored (or dropped) right here; the
+       * reader is never waited for.
+       */
+
+      if (pkt_ring_input(dev, conn))
+        {
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -0,0 +1,757 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_RING)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Offset of the sockaddr_ll, of received data and of data to send */
+
+#define PKT_RING_LLOFF   TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+#define PKT_RING_MACOFF  TPACKET_ALIGN(TPACKET_HDRLEN)
+#define PKT_RING_TXOFF   PKT_RING_LLOFF
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State of one TX ring flush */
+
+struct pkt_ringsend_s
+{
+  FAR struct pkt_conn_s       *rs_conn; /* Connection owning the ring */
+  FAR struct devif_callback_s *rs_cb;   /* Reference to callback instance */
+  sem_t                        rs_sem;  /* Wakes the sending thread */
+  ssize_t                      rs_sent; /* Number of bytes sent */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Return the header of frame 'index' of the ring.
+ *
+ ****************************************************************************/
+
+static inline FAR volatile struct tpacket_hdr *
+pkt_ring_frame(FAR struct pkt_ring_s *ring, unsigned int index)
+{
+  return (FAR volatile struct tpacket_hdr *)
+    (ring->base + (index / ring->perblock) * ring->blocksize +
+     (index % ring->perblock) * ring->framesize);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_next
+ ****************************************************************************/
+
+static inline void pkt_ring_next(FAR struct pkt_ring_s *ring)
+{
+  if (++ring->head >= ring->nframes)
+    {
+      ring->head = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_events
+ *
+ * Description:
+ *   Return the poll events currently true for the rings of 'conn'.
+ *
+ ****************************************************************************/
+
+static pollevent_t pkt_ring_events(FAR struct pkt_conn_s *conn)
+{
+  pollevent_t eventset = 0;
+
+  if (conn->rxring.base != NULL &&
+      (pkt_ring_frame(&conn->rxring, conn->rxring.head)->tp_status &
+       TP_STATUS_USER) != 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (conn->txring.base != NULL &&
+      pkt_ring_frame(&conn->txring, conn->txring.head)->tp_status ==
+      TP_STATUS_AVAILABLE)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollnotify
+ ****************************************************************************/
+
+static void pkt_ring_pollnotify(FAR struct pkt_conn_s *conn,
+                                pollevent_t eventset)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_PKT_RING_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = conn->fds[i];
+      if (fds)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              ninfo("Report events: %02x\n", fds->revents);
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Replace the RX or TX ring geometry.  Both rings are reallocated
+ *   together so that they stay in one region, RX ring first; all frames
+ *   start out owned by the kernel (RX) or available (TX).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool istx,
+                          FAR const struct tpacket_req *req)
+{
+  struct pkt_ring_s newring;
+  FAR struct pkt_ring_s *rx;
+  FAR struct pkt_ring_s *tx;
+  FAR uint8_t *buffer = NULL;
+  size_t rxsize;
+  size_t txsize;
+
+  if (conn->mapped)
+    {
+      return -EBUSY;
+    }
+
+  memset(&newring, 0, sizeof(struct pkt_ring_s));
+  if (req->tp_block_nr > 0)
+    {
+      /* Validate the geometry the way Linux does: frames are aligned,
+       * hold at least the frame header, fit in a block and add up to
+       * tp_frame_nr.
+       */
+
+      if (req->tp_frame_size < TPACKET_HDRLEN ||
+          (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+          req->tp_block_size < req->tp_frame_size ||
+          req->tp_block_size / req->tp_frame_size > UINT16_MAX ||
+          req->tp_frame_nr > UINT16_MAX ||
+          req->tp_frame_nr != req->tp_block_nr *
+                              (req->tp_block_size / req->tp_frame_size))
+        {
+          return -EINVAL;
+        }
+
+      newring.blocksize = req->tp_block_size;
+      newring.framesize = req->tp_frame_size;
+      newring.perblock  = req->tp_block_size / req->tp_frame_size;
+      newring.nframes   = req->tp_frame_nr;
+    }
+
+  rx = istx ? &conn->rxring : &newring;
+  tx = istx ? &newring : &conn->txring;
+
+  rxsize = rx->nframes > 0 ? (size_t)rx->blocksize *
+                             (rx->nframes / rx->perblock) : 0;
+  txsize = tx->nframes > 0 ? (size_t)tx->blocksize *
+                             (tx->nframes / tx->perblock) : 0;
+
+  if (rxsize + txsize > 0)
+    {
+      buffer = kumm_zalloc(rxsize + txsize);
+      if (buffer == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  if (conn->ringbuf != NULL)
+    {
+      kumm_free(conn->ringbuf);
+    }
+
+  conn->ringbuf = buffer;
+  conn->rxring  = *rx;
+  conn->txring  = *tx;
+
+  conn->rxring.base = rxsize > 0 ? buffer : NULL;
+  conn->rxring.head = 0;
+  conn->txring.base = txsize > 0 ? buffer + rxsize : NULL;
+  conn->txring.head = 0;
+  conn->losing      = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_sendhandler
+ *
+ * Description:
+ *   Send the next pending TX ring frame each time the device can accept a
+ *   packet, until no frame is marked TP_STATUS_SEND_REQUEST.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_ring_sendhandler(FAR struct net_driver_s *dev,
+                                     FAR void *pvconn,
+                                     FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_ringsend_s *pstate = (FAR struct pkt_ringsend_s *)pvpriv;
+  FAR struct pkt_ring_s *ring;
+  FAR volatile struct tpacket_hdr *hdr;
+
+  if (pstate == NULL)
+    {
+      return flags;
+    }
+
+  /* Wait for the next polling cycle if the device buffer is busy */
+
+  if (dev->d_sndlen > 0 || (flags & PKT_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  ring = &pstate->rs_conn->txring;
+  hdr  = pkt_ring_frame(ring, ring->head);
+
+  while (hdr->tp_status == TP_STATUS_SEND_REQUEST)
+    {
+      unsigned int len = hdr->tp_len;
+
+      pkt_ring_next(ring);
+
+      if (len == 0 || len > ring->framesize - PKT_RING_TXOFF ||
+          len >= NETDEV_PKTSIZE(dev))
+        {
+          /* Mark the bad frame and move on to the next one */
+
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          hdr = pkt_ring_frame(ring, ring->head);
+          continue;
+        }
+
+      hdr->tp_status = TP_STATUS_SENDING;
+      devif_pkt_send(dev, (FAR uint8_t *)hdr + PKT_RING_TXOFF, len);
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+      pstate->rs_sent += len;
+
+      /* Make sure no ARP request overwrites this packet.  This flag will
+       * be cleared in arp_out().
+       */
+
+      IFF_SET_NOARP(dev->d_flags);
+
+      /* Stay armed while more frames are pending; the next one goes out
+       * with the next polling cycle.
+       */
+
+      if (pkt_ring_frame(ring, ring->head)->tp_status ==
+          TP_STATUS_SEND_REQUEST)
+        {
+          netdev_txnotify_dev(dev);
+          return flags;
+        }
+
+      break;
+    }
+
+  /* Nothing more to send.  Don't allow any further call backs. */
+
+  pstate->rs_cb->flags = 0;
+  pstate->rs_cb->priv  = NULL;
+  pstate->rs_cb->event = NULL;
+
+  pkt_ring_pollnotify(pstate->rs_conn, POLLOUT);
+  nxsem_post(&pstate->rs_sem);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set a SOL_PACKET option: PACKET_RX_RING or PACKET_TX_RING.  The ring
+ *   geometry cannot change once the rings have been mapped.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn;
+  int ret;
+
+  if (psock->s_domain != PF_PACKET || psock->s_conn == NULL)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+  switch (option)
+    {
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value == NULL || value_len < sizeof(struct tpacket_req))
+          {
+            return -EINVAL;
+          }
+
+        net_lock();
+        ret = pkt_ring_setup(conn, option == PACKET_TX_RING,
+                             (FAR const struct tpacket_req *)value);
+        net_unlock();
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Get a SOL_PACKET option.  Only PACKET_STATISTICS is supported;
+ *   reading it resets the counters.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn;
+  FAR struct tpacket_stats *stats;
+
+  if (psock->s_domain != PF_PACKET || psock->s_conn == NULL)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+  switch (option)
+    {
+      case PACKET_STATISTICS:
+        if (value == NULL || *value_len < sizeof(struct tpacket_stats))
+          {
+            return -EINVAL;
+          }
+
+        stats = (FAR struct tpacket_stats *)value;
+
+        net_lock();
+        stats->tp_packets = conn->packets;
+        stats->tp_drops   = conn->drops;
+        conn->packets     = 0;
+        conn->drops       = 0;
+        net_unlock();
+
+        *value_len = sizeof(struct tpacket_stats);
+        return OK;
+
+      default:
+        nerr("ERROR: Unrecognized packet option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Return the address of the shared rings for FIOC_MMAP.
+ *
+ * Input Parameters:
+ *   psock - The packet socket
+ *   addr  - Location to return the address
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENXIO if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR void **addr)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  int ret = -ENXIO;
+
+  net_lock();
+  if (conn->ringbuf != NULL)
+    {
+      conn->mapped = true;
+      *addr = conn->ringbuf;
+      ret = OK;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the frame in dev->d_buf into the next RX ring frame, or count it
+ *   as dropped if the application has not yet released that frame.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received packet
+ *   conn - The packet connection the frame was matched to
+ *
+ * Returned Value:
+ *   true if the connection has an RX ring and the frame was consumed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR volatile struct tpacket_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  unsigned int snaplen;
+
+  if (ring->base == NULL)
+    {
+      return false;
+    }
+
+  conn->packets++;
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      /* The application is behind.  Drop the frame rather than holding
+       * up the driver and tell the application with TP_STATUS_LOSING on
+       * the next frame that is delivered.
+       */
+
+      conn->drops++;
+      conn->losing = true;
+      return true;
+    }
+
+  snaplen = dev->d_len;
+  if (snaplen > ring->framesize - PKT_RING_MACOFF)
+    {
+      snaplen = ring->framesize - PKT_RING_MACOFF;
+    }
+
+  memcpy((FAR uint8_t *)hdr + PKT_RING_MACOFF, dev->d_buf, snaplen);
+
+  sll = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr + PKT_RING_LLOFF);
+  sll->sll_family   = AF_PACKET;
+  sll->sll_protocol = ((FAR struct eth_hdr_s *)dev->d_buf)->type;
+  sll->sll_ifindex  = dev->d_ifindex;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = PKT_RING_MACOFF;
+  hdr->tp_net     = PKT_RING_MACOFF + ETH_HDRLEN;
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / 1000;
+
+  /* Hand the frame over to the application last */
+
+  hdr->tp_status  = TP_STATUS_USER |
+                    (conn->losing ? TP_STATUS_LOSING : 0);
+  conn->losing    = false;
+
+  pkt_ring_next(ring);
+  pkt_ring_pollnotify(conn, POLLIN);
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send every TX ring frame marked TP_STATUS_SEND_REQUEST, in ring order,
+ *   from a single device callback.
+ *
+ * Input Parameters:
+ *   psock - The packet socket
+ *
+ * Returned Value:
+ *   The number of bytes sent; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  FAR struct net_driver_s *dev;
+  struct pkt_ringsend_s state;
+  int ret = OK;
+
+  if (conn->txring.base == NULL)
+    {
+      return -EINVAL;
+    }
+
+  dev = pkt_find_device(conn);
+  if (dev == NULL)
+    {
+      return -ENODEV;
+    }
+
+  net_lock();
+
+  if (pkt_ring_frame(&conn->txring, conn->txring.head)->tp_status !=
+      TP_STATUS_SEND_REQUEST)
+    {
+      /* Nothing to send */
+
+      net_unlock();
+      return 0;
+    }
+
+  memset(&state, 0, sizeof(struct pkt_ringsend_s));
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&state.rs_sem, 0, 0); /* Doesn't really fail */
+  nxsem_set_protocol(&state.rs_sem, SEM_PRIO_NONE);
+
+  state.rs_conn = conn;
+  state.rs_cb   = pkt_callback_alloc(dev, conn);
+  if (state.rs_cb != NULL)
+    {
+      state.rs_cb->flags = PKT_POLL;
+      state.rs_cb->priv  = (FAR void *)&state;
+      state.rs_cb->event = pkt_ring_sendhandler;
+
+      /* Notify the device driver that new TX data is available and wait
+       * until the ring has drained or a signal is received.
+       */
+
+      netdev_txnotify_dev(dev);
+      ret = net_lockedwait(&state.rs_sem);
+
+      pkt_callback_free(dev, conn, state.rs_cb);
+    }
+  else
+    {
+      ret = -EBUSY;
+    }
+
+  nxsem_destroy(&state.rs_sem);
+  net_unlock();
+
+  /* Report what was sent even if the wait was interrupted */
+
+  return state.rs_sent > 0 ? state.rs_sent : ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Setup or teardown a poll on the shared rings.  POLLIN is reported when
+ *   the next RX frame belongs to the user, POLLOUT when the next TX frame
+ *   is available.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_poll(FAR struct socket *psock, FAR struct pollfd *fds,
+                  bool setup)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  pollevent_t eventset;
+  int ret = OK;
+  int i;
+
+  net_lock();
+  if (setup)
+    {
+      if (conn->ringbuf == NULL)
+        {
+          ret = -ENOSYS;
+          goto errout;
+        }
+
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_NET_PKT_RING_NPOLLWAITERS; i++)
+        {
+          if (conn->fds[i] == NULL)
+            {
+              conn->fds[i] = fds;
+              fds->priv    = &conn->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_NET_PKT_RING_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      /* Report events that are already true */
+
+      eventset = pkt_ring_events(conn);
+      if (eventset != 0)
+        {
+          pkt_ring_pollnotify(conn, eventset);
+        }
+    }
+  else
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot == NULL)
+        {
+          ret = -EIO;
+          goto errout;
+        }
+
+      /* Remove all memory of the poll setup */
+
+      *slot = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the shared rings of a connection that is being freed.
+ *
+ * Input Parameters:
+ *   conn - The connection being freed
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  net_lock();
+  if (conn->ringbuf != NULL)
+    {
+      kumm_free(conn->ringbuf);
+    }
+
+  conn->ringbuf = NULL;
+  memset(&conn->rxring, 0, sizeof(struct pkt_ring_s));
+  memset(&conn->txring, 0, sizeof(struct pkt_ring_s));
+  memset(conn->fds, 0, sizeof(conn->fds));
+  conn->mapped  = false;
+  conn->losing  = false;
+  conn->packets = 0;
+  conn->drops   = 0;
+  net_unlock();
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_RING */
@@ -520,7 +520,13 @@ int pkt_listen(FAR struct socket *psock, int backlog)
 static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
                           bool setup)
 {
+#ifdef CONFIG_NET_PKT_RING
+  /* Only the shared rings can be polled */
+
+  return pkt_ring_poll(psock, fds, setup);
+#else
   return -ENOSYS;
+#endif
 }
 
 /****************************************************************************
@@ -551,6 +557,15 @@ static ssize_t pkt_send(FAR struct socket *psock, FAR const void *buf,
 
   if (psock->s_type == SOCK_RAW)
     {
+#ifdef CONFIG_NET_PKT_RING
+      /* send(fd, NULL, 0, 0) flushes the TX ring */
+
+      if (buf == NULL && len == 0)
+        {
+          return pkt_ring_send(psock);
+        }
+#endif
+
       /* Raw packet send */
 
       ret = psock_pkt_send(psock, buf, len);
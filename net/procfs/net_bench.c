@@ -0,0 +1,1121 @@
+/****************************************************************************
+ * net/procfs/net_bench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/net/net.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_NET_LOOPBACK_BENCHMARK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETBENCH_NCONNS     CONFIG_NET_LOOPBACK_BENCHMARK_NCONNS
+#define NETBENCH_MSGSIZE    CONFIG_NET_LOOPBACK_BENCHMARK_MSGSIZE
+#define NETBENCH_BYTES      CONFIG_NET_LOOPBACK_BENCHMARK_BYTES
+#define NETBENCH_ROUNDTRIPS CONFIG_NET_LOOPBACK_BENCHMARK_ROUNDTRIPS
+#define NETBENCH_PORT       CONFIG_NET_LOOPBACK_BENCHMARK_PORT
+#define NETBENCH_PRIORITY   CONFIG_NET_LOOPBACK_BENCHMARK_PRIORITY
+#define NETBENCH_STACKSIZE  CONFIG_NET_LOOPBACK_BENCHMARK_STACKSIZE
+
+/* Each connection moves an equal share of the bytes */
+
+#define NETBENCH_CONNMSGS \
+  ((NETBENCH_BYTES / NETBENCH_NCONNS + NETBENCH_MSGSIZE - 1) / \
+   NETBENCH_MSGSIZE)
+
+/* The results */
+
+#ifdef CONFIG_NET_TCP
+#  define NETBENCH_TCP      0
+#  define NETBENCH_TCPRTT   1
+#  define _NETBENCH_UDP     2
+#else
+#  define NETBENCH_TCPRTT   -1
+#  define _NETBENCH_UDP     0
+#endif
+
+#ifdef CONFIG_NET_UDP
+#  define NETBENCH_UDP      _NETBENCH_UDP
+#  define NETBENCH_NTESTS   (_NETBENCH_UDP + 1)
+#else
+#  define NETBENCH_NTESTS   _NETBENCH_UDP
+#endif
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define NETBENCH_LINELEN    128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The result of one test */
+
+struct netbench_result_s
+{
+  FAR const char *name;        /* Name of the test */
+  int      result;             /* OK or a negated errno */
+  uint32_t nmsgs;              /* Messages (or round trips) completed */
+  uint32_t ndropped;           /* Messages sent but not received */
+  uint64_t nbytes;             /* Bytes received */
+  uint32_t usec;               /* Elapsed time */
+};
+
+/* One end of a connection, served by its own thread */
+
+struct netbench_conn_s
+{
+  struct socket sock;          /* The socket of this end */
+  volatile bool finished;      /* The receiver has seen the end */
+  int      result;             /* OK or a negated errno */
+  uint32_t nmsgs;              /* Messages sent or received */
+  uint64_t nbytes;             /* Bytes sent or received */
+};
+
+/* The state of one run.  Runs are serialized by g_netbench_lock. */
+
+struct netbench_s
+{
+  sem_t    done;               /* A connection thread has finished */
+  struct socket listener;      /* The TCP listening socket */
+  struct netbench_conn_s sources[NETBENCH_NCONNS];
+  struct netbench_conn_s sinks[NETBENCH_NCONNS];
+};
+
+/* This structure describes one open "file" */
+
+struct netbench_file_s
+{
+  struct procfs_file_s base;   /* Base open file structure */
+  struct netbench_result_s tests[NETBENCH_NTESTS];
+  char line[NETBENCH_LINELEN]; /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     netbench_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     netbench_close(FAR struct file *filep);
+static ssize_t netbench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     netbench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     netbench_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_netbench_lock = SEM_INITIALIZER(1);
+static struct netbench_s g_netbench;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See include/nutts/fs/procfs.h
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations net_procfs_benchoperations =
+{
+  netbench_open,       /* open */
+  netbench_close,      /* close */
+  netbench_read,       /* read */
+  NULL,                /* write */
+
+  netbench_dup,        /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  netbench_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_now
+ *
+ * Description:
+ *   Return the system time in microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t netbench_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: netbench_addr
+ ****************************************************************************/
+
+static void netbench_addr(FAR struct sockaddr_in *addr, int port)
+{
+  memset(addr, 0, sizeof(struct sockaddr_in));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(port);
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+
+/****************************************************************************
+ * Name: netbench_start
+ *
+ * Description:
+ *   Start a connection thread that is passed the connection index.
+ *
+ ****************************************************************************/
+
+static int netbench_start(FAR const char *name, main_t entry, int index)
+{
+  char arg[8];
+  FAR char *argv[2];
+
+  snprintf(arg, sizeof(arg), "%d", index);
+  argv[0] = arg;
+  argv[1] = NULL;
+
+  return kthread_create(name, NETBENCH_PRIORITY, NETBENCH_STACKSIZE,
+                        entry, argv);
+}
+
+/****************************************************************************
+ * Name: netbench_recvall
+ *
+ * Description:
+ *   Receive exactly len bytes from a stream socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP
+static ssize_t netbench_recvall(FAR struct socket *psock, FAR char *buf,
+                                size_t len)
+{
+  size_t nrecvd = 0;
+  ssize_t ret;
+
+  while (nrecvd < len)
+    {
+      ret = psock_recv(psock, buf + nrecvd, len - nrecvd, 0);
+      if (ret <= 0)
+        {
+          return ret < 0 ? ret : -ECONNRESET;
+        }
+
+      nrecvd += ret;
+    }
+
+  return nrecvd;
+}
+
+/****************************************************************************
+ * Name: netbench_tcp_source
+ *
+ * Description:
+ *   Connect to the listener and send this connection's share of the bytes.
+ *
+ ****************************************************************************/
+
+static int netbench_tcp_source(int argc, FAR char *argv[])
+{
+  FAR struct netbench_conn_s *conn = &g_netbench.sources[atoi(argv[1])];
+  struct sockaddr_in addr;
+  FAR char *buf;
+  ssize_t ret;
+
+  /* The socket was created by netbench_tcp() */
+
+  buf = kmm_zalloc(NETBENCH_MSGSIZE);
+  if (buf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  netbench_addr(&addr, NETBENCH_PORT);
+  ret = psock_connect(&conn->sock, (FAR struct sockaddr *)&addr,
+                      sizeof(addr));
+
+  while (ret >= 0 && conn->nmsgs < NETBENCH_CONNMSGS)
+    {
+      ret = psock_send(&conn->sock, buf, NETBENCH_MSGSIZE, 0);
+      if (ret > 0)
+        {
+          conn->nmsgs++;
+          conn->nbytes += ret;
+        }
+    }
+
+  kmm_free(buf);
+
+errout:
+  psock_close(&conn->sock);
+  conn->result = ret < 0 ? ret : OK;
+  nxsem_post(&g_netbench.done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_tcp_sink
+ *
+ * Description:
+ *   Receive from an accepted connection until the peer closes it.
+ *
+ ****************************************************************************/
+
+static int netbench_tcp_sink(int argc, FAR char *argv[])
+{
+  FAR struct netbench_conn_s *conn = &g_netbench.sinks[atoi(argv[1])];
+  FAR char *buf;
+  ssize_t ret;
+
+  buf = kmm_malloc(NETBENCH_MSGSIZE);
+  if (buf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  do
+    {
+      ret = psock_recv(&conn->sock, buf, NETBENCH_MSGSIZE, 0);
+      if (ret > 0)
+        {
+          conn->nbytes += ret;
+        }
+    }
+  while (ret > 0);
+
+  kmm_free(buf);
+
+errout:
+  psock_close(&conn->sock);
+  conn->nmsgs  = conn->nbytes / NETBENCH_MSGSIZE;
+  conn->result = ret < 0 ? ret : OK;
+  nxsem_post(&g_netbench.done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_tcp_echo
+ *
+ * Description:
+ *   Accept one connection and return every message to the sender.
+ *
+ ****************************************************************************/
+
+static int netbench_tcp_echo(int argc, FAR char *argv[])
+{
+  FAR struct netbench_conn_s *conn = &g_netbench.sinks[0];
+  FAR char *buf;
+  ssize_t ret;
+
+  buf = kmm_malloc(NETBENCH_MSGSIZE);
+  if (buf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = psock_accept(&g_netbench.listener, NULL, NULL, &conn->sock);
+  if (ret < 0)
+    {
+      goto errout_with_buf;
+    }
+
+  for (; ; )
+    {
+      ret = netbench_recvall(&conn->sock, buf, NETBENCH_MSGSIZE);
+      if (ret < 0)
+        {
+          /* The end of the test is seen as the connection closing */
+
+          ret = ret == -ECONNRESET ? OK : ret;
+          break;
+        }
+
+      ret = psock_send(&conn->sock, buf, NETBENCH_MSGSIZE, 0);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  psock_close(&conn->sock);
+
+errout_with_buf:
+  kmm_free(buf);
+
+errout:
+  conn->result = ret < 0 ? ret : OK;
+  nxsem_post(&g_netbench.done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_tcp_listen
+ ****************************************************************************/
+
+static int netbench_tcp_listen(void)
+{
+  struct sockaddr_in addr;
+  int ret;
+
+  ret = psock_socket(PF_INET, SOCK_STREAM, 0, &g_netbench.listener);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  netbench_addr(&addr, NETBENCH_PORT);
+  ret = psock_bind(&g_netbench.listener, (FAR struct sockaddr *)&addr,
+                   sizeof(addr));
+  if (ret >= 0)
+    {
+      ret = psock_listen(&g_netbench.listener, NETBENCH_NCONNS);
+    }
+
+  if (ret < 0)
+    {
+      psock_close(&g_netbench.listener);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_tcp
+ *
+ * Description:
+ *   Measure the throughput of NETBENCH_NCONNS concurrent TCP connections.
+ *
+ ****************************************************************************/
+
+static void netbench_tcp(FAR struct netbench_result_s *result)
+{
+  FAR struct netbench_conn_s *source;
+  uint64_t start;
+  int nsources = 0;
+  int nsinks = 0;
+  int ret;
+  int i;
+
+  ret = netbench_tcp_listen();
+  if (ret < 0)
+    {
+      result->result = ret;
+      return;
+    }
+
+  start = netbench_now();
+
+  for (i = 0; i < NETBENCH_NCONNS; i++)
+    {
+      /* The sockets are created here, so that any sender that started
+       * is sure to connect.
+       */
+
+      source = &g_netbench.sources[i];
+      ret = psock_socket(PF_INET, SOCK_STREAM, 0, &source->sock);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = netbench_start("netbench_src", netbench_tcp_source, i);
+      if (ret < 0)
+        {
+          psock_close(&source->sock);
+          break;
+        }
+
+      nsources++;
+    }
+
+  /* Accept one connection from each sender and give it to a receiver */
+
+  for (i = 0; i < nsources; i++)
+    {
+      ret = psock_accept(&g_netbench.listener, NULL, NULL,
+                         &g_netbench.sinks[i].sock);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = netbench_start("netbench_sink", netbench_tcp_sink, i);
+      if (ret < 0)
+        {
+          psock_close(&g_netbench.sinks[i].sock);
+          break;
+        }
+
+      nsinks++;
+    }
+
+  /* Closing the listener refuses any connection that was not accepted */
+
+  psock_close(&g_netbench.listener);
+
+  for (i = 0; i < nsources + nsinks; i++)
+    {
+      nxsem_wait_uninterruptible(&g_netbench.done);
+    }
+
+  result->usec = netbench_now() - start;
+
+  for (i = 0; i < nsinks; i++)
+    {
+      result->nmsgs  += g_netbench.sinks[i].nmsgs;
+      result->nbytes += g_netbench.sinks[i].nbytes;
+
+      if (ret >= 0)
+        {
+          ret = g_netbench.sources[i].result < 0 ?
+                g_netbench.sources[i].result : g_netbench.sinks[i].result;
+        }
+    }
+
+  result->result = ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: netbench_tcprtt
+ *
+ * Description:
+ *   Measure the round trip time of messages echoed over one TCP connection.
+ *
+ ****************************************************************************/
+
+static void netbench_tcprtt(FAR struct netbench_result_s *result)
+{
+  FAR struct netbench_conn_s *conn = &g_netbench.sources[0];
+  struct sockaddr_in addr;
+  uint64_t start;
+  FAR char *buf;
+  int ret;
+
+  buf = kmm_zalloc(NETBENCH_MSGSIZE);
+  if (buf == NULL)
+    {
+      result->result = -ENOMEM;
+      return;
+    }
+
+  ret = psock_socket(PF_INET, SOCK_STREAM, 0, &conn->sock);
+  if (ret < 0)
+    {
+      goto errout_with_buf;
+    }
+
+  ret = netbench_tcp_listen();
+  if (ret < 0)
+    {
+      goto errout_with_sock;
+    }
+
+  ret = netbench_start("netbench_echo", netbench_tcp_echo, 0);
+  if (ret < 0)
+    {
+      psock_close(&g_netbench.listener);
+      goto errout_with_sock;
+    }
+
+  /* The echo thread is in accept() until this connects, and it ends when
+   * this connection closes.
+   */
+
+  netbench_addr(&addr, NETBENCH_PORT);
+  ret = psock_connect(&conn->sock, (FAR struct sockaddr *)&addr,
+                      sizeof(addr));
+
+  start = netbench_now();
+  while (ret >= 0 && result->nmsgs < NETBENCH_ROUNDTRIPS)
+    {
+      ret = psock_send(&conn->sock, buf, NETBENCH_MSGSIZE, 0);
+      if (ret >= 0)
+        {
+          ret = netbench_recvall(&conn->sock, buf, NETBENCH_MSGSIZE);
+        }
+
+      if (ret >= 0)
+        {
+          result->nmsgs++;
+          result->nbytes += ret;
+        }
+    }
+
+  result->usec = netbench_now() - start;
+  psock_close(&conn->sock);
+
+  nxsem_wait_uninterruptible(&g_netbench.done);
+  psock_close(&g_netbench.listener);
+
+  if (ret >= 0)
+    {
+      ret = g_netbench.sinks[0].result;
+    }
+
+  goto errout_with_buf;
+
+errout_with_sock:
+  psock_close(&conn->sock);
+
+errout_with_buf:
+  kmm_free(buf);
+  result->result = ret < 0 ? ret : OK;
+}
+#endif /* CONFIG_NET_TCP */
+
+/****************************************************************************
+ * Name: netbench_udp_end
+ *
+ * Description:
+ *   Send one byte end markers until the receiver has seen one.  Unlike
+ *   TCP, UDP may drop messages that the receiver is too slow to take,
+ *   including the markers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP
+static void netbench_udp_end(int index)
+{
+  FAR struct netbench_conn_s *conn = &g_netbench.sources[index];
+  struct sockaddr_in addr;
+  char marker = 0;
+
+  netbench_addr(&addr, NETBENCH_PORT + index);
+  while (!g_netbench.sinks[index].finished)
+    {
+      psock_sendto(&conn->sock, &marker, 1, 0, (FAR struct sockaddr *)&addr,
+                   sizeof(addr));
+      nxsig_usleep(10000);
+    }
+}
+
+/****************************************************************************
+ * Name: netbench_udp_source
+ *
+ * Description:
+ *   Send this connection's share of the messages, then the end marker.
+ *
+ ****************************************************************************/
+
+static int netbench_udp_source(int argc, FAR char *argv[])
+{
+  int index = atoi(argv[1]);
+  FAR struct netbench_conn_s *conn = &g_netbench.sources[index];
+  struct sockaddr_in addr;
+  FAR char *buf;
+  ssize_t ret = -ENOMEM;
+
+  /* The socket was created by netbench_udp() */
+
+  buf = kmm_zalloc(NETBENCH_MSGSIZE);
+  if (buf != NULL)
+    {
+      netbench_addr(&addr, NETBENCH_PORT + index);
+      while (conn->nmsgs < NETBENCH_CONNMSGS)
+        {
+          ret = psock_sendto(&conn->sock, buf, NETBENCH_MSGSIZE, 0,
+                             (FAR struct sockaddr *)&addr, sizeof(addr));
+          if (ret < 0)
+            {
+              break;
+            }
+
+          conn->nmsgs++;
+          conn->nbytes += ret;
+        }
+
+      kmm_free(buf);
+    }
+
+  netbench_udp_end(index);
+  psock_close(&conn->sock);
+
+  conn->result = ret < 0 ? ret : OK;
+  nxsem_post(&g_netbench.done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_udp_sink
+ *
+ * Description:
+ *   Receive messages until an end marker arrives.
+ *
+ ****************************************************************************/
+
+static int netbench_udp_sink(int argc, FAR char *argv[])
+{
+  FAR struct netbench_conn_s *conn = &g_netbench.sinks[atoi(argv[1])];
+  FAR char *buf;
+  char marker;
+  ssize_t ret;
+
+  buf = kmm_malloc(NETBENCH_MSGSIZE);
+  for (; ; )
+    {
+      /* Without a buffer, only wait for the end marker */
+
+      ret = buf != NULL ?
+            psock_recv(&conn->sock, buf, NETBENCH_MSGSIZE, 0) :
+            psock_recv(&conn->sock, &marker, 1, 0);
+      if (ret < 0 || ret == 1)
+        {
+          break;
+        }
+
+      conn->nmsgs++;
+      conn->nbytes += ret;
+    }
+
+  if (buf == NULL)
+    {
+      ret = -ENOMEM;
+    }
+
+  kmm_free(buf);
+  psock_close(&conn->sock);
+
+  conn->result   = ret < 0 ? ret : OK;
+  conn->finished = true;
+  nxsem_post(&g_netbench.done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_udp
+ *
+ * Description:
+ *   Measure the throughput of NETBENCH_NCONNS concurrent UDP flows.
+ *
+ ****************************************************************************/
+
+static void netbench_udp(FAR struct netbench_result_s *result)
+{
+  FAR struct netbench_conn_s *source;
+  FAR struct netbench_conn_s *sink;
+  struct sockaddr_in addr;
+  uint64_t start;
+  int nthreads = 0;
+  int nconns;
+  int ret = OK;
+  int i;
+
+  start = netbench_now();
+
+  for (nconns = 0; nconns < NETBENCH_NCONNS; nconns++)
+    {
+      source = &g_netbench.sources[nconns];
+      sink   = &g_netbench.sinks[nconns];
+
+      /* Create both sockets and bind the receiver before either thread
+       * starts.
+       */
+
+      ret = psock_socket(PF_INET, SOCK_DGRAM, 0, &sink->sock);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = psock_socket(PF_INET, SOCK_DGRAM, 0, &source->sock);
+      if (ret < 0)
+        {
+          psock_close(&sink->sock);
+          break;
+        }
+
+      netbench_addr(&addr, NETBENCH_PORT + nconns);
+      ret = psock_bind(&sink->sock, (FAR struct sockaddr *)&addr,
+                       sizeof(addr));
+      if (ret >= 0)
+        {
+          ret = netbench_start("netbench_sink", netbench_udp_sink, nconns);
+        }
+
+      if (ret < 0)
+        {
+          psock_close(&source->sock);
+          psock_close(&sink->sock);
+          break;
+        }
+
+      nthreads++;
+
+      ret = netbench_start("netbench_src", netbench_udp_source, nconns);
+      if (ret < 0)
+        {
+          /* End the receiver that will never get anything */
+
+          netbench_udp_end(nconns);
+          psock_close(&source->sock);
+          nconns++;
+          break;
+        }
+
+      nthreads++;
+    }
+
+  while (nthreads-- > 0)
+    {
+      nxsem_wait_uninterruptible(&g_netbench.done);
+    }
+
+  result->usec = netbench_now() - start;
+
+  for (i = 0; i < nconns; i++)
+    {
+      result->nmsgs    += g_netbench.sinks[i].nmsgs;
+      result->nbytes   += g_netbench.sinks[i].nbytes;
+      result->ndropped += g_netbench.sources[i].nmsgs -
+                          g_netbench.sinks[i].nmsgs;
+
+      if (ret >= 0)
+        {
+          ret = g_netbench.sources[i].result < 0 ?
+                g_netbench.sources[i].result : g_netbench.sinks[i].result;
+        }
+    }
+
+  result->result = ret < 0 ? ret : OK;
+}
+#endif /* CONFIG_NET_UDP */
+
+/****************************************************************************
+ * Name: netbench_run
+ *
+ * Description:
+ *   Run all of the tests.  Only one run at a time is possible, because the
+ *   tests use fixed port numbers.
+ *
+ ****************************************************************************/
+
+static int netbench_run(FAR struct netbench_result_s *results)
+{
+  int ret;
+
+  ret = nxsem_wait(&g_netbench_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxsem_init(&g_netbench.done, 0, 0);
+  nxsem_set_protocol(&g_netbench.done, SEM_PRIO_NONE);
+
+#ifdef CONFIG_NET_TCP
+  memset(g_netbench.sources, 0, sizeof(g_netbench.sources));
+  memset(g_netbench.sinks, 0, sizeof(g_netbench.sinks));
+  results[NETBENCH_TCP].name = "tcp";
+  netbench_tcp(&results[NETBENCH_TCP]);
+
+  memset(g_netbench.sources, 0, sizeof(g_netbench.sources));
+  memset(g_netbench.sinks, 0, sizeof(g_netbench.sinks));
+  results[NETBENCH_TCPRTT].name = "tcprtt";
+  netbench_tcprtt(&results[NETBENCH_TCPRTT]);
+#endif
+
+#ifdef CONFIG_NET_UDP
+  memset(g_netbench.sources, 0, sizeof(g_netbench.sources));
+  memset(g_netbench.sinks, 0, sizeof(g_netbench.sinks));
+  results[NETBENCH_UDP].name = "udp";
+  netbench_udp(&results[NETBENCH_UDP]);
+#endif
+
+  nxsem_destroy(&g_netbench.done);
+  nxsem_post(&g_netbench_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_open
+ *
+ * Description:
+ *   Run the tests.  The results are kept with the open file, so that one
+ *   run can be read in as many pieces as needed.
+ *
+ ****************************************************************************/
+
+static int netbench_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct netbench_file_s *attr;
+  int ret;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "netbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "netbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct netbench_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  ret = netbench_run(attr->tests);
+  if (ret < 0)
+    {
+      kmm_free(attr);
+      return ret;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_close
+ ****************************************************************************/
+
+static int netbench_close(FAR struct file *filep)
+{
+  FAR struct netbench_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct netbench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_read
+ *
+ * Description:
+ *   Generate one line for each test with the number of connections, the
+ *   message size, the messages (round trips for tcprtt) and bytes
+ *   received, the messages dropped, the elapsed time in microseconds, the
+ *   message and byte rates per second and the time per message in
+ *   nanoseconds.  A test that failed shows the negated errno value in
+ *   place of the number of connections.
+ *
+ ****************************************************************************/
+
+static ssize_t netbench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct netbench_file_s *attr;
+  FAR struct netbench_result_s *test;
+  unsigned long msgrate;
+  unsigned long byterate;
+  unsigned long nsec;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  int conns;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct netbench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  /* Generate the header line */
+
+  linesize  = snprintf(attr->line, NETBENCH_LINELEN,
+                       "%-6s %5s %7s %8s %10s %7s %8s %8s %10s %8s\n",
+                       "TEST", "CONNS", "MSGSIZE", "MSGS", "BYTES",
+                       "DROPPED", "USEC", "MSGS/S", "BYTES/S", "NS/MSG");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (i = 0; i < NETBENCH_NTESTS && totalsize < buflen; i++)
+    {
+      test = &attr->tests[i];
+
+      msgrate  = 0;
+      byterate = 0;
+      nsec     = 0;
+
+      if (test->usec > 0)
+        {
+          msgrate  = (uint64_t)test->nmsgs * USEC_PER_SEC / test->usec;
+          byterate = test->nbytes * USEC_PER_SEC / test->usec;
+        }
+
+      if (test->nmsgs > 0)
+        {
+          nsec = (uint64_t)test->usec * NSEC_PER_USEC / test->nmsgs;
+        }
+
+      conns = test->result < 0 ? test->result :
+              i == NETBENCH_TCPRTT ? 1 : NETBENCH_NCONNS;
+
+      linesize   = snprintf(attr->line, NETBENCH_LINELEN,
+                            "%-6s %5d %7d %8lu %10llu %7lu %8lu %8lu "
+                            "%10lu %8lu\n",
+                            test->name, conns, NETBENCH_MSGSIZE,
+                            (unsigned long)test->nmsgs,
+                            (unsigned long long)test->nbytes,
+                            (unsigned long)test->ndropped,
+                            (unsigned long)test->usec,
+                            msgrate, byterate, nsec);
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: netbench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int netbench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct netbench_file_s *oldattr;
+  FAR struct netbench_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct netbench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct netbench_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct netbench_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int netbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "netbench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "netbench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "netbench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_NET_LOOPBACK_BENCHMARK */
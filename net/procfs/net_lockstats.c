@@ -0,0 +1,141 @@
+/****************************************************************************
+ * net/procfs/net_lockstats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Output format (times in clock ticks):
+ *
+ *   Locks:     xxxxxxxx Contended: xxxxxxxx
+ *   Wait:      xxxxxxxx Max:       xxxxxxxx
+ *   Hold:      xxxxxxxx Max:       xxxxxxxx
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <debug.h>
+
+#include <nuttx/net/netstats.h>
+
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && \
+    defined(CONFIG_NET_LOCK_STATISTICS)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static int netprocfs_locks(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_wait(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_hold(FAR struct netprocfs_file_s *netfile);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static const linegen_t g_lock_linegen[] =
+{
+  netprocfs_locks,
+  netprocfs_wait,
+  netprocfs_hold
+};
+
+#define NSTAT_LINES (sizeof(g_lock_linegen) / sizeof(linegen_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_locks
+ ****************************************************************************/
+
+static int netprocfs_locks(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Locks:     %08lx Contended: %08lx\n",
+                  (unsigned long)g_netstats.lock.nlocks,
+                  (unsigned long)g_netstats.lock.ncontended);
+}
+
+/****************************************************************************
+ * Name: netprocfs_wait
+ ****************************************************************************/
+
+static int netprocfs_wait(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Wait:      %08lx Max:       %08lx\n",
+                  (unsigned long)g_netstats.lock.waitticks,
+                  (unsigned long)g_netstats.lock.maxwait);
+}
+
+/****************************************************************************
+ * Name: netprocfs_hold
+ ****************************************************************************/
+
+static int netprocfs_hold(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Hold:      %08lx Max:       %08lx\n",
+                  (unsigned long)g_netstats.lock.holdticks,
+                  (unsigned long)g_netstats.lock.maxhold);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_lockstats
+ *
+ * Description:
+ *   Read and format network lock contention statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_lockstats(FAR struct netprocfs_file_s *priv,
+                                 FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen, g_lock_linegen,
+                                NSTAT_LINES);
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_LOCK_STATISTICS */
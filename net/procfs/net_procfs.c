@@ -74,19 +74,32 @@
 #  define STAT_INDEX     0
 #  ifdef CONFIG_NET_MLD
 #    define MLD_INDEX    1
-#    define _ROUTE_INDEX 2
+#    define _LOCK_INDEX  2
 #  else
-#    define _ROUTE_INDEX 1
+#    define _LOCK_INDEX  1
+#  endif
+#  ifdef CONFIG_NET_LOCK_STATISTICS
+#    define LOCK_INDEX   _LOCK_INDEX
+#    define _ROUTE_INDEX (_LOCK_INDEX + 1)
+#  else
+#    define _ROUTE_INDEX _LOCK_INDEX
 #  endif
 #else
 #  define _ROUTE_INDEX   0
 #endif
 
+#ifdef CONFIG_NET_TCP_CONNSTATS
+#  define TCP_INDEX      _ROUTE_INDEX
+#  define _ROUTE2_INDEX  (_ROUTE_INDEX + 1)
+#else
+#  define _ROUTE2_INDEX  _ROUTE_INDEX
+#endif
+
 #ifdef CONFIG_NET_ROUTE
-#  define ROUTE_INDEX    _ROUTE_INDEX
-#  define DEV_INDEX      (_ROUTE_INDEX + 1)
+#  define ROUTE_INDEX    _ROUTE2_INDEX
+#  define DEV_INDEX      (_ROUTE2_INDEX + 1)
 #else
-#  define DEV_INDEX      _ROUTE_INDEX
+#  define DEV_INDEX      _ROUTE2_INDEX
 #endif
 
 /****************************************************************************
@@ -193,6 +206,31 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
     }
   else
 #endif
+#ifdef CONFIG_NET_LOCK_STATISTICS
+  /* "net/lock" is an acceptable value for the relpath only if network lock
+   * statistics are enabled.
+   */
+
+  if (strcmp(relpath, "net/lock") == 0)
+    {
+      entry = NETPROCFS_SUBDIR_LOCK;
+      dev   = NULL;
+    }
+  else
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+  /* "net/tcp" is an acceptable value for the relpath only if TCP
+   * connection statistics are enabled.
+   */
+
+  if (strcmp(relpath, "net/tcp") == 0)
+    {
+      entry = NETPROCFS_SUBDIR_TCP;
+      dev   = NULL;
+    }
+  else
 #endif
 
 #ifdef CONFIG_NET_ROUTE
@@ -323,6 +361,24 @@ static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer,
         nreturned = netprocfs_read_mldstats(priv, buffer, buflen);
         break;
 #endif
+
+#ifdef CONFIG_NET_LOCK_STATISTICS
+      case NETPROCFS_SUBDIR_LOCK:
+
+        /* Show the network lock statistics */
+
+        nreturned = netprocfs_read_lockstats(priv, buffer, buflen);
+        break;
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+      case NETPROCFS_SUBDIR_TCP:
+
+        /* Show the TCP connection statistics */
+
+        nreturned = netprocfs_read_tcpstats(priv, buffer, buflen);
+        break;
 #endif
 
 #ifdef CONFIG_NET_ROUTE
@@ -445,6 +501,12 @@ static int netprocfs_opendir(FAR const char *relpath,
 #ifdef CONFIG_NET_MLD
       level1->base.nentries++;
 #endif
+#ifdef CONFIG_NET_LOCK_STATISTICS
+      level1->base.nentries++;
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_CONNSTATS
+      level1->base.nentries++;
 #endif
 #ifdef CONFIG_NET_ROUTE
       level1->base.nentries++;
@@ -551,6 +613,26 @@ static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
         }
       else
 #endif
+#ifdef CONFIG_NET_LOCK_STATISTICS
+      if (index == LOCK_INDEX)
+        {
+          /* Copy the network lock statistics directory entry */
+
+          dir->fd_dir.d_type = DTYPE_FILE;
+          strncpy(dir->fd_dir.d_name, "lock", NAME_MAX + 1);
+        }
+      else
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_CONNSTATS
+      if (index == TCP_INDEX)
+        {
+          /* Copy the TCP connection statistics directory entry */
+
+          dir->fd_dir.d_type = DTYPE_FILE;
+          strncpy(dir->fd_dir.d_name, "tcp", NAME_MAX + 1);
+        }
+      else
 #endif
 #ifdef CONFIG_NET_ROUTE
       if (index == ROUTE_INDEX)
@@ -682,6 +764,24 @@ static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
     }
   else
 #endif
+#ifdef CONFIG_NET_LOCK_STATISTICS
+  /* Check for network lock statistics "net/lock" */
+
+  if (strcmp(relpath, "net/lock") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_CONNSTATS
+  /* Check for TCP connection statistics "net/tcp" */
+
+  if (strcmp(relpath, "net/tcp") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
 #endif
 #ifdef CONFIG_NET_ROUTE
   /* Check for network statistics "net/stat" */
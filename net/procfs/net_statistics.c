@@ -80,6 +80,9 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_IPFORWARD
+static int     netprocfs_forwarded(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPFORWARD */
 
 /****************************************************************************
  * Private Data
@@ -114,6 +117,10 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_IPFORWARD
+  , netprocfs_forwarded
+#endif /* CONFIG_NET_IPFORWARD */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -436,6 +443,22 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_forwarded
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPFORWARD)
+static int netprocfs_forwarded(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  Forward     Pkt: %04x   Hit: %04x  Miss: %04x"
+                  "  Bytes: %lu\n",
+                  g_netstats.ipfwd.forwarded, g_netstats.ipfwd.flowhit,
+                  g_netstats.ipfwd.flowmiss,
+                  (unsigned long)g_netstats.ipfwd.bytes);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPFORWARD */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,258 @@
+/****************************************************************************
+ * net/procfs/net_tcpstats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Output format (times in microseconds), two lines per connection:
+ *
+ *   LPORT RPORT STATE           SRTT   RTTVAR      RTO    CWND     WND
+ *          SEGSOUT   SEGSIN  REXMITS     RTOS  DUPACKS    ZWINS  UNACKED
+ *   ddddd ddddd sssssssssss dddddddd dddddddd dddddddd ddddddd ddddddd
+ *         dddddddd dddddddd dddddddd dddddddd dddddddd dddddddd dddddddd
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && \
+    defined(CONFIG_NET_TCP_CONNSTATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The two header lines precede the two lines of each connection */
+
+#define TCPSTATS_HDRLINES  2
+#define TCPSTATS_CONNLINES 2
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Names of the TCP states, indexed by tcpstateflags & TCP_STATE_MASK */
+
+static FAR const char *g_tcp_statenames[] =
+{
+  "CLOSED",
+  "ALLOCATED",
+  "SYN_RCVD",
+  "SYN_SENT",
+  "ESTABLISHED",
+  "FIN_WAIT_1",
+  "FIN_WAIT_2",
+  "CLOSING",
+  "TIME_WAIT",
+  "LAST_ACK"
+};
+
+#define TCP_NSTATES (sizeof(g_tcp_statenames) / sizeof(g_tcp_statenames[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_tcpline
+ *
+ * Description:
+ *   Format line 'lineno' of the /proc/net/tcp output into netfile->line.
+ *   The connection list may change between reads, so each connection
+ *   line is generated by walking the list again to the requested entry.
+ *
+ * Returned Value:
+ *   The length of the line; zero if there are no more lines.
+ *
+ ****************************************************************************/
+
+static int netprocfs_tcpline(FAR struct netprocfs_file_s *netfile,
+                             unsigned int lineno)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR const char *state;
+  struct tcp_info info;
+  unsigned int index;
+  uint16_t lport;
+  uint16_t rport;
+
+  if (lineno == 0)
+    {
+      return snprintf(netfile->line, NET_LINELEN, "%-5s %-5s %-11s "
+                      "%8s %8s %8s %7s %7s\n", "LPORT", "RPORT", "STATE",
+                      "SRTT", "RTTVAR", "RTO", "CWND", "WND");
+    }
+  else if (lineno == 1)
+    {
+      return snprintf(netfile->line, NET_LINELEN, "      "
+                      "%8s %8s %8s %8s %8s %8s %8s\n", "SEGSOUT", "SEGSIN",
+                      "REXMITS", "RTOS", "DUPACKS", "ZWINS", "UNACKED");
+    }
+
+  /* Find the connection that this line belongs to */
+
+  index = (lineno - TCPSTATS_HDRLINES) / TCPSTATS_CONNLINES;
+
+  net_lock();
+  for (conn = tcp_nextconn(NULL); conn != NULL && index > 0;
+       conn = tcp_nextconn(conn))
+    {
+      index--;
+    }
+
+  if (conn == NULL)
+    {
+      net_unlock();
+      return 0;
+    }
+
+  tcp_stats_info(conn, &info);
+  lport = NTOHS(conn->lport);
+  rport = NTOHS(conn->rport);
+  net_unlock();
+
+  if (((lineno - TCPSTATS_HDRLINES) % TCPSTATS_CONNLINES) == 0)
+    {
+      state = info.tcpi_state < TCP_NSTATES ?
+              g_tcp_statenames[info.tcpi_state] : "?";
+
+      return snprintf(netfile->line, NET_LINELEN,
+                      "%-5u %-5u %-11s %8lu %8lu %8lu %7lu %7lu\n",
+                      lport, rport, state,
+                      (unsigned long)info.tcpi_rtt,
+                      (unsigned long)info.tcpi_rttvar,
+                      (unsigned long)info.tcpi_rto,
+                      (unsigned long)info.tcpi_snd_cwnd,
+                      (unsigned long)info.tcpi_snd_wnd);
+    }
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "      %8lu %8lu %8lu %8lu %8lu %8lu %8lu\n",
+                  (unsigned long)info.tcpi_segs_out,
+                  (unsigned long)info.tcpi_segs_in,
+                  (unsigned long)info.tcpi_total_retrans,
+                  (unsigned long)info.tcpi_rto_timeouts,
+                  (unsigned long)info.tcpi_dupacks,
+                  (unsigned long)info.tcpi_zero_windows,
+                  (unsigned long)info.tcpi_unacked);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_tcpstats
+ *
+ * Description:
+ *   Read and format the statistics of each TCP connection.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  size_t xfrsize;
+  ssize_t nreturned = 0;
+
+  /* Is there line data already buffered? */
+
+  if (priv->linesize > 0)
+    {
+      xfrsize = priv->linesize;
+      if (xfrsize > buflen)
+        {
+          xfrsize = buflen;
+        }
+
+      memcpy(buffer, &priv->line[priv->offset], xfrsize);
+
+      buffer         += xfrsize;
+      buflen         -= xfrsize;
+
+      priv->linesize -= xfrsize;
+      priv->offset   += xfrsize;
+      nreturned       = xfrsize;
+    }
+
+  /* Generate lines until the user buffer is full or until there are no
+   * more connections.
+   */
+
+  while (buflen > 0)
+    {
+      int len;
+
+      len = netprocfs_tcpline(priv, priv->lineno);
+      if (len <= 0)
+        {
+          break;
+        }
+
+      priv->lineno++;
+      priv->linesize = len;
+      priv->offset = 0;
+
+      xfrsize = priv->linesize;
+      if (xfrsize > buflen)
+        {
+          xfrsize = buflen;
+        }
+
+      memcpy(buffer, priv->line, xfrsize);
+
+      buffer         += xfrsize;
+      buflen         -= xfrsize;
+      nreturned      += xfrsize;
+
+      priv->linesize -= xfrsize;
+      priv->offset   += xfrsize;
+    }
+
+  return nreturned;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_TCP_CONNSTATS */
@@ -76,8 +76,12 @@ static int netprocfs_rxstatistics_header(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_rxstatistics(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_rxpackets_header(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_rxdrops_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_rxdrops(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_txdrops_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_txdrops(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -106,8 +110,12 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxstatistics,
   netprocfs_rxpackets_header,
   netprocfs_rxpackets,
+  netprocfs_rxdrops_header,
+  netprocfs_rxdrops,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+  netprocfs_txdrops_header,
+  netprocfs_txdrops,
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -487,6 +495,48 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_rxdrops_header
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static int netprocfs_rxdrops_header(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL);
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\t    %-8s %-8s %-8s %-8s %-8s %-8s %-8s\n",
+                  "Header", "Checksum", "Fragment", "Address", "Protocol",
+                  "NoConn", "NoBufs");
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
+/****************************************************************************
+ * Name: netprocfs_rxdrops
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static int netprocfs_rxdrops(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\t    %08lx %08lx %08lx %08lx %08lx %08lx %08lx\n",
+                  (unsigned long)stats->rx_drops[NETDEV_RXDROP_HEADER],
+                  (unsigned long)stats->rx_drops[NETDEV_RXDROP_CHKSUM],
+                  (unsigned long)stats->rx_drops[NETDEV_RXDROP_FRAGMENT],
+                  (unsigned long)stats->rx_drops[NETDEV_RXDROP_ADDRESS],
+                  (unsigned long)stats->rx_drops[NETDEV_RXDROP_PROTOCOL],
+                  (unsigned long)stats->rx_drops[NETDEV_RXDROP_NOCONN],
+                  (unsigned long)stats->rx_drops[NETDEV_RXDROP_NOBUFS]);
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
 /****************************************************************************
  * Name: netprocfs_txstatistics_header
  ****************************************************************************/
@@ -523,6 +573,40 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_txdrops_header
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static int netprocfs_txdrops_header(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL);
+
+  return snprintf(netfile->line, NET_LINELEN, "\t    %-8s %-8s\n",
+                  "Neighbor", "NoBufs");
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
+/****************************************************************************
+ * Name: netprocfs_txdrops
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static int netprocfs_txdrops(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  return snprintf(netfile->line, NET_LINELEN, "\t    %08lx %08lx\n",
+                  (unsigned long)stats->tx_drops[NETDEV_TXDROP_NEIGHBOR],
+                  (unsigned long)stats->tx_drops[NETDEV_TXDROP_NOBUFS]);
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
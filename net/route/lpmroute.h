@@ -0,0 +1,96 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPMTRIE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix matching the target address.
+ *   The lookup uses a path-compressed binary trie that is built from the
+ *   routing table on the first lookup after the table changes.
+ *
+ * Input Parameters:
+ *   dev    - If not NULL, only routes whose router is on the network of
+ *            this device are considered.
+ *   target - The IP address on a remote network to use in the lookup.
+ *   route  - The location to return a copy of the matching route.
+ *
+ * Returned Value:
+ *   OK if a route was found; -ENOENT if there is no matching route.
+ *   -ENOSYS is returned if the trie cannot represent the routing table
+ *   (for example, a route with a non-contiguous netmask) or could not be
+ *   allocated.  In that case, the caller should search the routing table
+ *   directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                      FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR struct net_driver_s *dev,
+                      const net_ipv6addr_t target,
+                      FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_lpminvalidate_ipv4 and net_lpminvalidate_ipv6
+ *
+ * Description:
+ *   Note that the routing table has changed.  The trie will be rebuilt on
+ *   the next lookup.  This only updates a counter, so it may be called with
+ *   the routing table locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_lpminvalidate_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_lpminvalidate_ipv6(void);
+#endif
+
+#else /* CONFIG_ROUTE_LPMTRIE */
+
+#  define net_lpminvalidate_ipv4()
+#  define net_lpminvalidate_ipv6()
+
+#endif /* CONFIG_ROUTE_LPMTRIE */
+#endif /* __NET_ROUTE_LPMROUTE_H */
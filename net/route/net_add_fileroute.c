@@ -49,7 +49,9 @@
 #include <nuttx/net/ip.h>
 
 #include "route/fileroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -99,6 +101,8 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   nwritten = net_writeroute_ipv4(&fshandle, &route);
 
   net_closeroute_ipv4(&fshandle);
+  net_lpminvalidate_ipv4();
+  ipfwd_flowflush();
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
 #endif
@@ -133,6 +137,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   nwritten = net_writeroute_ipv6(&fshandle, &route);
 
   net_closeroute_ipv6(&fshandle);
+  net_lpminvalidate_ipv6();
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
 #endif
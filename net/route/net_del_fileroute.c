@@ -53,7 +53,9 @@
 
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -326,6 +328,8 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
 errout_with_fshandle:
   net_closeroute_ipv4(&fshandle);
+  net_lpminvalidate_ipv4();
+  ipfwd_flowflush();
 
 errout_with_lock:
   net_unlockroute_ipv4();
@@ -475,6 +479,7 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
 errout_with_fshandle:
   net_closeroute_ipv6(&fshandle);
+  net_lpminvalidate_ipv6();
 
 errout_with_lock:
   net_unlockroute_ipv6();
@@ -48,7 +48,9 @@
 #include <nuttx/net/ip.h>
 
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -221,7 +223,14 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  if (net_foreachroute_ipv4(net_match_ipv4, &match) == 0)
+    {
+      return -ENOENT;
+    }
+
+  net_lpminvalidate_ipv4();
+  ipfwd_flowflush();
+  return OK;
 }
 #endif
 
@@ -238,7 +247,13 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  if (net_foreachroute_ipv6(net_match_ipv6, &match) == 0)
+    {
+      return -ENOENT;
+    }
+
+  net_lpminvalidate_ipv6();
+  return OK;
 }
 #endif
 
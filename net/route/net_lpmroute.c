@@ -0,0 +1,674 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The routing tables are simple lists (in RAM, in ROM or in a file) that
+ * had to be searched linearly for every packet.  This file maintains a
+ * path-compressed binary trie of the routes, built on demand from the
+ * table, so that a lookup only visits the nodes along the path of the
+ * target address and always returns the longest matching prefix.
+ *
+ * Every node holds a prefix and its length.  The prefixes of the children
+ * of a node extend the prefix of the node by at least one bit, the next
+ * bit selecting the child.  A node either holds a route or is a fork with
+ * two children; each route inserted adds at most two nodes.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+#include "route/lpmroute.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_ROUTE_LPMTRIE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of the largest key (an IP address) in bytes and bits */
+
+#ifdef CONFIG_NET_IPv6
+#  define LPM_KEYSIZE 16
+#else
+#  define LPM_KEYSIZE 4
+#endif
+
+#define LPM_KEYBITS (8 * LPM_KEYSIZE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of the trie */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *ln_child[2]; /* Children selected by the next bit */
+  int16_t ln_route;                   /* Index of the route, or -1 */
+  uint8_t ln_bits;                    /* Length of the prefix in bits */
+  uint8_t ln_key[LPM_KEYSIZE];        /* The prefix; other bits are zero */
+};
+
+/* The trie for one address family */
+
+typedef CODE bool (*lpm_filter_t)(FAR const void *route, FAR void *arg);
+
+struct lpm_trie_s
+{
+  FAR struct lpm_node_s *lt_root;     /* The root of the trie */
+  FAR struct lpm_node_s *lt_nodes;    /* Pool of nodes */
+  FAR uint8_t *lt_routes;             /* Copies of the routes */
+  uint16_t lt_nnodes;                 /* Number of nodes in use */
+  uint16_t lt_nroutes;                /* Number of routes in lt_routes */
+  uint16_t lt_maxroutes;              /* Capacity of lt_routes */
+  uint8_t lt_keybits;                 /* Address size in bits */
+  uint8_t lt_routesize;               /* Size of one route */
+  bool lt_valid;                      /* True: Built for lt_gen */
+  bool lt_usable;                     /* True: Represents the whole table */
+  unsigned int lt_gen;                /* Table generation of the trie */
+  volatile unsigned int lt_curgen;    /* Current table generation */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct lpm_trie_s g_lpm_ipv4 =
+{
+  NULL, NULL, NULL, 0, 0, 0, 32, sizeof(struct net_route_ipv4_s)
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct lpm_trie_s g_lpm_ipv6 =
+{
+  NULL, NULL, NULL, 0, 0, 0, 128, sizeof(struct net_route_ipv6_s)
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return bit 'n' of a key, counting from the most significant bit of the
+ *   first byte (i.e., in network order).
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint8_t *key, unsigned int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'nbits', that two keys have
+ *   in common.
+ *
+ ****************************************************************************/
+
+static unsigned int lpm_common(FAR const uint8_t *key1,
+                               FAR const uint8_t *key2, unsigned int nbits)
+{
+  unsigned int n;
+  uint8_t diff;
+
+  for (n = 0; n < nbits; n += 8)
+    {
+      diff = key1[n >> 3] ^ key2[n >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              n++;
+            }
+
+          return n < nbits ? n : nbits;
+        }
+    }
+
+  return nbits;
+}
+
+/****************************************************************************
+ * Name: lpm_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a netmask, or -1 if the mask is not a
+ *   contiguous run of leading one bits.
+ *
+ ****************************************************************************/
+
+static int lpm_prefixlen(FAR const uint8_t *mask, unsigned int nbytes)
+{
+  unsigned int plen = 0;
+  unsigned int i;
+
+  for (i = 0; i < nbytes && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < nbytes)
+    {
+      uint8_t byte = mask[i];
+
+      while ((byte & 0x80) != 0)
+        {
+          byte <<= 1;
+          plen++;
+        }
+
+      if (byte != 0)
+        {
+          return -1;
+        }
+
+      for (i++; i < nbytes; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -1;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: lpm_newnode
+ *
+ * Description:
+ *   Take a node from the pool and set its prefix to the first 'bits' bits
+ *   of 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_newnode(FAR struct lpm_trie_s *trie,
+                                          FAR const uint8_t *key,
+                                          unsigned int bits, int route)
+{
+  FAR struct lpm_node_s *node = &trie->lt_nodes[trie->lt_nnodes++];
+  unsigned int nbytes = (bits + 7) >> 3;
+
+  memset(node, 0, sizeof(struct lpm_node_s));
+  memcpy(node->ln_key, key, nbytes);
+  if ((bits & 7) != 0)
+    {
+      node->ln_key[nbytes - 1] &= (uint8_t)(0xff << (8 - (bits & 7)));
+    }
+
+  node->ln_bits  = bits;
+  node->ln_route = route;
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add a prefix to the trie.  If the same prefix was already added, the
+ *   first route is kept, as a linear search of the table would have done.
+ *
+ ****************************************************************************/
+
+static void lpm_insert(FAR struct lpm_trie_s *trie, FAR const uint8_t *key,
+                       unsigned int plen, int route)
+{
+  FAR struct lpm_node_s **link = &trie->lt_root;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *leaf;
+  FAR struct lpm_node_s *fork;
+  unsigned int common;
+
+  while ((node = *link) != NULL)
+    {
+      common = lpm_common(node->ln_key, key,
+                          node->ln_bits < plen ? node->ln_bits : plen);
+
+      if (common < node->ln_bits)
+        {
+          if (common == plen)
+            {
+              /* The new prefix is a prefix of this node's:  Insert it
+               * above the node.
+               */
+
+              leaf = lpm_newnode(trie, key, plen, route);
+              leaf->ln_child[lpm_bit(node->ln_key, plen)] = node;
+              *link = leaf;
+            }
+          else
+            {
+              /* The prefixes diverge:  Insert a fork where they do */
+
+              fork = lpm_newnode(trie, key, common, -1);
+              leaf = lpm_newnode(trie, key, plen, route);
+              fork->ln_child[lpm_bit(key, common)] = leaf;
+              fork->ln_child[lpm_bit(node->ln_key, common)] = node;
+              *link = fork;
+            }
+
+          return;
+        }
+
+      if (node->ln_bits == plen)
+        {
+          /* Same prefix.  Might be a fork that has no route yet */
+
+          if (node->ln_route < 0)
+            {
+              node->ln_route = route;
+            }
+
+          return;
+        }
+
+      link = &node->ln_child[lpm_bit(key, node->ln_bits)];
+    }
+
+  *link = lpm_newnode(trie, key, plen, route);
+}
+
+/****************************************************************************
+ * Name: lpm_add
+ *
+ * Description:
+ *   Copy one route from the routing table and insert it into the trie.
+ *   Returns non-zero to stop the traversal if the route cannot be added.
+ *
+ ****************************************************************************/
+
+static int lpm_add(FAR struct lpm_trie_s *trie, FAR const void *route,
+                   FAR const uint8_t *target, FAR const uint8_t *netmask)
+{
+  uint8_t key[LPM_KEYSIZE];
+  unsigned int nbytes = trie->lt_keybits >> 3;
+  unsigned int i;
+  int plen;
+
+  plen = lpm_prefixlen(netmask, nbytes);
+  if (plen < 0 || trie->lt_nroutes >= trie->lt_maxroutes)
+    {
+      trie->lt_usable = false;
+      return 1;
+    }
+
+  memcpy(&trie->lt_routes[trie->lt_nroutes * trie->lt_routesize], route,
+         trie->lt_routesize);
+
+  for (i = 0; i < nbytes; i++)
+    {
+      key[i] = target[i] & netmask[i];
+    }
+
+  lpm_insert(trie, key, plen, trie->lt_nroutes);
+  trie->lt_nroutes++;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lpm_count_ipv4, lpm_count_ipv6, lpm_add_ipv4 and lpm_add_ipv6
+ *
+ * Description:
+ *   Routing table traversal callbacks used to build the tries.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_count_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  (*(FAR unsigned int *)arg)++;
+  return 0;
+}
+
+static int lpm_add_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  return lpm_add(&g_lpm_ipv4, route, (FAR const uint8_t *)&route->target,
+                 (FAR const uint8_t *)&route->netmask);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int lpm_count_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  (*(FAR unsigned int *)arg)++;
+  return 0;
+}
+
+static int lpm_add_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  return lpm_add(&g_lpm_ipv6, route, (FAR const uint8_t *)route->target,
+                 (FAR const uint8_t *)route->netmask);
+}
+#endif
+
+/****************************************************************************
+ * Name: lpm_reset
+ *
+ * Description:
+ *   Release the memory of a trie and allocate it for 'nroutes' routes.
+ *
+ ****************************************************************************/
+
+static int lpm_reset(FAR struct lpm_trie_s *trie, unsigned int nroutes)
+{
+  trie->lt_root     = NULL;
+  trie->lt_nnodes   = 0;
+  trie->lt_nroutes  = 0;
+  trie->lt_usable   = true;
+
+  if (nroutes > trie->lt_maxroutes || nroutes > INT16_MAX / 2)
+    {
+      kmm_free(trie->lt_nodes);
+      kmm_free(trie->lt_routes);
+      trie->lt_maxroutes = 0;
+
+      if (nroutes > INT16_MAX / 2)
+        {
+          trie->lt_nodes  = NULL;
+          trie->lt_routes = NULL;
+          return -E2BIG;
+        }
+
+      trie->lt_nodes  = (FAR struct lpm_node_s *)
+        kmm_malloc(2 * nroutes * sizeof(struct lpm_node_s));
+      trie->lt_routes = (FAR uint8_t *)kmm_malloc(nroutes *
+                                                  trie->lt_routesize);
+      if (trie->lt_nodes == NULL || trie->lt_routes == NULL)
+        {
+          kmm_free(trie->lt_nodes);
+          kmm_free(trie->lt_routes);
+          trie->lt_nodes  = NULL;
+          trie->lt_routes = NULL;
+          return -ENOMEM;
+        }
+
+      trie->lt_maxroutes = nroutes;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_search
+ *
+ * Description:
+ *   Look up a key in an up-to-date trie.  Returns the route with the
+ *   longest matching prefix that satisfies the filter, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR const void *lpm_search(FAR struct lpm_trie_s *trie,
+                                  FAR const uint8_t *key,
+                                  lpm_filter_t filter, FAR void *arg)
+{
+  FAR struct lpm_node_s *node;
+  FAR const void *route;
+  int16_t path[LPM_KEYBITS + 1];
+  int npath = 0;
+
+  /* Collect the routes of all matching prefixes, shortest first */
+
+  for (node = trie->lt_root; node != NULL;
+       node = node->ln_child[lpm_bit(key, node->ln_bits)])
+    {
+      if (lpm_common(node->ln_key, key, node->ln_bits) < node->ln_bits)
+        {
+          break;
+        }
+
+      if (node->ln_route >= 0)
+        {
+          path[npath++] = node->ln_route;
+        }
+
+      if (node->ln_bits >= trie->lt_keybits)
+        {
+          break;
+        }
+    }
+
+  /* Then return the longest one that is acceptable */
+
+  while (npath > 0)
+    {
+      route = &trie->lt_routes[path[--npath] * trie->lt_routesize];
+      if (filter == NULL || filter(route, arg))
+        {
+          return route;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: lpm_devfilter_ipv4 and lpm_devfilter_ipv6
+ *
+ * Description:
+ *   Accept only routes through a router on the network of a device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static bool lpm_devfilter_ipv4(FAR const void *arg1, FAR void *arg2)
+{
+  FAR const struct net_route_ipv4_s *route = arg1;
+  FAR struct net_driver_s *dev = arg2;
+
+  return net_ipv4addr_maskcmp(route->router, dev->d_ipaddr, dev->d_netmask);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static bool lpm_devfilter_ipv6(FAR const void *arg1, FAR void *arg2)
+{
+  FAR const struct net_route_ipv6_s *route = arg1;
+  FAR struct net_driver_s *dev = arg2;
+
+  return net_ipv6addr_maskcmp(route->router, dev->d_ipv6addr,
+                              dev->d_ipv6netmask);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4
+ *
+ * Description:
+ *   Find the route with the longest prefix matching the target address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                      FAR struct net_route_ipv4_s *route)
+{
+  FAR struct lpm_trie_s *trie = &g_lpm_ipv4;
+  FAR const void *match;
+  unsigned int nroutes;
+  unsigned int gen;
+  int ret = OK;
+
+  net_lock();
+
+  /* Rebuild the trie if the routing table has changed */
+
+  gen = trie->lt_curgen;
+  if (!trie->lt_valid || trie->lt_gen != gen)
+    {
+      nroutes = 0;
+      net_foreachroute_ipv4(lpm_count_ipv4, &nroutes);
+
+      ret = lpm_reset(trie, nroutes);
+      if (ret >= 0)
+        {
+          net_foreachroute_ipv4(lpm_add_ipv4, NULL);
+        }
+      else
+        {
+          trie->lt_usable = false;
+        }
+
+      trie->lt_gen   = gen;
+      trie->lt_valid = true;
+    }
+
+  if (!trie->lt_usable)
+    {
+      ret = -ENOSYS;
+    }
+  else
+    {
+      match = lpm_search(trie, (FAR const uint8_t *)&target,
+                         dev != NULL ? lpm_devfilter_ipv4 : NULL, dev);
+      if (match != NULL)
+        {
+          memcpy(route, match, sizeof(struct net_route_ipv4_s));
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix matching the target address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR struct net_driver_s *dev,
+                      const net_ipv6addr_t target,
+                      FAR struct net_route_ipv6_s *route)
+{
+  FAR struct lpm_trie_s *trie = &g_lpm_ipv6;
+  FAR const void *match;
+  unsigned int nroutes;
+  unsigned int gen;
+  int ret = OK;
+
+  net_lock();
+
+  /* Rebuild the trie if the routing table has changed */
+
+  gen = trie->lt_curgen;
+  if (!trie->lt_valid || trie->lt_gen != gen)
+    {
+      nroutes = 0;
+      net_foreachroute_ipv6(lpm_count_ipv6, &nroutes);
+
+      ret = lpm_reset(trie, nroutes);
+      if (ret >= 0)
+        {
+          net_foreachroute_ipv6(lpm_add_ipv6, NULL);
+        }
+      else
+        {
+          trie->lt_usable = false;
+        }
+
+      trie->lt_gen   = gen;
+      trie->lt_valid = true;
+    }
+
+  if (!trie->lt_usable)
+    {
+      ret = -ENOSYS;
+    }
+  else
+    {
+      match = lpm_search(trie, (FAR const uint8_t *)target,
+                         dev != NULL ? lpm_devfilter_ipv6 : NULL, dev);
+      if (match != NULL)
+        {
+          memcpy(route, match, sizeof(struct net_route_ipv6_s));
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpminvalidate_ipv4 and net_lpminvalidate_ipv6
+ *
+ * Description:
+ *   Note that the routing table has changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_lpminvalidate_ipv4(void)
+{
+  g_lpm_ipv4.lt_curgen++;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_lpminvalidate_ipv6(void)
+{
+  g_lpm_ipv6.lt_curgen++;
+}
+#endif
+
+#endif /* CONFIG_NET && CONFIG_ROUTE_LPMTRIE */
@@ -49,6 +49,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -212,6 +213,9 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 {
   struct route_ipv4_match_s match;
+#ifdef CONFIG_ROUTE_LPMTRIE
+  struct net_route_ipv4_s route;
+#endif
   int ret;
 
   /* Do not route the special broadcast IP address */
@@ -221,6 +225,21 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_LPMTRIE
+  /* Find the longest matching prefix */
+
+  ret = net_lpmroute_ipv4(NULL, target, &route);
+  if (ret != -ENOSYS)
+    {
+      if (ret >= 0)
+        {
+          net_ipv4addr_copy(*router, route.router);
+        }
+
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -287,6 +306,9 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
 {
   struct route_ipv6_match_s match;
+#ifdef CONFIG_ROUTE_LPMTRIE
+  struct net_route_ipv6_s route;
+#endif
   int ret;
 
   /* Do not route to any the special IPv6 multicast addresses */
@@ -296,6 +318,21 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_LPMTRIE
+  /* Find the longest matching prefix */
+
+  ret = net_lpmroute_ipv6(NULL, target, &route);
+  if (ret != -ENOSYS)
+    {
+      if (ret >= 0)
+        {
+          net_ipv6addr_copy(router, route.router);
+        }
+
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
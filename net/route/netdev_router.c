@@ -48,6 +48,7 @@
 
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -231,8 +232,30 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
   struct route_ipv4_devmatch_s match;
+#ifdef CONFIG_ROUTE_LPMTRIE
+  struct net_route_ipv4_s route;
+#endif
   int ret;
 
+#ifdef CONFIG_ROUTE_LPMTRIE
+  /* Find the longest matching prefix routed through this device */
+
+  ret = net_lpmroute_ipv4(dev, target, &route);
+  if (ret != -ENOSYS)
+    {
+      if (ret >= 0)
+        {
+          net_ipv4addr_copy(*router, route.router);
+        }
+      else
+        {
+          net_ipv4addr_copy(*router, dev->d_draddr);
+        }
+
+      return;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_devmatch_s));
@@ -310,8 +333,30 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR net_ipv6addr_t router)
 {
   struct route_ipv6_devmatch_s match;
+#ifdef CONFIG_ROUTE_LPMTRIE
+  struct net_route_ipv6_s route;
+#endif
   int ret;
 
+#ifdef CONFIG_ROUTE_LPMTRIE
+  /* Find the longest matching prefix routed through this device */
+
+  ret = net_lpmroute_ipv6(dev, target, &route);
+  if (ret != -ENOSYS)
+    {
+      if (ret >= 0)
+        {
+          net_ipv6addr_copy(router, route.router);
+        }
+      else
+        {
+          net_ipv6addr_copy(router, dev->d_ipv6draddr);
+        }
+
+      return;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_devmatch_s));
@@ -59,6 +59,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -101,6 +102,29 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+/* The compressed form of one destination.  The encoding depends only on
+ * the destination IPv6 and MAC addresses (the address contexts do not
+ * change after initialization), so it can be replayed for later frames.
+ */
+
+struct sixlowpan_destcache_s
+{
+  net_ipv6addr_t ipaddr;           /* Destination IPv6 address */
+  struct netdev_varaddr_s macaddr; /* Destination MAC address */
+
+  /* Address context used to compress the destination, or NULL */
+
+  FAR struct sixlowpan_addrcontext_s *context;
+
+  uint8_t valid;                   /* Entry is in use */
+  uint8_t iphc1;                   /* M, DAC and DAM bits */
+  uint8_t dci;                     /* Destination context number */
+  uint8_t inlen;                   /* Number of inline bytes */
+  uint8_t indata[16];              /* Inline destination address bytes */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -120,6 +144,13 @@ static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
 #endif
 
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+/* Compressed destination addresses, hashed by destination */
+
+static struct sixlowpan_destcache_s
+  g_hc06_destcache[CONFIG_NET_6LOWPAN_HC06_DESTCACHE];
+#endif
+
 /* Pointer to the byte where to write next inline field. */
 
 static FAR uint8_t *g_hc06ptr;
@@ -409,6 +440,157 @@ static uint8_t compress_laddr(FAR const net_ipv6addr_t srcipaddr,
   return tag;
 }
 
+/****************************************************************************
+ * Name: compress_destaddr
+ *
+ * Description:
+ *   Compress the destination address of 'ipv6' into the inline fields at
+ *   g_hc06ptr.  The destination context number is merged into iphc[2].
+ *
+ * Returned Value:
+ *   The M, DAC and DAM bits for the second IPHC byte.
+ *
+ ****************************************************************************/
+
+static uint8_t
+  compress_destaddr(FAR const struct ipv6_hdr_s *ipv6,
+                    FAR const struct netdev_varaddr_s *destmac,
+                    FAR struct sixlowpan_addrcontext_s *daddrcontext,
+                    FAR uint8_t *iphc)
+{
+  uint8_t iphc1 = 0;
+
+  if (net_is_addr_mcast(ipv6->destipaddr))
+    {
+      /* Address is multicast, try to compress */
+
+      iphc1 |= SIXLOWPAN_IPHC_M;
+      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
+        {
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
+
+          /* Use "last" byte ("last" meaning the LS byte in host order.
+           * destipaddr is in big-endian network order).
+           */
+
+#ifdef CONFIG_ENDIAN_BIG
+          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
+#else
+          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
+#endif
+          g_hc06ptr += 1;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
+
+          /* Second byte + the last three */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[13], 3);
+          g_hc06ptr += 4;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
+
+          /* Second byte + the last five */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[11], 5);
+          g_hc06ptr += 6;
+        }
+      else
+        {
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
+
+          /* Full address */
+
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+  else
+    {
+      /* Address is unicast, try to compress */
+
+      if (daddrcontext != NULL)
+        {
+          /* Elide the prefix */
+
+          ninfo("Compressing dest with address context. Setting DAC. "
+                "Context: %d\n", daddrcontext->number);
+
+          iphc1   |= SIXLOWPAN_IPHC_DAC;
+          iphc[2] |= daddrcontext->number;
+
+          /* Compession compare with link address (destination) */
+
+          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                      SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* No address context found for this address */
+
+      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
+               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
+               ipv6->destipaddr[3] == 0)
+        {
+          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                    SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* Send the full address */
+
+      else
+        {
+          iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+
+  return iphc1;
+}
+
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+/****************************************************************************
+ * Name: find_destcache
+ *
+ * Description:
+ *   Return the destination cache slot for this IPv6 and MAC address pair.
+ *   '*hit' tells whether the slot already holds the pair; otherwise the
+ *   slot is the one to overwrite.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_destcache_s *
+  find_destcache(FAR const net_ipv6addr_t ipaddr,
+                 FAR const struct netdev_varaddr_s *macaddr,
+                 FAR bool *hit)
+{
+  FAR struct sixlowpan_destcache_s *dcache;
+  unsigned int hash;
+
+  /* Nodes of one mesh usually differ only in the interface identifier */
+
+  hash   = ipaddr[7] ^ ipaddr[6] ^ ipaddr[5];
+  hash   = (hash ^ (hash >> 8)) % CONFIG_NET_6LOWPAN_HC06_DESTCACHE;
+  dcache = &g_hc06_destcache[hash];
+
+  *hit   = dcache->valid != 0 &&
+           net_ipv6addr_cmp(dcache->ipaddr, ipaddr) &&
+           dcache->macaddr.nv_addrlen == macaddr->nv_addrlen &&
+           memcmp(dcache->macaddr.nv_addr, macaddr->nv_addr,
+                  macaddr->nv_addrlen) == 0;
+  return dcache;
+}
+#endif
+
 /****************************************************************************
  * Name: uncompress_addr
  *
@@ -728,6 +910,10 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
   FAR struct sixlowpan_addrcontext_s *saddrcontext;
   FAR struct sixlowpan_addrcontext_s *daddrcontext;
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+  FAR struct sixlowpan_destcache_s *dcache;
+  bool dhit;
+#endif
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -755,7 +941,13 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
   /* Check if dest address context exists (for allocating third byte) */
 
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+  dcache       = find_destcache(ipv6->destipaddr, destmac, &dhit);
+  daddrcontext = dhit ? dcache->context :
+                 find_addrcontext_byprefix(ipv6->destipaddr);
+#else
   daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+#endif
   saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
 
   if (daddrcontext != NULL || saddrcontext != NULL)
@@ -923,99 +1115,38 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
   /* Destination address */
 
-  if (net_is_addr_mcast(ipv6->destipaddr))
+#if CONFIG_NET_6LOWPAN_HC06_DESTCACHE > 0
+  if (dhit)
     {
-      /* Address is multicast, try to compress */
+      /* Replay the encoding cached for this destination */
 
-      iphc1 |= SIXLOWPAN_IPHC_M;
-      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
-
-          /* Use "last" byte ("last" meaning the LS byte in host order.
-           * destipaddr is in big-endian network order).
-           */
-
-#ifdef CONFIG_ENDIAN_BIG
-          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
-#else
-          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
-#endif
-          g_hc06ptr += 1;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
-
-          /* Second byte + the last three */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[13], 3);
-          g_hc06ptr += 4;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
-
-          /* Second byte + the last five */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[11], 5);
-          g_hc06ptr += 6;
-        }
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
-
-          /* Full address */
-
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
+      iphc1   |= dcache->iphc1;
+      iphc[2] |= dcache->dci;
+      memcpy(g_hc06ptr, dcache->indata, dcache->inlen);
+      g_hc06ptr += dcache->inlen;
     }
   else
     {
-      /* Address is unicast, try to compress */
-
-      if (daddrcontext != NULL)
-        {
-          /* Elide the prefix */
-
-          ninfo("Compressing dest with address context. Setting DAC. Context: %d\n",
-                daddrcontext->number);
-
-          iphc1   |= SIXLOWPAN_IPHC_DAC;
-          iphc[2] |= daddrcontext->number;
-
-          /* Compession compare with link address (destination) */
-
-          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                      SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* No address context found for this address */
-
-      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
-               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
-               ipv6->destipaddr[3] == 0)
-        {
-          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                    SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* Send the full address */
-
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
+      FAR uint8_t *dstart = g_hc06ptr;
+      uint8_t dbits;
+
+      dbits  = compress_destaddr(ipv6, destmac, daddrcontext, iphc);
+      iphc1 |= dbits;
+
+      /* Remember the encoding for the next frame to this destination */
+
+      net_ipv6addr_copy(dcache->ipaddr, ipv6->destipaddr);
+      memcpy(&dcache->macaddr, destmac, sizeof(struct netdev_varaddr_s));
+      dcache->context = daddrcontext;
+      dcache->iphc1   = dbits;
+      dcache->dci     = iphc[2] & 0x0f;
+      dcache->inlen   = g_hc06ptr - dstart;
+      memcpy(dcache->indata, dstart, dcache->inlen);
+      dcache->valid   = 1;
     }
+#else
+  iphc1 |= compress_destaddr(ipv6, destmac, daddrcontext, iphc);
+#endif
 
   g_uncomp_hdrlen = IPv6_HDRLEN;
 
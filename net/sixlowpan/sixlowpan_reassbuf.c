@@ -47,6 +47,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/wqueue.h>
 
 #include "sixlowpan_internal.h"
 
@@ -58,6 +59,23 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Expired reassemblies are reclaimed by a work item that runs four times
+ * per timeout while any reassembly is active.  Without a work queue, they
+ * are reclaimed when a new reassembly is started.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+#  define REASS_AGING 1
+#  define REASS_AGE_TICK (NET_6LOWPAN_TIMEOUT / 4 + 1)
+#  ifdef CONFIG_SCHED_LPWORK
+#    define REASSWORK LPWORK
+#  else
+#    define REASSWORK HPWORK
+#  endif
+#endif
+
+#define REASS_HASHSIZE CONFIG_NET_6LOWPAN_REASS_HASHSIZE
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -69,9 +87,21 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* Active, allocated reassemby buffers, hashed by reassembly tag and
+ * fragment source.  Each bucket is a list linked through rb_flink.
+ */
+
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_HASHSIZE];
+
+/* Number of active reassembly buffers */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static unsigned int g_nactive_reass;
+
+#ifdef REASS_AGING
+/* Work item that reclaims expired reassemblies */
+
+static struct work_s g_reass_work;
+#endif
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -79,9 +109,32 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the hash bucket for a reassembly tag and fragment source.
+ *
+ ****************************************************************************/
+
+static unsigned int
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen && i < RADIO_MAX_ADDRLEN; i++)
+    {
+      hash = (hash * 31) ^ fragsrc->nv_addr[i];
+    }
+
+  return hash % REASS_HASHSIZE;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -136,40 +189,70 @@ static void sixlowpan_reass_expire(void)
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
   clock_t elapsed;
+  int i;
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < REASS_HASHSIZE && g_nactive_reass > 0; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
-
-      if (!reass->rb_active)
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
         {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
-          /* Get the elpased time of the reassembly */
+          /* Needed if 'reass' is freed */
 
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          next = reass->rb_flink;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* Free any inactive reassembly buffers.  This is done because the
+           * life the reassembly buffer is not cerain.
+           */
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
+          if (!reass->rb_active)
             {
-              nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
+          else
+            {
+              /* Get the elpased time of the reassembly */
+
+              elapsed = clock_systime_ticks() - reass->rb_time;
+
+              /* If the reassembly has expired, then free the reassembly
+               * buffer
+               */
+
+              if (elapsed >= NET_6LOWPAN_TIMEOUT)
+                {
+                  nwarn("WARNING: Reassembly timed out\n");
+                  sixlowpan_reass_free(reass);
+                }
+            }
         }
     }
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_work
+ *
+ * Description:
+ *   Periodically reclaim expired reassembly buffers.
+ *
+ ****************************************************************************/
+
+#ifdef REASS_AGING
+static void sixlowpan_reass_work(FAR void *arg)
+{
+  net_lock();
+  sixlowpan_reass_expire();
+
+  if (g_nactive_reass > 0)
+    {
+      work_queue(REASSWORK, &g_reass_work, sixlowpan_reass_work, NULL,
+                 REASS_AGE_TICK);
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: sixlowpan_remove_active
  *
@@ -189,12 +272,16 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **bucket;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
-  /* Find the reassembly buffer in the list of active reassembly buffers */
+  /* Find the reassembly buffer in its hash bucket */
+
+  bucket = &g_active_reass[sixlowpan_reass_hash(reass->rb_reasstag,
+                                                &reass->rb_fragsrc)];
 
-  for (prev = NULL, curr = g_active_reass;
+  for (prev = NULL, curr = *bucket;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -208,12 +295,15 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *bucket = reass->rb_flink;
         }
       else
         {
           prev->rb_flink = reass->rb_flink;
         }
+
+      DEBUGASSERT(g_nactive_reass > 0);
+      g_nactive_reass--;
     }
 
   reass->rb_flink = NULL;
@@ -246,6 +336,9 @@ void sixlowpan_reass_initialize(void)
   FAR struct sixlowpan_reassbuf_s *reass;
   int i;
 
+  memset(g_active_reass, 0, sizeof(g_active_reass));
+  g_nactive_reass = 0;
+
   /* Initialize g_free_reass, the list of reassembly buffer structures that
    * are available for allocation.
    */
@@ -293,14 +386,17 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **bucket;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
+#ifndef REASS_AGING
   /* First, removed any expired or inactive reassembly buffers.  This might
    * free up a pre-allocated buffer for this allocation.
    */
 
   sixlowpan_reass_expire();
+#endif
 
   /* Now, try the free list first */
 
@@ -340,8 +436,21 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      bucket            = &g_active_reass[sixlowpan_reass_hash(reasstag,
+                                                               fragsrc)];
+      reass->rb_flink   = *bucket;
+      *bucket           = reass;
+      g_nactive_reass++;
+
+#ifdef REASS_AGING
+      /* Make sure that the reassembly does not outlive its timeout */
+
+      if (work_available(&g_reass_work))
+        {
+          work_queue(REASSWORK, &g_reass_work, sixlowpan_reass_work, NULL,
+                     REASS_AGE_TICK);
+        }
+#endif
     }
 
   return reass;
@@ -372,17 +481,11 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
-   */
+  /* Search for the matching reassembly buffer in its hash bucket */
 
-  sixlowpan_reass_expire();
-
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
-   */
-
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_active_reass[sixlowpan_reass_hash(reasstag, fragsrc)];
+       reass != NULL;
+       reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -392,6 +495,18 @@ FAR struct sixlowpan_reassbuf_s *
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          /* We don't want to return an old reassembly buffer with the same
+           * tag.  Expire it now if the aging has not done so yet.
+           */
+
+          if (!reass->rb_active ||
+              clock_systime_ticks() - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+            {
+              nwarn("WARNING: Reassembly timed out\n");
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
@@ -256,7 +256,11 @@ static int sixlowpan_tcp_header(FAR struct tcp_conn_s *conn,
     {
       /* Update the TCP received window based on I/O buffer availability */
 
-      uint16_t recvwndo = tcp_get_recvwindow(dev);
+      uint32_t recvwndo = tcp_get_recvwindow(dev, conn);
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      recvwndo >>= conn->rcv_scale;
+#endif
 
       /* Set the TCP Window */
 
@@ -432,7 +436,7 @@ static uint16_t tcp_send_eventhandler(FAR struct net_driver_s *dev,
   if ((flags & WPAN_NEWDATA) == 0 && sinfo->s_sent < sinfo->s_buflen)
     {
       uint32_t seqno;
-      uint16_t winleft;
+      uint32_t winleft;
       uint16_t sndlen;
 
       /* Get the amount of TCP payload data that we can send in the next
@@ -48,11 +48,14 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <netpacket/packet.h>
+
 #include "socket/socket.h"
 #include "tcp/tcp.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 #include "can/can.h"
+#include "pkt/pkt.h"
 
 /****************************************************************************
  * Private Functions
@@ -391,6 +394,12 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
 #endif
        break;
 
+#ifdef CONFIG_NET_PKT_RING
+      case SOL_PACKET: /* Packet socket options (see include/netpacket/packet.h) */
+       ret = pkt_getsockopt(psock, option, value, value_len);
+       break;
+#endif
+
       /* These levels are defined in sys/socket.h, but are not yet
        * implemented.
        */
@@ -180,11 +180,9 @@ int net_dup2(int sockfd1, int sockfd2)
   psock1 = sockfd_socket(sockfd1);
   psock2 = sockfd_socket(sockfd2);
 
-  /* Verify that the sockfd1 and sockfd2 both refer to valid socket
-   * descriptors and that sockfd2 corresponds to an allocated socket
-   */
+  /* Verify that the sockfd1 refers to a valid socket descriptor */
 
-  if (psock1 == NULL || psock2 == NULL || psock1->s_crefs <= 0)
+  if (psock1 == NULL || psock1->s_crefs <= 0)
     {
       ret = -EBADF;
       goto errout;
@@ -194,11 +192,22 @@ int net_dup2(int sockfd1, int sockfd2)
    * close it!
    */
 
-  if (psock2->s_crefs > 0)
+  if (psock2 != NULL && psock2->s_crefs > 0)
     {
       net_close(sockfd2);
     }
 
+  /* Then allocate sockfd2, possibly in a block of sockets not used so
+   * far.
+   */
+
+  psock2 = sockfd_reserve(sockfd2);
+  if (psock2 == NULL)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
   /* Duplicate the socket state */
 
   ret = psock_dup2(psock1, psock2);
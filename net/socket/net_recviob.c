@@ -0,0 +1,98 @@
+/****************************************************************************
+ * net/socket/net_recviob.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET_RECVIOB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Receive data without copying it:  The I/O buffer chain holding the
+ *   next read-ahead data of the socket is removed from the socket and
+ *   returned to the caller, who then owns it.  See include/nuttx/net/net.h
+ *   for the details.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   iob     - Location to return the I/O buffer chain
+ *   flags   - Receive flags
+ *   from    - Address of source (may be NULL; datagram sockets only)
+ *   fromlen - The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the chain.  Zero is
+ *   returned if the peer has performed an orderly shutdown.  Otherwise a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags, FAR struct sockaddr *from,
+                      FAR socklen_t *fromlen)
+{
+  /* Verify that non-NULL pointers were passed */
+
+  if (iob == NULL || (from != NULL && fromlen == NULL))
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  /* The address family indicates its support with a non-NULL
+   * si_recviob() method in the socket interface.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_recviob == NULL)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  *iob = NULL;
+  return psock->s_sockif->si_recviob(psock, iob, flags, from, fromlen);
+}
+
+#endif /* CONFIG_NET_RECVIOB */
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <sched.h>
@@ -47,6 +48,147 @@ static void _net_semtake(FAR struct socketlist *list)
 
 #define _net_semgive(list) nxsem_post(&list->sl_sem)
 
+/****************************************************************************
+ * Name: _net_findfree
+ *
+ * Description:
+ *   Return the index of the lowest free socket >= minsd, or -EMFILE if all
+ *   of them are in use.  A whole word of the bitmap is tested at once.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static int _net_findfree(FAR struct socketlist *list, int minsd)
+{
+  uint32_t avail;
+  int ndx;
+  int i;
+
+  if (minsd < 0 || minsd >= CONFIG_NSOCKET_DESCRIPTORS)
+    {
+      return -EMFILE;
+    }
+
+  /* Ignore the sockets below minsd in the first word */
+
+  ndx   = minsd >> 5;
+  avail = ~list->sl_used[ndx] & ~((1ul << (minsd & 31)) - 1);
+
+  for (; ; )
+    {
+      if (avail != 0)
+        {
+          i = (ndx << 5) + __builtin_ctz(avail);
+          return i < CONFIG_NSOCKET_DESCRIPTORS ? i : -EMFILE;
+        }
+
+      if (++ndx >= SOCKETS_NWORDS)
+        {
+          return -EMFILE;
+        }
+
+      avail = ~list->sl_used[ndx];
+    }
+}
+
+/****************************************************************************
+ * Name: _net_extend
+ *
+ * Description:
+ *   Make sure that the block holding socket 'ndx' is allocated.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static int _net_extend(FAR struct socketlist *list, int ndx)
+{
+  FAR struct socket **block = &list->sl_sockets[ndx / SOCKETS_PER_BLOCK];
+
+  if (*block == NULL)
+    {
+      *block = (FAR struct socket *)
+        kmm_zalloc(SOCKETS_PER_BLOCK * sizeof(struct socket));
+      if (*block == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: _net_socket
+ *
+ * Description:
+ *   Return socket 'ndx' of the list or NULL if its block is not allocated.
+ *
+ ****************************************************************************/
+
+static FAR struct socket *_net_socket(FAR struct socketlist *list, int ndx)
+{
+  FAR struct socket *block = list->sl_sockets[ndx / SOCKETS_PER_BLOCK];
+
+  return block != NULL ? &block[ndx % SOCKETS_PER_BLOCK] : NULL;
+}
+
+/****************************************************************************
+ * Name: _net_index
+ *
+ * Description:
+ *   Return the index of 'psock' in 'list', or -1 if the socket is not part
+ *   of the list.
+ *
+ ****************************************************************************/
+
+static int _net_index(FAR struct socketlist *list, FAR struct socket *psock)
+{
+  int i;
+
+  for (i = 0; i < SOCKETS_NBLOCKS; i++)
+    {
+      FAR struct socket *block = list->sl_sockets[i];
+
+      if (block != NULL && psock >= block &&
+          psock < block + SOCKETS_PER_BLOCK)
+        {
+          return i * SOCKETS_PER_BLOCK + (int)(psock - block);
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: _net_setused
+ *
+ * Description:
+ *   Mark socket 'ndx' allocated or free.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static void _net_setused(FAR struct socketlist *list, int ndx, bool used)
+{
+  if (ndx >= 0)
+    {
+      if (used)
+        {
+          list->sl_used[ndx >> 5] |= 1ul << (ndx & 31);
+        }
+      else
+        {
+          list->sl_used[ndx >> 5] &= ~(1ul << (ndx & 31));
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -67,6 +209,11 @@ static void _net_semtake(FAR struct socketlist *list)
 
 void net_initlist(FAR struct socketlist *list)
 {
+  /* No sockets are allocated until they are first used */
+
+  memset(list->sl_used, 0, sizeof(list->sl_used));
+  memset(list->sl_sockets, 0, sizeof(list->sl_sockets));
+
   /* Initialize the list access mutex */
 
   nxsem_init(&list->sl_sem, 0, 1);
@@ -97,18 +244,69 @@ void net_releaselist(FAR struct socketlist *list)
 
   for (ndx = 0; ndx < CONFIG_NSOCKET_DESCRIPTORS; ndx++)
     {
-      FAR struct socket *psock = &list->sl_sockets[ndx];
-      if (psock->s_crefs > 0)
+      FAR struct socket *psock = _net_socket(list, ndx);
+      if (psock != NULL && psock->s_crefs > 0)
         {
           psock_close(psock);
         }
     }
 
+  /* And free the socket storage */
+
+  for (ndx = 0; ndx < SOCKETS_NBLOCKS; ndx++)
+    {
+      kmm_free(list->sl_sockets[ndx]);
+      list->sl_sockets[ndx] = NULL;
+    }
+
+  memset(list->sl_used, 0, sizeof(list->sl_used));
+
   /* Destroy the semaphore */
 
   nxsem_destroy(&list->sl_sem);
 }
 
+/****************************************************************************
+ * Name: net_duplist
+ *
+ * Description:
+ *   Duplicate the valid sockets of 'plist' that are not close-on-exec
+ *   into the new list 'clist'.
+ *
+ ****************************************************************************/
+
+void net_duplist(FAR struct socketlist *plist, FAR struct socketlist *clist)
+{
+  FAR struct socket *parent;
+  int ndx;
+
+  _net_semtake(clist);
+  for (ndx = 0; ndx < CONFIG_NSOCKET_DESCRIPTORS; ndx++)
+    {
+      /* Check if this parent socket is valid.  Valid means both (1)
+       * allocated and (2) successfully initialized.  A complexity in SMP
+       * mode is that a socket my be allocated, but not yet initialized when
+       * the socket is cloned by another pthread.
+       *
+       * Sockets with the close-on-exec flag set should not be cloned either.
+       */
+
+      parent = _net_socket(plist, ndx);
+      if (parent != NULL && _PS_VALID(parent) &&
+          !_SS_ISCLOEXEC(parent->s_flags) && _net_extend(clist, ndx) >= 0)
+        {
+          /* Yes... duplicate it for the child */
+
+          if (psock_dup2(parent, _net_socket(clist, ndx)) >= 0)
+            {
+              _net_setused(clist, ndx, true);
+            }
+        }
+    }
+
+  _net_semgive(clist);
+}
+
 /****************************************************************************
  * Name: sockfd_allocate
  *
@@ -127,6 +325,7 @@ void net_releaselist(FAR struct socketlist *list)
 int sockfd_allocate(int minsd)
 {
   FAR struct socketlist *list;
+  FAR struct socket *psock;
   int i;
 
   /* Get the socket list for this task/thread */
@@ -134,24 +333,22 @@ int sockfd_allocate(int minsd)
   list = nxsched_get_sockets();
   if (list)
     {
-      /* Search for a socket structure with no references */
+      /* Find the lowest socket structure with no references */
 
       _net_semtake(list);
-      for (i = minsd; i < CONFIG_NSOCKET_DESCRIPTORS; i++)
+      i = _net_findfree(list, minsd);
+      if (i >= 0 && _net_extend(list, i) >= 0)
         {
-          /* Are there references on this socket? */
+          /* Take the reference and return the index + an offset as the
+           * socket descriptor.
+           */
 
-          if (!list->sl_sockets[i].s_crefs)
-            {
-              /* No take the reference and return the index + an offset
-               * as the socket descriptor.
-               */
-
-              memset(&list->sl_sockets[i], 0, sizeof(struct socket));
-              list->sl_sockets[i].s_crefs = 1;
-              _net_semgive(list);
-              return i + __SOCKFD_OFFSET;
-            }
+          psock = _net_socket(list, i);
+          memset(psock, 0, sizeof(struct socket));
+          psock->s_crefs = 1;
+          _net_setused(list, i, true);
+          _net_semgive(list);
+          return i + __SOCKFD_OFFSET;
         }
 
       _net_semgive(list);
@@ -160,6 +357,46 @@ int sockfd_allocate(int minsd)
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: sockfd_reserve
+ *
+ * Description:
+ *   Allocate the specific, currently free socket descriptor 'sockfd', as
+ *   needed by dup2().
+ *
+ * Input Parameters:
+ *   sockfd - The socket descriptor to allocate.
+ *
+ * Returned Value:
+ *   The zeroed socket structure, without references, or NULL if the
+ *   descriptor is not valid, is in use or no memory is available.
+ *
+ ****************************************************************************/
+
+FAR struct socket *sockfd_reserve(int sockfd)
+{
+  FAR struct socketlist *list;
+  FAR struct socket *psock = NULL;
+  int ndx = sockfd - __SOCKFD_OFFSET;
+
+  list = nxsched_get_sockets();
+  if (list != NULL && ndx >= 0 && ndx < CONFIG_NSOCKET_DESCRIPTORS)
+    {
+      _net_semtake(list);
+      if ((list->sl_used[ndx >> 5] & (1ul << (ndx & 31))) == 0 &&
+          _net_extend(list, ndx) >= 0)
+        {
+          psock = _net_socket(list, ndx);
+          memset(psock, 0, sizeof(struct socket));
+          _net_setused(list, ndx, true);
+        }
+
+      _net_semgive(list);
+    }
+
+  return psock;
+}
+
 /****************************************************************************
  * Name: psock_release
  *
@@ -176,6 +413,8 @@ int sockfd_allocate(int minsd)
 
 void psock_release(FAR struct socket *psock)
 {
+  FAR struct socketlist *list;
+
   if (psock != NULL)
     {
       /* Decrement the count if there the socket will persist
@@ -191,6 +430,16 @@ void psock_release(FAR struct socket *psock)
           /* The socket will not persist... reset it */
 
           memset(psock, 0, sizeof(struct socket));
+
+          /* And make it available again if it is one of our sockets */
+
+          list = nxsched_get_sockets();
+          if (list != NULL)
+            {
+              _net_semtake(list);
+              _net_setused(list, _net_index(list, psock), false);
+              _net_semgive(list);
+            }
         }
     }
 }
@@ -211,24 +460,11 @@ void psock_release(FAR struct socket *psock)
 
 void sockfd_release(int sockfd)
 {
-  /* Get the socket structure for this sockfd */
-
-  FAR struct socket *psock = sockfd_socket(sockfd);
-
-  if (psock)
-    {
-      /* Take the list semaphore so that there will be no accesses
-       * to this socket structure.
-       */
+  /* Get the socket structure for this sockfd.  psock_release() takes the
+   * list semaphore when the socket is freed.
+   */
 
-      FAR struct socketlist *list = nxsched_get_sockets();
-      if (list)
-        {
-          _net_semtake(list);
-          psock_release(psock);
-          _net_semgive(list);
-        }
-    }
+  psock_release(sockfd_socket(sockfd));
 }
 
 /****************************************************************************
@@ -256,7 +492,7 @@ FAR struct socket *sockfd_socket(int sockfd)
       list = nxsched_get_sockets();
       if (list)
         {
-          return &list->sl_sockets[ndx];
+          return _net_socket(list, ndx);
         }
     }
 
@@ -0,0 +1,230 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmmsg_one
+ *
+ * Description:
+ *   Receive a single datagram into one mmsghdr entry.
+ *
+ ****************************************************************************/
+
+static ssize_t recvmmsg_one(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags)
+{
+#ifdef CONFIG_NET_CMSG
+  return psock_recvmsg(psock, msg, flags);
+#else
+  FAR socklen_t *fromlen;
+
+  if (msg->msg_iovlen != 1)
+    {
+      return -ENOTSUP;
+    }
+
+  fromlen = msg->msg_name != NULL ? (FAR socklen_t *)&msg->msg_namelen :
+            NULL;
+
+  return psock_recvfrom(psock, msg->msg_iov->iov_base,
+                        msg->msg_iov->iov_len, flags, msg->msg_name,
+                        fromlen);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to 'vlen' datagrams from a socket in a
+ *   single call.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   The network is locked once for the whole batch if the caller will not
+ *   block in the loop (MSG_DONTWAIT).  Otherwise each receive takes the
+ *   lock itself, so that a blocking receive can release it normally.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - Array of message headers; msg_len is set for each entry
+ *   vlen    - Number of entries in msgvec
+ *   flags   - Receive flags, including MSG_WAITFORONE
+ *   timeout - Optional overall timeout, checked after each datagram
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams received.  If none could be
+ *   received, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout)
+{
+  clock_t start = 0;
+  clock_t ticks = 0;
+  unsigned int count = 0;
+  bool locked = false;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_nsec < 0 || timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+      start = clock_systime_ticks();
+    }
+
+  if ((flags & MSG_DONTWAIT) != 0)
+    {
+      net_lock();
+      locked = true;
+    }
+
+  for (; count < vlen; count++)
+    {
+      ret = recvmmsg_one(psock, &msgvec[count].msg_hdr,
+                         flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = (unsigned int)ret;
+
+      /* After the first datagram, MSG_WAITFORONE turns the rest of the
+       * batch into non-blocking receives.
+       */
+
+      if ((flags & MSG_WAITFORONE) != 0 && (flags & MSG_DONTWAIT) == 0)
+        {
+          flags |= MSG_DONTWAIT;
+          net_lock();
+          locked = true;
+        }
+
+      if (timeout != NULL && clock_systime_ticks() - start >= ticks)
+        {
+          count++;
+          break;
+        }
+    }
+
+  if (locked)
+    {
+      net_unlock();
+    }
+
+  /* Report an error only if nothing was received.  Otherwise the error
+   * will be reported (again) on the next call.
+   */
+
+  return count > 0 ? (int)count : (int)ret;
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() call receives multiple datagrams from a socket with a
+ *   single call.  Each element of 'msgvec' is filled as by recvmsg() and
+ *   its msg_len field is set to the number of bytes received.
+ *
+ * Input Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msgvec  - Array of message headers
+ *   vlen    - Number of entries in msgvec
+ *   flags   - Receive flags, including MSG_WAITFORONE
+ *   timeout - Optional timeout (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned, and errno is set appropriately (see recvmsg()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+  if (ret < 0)
+    {
+      _SO_SETERRNO(psock, -ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -0,0 +1,188 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendmmsg_one
+ *
+ * Description:
+ *   Send the datagram described by one mmsghdr entry.
+ *
+ ****************************************************************************/
+
+static ssize_t sendmmsg_one(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags)
+{
+#ifdef CONFIG_NET_CMSG
+  return psock_sendmsg(psock, msg, flags);
+#else
+  if (msg->msg_iovlen != 1)
+    {
+      return -ENOTSUP;
+    }
+
+  return psock_sendto(psock, msg->msg_iov->iov_base,
+                      msg->msg_iov->iov_len, flags, msg->msg_name,
+                      msg->msg_namelen);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends up to 'vlen' datagrams on a socket in a single
+ *   call.  This is an internal OS interface.  It is functionally equivalent
+ *   to sendmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   The network is locked once for the whole batch when MSG_DONTWAIT is
+ *   set; otherwise each send takes the lock itself so that a blocking send
+ *   can release it normally.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - Array of message headers; msg_len is set for each entry
+ *   vlen    - Number of entries in msgvec
+ *   flags   - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams sent.  If none could be
+ *   sent, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  unsigned int count;
+  bool locked = false;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if ((flags & MSG_DONTWAIT) != 0)
+    {
+      net_lock();
+      locked = true;
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      ret = sendmmsg_one(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = (unsigned int)ret;
+    }
+
+  if (locked)
+    {
+      net_unlock();
+    }
+
+  /* Report an error only if nothing was sent */
+
+  return count > 0 ? (int)count : (int)ret;
+}
+
+/****************************************************************************
+ * Name: sendmmsg
+ *
+ * Description:
+ *   The sendmmsg() call sends multiple datagrams on a socket with a single
+ *   call.  Each element of 'msgvec' is sent as by sendmsg() and its msg_len
+ *   field is set to the number of bytes sent.
+ *
+ * Input Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msgvec  - Array of message headers
+ *   vlen    - Number of entries in msgvec
+ *   flags   - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  On error, -1 is
+ *   returned, and errno is set appropriately (see sendmsg()).
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* Let psock_sendmmsg() do all of the work */
+
+  ret = psock_sendmmsg(psock, msgvec, vlen, flags);
+  if (ret < 0)
+    {
+      _SO_SETERRNO(psock, -ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -49,6 +49,7 @@
 #include <assert.h>
 #include <arch/irq.h>
 
+#include <netpacket/packet.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -58,6 +59,7 @@
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 #include "can/can.h"
+#include "pkt/pkt.h"
 
 /****************************************************************************
  * Public Functions
@@ -429,6 +431,12 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_PKT_RING
+      case SOL_PACKET:    /* Packet socket options (see include/netpacket/packet.h) */
+        ret = pkt_setsockopt(psock, option, value, value_len);
+        break;
+#endif
+
       default:         /* The provided level is invalid */
         ret = -EINVAL;
         break;
@@ -156,6 +156,24 @@ extern "C"
 
 int sockfd_allocate(int minsd);
 
+/****************************************************************************
+ * Name: sockfd_reserve
+ *
+ * Description:
+ *   Allocate the specific, currently free socket descriptor 'sockfd', as
+ *   needed by dup2().
+ *
+ * Input Parameters:
+ *   sockfd - The socket descriptor to allocate.
+ *
+ * Returned Value:
+ *   The zeroed socket structure, without references, or NULL if the
+ *   descriptor is not valid, is in use or no memory is available.
+ *
+ ****************************************************************************/
+
+FAR struct socket *sockfd_reserve(int sockfd);
+
 /****************************************************************************
  * Name: psock_release
  *
@@ -49,7 +49,8 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 
-#ifdef CONFIG_NET_TCP_NOTIFIER
+#if defined(CONFIG_NET_TCP_NOTIFIER) || \
+    defined(CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT)
 #  include <nuttx/wqueue.h>
 #endif
 
@@ -100,6 +101,16 @@
 #  endif
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+/* Number of duplicate ACKs that trigger a fast retransmission */
+
+#  define TCP_DUPACK_THRESH  3
+
+/* Number of SACKed ranges remembered per connection */
+
+#  define TCP_SACK_NSCORE    4
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -122,6 +133,49 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_cc_ops_s;      /* Forward reference */
+#endif
+#ifdef CONFIG_NET_TCP_CONNSTATS
+struct tcp_info;          /* Forward reference */
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+/* A range of sequence numbers that the peer has selectively acknowledged */
+
+struct tcp_sackblock_s
+{
+  uint32_t sb_start;      /* First SACKed sequence number */
+  uint32_t sb_end;        /* Sequence number just after the range */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+/* Per-connection statistics, maintained by tcp_stats.c.  The round trip
+ * time is measured on one data segment at a time and never on a
+ * retransmitted one (Karn's algorithm).
+ */
+
+struct tcp_connstats_s
+{
+  uint32_t segsout;       /* Segments sent */
+  uint32_t segsin;        /* Segments received */
+  uint32_t bytesacked;    /* Data bytes acknowledged by the peer */
+  uint32_t bytesrcvd;     /* In-order data bytes received */
+  uint32_t rexmits;       /* Data segments retransmitted */
+  uint32_t timeouts;      /* Retransmission time-outs */
+  uint32_t dupacks;       /* Duplicate ACKs received */
+  uint32_t zerowins;      /* Zero windows advertised by the peer */
+  uint32_t srtt;          /* Smoothed round trip time (usec, 0: no sample) */
+  uint32_t rttvar;        /* Round trip time variation (usec) */
+  uint32_t snduna;        /* Oldest sequence number not yet ACKed */
+  uint32_t sndmax;        /* Sequence number after the highest data sent */
+  uint32_t sndwnd;        /* Last window advertised by the peer */
+  uint32_t rttseq;        /* ACK number that ends the round trip sample */
+  uint32_t rttstart;      /* Time that the timed segment was sent (usec) */
+  bool     rttvalid;      /* True: A segment is being timed */
+};
+#endif
 
 /* This is a container that holds the poll-related information */
 
@@ -186,12 +240,31 @@ struct tcp_conn_s
 #ifdef CONFIG_NET_TCP_DELAYED_ACK
   uint8_t  rx_unackseg;   /* Number of un-ACKed received segments */
   uint8_t  rx_acktimer;   /* Time since last ACK sent (units: half-seconds) */
+  uint32_t rx_ackseq;     /* rcvseq when the last ACK was sent */
+#ifdef CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT
+  bool     rx_ackdue;     /* True: The delayed ACK timeout has expired */
+
+  /* Work item run when the delayed ACK timeout expires */
+
+  struct work_s rx_ackwork;
+#endif
 #endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
+#ifdef CONFIG_NET_TCP_HASH
+  bool     tuplehashed;   /* True: conn is in the connection hash */
+  bool     porthashed;    /* True: conn is in the local port hash */
+  dq_entry_t hnode;       /* Link in the connection (address/port) hash */
+  dq_entry_t pnode;       /* Link in the local port hash */
+#endif
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
-  uint16_t winsize;       /* Current window size of the connection */
+  uint32_t winsize;       /* Current window size of the connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  bool     wsok;          /* True: The peer sent a window scale option */
+  uint8_t  snd_scale;     /* Shift applied to the peer's window */
+  uint8_t  rcv_scale;     /* Shift applied to our advertised window */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t tx_unacked;    /* Number bytes sent but not yet ACKed */
 #else
@@ -232,6 +305,45 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control (RFC 5681 and RFC 6582).  Windows are in bytes.
+   *
+   *   cc_ops     - The congestion control algorithm
+   *   cwnd       - Congestion window
+   *   ssthresh   - Slow start threshold
+   *   lastack    - Highest ACK number received so far
+   *   recover    - Highest sequence number sent when recovery started
+   *   rtxnext    - Next sequence number to retransmit during recovery
+   *   dupacks    - Number of consecutive duplicate ACKs received
+   *   inrecovery - True: In fast recovery
+   *   rtxpending - True: A fast retransmission should be sent
+   */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+  uint32_t   cwnd;
+  uint32_t   ssthresh;
+  uint32_t   lastack;
+  uint32_t   recover;
+  uint32_t   rtxnext;
+  uint8_t    dupacks;
+  bool       inrecovery;
+  bool       rtxpending;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t   cubic_wmax;  /* cwnd just before the last reduction */
+  uint32_t   cubic_k;     /* Time to grow back to cubic_wmax (msec) */
+  clock_t    cubic_epoch; /* Start of the current growth epoch (0: none) */
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+  /* Selective acknowledgment (RFC 2018).  sacks[] holds the ranges above
+   * lastack that the peer has reported, sorted and without overlaps.
+   */
+
+  bool       sackperm;    /* True: Both ends sent SACK permitted */
+  uint8_t    nsacks;      /* Number of valid entries in sacks[] */
+  struct tcp_sackblock_s sacks[TCP_SACK_NSCORE];
+#endif
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -262,6 +374,10 @@ struct tcp_conn_s
   uint8_t    keepretries; /* Number of retries attempted */
 #endif
 
+#ifdef CONFIG_NET_TCP_CONNSTATS
+  struct tcp_connstats_s stats; /* Per-connection statistics */
+#endif
+
   /* connevents is a list of callbacks for each socket the uses this
    * connection (there can be more that one in the event that the the socket
    * was dup'ed).  It is used with the network monitor to handle
@@ -303,6 +419,27 @@ struct tcp_wrbuffer_s
 };
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+/* A congestion control algorithm.  All functions are called with the
+ * network locked.
+ *
+ *   name     - Name of the algorithm
+ *   init     - Initialize algorithm state when the connection is
+ *              established.  cwnd and ssthresh are already set. May be NULL.
+ *   ack      - 'acked' new bytes were ACKed outside of fast recovery.  Grow
+ *              cwnd.
+ *   ssthresh - Loss was detected.  Return the new slow start threshold.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*ack)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+#endif
+
 /* Support for listen backlog:
  *
  *   struct tcp_blcontainer_s describes one backlogged connection
@@ -1293,6 +1430,29 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR void *buf,
                            size_t len, int flags, FAR struct sockaddr *from,
                            FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: psock_tcp_recviob
+ *
+ * Description:
+ *   Remove the I/O buffer chain at the head of the read-ahead queue of a
+ *   TCP socket and lend it to the caller, waiting for data if necessary.
+ *
+ * Input Parameters:
+ *   psock - Pointer to the socket structure for the SOCK_STREAM socket
+ *   iob   - Location to return the I/O buffer chain
+ *   flags - Receive flags (only MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   The number of bytes in the chain on success; zero at the end of the
+ *   stream; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_tcp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags);
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_send
  *
@@ -1430,14 +1590,35 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
  *   Calculate the TCP receive window for the specified device.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The connection whose window scale limits the window.
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The value of the TCP receive window to use, before scaling.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev);
+uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_get_rcvscale
+ *
+ * Description:
+ *   Select the window scale shift to offer on a connection:  The smallest
+ *   shift that can represent a receive window holding every IOB.
+ *
+ * Input Parameters:
+ *   dev - The device that the connection uses.
+ *
+ * Returned Value:
+ *   The window scale shift, 0 through TCP_WS_MAXSHIFT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_rcvscale(FAR struct net_driver_s *dev);
+#endif
 
 /****************************************************************************
  * Name: psock_tcp_cansend
@@ -1569,6 +1750,172 @@ void tcp_wrbuffer_dump(FAR const char *msg, FAR struct tcp_wrbuffer_s *wrb,
 #endif
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   been established.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_cc_init(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state for an incoming ACK.  This detects
+ *   duplicate ACKs, enters and leaves fast recovery and grows cwnd.
+ *   conn->rtxpending is set when a fast retransmission is due.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection
+ *   ackno - The ACK number of the incoming segment
+ *   flags - The event flags; TCP_NEWDATA means that the segment had data
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                uint16_t flags);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control state after a retransmission timeout.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_nexthole
+ *
+ * Description:
+ *   Return the next range of sequence numbers to retransmit during fast
+ *   recovery.  Without SACK this is the data just after the last ACK;
+ *   with SACK it is the lowest range not yet retransmitted that the peer
+ *   has not selectively acknowledged.
+ *
+ * Returned Value:
+ *   True if there is something to retransmit, in [*start, *end).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+bool tcp_cc_nexthole(FAR struct tcp_conn_s *conn, FAR uint32_t *start,
+                     FAR uint32_t *end);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Parse the options of an incoming ACK and merge any SACK blocks into the
+ *   scoreboard of the connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   opts   - The TCP options of the incoming segment
+ *   optlen - The length of the options
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR const uint8_t *opts,
+                    unsigned int optlen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_stats_send
+ *
+ * Description:
+ *   Account for a segment that is about to be sent:  count it, start a
+ *   round trip time sample on new data or count a retransmission.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   tcp    - The TCP header of the outgoing segment
+ *   len    - The length of the data in the segment
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+void tcp_stats_send(FAR struct tcp_conn_s *conn,
+                    FAR const struct tcp_hdr_s *tcp, unsigned int len);
+#else
+#  define tcp_stats_send(conn,tcp,len)
+#endif
+
+/****************************************************************************
+ * Name: tcp_stats_input
+ *
+ * Description:
+ *   Account for a segment received on a connection:  count it and its
+ *   in-order data, duplicate ACKs and zero windows, and complete the round
+ *   trip time sample if the segment ACKs the timed data.  conn->winsize
+ *   must already hold the window of the segment.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   tcp    - The TCP header of the incoming segment
+ *   len    - The length of the data in the segment
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+void tcp_stats_input(FAR struct tcp_conn_s *conn,
+                     FAR const struct tcp_hdr_s *tcp, unsigned int len);
+#else
+#  define tcp_stats_input(conn,tcp,len)
+#endif
+
+/****************************************************************************
+ * Name: tcp_stats_timeout
+ *
+ * Description:
+ *   Account for a retransmission time-out.  The segment being timed will
+ *   be retransmitted, so the round trip time sample is abandoned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+void tcp_stats_timeout(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_stats_timeout(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_stats_info
+ *
+ * Description:
+ *   Fill in a struct tcp_info (see netinet/tcp.h) for a connection.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+void tcp_stats_info(FAR struct tcp_conn_s *conn,
+                    FAR struct tcp_info *info);
+#endif
+
 /****************************************************************************
  * Name: tcp_pollsetup
  *
@@ -48,13 +48,44 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/tcp.h>
 
+#include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ack_work
+ *
+ * Description:
+ *   The delayed ACK timeout expired.  Ask the device for a poll so that
+ *   tcp_poll() can send the ACK.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT
+static void tcp_ack_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  net_lock();
+  if (conn->rx_unackseg > 0 && conn->dev != NULL)
+    {
+      conn->rx_ackdue = true;
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,19 +136,20 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * NOTES:
        * 1. If there is a data payload or other flags to be sent with the
        *    outgoing packet, then we may as well include the ACK too.
-       * 2. The RFC refers to full-size segments.  It is not clear what
-       *    "full-size" means.  Does that mean that the payload is the size
-       *    of the MSS?  Payload size is not considered other there being
-       *    a payload or or not.  Should there be some special action for
-       *    small payloads of size < MSS?
+       * 2. Two full-size segments are detected by counting the bytes
+       *    received since the last ACK was sent:  As soon as that exceeds
+       *    one MSS, the ACK is sent.  Peers that send segments a little
+       *    smaller than the MSS (e.g. because of TCP options) get an ACK
+       *    for every second segment too, while a stream of small
+       *    segments is only ACKed by the delay timer.
        * 3. Experimentation shows that Windows and Linux behave somewhat
        *    differently; they delay the ACKs for many more segments (6 or
        *    more).  Delaying for more segments would provide less network
        *    traffic and better performance but seems non-compliant.
        */
 
-      if (conn->rx_unackseg > 0 || dev->d_sndlen > 0 ||
-          result != TCP_SNDACK)
+      if (dev->d_sndlen > 0 || result != TCP_SNDACK ||
+          tcp_getsequence(conn->rcvseq) - conn->rx_ackseq > conn->mss)
         {
           /* Reset the delayed ACK state and send the ACK with this packet. */
 
@@ -125,12 +157,25 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
         }
       else
         {
-          /* This is only an ACK and there is no pending delayed ACK and
-           * no TX data is being sent.  Indicate that there is one un-ACKed
+          /* This is only an ACK for less than two full-size segments and
+           * no TX data is being sent.  Indicate that there is an un-ACKed
            * segment and don't send anything now.
            */
 
           conn->rx_unackseg = 1;
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT
+          /* Start the delay timer unless it is already running for an
+           * earlier segment.
+           */
+
+          if (work_available(&conn->rx_ackwork))
+            {
+              work_queue(LPWORK, &conn->rx_ackwork, tcp_ack_work, conn,
+                         MSEC2TICK(CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT));
+            }
+#endif
+
           return;
         }
     }
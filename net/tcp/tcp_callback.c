@@ -111,6 +111,8 @@ tcp_data_event(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #ifdef CONFIG_NET_STATISTICS
           g_netstats.tcp.drop++;
 #endif
+          NETDEV_RXDROP(dev, NETDEV_RXDROP_NOBUFS);
+
           /* Clear the TCP_SNDACK bit so that no ACK will be sent */
 
           ret &= ~TCP_SNDACK;
@@ -243,6 +245,39 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
   FAR struct iob_s *iob;
   int ret;
 
+#ifdef CONFIG_NET_TCP_RECV_COALESCE
+  /* Append the data to the chain at the tail of the read-ahead queue.  That
+   * fills up the last, partially used IOB and needs no queue entry.  The
+   * reader has been told about that chain already.
+   */
+
+  if (conn->readahead.qh_tail != NULL)
+    {
+      unsigned int pktlen;
+
+      iob    = conn->readahead.qh_tail->qe_head;
+      pktlen = iob->io_pktlen;
+
+      if (pktlen + buflen <= UINT16_MAX)
+        {
+          ret = iob_trycopyin(iob, buffer, buflen, pktlen, true,
+                              IOBUSER_NET_TCP_READAHEAD);
+          if (ret >= 0)
+            {
+              ninfo("Appended %d bytes\n", buflen);
+              return buflen;
+            }
+
+          /* Remove whatever part of the data was copied in */
+
+          nerr("ERROR: Failed to append to the I/O buffer chain: %d\n", ret);
+          iob_trimtail(iob, iob->io_pktlen - pktlen,
+                       IOBUSER_NET_TCP_READAHEAD);
+          return 0;
+        }
+    }
+#endif
+
   /* Try to allocate on I/O buffer to start the chain without waiting (and
    * throttling as necessary).  If we would have to wait, then drop the
    * packet.
@@ -0,0 +1,749 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Sequence number comparisons that handle wrap-around */
+
+#define SEQ_LT(a,b)  ((int32_t)((a) - (b)) < 0)
+#define SEQ_LE(a,b)  ((int32_t)((a) - (b)) <= 0)
+#define SEQ_GT(a,b)  ((int32_t)((a) - (b)) > 0)
+#define SEQ_GE(a,b)  ((int32_t)((a) - (b)) >= 0)
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* CUBIC parameters (RFC 8312):  beta_cubic = 0.7 (in 1/1024 units) and
+ * C = 0.4 segments/sec^3.
+ */
+
+#  define CUBIC_BETA      717
+#  define CUBIC_BETA_ONE  1024
+
+/* Clamp |t - K| to about 16 minutes so that the cube can not overflow */
+
+#  define CUBIC_MAXDELTA  1000000
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void     newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static void     cubic_init(FAR struct tcp_conn_s *conn);
+static void     cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct tcp_cc_ops_s g_tcp_newreno =
+{
+  "newreno",
+  NULL,
+  newreno_ack,
+  newreno_ssthresh
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static const struct tcp_cc_ops_s g_tcp_cubic =
+{
+  "cubic",
+  cubic_init,
+  cubic_ack,
+  cubic_ssthresh
+};
+
+#  define TCP_CC_DEFAULT (&g_tcp_cubic)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_newreno)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: newreno_ack
+ *
+ * Description:
+ *   Slow start below ssthresh, otherwise grow cwnd by about one MSS per
+ *   round trip (RFC 5681).
+ *
+ ****************************************************************************/
+
+static void newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t incr;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      incr = acked < conn->mss ? acked : conn->mss;
+    }
+  else
+    {
+      incr = ((uint32_t)conn->mss * conn->mss) / conn->cwnd;
+      if (incr == 0)
+        {
+          incr = 1;
+        }
+    }
+
+  conn->cwnd += incr;
+}
+
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   Halve the data in flight, but keep at least two segments.
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh = conn->tx_unacked / 2;
+
+  if (ssthresh < 2 * (uint32_t)conn->mss)
+    {
+      ssthresh = 2 * (uint32_t)conn->mss;
+    }
+
+  return ssthresh;
+}
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t lo = 0;
+  uint64_t hi = 2097152; /* cbrt(2^63) */
+
+  while (lo < hi)
+    {
+      uint64_t mid = (lo + hi + 1) / 2;
+
+      if (mid * mid * mid <= x)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid - 1;
+        }
+    }
+
+  return (uint32_t)lo;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cubic_wmax  = 0;
+  conn->cubic_k     = 0;
+  conn->cubic_epoch = 0;
+}
+
+/****************************************************************************
+ * Name: cubic_ack
+ *
+ * Description:
+ *   Slow start below ssthresh.  Otherwise, move cwnd towards
+ *   W(t) = C * (t - K)^3 + Wmax, where t is the time since the start of
+ *   the epoch.
+ *
+ ****************************************************************************/
+
+static void cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t mss = conn->mss;
+  int64_t delta;
+  int64_t target;
+  clock_t now;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      conn->cwnd += acked < mss ? acked : mss;
+      return;
+    }
+
+  now = clock_systime_ticks();
+  if (conn->cubic_epoch == 0)
+    {
+      /* A new epoch.  K is the time (in msec) needed to grow back to Wmax:
+       * K = cbrt((Wmax - cwnd) / C) with windows in segments.
+       */
+
+      conn->cubic_epoch = now != 0 ? now : 1;
+      if (conn->cwnd < conn->cubic_wmax)
+        {
+          conn->cubic_k =
+            cubic_cbrt((uint64_t)(conn->cubic_wmax - conn->cwnd) *
+                       2500000 / mss * 1000);
+        }
+      else
+        {
+          conn->cubic_wmax = conn->cwnd;
+          conn->cubic_k    = 0;
+        }
+    }
+
+  delta = (int64_t)TICK2MSEC(now - conn->cubic_epoch) - conn->cubic_k;
+  if (delta > CUBIC_MAXDELTA)
+    {
+      delta = CUBIC_MAXDELTA;
+    }
+  else if (delta < -CUBIC_MAXDELTA)
+    {
+      delta = -CUBIC_MAXDELTA;
+    }
+
+  /* C * delta^3 segments with delta in msec, converted to bytes */
+
+  target = (int64_t)conn->cubic_wmax +
+           (delta * delta * delta / 1000000) * 4 * mss / 10000;
+
+  if (target > (int64_t)conn->cwnd)
+    {
+      int64_t diff = target - conn->cwnd;
+      uint32_t incr;
+
+      /* Approach the target over one round trip, by at most one MSS per
+       * ACK.
+       */
+
+      if (diff >= conn->cwnd)
+        {
+          incr = mss;
+        }
+      else
+        {
+          incr = (uint32_t)(diff * mss / conn->cwnd);
+        }
+
+      conn->cwnd += incr > 0 ? incr : 1;
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember Wmax (with fast convergence) and reduce to beta_cubic * cwnd.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh;
+
+  if (conn->cwnd < conn->cubic_wmax)
+    {
+      conn->cubic_wmax = (uint32_t)((uint64_t)conn->cwnd *
+                                    (CUBIC_BETA_ONE + CUBIC_BETA) /
+                                    (2 * CUBIC_BETA_ONE));
+    }
+  else
+    {
+      conn->cubic_wmax = conn->cwnd;
+    }
+
+  conn->cubic_epoch = 0;
+
+  ssthresh = (uint32_t)((uint64_t)conn->cwnd * CUBIC_BETA / CUBIC_BETA_ONE);
+  if (ssthresh < 2 * (uint32_t)conn->mss)
+    {
+      ssthresh = 2 * (uint32_t)conn->mss;
+    }
+
+  return ssthresh;
+}
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
+
+/****************************************************************************
+ * Name: tcp_sack_trim
+ *
+ * Description:
+ *   Forget the SACK blocks that are now covered by the cumulative ACK.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+static void tcp_sack_trim(FAR struct tcp_conn_s *conn)
+{
+  int i = 0;
+
+  while (i < conn->nsacks && SEQ_LE(conn->sacks[i].sb_end, conn->lastack))
+    {
+      i++;
+    }
+
+  if (i > 0)
+    {
+      conn->nsacks -= i;
+      memmove(&conn->sacks[0], &conn->sacks[i],
+              conn->nsacks * sizeof(struct tcp_sackblock_s));
+    }
+
+  if (conn->nsacks > 0 && SEQ_LT(conn->sacks[0].sb_start, conn->lastack))
+    {
+      conn->sacks[0].sb_start = conn->lastack;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_sack_add
+ *
+ * Description:
+ *   Merge one SACK block into the sorted scoreboard.  When the scoreboard
+ *   is full, the highest range is dropped; that only costs an unnecessary
+ *   retransmission.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_add(FAR struct tcp_conn_s *conn, uint32_t start,
+                         uint32_t end)
+{
+  FAR struct tcp_sackblock_s *sacks = conn->sacks;
+  int i;
+  int j;
+
+  if (SEQ_LT(start, conn->lastack))
+    {
+      start = conn->lastack;
+    }
+
+  if (SEQ_GT(end, conn->sndseq_max))
+    {
+      end = conn->sndseq_max;
+    }
+
+  if (!SEQ_LT(start, end))
+    {
+      return;
+    }
+
+  /* Find the first block that ends at or after the new start */
+
+  for (i = 0; i < conn->nsacks && SEQ_LT(sacks[i].sb_end, start); i++)
+    {
+    }
+
+  /* Absorb every block that overlaps or touches the new one */
+
+  for (j = i; j < conn->nsacks && SEQ_LE(sacks[j].sb_start, end); j++)
+    {
+      if (SEQ_LT(sacks[j].sb_start, start))
+        {
+          start = sacks[j].sb_start;
+        }
+
+      if (SEQ_GT(sacks[j].sb_end, end))
+        {
+          end = sacks[j].sb_end;
+        }
+    }
+
+  if (j > i)
+    {
+      /* Replace blocks i..j-1 with the merged block */
+
+      sacks[i].sb_start = start;
+      sacks[i].sb_end   = end;
+      memmove(&sacks[i + 1], &sacks[j],
+              (conn->nsacks - j) * sizeof(struct tcp_sackblock_s));
+      conn->nsacks -= j - i - 1;
+      return;
+    }
+
+  /* Insert a new block at i */
+
+  if (conn->nsacks >= TCP_SACK_NSCORE)
+    {
+      if (i >= TCP_SACK_NSCORE)
+        {
+          return;
+        }
+
+      conn->nsacks = TCP_SACK_NSCORE - 1;
+    }
+
+  memmove(&sacks[i + 1], &sacks[i],
+          (conn->nsacks - i) * sizeof(struct tcp_sackblock_s));
+  sacks[i].sb_start = start;
+  sacks[i].sb_end   = end;
+  conn->nsacks++;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_nexthole
+ *
+ * Description:
+ *   Skip the SACKed ranges at or above *seq and clip *end to the start of
+ *   the next SACKed range.  Returns false if the data at *seq is not known
+ *   to be lost.
+ *
+ ****************************************************************************/
+
+static bool tcp_sack_nexthole(FAR struct tcp_conn_s *conn,
+                              FAR uint32_t *seq, FAR uint32_t *end)
+{
+  bool above = false;
+  int i;
+
+  for (i = 0; i < conn->nsacks; i++)
+    {
+      if (SEQ_LE(conn->sacks[i].sb_end, *seq))
+        {
+          continue;
+        }
+
+      if (SEQ_LE(conn->sacks[i].sb_start, *seq))
+        {
+          *seq = conn->sacks[i].sb_end;
+          continue;
+        }
+
+      *end  = conn->sacks[i].sb_start;
+      above = true;
+      break;
+    }
+
+  /* Beyond the first hole, only data below a SACKed range is known to be
+   * lost.
+   */
+
+  return above || *seq == conn->lastack;
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   been established.  The initial window follows RFC 3390.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  uint32_t mss = conn->mss;
+
+  conn->cc_ops     = TCP_CC_DEFAULT;
+  conn->cwnd       = 4380 < 2 * mss ? 2 * mss :
+                     (4380 > 4 * mss ? 4 * mss : 4380);
+  conn->ssthresh   = UINT32_MAX;
+  conn->lastack    = conn->isn;
+  conn->recover    = conn->isn;
+  conn->rtxnext    = conn->isn;
+  conn->dupacks    = 0;
+  conn->inrecovery = false;
+  conn->rtxpending = false;
+#ifdef CONFIG_NET_TCP_SACK
+  conn->nsacks     = 0;
+#endif
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state for an incoming ACK.
+ *
+ ****************************************************************************/
+
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, uint16_t flags)
+{
+  uint32_t mss = conn->mss;
+
+  if (SEQ_GT(ackno, conn->lastack))
+    {
+      uint32_t acked = ackno - conn->lastack;
+
+      /* New data was acknowledged */
+
+      conn->lastack = ackno;
+      conn->dupacks = 0;
+#ifdef CONFIG_NET_TCP_SACK
+      tcp_sack_trim(conn);
+#endif
+
+      if (!conn->inrecovery)
+        {
+          conn->cc_ops->ack(conn, acked);
+        }
+      else if (SEQ_GE(ackno, conn->recover))
+        {
+          /* A full ACK ends fast recovery; deflate the window */
+
+          ninfo("Recovery done: ackno=%lu cwnd=%lu\n",
+                (unsigned long)ackno, (unsigned long)conn->ssthresh);
+
+          conn->inrecovery = false;
+          conn->rtxpending = false;
+          conn->cwnd       = conn->ssthresh;
+        }
+      else
+        {
+          /* A partial ACK:  The next hole was lost too.  Retransmit it and
+           * deflate the window by the amount ACKed (RFC 6582).
+           */
+
+          if (SEQ_LT(conn->rtxnext, ackno))
+            {
+              conn->rtxnext = ackno;
+            }
+
+          conn->rtxpending = true;
+          conn->cwnd = conn->cwnd > acked ? conn->cwnd - acked : mss;
+          if (acked >= mss)
+            {
+              conn->cwnd += mss;
+            }
+        }
+    }
+  else if (ackno == conn->lastack && (flags & TCP_NEWDATA) == 0 &&
+           conn->tx_unacked > 0)
+    {
+      /* A duplicate ACK */
+
+      if (conn->dupacks < UINT8_MAX)
+        {
+          conn->dupacks++;
+        }
+
+      if (!conn->inrecovery)
+        {
+          if (conn->dupacks == TCP_DUPACK_THRESH &&
+              SEQ_GE(ackno, conn->recover))
+            {
+              /* Fast retransmit and enter fast recovery */
+
+              conn->ssthresh   = conn->cc_ops->ssthresh(conn);
+              conn->cwnd       = conn->ssthresh + TCP_DUPACK_THRESH * mss;
+              conn->recover    = conn->sndseq_max;
+              conn->rtxnext    = ackno;
+              conn->inrecovery = true;
+              conn->rtxpending = true;
+
+              ninfo("Fast retransmit: ackno=%lu recover=%lu ssthresh=%lu\n",
+                    (unsigned long)ackno, (unsigned long)conn->recover,
+                    (unsigned long)conn->ssthresh);
+            }
+        }
+      else
+        {
+          uint32_t start;
+          uint32_t end;
+
+          /* Each further duplicate ACK means that a segment has left the
+           * network.  With SACK, it may also reveal another hole.
+           */
+
+          conn->cwnd += mss;
+          if (conn->rtxnext != conn->lastack &&
+              tcp_cc_nexthole(conn, &start, &end))
+            {
+              conn->rtxpending = true;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   A retransmission timeout:  Everything in flight is treated as lost and
+ *   the connection restarts from a window of one segment.  SACK
+ *   information is discarded as required by RFC 2018.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  conn->ssthresh   = conn->cc_ops->ssthresh(conn);
+  conn->cwnd       = conn->mss;
+  conn->recover    = conn->sndseq_max;
+  conn->dupacks    = 0;
+  conn->inrecovery = false;
+  conn->rtxpending = false;
+#ifdef CONFIG_NET_TCP_SACK
+  conn->nsacks     = 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_cc_nexthole
+ *
+ * Description:
+ *   Return the next range of sequence numbers to retransmit during fast
+ *   recovery.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_nexthole(FAR struct tcp_conn_s *conn, FAR uint32_t *start,
+                     FAR uint32_t *end)
+{
+  uint32_t seq = conn->rtxnext;
+
+  if (SEQ_LT(seq, conn->lastack))
+    {
+      seq = conn->lastack;
+    }
+
+  *end = conn->recover;
+
+#ifdef CONFIG_NET_TCP_SACK
+  if (!tcp_sack_nexthole(conn, &seq, end))
+    {
+      return false;
+    }
+#else
+  /* Without SACK only the segment at the cumulative ACK is known lost */
+
+  if (seq != conn->lastack)
+    {
+      return false;
+    }
+#endif
+
+  if (!SEQ_LT(seq, *end))
+    {
+      return false;
+    }
+
+  *start = seq;
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Parse the options of an incoming ACK and merge any SACK blocks into the
+ *   scoreboard of the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR const uint8_t *opts,
+                    unsigned int optlen)
+{
+  unsigned int i = 0;
+
+  while (i < optlen)
+    {
+      uint8_t opt = opts[i];
+      uint8_t len;
+
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      if (i + 1 >= optlen)
+        {
+          break;
+        }
+
+      len = opts[i + 1];
+      if (len < 2 || i + len > optlen)
+        {
+          /* Malformed options */
+
+          break;
+        }
+
+      if (opt == TCP_OPT_SACK)
+        {
+          unsigned int j;
+
+          for (j = i + 2; j + 8 <= i + len; j += 8)
+            {
+              uint32_t start = ((uint32_t)opts[j] << 24) |
+                               ((uint32_t)opts[j + 1] << 16) |
+                               ((uint32_t)opts[j + 2] << 8) |
+                               (uint32_t)opts[j + 3];
+              uint32_t end   = ((uint32_t)opts[j + 4] << 24) |
+                               ((uint32_t)opts[j + 5] << 16) |
+                               ((uint32_t)opts[j + 6] << 8) |
+                               (uint32_t)opts[j + 7];
+
+              tcp_sack_add(conn, start, end);
+            }
+        }
+
+      i += len;
+    }
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+#endif /* CONFIG_NET_TCP_CC */
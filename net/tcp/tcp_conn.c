@@ -54,6 +54,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -74,6 +75,21 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_TCP_HASH
+#  if CONFIG_NET_TCP_HASH_BUCKETS <= 0 || \
+      (CONFIG_NET_TCP_HASH_BUCKETS & (CONFIG_NET_TCP_HASH_BUCKETS - 1)) != 0
+#    error CONFIG_NET_TCP_HASH_BUCKETS must be a power of two
+#  endif
+
+#  define TCP_HASH_MASK      (CONFIG_NET_TCP_HASH_BUCKETS - 1)
+#  define TCP_PORTHASH(p)    (tcp_hashfold(p) & TCP_HASH_MASK)
+
+/* Map hash chain links back to the containing connection */
+
+#  define TCP_HNODE2CONN(e)  container_of(e, struct tcp_conn_s, hnode)
+#  define TCP_PNODE2CONN(e)  container_of(e, struct tcp_conn_s, pnode)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -90,10 +106,197 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_HASH
+/* Active connections hashed on the remote address and the local and remote
+ * ports.  The local address is not part of the key because a connection
+ * bound to INADDR_ANY must still match any destination address.
+ */
+
+static dq_queue_t g_tcp_tuplehash[CONFIG_NET_TCP_HASH_BUCKETS];
+
+/* All bound connections (i.e., with a local port assigned), hashed on the
+ * local port.
+ */
+
+static dq_queue_t g_tcp_porthash[CONFIG_NET_TCP_HASH_BUCKETS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_HASH
+/****************************************************************************
+ * Name: tcp_hashfold
+ *
+ * Description:
+ *   Fold a 32-bit key so that every input bit affects the low order bits
+ *   used to select the hash bucket.
+ *
+ ****************************************************************************/
+
+static inline unsigned int tcp_hashfold(uint32_t key)
+{
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return (unsigned int)key;
+}
+
+/****************************************************************************
+ * Name: tcp_hnode2conn and tcp_pnode2conn
+ *
+ * Description:
+ *   Return the connection of a tuple or port hash chain link, or NULL at
+ *   the end of the chain.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *tcp_hnode2conn(FAR dq_entry_t *entry)
+{
+  return entry != NULL ? TCP_HNODE2CONN(entry) : NULL;
+}
+
+static inline FAR struct tcp_conn_s *tcp_pnode2conn(FAR dq_entry_t *entry)
+{
+  return entry != NULL ? TCP_PNODE2CONN(entry) : NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_ipv4_tuplehash and tcp_ipv6_tuplehash
+ *
+ * Description:
+ *   Return the connection hash bucket index for the remote address and the
+ *   local and remote ports (all in network byte order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline unsigned int tcp_ipv4_tuplehash(in_addr_t raddr,
+                                              uint16_t lport,
+                                              uint16_t rport)
+{
+  return tcp_hashfold((uint32_t)raddr ^ ((uint32_t)rport << 16) ^ lport) &
+         TCP_HASH_MASK;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline unsigned int tcp_ipv6_tuplehash(const net_ipv6addr_t raddr,
+                                              uint16_t lport,
+                                              uint16_t rport)
+{
+  uint32_t key = ((uint32_t)rport << 16) ^ lport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return tcp_hashfold(key) & TCP_HASH_MASK;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_porthash_insert
+ *
+ * Description:
+ *   Add a connection with a newly assigned local port to the port hash,
+ *   moving it if it was already hashed under a previous port.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_porthash_insert(FAR struct tcp_conn_s *conn)
+{
+  if (conn->porthashed)
+    {
+      dq_rem(&conn->pnode, &g_tcp_porthash[TCP_PORTHASH(conn->lport)]);
+    }
+
+  dq_addlast(&conn->pnode, &g_tcp_porthash[TCP_PORTHASH(conn->lport)]);
+  conn->porthashed = true;
+}
+
+/****************************************************************************
+ * Name: tcp_porthash_remove
+ *
+ * Description:
+ *   Remove a connection from the port hash, if it is there.  This must be
+ *   called before the local port is changed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_porthash_remove(FAR struct tcp_conn_s *conn)
+{
+  if (conn->porthashed)
+    {
+      dq_rem(&conn->pnode, &g_tcp_porthash[TCP_PORTHASH(conn->lport)]);
+      conn->porthashed = false;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_tuplehash_bucket
+ *
+ * Description:
+ *   Return the connection hash bucket for the connection's current remote
+ *   address and ports.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *tcp_tuplehash_bucket(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return &g_tcp_tuplehash[tcp_ipv4_tuplehash(conn->u.ipv4.raddr,
+                                                 conn->lport, conn->rport)];
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return &g_tcp_tuplehash[tcp_ipv6_tuplehash(conn->u.ipv6.raddr,
+                                                 conn->lport, conn->rport)];
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+#endif /* CONFIG_NET_TCP_HASH */
+
+/****************************************************************************
+ * Name: tcp_activate
+ *
+ * Description:
+ *   Put a connection whose addresses and ports are now fully set up into
+ *   the list of active connections (and the lookup hashes, if enabled).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_activate(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->node, &g_active_tcp_connections);
+
+#ifdef CONFIG_NET_TCP_HASH
+  dq_addlast(&conn->hnode, tcp_tuplehash_bucket(conn));
+  conn->tuplehashed = true;
+  tcp_porthash_insert(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -111,14 +314,21 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Only connections hashed under this port number can be using it */
+
+  for (conn = tcp_pnode2conn(dq_peek(&g_tcp_porthash[TCP_PORTHASH(portno)]));
+       conn != NULL;
+       conn = tcp_pnode2conn(dq_next(&conn->pnode)))
+#else
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = &g_tcp_connections[0];
+       conn < &g_tcp_connections[CONFIG_NET_TCP_CONNS];
+       conn++)
+#endif
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -162,14 +372,21 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Only connections hashed under this port number can be using it */
+
+  for (conn = tcp_pnode2conn(dq_peek(&g_tcp_porthash[TCP_PORTHASH(portno)]));
+       conn != NULL;
+       conn = tcp_pnode2conn(dq_next(&conn->pnode)))
+#else
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = &g_tcp_connections[0];
+       conn < &g_tcp_connections[CONFIG_NET_TCP_CONNS];
+       conn++)
+#endif
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -339,10 +556,18 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Only the connections in this hash chain can match */
+
+  conn = tcp_hnode2conn(dq_peek(&g_tcp_tuplehash[
+           tcp_ipv4_tuplehash(srcipaddr, tcp->destport, tcp->srcport)]));
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -369,19 +594,21 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = tcp_hnode2conn(dq_next(&conn->hnode));
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -406,10 +633,18 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Only the connections in this hash chain can match */
+
+  conn = tcp_hnode2conn(dq_peek(&g_tcp_tuplehash[
+           tcp_ipv6_tuplehash(*srcipaddr, tcp->destport, tcp->srcport)]));
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -436,19 +671,21 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = tcp_hnode2conn(dq_next(&conn->hnode));
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -491,6 +728,10 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network order). */
 
+#ifdef CONFIG_NET_TCP_HASH
+  tcp_porthash_remove(conn);
+#endif
+
   conn->lport = htons(port);
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 
@@ -512,6 +753,12 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
       return ret;
     }
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Make the port binding visible to tcp_listener() */
+
+  tcp_porthash_insert(conn);
+#endif
+
   net_unlock();
   return OK;
 }
@@ -558,6 +805,10 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network order). */
 
+#ifdef CONFIG_NET_TCP_HASH
+  tcp_porthash_remove(conn);
+#endif
+
   conn->lport = htons(port);
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 
@@ -579,6 +830,12 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
       return ret;
     }
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Make the port binding visible to tcp_listener() */
+
+  tcp_porthash_insert(conn);
+#endif
+
   net_unlock();
   return OK;
 }
@@ -606,6 +863,14 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (i = 0; i < CONFIG_NET_TCP_HASH_BUCKETS; i++)
+    {
+      dq_init(&g_tcp_tuplehash[i]);
+      dq_init(&g_tcp_porthash[i]);
+    }
+#endif
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -764,6 +1029,12 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
   net_lock();
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT
+  /* Stop the delayed ACK timer */
+
+  work_cancel(LPWORK, &conn->rx_ackwork);
+#endif
+
   /* Free remaining callbacks, actually there should be only the close
    * callback left.
    */
@@ -785,6 +1056,18 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       dq_rem(&conn->node, &g_active_tcp_connections);
     }
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Remove the connection from the lookup hashes */
+
+  if (conn->tuplehashed)
+    {
+      dq_rem(&conn->hnode, tcp_tuplehash_bucket(conn));
+      conn->tuplehashed = false;
+    }
+
+  tcp_porthash_remove(conn);
+#endif
+
   /* Release any read-ahead buffers attached to the connection */
 
   iob_free_queue(&conn->readahead, IOBUSER_NET_TCP_READAHEAD);
@@ -1043,7 +1326,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_activate(conn);
     }
 
   return conn;
@@ -1287,6 +1570,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
+#ifdef CONFIG_NET_TCP_HASH
+  tcp_porthash_remove(conn);
+#endif
   conn->lport      = htons((uint16_t)port);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
@@ -1308,7 +1594,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_activate(conn);
   ret = OK;
 
 errout_with_lock:
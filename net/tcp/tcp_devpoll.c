@@ -86,6 +86,7 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
   dev->d_len     = 0;
   dev->d_sndlen  = 0;
+  NETDEV_SET_TSOMSS(dev, 0);
 
   /* Verify that the connection is established. */
 
@@ -127,6 +128,15 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
           /* Handle the callback response */
 
           tcp_appsend(dev, conn, result);
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT
+          /* Send an expired delayed ACK unless a segment was just sent */
+
+          if (conn->rx_ackdue)
+            {
+              tcp_synack(dev, conn, TCP_ACK);
+            }
+#endif
         }
     }
 }
@@ -41,6 +41,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -97,9 +98,9 @@
 int tcp_getsockopt(FAR struct socket *psock, int option,
                    FAR void *value, FAR socklen_t *value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
-   * supported.
+#if defined(CONFIG_NET_TCP_KEEPALIVE) || defined(CONFIG_NET_TCP_CONNSTATS)
+  /* Keep alive options and the connection statistics are the only TCP
+   * protocol socket options currently supported.
    */
 
   FAR struct tcp_conn_s *conn;
@@ -124,6 +125,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
 
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -153,11 +155,15 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
       case TCP_NODELAY:  /* Avoid coalescing of small segments. */
         nerr("ERROR: TCP_NODELAY not supported\n");
         ret = -ENOSYS;
         break;
 
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+
       case TCP_KEEPIDLE:  /* Start keepalives after this IDLE period */
         if (*value_len < sizeof(struct timeval))
           {
@@ -238,6 +244,31 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
             ret              = OK;
           }
         break;
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+      case TCP_INFO:      /* Connection statistics */
+        {
+          struct tcp_info info;
+
+          /* Take a consistent snapshot and truncate it to the size of the
+           * caller's buffer, as Linux does.
+           */
+
+          net_lock();
+          tcp_stats_info(conn, &info);
+          net_unlock();
+
+          if (*value_len > sizeof(struct tcp_info))
+            {
+              *value_len = sizeof(struct tcp_info);
+            }
+
+          memcpy(value, &info, *value_len);
+          ret = OK;
+        }
+        break;
+#endif /* CONFIG_NET_TCP_CONNSTATS */
 
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
@@ -248,7 +279,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
   return ret;
 #else
   return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
+#endif /* CONFIG_NET_TCP_KEEPALIVE || CONFIG_NET_TCP_CONNSTATS */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
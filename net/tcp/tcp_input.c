@@ -52,6 +52,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched_span.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -68,6 +69,12 @@
 
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+SCHED_SPAN_DEFINE(tcp_input);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -133,7 +140,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCHKSUM_OFFLOAD(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -142,6 +149,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
       g_netstats.tcp.chkerr++;
 #endif
       nwarn("WARNING: Bad TCP checksum\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_CHKSUM);
       goto drop;
     }
 
@@ -234,6 +242,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
               g_netstats.tcp.syndrop++;
 #endif
               nerr("ERROR: No free TCP connections\n");
+              NETDEV_RXDROP(dev, NETDEV_RXDROP_NOBUFS);
               goto drop;
             }
 
@@ -268,11 +277,34 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
                       tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
                                (uint16_t)dev->d_buf[hdrlen + 3 + i];
                       conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+                      i += TCP_OPT_MSS_LEN;
+                    }
+#ifdef CONFIG_NET_TCP_SACK
+                  else if (opt == TCP_OPT_SACK_PERM &&
+                           dev->d_buf[hdrlen + 1 + i] ==
+                           TCP_OPT_SACK_PERM_LEN)
+                    {
+                      /* The peer can process SACK options */
 
-                      /* And we are done processing options. */
+                      conn->sackperm = true;
+                      i += TCP_OPT_SACK_PERM_LEN;
+                    }
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+                  else if (opt == TCP_OPT_WS &&
+                           dev->d_buf[hdrlen + 1 + i] == TCP_OPT_WS_LEN)
+                    {
+                      /* The peer can scale windows.  Our SYNACK will
+                       * answer with our own shift.
+                       */
 
-                      break;
+                      tmp16 = dev->d_buf[hdrlen + 2 + i];
+                      conn->snd_scale = tmp16 > TCP_WS_MAXSHIFT ?
+                                        TCP_WS_MAXSHIFT : tmp16;
+                      conn->wsok = true;
+                      i += TCP_OPT_WS_LEN;
                     }
+#endif
                   else
                     {
                       /* All other options have a length field, so that we
@@ -301,6 +333,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
     }
 
   nwarn("WARNING: SYN with no listener (or old packet) .. reset\n");
+  NETDEV_RXDROP(dev, NETDEV_RXDROP_NOCONN);
 
   /* This is (1) an old duplicate packet or (2) a SYN packet but with
    * no matching listener found.  Send RST packet in either case.
@@ -327,6 +360,15 @@ found:
 
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window in a SYN segment is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_scale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -398,6 +440,8 @@ found:
 
   dev->d_len -= (len + iplen);
 
+  tcp_stats_input(conn, tcp, dev->d_len);
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
   /* Check for a to KeepAlive probes.  These packets have these properties:
    *
@@ -457,6 +501,18 @@ found:
         }
     }
 
+#ifdef CONFIG_NET_TCP_SACK
+  /* Remember any data that the peer has selectively acknowledged */
+
+  if (conn->sackperm && (tcp->flags & TCP_ACK) != 0 &&
+      (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+      (tcp->tcpoffset & 0xf0) > 0x50)
+    {
+      tcp_sack_input(conn, &dev->d_buf[hdrlen],
+                     ((tcp->tcpoffset >> 4) - 5) << 2);
+    }
+#endif
+
   /* Check if the incoming segment acknowledges any outstanding data. If so,
    * we update the sequence number, reset the length of the outstanding
    * data, calculate RTT estimations, and reset the retransmission timer.
@@ -609,6 +665,7 @@ found:
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
             conn->sndseq_max    = 0;
+            tcp_cc_init(conn);
 #endif
             conn->tx_unacked    = 0;
             flags               = TCP_CONNECTED;
@@ -676,11 +733,32 @@ found:
                           (dev->d_buf[hdrlen + 2 + i] << 8) |
                           dev->d_buf[hdrlen + 3 + i];
                         conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+                        i += TCP_OPT_MSS_LEN;
+                      }
+#ifdef CONFIG_NET_TCP_SACK
+                    else if (opt == TCP_OPT_SACK_PERM &&
+                             dev->d_buf[hdrlen + 1 + i] ==
+                             TCP_OPT_SACK_PERM_LEN)
+                      {
+                        /* The peer accepted our SACK permitted option */
 
-                        /* And we are done processing options. */
+                        conn->sackperm = true;
+                        i += TCP_OPT_SACK_PERM_LEN;
+                      }
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+                    else if (opt == TCP_OPT_WS &&
+                             dev->d_buf[hdrlen + 1 + i] == TCP_OPT_WS_LEN)
+                      {
+                        /* The peer accepted our window scale option */
 
-                        break;
+                        tmp16 = dev->d_buf[hdrlen + 2 + i];
+                        conn->snd_scale = tmp16 > TCP_WS_MAXSHIFT ?
+                                          TCP_WS_MAXSHIFT : tmp16;
+                        conn->wsok = true;
+                        i += TCP_OPT_WS_LEN;
                       }
+#endif
                     else
                       {
                         /* All other options have a length field, so that we
@@ -701,6 +779,15 @@ found:
                   }
               }
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+            /* Without the peer's option, neither side scales its window */
+
+            if (!conn->wsok)
+              {
+                conn->rcv_scale = 0;
+              }
+#endif
+
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
 
@@ -710,6 +797,7 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+            tcp_cc_init(conn);
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -1039,6 +1127,7 @@ void tcp_ipv4_input(FAR struct net_driver_s *dev)
 {
   FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
   uint16_t iphdrlen;
+  uint32_t span;
 
   /* Configure to receive an TCP IPv4 packet */
 
@@ -1050,7 +1139,9 @@ void tcp_ipv4_input(FAR struct net_driver_s *dev)
 
   /* Then process in the TCP IPv4 input */
 
+  span = SCHED_SPAN_BEGIN(tcp_input);
   tcp_input(dev, PF_INET, iphdrlen);
+  SCHED_SPAN_END(tcp_input, span);
 }
 #endif
 
@@ -1077,13 +1168,17 @@ void tcp_ipv4_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_IPv6
 void tcp_ipv6_input(FAR struct net_driver_s *dev, unsigned int iplen)
 {
+  uint32_t span;
+
   /* Configure to receive an TCP IPv6 packet */
 
   tcp_ipv6_select(dev);
 
   /* Then process in the TCP IPv6 input */
 
+  span = SCHED_SPAN_BEGIN(tcp_input);
   tcp_input(dev, PF_INET6, iplen);
+  SCHED_SPAN_END(tcp_input, span);
 }
 #endif
 
@@ -73,6 +73,83 @@ struct tcp_recvfrom_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_recvfrom_wakeup
+ *
+ * Description:
+ *   The receive is complete.  Stop further callbacks and wake up the
+ *   waiting thread.
+ *
+ * Input Parameters:
+ *   pstate   recvfrom state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_recvfrom_wakeup(FAR struct tcp_recvfrom_s *pstate)
+{
+  ninfo("TCP resume\n");
+
+  pstate->ir_cb->flags   = 0;
+  pstate->ir_cb->priv    = NULL;
+  pstate->ir_cb->event   = NULL;
+
+  /* Wake up the waiting thread, returning the number of bytes actually
+   * read.
+   */
+
+  nxsem_post(&pstate->ir_sem);
+}
+
+/****************************************************************************
+ * Name: tcp_recvfrom_pushed
+ *
+ * Description:
+ *   Check whether the incoming segment has the PSH flag set.
+ *
+ * Input Parameters:
+ *   dev      The structure of the network driver that received the segment
+ *
+ * Returned Value:
+ *   True if the sender asked for the data to be pushed to the reader.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RECV_COALESCE
+static bool tcp_recvfrom_pushed(FAR struct net_driver_s *dev)
+{
+  FAR struct tcp_hdr_s *tcp;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      tcp = TCPIPv6BUF;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      tcp = TCPIPv4BUF;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return (tcp->flags & TCP_PSH) != 0;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_update_recvlen
  *
@@ -414,6 +491,10 @@ static uint16_t tcp_eventhandler(FAR struct net_driver_s *dev,
 
       if ((flags & TCP_NEWDATA) != 0)
         {
+#ifdef CONFIG_NET_TCP_RECV_COALESCE
+          bool pushed = tcp_recvfrom_pushed(dev);
+#endif
+
           /* Copy the data from the packet (saving any unused bytes from the
            * packet in the read-ahead buffer).
            */
@@ -430,6 +511,20 @@ static uint16_t tcp_eventhandler(FAR struct net_driver_s *dev,
 
           flags = (flags & ~TCP_NEWDATA) | TCP_SNDACK;
 
+#ifdef CONFIG_NET_TCP_RECV_COALESCE
+          /* Keep collecting data in the caller's buffer until it is full,
+           * the threshold is reached or the sender pushed the data.
+           * Anything that is received once the buffer is full goes to the
+           * read-ahead buffer.
+           */
+
+          if (pstate->ir_recvlen > 0 &&
+              (pstate->ir_buflen == 0 || pushed ||
+               pstate->ir_recvlen >= CONFIG_NET_TCP_RECV_COALESCE_THRESH))
+            {
+              tcp_recvfrom_wakeup(pstate);
+            }
+#else
           /* Check for transfer complete.  We will consider the
            * TCP/IP transfer complete as soon as any data has been received.
            * This is safe because if any additional data is received, it
@@ -439,22 +534,13 @@ static uint16_t tcp_eventhandler(FAR struct net_driver_s *dev,
 
           if (pstate->ir_recvlen > 0)
             {
-              ninfo("TCP resume\n");
-
               /* The TCP receive buffer is non-empty.  Return now and don't
                * allow any further TCP call backs.
                */
 
-              pstate->ir_cb->flags   = 0;
-              pstate->ir_cb->priv    = NULL;
-              pstate->ir_cb->event   = NULL;
-
-              /* Wake up the waiting thread, returning the number of bytes
-               * actually read.
-               */
-
-              nxsem_post(&pstate->ir_sem);
+              tcp_recvfrom_wakeup(pstate);
             }
+#endif
         }
 
       /* Check for a loss of connection.
@@ -505,6 +591,17 @@ static uint16_t tcp_eventhandler(FAR struct net_driver_s *dev,
 
           nxsem_post(&pstate->ir_sem);
         }
+
+#ifdef CONFIG_NET_TCP_RECV_COALESCE
+      /* Don't hold back data that was not pushed for longer than until
+       * the next poll of the connection.
+       */
+
+      else if ((flags & TCP_POLL) != 0 && pstate->ir_recvlen > 0)
+        {
+          tcp_recvfrom_wakeup(pstate);
+        }
+#endif
     }
 
   return flags;
@@ -580,6 +677,18 @@ static void tcp_recvfrom_initialize(FAR struct socket *psock, FAR void *buf,
 
 static ssize_t tcp_recvfrom_result(int result, struct tcp_recvfrom_s *pstate)
 {
+#ifdef CONFIG_NET_TCP_RECV_COALESCE
+  /* Data that was already copied into the caller's buffer is returned even
+   * if the wait then ended with an error, a timeout or a signal.  The error
+   * will be reported by the next receive.
+   */
+
+  if (pstate->ir_recvlen > 0)
+    {
+      return pstate->ir_recvlen;
+    }
+#endif
+
   /* Check for a error/timeout detected by the event handler.  Errors are
    * signaled by negative errno values for the rcv length
    */
@@ -735,6 +844,9 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR void *buf,
       if (state.ir_cb)
         {
           state.ir_cb->flags   = (TCP_NEWDATA | TCP_DISCONN_EVENTS);
+#ifdef CONFIG_NET_TCP_RECV_COALESCE
+          state.ir_cb->flags  |= TCP_POLL;
+#endif
           state.ir_cb->priv    = (FAR void *)&state;
           state.ir_cb->event   = tcp_eventhandler;
 
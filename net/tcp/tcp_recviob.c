@@ -0,0 +1,197 @@
+/****************************************************************************
+ * net/tcp/tcp_recviob.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+#include "socket/socket.h"
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_RECVIOB)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcp_recviob_s
+{
+  FAR struct socket           *ri_sock;  /* The parent socket structure */
+  FAR struct devif_callback_s *ri_cb;    /* Reference to callback instance */
+  sem_t                        ri_sem;   /* Signals new data or loss of
+                                          * connection */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_recviob_eventhandler
+ *
+ * Description:
+ *   Wake up the waiting thread when new data arrives or the connection is
+ *   lost.  The new data is not consumed here:  TCP_NEWDATA stays set so
+ *   that tcp_callback() puts the data into the read-ahead queue, where the
+ *   waiting thread will pick it up.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_recviob_eventhandler(FAR struct net_driver_s *dev,
+                                         FAR void *pvconn, FAR void *pvpriv,
+                                         uint16_t flags)
+{
+  FAR struct tcp_recviob_s *pstate = (FAR struct tcp_recviob_s *)pvpriv;
+
+  ninfo("flags: %04x\n", flags);
+
+  if (pstate != NULL &&
+      (flags & (TCP_NEWDATA | TCP_DISCONN_EVENTS)) != 0)
+    {
+      FAR struct socket *psock = pstate->ri_sock;
+
+      /* Handle a loss of connection once, as psock_tcp_recvfrom() does */
+
+      if ((flags & TCP_DISCONN_EVENTS) != 0 &&
+          _SS_ISCONNECTED(psock->s_flags))
+        {
+          tcp_lost_connection(psock, pstate->ri_cb, flags);
+        }
+
+      pstate->ri_cb->flags = 0;
+      pstate->ri_cb->priv  = NULL;
+      pstate->ri_cb->event = NULL;
+
+      nxsem_post(&pstate->ri_sem);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_tcp_recviob
+ *
+ * Description:
+ *   Remove the I/O buffer chain at the head of the read-ahead queue of a
+ *   TCP socket and lend it to the caller, waiting for data if necessary.
+ *
+ * Input Parameters:
+ *   psock - Pointer to the socket structure for the SOCK_STREAM socket
+ *   iob   - Location to return the I/O buffer chain
+ *   flags - Receive flags (only MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   The number of bytes in the chain on success; zero at the end of the
+ *   stream; a negated errno value on failure.  The caller must release
+ *   the chain with iob_free_chain(iob, IOBUSER_NET_TCP_READAHEAD).
+ *
+ ****************************************************************************/
+
+ssize_t psock_tcp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  struct tcp_recviob_s state;
+  ssize_t ret;
+
+  DEBUGASSERT(conn != NULL && iob != NULL);
+
+  state.ri_sock = psock;
+  nxsem_init(&state.ri_sem, 0, 0); /* Doesn't really fail */
+  nxsem_set_protocol(&state.ri_sem, SEM_PRIO_NONE);
+
+  net_lock();
+  for (; ; )
+    {
+      /* Read-ahead data is returned even after the connection was lost */
+
+      if (!IOB_QEMPTY(&conn->readahead))
+        {
+          *iob = iob_remove_queue(&conn->readahead);
+          DEBUGASSERT(*iob != NULL);
+
+          ret = (*iob)->io_pktlen;
+          break;
+        }
+
+      if (!_SS_ISCONNECTED(psock->s_flags))
+        {
+          /* End of stream if the peer closed the connection gracefully */
+
+          ret = _SS_ISCLOSED(psock->s_flags) ? 0 : -ENOTCONN;
+          break;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      /* Wait for new data to be put into the read-ahead queue */
+
+      state.ri_cb = tcp_callback_alloc(conn);
+      if (state.ri_cb == NULL)
+        {
+          ret = -EBUSY;
+          break;
+        }
+
+      state.ri_cb->flags = (TCP_NEWDATA | TCP_DISCONN_EVENTS);
+      state.ri_cb->priv  = (FAR void *)&state;
+      state.ri_cb->event = tcp_recviob_eventhandler;
+
+      ret = net_timedwait(&state.ri_sem, _SO_TIMEOUT(psock->s_rcvtimeo));
+      tcp_callback_free(conn, state.ri_cb);
+
+      if (ret < 0)
+        {
+          ret = ret == -ETIMEDOUT ? -EAGAIN : ret;
+          break;
+        }
+    }
+
+  net_unlock();
+  nxsem_destroy(&state.ri_sem);
+  return ret;
+}
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_RECVIOB */
@@ -52,6 +52,18 @@
 
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest window that can be advertised on a connection */
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+#  define TCP_RCVWND_MAX(conn) ((uint32_t)UINT16_MAX << (conn)->rcv_scale)
+#else
+#  define TCP_RCVWND_MAX(conn) UINT16_MAX
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -63,18 +75,20 @@
  *   Calculate the TCP receive window for the specified device.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The connection whose window scale limits the window.
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The value of the TCP receive window to use, before scaling.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
+uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
 {
   uint16_t iplen;
   uint16_t mss;
-  uint16_t recvwndo;
+  uint32_t recvwndo;
   int niob_avail;
   int nqentry_avail;
 
@@ -155,14 +169,14 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
        */
 
       rwnd = (niob_avail * CONFIG_IOB_BUFSIZE) + mss;
-      if (rwnd > UINT16_MAX)
+      if (rwnd > TCP_RCVWND_MAX(conn))
         {
-          rwnd = UINT16_MAX;
+          rwnd = TCP_RCVWND_MAX(conn);
         }
 
       /* Save the new receive window size */
 
-      recvwndo = (uint16_t)rwnd;
+      recvwndo = rwnd;
     }
   else /* nqentry_avail == 0 || niob_avail == 0 */
     {
@@ -179,3 +193,38 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
 
   return recvwndo;
 }
+
+/****************************************************************************
+ * Name: tcp_get_rcvscale
+ *
+ * Description:
+ *   Select the window scale shift to offer on a connection:  The smallest
+ *   shift that can represent a receive window holding every IOB.
+ *
+ * Input Parameters:
+ *   dev - The device that the connection uses.
+ *
+ * Returned Value:
+ *   The window scale shift, 0 through TCP_WS_MAXSHIFT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_rcvscale(FAR struct net_driver_s *dev)
+{
+  uint32_t rwnd;
+  uint8_t shift = 0;
+
+  /* This is the same bound that tcp_get_recvwindow() uses when all IOBs
+   * are free, with the packet size standing in for the MSS.
+   */
+
+  rwnd = CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE + dev->d_pktsize;
+  while ((rwnd >> shift) > UINT16_MAX && shift < TCP_WS_MAXSHIFT)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
@@ -153,7 +153,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+  if (!NETDEV_TXCHKSUM_OFFLOAD(dev))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -168,7 +171,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   /* Calculate IP checksum. */
 
   ipv4->ipchksum    = 0;
-  ipv4->ipchksum    = ~ipv4_chksum(dev);
+  if (!NETDEV_TXCHKSUM_OFFLOAD(dev))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
 
   ninfo("IPv4 length: %d\n", ((int)ipv4->len[0] << 8) + ipv4->len[1]);
 
@@ -225,7 +231,10 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+  if (!NETDEV_TXCHKSUM_OFFLOAD(dev))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
@@ -342,6 +351,17 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   memcpy(tcp->ackno, conn->rcvseq, 4);
   memcpy(tcp->seqno, conn->sndseq, 4);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* This segment carries any delayed ACK */
+
+  conn->rx_ackseq   = tcp_getsequence(conn->rcvseq);
+  conn->rx_unackseg = 0;
+  conn->rx_acktimer = 0;
+#ifdef CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT
+  conn->rx_ackdue   = false;
+#endif
+#endif
+
   tcp->srcport  = conn->lport;
   tcp->destport = conn->rport;
 
@@ -360,7 +380,23 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     {
       /* Update the TCP received window based on I/O buffer availability */
 
-      uint16_t recvwndo = tcp_get_recvwindow(dev);
+      uint32_t recvwndo = tcp_get_recvwindow(dev, conn);
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      /* The window in a SYN segment is never scaled (RFC 7323) */
+
+      if ((tcp->flags & TCP_SYN) != 0)
+        {
+          if (recvwndo > UINT16_MAX)
+            {
+              recvwndo = UINT16_MAX;
+            }
+        }
+      else
+        {
+          recvwndo >>= conn->rcv_scale;
+        }
+#endif
 
       /* Set the TCP Window */
 
@@ -368,6 +404,12 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->wnd[1] = recvwndo & 0xff;
     }
 
+  /* Account for the segment.  Its data follows the TCP header. */
+
+  tcp_stats_send(conn, tcp, NET_LL_HDRLEN(dev) + dev->d_len -
+                 ((FAR uint8_t *)tcp - dev->d_buf) -
+                 ((tcp->tcpoffset >> 4) << 2));
+
   /* Finish the IP portion of the message and calculate checksums */
 
   tcp_sendcomplete(dev, tcp);
@@ -574,6 +616,7 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 {
   struct tcp_hdr_s *tcp;
   uint16_t tcp_mss;
+  uint16_t optlen = TCP_OPT_MSS_LEN;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -619,7 +662,46 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->optdata[1] = TCP_OPT_MSS_LEN;
   tcp->optdata[2] = tcp_mss >> 8;
   tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Offer selective acknowledgments in a SYN, and accept them in a SYNACK
+   * if the peer offered them.
+   */
+
+  if ((ack & TCP_SYN) != 0 && ((ack & TCP_ACK) == 0 || conn->sackperm))
+    {
+      FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      opt[0]          = TCP_OPT_NOOP;
+      opt[1]          = TCP_OPT_NOOP;
+      opt[2]          = TCP_OPT_SACK_PERM;
+      opt[3]          = TCP_OPT_SACK_PERM_LEN;
+      dev->d_len     += 4;
+      optlen         += 4;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Offer a window scale in a SYN, and answer with ours in a SYNACK only
+   * if the peer offered one.  Scaling is used only if both sides send it.
+   */
+
+  if ((ack & TCP_SYN) != 0 && ((ack & TCP_ACK) == 0 || conn->wsok))
+    {
+      FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      conn->rcv_scale = tcp_get_rcvscale(dev);
+
+      opt[0]          = TCP_OPT_NOOP;
+      opt[1]          = TCP_OPT_WS;
+      opt[2]          = TCP_OPT_WS_LEN;
+      opt[3]          = conn->rcv_scale;
+      dev->d_len     += 4;
+      optlen         += 4;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
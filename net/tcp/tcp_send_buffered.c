@@ -67,6 +67,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/net.h>
 
 #include "netdev/netdev.h"
@@ -291,6 +292,111 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: psock_fast_rexmit
+ *
+ * Description:
+ *   Set up the retransmission of the first segment of the next hole in the
+ *   sequence space that congestion control asked to be repaired.  Nothing
+ *   in the write buffer accounting is changed:  The data has already been
+ *   sent once and remains in the unacked_q (or in the sent part of the
+ *   write_q head) until it is acknowledged.
+ *
+ * Input Parameters:
+ *   dev  - The structure of the network driver that caused the event
+ *   conn - The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   True if a segment was set up in the device buffer.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static bool psock_fast_rexmit(FAR struct net_driver_s *dev,
+                              FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb = NULL;
+  FAR sq_entry_t *entry;
+  uint32_t start;
+  uint32_t end;
+  uint32_t offset;
+  uint32_t sndlen;
+
+  conn->rtxpending = false;
+  if (!tcp_cc_nexthole(conn, &start, &end))
+    {
+      return false;
+    }
+
+  /* Find the write buffer that holds the first byte of the hole.  The
+   * unsigned differences also reject sequence numbers below the start of
+   * a buffer.
+   */
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (start - TCP_WBSEQNO(wrb) < TCP_WBPKTLEN(wrb))
+        {
+          break;
+        }
+    }
+
+  if (entry != NULL)
+    {
+      sndlen = TCP_WBPKTLEN(wrb);
+    }
+  else
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || TCP_WBSENT(wrb) == 0 ||
+          start - TCP_WBSEQNO(wrb) >= TCP_WBSENT(wrb))
+        {
+          return false;
+        }
+
+      sndlen = TCP_WBSENT(wrb);
+    }
+
+  /* Send at most one MSS and never beyond the end of the hole */
+
+  offset  = start - TCP_WBSEQNO(wrb);
+  sndlen -= offset;
+
+  if (sndlen > end - start)
+    {
+      sndlen = end - start;
+    }
+
+  if (sndlen > conn->mss)
+    {
+      sndlen = conn->mss;
+    }
+
+  ninfo("FASTREXMIT: wrb=%p seqno=%u sndlen=%u\n",
+        wrb, start, sndlen);
+
+  tcp_setsequence(conn->sndseq, start);
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  send_ipselect(dev, conn);
+#endif
+
+  devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, offset);
+  NETDEV_SET_TSOMSS(dev, 0);
+
+  conn->rtxnext = start + sndlen;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rexmit++;
+#endif
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -369,6 +475,19 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%u flags=%04x\n", ackno, flags);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Let congestion control see the ACK before the queues are trimmed.
+       * If a retransmission is needed but the device buffer holds incoming
+       * data, ask for a poll so that it goes out promptly.
+       */
+
+      tcp_cc_ack(conn, ackno, flags);
+      if (conn->rtxpending && (flags & TCP_NEWDATA) != 0)
+        {
+          netdev_txnotify_dev(dev);
+        }
+#endif
+
       /* Look at every write buffer in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
        * have not yet been ACKed.
@@ -516,6 +635,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* A retransmission timeout collapses the congestion window */
+
+      tcp_cc_timeout(conn);
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -679,6 +804,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       return flags;
     }
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Fast retransmissions take precedence over new data */
+
+  if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+      conn->rtxpending && (flags & TCP_NEWDATA) == 0 &&
+      psock_fast_rexmit(dev, conn))
+    {
+      flags &= ~TCP_POLL;
+      return flags;
+    }
+#endif
+
   /* We get here if (1) not all of the data has been ACKed, (2) we have been
    * asked to retransmit data, (3) the connection is still healthy, and (4)
    * the outgoing packet is available for our use.  In this case, we are
@@ -694,6 +831,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     {
       FAR struct tcp_wrbuffer_s *wrb;
       uint32_t predicted_seqno;
+      size_t maxlen;
       size_t sndlen;
 
       /* Peek at the head of the write queue (but don't remove anything
@@ -707,13 +845,20 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       /* Get the amount of data that we can send in the next packet.
        * We will send either the remaining data in the buffer I/O
        * buffer chain, or as much as will fit given the MSS and current
-       * window size.
+       * window size.  If the device can do TCP segmentation, the limit
+       * is the device's TSO frame size instead of the MSS.
        */
 
+      maxlen = NETDEV_TSOMAX(dev);
+      if (maxlen < conn->mss)
+        {
+          maxlen = conn->mss;
+        }
+
       sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-      if (sndlen > conn->mss)
+      if (sndlen > maxlen)
         {
-          sndlen = conn->mss;
+          sndlen = maxlen;
         }
 
       if (sndlen > conn->winsize)
@@ -721,6 +866,27 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           sndlen = conn->winsize;
         }
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Never have more than the congestion window in flight.  Avoid
+       * sending a runt while earlier segments are still unacknowledged.
+       */
+
+      if (conn->tx_unacked + sndlen > conn->cwnd)
+        {
+          sndlen = conn->cwnd > conn->tx_unacked ?
+                   conn->cwnd - conn->tx_unacked : 0;
+          if (conn->tx_unacked > 0 && sndlen < conn->mss)
+            {
+              sndlen = 0;
+            }
+
+          if (sndlen == 0)
+            {
+              return flags;
+            }
+        }
+#endif
+
       ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u mss=%u "
             "winsize=%u\n",
             wrb, TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb), sndlen, conn->mss,
@@ -761,6 +927,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
 
+      /* Tell the driver how to segment the frame if it exceeds the MSS */
+
+      NETDEV_SET_TSOMSS(dev, sndlen > conn->mss ? conn->mss : 0);
+
       /* Remember how much data we send out now so that we know
        * when everything has been acknowledged.  Just increment
        * the amount of data sent. This will be needed in sequence
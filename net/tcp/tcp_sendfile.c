@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -98,6 +99,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;             /* File structure of the input file */
+  FAR const uint8_t *snd_map;              /* File data, if memory mapped */
   sem_t              snd_sem;              /* Used to wake up the waiting thread */
   off_t              snd_foffset;          /* Input file offset */
   size_t             snd_flen;             /* File length */
@@ -305,21 +307,37 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_map != NULL)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              /* The file data is directly addressable.  Copy it straight
+               * into the packet without going through the file system.
+               */
+
+              memcpy(dev->d_appdata,
+                     pstate->snd_map + pstate->snd_foffset +
+                     pstate->snd_sent, sndlen);
+              ret = sndlen;
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to lseek: %d\n", ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to read from input file: %d\n",
+                       (int)ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
             }
 
           dev->d_sndlen = sndlen;
@@ -451,6 +469,8 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 {
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
+  FAR void *map = NULL;
+  off_t foffset;
   int ret;
 
   /* If this is an un-connected socket, then return ENOTCONN */
@@ -497,6 +517,36 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* If the file system can map the file (e.g. XIP romfs or tmpfs), then
+   * the packets can be filled directly from the file data instead of
+   * seeking and reading through the file system for every segment.  The
+   * mapping covers the file only, so limit the transfer to the file size.
+   */
+
+  foffset = offset ? *offset : 0;
+  ret = file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&map));
+  if (ret >= 0 && map != NULL)
+    {
+      off_t fsize = file_seek(infile, 0, SEEK_END);
+
+      if (fsize < 0)
+        {
+          map = NULL;
+        }
+      else if (foffset >= fsize)
+        {
+          count = 0;
+        }
+      else if (count > fsize - foffset)
+        {
+          count = fsize - foffset;
+        }
+    }
+  else
+    {
+      map = NULL;
+    }
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -513,9 +563,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   nxsem_set_protocol(&state.snd_sem, SEM_PRIO_NONE);
 
   state.snd_sock    = psock;                /* Socket descriptor to use */
-  state.snd_foffset = offset ? *offset : 0; /* Input file offset */
+  state.snd_foffset = foffset;              /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_map     = map;                  /* Mapped file data or NULL */
 
   /* Allocate resources to receive a callback */
 
@@ -585,6 +636,13 @@ errout_locked:
   nxsem_destroy(&state.snd_sem);
   net_unlock();
 
+  /* Leave the file position where the read path would have left it */
+
+  if (map != NULL && state.snd_sent > 0)
+    {
+      file_seek(infile, foffset + state.snd_sent, SEEK_SET);
+    }
+
   if (ret < 0)
     {
       return ret;
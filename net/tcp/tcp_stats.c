@@ -0,0 +1,317 @@
+/****************************************************************************
+ * net/tcp/tcp_stats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include <netinet/tcp.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Sequence number comparisons that handle wrap-around */
+
+#define SEQ_LE(a,b)  ((int32_t)((a) - (b)) <= 0)
+#define SEQ_GT(a,b)  ((int32_t)((a) - (b)) > 0)
+#define SEQ_GE(a,b)  ((int32_t)((a) - (b)) >= 0)
+
+/* The TCP timer counts in half seconds */
+
+#define TCP_HSEC2USEC(h)  ((uint32_t)(h) * (USEC_PER_SEC / HSEC_PER_SEC))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_stats_now
+ *
+ * Description:
+ *   Return the system time in microseconds.  Only differences are used, so
+ *   the wrap-around of the 32-bit value does not matter.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_stats_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: tcp_stats_rtt
+ *
+ * Description:
+ *   Fold a round trip time sample into the smoothed round trip time and
+ *   its variation as RFC 6298 does (alpha = 1/8, beta = 1/4).
+ *
+ ****************************************************************************/
+
+static void tcp_stats_rtt(FAR struct tcp_connstats_s *stats, uint32_t rtt)
+{
+  uint32_t delta;
+
+  /* Zero means that there is no sample yet */
+
+  if (rtt == 0)
+    {
+      rtt = 1;
+    }
+
+  if (stats->srtt == 0)
+    {
+      stats->srtt   = rtt;
+      stats->rttvar = rtt / 2;
+    }
+  else
+    {
+      delta          = stats->srtt > rtt ? stats->srtt - rtt :
+                                           rtt - stats->srtt;
+      stats->rttvar  = stats->rttvar - stats->rttvar / 4 + delta / 4;
+      stats->srtt    = stats->srtt - stats->srtt / 8 + rtt / 8;
+      if (stats->srtt == 0)
+        {
+          stats->srtt = 1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_stats_send
+ *
+ * Description:
+ *   Account for a segment that is about to be sent:  count it, start a
+ *   round trip time sample on new data or count a retransmission.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   tcp    - The TCP header of the outgoing segment
+ *   len    - The length of the data in the segment
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_stats_send(FAR struct tcp_conn_s *conn,
+                    FAR const struct tcp_hdr_s *tcp, unsigned int len)
+{
+  FAR struct tcp_connstats_s *stats = &conn->stats;
+  uint32_t seqno = tcp_getsequence((FAR uint8_t *)tcp->seqno);
+  uint32_t end;
+
+  /* The first segment sent, normally the SYN, sets the sequence space */
+
+  if (stats->segsout++ == 0)
+    {
+      if ((tcp->flags & TCP_SYN) != 0)
+        {
+          seqno++;
+        }
+
+      stats->snduna = seqno;
+      stats->sndmax = seqno;
+    }
+
+  if (len == 0)
+    {
+      return;
+    }
+
+  end = seqno + len;
+  if (SEQ_GT(end, stats->sndmax))
+    {
+      /* New data.  Time it unless another segment is being timed. */
+
+      if (!stats->rttvalid)
+        {
+          stats->rttvalid = true;
+          stats->rttseq   = end;
+          stats->rttstart = tcp_stats_now();
+        }
+
+      stats->sndmax = end;
+    }
+  else
+    {
+      /* A retransmission:  The ACK of the segment being timed may now be
+       * for either copy, so the sample can not be trusted.
+       */
+
+      stats->rexmits++;
+      stats->rttvalid = false;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_stats_input
+ *
+ * Description:
+ *   Account for a segment received on a connection:  count it and its
+ *   in-order data, duplicate ACKs and zero windows, and complete the round
+ *   trip time sample if the segment ACKs the timed data.  conn->winsize
+ *   must already hold the window of the segment.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection
+ *   tcp    - The TCP header of the incoming segment
+ *   len    - The length of the data in the segment
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_stats_input(FAR struct tcp_conn_s *conn,
+                     FAR const struct tcp_hdr_s *tcp, unsigned int len)
+{
+  FAR struct tcp_connstats_s *stats = &conn->stats;
+  uint32_t ackseq;
+  bool wndchanged;
+
+  stats->segsin++;
+
+  if (len > 0 && memcmp(tcp->seqno, conn->rcvseq, 4) == 0)
+    {
+      stats->bytesrcvd += len;
+    }
+
+  wndchanged = conn->winsize != stats->sndwnd;
+  if (wndchanged && conn->winsize == 0)
+    {
+      stats->zerowins++;
+    }
+
+  stats->sndwnd = conn->winsize;
+
+  if ((tcp->flags & TCP_ACK) == 0 || stats->segsout == 0)
+    {
+      return;
+    }
+
+  /* Ignore ACKs of data that was never sent */
+
+  ackseq = tcp_getsequence((FAR uint8_t *)tcp->ackno);
+  if (SEQ_GT(ackseq, stats->sndmax))
+    {
+      return;
+    }
+
+  if (SEQ_GT(ackseq, stats->snduna))
+    {
+      stats->bytesacked += ackseq - stats->snduna;
+      stats->snduna      = ackseq;
+
+      if (stats->rttvalid && SEQ_GE(ackseq, stats->rttseq))
+        {
+          tcp_stats_rtt(stats, tcp_stats_now() - stats->rttstart);
+          stats->rttvalid = false;
+        }
+    }
+  else if (ackseq == stats->snduna && stats->snduna != stats->sndmax &&
+           len == 0 && !wndchanged &&
+           (tcp->flags & (TCP_SYN | TCP_FIN)) == 0)
+    {
+      /* An ACK that does not move the window while data is outstanding
+       * (RFC 5681)
+       */
+
+      stats->dupacks++;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_stats_timeout
+ *
+ * Description:
+ *   Account for a retransmission time-out.  The segment being timed will
+ *   be retransmitted, so the round trip time sample is abandoned.
+ *
+ ****************************************************************************/
+
+void tcp_stats_timeout(FAR struct tcp_conn_s *conn)
+{
+  conn->stats.timeouts++;
+  conn->stats.rttvalid = false;
+}
+
+/****************************************************************************
+ * Name: tcp_stats_info
+ *
+ * Description:
+ *   Fill in a struct tcp_info (see netinet/tcp.h) for a connection.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_stats_info(FAR struct tcp_conn_s *conn, FAR struct tcp_info *info)
+{
+  FAR struct tcp_connstats_s *stats = &conn->stats;
+
+  memset(info, 0, sizeof(struct tcp_info));
+
+  info->tcpi_state          = conn->tcpstateflags & TCP_STATE_MASK;
+  info->tcpi_retransmits    = conn->nrtx;
+  info->tcpi_rto            = TCP_HSEC2USEC(conn->rto);
+  info->tcpi_rtt            = stats->srtt;
+  info->tcpi_rttvar         = stats->rttvar;
+  info->tcpi_snd_mss        = conn->mss;
+#ifdef CONFIG_NET_TCP_CC
+  info->tcpi_snd_cwnd       = conn->cwnd;
+  info->tcpi_snd_ssthresh   = conn->ssthresh;
+#endif
+  info->tcpi_snd_wnd        = conn->winsize;
+  info->tcpi_unacked        = conn->tx_unacked;
+  info->tcpi_total_retrans  = stats->rexmits;
+  info->tcpi_rto_timeouts   = stats->timeouts;
+  info->tcpi_dupacks        = stats->dupacks;
+  info->tcpi_zero_windows   = stats->zerowins;
+  info->tcpi_segs_out       = stats->segsout;
+  info->tcpi_segs_in        = stats->segsin;
+  info->tcpi_bytes_acked    = stats->bytesacked;
+  info->tcpi_bytes_received = stats->bytesrcvd;
+}
+
+#endif /* CONFIG_NET_TCP_CONNSTATS */
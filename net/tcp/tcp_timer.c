@@ -139,6 +139,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   dev->d_len    = 0;
   dev->d_sndlen = 0;
+  NETDEV_SET_TSOMSS(dev, 0);
 
   /* Check if the connection is in a state in which we simply wait
    * for the connection to time out. If so, we increase the
@@ -321,6 +322,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #ifdef CONFIG_NET_STATISTICS
               g_netstats.tcp.rexmit++;
 #endif
+              tcp_stats_timeout(conn);
               switch (conn->tcpstateflags & TCP_STATE_MASK)
                 {
                   case TCP_SYN_RCVD:
@@ -661,6 +661,32 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR void *buf,
                            size_t len, int flags, FAR struct sockaddr *from,
                            FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: psock_udp_recviob
+ *
+ * Description:
+ *   Remove the datagram at the head of the read-ahead queue of a UDP
+ *   socket and lend its I/O buffer chain to the caller, waiting for a
+ *   datagram if necessary.
+ *
+ * Input Parameters:
+ *   psock   - Pointer to the socket structure for the SOCK_DGRAM socket
+ *   iob     - Location to return the I/O buffer chain
+ *   flags   - Receive flags (only MSG_DONTWAIT is supported)
+ *   from    - Address of the source (may be NULL)
+ *   fromlen - The length of the address structure
+ *
+ * Returned Value:
+ *   The size of the datagram on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_udp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags, FAR struct sockaddr *from,
+                          FAR socklen_t *fromlen);
+#endif
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
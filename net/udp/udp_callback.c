@@ -287,6 +287,7 @@ net_dataevent(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.udp.drop++;
 #endif
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_NOBUFS);
     }
 
   /* In any event, the new data has now been handled */
@@ -130,7 +130,11 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = &dev->d_buf[hdrlen];
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  /* A zero checksum means that there is nothing to verify, either because
+   * the sender did not compute one or because the hardware already did.
+   */
+
+  chksum = NETDEV_RXCHKSUM_OFFLOAD(dev) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
@@ -159,6 +163,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
       g_netstats.udp.chkerr++;
 #endif
       nwarn("WARNING: Bad UDP checksum\n");
+      NETDEV_RXDROP(dev, NETDEV_RXDROP_CHKSUM);
       dev->d_len = 0;
     }
   else
@@ -228,6 +233,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
       else
         {
           nwarn("WARNING: No listener on UDP port\n");
+          NETDEV_RXDROP(dev, NETDEV_RXDROP_NOCONN);
           dev->d_len = 0;
         }
     }
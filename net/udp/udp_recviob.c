@@ -0,0 +1,212 @@
+/****************************************************************************
+ * net/udp/udp_recviob.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "udp/udp.h"
+#include "socket/socket.h"
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_RECVIOB)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct udp_recviob_s
+{
+  FAR struct devif_callback_s *ri_cb;     /* Reference to callback instance */
+  sem_t                        ri_sem;    /* Signals new data or an error */
+  int                          ri_result; /* OK or a negated errno value */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_recviob_eventhandler
+ *
+ * Description:
+ *   Wake up the waiting thread when a datagram arrives or the network
+ *   device goes down.  The datagram is not consumed here:  UDP_NEWDATA
+ *   stays set so that udp_callback() puts it into the read-ahead queue,
+ *   where the waiting thread will pick it up.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t udp_recviob_eventhandler(FAR struct net_driver_s *dev,
+                                         FAR void *pvconn, FAR void *pvpriv,
+                                         uint16_t flags)
+{
+  FAR struct udp_recviob_s *pstate = (FAR struct udp_recviob_s *)pvpriv;
+
+  ninfo("flags: %04x\n", flags);
+
+  if (pstate != NULL && (flags & (UDP_NEWDATA | NETDEV_DOWN)) != 0)
+    {
+      pstate->ri_result    = (flags & NETDEV_DOWN) != 0 ? -ENETUNREACH : OK;
+
+      pstate->ri_cb->flags = 0;
+      pstate->ri_cb->priv  = NULL;
+      pstate->ri_cb->event = NULL;
+
+      nxsem_post(&pstate->ri_sem);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_recviob
+ *
+ * Description:
+ *   Remove the datagram at the head of the read-ahead queue of a UDP
+ *   socket and lend its I/O buffer chain to the caller, waiting for a
+ *   datagram if necessary.  The source address that precedes the payload
+ *   in the read-ahead buffer is trimmed away (and returned in 'from').
+ *
+ * Input Parameters:
+ *   psock   - Pointer to the socket structure for the SOCK_DGRAM socket
+ *   iob     - Location to return the I/O buffer chain
+ *   flags   - Receive flags (only MSG_DONTWAIT is supported)
+ *   from    - Address of the source (may be NULL)
+ *   fromlen - The length of the address structure
+ *
+ * Returned Value:
+ *   The size of the datagram on success; a negated errno value on failure.
+ *   The caller must release the chain with
+ *   iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD).
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags, FAR struct sockaddr *from,
+                          FAR socklen_t *fromlen)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct net_driver_s *dev;
+  struct udp_recviob_s state;
+  ssize_t ret;
+
+  DEBUGASSERT(conn != NULL && iob != NULL);
+
+  nxsem_init(&state.ri_sem, 0, 0); /* Doesn't really fail */
+  nxsem_set_protocol(&state.ri_sem, SEM_PRIO_NONE);
+
+  net_lock();
+  for (; ; )
+    {
+      if (!IOB_QEMPTY(&conn->readahead))
+        {
+          FAR struct iob_s *head;
+          uint8_t src_addr_size;
+
+          head = iob_remove_queue(&conn->readahead);
+          DEBUGASSERT(head != NULL);
+
+          /* The chain starts with the size of the source address and the
+           * address itself (see udp_datahandler()).
+           */
+
+          iob_copyout(&src_addr_size, head, sizeof(uint8_t), 0);
+          if (from != NULL)
+            {
+              socklen_t len = *fromlen;
+
+              if (len > src_addr_size)
+                {
+                  len = src_addr_size;
+                }
+
+              iob_copyout((FAR uint8_t *)from, head, len, sizeof(uint8_t));
+              *fromlen = len;
+            }
+
+          *iob = iob_trimhead(head, src_addr_size + sizeof(uint8_t),
+                              IOBUSER_NET_UDP_READAHEAD);
+          ret  = (*iob)->io_pktlen;
+          break;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      /* Wait for a datagram to be put into the read-ahead queue.  The
+       * device may be NULL if the socket is bound to INADDR_ANY.
+       */
+
+      dev = udp_find_laddr_device(conn);
+
+      state.ri_cb = udp_callback_alloc(dev, conn);
+      if (state.ri_cb == NULL)
+        {
+          ret = -EBUSY;
+          break;
+        }
+
+      state.ri_result    = OK;
+      state.ri_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
+      state.ri_cb->priv  = (FAR void *)&state;
+      state.ri_cb->event = udp_recviob_eventhandler;
+
+      ret = net_timedwait(&state.ri_sem, _SO_TIMEOUT(psock->s_rcvtimeo));
+      udp_callback_free(dev, conn, state.ri_cb);
+
+      if (ret < 0 || state.ri_result < 0)
+        {
+          ret = ret == -ETIMEDOUT ? -EAGAIN :
+                ret < 0 ? ret : state.ri_result;
+          break;
+        }
+    }
+
+  net_unlock();
+  nxsem_destroy(&state.ri_sem);
+  return ret;
+}
+
+#endif /* NET_UDP_HAVE_STACK && CONFIG_NET_RECVIOB */
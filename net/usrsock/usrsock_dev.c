@@ -83,8 +83,8 @@ struct usrsockdev_s
     FAR const struct iovec *iov; /* Pending request buffers */
     int     iovcnt;              /* Number of request buffers */
     size_t  pos;                 /* Reader position on request buffer */
-    sem_t   sem;                 /* Request semaphore (only one outstanding
-                                  * request) */
+    sem_t   sem;                 /* Request semaphore (only one request
+                                  * being read by the daemon) */
     sem_t   acksem;              /* Request acknowledgment notification */
     uint8_t ack_xid;             /* Exchange id for which waiting ack */
     uint16_t nbusy;              /* Number of requests blocked from different
@@ -272,7 +272,9 @@ static uint8_t usrsockdev_get_xid(FAR struct usrsock_conn_s *conn)
 #endif
 
   /* Each connection can one only one request/response pending. So map
-   * connection structure index to xid value.
+   * connection structure index to xid value.  With
+   * CONFIG_NET_USRSOCK_PIPELINE, requests of different connections are
+   * outstanding at the same time and are told apart by this xid.
    */
 
   conn_idx = usrsock_connidx(conn);
@@ -396,6 +398,19 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
           dev->req.pos += rlen;
           len = rlen;
         }
+
+#ifdef CONFIG_NET_USRSOCK_PIPELINE
+      /* Once the whole request has been read, release the request line so
+       * that the next request can be read before this one is answered.
+       */
+
+      if (iovec_get(NULL, 0, dev->req.iov, dev->req.iovcnt,
+                    dev->req.pos) < 0)
+        {
+          dev->req.iov = NULL;
+          nxsem_post(&dev->req.acksem);
+        }
+#endif
     }
   else
     {
@@ -859,70 +874,92 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
       return ret;
     }
 
-  if (!dev->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header.
-       */
+  /* The daemon may write any number of messages (responses, events and
+   * the data that follows a data response) back-to-back with one write().
+   * An error in a message other than the first is reported by the next
+   * write(), which starts at that message.
+   */
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  while (len > 0)
+    {
+      if (!dev->datain_conn)
         {
-          nwarn("message too short, %d < %d.\n", len,
-                sizeof(struct usrsock_message_common_s));
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
 
-          ret = -EINVAL;
-          goto errout;
-        }
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              nwarn("message too short, %d < %d.\n", len,
+                    sizeof(struct usrsock_message_common_s));
 
-      /* Handle message. */
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Handle message. */
+
+          ret = usrsockdev_handle_message(dev, buffer, len);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      ret = usrsockdev_handle_message(dev, buffer, len);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
           ret = origlen - len;
         }
-    }
 
-  /* Data input handling. */
+      /* Data input handling. */
 
-  if (dev->datain_conn)
-    {
-      conn = dev->datain_conn;
+      if (dev->datain_conn)
+        {
+          conn = dev->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
-                      conn->resp.datain.pos, buffer, len);
-      if (ret < 0)
-        {
-          /* Tried writing beyond buffer. */
+          ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
+                          conn->resp.datain.pos, buffer, len);
+          if (ret < 0)
+            {
+              /* Tried writing beyond buffer. */
 
-          ret = -EINVAL;
-          conn->resp.result = -EINVAL;
-          conn->resp.datain.pos =
-              conn->resp.datain.total;
-        }
-      else
-        {
-          conn->resp.datain.pos += ret;
-          buffer += ret;
-          len -= ret;
-          ret = origlen - len;
-        }
+              ret = -EINVAL;
+              conn->resp.result = -EINVAL;
+              conn->resp.datain.pos =
+                  conn->resp.datain.total;
+            }
+          else
+            {
+              conn->resp.datain.pos += ret;
+              buffer += ret;
+              len -= ret;
+              ret = origlen - len;
+            }
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
-        {
-          dev->datain_conn = NULL;
+          if (conn->resp.datain.pos == conn->resp.datain.total)
+            {
+              dev->datain_conn = NULL;
+
+              /* Done with data response. */
 
-          /* Done with data response. */
+              usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+            }
 
-          usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+          if (ret < 0)
+            {
+              break;
+            }
         }
     }
 
-errout:
+  /* Report the messages that were handled before an error */
+
+  if (ret < 0 && len < origlen)
+    {
+      ret = origlen - len;
+    }
+
   usrsockdev_semgive(&dev->devsem);
   return ret;
 }
@@ -67,42 +67,89 @@
  ****************************************************************************/
 
 #ifndef CONFIG_NET_ARCH_CHKSUM
-uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+uint16_t locate_fast chksum(uint16_t sum, FAR const uint8_t *data,
+                            uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint32_t acc = 0;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* len is at most 65535, so at most 32768 16-bit words each no greater
+   * than 0xffff are summed.  That cannot overflow a 32-bit accumulator, so
+   * the carries can all be folded in once at the end.
+   */
 
-  while (dataptr < last_byte)
+  if (((uintptr_t)data & 1) == 0)
     {
-      /* At least two more bytes */
+      FAR const uint16_t *wptr = (FAR const uint16_t *)data;
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
+      /* Aligned:  Sum native 16-bit words, eight per iteration.  The one's
+       * complement sum is byte order independent (RFC 1071), so the result
+       * only needs to be byte-swapped once at the end on little-endian
+       * machines.
+       */
+
+      for (; len >= 16; len -= 16, wptr += 8)
         {
-          sum++; /* carry */
+          acc += (uint32_t)wptr[0] + wptr[1] + wptr[2] + wptr[3] +
+                 wptr[4] + wptr[5] + wptr[6] + wptr[7];
         }
 
-      dataptr += 2;
-    }
+      for (; len >= 2; len -= 2)
+        {
+          acc += *wptr++;
+        }
 
-  if (dataptr == last_byte)
+      if (len > 0)
+        {
+          /* The odd trailing byte is the high byte of a zero-padded
+           * network order word.
+           */
+
+#ifdef CONFIG_ENDIAN_BIG
+          acc += (uint32_t)(*(FAR const uint8_t *)wptr) << 8;
+#else
+          acc += *(FAR const uint8_t *)wptr;
+#endif
+        }
+
+      acc = (acc >> 16) + (acc & 0xffff);
+      acc = (acc >> 16) + (acc & 0xffff);
+
+#ifndef CONFIG_ENDIAN_BIG
+      acc = ((acc & 0xff) << 8) | (acc >> 8);
+#endif
+    }
+  else
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      /* Unaligned:  Assemble network order words a byte at a time */
+
+      for (; len >= 8; len -= 8, data += 8)
         {
-          sum++; /* carry */
+          acc += ((uint32_t)data[0] << 8) + data[1] +
+                 ((uint32_t)data[2] << 8) + data[3] +
+                 ((uint32_t)data[4] << 8) + data[5] +
+                 ((uint32_t)data[6] << 8) + data[7];
+        }
+
+      for (; len >= 2; len -= 2, data += 2)
+        {
+          acc += ((uint32_t)data[0] << 8) + data[1];
+        }
+
+      if (len > 0)
+        {
+          acc += (uint32_t)data[0] << 8;
         }
     }
 
+  /* Add in the carried over sum and fold to 16 bits */
+
+  acc += sum;
+  acc  = (acc >> 16) + (acc & 0xffff);
+  acc  = (acc >> 16) + (acc & 0xffff);
+
   /* Return sum in host byte order. */
 
-  return sum;
+  return (uint16_t)acc;
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
@@ -132,7 +179,7 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
  ****************************************************************************/
 
 #ifndef CONFIG_NET_ARCH_CHKSUM
-uint16_t net_chksum(FAR uint16_t *data, uint16_t len)
+uint16_t locate_fast net_chksum(FAR uint16_t *data, uint16_t len)
 {
   return htons(chksum(0, (uint8_t *)data, len));
 }
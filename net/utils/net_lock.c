@@ -51,6 +51,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "utils/utils.h"
 
@@ -60,18 +61,76 @@
 
 #define NO_HOLDER (pid_t)-1
 
+#ifndef CONFIG_NET_LOCK_STATISTICS
+#  define net_lockstats_acquired(c,s)
+#  define net_lockstats_released()
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+/* The one lock shared by the socket layer and the network drivers.  The
+ * connection lists, the read-ahead and write queues and the devif callback
+ * chains are all protected by it, so it cannot yet be split per device or
+ * per connection.
+ */
+
 static sem_t        g_netlock;
 static pid_t        g_holder = NO_HOLDER;
 static unsigned int g_count  = 0;
 
+#ifdef CONFIG_NET_LOCK_STATISTICS
+static clock_t      g_holdstart;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_lockstats_acquired and net_lockstats_released
+ *
+ * Description:
+ *   Account for a newly taken or about to be released network lock.  Both
+ *   are called while the lock is held, so g_netstats.lock needs no further
+ *   protection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATISTICS
+static void net_lockstats_acquired(bool contended, clock_t start)
+{
+  clock_t now = clock_systime_ticks();
+
+  g_netstats.lock.nlocks++;
+  if (contended)
+    {
+      clock_t elapsed = now - start;
+
+      g_netstats.lock.ncontended++;
+      g_netstats.lock.waitticks += elapsed;
+      if (elapsed > g_netstats.lock.maxwait)
+        {
+          g_netstats.lock.maxwait = elapsed;
+        }
+    }
+
+  g_holdstart = now;
+}
+
+static void net_lockstats_released(void)
+{
+  clock_t elapsed = clock_systime_ticks() - g_holdstart;
+
+  g_netstats.lock.holdticks += elapsed;
+  if (elapsed > g_netstats.lock.maxhold)
+    {
+      g_netstats.lock.maxhold = elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: _net_takesem
  *
@@ -83,7 +142,30 @@ static unsigned int g_count  = 0;
 
 static int _net_takesem(void)
 {
+#ifdef CONFIG_NET_LOCK_STATISTICS
+  clock_t start;
+  int ret;
+
+  /* Try first so that contended acquisitions can be told apart */
+
+  ret = nxsem_trywait(&g_netlock);
+  if (ret >= 0)
+    {
+      net_lockstats_acquired(false, 0);
+      return ret;
+    }
+
+  start = clock_systime_ticks();
+  ret   = nxsem_wait_uninterruptible(&g_netlock);
+  if (ret >= 0)
+    {
+      net_lockstats_acquired(true, start);
+    }
+
+  return ret;
+#else
   return nxsem_wait_uninterruptible(&g_netlock);
+#endif
 }
 
 /****************************************************************************
@@ -268,6 +350,7 @@ int net_trylock(void)
         {
           /* Now this thread holds the semaphore */
 
+          net_lockstats_acquired(false, 0);
           g_holder = me;
           g_count  = 1;
         }
@@ -306,6 +389,7 @@ void net_unlock(void)
     {
       /* We no longer hold the semaphore */
 
+      net_lockstats_released();
       g_holder = NO_HOLDER;
       g_count  = 0;
       nxsem_post(&g_netlock);
@@ -348,6 +432,7 @@ int net_breaklock(FAR unsigned int *count)
 
       /* Release the network lock  */
 
+      net_lockstats_released();
       g_holder = NO_HOLDER;
       g_count  = 0;
 
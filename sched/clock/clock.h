@@ -101,4 +101,10 @@ int  clock_time2ticks(FAR const struct timespec *reltime,
                       FAR sclock_t *ticks);
 int  clock_ticks2time(sclock_t ticks, FAR struct timespec *reltime);
 
+#ifdef CONFIG_CLOCK_USERPAGE
+void clock_timepage_update(void);
+#else
+#  define clock_timepage_update()
+#endif
+
 #endif /* __SCHED_CLOCK_CLOCK_H */
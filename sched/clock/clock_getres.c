@@ -44,6 +44,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+
 #include "clock/clock.h"
 
 /****************************************************************************
@@ -84,6 +86,20 @@ int clock_getres(clockid_t clock_id, struct timespec *res)
 
         sinfo("Returning res=(%d,%d)\n", (int)res->tv_sec, (int)res->tv_nsec);
         break;
+
+#ifdef CONFIG_SCHED_CPUTIME
+      case CLOCK_PROCESS_CPUTIME_ID:
+      case CLOCK_THREAD_CPUTIME_ID:
+
+        /* The resolution is one count of the platform cycle counter */
+
+        up_critmon_convert(1, res);
+        if (res->tv_sec == 0 && res->tv_nsec == 0)
+          {
+            res->tv_nsec = 1;
+          }
+        break;
+#endif
     }
 
   return ret;
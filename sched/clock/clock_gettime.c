@@ -50,6 +50,9 @@
 #include <nuttx/arch.h>
 
 #include "clock/clock.h"
+#ifdef CONFIG_SCHED_CPUTIME
+#  include "sched/sched.h"
+#endif
 #ifdef CONFIG_CLOCK_TIMEKEEPING
 #  include "clock/clock_timekeeping.h"
 #endif
@@ -59,14 +62,17 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: clock_gettime
+ * Name: nx_clock_gettime
  *
  * Description:
- *   Clock Functions based on POSIX APIs
+ *   The OS half of clock_gettime().  It is identical except that it
+ *   returns a negated errno value on failure instead of setting errno.
+ *   clock_gettime() itself lives in the C library so that it can read the
+ *   user time page (CONFIG_CLOCK_USERPAGE) without a system call.
  *
  ****************************************************************************/
 
-int clock_gettime(clockid_t clock_id, struct timespec *tp)
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
 {
   struct timespec ts;
   uint32_t carry;
@@ -99,6 +105,22 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
   else
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+  /* CLOCK_THREAD_CPUTIME_ID and CLOCK_PROCESS_CPUTIME_ID report the
+   * execution time of the calling thread and of its whole task group.
+   */
+
+  if (clock_id == CLOCK_THREAD_CPUTIME_ID)
+    {
+      ret = clock_cputime(this_task()->pid, tp);
+    }
+  else if (clock_id == CLOCK_PROCESS_CPUTIME_ID)
+    {
+      ret = clock_processtime(this_task()->pid, tp);
+    }
+  else
+#endif
+
   /* CLOCK_REALTIME - POSIX demands this to be present.  CLOCK_REALTIME
    * represents the machine's best-guess as to the current wall-clock,
    * time-of-day time. This means that CLOCK_REALTIME can jump forward and
@@ -154,14 +176,9 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
       ret = -EINVAL;
     }
 
-  /* Check for errors and set the errno value if necessary */
-
   if (ret < 0)
     {
-      serr("Returning ERROR\n");
-
-      set_errno(-ret);
-      ret = ERROR;
+      serr("Returning %d\n", ret);
     }
   else
     {
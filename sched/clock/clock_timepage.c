@@ -0,0 +1,67 @@
+/****************************************************************************
+ * sched/clock/clock_timepage.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/userspace.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_USERPAGE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Copy the system timer and the CLOCK_REALTIME base time to the user
+ *   time page.  Called from the timer interrupt and whenever the base time
+ *   changes.
+ *
+ * Assumptions:
+ *   Interrupts are disabled, so there is only one writer.
+ *
+ ****************************************************************************/
+
+void clock_timepage_update(void)
+{
+  FAR struct clock_timepage_s *page = USERSPACE->us_timepage;
+
+  if (page != NULL)
+    {
+      page->seq++;
+      page->ticks     = g_system_timer;
+      page->base_sec  = g_basetime.tv_sec;
+      page->base_nsec = g_basetime.tv_nsec;
+      page->seq++;
+    }
+}
+
+#endif /* CONFIG_CLOCK_USERPAGE */
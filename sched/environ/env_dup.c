@@ -42,11 +42,9 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <sched.h>
-#include <string.h>
-#include <errno.h>
-
-#include <nuttx/kmalloc.h>
+#include <assert.h>
 
 #include "sched/sched.h"
 #include "environ/environ.h"
@@ -60,8 +58,9 @@
  *
  * Description:
  *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   that is performed when a new task is created: The new task has an exact
+ *   duplicate of the parent task's environment.  The environment is shared
+ *   with the parent until either of them modifies it.
  *
  * Input Parameters:
  *   group - The child task group to receive the newly allocated copy of the
@@ -78,9 +77,7 @@
 int env_dup(FAR struct task_group_s *group)
 {
   FAR struct tcb_s *ptcb = this_task();
-  FAR char *envp = NULL;
-  size_t envlen;
-  int ret = OK;
+  FAR struct env_s *env;
 
   DEBUGASSERT(group != NULL && ptcb != NULL && ptcb->group != NULL);
 
@@ -94,46 +91,23 @@ int env_dup(FAR struct task_group_s *group)
 
   if (ptcb->group != NULL && ptcb->group->tg_envp != NULL)
     {
-      /* Yes.. The parent task has an environment allocation. */
-
-      envlen = ptcb->group->tg_envsize;
-      envp   = NULL;
-
-      /* A special case is that the parent has an "empty" environment
-       * allocation, i.e., there is an allocation in place but it
-       * contains no variable definitions and, hence, envlen == 0.
+      /* Yes.. The parent task has an environment allocation.  Just take
+       * another reference to it.  env_unshare() will copy it as soon as
+       * either task group modifies it.
        */
 
-      if (envlen > 0)
-        {
-          /* There is an environment, duplicate it */
-
-          envp = (FAR char *)kumm_malloc(envlen);
-          if (envp == NULL)
-            {
-              /* The parent's environment can not be inherited due to a
-               * failure in the allocation of the child environment.
-               */
-
-              envlen = 0;
-              ret    = -ENOMEM;
-            }
-          else
-            {
-              /* Duplicate the parent environment. */
-
-              memcpy(envp, ptcb->group->tg_envp, envlen);
-            }
-        }
+      env = ENV_HDR(ptcb->group->tg_envp);
+      DEBUGASSERT(env->ev_crefs > 0 && env->ev_crefs < INT16_MAX);
+      env->ev_crefs++;
 
       /* Save the size and child environment allocation. */
 
-      group->tg_envsize = envlen;
-      group->tg_envp    = envp;
+      group->tg_envsize = ptcb->group->tg_envsize;
+      group->tg_envp    = ptcb->group->tg_envp;
     }
 
   sched_unlock();
-  return ret;
+  return OK;
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
@@ -99,6 +99,10 @@ static bool env_cmpname(const char *pszname, const char *peqname)
 
 FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname)
 {
+#if CONFIG_SCHED_ENV_HASHSIZE > 0
+  FAR struct env_s *env;
+  unsigned int ndx;
+#endif
   FAR char *ptr;
   FAR char *end;
 
@@ -106,6 +110,30 @@ FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname)
 
   DEBUGASSERT(group != NULL && pname != NULL);
 
+#if CONFIG_SCHED_ENV_HASHSIZE > 0
+  /* Look up the name in the hash table, if it indexes all variables */
+
+  if (group->tg_envp != NULL && ENV_HDR(group->tg_envp)->ev_hashed)
+    {
+      env = ENV_HDR(group->tg_envp);
+      for (ndx = env_hash(pname); env->ev_hash[ndx] != 0; )
+        {
+          ptr = &group->tg_envp[env->ev_hash[ndx] - 1];
+          if (env_cmpname(pname, ptr))
+            {
+              return ptr;
+            }
+
+          if (++ndx >= CONFIG_SCHED_ENV_HASHSIZE)
+            {
+              ndx = 0;
+            }
+        }
+
+      return NULL;
+    }
+#endif
+
   /* Search for a name=value string with matching name */
 
   end = &group->tg_envp[group->tg_envsize];
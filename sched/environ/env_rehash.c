@@ -0,0 +1,114 @@
+/****************************************************************************
+ * sched/environ/env_rehash.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "environ/environ.h"
+
+#if !defined(CONFIG_DISABLE_ENVIRON) && CONFIG_SCHED_ENV_HASHSIZE > 0
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_rehash
+ *
+ * Description:
+ *   Rebuild the hash table of the environment.  This must be called after
+ *   name=value strings have been added to or removed from the environment.
+ *
+ * Input Parameters:
+ *   group - The task group with the modified environment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *   - The environment is not shared
+ *
+ ****************************************************************************/
+
+void env_rehash(FAR struct task_group_s *group)
+{
+  FAR struct env_s *env;
+  FAR char *ptr;
+  FAR char *end;
+  unsigned int nvars = 0;
+  unsigned int ndx;
+
+  DEBUGASSERT(group != NULL);
+
+  if (group->tg_envp == NULL)
+    {
+      return;
+    }
+
+  env = ENV_HDR(group->tg_envp);
+  DEBUGASSERT(env->ev_crefs == 1);
+
+  env->ev_hashed = false;
+  memset(env->ev_hash, 0, sizeof(env->ev_hash));
+
+  /* The offsets must fit into the table entries */
+
+  if (group->tg_envsize >= UINT16_MAX)
+    {
+      return;
+    }
+
+  end = &group->tg_envp[group->tg_envsize];
+  for (ptr = group->tg_envp; ptr < end; ptr += (strlen(ptr) + 1))
+    {
+      /* Keep at least one entry empty so that lookups terminate.  With
+       * more variables, env_findvar() falls back to a linear search.
+       */
+
+      if (++nvars >= CONFIG_SCHED_ENV_HASHSIZE)
+        {
+          return;
+        }
+
+      /* Linear probing for the next empty entry */
+
+      for (ndx = env_hash(ptr); env->ev_hash[ndx] != 0; )
+        {
+          if (++ndx >= CONFIG_SCHED_ENV_HASHSIZE)
+            {
+              ndx = 0;
+            }
+        }
+
+      env->ev_hash[ndx] = (uint16_t)(ptr - group->tg_envp) + 1;
+    }
+
+  env->ev_hashed = true;
+}
+
+#endif /* !CONFIG_DISABLE_ENVIRON && CONFIG_SCHED_ENV_HASHSIZE > 0 */
@@ -42,6 +42,7 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <sched.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
@@ -75,15 +76,29 @@
 
 void env_release(FAR struct task_group_s *group)
 {
+  FAR struct env_s *env;
+
   DEBUGASSERT(group != NULL);
 
+  /* Pre-emption must be disabled because the environment may be shared */
+
+  sched_lock();
+
   /* Free any allocate environment strings */
 
   if (group->tg_envp)
     {
-      /* Free the environment */
+      /* Drop the reference.  Free the environment if this task group was
+       * the last one using it.
+       */
+
+      env = ENV_HDR(group->tg_envp);
+      DEBUGASSERT(env->ev_crefs > 0);
 
-      kumm_free(group->tg_envp);
+      if (--env->ev_crefs <= 0)
+        {
+          kumm_free(env);
+        }
     }
 
   /* In any event, make sure that all environment-related variables in the
@@ -92,6 +107,7 @@ void env_release(FAR struct task_group_s *group)
 
   group->tg_envsize = 0;
   group->tg_envp = NULL;
+  sched_unlock();
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
@@ -67,6 +67,7 @@
  * Assumptions:
  *   - Not called from an interrupt handler
  *   - Caller has pre-emption disabled
+ *   - The environment is not shared (see env_unshare())
  *   - Caller will reallocate the environment structure to the correct size
  *
  ****************************************************************************/
@@ -108,6 +109,7 @@ int env_removevar(FAR struct task_group_s *group, FAR char *pvar)
        */
 
       group->tg_envsize -= len;
+      env_rehash(group);
       ret = OK;
     }
 
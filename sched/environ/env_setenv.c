@@ -83,8 +83,8 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 {
   FAR struct tcb_s *rtcb;
   FAR struct task_group_s *group;
+  FAR struct env_s *newenv;
   FAR char *pvar;
-  FAR char *newenvp;
   int newsize;
   int varlen;
   int ret = OK;
@@ -126,6 +126,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   /* Check if the variable already exists */
 
+  pvar = NULL;
   if (group->tg_envp && (pvar = env_findvar(group, name)) != NULL)
     {
       /* It does! Do we have permission to overwrite the existing value? */
@@ -137,13 +138,27 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
           sched_unlock();
           return OK;
         }
+    }
+
+  /* The environment will be modified.  Get a private copy first if it is
+   * still shared with another task group.
+   */
 
-      /* Yes.. just remove the name=value pair from the environment.  It will
-       * be added again below.  Note that we are responsible for reallocating
+  ret = env_unshare(group);
+  if (ret < 0)
+    {
+      ret = -ret;
+      goto errout_with_lock;
+    }
+
+  if (pvar != NULL)
+    {
+      /* Just remove the name=value pair from the environment.  It will be
+       * added again below.  Note that we are responsible for reallocating
        * the environment buffer; this will happen below.
        */
 
-      env_removevar(group, pvar);
+      env_removevar(group, env_findvar(group, name));
     }
 
   /* Get the size of the new name=value string.  The +2 is for the '=' and for
@@ -157,36 +172,39 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   if (group->tg_envp)
     {
       newsize = group->tg_envsize + varlen;
-      newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-      if (!newenvp)
+      newenv  = (FAR struct env_s *)
+        kumm_realloc(ENV_HDR(group->tg_envp), ENV_HDRSIZE + newsize);
+      if (!newenv)
         {
           ret = ENOMEM;
           goto errout_with_lock;
         }
 
-      pvar = &newenvp[group->tg_envsize];
+      pvar = &newenv->ev_env[group->tg_envsize];
     }
   else
     {
       newsize = varlen;
-      newenvp = (FAR char *)kumm_malloc(varlen);
-      if (!newenvp)
+      newenv  = (FAR struct env_s *)kumm_malloc(ENV_HDRSIZE + varlen);
+      if (!newenv)
         {
           ret = ENOMEM;
           goto errout_with_lock;
         }
 
-      pvar = newenvp;
+      newenv->ev_crefs = 1;
+      pvar = newenv->ev_env;
     }
 
   /* Save the new buffer and size */
 
-  group->tg_envp    = newenvp;
+  group->tg_envp    = newenv->ev_env;
   group->tg_envsize = newsize;
 
   /* Now, put the new name=value string into the environment buffer */
 
   sprintf(pvar, "%s=%s", name, value);
+  env_rehash(group);
   sched_unlock();
   return OK;
 
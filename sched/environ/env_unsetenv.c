@@ -76,8 +76,8 @@ int unsetenv(FAR const char *name)
 {
   FAR struct tcb_s *rtcb = this_task();
   FAR struct task_group_s *group = rtcb->group;
+  FAR struct env_s *newenv;
   FAR char *pvar;
-  FAR char *newenvp;
   int newsize;
   int ret = OK;
 
@@ -88,9 +88,21 @@ int unsetenv(FAR const char *name)
   sched_lock();
   if (group && (pvar = env_findvar(group, name)) != NULL)
     {
-      /* It does!  Remove the name=value pair from the environment. */
+      /* It does!  Get a private copy of the environment first if it is
+       * still shared with another task group.
+       */
 
-      env_removevar(group, pvar);
+      ret = env_unshare(group);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          sched_unlock();
+          return ERROR;
+        }
+
+      /* Remove the name=value pair from the environment. */
+
+      env_removevar(group, env_findvar(group, name));
 
       /* Reallocate the new environment buffer */
 
@@ -101,7 +113,7 @@ int unsetenv(FAR const char *name)
 
           if (group->tg_envp != NULL)
             {
-              kumm_free(group->tg_envp);
+              kumm_free(ENV_HDR(group->tg_envp));
               group->tg_envp = NULL;
             }
 
@@ -111,8 +123,9 @@ int unsetenv(FAR const char *name)
         {
           /* Reallocate the environment to reclaim a little memory */
 
-          newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-          if (newenvp == NULL)
+          newenv = (FAR struct env_s *)
+            kumm_realloc(ENV_HDR(group->tg_envp), ENV_HDRSIZE + newsize);
+          if (newenv == NULL)
             {
               set_errno(ENOMEM);
               ret = ERROR;
@@ -123,7 +136,7 @@ int unsetenv(FAR const char *name)
                * to reallocation).
                */
 
-              group->tg_envp = newenvp;
+              group->tg_envp = newenv->ev_env;
             }
         }
     }
@@ -0,0 +1,102 @@
+/****************************************************************************
+ * sched/environ/env_unshare.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifndef CONFIG_DISABLE_ENVIRON
+
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "environ/environ.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Make sure that the environment of the task group is not shared with any
+ *   other task group, copying it if necessary.  This must be called before
+ *   the environment is modified.
+ *
+ * Input Parameters:
+ *   group - The task group whose environment will be modified
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the environment could not be copied.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group)
+{
+  FAR struct env_s *env;
+  FAR struct env_s *newenv;
+  size_t size;
+
+  DEBUGASSERT(group != NULL);
+
+  if (group->tg_envp == NULL)
+    {
+      return OK;
+    }
+
+  env = ENV_HDR(group->tg_envp);
+  DEBUGASSERT(env->ev_crefs > 0);
+
+  if (env->ev_crefs == 1)
+    {
+      /* The environment is already private */
+
+      return OK;
+    }
+
+  /* Copy the header, with its hash table, and the name=value strings */
+
+  size   = ENV_HDRSIZE + group->tg_envsize;
+  newenv = (FAR struct env_s *)kumm_malloc(size);
+  if (newenv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newenv, env, size);
+  newenv->ev_crefs = 1;
+
+  /* Drop the reference to the shared environment */
+
+  env->ev_crefs--;
+  group->tg_envp = newenv->ev_env;
+  return OK;
+}
+
+#endif /* CONFIG_DISABLE_ENVIRON */
@@ -42,6 +42,11 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <nuttx/sched.h>
 
 /****************************************************************************
@@ -53,6 +58,43 @@
 #  define env_release(group) (0)
 #else
 
+#ifndef CONFIG_SCHED_ENV_HASHSIZE
+#  define CONFIG_SCHED_ENV_HASHSIZE 0
+#endif
+
+#if CONFIG_SCHED_ENV_HASHSIZE == 0
+#  define env_rehash(group)
+#endif
+
+/* The environment strings of a task group are preceded by a struct env_s
+ * header in the same allocation.  tg_envp points to the strings.
+ */
+
+#define ENV_HDRSIZE   offsetof(struct env_s, ev_env)
+#define ENV_HDR(envp) ((FAR struct env_s *)((FAR char *)(envp) - ENV_HDRSIZE))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A child task group shares the environment of its parent until either of
+ * them modifies it (copy-on-write).  ev_crefs counts the sharing groups.
+ *
+ * ev_hash[] is an open addressing hash table of the variable names.  Each
+ * entry holds the offset of one name=value string plus one; zero means an
+ * empty entry.  It is not used if it cannot hold all of the variables.
+ */
+
+struct env_s
+{
+  int16_t  ev_crefs;           /* Number of task groups sharing it */
+#if CONFIG_SCHED_ENV_HASHSIZE > 0
+  bool     ev_hashed;          /* True: ev_hash[] indexes all variables */
+  uint16_t ev_hash[CONFIG_SCHED_ENV_HASHSIZE];
+#endif
+  char     ev_env[1];          /* The name=value strings */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -69,13 +111,37 @@ extern "C"
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: env_hash
+ *
+ * Description:
+ *   Return the hash of a variable name.  The name ends with either '\0' or
+ *   '=', so this works for names as well as for name=value strings.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_ENV_HASHSIZE > 0
+static inline unsigned int env_hash(FAR const char *pname)
+{
+  unsigned int hash = 0;
+
+  for (; *pname != '\0' && *pname != '='; pname++)
+    {
+      hash = 31 * hash + (unsigned char)*pname;
+    }
+
+  return hash % CONFIG_SCHED_ENV_HASHSIZE;
+}
+#endif
+
 /****************************************************************************
  * Name: env_dup
  *
  * Description:
  *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   that is performed when a new task is created: The new task has an exact
+ *   duplicate of the parent task's environment.  The environment is shared
+ *   with the parent until either of them modifies it.
  *
  * Input Parameters:
  *   group - The child task group to receive the newly allocated copy of the
@@ -159,6 +225,52 @@ FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 
 int env_removevar(FAR struct task_group_s *group, FAR char *pvar);
 
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Make sure that the environment of the task group is not shared with any
+ *   other task group, copying it if necessary.  This must be called before
+ *   the environment is modified.
+ *
+ * Input Parameters:
+ *   group - The task group whose environment will be modified
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the environment could not be copied.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group);
+
+/****************************************************************************
+ * Name: env_rehash
+ *
+ * Description:
+ *   Rebuild the hash table of the environment.  This must be called after
+ *   name=value strings have been added to or removed from the environment.
+ *
+ * Input Parameters:
+ *   group - The task group with the modified environment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *   - The environment is not shared
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_ENV_HASHSIZE > 0
+void env_rehash(FAR struct task_group_s *group);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
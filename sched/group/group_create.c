@@ -52,6 +52,7 @@
 #include "environ/environ.h"
 #include "sched/sched.h"
 #include "group/group.h"
+#include "task/task.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -219,7 +220,7 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 
   /* Allocate the group structure and assign it to the TCB */
 
-  group = (FAR struct task_group_s *)kmm_zalloc(sizeof(struct task_group_s));
+  group = nxtask_groupalloc();
   if (!group)
     {
       return -ENOMEM;
@@ -248,7 +249,7 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 
   if (!group->tg_streamlist)
     {
-      kmm_free(group);
+      nxtask_groupfree(group);
       return -ENOMEM;
     }
 
@@ -278,7 +279,7 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 #if defined(CONFIG_FILE_STREAM) && defined(CONFIG_MM_KERNEL_HEAP)
       group_free(group, group->tg_streamlist);
 #endif
-      kmm_free(group);
+      nxtask_groupfree(group);
       tcb->cmn.group = NULL;
       return ret;
     }
@@ -340,7 +341,7 @@ int group_initialize(FAR struct task_tcb_s *tcb)
   group->tg_members = kmm_malloc(GROUP_INITIAL_MEMBERS * sizeof(pid_t));
   if (!group->tg_members)
     {
-      kmm_free(group);
+      nxtask_groupfree(group);
       tcb->cmn.group = NULL;
       return -ENOMEM;
     }
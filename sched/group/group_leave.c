@@ -43,6 +43,7 @@
 #include "pthread/pthread.h"
 #include "mqueue/mqueue.h"
 #include "group/group.h"
+#include "task/task.h"
 
 /****************************************************************************
  * Private Functions
@@ -262,7 +263,7 @@ static inline void group_release(FAR struct task_group_s *group)
     {
       /* Release the group container itself */
 
-      kmm_free(group);
+      nxtask_groupfree(group);
     }
 }
 
@@ -355,6 +356,12 @@ void group_leave(FAR struct tcb_s *tcb)
   group = tcb->group;
   if (group)
     {
+#ifdef CONFIG_SCHED_CPUTIME
+      /* Retain the execution time of the member that is leaving */
+
+      group->tg_cputime += tcb->run_time;
+#endif
+
       /* Remove the member from group.  This function may be called
        * during certain error handling before the PID has been
        * added to the group.  In this case tcb->pid will be uninitialized
@@ -393,6 +400,12 @@ void group_leave(FAR struct tcb_s *tcb)
   group = tcb->group;
   if (group)
     {
+#ifdef CONFIG_SCHED_CPUTIME
+      /* Retain the execution time of the member that is leaving */
+
+      group->tg_cputime += tcb->run_time;
+#endif
+
       /* Yes, we have a group.. Is this the last member of the group? */
 
       if (group->tg_nmembers > 1)
@@ -74,9 +74,6 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
   /* The parent task is the one at the head of the ready-to-run list */
 
   FAR struct tcb_s *rtcb = this_task();
-  FAR struct file *parent;
-  FAR struct file *child;
-  int i;
 
   DEBUGASSERT(tcb && tcb->cmn.group && rtcb->group);
 
@@ -86,28 +83,8 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
    * accordingly above.
    */
 
-  /* Get pointers to the parent and child task file lists */
-
-  parent = rtcb->group->tg_filelist.fl_files;
-  child  = tcb->cmn.group->tg_filelist.fl_files;
-
-  /* Check each file in the parent file list */
-
-  for (i = 0; i < NFDS_TOCLONE; i++)
-    {
-      /* Check if this file is opened by the parent.  We can tell if
-       * if the file is open because it contain a reference to a non-NULL
-       * i-node structure.
-       */
-
-      if (parent[i].f_inode &&
-          (parent[i].f_oflags & O_CLOEXEC) == 0)
-        {
-          /* Yes... duplicate it for the child */
-
-          file_dup2(&parent[i], &child[i]);
-        }
-    }
+  files_duplist(&rtcb->group->tg_filelist, &tcb->cmn.group->tg_filelist,
+                NFDS_TOCLONE);
 }
 #else /* !CONFIG_FDCLONE_DISABLE */
 #  define sched_dupfiles(tcb)
@@ -133,9 +110,6 @@ static inline void sched_dupsockets(FAR struct task_tcb_s *tcb)
   /* The parent task is the one at the head of the ready-to-run list */
 
   FAR struct tcb_s *rtcb = this_task();
-  FAR struct socket *parent;
-  FAR struct socket *child;
-  int i;
 
   /* Duplicate the socket descriptors of all sockets opened by the parent
    * task.
@@ -143,30 +117,9 @@ static inline void sched_dupsockets(FAR struct task_tcb_s *tcb)
 
   DEBUGASSERT(tcb && tcb->cmn.group && rtcb->group);
 
-  /* Get pointers to the parent and child task socket lists */
-
-  parent = rtcb->group->tg_socketlist.sl_sockets;
-  child  = tcb->cmn.group->tg_socketlist.sl_sockets;
-
-  /* Check each socket in the parent socket list */
-
-  for (i = 0; i < CONFIG_NSOCKET_DESCRIPTORS; i++)
-    {
-      /* Check if this parent socket is valid.  Valid means both (1)
-       * allocated and (2) successfully initialized.  A complexity in SMP
-       * mode is that a socket my be allocated, but not yet initialized when
-       * the socket is cloned by another pthread.
-       *
-       * Sockets with the close-on-exec flag set should not be cloned either.
-       */
-
-      if (_PS_VALID(&parent[i]) && !_SS_ISCLOEXEC(parent[i].s_flags))
-        {
-          /* Yes... duplicate it for the child */
+  /* Sockets that are not valid or close-on-exec are not cloned */
 
-          psock_dup2(&parent[i], &child[i]);
-        }
-    }
+  net_duplist(&rtcb->group->tg_socketlist, &tcb->cmn.group->tg_socketlist);
 }
 #else /* CONFIG_NET && !CONFIG_SDCLONE_DISABLE */
 #  define sched_dupsockets(tcb)
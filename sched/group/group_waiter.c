@@ -43,6 +43,7 @@
 
 #include "nuttx/sched.h"
 #include "group/group.h"
+#include "task/task.h"
 
 #if defined(CONFIG_SCHED_WAITPID) && !defined(CONFIG_SCHED_HAVE_PARENT)
 
@@ -91,7 +92,7 @@ void group_del_waiter(FAR struct task_group_s *group)
        * freed).
        */
 
-      kmm_free(group);
+      nxtask_groupfree(group);
     }
 }
 
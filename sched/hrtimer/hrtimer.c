@@ -0,0 +1,348 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/timers/oneshot.h>
+
+#ifdef CONFIG_HRTIMER
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error CONFIG_HRTIMER requires 64-bit integer support
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Never ask the hardware for a zero-length delay; overdue timers are run
+ * from an interrupt this far in the future instead.
+ */
+
+#define HRTIMER_MIN_DELAY  NSEC_PER_USEC
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct oneshot_lowerhalf_s *g_hrtimer_lower;
+
+/* Active timers, sorted by expiration time */
+
+static FAR struct hrtimer_s *g_hrtimer_head;
+
+/* The longest delay the oneshot timer supports */
+
+static uint64_t g_hrtimer_maxdelay;
+
+/* True while expired timers are being run.  Timers started or cancelled by
+ * the expiration functions do not reprogram the hardware; that is done
+ * once when they have all run.
+ */
+
+static bool g_hrtimer_running;
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void hrtimer_expire(FAR struct oneshot_lowerhalf_s *lower,
+                           FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint64_t hrtimer_ts2ns(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static inline void hrtimer_ns2ts(uint64_t ns, FAR struct timespec *ts)
+{
+  ts->tv_sec  = (time_t)(ns / NSEC_PER_SEC);
+  ts->tv_nsec = (long)(ns % NSEC_PER_SEC);
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Arm the oneshot timer for the timer at the head of the list.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void hrtimer_reprogram(void)
+{
+  struct timespec ts;
+  uint64_t now;
+  uint64_t delay;
+
+  ONESHOT_CANCEL(g_hrtimer_lower, &ts);
+
+  if (g_hrtimer_head != NULL)
+    {
+      now   = hrtimer_gettime();
+      delay = g_hrtimer_head->expire > now ?
+              g_hrtimer_head->expire - now : 0;
+
+      if (delay < HRTIMER_MIN_DELAY)
+        {
+          delay = HRTIMER_MIN_DELAY;
+        }
+      else if (delay > g_hrtimer_maxdelay)
+        {
+          /* Wake up early; hrtimer_expire() will find nothing due and
+           * re-arm for the remainder.
+           */
+
+          delay = g_hrtimer_maxdelay;
+        }
+
+      hrtimer_ns2ts(delay, &ts);
+      ONESHOT_START(g_hrtimer_lower, hrtimer_expire, NULL, &ts);
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_remove
+ *
+ * Description:
+ *   Unlink an active timer.  Returns true if it was at the head of the
+ *   list.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static bool hrtimer_remove(FAR struct hrtimer_s *timer)
+{
+  FAR struct hrtimer_s **link;
+
+  for (link = &g_hrtimer_head; *link != NULL; link = &(*link)->next)
+    {
+      if (*link == timer)
+        {
+          *link       = timer->next;
+          timer->next = NULL;
+          timer->func = NULL;
+          return link == &g_hrtimer_head;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: hrtimer_expire
+ *
+ * Description:
+ *   The oneshot timer has fired:  run every timer that is due and re-arm
+ *   for the next one.
+ *
+ ****************************************************************************/
+
+static void hrtimer_expire(FAR struct oneshot_lowerhalf_s *lower,
+                           FAR void *arg)
+{
+  FAR struct hrtimer_s *timer;
+  irqstate_t flags;
+  wdentry_t func;
+  uint64_t now;
+
+  flags = enter_critical_section();
+  g_hrtimer_running = true;
+
+  now = hrtimer_gettime();
+  while ((timer = g_hrtimer_head) != NULL && timer->expire <= now)
+    {
+      g_hrtimer_head = timer->next;
+      func           = timer->func;
+      timer->next    = NULL;
+      timer->func    = NULL;
+
+      /* The function may restart this or any other timer */
+
+      func(timer->arg);
+    }
+
+  g_hrtimer_running = false;
+  hrtimer_reprogram();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ ****************************************************************************/
+
+void hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower)
+{
+  struct timespec ts;
+
+  DEBUGASSERT(lower != NULL && lower->ops->current != NULL);
+
+  ONESHOT_MAX_DELAY(lower, &ts);
+  g_hrtimer_maxdelay = hrtimer_ts2ns(&ts);
+  g_hrtimer_lower    = lower;
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void)
+{
+  struct timespec ts;
+
+  if (g_hrtimer_lower == NULL || ONESHOT_CURRENT(g_hrtimer_lower, &ts) < 0)
+    {
+      return 0;
+    }
+
+  return hrtimer_ts2ns(&ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_start_abs
+ ****************************************************************************/
+
+int hrtimer_start_abs(FAR struct hrtimer_s *timer, uint64_t expire,
+                      wdentry_t func, wdparm_t arg)
+{
+  FAR struct hrtimer_s **link;
+  irqstate_t flags;
+
+  DEBUGASSERT(timer != NULL && func != NULL);
+
+  if (g_hrtimer_lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      hrtimer_remove(timer);
+    }
+
+  timer->func   = func;
+  timer->arg    = arg;
+  timer->expire = expire;
+
+  /* Insert behind all timers that expire at the same time or earlier */
+
+  for (link = &g_hrtimer_head;
+       *link != NULL && (*link)->expire <= expire;
+       link = &(*link)->next);
+
+  timer->next = *link;
+  *link       = timer;
+
+  /* Re-arm the hardware if this is now the earliest timer.  This also
+   * covers the case where the previous head was the timer just removed.
+   */
+
+  if (!g_hrtimer_running && g_hrtimer_head == timer)
+    {
+      hrtimer_reprogram();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t delay,
+                  wdentry_t func, wdparm_t arg)
+{
+  return hrtimer_start_abs(timer, hrtimer_gettime() + delay, func, arg);
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(timer != NULL);
+
+  flags = enter_critical_section();
+  if (HRTIMER_ISACTIVE(timer) && hrtimer_remove(timer) &&
+      !g_hrtimer_running)
+    {
+      hrtimer_reprogram();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+  uint64_t remaining = 0;
+  uint64_t now;
+
+  flags = enter_critical_section();
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      now = hrtimer_gettime();
+      if (timer->expire > now)
+        {
+          remaining = timer->expire - now;
+        }
+    }
+
+  leave_critical_section(flags);
+  return remaining;
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -33,6 +33,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/board.h>
 #include <nuttx/init.h>
+#include <nuttx/initstep.h>
 #include <nuttx/symtab.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
@@ -45,6 +46,10 @@
 # include "wqueue/wqueue.h"
 # include "init/init.h"
 
+#ifdef CONFIG_STACK_MONITOR
+# include "sched/sched.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -231,15 +236,23 @@ static inline void nx_start_application(void)
   };
 #else
   FAR char *const *argv = NULL;
+#endif
+#if defined(CONFIG_BOARD_LATE_INITIALIZE) && defined(CONFIG_SCHED_INITSTEPS)
+  uint32_t start = initstep_now();
 #endif
   int ret;
 
 #ifdef CONFIG_BOARD_LATE_INITIALIZE
   /* Perform any last-minute, board-specific initialization, if so
-   * configured.
+   * configured.  The board may run its steps in parallel with
+   * initstep_run(); the total is added to the boot profile.
    */
 
   board_late_initialize();
+
+#ifdef CONFIG_SCHED_INITSTEPS
+  initstep_record("board_late_initialize", start, OK);
+#endif
 #endif
 
 #if defined(CONFIG_INIT_ENTRYPOINT)
@@ -424,6 +437,12 @@ int nx_bringup(void)
 
   nx_workqueues();
 
+#ifdef CONFIG_STACK_MONITOR
+  /* Start sampling the stack usage of all threads */
+
+  nxsched_stackmon_start();
+#endif
+
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
    * will be the first user-mode thread.
@@ -0,0 +1,457 @@
+/****************************************************************************
+ * sched/init/nx_initsteps.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <syslog.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/initstep.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_SCHED_INITSTEPS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_INITSTEPS_NPROFILE
+#  define CONFIG_SCHED_INITSTEPS_NPROFILE 32
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State of the table being run.  Protected by g_steplock. */
+
+struct initstep_run_s
+{
+  FAR const struct initstep_s *steps;
+  uint8_t nsteps;                  /* Number of steps in the table */
+  uint8_t nwaiting;                /* Threads waiting on g_stepwake */
+  uint32_t all;                    /* Mask of all steps in the table */
+  uint32_t started;                /* Steps started (or skipped) */
+  uint32_t done;                   /* Steps completed (or skipped) */
+  uint32_t failed;                 /* Steps that did not return OK */
+  int result[INITSTEP_MAX];        /* Result of each completed step */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_initlock = SEM_INITIALIZER(1);  /* One table at a time */
+static sem_t g_steplock = SEM_INITIALIZER(1);  /* Protects the state below */
+static sem_t g_stepwake;                       /* Threads waiting for steps */
+static sem_t g_stepexit;                       /* Posted as threads exit */
+
+static struct initstep_run_s g_run;
+
+/* The profile.  Entries are only appended, so readers need no lock. */
+
+static struct initstep_info_s g_profile[CONFIG_SCHED_INITSTEPS_NPROFILE];
+static volatile int g_nprofile;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initstep_append
+ *
+ * Description:
+ *   Append one entry to the profile.  Called with g_steplock held.
+ *
+ ****************************************************************************/
+
+static void initstep_append(FAR const char *name, uint32_t start,
+                            int result, int thread)
+{
+  FAR struct initstep_info_s *info;
+
+  if (g_nprofile < CONFIG_SCHED_INITSTEPS_NPROFILE)
+    {
+      info          = &g_profile[g_nprofile];
+      info->name    = name;
+      info->start   = start;
+      info->elapsed = initstep_now() - start;
+      info->result  = result;
+      info->thread  = thread;
+      g_nprofile++;
+    }
+}
+
+/****************************************************************************
+ * Name: initstep_complete
+ *
+ * Description:
+ *   Mark a step as done and wake up the threads waiting for it.  Called
+ *   with g_steplock held.
+ *
+ ****************************************************************************/
+
+static void initstep_complete(int ndx, int result)
+{
+  uint32_t bit = INITSTEP_DEP(ndx);
+
+  g_run.started    |= bit;
+  g_run.done       |= bit;
+  g_run.result[ndx] = result;
+
+  if (result != OK)
+    {
+      g_run.failed |= bit;
+    }
+
+  while (g_run.nwaiting > 0)
+    {
+      g_run.nwaiting--;
+      nxsem_post(&g_stepwake);
+    }
+}
+
+/****************************************************************************
+ * Name: initstep_next
+ *
+ * Description:
+ *   Return the index of the next step that may run, or -1 if there is
+ *   none.  Steps that depend on a failed step are completed here with
+ *   -ECANCELED.  Called with g_steplock held.
+ *
+ ****************************************************************************/
+
+static int initstep_next(void)
+{
+  FAR const struct initstep_s *step;
+  uint32_t bit;
+  int ndx;
+
+  for (ndx = 0; ndx < g_run.nsteps; ndx++)
+    {
+      bit  = INITSTEP_DEP(ndx);
+      step = &g_run.steps[ndx];
+
+      if ((g_run.started & bit) != 0)
+        {
+          continue;
+        }
+
+      if ((step->deps & g_run.failed) != 0)
+        {
+          /* Skipping this step may in turn skip an earlier one */
+
+          initstep_append(step->name, initstep_now(), -ECANCELED, 0);
+          initstep_complete(ndx, -ECANCELED);
+          ndx = -1;
+        }
+      else if ((step->deps & ~g_run.done) == 0)
+        {
+          return ndx;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: initstep_worker
+ *
+ * Description:
+ *   Run steps until the table is complete.  This is run by the caller of
+ *   initstep_run() as 'thread' 0 and by each of the kernel threads.
+ *
+ ****************************************************************************/
+
+static void initstep_worker(int thread)
+{
+  FAR const struct initstep_s *step;
+  uint32_t start;
+  int ndx;
+  int ret;
+
+  nxsem_wait_uninterruptible(&g_steplock);
+
+  while (g_run.done != g_run.all)
+    {
+      ndx = initstep_next();
+      if (ndx >= 0)
+        {
+          step           = &g_run.steps[ndx];
+          g_run.started |= INITSTEP_DEP(ndx);
+          nxsem_post(&g_steplock);
+
+          start = initstep_now();
+          ret   = step->func();
+
+          nxsem_wait_uninterruptible(&g_steplock);
+          initstep_append(step->name, start, ret, thread);
+          initstep_complete(ndx, ret);
+        }
+      else if (g_run.started == g_run.done)
+        {
+          /* Nothing is running and nothing can be started:  The remaining
+           * steps depend on each other.
+           */
+
+          for (ndx = 0; ndx < g_run.nsteps; ndx++)
+            {
+              if ((g_run.done & INITSTEP_DEP(ndx)) == 0)
+                {
+                  serr("ERROR: Dependency cycle at %s\n",
+                       g_run.steps[ndx].name);
+                  initstep_complete(ndx, -EDEADLK);
+                }
+            }
+        }
+      else
+        {
+          /* Wait for one of the running steps to complete */
+
+          g_run.nwaiting++;
+          nxsem_post(&g_steplock);
+          nxsem_wait_uninterruptible(&g_stepwake);
+          nxsem_wait_uninterruptible(&g_steplock);
+        }
+    }
+
+  nxsem_post(&g_steplock);
+}
+
+/****************************************************************************
+ * Name: initstep_thread
+ *
+ * Description:
+ *   Entry point of the kernel threads started by initstep_run().  argv[1]
+ *   holds the thread number for the profile.
+ *
+ ****************************************************************************/
+
+static int initstep_thread(int argc, FAR char **argv)
+{
+  DEBUGASSERT(argc == 2);
+
+  initstep_worker(atoi(argv[1]));
+  nxsem_post(&g_stepexit);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: initstep_report
+ *
+ * Description:
+ *   Write the profile entries from 'first' on to the syslog.
+ *
+ ****************************************************************************/
+
+static void initstep_report(int first, uint32_t start)
+{
+  FAR struct initstep_info_s *info;
+  uint32_t total = 0;
+  int i;
+
+  for (i = first; i < g_nprofile; i++)
+    {
+      info   = &g_profile[i];
+      total += info->elapsed;
+
+      syslog(LOG_INFO, "initstep: %-24s %2u %6lu.%03lu ms %d\n",
+             info->name, (unsigned int)info->thread,
+             (unsigned long)(info->elapsed / 1000),
+             (unsigned long)(info->elapsed % 1000), info->result);
+    }
+
+  syslog(LOG_INFO, "initstep: %lu ms, %lu ms if run in sequence\n",
+         (unsigned long)((initstep_now() - start) / 1000),
+         (unsigned long)(total / 1000));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initstep_run
+ *
+ * Description:
+ *   Run a table of initialization steps and return when all of them have
+ *   completed.  See include/nuttx/initstep.h.
+ *
+ ****************************************************************************/
+
+int initstep_run(FAR const struct initstep_s *steps, int nsteps)
+{
+  FAR char *argv[2];
+  char arg[4];
+  uint32_t start;
+  uint32_t all;
+  int nthreads;
+  int first;
+  int ret;
+  int i;
+
+  if (steps == NULL || nsteps <= 0 || nsteps > INITSTEP_MAX)
+    {
+      return -EINVAL;
+    }
+
+  all = nsteps < 32 ? INITSTEP_DEP(nsteps) - 1 : UINT32_MAX;
+  for (i = 0; i < nsteps; i++)
+    {
+      if ((steps[i].deps & ~all) != 0 || steps[i].func == NULL)
+        {
+          return -EINVAL;
+        }
+    }
+
+  nxsem_wait_uninterruptible(&g_initlock);
+
+  start          = initstep_now();
+  first          = g_nprofile;
+
+  g_run.steps    = steps;
+  g_run.nsteps   = nsteps;
+  g_run.nwaiting = 0;
+  g_run.all      = all;
+  g_run.started  = 0;
+  g_run.done     = 0;
+  g_run.failed   = 0;
+
+  /* These are used for signaling and, hence, must not have priority
+   * inheritance enabled.
+   */
+
+  nxsem_init(&g_stepwake, 0, 0);
+  nxsem_set_protocol(&g_stepwake, SEM_PRIO_NONE);
+  nxsem_init(&g_stepexit, 0, 0);
+  nxsem_set_protocol(&g_stepexit, SEM_PRIO_NONE);
+
+  /* The caller runs steps too, so one thread fewer than steps suffices.
+   * If a thread cannot be created, the table still completes with fewer.
+   */
+
+  argv[0] = arg;
+  argv[1] = NULL;
+
+  for (nthreads = 0;
+       nthreads < CONFIG_SCHED_INITSTEPS_NTHREADS && nthreads < nsteps - 1;
+       nthreads++)
+    {
+      snprintf(arg, sizeof(arg), "%d", nthreads + 1);
+      ret = kthread_create("initstep", CONFIG_SCHED_INITSTEPS_PRIORITY,
+                           CONFIG_SCHED_INITSTEPS_STACKSIZE,
+                           (main_t)initstep_thread,
+                           (FAR char * const *)argv);
+      if (ret < 0)
+        {
+          serr("ERROR: kthread_create failed: %d\n", ret);
+          break;
+        }
+    }
+
+  initstep_worker(0);
+
+  while (nthreads-- > 0)
+    {
+      nxsem_wait_uninterruptible(&g_stepexit);
+    }
+
+  nxsem_destroy(&g_stepwake);
+  nxsem_destroy(&g_stepexit);
+
+  /* Report the first failure in table order */
+
+  ret = OK;
+  for (i = 0; i < nsteps && ret == OK; i++)
+    {
+      ret = g_run.result[i];
+    }
+
+  initstep_report(first, start);
+
+  g_run.steps = NULL;
+  nxsem_post(&g_initlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: initstep_record
+ *
+ * Description:
+ *   Add a step that was run directly by the caller to the profile.
+ *
+ ****************************************************************************/
+
+void initstep_record(FAR const char *name, uint32_t start, int result)
+{
+  nxsem_wait_uninterruptible(&g_steplock);
+  initstep_append(name, start, result, 0);
+  nxsem_post(&g_steplock);
+}
+
+/****************************************************************************
+ * Name: initstep_now
+ *
+ * Description:
+ *   Return the time since boot in microseconds.  This wraps after about 71
+ *   minutes, which is of no concern for the boot profile.
+ *
+ ****************************************************************************/
+
+uint32_t initstep_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC +
+         (uint32_t)ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: initstep_info
+ *
+ * Description:
+ *   Return the profile of the recorded step at 'index'.
+ *
+ ****************************************************************************/
+
+int initstep_info(int index, FAR struct initstep_info_s *info)
+{
+  if (index < 0 || index >= g_nprofile)
+    {
+      return -ENOENT;
+    }
+
+  *info = g_profile[index];
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_INITSTEPS */
@@ -74,6 +74,7 @@
 #include "timer/timer.h"
 #include "irq/irq.h"
 #include "group/group.h"
+#include "task/task.h"
 #include "init/init.h"
 
 /****************************************************************************
@@ -485,6 +486,14 @@ void nx_start(void)
       g_idletcb[cpu].cmn.affinity = SCHED_ALL_CPUS;
 #endif
 
+#ifdef CONFIG_SCHED_TICKLESS_SLACK
+      /* All tasks inherit the timer slack from their parent, ultimately
+       * from the IDLE task.
+       */
+
+      g_idletcb[cpu].cmn.timerslack = TIMER_SLACK_DEFAULT;
+#endif
+
 #if CONFIG_TASK_NAME_SIZE > 0
       /* Set the IDLE task name */
 
@@ -523,6 +532,9 @@ void nx_start(void)
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING);
 #endif
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+#ifndef CONFIG_SMP
+      nxsched_rebuild_index();
+#endif
 
       /* Mark the idle task as the running task */
 
@@ -535,6 +547,10 @@ void nx_start(void)
       if (cpu == 0)
         {
           up_initial_state(&g_idletcb[cpu].cmn);
+
+          /* up_initial_state() has set up the idle thread stack */
+
+          nxtask_setup_tlspid(&g_idletcb[cpu].cmn);
         }
     }
 
@@ -585,6 +601,14 @@ void nx_start(void)
       up_allocate_pgheap(&heap_start, &heap_size);
       mm_pginitialize(heap_start, heap_size);
 #endif
+
+#ifdef CONFIG_MM_REGION_HEAPS
+      /* Let the platform-specific code register the attribute tagged
+       * region heaps before anything is allocated from them.
+       */
+
+      up_allocate_regionheaps();
+#endif
     }
 #endif
 
@@ -598,6 +622,12 @@ void nx_start(void)
   iob_initialize();
 #endif
 
+#ifdef CONFIG_MM_SLAB
+  /* Create the TCB and task group caches */
+
+  nxtask_cacheinitialize();
+#endif
+
   /* The memory manager is available */
 
   g_nx_initstate = OSINIT_MEMORY;
@@ -74,6 +74,9 @@ struct irq_info_s
 {
   xcpt_t handler;    /* Address of the interrupt handler */
   FAR void *arg;     /* The argument provided to the interrupt handler. */
+#ifdef CONFIG_IRQ_AFFINITY
+  cpu_set_t affinity; /* The CPUs that the IRQ is routed to */
+#endif
 #ifdef CONFIG_SCHED_IRQMONITOR
   clock_t start;     /* Time interrupt attached */
 #ifdef CONFIG_HAVE_LONG_LONG
@@ -82,7 +85,21 @@ struct irq_info_s
   uint32_t mscount;  /* Number of interrupts on this IRQ (MS) */
   uint32_t lscount;  /* Number of interrupts on this IRQ (LS) */
 #endif
-  uint32_t time;     /* Maximum execution time on this IRQ */
+  uint32_t time;     /* Maximum execution time on this IRQ (ns) */
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t total;    /* Total execution time on this IRQ (ns) */
+#else
+  uint32_t total;    /* Total execution time on this IRQ (ns) */
+#endif
+#ifdef CONFIG_SMP
+  uint32_t cpucount[CONFIG_SMP_NCPUS]; /* Number of interrupts on each CPU */
+#endif
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM
+  clock_t winstart;  /* Start of the current storm detection window */
+  uint32_t wincount; /* Number of interrupts in the current window */
+  uint16_t storms;   /* Number of storms detected on this IRQ */
+  bool throttled;    /* The IRQ is disabled until the hold-off expires */
+#endif
 #endif
 };
 
@@ -228,6 +245,41 @@ bool irq_cpu_locked(int cpu);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_storm
+ *
+ * Description:
+ *   Called from irq_dispatch() when an IRQ has exceeded
+ *   CONFIG_SCHED_IRQMONITOR_STORM_LIMIT interrupts in one detection
+ *   window.  The storm is counted and, if throttling is enabled, the IRQ is
+ *   disabled until the hold-off timer expires.
+ *
+ * Input Parameters:
+ *   irq  - The IRQ number
+ *   info - The vector table entry of the IRQ
+ *
+ * Assumptions:
+ *   Called from interrupt level.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM
+void irq_storm(int irq, FAR struct irq_info_s *info);
+#endif
+
+/****************************************************************************
+ * Name: irq_thread_affinity
+ *
+ * Description:
+ *   Bind the handler thread of a threaded interrupt handler, if 'irq' has
+ *   one, to the CPUs in 'cpuset'.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_IRQTHREAD) && defined(CONFIG_IRQ_AFFINITY)
+void irq_thread_affinity(int irq, cpu_set_t cpuset);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
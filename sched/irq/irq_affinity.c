@@ -0,0 +1,179 @@
+/****************************************************************************
+ * sched/irq/irq_affinity.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQ_AFFINITY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The set of all CPUs */
+
+#define IRQ_ALLCPUS ((cpu_set_t)((1 << CONFIG_SMP_NCPUS) - 1))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_to_ndx
+ *
+ * Description:
+ *   Map an IRQ number to its vector table index.  Returns a negated errno
+ *   value if the IRQ number is not valid.
+ *
+ ****************************************************************************/
+
+static int irq_to_ndx(int irq)
+{
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+  if (g_irqmap[irq] >= CONFIG_ARCH_NUSER_INTERRUPTS)
+    {
+      return -EINVAL;
+    }
+
+  return g_irqmap[irq];
+#else
+  return irq;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset'.  If the IRQ has a
+ *   threaded handler (see irq_attach_thread()), the handler thread is
+ *   bound to the same CPUs.
+ *
+ * Input Parameters:
+ *   irq    - The IRQ number
+ *   cpuset - The set of CPUs that may take the interrupt
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if 'irq' or 'cpuset' is not valid.
+ *
+ ****************************************************************************/
+
+int irq_set_affinity(int irq, cpu_set_t cpuset)
+{
+  irqstate_t flags;
+  int ndx;
+
+  ndx = irq_to_ndx(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  if (cpuset == 0 || (cpuset & ~IRQ_ALLCPUS) != 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  g_irqvector[ndx].affinity = cpuset;
+  up_affinity_irq(irq, cpuset);
+  leave_critical_section(flags);
+
+#ifdef CONFIG_IRQTHREAD
+  irq_thread_affinity(irq, cpuset);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_get_affinity
+ *
+ * Description:
+ *   Return the set of CPUs that IRQ number 'irq' is routed to.
+ *
+ ****************************************************************************/
+
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset)
+{
+  int ndx;
+
+  ndx = irq_to_ndx(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  *cpuset = g_irqvector[ndx].affinity;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_get_cpu
+ *
+ * Description:
+ *   Return the lowest numbered CPU that IRQ number 'irq' is routed to.
+ *   Drivers use this to queue their bottom half work on the CPU that
+ *   takes the interrupt (see work_queue_cpu()).
+ *
+ ****************************************************************************/
+
+int irq_get_cpu(int irq)
+{
+  cpu_set_t cpuset;
+  int cpu;
+
+  if (irq_get_affinity(irq, &cpuset) < 0)
+    {
+      return 0;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if ((cpuset & (1 << cpu)) != 0)
+        {
+          return cpu;
+        }
+    }
+
+  return 0;
+}
+
+#endif /* CONFIG_IRQ_AFFINITY */
@@ -139,6 +139,8 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
       g_irqvector[ndx].mscount = 0;
       g_irqvector[ndx].lscount = 0;
 #endif
+      g_irqvector[ndx].time    = 0;
+      g_irqvector[ndx].total   = 0;
 #endif
 
       leave_critical_section(flags);
@@ -0,0 +1,390 @@
+/****************************************************************************
+ * sched/irq/irq_attach_thread.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQTHREAD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One threaded interrupt handler */
+
+struct irq_thread_s
+{
+  FAR struct irq_thread_s *flink; /* Supports a singly linked list */
+  xcpt_t isr;                     /* The top half, or NULL */
+  xcpt_t isrthread;               /* The bottom half */
+  FAR void *arg;                  /* Argument passed to both halves */
+  sem_t sem;                      /* Wakes up the handler thread */
+  int irq;                        /* The IRQ number */
+  pid_t pid;                      /* The handler thread */
+  volatile bool detached;         /* The handler thread should exit */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The attached threaded handlers, protected by the critical section */
+
+static FAR struct irq_thread_s *g_irq_threads;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   The interrupt handler that is attached with irq_attach():  Run the top
+ *   half and wake up the handler thread if the top half asks for it.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct irq_thread_s *info = (FAR struct irq_thread_s *)arg;
+  int ret = IRQ_WAKE_THREAD;
+  int semcount;
+
+  if (info->isr != NULL)
+    {
+      ret = info->isr(irq, context, info->arg);
+    }
+
+  if (ret == IRQ_WAKE_THREAD)
+    {
+      /* Merge wake-ups while the thread is already pending */
+
+      nxsem_get_value(&info->sem, &semcount);
+      if (semcount < 1)
+        {
+          nxsem_post(&info->sem);
+        }
+
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ *
+ * Description:
+ *   The handler thread:  Run the bottom half each time the top half wakes
+ *   it up, until the handler is detached.
+ *
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, FAR char *argv[])
+{
+  FAR struct irq_thread_s *info;
+
+  DEBUGASSERT(argc == 2);
+  info = (FAR struct irq_thread_s *)((uintptr_t)strtoul(argv[1], NULL, 0));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&info->sem);
+      if (info->detached)
+        {
+          break;
+        }
+
+      info->isrthread(info->irq, NULL, info->arg);
+    }
+
+  nxsem_destroy(&info->sem);
+  kmm_free(info);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_find
+ *
+ * Description:
+ *   Find the threaded handler of an IRQ.  Must be called from within a
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct irq_thread_s *irq_thread_find(int irq,
+                                   FAR struct irq_thread_s **pprev)
+{
+  FAR struct irq_thread_s *prev = NULL;
+  FAR struct irq_thread_s *info;
+
+  for (info = g_irq_threads; info != NULL; info = info->flink)
+    {
+      if (info->irq == irq)
+        {
+          break;
+        }
+
+      prev = info;
+    }
+
+  if (pprev != NULL)
+    {
+      *pprev = prev;
+    }
+
+  return info;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded interrupt handler to IRQ number 'irq'.  A kernel
+ *   thread named "irq<n>" is created at 'priority'.  When the interrupt
+ *   occurs, the top half 'isr' runs in interrupt context; if it returns
+ *   IRQ_WAKE_THREAD, 'isrthread' is then run on the thread with a NULL
+ *   context.  A NULL 'isr' wakes the thread on every interrupt.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - The top half, or NULL
+ *   isrthread  - The bottom half, run on the handler thread
+ *   arg        - The argument passed to both handlers
+ *   priority   - The priority of the handler thread
+ *   stack_size - The stack size of the handler thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size)
+{
+  FAR struct irq_thread_s *info;
+  FAR struct irq_thread_s *prev;
+  FAR char *argv[2];
+  char arg1[32];
+  char name[16];
+  irqstate_t flags;
+#ifdef CONFIG_IRQ_AFFINITY
+  cpu_set_t cpuset;
+#endif
+  pid_t pid;
+  int ret;
+
+  if ((unsigned)irq >= NR_IRQS || isrthread == NULL)
+    {
+      return -EINVAL;
+    }
+
+  info = (FAR struct irq_thread_s *)kmm_zalloc(sizeof(struct irq_thread_s));
+  if (info == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  info->isr       = isr;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+  info->irq       = irq;
+
+  /* The semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&info->sem, 0, 0);
+  nxsem_set_protocol(&info->sem, SEM_PRIO_NONE);
+
+  /* Only one threaded handler may be attached to an IRQ */
+
+  flags = enter_critical_section();
+  if (irq_thread_find(irq, NULL) != NULL)
+    {
+      leave_critical_section(flags);
+      ret = -EBUSY;
+      goto errout_with_info;
+    }
+
+  info->flink   = g_irq_threads;
+  g_irq_threads = info;
+  leave_critical_section(flags);
+
+  /* Start the handler thread.  It owns 'info' from now on. */
+
+  snprintf(name, sizeof(name), "irq%d", irq);
+  snprintf(arg1, sizeof(arg1), "%#lx", (unsigned long)((uintptr_t)info));
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  pid = kthread_create(name, priority, stack_size, irq_thread_main, argv);
+  if (pid < 0)
+    {
+      serr("ERROR: kthread_create failed: %d\n", (int)pid);
+      ret = (int)pid;
+
+      flags = enter_critical_section();
+      irq_thread_find(irq, &prev);
+      if (prev != NULL)
+        {
+          prev->flink = info->flink;
+        }
+      else
+        {
+          g_irq_threads = info->flink;
+        }
+
+      leave_critical_section(flags);
+      goto errout_with_info;
+    }
+
+  info->pid = pid;
+
+#ifdef CONFIG_IRQ_AFFINITY
+  /* Run the bottom half on the CPUs that take the interrupt */
+
+  if (irq_get_affinity(irq, &cpuset) == OK)
+    {
+      nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+    }
+#endif
+
+  ret = irq_attach(irq, irq_thread_isr, info);
+  if (ret < 0)
+    {
+      irq_detach_thread(irq);
+    }
+
+  return ret;
+
+errout_with_info:
+  nxsem_destroy(&info->sem);
+  kmm_free(info);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_detach_thread
+ *
+ * Description:
+ *   Detach a threaded interrupt handler attached with irq_attach_thread()
+ *   and terminate its handler thread.
+ *
+ * Input Parameters:
+ *   irq - The IRQ number
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if no threaded handler is attached.
+ *
+ ****************************************************************************/
+
+int irq_detach_thread(int irq)
+{
+  FAR struct irq_thread_s *info;
+  FAR struct irq_thread_s *prev;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  info = irq_thread_find(irq, &prev);
+  if (info == NULL)
+    {
+      leave_critical_section(flags);
+      return -ENOENT;
+    }
+
+  if (prev != NULL)
+    {
+      prev->flink = info->flink;
+    }
+  else
+    {
+      g_irq_threads = info->flink;
+    }
+
+  /* Detach the top half before the thread goes away; the thread then
+   * frees 'info' when it wakes up.
+   */
+
+  irq_detach(irq);
+  info->detached = true;
+  nxsem_post(&info->sem);
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_affinity
+ *
+ * Description:
+ *   Bind the handler thread of a threaded interrupt handler, if 'irq' has
+ *   one, to the CPUs in 'cpuset'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+void irq_thread_affinity(int irq, cpu_set_t cpuset)
+{
+  FAR struct irq_thread_s *info;
+  irqstate_t flags;
+  pid_t pid = 0;
+
+  flags = enter_critical_section();
+
+  info = irq_thread_find(irq, NULL);
+  if (info != NULL)
+    {
+      pid = info->pid;
+    }
+
+  leave_critical_section(flags);
+
+  if (pid > 0)
+    {
+      nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+    }
+}
+#endif
+
+#endif /* CONFIG_IRQTHREAD */
@@ -107,6 +107,9 @@ volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
 #ifdef CONFIG_SMP
 static inline bool irq_waitlock(int cpu)
 {
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  uint32_t nspins = 0;
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   FAR struct tcb_s *tcb = current_task(cpu);
 
@@ -137,10 +140,31 @@ static inline bool irq_waitlock(int cpu)
 
           return false;
         }
+
+      /* Poll with plain reads until the lock looks free before retrying
+       * the test-and-set (see spin_lock()).
+       */
+
+      while (spin_islocked(&g_cpu_irqlock) && !up_cpu_pausereq(cpu))
+        {
+          SP_DSB();
+#ifdef CONFIG_SPINLOCK_STATISTICS
+          nspins++;
+#endif
+        }
     }
 
   /* We have g_cpu_irqlock! */
 
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  g_spinlock_stats[cpu].nlocks++;
+  if (nspins > 0)
+    {
+      g_spinlock_stats[cpu].ncontended++;
+      g_spinlock_stats[cpu].nspins += nspins;
+    }
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
 
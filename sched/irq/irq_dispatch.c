@@ -77,7 +77,10 @@
 #endif
 
 /* CALL_VECTOR - Call the interrupt service routine attached to this
- * interrupt request
+ * interrupt request.  With CONFIG_SCHED_CRITMONITOR the handler is timed
+ * with the cycle counter behind up_critmon_gettime(); otherwise with the
+ * system clock, which has only tick resolution unless the system is
+ * tickless.
  */
 
 #ifndef CONFIG_SCHED_IRQMONITOR
@@ -94,10 +97,7 @@
          vector(irq, context, arg); \
          elapsed = up_critmon_gettime() - start; \
          up_critmon_convert(elapsed, &delta); \
-         if (delta.tv_nsec > g_irqvector[ndx].time) \
-           { \
-             g_irqvector[ndx].time = delta.tv_nsec; \
-           } \
+         irq_monitor(irq, ndx, &delta); \
        } \
      while (0)
 #else
@@ -111,14 +111,84 @@
          vector(irq, context, arg); \
          clock_systime_timespec(&end); \
          clock_timespec_subtract(&end, &start, &delta); \
-         if (delta.tv_nsec > g_irqvector[ndx].time) \
-           { \
-             g_irqvector[ndx].time = delta.tv_nsec; \
-           } \
+         irq_monitor(irq, ndx, &delta); \
        } \
      while (0)
 #endif /* CONFIG_SCHED_IRQMONITOR */
 
+/* This is the number of entries in the interrupt vector table */
+
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+#  define TAB_SIZE CONFIG_ARCH_NUSER_INTERRUPTS
+#else
+#  define TAB_SIZE NR_IRQS
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_monitor
+ *
+ * Description:
+ *   Account the execution time of one interrupt handler and check the IRQ
+ *   for an interrupt storm.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+static inline void irq_monitor(int irq, unsigned int ndx,
+                               FAR const struct timespec *delta)
+{
+  FAR struct irq_info_s *info;
+  uint32_t elapsed;
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM
+  clock_t now;
+#endif
+
+  if (ndx >= TAB_SIZE)
+    {
+      return;
+    }
+
+  info = &g_irqvector[ndx];
+
+  /* Saturate rather than wrap if a handler ran for a second or more */
+
+  elapsed = delta->tv_sec > 0 ? UINT32_MAX : (uint32_t)delta->tv_nsec;
+  if (elapsed > info->time)
+    {
+      info->time = elapsed;
+    }
+
+  info->total += elapsed;
+
+#ifdef CONFIG_SMP
+  info->cpucount[this_cpu()]++;
+#endif
+
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM
+  /* Count the interrupts in fixed windows.  irq_storm() is called once,
+   * on the first interrupt that tips a window over the limit.
+   */
+
+  now = clock_systime_ticks();
+  if (now - info->winstart >=
+      MSEC2TICK(CONFIG_SCHED_IRQMONITOR_STORM_WINDOW))
+    {
+      info->winstart = now;
+      info->wincount = 0;
+    }
+
+  if (++info->wincount == CONFIG_SCHED_IRQMONITOR_STORM_LIMIT + 1)
+    {
+      irq_storm(irq, info);
+    }
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -133,11 +203,22 @@
  *
  ****************************************************************************/
 
-void irq_dispatch(int irq, FAR void *context)
+void locate_fast irq_dispatch(int irq, FAR void *context)
 {
   xcpt_t vector = irq_unexpected_isr;
   FAR void *arg = NULL;
   unsigned int ndx = irq;
+#ifdef CONFIG_SCHED_CRITMONITOR
+  uint32_t irqstart;
+  int cpu = this_cpu();
+
+  /* Save the entry time of this interrupt for the wake-up latency.  Save
+   * the time of any interrupt that this one nested within.
+   */
+
+  irqstart                = g_critmon_irqstart[cpu];
+  g_critmon_irqstart[cpu] = up_critmon_gettime();
+#endif
 
 #if NR_IRQS > 0
   if ((unsigned)irq < NR_IRQS)
@@ -194,4 +275,8 @@ void irq_dispatch(int irq, FAR void *context)
    */
 
   g_running_tasks[this_cpu()] = this_task();
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  g_critmon_irqstart[cpu] = irqstart;
+#endif
 }
@@ -89,6 +89,9 @@ void irq_initialize(void)
     {
       g_irqvector[i].handler = irq_unexpected_isr;
       g_irqvector[i].arg     = NULL;
+#ifdef CONFIG_IRQ_AFFINITY
+      g_irqvector[i].affinity = 1 << 0;
+#endif
 #ifdef CONFIG_SCHED_IRQMONITOR
       g_irqvector[i].start   = 0;
 #ifdef CONFIG_HAVE_LONG_LONG
@@ -98,6 +101,7 @@ void irq_initialize(void)
       g_irqvector[i].lscount = 0;
 #endif
       g_irqvector[i].time    = 0;
+      g_irqvector[i].total   = 0;
 #endif
     }
 
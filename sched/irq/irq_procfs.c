@@ -41,6 +41,7 @@
 
 #include <sys/stat.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
 #include <assert.h>
@@ -61,26 +62,45 @@
 
 /* Output format:
  *
- *            1111111111222222222233333333334444444444
- *   1234567890123456789012345678901234567890123456789
+ *            1111111111222222222233333333334444444444555555555566666666667
+ *   1234567890123456789012345678901234567890123456789012345678901234567890
  *
- *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME
- *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD
+ *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME    TOTAL  LOAD STORM
+ *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD DDDDDDDD DDD.D DDDDDS
+ *
+ * TIME is the longest and TOTAL the accumulated handler execution time in
+ * microseconds, and LOAD is TOTAL as a percentage of the sampling
+ * interval.  STORM is the number of interrupt storms detected, followed by
+ * '*' while the IRQ is throttled.  On SMP, the number of interrupts taken
+ * by each CPU follows, and with CONFIG_IRQ_AFFINITY the set of CPUs that
+ * the IRQ is routed to.  Writing "<irq> <cpuset>" to the file changes that
+ * set.
  *
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME    TOTAL  " \
+                "LOAD STORM"
+#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu %8lu %3lu.%lu %5u%c"
+#define CPU_HDR_FMT "       CPU%d"
+#define CPU_FMT " %10lu"
+#define AFF_HDR_FMT "   AFFINITY"
+#define AFF_FMT " %10lx"
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#if defined(CONFIG_IRQ_AFFINITY)
+#  define IRQ_LINELEN (83 + 11 * CONFIG_SMP_NCPUS)
+#elif defined(CONFIG_SMP)
+#  define IRQ_LINELEN (72 + 11 * CONFIG_SMP_NCPUS)
+#else
+#  define IRQ_LINELEN 72
+#endif
 
 /****************************************************************************
  * Private Types
@@ -114,6 +134,10 @@ static int     irq_open(FAR struct file *filep, FAR const char *relpath,
 static int     irq_close(FAR struct file *filep);
 static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+#ifdef CONFIG_IRQ_AFFINITY
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+#endif
 static int     irq_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     irq_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -132,7 +156,11 @@ const struct procfs_operations irq_operations =
   irq_open,       /* open */
   irq_close,      /* close */
   irq_read,       /* read */
+#ifdef CONFIG_IRQ_AFFINITY
+  irq_write,      /* write */
+#else
   NULL,           /* write */
+#endif
 
   irq_dup,        /* dup */
 
@@ -165,6 +193,12 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   unsigned long intpart;
   unsigned long fracpart;
   unsigned long count;
+  unsigned long load;
+  bool throttled = false;
+  unsigned int storms = 0;
+#ifdef CONFIG_SMP
+  int cpu;
+#endif
 
   DEBUGASSERT(irqfile != NULL);
 
@@ -181,8 +215,20 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   info->lscount = 0;
 #endif
   info->time    = 0;
+  info->total   = 0;
+#ifdef CONFIG_SMP
+  memset(info->cpucount, 0, sizeof(info->cpucount));
+#endif
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM
+  info->storms  = 0;
+#endif
   leave_critical_section(flags);
 
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM
+  storms    = copy.storms;
+  throttled = copy.throttled;
+#endif
+
   /* Don't bother if count == 0.
    *
    * REVISIT:  There is a logic problem with skipping if the count is zero.
@@ -201,7 +247,7 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
    * byte offset into the pseudo-file, f_pos.
    */
 
-  if (copy.count == 0)
+  if (copy.count == 0 && !throttled)
     {
       return 0;
     }
@@ -233,6 +279,19 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
         (((copy.count * TICK_PER_SEC - intcount) * 1000) / elapsed);
     }
 
+  /* The handler load in tenths of a percent of the elapsed time */
+
+  load = 0;
+  if (elapsed > 0)
+    {
+      load = (unsigned long)
+        ((copy.total * 1000) / TICK2NSEC((uint64_t)elapsed));
+      if (load > 1000)
+        {
+          load = 1000;
+        }
+    }
+
   /* Make sure that the count is representable with snprintf format */
 
   if (copy.count > ULONG_MAX)
@@ -254,7 +313,27 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       (unsigned long)((uintptr_t)copy.handler),
                       (unsigned long)((uintptr_t)copy.arg),
                       count, intpart, fracpart,
-                      (unsigned long)copy.time / 1000);
+                      (unsigned long)copy.time / 1000,
+                      (unsigned long)(copy.total / 1000),
+                      load / 10, load % 10,
+                      storms, throttled ? '*' : ' ');
+
+#ifdef CONFIG_SMP
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      linesize += snprintf(&irqfile->line[linesize],
+                           IRQ_LINELEN - linesize, CPU_FMT,
+                           (unsigned long)copy.cpucount[cpu]);
+    }
+#endif
+
+#ifdef CONFIG_IRQ_AFFINITY
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       AFF_FMT, (unsigned long)copy.affinity);
+#endif
+
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       "\n");
 
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
@@ -288,6 +367,7 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Open '%s'\n", relpath);
 
+#ifndef CONFIG_IRQ_AFFINITY
   /* This PROCFS file is read-only.  Any attempt to open with write access
    * is not permitted.
    */
@@ -297,6 +377,7 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
       ferr("ERROR: Only O_RDONLY supported\n");
       return -EACCES;
     }
+#endif
 
   /* "irqs" is the only acceptable value for the relpath */
 
@@ -351,6 +432,9 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
   FAR struct irq_file_s *irqfile;
   size_t linesize;
   size_t copysize;
+#ifdef CONFIG_SMP
+  int cpu;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -369,6 +453,22 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 
   linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT);
 
+#ifdef CONFIG_SMP
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      linesize += snprintf(&irqfile->line[linesize],
+                           IRQ_LINELEN - linesize, CPU_HDR_FMT, cpu);
+    }
+#endif
+
+#ifdef CONFIG_IRQ_AFFINITY
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       AFF_HDR_FMT);
+#endif
+
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       "\n");
+
   copysize = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                            irqfile->remaining, &irqfile->offset);
 
@@ -388,6 +488,48 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
   return irqfile->ncopied;
 }
 
+/****************************************************************************
+ * Name: irq_write
+ *
+ * Description:
+ *   Change the affinity of an IRQ.  The input is "<irq> <cpuset>" where
+ *   <cpuset> is a CPU bit mask, e.g. "38 0x2" to route IRQ 38 to CPU1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  char cmd[32];
+  FAR char *endptr;
+  unsigned long irq;
+  unsigned long cpuset;
+  size_t len;
+  int ret;
+
+  len = buflen < sizeof(cmd) - 1 ? buflen : sizeof(cmd) - 1;
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  irq = strtoul(cmd, &endptr, 0);
+  if (endptr == cmd)
+    {
+      return -EINVAL;
+    }
+
+  cpuset = strtoul(endptr, &endptr, 0);
+
+  ret = irq_set_affinity((int)irq, (cpu_set_t)cpuset);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: irq_dup
  *
@@ -444,10 +586,13 @@ static int irq_stat(const char *relpath, struct stat *buf)
       return -ENOENT;
     }
 
-  /* "irqs" is the name for a read-only file */
+  /* "irqs" is the name for a read-only file, writable with IRQ affinity */
 
   memset(buf, 0, sizeof(struct stat));
   buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+#ifdef CONFIG_IRQ_AFFINITY
+  buf->st_mode |= S_IWUSR;
+#endif
   return OK;
 }
 
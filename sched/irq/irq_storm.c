@@ -0,0 +1,155 @@
+/****************************************************************************
+ * sched/irq/irq_storm.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM_THROTTLE
+/* One hold-off timer serves all throttled IRQs */
+
+static struct wdog_s g_irq_stormdog;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_storm_expiry
+ *
+ * Description:
+ *   The hold-off timer has expired:  Re-enable every throttled IRQ that
+ *   still has a handler attached.  An IRQ throttled shortly before the
+ *   expiry is re-enabled early, which only shortens its hold-off.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM_THROTTLE
+static void irq_storm_expiry(wdparm_t arg)
+{
+  FAR struct irq_info_s *info;
+  irqstate_t flags;
+  int irq;
+
+  flags = enter_critical_section();
+
+  for (irq = 0; irq < NR_IRQS; irq++)
+    {
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+      int ndx = g_irqmap[irq];
+
+      if (ndx >= CONFIG_ARCH_NUSER_INTERRUPTS)
+        {
+          continue;
+        }
+#else
+      int ndx = irq;
+#endif
+
+      info = &g_irqvector[ndx];
+      if (info->throttled)
+        {
+          info->throttled = false;
+          info->winstart  = clock_systime_ticks();
+          info->wincount  = 0;
+
+          if (info->handler != NULL && info->handler != irq_unexpected_isr)
+            {
+              up_enable_irq(irq);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_storm
+ *
+ * Description:
+ *   Called from irq_dispatch() when an IRQ has exceeded
+ *   CONFIG_SCHED_IRQMONITOR_STORM_LIMIT interrupts in one detection
+ *   window.  The storm is counted and, if throttling is enabled, the IRQ is
+ *   disabled until the hold-off timer expires.
+ *
+ * Input Parameters:
+ *   irq  - The IRQ number
+ *   info - The vector table entry of the IRQ
+ *
+ * Assumptions:
+ *   Called from interrupt level.
+ *
+ ****************************************************************************/
+
+void irq_storm(int irq, FAR struct irq_info_s *info)
+{
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM_THROTTLE
+  irqstate_t flags;
+#endif
+
+  if (info->storms < UINT16_MAX)
+    {
+      info->storms++;
+    }
+
+#ifdef CONFIG_SCHED_IRQMONITOR_STORM_THROTTLE
+  flags = enter_critical_section();
+
+  if (!info->throttled)
+    {
+      up_disable_irq(irq);
+      info->throttled = true;
+
+      if (!WDOG_ISACTIVE(&g_irq_stormdog))
+        {
+          wd_start(&g_irq_stormdog,
+                   MSEC2TICK(CONFIG_SCHED_IRQMONITOR_STORM_HOLDOFF),
+                   irq_storm_expiry, 0);
+        }
+    }
+
+  leave_critical_section(flags);
+#endif
+}
+
+#endif /* CONFIG_SCHED_IRQMONITOR_STORM */
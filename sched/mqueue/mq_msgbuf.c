@@ -0,0 +1,172 @@
+/****************************************************************************
+ * sched/mqueue/mq_msgbuf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/sched.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The payload buffer handed out is the 'mail' member of a message */
+
+#define nxmq_buffer2msg(b) container_of(b, struct mqueue_msg_s, mail[0])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_alloc_buffer
+ *
+ * Description:
+ *   Take a message from the message pool and return its payload buffer.
+ *   See include/nuttx/mqueue.h.
+ *
+ ****************************************************************************/
+
+FAR char *nxmq_alloc_buffer(void)
+{
+  FAR struct mqueue_msg_s *mqmsg = nxmq_alloc_msg();
+
+  return mqmsg != NULL ? mqmsg->mail : NULL;
+}
+
+/****************************************************************************
+ * Name: nxmq_free_buffer
+ *
+ * Description:
+ *   Return a payload buffer to the message pool.
+ *
+ ****************************************************************************/
+
+void nxmq_free_buffer(FAR char *buffer)
+{
+  DEBUGASSERT(buffer != NULL);
+  nxmq_free_msg(nxmq_buffer2msg(buffer));
+}
+
+/****************************************************************************
+ * Name: nxmq_send_buffer
+ *
+ * Description:
+ *   Queue a payload buffer by reference.  This follows nxmq_send() except
+ *   that the message was allocated by the caller up front, so there is
+ *   nothing to allocate or copy after the wait for space.
+ *
+ ****************************************************************************/
+
+int nxmq_send_buffer(mqd_t mqdes, FAR char *buffer, size_t msglen,
+                     unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_verify_send(mqdes, buffer, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sched_lock();
+  msgq  = mqdes->msgq;
+  flags = enter_critical_section();
+
+  /* Wait for space unless we are in an interrupt handler */
+
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(mqdes);
+    }
+
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      ret = nxmq_do_send(mqdes, nxmq_buffer2msg(buffer), buffer, msglen,
+                         prio);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_receive_buffer
+ *
+ * Description:
+ *   Dequeue a message by reference.  This follows nxmq_receive() except
+ *   that the message is handed to the caller instead of being copied out
+ *   and freed.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_buffer(mqd_t mqdes, FAR char **buffer,
+                            FAR unsigned int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (buffer == NULL || mqdes == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_RDOK) == 0)
+    {
+      return -EPERM;
+    }
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret   = nxmq_wait_receive(mqdes, &mqmsg);
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(mqmsg != NULL);
+      ret     = nxmq_do_receive(mqdes, mqmsg, NULL, prio);
+      *buffer = mqmsg->mail;
+    }
+
+  sched_unlock();
+  return ret;
+}
@@ -29,6 +29,7 @@
 #include <fcntl.h>
 #include <mqueue.h>
 #include <string.h>
+#include <strings.h>
 #include <errno.h>
 #include <sched.h>
 #include <debug.h>
@@ -42,6 +43,58 @@
 #include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_prio_prev
+ *
+ * Description:
+ *   Return the message that a new message of priority 'prio' must follow in
+ *   the message list:  the last message of the lowest priority that is
+ *   still greater than or equal to 'prio'.  NULL means that the new message
+ *   goes at the head of the list.
+ *
+ * Assumptions:
+ *   Executes within a critical section established by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+static FAR struct mqueue_msg_s *
+nxmq_prio_prev(FAR struct mqueue_inode_s *msgq, unsigned int prio)
+{
+  unsigned int word;
+  uint32_t map;
+
+  /* Messages of the same priority are kept in FIFO order */
+
+  if (msgq->priotail[prio] != NULL)
+    {
+      return (FAR struct mqueue_msg_s *)msgq->priotail[prio];
+    }
+
+  /* Otherwise find the nearest higher priority that has messages */
+
+  word = prio >> 5;
+  map  = msgq->priomap[word] & ~((2u << (prio & 31)) - 1);
+
+  while (map == 0)
+    {
+      if (++word >= MQ_PRIOMAP_WORDS)
+        {
+          return NULL;
+        }
+
+      map = msgq->priomap[word];
+    }
+
+  return (FAR struct mqueue_msg_s *)
+    msgq->priotail[(word << 5) + ffs((int)map) - 1];
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -311,7 +364,8 @@ int nxmq_wait_send(mqd_t mqdes)
  *
  * Input Parameters:
  *   mqdes  - Message queue descriptor
- *   msg    - Message to send
+ *   msg    - Message to send.  If this is mqmsg->mail, the message was
+ *            built in place and is not copied.
  *   msglen - The length of the message in bytes
  *   prio   - The priority of the message
  *
@@ -325,7 +379,9 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 {
   FAR struct tcb_s *btcb;
   FAR struct mqueue_inode_s *msgq;
+#ifndef CONFIG_MQ_PRIO_BUCKETS
   FAR struct mqueue_msg_s *next;
+#endif
   FAR struct mqueue_msg_s *prev;
   irqstate_t flags;
 
@@ -341,12 +397,20 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   /* Copy the message data into the message */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  /* Look up the location to insert the new message */
+
+  prev = nxmq_prio_prev(msgq, prio);
+#else
   /* Search the message list to find the location to insert the new
    * message. Each is list is maintained in ascending priority order.
    */
@@ -354,6 +418,7 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
        next && prio <= next->priority;
        prev = next, next = next->next);
+#endif
 
   /* Add the message at the right place */
 
@@ -367,6 +432,13 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
       sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
     }
 
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  /* The new message is now the last one of its priority */
+
+  msgq->priotail[prio] = (FAR sq_entry_t *)mqmsg;
+  MQ_PRIOMAP_SET(msgq, prio);
+#endif
+
   /* Increment the count of messages in the queue */
 
   msgq->nmsgs++;
@@ -208,7 +208,8 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
 
       /* Start the watchdog */
 
-      wd_start(&rtcb->waitdog, ticks, nxmq_rcvtimeout, getpid());
+      wd_start(&rtcb->waitdog, nxsched_slack_delay(rtcb, ticks),
+               nxmq_rcvtimeout, getpid());
     }
 
   /* Get the message from the message queue */
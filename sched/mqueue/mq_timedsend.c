@@ -243,7 +243,8 @@ int nxmq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen,
 
   /* Start the watchdog and begin the wait for MQ not full */
 
-  wd_start(&rtcb->waitdog, ticks, nxmq_sndtimeout, getpid());
+  wd_start(&rtcb->waitdog, nxsched_slack_delay(rtcb, ticks),
+           nxmq_sndtimeout, getpid());
 
   /* And wait for the message queue to be non-empty */
 
@@ -59,6 +59,14 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* Priority bucket bitmap helpers */
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+#  define MQ_PRIOMAP_WORDS     ((MQ_PRIO_MAX + 32) / 32)
+#  define MQ_PRIOMAP_SET(q,p)  ((q)->priomap[(p) >> 5] |= (1u << ((p) & 31)))
+#  define MQ_PRIOMAP_CLR(q,p)  ((q)->priomap[(p) >> 5] &= ~(1u << ((p) & 31)))
+#endif
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
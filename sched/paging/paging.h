@@ -43,6 +43,8 @@
 #include <nuttx/config.h>
 #include <queue.h>
 
+#include <nuttx/page.h>
+
 #ifdef CONFIG_PAGING
 
 /****************************************************************************
@@ -67,6 +69,11 @@
 #  define CONFIG_PAGING_STACKSIZE  CONFIG_IDLETHREAD_STACKSIZE
 #endif
 
+#if !defined(CONFIG_PAGING_PREFETCH) || !defined(CONFIG_PAGING_BLOCKINGFILL)
+#  undef CONFIG_PAGING_PREFETCH
+#  define CONFIG_PAGING_PREFETCH 0
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -92,6 +99,10 @@ extern pid_t g_pgworker;
 
 extern FAR struct tcb_s *g_pftcb;
 
+/* Paging statistics.  These are only modified with interrupts disabled. */
+
+extern struct pg_stats_s g_pgstats;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -136,6 +136,8 @@ void pg_miss(void)
   pginfo("Blocking TCB: %p PID: %d\n", ftcb, ftcb->pid);
   DEBUGASSERT(g_pgworker != ftcb->pid);
 
+  g_pgstats.faults++;
+
   /* Block the currently executing task
    * - Call up_block_task() to block the task at the head of the ready-
    *   to-run list.  This should cause an interrupt level context switch
@@ -0,0 +1,65 @@
+/****************************************************************************
+ * sched/paging/pg_statistics.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/page.h>
+
+#ifdef CONFIG_PAGING
+
+#include "paging/paging.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pg_statistics
+ *
+ * Description:
+ *   Return a snapshot of the paging statistics.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pg_statistics(FAR struct pg_stats_s *stats)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(stats != NULL);
+
+  flags = enter_critical_section();
+  *stats = g_pgstats;
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_PAGING */
@@ -83,10 +83,22 @@ pid_t g_pgworker;
 
 FAR struct tcb_s *g_pftcb;
 
+/* Paging statistics */
+
+struct pg_stats_s g_pgstats;
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#if CONFIG_PAGING_PREFETCH > 0
+/* The virtual address of the last page filled on demand.  Prefetching
+ * continues from here.  Zero means that there is nothing to prefetch.
+ */
+
+static uintptr_t g_pfaddr;
+#endif
+
 #ifndef CONFIG_PAGING_BLOCKINGFILL
 
 /* When a page fill completes, the result of the fill is stored here.  The
@@ -303,6 +315,7 @@ static inline bool pg_dequeue(void)
            * virtual address space -- just restart it.
            */
 
+          g_pgstats.redundant++;
           pginfo("Restarting TCB: %p\n", g_pftcb);
           up_unblock_task(g_pftcb);
         }
@@ -352,7 +365,7 @@ static inline bool pg_startfill(void)
    * dequeued.
    */
 
-  if (pg_dequeue())
+  while (pg_dequeue())
     {
       /* Call up_allocpage(tcb, &vpage). This architecture-specific function
        * will set aside page in memory and map to virtual address (vpage). If
@@ -362,7 +375,24 @@ static inline bool pg_startfill(void)
 
       pginfo("Call up_allocpage(%p)\n", g_pftcb);
       result = up_allocpage(g_pftcb, &vpage);
-      DEBUGASSERT(result == OK);
+      DEBUGASSERT(result >= 0);
+
+      if (result == PG_RESIDENT)
+        {
+          /* The page was still resident and has just been mapped again.
+           * No fill is needed, so restart the task and try the next one.
+           */
+
+          g_pgstats.reclaims++;
+          pginfo("Restarting TCB: %p\n", g_pftcb);
+          up_unblock_task(g_pftcb);
+          continue;
+        }
+
+      g_pgstats.fills++;
+#if CONFIG_PAGING_PREFETCH > 0
+      g_pfaddr = PG_FAULTADDR(g_pftcb);
+#endif
 
       /* Start the fill.  The exact way that the fill is started depends upon
        * the nature of the architecture-specific up_fillpage() function -- Is
@@ -426,6 +456,82 @@ static inline bool pg_startfill(void)
   return false;
 }
 
+/****************************************************************************
+ * Name: pg_prefetch
+ *
+ * Description:
+ *   Fill the pages that follow the last page filled on demand, unless they
+ *   are already mapped.  The fills are performed on behalf of the page fill
+ *   worker thread itself:  Its TCB holds the address to be filled.  Called
+ *   by the page fill worker thread after pg_alldone(), so this runs at the
+ *   default worker priority.  Prefetching stops as soon as a page fault is
+ *   queued.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with interrupts
+ *   disabled.  Only used with blocking fills.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PAGING_PREFETCH > 0
+static inline void pg_prefetch(void)
+{
+  FAR struct tcb_s *wtcb = this_task();
+  uintptr_t vaddr = PG_ALIGNDOWN(g_pfaddr);
+  FAR void *vpage;
+  int result;
+  int i;
+
+  if (g_pfaddr == 0)
+    {
+      return;
+    }
+
+  g_pfaddr = 0;
+
+  /* A fill is in progress on behalf of the worker thread while it
+   * prefetches, so pg_miss() will not signal it.
+   */
+
+  g_pftcb = wtcb;
+
+  for (i = 0; i < CONFIG_PAGING_PREFETCH; i++)
+    {
+      vaddr += PAGESIZE;
+      if (vaddr >= PG_PAGED_VEND || g_waitingforfill.head != NULL)
+        {
+          break;
+        }
+
+      PG_FAULTADDR(wtcb) = vaddr;
+      if (up_checkmapping(wtcb))
+        {
+          continue;
+        }
+
+      pginfo("Prefetch %08lx\n", (unsigned long)vaddr);
+      result = up_allocpage(wtcb, &vpage);
+      DEBUGASSERT(result >= 0);
+
+      if (result != PG_RESIDENT)
+        {
+          result = up_fillpage(wtcb, vpage);
+          DEBUGASSERT(result == OK);
+          g_pgstats.prefetches++;
+        }
+    }
+
+  g_pftcb = NULL;
+  UNUSED(result);
+}
+#endif
+
 /****************************************************************************
  * Name: pg_alldone
  *
@@ -547,7 +653,14 @@ int pg_worker(int argc, char *argv[])
        * supports timeouts for case of non-blocking, asynchronous fills.
        */
 
-      nxsig_usleep(CONFIG_PAGING_WORKPERIOD);
+#if CONFIG_PAGING_PREFETCH > 0
+      /* Don't sleep if a page fault was queued while prefetching */
+
+      if (g_waitingforfill.head == NULL)
+#endif
+        {
+          nxsig_usleep(CONFIG_PAGING_WORKPERIOD);
+        }
 
       /* The page fill worker thread will be awakened on one of 3 conditions:
        *
@@ -668,6 +781,12 @@ int pg_worker(int argc, char *argv[])
 
       pginfo("Call pg_alldone()\n");
       pg_alldone();
+
+#if CONFIG_PAGING_PREFETCH > 0
+      /* Use the idle fill time to prefetch the following pages */
+
+      pg_prefetch();
+#endif
 #endif
     }
 
@@ -44,8 +44,77 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
 #include "pthread/pthread.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cond_requeue
+ *
+ * Description:
+ *   Move all threads still waiting on the condition variable directly onto
+ *   the semaphore of the mutex that they will reacquire.  Instead of waking
+ *   every waiter only to have all but one of them block again on the mutex,
+ *   each is woken in turn as the mutex is released, already holding it.
+ *
+ *   This is only possible while the mutex is held by some thread, since
+ *   that thread is the one that will eventually hand the mutex over.
+ *   Requeued waiters do not boost the priority of the mutex holder, so
+ *   mutexes with priority inheritance are never requeued onto.
+ *
+ * Input Parameters:
+ *   cond - The condition variable
+ *
+ * Returned Value:
+ *   The number of waiters requeued onto the mutex.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static int pthread_cond_requeue(FAR pthread_cond_t *cond)
+{
+  FAR struct pthread_mutex_s *mutex = cond->mutex;
+  FAR struct tcb_s *stcb;
+  int nwaiters = 0;
+
+  if (mutex == NULL || mutex->sem.semcount > 0)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((mutex->sem.flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+    {
+      return 0;
+    }
+#endif
+
+  /* The list is prioritized, so requeued waiters keep their order */
+
+  for (stcb = (FAR struct tcb_s *)g_waitingforsemaphore.head;
+       stcb != NULL;
+       stcb = stcb->flink)
+    {
+      if (stcb->waitsem == (FAR sem_t *)&cond->sem)
+        {
+          stcb->waitsem = &mutex->sem;
+          stcb->flags  |= TCB_FLAG_COND_REQUEUED;
+          cond->sem.semcount++;
+          mutex->sem.semcount--;
+          nwaiters++;
+        }
+    }
+
+  return nwaiters;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,6 +125,10 @@
  * Description:
  *    A thread broadcast on a condition variable.
  *
+ *    The highest priority waiter is restarted to contend for the mutex.
+ *    When possible, the remaining waiters are requeued onto the mutex
+ *    rather than restarted all at once.
+ *
  * Input Parameters:
  *   None
  *
@@ -68,6 +141,7 @@
 
 int pthread_cond_broadcast(FAR pthread_cond_t *cond)
 {
+  irqstate_t flags;
   int ret = OK;
   int sval;
 
@@ -81,10 +155,12 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
     {
       /* Disable pre-emption until all of the waiting threads have been
        * restarted. This is necessary to assure that the sval behaves as
-       * expected in the following while loop
+       * expected in the following while loop.  Interrupts are disabled so
+       * that the waiting list is stable while waiters are requeued.
        */
 
       sched_lock();
+      flags = enter_critical_section();
 
       /* Get the current value of the semaphore */
 
@@ -92,9 +168,23 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
         {
           ret = EINVAL;
         }
-      else
+      else if (sval < 0)
         {
-          /* Loop until all of the waiting threads have been restarted. */
+          /* Restart the highest priority waiting thread */
+
+          ret = pthread_sem_give((FAR sem_t *)&cond->sem);
+          sval++;
+
+          /* Then requeue the others onto the mutex */
+
+          if (sval < 0)
+            {
+              sval += pthread_cond_requeue(cond);
+            }
+
+          /* Loop until all of the remaining waiting threads have been
+           * restarted.
+           */
 
           while (sval < 0)
             {
@@ -115,6 +205,7 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
 
       /* Now we can let the restarted threads run */
 
+      leave_critical_section(flags);
       sched_unlock();
     }
 
@@ -154,6 +154,7 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
                            FAR const struct timespec *abstime)
 {
   FAR struct tcb_s *rtcb = this_task();
+  bool requeued = false;
   irqstate_t flags;
   sclock_t ticks;
   int mypid = getpid();
@@ -243,6 +244,7 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
 #endif
               /* Give up the mutex */
 
+              cond->mutex = mutex;
               mutex->pid = -1;
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
               mflags     = mutex->flags;
@@ -264,7 +266,8 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
                 {
                   /* Start the watchdog */
 
-                  wd_start(&rtcb->waitdog, ticks,
+                  wd_start(&rtcb->waitdog,
+                           nxsched_slack_delay(rtcb, ticks),
                            pthread_condtimedout, mypid);
 
                   /* Take the condition semaphore.  Do not restore
@@ -275,9 +278,20 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
 
                   status = nxsem_wait((FAR sem_t *)&cond->sem);
 
+                  /* If pthread_cond_broadcast() requeued this thread onto
+                   * the mutex, then the condition was signaled and the
+                   * mutex is held unless that wait timed out.
+                   */
+
+                  if ((rtcb->flags & TCB_FLAG_COND_REQUEUED) != 0)
+                    {
+                      rtcb->flags &= ~TCB_FLAG_COND_REQUEUED;
+                      requeued     = (status == OK);
+                    }
+
                   /* Did we get the condition semaphore. */
 
-                  if (status < 0)
+                  else if (status < 0)
                     {
                       /* NO.. Handle the special case where the semaphore
                        * wait was awakened by the receipt of a signal --
@@ -309,7 +323,15 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
 
               sinfo("Re-locking...\n");
 
-              status = pthread_mutex_take(mutex, NULL, false);
+              if (requeued)
+                {
+                  status = pthread_mutex_requeued(mutex);
+                }
+              else
+                {
+                  status = pthread_mutex_take(mutex, NULL, false);
+                }
+
               if (status == OK)
                 {
                   mutex->pid    = mypid;
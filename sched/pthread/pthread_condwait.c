@@ -32,6 +32,7 @@
 
 #include <nuttx/cancelpt.h>
 
+#include "sched/sched.h"
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -56,6 +57,8 @@
 
 int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 {
+  FAR struct tcb_s *rtcb = this_task();
+  bool requeued = false;
   int status;
   int ret;
 
@@ -93,6 +96,7 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
       sinfo("Give up mutex / take cond\n");
 
       sched_lock();
+      cond->mutex = mutex;
       mutex->pid = -1;
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
       mflags     = mutex->flags;
@@ -104,10 +108,32 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
       ret        = pthread_mutex_give(mutex);
 
       /* Take the semaphore.  This may be awakened only be a signal (EINTR)
-       * or if the thread is canceled (ECANCELED)
+       * or if the thread is canceled (ECANCELED).  A signal is ignored
+       * unless pthread_cond_broadcast() has already requeued this thread
+       * onto the mutex.
        */
 
-      status = pthread_sem_take((FAR sem_t *)&cond->sem, NULL, false);
+      do
+        {
+          status = -nxsem_wait((FAR sem_t *)&cond->sem);
+        }
+      while (status == EINTR &&
+             (rtcb->flags & TCB_FLAG_COND_REQUEUED) == 0);
+
+      /* If this thread was requeued, then the mutex is already held unless
+       * the wait on the mutex was interrupted.
+       */
+
+      if ((rtcb->flags & TCB_FLAG_COND_REQUEUED) != 0)
+        {
+          rtcb->flags &= ~TCB_FLAG_COND_REQUEUED;
+          requeued     = (status == OK);
+          if (status == EINTR)
+            {
+              status   = OK;
+            }
+        }
+
       if (ret == OK)
         {
           /* Report the first failure that occurs */
@@ -126,7 +152,15 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 
       sinfo("Reacquire mutex...\n");
 
-      status = pthread_mutex_take(mutex, NULL, false);
+      if (requeued)
+        {
+          status = pthread_mutex_requeued(mutex);
+        }
+      else
+        {
+          status = pthread_mutex_take(mutex, NULL, false);
+        }
+
       if (ret == OK)
         {
           /* Report the first failure that occurs */
@@ -245,7 +245,7 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
   /* Allocate a TCB for the new task. */
 
   ptcb = (FAR struct pthread_tcb_s *)
-            kmm_zalloc(sizeof(struct pthread_tcb_s));
+            nxsched_alloc_tcb(sizeof(struct pthread_tcb_s));
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -476,6 +476,16 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        /* A deadline reservation is not inherited; the new thread runs
+         * SCHED_FIFO at the priority of its creator.
+         */
+
+        ptcb->cmn.flags    |= TCB_FLAG_SCHED_FIFO;
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         ptcb->cmn.flags    |= TCB_FLAG_SCHED_OTHER;
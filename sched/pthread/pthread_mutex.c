@@ -253,6 +253,49 @@ int pthread_mutex_trytake(FAR struct pthread_mutex_s *mutex)
   return ret;
 }
 
+/****************************************************************************
+ * Name: pthread_mutex_requeued
+ *
+ * Description:
+ *   Complete the locking of a mutex whose underlying semaphore was handed
+ *   to this thread while it was requeued from a condition variable onto
+ *   the mutex by pthread_cond_broadcast().  The semaphore is already held;
+ *   only the mutex bookkeeping remains.
+ *
+ * Input Parameters:
+ *  mutex - The mutex that was locked
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_requeued(FAR struct pthread_mutex_s *mutex)
+{
+  int ret = OK;
+
+  DEBUGASSERT(mutex != NULL);
+
+  sched_lock();
+
+  /* Check if the holder of the mutex has terminated without releasing */
+
+  if ((mutex->flags & _PTHREAD_MFLAGS_INCONSISTENT) != 0)
+    {
+      ret = EOWNERDEAD;
+    }
+
+  /* Add the mutex to the list of mutexes held by this task */
+
+  else
+    {
+      pthread_mutex_add(mutex);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
 /****************************************************************************
  * Name: pthread_mutex_give
  *
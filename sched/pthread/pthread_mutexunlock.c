@@ -86,9 +86,13 @@ static inline bool pthread_mutex_islocked(FAR struct pthread_mutex_s *mutex)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: pthread_mutex_unlock
+ * Name: nx_pthread_mutex_unlock
  *
  * Description:
+ *   This is the OS part of pthread_mutex_unlock().  The C library
+ *   pthread_mutex_unlock() function calls this unless it can release an
+ *   uncontended mutex itself.
+ *
  *   The pthread_mutex_unlock() function releases the mutex object referenced
  *   by mutex. The manner in which a mutex is released is dependent upon the
  *   mutex's type attribute. If there are threads blocked on the mutex object
@@ -104,16 +108,16 @@ static inline bool pthread_mutex_islocked(FAR struct pthread_mutex_s *mutex)
  *   it was not interrupted.
  *
  * Input Parameters:
- *   None
+ *   mutex - A reference to the mutex to be unlocked.
  *
  * Returned Value:
- *   None
+ *   0 on success or an errno value on failure.
  *
  * Assumptions:
  *
  ****************************************************************************/
 
-int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+int nx_pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 {
   int ret = EPERM;
 
@@ -76,6 +76,26 @@
 #define running_task() \
   (up_interrupt_context() ? g_running_tasks[this_cpu()] : this_task())
 
+/* Order of TCBs in the prioritized lists:  higher priority first and, among
+ * equal priorities, deadline threads by earliest absolute deadline.  All
+ * others keep FIFO order.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define nxsched_deadline_before(t1,t2) \
+     ((t1)->deadline != NULL && \
+      ((t2)->deadline == NULL || \
+       (sclock_t)((t1)->deadline->absdeadline - \
+                  (t2)->deadline->absdeadline) < 0))
+#else
+#  define nxsched_deadline_before(t1,t2) (false)
+#endif
+
+#define nxsched_precedes(t1,t2) \
+  ((t1)->sched_priority > (t2)->sched_priority || \
+   ((t1)->sched_priority == (t2)->sched_priority && \
+    nxsched_deadline_before(t1,t2)))
+
 /* List attribute flags */
 
 #define TLIST_ATTR_PRIORITIZED   (1 << 0) /* Bit 0: List is prioritized */
@@ -278,6 +298,18 @@ extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
 extern volatile uint32_t g_cpuload_total;
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* The entry time of the interrupt being handled by each CPU (zero if none).
+ * Declared in sched_critmonitor.c.
+ */
+
+#ifdef CONFIG_SMP_NCPUS
+extern uint32_t g_critmon_irqstart[CONFIG_SMP_NCPUS];
+#else
+extern uint32_t g_critmon_irqstart[1];
+#endif
+#endif
+
 /* Declared in sched_lock.c *************************************************/
 
 /* Pre-emption is disabled via the interface sched_lock(). sched_lock()
@@ -362,6 +394,24 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
 void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                                uint8_t task_state);
 bool nxsched_merge_pending(void);
+
+/* Insertion into and removal from g_readytorun (non-SMP) */
+
+#ifdef CONFIG_SCHED_READYINDEX
+bool nxsched_add_indexed(FAR struct tcb_s *tcb);
+void nxsched_remove_indexed(FAR struct tcb_s *tcb);
+void nxsched_setpriority_indexed(FAR struct tcb_s *tcb, uint8_t priority);
+void nxsched_rebuild_index(void);
+#else
+#  define nxsched_add_indexed(t) \
+     nxsched_add_prioritized(t, (FAR dq_queue_t *)&g_readytorun)
+#  define nxsched_remove_indexed(t) \
+     dq_rem((FAR dq_entry_t *)(t), (FAR dq_queue_t *)&g_readytorun)
+#  define nxsched_setpriority_indexed(t,p) \
+     do { (t)->sched_priority = (p); } while (0)
+#  define nxsched_rebuild_index()
+#endif
+
 void nxsched_add_blocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
@@ -387,6 +437,15 @@ void nxsched_reassess_timer(void);
 #  define nxsched_reassess_timer()
 #endif
 
+/* Timer slack of timed waits */
+
+#ifdef CONFIG_SCHED_TICKLESS_SLACK
+#  define TIMER_SLACK_DEFAULT USEC2TICK(CONFIG_SCHED_TICKLESS_SLACK_DEFAULT)
+int32_t nxsched_slack_delay(FAR struct tcb_s *tcb, int32_t delay);
+#else
+#  define nxsched_slack_delay(tcb,delay) (delay)
+#endif
+
 /* Scheduler policy support */
 
 #if CONFIG_RR_INTERVAL > 0
@@ -406,6 +465,14 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_set_deadline(FAR struct tcb_s *tcb,
+                          FAR const struct sched_param *param);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 void nxsched_continue(FAR struct tcb_s *tcb);
@@ -415,6 +482,13 @@ void nxsched_continue(FAR struct tcb_s *tcb);
 FAR struct tcb_s *this_task(void);
 
 int  nxsched_select_cpu(cpu_set_t affinity);
+#ifdef CONFIG_SCHED_SOFT_AFFINITY
+int  nxsched_select_cpu_prefer(cpu_set_t affinity, int prefer);
+#  define nxsched_select_tcbcpu(t) \
+     nxsched_select_cpu_prefer((t)->affinity, (t)->cpu)
+#else
+#  define nxsched_select_tcbcpu(t) nxsched_select_cpu((t)->affinity)
+#endif
 int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 
 irqstate_t nxsched_lock_tasklist(void);
@@ -423,6 +497,19 @@ void nxsched_unlock_tasklist(irqstate_t lock);
 #  define nxsched_islocked_global() spin_islocked(&g_cpu_schedlock)
 #  define nxsched_islocked_tcb(tcb) nxsched_islocked_global()
 
+/* Assign a task to a CPU, counting the moves to a different CPU */
+
+#  define nxsched_set_cpu(tcb,c) \
+     do \
+       { \
+         if ((tcb)->cpu != (c)) \
+           { \
+             (tcb)->nmigrations++; \
+           } \
+         (tcb)->cpu = (c); \
+       } \
+     while (0)
+
 #else
 #  define nxsched_select_cpu(a)     (0)
 #  define nxsched_pause_cpu(t)      (-38)  /* -ENOSYS */
@@ -440,10 +527,26 @@ void weak_function nxsched_process_cpuload(void);
 #ifdef CONFIG_SCHED_CRITMONITOR
 void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state);
 void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state);
+void nxsched_critmon_wakeup(FAR struct tcb_s *tcb);
 void nxsched_resume_critmon(FAR struct tcb_s *tcb);
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 #endif
 
+/* CPU time accounting */
+
+#ifdef CONFIG_SCHED_CPUTIME
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb);
+void nxsched_resume_cputime(FAR struct tcb_s *tcb);
+void nxsched_process_cputime(void);
+#endif
+
+/* Stack usage monitor */
+
+#ifdef CONFIG_STACK_MONITOR
+void nxsched_stackmon_start(void);
+void nxsched_stackmon_exit(FAR struct tcb_s *tcb);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
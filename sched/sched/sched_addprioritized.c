@@ -88,11 +88,12 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
   /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+   * Each is list is maintained in descending sched_priority order (and
+   * by deadline among deadline threads of equal priority).
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && !nxsched_precedes(tcb, next));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
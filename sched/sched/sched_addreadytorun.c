@@ -80,18 +80,24 @@
  ****************************************************************************/
 
 #ifndef CONFIG_SMP
-bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
+bool locate_fast nxsched_add_readytorun(FAR struct tcb_s *btcb)
 {
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Remember if an interrupt handler woke up the task */
+
+  nxsched_critmon_wakeup(btcb);
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 && nxsched_precedes(btcb, rtcb))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -104,7 +110,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
-  else if (nxsched_add_prioritized(btcb, (FAR dq_queue_t *)&g_readytorun))
+  else if (nxsched_add_indexed(btcb))
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -164,7 +170,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
  ****************************************************************************/
 
 #ifdef CONFIG_SMP
-bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
+bool locate_fast nxsched_add_readytorun(FAR struct tcb_s *btcb)
 {
   FAR struct tcb_s *rtcb;
   FAR dq_queue_t *tasklist;
@@ -178,6 +184,12 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   irqstate_t lock = nxsched_lock_tasklist();
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Remember if an interrupt handler woke up the task */
+
+  nxsched_critmon_wakeup(btcb);
+#endif
+
   /* Check if the blocked TCB is locked to this CPU */
 
   if ((btcb->flags & TCB_FLAG_CPU_LOCKED) != 0)
@@ -192,7 +204,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * (possibly its IDLE task).
        */
 
-      cpu = nxsched_select_cpu(btcb->affinity);
+      cpu = nxsched_select_tcbcpu(btcb);
     }
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -305,7 +317,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
           DEBUGASSERT(task_state == TSTATE_TASK_RUNNING);
 
-          btcb->cpu        = cpu;
+          nxsched_set_cpu(btcb, cpu);
           btcb->task_state = TSTATE_TASK_RUNNING;
 
           /* Adjust global pre-emption controls.  If the lockcount is
@@ -420,7 +432,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
           DEBUGASSERT(task_state == TSTATE_TASK_ASSIGNED);
 
-          btcb->cpu        = cpu;
+          nxsched_set_cpu(btcb, cpu);
           btcb->task_state = TSTATE_TASK_ASSIGNED;
         }
 
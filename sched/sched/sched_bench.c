@@ -0,0 +1,571 @@
+/****************************************************************************
+ * sched/sched/sched_bench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/sched_bench.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NSAMPLES  CONFIG_SCHED_BENCHMARK_ITERATIONS
+#define BENCH_PRIORITY  CONFIG_SCHED_BENCHMARK_PRIORITY
+#define BENCH_STACKSIZE CONFIG_SCHED_BENCHMARK_STACKSIZE
+
+#if BENCH_PRIORITY >= SCHED_PRIORITY_MAX
+#  error CONFIG_SCHED_BENCHMARK_PRIORITY must be below SCHED_PRIORITY_MAX
+#endif
+
+#if defined(CONFIG_SCHED_HPWORK)
+#  define BENCH_WORKQUEUE HPWORK
+#elif defined(CONFIG_SCHED_LPWORK)
+#  define BENCH_WORKQUEUE LPWORK
+#endif
+
+#define BENCH_MQREQUEST  "schedbench.req"
+#define BENCH_MQRESPONSE "schedbench.rsp"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one run of the benchmarks.  Runs are serialized by
+ * g_bench_lock, so a single instance is enough.
+ */
+
+struct sched_bench_state_s
+{
+  FAR struct sched_bench_s *results;  /* Where the samples are accounted */
+  volatile uint32_t stamp;            /* Time the measured event started */
+  sem_t    sem;                       /* Measured wake-ups */
+  sem_t    done;                      /* A helper has finished */
+  sem_t    complete;                  /* All measurements have finished */
+#ifdef CONFIG_SMP
+  int      cpu;                       /* The CPU that all threads run on */
+#endif
+#ifdef BENCH_WORKQUEUE
+  struct work_s work;                 /* For SCHED_BENCH_WORK */
+#endif
+  struct wdog_s wdog;                 /* For SCHED_BENCH_IRQWAKE */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_bench_names[SCHED_BENCH_NTESTS] =
+{
+  "switch",
+  "semwake",
+  "mq",
+  "work",
+  "irqwake"
+};
+
+static sem_t g_bench_lock = SEM_INITIALIZER(1);
+static struct sched_bench_state_s g_bench;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_sample
+ *
+ * Description:
+ *   Account for one sample of a measurement.
+ *
+ ****************************************************************************/
+
+static void bench_sample(int test, uint32_t elapsed)
+{
+  FAR struct sched_bench_s *result = &g_bench.results[test];
+
+  if (result->sb_count == 0 || elapsed < result->sb_min)
+    {
+      result->sb_min = elapsed;
+    }
+
+  if (elapsed > result->sb_max)
+    {
+      result->sb_max = elapsed;
+    }
+
+  result->sb_count++;
+  result->sb_total += elapsed;
+}
+
+/****************************************************************************
+ * Name: bench_start
+ *
+ * Description:
+ *   Start a helper thread.  In SMP configurations the helper is bound to
+ *   the CPU of the caller before it can run anywhere else.
+ *
+ ****************************************************************************/
+
+static int bench_start(FAR const char *name, int priority, main_t entry)
+{
+  int pid;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+
+  sched_lock();
+
+  pid = kthread_create(name, priority, BENCH_STACKSIZE, entry, NULL);
+#ifdef CONFIG_SMP
+  if (pid > 0)
+    {
+      CPU_ZERO(&cpuset);
+      CPU_SET(g_bench.cpu, &cpuset);
+      nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+    }
+#endif
+
+  sched_unlock();
+  return pid;
+}
+
+/****************************************************************************
+ * Name: bench_switch_*
+ *
+ * Description:
+ *   Two threads of the same priority take turns with sched_yield().  Each
+ *   one measures the time from the other one giving up the CPU until it
+ *   runs itself.
+ *
+ ****************************************************************************/
+
+static int bench_switch_helper(int argc, FAR char *argv[])
+{
+  int i;
+
+  /* The first time this runs is the start of the thread, not the return
+   * from sched_yield(), so it is not a sample.
+   */
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      if (i > 0)
+        {
+          bench_sample(SCHED_BENCH_SWITCH,
+                       up_critmon_gettime() - g_bench.stamp);
+        }
+
+      g_bench.stamp = up_critmon_gettime();
+      sched_yield();
+    }
+
+  nxsem_post(&g_bench.done);
+  return OK;
+}
+
+static int bench_switch(void)
+{
+  int ret;
+  int i;
+
+  ret = bench_start("bench_switch", BENCH_PRIORITY, bench_switch_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      g_bench.stamp = up_critmon_gettime();
+      sched_yield();
+      bench_sample(SCHED_BENCH_SWITCH,
+                   up_critmon_gettime() - g_bench.stamp);
+    }
+
+  return nxsem_wait_uninterruptible(&g_bench.done);
+}
+
+/****************************************************************************
+ * Name: bench_semwake_*
+ *
+ * Description:
+ *   Measure the time from nxsem_post() until a higher priority waiter
+ *   runs.
+ *
+ ****************************************************************************/
+
+static int bench_semwake_helper(int argc, FAR char *argv[])
+{
+  int i;
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      nxsem_wait_uninterruptible(&g_bench.sem);
+      bench_sample(SCHED_BENCH_SEMWAKE,
+                   up_critmon_gettime() - g_bench.stamp);
+    }
+
+  nxsem_post(&g_bench.done);
+  return OK;
+}
+
+static int bench_semwake(void)
+{
+  int ret;
+  int i;
+
+  ret = bench_start("bench_semwake", BENCH_PRIORITY + 1,
+                    bench_semwake_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      g_bench.stamp = up_critmon_gettime();
+      nxsem_post(&g_bench.sem);
+    }
+
+  return nxsem_wait_uninterruptible(&g_bench.done);
+}
+
+/****************************************************************************
+ * Name: bench_mq_*
+ *
+ * Description:
+ *   Measure the round trip of a message sent to a higher priority thread
+ *   that answers with a message of its own.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static int bench_mq_helper(int argc, FAR char *argv[])
+{
+  mqd_t request;
+  mqd_t response;
+  uint32_t msg;
+  int ret;
+  int i;
+
+  ret = nxmq_open(BENCH_MQREQUEST, O_RDONLY, 0, NULL, &request);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = nxmq_open(BENCH_MQRESPONSE, O_WRONLY, 0, NULL, &response);
+  if (ret < 0)
+    {
+      nxmq_close(request);
+      goto errout;
+    }
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      ret = nxmq_receive(request, (FAR char *)&msg, sizeof(msg), NULL);
+      if (ret >= 0)
+        {
+          ret = nxmq_send(response, (FAR const char *)&msg, sizeof(msg), 0);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxmq_close(response);
+  nxmq_close(request);
+
+errout:
+  g_bench.results[SCHED_BENCH_MQ].sb_result = ret < 0 ? ret : OK;
+  nxsem_post(&g_bench.done);
+  return OK;
+}
+
+static int bench_mq(void)
+{
+  struct mq_attr attr;
+  mqd_t request;
+  mqd_t response;
+  uint32_t msg;
+  int ret;
+  int i;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = sizeof(msg);
+
+  ret = nxmq_open(BENCH_MQREQUEST, O_WRONLY | O_CREAT, 0600, &attr,
+                  &request);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxmq_open(BENCH_MQRESPONSE, O_RDONLY | O_CREAT, 0600, &attr,
+                  &response);
+  if (ret < 0)
+    {
+      goto errout_with_request;
+    }
+
+  ret = bench_start("bench_mq", BENCH_PRIORITY + 1, bench_mq_helper);
+  if (ret < 0)
+    {
+      goto errout_with_response;
+    }
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      uint32_t start = up_critmon_gettime();
+
+      msg = i;
+      if (nxmq_send(request, (FAR const char *)&msg, sizeof(msg), 0) < 0 ||
+          nxmq_receive(response, (FAR char *)&msg, sizeof(msg), NULL) < 0)
+        {
+          break;
+        }
+
+      bench_sample(SCHED_BENCH_MQ, up_critmon_gettime() - start);
+    }
+
+  /* If the loop ended early, the helper is blocked on an empty queue.
+   * Closing and unlinking does not wake it, so it is left behind rather
+   * than waited for.
+   */
+
+  if (i == BENCH_NSAMPLES)
+    {
+      nxsem_wait_uninterruptible(&g_bench.done);
+      ret = g_bench.results[SCHED_BENCH_MQ].sb_result;
+    }
+  else
+    {
+      ret = -EIO;
+    }
+
+errout_with_response:
+  nxmq_close(response);
+  nxmq_unlink(BENCH_MQRESPONSE);
+
+errout_with_request:
+  nxmq_close(request);
+  nxmq_unlink(BENCH_MQREQUEST);
+  return ret;
+}
+#endif /* CONFIG_DISABLE_MQUEUE */
+
+/****************************************************************************
+ * Name: bench_work_*
+ *
+ * Description:
+ *   Measure the time from work_queue() until the worker runs.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_WORKQUEUE
+static void bench_work_worker(FAR void *arg)
+{
+  bench_sample(SCHED_BENCH_WORK, up_critmon_gettime() - g_bench.stamp);
+  nxsem_post(&g_bench.sem);
+}
+
+static int bench_work(void)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      g_bench.stamp = up_critmon_gettime();
+      ret = work_queue(BENCH_WORKQUEUE, &g_bench.work, bench_work_worker,
+                       NULL, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxsem_wait_uninterruptible(&g_bench.sem);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_irqwake_*
+ *
+ * Description:
+ *   Measure the time from a timer interrupt posting a semaphore until the
+ *   waiting thread runs.
+ *
+ ****************************************************************************/
+
+static void bench_irqwake_expiry(wdparm_t arg)
+{
+  g_bench.stamp = up_critmon_gettime();
+  nxsem_post(&g_bench.sem);
+}
+
+static int bench_irqwake(void)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < BENCH_NSAMPLES; i++)
+    {
+      ret = wd_start(&g_bench.wdog, 1, bench_irqwake_expiry, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxsem_wait_uninterruptible(&g_bench.sem);
+      bench_sample(SCHED_BENCH_IRQWAKE,
+                   up_critmon_gettime() - g_bench.stamp);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_thread
+ *
+ * Description:
+ *   Run all of the measurements at CONFIG_SCHED_BENCHMARK_PRIORITY.
+ *
+ ****************************************************************************/
+
+static int bench_thread(int argc, FAR char *argv[])
+{
+  FAR struct sched_bench_s *results = g_bench.results;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+
+  /* Stay on one CPU so that each sample includes a context switch */
+
+  g_bench.cpu = this_cpu();
+  CPU_ZERO(&cpuset);
+  CPU_SET(g_bench.cpu, &cpuset);
+  nxsched_set_affinity(0, sizeof(cpu_set_t), &cpuset);
+#endif
+
+  results[SCHED_BENCH_SWITCH].sb_result  = bench_switch();
+  results[SCHED_BENCH_SEMWAKE].sb_result = bench_semwake();
+#ifndef CONFIG_DISABLE_MQUEUE
+  results[SCHED_BENCH_MQ].sb_result      = bench_mq();
+#else
+  results[SCHED_BENCH_MQ].sb_result      = -ENOSYS;
+#endif
+#ifdef BENCH_WORKQUEUE
+  results[SCHED_BENCH_WORK].sb_result    = bench_work();
+#else
+  results[SCHED_BENCH_WORK].sb_result    = -ENOSYS;
+#endif
+  results[SCHED_BENCH_IRQWAKE].sb_result = bench_irqwake();
+
+  nxsem_post(&g_bench.complete);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_bench_run
+ *
+ * Description:
+ *   Run each measurement CONFIG_SCHED_BENCHMARK_ITERATIONS times.  See
+ *   include/nuttx/sched_bench.h.
+ *
+ ****************************************************************************/
+
+int sched_bench_run(FAR struct sched_bench_s *results)
+{
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&g_bench_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(results, 0, SCHED_BENCH_NTESTS * sizeof(struct sched_bench_s));
+  for (i = 0; i < SCHED_BENCH_NTESTS; i++)
+    {
+      results[i].sb_name = g_bench_names[i];
+    }
+
+  memset(&g_bench, 0, sizeof(g_bench));
+  g_bench.results = results;
+
+  /* These semaphores are used for signaling */
+
+  nxsem_init(&g_bench.sem, 0, 0);
+  nxsem_set_protocol(&g_bench.sem, SEM_PRIO_NONE);
+  nxsem_init(&g_bench.done, 0, 0);
+  nxsem_set_protocol(&g_bench.done, SEM_PRIO_NONE);
+  nxsem_init(&g_bench.complete, 0, 0);
+  nxsem_set_protocol(&g_bench.complete, SEM_PRIO_NONE);
+
+  ret = kthread_create("bench", BENCH_PRIORITY, BENCH_STACKSIZE,
+                       bench_thread, NULL);
+  if (ret > 0)
+    {
+      ret = nxsem_wait_uninterruptible(&g_bench.complete);
+    }
+
+  wd_cancel(&g_bench.wdog);
+  nxsem_destroy(&g_bench.sem);
+  nxsem_destroy(&g_bench.done);
+  nxsem_destroy(&g_bench.complete);
+
+  nxsem_post(&g_bench_lock);
+  return ret < 0 ? ret : OK;
+}
+
+#endif /* CONFIG_SCHED_BENCHMARK */
@@ -124,4 +124,51 @@ int nxsched_select_cpu(cpu_set_t affinity)
   return cpu;
 }
 
+/****************************************************************************
+ * Name:  nxsched_select_cpu_prefer
+ *
+ * Description:
+ *   Like nxsched_select_cpu(), but if the 'prefer' CPU (normally the CPU
+ *   that the task last ran on) is among the CPUs with the lowest priority
+ *   running task, return it rather than the first such CPU.
+ *
+ * Input Parameters:
+ *   affinity - The set of CPUs on which the thread is permitted to run.
+ *   prefer   - The preferred CPU
+ *
+ * Returned Value:
+ *   Index of the selected CPU
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SOFT_AFFINITY
+int nxsched_select_cpu_prefer(cpu_set_t affinity, int prefer)
+{
+  FAR struct tcb_s *rtcb;
+  int cpu;
+
+  cpu = nxsched_select_cpu(affinity);
+  if (cpu != prefer && prefer < CONFIG_SMP_NCPUS &&
+      (affinity & (1 << prefer)) != 0)
+    {
+      /* Use the preferred CPU if its running task has the same priority as
+       * the best candidate.  That includes the case where both are
+       * running their IDLE tasks.
+       */
+
+      rtcb = (FAR struct tcb_s *)g_assignedtasks[prefer].head;
+      if (rtcb->sched_priority ==
+          ((FAR struct tcb_s *)g_assignedtasks[cpu].head)->sched_priority)
+        {
+          cpu = prefer;
+        }
+    }
+
+  return cpu;
+}
+#endif
+
 #endif /* CONFIG_SMP */
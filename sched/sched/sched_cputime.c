@@ -0,0 +1,289 @@
+/****************************************************************************
+ * sched/sched/sched_cputime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUTIME
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cputime_group_s
+{
+  FAR struct task_group_s *group;   /* The group being summed */
+  uint32_t now;                     /* The current time */
+  uint64_t total;                   /* Accumulated time in nanoseconds */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_cputime_nsec
+ *
+ * Description:
+ *   Convert an elapsed time in up_critmon_gettime() units to nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t nxsched_cputime_nsec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  if (elapsed == 0)
+    {
+      return 0;
+    }
+
+  up_critmon_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: nxsched_cputime_thread
+ *
+ * Description:
+ *   Return the execution time of a thread in nanoseconds, including the
+ *   current slice if the thread is running.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static uint64_t nxsched_cputime_thread(FAR struct tcb_s *tcb, uint32_t now)
+{
+  uint64_t total = tcb->run_time;
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING && tcb->run_start != 0)
+    {
+      total += nxsched_cputime_nsec(now - tcb->run_start);
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: nxsched_cputime_member
+ *
+ * Description:
+ *   nxsched_foreach() callback that adds the time of the threads in one
+ *   task group.
+ *
+ ****************************************************************************/
+
+static void nxsched_cputime_member(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct cputime_group_s *info = (FAR struct cputime_group_s *)arg;
+
+  if (tcb->group == info->group)
+    {
+      info->total += nxsched_cputime_thread(tcb, info->now);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_cputime_timespec
+ ****************************************************************************/
+
+static void nxsched_cputime_timespec(uint64_t nsec,
+                                     FAR struct timespec *cputime)
+{
+  cputime->tv_sec  = (time_t)(nsec / NSEC_PER_SEC);
+  cputime->tv_nsec = (long)(nsec % NSEC_PER_SEC);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_suspend_cputime
+ *
+ * Description:
+ *   Called when a thread suspends execution.  Add the slice that just
+ *   ended to the execution time of the thread.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb)
+{
+  if (tcb->run_start != 0)
+    {
+      tcb->run_time  += nxsched_cputime_nsec(up_critmon_gettime() -
+                                             tcb->run_start);
+      tcb->run_start  = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_cputime
+ *
+ * Description:
+ *   Called when a thread resumes execution.  Start timing a new slice.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_resume_cputime(FAR struct tcb_s *tcb)
+{
+  tcb->run_start = up_critmon_gettime();
+}
+
+/****************************************************************************
+ * Name: nxsched_process_cputime
+ *
+ * Description:
+ *   Called from the timer interrupt handler.  Fold the current slice of
+ *   the running thread into its execution time so that the 32-bit time
+ *   difference never wraps, even if a thread runs for a long time without
+ *   being suspended.
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_process_cputime(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  uint32_t now;
+
+  if (rtcb->run_start != 0)
+    {
+      now             = up_critmon_gettime();
+      rtcb->run_time += nxsched_cputime_nsec(now - rtcb->run_start);
+      rtcb->run_start = now;
+    }
+}
+
+/****************************************************************************
+ * Name:  clock_cputime
+ *
+ * Description:
+ *   Return the accumulated execution time of a thread.
+ *
+ * Input Parameters:
+ *   pid     - The ID of the thread of interest.  pid == 0 is the IDLE
+ *             thread.
+ *   cputime - The location to return the execution time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+int clock_cputime(int pid, FAR struct timespec *cputime)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t total;
+
+  DEBUGASSERT(cputime != NULL);
+
+  flags = enter_critical_section();
+
+  tcb = nxsched_get_tcb(pid);
+  if (tcb == NULL)
+    {
+      leave_critical_section(flags);
+      return -ESRCH;
+    }
+
+  total = nxsched_cputime_thread(tcb, up_critmon_gettime());
+  leave_critical_section(flags);
+
+  nxsched_cputime_timespec(total, cputime);
+  return OK;
+}
+
+/****************************************************************************
+ * Name:  clock_processtime
+ *
+ * Description:
+ *   Return the accumulated execution time of all threads in the task group
+ *   of a thread, including the threads that have already exited.
+ *
+ * Input Parameters:
+ *   pid     - The ID of any thread in the task group of interest
+ *   cputime - The location to return the execution time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+int clock_processtime(int pid, FAR struct timespec *cputime)
+{
+  struct cputime_group_s info;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  DEBUGASSERT(cputime != NULL);
+
+  flags = enter_critical_section();
+
+  tcb = nxsched_get_tcb(pid);
+  if (tcb == NULL || tcb->group == NULL)
+    {
+      leave_critical_section(flags);
+      return -ESRCH;
+    }
+
+  info.group = tcb->group;
+  info.now   = up_critmon_gettime();
+  info.total = tcb->group->tg_cputime;
+
+  nxsched_foreach(nxsched_cputime_member, &info);
+  leave_critical_section(flags);
+
+  nxsched_cputime_timespec(info.total, cputime);
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_CPUTIME */
@@ -74,6 +74,97 @@ uint32_t g_premp_max[1];
 uint32_t g_crit_max[1];
 #endif
 
+/* Histograms of the same times and of the interrupt wake-up latency */
+
+#ifdef CONFIG_SMP_NCPUS
+uint32_t g_premp_hist[CONFIG_SMP_NCPUS][CRITMON_NBUCKETS];
+uint32_t g_crit_hist[CONFIG_SMP_NCPUS][CRITMON_NBUCKETS];
+uint32_t g_wakeup_hist[CONFIG_SMP_NCPUS][CRITMON_NBUCKETS];
+#else
+uint32_t g_premp_hist[1][CRITMON_NBUCKETS];
+uint32_t g_crit_hist[1][CRITMON_NBUCKETS];
+uint32_t g_wakeup_hist[1][CRITMON_NBUCKETS];
+#endif
+
+/* Entry time of the interrupt being handled by each CPU */
+
+#ifdef CONFIG_SMP_NCPUS
+uint32_t g_critmon_irqstart[CONFIG_SMP_NCPUS];
+#else
+uint32_t g_critmon_irqstart[1];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_critmon_hist
+ *
+ * Description:
+ *   Add one elapsed time to a log2 histogram.
+ *
+ ****************************************************************************/
+
+static inline void nxsched_critmon_hist(FAR uint32_t *hist, uint32_t elapsed)
+{
+  unsigned int bucket = 0;
+
+  /* The bucket is the number of significant bits in the elapsed time */
+
+  if (elapsed >= (UINT32_C(1) << 16))
+    {
+      elapsed >>= 16;
+      bucket   += 16;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 8))
+    {
+      elapsed >>= 8;
+      bucket   += 8;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 4))
+    {
+      elapsed >>= 4;
+      bucket   += 4;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 2))
+    {
+      elapsed >>= 2;
+      bucket   += 2;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 1))
+    {
+      elapsed >>= 1;
+      bucket   += 1;
+    }
+
+  hist[bucket + elapsed]++;
+}
+
+/****************************************************************************
+ * Name: nxsched_critmon_record
+ *
+ * Description:
+ *   Account for one elapsed time:  Update the maximum and the histogram.
+ *
+ ****************************************************************************/
+
+static inline void nxsched_critmon_record(FAR uint32_t *max,
+                                          FAR uint32_t *hist,
+                                          uint32_t elapsed)
+{
+  if (elapsed > *max)
+    {
+      *max = elapsed;
+    }
+
+  nxsched_critmon_hist(hist, elapsed);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -135,10 +226,8 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
           elapsed            = now - g_premp_start[cpu];
           g_premp_start[cpu] = 0;
 
-          if (elapsed > g_premp_max[cpu])
-            {
-              g_premp_max[cpu] = elapsed;
-            }
+          nxsched_critmon_record(&g_premp_max[cpu], g_premp_hist[cpu],
+                                 elapsed);
         }
     }
 }
@@ -199,14 +288,37 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
           elapsed           = now - g_crit_start[cpu];
           g_crit_start[cpu] = 0;
 
-          if (elapsed > g_crit_max[cpu])
-            {
-              g_crit_max[cpu] = elapsed;
-            }
+          nxsched_critmon_record(&g_crit_max[cpu], g_crit_hist[cpu],
+                                 elapsed);
         }
     }
 }
 
+/****************************************************************************
+ * Name: nxsched_critmon_wakeup
+ *
+ * Description:
+ *   Called when a thread is made ready-to-run.  If this happens in an
+ *   interrupt handler, remember the entry time of the interrupt so that the
+ *   wake-up latency can be measured when the thread next runs.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_critmon_wakeup(FAR struct tcb_s *tcb)
+{
+  int cpu = this_cpu();
+
+  if (up_interrupt_context() && g_critmon_irqstart[cpu] != 0 &&
+      tcb->wakeup_start == 0)
+    {
+      tcb->wakeup_start = g_critmon_irqstart[cpu];
+    }
+}
+
 /****************************************************************************
  * Name: nxsched_resume_critmon
  *
@@ -227,6 +339,16 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb)
 
   DEBUGASSERT(tcb->premp_start == 0 && tcb->crit_start == 0);
 
+  /* Was this task woken up by an interrupt? */
+
+  if (tcb->wakeup_start != 0)
+    {
+      elapsed           = up_critmon_gettime() - tcb->wakeup_start;
+      tcb->wakeup_start = 0;
+
+      nxsched_critmon_hist(g_wakeup_hist[cpu], elapsed);
+    }
+
   /* Did this task disable pre-emption? */
 
   if (tcb->lockcount > 0)
@@ -250,10 +372,7 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb)
       elapsed            = up_critmon_gettime() - g_premp_start[cpu];
       g_premp_start[cpu] = 0;
 
-      if (elapsed > g_premp_max[cpu])
-        {
-          g_premp_max[cpu] = elapsed;
-        }
+      nxsched_critmon_record(&g_premp_max[cpu], g_premp_hist[cpu], elapsed);
     }
 
   /* Was this task in a critical section? */
@@ -277,10 +396,7 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb)
       elapsed      = up_critmon_gettime() - g_crit_start[cpu];
       g_crit_start[cpu] = 0;
 
-      if (elapsed > g_crit_max[cpu])
-        {
-          g_crit_max[cpu] = elapsed;
-        }
+      nxsched_critmon_record(&g_crit_max[cpu], g_crit_hist[cpu], elapsed);
     }
 }
 
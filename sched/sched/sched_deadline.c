@@ -0,0 +1,351 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths (runtime / period) are fixed point values with this many
+ * fractional bits.
+ */
+
+#define DEADLINE_BW_SHIFT  16
+#define DEADLINE_BW_LIMIT  \
+  (((uint32_t)CONFIG_SCHED_DEADLINE_MAXUTIL << DEADLINE_BW_SHIFT) / 100)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidths of all deadline threads */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Change the priority of a deadline thread.  This also moves the thread
+ *   to the position of its current deadline in whatever list it is in and
+ *   may cause a context switch.
+ *
+ * Input Parameters:
+ *   tcb      - TCB of the thread whose priority will be modified
+ *   priority - The new priority
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* If the priority was boosted above the new priority, then just reset
+   * the base priority and continue to run at the boosted priority.
+   */
+
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority > priority)
+    {
+      tcb->base_priority = priority;
+      return OK;
+    }
+#endif
+
+  return nxsched_reprioritize(tcb, priority);
+}
+
+/****************************************************************************
+ * Name: deadline_period_expire
+ *
+ * Description:
+ *   Handles the start of a new period:  The budget is replenished, the
+ *   absolute deadline advances by one period and a throttled thread
+ *   returns to its priority.
+ *
+ * Input Parameters:
+ *   arg - The TCB of the deadline thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_period_expire(wdparm_t arg)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg;
+  FAR struct deadline_s *deadline;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  DEBUGVERIFY(wd_start(&deadline->timer, deadline->period,
+                       deadline_period_expire, arg));
+
+  deadline->absdeadline += deadline->period;
+  deadline->throttled    = false;
+  tcb->timeslice         = deadline->runtime;
+
+  DEBUGVERIFY(deadline_set_priority(tcb, deadline->priority));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_set_deadline
+ *
+ * Description:
+ *   Establish, or change, the deadline scheduling parameters of a thread
+ *   and start its first period now.  Called from sched_setscheduler() and
+ *   sched_setparam().  The priority itself is set by the caller.
+ *
+ *   Admission control:  The request is refused if the total bandwidth of
+ *   all deadline threads would exceed CONFIG_SCHED_DEADLINE_MAXUTIL.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The priority and the sched_dl_* parameters.  A zero period
+ *           means that the period is equal to the deadline.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL The parameters are not runtime <= deadline <= period.
+ *   EBUSY  Admission control refused the new bandwidth.
+ *   ENOMEM The deadline state could not be allocated.
+ *
+ *   On failure, the current parameters of the thread are unchanged.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int nxsched_set_deadline(FAR struct tcb_s *tcb,
+                         FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *deadline;
+  sclock_t runtime_ticks;
+  sclock_t deadline_ticks;
+  sclock_t period_ticks;
+  uint32_t bandwidth;
+  uint32_t oldbw;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+
+  if (param->sched_priority < SCHED_PRIORITY_MIN ||
+      param->sched_priority > SCHED_PRIORITY_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Convert timespec values to system clock ticks */
+
+  clock_time2ticks(&param->sched_dl_runtime, &runtime_ticks);
+  clock_time2ticks(&param->sched_dl_deadline, &deadline_ticks);
+  clock_time2ticks(&param->sched_dl_period, &period_ticks);
+
+  if (period_ticks == 0)
+    {
+      period_ticks = deadline_ticks;
+    }
+
+  if (runtime_ticks < 1 || deadline_ticks < runtime_ticks ||
+      period_ticks < deadline_ticks)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control */
+
+  deadline  = tcb->deadline;
+  oldbw     = deadline != NULL ? deadline->bandwidth : 0;
+  bandwidth = (uint32_t)(((uint64_t)runtime_ticks << DEADLINE_BW_SHIFT) /
+                         (uint64_t)period_ticks);
+
+  if (g_deadline_bw - oldbw + bandwidth > DEADLINE_BW_LIMIT)
+    {
+      return -EBUSY;
+    }
+
+  if (deadline == NULL)
+    {
+      /* Allocate the deadline add-on data structure */
+
+      deadline = (FAR struct deadline_s *)
+        kmm_zalloc(sizeof(struct deadline_s));
+      if (deadline == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      tcb->deadline = deadline;
+    }
+  else
+    {
+      wd_cancel(&deadline->timer);
+    }
+
+  g_deadline_bw          = g_deadline_bw - oldbw + bandwidth;
+
+  deadline->priority     = (uint8_t)param->sched_priority;
+  deadline->runtime      = runtime_ticks;
+  deadline->deadline     = deadline_ticks;
+  deadline->period       = period_ticks;
+  deadline->bandwidth    = bandwidth;
+  deadline->throttled    = false;
+
+  /* Start the first period now */
+
+  deadline->absdeadline  = clock_systime_ticks() + deadline_ticks;
+  tcb->timeslice         = runtime_ticks;
+
+  return wd_start(&deadline->timer, period_ticks,
+                  deadline_period_expire, (wdparm_t)tcb);
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Terminate deadline scheduling on a thread, release its bandwidth and
+ *   free its deadline state.  Called when the thread exits or changes to
+ *   another scheduling policy.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  wd_cancel(&deadline->timer);
+  g_deadline_bw -= deadline->bandwidth;
+
+  kmm_free(deadline);
+  tcb->deadline  = NULL;
+  tcb->timeslice = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_process_deadline
+ *
+ * Description:
+ *   Charge the elapsed time to the budget of the running deadline thread.
+ *   Called from the timer interrupt handler while the thread is running.
+ *   When the budget is used up, the thread is throttled to the lowest
+ *   priority until its next period begins.
+ *
+ * Input Parameters:
+ *   tcb        - The TCB of the running deadline thread
+ *   ticks      - The number of elapsed ticks since the last time this
+ *                function was called.
+ *   noswitches - We are running in a context where context switching is
+ *                not permitted.
+ *
+ * Returned Value:
+ *   The number of ticks remaining in the budget of this period.  Zero is
+ *   returned if the thread is throttled.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches)
+{
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL && ticks > 0);
+
+  /* Nothing is charged while throttled */
+
+  if (tcb->timeslice <= 0)
+    {
+      return 0;
+    }
+
+  if (ticks < (uint32_t)tcb->timeslice)
+    {
+      tcb->timeslice -= ticks;
+      return tcb->timeslice;
+    }
+
+  /* The budget is used up.  Throttling may cause a context switch, which
+   * is not possible with pre-emption disabled or when called via
+   * nxsched_reassess_timer().  Try again on the next tick.
+   */
+
+  if (noswitches || nxsched_islocked_tcb(tcb))
+    {
+      tcb->timeslice = 1;
+      return 1;
+    }
+
+  tcb->timeslice           = 0;
+  tcb->deadline->throttled = true;
+
+  DEBUGVERIFY(deadline_set_priority(tcb, SCHED_PRIORITY_MIN));
+  return 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -68,7 +68,45 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_READYINDEX)
+bool nxsched_merge_pending(void)
+{
+  FAR struct tcb_s *ptcb;
+  FAR struct tcb_s *pnext;
+  bool ret = false;
+
+  /* Move every TCB in the g_pendingtasks list to the ready-to-run list.
+   * With the ready-to-run index, each insertion is constant time.
+   */
+
+  for (ptcb = (FAR struct tcb_s *)g_pendingtasks.head;
+       ptcb;
+       ptcb = pnext)
+    {
+      pnext = ptcb->flink;
+
+      if (nxsched_add_indexed(ptcb))
+        {
+          /* ptcb is the new head of the ready-to-run list */
+
+          ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+          ptcb->task_state        = TSTATE_TASK_RUNNING;
+          ret                     = true;
+        }
+      else
+        {
+          ptcb->task_state        = TSTATE_TASK_READYTORUN;
+        }
+    }
+
+  /* Mark the input list empty */
+
+  g_pendingtasks.head = NULL;
+  g_pendingtasks.tail = NULL;
+
+  return ret;
+}
+#elif !defined(CONFIG_SMP)
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -99,7 +137,7 @@ bool nxsched_merge_pending(void)
        */
 
       for (;
-           (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+           (rtcb && !nxsched_precedes(ptcb, rtcb));
            rtcb = rtcb->flink)
         {
         }
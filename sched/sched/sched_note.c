@@ -25,6 +25,8 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -730,6 +732,154 @@ void sched_note_irqhandler(int irq, FAR void *handler, bool enter)
 }
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SEMSPIN
+void sched_note_semspin(FAR struct tcb_s *tcb, FAR sem_t *sem,
+                        unsigned int nspins, bool acquired)
+{
+  struct note_semspin_s note;
+
+  if (!note_isenabled())
+    {
+      return;
+    }
+
+  /* Format the note */
+
+  note_common(tcb, &note.nss_cmn, sizeof(struct note_semspin_s),
+              NOTE_SEM_SPIN);
+
+  note.nss_sem[0] = (uint8_t)((uintptr_t)sem & 0xff);
+  note.nss_sem[1] = (uint8_t)(((uintptr_t)sem >> 8)  & 0xff);
+#if UINTPTR_MAX > UINT16_MAX
+  note.nss_sem[2] = (uint8_t)(((uintptr_t)sem >> 16) & 0xff);
+  note.nss_sem[3] = (uint8_t)(((uintptr_t)sem >> 24) & 0xff);
+#if UINTPTR_MAX > UINT32_MAX
+  note.nss_sem[4] = (uint8_t)(((uintptr_t)sem >> 32) & 0xff);
+  note.nss_sem[5] = (uint8_t)(((uintptr_t)sem >> 40) & 0xff);
+  note.nss_sem[6] = (uint8_t)(((uintptr_t)sem >> 48) & 0xff);
+  note.nss_sem[7] = (uint8_t)(((uintptr_t)sem >> 56) & 0xff);
+#endif
+#endif
+
+  if (nspins > UINT16_MAX)
+    {
+      nspins = UINT16_MAX;
+    }
+
+  note.nss_nspins[0] = (uint8_t)(nspins & 0xff);
+  note.nss_nspins[1] = (uint8_t)((nspins >> 8) & 0xff);
+  note.nss_acquired  = acquired ? 1 : 0;
+
+  /* Add the note to circular buffer */
+
+  sched_note_add(&note, sizeof(struct note_semspin_s));
+}
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+void sched_note_string(FAR const char *buf)
+{
+  uint8_t data[UINT8_MAX];
+  FAR struct note_string_s *note = (FAR struct note_string_s *)data;
+  size_t length;
+
+  if (!note_isenabled())
+    {
+      return;
+    }
+
+  /* Copy the string, truncating it if it will not fit in one note */
+
+  length = strnlen(buf, NOTE_STRING_MAXLEN);
+  memcpy(note->nst_data, buf, length);
+  note->nst_data[length] = '\0';
+
+  /* Format the note */
+
+  length += sizeof(struct note_string_s);
+  note_common(this_task(), &note->nst_cmn, length, NOTE_DUMP_STRING);
+
+  /* Add the note to circular buffer */
+
+  sched_note_add(note, length);
+}
+
+void sched_note_printf(FAR const char *fmt, ...)
+{
+  uint8_t data[UINT8_MAX];
+  FAR struct note_string_s *note = (FAR struct note_string_s *)data;
+  size_t length;
+  va_list ap;
+  int ret;
+
+  if (!note_isenabled())
+    {
+      return;
+    }
+
+  /* Format the string directly into the note, truncating it if necessary */
+
+  va_start(ap, fmt);
+  ret = vsnprintf(note->nst_data, NOTE_STRING_MAXLEN + 1, fmt, ap);
+  va_end(ap);
+
+  if (ret < 0)
+    {
+      return;
+    }
+
+  length = ret > NOTE_STRING_MAXLEN ? NOTE_STRING_MAXLEN : ret;
+
+  /* Format the note */
+
+  length += sizeof(struct note_string_s);
+  note_common(this_task(), &note->nst_cmn, length, NOTE_DUMP_STRING);
+
+  /* Add the note to circular buffer */
+
+  sched_note_add(note, length);
+}
+#endif
+
+#ifdef CONFIG_SCHED_SPANS
+void sched_note_span(FAR void *span, uint32_t time, bool begin)
+{
+  struct note_span_s note;
+
+  if (!note_isenabled())
+    {
+      return;
+    }
+
+  /* Format the note */
+
+  note_common(this_task(), &note.nsp_cmn, sizeof(struct note_span_s),
+              begin ? NOTE_SPAN_BEGIN : NOTE_SPAN_END);
+
+  note.nsp_span[0] = (uint8_t)((uintptr_t)span & 0xff);
+  note.nsp_span[1] = (uint8_t)(((uintptr_t)span >> 8)  & 0xff);
+#if UINTPTR_MAX > UINT16_MAX
+  note.nsp_span[2] = (uint8_t)(((uintptr_t)span >> 16) & 0xff);
+  note.nsp_span[3] = (uint8_t)(((uintptr_t)span >> 24) & 0xff);
+#if UINTPTR_MAX > UINT32_MAX
+  note.nsp_span[4] = (uint8_t)(((uintptr_t)span >> 32) & 0xff);
+  note.nsp_span[5] = (uint8_t)(((uintptr_t)span >> 40) & 0xff);
+  note.nsp_span[6] = (uint8_t)(((uintptr_t)span >> 48) & 0xff);
+  note.nsp_span[7] = (uint8_t)(((uintptr_t)span >> 56) & 0xff);
+#endif
+#endif
+
+  note.nsp_time[0] = (uint8_t)(time         & 0xff);
+  note.nsp_time[1] = (uint8_t)((time >> 8)  & 0xff);
+  note.nsp_time[2] = (uint8_t)((time >> 16) & 0xff);
+  note.nsp_time[3] = (uint8_t)((time >> 24) & 0xff);
+
+  /* Add the note to circular buffer */
+
+  sched_note_add(&note, sizeof(struct note_span_s));
+}
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
 
 /****************************************************************************
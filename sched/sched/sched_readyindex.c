@@ -0,0 +1,277 @@
+/****************************************************************************
+ * sched/sched/sched_readyindex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Constant-time insertion into the ready-to-run list.
+ *
+ * g_readytorun stays the same priority-sorted list that everything else
+ * walks (this_task() is still its head).  In addition, a bitmap records
+ * which priorities have ready-to-run tasks and g_readytail[] holds the
+ * last task of each priority.  A new task goes right after the tail of the
+ * lowest present priority that is >= its own, which is exactly where the
+ * linear search in nxsched_add_prioritized() would have put it:  behind
+ * all tasks of equal priority, so round-robin and sporadic scheduling
+ * see the same FIFO order.  Finding that priority is a scan over at most
+ * eight 32-bit words.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYINDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NPRIORITIES (SCHED_PRIORITY_MAX + 1)
+#define NWORDS      ((NPRIORITIES + 31) / 32)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct tcb_s *g_readytail[NPRIORITIES];
+static uint32_t g_readymap[NWORDS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_index_find
+ *
+ * Description:
+ *   Return the lowest priority >= 'priority' that has ready-to-run tasks,
+ *   or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int nxsched_index_find(int priority)
+{
+  int word = priority >> 5;
+  uint32_t bits = g_readymap[word] & (UINT32_MAX << (priority & 31));
+
+  for (; ; )
+    {
+      if (bits != 0)
+        {
+          return (word << 5) + __builtin_ctz(bits);
+        }
+
+      if (++word >= NWORDS)
+        {
+          return -1;
+        }
+
+      bits = g_readymap[word];
+    }
+}
+
+static void nxsched_index_settail(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+
+  g_readytail[priority]    = tcb;
+  g_readymap[priority >> 5] |= (uint32_t)1 << (priority & 31);
+}
+
+/* Forget 'tcb' in the index (but leave it in the list) */
+
+static void nxsched_index_forget(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (g_readytail[priority] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          g_readytail[priority] = prev;
+        }
+      else
+        {
+          g_readytail[priority] = NULL;
+          g_readymap[priority >> 5] &= ~((uint32_t)1 << (priority & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_add_indexed
+ *
+ * Description:
+ *   Add 'tcb' to g_readytorun, behind all tasks of higher or equal
+ *   priority.  Same contract as nxsched_add_prioritized().
+ *
+ * Returned Value:
+ *   true if the head of the list has changed.
+ *
+ ****************************************************************************/
+
+bool nxsched_add_indexed(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = (FAR dq_queue_t *)&g_readytorun;
+  FAR struct tcb_s *prev;
+  FAR struct tcb_s *tail;
+  bool ret = false;
+  int priority;
+
+  DEBUGASSERT(tcb->sched_priority >= SCHED_PRIORITY_MIN);
+
+  priority = nxsched_index_find(tcb->sched_priority);
+  tail     = priority < 0 ? NULL : g_readytail[priority];
+  prev     = tail;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Within its priority, a deadline thread goes ahead of the tasks with a
+   * later deadline.
+   */
+
+  while (prev != NULL && prev->sched_priority == tcb->sched_priority &&
+         nxsched_deadline_before(tcb, prev))
+    {
+      prev = prev->blink;
+    }
+#endif
+
+  if (prev == NULL)
+    {
+      /* Nothing ahead of the tcb:  it becomes the head */
+
+      tcb->blink = NULL;
+      tcb->flink = (FAR struct tcb_s *)list->head;
+      if (list->head != NULL)
+        {
+          ((FAR struct tcb_s *)list->head)->blink = tcb;
+        }
+      else
+        {
+          list->tail = (FAR dq_entry_t *)tcb;
+        }
+
+      list->head = (FAR dq_entry_t *)tcb;
+      ret        = true;
+    }
+  else
+    {
+      /* Insert just after prev */
+
+      tcb->blink = prev;
+      tcb->flink = prev->flink;
+      if (prev->flink != NULL)
+        {
+          prev->flink->blink = tcb;
+        }
+      else
+        {
+          list->tail = (FAR dq_entry_t *)tcb;
+        }
+
+      prev->flink = tcb;
+    }
+
+  /* The index only changes if tcb is now the last of its priority */
+
+  if (prev == tail)
+    {
+      nxsched_index_settail(tcb);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_remove_indexed
+ *
+ * Description:
+ *   Remove 'tcb' from g_readytorun.
+ *
+ ****************************************************************************/
+
+void nxsched_remove_indexed(FAR struct tcb_s *tcb)
+{
+  nxsched_index_forget(tcb);
+  dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+}
+
+/****************************************************************************
+ * Name: nxsched_setpriority_indexed
+ *
+ * Description:
+ *   Change the priority of a task in g_readytorun without moving it.  This
+ *   is only valid when the list stays sorted, i.e. for the running task
+ *   whose new priority remains strictly above that of the next task.
+ *
+ ****************************************************************************/
+
+void nxsched_setpriority_indexed(FAR struct tcb_s *tcb, uint8_t priority)
+{
+  nxsched_index_forget(tcb);
+  tcb->sched_priority = priority;
+  nxsched_index_settail(tcb);
+}
+
+/****************************************************************************
+ * Name: nxsched_rebuild_index
+ *
+ * Description:
+ *   Rebuild the index from the contents of g_readytorun.  Used at start-up
+ *   once the IDLE task has been put in the list.
+ *
+ ****************************************************************************/
+
+void nxsched_rebuild_index(void)
+{
+  FAR struct tcb_s *tcb;
+  int i;
+
+  for (i = 0; i < NWORDS; i++)
+    {
+      g_readymap[i] = 0;
+    }
+
+  for (i = 0; i < NPRIORITIES; i++)
+    {
+      g_readytail[i] = NULL;
+    }
+
+  for (tcb = (FAR struct tcb_s *)g_readytorun.head; tcb != NULL;
+       tcb = tcb->flink)
+    {
+      nxsched_index_settail(tcb);
+    }
+}
+
+#endif /* CONFIG_SCHED_READYINDEX */
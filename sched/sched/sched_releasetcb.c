@@ -34,6 +34,7 @@
 #include "sched/sched.h"
 #include "group/group.h"
 #include "timer/timer.h"
+#include "task/task.h"
 
 /****************************************************************************
  * Private Functions
@@ -127,6 +128,22 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
           nxsched_releasepid(tcb->pid);
         }
 
+#ifdef CONFIG_STACK_MONITOR
+      /* Keep the stack usage of the thread for the stack size report */
+
+      if (tcb->stack_alloc_ptr)
+        {
+          nxsched_stackmon_exit(tcb);
+        }
+#endif
+
+      /* A pooled TCB keeps its stack; it goes back with the slot */
+
+      if (nxtask_tcbpooled(tcb))
+        {
+          tcb->stack_alloc_ptr = NULL;
+        }
+
       /* Delete the thread's stack if one has been allocated */
 
       if (tcb->stack_alloc_ptr)
@@ -168,7 +185,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* And, finally, release the TCB itself */
 
-      kmm_free(tcb);
+      nxtask_tcbfree(tcb);
     }
 
   return ret;
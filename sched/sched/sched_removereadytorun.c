@@ -102,7 +102,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+  nxsched_remove_indexed(rtcb);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -243,7 +243,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
 
           dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
 
-          tmptcb->cpu = cpu;
+          nxsched_set_cpu(tmptcb, cpu);
           nxttcb = tmptcb;
         }
 
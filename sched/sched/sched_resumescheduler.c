@@ -41,6 +41,7 @@
 
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
@@ -73,7 +74,7 @@
 void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
 {
 #if CONFIG_RR_INTERVAL > 0
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
   if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_RR)
 #endif
     {
@@ -95,11 +96,21 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#if defined(CONFIG_TLS_THREAD_POINTER) && \
+    defined(CONFIG_ARCH_THREAD_POINTER_SWITCH)
+  /* Point the thread pointer register at the TLS of the task */
+
+  up_tls_switch(tcb);
+#endif
+
   /* Indicate the task has been resumed */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_resume_cputime(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
@@ -219,6 +219,26 @@ int nxsched_set_param(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  This restarts the
+   * period.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      ret = nxsched_set_deadline(tcb, param);
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = nxsched_reprioritize(tcb, param->sched_priority);
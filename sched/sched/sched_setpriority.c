@@ -151,7 +151,11 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
+#ifdef CONFIG_SMP
       tcb->sched_priority = (uint8_t)sched_priority;
+#else
+      nxsched_setpriority_indexed(tcb, (uint8_t)sched_priority);
+#endif
     }
 }
 
@@ -188,7 +192,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
   if (tcb->task_state == TSTATE_TASK_READYTORUN)
     {
-      cpu = nxsched_select_cpu(tcb->affinity);
+      cpu = nxsched_select_tcbcpu(tcb);
     }
 
   /* CASE 2b.  The task is ready to run, and assigned to a CPU.  An increase
@@ -216,10 +220,16 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 #endif
 
   /* A context switch will occur if the new priority of the ready-to-run
-   * task is (strictly) greater than the current running task
+   * task is (strictly) greater than the current running task, or equal
+   * to it with an earlier deadline.
    */
 
-  if (sched_priority > rtcb->sched_priority)
+  if (sched_priority > rtcb->sched_priority
+#ifdef CONFIG_SCHED_DEADLINE
+      || (sched_priority == rtcb->sched_priority &&
+          nxsched_deadline_before(tcb, rtcb))
+#endif
+     )
     {
       /* A context switch will occur. */
 
@@ -72,6 +72,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control refused the request.
  *
  ****************************************************************************/
 
@@ -90,6 +91,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -138,10 +142,20 @@ int nxsched_set_scheduler(pid_t pid, int policy,
             }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+          /* Cancel any on-going deadline scheduling */
+
+          if (tcb->deadline != NULL)
+            {
+              DEBUGVERIFY(nxsched_stop_deadline(tcb));
+            }
+#endif
+
           /* Save the FIFO scheduling parameters */
 
           tcb->flags       |= TCB_FLAG_SCHED_FIFO;
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
           tcb->timeslice    = 0;
 #endif
         }
@@ -159,6 +173,15 @@ int nxsched_set_scheduler(pid_t pid, int policy,
             }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+          /* Cancel any on-going deadline scheduling */
+
+          if (tcb->deadline != NULL)
+            {
+              DEBUGVERIFY(nxsched_stop_deadline(tcb));
+            }
+#endif
+
           /* Save the round robin scheduling parameters */
 
           tcb->flags       |= TCB_FLAG_SCHED_RR;
@@ -216,6 +239,15 @@ int nxsched_set_scheduler(pid_t pid, int policy,
               goto errout_with_irq;
             }
 
+#ifdef CONFIG_SCHED_DEADLINE
+          /* Cancel any on-going deadline scheduling */
+
+          if (tcb->deadline != NULL)
+            {
+              DEBUGVERIFY(nxsched_stop_deadline(tcb));
+            }
+#endif
+
           /* Initialize/reset current sporadic scheduling */
 
           if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
@@ -258,6 +290,36 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Set up the reservation and start its first period.  On
+           * failure, an existing reservation is left unchanged.
+           */
+
+          ret = nxsched_set_deadline(tcb, param);
+          if (tcb->deadline != NULL)
+            {
+              tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+
+#ifdef CONFIG_SCHED_SPORADIC
+          /* Cancel any on-going sporadic scheduling */
+
+          if (tcb->sporadic != NULL)
+            {
+              DEBUGVERIFY(nxsched_stop_sporadic(tcb));
+            }
+#endif
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -273,7 +335,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -0,0 +1,83 @@
+/****************************************************************************
+ * sched/sched/sched_slack.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TICKLESS_SLACK
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_slack_delay
+ *
+ * Description:
+ *   Apply the timer slack of a thread to the delay of one of its timed
+ *   waits.  The expiration is moved later, to the next multiple of the
+ *   slack.  The timed waits of all threads with the same slack (or with
+ *   slacks that are multiples of each other) then expire on the same ticks
+ *   and the tick-less timer is programmed fewer times.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the waiting thread
+ *   delay - The requested delay in clock ticks
+ *
+ * Returned Value:
+ *   The delay to pass to wd_start().  It is never less than 'delay' and
+ *   exceeds it by less than the slack of the thread.
+ *
+ ****************************************************************************/
+
+int32_t nxsched_slack_delay(FAR struct tcb_s *tcb, int32_t delay)
+{
+  uint32_t slack = tcb->timerslack;
+  uint32_t pad;
+
+  if (slack <= 1 || delay <= 0)
+    {
+      return delay;
+    }
+
+  pad = (uint32_t)((clock_systime_ticks() + delay) % slack);
+  if (pad != 0)
+    {
+      pad = slack - pad;
+      if (delay <= INT32_MAX - (int32_t)pad)
+        {
+          delay += pad;
+        }
+    }
+
+  return delay;
+}
+
+#endif /* CONFIG_SCHED_TICKLESS_SLACK */
@@ -0,0 +1,174 @@
+/****************************************************************************
+ * sched/sched/sched_span.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/sched_span.h>
+
+#ifdef CONFIG_SCHED_SPANS
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of spans that have completed at least once.  Entries are only
+ * ever added at the head, so a reader may walk the list without a lock.
+ */
+
+FAR struct sched_span_s *volatile g_sched_spans;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_span_bucket
+ *
+ * Description:
+ *   Return the histogram bucket for a duration:  The number of significant
+ *   bits in the duration.
+ *
+ ****************************************************************************/
+
+static inline unsigned int sched_span_bucket(uint32_t elapsed)
+{
+  unsigned int bucket = 0;
+
+  if (elapsed >= (UINT32_C(1) << 16))
+    {
+      elapsed >>= 16;
+      bucket   += 16;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 8))
+    {
+      elapsed >>= 8;
+      bucket   += 8;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 4))
+    {
+      elapsed >>= 4;
+      bucket   += 4;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 2))
+    {
+      elapsed >>= 2;
+      bucket   += 2;
+    }
+
+  if (elapsed >= (UINT32_C(1) << 1))
+    {
+      elapsed >>= 1;
+      bucket   += 1;
+    }
+
+  return bucket + elapsed;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_span_begin
+ *
+ * Description:
+ *   Mark the beginning of one execution of a span of code.
+ *
+ * Input Parameters:
+ *   span - The span being measured
+ *
+ * Returned Value:
+ *   The start time, which must be passed to sched_span_end().
+ *
+ ****************************************************************************/
+
+uint32_t sched_span_begin(FAR struct sched_span_s *span)
+{
+  uint32_t now = up_critmon_gettime();
+
+  sched_note_span(span, now, true);
+  return now;
+}
+
+/****************************************************************************
+ * Name: sched_span_end
+ *
+ * Description:
+ *   Mark the end of one execution of a span of code and account for its
+ *   duration.
+ *
+ * Input Parameters:
+ *   span  - The span being measured
+ *   start - The value returned by the matching sched_span_begin()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_span_end(FAR struct sched_span_s *span, uint32_t start)
+{
+  uint32_t now     = up_critmon_gettime();
+  uint32_t elapsed = now - start;
+  irqstate_t flags;
+
+  sched_note_span(span, now, false);
+
+  flags = enter_critical_section();
+
+  /* Add the span to the list the first time that it completes */
+
+  if (!span->ss_registered)
+    {
+      span->ss_flink      = g_sched_spans;
+      span->ss_registered = true;
+      g_sched_spans       = span;
+    }
+
+  if (span->ss_count == 0 || elapsed < span->ss_min)
+    {
+      span->ss_min = elapsed;
+    }
+
+  if (elapsed > span->ss_max)
+    {
+      span->ss_max = elapsed;
+    }
+
+  span->ss_count++;
+  span->ss_total += elapsed;
+  span->ss_hist[sched_span_bucket(elapsed)]++;
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_SPANS */
@@ -0,0 +1,236 @@
+/****************************************************************************
+ * sched/sched/sched_stackmon.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <syslog.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_STACK_MONITOR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define STACKMONWORK LPWORK
+#else
+#  define STACKMONWORK HPWORK
+#endif
+
+#define STACKMON_DELAY MSEC2TICK(CONFIG_STACK_MONITOR_INTERVAL)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct work_s g_stackmon_work;
+
+/* Usage of the threads that have exited, grouped by name.  Entries are
+ * only added, under a critical section.
+ */
+
+static struct stackhist_s g_stackmon_hist[CONFIG_STACK_MONITOR_NHISTORY];
+static int g_stackmon_nhist;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stackmon_worker
+ *
+ * Description:
+ *   Sample the stack high water mark of every thread.  Each stack is
+ *   scanned in its own critical section so that the thread cannot exit
+ *   while it is examined.  A warning is given once, when a thread first
+ *   uses more than CONFIG_STACK_MONITOR_WARN percent of its stack.
+ *
+ ****************************************************************************/
+
+static void stackmon_worker(FAR void *arg)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  size_t size;
+  size_t used;
+  bool warn;
+  pid_t pid;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_MAX_TASKS; ndx++)
+    {
+      warn  = false;
+      flags = enter_critical_section();
+
+      tcb = g_pidhash[ndx].tcb;
+      if (tcb != NULL && tcb->adj_stack_size > 0)
+        {
+          used = up_check_tcbstack(tcb);
+          size = tcb->adj_stack_size;
+          pid  = tcb->pid;
+
+#if CONFIG_STACK_MONITOR_WARN > 0
+          warn = used * 100 > size * CONFIG_STACK_MONITOR_WARN &&
+                 tcb->stack_hwm * 100 <= size * CONFIG_STACK_MONITOR_WARN;
+#endif
+          if (used > tcb->stack_hwm)
+            {
+              tcb->stack_hwm = used;
+            }
+        }
+
+      leave_critical_section(flags);
+
+      /* The syslog may block, so report outside of the critical section */
+
+      if (warn)
+        {
+          syslog(LOG_WARNING, "stackmon: PID %d uses %lu of %lu bytes\n",
+                 (int)pid, (unsigned long)used, (unsigned long)size);
+        }
+    }
+
+  work_queue(STACKMONWORK, &g_stackmon_work, stackmon_worker, NULL,
+             STACKMON_DELAY);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_stackmon_start
+ *
+ * Description:
+ *   Start periodic sampling.  Called from nx_bringup() once the work queues
+ *   are running.
+ *
+ ****************************************************************************/
+
+void nxsched_stackmon_start(void)
+{
+  work_queue(STACKMONWORK, &g_stackmon_work, stackmon_worker, NULL,
+             STACKMON_DELAY);
+}
+
+/****************************************************************************
+ * Name: nxsched_stackmon_exit
+ *
+ * Description:
+ *   Record the final stack usage of a thread whose TCB is being released.
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_stackmon_exit(FAR struct tcb_s *tcb)
+{
+  FAR struct stackhist_s *hist;
+  FAR const char *name = "";
+  size_t used;
+  int i;
+
+  if (tcb->adj_stack_size == 0)
+    {
+      return;
+    }
+
+  used = up_check_tcbstack(tcb);
+  if (used < tcb->stack_hwm)
+    {
+      used = tcb->stack_hwm;
+    }
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  name = tcb->name;
+#endif
+
+  for (i = 0; i < g_stackmon_nhist; i++)
+    {
+      hist = &g_stackmon_hist[i];
+      if (strcmp(hist->name, name) == 0)
+        {
+          break;
+        }
+    }
+
+  if (i == g_stackmon_nhist)
+    {
+      if (i >= CONFIG_STACK_MONITOR_NHISTORY)
+        {
+          return;
+        }
+
+      hist = &g_stackmon_hist[i];
+      strlcpy(hist->name, name, sizeof(hist->name));
+      hist->used  = 0;
+      hist->count = 0;
+      g_stackmon_nhist++;
+    }
+
+  hist->size = tcb->adj_stack_size;
+  hist->count++;
+
+  if (used > hist->used)
+    {
+      hist->used = used;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_stackmon_history
+ *
+ * Description:
+ *   Report the stack usage of threads that have exited.
+ *
+ ****************************************************************************/
+
+int nxsched_stackmon_history(int index, FAR struct stackhist_s *hist)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = enter_critical_section();
+  if (index >= 0 && index < g_stackmon_nhist)
+    {
+      *hist = g_stackmon_hist[index];
+      ret   = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_STACK_MONITOR */
@@ -61,7 +61,7 @@ FAR struct tcb_s *this_task(void)
    * the following operations.
    */
 
-  flags = up_irq_save();
+  flags = local_irq_save();
 
   /* Obtain the TCB which is currently running on this CPU */
 
@@ -69,7 +69,7 @@ FAR struct tcb_s *this_task(void)
 
   /* Enable local interrupts */
 
-  up_irq_restore(flags);
+  local_irq_restore(flags);
   return tcb;
 }
 
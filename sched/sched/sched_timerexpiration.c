@@ -25,10 +25,14 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
 #include <time.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+
 #if CONFIG_RR_INTERVAL > 0
 #  include <sched.h>
 #  include <nuttx/arch.h>
@@ -102,11 +106,13 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * Private Function Prototypes
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
                                       bool noswitches);
 #endif
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_process_scheduler(uint32_t ticks, bool noswitches);
 #endif
 static unsigned int nxsched_timer_process(unsigned int ticks,
@@ -139,6 +145,14 @@ static unsigned int g_timer_interval;
 static struct timespec g_sched_time;
 #endif
 
+/* The time when the timer started by nxsched_timer_start() will expire and
+ * whether it is running.  This is the prediction available to the PM
+ * governor through nxsched_timer_remaining().
+ */
+
+static struct timespec g_timer_deadline;
+static bool g_timer_active;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -168,7 +182,8 @@ static struct timespec g_sched_time;
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
                                       bool noswitches)
 {
@@ -216,6 +231,17 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the elapsed ticks to its budget. */
+
+      ret = nxsched_process_deadline(rtcb, ticks, noswitches);
+    }
+#endif
+
   /* If a context switch occurred, then need to return delay remaining for
    * the new task at the head of the ready to run list.
    */
@@ -270,7 +296,8 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_process_scheduler(uint32_t ticks, bool noswitches)
 {
 #ifdef CONFIG_SMP
@@ -390,6 +417,8 @@ static void nxsched_timer_start(unsigned int ticks)
   uint32_t nsecs;
   int ret;
 
+  g_timer_active = false;
+
   if (ticks > 0)
     {
       struct timespec ts;
@@ -427,6 +456,7 @@ static void nxsched_timer_start(unsigned int ticks)
       clock_timespec_add(&g_stop_time, &ts, &ts);
       ret = up_alarm_start(&ts);
 
+      g_timer_deadline = ts;
 #else
       /* Save new timer interval */
 
@@ -435,6 +465,9 @@ static void nxsched_timer_start(unsigned int ticks)
       /* [Re-]start the interval timer */
 
       ret = up_timer_start(&ts);
+
+      up_timer_gettime(&g_timer_deadline);
+      clock_timespec_add(&g_timer_deadline, &ts, &g_timer_deadline);
 #endif
 
       if (ret < 0)
@@ -442,6 +475,10 @@ static void nxsched_timer_start(unsigned int ticks)
           serr("ERROR: up_timer_start/up_alarm_start failed: %d\n");
           UNUSED(ret);
         }
+      else
+        {
+          g_timer_active = true;
+        }
     }
 }
 
@@ -756,4 +793,48 @@ void nxsched_reassess_timer(void)
   nxsched_timer_start(nexttime);
 }
 
+/****************************************************************************
+ * Name:  nxsched_timer_remaining
+ *
+ * Description:
+ *   Return the time until the timer expires for the next watchdog or time
+ *   slice.  The IDLE loop, or the PM governor, uses this to predict how long
+ *   the CPU will stay idle if no interrupt occurs.
+ *
+ * Input Parameters:
+ *   ts - Location to return the remaining time
+ *
+ * Returned Value:
+ *   OK, or -ENOENT if no timer event is pending, in which case the idle
+ *   time is only ended by an interrupt.
+ *
+ ****************************************************************************/
+
+int nxsched_timer_remaining(FAR struct timespec *ts)
+{
+  struct timespec now;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = enter_critical_section();
+  if (g_timer_active)
+    {
+      up_timer_gettime(&now);
+      if (clock_timespec_compare(&g_timer_deadline, &now) > 0)
+        {
+          clock_timespec_subtract(&g_timer_deadline, &now, ts);
+        }
+      else
+        {
+          ts->tv_sec  = 0;
+          ts->tv_nsec = 0;
+        }
+
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
 #endif /* CONFIG_SCHED_TICKLESS */
@@ -166,7 +166,8 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
 
   /* Start the watchdog */
 
-  wd_start(&rtcb->waitdog, ticks, nxsem_timeout, getpid());
+  wd_start(&rtcb->waitdog, nxsched_slack_delay(rtcb, ticks),
+           nxsem_timeout, getpid());
 
   /* Now perform the blocking wait.  If nxsem_wait() fails, the
    * negated errno value will be returned below.
@@ -28,6 +28,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <nuttx/arch.h>
+#include <nuttx/mutex.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -44,6 +45,19 @@
 #  define CONFIG_SEM_PREALLOCHOLDERS 0
 #endif
 
+/* A mutex has exactly one holder container.  With pre-allocated holders it
+ * lives in the mutex_t that wraps the semaphore; otherwise the first of the
+ * two built-in containers is used.
+ */
+
+#define nxsem_is_mutex(s)   (((s)->flags & PRIOINHERIT_FLAGS_MUTEX) != 0)
+
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#  define nxsem_mutexholder(s) (&((FAR mutex_t *)(s))->holder)
+#else
+#  define nxsem_mutexholder(s) (&(s)->holder[0])
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -70,14 +84,29 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
 {
   FAR struct semholder_s *pholder;
 
+  /* A mutex owns its only container; it is free if the mutex is not held */
+
+  if (nxsem_is_mutex(sem))
+    {
+      pholder = nxsem_mutexholder(sem);
+      if (pholder->htcb == NULL)
+        {
+          pholder->counts = 0;
+        }
+      else
+        {
+          serr("ERROR: Mutex is already held\n");
+          pholder = NULL;
+        }
+    }
+
   /* Check if the "built-in" holder is being used.  We have this built-in
    * holder to optimize for the simplest case where semaphores are only
    * used to implement mutexes.
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder != NULL)
+  else if ((pholder = g_freeholders) != NULL)
     {
       /* Remove the holder from the free list an put it into the semaphore's
        * holder list
@@ -92,7 +121,7 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
       pholder->counts  = 0;
     }
 #else
-  if (sem->holder[0].htcb == NULL)
+  else if (sem->holder[0].htcb == NULL)
     {
       pholder          = &sem->holder[0];
       pholder->counts  = 0;
@@ -127,6 +156,14 @@ static FAR struct semholder_s *nxsem_findholder(sem_t *sem,
 {
   FAR struct semholder_s *pholder;
 
+  /* A mutex has only one holder to check */
+
+  if (nxsem_is_mutex(sem))
+    {
+      pholder = nxsem_mutexholder(sem);
+      return pholder->htcb == htcb ? pholder : NULL;
+    }
+
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   /* Try to find the holder in the list of holders associated with this
    * semaphore
@@ -198,6 +235,13 @@ static inline void nxsem_freeholder(sem_t *sem,
   pholder->counts = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+  /* The container of a mutex is not on any list */
+
+  if (nxsem_is_mutex(sem))
+    {
+      return;
+    }
+
   /* Search the list for the matching holder */
 
   for (prev = NULL, curr = sem->hhead;
@@ -256,7 +300,22 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *next;
+#endif
 
+  /* A mutex has at most one holder:  no list to walk */
+
+  if (nxsem_is_mutex(sem))
+    {
+      pholder = nxsem_mutexholder(sem);
+      if (pholder->htcb != NULL)
+        {
+          ret = handler(pholder, sem, arg);
+        }
+
+      return ret;
+    }
+
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
   for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
     {
       /* In case this holder gets deleted */
@@ -451,6 +510,18 @@ static int nxsem_verifyholder(FAR struct semholder_s *pholder,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsem_runningholder
+ ****************************************************************************/
+
+#if CONFIG_SEM_SPIN_BUDGET > 0
+static int nxsem_runningholder(FAR struct semholder_s *pholder,
+                               FAR sem_t *sem, FAR void *arg)
+{
+  return pholder->htcb->task_state == TSTATE_TASK_RUNNING ? 1 : 0;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsem_dumpholder
  ****************************************************************************/
@@ -898,6 +969,13 @@ void nxsem_destroyholder(FAR sem_t *sem)
    * any stranded holders and hope the task knows what it is doing.
    */
 
+  if (nxsem_is_mutex(sem))
+    {
+      nxsem_mutexholder(sem)->htcb   = NULL;
+      nxsem_mutexholder(sem)->counts = 0;
+      return;
+    }
+
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   if (sem->hhead != NULL)
     {
@@ -949,6 +1027,24 @@ void nxsem_add_holder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem)
 
   if ((sem->flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
     {
+      /* When sem_post() hands a mutex to a waiter, the only container still
+       * names the releasing thread, whose counts have already dropped to
+       * zero.  Undo any boost of the releaser now and free the container;
+       * otherwise the waiter could not be recorded and priority inheritance
+       * would be lost for as long as it holds the mutex.
+       */
+
+      if (nxsem_is_mutex(sem))
+        {
+          pholder = nxsem_mutexholder(sem);
+          if (pholder->htcb != NULL && pholder->htcb != htcb &&
+              pholder->counts <= 0)
+            {
+              nxsem_restoreholderprio(pholder->htcb, sem, htcb);
+              nxsem_freeholder(sem, pholder);
+            }
+        }
+
       /* Find or allocate a container for this new holder */
 
       pholder = nxsem_findorallocateholder(sem, htcb);
@@ -1164,6 +1260,32 @@ void sem_enumholders(FAR sem_t *sem)
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsem_holder_running
+ *
+ * Description:
+ *   Check if any holder of the semaphore is running on some CPU.  This is
+ *   used to decide if it is worth spinning on the semaphore instead of
+ *   blocking.
+ *
+ * Input Parameters:
+ *   sem - A reference to the semaphore
+ *
+ * Returned Value:
+ *   True if a holder is running
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SEM_SPIN_BUDGET > 0
+bool nxsem_holder_running(FAR sem_t *sem)
+{
+  return nxsem_foreachholder(sem, nxsem_runningholder, NULL) != 0;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsem_nfreeholders
  *
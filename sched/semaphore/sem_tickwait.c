@@ -120,7 +120,8 @@ int nxsem_tickwait(FAR sem_t *sem, clock_t start, uint32_t delay)
 
   /* Start the watchdog with interrupts still disabled */
 
-  wd_start(&rtcb->waitdog, delay, nxsem_timeout, getpid());
+  wd_start(&rtcb->waitdog, nxsched_slack_delay(rtcb, delay),
+           nxsem_timeout, getpid());
 
   /* Now perform the blocking wait */
 
@@ -31,10 +31,77 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched_note.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_spin
+ *
+ * Description:
+ *   Poll an unavailable semaphore for a short while with the critical
+ *   section released, hoping that its holder on another CPU releases it
+ *   soon.  Spinning is cheaper than blocking and being restarted if the
+ *   holder only keeps the semaphore for a short time.
+ *
+ * Input Parameters:
+ *   rtcb  - The TCB of the calling thread
+ *   sem   - The semaphore to poll
+ *   flags - The saved state of the critical section of the caller.  The
+ *           critical section is released and re-entered.
+ *
+ * Returned Value:
+ *   None.  The caller must check the semaphore count again.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SEM_SPIN_BUDGET > 0
+static void nxsem_spin(FAR struct tcb_s *rtcb, FAR sem_t *sem,
+                       FAR irqstate_t *flags)
+{
+  unsigned int nspins;
+
+  /* Don't spin if other threads are already waiting or if the critical
+   * section would not really be released.
+   */
+
+  if (sem->semcount != 0 || rtcb->irqcount != 1)
+    {
+      return;
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* Don't spin if we know that no holder is running */
+
+  if ((sem->flags & PRIOINHERIT_FLAGS_DISABLE) == 0 &&
+      !nxsem_holder_running(sem))
+    {
+      return;
+    }
+#endif
+
+  leave_critical_section(*flags);
+
+  for (nspins = 0;
+       nspins < CONFIG_SEM_SPIN_BUDGET && sem->semcount <= 0;
+       nspins++)
+    {
+      /* semcount is volatile; just poll it */
+    }
+
+  *flags = enter_critical_section();
+  sched_note_semspin(rtcb, sem, nspins, sem->semcount > 0);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -88,6 +155,15 @@ int nxsem_wait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+#if CONFIG_SEM_SPIN_BUDGET > 0
+      /* Spin briefly before committing to block */
+
+      if (sem->semcount <= 0)
+        {
+          nxsem_spin(rtcb, sem, &flags);
+        }
+#endif
+
       /* Check if the lock is available */
 
       if (sem->semcount > 0)
@@ -79,6 +79,9 @@ void nxsem_boost_priority(FAR sem_t *sem);
 void nxsem_release_holder(FAR sem_t *sem);
 void nxsem_restore_baseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
+#  if CONFIG_SEM_SPIN_BUDGET > 0
+bool nxsem_holder_running(FAR sem_t *sem);
+#  endif
 #else
 #  define nxsem_initialize_holders()
 #  define nxsem_destroyholder(sem)
@@ -51,6 +51,61 @@
 
 #ifdef CONFIG_SPINLOCK
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+/* Per-CPU spinlock contention counters */
+
+struct spinlock_stats_s g_spinlock_stats[SPINLOCK_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_acquire
+ *
+ * Description:
+ *   Loop until the spinlock is successfully locked.  After a failed
+ *   test-and-set, wait with plain reads until the lock looks free before
+ *   trying again.  The waiting CPUs then share the cache line holding the
+ *   lock instead of fighting over it with a stream of atomic writes.
+ *
+ ****************************************************************************/
+
+static inline void spin_acquire(FAR volatile spinlock_t *lock)
+{
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  FAR struct spinlock_stats_s *stats;
+  uint32_t nspins = 0;
+#endif
+
+  while (up_testset(lock) == SP_LOCKED)
+    {
+      do
+        {
+          SP_DSB();
+#ifdef CONFIG_SPINLOCK_STATISTICS
+          nspins++;
+#endif
+        }
+      while (*lock == SP_LOCKED);
+    }
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  stats = &g_spinlock_stats[this_cpu()];
+  stats->nlocks++;
+  if (nspins > 0)
+    {
+      stats->ncontended++;
+      stats->nspins += nspins;
+    }
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -86,10 +141,7 @@ void spin_lock(FAR volatile spinlock_t *lock)
   sched_note_spinlock(this_task(), lock);
 #endif
 
-  while (up_testset(lock) == SP_LOCKED)
-    {
-      SP_DSB();
-    }
+  spin_acquire(lock);
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
@@ -123,10 +175,7 @@ void spin_lock(FAR volatile spinlock_t *lock)
 
 void spin_lock_wo_note(FAR volatile spinlock_t *lock)
 {
-  while (up_testset(lock) == SP_LOCKED)
-    {
-      SP_DSB();
-    }
+  spin_acquire(lock);
 
   SP_DMB();
 }
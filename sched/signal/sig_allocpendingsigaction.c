@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <signal.h>
+#include <strings.h>
 #include <assert.h>
 
 #include <nuttx/irq.h>
@@ -55,15 +56,39 @@
  * Name: nxsig_alloc_pendingsigaction
  *
  * Description:
- *   Allocate a new element for the pending signal action queue
+ *   Allocate a new element for the pending signal action queue of stcb
  *
  ****************************************************************************/
 
-FAR sigq_t *nxsig_alloc_pendingsigaction(void)
+FAR sigq_t *nxsig_alloc_pendingsigaction(FAR struct tcb_s *stcb)
 {
   FAR sigq_t    *sigq;
   irqstate_t flags;
 
+#if CONFIG_SIG_TASK_SLOTS > 0
+  unsigned int freeslots;
+
+  /* Try the recipient's own slots first.  This works the same way from
+   * interrupt handlers and from threads.
+   */
+
+  flags     = enter_critical_section();
+  freeslots = ~stcb->sigslotbusy & ((1u << CONFIG_SIG_TASK_SLOTS) - 1);
+  if (freeslots != 0)
+    {
+      int slot = ffs((int)freeslots) - 1;
+
+      stcb->sigslotbusy |= 1u << slot;
+      leave_critical_section(flags);
+
+      sigq       = &stcb->sigslots[slot];
+      sigq->type = SIG_ALLOC_TCB;
+      return sigq;
+    }
+
+  leave_critical_section(flags);
+#endif
+
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
@@ -64,14 +64,14 @@ void nxsig_cleanup(FAR struct tcb_s *stcb)
 
   while ((sigq = (FAR sigq_t *)sq_remfirst(&stcb->sigpendactionq)) != NULL)
     {
-      nxsig_release_pendingsigaction(sigq);
+      nxsig_release_pendingsigaction(stcb, sigq);
     }
 
   /* Deallocate all entries in the list of posted signal actions */
 
   while ((sigq = (FAR sigq_t *)sq_remfirst(&stcb->sigpostedq)) != NULL)
     {
-      nxsig_release_pendingsigaction(sigq);
+      nxsig_release_pendingsigaction(stcb, sigq);
     }
 
   /* Misc. signal-related clean-up */
@@ -111,4 +111,6 @@ void nxsig_release(FAR struct task_group_s *group)
     {
       nxsig_release_pendingsignal(sigpend);
     }
+
+  group->tg_sigpendset = NULL_SIGNAL_SET;
 }
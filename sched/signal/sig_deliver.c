@@ -193,6 +193,6 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
 
       /* Then deallocate the signal structure */
 
-      nxsig_release_pendingsigaction(sigq);
+      nxsig_release_pendingsigaction(stcb, sigq);
     }
 }
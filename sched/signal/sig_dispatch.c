@@ -50,6 +50,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
 
 #include "sched/sched.h"
 #include "group/group.h"
@@ -97,9 +98,10 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
        * unable to allocate memory for the signal data.
        */
 
-      sigq = nxsig_alloc_pendingsigaction();
+      sigq = nxsig_alloc_pendingsigaction(stcb);
       if (!sigq)
         {
+          stcb->sigdropped++;
           ret = -ENOMEM;
         }
       else
@@ -208,6 +210,14 @@ static FAR sigpendq_t *
 
   flags = enter_critical_section();
 
+  /* The usual case, nothing pending for this signal, needs no search */
+
+  if (!nxsig_ismember(&group->tg_sigpendset, signo))
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
   /* Search the list for a action pending on this signal */
 
   for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
@@ -247,6 +257,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
       /* The signal is already pending... retain only one copy */
 
       memcpy(&sigpend->info, info, sizeof(siginfo_t));
+      stcb->sigoverrun++;
     }
 
   /* No... There is nothing pending in the group for this signo */
@@ -266,11 +277,25 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 
           flags = enter_critical_section();
           sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendingq);
+          nxsig_addset(&group->tg_sigpendset, info->si_signo);
           leave_critical_section(flags);
         }
+      else
+        {
+          stcb->sigdropped++;
+        }
     }
 
   DEBUGASSERT(sigpend);
+
+#ifdef CONFIG_SIGNAL_FD
+  /* Wake up any signalfd of the group that is polling for this signal */
+
+  if (sigpend != NULL)
+    {
+      signalfd_notify(group, info->si_signo);
+    }
+#endif
 }
 
 /****************************************************************************
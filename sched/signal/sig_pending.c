@@ -95,22 +95,12 @@ int sigpending(FAR sigset_t *set)
 sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
 {
   FAR struct task_group_s *group = stcb->group;
-  sigset_t sigpendset;
-  FAR sigpendq_t *sigpend;
-  irqstate_t flags;
 
   DEBUGASSERT(group);
 
-  sigpendset = NULL_SIGNAL_SET;
+  /* The set is maintained as signals are added to and removed from the
+   * group's pending signal list.
+   */
 
-  flags = enter_critical_section();
-  for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
-       (sigpend); sigpend = sigpend->flink)
-    {
-      nxsig_addset(&sigpendset, sigpend->info.si_signo);
-    }
-
-  leave_critical_section(flags);
-
-  return sigpendset;
+  return group->tg_sigpendset;
 }
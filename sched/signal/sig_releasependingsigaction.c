@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sched.h>
+#include <assert.h>
 
 #include <nuttx/irq.h>
 
@@ -57,14 +58,30 @@
  *
  ****************************************************************************/
 
-void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
+void nxsig_release_pendingsigaction(FAR struct tcb_s *stcb,
+                                    FAR sigq_t *sigq)
 {
   irqstate_t flags;
 
+#if CONFIG_SIG_TASK_SLOTS > 0
+  /* If this is one of the TCB's own slots, just mark it free */
+
+  if (sigq->type == SIG_ALLOC_TCB)
+    {
+      DEBUGASSERT(sigq >= stcb->sigslots &&
+                  sigq < &stcb->sigslots[CONFIG_SIG_TASK_SLOTS]);
+
+      flags = enter_critical_section();
+      stcb->sigslotbusy &= ~(1u << (sigq - stcb->sigslots));
+      leave_critical_section(flags);
+    }
+
   /* If this is a generally available pre-allocated structyre,
    * then just put it back in the free list.
    */
 
+  else
+#endif
   if (sigq->type == SIG_ALLOC_FIXED)
     {
       /* Make sure we avoid concurrent access to the free
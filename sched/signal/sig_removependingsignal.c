@@ -51,6 +51,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
 
 #include "signal/signal.h"
 
@@ -77,6 +78,14 @@ FAR sigpendq_t *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo)
 
   flags = enter_critical_section();
 
+  /* Nothing to search for if the signal is not pending */
+
+  if (!nxsig_ismember(&group->tg_sigpendset, signo))
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
   for (prevsig = NULL,
        currsig = (FAR sigpendq_t *)group->tg_sigpendingq.head;
        (currsig && currsig->info.si_signo != signo);
@@ -92,6 +101,10 @@ FAR sigpendq_t *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo)
         {
           sq_remfirst(&group->tg_sigpendingq);
         }
+
+      /* Only one entry is kept per signal number */
+
+      nxsig_delset(&group->tg_sigpendset, signo);
     }
 
   leave_critical_section(flags);
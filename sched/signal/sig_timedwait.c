@@ -324,10 +324,24 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
           waitticks = MSEC2TICK(waitmsec);
 #endif
 
-          /* Start the watchdog */
+#ifdef CONFIG_HRTIMER
+          /* Prefer the high-resolution timer so that short sleeps are not
+           * rounded up to whole ticks.  Fall back to the watchdog if no
+           * oneshot timer was provided for it.
+           */
+
+          if (hrtimer_start(&rtcb->waithrtimer,
+                            (uint64_t)timeout->tv_sec * NSEC_PER_SEC +
+                            timeout->tv_nsec,
+                            nxsig_timeout, (uintptr_t)rtcb) < 0)
+#endif
+            {
+              /* Start the watchdog */
 
-          wd_start(&rtcb->waitdog, waitticks,
-                   nxsig_timeout, (uintptr_t)rtcb);
+              wd_start(&rtcb->waitdog,
+                       nxsched_slack_delay(rtcb, waitticks),
+                       nxsig_timeout, (uintptr_t)rtcb);
+            }
 
           /* Now wait for either the signal or the watchdog, but
            * first, make sure this is not the idle task,
@@ -340,6 +354,9 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
           /* We no longer need the watchdog */
 
           wd_cancel(&rtcb->waitdog);
+#ifdef CONFIG_HRTIMER
+          hrtimer_cancel(&rtcb->waithrtimer);
+#endif
         }
 
       /* No timeout, just wait */
@@ -46,7 +46,24 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
+#include <nuttx/tls.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Cache the thread ID in the TLS at the base of the stack for the
+ * user-space mutex fast path.  The stack must already be allocated.
+ */
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#  define nxtask_setup_tlspid(tcb) \
+     (((FAR struct tls_info_s *)(tcb)->stack_alloc_ptr)->tl_pid = (tcb)->pid)
+#else
+#  define nxtask_setup_tlspid(tcb)
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -73,4 +90,36 @@ void nxtask_recover(FAR struct tcb_s *tcb);
 
 bool nxnotify_cancellation(FAR struct tcb_s *tcb);
 
+/* TCB and group allocation (from the preallocated pool if configured) */
+
+#ifdef CONFIG_SCHED_TASKPOOL
+FAR struct task_tcb_s *nxtask_tcballoc(int stack_size, FAR void **stack);
+bool nxtask_tcbpooled(FAR struct tcb_s *tcb);
+void nxtask_tcbfree(FAR struct tcb_s *tcb);
+FAR struct task_group_s *nxtask_groupalloc(void);
+void nxtask_groupfree(FAR struct task_group_s *group);
+#else
+#  define nxtask_tcballoc(s,p) \
+     (*(p) = NULL, \
+      (FAR struct task_tcb_s *)nxsched_alloc_tcb(sizeof(struct task_tcb_s)))
+#  define nxtask_tcbpooled(t)  false
+#  define nxtask_tcbfree(t)    nxsched_free_tcb(t)
+#  define nxtask_groupalloc()  nxtask_cachegroupalloc()
+#  define nxtask_groupfree(g)  nxtask_cachegroupfree(g)
+#endif
+
+/* Group allocation from the kernel object cache if configured, else from
+ * the heap.  See task_cache.c.
+ */
+
+#ifdef CONFIG_MM_SLAB
+void nxtask_cacheinitialize(void);
+FAR struct task_group_s *nxtask_cachegroupalloc(void);
+void nxtask_cachegroupfree(FAR struct task_group_s *group);
+#else
+#  define nxtask_cachegroupalloc() \
+     ((FAR struct task_group_s *)kmm_zalloc(sizeof(struct task_group_s)))
+#  define nxtask_cachegroupfree(g) kmm_free(g)
+#endif
+
 #endif /* __SCHED_TASK_TASK_H */
@@ -0,0 +1,137 @@
+/****************************************************************************
+ * sched/task/task_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/mm/slab.h>
+
+#include "task/task.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Objects per slab.  TCBs and groups are big, a slab of a few is plenty. */
+
+#define TASK_CACHE_NPERSLAB 4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One object of the TCB cache holds any type of TCB */
+
+union task_cachetcb_u
+{
+  struct task_tcb_s task;
+#ifndef CONFIG_DISABLE_PTHREAD
+  struct pthread_tcb_s pthread;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct kmem_cache_s *g_tcbcache;
+static FAR struct kmem_cache_s *g_groupcache;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxtask_cacheinitialize
+ *
+ * Description:
+ *   Create the TCB and task group caches.  Called once by nx_start() when
+ *   the kernel heap is available.
+ *
+ ****************************************************************************/
+
+void nxtask_cacheinitialize(void)
+{
+  g_tcbcache   = kmem_cache_create("tcb", sizeof(union task_cachetcb_u),
+                                   TASK_CACHE_NPERSLAB);
+  g_groupcache = kmem_cache_create("group", sizeof(struct task_group_s),
+                                   TASK_CACHE_NPERSLAB);
+
+  DEBUGASSERT(g_tcbcache != NULL && g_groupcache != NULL);
+}
+
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB from the TCB cache.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(size_t size)
+{
+  DEBUGASSERT(size <= sizeof(union task_cachetcb_u));
+  return kmem_cache_zalloc(g_tcbcache);
+}
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Return a TCB obtained from nxsched_alloc_tcb().
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR struct tcb_s *tcb)
+{
+  kmem_cache_free(g_tcbcache, tcb);
+}
+
+/****************************************************************************
+ * Name: nxtask_cachegroupalloc
+ *
+ * Description:
+ *   Allocate a zeroed task group from the group cache.
+ *
+ ****************************************************************************/
+
+FAR struct task_group_s *nxtask_cachegroupalloc(void)
+{
+  return kmem_cache_zalloc(g_groupcache);
+}
+
+/****************************************************************************
+ * Name: nxtask_cachegroupfree
+ ****************************************************************************/
+
+void nxtask_cachegroupfree(FAR struct task_group_s *group)
+{
+  kmem_cache_free(g_groupcache, group);
+}
+
+#endif /* CONFIG_MM_SLAB */
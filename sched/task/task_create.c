@@ -73,12 +73,13 @@ static int nxthread_create(FAR const char *name, uint8_t ttype,
                            FAR char * const argv[])
 {
   FAR struct task_tcb_s *tcb;
+  FAR void *stack;
   pid_t pid;
   int ret;
 
-  /* Allocate a TCB for the new task. */
+  /* Allocate a TCB for the new task (and maybe a stack from the pool) */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = nxtask_tcballoc(stack_size, &stack);
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -91,10 +92,17 @@ static int nxthread_create(FAR const char *name, uint8_t ttype,
 
   /* Initialize the task */
 
-  ret = nxtask_init(tcb, name, priority, NULL, stack_size, entry, argv);
+#ifdef CONFIG_SCHED_TASKPOOL
+  if (stack != NULL)
+    {
+      stack_size = CONFIG_SCHED_TASKPOOL_STACKSIZE;
+    }
+#endif
+
+  ret = nxtask_init(tcb, name, priority, stack, stack_size, entry, argv);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxtask_tcbfree(&tcb->cmn);
       return ret;
     }
 
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * sched/task/task_pool.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Preallocated task pool.  A fixed number of slots, each a task TCB with
+ * a stack of CONFIG_SCHED_TASKPOOL_STACKSIZE bytes, plus the same number
+ * of task groups, are reserved at build time.  Task creation takes a slot
+ * when the requested stack fits and one is free, and falls back to the
+ * heap otherwise, so creating and deleting a pooled task costs a bit scan
+ * instead of several heap operations.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+
+#include "task/task.h"
+
+#ifdef CONFIG_SCHED_TASKPOOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TASKPOOL_NSLOTS   CONFIG_SCHED_TASKPOOL_NSLOTS
+#define TASKPOOL_STACKLEN ((CONFIG_SCHED_TASKPOOL_STACKSIZE + 7) / 8)
+
+#if TASKPOOL_NSLOTS > 32
+#  error CONFIG_SCHED_TASKPOOL_NSLOTS must not exceed 32
+#endif
+
+#define TASKPOOL_ALLMASK  ((uint32_t)(((uint64_t)1 << TASKPOOL_NSLOTS) - 1))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct task_tcb_s g_pooltcb[TASKPOOL_NSLOTS];
+static uint64_t g_poolstack[TASKPOOL_NSLOTS][TASKPOOL_STACKLEN];
+static struct task_group_s g_poolgroup[TASKPOOL_NSLOTS];
+
+/* Bit n set means that slot n is in use */
+
+static uint32_t g_tcbinuse;
+static uint32_t g_groupinuse;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: taskpool_take
+ *
+ * Description:
+ *   Claim the lowest free slot in '*inuse'.  Returns the slot index or -1
+ *   if all slots are in use.
+ *
+ ****************************************************************************/
+
+static int taskpool_take(FAR uint32_t *inuse)
+{
+  irqstate_t flags;
+  uint32_t avail;
+  int slot = -1;
+
+  flags = enter_critical_section();
+  avail = ~*inuse & TASKPOOL_ALLMASK;
+  if (avail != 0)
+    {
+      slot = __builtin_ctz(avail);
+      *inuse |= (uint32_t)1 << slot;
+    }
+
+  leave_critical_section(flags);
+  return slot;
+}
+
+static void taskpool_give(FAR uint32_t *inuse, int slot)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  DEBUGASSERT((*inuse & ((uint32_t)1 << slot)) != 0);
+  *inuse &= ~((uint32_t)1 << slot);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxtask_tcballoc
+ *
+ * Description:
+ *   Allocate a zeroed task TCB.  If 'stack_size' fits in a pool stack and
+ *   a slot is free, the TCB comes from the pool and '*stack' is set to the
+ *   slot's stack (to be passed to nxtask_init()).  Otherwise the TCB is
+ *   allocated from the heap and '*stack' is set to NULL.
+ *
+ ****************************************************************************/
+
+FAR struct task_tcb_s *nxtask_tcballoc(int stack_size, FAR void **stack)
+{
+  int slot;
+
+  *stack = NULL;
+
+  if (stack_size <= CONFIG_SCHED_TASKPOOL_STACKSIZE &&
+      (slot = taskpool_take(&g_tcbinuse)) >= 0)
+    {
+      memset(&g_pooltcb[slot], 0, sizeof(struct task_tcb_s));
+      *stack = g_poolstack[slot];
+      return &g_pooltcb[slot];
+    }
+
+  return (FAR struct task_tcb_s *)
+         nxsched_alloc_tcb(sizeof(struct task_tcb_s));
+}
+
+/****************************************************************************
+ * Name: nxtask_tcbpooled
+ *
+ * Description:
+ *   Return true if 'tcb' (and its stack) belongs to the pool.
+ *
+ ****************************************************************************/
+
+bool nxtask_tcbpooled(FAR struct tcb_s *tcb)
+{
+  return (uintptr_t)tcb >= (uintptr_t)&g_pooltcb[0] &&
+         (uintptr_t)tcb < (uintptr_t)&g_pooltcb[TASKPOOL_NSLOTS];
+}
+
+/****************************************************************************
+ * Name: nxtask_tcbfree
+ *
+ * Description:
+ *   Return a TCB obtained from nxtask_tcballoc() (or nxsched_alloc_tcb()).
+ *
+ ****************************************************************************/
+
+void nxtask_tcbfree(FAR struct tcb_s *tcb)
+{
+  if (nxtask_tcbpooled(tcb))
+    {
+      taskpool_give(&g_tcbinuse,
+                    (FAR struct task_tcb_s *)tcb - g_pooltcb);
+    }
+  else
+    {
+      nxsched_free_tcb(tcb);
+    }
+}
+
+/****************************************************************************
+ * Name: nxtask_groupalloc
+ *
+ * Description:
+ *   Allocate a zeroed task group, from the pool if possible.
+ *
+ ****************************************************************************/
+
+FAR struct task_group_s *nxtask_groupalloc(void)
+{
+  int slot = taskpool_take(&g_groupinuse);
+
+  if (slot >= 0)
+    {
+      memset(&g_poolgroup[slot], 0, sizeof(struct task_group_s));
+      return &g_poolgroup[slot];
+    }
+
+  return nxtask_cachegroupalloc();
+}
+
+/****************************************************************************
+ * Name: nxtask_groupfree
+ ****************************************************************************/
+
+void nxtask_groupfree(FAR struct task_group_s *group)
+{
+  if (group >= &g_poolgroup[0] && group < &g_poolgroup[TASKPOOL_NSLOTS])
+    {
+      taskpool_give(&g_groupinuse, group - g_poolgroup);
+    }
+  else
+    {
+      nxtask_cachegroupfree(group);
+    }
+}
+
+#endif /* CONFIG_SCHED_TASKPOOL */
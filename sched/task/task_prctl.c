@@ -41,6 +41,7 @@
 
 #include <sys/prctl.h>
 #include <stdarg.h>
+#include <limits.h>
 #include <string.h>
 #include <errno.h>
 #include <debug.h>
@@ -65,6 +66,7 @@
  * Returned Value:
  *   The returned value may depend on the specific command.  For PR_SET_NAME
  *   and PR_GET_NAME, the returned value of 0 indicates successful operation.
+ *   PR_GET_TIMERSLACK returns the timer slack in nanoseconds.
  *   On any failure, -1 is retruend and the errno value is set appropriately.
  *
  *     EINVAL The value of 'option' is not recognized.
@@ -161,6 +163,34 @@ int prctl(int option, ...)
         goto errout;
 #endif
 
+      case PR_SET_TIMERSLACK:
+      case PR_GET_TIMERSLACK:
+#ifdef CONFIG_SCHED_TICKLESS_SLACK
+        {
+          FAR struct tcb_s *rtcb = this_task();
+          uint64_t nsecs;
+
+          if (option == PR_SET_TIMERSLACK)
+            {
+              /* Zero restores the default slack */
+
+              nsecs = va_arg(ap, unsigned long);
+              rtcb->timerslack = nsecs == 0 ? TIMER_SLACK_DEFAULT :
+                                 (uint32_t)NSEC2TICK(nsecs);
+              va_end(ap);
+              return OK;
+            }
+
+          nsecs = TICK2NSEC((uint64_t)rtcb->timerslack);
+          va_end(ap);
+          return nsecs > INT_MAX ? INT_MAX : (int)nsecs;
+        }
+#else
+        serr("ERROR: Option not enabled: %d\n", option);
+        errcode = ENOSYS;
+        goto errout;
+#endif
+
       default:
         serr("ERROR: Unrecognized option: %d\n", option);
         errcode = EINVAL;
@@ -100,4 +100,14 @@ void nxtask_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(nxsched_stop_sporadic(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Stop current deadline scheduling and release its bandwidth */
+
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+      tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+    }
+#endif
 }
@@ -139,7 +139,17 @@ int task_restart(pid_t pid)
   tasklist = TLIST_HEAD(tcb->cmn.task_state);
 #endif
 
-  dq_rem((FAR dq_entry_t *)tcb, tasklist);
+#if defined(CONFIG_SCHED_READYINDEX)
+  if (tasklist == (FAR dq_queue_t *)&g_readytorun)
+    {
+      nxsched_remove_indexed((FAR struct tcb_s *)tcb);
+    }
+  else
+#endif
+    {
+      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+    }
+
   tcb->cmn.task_state = TSTATE_TASK_INVALID;
 
   /* Deallocate anything left in the TCB's signal queues */
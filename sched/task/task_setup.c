@@ -34,6 +34,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/signal.h>
+#include <nuttx/tls.h>
 
 #include "sched/sched.h"
 #include "pthread/pthread.h"
@@ -166,6 +167,30 @@ static inline void nxtask_inherit_affinity(FAR struct tcb_s *tcb)
 #  define nxtask_inherit_affinity(tcb)
 #endif
 
+/****************************************************************************
+ * Name: nxtask_inherit_timerslack
+ *
+ * Description:
+ *   All new tasks and threads inherit the timer slack of the parent thread.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the new task.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS_SLACK
+static inline void nxtask_inherit_timerslack(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  tcb->timerslack = rtcb->timerslack;
+}
+#else
+#  define nxtask_inherit_timerslack(tcb)
+#endif
+
 /****************************************************************************
  * Name: nxtask_save_parent
  *
@@ -360,6 +385,15 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
       tcb->start          = start;
       tcb->entry.main     = (main_t)entry;
 
+      /* Cache the thread ID in the TLS.  The stack of a vfork() child is
+       * only allocated later by up_vfork(); nxtask_start_vfork() sets it.
+       */
+
+      if (tcb->stack_alloc_ptr != NULL)
+        {
+          nxtask_setup_tlspid(tcb);
+        }
+
       /* Save the thread type.  This setting will be needed in
        * up_initial_state() is called.
        */
@@ -391,6 +425,10 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
       nxtask_inherit_affinity(tcb);
 #endif
 
+      /* The timer slack is inherited from the parent thread as well */
+
+      nxtask_inherit_timerslack(tcb);
+
       /* exec(), pthread_create(), task_create(), and vfork() all
        * inherit the signal mask of the parent thread.
        */
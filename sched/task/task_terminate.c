@@ -157,7 +157,17 @@ int nxtask_terminate(pid_t pid, bool nonblocking)
 
   /* Remove the task from the task list */
 
-  dq_rem((FAR dq_entry_t *)dtcb, tasklist);
+#if defined(CONFIG_SCHED_READYINDEX)
+  if (tasklist == (FAR dq_queue_t *)&g_readytorun)
+    {
+      nxsched_remove_indexed((FAR struct tcb_s *)dtcb);
+    }
+  else
+#endif
+    {
+      dq_rem((FAR dq_entry_t *)dtcb, tasklist);
+    }
+
   dtcb->task_state = TSTATE_TASK_INVALID;
 
   /* At this point, the TCB should no longer be accessible to the system */
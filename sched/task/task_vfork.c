@@ -293,7 +293,8 @@ FAR struct task_tcb_s *nxtask_setup_vfork(start_t retaddr, size_t *argsize)
 
   /* Allocate a TCB for the child task. */
 
-  child = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  child = (FAR struct task_tcb_s *)
+          nxsched_alloc_tcb(sizeof(struct task_tcb_s));
   if (!child)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -420,6 +421,10 @@ pid_t nxtask_start_vfork(FAR struct task_tcb_s *child)
       return ERROR;
     }
 
+  /* up_vfork() has allocated the stack now, so its TLS can hold the pid */
+
+  nxtask_setup_tlspid((FAR struct tcb_s *)child);
+
   /* Get the assigned pid before we start the task */
 
   pid = (int)child->cmn.pid;
@@ -31,14 +31,17 @@
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 #define PT_FLAGS_PREALLOCATED 0x01 /* Timer comes from a pool of preallocated timers */
+#define PT_FLAGS_HRTIMER      0x02 /* Armed on pt_hrtimer rather than pt_wdog */
 
 /****************************************************************************
  * Public Types
@@ -56,10 +59,31 @@ struct posix_timer_s
   int              pt_delay;       /* If non-zero, used to reset repetitive timers */
   int              pt_last;        /* Last value used to set watchdog */
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s pt_hrtimer;     /* Or the high-resolution timer */
+  uint64_t         pt_interval;    /* Repetitive interval of pt_hrtimer (ns) */
+#endif
   struct sigevent  pt_event;       /* Notification information */
   struct sigwork_s pt_work;
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static inline uint64_t timer_time2ns(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static inline void timer_ns2time(uint64_t ns, FAR struct timespec *ts)
+{
+  ts->tv_sec  = (time_t)(ns / NSEC_PER_SEC);
+  ts->tv_nsec = (long)(ns % NSEC_PER_SEC);
+}
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -122,6 +122,9 @@ int timer_release(FAR struct posix_timer_s *timer)
   /* Cancel the underlying watchdog instance */
 
   wd_cancel(&timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#endif
 
   /* Cancel any pending notification */
 
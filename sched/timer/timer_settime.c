@@ -44,6 +44,10 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer);
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer);
 static void timer_timeout(wdparm_t itimer);
+#ifdef CONFIG_HRTIMER
+static int timer_hrstart(FAR struct posix_timer_s *timer, int flags,
+                         FAR const struct itimerspec *value);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -93,6 +97,35 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer)
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer)
 {
+#ifdef CONFIG_HRTIMER
+  if ((timer->pt_flags & PT_FLAGS_HRTIMER) != 0)
+    {
+      uint64_t expire;
+      uint64_t now;
+
+      if (timer->pt_interval == 0)
+        {
+          return;
+        }
+
+      /* Advance from the previous expiration, not from now, so that the
+       * period does not drift.  Skip whole periods that have already
+       * passed rather than firing them back to back.
+       */
+
+      expire = timer->pt_hrtimer.expire + timer->pt_interval;
+      now    = hrtimer_gettime();
+      if (expire <= now)
+        {
+          expire += ((now - expire) / timer->pt_interval + 1) *
+                    timer->pt_interval;
+        }
+
+      hrtimer_start_abs(&timer->pt_hrtimer, expire, timer_timeout, itimer);
+      return;
+    }
+#endif
+
   /* If this is a repetitive timer, then restart the watchdog */
 
   if (timer->pt_delay)
@@ -144,6 +177,75 @@ static void timer_timeout(wdparm_t itimer)
     }
 }
 
+/****************************************************************************
+ * Name: timer_hrstart
+ *
+ * Description:
+ *   Arm the timer on the high-resolution timer instead of a watchdog so
+ *   that it is not rounded to the system tick.
+ *
+ * Input Parameters:
+ *   timer - The POSIX timer to arm
+ *   flags - TIMER_ABSTIME or zero
+ *   value - The expiration and reload values
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if there is no high-resolution timer, in
+ *   which case the caller falls back to a watchdog.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int timer_hrstart(FAR struct posix_timer_s *timer, int flags,
+                         FAR const struct itimerspec *value)
+{
+  struct timespec ts;
+  irqstate_t intflags;
+  uint64_t expire;
+  uint64_t now;
+  int ret;
+
+  if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
+    {
+      timer->pt_interval = timer_time2ns(&value->it_interval);
+    }
+  else
+    {
+      timer->pt_interval = 0;
+    }
+
+  intflags = enter_critical_section();
+
+  now    = hrtimer_gettime();
+  expire = timer_time2ns(&value->it_value);
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      /* Translate the CLOCK_REALTIME deadline to the hrtimer clock.  A
+       * deadline in the past expires immediately.
+       */
+
+      clock_gettime(CLOCK_REALTIME, &ts);
+      expire = expire > timer_time2ns(&ts) ?
+               now + (expire - timer_time2ns(&ts)) : now;
+    }
+  else
+    {
+      expire += now;
+    }
+
+  ret = hrtimer_start_abs(&timer->pt_hrtimer, expire,
+                          timer_timeout, (wdparm_t)timer);
+  if (ret >= 0)
+    {
+      timer->pt_flags |= PT_FLAGS_HRTIMER;
+    }
+
+  leave_critical_section(intflags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -229,6 +331,15 @@ int timer_settime(timer_t timerid, int flags,
       return ERROR;
     }
 
+#ifdef CONFIG_HRTIMER
+  if (ovalue && (timer->pt_flags & PT_FLAGS_HRTIMER) != 0)
+    {
+      timer_ns2time(hrtimer_remaining(&timer->pt_hrtimer),
+                    &ovalue->it_value);
+      timer_ns2time(timer->pt_interval, &ovalue->it_interval);
+    }
+  else
+#endif
   if (ovalue)
     {
       /* Get the number of ticks before the underlying watchdog expires */
@@ -246,6 +357,10 @@ int timer_settime(timer_t timerid, int flags,
    */
 
   wd_cancel(&timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+  timer->pt_flags &= ~PT_FLAGS_HRTIMER;
+#endif
 
   /* Cancel any pending notification */
 
@@ -260,6 +375,18 @@ int timer_settime(timer_t timerid, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Use the high-resolution timer if one has been provided */
+
+  ret = timer_hrstart(timer, flags, value);
+  if (ret != -ENODEV)
+    {
+      return OK;
+    }
+
+  ret = OK;
+#endif
+
   /* Setup up any repetitive timer */
 
   if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
@@ -37,7 +37,22 @@
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_WHEEL
 sq_queue_t g_wdactivelist;
+#else
+/* The timer wheel.  Watchdog timers are hashed into the slot selected by
+ * the low order bits of their absolute expiration time.  Each slot is a
+ * doubly linked list in the order in which the watchdogs were started.  A
+ * slot may also hold watchdogs that expire one or more full rotations
+ * later; those are skipped until their time comes.
+ */
+
+dq_queue_t g_wdwheel[CONFIG_WDOG_WHEEL_SIZE];
+
+/* The time (in ticks) up to which the wheel has been processed */
+
+clock_t g_wdcurrent;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -72,7 +87,20 @@ clock_t g_wdtickbase;
 
 void wd_initialize(void)
 {
+#ifdef CONFIG_WDOG_WHEEL
+  int i;
+
+  /* Initialize the timer wheel */
+
+  for (i = 0; i < CONFIG_WDOG_WHEEL_SIZE; i++)
+    {
+      dq_init(&g_wdwheel[i]);
+    }
+
+  g_wdcurrent = 0;
+#else
   /* Initialize watchdog lists */
 
   sq_init(&g_wdactivelist);
+#endif
 }
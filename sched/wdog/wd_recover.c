@@ -64,4 +64,7 @@ void wd_recover(FAR struct tcb_s *tcb)
    */
 
   wd_cancel(&tcb->waitdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&tcb->waithrtimer);
+#endif
 }
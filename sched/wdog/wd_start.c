@@ -149,8 +149,8 @@ static inline void wd_expiration(void)
  *
  ****************************************************************************/
 
-int wd_start(FAR struct wdog_s *wdog, int32_t delay,
-             wdentry_t wdentry, wdparm_t arg)
+int locate_fast wd_start(FAR struct wdog_s *wdog, int32_t delay,
+                         wdentry_t wdentry, wdparm_t arg)
 {
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
@@ -338,7 +338,7 @@ int wd_start(FAR struct wdog_s *wdog, int32_t delay,
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_TICKLESS
-unsigned int wd_timer(int ticks)
+unsigned int locate_fast wd_timer(int ticks)
 {
   FAR struct wdog_s *wdog;
 #ifdef CONFIG_SMP
@@ -410,7 +410,7 @@ unsigned int wd_timer(int ticks)
 }
 
 #else
-void wd_timer(void)
+void locate_fast wd_timer(void)
 {
 #ifdef CONFIG_SMP
   irqstate_t flags;
@@ -0,0 +1,499 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WDOG_WHEEL_MASK     (CONFIG_WDOG_WHEEL_SIZE - 1)
+
+#if (CONFIG_WDOG_WHEEL_SIZE & WDOG_WHEEL_MASK) != 0
+#  error CONFIG_WDOG_WHEEL_SIZE must be a power of two
+#endif
+
+/* The slot that holds the watchdogs expiring at time 't' */
+
+#define WDOG_SLOT(t)        (&g_wdwheel[(t) & WDOG_WHEEL_MASK])
+
+/* The signed number of ticks from 'now' until 'w' expires */
+
+#define WDOG_REMAINING(w,now) ((sclock_t)((w)->expire - (now)))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of active watchdogs */
+
+static unsigned int g_wdnactive;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_remove
+ *
+ * Description:
+ *   Remove an active watchdog from its slot and mark it inactive.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static inline void wd_remove(FAR struct wdog_s *wdog)
+{
+  dq_rem((FAR dq_entry_t *)wdog, WDOG_SLOT(wdog->expire));
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+  WDOG_CLRACTIVE(wdog);
+  g_wdnactive--;
+}
+
+/****************************************************************************
+ * Name: wd_expireslot
+ *
+ * Description:
+ *   Execute every watchdog in 'slot' that has expired at time 'now'.
+ *   Watchdogs are taken one at a time since the callbacks may start or
+ *   cancel any other watchdog, including those in this same slot.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static void wd_expireslot(FAR dq_queue_t *slot, clock_t now)
+{
+  FAR struct wdog_s *wdog;
+
+  for (; ; )
+    {
+      wdog = (FAR struct wdog_s *)slot->head;
+      while (wdog != NULL && WDOG_REMAINING(wdog, now) > 0)
+        {
+          wdog = wdog->next;
+        }
+
+      if (wdog == NULL)
+        {
+          break;
+        }
+
+      wd_remove(wdog);
+
+      /* Execute the watchdog function */
+
+      up_setpicbase(wdog->picbase);
+      wdog->func(wdog->arg);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_advance
+ *
+ * Description:
+ *   Advance the wheel by 'ticks', executing the watchdogs that expire in
+ *   that interval in the order of their expiration time.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static void wd_advance(clock_t ticks)
+{
+  clock_t target = g_wdcurrent + ticks;
+  int i;
+
+  if (ticks > CONFIG_WDOG_WHEEL_SIZE)
+    {
+      /* More than one rotation has passed.  This does not normally happen
+       * because the interval timer never runs past the next expiration.
+       * Anything that is overdue by more than a rotation runs now, in slot
+       * order rather than in strict expiration order.
+       */
+
+      g_wdcurrent = target - CONFIG_WDOG_WHEEL_SIZE;
+      for (i = 0; i < CONFIG_WDOG_WHEEL_SIZE && g_wdnactive > 0; i++)
+        {
+          wd_expireslot(&g_wdwheel[i], g_wdcurrent);
+        }
+    }
+
+  /* Visit the slot of each tick in the interval.  A callback that restarts
+   * the timer from the tickless path may move the wheel on by itself.
+   */
+
+  while ((sclock_t)(target - g_wdcurrent) > 0)
+    {
+      if (g_wdnactive == 0)
+        {
+          g_wdcurrent = target;
+          break;
+        }
+
+      g_wdcurrent++;
+      wd_expireslot(WDOG_SLOT(g_wdcurrent), g_wdcurrent);
+    }
+}
+
+#ifdef CONFIG_SCHED_TICKLESS
+/****************************************************************************
+ * Name: wd_nextexpiration
+ *
+ * Description:
+ *   Return the number of ticks until the next watchdog expires, or zero if
+ *   there are no active watchdogs.  The wheel is searched one rotation
+ *   ahead; watchdogs further in the future require a full scan, which only
+ *   happens when no watchdog expires within the next rotation.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static unsigned int wd_nextexpiration(void)
+{
+  FAR struct wdog_s *wdog;
+  FAR dq_queue_t *slot;
+  sclock_t remaining;
+  sclock_t next = INT32_MAX;
+  int i;
+
+  if (g_wdnactive == 0)
+    {
+      return 0;
+    }
+
+  for (i = 1; i <= CONFIG_WDOG_WHEEL_SIZE; i++)
+    {
+      slot = WDOG_SLOT(g_wdcurrent + i);
+      for (wdog = (FAR struct wdog_s *)slot->head;
+           wdog != NULL;
+           wdog = wdog->next)
+        {
+          remaining = WDOG_REMAINING(wdog, g_wdcurrent);
+          if (remaining <= i)
+            {
+              /* Due in this rotation.  This is the earliest. */
+
+              return remaining > 0 ? remaining : 1;
+            }
+
+          if (remaining < next)
+            {
+              next = remaining;
+            }
+        }
+    }
+
+  return next;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_start
+ *
+ * Description:
+ *   This function adds a watchdog timer to the active timer queue.  The
+ *   specified watchdog function at 'wdentry' will be called from the
+ *   interrupt level after the specified number of ticks has elapsed.
+ *   Watchdog timers may be started from the interrupt level.
+ *
+ *   Watchdog timers execute in the address environment that was in effect
+ *   when wd_start() is called.
+ *
+ *   Watchdog timers execute only once.
+ *
+ *   To replace either the timeout delay or the function to be executed,
+ *   call wd_start again with the same wdog; only the most recent wdStart()
+ *   on a given watchdog ID has any effect.
+ *
+ *   With the timer wheel, this is a constant time operation.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *
+ *   NOTE:  The parameter must be of type wdparm_t.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ * Assumptions:
+ *   The watchdog routine runs in the context of the timer interrupt handler
+ *   and is subject to all ISR restrictions.
+ *
+ ****************************************************************************/
+
+int wd_start(FAR struct wdog_s *wdog, int32_t delay,
+             wdentry_t wdentry, wdparm_t arg)
+{
+  irqstate_t flags;
+
+  /* Verify the wdog and setup parameters */
+
+  if (wdog == NULL || delay < 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (WDOG_ISACTIVE(wdog))
+    {
+      wd_remove(wdog);
+    }
+
+  /* Save the data in the watchdog structure */
+
+  wdog->func = wdentry;         /* Function to execute when delay expires */
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+
+  /* Calculate delay+1, forcing the delay into a range that we can handle */
+
+  if (delay <= 0)
+    {
+      delay = 1;
+    }
+  else if (++delay <= 0)
+    {
+      delay--;
+    }
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Cancel the interval timer that drives the timing events.  This will
+   * cause wd_timer to be called which brings the wheel up to the current
+   * time.
+   */
+
+  nxsched_cancel_timer();
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* If nothing is pending, the wheel may lag behind the system time */
+
+  if (g_wdnactive == 0)
+    {
+      g_wdcurrent  = clock_systime_ticks();
+      g_wdtickbase = g_wdcurrent;
+    }
+#endif
+
+  /* Hash the watchdog into the slot of its expiration time */
+
+  wdog->expire = g_wdcurrent + delay;
+  dq_addlast((FAR dq_entry_t *)wdog, WDOG_SLOT(wdog->expire));
+  g_wdnactive++;
+  WDOG_SETACTIVE(wdog);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Resume the interval timer that will generate the next interval event.
+   * If this watchdog is now the earliest, then this will pick its delay.
+   */
+
+  nxsched_resume_timer();
+#endif
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wd_cancel
+ *
+ * Description:
+ *   This function cancels a currently running watchdog timer. Watchdog
+ *   timers may be canceled from the interrupt level.  With the timer wheel,
+ *   this is a constant time operation.
+ *
+ * Input Parameters:
+ *   wdog - ID of the watchdog to cancel.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success;  A negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int wd_cancel(FAR struct wdog_s *wdog)
+{
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  flags = enter_critical_section();
+
+  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+    {
+      wd_remove(wdog);
+
+      /* Reassess the interval timer that will generate the next interval
+       * event.
+       */
+
+      nxsched_reassess_timer();
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: wd_gettime
+ *
+ * Description:
+ *   This function returns the time remaining before the specified watchdog
+ *   timer expires.
+ *
+ * Input Parameters:
+ *   wdog - watchdog ID
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the watchdog time expires.
+ *   Zero means either that wdog is not valid or that the wdog has already
+ *   expired.
+ *
+ ****************************************************************************/
+
+int wd_gettime(FAR struct wdog_s *wdog)
+{
+  irqstate_t flags;
+  int delay = 0;
+
+  flags = enter_critical_section();
+  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+    {
+      delay = WDOG_REMAINING(wdog, g_wdcurrent) - wd_elapse();
+    }
+
+  leave_critical_section(flags);
+  return delay;
+}
+
+/****************************************************************************
+ * Name: wd_timer
+ *
+ * Description:
+ *   This function is called from the timer interrupt handler to determine
+ *   if it is time to execute a watchdog function.  If so, the watchdog
+ *   function will be executed in the context of the timer interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   ticks - If CONFIG_SCHED_TICKLESS is defined then the number of ticks
+ *     in the interval that just expired is provided.  Otherwise,
+ *     this function is called on each timer interrupt and a value of one
+ *     is implicit.
+ *
+ * Returned Value:
+ *   If CONFIG_SCHED_TICKLESS is defined then the number of ticks for the
+ *   next delay is provided (zero if no delay).  Otherwise, this function
+ *   has no returned value.
+ *
+ * Assumptions:
+ *   Called from interrupt handler logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_timer(int ticks)
+#else
+void wd_timer(void)
+#endif
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
+#ifdef CONFIG_SCHED_TICKLESS
+  unsigned int ret;
+#endif
+
+#ifdef CONFIG_SMP
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS
+  if (ticks > 0)
+    {
+      wd_advance(ticks);
+    }
+
+  g_wdtickbase = g_wdcurrent;
+
+  /* Return the delay for the next watchdog to expire */
+
+  ret = wd_nextexpiration();
+#else
+  wd_advance(1);
+#endif
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS
+  return ret;
+#endif
+}
+
+#endif /* CONFIG_WDOG_WHEEL */
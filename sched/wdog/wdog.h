@@ -70,9 +70,22 @@ extern "C"
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
+ *
+ * With CONFIG_WDOG_WHEEL, the active watchdogs are instead hashed into the
+ * slots of g_wdwheel[] by their absolute expiration time.
  */
 
+#ifdef CONFIG_WDOG_WHEEL
+extern dq_queue_t g_wdwheel[CONFIG_WDOG_WHEEL_SIZE];
+#else
 extern sq_queue_t g_wdactivelist;
+#endif
+
+/* This is the time up to which the timer wheel has been processed */
+
+#ifdef CONFIG_WDOG_WHEEL
+extern clock_t g_wdcurrent;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
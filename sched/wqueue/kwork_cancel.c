@@ -129,7 +129,13 @@ int work_cancel(int qid, FAR struct work_s *work)
     {
       /* Cancel high priority work */
 
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, work);
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      return work_qcancel((FAR struct kwork_wqueue_s *)
+                          &g_hpwork[work->cpu], work);
+#else
+      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork[0],
+                          work);
+#endif
     }
   else
 #endif
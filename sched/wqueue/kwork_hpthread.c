@@ -36,6 +36,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/clock.h>
 
+#include "sched/sched.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_HPWORK
@@ -46,7 +47,7 @@
 
 /* The state of the kernel mode, high priority work queue(s). */
 
-struct hp_wqueue_s g_hpwork;
+struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 
 /****************************************************************************
  * Private Functions
@@ -76,23 +77,32 @@ struct hp_wqueue_s g_hpwork;
 
 static int work_hpthread(int argc, char *argv[])
 {
+  FAR struct kwork_wqueue_s *wqueue =
+    (FAR struct kwork_wqueue_s *)&g_hpwork[0];
   int wndx = 0;
-#if CONFIG_SCHED_HPNTHREADS > 1
+#if CONFIG_SCHED_HPNTHREADS > 1 || HPWORK_NQUEUES > 1
   pid_t me = getpid();
+  int qndx;
   int i;
 
-  /* Find out thread index by search the workers in g_hpwork */
+  /* Find out queue and thread index by search the workers in g_hpwork */
 
-  for (wndx = 0, i = 0; i < CONFIG_SCHED_HPNTHREADS; i++)
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
     {
-      if (g_hpwork.worker[i].pid == me)
+      for (i = 0; i < CONFIG_SCHED_HPNTHREADS; i++)
         {
-          wndx = i;
-          break;
+          if (g_hpwork[qndx].worker[i].pid == me)
+            {
+              wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork[qndx];
+              wndx = i;
+              goto found;
+            }
         }
     }
 
-  DEBUGASSERT(i < CONFIG_SCHED_HPNTHREADS);
+  DEBUGPANIC();
+
+found:
 #endif
 
   /* Loop forever */
@@ -104,7 +114,7 @@ static int work_hpthread(int argc, char *argv[])
        * triggered, or delayed work expires.
        */
 
-      work_process((FAR struct kwork_wqueue_s *)&g_hpwork, wndx);
+      work_process(wqueue, wndx);
     }
 
   return OK; /* To keep some compilers happy */
@@ -131,7 +141,11 @@ static int work_hpthread(int argc, char *argv[])
 
 int work_start_highpri(void)
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  cpu_set_t cpuset;
+#endif
   pid_t pid;
+  int qndx;
   int wndx;
 
   /* Don't permit any of the threads to run until we have fully initialized
@@ -144,27 +158,58 @@ int work_start_highpri(void)
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
-  for (wndx = 0; wndx < CONFIG_SCHED_HPNTHREADS; wndx++)
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
     {
-      pid = kthread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
-                           CONFIG_SCHED_HPWORKSTACKSIZE,
-                           (main_t)work_hpthread,
-                           (FAR char * const *)NULL);
-
-      DEBUGASSERT(pid > 0);
-      if (pid < 0)
+      for (wndx = 0; wndx < CONFIG_SCHED_HPNTHREADS; wndx++)
         {
-          serr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
-          sched_unlock();
-          return (int)pid;
-        }
+          pid = kthread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                               CONFIG_SCHED_HPWORKSTACKSIZE,
+                               (main_t)work_hpthread,
+                               (FAR char * const *)NULL);
+
+          DEBUGASSERT(pid > 0);
+          if (pid < 0)
+            {
+              serr("ERROR: kthread_create %d failed: %d\n",
+                   wndx, (int)pid);
+              sched_unlock();
+              return (int)pid;
+            }
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+          /* Bind the worker to the CPU whose queue it serves */
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(qndx, &cpuset);
+          nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+#endif
 
-      g_hpwork.worker[wndx].pid  = pid;
-      g_hpwork.worker[wndx].busy = true;
+          g_hpwork[qndx].worker[wndx].pid  = pid;
+          g_hpwork[qndx].worker[wndx].busy = true;
+        }
     }
 
   sched_unlock();
-  return g_hpwork.worker[0].pid;
+  return g_hpwork[0].worker[0].pid;
+}
+
+/****************************************************************************
+ * Name: work_hpqueue
+ *
+ * Description:
+ *   Return the high priority work queue used by the calling CPU.  With
+ *   CONFIG_SCHED_HPWORK_PERCPU this must be called with interrupts
+ *   disabled so that the caller cannot migrate to another CPU.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_hpqueue(void)
+{
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  return (FAR struct kwork_wqueue_s *)&g_hpwork[this_cpu()];
+#else
+  return (FAR struct kwork_wqueue_s *)&g_hpwork[0];
+#endif
 }
 
 #endif /* CONFIG_SCHED_HPWORK */
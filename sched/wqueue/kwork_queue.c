@@ -38,10 +38,44 @@
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define WORK_IS_HPQUEUE(q) \
+     ((FAR struct hp_wqueue_s *)(q) >= &g_hpwork[0] && \
+      (FAR struct hp_wqueue_s *)(q) < &g_hpwork[HPWORK_NQUEUES])
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_pendq
+ *
+ * Description:
+ *   Return the queue that currently holds the pending 'work'.  With per-CPU
+ *   high priority queues, that may be another CPU's queue than 'wqueue'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+static FAR dq_queue_t *work_pendq(FAR struct kwork_wqueue_s *wqueue,
+                                  FAR struct work_s *work)
+{
+  if (WORK_IS_HPQUEUE(wqueue))
+    {
+      return &g_hpwork[work->cpu].q;
+    }
+
+  return &wqueue->q;
+}
+#else
+#  define work_pendq(wqueue, work) (&(wqueue)->q)
+#endif
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -93,7 +127,7 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
        * end of the work queue.
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      dq_rem((FAR dq_entry_t *)work, work_pendq(wqueue, work));
     }
 
   /* Initialize the work structure. */
@@ -106,11 +140,53 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 
   work->qtime  = clock_systime_ticks(); /* Time work queued */
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  /* Remember the queue for work_cancel() and for re-queuing */
+
+  if (WORK_IS_HPQUEUE(wqueue))
+    {
+      work->cpu = (FAR struct hp_wqueue_s *)wqueue - &g_hpwork[0];
+    }
+#endif
+
   dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
 
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: work_qid2queue
+ *
+ * Description:
+ *   Map a work queue ID to the work queue and its number of worker
+ *   threads.  Must be called in a critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct kwork_wqueue_s *work_qid2queue(int qid,
+                                                 FAR int *nthreads)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      *nthreads = CONFIG_SCHED_HPNTHREADS;
+      return work_hpqueue();
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      *nthreads = CONFIG_SCHED_LPNTHREADS;
+      return (FAR struct kwork_wqueue_s *)&g_lpwork;
+    }
+  else
+#endif
+    {
+      return NULL;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -148,33 +224,118 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
-  /* Queue the new work */
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+  int nthreads;
 
-#ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      /* Queue high priority work */
+  /* Select the queue and queue the new work.  For the high priority queue
+   * this is the queue of the CPU we are running on, so the critical
+   * section also keeps us from migrating.
+   */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker,
-                  arg, delay);
-      return work_signal(HPWORK);
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
+  flags  = enter_critical_section();
+  wqueue = work_qid2queue(qid, &nthreads);
+  if (wqueue == NULL)
     {
-      /* Queue low priority work */
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  work_qqueue(wqueue, work, worker, arg, delay);
+  leave_critical_section(flags);
+
+  return work_qsignal(wqueue, nthreads);
+}
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Like work_queue(), but place HPWORK work on the high priority work
+ *   queue of 'cpu' rather than that of the calling CPU.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   cpu    - The CPU whose high priority work queue is used
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument that will be passed to the worker callback.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker,
-                  arg, delay);
-      return work_signal(LPWORK);
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+
+  if (qid != HPWORK || (unsigned)cpu >= HPWORK_NQUEUES)
+    {
+      return work_queue(qid, work, worker, arg, delay);
     }
-  else
+
+  wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork[cpu];
+
+  flags = enter_critical_section();
+  work_qqueue(wqueue, work, worker, arg, delay);
+  leave_critical_section(flags);
+
+  return work_qsignal(wqueue, CONFIG_SCHED_HPNTHREADS);
+}
 #endif
+
+/****************************************************************************
+ * Name: work_queue_batch
+ *
+ * Description:
+ *   Queue several work items on the same work queue at once.  This is
+ *   equivalent to calling work_queue() for each entry in 'batch', but the
+ *   critical section is entered once and the worker thread is signaled
+ *   once for the whole batch.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   batch  - The array of work requests
+ *   nbatch - The number of entries in 'batch'
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_batch(int qid, FAR const struct work_batch_s *batch,
+                     int nbatch)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+  int nthreads;
+  int i;
+
+  DEBUGASSERT(batch != NULL || nbatch == 0);
+
+  flags  = enter_critical_section();
+  wqueue = work_qid2queue(qid, &nthreads);
+  if (wqueue == NULL)
     {
+      leave_critical_section(flags);
       return -EINVAL;
     }
+
+  for (i = 0; i < nbatch; i++)
+    {
+      work_qqueue(wqueue, batch[i].work, batch[i].worker, batch[i].arg,
+                  batch[i].delay);
+    }
+
+  leave_critical_section(flags);
+
+  return nbatch > 0 ? work_qsignal(wqueue, nthreads) : OK;
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
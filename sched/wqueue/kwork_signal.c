@@ -27,6 +27,7 @@
 #include <signal.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/signal.h>
 
@@ -39,56 +40,31 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_signal
+ * Name: work_qsignal
  *
  * Description:
- *   Signal the worker thread to process the work queue now.  This function
- *   is used internally by the work logic but could also be used by the
- *   user to force an immediate re-assessment of pending work.
+ *   Signal an IDLE worker thread of 'wqueue' to process the work queue.
  *
  * Input Parameters:
- *   qid    - The work queue ID
+ *   wqueue   - The work queue to be signaled
+ *   nthreads - The number of worker threads serving the queue
  *
  * Returned Value:
  *   Zero (OK) on success, a negated errno value on failure
  *
  ****************************************************************************/
 
-int work_signal(int qid)
+int work_qsignal(FAR struct kwork_wqueue_s *wqueue, int nthreads)
 {
-  FAR struct kwork_wqueue_s *work;
-  int threads;
   int i;
 
-  /* Get the process ID of the worker thread */
-
-#ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      work = (FAR struct kwork_wqueue_s *)&g_hpwork;
-      threads = CONFIG_SCHED_HPNTHREADS;
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
-    {
-      work = (FAR struct kwork_wqueue_s *)&g_lpwork;
-      threads = CONFIG_SCHED_LPNTHREADS;
-    }
-  else
-#endif
-    {
-      return -EINVAL;
-    }
-
   /* Find an IDLE worker thread */
 
-  for (i = 0; i < threads; i++)
+  for (i = 0; i < nthreads; i++)
     {
       /* Is this worker thread busy? */
 
-      if (!work->worker[i].busy)
+      if (!wqueue->worker[i].busy)
         {
           /* No.. select this thread */
 
@@ -98,14 +74,59 @@ int work_signal(int qid)
 
   /* If all of the IDLE threads are busy, then just return successfully */
 
-  if (i >= threads)
+  if (i >= nthreads)
     {
       return OK;
     }
 
   /* Otherwise, signal the first IDLE thread found */
 
-  return nxsig_kill(work->worker[i].pid, SIGWORK);
+  return nxsig_kill(wqueue->worker[i].pid, SIGWORK);
+}
+
+/****************************************************************************
+ * Name: work_signal
+ *
+ * Description:
+ *   Signal the worker thread to process the work queue now.  This function
+ *   is used internally by the work logic but could also be used by the
+ *   user to force an immediate re-assessment of pending work.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_signal(int qid)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      FAR struct kwork_wqueue_s *wqueue;
+      irqstate_t flags;
+
+      flags  = local_irq_save();
+      wqueue = work_hpqueue();
+      local_irq_restore(flags);
+
+      return work_qsignal(wqueue, CONFIG_SCHED_HPNTHREADS);
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      return work_qsignal((FAR struct kwork_wqueue_s *)&g_lpwork,
+                          CONFIG_SCHED_LPNTHREADS);
+    }
+  else
+#endif
+    {
+      return -EINVAL;
+    }
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -43,6 +43,16 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* Number of high priority work queues: one per CPU, or a single shared
+ * queue.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define HPWORK_NQUEUES CONFIG_SMP_NCPUS
+#else
+#  define HPWORK_NQUEUES 1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -98,9 +108,9 @@ struct lp_wqueue_s
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s). */
 
-extern struct hp_wqueue_s g_hpwork;
+extern struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
@@ -151,6 +161,35 @@ int work_start_highpri(void);
 int work_start_lowpri(void);
 #endif
 
+/****************************************************************************
+ * Name: work_hpqueue
+ *
+ * Description:
+ *   Return the high priority work queue used by the calling CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+FAR struct kwork_wqueue_s *work_hpqueue(void);
+#endif
+
+/****************************************************************************
+ * Name: work_qsignal
+ *
+ * Description:
+ *   Signal an IDLE worker thread of 'wqueue' to process the work queue.
+ *
+ * Input Parameters:
+ *   wqueue   - The work queue to be signaled
+ *   nthreads - The number of worker threads serving the queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_qsignal(FAR struct kwork_wqueue_s *wqueue, int nthreads);
+
 /****************************************************************************
  * Name: work_process
  *
@@ -117,14 +117,18 @@
 #define CROMFS_MAGIC       0x4d4f5243
 #define CROMFS_BLOCKSIZE   512
 
+#define CROMFS_FLAG_INDEX  (1 << 0)  /* Must match fs/cromfs/cromfs.h */
+
 #define LZF_BUFSIZE        512
 #define LZF_HLOG           13
 #define LZF_HSIZE          (1 << LZF_HLOG)
 
 #define LZF_TYPE0_HDR      0
 #define LZF_TYPE1_HDR      1
+#define LZF_TYPE2_HDR      2
 #define LZF_TYPE0_HDR_SIZE 5
 #define LZF_TYPE1_HDR_SIZE 7
+#define LZF_TYPE2_HDR_SIZE 7
 
 #define LZF_FRST(p)        (((p[0]) << 8) | p[1])
 #define LZF_NEXT(v,p)      (((v) << 8) | p[2])
@@ -134,6 +138,15 @@
 #define LZF_MAX_OFF        (1 << LZF_HLOG)
 #define LZF_MAX_REF        ((1 << 8) + (1 << 3))
 
+#define LZ4_HLOG           12
+#define LZ4_HSIZE          (1 << LZ4_HLOG)
+#define LZ4_MIN_MATCH      4
+#define LZ4_MAX_OFF        65535
+#define LZ4_LAST_LITERALS  5
+#define LZ4_MF_LIMIT       12
+#define LZ4_RUN_MASK       15
+#define LZ4_HASH(v)        (((v) * 2654435761u) >> (32 - LZ4_HLOG))
+
 #define HEX_PER_LINE       8
 
 /****************************************************************************
@@ -164,7 +177,7 @@ struct cromfs_volume_s
 struct cromfs_node_s
 {
   uint16_t cn_mode;       /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;        /* Not used */
+  uint16_t cn_flags;      /* See CROMFS_FLAG_* definitions */
   uint32_t cn_name;       /* Offset from the beginning of the volume header to the
                            * node name string.  NUL-terminated. */
   uint32_t cn_size;       /* Size of the uncompressed data (in bytes) */
@@ -230,6 +243,10 @@ union lzf_result_u
 
 static uint8_t *g_lzf_hashtab[LZF_HSIZE];
 
+/* LZ4 hash table (input offsets plus one, zero means empty) */
+
+static uint32_t g_lz4_hashtab[LZ4_HSIZE];
+
 /* Type of the callback from traverse_directory() */
 
 typedef int (*traversal_callback_t)(const char *dirpath, const char *name,
@@ -243,6 +260,8 @@ static char *g_progname;       /* Name of this program */
 static char *g_dirname;        /* Source directory path */
 static char *g_outname;        /* Output file path */
 
+static bool g_lz4;             /* True: Compress with LZ4 instead of LZF */
+
 static FILE *g_outstream;      /* Main output stream */
 static FILE *g_tmpstream;      /* Temporary file output stream */
 
@@ -297,6 +316,8 @@ static void dump_hexbuffer(FILE *stream, const void *buffer,
 static void dump_nextline(FILE *stream);
 static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
                            union lzf_result_u *result);
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result);
 static uint16_t get_mode(mode_t mode);
 #ifdef HOST_TGTSWAP
 static inline uint16_t tgt_uint16(uint16_t a);
@@ -325,7 +346,8 @@ static int  traverse_directory(const char *dirpath,
 
 static void show_usage(void)
 {
-  fprintf(stderr, "USAGE: %s <dir-path> <out-file>\n", g_progname);
+  fprintf(stderr, "USAGE: %s [-4] <dir-path> <out-file>\n", g_progname);
+  fprintf(stderr, "  -4  Compress with LZ4 (needs CONFIG_LIBC_LZF_LZ4)\n");
   exit(1);
 }
 
@@ -832,6 +854,149 @@ genhdr:
   return retlen;
 }
 
+static uint8_t *lz4_putlen(uint8_t *outptr, unsigned int len)
+{
+  /* Extend a length that did not fit in its 4-bit token field */
+
+  for (len -= LZ4_RUN_MASK; len >= 255; len -= 255)
+    {
+      *outptr++ = 255;
+    }
+
+  *outptr++ = len;
+  return outptr;
+}
+
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result)
+{
+  const uint8_t *inptr  = inbuffer;
+  const uint8_t *anchor = inbuffer;
+  const uint8_t *inend  = inbuffer + inlen;
+        uint8_t *outptr = result->compressed.lzf_buffer;
+        uint8_t *outend = outptr + LZF_BUFSIZE;
+  const uint8_t *ref;
+  unsigned int litlen;
+  unsigned int mlen;
+  uint32_t seq;
+  uint32_t hval;
+  ssize_t cs = 0;
+  ssize_t retlen;
+
+  memset(g_lz4_hashtab, 0, sizeof(g_lz4_hashtab));
+
+  /* Greedy parse.  No match may start in the last LZ4_MF_LIMIT octets and
+   * the last LZ4_LAST_LITERALS octets are always literals.
+   */
+
+  while (inlen >= LZ4_MF_LIMIT && inptr <= inend - LZ4_MF_LIMIT)
+    {
+      memcpy(&seq, inptr, sizeof(uint32_t));
+      hval = LZ4_HASH(seq);
+      ref  = g_lz4_hashtab[hval] ? inbuffer + g_lz4_hashtab[hval] - 1 : NULL;
+      g_lz4_hashtab[hval] = inptr - inbuffer + 1;
+
+      if (ref == NULL || inptr - ref > LZ4_MAX_OFF ||
+          memcmp(ref, inptr, LZ4_MIN_MATCH) != 0)
+        {
+          inptr++;
+          continue;
+        }
+
+      mlen = LZ4_MIN_MATCH;
+      while (inptr + mlen < inend - LZ4_LAST_LITERALS &&
+             ref[mlen] == inptr[mlen])
+        {
+          mlen++;
+        }
+
+      /* Emit the sequence:  Token, literals, offset, match length */
+
+      litlen = inptr - anchor;
+      if (outptr + 1 + litlen + litlen / 255 + 2 + mlen / 255 + 2 > outend)
+        {
+          goto genhdr;
+        }
+
+      *outptr++ = (litlen < LZ4_RUN_MASK ? litlen : LZ4_RUN_MASK) << 4 |
+                  (mlen - LZ4_MIN_MATCH < LZ4_RUN_MASK ?
+                   mlen - LZ4_MIN_MATCH : LZ4_RUN_MASK);
+      if (litlen >= LZ4_RUN_MASK)
+        {
+          outptr = lz4_putlen(outptr, litlen);
+        }
+
+      memcpy(outptr, anchor, litlen);
+      outptr   += litlen;
+
+      *outptr++ = (inptr - ref) & 0xff;
+      *outptr++ = (inptr - ref) >> 8;
+
+      if (mlen - LZ4_MIN_MATCH >= LZ4_RUN_MASK)
+        {
+          outptr = lz4_putlen(outptr, mlen - LZ4_MIN_MATCH);
+        }
+
+      inptr  += mlen;
+      anchor  = inptr;
+    }
+
+  /* The final sequence holds the remaining literals */
+
+  litlen = inend - anchor;
+  if (outptr + 1 + litlen + litlen / 255 + 1 > outend)
+    {
+      goto genhdr;
+    }
+
+  *outptr++ = (litlen < LZ4_RUN_MASK ? litlen : LZ4_RUN_MASK) << 4;
+  if (litlen >= LZ4_RUN_MASK)
+    {
+      outptr = lz4_putlen(outptr, litlen);
+    }
+
+  memcpy(outptr, anchor, litlen);
+  outptr += litlen;
+
+  cs = outptr - (uint8_t *)result->compressed.lzf_buffer;
+  if (cs >= inlen)
+    {
+      cs = 0;
+    }
+
+genhdr:
+  if (cs > 0)
+    {
+      /* Write compressed header */
+
+      result->compressed.lzf_magic[0]   = 'Z';
+      result->compressed.lzf_magic[1]   = 'V';
+      result->compressed.lzf_type       = LZF_TYPE2_HDR;
+      result->compressed.lzf_clen[0]    = cs >> 8;
+      result->compressed.lzf_clen[1]    = cs & 0xff;
+      result->compressed.lzf_ulen[0]    = inlen >> 8;
+      result->compressed.lzf_ulen[1]    = inlen & 0xff;
+      retlen                            = cs + LZF_TYPE2_HDR_SIZE;
+    }
+  else
+    {
+      /* Write uncompressed header */
+
+      result->uncompressed.lzf_magic[0] = 'Z';
+      result->uncompressed.lzf_magic[1] = 'V';
+      result->uncompressed.lzf_type     = LZF_TYPE0_HDR;
+      result->uncompressed.lzf_len[0]   = inlen >> 8;
+      result->uncompressed.lzf_len[1]   = inlen & 0xff;
+
+      /* Copy uncompressed data into the result buffer */
+
+      memcpy(result->uncompressed.lzf_buffer, inbuffer, inlen);
+      retlen                            = inlen + LZF_TYPE0_HDR_SIZE;
+    }
+
+  return retlen;
+}
+
 static uint16_t get_mode(mode_t mode)
 {
   uint16_t ret = 0;
@@ -901,7 +1066,7 @@ static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty)
           (unsigned long)g_offset, name);
 
   node.cn_mode    = TGT_UINT16(DIRLINK_MODEFLAGS);
-  node.cn_pad     = 0;
+  node.cn_flags     = 0;
 
   g_offset       += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(g_offset);
@@ -984,7 +1149,7 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
           (unsigned long)save_offset, path);
 
   node.cn_mode    = TGT_UINT16(NUTTX_IFDIR | get_mode(mode));
-  node.cn_pad     = 0;
+  node.cn_flags     = 0;
 
   save_offset    += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(save_offset);
@@ -1016,7 +1181,11 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   FILE *save_tmpstream = g_tmpstream;
   FILE *outstream;
   FILE *instream;
+  struct stat buf;
   uint8_t iobuffer[LZF_BUFSIZE];
+  uint32_t *index;
+  size_t indexlen;
+  size_t nindex;
   size_t nread;
   size_t ntotal;
   size_t blklen;
@@ -1026,12 +1195,6 @@ static void gen_file(const char *path, const char *name, mode_t mode,
 
   namlen      = strlen(name) + 1;
 
-  /* Open a new temporary file */
-
-  outstream   = open_tmpfile();
-  g_tmpstream = outstream;
-  g_offset    = nodeoffs + sizeof(struct cromfs_node_s) + namlen;
-
   /* Open the source data file */
 
   instream    = fopen(path, "r");
@@ -1042,6 +1205,32 @@ static void gen_file(const char *path, const char *name, mode_t mode,
       exit(1);
     }
 
+  /* The block index precedes the blocks so its size must be known now.
+   * There is one entry for each CROMFS_BLOCKSIZE chunk of the file.
+   */
+
+  if (fstat(fileno(instream), &buf) < 0)
+    {
+      fprintf(stderr, "fstat for source file %s failed: %s\n",
+              path, strerror(errno));
+      exit(1);
+    }
+
+  nindex      = (buf.st_size + CROMFS_BLOCKSIZE - 1) / CROMFS_BLOCKSIZE;
+  indexlen    = nindex * sizeof(uint32_t);
+  index       = malloc(indexlen + 1);
+  if (!index)
+    {
+      fprintf(stderr, "Failed to allocate block index for %s\n", path);
+      exit(1);
+    }
+
+  /* Open a new temporary file */
+
+  outstream   = open_tmpfile();
+  g_tmpstream = outstream;
+  g_offset    = nodeoffs + sizeof(struct cromfs_node_s) + namlen + indexlen;
+
   /* Then read data from the file, compress it, and write it to the new
    * temporary file
    */
@@ -1059,9 +1248,26 @@ static void gen_file(const char *path, const char *name, mode_t mode,
         {
           uint16_t clen;
 
+          if (blkno >= nindex)
+            {
+              fprintf(stderr, "Source file %s grew while compressing\n",
+                      path);
+              exit(1);
+            }
+
+          index[blkno] = TGT_UINT32(g_offset);
+
           /* Compress the chunk */
 
-          blklen = lzf_compress(iobuffer, nread, &result);
+          if (g_lz4)
+            {
+              blklen = lz4_compress(iobuffer, nread, &result);
+            }
+          else
+            {
+              blklen = lzf_compress(iobuffer, nread, &result);
+            }
+
           if (result.cmn.lzf_type == LZF_TYPE0_HDR)
             {
               clen = nread;
@@ -1090,6 +1296,14 @@ static void gen_file(const char *path, const char *name, mode_t mode,
     }
   while (nread > 0);
 
+  fclose(instream);
+
+  if (blkno != nindex)
+    {
+      fprintf(stderr, "Source file %s shrank while compressing\n", path);
+      exit(1);
+    }
+
   /* Restore the old tmpfile context */
 
   g_tmpstream        = save_tmpstream;
@@ -1102,7 +1316,7 @@ static void gen_file(const char *path, const char *name, mode_t mode,
           (unsigned long)blktotal);
 
   node.cn_mode       = TGT_UINT16(NUTTX_IFREG | get_mode(mode));
-  node.cn_pad        = 0;
+  node.cn_flags      = TGT_UINT16(CROMFS_FLAG_INDEX);
 
   nodeoffs          += sizeof(struct cromfs_node_s);
   node.cn_name       = TGT_UINT32(nodeoffs);
@@ -1112,13 +1326,16 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   nodeoffs          += namlen;
   node.u.cn_blocks   = TGT_UINT32(nodeoffs);
 
-  nodeoffs          += blktotal;
+  nodeoffs          += indexlen + blktotal;
   node.cn_peer       = TGT_UINT32(lastentry ? 0 : nodeoffs);
 
   dump_hexbuffer(g_tmpstream, &node, sizeof(struct cromfs_node_s));
   dump_hexbuffer(g_tmpstream, name, namlen);
+  dump_hexbuffer(g_tmpstream, index, indexlen);
   dump_nextline(g_tmpstream);
 
+  free(index);
+
   g_nnodes++;
 
   /* Now append the sub-tree nodes in the new tmpfile to the previous
@@ -1274,6 +1491,13 @@ int main(int argc, char **argv, char **envp)
   ptr = strrchr(argv[0], '/');
   g_progname = ptr == NULL ? argv[0] : ptr + 1;
 
+  if (argc > 1 && strcmp(argv[1], "-4") == 0)
+    {
+      g_lz4 = true;
+      argv++;
+      argc--;
+    }
+
   if (argc != 3)
     {
       fprintf(stderr, "Unexpected number of arguments\n");
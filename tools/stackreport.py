@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+# tools/stackreport.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+
+import argparse
+import re
+import sys
+
+# Threads created by the OS and the configuration setting of their stack
+
+KNOWN_THREADS = {
+    "Idle Task":  "CONFIG_IDLETHREAD_STACKSIZE",
+    "hpwork":     "CONFIG_SCHED_HPWORKSTACKSIZE",
+    "lpwork":     "CONFIG_SCHED_LPWORKSTACKSIZE",
+    "init":       "CONFIG_USERMAIN_STACKSIZE",
+    "AppBringUp": "CONFIG_BOARD_INITTHREAD_STACKSIZE",
+    "pgfill":     "CONFIG_PAGING_STACKSIZE",
+    "initstep":   "CONFIG_SCHED_INITSTEPS_STACKSIZE",
+}
+
+def parse_args():
+
+    parser = argparse.ArgumentParser(description = """
+        Suggest stack sizes from one or more captures of /proc/stackmon
+        (CONFIG_STACK_MONITOR).  Capture the file after exercising the
+        system, for example with 'cat /proc/stackmon' on the NSH console.
+        Threads are grouped by name and the largest use seen in any capture
+        is kept.  The suggested size is that use plus a margin, rounded up.
+        """)
+
+    parser.add_argument("captures", nargs = "+",
+        help = "files holding the output of /proc/stackmon")
+    parser.add_argument("-m", "--margin", type = int, default = 25,
+        help = "margin over the measured use, in percent (default 25)")
+    parser.add_argument("-a", "--align", type = int, default = 16,
+        help = "round suggested sizes up to this many bytes (default 16)")
+    parser.add_argument("-s", "--minimum", type = int, default = 256,
+        help = "smallest size to suggest (default 256)")
+    parser.add_argument("-c", "--config",
+        help = ".config file: print the settings to change for OS threads")
+
+    return parser.parse_args()
+
+def read_captures(files):
+
+    # name -> [size, used]
+
+    threads = {}
+    line_re = re.compile(r"^\s*(\S+)\s+(\d+)\s+(\d+)\s+(\d+)\s+\d+%\s+(\S+)\s?(.*)$")
+
+    for filename in files:
+        with open(filename) as f:
+            for line in f:
+                m = line_re.match(line)
+                if m is None:
+                    continue
+
+                size = int(m.group(2))
+                used = int(m.group(3))
+                name = m.group(6).strip() or "<pid %s>" % m.group(1)
+
+                entry = threads.setdefault(name, [size, 0])
+                entry[0] = max(entry[0], size)
+                entry[1] = max(entry[1], used)
+
+    return threads
+
+def suggest(used, args):
+
+    size = used * (100 + args.margin) // 100
+    size = max(size, args.minimum)
+    return (size + args.align - 1) // args.align * args.align
+
+def read_config(filename):
+
+    config = {}
+    with open(filename) as f:
+        for line in f:
+            m = re.match(r"^(CONFIG_\w+)=(\d+)$", line.strip())
+            if m is not None:
+                config[m.group(1)] = int(m.group(2))
+
+    return config
+
+def main():
+
+    args = parse_args()
+    threads = read_captures(args.captures)
+    if not threads:
+        sys.exit("No thread found in the captures")
+
+    total = 0
+    print("%-24s %7s %7s %9s %8s" %
+          ("NAME", "SIZE", "USED", "SUGGESTED", "SAVED"))
+
+    for name, (size, used) in sorted(threads.items(),
+                                     key = lambda t: t[1][1] - t[1][0]):
+        new = suggest(used, args)
+        saved = size - new
+        total += max(saved, 0)
+
+        note = ""
+        if used >= size:
+            note = "  (overflow?)"
+
+        print("%-24s %7d %7d %9d %8d%s" %
+              (name, size, used, new, saved, note))
+
+    print("Total saved: %d bytes" % total)
+
+    if args.config is None:
+        return
+
+    print()
+    print("# Suggested settings for %s" % args.config)
+
+    config = read_config(args.config)
+    for name, symbol in KNOWN_THREADS.items():
+        if name in threads and symbol in config:
+            new = suggest(threads[name][1], args)
+            if new != config[symbol]:
+                print("%s=%d  # was %d" % (symbol, new, config[symbol]))
+
+if __name__ == "__main__":
+    main()
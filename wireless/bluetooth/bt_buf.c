@@ -82,11 +82,16 @@
 #  define CONFIG_BLUETOOTH_BUFFER_IRQRESERVE CONFIG_BLUETOOTH_BUFFER_PREALLOC
 #endif
 
+#ifndef CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC
+#  define CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC 0
+#endif
+
 /* Memory Pools */
 
 #define POOL_BUFFER_GENERAL  0
 #define POOL_BUFFER_IRQ      1
 #define POOL_BUFFER_DYNAMIC  2
+#define POOL_BUFFER_ACL      3
 
 /****************************************************************************
  * Private Data
@@ -113,6 +118,17 @@ static struct bt_buf_s *g_buf_free_irq;
 static struct bt_buf_s
   g_buf_pool[CONFIG_BLUETOOTH_BUFFER_PREALLOC];
 
+#if CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC > 0
+/* ACL data buffers have a separate pool, g_buf_free_acl, so that a burst
+ * of data cannot starve HCI commands and events.
+ */
+
+static struct bt_buf_s *g_buf_free_acl;
+
+static struct bt_buf_s
+  g_buf_acl_pool[CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC];
+#endif
+
 static bool g_poolinit = false;
 
 /****************************************************************************
@@ -149,6 +165,21 @@ void bt_buf_initialize(void)
 
   g_poolinit = true;
 
+#if CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC > 0
+  /* Initialize g_buf_free_acl, the list of ACL data buffer structures */
+
+  g_buf_free_acl = NULL;
+  for (pool = g_buf_acl_pool;
+       pool < &g_buf_acl_pool[CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC];
+       pool++)
+    {
+      pool->flink    = g_buf_free_acl;
+      g_buf_free_acl = pool;
+    }
+
+  pool = g_buf_pool;
+#endif
+
 #if CONFIG_BLUETOOTH_BUFFER_PREALLOC > CONFIG_BLUETOOTH_BUFFER_IRQRESERVE
   /* Initialize g_buf_free, the list of buffer structures that are available
    * for general use.
@@ -244,6 +275,20 @@ FAR struct bt_buf_s *bt_buf_alloc(enum bt_buf_type_e type,
    */
 
   flags = spin_lock_irqsave(); /* Always necessary in SMP mode */
+
+#if CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC > 0
+  /* ACL data buffers come from their own pool first, in any context */
+
+  if ((type == BT_ACL_IN || type == BT_ACL_OUT) && g_buf_free_acl != NULL)
+    {
+      buf            = g_buf_free_acl;
+      g_buf_free_acl = buf->flink;
+
+      spin_unlock_irqrestore(flags);
+      pool           = POOL_BUFFER_ACL;
+    }
+  else
+#endif
   if (up_interrupt_context())
     {
 #if CONFIG_BLUETOOTH_BUFFER_PREALLOC > CONFIG_BLUETOOTH_BUFFER_IRQRESERVE
@@ -336,7 +381,7 @@ FAR struct bt_buf_s *bt_buf_alloc(enum bt_buf_type_e type,
       /* Yes.. use that IOB */
 
       DEBUGASSERT(iob->io_len >= iob->io_offset &&
-                  iob->io_len <= BLUETOOTH_MAX_FRAMELEN);
+                  iob->io_len <= CONFIG_IOB_BUFSIZE);
 
       buf->frame = iob;
       buf->data  = &iob->io_data[iob->io_offset];
@@ -413,6 +458,19 @@ void bt_buf_release(FAR struct bt_buf_s *buf)
       buf->frame = NULL;
     }
 
+#if CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC > 0
+  /* ACL data buffer structures return to their own pool */
+
+  if (buf->pool == POOL_BUFFER_ACL)
+    {
+      flags          = spin_lock_irqsave();
+      buf->flink     = g_buf_free_acl;
+      g_buf_free_acl = buf;
+      spin_unlock_irqrestore(flags);
+    }
+  else
+#endif
+
 #if CONFIG_BLUETOOTH_BUFFER_PREALLOC > CONFIG_BLUETOOTH_BUFFER_IRQRESERVE
   /* If this is a generally available pre-allocated buffer structure,
    * then just put it back in the free list.
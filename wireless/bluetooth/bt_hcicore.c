@@ -1330,10 +1330,22 @@ static int hci_initialize(void)
 
   hbs = bt_buf_extend(buf, sizeof(*hbs));
   memset(hbs, 0, sizeof(*hbs));
+#if CONFIG_BLUETOOTH_LE_DATALEN > 27
+  /* Accept whole data-length-extended PDUs so that they arrive in one ACL
+   * packet and need no L2CAP reassembly copy.
+   */
+
+  hbs->acl_mtu = BT_HOST2LE16(CONFIG_BLUETOOTH_LE_DATALEN);
+#else
   hbs->acl_mtu = BT_HOST2LE16(BLUETOOTH_MAX_FRAMELEN -
                               sizeof(struct bt_hci_acl_hdr_s) -
                               g_btdev.btdev->head_reserve);
+#endif
+#if CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC > 0
+  hbs->acl_pkts = BT_HOST2LE16(CONFIG_BLUETOOTH_BUFFER_ACL_PREALLOC);
+#else
   hbs->acl_pkts = BT_HOST2LE16(CONFIG_BLUETOOTH_BUFFER_PREALLOC);
+#endif
 
   ret = bt_hci_cmd_send(BT_HCI_OP_HOST_BUFFER_SIZE, buf);
   if (ret < 0)
@@ -1394,6 +1406,37 @@ static int hci_initialize(void)
       bt_hci_cmd_send_sync(BT_HCI_OP_LE_WRITE_LE_HOST_SUPP, buf, NULL);
     }
 
+#if CONFIG_BLUETOOTH_LE_DATALEN > 27
+  if (g_btdev.le_features[0] & BT_HCI_LE_DATA_LEN_EXT)
+    {
+      FAR struct bt_hci_cp_le_write_default_data_len_s *dl;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN,
+                              sizeof(*dl));
+      if (buf == NULL)
+        {
+          wlerr("ERROR:  Failed to create buffer\n");
+          return -ENOBUFS;
+        }
+
+      /* Suggest the PDU size for new connections.  The time is that of
+       * the longest PDU on the LE 1M PHY.
+       */
+
+      dl                = bt_buf_extend(buf, sizeof(*dl));
+      dl->max_tx_octets = BT_HOST2LE16(CONFIG_BLUETOOTH_LE_DATALEN);
+      dl->max_tx_time   =
+        BT_HOST2LE16((CONFIG_BLUETOOTH_LE_DATALEN + 14) * 8);
+
+      ret = bt_hci_cmd_send_sync(BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN, buf,
+                                 NULL);
+      if (ret < 0)
+        {
+          wlwarn("WARNING:  Failed to set the data length: %d\n", ret);
+        }
+    }
+#endif
+
   wlinfo("HCI ver %u rev %u, manufacturer %u\n", g_btdev.hci_version,
          g_btdev.hci_revision, g_btdev.manufacturer);
   wlinfo("ACL buffers: pkts %u mtu %u\n", g_btdev.le_pkts, g_btdev.le_mtu);
@@ -89,6 +89,11 @@
 #  error CONFIG_IOB_BUFSIZE to small for max Bluetooth frame
 #endif
 
+#if defined(CONFIG_BLUETOOTH_LE_DATALEN) && \
+    CONFIG_BLUETOOTH_LE_DATALEN + BLUETOOTH_MAX_HDRLEN > CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_BUFSIZE to small for CONFIG_BLUETOOTH_LE_DATALEN
+#endif
+
 /* TX poll delay = 1 seconds.
  * CLK_TCK is the number of clock ticks per second
  */
@@ -363,10 +368,10 @@ static void btnet_l2cap_receive(FAR struct bt_conn_s *conn,
    * to synchronize?
    */
 
-  frame->io_len    = buf->len;
-  frame->io_pktlen = buf->len;
   frame->io_offset = (unsigned int)
     ((uintptr_t)buf->data - (uintptr_t)frame->io_data);
+  frame->io_len    = frame->io_offset + buf->len;
+  frame->io_pktlen = frame->io_len;
 
   DEBUGASSERT(frame->io_len <= CONFIG_IOB_BUFSIZE);
   DEBUGASSERT(frame->io_offset < CONFIG_IOB_BUFSIZE);
@@ -228,6 +228,8 @@ int mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
 
   (*txdesc)->purgetime = 0;
   (*txdesc)->retrycount = priv->maxretries;
+  (*txdesc)->retries = 0;
+  (*txdesc)->csma = false;
 
   (*txdesc)->conf = &primitive->u.dataconf;
   return OK;
@@ -649,6 +651,33 @@ void mac802154_updatebeacon(FAR struct ieee802154_privmac_s *priv)
   priv->beaconupdate = false;
 }
 
+/****************************************************************************
+ * Name: mac802154_csma_enqueue
+ *
+ * Description:
+ *    Internal function used by various parts of the MAC layer.  This
+ *    function links the provided tx descriptor into the CSMA transaction
+ *    list.  The caller notifies the radio afterwards.
+ *
+ * Assumptions:
+ *    Called with the MAC locked
+ *
+ ****************************************************************************/
+
+void mac802154_csma_enqueue(FAR struct ieee802154_privmac_s *priv,
+                            FAR struct ieee802154_txdesc_s *txdesc)
+{
+  sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue);
+
+#ifdef CONFIG_MAC802154_TXSTATS
+  priv->txstats.queued++;
+  if (++priv->txstats.depth > priv->txstats.maxdepth)
+    {
+      priv->txstats.maxdepth = priv->txstats.depth;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: mac802154_setupindirect
  *
@@ -832,6 +861,13 @@ static int
 
       *txdesc = (FAR struct ieee802154_txdesc_s *)
                   sq_remfirst(&priv->csma_queue);
+      if (*txdesc != NULL)
+        {
+          (*txdesc)->csma = true;
+#ifdef CONFIG_MAC802154_TXSTATS
+          priv->txstats.depth--;
+#endif
+        }
     }
 
   mac802154_unlock(priv)
@@ -856,6 +892,10 @@ static int
  *   the descriptor and schedules work to handle the transaction without
  *   blocking the radio.
  *
+ *   A CSMA frame that was not acknowledged goes back to the head of the
+ *   CSMA queue, up to macMaxFrameRetries times, unless the radio has
+ *   already retransmitted it itself.
+ *
  ****************************************************************************/
 
 static void mac802154_txdone(FAR const struct ieee802154_radiocb_s *radiocb,
@@ -874,6 +914,52 @@ static void mac802154_txdone(FAR const struct ieee802154_radiocb_s *radiocb,
 
   mac802154_lock(priv, false);
 
+#ifdef CONFIG_MAC802154_TXSTATS
+  priv->txstats.retries += txdesc->retries;
+#endif
+
+  if (txdesc->csma && txdesc->ackreq && txdesc->retrycount > 0 &&
+      txdesc->conf->status == IEEE802154_STATUS_NO_ACK &&
+      (priv->radio->caps & IEEE802154_RADIOCAP_RETRY) == 0)
+    {
+      txdesc->retrycount--;
+      txdesc->retries = 1;
+
+      sq_addfirst((FAR sq_entry_t *)txdesc, &priv->csma_queue);
+#ifdef CONFIG_MAC802154_TXSTATS
+      if (++priv->txstats.depth > priv->txstats.maxdepth)
+        {
+          priv->txstats.maxdepth = priv->txstats.depth;
+        }
+#endif
+
+      mac802154_unlock(priv)
+
+      priv->radio->txnotify(priv->radio, false);
+      return;
+    }
+
+#ifdef CONFIG_MAC802154_TXSTATS
+  switch (txdesc->conf->status)
+    {
+      case IEEE802154_STATUS_SUCCESS:
+        priv->txstats.sent++;
+        break;
+
+      case IEEE802154_STATUS_NO_ACK:
+        priv->txstats.noack++;
+        break;
+
+      case IEEE802154_STATUS_CHANNEL_ACCESS_FAILURE:
+        priv->txstats.chanfail++;
+        break;
+
+      default:
+        priv->txstats.failed++;
+        break;
+    }
+#endif
+
   sq_addlast((FAR sq_entry_t *)txdesc, &priv->txdone_queue);
 
   mac802154_unlock(priv)
@@ -2007,7 +2093,7 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
 
           /* Link the transaction into the CSMA transaction list */
 
-          sq_addlast((FAR sq_entry_t *)respdesc, &priv->csma_queue);
+          mac802154_csma_enqueue(priv, respdesc);
 
           /* Notify the radio driver that there is data available */
 
@@ -2069,7 +2155,7 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
 
                   /* Link the transaction into the CSMA transaction list */
 
-                  sq_addlast((FAR sq_entry_t *)respdesc, &priv->csma_queue);
+                  mac802154_csma_enqueue(priv, respdesc);
 
                   /* Notify the radio driver that there is data available */
 
@@ -2114,6 +2200,32 @@ errout:
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mac802154_get_txstats
+ *
+ * Description:
+ *   Return the transmit queue statistics of the MAC.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MAC802154_TXSTATS
+int mac802154_get_txstats(MACHANDLE mac,
+                          FAR struct ieee802154_txstats_s *stats)
+{
+  FAR struct ieee802154_privmac_s *priv =
+    (FAR struct ieee802154_privmac_s *)mac;
+
+  DEBUGASSERT(priv != NULL && stats != NULL);
+
+  mac802154_lock(priv, false);
+  memcpy(stats, &priv->txstats, sizeof(struct ieee802154_txstats_s));
+  stats->caps = priv->radio->caps;
+  mac802154_unlock(priv)
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
 
  * Name: mac802154_create
@@ -364,6 +364,21 @@ int mac802154_resp_associate(MACHANDLE mac,
 int mac802154_resp_orphan(MACHANDLE mac,
                           FAR struct ieee802154_orphan_resp_s *resp);
 
+/****************************************************************************
+ * Name: mac802154_get_txstats
+ *
+ * Description:
+ *   Return the transmit queue statistics of the MAC:  the frames queued,
+ *   sent and given up, the retransmissions and the depth of the CSMA
+ *   queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MAC802154_TXSTATS
+int mac802154_get_txstats(MACHANDLE mac,
+                          FAR struct ieee802154_txstats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
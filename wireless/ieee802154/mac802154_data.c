@@ -350,7 +350,7 @@ int mac802154_req_data(MACHANDLE mac,
         {
           /* Link the transaction into the CSMA transaction list */
 
-          sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue);
+          mac802154_csma_enqueue(priv, txdesc);
 
           /* We no longer need to have the MAC layer locked. */
 
@@ -177,6 +177,10 @@ struct ieee802154_privmac_s
   sq_queue_t csma_queue;
   sq_queue_t gts_queue;
 
+#ifdef CONFIG_MAC802154_TXSTATS
+  struct ieee802154_txstats_s txstats;
+#endif
+
   /* Support a singly linked list of transactions that will be sent
    * indirectly. This list should only be used by a MAC acting as a
    * coordinator.  These transactions will stay here until the data
@@ -332,6 +336,9 @@ int  mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
 void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
       FAR struct ieee802154_txdesc_s *txdesc);
 
+void mac802154_csma_enqueue(FAR struct ieee802154_privmac_s *priv,
+      FAR struct ieee802154_txdesc_s *txdesc);
+
 void mac802154_createdatareq(FAR struct ieee802154_privmac_s *priv,
       FAR struct ieee802154_addr_s *coordaddr,
       enum ieee802154_addrmode_e srcmode,
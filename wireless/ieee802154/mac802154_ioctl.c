@@ -156,6 +156,13 @@ int mac802154_ioctl(MACHANDLE mac, int cmd, unsigned long arg)
               ret = mac802154_req_poll(mac, &macarg->pollreq);
             }
             break;
+#ifdef CONFIG_MAC802154_TXSTATS
+          case MAC802154IOC_GET_TXSTATS:
+            {
+              ret = mac802154_get_txstats(mac, &macarg->txstats);
+            }
+            break;
+#endif
           default:
               wlerr("ERROR: Unrecognized cmd: %d\n", cmd);
               ret = -ENOTTY;